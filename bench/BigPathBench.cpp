@@ -6,10 +6,16 @@
  */
 
 #include "Benchmark.h"
+#include "GrTessellator.h"
 #include "SkCanvas.h"
+#include "SkExecutor.h"
+#include "SkMatrix.h"
 #include "SkPath.h"
+#include "SkTemplates.h"
 #include "sk_tool_utils.h"
 
+#include <atomic>
+
 enum Align {
     kLeft_Align,
     kMiddle_Align,
@@ -84,3 +90,148 @@ DEF_BENCH( return new BigPathBench(kRight_Align,    false); )
 DEF_BENCH( return new BigPathBench(kLeft_Align,     true); )
 DEF_BENCH( return new BigPathBench(kMiddle_Align,   true); )
 DEF_BENCH( return new BigPathBench(kRight_Align,    true); )
+
+// Tessellates the filled big path directly, either in one pass or split into bands.
+class BigPathTessellateBench : public Benchmark {
+    SkPath                      fPath;
+    int                         fBandCount;
+    std::unique_ptr<SkExecutor> fExecutor;
+    SkString                    fName;
+
+    class Allocator : public GrTessellator::VertexAllocator {
+    public:
+        Allocator() : VertexAllocator(sizeof(SkPoint)) {}
+        void* lock(int vertexCount) override {
+            fPoints.reset(vertexCount);
+            return fPoints.get();
+        }
+        void unlock(int) override {}
+    private:
+        SkAutoTMalloc<SkPoint> fPoints;
+    };
+
+public:
+    // bandCount == 0 tessellates with GrTessellator::PathToTriangles.
+    BigPathTessellateBench(int bandCount) : fBandCount(bandCount) {
+        fName.printf("bigpath_tessellate");
+        if (fBandCount) {
+            fName.appendf("_bands_%d", fBandCount);
+        }
+    }
+
+protected:
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    void onDelayedSetup() override {
+        sk_tool_utils::make_big_path(fPath);
+        if (fBandCount) {
+            fExecutor = SkExecutor::MakeFIFOThreadPool(fBandCount);
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        const SkRect clip = fPath.getBounds();
+        Allocator allocator;
+        bool isLinear;
+        for (int i = 0; i < loops; i++) {
+            if (fBandCount) {
+                GrTessellator::PathToTrianglesInBands(fPath, 0.25f, clip, &allocator, fBandCount,
+                                                      fExecutor.get(), &isLinear);
+            } else {
+                GrTessellator::PathToTriangles(fPath, 0.25f, clip, &allocator, false, GrColor(),
+                                               false, &isLinear);
+            }
+        }
+    }
+
+private:
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH( return new BigPathTessellateBench(0); )
+DEF_BENCH( return new BigPathTessellateBench(4); )
+DEF_BENCH( return new BigPathTessellateBench(8); )
+
+extern std::atomic<bool> gSkForceDeltaAA;
+extern std::atomic<int>  gSkDAABandPixelThreshold;
+
+// Fills the big path scaled up to the whole canvas with delta AA, either serially or with its
+// coverage deltas built in bands on a pool of threadCount threads.
+class BigPathDAABandsBench : public Benchmark {
+    SkPath                      fPath;
+    int                         fThreadCount;
+    std::unique_ptr<SkExecutor> fExecutor;
+    SkString                    fName;
+
+public:
+    // threadCount == 0 fills without banding.
+    BigPathDAABandsBench(int threadCount) : fThreadCount(threadCount) {
+        fName.printf("bigpath_daa");
+        if (fThreadCount) {
+            fName.appendf("_bands_threads_%d", fThreadCount);
+        }
+    }
+
+protected:
+    bool isSuitableFor(Backend backend) override {
+        return backend == kRaster_Backend;
+    }
+
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    SkIPoint onGetSize() override {
+        return SkIPoint::Make(2048, 2048);
+    }
+
+    void onDelayedSetup() override {
+        sk_tool_utils::make_big_path(fPath);
+        SkMatrix matrix;
+        matrix.setRectToRect(fPath.getBounds(), SkRect::MakeWH(2048, 2048),
+                             SkMatrix::kFill_ScaleToFit);
+        fPath.transform(matrix);
+        if (fThreadCount) {
+            fExecutor = SkExecutor::MakeFIFOThreadPool(fThreadCount);
+        }
+    }
+
+    void onPerCanvasPreDraw(SkCanvas*) override {
+        gSkForceDeltaAA = true;
+        if (fThreadCount) {
+            gSkDAABandPixelThreshold = 1;
+            SkExecutor::SetDefault(fExecutor.get());
+        }
+    }
+
+    void onPerCanvasPostDraw(SkCanvas*) override {
+        gSkForceDeltaAA = false;
+        gSkDAABandPixelThreshold = 0;
+        SkExecutor::SetDefault(nullptr);
+    }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        SkPaint paint;
+        paint.setAntiAlias(true);
+        this->setupPaint(&paint);
+        for (int i = 0; i < loops; i++) {
+            canvas->drawPath(fPath, paint);
+        }
+    }
+
+private:
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH( return new BigPathDAABandsBench(0); )
+DEF_BENCH( return new BigPathDAABandsBench(1); )
+DEF_BENCH( return new BigPathDAABandsBench(2); )
+DEF_BENCH( return new BigPathDAABandsBench(4); )
+DEF_BENCH( return new BigPathDAABandsBench(8); )
+DEF_BENCH( return new BigPathDAABandsBench(16); )
@@ -11,12 +11,15 @@
 #include "SkOSFile.h"
 
 BitmapRegionDecoderBench::BitmapRegionDecoderBench(const char* baseName, SkData* encoded,
-        SkColorType colorType, uint32_t sampleSize, const SkIRect& subset)
+        SkColorType colorType, uint32_t sampleSize, const SkIRect& subset,
+        SkBitmapRegionDecoder::Strategy strategy, int panSteps)
     : fBRD(nullptr)
     , fData(SkRef(encoded))
     , fColorType(colorType)
     , fSampleSize(sampleSize)
     , fSubset(subset)
+    , fStrategy(strategy)
+    , fPanSteps(panSteps)
 {
     // Choose a useful name for the color type
     const char* colorName = color_type_to_str(colorType);
@@ -36,14 +39,22 @@ bool BitmapRegionDecoderBench::isSuitableFor(Backend backend) {
 }
 
 void BitmapRegionDecoderBench::onDelayedSetup() {
-    fBRD.reset(SkBitmapRegionDecoder::Create(fData, SkBitmapRegionDecoder::kAndroidCodec_Strategy));
+    fBRD.reset(SkBitmapRegionDecoder::Create(fData, fStrategy));
 }
 
 void BitmapRegionDecoderBench::onDraw(int n, SkCanvas* canvas) {
     auto ct = fBRD->computeOutputColorType(fColorType);
     auto cs = fBRD->computeOutputColorSpace(ct, nullptr);
     for (int i = 0; i < n; i++) {
-        SkBitmap bm;
-        SkAssertResult(fBRD->decodeRegion(&bm, nullptr, fSubset, fSampleSize, ct, false, cs));
+        if (fPanSteps > 0) {
+            // Start each pan with nothing cached.
+            fBRD.reset(SkBitmapRegionDecoder::Create(fData, fStrategy));
+        }
+        SkIRect subset = fSubset;
+        for (int step = 0; step <= fPanSteps; step++) {
+            SkBitmap bm;
+            SkAssertResult(fBRD->decodeRegion(&bm, nullptr, subset, fSampleSize, ct, false, cs));
+            subset.offset(fSubset.width() / 4, 0);
+        }
     }
 }
@@ -18,6 +18,9 @@
 /**
  *  Benchmark Android's BitmapRegionDecoder for a particular colorType, sampleSize, and subset.
  *
+ *  If panSteps is non-zero, each loop instead creates a new decoder and decodes the subset, then
+ *  panSteps more subsets, each a quarter of the subset's width to the right of the one before.
+ *
  *  nanobench.cpp handles creating benchmarks for interesting scaled subsets.  We strive to test
  *  on real use cases.
  */
@@ -25,7 +28,9 @@ class BitmapRegionDecoderBench : public Benchmark {
 public:
     // Calls encoded->ref()
     BitmapRegionDecoderBench(const char* basename, SkData* encoded, SkColorType colorType,
-            uint32_t sampleSize, const SkIRect& subset);
+            uint32_t sampleSize, const SkIRect& subset,
+            SkBitmapRegionDecoder::Strategy = SkBitmapRegionDecoder::kAndroidCodec_Strategy,
+            int panSteps = 0);
 
 protected:
     const char* onGetName() override;
@@ -40,6 +45,8 @@ private:
     const SkColorType                              fColorType;
     const uint32_t                                 fSampleSize;
     const SkIRect                                  fSubset;
+    const SkBitmapRegionDecoder::Strategy          fStrategy;
+    const int                                      fPanSteps;
     typedef Benchmark INHERITED;
 };
 #endif // BitmapRegionDecoderBench_DEFINED
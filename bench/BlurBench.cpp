@@ -21,6 +21,11 @@
 // The value that produces a sigma of just over 2.
 #define CUTOVER 2.6f
 
+// Radii whose sigmas are about 64, 128 and 256, big enough for the reduced resolution blur.
+static const SkScalar kSigma64  = SkIntToScalar(110);
+static const SkScalar kSigma128 = SkIntToScalar(221);
+static const SkScalar kSigma256 = SkIntToScalar(443);
+
 static const char* gStyleName[] = {
     "normal",
     "solid",
@@ -100,4 +105,8 @@ DEF_BENCH(return new BlurBench(REAL, kSolid_SkBlurStyle);)
 DEF_BENCH(return new BlurBench(REAL, kOuter_SkBlurStyle);)
 DEF_BENCH(return new BlurBench(REAL, kInner_SkBlurStyle);)
 
+DEF_BENCH(return new BlurBench(kSigma64, kNormal_SkBlurStyle);)
+DEF_BENCH(return new BlurBench(kSigma128, kNormal_SkBlurStyle);)
+DEF_BENCH(return new BlurBench(kSigma256, kNormal_SkBlurStyle);)
+
 DEF_BENCH(return new BlurBench(0, kNormal_SkBlurStyle);)
@@ -19,6 +19,10 @@ static const SkScalar kMedium = SkIntToScalar(5);
 #define BIG     SkIntToScalar(10)
 static const SkScalar kMedBig = SkIntToScalar(20);
 #define REALBIG 30.5f
+// Radii whose sigmas are about 64, 128 and 256, big enough for the reduced resolution blur.
+static const SkScalar kSigma64  = SkIntToScalar(110);
+static const SkScalar kSigma128 = SkIntToScalar(221);
+static const SkScalar kSigma256 = SkIntToScalar(443);
 
 class BlurRectBench: public Benchmark {
     int         fLoopCount;
@@ -201,6 +205,10 @@ DEF_BENCH(return new BlurRectDirectBench(kMedBig);)
 DEF_BENCH(return new BlurRectBoxFilterBench(kMedium);)
 DEF_BENCH(return new BlurRectBoxFilterBench(kMedBig);)
 
+DEF_BENCH(return new BlurRectBoxFilterBench(kSigma64);)
+DEF_BENCH(return new BlurRectBoxFilterBench(kSigma128);)
+DEF_BENCH(return new BlurRectBoxFilterBench(kSigma256);)
+
 #if 0
 // disable Gaussian benchmarks; the algorithm works well enough
 // and serves as a baseline for ground truth, but it's too slow
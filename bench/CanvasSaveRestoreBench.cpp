@@ -0,0 +1,78 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+// Measures the overhead of save()/restore() pairs on a raster canvas, as a UI tree replays them
+// around each of its nodes. The draws are quick-rejected, so only the canvas's bookkeeping counts.
+
+#include "Benchmark.h"
+#include "SkCanvas.h"
+#include "SkSurface.h"
+
+class CanvasSaveRestoreBench : public Benchmark {
+public:
+    enum Mode {
+        kDraw_Mode,         // save, draw, restore
+        kTranslate_Mode,    // save, translate, draw, restore
+        kClip_Mode,         // save, translate, clip, draw, restore
+    };
+
+    CanvasSaveRestoreBench(Mode mode, int depth) : fMode(mode), fDepth(depth) {
+        static const char* kNames[] = { "draw", "translate", "clip" };
+        fName.printf("canvas_save_restore_%s_%d", kNames[mode], depth);
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        fSurface = SkSurface::MakeRasterN32Premul(256, 256);
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        SkCanvas* canvas = fSurface->getCanvas();
+        const SkRect offscreen = SkRect::MakeXYWH(-100, -100, 10, 10);
+        const SkPaint paint;
+        for (int i = 0; i < loops; ++i) {
+            this->drawNode(canvas, fDepth, offscreen, paint);
+        }
+    }
+
+private:
+    void drawNode(SkCanvas* canvas, int depth, const SkRect& r, const SkPaint& paint) {
+        if (0 == depth) {
+            return;
+        }
+        canvas->save();
+        if (fMode >= kTranslate_Mode) {
+            canvas->translate(1, 1);
+        }
+        if (fMode >= kClip_Mode) {
+            canvas->clipRect(SkRect::MakeWH(200, 200));
+        }
+        canvas->drawRect(r, paint);
+        this->drawNode(canvas, depth - 1, r, paint);
+        canvas->restore();
+    }
+
+    const Mode       fMode;
+    const int        fDepth;
+    SkString         fName;
+    sk_sp<SkSurface> fSurface;
+
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH(return new CanvasSaveRestoreBench(CanvasSaveRestoreBench::kDraw_Mode, 1);)
+DEF_BENCH(return new CanvasSaveRestoreBench(CanvasSaveRestoreBench::kTranslate_Mode, 1);)
+DEF_BENCH(return new CanvasSaveRestoreBench(CanvasSaveRestoreBench::kClip_Mode, 1);)
+DEF_BENCH(return new CanvasSaveRestoreBench(CanvasSaveRestoreBench::kDraw_Mode, 32);)
+DEF_BENCH(return new CanvasSaveRestoreBench(CanvasSaveRestoreBench::kTranslate_Mode, 32);)
+DEF_BENCH(return new CanvasSaveRestoreBench(CanvasSaveRestoreBench::kClip_Mode, 32);)
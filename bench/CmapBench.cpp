@@ -9,6 +9,7 @@
 #include "SkCanvas.h"
 #include "SkFont.h"
 #include "SkTypeface.h"
+#include "SkUTF.h"
 
 enum {
     NGLYPHS = 100
@@ -56,17 +57,24 @@ static void charsToGlyphsNull_proc(int loops, const SkFont& font, const void* te
 class CMAPBench : public Benchmark {
     TypefaceProc fProc;
     SkString     fName;
-    char         fText[NGLYPHS];
+    SkString     fText;
     SkFont       fFont;
 
 public:
-    CMAPBench(TypefaceProc proc, const char name[]) {
+    // If 'nonASCII' is set, the text mixes Latin-1, Cyrillic and CJK characters, so that it
+    // decodes from multi-byte UTF-8 and maps through several cmap pages.
+    CMAPBench(TypefaceProc proc, const char name[], bool nonASCII = false) {
         fProc = proc;
-        fName.printf("cmap_%s", name);
+        fName.printf("cmap_%s%s", name, nonASCII ? "_nonASCII" : "");
 
+        static const SkUnichar kNonASCII[] = { 0xE9, 0x416, 0x4E2D, 0xFC };
         for (int i = 0; i < NGLYPHS; ++i) {
-            // we're jamming values into utf8, so we must keep it legal utf8
-            fText[i] = 'A' + (i & 31);
+            SkUnichar uni = 'A' + (i & 31);
+            if (nonASCII && (i & 1)) {
+                uni = kNonASCII[(i >> 1) % SK_ARRAY_COUNT(kNonASCII)];
+            }
+            char utf8[SkUTF::kMaxBytesInUTF8Sequence];
+            fText.append(utf8, SkUTF::ToUTF8(uni, utf8));
         }
         fFont.setTypeface(SkTypeface::MakeDefault());
     }
@@ -77,7 +85,7 @@ protected:
     }
 
     void onDraw(int loops, SkCanvas* canvas) override {
-        fProc(loops, fFont, fText, sizeof(fText), NGLYPHS);
+        fProc(loops, fFont, fText.c_str(), fText.size(), NGLYPHS);
     }
 
 private:
@@ -91,3 +99,5 @@ DEF_BENCH( return new CMAPBench(containsText_proc, "paint_containsText"); )
 DEF_BENCH( return new CMAPBench(textToGlyphs_proc, "paint_textToGlyphs"); )
 DEF_BENCH( return new CMAPBench(charsToGlyphs_proc, "face_charsToGlyphs"); )
 DEF_BENCH( return new CMAPBench(charsToGlyphsNull_proc, "face_charsToGlyphs_null"); )
+DEF_BENCH( return new CMAPBench(textToGlyphs_proc, "paint_textToGlyphs", true); )
+DEF_BENCH( return new CMAPBench(charsToGlyphs_proc, "face_charsToGlyphs", true); )
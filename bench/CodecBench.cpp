@@ -10,20 +10,29 @@
 #include "SkBitmap.h"
 #include "SkCodec.h"
 #include "SkCommandLineFlags.h"
+#include "SkExecutor.h"
 #include "SkOSFile.h"
 
 // Actually zeroing the memory would throw off timing, so we just lie.
 DEFINE_bool(zero_init, false, "Pretend our destination is zero-intialized, simulating Android?");
 
 CodecBench::CodecBench(SkString baseName, SkData* encoded, SkColorType colorType,
-        SkAlphaType alphaType)
+        SkAlphaType alphaType, bool allFrames, int threads)
     : fColorType(colorType)
     , fAlphaType(alphaType)
     , fData(SkRef(encoded))
+    , fAllFrames(allFrames)
+    , fThreads(threads)
 {
     // Parse filename and the color type to give the benchmark a useful name
     fName.printf("Codec_%s_%s%s", baseName.c_str(), color_type_to_str(colorType),
             alpha_type_to_str(alphaType));
+    if (fAllFrames) {
+        fName.append("_frames");
+        if (fThreads) {
+            fName.appendf("_threads_%d", fThreads);
+        }
+    }
     // Ensure that we can create an SkCodec from this data.
     SkASSERT(SkCodec::MakeFromData(fData));
 }
@@ -32,6 +41,8 @@ const char* CodecBench::onGetName() {
     return fName.c_str();
 }
 
+CodecBench::~CodecBench() {}
+
 bool CodecBench::isSuitableFor(Backend backend) {
     return kNonRendering_Backend == backend;
 }
@@ -43,7 +54,21 @@ void CodecBench::onDelayedSetup() {
                             .makeAlphaType(fAlphaType)
                             .makeColorSpace(nullptr);
 
-    fPixelStorage.reset(fInfo.computeMinByteSize());
+    if (!fAllFrames) {
+        fPixelStorage.reset(fInfo.computeMinByteSize());
+        return;
+    }
+
+    const int frameCount = codec->getFrameCount();
+    const size_t frameSize = fInfo.computeMinByteSize();
+    fPixelStorage.reset(frameSize * frameCount);
+    fFramePixels.resize(frameCount);
+    for (int i = 0; i < frameCount; i++) {
+        fFramePixels[i] = SkTAddOffset<void>(fPixelStorage.get(), frameSize * i);
+    }
+    if (fThreads) {
+        fExecutor = SkExecutor::MakeFIFOThreadPool(fThreads);
+    }
 }
 
 void CodecBench::onDraw(int n, SkCanvas* canvas) {
@@ -54,6 +79,16 @@ void CodecBench::onDraw(int n, SkCanvas* canvas) {
     }
     for (int i = 0; i < n; i++) {
         codec = SkCodec::MakeFromData(fData);
+        if (fAllFrames) {
+#ifdef SK_DEBUG
+            const SkCodec::Result result =
+#endif
+            codec->getAllFrames(fInfo, fFramePixels.data(), fInfo.minRowBytes(),
+                                fExecutor.get());
+            SkASSERT(result == SkCodec::kSuccess
+                     || result == SkCodec::kIncompleteInput);
+            continue;
+        }
 #ifdef SK_DEBUG
         const SkCodec::Result result =
 #endif
@@ -15,13 +15,22 @@
 #include "SkRefCnt.h"
 #include "SkString.h"
 
+#include <vector>
+
+class SkExecutor;
+
 /**
  *  Time SkCodec.
+ *
+ *  With allFrames, each loop decodes every frame of an animated image with
+ *  SkCodec::getAllFrames(), using a pool of that many threads if threads is non-zero.
  */
 class CodecBench : public Benchmark {
 public:
     // Calls encoded->ref()
-    CodecBench(SkString basename, SkData* encoded, SkColorType colorType, SkAlphaType alphaType);
+    CodecBench(SkString basename, SkData* encoded, SkColorType colorType, SkAlphaType alphaType,
+               bool allFrames = false, int threads = 0);
+    ~CodecBench() override;
 
 protected:
     const char* onGetName() override;
@@ -36,6 +45,10 @@ private:
     sk_sp<SkData>           fData;
     SkImageInfo             fInfo;          // Set in onDelayedSetup.
     SkAutoMalloc            fPixelStorage;
+    const bool              fAllFrames;
+    const int               fThreads;
+    std::vector<void*>      fFramePixels;   // Points into fPixelStorage, one per frame.
+    std::unique_ptr<SkExecutor> fExecutor;
     typedef Benchmark INHERITED;
 };
 #endif // CodecBench_DEFINED
@@ -7,8 +7,11 @@
 
 #include "Benchmark.h"
 #include "SkColor.h"
+#include "SkColorSpacePriv.h"
 #include "SkColorSpaceXformer.h"
 #include "SkColorSpaceXformSteps.h"
+#include "SkConvertPixels.h"
+#include "SkExecutor.h"
 #include "SkMakeUnique.h"
 #include "SkRandom.h"
 
@@ -72,3 +75,58 @@ struct ColorSpaceXformBench : public Benchmark {
 
 DEF_BENCH(return new ColorSpaceXformBench{Mode::steps  };)
 DEF_BENCH(return new ColorSpaceXformBench{Mode::xformer};)
+
+// Converts a 4K image between color spaces with SkConvertPixels, serially or with its bands spread
+// over a thread pool. sRGB -> P3 goes through the pipeline; sRGB -> 2.2 gamma uses a byte table.
+struct ConvertPixelsBench : public Benchmark {
+    ConvertPixelsBench(bool gamut, int threads) : fGamut(gamut), fThreads(threads) {
+        fName.printf("ConvertPixelsBench_%s", gamut ? "gamut" : "transfer_fn");
+        if (fThreads) {
+            fName.appendf("_threads_%d", fThreads);
+        }
+    }
+
+    const bool fGamut;
+    const int  fThreads;
+    SkString   fName;
+
+    SkImageInfo                 fSrcInfo, fDstInfo;
+    SkAutoTMalloc<uint32_t>     fSrc, fDst;
+    std::unique_ptr<SkExecutor> fExecutor;
+
+    const char* onGetName() override { return fName.c_str(); }
+
+    bool isSuitableFor(Backend backend) override { return kNonRendering_Backend == backend; }
+
+    void onDelayedSetup() override {
+        const int w = 3840, h = 2160;
+        fSrcInfo = SkImageInfo::MakeS32(w, h, kOpaque_SkAlphaType);
+        fDstInfo = fSrcInfo.makeColorSpace(
+                fGamut ? SkColorSpace::MakeRGB(SkColorSpace::kSRGB_RenderTargetGamma,
+                                               SkColorSpace::kDCIP3_D65_Gamut)
+                       : SkColorSpace::MakeRGB(g2Dot2_TransferFn, SkColorSpace::kSRGB_Gamut));
+        fSrc.reset(w * h);
+        fDst.reset(w * h);
+        SkRandom rand;
+        for (int i = 0; i < w * h; i++) {
+            fSrc[i] = rand.nextU() | 0xFF000000;
+        }
+        if (fThreads) {
+            fExecutor = SkExecutor::MakeFIFOThreadPool(fThreads);
+        }
+    }
+
+    void onDraw(int n, SkCanvas*) override {
+        SkExecutor::SetDefault(fExecutor.get());
+        for (int i = 0; i < n; i++) {
+            SkConvertPixels(fDstInfo, fDst.get(), fDstInfo.minRowBytes(),
+                            fSrcInfo, fSrc.get(), fSrcInfo.minRowBytes());
+        }
+        SkExecutor::SetDefault(nullptr);
+    }
+};
+
+DEF_BENCH(return new ConvertPixelsBench(true,  0);)
+DEF_BENCH(return new ConvertPixelsBench(true,  4);)
+DEF_BENCH(return new ConvertPixelsBench(false, 0);)
+DEF_BENCH(return new ConvertPixelsBench(false, 4);)
@@ -8,6 +8,7 @@
 #include "Benchmark.h"
 #include "Resources.h"
 #include "SkBitmap.h"
+#include "SkExecutor.h"
 #include "SkJpegEncoder.h"
 #include "SkPngEncoder.h"
 #include "SkWebpEncoder.h"
@@ -58,6 +59,14 @@ static bool encode_jpeg(SkWStream* dst, const SkPixmap& src) {
     return SkJpegEncoder::Encode(dst, src, opts);
 }
 
+static bool encode_jpeg_parallel(SkWStream* dst, const SkPixmap& src) {
+    static SkExecutor* executor = SkExecutor::MakeFIFOThreadPool(4).release();
+    SkJpegEncoder::Options opts;
+    opts.fQuality = 90;
+    opts.fExecutor = executor;
+    return SkJpegEncoder::Encode(dst, src, opts);
+}
+
 static bool encode_webp_lossy(SkWStream* dst, const SkPixmap& src) {
     SkWebpEncoder::Options opts;
     opts.fCompression = SkWebpEncoder::Compression::kLossy;
@@ -82,6 +91,27 @@ static bool encode_png(SkWStream* dst,
     return SkPngEncoder::Encode(dst, src, opts);
 }
 
+static bool encode_png_speed(SkWStream* dst, const SkPixmap& src) {
+    return SkPngEncoder::Encode(dst, src, SkPngEncoder::Options::Speed());
+}
+
+static bool encode_png_speed_rle(SkWStream* dst, const SkPixmap& src) {
+    SkPngEncoder::Options opts = SkPngEncoder::Options::Speed();
+    opts.fZLibStrategy = SkPngEncoder::Options::ZLibStrategy::kRLE;
+    return SkPngEncoder::Encode(dst, src, opts);
+}
+
+static bool encode_png_parallel(SkWStream* dst, const SkPixmap& src) {
+    static SkExecutor* executor = SkExecutor::MakeFIFOThreadPool(4).release();
+    SkPngEncoder::Options opts;
+    opts.fExecutor = executor;
+    return SkPngEncoder::Encode(dst, src, opts);
+}
+
+static bool encode_webp_fast_lossless(SkWStream* dst, const SkPixmap& src) {
+    return SkWebpEncoder::Encode(dst, src, SkWebpEncoder::Options::FastLossless());
+}
+
 #define PNG(FLAG, ZLIBLEVEL) [](SkWStream* d, const SkPixmap& s) { \
            return encode_png(d, s, SkPngEncoder::FilterFlag::FLAG, ZLIBLEVEL); }
 
@@ -90,6 +120,7 @@ static const char* srcs[2] = {"images/mandrill_512.png", "images/color_wheel.jpg
 // The Android Photos app uses a quality of 90 on JPEG encodes
 DEF_BENCH(return new EncodeBench(srcs[0], &encode_jpeg, "JPEG"));
 DEF_BENCH(return new EncodeBench(srcs[1], &encode_jpeg, "JPEG"));
+DEF_BENCH(return new EncodeBench(srcs[0], &encode_jpeg_parallel, "JPEG_parallel"));
 
 // TODO: What is the appropriate quality to use to benchmark WEBP encodes?
 DEF_BENCH(return new EncodeBench(srcs[0], encode_webp_lossy, "WEBP"));
@@ -98,6 +129,9 @@ DEF_BENCH(return new EncodeBench(srcs[1], encode_webp_lossy, "WEBP"));
 DEF_BENCH(return new EncodeBench(srcs[0], encode_webp_lossless, "WEBP_LL"));
 DEF_BENCH(return new EncodeBench(srcs[1], encode_webp_lossless, "WEBP_LL"));
 
+DEF_BENCH(return new EncodeBench(srcs[0], encode_webp_fast_lossless, "WEBP_LL_fast"));
+DEF_BENCH(return new EncodeBench(srcs[1], encode_webp_fast_lossless, "WEBP_LL_fast"));
+
 DEF_BENCH(return new EncodeBench(srcs[0], PNG(kAll, 6), "PNG"));
 DEF_BENCH(return new EncodeBench(srcs[0], PNG(kAll, 3), "PNG_3"));
 DEF_BENCH(return new EncodeBench(srcs[0], PNG(kAll, 1), "PNG_1"));
@@ -122,4 +156,13 @@ DEF_BENCH(return new EncodeBench(srcs[1], PNG(kNone, 6), "PNG_6n"));
 DEF_BENCH(return new EncodeBench(srcs[1], PNG(kNone, 3), "PNG_3n"));
 DEF_BENCH(return new EncodeBench(srcs[1], PNG(kNone, 1), "PNG_1n"));
 
+DEF_BENCH(return new EncodeBench(srcs[0], encode_png_speed, "PNG_speed"));
+DEF_BENCH(return new EncodeBench(srcs[1], encode_png_speed, "PNG_speed"));
+
+DEF_BENCH(return new EncodeBench(srcs[0], encode_png_speed_rle, "PNG_speed_rle"));
+DEF_BENCH(return new EncodeBench(srcs[1], encode_png_speed_rle, "PNG_speed_rle"));
+
+DEF_BENCH(return new EncodeBench(srcs[0], encode_png_parallel, "PNG_threads_4"));
+DEF_BENCH(return new EncodeBench(srcs[1], encode_png_parallel, "PNG_threads_4"));
+
 #undef PNG
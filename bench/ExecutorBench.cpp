@@ -0,0 +1,68 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Benchmark.h"
+#include "SkExecutor.h"
+#include "SkString.h"
+#include "SkTaskGroup.h"
+
+#include <atomic>
+
+// Runs lots of tiny tasks on each kind of thread pool, either added all at once from outside the
+// pool, or added in small nested batches from tasks already running on it.
+class ExecutorBench : public Benchmark {
+public:
+    enum class Pool { kFIFO, kLIFO, kWorkStealing };
+
+    ExecutorBench(Pool pool, bool nested) : fPoolType(pool), fNested(nested) {
+        static const char* kNames[] = { "fifo", "lifo", "workstealing" };
+        fName.printf("executor_%s_%s", kNames[(int)pool], nested ? "nested" : "flat");
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        switch (fPoolType) {
+            case Pool::kFIFO:         fPool = SkExecutor::MakeFIFOThreadPool();   break;
+            case Pool::kLIFO:         fPool = SkExecutor::MakeLIFOThreadPool();   break;
+            case Pool::kWorkStealing: fPool = SkExecutor::MakeWorkStealingPool(); break;
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        std::atomic<int> sum{0};
+        for (int i = 0; i < loops; i++) {
+            SkTaskGroup tg(*fPool);
+            if (fNested) {
+                tg.batch(64, [&](int) {
+                    SkTaskGroup inner(*fPool);
+                    inner.batch(64, [&](int j) { sum.fetch_add(j, std::memory_order_relaxed); });
+                });
+            } else {
+                tg.batch(4096, [&](int j) { sum.fetch_add(j, std::memory_order_relaxed); });
+            }
+        }
+    }
+
+private:
+    SkString                    fName;
+    Pool                        fPoolType;
+    bool                        fNested;
+    std::unique_ptr<SkExecutor> fPool;
+};
+
+DEF_BENCH( return new ExecutorBench(ExecutorBench::Pool::kFIFO,         false); )
+DEF_BENCH( return new ExecutorBench(ExecutorBench::Pool::kLIFO,         false); )
+DEF_BENCH( return new ExecutorBench(ExecutorBench::Pool::kWorkStealing, false); )
+DEF_BENCH( return new ExecutorBench(ExecutorBench::Pool::kFIFO,         true); )
+DEF_BENCH( return new ExecutorBench(ExecutorBench::Pool::kLIFO,         true); )
+DEF_BENCH( return new ExecutorBench(ExecutorBench::Pool::kWorkStealing, true); )
@@ -6,11 +6,14 @@
  */
 
 #include "Benchmark.h"
+#include "SkBitmap.h"
 #include "SkCanvas.h"
+#include "SkExecutor.h"
 #include "SkGraphics.h"
 #include "SkPaint.h"
 #include "SkRandom.h"
 #include "SkString.h"
+#include "SkTaskGroup.h"
 
 class FontScalerBench : public Benchmark {
     SkString fName;
@@ -46,7 +49,56 @@ private:
     typedef Benchmark INHERITED;
 };
 
+// Like FontScalerBench, but each of fThreads threads draws its own set of strikes into its own
+// bitmap at the same time, to see how well glyph rasterization scales across threads.
+class ThreadedFontScalerBench : public Benchmark {
+    SkString                    fName;
+    SkString                    fText;
+    int                         fThreads;
+    std::unique_ptr<SkExecutor> fExecutor;
+    std::unique_ptr<SkBitmap[]> fBitmaps;
+public:
+    ThreadedFontScalerBench(int threads) : fThreads(threads) {
+        fName.printf("fontscaler_aa_threads_%d", threads);
+        fText.set("abcdefghijklmnopqrstuvwxyz01234567890");
+    }
+
+protected:
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        fExecutor = SkExecutor::MakeFIFOThreadPool(fThreads);
+        fBitmaps.reset(new SkBitmap[fThreads]);
+        for (int t = 0; t < fThreads; t++) {
+            fBitmaps[t].allocN32Pixels(512, 32);
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        for (int i = 0; i < loops; i++) {
+            SkGraphics::PurgeFontCache();
+
+            SkTaskGroup(*fExecutor).batch(fThreads, [&](int t) {
+                SkCanvas canvas(fBitmaps[t]);
+                SkPaint paint;
+                paint.setAntiAlias(true);
+                for (int ps = 9; ps <= 24; ps += 2) {
+                    // A fractional size per thread, so no two threads share a strike.
+                    paint.setTextSize(ps + SkIntToScalar(t) / fThreads);
+                    canvas.drawString(fText, 0, SkIntToScalar(20), paint);
+                }
+            });
+        }
+    }
+private:
+    typedef Benchmark INHERITED;
+};
+
 ///////////////////////////////////////////////////////////////////////////////
 
 DEF_BENCH(return new FontScalerBench(false);)
 DEF_BENCH(return new FontScalerBench(true);)
+DEF_BENCH(return new ThreadedFontScalerBench(1);)
+DEF_BENCH(return new ThreadedFontScalerBench(4);)
+DEF_BENCH(return new ThreadedFontScalerBench(32);)
@@ -0,0 +1,297 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Benchmark.h"
+
+#include "GrAppliedClip.h"
+#include "GrCaps.h"
+#include "GrClip.h"
+#include "GrContext.h"
+#include "GrContextPriv.h"
+#include "GrDefaultGeoProcFactory.h"
+#include "GrGpu.h"
+#include "GrMemoryPool.h"
+#include "GrPaint.h"
+#include "GrPipeline.h"
+#include "GrProcessorSet.h"
+#include "GrProgramDesc.h"
+#include "GrRenderTargetContext.h"
+#include "SkCanvas.h"
+#include "SkSurface.h"
+#include "effects/GrConstColorProcessor.h"
+#include "ops/GrFillRectOp.h"
+
+// These time the CPU side of Ganesh on the mock backend, which does no GPU work, one stage at a
+// time. Every loop is one op (or one render target for the allocator), so nanobench's time per
+// loop is the cost of a stage per op. Recording flushes every kOpsPerFlush ops, as a busy frame
+// might, which keeps the op lists from growing without bound.
+
+static constexpr int kOpsPerFlush = 10000;
+static constexpr int kTargetSize = 256;
+
+// Sets up a paint whose color comes from a chain of 'depth' nested fragment processors.
+static void setup_paint(GrPaint* paint, int depth) {
+    paint->setColor4f({0.25f, 0.5f, 0.75f, 1});
+    if (depth > 0) {
+        auto fp = GrConstColorProcessor::Make({0.5f, 0.5f, 0.5f, 1},
+                                              GrConstColorProcessor::InputMode::kModulateRGBA);
+        for (int i = 1; i < depth; ++i) {
+            fp = GrFragmentProcessor::MulChildByInputAlpha(std::move(fp));
+        }
+        paint->addColorFragmentProcessor(std::move(fp));
+    }
+}
+
+// The i'th of a grid of small rects that tiles the target without overlapping.
+static SkRect rect_for(int i) {
+    constexpr int kPerRow = kTargetSize / 8;
+    int x = i % kPerRow, y = (i / kPerRow) % kPerRow;
+    return SkRect::MakeXYWH(8 * x, 8 * y, 7, 7);
+}
+
+class GrCPUOverheadBench : public Benchmark {
+public:
+    GrCPUOverheadBench(const char* stage) : fName("gr_cpu_overhead_") {
+        fName.append(stage);
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onPerCanvasPreDraw(SkCanvas*) override {
+        fContext = GrContext::MakeMock(nullptr);
+        if (fContext) {
+            this->setUp();
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        if (fContext) {
+            this->run(loops);
+            fContext->flush();
+        }
+    }
+
+    void onPerCanvasPostDraw(SkCanvas*) override {
+        this->tearDown();
+        fContext.reset();
+    }
+
+    virtual void setUp() {}
+    virtual void run(int loops) = 0;
+    virtual void tearDown() {}
+
+    sk_sp<GrContext> fContext;
+
+private:
+    SkString fName;
+
+    typedef Benchmark INHERITED;
+};
+
+// Making (and releasing) a fill rect op: the op's allocation, its GrProcessorSet and its
+// analysis, against a GrCaps but no render target.
+class OpCreationBench : public GrCPUOverheadBench {
+public:
+    OpCreationBench() : INHERITED("op_create") {}
+
+protected:
+    void run(int loops) override {
+        GrOpMemoryPool* pool = fContext->contextPriv().opMemoryPool();
+        for (int i = 0; i < loops; ++i) {
+            GrPaint paint;
+            setup_paint(&paint, 0);
+            auto op = GrFillRectOp::Make(fContext.get(), std::move(paint), GrAAType::kNone,
+                                         GrQuadAAFlags::kNone, SkMatrix::I(), rect_for(i));
+            pool->release(std::move(op));
+        }
+    }
+
+private:
+    typedef GrCPUOverheadBench INHERITED;
+};
+
+// Moving a paint with 'depth' nested fragment processors into a GrProcessorSet and analyzing it,
+// as every op does when it is recorded. This includes building the processors.
+class ProcessorSetBench : public GrCPUOverheadBench {
+public:
+    ProcessorSetBench(int depth)
+            : INHERITED(SkStringPrintf("processor_set_%d", depth).c_str())
+            , fDepth(depth) {}
+
+protected:
+    void run(int loops) override {
+        const GrCaps& caps = *fContext->contextPriv().caps();
+        for (int i = 0; i < loops; ++i) {
+            GrPaint paint;
+            setup_paint(&paint, fDepth);
+            GrProcessorSet set(std::move(paint));
+            SkPMColor4f overrideColor = SK_PMColor4fWHITE;
+            set.finalize(GrProcessorAnalysisColor::Opaque::kYes,
+                         GrProcessorAnalysisCoverage::kNone, nullptr, false, caps, &overrideColor);
+        }
+    }
+
+private:
+    int fDepth;
+
+    typedef GrCPUOverheadBench INHERITED;
+};
+
+// Building the GrProgramDesc key of a pipeline with 'depth' nested fragment processors, which
+// happens for every draw that the GPU backend executes.
+class ProgramKeyBench : public GrCPUOverheadBench {
+public:
+    ProgramKeyBench(int depth)
+            : INHERITED(SkStringPrintf("program_key_%d", depth).c_str())
+            , fDepth(depth) {}
+
+protected:
+    void setUp() override {
+        const GrCaps& caps = *fContext->contextPriv().caps();
+        fRTC = fContext->contextPriv().makeDeferredRenderTargetContext(
+                caps.getBackendFormatFromColorType(kRGBA_8888_SkColorType), SkBackingFit::kExact,
+                kTargetSize, kTargetSize, kRGBA_8888_GrPixelConfig, nullptr);
+        if (!fRTC) {
+            return;
+        }
+        GrPaint paint;
+        setup_paint(&paint, fDepth);
+        GrProcessorSet set(std::move(paint));
+        SkPMColor4f overrideColor = SK_PMColor4fWHITE;
+        set.finalize(GrProcessorAnalysisColor::Opaque::kYes, GrProcessorAnalysisCoverage::kNone,
+                     nullptr, false, caps, &overrideColor);
+
+        GrPipeline::InitArgs args;
+        args.fProxy = fRTC->asRenderTargetProxy();
+        args.fCaps = &caps;
+        args.fResourceProvider = fContext->contextPriv().resourceProvider();
+        fPipeline.reset(new GrPipeline(args, std::move(set), GrAppliedClip()));
+
+        using namespace GrDefaultGeoProcFactory;
+        fGP = GrDefaultGeoProcFactory::Make(caps.shaderCaps(), Color(overrideColor),
+                                            Coverage::kSolid_Type, LocalCoords::kUsePosition_Type,
+                                            SkMatrix::I());
+    }
+
+    void run(int loops) override {
+        if (!fPipeline || !fGP) {
+            return;
+        }
+        GrGpu* gpu = fContext->contextPriv().getGpu();
+        for (int i = 0; i < loops; ++i) {
+            GrProgramDesc desc;
+            GrProgramDesc::Build(&desc, *fGP, false, *fPipeline, gpu);
+        }
+    }
+
+    void tearDown() override {
+        fGP.reset();
+        fPipeline.reset();
+        fRTC.reset();
+    }
+
+private:
+    int                               fDepth;
+    sk_sp<GrRenderTargetContext>      fRTC;
+    std::unique_ptr<GrPipeline>       fPipeline;
+    sk_sp<GrGeometryProcessor>        fGP;
+
+    typedef GrCPUOverheadBench INHERITED;
+};
+
+// Drawing rects through SkCanvas and flushing them: op creation, clipping, recording into the
+// op list with its attempts to merge, and at flush the op list's preparation and execution. When
+// 'merge' is set every rect merges into the previous op; otherwise alternating blend modes keep
+// any two neighbors from merging, so there are kOpsPerFlush ops to look back over and prepare.
+// The difference from op_create is the cost of recording and flushing.
+class RecordAndFlushBench : public GrCPUOverheadBench {
+public:
+    RecordAndFlushBench(bool merge)
+            : INHERITED(merge ? "record_flush_merged" : "record_flush_unmerged")
+            , fMerge(merge) {}
+
+protected:
+    void setUp() override {
+        fSurface = SkSurface::MakeRenderTarget(fContext.get(), SkBudgeted::kNo,
+                                               SkImageInfo::MakeN32Premul(kTargetSize,
+                                                                          kTargetSize));
+    }
+
+    void run(int loops) override {
+        if (!fSurface) {
+            return;
+        }
+        SkCanvas* canvas = fSurface->getCanvas();
+        SkPaint paints[2];
+        paints[0].setColor(0xFF4080C0);
+        paints[1].setColor(0xFF4080C0);
+        paints[1].setBlendMode(fMerge ? SkBlendMode::kSrcOver : SkBlendMode::kPlus);
+        for (int i = 0; i < loops; ++i) {
+            canvas->drawRect(rect_for(i), paints[i & 1]);
+            if ((i + 1) % kOpsPerFlush == 0) {
+                canvas->flush();
+            }
+        }
+    }
+
+    void tearDown() override { fSurface.reset(); }
+
+private:
+    bool              fMerge;
+    sk_sp<SkSurface>  fSurface;
+
+    typedef GrCPUOverheadBench INHERITED;
+};
+
+// Making approx-fit render targets that are each drawn to once, as a frame full of layers and
+// masks does, so that each flush's GrResourceAllocator has many intervals to assign surfaces to.
+class ResourceAllocatorBench : public GrCPUOverheadBench {
+public:
+    ResourceAllocatorBench() : INHERITED("resource_allocator") {}
+
+protected:
+    void run(int loops) override {
+        // Fewer targets than ops per flush: each is a whole op list for the flush to sort.
+        constexpr int kTargetsPerFlush = 500;
+        const GrCaps& caps = *fContext->contextPriv().caps();
+        const GrBackendFormat format = caps.getBackendFormatFromColorType(kRGBA_8888_SkColorType);
+        for (int i = 0; i < loops; ++i) {
+            int size = 16 + 8 * (i % 16);
+            auto rtc = fContext->contextPriv().makeDeferredRenderTargetContext(
+                    format, SkBackingFit::kApprox, size, size, kRGBA_8888_GrPixelConfig, nullptr);
+            if (!rtc) {
+                return;
+            }
+            GrPaint paint;
+            setup_paint(&paint, 0);
+            rtc->drawRect(GrNoClip(), std::move(paint), GrAA::kNo, SkMatrix::I(),
+                          SkRect::MakeIWH(size, size));
+            if ((i + 1) % kTargetsPerFlush == 0) {
+                fContext->flush();
+            }
+        }
+    }
+
+private:
+    typedef GrCPUOverheadBench INHERITED;
+};
+
+DEF_BENCH(return new OpCreationBench();)
+DEF_BENCH(return new ProcessorSetBench(1);)
+DEF_BENCH(return new ProcessorSetBench(8);)
+DEF_BENCH(return new ProcessorSetBench(32);)
+DEF_BENCH(return new ProgramKeyBench(1);)
+DEF_BENCH(return new ProgramKeyBench(8);)
+DEF_BENCH(return new ProgramKeyBench(32);)
+DEF_BENCH(return new RecordAndFlushBench(true);)
+DEF_BENCH(return new RecordAndFlushBench(false);)
+DEF_BENCH(return new ResourceAllocatorBench();)
@@ -0,0 +1,107 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Benchmark.h"
+
+#if SK_SUPPORT_GPU
+
+#include "GrBuffer.h"
+#include "GrContext.h"
+#include "GrContextPriv.h"
+#include "GrOnFlushResourceProvider.h"
+#include "SkCanvas.h"
+#include "SkRandom.h"
+#include "SkTSort.h"
+
+/**
+ * Sorts a vertex buffer of random 64-bit keys at each flush, the way a flush would order its
+ * instances: either on the GPU with GrOnFlushResourceProvider::sortKeys(), or on the CPU before
+ * the keys are uploaded. Where the GPU can't sort keys the "gpu" variant only uploads them.
+ */
+class GrKeySortBench : public Benchmark, public GrOnFlushCallbackObject {
+public:
+    GrKeySortBench(bool onGpu, int count) : fOnGpu(onGpu), fCount(count) {
+        fName.printf("key_sort_%s_%d", onGpu ? "gpu" : "cpu", count);
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return kGPU_Backend == backend;
+    }
+
+protected:
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    void onDelayedSetup() override {
+        SkRandom random;
+        fKeys.reset(fCount);
+        fSortedKeys.reset(fCount);
+        for (int i = 0; i < fCount; ++i) {
+            fKeys[i] = ((uint64_t)random.nextU() << 32) | random.nextU();
+        }
+    }
+
+    void onPerCanvasPreDraw(SkCanvas* canvas) override {
+        if (GrContext* context = canvas->getGrContext()) {
+            context->contextPriv().addOnFlushCallbackObject(this);
+        }
+    }
+
+    void onPerCanvasPostDraw(SkCanvas* canvas) override {
+        if (GrContext* context = canvas->getGrContext()) {
+            context->contextPriv().testingOnly_flushAndRemoveOnFlushCallbackObject(this);
+        }
+        fBuffer.reset();
+    }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        for (int i = 0; i < loops; ++i) {
+            canvas->flush();
+        }
+    }
+
+    void preFlush(GrOnFlushResourceProvider* onFlushRP, const uint32_t*, int,
+                  SkTArray<sk_sp<GrRenderTargetContext>>*) override {
+        int bufferCount = fOnGpu ? onFlushRP->sortKeysBufferCount(fCount) : 0;
+        bool sortOnGpu = bufferCount > 0;
+        if (!fBuffer) {
+            bufferCount = SkTMax(bufferCount, fCount);
+            fBuffer = onFlushRP->makeBuffer(kVertex_GrBufferType, bufferCount * sizeof(uint64_t));
+            if (!fBuffer) {
+                return;
+            }
+        }
+        if (fOnGpu) {
+            fBuffer->updateData(fKeys.get(), fCount * sizeof(uint64_t));
+            if (sortOnGpu) {
+                onFlushRP->sortKeys(fBuffer.get(), fCount);
+            }
+        } else {
+            memcpy(fSortedKeys.get(), fKeys.get(), fCount * sizeof(uint64_t));
+            SkTQSort(fSortedKeys.get(), fSortedKeys.get() + fCount - 1);
+            fBuffer->updateData(fSortedKeys.get(), fCount * sizeof(uint64_t));
+        }
+    }
+
+private:
+    const bool fOnGpu;
+    const int fCount;
+    SkString fName;
+    SkAutoTMalloc<uint64_t> fKeys;
+    SkAutoTMalloc<uint64_t> fSortedKeys;
+    sk_sp<GrBuffer> fBuffer;
+
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH(return new GrKeySortBench(false, 1 << 12);)
+DEF_BENCH(return new GrKeySortBench(true, 1 << 12);)
+DEF_BENCH(return new GrKeySortBench(false, 1 << 20);)
+DEF_BENCH(return new GrKeySortBench(true, 1 << 20);)
+
+#endif
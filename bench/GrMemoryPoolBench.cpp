@@ -10,6 +10,8 @@
 #include "Benchmark.h"
 #include "GrMemoryPool.h"
 #include "SkRandom.h"
+#include "SkString.h"
+#include "SkTArray.h"
 #include "SkTDArray.h"
 #include "SkTemplates.h"
 
@@ -170,8 +172,83 @@ private:
     typedef Benchmark INHERITED;
 };
 
+/**
+ * This benchmark allocates and releases like GrOps do: a few opLists record ops of assorted
+ * sizes, some of which are merged into the op before them and released at once, and each opList
+ * releases all of its ops when it is flushed, while the others keep recording.
+ */
+class GrMemoryPoolBenchOps : public Benchmark {
+public:
+    GrMemoryPoolBenchOps(const char* name, const GrMemoryPool::Options& options)
+            : fName(SkStringPrintf("grmemorypool_ops_%s", name))
+            , fOptions(options) {}
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+protected:
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        // The sizes of a few common ops, give or take.
+        static const size_t kOpSizes[] = { 112, 136, 176, 208, 240, 288, 352, 480 };
+        static const int kOpListCount = 4;
+        static const int kMaxOpsPerOpList = 256;
+
+        // As GrContext makes its op pool.
+        GrMemoryPool pool(16384, 16384, fOptions);
+        SkRandom r;
+        SkTArray<void*> opLists[kOpListCount];
+        int flushAt[kOpListCount];
+        for (int i = 0; i < kOpListCount; ++i) {
+            flushAt[i] = r.nextRangeU(1, kMaxOpsPerOpList);
+        }
+        for (int i = 0; i < loops; ++i) {
+            int l = r.nextULessThan(kOpListCount);
+            void* op = pool.allocate(kOpSizes[r.nextULessThan(SK_ARRAY_COUNT(kOpSizes))]);
+            if (!opLists[l].empty() && r.nextULessThan(4) == 0) {
+                pool.release(op);  // Merged into the previous op.
+            } else {
+                opLists[l].push_back(op);
+            }
+            if (opLists[l].count() >= flushAt[l]) {
+                for (void* recorded : opLists[l]) {
+                    pool.release(recorded);
+                }
+                opLists[l].reset();
+                flushAt[l] = r.nextRangeU(1, kMaxOpsPerOpList);
+            }
+        }
+        for (SkTArray<void*>& opList : opLists) {
+            for (void* recorded : opList) {
+                pool.release(recorded);
+            }
+        }
+    }
+
+private:
+    SkString              fName;
+    GrMemoryPool::Options fOptions;
+
+    typedef Benchmark INHERITED;
+};
+
+static GrMemoryPool::Options ops_options(bool sizeClassFreeLists, size_t warmBlockBytes) {
+    GrMemoryPool::Options options;
+    options.fSizeClassFreeLists = sizeClassFreeLists;
+    options.fWarmBlockBytes = warmBlockBytes;
+    return options;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 DEF_BENCH( return new GrMemoryPoolBenchStack(); )
 DEF_BENCH( return new GrMemoryPoolBenchRandom(); )
 DEF_BENCH( return new GrMemoryPoolBenchQueue(); )
+DEF_BENCH( return new GrMemoryPoolBenchOps("bump", ops_options(false, 0)); )
+DEF_BENCH( return new GrMemoryPoolBenchOps("freelists", ops_options(true, 0)); )
+DEF_BENCH( return new GrMemoryPoolBenchOps("warm", ops_options(false, 256 * 1024)); )
+DEF_BENCH( return new GrMemoryPoolBenchOps("freelists_warm", ops_options(true, 256 * 1024)); )
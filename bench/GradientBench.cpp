@@ -36,6 +36,28 @@ static const SkColor gColors[] = {
 static const SkColor gShallowColors[] = { 0xFF555555, 0xFF444444 };
 static const SkScalar gPos[] = {0.25f, 0.75f};
 
+// Unevenly spaced stops, which have to be searched.
+static const SkScalar gHicolorPos[] = {
+    0.0f, 0.0004f, 0.0017f, 0.0037f, 0.0067f, 0.0104f, 0.015f, 0.0204f, 0.0267f, 0.0337f,
+    0.0416f, 0.0504f, 0.06f, 0.0704f, 0.0816f, 0.0937f, 0.1066f, 0.1204f, 0.1349f, 0.1504f,
+    0.1666f, 0.1837f, 0.2016f, 0.2203f, 0.2399f, 0.2603f, 0.2815f, 0.3036f, 0.3265f, 0.3503f,
+    0.3748f, 0.4002f, 0.4265f, 0.4536f, 0.4815f, 0.5102f, 0.5398f, 0.5702f, 0.6014f, 0.6335f,
+    0.6664f, 0.7001f, 0.7347f, 0.7701f, 0.8063f, 0.8434f, 0.8813f, 0.92f, 0.9596f, 1.0f,
+};
+
+// Unevenly spaced stops along a smooth ramp, like a sampled colormap.
+static const SkColor gColormapColors[] = {
+    0xFF0000C0, 0xFF0F01B8, 0xFF1D03B1, 0xFF2B07AA, 0xFF380CA4, 0xFF44129E,
+    0xFF4F1998, 0xFF5A1F93, 0xFF63278E, 0xFF6C2E8A, 0xFF743586, 0xFF7C3C82,
+    0xFF83447E, 0xFF8B4C7A, 0xFF935576, 0xFF9C5F72, 0xFFA56B6D, 0xFFB07968,
+    0xFFBB8962, 0xFFC79C5C, 0xFFD4B155, 0xFFE2C94E, 0xFFF0E347, 0xFFFFFF40,
+};
+static const SkScalar gColormapPos[] = {
+    0.0f, 0.057f, 0.1129f, 0.167f, 0.2183f, 0.2663f, 0.3108f, 0.3515f,
+    0.3887f, 0.4229f, 0.4547f, 0.4851f, 0.5149f, 0.5453f, 0.5771f, 0.6113f,
+    0.6485f, 0.6892f, 0.7337f, 0.7817f, 0.833f, 0.8871f, 0.943f, 1.0f,
+};
+
 // We have several special-cases depending on the number (and spacing) of colors, so
 // try to exercise those here.
 static const GradData gGradData[] = {
@@ -44,6 +66,8 @@ static const GradData gGradData[] = {
     { 3, gColors, nullptr, "_3color" },
     { 2, gShallowColors, nullptr, "_shallow" },
     { 2, gColors, gPos, "_pos" },
+    { 50, gColors, gHicolorPos, "_hicolor_pos" },
+    { 24, gColormapColors, gColormapPos, "_colormap" },
 };
 
 /// Ignores scale
@@ -282,6 +306,8 @@ DEF_BENCH( return new GradientBench(kLinear_GradType, gGradData[2], SkShader::kM
 DEF_BENCH( return new GradientBench(kRadial_GradType, gGradData[0]); )
 DEF_BENCH( return new GradientBench(kRadial_GradType, gGradData[1]); )
 DEF_BENCH( return new GradientBench(kRadial_GradType, gGradData[2]); )
+DEF_BENCH( return new GradientBench(kRadial_GradType, gGradData[5]); )
+DEF_BENCH( return new GradientBench(kRadial_GradType, gGradData[6]); )
 // Draw a radial gradient of radius 1/2 on a rectangle; half the lines should
 // be completely pinned, the other half should pe partially pinned
 DEF_BENCH( return new GradientBench(kRadial_GradType, gGradData[0], SkShader::kClamp_TileMode, kRect_GeomType, 0.5f); )
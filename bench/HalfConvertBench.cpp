@@ -0,0 +1,69 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Benchmark.h"
+#include "SkHalf.h"
+#include "SkOpts.h"
+#include "SkString.h"
+
+// Converts a row of F16 pixels to floats and back, with SkOpts or one pixel at a time the way
+// callers did before (the _finite_ftz helpers in SkHalf.h).
+class HalfConvertBench : public Benchmark {
+public:
+    HalfConvertBench(bool toFloat, bool useOpts) : fToFloat(toFloat), fUseOpts(useOpts) {
+        fName.printf("half_convert_%s_%s", toFloat ? "to_float" : "to_half",
+                     useOpts ? "opts" : "serial");
+    }
+
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        for (int i = 0; i < kCount; i++) {
+            fFloats[i] = (i % 1000) * (1 / 999.0f);
+        }
+        SkOpts::float_to_half(fHalfs, fFloats, kCount);
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        while (loops --> 0) {
+            if (fToFloat) {
+                if (fUseOpts) {
+                    SkOpts::half_to_float(fFloats, fHalfs, kCount);
+                } else {
+                    for (int i = 0; i < kCount; i += 4) {
+                        uint64_t h;
+                        memcpy(&h, fHalfs + i, sizeof(h));
+                        SkHalfToFloat_finite_ftz(h).store(fFloats + i);
+                    }
+                }
+            } else {
+                if (fUseOpts) {
+                    SkOpts::float_to_half(fHalfs, fFloats, kCount);
+                } else {
+                    for (int i = 0; i < kCount; i += 4) {
+                        SkFloatToHalf_finite_ftz(Sk4f::Load(fFloats + i)).store(fHalfs + i);
+                    }
+                }
+            }
+        }
+    }
+
+private:
+    static constexpr int kCount = 4 * 1023;  // An odd number of RGBA pixels.
+
+    SkString fName;
+    bool     fToFloat;
+    bool     fUseOpts;
+    float    fFloats[kCount];
+    uint16_t fHalfs[kCount];
+};
+
+DEF_BENCH(return new HalfConvertBench(true,  true);)
+DEF_BENCH(return new HalfConvertBench(true,  false);)
+DEF_BENCH(return new HalfConvertBench(false, true);)
+DEF_BENCH(return new HalfConvertBench(false, false);)
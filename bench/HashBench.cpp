@@ -0,0 +1,126 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Benchmark.h"
+#include "SkRandom.h"
+#include "SkString.h"
+#include "SkTHash.h"
+#include "SkTSwissHash.h"
+#include "SkTemplates.h"
+
+// Compares SkTHashMap and SkTSwissHashMap, with a few table sizes so that each runs from lightly
+// loaded up to just under where it would grow (3/4 full for SkTHashMap, 7/8 for SkTSwissHashMap).
+// Keys are random, so both hashes and probes are realistic.
+
+enum class HashOp {
+    kFindHit,   // find() keys that are in the map
+    kFindMiss,  // find() keys that aren't
+    kSet,       // set() count keys into an empty map
+    kRemove,    // remove() and set() back keys that are in the map
+};
+
+static const char* op_name(HashOp op) {
+    switch (op) {
+        case HashOp::kFindHit:  return "find_hit";
+        case HashOp::kFindMiss: return "find_miss";
+        case HashOp::kSet:      return "set";
+        case HashOp::kRemove:   return "remove";
+    }
+    return "";
+}
+
+template <typename Map>
+class HashBench : public Benchmark {
+public:
+    HashBench(const char* mapName, HashOp op, int count) : fOp(op), fCount(count) {
+        fName.printf("hash_%s_%s_%d", mapName, op_name(op), count);
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        // Keys in the map are even, and misses are odd.
+        SkRandom rand;
+        fKeys.reset(fCount);
+        fMissKeys.reset(fCount);
+        for (int i = 0; i < fCount; i++) {
+            fKeys[i]     = rand.nextU() & ~1u;
+            fMissKeys[i] = rand.nextU() |  1u;
+        }
+        for (int i = 0; i < fCount; i++) {
+            fMap.set(fKeys[i], i);
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        int sum = 0;
+        for (int loop = 0; loop < loops; loop++) {
+            switch (fOp) {
+                case HashOp::kFindHit:
+                    for (int i = 0; i < fCount; i++) {
+                        sum += *fMap.find(fKeys[i]);
+                    }
+                    break;
+                case HashOp::kFindMiss:
+                    for (int i = 0; i < fCount; i++) {
+                        sum += fMap.find(fMissKeys[i]) ? 1 : 0;
+                    }
+                    break;
+                case HashOp::kSet: {
+                    Map map;
+                    for (int i = 0; i < fCount; i++) {
+                        map.set(fKeys[i], i);
+                    }
+                    sum += map.count();
+                } break;
+                case HashOp::kRemove:
+                    for (int i = 0; i < fCount; i++) {
+                        fMap.remove(fKeys[i]);
+                        fMap.set(fKeys[(i + fCount / 2) % fCount], i);
+                        fMap.set(fKeys[i], i);
+                    }
+                    sum += fMap.count();
+                    break;
+            }
+        }
+        fSink = sum;
+    }
+
+private:
+    HashOp                 fOp;
+    int                    fCount;
+    SkString               fName;
+    SkAutoTMalloc<uint32_t> fKeys, fMissKeys;
+    Map                    fMap;
+    volatile int           fSink;
+
+    typedef Benchmark INHERITED;
+};
+
+using THashMap     = SkTHashMap<uint32_t, int>;
+using SwissHashMap = SkTSwissHashMap<uint32_t, int>;
+
+#define HASH_BENCHES(op, count)                                          \
+    DEF_BENCH( return new HashBench<THashMap>("thash", op, count); )     \
+    DEF_BENCH( return new HashBench<SwissHashMap>("swiss", op, count); )
+
+#define HASH_BENCHES_ALL_COUNTS(op)  \
+    HASH_BENCHES(op, 100)            \
+    HASH_BENCHES(op, 1024)           \
+    HASH_BENCHES(op, 1500)           \
+    HASH_BENCHES(op, 1790)           \
+    HASH_BENCHES(op, 100000)
+
+HASH_BENCHES_ALL_COUNTS(HashOp::kFindHit)
+HASH_BENCHES_ALL_COUNTS(HashOp::kFindMiss)
+HASH_BENCHES_ALL_COUNTS(HashOp::kSet)
+HASH_BENCHES_ALL_COUNTS(HashOp::kRemove)
@@ -6,7 +6,10 @@
  */
 
 #include "Benchmark.h"
+#include "SkExecutor.h"
+#include "SkMutex.h"
 #include "SkResourceCache.h"
+#include "SkTaskGroup.h"
 
 namespace {
 static void* gGlobalAddress;
@@ -72,6 +75,74 @@ private:
     typedef Benchmark INHERITED;
 };
 
+// Several threads looking up (and, one time in sixteen, adding) small recs, as when many raster
+// threads hit the mask and bitmap caches. Compares the sharded global cache with a single cache
+// behind a single mutex, which is how the global cache used to work.
+class ImageCacheContentionBench : public Benchmark {
+    static constexpr int kKeysPerThread = 256;
+
+    int                         fThreads;
+    bool                        fSharded;
+    SkString                    fName;
+    std::unique_ptr<SkExecutor> fExecutor;
+    SkMutex                     fMutex;
+    SkResourceCache             fCache;
+
+public:
+    ImageCacheContentionBench(int threads, bool sharded)
+        : fThreads(threads)
+        , fSharded(sharded)
+        , fCache(1024 * 1024) {
+        fName.printf("imagecache_contention_%d_%s", threads, sharded ? "sharded" : "locked");
+    }
+
+protected:
+    bool isSuitableFor(Backend backend) override { return kNonRendering_Backend == backend; }
+
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        fExecutor = SkExecutor::MakeFIFOThreadPool(fThreads);
+    }
+
+    bool find(const TestKey& key) {
+        if (fSharded) {
+            return SkResourceCache::Find(key, TestRec::Visitor, nullptr);
+        }
+        SkAutoMutexAcquire lock(fMutex);
+        return fCache.find(key, TestRec::Visitor, nullptr);
+    }
+
+    void add(TestRec* rec) {
+        if (fSharded) {
+            SkResourceCache::Add(rec);
+        } else {
+            SkAutoMutexAcquire lock(fMutex);
+            fCache.add(rec);
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        SkTaskGroup(*fExecutor).batch(fThreads, [&](int thread) {
+            // Keys past anything ImageCacheBench uses.
+            const intptr_t base = (thread + 1) * 1000000;
+            for (int i = 0; i < loops; ++i) {
+                TestKey key(base + (i % kKeysPerThread));
+                if (!this->find(key) || 0 == (i & 15)) {
+                    this->add(new TestRec(key, i));
+                }
+            }
+        });
+    }
+
+private:
+    typedef Benchmark INHERITED;
+};
+
 ///////////////////////////////////////////////////////////////////////////////
 
 DEF_BENCH( return new ImageCacheBench(); )
+DEF_BENCH( return new ImageCacheContentionBench(1, false); )
+DEF_BENCH( return new ImageCacheContentionBench(1, true); )
+DEF_BENCH( return new ImageCacheContentionBench(8, false); )
+DEF_BENCH( return new ImageCacheContentionBench(8, true); )
@@ -9,8 +9,12 @@
 #include "Resources.h"
 #include "SkBlurImageFilter.h"
 #include "SkCanvas.h"
+#include "SkColorFilter.h"
+#include "SkColorFilterImageFilter.h"
+#include "SkExecutor.h"
 #include "SkDisplacementMapEffect.h"
 #include "SkImage.h"
+#include "SkImageFilterPriv.h"
 #include "SkMergeImageFilter.h"
 #include "SkOffsetImageFilter.h"
 #include "SkXfermodeImageFilter.h"
@@ -144,7 +148,73 @@ private:
     typedef Benchmark INHERITED;
 };
 
+// Filters an 8K canvas through blur -> color filter -> merge with an offset copy, either all at once
+// or one tile at a time (see gSkImageFilterTileSize), optionally with the merge's inputs filtered on
+// a thread pool. Alongside the time, reports how much the process' peak resident set grew while
+// the bench ran; run it alone (--match) for that to mean anything.
+class ImageFilterTiledDAGBench : public Benchmark {
+public:
+    ImageFilterTiledDAGBench(int tileSize, int threads) : fTileSize(tileSize), fThreads(threads) {
+        fName.printf("image_filter_dag_8k");
+        if (fTileSize) {
+            fName.appendf("_tile_%d", fTileSize);
+        }
+        if (fThreads) {
+            fName.appendf("_threads_%d", fThreads);
+        }
+    }
+
+protected:
+    bool isSuitableFor(Backend backend) override { return backend == kRaster_Backend; }
+
+    const char* onGetName() override { return fName.c_str(); }
+
+    SkIPoint onGetSize() override { return SkIPoint::Make(7680, 4320); }
+
+    void onDelayedSetup() override {
+        if (fThreads) {
+            fExecutor = SkExecutor::MakeFIFOThreadPool(fThreads);
+        }
+    }
+
+    void onPerCanvasPreDraw(SkCanvas*) override {
+        gSkImageFilterTileSize = fTileSize;
+        if (fExecutor) {
+            SkExecutor::SetDefault(fExecutor.get());
+        }
+    }
+
+    void onPerCanvasPostDraw(SkCanvas*) override {
+        gSkImageFilterTileSize = 0;
+        SkExecutor::SetDefault(nullptr);
+    }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        for (int j = 0; j < loops; j++) {
+            // New filters each loop, so no results are served from the cache.
+            auto blur = SkBlurImageFilter::Make(20.0f, 20.0f, nullptr);
+            auto tint = SkColorFilterImageFilter::Make(
+                    SkColorFilter::MakeModeFilter(SK_ColorBLUE, SkBlendMode::kSrcIn), blur);
+            sk_sp<SkImageFilter> inputs[2] = { tint, SkOffsetImageFilter::Make(40, 40, blur) };
+            SkPaint paint;
+            paint.setImageFilter(SkMergeImageFilter::Make(inputs, 2));
+            canvas->drawRect(SkRect::MakeWH(7680, 4320), paint);
+        }
+    }
+
+private:
+    int                         fTileSize;
+    int                         fThreads;
+    SkString                    fName;
+    std::unique_ptr<SkExecutor> fExecutor;
+
+    typedef Benchmark INHERITED;
+};
+
 DEF_BENCH(return new ImageFilterDAGBench;)
 DEF_BENCH(return new ImageMakeWithFilterDAGBench;)
 DEF_BENCH(return new ImageFilterDisplacedBlur;)
 DEF_BENCH(return new ImageFilterXfermodeIn;)
+DEF_BENCH(return new ImageFilterTiledDAGBench(0, 0);)
+DEF_BENCH(return new ImageFilterTiledDAGBench(1024, 0);)
+DEF_BENCH(return new ImageFilterTiledDAGBench(1024, 4);)
@@ -55,6 +55,50 @@ private:
 
 DEF_BENCH( return new JsonBench; )
 
+// Inline asset-like data: mostly long strings, which the parser scans in blocks.
+class JsonStringsBench : public Benchmark {
+protected:
+    const char* onGetName() override { return "json_skjson_strings"; }
+
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+
+    void onDelayedSetup() override {
+        SkDynamicMemoryWStream stream;
+        stream.writeText("{ \"assets\": [");
+        for (int i = 0; i < 64; ++i) {
+            stream.writeText(i ? ", " : " ");
+            stream.writeText("{ \"id\": \"image_");
+            stream.writeDecAsText(i);
+            stream.writeText("\", \"p\": \"data:image/png;base64,");
+            for (int j = 0; j < 4096; ++j) {
+                static constexpr char kBase64[] =
+                        "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+                stream.write(&kBase64[(i * 7 + j * 13) % 64], 1);
+            }
+            stream.writeText("\" }");
+        }
+        stream.writeText(" ] }");
+        fData = stream.detachAsData();
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        for (int i = 0; i < loops; i++) {
+            skjson::DOM dom(static_cast<const char*>(fData->data()), fData->size());
+            if (dom.root().is<skjson::NullValue>()) {
+                SkDebugf("!! Parsing failed.\n");
+                return;
+            }
+        }
+    }
+
+private:
+    sk_sp<SkData> fData;
+
+    using INHERITED = Benchmark;
+};
+
+DEF_BENCH( return new JsonStringsBench; )
+
 #if (0)
 
 #include "rapidjson/document.h"
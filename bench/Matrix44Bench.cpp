@@ -283,6 +283,34 @@ private:
     typedef Matrix44Bench INHERITED;
 };
 
+class Map2Matrix44Bench : public Matrix44Bench {
+public:
+    Map2Matrix44Bench(bool persp)
+        : INHERITED(persp ? "map2_persp" : "map2_affine")
+    {
+        fMatrix.setTranslate(3, 4, 5);
+        fMatrix.postScale(2, 3, 4);
+        if (persp) {
+            fMatrix.set(3, 0, 0.001f);
+            fMatrix.set(3, 1, -0.002f);
+        }
+        SkRandom rand;
+        for (int i = 0; i < kCount * 2; ++i) {
+            fSrc[i] = rand.nextF();
+        }
+    }
+protected:
+    void performTest() override {
+        fMatrix.map2(fSrc, kCount, fDst);
+    }
+private:
+    enum { kCount = 256 };
+    float fSrc[kCount * 2];
+    float fDst[kCount * 4];
+    SkMatrix44 fMatrix;
+    typedef Matrix44Bench INHERITED;
+};
+
 DEF_BENCH( return new SetIdentityMatrix44Bench(); )
 DEF_BENCH( return new EqualsMatrix44Bench(); )
 DEF_BENCH( return new PreScaleMatrix44Bench(); )
@@ -294,3 +322,5 @@ DEF_BENCH( return new InvertTranslateMatrix44Bench(); )
 DEF_BENCH( return new SetConcatMatrix44Bench(true); )
 DEF_BENCH( return new SetConcatMatrix44Bench(false); )
 DEF_BENCH( return new GetTypeMatrix44Bench(); )
+DEF_BENCH( return new Map2Matrix44Bench(false); )
+DEF_BENCH( return new Map2Matrix44Bench(true); )
@@ -7,6 +7,10 @@
 
 #include "Benchmark.h"
 #include "SkBitmap.h"
+#include "SkBitmapCache.h"
+#include "SkCanvas.h"
+#include "SkExecutor.h"
+#include "SkImage.h"
 #include "SkMipMap.h"
 
 class MipMapBench: public Benchmark {
@@ -14,15 +18,20 @@ class MipMapBench: public Benchmark {
     SkString fName;
     const int fW, fH;
     bool fHalfFoat;
+    bool fLazy;
 
 public:
-    MipMapBench(int w, int h, bool halfFloat = false)
-        : fW(w), fH(h), fHalfFoat(halfFloat)
+    // When lazy, only the first level is built, as when drawing at just under half size.
+    MipMapBench(int w, int h, bool halfFloat = false, bool lazy = false)
+        : fW(w), fH(h), fHalfFoat(halfFloat), fLazy(lazy)
     {
         fName.printf("mipmap_build_%dx%d", w, h);
         if (halfFloat) {
             fName.append("_f16");
         }
+        if (lazy) {
+            fName.append("_lazy");
+        }
     }
 
 protected:
@@ -42,7 +51,7 @@ protected:
 
     void onDraw(int loops, SkCanvas*) override {
         for (int i = 0; i < loops * 4; i++) {
-            SkMipMap::Build(fBitmap, nullptr)->unref();
+            SkMipMap::Build(fBitmap, nullptr, fLazy ? 1 : SK_MaxS32)->unref();
         }
     }
 
@@ -65,3 +74,63 @@ DEF_BENCH( return new MipMapBench(2048, 2048); )
 DEF_BENCH( return new MipMapBench(2047, 2047); )
 DEF_BENCH( return new MipMapBench(2048, 2047); )
 DEF_BENCH( return new MipMapBench(2047, 2048); )
+
+DEF_BENCH( return new MipMapBench(2048, 2048, false, true); )
+DEF_BENCH( return new MipMapBench(2048, 2048, true, true); )
+
+// Draws a new (so uncached) image at a third of its size with medium quality each loop, which
+// needs a mipmap. In the background variant the draw thread leaves building it to a thread pool
+// (and draws without it); the time only reflects the draw thread.
+class MipMapDrawBench : public Benchmark {
+    SkBitmap fBitmap;
+    SkString fName;
+    bool     fBackground;
+    std::unique_ptr<SkExecutor> fExecutor;
+
+public:
+    MipMapDrawBench(bool background) : fBackground(background) {
+        fName.printf("mipmap_draw_2048x2048%s", background ? "_background" : "");
+    }
+
+protected:
+    bool isSuitableFor(Backend backend) override { return kRaster_Backend == backend; }
+
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        fBitmap.allocN32Pixels(2048, 2048);
+        fBitmap.eraseColor(SK_ColorWHITE);
+    }
+
+    void onPerCanvasPreDraw(SkCanvas*) override {
+        if (fBackground) {
+            fExecutor = SkExecutor::MakeFIFOThreadPool(2);
+            SkExecutor::SetDefault(fExecutor.get());
+            gSkBuildMipMapsInBackground = true;
+        }
+    }
+
+    void onPerCanvasPostDraw(SkCanvas*) override {
+        if (fBackground) {
+            gSkBuildMipMapsInBackground = false;
+            SkExecutor::SetDefault(nullptr);
+            fExecutor.reset();  // Finishes any builds still queued.
+        }
+    }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        SkPaint paint;
+        paint.setFilterQuality(kMedium_SkFilterQuality);
+        canvas->scale(1/3.0f, 1/3.0f);
+        for (int i = 0; i < loops; i++) {
+            sk_sp<SkImage> image = SkImage::MakeRasterCopy(fBitmap.pixmap());
+            canvas->drawImage(image, 0, 0, &paint);
+        }
+    }
+
+private:
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH( return new MipMapDrawBench(false); )
+DEF_BENCH( return new MipMapDrawBench(true); )
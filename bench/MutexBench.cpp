@@ -5,10 +5,12 @@
  * found in the LICENSE file.
  */
 #include "Benchmark.h"
+#include "SkExecutor.h"
 #include "SkMutex.h"
 #include "SkSharedMutex.h"
 #include "SkSpinlock.h"
 #include "SkString.h"
+#include "SkTaskGroup.h"
 
 template <typename Mutex>
 class MutexBench : public Benchmark {
@@ -59,9 +61,71 @@ private:
     SkSharedMutex fMu;
 };
 
+// kThreadCount threads each take the lock loops times to read a value. If writeEvery is non-zero,
+// the first thread takes it exclusively to change the value every writeEvery times instead.
+template <typename Mutex>
+class SharedContendedBench : public Benchmark {
+public:
+    static constexpr int kThreadCount = 32;
+
+    SharedContendedBench(const char* mutexName, int writeEvery) : fWriteEvery(writeEvery) {
+        fName.printf("%sSharedContended_threads_%d", mutexName, kThreadCount);
+        if (fWriteEvery) {
+            fName.appendf("_write_every_%d", fWriteEvery);
+        }
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+protected:
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    void onDelayedSetup() override {
+        fExecutor = SkExecutor::MakeFIFOThreadPool(kThreadCount);
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        SkTaskGroup(*fExecutor).batch(kThreadCount, [&](int thread) {
+            int sum = 0;
+            for (int i = 0; i < loops; i++) {
+                if (0 == thread && fWriteEvery && 0 == i % fWriteEvery) {
+                    fMu.acquire();
+                    fValue++;
+                    fMu.release();
+                } else {
+                    fMu.acquireShared();
+                    sum += fValue;
+                    fMu.releaseShared();
+                }
+            }
+            fSink.fetch_add(sum, std::memory_order_relaxed);
+        });
+    }
+
+private:
+    typedef Benchmark INHERITED;
+    SkString                    fName;
+    const int                   fWriteEvery;
+    std::unique_ptr<SkExecutor> fExecutor;
+    Mutex                       fMu;
+    int                         fValue = 0;
+    std::atomic<int>            fSink{0};
+};
+
 ///////////////////////////////////////////////////////////////////////////////
 
 DEF_BENCH( return new MutexBench<SkSharedMutex>(SkString("SkSharedMutex")); )
 DEF_BENCH( return new MutexBench<SkMutex>(SkString("SkMutex")); )
 DEF_BENCH( return new MutexBench<SkSpinlock>(SkString("SkSpinlock")); )
 DEF_BENCH( return new SharedBench; )
+DEF_BENCH( return new MutexBench<SkDistributedSharedMutex>(SkString("SkDistributedSharedMutex")); )
+DEF_BENCH( return new SharedContendedBench<SkSharedMutex>("SkSharedMutex", 0); )
+DEF_BENCH( return new SharedContendedBench<SkSharedMutex>("SkSharedMutex", 1000); )
+
+using DistributedBench = SharedContendedBench<SkDistributedSharedMutex>;
+DEF_BENCH( return new DistributedBench("SkDistributedSharedMutex", 0); )
+DEF_BENCH( return new DistributedBench("SkDistributedSharedMutex", 1000); )
@@ -6,6 +6,7 @@
  */
 
 #include "Benchmark.h"
+#include "SkMatrix.h"
 #include "SkPath.h"
 #include "SkPathOps.h"
 #include "SkRandom.h"
@@ -26,6 +27,11 @@ public:
         fPath2.addOval({-20, -10, 20, 10});
     }
 
+    PathOpsBench(const char suffix[], const SkPath& path1, const SkPath& path2, SkPathOp op)
+        : fPath1(path1), fPath2(path2), fOp(op) {
+        fName.printf("pathops_%s", suffix);
+    }
+
     bool isSuitableFor(Backend backend) override {
         return backend == kNonRendering_Backend;
     }
@@ -83,6 +89,27 @@ private:
 DEF_BENCH( return new PathOpsBench("sect", kIntersect_SkPathOp); )
 DEF_BENCH( return new PathOpsBench("join", kUnion_SkPathOp); )
 
+// Typical UI clip shapes, which Op() handles without the general engine.
+static SkPath make_rotated_rect() {
+    SkPath path;
+    path.addRect({0, 0, 100, 60});
+    path.transform(SkMatrix::MakeAll(0.8f, -0.6f, 20, 0.6f, 0.8f, 10, 0, 0, 1));
+    return path;
+}
+
+static SkPath make_rrect(SkScalar x) {
+    SkPath path;
+    path.addRoundRect({x, 0, x + 100, 60}, 8, 8);
+    return path;
+}
+
+DEF_BENCH( return new PathOpsBench("rect_rotated_rect_sect", SkPath().addRect({10, 10, 90, 70}),
+                                   make_rotated_rect(), kIntersect_SkPathOp); )
+DEF_BENCH( return new PathOpsBench("disjoint_rrects_join", make_rrect(0), make_rrect(200),
+                                   kUnion_SkPathOp); )
+DEF_BENCH( return new PathOpsBench("same_rrects_sect", make_rrect(0), make_rrect(0),
+                                   kIntersect_SkPathOp); )
+
 static SkPath makerects() {
     SkRandom rand;
     SkPath path;
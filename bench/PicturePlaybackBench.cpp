@@ -7,11 +7,15 @@
 #include "Benchmark.h"
 #include "SkCanvas.h"
 #include "SkColor.h"
+#include "SkExecutor.h"
+#include "SkMultiPictureDraw.h"
 #include "SkPaint.h"
 #include "SkPicture.h"
+#include "SkPixmap.h"
 #include "SkPictureRecorder.h"
 #include "SkPoint.h"
 #include "SkRandom.h"
+#include "SkRRect.h"
 #include "SkRect.h"
 #include "SkString.h"
 
@@ -95,3 +99,128 @@ DEF_BENCH( return new TiledPlaybackBench(kNone,     kRandom); )
 DEF_BENCH( return new TiledPlaybackBench(kNone,     kTiled ); )
 DEF_BENCH( return new TiledPlaybackBench(kRTree,    kRandom); )
 DEF_BENCH( return new TiledPlaybackBench(kRTree,    kTiled ); )
+
+// Server-rendered pictures tend to be full of redundant work: grids of same-paint cells,
+// backgrounds painted over, nested translates and clips that don't clip. This plays one back,
+// finished with or without SkPictureRecorder::kOptimizeDrawCalls_FinishFlag.
+class RedundantOpsPlaybackBench : public Benchmark {
+public:
+    explicit RedundantOpsPlaybackBench(bool optimize) : fOptimize(optimize) {}
+
+private:
+    const char* onGetName() override {
+        return fOptimize ? "redundant_ops_playback_optimized" : "redundant_ops_playback";
+    }
+    SkIPoint onGetSize() override { return SkIPoint::Make(1024,1024); }
+
+    void onDelayedSetup() override {
+        SkPictureRecorder recorder;
+        SkCanvas* canvas = recorder.beginRecording(1024, 1024);
+            SkPaint placeholder, background, cell;
+            placeholder.setColor(SK_ColorGRAY);
+            background.setColor(SK_ColorWHITE);
+            cell.setColor(0xFF4080C0);
+            for (int row = 0; row < 64; row++) {
+                canvas->save();
+                canvas->translate(0, SkIntToScalar(16 * row));
+                canvas->translate(2, 2);
+                canvas->clipRect(SkRect::MakeXYWH(-2, -2, 1024, 16));
+                canvas->clipRect(SkRect::MakeXYWH(-2, -2, 1024, 1024));
+                canvas->drawRect(SkRect::MakeXYWH(-2, -2, 1024, 16), placeholder);
+                canvas->drawRect(SkRect::MakeXYWH(-2, -2, 1024, 16), background);
+                for (int col = 0; col < 64; col++) {
+                    canvas->drawRect(SkRect::MakeXYWH(SkIntToScalar(16 * col), 0, 12, 12), cell);
+                }
+                canvas->restore();
+            }
+        fPic = recorder.finishRecordingAsPicture(
+                fOptimize ? SkPictureRecorder::kOptimizeDrawCalls_FinishFlag : 0);
+    }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        for (int i = 0; i < loops; i++) {
+            canvas->drawColor(SK_ColorBLACK);
+            fPic->playback(canvas);
+        }
+    }
+
+    bool             fOptimize;
+    sk_sp<SkPicture> fPic;
+};
+
+DEF_BENCH( return new RedundantOpsPlaybackBench(false); )
+DEF_BENCH( return new RedundantOpsPlaybackBench(true); )
+
+// Plays one 4K picture of rounded rects and translucent layers into a raster canvas, either with a
+// single drawPicture() or split into tiles across a thread pool with
+// SkMultiPictureDraw::DrawTiled().
+class ParallelPlaybackBench : public Benchmark {
+public:
+    explicit ParallelPlaybackBench(int threads) : fThreads(threads) {
+        fName.printf("parallel_playback_%d", fThreads);
+    }
+
+private:
+    bool isSuitableFor(Backend backend) override { return backend == kRaster_Backend; }
+    const char* onGetName() override { return fName.c_str(); }
+    SkIPoint onGetSize() override { return SkIPoint::Make(3840, 2160); }
+
+    void onDelayedSetup() override {
+        if (fThreads) {
+            fExecutor = SkExecutor::MakeFIFOThreadPool(fThreads);
+        }
+        SkRTreeFactory factory;
+        SkPictureRecorder recorder;
+        SkCanvas* canvas = recorder.beginRecording(3840, 2160, &factory);
+            SkRandom rand;
+            SkPaint paint;
+            paint.setAntiAlias(true);
+            for (int i = 0; i < 2000; i++) {
+                SkRect r = SkRect::MakeXYWH(rand.nextRangeScalar(0, 3840),
+                                            rand.nextRangeScalar(0, 2160),
+                                            rand.nextRangeScalar(16, 256),
+                                            rand.nextRangeScalar(16, 256));
+                paint.setColor(rand.nextU() | 0xFF000000);
+                if (i % 100 == 0) {
+                    SkPaint layerPaint;
+                    layerPaint.setAlpha(0xC0);
+                    canvas->saveLayer(&r, &layerPaint);
+                    canvas->drawOval(r, paint);
+                    canvas->restore();
+                } else {
+                    canvas->drawRRect(SkRRect::MakeRectXY(r, 8, 8), paint);
+                }
+            }
+        fPic = recorder.finishRecordingAsPicture();
+    }
+
+    void onPerCanvasPreDraw(SkCanvas*) override {
+        if (fExecutor) {
+            SkExecutor::SetDefault(fExecutor.get());
+        }
+    }
+
+    void onPerCanvasPostDraw(SkCanvas*) override {
+        SkExecutor::SetDefault(nullptr);
+    }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        SkPixmap pixels;
+        for (int i = 0; i < loops; i++) {
+            if (fThreads && canvas->peekPixels(&pixels)) {
+                SkMultiPictureDraw::DrawTiled(pixels, fPic.get());
+            } else {
+                canvas->drawPicture(fPic);
+            }
+        }
+    }
+
+    int                         fThreads;
+    SkString                    fName;
+    sk_sp<SkPicture>            fPic;
+    std::unique_ptr<SkExecutor> fExecutor;
+};
+
+DEF_BENCH( return new ParallelPlaybackBench(0); )
+DEF_BENCH( return new ParallelPlaybackBench(4); )
+DEF_BENCH( return new ParallelPlaybackBench(16); )
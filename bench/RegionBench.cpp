@@ -8,6 +8,7 @@
 #include "SkRandom.h"
 #include "SkRegion.h"
 #include "SkString.h"
+#include "SkTDArray.h"
 
 static bool union_proc(SkRegion& a, SkRegion& b) {
     SkRegion result;
@@ -34,6 +35,18 @@ static bool diffrectbig_proc(SkRegion& a, SkRegion& b) {
     return result.op(a, a.getBounds(), SkRegion::kDifference_Op);
 }
 
+static bool sectrect_proc(SkRegion& a, SkRegion& b) {
+    SkRegion result;
+    return result.op(a, b.getBounds().makeInset(b.getBounds().width()/4, 0),
+                     SkRegion::kIntersect_Op);
+}
+
+static bool unionrect_proc(SkRegion& a, SkRegion& b) {
+    SkRegion result;
+    return result.op(a, b.getBounds().makeInset(b.getBounds().width()/4, 0),
+                     SkRegion::kUnion_Op);
+}
+
 static bool containsrect_proc(SkRegion& a, SkRegion& b) {
     SkIRect r = a.getBounds();
     r.inset(r.width()/4, r.height()/4);
@@ -129,3 +142,52 @@ DEF_BENCH(return new RegionBench(SMALL, containsrect_proc, "containsrect");)
 DEF_BENCH(return new RegionBench(SMALL, sectsrgn_proc, "intersectsrgn");)
 DEF_BENCH(return new RegionBench(SMALL, sectsrect_proc, "intersectsrect");)
 DEF_BENCH(return new RegionBench(SMALL, containsxy_proc, "containsxy");)
+DEF_BENCH(return new RegionBench(SMALL, sectrect_proc, "intersectrect");)
+DEF_BENCH(return new RegionBench(SMALL, unionrect_proc, "unionrect");)
+
+#define BIG     256
+
+DEF_BENCH(return new RegionBench(BIG, union_proc, "union");)
+DEF_BENCH(return new RegionBench(BIG, sect_proc, "intersect");)
+DEF_BENCH(return new RegionBench(BIG, sectrect_proc, "intersectrect");)
+DEF_BENCH(return new RegionBench(BIG, unionrect_proc, "unionrect");)
+
+// Builds a region from a grid of rects, e.g. the tiles or damage rects of a compositor.
+class RegionSetRectsBench : public Benchmark {
+public:
+    RegionSetRectsBench(int n) {
+        fName.printf("region_setrects_grid_%d", n * n);
+        SkRandom rand;
+        for (int y = 0; y < n; y++) {
+            for (int x = 0; x < n; x++) {
+                // Leave out some cells, so that the region isn't just a rect.
+                if (rand.nextU() % 4) {
+                    fRects.push_back(SkIRect::MakeXYWH(x * 16, y * 16, 16, 16));
+                }
+            }
+        }
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        for (int i = 0; i < loops; ++i) {
+            SkRegion rgn;
+            rgn.setRects(fRects.begin(), fRects.count());
+        }
+    }
+
+private:
+    SkTDArray<SkIRect> fRects;
+    SkString           fName;
+
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH(return new RegionSetRectsBench(4);)
+DEF_BENCH(return new RegionSetRectsBench(32);)
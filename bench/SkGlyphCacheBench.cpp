@@ -10,6 +10,7 @@
 
 #include "Benchmark.h"
 #include "SkCanvas.h"
+#include "SkExecutor.h"
 #include "SkStrikeCache.h"
 #include "SkGraphics.h"
 #include "SkTaskGroup.h"
@@ -111,7 +112,61 @@ private:
     SkString fName;
 };
 
+// Many threads finding strikes that are already cached, which is dominated by strike cache
+// locking. Compare the times across thread counts to see how lookups scale.
+class SkGlyphCacheThreadedLookup : public Benchmark {
+public:
+    explicit SkGlyphCacheThreadedLookup(int threads) : fThreads(threads) { }
+
+protected:
+    const char* onGetName() override {
+        fName.printf("SkGlyphCacheThreadedLookup_%d", fThreads);
+        return fName.c_str();
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+    void onDelayedSetup() override {
+        fExecutor = SkExecutor::MakeFIFOThreadPool(fThreads);
+        fTypefaces[0] = sk_tool_utils::create_portable_typeface("serif", SkFontStyle::Italic());
+        fTypefaces[1] = sk_tool_utils::create_portable_typeface("sans-serif",
+                                                                SkFontStyle::Italic());
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        SkPaint defaultPaint;
+        SkTaskGroup tg(*fExecutor);
+        tg.batch(fThreads * 4, [&](int index) {
+            SkFont font;
+            font.setEdging(SkFont::Edging::kAntiAlias);
+            font.setTypeface(fTypefaces[index % 2]);
+            for (int work = 0; work < loops; work++) {
+                for (SkScalar size = 8; size < 24; size++) {
+                    font.setSize(size);
+                    auto cache = SkStrikeCache::FindOrCreateStrikeExclusive(
+                            font, defaultPaint, SkSurfaceProps(0, kUnknown_SkPixelGeometry),
+                            SkScalerContextFlags::kNone, SkMatrix::I());
+                    cache->getGlyphIDMetrics(cache->unicharToGlyph('A' + index % 26));
+                }
+            }
+        });
+    }
+
+private:
+    typedef Benchmark INHERITED;
+    const int fThreads;
+    std::unique_ptr<SkExecutor> fExecutor;
+    sk_sp<SkTypeface> fTypefaces[2];
+    SkString fName;
+};
+
 DEF_BENCH( return new SkGlyphCacheBasic(256 * 1024); )
 DEF_BENCH( return new SkGlyphCacheBasic(32 * 1024 * 1024); )
 DEF_BENCH( return new SkGlyphCacheStressTest(256 * 1024); )
 DEF_BENCH( return new SkGlyphCacheStressTest(32 * 1024 * 1024); )
+DEF_BENCH( return new SkGlyphCacheThreadedLookup(1); )
+DEF_BENCH( return new SkGlyphCacheThreadedLookup(4); )
+DEF_BENCH( return new SkGlyphCacheThreadedLookup(16); )
+DEF_BENCH( return new SkGlyphCacheThreadedLookup(48); )
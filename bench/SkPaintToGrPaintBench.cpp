@@ -0,0 +1,114 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Benchmark.h"
+
+#include "GrContext.h"
+#include "GrContextPriv.h"
+#include "GrPaint.h"
+#include "GrRenderTargetContext.h"
+#include "SkColorFilter.h"
+#include "SkGr.h"
+#include "SkGradientShader.h"
+#include "SkShader.h"
+
+// Times SkPaintToGrPaint() and releasing the GrPaint it made, i.e. making and freeing a tree of
+// fragment processors for each draw, on the mock backend.
+class SkPaintToGrPaintBench : public Benchmark {
+public:
+    enum class Effects {
+        kNone,             // Just a color.
+        kGradient,         // A linear gradient shader.
+        kColorFilter,      // The gradient with a color matrix filter.
+        kComposeShader,    // Two gradients blended by a compose shader.
+    };
+
+    SkPaintToGrPaintBench(Effects effects) : fEffects(effects) {
+        static const char* kNames[] = {"none", "gradient", "colorfilter", "composeshader"};
+        fName.printf("skpaint_to_grpaint_%s", kNames[(int)effects]);
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        const SkPoint pts[] = {{0, 0}, {100, 100}};
+        const SkColor colors[] = {SK_ColorRED, SK_ColorBLUE, SK_ColorGREEN};
+        auto gradient = [&](SkShader::TileMode mode) {
+            return SkGradientShader::MakeLinear(pts, colors, nullptr, SK_ARRAY_COUNT(colors),
+                                                mode);
+        };
+
+        fPaint.setColor(0xFF336699);
+        switch (fEffects) {
+            case Effects::kNone:
+                break;
+            case Effects::kGradient:
+                fPaint.setShader(gradient(SkShader::kClamp_TileMode));
+                break;
+            case Effects::kColorFilter: {
+                fPaint.setShader(gradient(SkShader::kClamp_TileMode));
+                const float matrix[20] = {0.5f, 0,    0,    0, 0,
+                                          0,    0.5f, 0,    0, 0,
+                                          0,    0,    0.5f, 0, 0,
+                                          0,    0,    0,    1, 0};
+                fPaint.setColorFilter(SkColorFilter::MakeMatrixFilterRowMajor255(matrix));
+                break;
+            }
+            case Effects::kComposeShader:
+                fPaint.setShader(SkShader::MakeComposeShader(gradient(SkShader::kClamp_TileMode),
+                                                             gradient(SkShader::kMirror_TileMode),
+                                                             SkBlendMode::kMultiply));
+                break;
+        }
+    }
+
+    void onPerCanvasPreDraw(SkCanvas*) override {
+        fContext = GrContext::MakeMock(nullptr);
+        if (!fContext) {
+            return;
+        }
+        const GrCaps& caps = *fContext->contextPriv().caps();
+        fRTC = fContext->contextPriv().makeDeferredRenderTargetContext(
+                caps.getBackendFormatFromColorType(kRGBA_8888_SkColorType), SkBackingFit::kExact,
+                100, 100, kRGBA_8888_GrPixelConfig, nullptr);
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        if (!fRTC) {
+            return;
+        }
+        for (int i = 0; i < loops; ++i) {
+            GrPaint grPaint;
+            SkPaintToGrPaint(fContext.get(), fRTC->colorSpaceInfo(), fPaint, SkMatrix::I(),
+                             &grPaint);
+        }
+    }
+
+    void onPerCanvasPostDraw(SkCanvas*) override {
+        fRTC.reset();
+        fContext.reset();
+    }
+
+private:
+    Effects                      fEffects;
+    SkString                     fName;
+    SkPaint                      fPaint;
+    sk_sp<GrContext>             fContext;
+    sk_sp<GrRenderTargetContext> fRTC;
+
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH(return new SkPaintToGrPaintBench(SkPaintToGrPaintBench::Effects::kNone);)
+DEF_BENCH(return new SkPaintToGrPaintBench(SkPaintToGrPaintBench::Effects::kGradient);)
+DEF_BENCH(return new SkPaintToGrPaintBench(SkPaintToGrPaintBench::Effects::kColorFilter);)
+DEF_BENCH(return new SkPaintToGrPaintBench(SkPaintToGrPaintBench::Effects::kComposeShader);)
@@ -0,0 +1,133 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Benchmark.h"
+
+#if SK_SUPPORT_GPU
+
+#include "SkSLCompiler.h"
+
+// Fragment shaders in the shape of those Ganesh generates for common draws.
+static const char* kSimpleTextureShader = R"(
+    uniform float4 sk_RTAdjust;
+    uniform half4 uColor_Stage0;
+    uniform sampler2D uTextureSampler_0_Stage1;
+    in float2 vTextureCoords_Stage0;
+    in half4 vColor_Stage0;
+    void main() {
+        half4 outputColor_Stage0 = vColor_Stage0 * uColor_Stage0;
+        half4 output_Stage1 = outputColor_Stage0 *
+                              texture(uTextureSampler_0_Stage1, vTextureCoords_Stage0);
+        sk_FragColor = output_Stage1;
+    }
+)";
+
+static const char* kCircleShader = R"(
+    uniform float4 sk_RTAdjust;
+    uniform float4 uCircle_Stage1;
+    in float4 vCircleEdge_Stage0;
+    in half4 vinColor_Stage0;
+    void main() {
+        half4 outputColor_Stage0 = vinColor_Stage0;
+        float d = length(vCircleEdge_Stage0.xy);
+        half distanceToOuterEdge = half(vCircleEdge_Stage0.z * (1.0 - d));
+        half edgeAlpha = saturate(distanceToOuterEdge);
+        half distanceToInnerEdge = half(vCircleEdge_Stage0.z * (d - vCircleEdge_Stage0.w));
+        half innerAlpha = saturate(distanceToInnerEdge);
+        edgeAlpha *= innerAlpha;
+        half4 outputCoverage_Stage0 = half4(edgeAlpha);
+        half4 output_Stage1;
+        {
+            half2 v = half2(sk_FragCoord.xy - uCircle_Stage1.xy) * half(uCircle_Stage1.w);
+            half dist = half(uCircle_Stage1.z) * (1.0 - length(v));
+            output_Stage1 = outputCoverage_Stage0 * saturate(dist);
+        }
+        sk_FragColor = outputColor_Stage0 * output_Stage1;
+    }
+)";
+
+static const char* kGradientShader = R"(
+    uniform float4 sk_RTAdjust;
+    uniform half4 uscale01_Stage1_c0_c1;
+    uniform half4 ubias01_Stage1_c0_c1;
+    uniform half4 uscale23_Stage1_c0_c1;
+    uniform half4 ubias23_Stage1_c0_c1;
+    uniform half uthreshold_Stage1_c0_c1;
+    in float2 vTransformedCoords_0_Stage0;
+    in half4 vcolor_Stage0;
+    half4 colorize(half t) {
+        half4 scale, bias;
+        if (t < uthreshold_Stage1_c0_c1) {
+            scale = uscale01_Stage1_c0_c1;
+            bias = ubias01_Stage1_c0_c1;
+        } else {
+            scale = uscale23_Stage1_c0_c1;
+            bias = ubias23_Stage1_c0_c1;
+        }
+        return t * scale + bias;
+    }
+    half linear_layout(float2 p) {
+        return half(p.x);
+    }
+    void main() {
+        half4 outputColor_Stage0 = vcolor_Stage0;
+        half4 t = half4(linear_layout(vTransformedCoords_0_Stage0), 1.0, 0.0, 0.0);
+        half4 output_Stage1;
+        if (t.y < 0) {
+            output_Stage1 = half4(0);
+        } else {
+            t.x = saturate(t.x);
+            half4 color = colorize(t.x);
+            color.rgb *= color.a;
+            output_Stage1 = color * outputColor_Stage0.a;
+        }
+        sk_FragColor = output_Stage1;
+    }
+)";
+
+/**
+ * Converts and optimizes representative fragment shaders and generates their GLSL, as happens
+ * each time Ganesh creates a program that isn't cached.
+ */
+class SkSLCompileBench : public Benchmark {
+public:
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+protected:
+    const char* onGetName() override {
+        return "sksl_compile";
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        sk_sp<GrShaderCaps> caps = SkSL::ShaderCapsFactory::Default();
+        SkSL::Program::Settings settings;
+        settings.fCaps = caps.get();
+        for (int i = 0; i < loops; i++) {
+            for (const char* src : { kSimpleTextureShader, kCircleShader, kGradientShader }) {
+                std::unique_ptr<SkSL::Program> program =
+                        fCompiler.convertProgram(SkSL::Program::kFragment_Kind,
+                                                 SkSL::String(src), settings);
+                SkSL::String glsl;
+                if (!program || !fCompiler.toGLSL(*program, &glsl)) {
+                    SkDebugf("%s\n", fCompiler.errorText().c_str());
+                    SK_ABORT("shader failed to compile");
+                }
+            }
+        }
+    }
+
+private:
+    SkSL::Compiler fCompiler;
+
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH(return new SkSLCompileBench();)
+
+#endif
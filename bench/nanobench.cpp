@@ -16,6 +16,7 @@
 #include "CodecBenchPriv.h"
 #include "CrashHandler.h"
 #include "GMBench.h"
+#include "PerfCounters.h"
 #include "ProcStats.h"
 #include "RecordingBench.h"
 #include "ResultsWriter.h"
@@ -137,6 +138,8 @@ DEFINE_string(benchType,  "",
         "Apply usual --match rules to bench type: micro, recording, piping, playback, skcodec, etc.");
 
 DEFINE_bool(forceRasterPipeline, false, "sets gSkForceRasterPipelineBlitter");
+DEFINE_bool(perfCounters, false, "Count instructions, cycles, cache misses and branch misses "
+                                 "per loop with hardware performance counters? (Linux only)");
 
 static double now_ms() { return SkTime::GetNSecs() * 1e-6; }
 
@@ -239,7 +242,8 @@ struct GPUTarget : public Target {
     }
 };
 
-static double time(int loops, Benchmark* bench, Target* target) {
+static double time(int loops, Benchmark* bench, Target* target,
+                   sk_tools::PerfCounters* counters = nullptr) {
     SkCanvas* canvas = target->getCanvas();
     if (canvas) {
         canvas->clear(SK_ColorWHITE);
@@ -247,10 +251,16 @@ static double time(int loops, Benchmark* bench, Target* target) {
     bench->preDraw(canvas);
     double start = now_ms();
     canvas = target->beginTiming(canvas);
+    if (counters) {
+        counters->start();
+    }
     bench->draw(loops, canvas);
     if (canvas) {
         canvas->flush();
     }
+    if (counters) {
+        counters->stop();
+    }
     target->endTiming();
     double elapsed = now_ms() - start;
     bench->postDraw(canvas);
@@ -605,6 +615,8 @@ public:
                       , fCurrentSVG(0)
                       , fCurrentUseMPD(0)
                       , fCurrentCodec(0)
+                      , fCurrentAnimCodec(0)
+                      , fCurrentFrameThreads(0)
                       , fCurrentAndroidCodec(0)
                       , fCurrentBRDImage(0)
                       , fCurrentColorType(0)
@@ -900,6 +912,29 @@ public:
             fCurrentColorType = 0;
         }
 
+        // Decode every frame of animated images, serially and then on a thread pool.
+        for (; fCurrentAnimCodec < fImages.count(); fCurrentAnimCodec++) {
+            fSourceType = "image";
+            fBenchType = "skcodec_frames";
+            const SkString& path = fImages[fCurrentAnimCodec];
+            if (SkCommandLineFlags::ShouldSkip(FLAGS_match, path.c_str())) {
+                continue;
+            }
+            sk_sp<SkData> encoded(SkData::MakeFromFileName(path.c_str()));
+            std::unique_ptr<SkCodec> codec(SkCodec::MakeFromData(encoded));
+            if (!codec || codec->getFrameCount() < 2) {
+                continue;
+            }
+
+            const int threads[] = { 0, 4 };
+            if (fCurrentFrameThreads < (int)SK_ARRAY_COUNT(threads)) {
+                return new CodecBench(SkOSPath::Basename(path.c_str()), encoded.get(),
+                                      kN32_SkColorType, kPremul_SkAlphaType, true,
+                                      threads[fCurrentFrameThreads++]);
+            }
+            fCurrentFrameThreads = 0;
+        }
+
         // Run AndroidCodecBenches
         const int sampleSizes[] = { 2, 4, 8 };
         for (; fCurrentAndroidCodec < fImages.count(); fCurrentAndroidCodec++) {
@@ -958,7 +993,7 @@ public:
 
             while (fCurrentColorType < fColorTypes.count()) {
                 while (fCurrentSampleSize < (int) SK_ARRAY_COUNT(brdSampleSizes)) {
-                    while (fCurrentSubsetType <= kLastSingle_SubsetType) {
+                    while (fCurrentSubsetType <= kLastBRD_SubsetType) {
 
                         sk_sp<SkData> encoded(SkData::MakeFromFileName(path.c_str()));
                         const SkColorType colorType = fColorTypes[fCurrentColorType];
@@ -975,6 +1010,8 @@ public:
                         SkString basename = SkOSPath::Basename(path.c_str());
                         SkIRect subset;
                         const uint32_t subsetSize = sampleSize * minOutputSize;
+                        auto strategy = SkBitmapRegionDecoder::kAndroidCodec_Strategy;
+                        int panSteps = 0;
                         switch (currentSubsetType) {
                             case kTopLeft_SubsetType:
                                 basename.append("_TopLeft");
@@ -1000,12 +1037,26 @@ public:
                                 subset = SkIRect::MakeXYWH(width - subsetSize,
                                         height - subsetSize, subsetSize, subsetSize);
                                 break;
+                            case kTiledPan_SubsetType:
+                                strategy = SkBitmapRegionDecoder::kTiledAndroidCodec_Strategy;
+                                basename.append("_Tiled");
+                                // fall through
+                            case kPan_SubsetType:
+                                // Pan right across the middle, a quarter of a tile at a time.
+                                basename.append("_Pan");
+                                subset = SkIRect::MakeXYWH(0, (height - subsetSize) / 2,
+                                        subsetSize, subsetSize);
+                                panSteps = SkTMin<int>(8, (width - subsetSize) / (subsetSize / 4));
+                                if (panSteps < 1) {
+                                    continue;
+                                }
+                                break;
                             default:
                                 SkASSERT(false);
                         }
 
                         return new BitmapRegionDecoderBench(basename.c_str(), encoded.get(),
-                                colorType, sampleSize, subset);
+                                colorType, sampleSize, subset, strategy, panSteps);
                     }
                     fCurrentSubsetType = 0;
                     fCurrentSampleSize++;
@@ -1046,10 +1097,13 @@ private:
         kMiddle_SubsetType      = 2,
         kBottomLeft_SubsetType  = 3,
         kBottomRight_SubsetType = 4,
-        kTranslate_SubsetType   = 5,
-        kZoom_SubsetType        = 6,
+        kPan_SubsetType         = 5,
+        kTiledPan_SubsetType    = 6,
+        kTranslate_SubsetType   = 7,
+        kZoom_SubsetType        = 8,
         kLast_SubsetType        = kZoom_SubsetType,
         kLastSingle_SubsetType  = kBottomRight_SubsetType,
+        kLastBRD_SubsetType     = kTiledPan_SubsetType,
     };
 
     const BenchRegistry* fBenches;
@@ -1075,6 +1129,8 @@ private:
     int fCurrentSVG;
     int fCurrentUseMPD;
     int fCurrentCodec;
+    int fCurrentAnimCodec;
+    int fCurrentFrameThreads;
     int fCurrentAndroidCodec;
     int fCurrentBRDImage;
     int fCurrentColorType;
@@ -1161,7 +1217,19 @@ int main(int argc, char** argv) {
     const double overhead = estimate_timer_overhead();
     SkDebugf("Timer overhead: %s\n", HUMANIZE(overhead));
 
+    using sk_tools::PerfCounters;
+    std::unique_ptr<PerfCounters> perfCounters;
+    if (FLAGS_perfCounters) {
+        perfCounters.reset(new PerfCounters);
+        if (!perfCounters->isValid()) {
+            SkDebugf("Can't open hardware performance counters; ignoring --perfCounters.\n");
+            perfCounters.reset();
+        }
+    }
+    const char* counterHeader = perfCounters ? "instrs\tcycles\tIPC\tcachemiss\tbrmiss\t" : "";
+
     SkTArray<double> samples;
+    SkTArray<double> counterSamples[PerfCounters::kCounterCount];
 
     if (kAutoTuneLoops != FLAGS_loops) {
         SkDebugf("Fixed number of loops; times would only be misleading so we won't print them.\n");
@@ -1169,10 +1237,11 @@ int main(int argc, char** argv) {
         SkDebugf("! -> high variance, ? -> moderate variance\n");
         SkDebugf("    micros   \tbench\n");
     } else if (FLAGS_ms) {
-        SkDebugf("curr/maxrss\tloops\tmin\tmedian\tmean\tmax\tstddev\tsamples\tconfig\tbench\n");
+        SkDebugf("curr/maxrss\tloops\tmin\tmedian\tmean\tmax\tstddev\tsamples\t%sconfig\tbench\n",
+                 counterHeader);
     } else {
-        SkDebugf("curr/maxrss\tloops\tmin\tmedian\tmean\tmax\tstddev\t%-*s\tconfig\tbench\n",
-                 FLAGS_samples, "samples");
+        SkDebugf("curr/maxrss\tloops\tmin\tmedian\tmean\tmax\tstddev\t%-*s\t%sconfig\tbench\n",
+                 FLAGS_samples, "samples", counterHeader);
     }
 
     SkTArray<Config> configs;
@@ -1252,19 +1321,43 @@ int main(int argc, char** argv) {
                 } while (now_ms() < stop);
             }
 
+            for (SkTArray<double>& counts : counterSamples) {
+                counts.reset();
+            }
+            auto sample = [&] {
+                double ms = time(loops, bench.get(), target, perfCounters.get()) / loops;
+                for (int c = 0; perfCounters && c < PerfCounters::kCounterCount; c++) {
+                    int64_t count = perfCounters->read((PerfCounters::Counter)c);
+                    if (count >= 0) {
+                        counterSamples[c].push_back((double)count / loops);
+                    }
+                }
+                return ms;
+            };
+
             if (FLAGS_ms) {
                 samples.reset();
                 auto stop = now_ms() + FLAGS_ms;
                 do {
-                    samples.push_back(time(loops, bench.get(), target) / loops);
+                    samples.push_back(sample());
                 } while (now_ms() < stop);
             } else {
                 samples.reset(FLAGS_samples);
                 for (int s = 0; s < FLAGS_samples; s++) {
-                    samples[s] = time(loops, bench.get(), target) / loops;
+                    samples[s] = sample();
                 }
             }
 
+            // Median count per loop of each counter, or -1 if we couldn't read it.
+            double counts[PerfCounters::kCounterCount];
+            for (int c = 0; c < PerfCounters::kCounterCount; c++) {
+                counts[c] = counterSamples[c].empty() ? -1 : Stats(counterSamples[c], false).median;
+            }
+            const double ipc = counts[PerfCounters::kInstructions] >= 0 &&
+                               counts[PerfCounters::kCycles] > 0
+                             ? counts[PerfCounters::kInstructions] / counts[PerfCounters::kCycles]
+                             : -1;
+
             SkTArray<SkString> keys;
             SkTArray<double> values;
             bool gpuStatsDump = FLAGS_gpuStatsDump && Benchmark::kGPU_Backend == configs[i].backend;
@@ -1294,6 +1387,14 @@ int main(int argc, char** argv) {
             target->fillOptions(log.get());
             log->metric("min_ms",    stats.min);
             log->metrics("samples",    samples);
+            for (int c = 0; c < PerfCounters::kCounterCount; c++) {
+                if (counts[c] >= 0) {
+                    log->metric(PerfCounters::Name((PerfCounters::Counter)c), counts[c]);
+                }
+            }
+            if (ipc >= 0) {
+                log->metric("ipc", ipc);
+            }
             if (gpuStatsDump) {
                 // dump to json, only SKPBench currently returns valid keys / values
                 SkASSERT(keys.count() == values.count());
@@ -1335,7 +1436,22 @@ int main(int argc, char** argv) {
                          , bench->getUniqueName()
                          );
             } else {
-                const char* format = "%4d/%-4dMB\t%d\t%s\t%s\t%s\t%s\t%.0f%%\t%s\t%s\t%s\n";
+                SkString counterColumns;
+                if (perfCounters) {
+                    auto column = [&](double value, const char* format) {
+                        if (value >= 0) {
+                            counterColumns.appendf(format, value);
+                        } else {
+                            counterColumns.append("-\t");
+                        }
+                    };
+                    column(counts[PerfCounters::kInstructions], "%.4g\t");
+                    column(counts[PerfCounters::kCycles],       "%.4g\t");
+                    column(ipc,                                 "%.2f\t");
+                    column(counts[PerfCounters::kCacheMisses],  "%.4g\t");
+                    column(counts[PerfCounters::kBranchMisses], "%.4g\t");
+                }
+                const char* format = "%4d/%-4dMB\t%d\t%s\t%s\t%s\t%s\t%.0f%%\t%s\t%s%s\t%s\n";
                 const double stddev_percent = 100 * sqrt(stats.var) / stats.mean;
                 SkDebugf(format
                         , sk_tools::getCurrResidentSetSizeMB()
@@ -1347,6 +1463,7 @@ int main(int argc, char** argv) {
                         , HUMANIZE(stats.max)
                         , stddev_percent
                         , FLAGS_ms ? to_string(samples.count()).c_str() : stats.plot.c_str()
+                        , counterColumns.c_str()
                         , config
                         , bench->getUniqueName()
                         );
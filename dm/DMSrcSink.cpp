@@ -54,6 +54,7 @@
 #include "SkSwizzler.h"
 #include "SkTLogic.h"
 #include "SkTaskGroup.h"
+#include "SkThreadedBMPDevice.h"
 #if defined(SK_BUILD_FOR_WIN)
     #include "SkAutoCoInitialize.h"
     #include "SkHRESULT.h"
@@ -1490,6 +1491,9 @@ Error GPUSink::onDraw(const Src& src, SkBitmap* dst, SkWStream*, SkString* log,
         return err;
     }
     canvas->flush();
+    if (grOptions.fPersistentCache) {
+        context->storeVkPipelineCacheData();
+    }
     if (FLAGS_gpuStats) {
         canvas->getGrContext()->contextPriv().dumpCacheStats(log);
         canvas->getGrContext()->contextPriv().dumpGpuStats(log);
@@ -1759,6 +1763,33 @@ Error RasterSink::draw(const Src& src, SkBitmap* dst, SkWStream*, SkString*) con
 
 /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
 
+ThreadedSink::ThreadedSink(SkColorType colorType, sk_sp<SkColorSpace> colorSpace)
+    : RasterSink(colorType, std::move(colorSpace)) {}
+
+Error ThreadedSink::draw(const Src& src, SkBitmap* dst, SkWStream* stream, SkString* log) const {
+    // Draw once single-threaded as a reference, then again through SkThreadedBMPDevice.
+    SkBitmap reference;
+    Error err = this->RasterSink::draw(src, &reference, stream, log);
+    if (!err.isEmpty()) {
+        return err;
+    }
+
+    dst->allocPixelsFlags(reference.info(), SkBitmap::kZeroPixels_AllocFlag);
+    {
+        // Use small bands so even small sources are split up across several tasks.
+        const int bands = SkTMax(1, dst->height() / 16);
+        SkCanvas canvas(sk_make_sp<SkThreadedBMPDevice>(
+                *dst, SkSurfaceProps(SkSurfaceProps::kLegacyFontHost_InitType), nullptr, bands));
+        err = src.draw(&canvas);
+        if (!err.isEmpty()) {
+            return err;
+        }
+    }   // The device flushes when the canvas goes away.
+    return compare_bitmaps(reference, *dst);
+}
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
 // Handy for front-patching a Src.  Do whatever up-front work you need, then call draw_to_canvas(),
 // passing the Sink draw() arguments, a size, and a function draws into an SkCanvas.
 // Several examples below.
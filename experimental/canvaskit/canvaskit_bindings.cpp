@@ -56,6 +56,7 @@
 
 #include <iostream>
 #include <string>
+#include <vector>
 
 #include <emscripten.h>
 #include <emscripten/bind.h>
@@ -67,6 +68,7 @@
 using namespace emscripten;
 
 // Self-documenting types
+using Float32Array = emscripten::val;
 using JSArray = emscripten::val;
 using JSColor = int32_t;
 using JSObject = emscripten::val;
@@ -342,6 +344,84 @@ SkPathOrNull EMSCRIPTEN_KEEPALIVE MakePathFromOp(const SkPath& pathOne, const Sk
     return emscripten::val::null();
 }
 
+// Verbs of the flat command arrays read by MakePathFromCmds() and written by ToCmds(), which
+// match PathKit's: each verb is followed by its arguments.
+static const int MOVE = 0;
+static const int LINE = 1;
+static const int QUAD = 2;
+static const int CONIC = 3;
+static const int CUBIC = 4;
+static const int CLOSE = 5;
+
+// Builds a path from commands in the wasm heap in one call, rather than one call per verb.
+SkPathOrNull EMSCRIPTEN_KEEPALIVE MakePathFromCmds(uintptr_t /* float* */ cptr, int numCmds) {
+    const auto* cmds = reinterpret_cast<const float*>(cptr);
+    SkPath path;
+
+    static constexpr int kArgCounts[] = { 2, 2, 4, 5, 6, 0 };
+    for (int i = 0; i < numCmds;) {
+        const int verb = sk_float_floor2int(cmds[i++]);
+        if (verb < MOVE || verb > CLOSE || i + kArgCounts[verb] > numCmds) {
+            SkDebugf("Invalid path command %f at %d\n", cmds[i - 1], i - 1);
+            return emscripten::val::null();
+        }
+
+        const float* a = cmds + i;
+        switch (verb) {
+            case MOVE:  path.moveTo(a[0], a[1]);                             break;
+            case LINE:  path.lineTo(a[0], a[1]);                             break;
+            case QUAD:  path.quadTo(a[0], a[1], a[2], a[3]);                 break;
+            case CONIC: path.conicTo(a[0], a[1], a[2], a[3], a[4]);          break;
+            case CUBIC: path.cubicTo(a[0], a[1], a[2], a[3], a[4], a[5]);    break;
+            case CLOSE: path.close();                                        break;
+        }
+        i += kArgCounts[verb];
+    }
+
+    return emscripten::val(path);
+}
+
+// Exports the path as flat commands, in one Float32Array.
+Float32Array EMSCRIPTEN_KEEPALIVE ToCmds(const SkPath& path) {
+    std::vector<float> cmds;
+    // Conic weights may need a little more room.
+    cmds.reserve(path.countVerbs() + 2 * path.countPoints());
+
+    SkPath::RawIter iter(path);
+    SkPoint pts[4];
+    SkPath::Verb verb;
+    while ((verb = iter.next(pts)) != SkPath::kDone_Verb) {
+        switch (verb) {
+            case SkPath::kMove_Verb:
+                cmds.insert(cmds.end(), { MOVE, pts[0].x(), pts[0].y() });
+                break;
+            case SkPath::kLine_Verb:
+                cmds.insert(cmds.end(), { LINE, pts[1].x(), pts[1].y() });
+                break;
+            case SkPath::kQuad_Verb:
+                cmds.insert(cmds.end(), { QUAD, pts[1].x(), pts[1].y(), pts[2].x(), pts[2].y() });
+                break;
+            case SkPath::kConic_Verb:
+                cmds.insert(cmds.end(), { CONIC, pts[1].x(), pts[1].y(), pts[2].x(), pts[2].y(),
+                                          iter.conicWeight() });
+                break;
+            case SkPath::kCubic_Verb:
+                cmds.insert(cmds.end(), { CUBIC, pts[1].x(), pts[1].y(), pts[2].x(), pts[2].y(),
+                                          pts[3].x(), pts[3].y() });
+                break;
+            case SkPath::kClose_Verb:
+                cmds.push_back(CLOSE);
+                break;
+            case SkPath::kDone_Verb:
+                break;
+        }
+    }
+
+    // Return a copy, as views of the wasm heap become invalid if it grows.
+    return emscripten::val::global("Float32Array").new_(typed_memory_view(cmds.size(),
+                                                                          cmds.data()));
+}
+
 SkPath EMSCRIPTEN_KEEPALIVE CopyPath(const SkPath& a) {
     SkPath copy(a);
     return copy;
@@ -472,6 +552,8 @@ EMSCRIPTEN_BINDINGS(Skia) {
         return SkMaskFilter::MakeBlur(style, sigma, respectCTM);
     }), allow_raw_pointers());
     function("MakePathFromOp", &MakePathFromOp);
+    // MakePathFromCmds is defined in interface.js to accept arrays and TypedArrays.
+    function("_MakePathFromCmds", &MakePathFromCmds);
 
     // These won't be called directly, there's a JS helper to deal with typed arrays.
     function("_MakeSkDashPathEffect", optional_override([](uintptr_t /* float* */ cptr, int count, SkScalar phase)->sk_sp<SkPathEffect> {
@@ -749,6 +831,7 @@ EMSCRIPTEN_BINDINGS(Skia) {
         .function("_op", &ApplyPathOp)
 
         // Exporting
+        .function("toCmds", &ToCmds)
         .function("toSVGString", &ToSVGString)
 
         .function("setFillType", &SkPath::setFillType)
@@ -975,6 +1058,13 @@ EMSCRIPTEN_BINDINGS(Skia) {
     constant("CYAN",        (JSColor) SK_ColorCYAN);
     constant("BLACK",       (JSColor) SK_ColorBLACK);
     constant("WHITE",       (JSColor) SK_ColorWHITE);
+
+    constant("MOVE_VERB",  MOVE);
+    constant("LINE_VERB",  LINE);
+    constant("QUAD_VERB",  QUAD);
+    constant("CONIC_VERB", CONIC);
+    constant("CUBIC_VERB", CUBIC);
+    constant("CLOSE_VERB", CLOSE);
     // TODO(?)
 
 #if SK_INCLUDE_SKOTTIE
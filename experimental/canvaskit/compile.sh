@@ -80,6 +80,16 @@ if [[ $@ == *no_managed_skottie* ]]; then
   WASM_MANAGED_SKOTTIE="-DSK_INCLUDE_MANAGED_SKOTTIE=0"
 fi
 
+# WebAssembly SIMD is not enabled by default in browsers yet. Emscripten implements the SSE
+# intrinsics on top of it, so this builds SkNx, SkOpts and the raster pipeline as for SSE2.
+SIMD_CFLAGS="\"-DSKNX_NO_SIMD\","
+WASM_SIMD=""
+if [[ $@ == *simd* ]]; then
+  echo "Using WebAssembly SIMD"
+  SIMD_CFLAGS="\"-msimd128\", \"-msse2\","
+  WASM_SIMD="-msimd128 -msse2"
+fi
+
 HTML_CANVAS_API="--pre-js $BASE_DIR/htmlcanvas/canvas2d.js"
 if [[ $@ == *no_canvas* ]]; then
   echo "Omitting bindings for HTML Canvas API"
@@ -104,7 +114,7 @@ echo "Compiling bitcode"
   cxx=\"${EMCXX}\" \
   extra_cflags_cc=[\"-frtti\"] \
   extra_cflags=[\"-s\",\"USE_FREETYPE=1\",\"-s\",\"USE_LIBPNG=1\", \"-s\", \"WARN_UNALIGNED=1\",
-    \"-DSKNX_NO_SIMD\", \"-DSK_DISABLE_AAA\", \"-DSK_DISABLE_DAA\", \"-DSK_DISABLE_READBUFFER\",
+    ${SIMD_CFLAGS} \"-DSK_DISABLE_AAA\", \"-DSK_DISABLE_DAA\", \"-DSK_DISABLE_READBUFFER\",
     \"-DSK_DISABLE_EFFECT_DESERIALIZATION\",
     ${GN_GPU_FLAGS}
     ${EXTRA_CFLAGS}
@@ -176,6 +186,7 @@ ${EMCXX} \
     -DSK_DISABLE_AAA \
     -DSK_DISABLE_DAA \
     $WASM_GPU \
+    $WASM_SIMD \
     -std=c++14 \
     --bind \
     --pre-js $BASE_DIR/helper.js \
@@ -39,6 +39,8 @@ var CanvasKit = {
 	MakeImageFromEncoded: function() {},
 	/** @return {LinearCanvasGradient} */
 	MakeLinearGradientShader: function() {},
+	/** @return {CanvasKit.SkPath} */
+	MakePathFromCmds: function() {},
 	MakeRadialGradientShader: function() {},
 	MakeSWCanvasSurface: function() {},
 	MakeSkDashPathEffect: function() {},
@@ -59,6 +61,7 @@ var CanvasKit = {
 	_MakeImage: function() {},
 	_MakeImageShader: function() {},
 	_MakeLinearGradientShader: function() {},
+	_MakePathFromCmds: function() {},
 	_MakeRadialGradientShader: function() {},
 	_MakeSkDashPathEffect: function() {},
 	_MakeSkVertices: function() {},
@@ -163,6 +166,7 @@ var CanvasKit = {
 		getFillType: function() {},
 		getPoint: function() {},
 		setFillType: function() {},
+		toCmds: function() {},
 		toSVGString: function() {},
 
 		// private API
@@ -233,6 +237,13 @@ var CanvasKit = {
 	BLACK: {},
 	WHITE: {},
 
+	MOVE_VERB: {},
+	LINE_VERB: {},
+	QUAD_VERB: {},
+	CONIC_VERB: {},
+	CUBIC_VERB: {},
+	CLOSE_VERB: {},
+
 	AlphaType: {
 		Opaque: {},
 		Premul: {},
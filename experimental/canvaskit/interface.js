@@ -467,6 +467,23 @@
     return dpe;
   }
 
+  // cmds is a Float32Array or JS array of flat commands, or a 2d array with
+  // one command per row, e.g. [[CanvasKit.MOVE_VERB, 0, 10], [CanvasKit.LINE_VERB, 30, 40]].
+  // A Float32Array that is a view of CanvasKit.HEAPF32 (e.g. filled in by
+  // an earlier call) is read in place, without copying.
+  CanvasKit.MakePathFromCmds = function(cmds) {
+    if (cmds instanceof Float32Array && cmds.buffer === CanvasKit.HEAPF32.buffer) {
+      return CanvasKit._MakePathFromCmds(cmds.byteOffset, cmds.length);
+    }
+    if (cmds.length && Array.isArray(cmds[0])) {
+      cmds = [].concat.apply([], cmds);
+    }
+    var ptr = copy1dArray(cmds, CanvasKit.HEAPF32);
+    var path = CanvasKit._MakePathFromCmds(ptr, cmds.length);
+    CanvasKit._free(ptr);
+    return path;
+  }
+
   // data is a TypedArray or ArrayBuffer
   CanvasKit.MakeImageFromEncoded = function(data) {
     data = new Uint8Array(data);
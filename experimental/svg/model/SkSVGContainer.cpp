@@ -14,7 +14,10 @@ SkSVGContainer::SkSVGContainer(SkSVGTag t) : INHERITED(t) { }
 
 void SkSVGContainer::appendChild(sk_sp<SkSVGNode> node) {
     SkASSERT(node);
+    SkASSERT(!node->fParent);
+    node->fParent = this;
     fChildren.push_back(std::move(node));
+    this->invalidate();
 }
 
 bool SkSVGContainer::hasChildren() const {
@@ -502,10 +502,14 @@ const SkSize& SkSVGDOM::containerSize() const {
 }
 
 void SkSVGDOM::setContainerSize(const SkSize& containerSize) {
-    // TODO: inval
+    // Cached renderings key on their viewport, so there's nothing to invalidate here.
     fContainerSize = containerSize;
 }
 
+sk_sp<SkSVGNode>* SkSVGDOM::findNodeById(const char* id) {
+    return fIDMapper.find(SkString(id));
+}
+
 void SkSVGDOM::setRoot(sk_sp<SkSVGNode> root) {
     fRoot = std::move(root);
 }
@@ -31,6 +31,11 @@ public:
 
     void setRoot(sk_sp<SkSVGNode>);
 
+    // Nodes can be changed through SkSVGNode::setAttribute() between renders; only the subtrees
+    // affected by a change are recorded again, the rest replay their cached pictures.
+    sk_sp<SkSVGNode>* findNodeById(const char* id);
+
+    // Not thread safe: rendering updates the nodes' cached pictures.
     void render(SkCanvas*) const;
 
 private:
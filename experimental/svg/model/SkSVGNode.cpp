@@ -6,23 +6,102 @@
  */
 
 #include "SkCanvas.h"
+#include "SkMakeUnique.h"
 #include "SkMatrix.h"
 #include "SkPathOps.h"
+#include "SkPicture.h"
+#include "SkPictureRecorder.h"
 #include "SkSVGNode.h"
 #include "SkSVGRenderContext.h"
 #include "SkSVGValue.h"
 #include "SkTLazy.h"
 
+namespace {
+
+bool inherited_equal(const SkSVGPresentationAttributes& a, const SkSVGPresentationAttributes& b) {
+    return *a.fFill.get()             == *b.fFill.get()
+        && *a.fFillOpacity.get()      == *b.fFillOpacity.get()
+        && *a.fFillRule.get()         == *b.fFillRule.get()
+        && *a.fClipRule.get()         == *b.fClipRule.get()
+        && *a.fStroke.get()           == *b.fStroke.get()
+        && *a.fStrokeDashArray.get()  == *b.fStrokeDashArray.get()
+        && *a.fStrokeDashOffset.get() == *b.fStrokeDashOffset.get()
+        && *a.fStrokeLineCap.get()    == *b.fStrokeLineCap.get()
+        && *a.fStrokeLineJoin.get()   == *b.fStrokeLineJoin.get()
+        && *a.fStrokeMiterLimit.get() == *b.fStrokeMiterLimit.get()
+        && *a.fStrokeOpacity.get()    == *b.fStrokeOpacity.get()
+        && *a.fStrokeWidth.get()      == *b.fStrokeWidth.get()
+        && *a.fVisibility.get()       == *b.fVisibility.get();
+}
+
+} // anonymous ns
+
+// A recorded rendering of a node, and what it was rendered from: the viewport, the inherited
+// presentation attributes, and the generations of every node looked up along the way (including
+// those the inherited paints were made from).
+struct SkSVGNode::RenderCache {
+    SkSize                      fViewport;
+    SkSVGPresentationAttributes fInherited;
+    SkSVGDependencies           fDependencies;
+    sk_sp<SkPicture>            fPicture;
+
+    bool isValidFor(const SkSVGRenderContext& ctx) const {
+        if (fViewport != ctx.lengthContext().viewPort() ||
+            !inherited_equal(fInherited, ctx.presentationContext().fInherited)) {
+            return false;
+        }
+        for (const auto& dep : fDependencies) {
+            if (dep.first->generation() != dep.second) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
 SkSVGNode::SkSVGNode(SkSVGTag t) : fTag(t) { }
 
 SkSVGNode::~SkSVGNode() { }
 
 void SkSVGNode::render(const SkSVGRenderContext& ctx) const {
-    SkSVGRenderContext localContext(ctx);
+    if (!this->hasChildren()) {
+        SkSVGRenderContext localContext(ctx);
 
-    if (this->onPrepareToRender(&localContext)) {
-        this->onRender(localContext);
+        if (this->onPrepareToRender(&localContext)) {
+            this->onRender(localContext);
+        }
+        return;
+    }
+
+    if (!fRenderCache || !fRenderCache->isValidFor(ctx)) {
+        auto cache = skstd::make_unique<RenderCache>();
+        cache->fViewport = ctx.lengthContext().viewPort();
+        cache->fInherited = ctx.presentationContext().fInherited;
+        cache->fDependencies = ctx.presentationContext().fFillDependencies;
+        cache->fDependencies.insert(cache->fDependencies.end(),
+                                    ctx.presentationContext().fStrokeDependencies.begin(),
+                                    ctx.presentationContext().fStrokeDependencies.end());
+
+        // Nothing about the subtree depends on the canvas state, so it can be recorded unbounded
+        // and replayed under any matrix and clip.
+        static constexpr SkRect kUnbounded =
+                { SK_ScalarMin, SK_ScalarMin, SK_ScalarMax, SK_ScalarMax };
+        SkPictureRecorder recorder;
+        {
+            SkSVGRenderContext localContext(ctx, recorder.beginRecording(kUnbounded));
+            localContext.setDependencies(&cache->fDependencies);
+
+            if (this->onPrepareToRender(&localContext)) {
+                this->onRender(localContext);
+            }
+        }
+        cache->fPicture = recorder.finishRecordingAsPicture();
+        fRenderCache = std::move(cache);
     }
+
+    // Whatever caches this rendering in turn depends on the same nodes.
+    ctx.addDependencies(fRenderCache->fDependencies);
+    ctx.canvas()->drawPicture(fRenderCache->fPicture);
 }
 
 bool SkSVGNode::asPaint(const SkSVGRenderContext& ctx, SkPaint* paint) const {
@@ -58,6 +137,14 @@ bool SkSVGNode::onPrepareToRender(SkSVGRenderContext* ctx) const {
 
 void SkSVGNode::setAttribute(SkSVGAttribute attr, const SkSVGValue& v) {
     this->onSetAttribute(attr, v);
+    this->invalidate();
+}
+
+void SkSVGNode::invalidate() {
+    for (SkSVGNode* node = this; node; node = node->fParent) {
+        node->fGeneration++;
+        node->fRenderCache.reset();
+    }
 }
 
 void SkSVGNode::setClipPath(const SkSVGClip& clip) {
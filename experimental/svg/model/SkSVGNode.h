@@ -11,6 +11,8 @@
 #include "SkRefCnt.h"
 #include "SkSVGAttribute.h"
 
+#include <memory>
+
 class SkCanvas;
 class SkMatrix;
 class SkPaint;
@@ -45,12 +47,23 @@ public:
 
     virtual void appendChild(sk_sp<SkSVGNode>) = 0;
 
+    // Nodes with children keep a picture of their last rendering, which is replayed for as long
+    // as neither the subtree, what it inherits, nor anything it refers to changes.  Because of
+    // that cache, a DOM must not be rendered on more than one thread at a time.
     void render(const SkSVGRenderContext&) const;
     bool asPaint(const SkSVGRenderContext&, SkPaint*) const;
     SkPath asPath(const SkSVGRenderContext&) const;
 
+    // Invalidates the node's cached rendering, and that of its ancestors.
     void setAttribute(SkSVGAttribute, const SkSVGValue&);
 
+    // The typed setters below (and those of subclasses) leave it to the caller to invalidate()
+    // once it's done making changes.
+    void invalidate();
+
+    // Bumped by each invalidate(), so that nodes referring to this one can tell it changed.
+    uint32_t generation() const { return fGeneration; }
+
     void setClipPath(const SkSVGClip&);
     void setClipRule(const SkSVGFillRule&);
     void setFill(const SkSVGPaint&);
@@ -86,7 +99,15 @@ protected:
     virtual bool hasChildren() const { return false; }
 
 private:
+    friend class SkSVGContainer;  // for fParent
+
+    struct RenderCache;
+
     SkSVGTag                    fTag;
+    SkSVGNode*                  fParent = nullptr;
+    uint32_t                    fGeneration = 0;
+
+    mutable std::unique_ptr<RenderCache> fRenderCache;
 
     // FIXME: this should be sparse
     SkSVGPresentationAttributes fPresentationAttributes;
@@ -103,16 +103,25 @@ SkPaint::Join toSkJoin(const SkSVGLineJoin& join) {
     }
 }
 
-void applySvgPaint(const SkSVGRenderContext& ctx, const SkSVGPaint& svgPaint, SkPaint* p) {
+void applySvgPaint(const SkSVGRenderContext& ctx, const SkSVGPaint& svgPaint, SkPaint* p,
+                   SkSVGDependencies* deps) {
+    deps->clear();
     switch (svgPaint.type()) {
     case SkSVGPaint::Type::kColor:
         p->setColor(SkColorSetA(svgPaint.color(), p->getAlpha()));
         break;
     case SkSVGPaint::Type::kIRI: {
-        const auto* node = ctx.findNodeById(svgPaint.iri());
-        if (!node || !node->asPaint(ctx, p)) {
-            p->setColor(SK_ColorTRANSPARENT);
+        // Keep track of the paint server (and whatever it refers to) along with the paint, so
+        // that cached renderings which inherit the paint can tell when it changes.
+        {
+            SkSVGRenderContext paintContext(ctx);
+            paintContext.setDependencies(deps);
+            const auto* node = paintContext.findNodeById(svgPaint.iri());
+            if (!node || !node->asPaint(paintContext, p)) {
+                p->setColor(SK_ColorTRANSPARENT);
+            }
         }
+        ctx.addDependencies(*deps);
         break;
     }
     case SkSVGPaint::Type::kCurrentColor:
@@ -139,14 +148,14 @@ template <>
 void commitToPaint<SkSVGAttribute::kFill>(const SkSVGPresentationAttributes& attrs,
                                           const SkSVGRenderContext& ctx,
                                           SkSVGPresentationContext* pctx) {
-    applySvgPaint(ctx, *attrs.fFill.get(), &pctx->fFillPaint);
+    applySvgPaint(ctx, *attrs.fFill.get(), &pctx->fFillPaint, &pctx->fFillDependencies);
 }
 
 template <>
 void commitToPaint<SkSVGAttribute::kStroke>(const SkSVGPresentationAttributes& attrs,
                                             const SkSVGRenderContext& ctx,
                                             SkSVGPresentationContext* pctx) {
-    applySvgPaint(ctx, *attrs.fStroke.get(), &pctx->fStrokePaint);
+    applySvgPaint(ctx, *attrs.fStroke.get(), &pctx->fStrokePaint, &pctx->fStrokeDependencies);
 }
 
 template <>
@@ -300,13 +309,17 @@ SkSVGRenderContext::SkSVGRenderContext(const SkSVGRenderContext& other)
     : SkSVGRenderContext(other.fCanvas,
                          other.fIDMapper,
                          *other.fLengthContext,
-                         *other.fPresentationContext) {}
+                         *other.fPresentationContext) {
+    fDependencies = other.fDependencies;
+}
 
 SkSVGRenderContext::SkSVGRenderContext(const SkSVGRenderContext& other, SkCanvas* canvas)
     : SkSVGRenderContext(canvas,
                          other.fIDMapper,
                          *other.fLengthContext,
-                         *other.fPresentationContext) {}
+                         *other.fPresentationContext) {
+    fDependencies = other.fDependencies;
+}
 
 SkSVGRenderContext::~SkSVGRenderContext() {
     fCanvas->restoreToCount(fCanvasSaveCount);
@@ -314,7 +327,19 @@ SkSVGRenderContext::~SkSVGRenderContext() {
 
 const SkSVGNode* SkSVGRenderContext::findNodeById(const SkString& id) const {
     const auto* v = fIDMapper.find(id);
-    return v ? v->get() : nullptr;
+    if (!v) {
+        return nullptr;
+    }
+    if (fDependencies) {
+        fDependencies->push_back({ v->get(), (*v)->generation() });
+    }
+    return v->get();
+}
+
+void SkSVGRenderContext::addDependencies(const SkSVGDependencies& deps) const {
+    if (fDependencies) {
+        fDependencies->insert(fDependencies->end(), deps.begin(), deps.end());
+    }
 }
 
 void SkSVGRenderContext::applyPresentationAttributes(const SkSVGPresentationAttributes& attrs,
@@ -17,8 +17,16 @@
 #include "SkTLazy.h"
 #include "SkTypes.h"
 
+#include <utility>
+#include <vector>
+
 class SkCanvas;
 class SkSVGLength;
+class SkSVGNode;
+
+// Nodes referenced while rendering, each with its generation at the time.  A cached rendering
+// stays valid only as long as none of these change (see SkSVGNode::render()).
+using SkSVGDependencies = std::vector<std::pair<const SkSVGNode*, uint32_t>>;
 
 class SkSVGLengthContext {
 public:
@@ -54,6 +62,10 @@ struct SkSVGPresentationContext {
     // Cached paints, reflecting the current presentation attributes.
     SkPaint fFillPaint;
     SkPaint fStrokePaint;
+
+    // The nodes the cached paints were made from, when they are IRI paints.
+    SkSVGDependencies fFillDependencies;
+    SkSVGDependencies fStrokeDependencies;
 };
 
 class SkSVGRenderContext {
@@ -77,8 +89,13 @@ public:
     };
     void applyPresentationAttributes(const SkSVGPresentationAttributes&, uint32_t flags);
 
+    // Lookups are noted in the dependency list, if there is one.
     const SkSVGNode* findNodeById(const SkString&) const;
 
+    // Sets the list that this context, and contexts copied from it, note their dependencies in.
+    void setDependencies(SkSVGDependencies* deps) { fDependencies = deps; }
+    void addDependencies(const SkSVGDependencies&) const;
+
     const SkPaint* fillPaint() const;
     const SkPaint* strokePaint() const;
 
@@ -104,6 +121,8 @@ private:
 
     // clipPath, if present for the current context (not inherited).
     SkTLazy<SkPath>                               fClipPath;
+
+    SkSVGDependencies*                            fDependencies = nullptr;
 };
 
 #endif // SkSVGRenderContext_DEFINED
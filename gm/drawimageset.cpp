@@ -251,7 +251,57 @@ private:
     SkCanvas::ImageSetEntry fSet[kM * kN];
 };
 
+// This GM draws a ring of sprites, each pair with its own matrix, in one
+// experimental_DrawImageSetV2() call. Neighboring pairs share images.
+class DrawImageSetMatricesGM : public GM {
+private:
+    SkString onShortName() final { return SkString("draw_image_set_matrices"); }
+    SkISize onISize() override { return SkISize::Make(420, 420); }
+    void onOnceBeforeDraw() override {
+        static constexpr SkColor kColors[] = {SK_ColorGREEN, SK_ColorWHITE,
+                                              SK_ColorMAGENTA, SK_ColorWHITE};
+        SkCanvas::ImageSetEntry tiles[kTileCnt];
+        make_image_tiles(kTileW, kTileH, kTileCnt, 1, kColors, tiles);
+        for (int i = 0; i < kSpriteCnt; ++i) {
+            fSet[i] = tiles[(i / 4) % kTileCnt];
+            // The second sprite of each pair sits just outside the first.
+            fSet[i].fDstRect = SkRect::MakeXYWH(-kTileW / 2.f + (i % 2) * (kTileW + 2),
+                                                -kTileH / 2.f, kTileW, kTileH);
+            fSet[i].fAAFlags = SkCanvas::kAll_QuadAAFlags;
+            fSet[i].fAlpha = 0 == (i % 5) ? 0.5f : 1.f;
+            fSet[i].fMatrixIndex = i / 2;
+        }
+        for (int i = 0; i < kSpriteCnt / 2; ++i) {
+            SkScalar angle = 720.f * i / kSpriteCnt;
+            fMatrices[i].setRotate(15.f * (i % 4));
+            fMatrices[i].postTranslate(120, 0);
+            fMatrices[i].postRotate(angle);
+        }
+    }
+
+    void onDraw(SkCanvas* canvas) override {
+        sk_tool_utils::draw_checkerboard(canvas, SK_ColorBLACK, SK_ColorWHITE, 30);
+        canvas->translate(210, 210);
+        canvas->experimental_DrawImageSetV2(fSet, kSpriteCnt, fMatrices, kLow_SkFilterQuality,
+                                            SkBlendMode::kSrcOver);
+        // An entry without a matrix index is only transformed by the canvas matrix.
+        SkCanvas::ImageSetEntry center = fSet[0];
+        center.fMatrixIndex = -1;
+        center.fAlpha = 1.f;
+        canvas->scale(2, 2);
+        canvas->experimental_DrawImageSetV2(&center, 1, nullptr, kLow_SkFilterQuality,
+                                            SkBlendMode::kSrcOver);
+    }
+    static constexpr int kTileCnt = 3;
+    static constexpr int kSpriteCnt = 24;
+    static constexpr int kTileW = 30;
+    static constexpr int kTileH = 40;
+    SkCanvas::ImageSetEntry fSet[kSpriteCnt];
+    SkMatrix fMatrices[kSpriteCnt / 2];
+};
+
 DEF_GM(return new DrawImageSetGM();)
 DEF_GM(return new DrawImageSetRectToRectGM();)
+DEF_GM(return new DrawImageSetMatricesGM();)
 
 }  // namespace skiagm
@@ -21,7 +21,10 @@ class SK_API SkBitmapRegionDecoder {
 public:
 
     enum Strategy {
-        kAndroidCodec_Strategy, // Uses SkAndroidCodec for scaling and subsetting
+        kAndroidCodec_Strategy,      // Uses SkAndroidCodec for scaling and subsetting
+        kTiledAndroidCodec_Strategy, // Like kAndroidCodec_Strategy, but keeps the decoded tiles
+                                     // of each region in SkResourceCache, so that regions which
+                                     // overlap earlier ones only decode what is new
     };
 
     /*
@@ -26,6 +26,7 @@
 
 class SkColorSpace;
 class SkData;
+class SkExecutor;
 class SkFrameHolder;
 class SkPngChunkReader;
 class SkSampler;
@@ -664,6 +665,23 @@ public:
      */
     std::vector<FrameInfo> getFrameInfo();
 
+    /**
+     *  Decode every frame of the image, each into its own buffer, as getPixels() would decode it
+     *  with fFrameIndex set (and fPriorFrame, for frames which draw on top of another).
+     *
+     *  Each independent frame (fRequiredFrame == kNoFrame) starts a run of frames which depend
+     *  on no frame outside it. If executor is non-null, and the encoded data can be read by more
+     *  than one codec at once, runs are decoded concurrently on it, each by its own codec.
+     *  Otherwise the frames are decoded one after another.
+     *
+     *  @param pixels One buffer per frame, getFrameCount() of them, each large enough for info
+     *                at rowBytes.
+     *  @return kSuccess, or the failure of the first run which failed. Frames which were not
+     *          successfully decoded are left undefined.
+     */
+    Result getAllFrames(const SkImageInfo& info, void* const pixels[], size_t rowBytes,
+                        SkExecutor* executor = nullptr);
+
     static constexpr int kRepetitionCountInfinite = -1;
 
     /**
@@ -762,6 +780,13 @@ protected:
         return fStream.get();
     }
 
+    /**
+     *  Returns a new stream over the encoded data, starting at its beginning, from which another
+     *  codec can decode at the same time as this one, or nullptr if there is none. Subclasses
+     *  which keep the stream themselves, rather than giving it to SkCodec, should override this.
+     */
+    virtual std::unique_ptr<SkStream> onDuplicateStream() const;
+
     /**
      *  The remaining functions revolve around decoding scanlines.
      */
@@ -1831,6 +1831,7 @@ public:
         SkRect fDstRect;
         float fAlpha;
         unsigned fAAFlags;  // QuadAAFlags
+        int fMatrixIndex = -1;  // index into experimental_DrawImageSetV2's matrices, or -1
     };
 
     /**
@@ -1844,6 +1845,18 @@ public:
     void experimental_DrawImageSetV1(const ImageSetEntry imageSet[], int cnt,
                                      SkFilterQuality quality, SkBlendMode mode);
 
+    /**
+     * Experimental. Like experimental_DrawImageSetV1, but each entry's dst rect is first mapped by
+     * preViewMatrices[fMatrixIndex] and then by the canvas matrix. Entries with a negative
+     * fMatrixIndex only use the canvas matrix, and preViewMatrices may be null if every entry's
+     * index is negative. Entries may share matrices. This lets sets of arbitrarily transformed
+     * sprites be drawn in a single call; on the GPU backend they batch into as few draws as
+     * drawing them all with one matrix would.
+     */
+    void experimental_DrawImageSetV2(const ImageSetEntry imageSet[], int cnt,
+                                     const SkMatrix preViewMatrices[], SkFilterQuality quality,
+                                     SkBlendMode mode);
+
     /** Draws text, with origin at (x, y), using clip, SkMatrix, and SkPaint paint.
 
         text meaning depends on SkTextEncoding; by default, text is encoded as
@@ -2474,8 +2487,8 @@ protected:
     virtual void onDrawImageLattice(const SkImage* image, const Lattice& lattice, const SkRect& dst,
                                     const SkPaint* paint);
 
-    virtual void onDrawImageSet(const ImageSetEntry imageSet[], int count, SkFilterQuality,
-                                SkBlendMode);
+    virtual void onDrawImageSet(const ImageSetEntry imageSet[], int count,
+                                const SkMatrix preViewMatrices[], SkFilterQuality, SkBlendMode);
 
     virtual void onDrawBitmap(const SkBitmap& bitmap, SkScalar dx, SkScalar dy,
                               const SkPaint* paint);
@@ -2577,6 +2590,12 @@ private:
         this->predrawNotify(rect, paint, shaderOverrideIsOpaque ? kOpaque_ShaderOverrideOpacity
                                                                 : kNotOpaque_ShaderOverrideOpacity);
     }
+    // bounds (in local space, before the paint) may be null if the draw isn't bounded.
+    void predrawNotify(const SkRect* bounds, const SkPaint& paint);
+    // If our surface tracks which of its pixels change, computes the device-space bounds the draw
+    // may touch into storage and returns it; otherwise returns null.
+    const SkIRect* computeDirtyBounds(const SkRect* bounds, const SkPaint* paint,
+                                      SkIRect* storage) const;
 
     SkBaseDevice* getDevice() const;
 
@@ -2613,6 +2632,7 @@ private:
 
     void doSave();
     void checkForDeferredSave();
+    void checkForDeferredDeviceSave();
     void internalSetMatrix(const SkMatrix&);
 
     friend class SkAndroidFrameworkUtils;
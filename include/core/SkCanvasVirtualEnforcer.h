@@ -61,11 +61,11 @@ protected:
 #ifdef SK_BUILD_FOR_ANDROID_FRAMEWORK
     // This is under active development for Chrome and not used in Android. Hold off on adding
     // implementations in Android's SkCanvas subclasses until this stabilizes.
-    void onDrawImageSet(const SkCanvas::ImageSetEntry[], int count, SkFilterQuality,
-                        SkBlendMode) override {};
+    void onDrawImageSet(const SkCanvas::ImageSetEntry[], int count, const SkMatrix[],
+                        SkFilterQuality, SkBlendMode) override {};
 #else
-    void onDrawImageSet(const SkCanvas::ImageSetEntry[], int count, SkFilterQuality,
-                        SkBlendMode) override = 0;
+    void onDrawImageSet(const SkCanvas::ImageSetEntry[], int count, const SkMatrix[],
+                        SkFilterQuality, SkBlendMode) override = 0;
 #endif
 
     void onDrawBitmap(const SkBitmap& bitmap, SkScalar dx, SkScalar dy,
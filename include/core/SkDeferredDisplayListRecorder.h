@@ -20,8 +20,12 @@ class GrBackendTexture;
 class GrContext;
 
 class SkCanvas;
+class SkExecutor;
 class SkImage;
+class SkNWayCanvas;
+class SkPictureRecorder;
 class SkSurface;
+struct SkDeserialProcs;
 struct SkYUVAIndex;
 struct SkYUVASizeInfo;
 
@@ -39,7 +43,15 @@ struct SkYUVASizeInfo;
  */
 class SK_API SkDeferredDisplayListRecorder {
 public:
-    SkDeferredDisplayListRecorder(const SkSurfaceCharacterization&);
+    /**
+     * With kYes, what is drawn into the canvas is also recorded in a portable form, so that the
+     * detached display list can be serialized (see SkDeferredDisplayList::serialize()). This
+     * costs a second recording of every draw.
+     */
+    enum class Serializable : bool { kNo = false, kYes = true };
+
+    SkDeferredDisplayListRecorder(const SkSurfaceCharacterization&,
+                                  Serializable = Serializable::kNo);
     ~SkDeferredDisplayListRecorder();
 
     const SkSurfaceCharacterization& characterization() const {
@@ -53,11 +65,48 @@ public:
 
     std::unique_ptr<SkDeferredDisplayList> detach();
 
+    /**
+     * Draws a display list written by SkDeferredDisplayList::serialize() into this recorder's
+     * canvas. Promise images it refers to can be recreated by procs' image proc calling this
+     * recorder's makePromiseTexture(). Returns false if the data is malformed or was recorded for
+     * a surface of a different size.
+     */
+    bool playback(const void* data, size_t length, const SkDeserialProcs* procs = nullptr);
+
     // Matches the defines in SkImage_GpuBase.h
     typedef void* TextureContext;
     typedef void (*TextureReleaseProc)(TextureContext textureContext);
     typedef void (*TextureFulfillProc)(TextureContext textureContext, GrBackendTexture* outTexture);
     typedef void (*PromiseDoneProc)(TextureContext textureContext);
+    typedef void (*TextureBatchFulfillProc)(void* batchContext,
+                                            const TextureContext textureContexts[],
+                                            GrBackendTexture outTextures[], int count);
+    typedef void (*TextureBatchReleaseProc)(void* batchContext,
+                                            const TextureContext textureContexts[], int count);
+
+    /**
+        Promise images made by this recorder after this call have their textures fulfilled and
+        released in batches, with textureBatchFulfillProc and textureBatchReleaseProc in place of
+        their textureFulfillProc and textureReleaseProc (which may then be nullptr).
+
+        When a flush replays display lists detached from this recorder, it calls
+        textureBatchFulfillProc once, before drawing, with every one of their promise textures
+        that isn't already fulfilled. The client fills in outTextures[i] for textureContexts[i].
+        Textures released during the flush are handed to textureBatchReleaseProc together at its
+        end. If releaseExecutor is set, textureBatchReleaseProc is called there, so the flush does
+        not wait for the client to free its textures, and promiseDoneProc may then be called
+        there too; the recorder's releaseExecutor must outlive its promise images. A texture
+        fulfilled for a flush that didn't draw it is released at its end.
+
+        Each textureContext is still fulfilled and released in pairs, though with a
+        releaseExecutor its release may reach the client after it is next fulfilled.
+        promiseDoneProc is still called only after its last release. Passing nullptr for
+        textureBatchFulfillProc returns to per image procs.
+     */
+    void setPromiseTextureBatchProcs(TextureBatchFulfillProc textureBatchFulfillProc,
+                                     TextureBatchReleaseProc textureBatchReleaseProc,
+                                     void* batchContext,
+                                     SkExecutor* releaseExecutor = nullptr);
 
     /**
         Create a new SkImage that is very similar to an SkImage created by MakeFromTexture. The main
@@ -154,11 +203,19 @@ private:
     bool init();
 
     const SkSurfaceCharacterization             fCharacterization;
+    const Serializable                          fSerializable;
 
 #if SK_SUPPORT_GPU
     sk_sp<GrContext>                            fContext;
     sk_sp<SkDeferredDisplayList::LazyProxyData> fLazyProxyData;
     sk_sp<SkSurface>                            fSurface;
+    // When serializable, the canvas we hand out draws into both fSurface and fPictureRecorder.
+    std::unique_ptr<SkPictureRecorder>          fPictureRecorder;
+    std::unique_ptr<SkNWayCanvas>               fTeeCanvas;
+    // Set by setPromiseTextureBatchProcs().
+    sk_sp<GrPromiseTextureBatcher>              fPromiseBatcher;
+    // Promise textures made with earlier batch procs, for the next DDL.
+    SkTArray<sk_sp<GrPromiseTextureBatcher::Texture>> fPromiseTextures;
 #endif
 };
 
@@ -19,6 +19,10 @@ public:
     static std::unique_ptr<SkExecutor> MakeFIFOThreadPool(int threads = 0);
     static std::unique_ptr<SkExecutor> MakeLIFOThreadPool(int threads = 0);
 
+    // Like a LIFO thread pool, but each thread keeps the work it adds to itself, stealing from
+    // the others only when it runs out.  This scales better with many small, nested tasks.
+    static std::unique_ptr<SkExecutor> MakeWorkStealingPool(int threads = 0);
+
     // There is always a default SkExecutor available by calling SkExecutor::GetDefault().
     static SkExecutor& GetDefault();
     static void SetDefault(SkExecutor*);  // Does not take ownership.  Not thread safe.
@@ -26,6 +30,20 @@ public:
     // Add work to execute.
     virtual void add(std::function<void(void)>) = 0;
 
+    // Work of a higher priority is started before any of lower priority that is still waiting.
+    // Nothing is interrupted, so work should come in small enough pieces for this to matter.
+    enum class Priority {
+        kFrameCritical,  // The current frame is waiting on it, e.g. drawing its tiles.
+        kNormal,         // What add() uses.
+        kBackground,     // Nothing is waiting on it yet, e.g. prefetching images.
+    };
+    static constexpr int kPriorityCount = 3;
+
+    // Add work to execute at a priority.  By default this ignores the priority and calls add().
+    virtual void addWithPriority(std::function<void(void)> work, Priority) {
+        this->add(std::move(work));
+    }
+
     // If it makes sense for this executor, use this thread to execute work for a little while.
     virtual void borrow() {}
 };
@@ -11,6 +11,7 @@
 #include "SkRefCnt.h"
 
 class SkData;
+class SkExecutor;
 class SkImageGenerator;
 class SkTraceMemoryDump;
 
@@ -96,6 +97,19 @@ public:
      */
     static int SetFontCachePointSizeLimit(int maxPointSize);
 
+    /**
+     *  Returns the executor on which glyph images that are missing from the font cache are
+     *  rasterized, or nullptr if they are rasterized on the drawing thread.
+     */
+    static SkExecutor* GetFontCacheRasterExecutor();
+
+    /**
+     *  Set the executor on which the glyph images of a text run that are missing from the font
+     *  cache are rasterized in parallel, returning the previous one. Does not take ownership; the
+     *  executor must outlive its use. nullptr (the default) rasterizes them on the drawing thread.
+     */
+    static SkExecutor* SetFontCacheRasterExecutor(SkExecutor* executor);
+
     /**
      *  For debugging purposes, this will attempt to purge the font cache. It
      *  does not change the limit, but will cause subsequent font measures and
@@ -137,12 +151,54 @@ public:
     static size_t GetResourceCacheSingleAllocationByteLimit();
     static size_t SetResourceCacheSingleAllocationByteLimit(size_t newLimit);
 
+    /**
+     *  Raster blitters look up the stage functions for their SkRasterPipeline in a process-wide
+     *  cache. These return the number of entries in that cache, and the number of times a
+     *  lookup found an entry (hit) or had to pick the stages itself (miss), to help size it.
+     */
+    static int GetRasterPipelineCacheCountUsed();
+    static int GetRasterPipelineCacheHitCount();
+    static int GetRasterPipelineCacheMissCount();
+
+    /**
+     *  For debugging purposes, this will empty the raster pipeline cache. The hit and miss
+     *  counts are not reset.
+     */
+    static void PurgeRasterPipelineCache();
+
     /**
      *  Dumps memory usage of caches using the SkTraceMemoryDump interface. See SkTraceMemoryDump
      *  for usage of this method.
      */
     static void DumpMemoryStatistics(SkTraceMemoryDump* dump);
 
+    /**
+     *  Bytes held by allocators other than the caches, kept up to date as they change. Reading
+     *  them is cheap enough to poll every second. The GPU counters sum over every GrContext in
+     *  the process. DumpMemoryStatistics() reports these too.
+     */
+    struct MemoryCounters {
+        enum Counter {
+            kArenaAlloc,         // Heap blocks in use by SkArenaAllocs.
+            kPathRef,            // Point and verb storage of live paths.
+            kPicture,            // Recorded ops and bounding box hierarchies of live pictures.
+            kGrOpMemoryPool,     // Blocks of the pools that GrOps are allocated from.
+            kGrBufferAllocPool,  // Vertex and index buffers held by GrBufferAllocPools.
+            kGrDrawOpAtlas,      // Active pages of the glyph and other GrDrawOpAtlases.
+            kGrCCAtlas,          // Textures of the coverage counting path renderer's atlases.
+
+            kLast_Counter = kGrCCAtlas
+        };
+        static constexpr int kCounterCount = kLast_Counter + 1;
+
+        static const char* Name(Counter);
+
+        size_t fBytes[kCounterCount];      // Held now.
+        size_t fPeakBytes[kCounterCount];  // The most ever held at once.
+    };
+
+    static void GetMemoryCounters(MemoryCounters*);
+
     /**
      *  Free as much globally cached memory as possible. This will purge all private caches in Skia,
      *  including font and image caches.
@@ -151,6 +207,40 @@ public:
      */
     static void PurgeAllCaches();
 
+    /**
+     *  How urgently PurgeForMemoryPressure() should free memory.
+     */
+    enum class MemoryPressureLevel {
+        kModerate,  // Free about the bytes asked for, least recently used first.
+        kCritical,  // Free everything that can be freed.
+    };
+
+    /**
+     *  How much each of the global caches freed in PurgeForMemoryPressure().
+     */
+    struct MemoryPressureResult {
+        size_t fResourceCacheBytes = 0;  // Decoded and scaled images, mipmaps, masks, ...
+        size_t fFontCacheBytes     = 0;  // Glyph images and paths.
+        int    fTypefaceCount      = 0;  // Typefaces only the cache referred to; sizes unknown.
+
+        size_t totalBytes() const { return fResourceCacheBytes + fFontCacheBytes; }
+    };
+
+    /**
+     *  Frees globally cached memory, e.g. in response to a low memory or cgroup memory.high
+     *  event, and reports how much each cache freed.
+     *
+     *  kModerate frees at least bytesToFree from the resource cache, then, if that was not
+     *  enough, the rest from the font cache (which frees at least a quarter of itself when it
+     *  frees anything). kCritical ignores bytesToFree and empties both caches as well as the
+     *  typeface, image filter and raster pipeline caches. Entries in use are never freed.
+     *
+     *  Caches associated with a GPU context are not affected by this call; see
+     *  GrContext::purgeForMemoryPressure().
+     */
+    static MemoryPressureResult PurgeForMemoryPressure(MemoryPressureLevel level,
+                                                       size_t bytesToFree);
+
     /**
      *  Applications with command line options may pass optional state, such
      *  as cache sizes, here, for instance:
@@ -897,6 +897,22 @@ public:
     sk_sp<SkImage> makeTextureImage(GrContext* context, SkColorSpace* dstColorSpace,
                                     GrMipMapped mipMapped = GrMipMapped::kNo) const;
 
+    /** Like makeTextureImage(), but returns without uploading pixels, so that images can be
+        prepared for a later frame without blocking the current one. For raster images, and
+        lazy images of encoded data, the returned SkImage's texture is created and uploaded by
+        the first flush that draws it. If context was made with an SkExecutor, decoding,
+        conversion and mip map building run on its threads in the meantime.
+
+        Drawing the returned SkImage, or for a raster image the original SkImage, before then
+        uses the same pending upload. Other images are made as by makeTextureImage().
+
+        @param context    GPU context
+        @param mipMapped  whether created SkImage texture must allocate mip map levels
+        @return           created SkImage, or nullptr
+    */
+    sk_sp<SkImage> makeTextureImageAsync(GrContext* context,
+                                         GrMipMapped mipMapped = GrMipMapped::kNo) const;
+
     /** Returns raster image or lazy image. Copies SkImage backed by GPU texture into
         CPU memory if needed. Returns original SkImage if decoded in raster bitmap,
         or if encoded in a stream.
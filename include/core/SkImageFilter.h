@@ -198,6 +198,13 @@ public:
      */
     bool asAColorFilter(SkColorFilter** filterPtr) const;
 
+    /**
+     *  Returns true (and optionally returns the offset in local coordinates) if this imagefilter
+     *  just moves its source w/o CropRect constraints. Drawing with it then matches drawing
+     *  without it, moved by the offset mapped to device space and rounded to whole pixels.
+     */
+    bool asAnOffset(SkVector* offset) const;
+
     /**
      *  Returns the number of inputs this filter will accept (some inputs can
      *  be NULL).
@@ -380,6 +387,12 @@ protected:
                                       const Context&,
                                       SkIPoint* offset) const;
 
+    // Calls filterInput() for every input, storing the images in "results" and their offsets in
+    // "offsets" (both countInputs() long). For raster sources, independent inputs are filtered in
+    // parallel on the default SkExecutor, and an input used more than once is filtered once.
+    void filterInputs(SkSpecialImage* src, const Context&,
+                      sk_sp<SkSpecialImage> results[], SkIPoint offsets[]) const;
+
     /**
      *  Return true (and return a ref'd colorfilter) if this node in the DAG is just a
      *  colorfilter w/o CropRect constraints.
@@ -388,6 +401,14 @@ protected:
         return false;
     }
 
+    /**
+     *  Return true (and return the offset) if this node in the DAG just offsets its input w/o
+     *  CropRect constraints.
+     */
+    virtual bool onIsOffsetNode(SkVector* /*offset*/) const {
+        return false;
+    }
+
     /**
      *  Override this to describe the behavior of your subclass - as a leaf node. The caller will
      *  take care of calling your inputs (and return false if any of them could not handle it).
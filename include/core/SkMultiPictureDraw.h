@@ -14,6 +14,8 @@
 class SkCanvas;
 class SkPaint;
 class SkPicture;
+class SkPixmap;
+class SkSurfaceProps;
 
 /** \class SkMultiPictureDraw
 
@@ -55,6 +57,25 @@ public:
      */
     void reset();
 
+    /**
+     *  Draw a single picture into raster pixels, in parallel. dst is split into tiles of
+     *  tileSize x tileSize pixels, and each tile is drawn on SkExecutor::GetDefault() by
+     *  its own canvas onto just that tile of dst. If the picture was recorded with a bounding
+     *  box hierarchy, each tile only replays the ops that intersect it. Layers (saveLayer,
+     *  image filters) are allocated per tile, sized to what the tile needs. The result matches
+     *  drawing the picture into dst on a single canvas, except that edges crossing a tile
+     *  boundary may round differently, as they would against any clip.
+     *
+     *  @param dst       the pixels to draw into
+     *  @param picture   the picture to draw
+     *  @param matrix    if non-NULL, applied to the CTM when drawing
+     *  @param tileSize  width and height of the tiles, in pixels
+     *  @param props     if non-NULL, the surface properties of the tile canvases
+     */
+    static void DrawTiled(const SkPixmap& dst, const SkPicture* picture,
+                          const SkMatrix* matrix = nullptr, int tileSize = 256,
+                          const SkSurfaceProps* props = nullptr);
+
 private:
     struct DrawData {
         SkCanvas*        fCanvas;
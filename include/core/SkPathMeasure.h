@@ -11,6 +11,7 @@
 #include "../private/SkNoncopyable.h"
 #include "../private/SkTDArray.h"
 #include "SkPath.h"
+#include "SkRefCnt.h"
 
 struct SkConic;
 
@@ -84,6 +85,11 @@ public:
 #endif
 
 private:
+    // The measurements of every contour of a path, shareable between measures of that path.
+    // See SkPathMeasureCache.
+    class Table;
+    friend class SkPathMeasureCache;
+
     SkPath::Iter    fIter;
     SkPath          fPath;
     SkScalar        fTolerance;
@@ -106,8 +112,22 @@ private:
     SkTDArray<Segment>  fSegments;
     SkTDArray<SkPoint>  fPts; // Points used to define the segments
 
+    // If set, the segments and points come from here, and fSegments and fPts are unused.
+    sk_sp<const Table>  fTable;
+    int                 fContourIndex;
+
     static const Segment* NextSegment(const Segment*);
 
+    // Measures every contour of the path.
+    static sk_sp<const Table> MeasureAll(const SkPath&, bool forceClosed, SkScalar resScale);
+    void setResScale(SkScalar resScale);
+    void setTable(sk_sp<const Table>);
+    void setContour(int index);
+
+    const Segment* segments() const;
+    int segmentCount() const;
+    const SkPoint* points() const;
+
     void     buildSegments();
     SkScalar compute_quad_segs(const SkPoint pts[3], SkScalar distance,
                                 int mint, int maxt, unsigned ptIndex);
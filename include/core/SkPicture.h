@@ -22,10 +22,13 @@
 #include "SkRect.h"
 #include "SkTypes.h"
 
+class GrContext;
 class SkCanvas;
 class SkData;
 struct SkDeserialProcs;
+class SkExecutor;
 class SkImage;
+class SkMatrix;
 struct SkSerialProcs;
 class SkStream;
 class SkWStream;
@@ -87,6 +90,20 @@ public:
     static sk_sp<SkPicture> MakeFromData(const void* data, size_t size,
                                          const SkDeserialProcs* procs = nullptr);
 
+    /** Recreates SkPicture that was serialized into the file at path, memory-mapping the file
+        instead of reading it. Encoded images and other large byte arrays are referenced in
+        place in the mapping rather than copied, and images are decoded lazily when drawn, so
+        loading a large picture is faster and keeps less of it resident. The mapping stays
+        alive as long as anything returned from it does. Returns nullptr if the file cannot
+        be mapped or does not contain a valid SkPicture.
+
+        @param path   file containing serial data
+        @param procs  custom serial data decoders; may be nullptr
+        @return       SkPicture constructed from the file
+    */
+    static sk_sp<SkPicture> MakeFromFile(const char path[],
+                                         const SkDeserialProcs* procs = nullptr);
+
     /** \class SkPicture::AbortCallback
         AbortCallback is an abstract class. An implementation of AbortCallback may
         passed as a parameter to SkPicture::playback, to stop it before all drawing
@@ -203,6 +220,24 @@ public:
     */
     virtual size_t approximateBytesUsed() const = 0;
 
+    /** Decodes the lazily generated SkImage drawn by SkPicture within clip, when played back
+        with matrix, so that playback need not stop to decode them. Pixels are left in the
+        caches drawing looks in: as a mipmap too, down to the level needed, for an image drawn
+        smaller with kMedium_SkFilterQuality or better, and as a texture if context is not
+        nullptr.
+
+        Images are decoded in parallel on executor at SkExecutor::Priority::kBackground, or one
+        after another on this thread if executor is nullptr. Textures are made on this thread,
+        which must be one context may be used from. Returns when every image is decoded.
+
+        @param executor  runs decodes; may be nullptr
+        @param matrix    SkMatrix SkPicture will be played back with
+        @param clip      device bounds SkPicture will be played back into
+        @param context   GPU context SkPicture will be played back into; may be nullptr
+    */
+    void prefetchImages(SkExecutor* executor, const SkMatrix& matrix, const SkRect& clip,
+                        GrContext* context = nullptr) const;
+
 private:
     // Subclass whitelist.
     SkPicture();
@@ -212,8 +247,11 @@ private:
     template <typename> friend class SkMiniPicture;
 
     void serialize(SkWStream*, const SkSerialProcs*, class SkRefCntSet* typefaces) const;
+    // If mapped is not null, stream reads its bytes from the start and the picture may keep
+    // references into it instead of copying.
     static sk_sp<SkPicture> MakeFromStream(SkStream*, const SkDeserialProcs*,
-                                           class SkTypefacePlayback*);
+                                           class SkTypefacePlayback*,
+                                           const SkData* mapped = nullptr);
     friend class SkPictureData;
 
     /** Return true if the SkStream/Buffer represents a serialized picture, and
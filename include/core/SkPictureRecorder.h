@@ -36,9 +36,20 @@ public:
         // If you call drawPicture() or drawDrawable() on the recording canvas, this flag forces
         // that object to playback its contents immediately rather than reffing the object.
         kPlaybackDrawPicture_RecordFlag     = 1 << 0,
+
+        // Paths and text blobs drawn with the same contents as ones already recorded share the
+        // recorded copy, even if they were built separately. This costs a hash of each path and
+        // blob, and pays off when the same content is rebuilt for many draws: the picture is
+        // smaller, and playback caches keyed on a path's or blob's ID hit more often.
+        kDedupeContent_RecordFlag           = 1 << 1,
     };
 
     enum FinishFlags {
+        // Spend more time finishing the recording to make it cheaper to play back: merge runs of
+        // similar rect and image draws into batched draws, drop draws hidden by later opaque
+        // rects, and drop redundant translates and clip rects. Batched draws may rasterize a
+        // little differently than the draws they replace under scaling or rotating matrices.
+        kOptimizeDrawCalls_FinishFlag       = 1 << 0,
     };
 
     /** Returns the canvas that records the drawing commands.
@@ -67,6 +67,13 @@ struct SK_API SkDeserialProcs {
 
     SkDeserialTypefaceProc  fTypefaceProc = nullptr;
     void*                   fTypefaceCtx = nullptr;
+
+    /**
+     *  Set this only when the data was serialized by this same build of Skia and has not left
+     *  the process (e.g. a picture round-tripped through memory). Reading then skips the bounds,
+     *  alignment and range checks made on every value, so malformed data is undefined behavior.
+     */
+    bool                    fTrusted = false;
 };
 
 #endif
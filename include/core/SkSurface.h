@@ -26,6 +26,7 @@
 
 class SkCanvas;
 class SkDeferredDisplayList;
+class SkExecutor;
 class SkPaint;
 class SkSurfaceCharacterization;
 class GrBackendRenderTarget;
@@ -144,6 +145,30 @@ public:
         return MakeRaster(imageInfo, 0, props);
     }
 
+    /** Allocates raster SkSurface. SkCanvas returned by SkSurface records draws, and rasterizes
+        them in parallel on executor in horizontal bands when pixels are read, written or
+        snapped, and when SkCanvas::flush() is called.
+        Allocates and zeroes pixel memory. Pixel memory size is imageInfo.height() times
+        imageInfo.minRowBytes().
+        Pixel memory is deleted when SkSurface is deleted.
+
+        Drawing produces the same pixels as SkSurface returned by MakeRaster().
+
+        SkSurface is returned if all parameters are valid.
+        Valid parameters include:
+        info dimensions are greater than zero;
+        info contains SkColorType and SkAlphaType supported by raster surface.
+
+        @param imageInfo  width, height, SkColorType, SkAlphaType, SkColorSpace,
+                          of raster surface; width and height must be greater than zero
+        @param executor   runs rasterization tasks; may be nullptr to use SkExecutor::GetDefault()
+        @param props      LCD striping orientation and setting for device independent fonts;
+                          may be nullptr
+        @return           SkSurface if all parameters are valid; otherwise, nullptr
+    */
+    static sk_sp<SkSurface> MakeRasterThreaded(const SkImageInfo& imageInfo, SkExecutor* executor,
+                                               const SkSurfaceProps* props = nullptr);
+
     /** Allocates raster SkSurface. SkCanvas returned by SkSurface draws directly into pixels.
         Allocates and zeroes pixel memory. Pixel memory size is height times width times
         four. Pixel memory is deleted when SkSurface is deleted.
@@ -621,6 +646,69 @@ public:
     */
     bool readPixels(const SkBitmap& dst, int srcX, int srcY);
 
+    /** Client-provided context that is passed to the callbacks of the asynchronous reads. */
+    typedef void* ReadPixelsContext;
+
+    /** Called by asyncRescaleAndReadPixels() with the read pixels and their row bytes, or with
+        nullptr if the read failed. The pixels are only valid for the duration of the call.
+    */
+    typedef void (*ReadPixelsCallback)(ReadPixelsContext context, const void* data,
+                                       size_t rowBytes);
+
+    /** Called by asyncRescaleAndReadPixelsYUV420() with the Y, U and V planes and their row
+        bytes, or with nullptr for both if the read failed. The planes are only valid for the
+        duration of the call.
+    */
+    typedef void (*ReadPixelsCallbackYUV420)(ReadPixelsContext context, const void* data[3],
+                                             size_t rowBytes[3]);
+
+    /** Reads srcRect of the surface, rescaled to info's dimensions and converted to its
+        SkColorType, SkAlphaType and SkColorSpace, and passes the pixels to callback.
+
+        On a GPU-backed surface the rescale and conversions are done with GPU draws, and the
+        pixels are read back without waiting for the GPU: callback is called once the GPU has
+        finished, at the end of a later flush or from GrContext::checkAsyncWorkCompletion().
+        If the GrContext is abandoned or destroyed first, callback is called with nullptr.
+        Other surfaces call callback before returning.
+
+        The rescale uses quality: kNone_SkFilterQuality samples the nearest pixel,
+        kLow_SkFilterQuality filters bilinearly, kMedium_SkFilterQuality filters bilinearly in
+        steps that at most halve each dimension, and kHigh_SkFilterQuality filters the last of
+        those steps bicubically.
+
+        @param info      dimensions and pixel format of the pixels passed to callback
+        @param srcRect   rectangle of the surface to read; must be contained by its bounds
+        @param quality   filtering for the rescale
+        @param callback  called with the pixels, or with nullptr on failure
+        @param context   passed to callback
+    */
+    void asyncRescaleAndReadPixels(const SkImageInfo& info, const SkIRect& srcRect,
+                                   SkFilterQuality quality, ReadPixelsCallback callback,
+                                   ReadPixelsContext context);
+
+    /** Like asyncRescaleAndReadPixels(), but passes callback I420 planes: the pixels are
+        converted to dstColorSpace, and then to Y, U and V with yuvColorSpace's coefficients. The
+        Y plane is dstW by dstH, and the U and V planes are subsampled by two in both dimensions,
+        rounding up. Each plane has one byte per pixel.
+
+        Only GPU-backed surfaces support this; other surfaces call callback with nullptr.
+
+        @param yuvColorSpace  the conversion from RGB to YUV, and its range
+        @param dstColorSpace  color space to convert the pixels to before computing YUV
+        @param srcRect        rectangle of the surface to read; must be contained by its bounds
+        @param dstW           width of the Y plane
+        @param dstH           height of the Y plane
+        @param quality        filtering for the rescale
+        @param callback       called with the planes, or with nullptr on failure
+        @param context        passed to callback
+    */
+    void asyncRescaleAndReadPixelsYUV420(SkYUVColorSpace yuvColorSpace,
+                                         sk_sp<SkColorSpace> dstColorSpace,
+                                         const SkIRect& srcRect, int dstW, int dstH,
+                                         SkFilterQuality quality,
+                                         ReadPixelsCallbackYUV420 callback,
+                                         ReadPixelsContext context);
+
     /** Copies SkRect of pixels from the src SkPixmap to the SkSurface.
 
         Source SkRect corners are (0, 0) and (src.width(), src.height()).
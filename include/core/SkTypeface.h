@@ -17,6 +17,8 @@
 #include "SkRect.h"
 #include "SkString.h"
 
+#include <memory>
+
 class SkData;
 class SkDescriptor;
 class SkFontData;
@@ -24,6 +26,7 @@ class SkFontDescriptor;
 class SkScalerContext;
 class SkStream;
 class SkStreamAsset;
+class SkUnicharToGlyphCache;
 class SkWStream;
 struct SkAdvancedTypefaceMetrics;
 struct SkScalerContextEffects;
@@ -438,6 +441,8 @@ private:
     friend class SkFontPriv;       // GetDefaultTypeface
     friend class SkPaintPriv;      // GetDefaultTypeface
 
+    void unicharsToGlyphs(const SkUnichar unichars[], int count, SkGlyphID glyphs[]) const;
+
 private:
     SkFontID            fUniqueID;
     SkFontStyle         fStyle;
@@ -445,6 +450,10 @@ private:
     mutable SkOnce      fBoundsOnce;
     bool                fIsFixedPitch;
 
+    // Caches onCharsToGlyphs() for the BMP. Created by the first charsToGlyphs().
+    mutable std::unique_ptr<SkUnicharToGlyphCache> fUnicharToGlyphCache;
+    mutable SkOnce                                 fUnicharToGlyphCacheOnce;
+
     typedef SkWeakRefCnt INHERITED;
 };
 #endif
@@ -9,6 +9,8 @@
 #include "SkString.h"
 #include "SkTime.h"
 
+class SkExecutor;
+
 namespace SkPDF {
 
 /** Table 333 in PDF 32000-1:2008
@@ -72,6 +74,20 @@ struct StructureElementNode {
     DocumentStructureType fType;
 };
 
+/** Font data that PDF documents can share, so that documents using the same typefaces don't
+    each work it out again: each typeface's metrics and glyph to unicode map, and for each set of
+    glyphs used, the font subset, glyph widths and ToUnicode CMap.  Any number of documents, on
+    any threads, may use one cache at once.  Once it holds byteLimit bytes, the least recently
+    used entries are dropped to make room.
+*/
+class SK_API FontCache : public SkRefCnt {
+public:
+    static sk_sp<FontCache> Make(size_t byteLimit = 32 * 1024 * 1024);
+
+    virtual size_t bytesUsed() const = 0;
+    virtual void purgeAll() = 0;
+};
+
 /** Optional metadata to be passed into the PDF factory function.
 */
 struct Metadata {
@@ -141,6 +157,22 @@ struct Metadata {
      *  should retain ownership.
      */
     const StructureElementNode* fStructureElementTreeRoot = nullptr;
+
+    /** Executor to handle threaded work within PDF Backend. If this is nullptr,
+        then all work will be done serially on the main thread. To have worker
+        threads assist with various tasks, set this to a valid SkExecutor
+        instance. Currently used for executing page content stream compression,
+        image encoding and font subsetting. Object numbers, and therefore the
+        cross reference table entries, are assigned on the calling thread and
+        do not depend on the executor. The caller retains ownership and must
+        keep the executor alive until the document is closed or aborted.
+    */
+    SkExecutor* fExecutor = nullptr;
+
+    /** Optional cache of font data shared with other documents (see FontCache).  Without one,
+        each document works out the font data it needs itself.
+    */
+    sk_sp<FontCache> fFontCache;
 };
 
 /** Associate a node ID with subsequent drawing commands in an
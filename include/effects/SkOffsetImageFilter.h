@@ -27,6 +27,7 @@ protected:
     sk_sp<SkImageFilter> onMakeColorSpace(SkColorSpaceXformer*) const override;
     SkIRect onFilterNodeBounds(const SkIRect&, const SkMatrix& ctm,
                                MapDirection, const SkIRect* inputRect) const override;
+    bool onIsOffsetNode(SkVector* offset) const override;
 
 private:
     SK_FLATTENABLE_HOOKS(SkOffsetImageFilter)
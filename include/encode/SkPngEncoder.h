@@ -12,6 +12,7 @@
 #include "SkDataTable.h"
 
 class SkPngEncoderMgr;
+class SkExecutor;
 class SkWStream;
 
 class SK_API SkPngEncoder : public SkEncoder {
@@ -31,10 +32,10 @@ public:
         /**
          *  Selects which filtering strategies to use.
          *
-         *  If a single filter is chosen, libpng will use that filter for every row.
+         *  If a single filter is chosen, that filter is used for every row.
          *
-         *  If multiple filters are chosen, libpng will use a heuristic to guess which filter
-         *  will encode smallest, then apply that filter.  This happens on a per row basis,
+         *  If multiple filters are chosen, libpng's heuristic is used to guess which filter
+         *  will encode smallest, then that filter is applied.  This happens on a per row basis,
          *  different rows can use different filters.
          *
          *  Using a single filter (or less filters) is typically faster.  Trying all of the
@@ -53,12 +54,44 @@ public:
          */
         int fZLibLevel = 6;
 
+        enum class ZLibStrategy {
+            /** Let zlib look for any repeated data, tuned for filtered rows as libpng does. */
+            kDefault,
+            /**
+             *  Only look for runs of the same byte.  After filtering, flat areas are runs of
+             *  zeros, so this suits images made mostly of them, like screenshots, but it can be
+             *  much bigger for photographs and gradients.
+             */
+            kRLE,
+        };
+        ZLibStrategy fZLibStrategy = ZLibStrategy::kDefault;
+
         /**
          *  Represents comments in the tEXt ancillary chunk of the png.
          *  The 2i-th entry is the keyword for the i-th comment,
          *  and the (2i + 1)-th entry is the text for the i-th comment.
          */
         sk_sp<SkDataTable> fComments;
+
+        /**
+         *  If set, rows are filtered and compressed in independent chunks on this executor,
+         *  each chunk's compressor primed with the data before it.  The output is still a
+         *  single zlib stream, a little bigger than a serial encode's.
+         *
+         *  The default is to encode on the calling thread.
+         */
+        SkExecutor* fExecutor = nullptr;
+
+        /**
+         *  Options which favor encoding speed over size: each row gets whichever of the Sub and
+         *  Up filters looks smaller, and is compressed at zlib's fastest level.
+         */
+        static Options Speed() {
+            Options options;
+            options.fFilterFlags = (FilterFlag)((int)FilterFlag::kSub | (int)FilterFlag::kUp);
+            options.fZLibLevel = 1;
+            return options;
+        }
     };
 
     /**
@@ -10,6 +10,7 @@
 
 #include "SkEncoder.h"
 
+class SkExecutor;
 class SkWStream;
 
 namespace SkWebpEncoder {
@@ -34,6 +35,52 @@ namespace SkWebpEncoder {
          */
         Compression fCompression = Compression::kLossy;
         float fQuality = 100.0f;
+
+        /**
+         *  libwebp's |method|, in [0, 6], trading encoding speed for size: 0 is fastest, and
+         *  6 is smallest.  Together with |fQuality|, this picks how hard a lossless encode
+         *  tries, from WebPConfigLosslessPreset()'s level 0 (0, 0) to level 9 (6, 100).
+         *
+         *  The default, -1, uses 3 for lossy and 0 for lossless.
+         */
+        int fMethod = -1;
+
+        /**
+         *  If true, libwebp may use a thread of its own for parts of each encode
+         *  (WebPConfig's |thread_level|).
+         */
+        bool fMultithreaded = false;
+
+        /**
+         *  If set, EncodeAnimated() encodes frames concurrently on this executor.  The output
+         *  is the same either way.
+         */
+        SkExecutor* fExecutor = nullptr;
+
+        /**
+         *  The fastest lossless encode, WebPConfigLosslessPreset()'s level 0, with an extra
+         *  thread.  This is for when latency matters more than size.
+         */
+        static Options FastLossless() {
+            Options options;
+            options.fCompression = Compression::kLossless;
+            options.fQuality = 0.0f;
+            options.fMethod = 0;
+            options.fMultithreaded = true;
+            return options;
+        }
+    };
+
+    struct SK_API Frame {
+        /**
+         *  The whole frame, which must be the same size as the others.
+         */
+        SkPixmap fPixmap;
+
+        /**
+         *  How long to show the frame, in milliseconds.
+         */
+        int fDuration;
     };
 
     /**
@@ -43,6 +90,20 @@ namespace SkWebpEncoder {
      *  Returns true on success.  Returns false on an invalid or unsupported |src|.
      */
     SK_API bool Encode(SkWStream* dst, const SkPixmap& src, const Options& options);
+
+    /**
+     *  Encode the |frameCount| |frames| to the |dst| stream as an animation which loops
+     *  forever, using the color space of the first frame.
+     *
+     *  Each frame is encoded whole and on its own, without blending with the one before, so
+     *  that the frames can be encoded concurrently (see Options::fExecutor).  This is bigger
+     *  than an animation whose frames only hold what changed.
+     *
+     *  Returns true on success.  Returns false if any frame is invalid or unsupported, or not
+     *  the size of the first.
+     */
+    SK_API bool EncodeAnimated(SkWStream* dst, const Frame frames[], int frameCount,
+                               const Options& options);
 };
 
 #endif
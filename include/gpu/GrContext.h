@@ -8,6 +8,7 @@
 #ifndef GrContext_DEFINED
 #define GrContext_DEFINED
 
+#include "SkGraphics.h"
 #include "SkMatrix.h"
 #include "SkPathEffect.h"
 #include "SkTypes.h"
@@ -34,6 +35,7 @@ class GrGpu;
 struct GrMockOptions;
 class GrOpMemoryPool;
 class GrPath;
+class GrPictureRasterCache;
 class GrProxyProvider;
 class GrRenderTargetContext;
 class GrResourceCache;
@@ -47,6 +49,7 @@ class GrTextureProxy;
 struct GrVkBackendContext;
 
 class SkImage;
+class SkPath;
 class SkSurfaceCharacterization;
 class SkSurfaceProps;
 class SkTaskGroup;
@@ -206,6 +209,32 @@ public:
      */
     void purgeUnlockedResources(bool scratchResourcesOnly);
 
+    /**
+     *  How much each of this context's caches freed in purgeForMemoryPressure().
+     */
+    struct MemoryPressureResult {
+        size_t fTextBlobCacheBytes = 0;  // Text blobs laid out for drawing (CPU memory).
+        size_t fResourceCacheBytes = 0;  // Unlocked textures, buffers, ...
+        size_t fPathCacheBytes     = 0;  // Coverage counting path renderer's cached path masks.
+        size_t fGlyphAtlasBytes    = 0;  // Glyph atlas textures.
+
+        size_t totalBytes() const {
+            return fTextBlobCacheBytes + fResourceCacheBytes + fPathCacheBytes + fGlyphAtlasBytes;
+        }
+    };
+
+    /**
+     *  The GPU counterpart of SkGraphics::PurgeForMemoryPressure(): frees memory held by this
+     *  context's caches and reports how much each one freed.
+     *
+     *  kModerate frees at least bytesToFree, first from the text blob cache, then from the
+     *  least recently used unlocked resources, scratch ones first. kCritical ignores bytesToFree
+     *  and frees every text blob, cached path mask, glyph and glyph atlas and every unlocked
+     *  resource, as freeGpuResources() would.
+     */
+    MemoryPressureResult purgeForMemoryPressure(SkGraphics::MemoryPressureLevel level,
+                                                size_t bytesToFree);
+
     /**
      * Gets the maximum supported texture size.
      */
@@ -244,6 +273,13 @@ public:
      */
     void flush();
 
+    /**
+     * Delivers the results of any asynchronous work, such as SkSurface::asyncRescaleAndReadPixels,
+     * whose GPU commands have finished. Flushing checks for these too; call this to poll between
+     * flushes. Never blocks.
+     */
+    void checkAsyncWorkCompletion();
+
     /**
      * Call to ensure all drawing to the context has been issued to the underlying 3D API. After
      * issuing all commands, numSemaphore semaphores will be signaled by the gpu. The client passes
@@ -268,6 +304,23 @@ public:
     GrSemaphoresSubmitted flushAndSignalSemaphores(int numSemaphores,
                                                    GrBackendSemaphore signalSemaphores[]);
 
+    /**
+     * Writes the Vulkan VkPipelineCache to the GrContextOptions::PersistentCache, so the next
+     * GrContext created with that cache can skip compiling pipelines it has seen before. Call it
+     * at a convenient time after the first frames have drawn, e.g. when the app is backgrounded.
+     * Does nothing for other backends or when there is no PersistentCache.
+     */
+    void storeVkPipelineCacheData();
+
+    /**
+     * Makes the masks used to draw small antialiased paths, e.g. a toolbar's icons, filled with
+     * viewMatrix, so the first frames that draw them only have to upload them. The masks go in a
+     * cache shared by all contexts in the process, including those of a share group. The work is
+     * spread over GrContextOptions::fExecutor's threads if there is one, and is done when this
+     * returns. Paths too large or complex to draw from masks are skipped.
+     */
+    void prewarmPathMasks(const SkPath paths[], int count, const SkMatrix& viewMatrix);
+
     /**
      * An ID associated with this context, guaranteed to be unique.
      */
@@ -307,6 +360,7 @@ private:
 
     GrGlyphCache*                           fGlyphCache;
     std::unique_ptr<GrTextBlobCache>        fTextBlobCache;
+    std::unique_ptr<GrPictureRasterCache>   fPictureRasterCache;
 
     bool                                    fDisableGpuYUVConversion;
     bool                                    fSharpenMipmappedTextures;
@@ -16,6 +16,7 @@
 
 #include <vector>
 
+class GrSharedTexturePool;
 class SkExecutor;
 
 #if SK_SUPPORT_GPU
@@ -33,8 +34,10 @@ struct GrContextOptions {
 
     /**
      * Abstract class which stores Skia data in a cache that persists between sessions. Currently,
-     * Skia stores compiled shader binaries (only when glProgramBinary / glGetProgramBinary are
-     * supported) when provided a persistent cache, but this may extend to other data in the future.
+     * Skia stores compiled shader binaries when provided a persistent cache: GL program binaries
+     * (only when glProgramBinary / glGetProgramBinary are supported), Vulkan SPIR-V plus the
+     * VkPipelineCache data (see GrContext::storeVkPipelineCacheData()), and Metal MSL. This may
+     * extend to other data in the future.
      */
     class PersistentCache {
     public:
@@ -72,6 +75,14 @@ struct GrContextOptions {
      */
     SkExecutor* fExecutor = nullptr;
 
+    /**
+     * When fExecutor is set, the mip levels of raster images are built on its threads and
+     * uploaded when the flush that first draws them runs, as are the pixels of images made by
+     * SkImage::makeTextureImageAsync(). This caps the bytes that can be waiting for a flush at
+     * once; past it that work happens on the calling thread, or at the flush, again.
+     */
+    size_t fMaxPendingMipMapUploadBytes = 64 * (1 << 20);
+
     /** Construct mipmaps manually, via repeated downsampling draw-calls. This is used when
         the driver's implementation (glGenerateMipmap) contains bugs. This requires mipmap
         level and LOD control (ie desktop or ES3). */
@@ -96,6 +107,25 @@ struct GrContextOptions {
      */
     bool fAllowPathMaskCaching = true;
 
+    /**
+     * When path mask caching is enabled, this allows a cached coverage counting path mask to be
+     * reused with a different fractional translate or a slightly different scale/skew, as long as
+     * no point on the path's bounds lands more than this many device pixels from where it belongs.
+     * 0 requires the matrices to match (only integer translates may differ). Values are clamped to
+     * [0, 1].
+     */
+    float fPathMaskCachingTolerance = 0;
+
+    /**
+     * If nonzero, pictures and drawables of enough ops that are drawn more than once with the
+     * same scale and skew are rasterized, and later draws draw the raster instead of playing them
+     * back. This caps the bytes of rasters kept. When fExecutor is set, pictures that draw no
+     * images are rasterized on its threads. A raster is composited as if the picture were drawn
+     * into a layer of its own, so pictures with draws whose blend modes read or clear what was
+     * under them may look different.
+     */
+    size_t fPictureRasterCacheBytes = 0;
+
     /**
      * If true, the GPU will not be used to perform YUV -> RGB conversion when generating
      * textures from codec-backed images.
@@ -120,6 +150,22 @@ struct GrContextOptions {
      */
     float fGlyphsAsPathsFontSize = -1.f;
 
+    /**
+     * If true, cached text blobs drawn from subpixel positioned bitmap glyphs are reused when
+     * they move by a fractional amount that is within the subpixel rounding error of the glyph
+     * positions (1/8 pixel), instead of only when they move by whole pixels. The glyphs then
+     * land up to 1/8 pixel further from their exact positions than newly generated glyphs would.
+     */
+    bool fReuseTextBlobsUnderFractionalTranslation = false;
+
+    /**
+     * If true, a cached text blob of bitmap glyphs that is drawn at a new scale is regenerated
+     * with distance field glyphs when the text allows it, so that it can be reused while the
+     * scale keeps changing (e.g. during a zoom animation). Once it is drawn twice in a row at the
+     * same scale it goes back to bitmap glyphs.
+     */
+    bool fDistanceFieldTextForScaleChanges = false;
+
     /**
      * Can the glyph atlas use multiple textures. If allowed, the each texture's size is bound by
      * fGlypheCacheTextureMaximumBytes.
@@ -164,6 +210,15 @@ struct GrContextOptions {
      */
     Enable fExplicitlyAllocateGPUResources = Enable::kDefault;
 
+    /**
+     * When GPU resources are explicitly allocated, an approx-fit render target or texture that
+     * finds no free surface of its own size bucket at flush time may take a free surface one
+     * bucket larger in width and/or height, which it then only partially uses. This lowers the
+     * peak memory of flushes with many differently sized temporary targets (e.g. blurs and
+     * saveLayers) that don't all live at once.
+     */
+    bool fReuseLargerTransientSurfaces = false;
+
     /**
      * Allow Ganesh to sort the opLists prior to allocating resources. This is an optional
      * behavior that is only relevant when 'fExplicitlyAllocateGPUResources' is enabled.
@@ -192,11 +247,48 @@ struct GrContextOptions {
      */
     bool fDisableDriverCorrectnessWorkarounds = false;
 
+    /**
+     * If greater than zero, resources that go unused for this many flushes are purged from the GPU
+     * resource cache even when it's under budget, to keep memory down while content is static.
+     */
+    int fResourceCacheMaxUnusedFlushes = 0;
+
+    /**
+     * Like fResourceCacheMaxUnusedFlushes, if nonzero, resources that go unused for this long are
+     * purged from the GPU resource cache by the next flush.
+     */
+    std::chrono::milliseconds fResourceCacheMaxUnusedTime = std::chrono::milliseconds::zero();
+
     /**
      * Cache in which to store compiled shader binaries between runs.
      */
     PersistentCache* fPersistentCache = nullptr;
 
+    /**
+     * Pool through which this context shares its uniquely keyed textures (e.g. uploaded images)
+     * with other GrContexts in the same share group, see GrSharedTexturePool. The pool must
+     * outlive the context.
+     */
+    GrSharedTexturePool* fSharedTexturePool = nullptr;
+
+    /**
+     * If true, and the GL driver supports KHR_parallel_shader_compile, programs that are not
+     * already cached are compiled and linked by the driver in the background. Until a program is
+     * ready, draws that need it are skipped, so rendering may be incomplete for a few frames.
+     * This is only appropriate for clients that redraw continuously (e.g. animations or games).
+     * Currently only used by the GL backend.
+     */
+    bool fAllowAsyncProgramCompilation = false;
+
+    /**
+     * An OpenCL context (cl_context), and one of its devices (cl_device_id), that can share
+     * objects with the GL context (cl_khr_gl_sharing). If both are set, builds with skia_use_skc
+     * fill large, complex paths with the skc compute rasterizer on that device. The context is
+     * retained by the GrContext. Currently only used by the GL backend.
+     */
+    void* fOpenCLContext = nullptr;
+    void* fOpenCLDevice = nullptr;
+
 #if GR_TEST_UTILS
     /**
      * Private options that are only meant for testing within Skia's tools.
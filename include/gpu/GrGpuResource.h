@@ -217,6 +217,22 @@ public:
         associated unique key. */
     const GrUniqueKey& getUniqueKey() const { return fUniqueKey; }
 
+    /**
+     * Classes of resources, in the order that the cache purges them: it purges the least recently
+     * used resource of the lowest class that has any purgeable resources first. Resources are
+     * kScratch without a unique key and kUniqueKey with one, unless their contents were marked as
+     * more expensive to regenerate with ResourcePriv::setPurgePriority().
+     */
+    enum class PurgePriority {
+        kScratch,
+        kUniqueKey,
+        kCCPRCache,   // Cached coverage counting path atlases.
+        kGlyphAtlas,  // Pages of GrDrawOpAtlases: glyphs and small path masks.
+
+        kLast = kGlyphAtlas
+    };
+    static constexpr int kPurgePriorityCount = (int)PurgePriority::kLast + 1;
+
     /**
      * Internal-only helper class used for manipulations of the resource by the cache.
      */
@@ -336,6 +352,12 @@ private:
     // by the cache.
     uint32_t fTimestamp;
     GrStdSteadyClock::time_point fTimeWhenBecamePurgeable;
+    // The cache's flush count when this resource became purgeable.
+    uint32_t fFlushCntWhenBecamePurgeable;
+    // The class set by ResourcePriv::setPurgePriority(), or kScratch if none is.
+    PurgePriority fPurgePriority;
+    // The class this resource was purgeable as. The cache orders its purgeable resources by this.
+    PurgePriority fPurgeablePriority;
 
     static const size_t kInvalidGpuMemorySize = ~static_cast<size_t>(0);
     GrScratchKey fScratchKey;
@@ -0,0 +1,90 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef GrSharedTexturePool_DEFINED
+#define GrSharedTexturePool_DEFINED
+
+#include "GrResourceKey.h"
+#include "GrTypes.h"
+#include "../private/SkMutex.h"
+#include "../private/SkNoncopyable.h"
+#include "../private/SkTHash.h"
+#include "../private/SkTInternalLList.h"
+
+class GrBackendTexture;
+class GrResourceProvider;
+class GrSemaphore;
+class GrTexture;
+
+/**
+ * A pool of uniquely keyed textures (e.g. uploaded images) shared by GrContexts whose backend
+ * objects live in the same share group, such as GL contexts created with a common share context.
+ * Give every such context the same pool through GrContextOptions::fSharedTexturePool.
+ *
+ * When a context uploads a texture under a GrUniqueKey it publishes the texture to the pool. A
+ * context that misses the key in its own cache then wraps the published texture instead of
+ * uploading another copy. Only the owning context counts a shared texture against its budget, and
+ * the pool caps the total size of the textures it keeps published; the least recently borrowed
+ * ones are withdrawn first. A withdrawn texture is freed by its owning context once every context
+ * that borrowed it has released its copy.
+ *
+ * Render targets are never shared, and the pool is ignored by backends without cross context
+ * texture support and by Vulkan, whose semaphores can only be waited on by one context.
+ *
+ * The pool is thread safe. It must outlive all of its contexts, and a context must not be
+ * destroyed while other contexts still draw with textures it published.
+ */
+class SK_API GrSharedTexturePool : SkNoncopyable {
+public:
+    static constexpr size_t kDefaultMaxBytes = 96 * (1 << 20);
+
+    explicit GrSharedTexturePool(size_t maxBytes = kDefaultMaxBytes);
+    ~GrSharedTexturePool();
+
+    /** The maximum total size of the textures the pool keeps published. */
+    size_t maxBytes() const { return fMaxBytes; }
+
+    /** Total size of the published textures. */
+    size_t bytesUsed() const;
+
+    /** Number of published textures. */
+    int count() const;
+
+private:
+    class Entry;
+
+    // Called by the owning context once texture's contents can be read by other contexts. The
+    // texture must have a unique key. Returns false if it wasn't published.
+    bool publish(GrTexture*, const GrBackendTexture&, GrSurfaceOrigin, sk_sp<GrSemaphore>);
+
+    // Wraps the texture another context published under key for use by resourceProvider's
+    // context. Returns null if there's no such texture.
+    sk_sp<GrTexture> borrow(const GrUniqueKey&, GrSurfaceOrigin, GrResourceProvider*,
+                            uint32_t contextID);
+
+    // Withdraws the texture the context published under key, if any.
+    void withdraw(const GrUniqueKey&, uint32_t owningContextID);
+
+    // Withdraws every texture the context published.
+    void withdrawAll(uint32_t owningContextID);
+
+    void removeEntry(Entry*);
+
+    struct KeyHash {
+        uint32_t operator()(const GrUniqueKey& key) const { return key.hash(); }
+    };
+
+    const size_t                                  fMaxBytes;
+    mutable SkMutex                               fMutex;
+    SkTHashMap<GrUniqueKey, Entry*, KeyHash>      fEntries;
+    SkTInternalLList<Entry>                       fLRU;  // most recently used at the head
+    size_t                                        fBytesUsed = 0;
+
+    friend class GrProxyProvider;  // publish, borrow and withdraw
+};
+
+#endif
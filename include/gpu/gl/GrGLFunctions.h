@@ -259,6 +259,9 @@ using GrGLObjectLabelFn = GrGLvoid GR_GL_FUNCTION_TYPE(GrGLenum identifier, GrGL
 /** EXT_window_rectangles */
 using GrGLWindowRectanglesFn = GrGLvoid GR_GL_FUNCTION_TYPE(GrGLenum mode, GrGLsizei count, const GrGLint box[]);
 
+/** KHR_parallel_shader_compile */
+using GrGLMaxShaderCompilerThreadsFn = GrGLvoid GR_GL_FUNCTION_TYPE(GrGLuint count);
+
 /** EGL functions */
 using GrEGLQueryStringFn = const char* GR_GL_FUNCTION_TYPE(GrEGLDisplay dpy, GrEGLint name);
 using GrEGLGetCurrentDisplayFn = GrEGLDisplay GR_GL_FUNCTION_TYPE();
@@ -335,6 +335,9 @@ public:
         /* EXT_window_rectangles */
         GrGLFunction<GrGLWindowRectanglesFn> fWindowRectangles;
 
+        /* KHR_parallel_shader_compile */
+        GrGLFunction<GrGLMaxShaderCompilerThreadsFn> fMaxShaderCompilerThreads;
+
         /* EGL functions */
         GrGLFunction<GrEGLCreateImageFn> fEGLCreateImage;
         GrGLFunction<GrEGLDestroyImageFn> fEGLDestroyImage;
@@ -58,6 +58,7 @@ struct GrMockOptions {
     int fMaxTextureSize = 2048;
     int fMaxRenderTargetSize = 2048;
     int fMaxVertexAttributes = 16;
+    bool fCrossContextTextureSupport = false;
     ConfigOptions fConfigOptions[kGrPixelConfigCnt];
 
     // GrShaderCaps options.
@@ -18,4 +18,12 @@ class SkFontMgr;
  */
 SK_API sk_sp<SkFontMgr> SkFontMgr_New_Custom_Directory(const char* dir);
 
+/** Like SkFontMgr_New_Custom_Directory, but keeps what scanning each font file found (family
+ *  name, style and character coverage of each face) in an index file at indexPath. Files whose
+ *  size and modification time still match their entry are not opened again, and the index is
+ *  rewritten if anything in the directory changed. The coverage also lets
+ *  matchFamilyStyleCharacter skip opening fonts which cannot have the character.
+ */
+SK_API sk_sp<SkFontMgr> SkFontMgr_New_Custom_Directory(const char* dir, const char* indexPath);
+
 #endif // SkFontMgr_directory_DEFINED
@@ -16,6 +16,7 @@
 #include "SkTArray.h"
 #include "SkTHash.h"
 
+class GrGpu;
 class GrOp;
 
 /*
@@ -31,7 +32,10 @@ class GrAuditTrail {
 public:
     GrAuditTrail()
     : fClientID(kGrAuditTrailInvalidID)
-    , fEnabled(false) {}
+    , fNumOpsMerged(0)
+    , fEnabled(false)
+    , fGpuTimingEnabled(false)
+    , fTimerGpu(nullptr) {}
 
     class AutoEnable {
     public:
@@ -85,6 +89,24 @@ public:
 
     void opsCombined(const GrOp* consumer, const GrOp* consumed);
 
+    // With GPU timing enabled, op lists time each op chain they execute while the audit trail is
+    // enabled, if the backend supports timer queries. Call resolveGpuTimes() after flushing to
+    // wait for the results, which are then reported with the ops at the head of each chain.
+    void setGpuTimingEnabled(bool enabled) { fGpuTimingEnabled = enabled; }
+    bool isGpuTimingEnabled() const { return fGpuTimingEnabled; }
+
+    void opChainTimed(const GrOp* head, GrGpu*, GrTimerQuery);
+    void resolveGpuTimes();
+
+    // Splits the GPU time of each timed op chain evenly between the ops in it, and adds each op's
+    // share to clientNanos[clientID], for client IDs in [0, clientCount). Returns false if no op
+    // chain has a GPU time.
+    bool addGpuTimesByClientID(double clientNanos[], int clientCount) const;
+
+    // Number of ops that were merged into another op since the last fullReset(). Each one is a
+    // draw call that won't be issued.
+    int drawCallsSaved() const { return fNumOpsMerged; }
+
     // Because op combining is heavily dependent on sequence of draw calls, these calls will only
     // produce valid information for the given draw sequence which preceeded them. Specifically, ops
     // of future draw calls may combine with previous ops and thus would invalidate the json. What
@@ -112,6 +134,7 @@ public:
         SkRect                   fBounds;
         GrSurfaceProxy::UniqueID fProxyUniqueID;
         SkTArray<Op>             fOps;
+        int64_t                  fGpuNanos;  // -1 if the GPU time isn't known
     };
 
     void getBoundsByClientID(SkTArray<OpInfo>* outInfo, int clientID);
@@ -143,11 +166,17 @@ private:
         SkRect                         fBounds;
         Ops                            fChildren;
         const GrSurfaceProxy::UniqueID fProxyUniqueID;
+        int64_t                        fGpuNanos = -1;
     };
     typedef SkTArray<std::unique_ptr<OpNode>, true> OpList;
 
     void copyOutFromOpList(OpInfo* outOpInfo, int opListID);
 
+    struct PendingTimer {
+        int          fOpListID;  // kGrAuditTrailInvalidID if the op chain wasn't recorded
+        GrTimerQuery fQuery;
+    };
+
     template <typename T>
     static void JsonifyTArray(SkString* json, const char* name, const T& array,
                               bool addComma);
@@ -160,7 +189,12 @@ private:
 
     // The client can pass in an optional client ID which we will use to mark the ops
     int fClientID;
+    int fNumOpsMerged;
     bool fEnabled;
+
+    bool fGpuTimingEnabled;
+    SkTArray<PendingTimer> fPendingTimers;
+    GrGpu* fTimerGpu;
 };
 
 #define GR_AUDIT_TRAIL_INVOKE_GUARD(audit_trail, invoke, ...) \
@@ -10,10 +10,15 @@
 
 #include "SkRefCnt.h"
 
+#include <memory>
 #include <vector>
 
 class GrSkSLFPFactory;
 
+namespace SkSL {
+class Compiler;
+}
+
 // This is a cache used by GrSkSLFP to retain GrSkSLFPFactory instances, so we don't have to
 // re-process the SkSL source code every time we create a GrSkSLFP instance.
 // For thread safety, it is important that GrSkSLFP only interact with the cache from methods that
@@ -21,6 +26,8 @@ class GrSkSLFPFactory;
 // onGetGLSLProcessorKey.
 class GrSkSLFPFactoryCache : public SkNVRefCnt<GrSkSLFPFactoryCache> {
 public:
+    GrSkSLFPFactoryCache();
+
     // Returns a factory by its numeric index, or null if no such factory exists. Indices are
     // allocated by GrSkSLFP::NewIndex().
     sk_sp<GrSkSLFPFactory> get(int index);
@@ -28,10 +35,15 @@ public:
     // Stores a new factory with the given index.
     void set(int index, sk_sp<GrSkSLFPFactory> factory);
 
+    // Returns the compiler shared by all of the factories in this cache, creating it if needed.
+    // Compilers are expensive to construct, and each one holds its own copy of the SkSL types.
+    SkSL::Compiler* compiler();
+
     ~GrSkSLFPFactoryCache();
 
 private:
     std::vector<GrSkSLFPFactory*> fFactories;
+    std::unique_ptr<SkSL::Compiler> fCompiler;
 };
 
 #endif
@@ -880,6 +880,11 @@ T* const* unique_ptr_address_as_pointer_address(std::unique_ptr<T> const* up) {
  */
 typedef uint64_t GrFence;
 
+/*
+ * Measures the GPU time taken by a span of commands. Zero is never a valid query.
+ */
+typedef uint64_t GrTimerQuery;
+
 /**
  * Used to include or exclude specific GPU path renderers for testing purposes.
  */
@@ -893,8 +898,9 @@ enum class GpuPathRenderers {
     kAALinearizing     = 1 << 5,
     kSmall             = 1 << 6,
     kTessellating      = 1 << 7,
+    kSkc               = 1 << 8,
 
-    kAll               = (kTessellating | (kTessellating - 1))
+    kAll               = (kSkc | (kSkc - 1))
 };
 
 /**
@@ -10,6 +10,7 @@
 
 #include "../private/SkTFitsIn.h"
 
+#include <atomic>
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
@@ -61,8 +62,44 @@
 // recursion of the RunDtorsOnBlock to be limited to O(log size-of-memory). Block size grow using
 // the Fibonacci sequence which means that for 2^32 memory there are 48 allocations, and for 2^48
 // there are 71 allocations.
+//
+// Heap blocks are normally freed when the arena is destroyed. SetBlockRecyclingLimit() lets each
+// thread keep some of them instead, for the next arenas on that thread to reuse.
+//
+// To tune the size of an arena's inline storage, give it a Site, which records the most bytes any
+// of its arenas used, and how many of them had to go to the heap.
 class SkArenaAlloc {
 public:
+    // Where arenas are made. Sites must live as long as the program, e.g. as function statics.
+    class Site {
+    public:
+        constexpr explicit Site(const char* name) : fName(name) {}
+
+        const char* name() const { return fName; }
+        // The most bytes used by one arena, counting the unused ends of blocks that filled up.
+        size_t highWaterMark() const { return fHighWaterMark.load(std::memory_order_relaxed); }
+        // The number of arenas which needed heap blocks.
+        size_t heapCount() const { return fHeapCount.load(std::memory_order_relaxed); }
+
+        // Sites are listed once one of their arenas has been destroyed.
+        static const Site* Head();
+        const Site* next() const { return fNext; }
+
+    private:
+        friend class SkArenaAlloc;
+        void record(size_t bytesUsed, bool usedHeap);
+
+        const char* const   fName;
+        std::atomic<size_t> fHighWaterMark{0};
+        std::atomic<size_t> fHeapCount{0};
+        std::atomic<bool>   fListed{false};
+        const Site*         fNext{nullptr};
+    };
+
+    // Each thread keeps up to bytesPerThread of freed heap blocks to reuse. 0, the default,
+    // frees them right away. Blocks already kept are freed when their thread exits.
+    static void SetBlockRecyclingLimit(size_t bytesPerThread);
+
     SkArenaAlloc(char* block, size_t blockSize, size_t firstHeapAllocation);
 
     explicit SkArenaAlloc(size_t firstHeapAllocation)
@@ -136,6 +173,9 @@ public:
     // Destroy all allocated objects, free any heap allocations.
     void reset();
 
+    // Record this arena's use in site when it is destroyed or reset.
+    void setSite(Site* site) { fSite = site; }
+
 private:
     static void AssertRelease(bool cond) { if (!cond) { ::abort(); } }
     static uint32_t ToU32(size_t v) {
@@ -155,6 +195,7 @@ private:
     void installPtrFooter(FooterAction* action, char* ptr, uint32_t padding);
 
     void ensureSpace(uint32_t size, uint32_t alignment);
+    size_t bytesUsed() const;
 
     char* allocObject(uint32_t size, uint32_t alignment) {
         uintptr_t mask = alignment - 1;
@@ -216,6 +257,8 @@ private:
     char* const    fFirstBlock;
     const uint32_t fFirstSize;
     const uint32_t fFirstHeapAllocationSize;
+    size_t         fHeapBytes {0};
+    Site*          fSite {nullptr};
 
     // Use the Fibonacci sequence as the growth factor for block size. The size of the block
     // allocated is fFib0 * fFirstHeapAllocationSize. Using 2 ^ n * fFirstHeapAllocationSize
@@ -13,12 +13,17 @@
 #if SK_SUPPORT_GPU
 #include "GrCCPerOpListPaths.h"
 #include "GrOpList.h"
+#include "GrPromiseTextureBatcher.h"
 
 #include <map>
 #endif
 
+class SkData;
 class SkDeferredDisplayListPriv;
+class SkPicture;
 class SkSurface;
+struct SkDeserialProcs;
+struct SkSerialProcs;
 /*
  * This class contains pre-processed gpu operations that can be replayed into
  * an SkSurface via draw(SkDeferredDisplayList*).
@@ -51,6 +56,15 @@ public:
         return fCharacterization;
     }
 
+    /**
+     * Returns what was drawn into this display list in a form that
+     * SkDeferredDisplayListRecorder::playback() can record again, e.g. in another process or a
+     * later run, against any characterization of the same size. Images (including promise images)
+     * are written with procs' image proc, if given. Returns null unless the recorder was created
+     * with SkDeferredDisplayListRecorder::Serializable::kYes.
+     */
+    sk_sp<SkData> serialize(const SkSerialProcs* procs = nullptr) const;
+
     // Provides access to functions that aren't part of the public API.
     SkDeferredDisplayListPriv priv();
     const SkDeferredDisplayListPriv priv() const;
@@ -60,6 +74,10 @@ private:
     friend class SkDeferredDisplayListRecorder; // for access to 'fLazyProxyData'
     friend class SkDeferredDisplayListPriv;
 
+    // Reads what serialize() wrote, returning the picture and the size it was recorded at.
+    static sk_sp<SkPicture> Deserialize(const void* data, size_t length, SkISize* dimensions,
+                                        const SkDeserialProcs*);
+
     const SkSurfaceCharacterization fCharacterization;
 
 #if SK_SUPPORT_GPU
@@ -68,8 +86,11 @@ private:
 
     SkTArray<sk_sp<GrOpList>>    fOpLists;
     PendingPathsMap              fPendingPaths;  // This is the path data from CCPR.
+    // Promise textures to fulfill in batches when the DDL is replayed.
+    SkTArray<sk_sp<GrPromiseTextureBatcher::Texture>> fPromiseTextures;
 #endif
     sk_sp<LazyProxyData>         fLazyProxyData;
+    sk_sp<SkPicture>             fPicture;  // What was drawn, if the recorder was serializable.
 };
 
 #endif
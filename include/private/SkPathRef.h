@@ -415,13 +415,15 @@ private:
 
         ptrdiff_t sizeDelta = this->currSize() - minSize;
 
-        if (sizeDelta < 0 || static_cast<size_t>(sizeDelta) >= 3 * minSize) {
-            sk_free(fPoints);
-            fPoints = nullptr;
-            fVerbs = nullptr;
-            fFreeSpace = 0;
-            fVerbCnt = 0;
-            fPointCnt = 0;
+        if (minSize <= kInlineStorageSize) {
+            this->freeStorage();
+            this->useInlineStorage();
+            fVerbCnt = verbCount;
+            fPointCnt = pointCount;
+            fFreeSpace -= newSize;
+        } else if (sizeDelta < 0 || static_cast<size_t>(sizeDelta) >= 3 * minSize ||
+                   this->usesInlineStorage()) {
+            this->freeStorage();
             this->makeSpace(minSize, true);
             fVerbCnt = verbCount;
             fPointCnt = pointCount;
@@ -459,6 +461,11 @@ private:
         if (size <= fFreeSpace) {
             return;
         }
+        if (nullptr == fPoints && size <= kInlineStorageSize) {
+            this->useInlineStorage();
+            SkDEBUGCODE(this->validate();)
+            return;
+        }
         size_t growSize = size - fFreeSpace;
         size_t oldSize = this->currSize();
 
@@ -481,13 +488,24 @@ private:
         } else {
             SK_ABORT("Path too big.");
         }
-        // Note that realloc could memcpy more than we need. It seems to be a win anyway. TODO:
-        // encapsulate this.
-        fPoints = reinterpret_cast<SkPoint*>(sk_realloc_throw(fPoints, newSize));
         size_t oldVerbSize = fVerbCnt * sizeof(uint8_t);
-        void* newVerbsDst = SkTAddOffset<void>(fPoints, newSize - oldVerbSize);
-        void* oldVerbsSrc = SkTAddOffset<void>(fPoints, oldSize - oldVerbSize);
-        memmove(newVerbsDst, oldVerbsSrc, oldVerbSize);
+        if (this->usesInlineStorage()) {
+            // Outgrown the inline storage: move to the heap, where it will be realloc'ed from now.
+            SkPoint* points = reinterpret_cast<SkPoint*>(sk_malloc_throw(newSize));
+            sk_careful_memcpy(points, fPoints, fPointCnt * sizeof(SkPoint));
+            sk_careful_memcpy(SkTAddOffset<void>(points, newSize - oldVerbSize),
+                              fVerbs - fVerbCnt, oldVerbSize);
+            fPoints = points;
+            TrackStorage(0, newSize);
+        } else {
+            // Note that realloc could memcpy more than we need. It seems to be a win anyway.
+            // TODO: encapsulate this.
+            fPoints = reinterpret_cast<SkPoint*>(sk_realloc_throw(fPoints, newSize));
+            TrackStorage(oldSize, newSize);
+            void* newVerbsDst = SkTAddOffset<void>(fPoints, newSize - oldVerbSize);
+            void* oldVerbsSrc = SkTAddOffset<void>(fPoints, oldSize - oldVerbSize);
+            memmove(newVerbsDst, oldVerbsSrc, oldVerbSize);
+        }
         fVerbs = SkTAddOffset<uint8_t>(fPoints, newSize);
         fFreeSpace += growSize;
         SkDEBUGCODE(this->validate();)
@@ -508,6 +526,40 @@ private:
         return reinterpret_cast<intptr_t>(fVerbs) - reinterpret_cast<intptr_t>(fPoints);
     }
 
+    /**
+     * Counts the point and verb storage in SkGraphics::MemoryCounters when it's reallocated.
+     */
+    static void TrackStorage(size_t oldSize, size_t newSize);
+
+    bool usesInlineStorage() const {
+        return fPoints == reinterpret_cast<const SkPoint*>(fInlineStorage);
+    }
+
+    /**
+     * Points the (empty) path ref at its inline storage, all of which becomes free space.
+     */
+    void useInlineStorage() {
+        SkASSERT(0 == fVerbCnt && 0 == fPointCnt);
+        fPoints = reinterpret_cast<SkPoint*>(fInlineStorage);
+        fVerbs = reinterpret_cast<uint8_t*>(fInlineStorage) + kInlineStorageSize;
+        fFreeSpace = kInlineStorageSize;
+    }
+
+    /**
+     * Frees the point and verb storage if it is on the heap, leaving the path ref with none.
+     */
+    void freeStorage() {
+        if (!this->usesInlineStorage()) {
+            TrackStorage(this->currSize(), 0);
+            sk_free(fPoints);
+        }
+        fPoints = nullptr;
+        fVerbs = nullptr;
+        fFreeSpace = 0;
+        fVerbCnt = 0;
+        fPointCnt = 0;
+    }
+
     /**
      * Called the first time someone calls CreateEmpty to actually create the singleton.
      */
@@ -544,6 +596,10 @@ private:
         kMinSize = 256,
     };
 
+    // Paths with up to 16 points and 16 verbs (e.g. a rect, a round rect, or a glyph outline or
+    // map feature of a few segments) keep them in the path ref itself instead of on the heap.
+    static constexpr size_t kInlineStorageSize = 16 * sizeof(SkPoint) + 16 * sizeof(uint8_t);
+
     mutable SkRect   fBounds;
 
     SkPoint*            fPoints; // points to begining of the allocation
@@ -573,6 +629,9 @@ private:
     uint8_t  fRRectOrOvalStartIdx;
     uint8_t  fSegmentMask;
 
+    // Holds the points (from the front) and verbs (from the back) while they fit.
+    alignas(SkPoint) char fInlineStorage[kInlineStorageSize];
+
     friend class PathRefTest_Private;
     friend class ForceIsRRect_Private; // unit test isRRect
     friend class SkPath;
@@ -0,0 +1,510 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkTSwissHash_DEFINED
+#define SkTSwissHash_DEFINED
+
+#include "SkChecksum.h"
+#include "SkTypes.h"
+#include "SkTemplates.h"
+#include <new>
+#include <utility>
+
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE2
+    #include <emmintrin.h>
+#elif defined(SK_ARM_HAS_NEON)
+    #include <arm_neon.h>
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__)
+    #include <intrin.h>
+#endif
+
+// SkTSwissHashTable, SkTSwissHashMap and SkTSwissHashSet have the same interface as SkTHashTable,
+// SkTHashMap and SkTHashSet, and can be used in their place.
+//
+// They're open addressed too, but each slot has a control byte, kept apart from the slots: either
+// empty, deleted, or 7 bits of the hash of the slot's key. A lookup compares a group of 16
+// control bytes at once with SSE2 or NEON, and only looks at the slots whose bytes match. Most
+// misses are then found without touching the slots at all, and most hits look at one slot.
+// Tables are kept at most 7/8 full, against SkTHashTable's 3/4.
+//
+// Unlike SkTHashTable, remove() leaves a deleted marker rather than moving other entries, so it
+// never invalidates pointers to them. set() may still move every entry when it grows the table.
+
+namespace SkSwissHashPriv {
+
+    using Ctrl = int8_t;
+    static constexpr Ctrl kEmpty   = -128;  // 0b10000000
+    static constexpr Ctrl kDeleted = -2;    // 0b11111110
+    // Full slots' control bytes are 0b0xxxxxxx, the hash's low 7 bits.
+
+    static constexpr int kGroupWidth = 16;
+
+    static inline int CountTrailingZeros(uint32_t bits) {
+        SkASSERT(bits);
+    #if defined(_MSC_VER) && !defined(__clang__)
+        unsigned long index;
+        _BitScanForward(&index, bits);
+        return (int)index;
+    #else
+        return __builtin_ctz(bits);
+    #endif
+    }
+
+    static inline int CountLeadingZeros(uint32_t bits) {
+        SkASSERT(bits);
+    #if defined(_MSC_VER) && !defined(__clang__)
+        unsigned long index;
+        _BitScanReverse(&index, bits);
+        return 31 - (int)index;
+    #else
+        return __builtin_clz(bits);
+    #endif
+    }
+
+    // The slots of a group that matched something, as a bit mask to iterate over.
+    class Mask {
+    public:
+    #if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE2
+        using Bits = uint32_t;
+        static constexpr int kShift = 0;
+
+        int lowest() const { return CountTrailingZeros(fBits); }
+        int highest() const { return 31 - CountLeadingZeros(fBits); }
+    #elif defined(SK_ARM_HAS_NEON)
+        // NEON has no movemask, so each slot gets a nibble with only its top bit kept.
+        using Bits = uint64_t;
+        static constexpr int kShift = 2;
+
+        int lowest() const {
+            uint32_t lo = (uint32_t)fBits;
+            return (lo ? CountTrailingZeros(lo)
+                       : 32 + CountTrailingZeros((uint32_t)(fBits >> 32))) >> kShift;
+        }
+        int highest() const {
+            uint32_t hi = (uint32_t)(fBits >> 32);
+            return (hi ? 63 - CountLeadingZeros(hi)
+                       : 31 - CountLeadingZeros((uint32_t)fBits)) >> kShift;
+        }
+    #else
+        using Bits = uint32_t;
+        static constexpr int kShift = 0;
+
+        int lowest() const { return CountTrailingZeros(fBits); }
+        int highest() const { return 31 - CountLeadingZeros(fBits); }
+    #endif
+
+        explicit Mask(Bits bits) : fBits(bits) {}
+
+        explicit operator bool() const { return fBits != 0; }
+
+        void clearLowest() { fBits &= fBits - 1; }
+
+    private:
+        Bits fBits;
+    };
+
+    // kGroupWidth control bytes, compared all at once.
+    class Group {
+    public:
+        explicit Group(const Ctrl* ctrl) {
+        #if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE2
+            fCtrl = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ctrl));
+        #elif defined(SK_ARM_HAS_NEON)
+            fCtrl = vld1q_s8(ctrl);
+        #else
+            memcpy(fCtrl, ctrl, kGroupWidth);
+        #endif
+        }
+
+        Mask match(Ctrl h2) const {
+        #if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE2
+            return Mask((uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(fCtrl, _mm_set1_epi8(h2))));
+        #elif defined(SK_ARM_HAS_NEON)
+            return ToMask(vceqq_s8(fCtrl, vdupq_n_s8(h2)));
+        #else
+            uint32_t bits = 0;
+            for (int i = 0; i < kGroupWidth; i++) {
+                bits |= (uint32_t)(fCtrl[i] == h2) << i;
+            }
+            return Mask(bits);
+        #endif
+        }
+
+        Mask matchEmpty() const { return this->match(kEmpty); }
+
+        // Empty and deleted are the only control bytes with their top bit set.
+        Mask matchEmptyOrDeleted() const {
+        #if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE2
+            return Mask((uint32_t)_mm_movemask_epi8(fCtrl));
+        #elif defined(SK_ARM_HAS_NEON)
+            return ToMask(vcltq_s8(fCtrl, vdupq_n_s8(0)));
+        #else
+            uint32_t bits = 0;
+            for (int i = 0; i < kGroupWidth; i++) {
+                bits |= (uint32_t)(fCtrl[i] < 0) << i;
+            }
+            return Mask(bits);
+        #endif
+        }
+
+    private:
+    #if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE2
+        __m128i fCtrl;
+    #elif defined(SK_ARM_HAS_NEON)
+        static Mask ToMask(uint8x16_t eq) {
+            uint8x8_t nibbles = vshrn_n_u16(vreinterpretq_u16_u8(eq), 4);
+            return Mask(vget_lane_u64(vreinterpret_u64_u8(nibbles), 0) & 0x8888888888888888ULL);
+        }
+        int8x16_t fCtrl;
+    #else
+        Ctrl fCtrl[kGroupWidth];
+    #endif
+    };
+
+}  // namespace SkSwissHashPriv
+
+// Traits must have:
+//   - static K GetKey(T)
+//   - static uint32_t Hash(K)
+// If the key is large and stored inside T, you may want to make K a const&.
+// Similarly, if T is large you might want it to be a pointer.
+template <typename T, typename K, typename Traits = T>
+class SkTSwissHashTable {
+public:
+    SkTSwissHashTable() : fCount(0), fDeleted(0), fCapacity(0) {}
+    SkTSwissHashTable(SkTSwissHashTable&& other)
+        : fCount(other.fCount)
+        , fDeleted(other.fDeleted)
+        , fCapacity(other.fCapacity)
+        , fCtrl(std::move(other.fCtrl))
+        , fSlots(std::move(other.fSlots)) { other.fCount = other.fDeleted = other.fCapacity = 0; }
+
+    SkTSwissHashTable& operator=(SkTSwissHashTable&& other) {
+        if (this != &other) {
+            this->~SkTSwissHashTable();
+            new (this) SkTSwissHashTable(std::move(other));
+        }
+        return *this;
+    }
+
+    ~SkTSwissHashTable() { this->destroyAll(); }
+
+    // Clear the table.
+    void reset() { *this = SkTSwissHashTable(); }
+
+    // How many entries are in the table?
+    int count() const { return fCount; }
+
+    // Approximately how many bytes of memory do we use beyond sizeof(*this)?
+    size_t approxBytesUsed() const {
+        return fCapacity ? fCapacity * sizeof(T) + fCapacity + kGroupWidth : 0;
+    }
+
+    // !!!!!!!!!!!!!!!!!                 CAUTION                   !!!!!!!!!!!!!!!!!
+    // set(), find() and foreach() all allow mutable access to table entries.
+    // If you change an entry so that it no longer has the same key, all hell
+    // will break loose.  Do not do that!
+    //
+    // Please prefer to use SkTSwissHashMap or SkTSwissHashSet, which do not have this danger.
+
+    // The pointers returned by set() and find() are valid only until the next call to set().
+
+    // Copy val into the hash table, returning a pointer to the copy now in the table.
+    // If there already is an entry in the table with the same key, we overwrite it.
+    T* set(T val) {
+        const K& key = Traits::GetKey(val);
+        uint32_t hash = Traits::Hash(key);
+        int index = this->findIndex(key, hash);
+        if (index >= 0) {
+            this->slot(index) = std::move(val);
+            return &this->slot(index);
+        }
+        if (8 * (fCount + fDeleted + 1) > 7 * fCapacity) {
+            // Mostly deleted markers? Then just clean those up at the same capacity.
+            bool grow = fCapacity == 0 || 2 * fCount >= fCapacity;
+            this->resize(grow ? SkTMax(2 * fCapacity, (int)kGroupWidth) : fCapacity);
+        }
+        return this->uncheckedSet(std::move(val), hash);
+    }
+
+    // If there is an entry in the table with this key, return a pointer to it.  If not, null.
+    T* find(const K& key) const {
+        int index = this->findIndex(key, Traits::Hash(key));
+        return index >= 0 ? &this->slot(index) : nullptr;
+    }
+
+    // Remove the value with matching key from the hash table.
+    void remove(const K& key) {
+        SkASSERT(this->find(key));
+        int index = this->findIndex(key, Traits::Hash(key));
+        this->slot(index).~T();
+        fCount--;
+        // A probe only passes a group with no empty slots, so if every kGroupWidth run of slots
+        // around this one has an empty slot, none has passed it and it can go back to empty.
+        // Otherwise it's marked deleted: set() reuses those, and resizing clears them out.
+        using namespace SkSwissHashPriv;
+        Mask emptyAfter  = Group(&fCtrl[index]).matchEmpty(),
+             emptyBefore = Group(&fCtrl[(index - kGroupWidth) & (fCapacity - 1)]).matchEmpty();
+        if (emptyAfter && emptyBefore &&
+                emptyAfter.lowest() + (kGroupWidth - 1 - emptyBefore.highest()) < kGroupWidth) {
+            this->setCtrl(index, kEmpty);
+        } else {
+            this->setCtrl(index, kDeleted);
+            fDeleted++;
+        }
+    }
+
+    // Call fn on every entry in the table.  You may mutate the entries, but be very careful.
+    template <typename Fn>  // f(T*)
+    void foreach(Fn&& fn) {
+        for (int i = 0; i < fCapacity; i++) {
+            if (fCtrl[i] >= 0) {
+                fn(&this->slot(i));
+            }
+        }
+    }
+
+    // Call fn on every entry in the table.  You may not mutate anything.
+    template <typename Fn>  // f(T) or f(const T&)
+    void foreach(Fn&& fn) const {
+        for (int i = 0; i < fCapacity; i++) {
+            if (fCtrl[i] >= 0) {
+                fn(this->slot(i));
+            }
+        }
+    }
+
+private:
+    static constexpr int kGroupWidth = SkSwissHashPriv::kGroupWidth;
+
+    // The hash's low 7 bits go in the control byte, and the rest pick where to start probing.
+    static SkSwissHashPriv::Ctrl H2(uint32_t hash) { return (SkSwissHashPriv::Ctrl)(hash & 0x7F); }
+    static uint32_t H1(uint32_t hash) { return hash >> 7; }
+
+    T& slot(int index) const { return reinterpret_cast<T*>(fSlots.get())[index]; }
+
+    // The first kGroupWidth control bytes are repeated past the end, so that a group can be
+    // loaded starting at any slot.
+    void setCtrl(int index, SkSwissHashPriv::Ctrl ctrl) {
+        fCtrl[index] = ctrl;
+        if (index < kGroupWidth) {
+            fCtrl[fCapacity + index] = ctrl;
+        }
+    }
+
+    // Groups are probed at triangular offsets from H1, which visits every slot when the
+    // capacity is a power of 2.
+    int findIndex(const K& key, uint32_t hash) const {
+        if (fCapacity == 0) {
+            return -1;
+        }
+        int mask = fCapacity - 1;
+        int pos = H1(hash) & mask;
+        SkSwissHashPriv::Ctrl h2 = H2(hash);
+        // Most hits are in the first slot probed.
+        if (fCtrl[pos] == h2 && key == Traits::GetKey(this->slot(pos))) {
+            return pos;
+        }
+        for (int step = kGroupWidth; ; step += kGroupWidth) {
+            SkSwissHashPriv::Group group(&fCtrl[pos]);
+            for (auto m = group.match(h2); m; m.clearLowest()) {
+                int index = (pos + m.lowest()) & mask;
+                if (key == Traits::GetKey(this->slot(index))) {
+                    return index;
+                }
+            }
+            if (group.matchEmpty()) {
+                return -1;
+            }
+            pos = (pos + step) & mask;
+        }
+    }
+
+    T* uncheckedSet(T&& val, uint32_t hash) {
+        int mask = fCapacity - 1;
+        int pos = H1(hash) & mask;
+        for (int step = kGroupWidth; ; step += kGroupWidth) {
+            auto m = SkSwissHashPriv::Group(&fCtrl[pos]).matchEmptyOrDeleted();
+            if (m) {
+                int index = (pos + m.lowest()) & mask;
+                if (fCtrl[index] == SkSwissHashPriv::kDeleted) {
+                    fDeleted--;
+                }
+                this->setCtrl(index, H2(hash));
+                new (&this->slot(index)) T(std::move(val));
+                fCount++;
+                return &this->slot(index);
+            }
+            pos = (pos + step) & mask;
+        }
+    }
+
+    void resize(int capacity) {
+        SkASSERT(SkIsPow2(capacity) && capacity >= kGroupWidth);
+        int oldCapacity = fCapacity;
+        SkAutoTMalloc<SkSwissHashPriv::Ctrl> oldCtrl = std::move(fCtrl);
+        SkAutoTMalloc<Storage> oldSlots = std::move(fSlots);
+        SkDEBUGCODE(int oldCount = fCount);
+
+        fCount = fDeleted = 0;
+        fCapacity = capacity;
+        fCtrl.reset(capacity + kGroupWidth);
+        memset(fCtrl.get(), SkSwissHashPriv::kEmpty, capacity + kGroupWidth);
+        fSlots.reset(capacity);
+
+        T* old = reinterpret_cast<T*>(oldSlots.get());
+        for (int i = 0; i < oldCapacity; i++) {
+            if (oldCtrl[i] >= 0) {
+                this->uncheckedSet(std::move(old[i]), Traits::Hash(Traits::GetKey(old[i])));
+                old[i].~T();
+            }
+        }
+        SkASSERT(fCount == oldCount);
+    }
+
+    void destroyAll() {
+        for (int i = 0; i < fCapacity; i++) {
+            if (fCtrl[i] >= 0) {
+                this->slot(i).~T();
+            }
+        }
+    }
+
+    // Uninitialized space for one T.
+    struct Storage {
+        alignas(T) char fBytes[sizeof(T)];
+    };
+
+    int fCount, fDeleted, fCapacity;
+    SkAutoTMalloc<SkSwissHashPriv::Ctrl> fCtrl;
+    SkAutoTMalloc<Storage>               fSlots;
+
+    SkTSwissHashTable(const SkTSwissHashTable&) = delete;
+    SkTSwissHashTable& operator=(const SkTSwissHashTable&) = delete;
+};
+
+// Maps K->V.  A more user-friendly wrapper around SkTSwissHashTable, suitable for most use cases.
+// K and V are treated as ordinary copyable C++ types, with no assumed relationship between the two.
+template <typename K, typename V, typename HashK = SkGoodHash>
+class SkTSwissHashMap {
+public:
+    SkTSwissHashMap() {}
+    SkTSwissHashMap(SkTSwissHashMap&&) = default;
+    SkTSwissHashMap& operator=(SkTSwissHashMap&&) = default;
+
+    // Clear the map.
+    void reset() { fTable.reset(); }
+
+    // How many key/value pairs are in the table?
+    int count() const { return fTable.count(); }
+
+    // Approximately how many bytes of memory do we use beyond sizeof(*this)?
+    size_t approxBytesUsed() const { return fTable.approxBytesUsed(); }
+
+    // N.B. The pointers returned by set() and find() are valid only until the next call to set().
+
+    // Set key to val in the table, replacing any previous value with the same key.
+    // We copy both key and val, and return a pointer to the value copy now in the table.
+    V* set(K key, V val) {
+        Pair* out = fTable.set({std::move(key), std::move(val)});
+        return &out->val;
+    }
+
+    // If there is key/value entry in the table with this key, return a pointer to the value.
+    // If not, return null.
+    V* find(const K& key) const {
+        if (Pair* p = fTable.find(key)) {
+            return &p->val;
+        }
+        return nullptr;
+    }
+
+    // Remove the key/value entry in the table with this key.
+    void remove(const K& key) {
+        SkASSERT(this->find(key));
+        fTable.remove(key);
+    }
+
+    // Call fn on every key/value pair in the table.  You may mutate the value but not the key.
+    template <typename Fn>  // f(K, V*) or f(const K&, V*)
+    void foreach(Fn&& fn) {
+        fTable.foreach([&fn](Pair* p){ fn(p->key, &p->val); });
+    }
+
+    // Call fn on every key/value pair in the table.  You may not mutate anything.
+    template <typename Fn>  // f(K, V), f(const K&, V), f(K, const V&) or f(const K&, const V&).
+    void foreach(Fn&& fn) const {
+        fTable.foreach([&fn](const Pair& p){ fn(p.key, p.val); });
+    }
+
+private:
+    struct Pair {
+        K key;
+        V val;
+        static const K& GetKey(const Pair& p) { return p.key; }
+        static uint32_t Hash(const K& key) { return HashK()(key); }
+    };
+
+    SkTSwissHashTable<Pair, K> fTable;
+
+    SkTSwissHashMap(const SkTSwissHashMap&) = delete;
+    SkTSwissHashMap& operator=(const SkTSwissHashMap&) = delete;
+};
+
+// A set of T.  T is treated as an ordinary copyable C++ type.
+template <typename T, typename HashT = SkGoodHash>
+class SkTSwissHashSet {
+public:
+    SkTSwissHashSet() {}
+    SkTSwissHashSet(SkTSwissHashSet&&) = default;
+    SkTSwissHashSet& operator=(SkTSwissHashSet&&) = default;
+
+    // Clear the set.
+    void reset() { fTable.reset(); }
+
+    // How many items are in the set?
+    int count() const { return fTable.count(); }
+
+    // Approximately how many bytes of memory do we use beyond sizeof(*this)?
+    size_t approxBytesUsed() const { return fTable.approxBytesUsed(); }
+
+    // Copy an item into the set.
+    void add(T item) { fTable.set(std::move(item)); }
+
+    // Is this item in the set?
+    bool contains(const T& item) const { return SkToBool(this->find(item)); }
+
+    // If an item equal to this is in the set, return a pointer to it, otherwise null.
+    // This pointer remains valid until the next call to add().
+    const T* find(const T& item) const { return fTable.find(item); }
+
+    // Remove the item in the set equal to this.
+    void remove(const T& item) {
+        SkASSERT(this->contains(item));
+        fTable.remove(item);
+    }
+
+    // Call fn on every item in the set.  You may not mutate anything.
+    template <typename Fn>  // f(T), f(const T&)
+    void foreach (Fn&& fn) const {
+        fTable.foreach(fn);
+    }
+
+private:
+    struct Traits {
+        static const T& GetKey(const T& item) { return item; }
+        static uint32_t Hash(const T& item) { return HashT()(item); }
+    };
+    SkTSwissHashTable<T, T, Traits> fTable;
+
+    SkTSwissHashSet(const SkTSwissHashSet&) = delete;
+    SkTSwissHashSet& operator=(const SkTSwissHashSet&) = delete;
+};
+
+#endif//SkTSwissHash_DEFINED
@@ -8,13 +8,27 @@
 #ifndef SkAnimCodecPlayer_DEFINED
 #define SkAnimCodecPlayer_DEFINED
 
+#include "../private/SkMutex.h"
 #include "SkCodec.h"
 
+#include <atomic>
+
+class SkExecutor;
 class SkImage;
+class SkTaskGroup;
 
 class SkAnimCodecPlayer {
 public:
-    SkAnimCodecPlayer(std::unique_ptr<SkCodec> codec);
+    /**
+     *  Decoded frames are cached, up to cacheBudget bytes of them.  When over budget, the frames
+     *  which playback will need again last are dropped first, counting a frame as needed when a
+     *  frame which is decoded on top of it (see SkCodec::FrameInfo::fRequiredFrame) is.
+     *
+     *  If executor is not null, the current frame and the next few are decoded on it in the
+     *  background, so that getFrame() usually finds them cached.
+     */
+    SkAnimCodecPlayer(std::unique_ptr<SkCodec> codec, size_t cacheBudget = SIZE_MAX,
+                      SkExecutor* executor = nullptr);
     ~SkAnimCodecPlayer();
 
     /**
@@ -46,14 +60,25 @@ public:
 
 
 private:
-    std::unique_ptr<SkCodec>        fCodec;
+    std::unique_ptr<SkCodec>        fCodec;           // Guarded by fCodecMutex.
     SkImageInfo                     fImageInfo;
     std::vector<SkCodec::FrameInfo> fFrameInfos;
-    std::vector<sk_sp<SkImage> >    fImages;
-    int                             fCurrIndex = 0;
+    std::vector<sk_sp<SkImage> >    fImages;          // Guarded by fCacheMutex.
+    size_t                          fCachedBytes = 0; // Guarded by fCacheMutex.
+    size_t                          fCacheBudget;
+    std::atomic<int>                fCurrIndex{0};
     uint32_t                        fTotalDuration;
 
+    SkMutex                         fCodecMutex;
+    SkMutex                         fCacheMutex;
+    std::atomic<bool>               fPrefetching{false};
+    std::unique_ptr<SkTaskGroup>    fPrefetchTasks;
+
     sk_sp<SkImage> getFrameAt(int index);
+    sk_sp<SkImage> findFrame(int index);
+    sk_sp<SkImage> decodeFrame(int index);  // Requires fCodecMutex.
+    void cacheFrame(int index, sk_sp<SkImage>);
+    void prefetch();
 };
 
 #endif
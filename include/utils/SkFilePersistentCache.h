@@ -0,0 +1,97 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkFilePersistentCache_DEFINED
+#define SkFilePersistentCache_DEFINED
+
+#include "GrContextOptions.h"
+#include "SkData.h"
+#include "SkString.h"
+#include "../private/SkMutex.h"
+#include "../private/SkTHash.h"
+#include "../private/SkTInternalLList.h"
+
+#include <memory>
+
+#if SK_SUPPORT_GPU
+
+class SkExecutor;
+class SkTaskGroup;
+
+/**
+ *  A GrContextOptions::PersistentCache that keeps each entry in its own file in a directory, so
+ *  that GrContexts can reuse the programs they compiled in earlier runs.  Like any persistent
+ *  cache, it should only be shared by GrContexts with the same backend and GrCaps.
+ *
+ *  Every file holds its key and a CRC-32 of the key and data, so a damaged, truncated or
+ *  colliding file is a miss (and damaged files are deleted) rather than bad data.  Files are
+ *  written to a temporary name and renamed into place, so other processes and later runs only
+ *  see whole entries.  When the files would exceed fMaxBytes, the least recently used entries are
+ *  deleted.  Entries are ordered by use within a run; across runs, by when they were written.
+ *
+ *  The cache is thread-safe.  If it has an executor, store() returns at once and the file is
+ *  written on the executor; until then, load() returns the data from memory.
+ */
+class SK_API SkFilePersistentCache : public GrContextOptions::PersistentCache {
+public:
+    struct Options {
+        // The most bytes that the cache's files may take up.
+        size_t      fMaxBytes = 32 * 1024 * 1024;
+
+        // If set, files are written on this executor, which must outlive the cache.
+        SkExecutor* fExecutor = nullptr;
+    };
+
+    /**
+     *  Makes a cache of the entries in dir, creating it if needed, or returns null if dir isn't a
+     *  usable directory.  Only one SkFilePersistentCache at a time should use a directory.
+     */
+    static std::unique_ptr<SkFilePersistentCache> Make(const char dir[], const Options&);
+    static std::unique_ptr<SkFilePersistentCache> Make(const char dir[]) {
+        return Make(dir, Options());
+    }
+
+    /** Waits for the pending writes. */
+    ~SkFilePersistentCache() override;
+
+    sk_sp<SkData> load(const SkData& key) override;
+    void store(const SkData& key, const SkData& data) override;
+
+    /** Waits until the data from every earlier store() is in its file. */
+    void flush();
+
+    /** The number of entries, and the bytes their files take up (or will when written). */
+    int count() const;
+    size_t totalBytes() const;
+
+private:
+    struct Entry;
+
+    SkFilePersistentCache(const char dir[], const Options&);
+
+    void scanDirectory();
+    SkString pathFor(uint64_t name, const char suffix[]) const;
+    void write(uint64_t name, uint32_t writeID, sk_sp<SkData> key, sk_sp<SkData> data);
+
+    // These must be called with fMutex held.
+    void removeEntry(Entry*);
+    void evictUntilFits();
+
+    const SkString                  fDir;
+    const Options                   fOptions;
+    std::unique_ptr<SkTaskGroup>    fWrites;
+
+    mutable SkMutex                 fMutex;
+    SkTHashMap<uint64_t, Entry*>    fEntries;
+    SkTInternalLList<Entry>         fLRU;  // Most recently used first.
+    size_t                          fTotalBytes = 0;
+    uint32_t                        fNextWriteID = 0;
+};
+
+#endif
+
+#endif
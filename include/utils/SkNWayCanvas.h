@@ -13,6 +13,12 @@
 #include "SkCanvasVirtualEnforcer.h"
 #include "SkNoDrawCanvas.h"
 
+#include <memory>
+
+class SkExecutor;
+class SkLiteDL;
+class SkLiteRecorder;
+
 class SK_API SkNWayCanvas : public SkCanvasVirtualEnforcer<SkNoDrawCanvas> {
 public:
     SkNWayCanvas(int width, int height);
@@ -22,6 +28,21 @@ public:
     virtual void removeCanvas(SkCanvas*);
     virtual void removeAll();
 
+    /**
+     *  If 'executor' is not null, calls are no longer forwarded to each canvas as they're made.
+     *  They're recorded once instead, and flush() plays the frame back into all the canvases at
+     *  once, on the executor's threads, then flushes them and waits for them all to finish. A
+     *  frame then costs about as much as its slowest canvas, instead of the sum of them all.
+     *
+     *  The first canvas added is played back on the thread that calls flush(), e.g. for a GPU
+     *  canvas whose context is bound to it; the others must be drawable from any thread. Like a
+     *  picture, each frame is played back inside a save()/restore(), so flush() between frames,
+     *  when the saves and restores are balanced.
+     *
+     *  Passing null plays back any pending frame and goes back to forwarding each call.
+     */
+    void setExecutor(SkExecutor*);
+
 protected:
     SkTDArray<SkCanvas*> fList;
 
@@ -66,8 +87,8 @@ protected:
     void onDrawImageLattice(const SkImage*, const Lattice&, const SkRect&, const SkPaint*) override;
     void onDrawImageNine(const SkImage*, const SkIRect& center, const SkRect& dst,
                          const SkPaint*) override;
-    void onDrawImageSet(const SkCanvas::ImageSetEntry[], int count, SkFilterQuality,
-                        SkBlendMode) override;
+    void onDrawImageSet(const SkCanvas::ImageSetEntry[], int count, const SkMatrix[],
+                        SkFilterQuality, SkBlendMode) override;
     void onDrawBitmapNine(const SkBitmap&, const SkIRect& center, const SkRect& dst,
                           const SkPaint*) override;
     void onDrawVerticesObject(const SkVertices*, const SkVertices::Bone bones[], int boneCount,
@@ -90,6 +111,15 @@ protected:
     class Iter;
 
 private:
+    SkTDArray<SkCanvas*>& targets() { return fRecorder ? fTargets : fList; }
+    void playbackFrame();
+
+    // While an executor is set, fList holds just fRecorder, and the canvases are in fTargets.
+    SkExecutor*                     fExecutor = nullptr;
+    std::unique_ptr<SkLiteDL>       fFrame;
+    std::unique_ptr<SkLiteRecorder> fRecorder;
+    SkTDArray<SkCanvas*>            fTargets;
+
     typedef SkCanvasVirtualEnforcer<SkNoDrawCanvas> INHERITED;
 };
 
@@ -71,7 +71,7 @@ protected:
                           const SkPaint*) override {}
     void onDrawImageLattice(const SkImage*, const Lattice&, const SkRect&,
                             const SkPaint*) override {}
-    void onDrawImageSet(const SkCanvas::ImageSetEntry[], int, SkFilterQuality,
+    void onDrawImageSet(const SkCanvas::ImageSetEntry[], int, const SkMatrix[], SkFilterQuality,
                         SkBlendMode) override {}
     void onDrawBitmapLattice(const SkBitmap&, const Lattice&, const SkRect&,
                              const SkPaint*) override {}
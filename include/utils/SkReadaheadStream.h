@@ -0,0 +1,78 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkReadaheadStream_DEFINED
+#define SkReadaheadStream_DEFINED
+
+#include "SkStream.h"
+#include "../private/SkMutex.h"
+#include "../private/SkTDArray.h"
+
+#include <atomic>
+#include <functional>
+#include <memory>
+
+class SkExecutor;
+class SkTaskGroup;
+
+/**
+ *  A stream of the data in another stream, which is read ahead on an SkExecutor so that reading
+ *  this stream never waits for the source.  read() and peek() return only what has arrived so
+ *  far, which may be nothing even though the stream is not at its end.  This suits SkCodec's
+ *  incremental decodes, which can pick up where they left off when more data has arrived.
+ *
+ *  Everything read from the source is kept, so the stream can always rewind.
+ */
+class SK_API SkReadaheadStream : public SkStreamRewindable {
+public:
+    /**
+     *  Starts reading source on executor, or on the default executor if it is null.  The source
+     *  is done when a read() returns nothing or it is at its end.  If set, onData is called on
+     *  the executor whenever more data has arrived, and when the source is done.
+     *
+     *  Returns null if source is null.  The executor must outlive the stream.
+     */
+    static std::unique_ptr<SkReadaheadStream> Make(std::unique_ptr<SkStream> source,
+                                                   SkExecutor* executor = nullptr,
+                                                   std::function<void()> onData = nullptr);
+
+    /** Stops reading the source, waiting for any read of it in progress. */
+    ~SkReadaheadStream() override;
+
+    size_t read(void* buffer, size_t size) override;
+    size_t peek(void* buffer, size_t size) const override;
+    bool isAtEnd() const override;
+    bool rewind() override;
+
+    bool hasPosition() const override { return true; }
+    size_t getPosition() const override;
+
+    /** The number of bytes read from the source so far. */
+    size_t bytesAvailable() const;
+
+    /** Whether all of the source has been read. */
+    bool sourceIsDone() const;
+
+private:
+    SkReadaheadStream(std::unique_ptr<SkStream>, SkExecutor*, std::function<void()>);
+
+    void readChunk();
+
+    SkStreamRewindable* onDuplicate() const override { return nullptr; }
+
+    std::unique_ptr<SkStream>       fSource;
+    const std::function<void()>     fOnData;
+    std::unique_ptr<SkTaskGroup>    fReads;
+    std::atomic<bool>               fStopping{false};
+
+    mutable SkMutex                 fMutex;
+    SkTDArray<uint8_t>              fData;
+    size_t                          fPosition = 0;
+    bool                            fSourceIsDone = false;
+};
+
+#endif
@@ -0,0 +1,82 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkRingBufferTracer_DEFINED
+#define SkRingBufferTracer_DEFINED
+
+#include "SkEventTracer.h"
+#include "../private/SkMutex.h"
+#include "../private/SkThreadID.h"
+
+#include <atomic>
+#include <memory>
+
+class SkWStream;
+
+/**
+ *  An SkEventTracer cheap enough to leave on all the time.  Each thread records its most recent
+ *  events into its own fixed-size ring buffer, 16 bytes per event, without taking any locks.
+ *  Event arguments are not recorded.  At any point, dumpJSON() writes what the buffers hold as
+ *  a Chrome trace (viewable in chrome://tracing), e.g. after noticing a slow frame.
+ *
+ *  Install it with SkEventTracer::SetInstance(new SkRingBufferTracer).
+ */
+class SK_API SkRingBufferTracer : public SkEventTracer {
+public:
+    /**
+     *  eventsPerThread is rounded up to a power of two.  The buffers are allocated when each
+     *  thread first traces, and up to kMaxThreads threads are traced; others are ignored.
+     */
+    explicit SkRingBufferTracer(int eventsPerThread = 1 << 16);
+    ~SkRingBufferTracer() override;
+
+    static constexpr int kMaxThreads    = 64;
+    static constexpr int kMaxCategories = 256;
+
+    /**
+     *  Writes the recorded events from the last `seconds` seconds, or all of them if seconds <= 0,
+     *  as Chrome trace JSON.  Threads may keep tracing while this runs; their events are either
+     *  written whole or skipped.
+     */
+    void dumpJSON(SkWStream*, double seconds = 0) const;
+
+    SkEventTracer::Handle addTraceEvent(char phase,
+                                        const uint8_t* categoryEnabledFlag,
+                                        const char* name,
+                                        uint64_t id,
+                                        int numArgs,
+                                        const char** argNames,
+                                        const uint8_t* argTypes,
+                                        const uint64_t* argValues,
+                                        uint8_t flags) override;
+
+    void updateTraceEventDuration(const uint8_t* categoryEnabledFlag,
+                                  const char* name,
+                                  SkEventTracer::Handle handle) override;
+
+    const uint8_t* getCategoryGroupEnabled(const char* name) override;
+    const char* getCategoryGroupName(const uint8_t* categoryEnabledFlag) override;
+
+private:
+    struct Ring;
+
+    void record(char phase, const uint8_t* categoryEnabledFlag, const char* name);
+    Ring* ringForThisThread();
+
+    const int                fEventsPerThread;
+    const double             fStartNanos;
+
+    std::atomic<SkThreadID>  fThreadIDs[kMaxThreads];
+    std::atomic<Ring*>       fRings[kMaxThreads];
+
+    SkMutex                  fCategoryMutex;
+    std::atomic<int>         fCategoryCount{0};
+    uint8_t                  fCategoryFlags[kMaxCategories];
+    const char*              fCategoryNames[kMaxCategories];
+};
+
+#endif
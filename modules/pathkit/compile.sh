@@ -37,6 +37,7 @@ if [[ $@ == *help* ]]; then
   echo "  test = Make a build suitable for running tests or profiling"
   echo "  debug = Make a build suitable for debugging (defines SK_DEBUG)"
   echo "  asm.js = Build for asm.js instead of WASM (very experimental)"
+  echo "  simd = Use WebAssembly SIMD (needs a browser with it enabled)"
   echo "  serve = starts a webserver allowing a user to navigate to"
   echo "          localhost:8000/pathkit.html to view the demo page."
   exit 0
@@ -68,6 +69,16 @@ if [[ $@ == *asm.js* ]]; then
   WASM_CONF="-s WASM=0 -s ALLOW_MEMORY_GROWTH=1"
 fi
 
+# Emscripten implements the SSE intrinsics on top of WebAssembly SIMD, so this builds SkNx and
+# SkOpts as for SSE2.
+SIMD_CFLAGS=""
+WASM_SIMD=""
+if [[ $@ == *simd* ]]; then
+  echo "Using WebAssembly SIMD"
+  SIMD_CFLAGS="\"-msimd128\", \"-msse2\","
+  WASM_SIMD="-msimd128 -msse2"
+fi
+
 OUTPUT="-o $BUILD_DIR/pathkit.js"
 
 source $EMSDK/emsdk_env.sh
@@ -92,6 +103,7 @@ echo "Compiling bitcode"
   --args="cc=\"${EMCC}\" \
   cxx=\"${EMCXX}\" \
   extra_cflags=[\"-DSK_DISABLE_READBUFFER=1\",\"-s\", \"WARN_UNALIGNED=1\",
+    ${SIMD_CFLAGS}
     ${EXTRA_CFLAGS}
   ] \
   is_debug=false \
@@ -123,6 +135,7 @@ ${EMCXX} $RELEASE_CONF -std=c++14 \
 -DSK_DISABLE_READBUFFER=1 \
 -fno-rtti -fno-exceptions -DEMSCRIPTEN_HAS_UNBOUND_TYPE_NAMES=0 \
 $WASM_CONF \
+$WASM_SIMD \
 -s BINARYEN_IGNORE_IMPLICIT_TRAPS=1 \
 -s ERROR_ON_MISSING_LIBRARIES=1 \
 -s ERROR_ON_UNDEFINED_SYMBOLS=1 \
@@ -28,6 +28,8 @@ var PathKit = {
 	_FromCmds: function(ptr, size) {},
 	loadCmdsTypedArray: function(arr) {},
 	FromCmds: function(arr) {},
+	Malloc: function(len) {},
+	Free: function(typedArray) {},
 	_SkCubicMap: function(cp1, cp2) {},
 	cubicYFromX: function(cpx1, cpy1, cpx2, cpy2, X) {},
 	cubicPtFromT: function(cpx1, cpy1, cpx2, cpy2, T) {},
@@ -58,10 +58,43 @@
     return [ptr, len];
   }
 
+  // Returns a Float32Array of the given length that is a view into the WASM
+  // heap. Clients can write commands into it directly, in the flat format that
+  // toCmdsTypedArray() returns, and FromCmds() then reads them without any
+  // copying. The array must be released with PathKit.Free(). In asm.js builds,
+  // which let the heap grow, it is only valid until the next allocation.
+  //
+  // Example usage:
+  // let cmds = PathKit.Malloc(3);
+  // cmds.set([PathKit.MOVE_VERB, 0, 10]);
+  // let path = PathKit.FromCmds(cmds);
+  // PathKit.Free(cmds);
+  PathKit.Malloc = function(len) {
+    var ptr = PathKit._malloc(len * Float32Array.BYTES_PER_ELEMENT);
+    return new Float32Array(PathKit.HEAPF32.buffer, ptr, len);
+  }
+
+  PathKit.Free = function(ta) {
+    PathKit._free(ta.byteOffset);
+  }
+
   // Experimentation has shown that using TypedArrays to pass arrays from
   // JS to C++ is faster than passing the JS Arrays across.
-  // See above for example of cmds.
+  // See above for example of cmds. A flat Float32Array of commands (e.g. from
+  // toCmdsTypedArray()) is copied into the WASM heap in one step, and one from
+  // PathKit.Malloc() is not copied at all.
   PathKit.FromCmds = function(cmds) {
+    if (cmds instanceof Float32Array) {
+      if (cmds.buffer === PathKit.HEAPF32.buffer) {
+        return PathKit._FromCmds(cmds.byteOffset, cmds.length);
+      }
+      var ptr = PathKit._malloc(cmds.byteLength);
+      PathKit.HEAPF32.set(cmds, ptr / cmds.BYTES_PER_ELEMENT);
+      var path = PathKit._FromCmds(ptr, cmds.length);
+      PathKit._free(ptr);
+      return path;
+    }
+
     var ptrLen = PathKit.loadCmdsTypedArray(cmds);
     var path = PathKit._FromCmds(ptrLen[0], ptrLen[1]);
     // TODO(kjlubick): cache this memory blob somehow.
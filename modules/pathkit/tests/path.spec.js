@@ -180,6 +180,34 @@ describe('PathKit\'s Path Behavior', function() {
                 done();
             }));
         });
+
+        it('round trips through flat Float32Arrays', function(done){
+            LoadPathKit.then(catchException(done, () => {
+                let path = PathKit.NewPath();
+                path.moveTo(20, 120);
+                path.arc(20, 120, 18, 0, 1.75 * Math.PI);
+                path.bezierCurveTo(1, 2, 3, 4, 5, 6);
+                path.closePath();
+
+                let cmds = path.toCmdsTypedArray();
+                expect(cmds instanceof Float32Array).toBe(true);
+
+                let copied = PathKit.FromCmds(cmds);
+                expect(copied.equals(path)).toBe(true);
+
+                // A view of the heap is read in place.
+                let heapCmds = PathKit.Malloc(cmds.length);
+                heapCmds.set(cmds);
+                let inPlace = PathKit.FromCmds(heapCmds);
+                PathKit.Free(heapCmds);
+                expect(inPlace.equals(path)).toBe(true);
+
+                path.delete();
+                copied.delete();
+                inPlace.delete();
+                done();
+            }));
+        });
     });
 
 });
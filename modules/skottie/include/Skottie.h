@@ -9,6 +9,7 @@
 #define Skottie_DEFINED
 
 #include "SkFontMgr.h"
+#include "SkRect.h"
 #include "SkRefCnt.h"
 #include "SkSize.h"
 #include "SkString.h"
@@ -19,7 +20,6 @@
 class SkCanvas;
 class SkData;
 class SkImage;
-struct SkRect;
 class SkStream;
 
 namespace skjson { class ObjectValue; }
@@ -163,6 +163,38 @@ public:
          */
         Builder& setMarkerObserver(sk_sp<MarkerObserver>);
 
+        /**
+         * Keep the parsed animation data with built animations, so that Animation::makeInstance()
+         * can build more instances of them without parsing again.
+         */
+        Builder& setAllowInstances(bool);
+
+        enum class LayerBuilding {
+            // All layers are built when the animation is made.
+            kEager,
+            // Each layer is built the first time the animation seeks into its [in..out] range.
+            kLazy,
+            // Like kLazy, but layers are also released when the animation seeks past their
+            // out-point, and built again if it seeks back.  This suits linear playback.
+            kLazyAndRelease,
+        };
+
+        /**
+         * Defer building layers until they are first needed, which cuts the load time and memory
+         * use of long animations. The JSON data is kept with the animation while it is alive.
+         *
+         * Layers are always built eagerly when a PropertyObserver is set, as it expects to see all
+         * properties at build time.
+         */
+        Builder& setLayerBuilding(LayerBuilding);
+
+        /**
+         * Record groups of layers and shapes into pictures once they render unchanged for a couple
+         * of frames, and draw those pictures until the groups change. This suits animations with
+         * large static parts, at the cost of the pictures' memory. Off by default.
+         */
+        Builder& setCacheStaticContent(bool);
+
         /**
          * Animation factories.
          */
@@ -177,6 +209,9 @@ public:
         sk_sp<Logger>           fLogger;
         sk_sp<MarkerObserver>   fMarkerObserver;
         Stats                   fStats;
+        bool                    fAllowInstances = false;
+        LayerBuilding           fLayerBuilding  = LayerBuilding::kEager;
+        bool                    fCacheStaticContent = false;
     };
 
     /**
@@ -190,6 +225,18 @@ public:
 
     ~Animation();
 
+    /**
+     * Builds another instance of the animation from the same parsed data, with its own scene and
+     * animation state. Instances can seek and render concurrently on different threads. They can
+     * also be made concurrently, if the builder's resource provider and font manager allow it.
+     *
+     * Instances get no property or marker observer, nor a logger.
+     *
+     * @return  the new instance, or nullptr if the animation was not built with
+     *          Builder::setAllowInstances(true)
+     */
+    sk_sp<Animation> makeInstance() const;
+
     /**
      * Draws the current animation frame.
      *
@@ -198,6 +245,16 @@ public:
      */
     void render(SkCanvas* canvas, const SkRect* dst = nullptr) const;
 
+    /**
+     * Draws the current animation frame into a canvas that still holds the frame drawn by the
+     * previous call (e.g. one backed by a retained surface), redrawing only what changed since.
+     *
+     * @param canvas   destination canvas, holding the previous frame
+     * @param dst      optional destination rect, which must not change between calls
+     * @return         the redrawn area, in device space
+     */
+    SkIRect renderDamage(SkCanvas* canvas, const SkRect* dst = nullptr) const;
+
     /**
      * Updates the animation state for |t|.
      *
@@ -217,9 +274,13 @@ public:
     void setShowInval(bool show);
 
 private:
+    // Immutable data shared by all instances of an animation.
+    struct Source;
+
     Animation(std::unique_ptr<sksg::Scene>, SkString ver, const SkSize& size,
-              SkScalar inPoint, SkScalar outPoint, SkScalar duration);
+              SkScalar inPoint, SkScalar outPoint, SkScalar duration, sk_sp<const Source>);
 
+    const sk_sp<const Source>    fSource;
     std::unique_ptr<sksg::Scene> fScene;
     const SkString               fVersion;
     const SkSize                 fSize;
@@ -157,7 +157,9 @@ AnimationBuilder::AnimationBuilder(sk_sp<ResourceProvider> rp, sk_sp<SkFontMgr>
                                    sk_sp<PropertyObserver> pobserver, sk_sp<Logger> logger,
                                    sk_sp<MarkerObserver> mobserver,
                                    Animation::Builder::Stats* stats,
-                                   float duration, float framerate)
+                                   float duration, float framerate,
+                                   Animation::Builder::LayerBuilding layer_building,
+                                   bool cache_static_content)
     : fResourceProvider(std::move(rp))
     , fLazyFontMgr(std::move(fontmgr))
     , fPropertyObserver(std::move(pobserver))
@@ -165,7 +167,11 @@ AnimationBuilder::AnimationBuilder(sk_sp<ResourceProvider> rp, sk_sp<SkFontMgr>
     , fMarkerObserver(std::move(mobserver))
     , fStats(stats)
     , fDuration(duration)
-    , fFrameRate(framerate) {}
+    , fFrameRate(framerate)
+    // Property observers expect to see all properties while the animation is built.
+    , fLayerBuilding(fPropertyObserver ? Animation::Builder::LayerBuilding::kEager
+                                       : layer_building)
+    , fCacheStaticContent(cache_static_content) {}
 
 std::unique_ptr<sksg::Scene> AnimationBuilder::parse(const skjson::ObjectValue& jroot) {
     this->dispatchMarkers(jroot["markers"]);
@@ -177,6 +183,8 @@ std::unique_ptr<sksg::Scene> AnimationBuilder::parse(const skjson::ObjectValue&
     auto root = this->attachComposition(jroot, &animators);
 
     fStats->fAnimatorCount = animators.size();
+    // The stats don't outlive parsing, but lazily built layers may outlive them.
+    fStats = nullptr;
 
     return sksg::Scene::Make(std::move(root), std::move(animators));
 }
@@ -316,6 +324,33 @@ Animation::Builder& Animation::Builder::setMarkerObserver(sk_sp<MarkerObserver>
     return *this;
 }
 
+Animation::Builder& Animation::Builder::setAllowInstances(bool allow) {
+    fAllowInstances = allow;
+    return *this;
+}
+
+Animation::Builder& Animation::Builder::setLayerBuilding(LayerBuilding layer_building) {
+    fLayerBuilding = layer_building;
+    return *this;
+}
+
+Animation::Builder& Animation::Builder::setCacheStaticContent(bool cache) {
+    fCacheStaticContent = cache;
+    return *this;
+}
+
+struct Animation::Source final : public SkNVRefCnt<Source> {
+    Source(const char* data, size_t length) : fDOM(data, length) {}
+
+    const skjson::DOM       fDOM;
+    bool                    fAllowInstances = false;
+    sk_sp<ResourceProvider> fResourceProvider;
+    sk_sp<SkFontMgr>        fFontMgr;
+    float                   fFps = 0;
+    Builder::LayerBuilding  fLayerBuilding = Builder::LayerBuilding::kEager;
+    bool                    fCacheStaticContent = false;
+};
+
 sk_sp<Animation> Animation::Builder::make(SkStream* stream) {
     if (!stream->hasLength()) {
         // TODO: handle explicit buffering?
@@ -349,15 +384,15 @@ sk_sp<Animation> Animation::Builder::make(const char* data, size_t data_len) {
     fStats.fJsonSize = data_len;
     const auto t0 = SkTime::GetMSecs();
 
-    const skjson::DOM dom(data, data_len);
-    if (!dom.root().is<skjson::ObjectValue>()) {
+    auto source = sk_make_sp<Source>(data, data_len);
+    if (!source->fDOM.root().is<skjson::ObjectValue>()) {
         // TODO: more error info.
         if (fLogger) {
             fLogger->log(Logger::Level::kError, "Failed to parse JSON input.\n");
         }
         return nullptr;
     }
-    const auto& json = dom.root().as<skjson::ObjectValue>();
+    const auto& json = source->fDOM.root().as<skjson::ObjectValue>();
 
     const auto t1 = SkTime::GetMSecs();
     fStats.fJsonParseTimeMS = t1 - t0;
@@ -383,12 +418,22 @@ sk_sp<Animation> Animation::Builder::make(const char* data, size_t data_len) {
     }
 
     SkASSERT(resolvedProvider);
-    internal::AnimationBuilder builder(std::move(resolvedProvider), fFontMgr,
-                                       std::move(fPropertyObserver),
-                                       std::move(fLogger),
-                                       std::move(fMarkerObserver),
-                                       &fStats, duration, fps);
-    auto scene = builder.parse(json);
+    if (fAllowInstances) {
+        source->fAllowInstances   = true;
+        source->fResourceProvider = resolvedProvider;
+        source->fFontMgr          = fFontMgr;
+        source->fFps              = fps;
+        source->fLayerBuilding    = fLayerBuilding;
+        source->fCacheStaticContent = fCacheStaticContent;
+    }
+
+    auto builder = sk_make_sp<internal::AnimationBuilder>(std::move(resolvedProvider), fFontMgr,
+                                                          std::move(fPropertyObserver),
+                                                          std::move(fLogger),
+                                                          std::move(fMarkerObserver),
+                                                          &fStats, duration, fps,
+                                                          fLayerBuilding, fCacheStaticContent);
+    auto scene = builder->parse(json);
 
     const auto t2 = SkTime::GetMSecs();
     fStats.fSceneParseTimeMS = t2 - t1;
@@ -398,8 +443,14 @@ sk_sp<Animation> Animation::Builder::make(const char* data, size_t data_len) {
         fLogger->log(Logger::Level::kError, "Could not parse animation.\n");
     }
 
-    return sk_sp<Animation>(
-        new Animation(std::move(scene), std::move(version), size, inPoint, outPoint, duration));
+    // Lazily built layers read the JSON DOM until the scene is destroyed, which the animation
+    // does before releasing its source.
+    if (!fAllowInstances && fLayerBuilding == LayerBuilding::kEager) {
+        source.reset();
+    }
+
+    return sk_sp<Animation>(new Animation(std::move(scene), std::move(version), size,
+                                          inPoint, outPoint, duration, std::move(source)));
 }
 
 sk_sp<Animation> Animation::Builder::makeFromFile(const char path[]) {
@@ -410,8 +461,10 @@ sk_sp<Animation> Animation::Builder::makeFromFile(const char path[]) {
 }
 
 Animation::Animation(std::unique_ptr<sksg::Scene> scene, SkString version, const SkSize& size,
-                     SkScalar inPoint, SkScalar outPoint, SkScalar duration)
-    : fScene(std::move(scene))
+                     SkScalar inPoint, SkScalar outPoint, SkScalar duration,
+                     sk_sp<const Source> source)
+    : fSource(std::move(source))
+    , fScene(std::move(scene))
     , fVersion(std::move(version))
     , fSize(size)
     , fInPoint(inPoint)
@@ -424,6 +477,25 @@ Animation::Animation(std::unique_ptr<sksg::Scene> scene, SkString version, const
 
 Animation::~Animation() = default;
 
+sk_sp<Animation> Animation::makeInstance() const {
+    if (!fSource || !fSource->fAllowInstances) {
+        return nullptr;
+    }
+
+    // The source is only ever read, so instances can be built from it concurrently.
+    Builder::Stats stats;
+    auto builder = sk_make_sp<internal::AnimationBuilder>(fSource->fResourceProvider,
+                                                          fSource->fFontMgr,
+                                                          nullptr, nullptr, nullptr,
+                                                          &stats, fDuration, fSource->fFps,
+                                                          fSource->fLayerBuilding,
+                                                          fSource->fCacheStaticContent);
+    auto scene = builder->parse(fSource->fDOM.root().as<skjson::ObjectValue>());
+
+    return sk_sp<Animation>(new Animation(std::move(scene), fVersion, fSize,
+                                          fInPoint, fOutPoint, fDuration, fSource));
+}
+
 void Animation::setShowInval(bool show) {
     if (fScene) {
         fScene->setShowInval(show);
@@ -443,6 +515,19 @@ void Animation::render(SkCanvas* canvas, const SkRect* dstR) const {
     fScene->render(canvas);
 }
 
+SkIRect Animation::renderDamage(SkCanvas* canvas, const SkRect* dstR) const {
+    if (!fScene)
+        return SkIRect::MakeEmpty();
+
+    SkAutoCanvasRestore restore(canvas, true);
+    const SkRect srcR = SkRect::MakeSize(this->size());
+    if (dstR) {
+        canvas->concat(SkMatrix::MakeRectToRect(srcR, *dstR, SkMatrix::kCenter_ScaleToFit));
+    }
+    canvas->clipRect(srcR);
+    return fScene->renderDamage(canvas);
+}
+
 void Animation::seek(SkScalar t) {
     if (!fScene)
         return;
@@ -26,6 +26,7 @@
 #include "SkUTF.h"
 #include "SkottieValue.h"
 
+#include <algorithm>
 #include <cmath>
 #include <utility>
 
@@ -274,8 +275,38 @@ sk_sp<SkTextBlob> TextAdapter::makeBlob() const {
     return builder.make();
 }
 
+const sk_sp<SkTextBlob>& TextAdapter::blob() const {
+    return fTextNode->getBlob();
+}
+
+sk_sp<SkTextBlob> TextAdapter::findOrMakeBlob() {
+    const auto same_shaping = [](const TextValue& a, const TextValue& b) {
+        return a.fTypeface == b.fTypeface
+            && a.fText     == b.fText
+            && a.fTextSize == b.fTextSize
+            && a.fAlign    == b.fAlign;
+    };
+
+    for (int i = fBlobCache.count() - 1; i >= 0; --i) {
+        if (same_shaping(fBlobCache[i].fValue, fText)) {
+            std::rotate(fBlobCache.begin() + i, fBlobCache.begin() + i + 1, fBlobCache.end());
+            return fBlobCache.back().fBlob;
+        }
+    }
+
+    if (fBlobCache.count() == kMaxCachedBlobs) {
+        // Evict the least recently used entry.
+        std::rotate(fBlobCache.begin(), fBlobCache.begin() + 1, fBlobCache.end());
+        fBlobCache.pop_back();
+    }
+    fBlobCache.push_back({fText, this->makeBlob()});
+
+    return fBlobCache.back().fBlob;
+}
+
 void TextAdapter::apply() {
-    fTextNode->setBlob(this->makeBlob());
+    // The text node ignores a blob it already has, so this only invalidates on reshaping.
+    fTextNode->setBlob(this->findOrMakeBlob());
     fFillColor->setColor(fText.fFillColor);
     fStrokeColor->setColor(fText.fStrokeColor);
     fStrokeColor->setStrokeWidth(fText.fStrokeWidth);
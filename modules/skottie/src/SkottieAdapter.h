@@ -11,6 +11,7 @@
 #include "SkPoint.h"
 #include "SkRefCnt.h"
 #include "SkSize.h"
+#include "SkTArray.h"
 #include "SkottieValue.h"
 
 namespace sksg {
@@ -173,9 +174,21 @@ public:
 
     const sk_sp<sksg::Group>& root() const { return fRoot; }
 
+    // The blob for the current text value, exposed for testing.
+    const sk_sp<SkTextBlob>& blob() const;
+
 private:
     void apply();
     sk_sp<SkTextBlob> makeBlob() const;
+    sk_sp<SkTextBlob> findOrMakeBlob();
+
+    // Blobs shaped for recent text values, most recently used last. Only the shaping fields of
+    // fValue are compared, so paint changes and text switching back and forth don't reshape.
+    struct CachedBlob {
+        TextValue         fValue;
+        sk_sp<SkTextBlob> fBlob;
+    };
+    static constexpr int kMaxCachedBlobs = 4;
 
     sk_sp<sksg::Group>     fRoot;
     sk_sp<sksg::TextBlob>  fTextNode;
@@ -187,6 +200,8 @@ private:
     bool                   fHadFill   : 1, //  - state cached from the prev apply()
                            fHadStroke : 1; //  /
 
+    SkSTArray<kMaxCachedBlobs, CachedBlob> fBlobCache;
+
     using INHERITED = SkRefCnt;
 };
 
@@ -458,22 +458,13 @@ private:
     }
 };
 
-sk_sp<sksg::RenderNode> AnimationBuilder::attachLayer(const skjson::ObjectValue* jlayer,
-                                                     AttachLayerContext* layerCtx) const {
-    if (!jlayer) return nullptr;
-
-    const LayerInfo layer_info = {
-        ParseDefault<float>((*jlayer)["ip"], 0.0f),
-        ParseDefault<float>((*jlayer)["op"], 0.0f)
-    };
-    if (layer_info.fInPoint >= layer_info.fOutPoint) {
-        this->log(Logger::Level::kError, nullptr,
-                  "Invalid layer in/out points: %f/%f.", layer_info.fInPoint, layer_info.fOutPoint);
-        return nullptr;
-    }
-
-    const AutoPropertyTracker apt(this, *jlayer);
+// Layer 'ty' values are in [0..kLayerTypeCount).
+static constexpr int kLayerTypeCount = 6;
 
+sk_sp<sksg::RenderNode> AnimationBuilder::attachLayerContent(
+        const skjson::ObjectValue& jlayer, const LayerInfo& layer_info, int type,
+        const std::function<sk_sp<sksg::Matrix>()>& attach_layer_matrix,
+        AnimatorScope* layer_animators) const {
     using LayerAttacher = sk_sp<sksg::RenderNode> (AnimationBuilder::*)(const skjson::ObjectValue&,
                                                                         const LayerInfo&,
                                                                         AnimatorScope*) const;
@@ -485,81 +476,181 @@ sk_sp<sksg::RenderNode> AnimationBuilder::attachLayer(const skjson::ObjectValue*
         &AnimationBuilder::attachShapeLayer,    // 'ty': 4
         &AnimationBuilder::attachTextLayer,     // 'ty': 5
     };
-
-    int type = ParseDefault<int>((*jlayer)["ty"], -1);
-    if (type < 0 || type >= SkTo<int>(SK_ARRAY_COUNT(gLayerAttachers))) {
-        return nullptr;
-    }
-
-    AnimatorScope layer_animators;
+    static_assert(SK_ARRAY_COUNT(gLayerAttachers) == kLayerTypeCount, "");
+    SkASSERT(type >= 0 && type < kLayerTypeCount);
 
     // Layer content.
-    auto layer = (this->*(gLayerAttachers[type]))(*jlayer, layer_info, &layer_animators);
+    auto layer = (this->*(gLayerAttachers[type]))(jlayer, layer_info, layer_animators);
 
     // Clip layers with explicit dimensions.
     float w = 0, h = 0;
-    if (Parse<float>((*jlayer)["w"], &w) && Parse<float>((*jlayer)["h"], &h)) {
+    if (Parse<float>(jlayer["w"], &w) && Parse<float>(jlayer["h"], &h)) {
         layer = sksg::ClipEffect::Make(std::move(layer),
                                        sksg::Rect::Make(SkRect::MakeWH(w, h)),
                                        true);
     }
 
     // Optional layer mask.
-    layer = AttachMask((*jlayer)["masksProperties"], this, &layer_animators, std::move(layer));
+    layer = AttachMask(jlayer["masksProperties"], this, layer_animators, std::move(layer));
 
     // Optional layer transform.
-    if (auto layerMatrix = layerCtx->AttachLayerMatrix(*jlayer, this)) {
+    if (auto layerMatrix = attach_layer_matrix()) {
         layer = sksg::Transform::Make(std::move(layer), std::move(layerMatrix));
     }
 
     // Optional layer opacity.
     // TODO: de-dupe this "ks" lookup with matrix above.
-    if (const skjson::ObjectValue* jtransform = (*jlayer)["ks"]) {
-        layer = this->attachOpacity(*jtransform, &layer_animators, std::move(layer));
+    if (const skjson::ObjectValue* jtransform = jlayer["ks"]) {
+        layer = this->attachOpacity(*jtransform, layer_animators, std::move(layer));
     }
 
     // Optional layer effects.
-    if (const skjson::ArrayValue* jeffects = (*jlayer)["ef"]) {
-        layer = this->attachLayerEffects(*jeffects, &layer_animators, std::move(layer));
+    if (const skjson::ArrayValue* jeffects = jlayer["ef"]) {
+        layer = this->attachLayerEffects(*jeffects, layer_animators, std::move(layer));
     }
 
-    class LayerController final : public sksg::GroupAnimator {
-    public:
-        LayerController(sksg::AnimatorList&& layer_animators,
-                        sk_sp<sksg::OpacityEffect> controlNode,
-                        float in, float out)
-            : INHERITED(std::move(layer_animators))
-            , fControlNode(std::move(controlNode))
-            , fIn(in)
-            , fOut(out) {}
-
-        void onTick(float t) override {
-            const auto active = (t >= fIn && t <= fOut);
-
-            // Keep the layer fully transparent except for its [in..out] lifespan.
-            // (note: opacity == 0 disables rendering, while opacity == 1 is a noop)
-            fControlNode->setOpacity(active ? 1 : 0);
-
-            // Dispatch ticks only while active.
-            if (active) this->INHERITED::onTick(t);
-        }
+    return layer;
+}
 
-    private:
-        const sk_sp<sksg::OpacityEffect> fControlNode;
-        const float                      fIn,
-                                         fOut;
+sk_sp<sksg::RenderNode> AnimationBuilder::attachLayer(const skjson::ObjectValue* jlayer,
+                                                     AttachLayerContext* layerCtx) const {
+    if (!jlayer) return nullptr;
 
-        using INHERITED = sksg::GroupAnimator;
+    const LayerInfo layer_info = {
+        ParseDefault<float>((*jlayer)["ip"], 0.0f),
+        ParseDefault<float>((*jlayer)["op"], 0.0f)
     };
+    if (layer_info.fInPoint >= layer_info.fOutPoint) {
+        this->log(Logger::Level::kError, nullptr,
+                  "Invalid layer in/out points: %f/%f.", layer_info.fInPoint, layer_info.fOutPoint);
+        return nullptr;
+    }
+
+    const AutoPropertyTracker apt(this, *jlayer);
 
-    auto controller_node = sksg::OpacityEffect::Make(std::move(layer));
-    if (!controller_node) {
+    int type = ParseDefault<int>((*jlayer)["ty"], -1);
+    if (type < 0 || type >= kLayerTypeCount) {
         return nullptr;
     }
 
-    layerCtx->fScope->push_back(
-        skstd::make_unique<LayerController>(std::move(layer_animators), controller_node,
-                                            layer_info.fInPoint, layer_info.fOutPoint));
+    sk_sp<sksg::OpacityEffect> controller_node;
+
+    if (fLayerBuilding == Animation::Builder::LayerBuilding::kEager) {
+        class LayerController final : public sksg::GroupAnimator {
+        public:
+            LayerController(sksg::AnimatorList&& layer_animators,
+                            sk_sp<sksg::OpacityEffect> controlNode,
+                            float in, float out)
+                : INHERITED(std::move(layer_animators))
+                , fControlNode(std::move(controlNode))
+                , fIn(in)
+                , fOut(out) {}
+
+            void onTick(float t) override {
+                const auto active = (t >= fIn && t <= fOut);
+
+                // Keep the layer fully transparent except for its [in..out] lifespan.
+                // (note: opacity == 0 disables rendering, while opacity == 1 is a noop)
+                fControlNode->setOpacity(active ? 1 : 0);
+
+                // Dispatch ticks only while active.
+                if (active) this->INHERITED::onTick(t);
+            }
+
+        private:
+            const sk_sp<sksg::OpacityEffect> fControlNode;
+            const float                      fIn,
+                                             fOut;
+
+            using INHERITED = sksg::GroupAnimator;
+        };
+
+        AnimatorScope layer_animators;
+        controller_node = sksg::OpacityEffect::Make(
+            this->attachLayerContent(*jlayer, layer_info, type,
+                                     [&]() { return layerCtx->AttachLayerMatrix(*jlayer, this); },
+                                     &layer_animators));
+        if (!controller_node) {
+            return nullptr;
+        }
+
+        layerCtx->fScope->push_back(
+            skstd::make_unique<LayerController>(std::move(layer_animators), controller_node,
+                                                layer_info.fInPoint, layer_info.fOutPoint));
+    } else {
+        // Builds the layer content and its animators the first time the layer is active, and
+        // optionally releases them once the animation moves past the layer out-point.
+        class LazyLayerController final : public sksg::Animator {
+        public:
+            LazyLayerController(sk_sp<const AnimationBuilder> abuilder,
+                                const skjson::ObjectValue& jlayer,
+                                const LayerInfo& layer_info, int type,
+                                sk_sp<sksg::Matrix> layer_matrix,
+                                sk_sp<sksg::Group> content_group,
+                                sk_sp<sksg::OpacityEffect> controlNode)
+                : fBuilder(std::move(abuilder))
+                , fLayer(jlayer)
+                , fLayerInfo(layer_info)
+                , fType(type)
+                , fLayerMatrix(std::move(layer_matrix))
+                , fContentGroup(std::move(content_group))
+                , fControlNode(std::move(controlNode)) {}
+
+            void onTick(float t) override {
+                const auto active = (t >= fLayerInfo.fInPoint && t <= fLayerInfo.fOutPoint);
+
+                fControlNode->setOpacity(active ? 1 : 0);
+
+                if (active) {
+                    if (!fBuilt) {
+                        fContent = fBuilder->attachLayerContent(fLayer, fLayerInfo, fType,
+                                                                [this]() { return fLayerMatrix; },
+                                                                &fAnimators);
+                        if (fContent) {
+                            fContentGroup->addChild(fContent);
+                        }
+                        fBuilt = true;
+                    }
+
+                    for (const auto& animator : fAnimators) {
+                        animator->tick(t);
+                    }
+                } else if (fBuilt && t > fLayerInfo.fOutPoint &&
+                           fBuilder->fLayerBuilding ==
+                               Animation::Builder::LayerBuilding::kLazyAndRelease) {
+                    if (fContent) {
+                        fContentGroup->removeChild(fContent);
+                        fContent.reset();
+                    }
+                    fAnimators.clear();
+                    fBuilt = false;
+                }
+            }
+
+        private:
+            const sk_sp<const AnimationBuilder> fBuilder;
+            const skjson::ObjectValue&          fLayer;
+            const LayerInfo                     fLayerInfo;
+            const int                           fType;
+            const sk_sp<sksg::Matrix>           fLayerMatrix;
+            const sk_sp<sksg::Group>            fContentGroup;
+            const sk_sp<sksg::OpacityEffect>    fControlNode;
+
+            sk_sp<sksg::RenderNode>             fContent;
+            AnimatorScope                       fAnimators;
+            bool                                fBuilt = false;
+        };
+
+        // The layer matrix is shared with child layers, so it is always attached up front.
+        auto layer_matrix  = layerCtx->AttachLayerMatrix(*jlayer, this);
+        auto content_group = sksg::Group::Make();
+        controller_node    = sksg::OpacityEffect::Make(content_group);
+
+        layerCtx->fScope->push_back(
+            skstd::make_unique<LazyLayerController>(sk_ref_sp(this), *jlayer, layer_info, type,
+                                                    std::move(layer_matrix),
+                                                    std::move(content_group), controller_node));
+    }
 
     if (ParseDefault<bool>((*jlayer)["td"], false)) {
         // This layer is a matte.  We apply it as a mask to the next layer.
@@ -609,7 +700,10 @@ sk_sp<sksg::RenderNode> AnimationBuilder::attachComposition(const skjson::Object
     std::reverse(layers.begin(), layers.end());
     layers.shrink_to_fit();
 
-    return sksg::Group::Make(std::move(layers));
+    auto group = sksg::Group::Make(std::move(layers));
+    group->setCacheContent(fCacheStaticContent);
+
+    return group;
 }
 
 } // namespace internal
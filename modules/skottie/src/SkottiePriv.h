@@ -41,11 +41,13 @@ namespace internal {
 
 using AnimatorScope = sksg::AnimatorList;
 
-class AnimationBuilder final : public SkNoncopyable {
+// Ref-counted, as lazily built layers keep using their builder after parse().
+class AnimationBuilder final : public SkRefCnt {
 public:
     AnimationBuilder(sk_sp<ResourceProvider>, sk_sp<SkFontMgr>, sk_sp<PropertyObserver>,
                      sk_sp<Logger>, sk_sp<MarkerObserver>,
-                     Animation::Builder::Stats*, float duration, float framerate);
+                     Animation::Builder::Stats*, float duration, float framerate,
+                     Animation::Builder::LayerBuilding, bool cache_static_content);
 
     std::unique_ptr<sksg::Scene> parse(const skjson::ObjectValue&);
 
@@ -91,6 +93,10 @@ private:
 
     sk_sp<sksg::RenderNode> attachComposition(const skjson::ObjectValue&, AnimatorScope*) const;
     sk_sp<sksg::RenderNode> attachLayer(const skjson::ObjectValue*, AttachLayerContext*) const;
+    sk_sp<sksg::RenderNode> attachLayerContent(const skjson::ObjectValue&, const LayerInfo&,
+                                               int type,
+                                               const std::function<sk_sp<sksg::Matrix>()>&,
+                                               AnimatorScope*) const;
     sk_sp<sksg::RenderNode> attachLayerEffects(const skjson::ArrayValue& jeffects, AnimatorScope*,
                                                sk_sp<sksg::RenderNode>) const;
 
@@ -169,6 +175,8 @@ private:
     Animation::Builder::Stats* fStats;
     const float                fDuration,
                                fFrameRate;
+    const Animation::Builder::LayerBuilding fLayerBuilding;
+    const bool                 fCacheStaticContent;
 
     mutable const char*        fPropertyObserverContext;
 
@@ -200,7 +208,7 @@ private:
     SkTHashMap<SkString, FontInfo>               fFonts;
     mutable SkTHashMap<SkString, ImageAssetInfo> fImageAssetCache;
 
-    using INHERITED = SkNoncopyable;
+    using INHERITED = SkRefCnt;
 };
 
 } // namespace internal
@@ -584,7 +584,9 @@ sk_sp<sksg::RenderNode> AnimationBuilder::attachShape(const skjson::ArrayValue*
         draws.shrink_to_fit();
 
         // We need a group to dispatch multiple draws.
-        shape_wrapper = sksg::Group::Make(std::move(draws));
+        auto group = sksg::Group::Make(std::move(draws));
+        group->setCacheContent(fCacheStaticContent);
+        shape_wrapper = std::move(group);
     }
 
     sk_sp<sksg::Matrix> shape_matrix;
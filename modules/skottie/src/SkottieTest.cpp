@@ -5,10 +5,17 @@
  * found in the LICENSE file.
  */
 
+#include "SkBitmap.h"
+#include "SkCanvas.h"
+#include "SkImage.h"
 #include "SkMatrix.h"
+#include "SkSGGroup.h"
 #include "Skottie.h"
+#include "SkottieAdapter.h"
 #include "SkottieProperty.h"
 #include "SkStream.h"
+#include "SkTaskGroup.h"
+#include "SkTextBlob.h"
 
 #include "Test.h"
 
@@ -217,3 +224,202 @@ DEF_TEST(Skottie_Annotations, reporter) {
     REPORTER_ASSERT(reporter, std::get<1>(observer->fMarkers[1]) == 0.75f);
     REPORTER_ASSERT(reporter, std::get<2>(observer->fMarkers[1]) == 0.75f);
 }
+
+DEF_TEST(Skottie_Instances, reporter) {
+    static constexpr char json[] = R"({
+                                     "v": "5.2.1",
+                                     "w": 32,
+                                     "h": 32,
+                                     "fr": 10,
+                                     "ip": 0,
+                                     "op": 10,
+                                     "layers": [
+                                       {
+                                         "ty": 1,
+                                         "ind": 0,
+                                         "ip": 0,
+                                         "op": 10,
+                                         "ks": {
+                                           "o": { "a": 1, "k": [
+                                             { "t": 0, "s": [0], "e": [100] },
+                                             { "t": 10 }
+                                           ]}
+                                         },
+                                         "sw": 32,
+                                         "sh": 32,
+                                         "sc": "#ff0000"
+                                       }
+                                     ]
+                                   })";
+
+    REPORTER_ASSERT(reporter, !Animation::Make(json, strlen(json))->makeInstance());
+
+    auto animation = Animation::Builder()
+            .setAllowInstances(true)
+            .make(json, strlen(json));
+    REPORTER_ASSERT(reporter, animation);
+
+    static constexpr int kInstanceCount = 8;
+    auto frame_time = [](int i) { return (i + 1) / (kInstanceCount + 1.0f); };
+    auto render = [](const Animation& anim, SkBitmap* bm) {
+        bm->allocN32Pixels(32, 32);
+        bm->eraseColor(SK_ColorTRANSPARENT);
+        SkCanvas canvas(*bm);
+        anim.render(&canvas);
+    };
+
+    // Each instance seeks to its own time concurrently, and none affects another.
+    SkBitmap results[kInstanceCount];
+    SkTaskGroup().batch(kInstanceCount, [&](int i) {
+        auto instance = animation->makeInstance();
+        instance->seek(frame_time(i));
+        render(*instance, &results[i]);
+    });
+
+    for (int i = 0; i < kInstanceCount; ++i) {
+        animation->seek(frame_time(i));
+        SkBitmap expected;
+        render(*animation, &expected);
+        REPORTER_ASSERT(reporter, results[i].getColor(16, 16) == expected.getColor(16, 16));
+        if (i > 0) {
+            REPORTER_ASSERT(reporter, results[i].getColor(16, 16) !=
+                                      results[i - 1].getColor(16, 16));
+        }
+    }
+}
+
+DEF_TEST(Skottie_LazyLayers, reporter) {
+    // A red image layer, active in [2..5], over a green solid layer.
+    static constexpr char json[] = R"({
+                                     "v": "5.2.1",
+                                     "w": 32,
+                                     "h": 32,
+                                     "fr": 10,
+                                     "ip": 0,
+                                     "op": 10,
+                                     "assets": [
+                                       { "id": "img_0", "p": "img.png", "u": "", "w": 32, "h": 32 }
+                                     ],
+                                     "layers": [
+                                       {
+                                         "ty": 2,
+                                         "ind": 0,
+                                         "ip": 2,
+                                         "op": 5,
+                                         "refId": "img_0"
+                                       },
+                                       {
+                                         "ty": 1,
+                                         "ind": 1,
+                                         "ip": 0,
+                                         "op": 10,
+                                         "sw": 32,
+                                         "sh": 32,
+                                         "sc": "#00ff00"
+                                       }
+                                     ]
+                                   })";
+
+    // Counts the image layer builds.
+    class TestImageAsset final : public ImageAsset {
+    public:
+        bool isMultiFrame() override { return false; }
+
+        sk_sp<SkImage> getFrame(float) override {
+            fFrameCount++;
+            SkBitmap bm;
+            bm.allocN32Pixels(32, 32);
+            bm.eraseColor(SK_ColorRED);
+            return SkImage::MakeFromBitmap(bm);
+        }
+
+        int fFrameCount = 0;
+    };
+
+    class TestResourceProvider final : public ResourceProvider {
+    public:
+        explicit TestResourceProvider(sk_sp<ImageAsset> asset) : fAsset(std::move(asset)) {}
+
+        sk_sp<ImageAsset> loadImageAsset(const char[], const char[]) const override {
+            return fAsset;
+        }
+
+    private:
+        const sk_sp<ImageAsset> fAsset;
+    };
+
+    auto center_color = [](const Animation& anim) {
+        SkBitmap bm;
+        bm.allocN32Pixels(32, 32);
+        bm.eraseColor(SK_ColorTRANSPARENT);
+        SkCanvas canvas(bm);
+        anim.render(&canvas);
+        return bm.getColor(16, 16);
+    };
+
+    for (auto building : { Animation::Builder::LayerBuilding::kEager,
+                           Animation::Builder::LayerBuilding::kLazy,
+                           Animation::Builder::LayerBuilding::kLazyAndRelease }) {
+        auto asset = sk_make_sp<TestImageAsset>();
+        auto animation = Animation::Builder()
+                .setResourceProvider(sk_make_sp<TestResourceProvider>(asset))
+                .setLayerBuilding(building)
+                .make(json, strlen(json));
+        REPORTER_ASSERT(reporter, animation);
+
+        const bool lazy = building != Animation::Builder::LayerBuilding::kEager;
+        REPORTER_ASSERT(reporter, asset->fFrameCount == (lazy ? 0 : 1));
+        REPORTER_ASSERT(reporter, center_color(*animation) == SK_ColorGREEN);
+
+        animation->seek(0.3f);
+        REPORTER_ASSERT(reporter, asset->fFrameCount == 1);
+        REPORTER_ASSERT(reporter, center_color(*animation) == SK_ColorRED);
+
+        animation->seek(0.8f);
+        REPORTER_ASSERT(reporter, center_color(*animation) == SK_ColorGREEN);
+
+        // Seeking back only rebuilds released layers.
+        animation->seek(0.4f);
+        REPORTER_ASSERT(reporter, asset->fFrameCount ==
+                (building == Animation::Builder::LayerBuilding::kLazyAndRelease ? 2 : 1));
+        REPORTER_ASSERT(reporter, center_color(*animation) == SK_ColorRED);
+    }
+}
+
+DEF_TEST(Skottie_TextBlobCache, reporter) {
+    auto adapter = sk_make_sp<TextAdapter>(sksg::Group::Make());
+
+    const auto make_text = [](const char* str, SkColor color = SK_ColorBLACK) {
+        TextValue text;
+        text.fText      = SkString(str);
+        text.fTextSize  = 12;
+        text.fFillColor = color;
+        text.fHasFill   = true;
+        text.fHasStroke = false;
+        return text;
+    };
+
+    sk_sp<SkTextBlob> blobs[5];
+    for (int i = 0; i < 4; ++i) {
+        const char str[] = { static_cast<char>('a' + i), '\0' };
+        adapter->setText(make_text(str));
+        blobs[i] = adapter->blob();
+        REPORTER_ASSERT(reporter, blobs[i]);
+        REPORTER_ASSERT(reporter, i == 0 || blobs[i] != blobs[i - 1]);
+    }
+
+    // Paint-only changes and recently used values reuse their blobs.
+    adapter->setText(make_text("d", SK_ColorRED));
+    REPORTER_ASSERT(reporter, adapter->blob() == blobs[3]);
+    adapter->setText(make_text("a"));
+    REPORTER_ASSERT(reporter, adapter->blob() == blobs[0]);
+
+    // A fifth value evicts the least recently used one ("b"), but nothing more recent.
+    adapter->setText(make_text("e"));
+    blobs[4] = adapter->blob();
+    REPORTER_ASSERT(reporter, blobs[4] && blobs[4] != blobs[0]);
+    adapter->setText(make_text("c"));
+    REPORTER_ASSERT(reporter, adapter->blob() == blobs[2]);
+    adapter->setText(make_text("b"));
+    REPORTER_ASSERT(reporter, adapter->blob() && adapter->blob() != blobs[1]);
+}
@@ -7,21 +7,27 @@
 
 #include "SkCanvas.h"
 #include "SkCommandLineFlags.h"
+#include "SkExecutor.h"
 #include "SkGraphics.h"
+#include "SkImageEncoder.h"
 #include "SkMakeUnique.h"
 #include "SkOSFile.h"
 #include "SkOSPath.h"
+#include "SkSemaphore.h"
+#include "SkTaskGroup.h"
+#include "SkTime.h"
 #include "Skottie.h"
 #include "SkottieUtils.h"
 #include "SkPictureRecorder.h"
 #include "SkStream.h"
 #include "SkSurface.h"
 
+#include <atomic>
 #include <vector>
 
-DEFINE_string2(input    , i, nullptr, "Input .json file.");
+DEFINE_string2(input    , i, nullptr, "Input .json file, or directory of them with --bench.");
 DEFINE_string2(writePath, w, nullptr, "Output directory.  Frames are names [0-9]{6}.png.");
-DEFINE_string2(format   , f, "png"  , "Output format (png or skp)");
+DEFINE_string2(format   , f, "png"  , "Output format (png, webp or skp)");
 
 DEFINE_double(t0,   0, "Timeline start [0..1].");
 DEFINE_double(t1,   1, "Timeline stop [0..1].");
@@ -30,15 +36,41 @@ DEFINE_double(fps, 30, "Decode frames per second.");
 DEFINE_int32(width , 800, "Render width.");
 DEFINE_int32(height, 600, "Render height.");
 
+DEFINE_int32(threads , 0, "Threads encoding frames while the next ones render "
+                          "(0 encodes on the rendering thread).");
+DEFINE_int32(inFlight, 4, "Maximum number of rendered frames waiting to be encoded.");
+DEFINE_bool(bench, false, "Report the time spent seeking, rendering (including revalidation) and "
+                          "encoding frames, instead of writing them.");
+
 namespace {
 
+// Time spent in each stage of producing frames, in milliseconds.
+struct StageTimes {
+    double fSeek   = 0,
+           fRender = 0,
+           fEncode = 0;
+};
+
 class Sink {
 public:
     virtual ~Sink() = default;
     Sink(const Sink&) = delete;
     Sink& operator=(const Sink&) = delete;
 
-    bool handleFrame(const sk_sp<skottie::Animation>& anim, size_t idx) const {
+    // Renders the current frame, and hands it off to be encoded and written as frame |idx|.
+    virtual bool handleFrame(const sk_sp<skottie::Animation>& anim, size_t idx) = 0;
+
+    // Waits for all frames to be written, and adds the time spent on them to |times|.
+    virtual bool finish(StageTimes* times) = 0;
+
+protected:
+    Sink(const char* ext) : fExtension(ext) {}
+
+    bool writeFrame(size_t idx, const SkData& data) const {
+        if (FLAGS_bench) {
+            return true;
+        }
+
         const auto frame_file = SkStringPrintf("0%06d.%s", idx, fExtension.c_str());
         SkFILEWStream stream (SkOSPath::Join(FLAGS_writePath[0], frame_file.c_str()).c_str());
 
@@ -48,52 +80,109 @@ public:
             return false;
         }
 
-        return this->saveFrame(anim, &stream);
+        return stream.write(data.data(), data.size());
     }
 
-protected:
-    Sink(const char* ext) : fExtension(ext) {}
-
-    virtual bool saveFrame(const sk_sp<skottie::Animation>& anim, SkFILEWStream*) const = 0;
+    static SkMatrix FrameMatrix(const sk_sp<skottie::Animation>& anim) {
+        return SkMatrix::MakeRectToRect(SkRect::MakeSize(anim->size()),
+                                        SkRect::MakeIWH(FLAGS_width, FLAGS_height),
+                                        SkMatrix::kCenter_ScaleToFit);
+    }
 
 private:
     const SkString fExtension;
 };
 
-class PNGSink final : public Sink {
+// Renders into one of a few surfaces, and encodes frames from them on an executor if given, so
+// that rendering of the next frames overlaps with encoding.
+class RasterSink final : public Sink {
 public:
-    PNGSink()
-        : INHERITED("png")
-        , fSurface(SkSurface::MakeRasterN32Premul(FLAGS_width, FLAGS_height)) {
-        if (!fSurface) {
-            SkDebugf("Could not allocate a %d x %d surface.\n", FLAGS_width, FLAGS_height);
+    RasterSink(const char* ext, SkEncodedImageFormat format, SkExecutor* executor)
+        : INHERITED(ext)
+        , fFormat(format)
+        , fSlotCount(executor ? SkTMax(FLAGS_inFlight, 1) : 1)
+        , fSlots(new Slot[fSlotCount]) {
+        if (executor) {
+            fTaskGroup = skstd::make_unique<SkTaskGroup>(*executor);
+        }
+        for (int i = 0; i < fSlotCount; ++i) {
+            fSlots[i].fSurface = SkSurface::MakeRasterN32Premul(FLAGS_width, FLAGS_height);
+            if (!fSlots[i].fSurface) {
+                SkDebugf("Could not allocate a %d x %d surface.\n", FLAGS_width, FLAGS_height);
+                fSlotCount = 0;
+            }
         }
     }
 
-    bool saveFrame(const sk_sp<skottie::Animation>& anim, SkFILEWStream* stream) const override {
-        if (!fSurface) return false;
+    bool handleFrame(const sk_sp<skottie::Animation>& anim, size_t idx) override {
+        if (!fSlotCount) return false;
 
-        auto* canvas = fSurface->getCanvas();
-        SkAutoCanvasRestore acr(canvas, true);
+        // Wait for the slot's previous frame to be encoded.
+        auto& slot = fSlots[idx % fSlotCount];
+        slot.fFree.wait();
 
-        canvas->concat(SkMatrix::MakeRectToRect(SkRect::MakeSize(anim->size()),
-                                                SkRect::MakeIWH(FLAGS_width, FLAGS_height),
-                                                SkMatrix::kCenter_ScaleToFit));
+        const auto t0 = SkTime::GetMSecs();
+        auto* canvas = slot.fSurface->getCanvas();
+        {
+            SkAutoCanvasRestore acr(canvas, true);
+            canvas->concat(FrameMatrix(anim));
+            canvas->clear(SK_ColorTRANSPARENT);
+            anim->render(canvas);
+        }
+        fRenderMS += SkTime::GetMSecs() - t0;
+
+        auto encode = [this, &slot, idx]() {
+            const auto t0 = SkTime::GetMSecs();
+            SkPixmap pixmap;
+            SkAssertResult(slot.fSurface->peekPixels(&pixmap));
+            auto data = SkEncodePixmap(pixmap, fFormat, 100);
+            slot.fEncodeMS += SkTime::GetMSecs() - t0;
+
+            if (!data) {
+                SkDebugf("Failed to encode frame!\n");
+                fFailed = true;
+            } else if (!this->writeFrame(idx, *data)) {
+                fFailed = true;
+            }
+            slot.fFree.signal();
+        };
 
-        canvas->clear(SK_ColorTRANSPARENT);
-        anim->render(canvas);
+        if (fTaskGroup) {
+            fTaskGroup->add(std::move(encode));
+        } else {
+            encode();
+        }
 
-        auto png_data = fSurface->makeImageSnapshot()->encodeToData();
-        if (!png_data) {
-            SkDebugf("Failed to encode frame!\n");
-            return false;
+        return !fFailed;
+    }
+
+    bool finish(StageTimes* times) override {
+        if (fTaskGroup) {
+            fTaskGroup->wait();
+        }
+        times->fRender += fRenderMS;
+        for (int i = 0; i < fSlotCount; ++i) {
+            times->fEncode += fSlots[i].fEncodeMS;
+            fSlots[i].fEncodeMS = 0;
         }
+        fRenderMS = 0;
 
-        return stream->write(png_data->data(), png_data->size());
+        return fSlotCount && !fFailed;
     }
 
 private:
-    const sk_sp<SkSurface> fSurface;
+    struct Slot {
+        sk_sp<SkSurface> fSurface;
+        SkSemaphore      fFree{1};      // Signaled once the frame in fSurface is encoded.
+        double           fEncodeMS = 0; // Only touched by whoever holds fFree.
+    };
+
+    const SkEncodedImageFormat   fFormat;
+    int                          fSlotCount;
+    std::unique_ptr<Slot[]>      fSlots;
+    std::unique_ptr<SkTaskGroup> fTaskGroup;
+    double                       fRenderMS = 0;
+    std::atomic<bool>            fFailed{false};
 
     using INHERITED = Sink;
 };
@@ -102,21 +191,34 @@ class SKPSink final : public Sink {
 public:
     SKPSink() : INHERITED("skp") {}
 
-    bool saveFrame(const sk_sp<skottie::Animation>& anim, SkFILEWStream* stream) const override {
+    bool handleFrame(const sk_sp<skottie::Animation>& anim, size_t idx) override {
+        const auto t0 = SkTime::GetMSecs();
         SkPictureRecorder recorder;
 
         auto canvas = recorder.beginRecording(FLAGS_width, FLAGS_height);
-        canvas->concat(SkMatrix::MakeRectToRect(SkRect::MakeSize(anim->size()),
-                                                SkRect::MakeIWH(FLAGS_width, FLAGS_height),
-                                                SkMatrix::kCenter_ScaleToFit));
+        canvas->concat(FrameMatrix(anim));
         anim->render(canvas);
-        recorder.finishRecordingAsPicture()->serialize(stream);
+        auto picture = recorder.finishRecordingAsPicture();
+
+        const auto t1 = SkTime::GetMSecs();
+        auto data = picture->serialize();
+        const auto t2 = SkTime::GetMSecs();
+        fTimes.fRender += t1 - t0;
+        fTimes.fEncode += t2 - t1;
+
+        return this->writeFrame(idx, *data);
+    }
+
+    bool finish(StageTimes* times) override {
+        times->fRender += fTimes.fRender;
+        times->fEncode += fTimes.fEncode;
+        fTimes = StageTimes();
 
         return true;
     }
 
 private:
-    const sk_sp<SkSurface> fSurface;
+    StageTimes fTimes;
 
     using INHERITED = Sink;
 };
@@ -156,11 +258,36 @@ private:
 
 } // namespace
 
+// Renders the frames of one animation through the sink, returning the number of frames.
+static size_t export_frames(const sk_sp<skottie::Animation>& anim, Sink* sink,
+                            StageTimes* times) {
+    static constexpr double kMaxFrames = 10000;
+    const auto t0 = SkTPin(FLAGS_t0, 0.0, 1.0),
+               t1 = SkTPin(FLAGS_t1,  t0, 1.0),
+               advance = 1 / std::min(anim->duration() * FLAGS_fps, kMaxFrames);
+
+    size_t frame_index = 0;
+    for (auto t = t0; t <= t1; t += advance) {
+        const auto seek_start = SkTime::GetMSecs();
+        anim->seek(t);
+        times->fSeek += SkTime::GetMSecs() - seek_start;
+
+        if (!sink->handleFrame(anim, frame_index++)) {
+            break;
+        }
+    }
+    if (!sink->finish(times)) {
+        SkDebugf("Failed to write all frames.\n");
+    }
+
+    return frame_index;
+}
+
 int main(int argc, char** argv) {
     SkCommandLineFlags::Parse(argc, argv);
     SkAutoGraphics ag;
 
-    if (FLAGS_input.isEmpty() || FLAGS_writePath.isEmpty()) {
+    if (FLAGS_input.isEmpty() || (FLAGS_writePath.isEmpty() && !FLAGS_bench)) {
         SkDebugf("Missing required 'input' and 'writePath' args.\n");
         return 1;
     }
@@ -170,13 +297,21 @@ int main(int argc, char** argv) {
         return 1;
     }
 
-    if (!sk_mkdir(FLAGS_writePath[0])) {
+    if (!FLAGS_bench && !sk_mkdir(FLAGS_writePath[0])) {
         return 1;
     }
 
+    std::unique_ptr<SkExecutor> executor;
+    if (FLAGS_threads > 0) {
+        executor = SkExecutor::MakeFIFOThreadPool(FLAGS_threads);
+    }
+
     std::unique_ptr<Sink> sink;
     if (0 == strcmp(FLAGS_format[0], "png")) {
-        sink = skstd::make_unique<PNGSink>();
+        sink = skstd::make_unique<RasterSink>("png", SkEncodedImageFormat::kPNG, executor.get());
+    } else if (0 == strcmp(FLAGS_format[0], "webp")) {
+        sink = skstd::make_unique<RasterSink>("webp", SkEncodedImageFormat::kWEBP,
+                                              executor.get());
     } else if (0 == strcmp(FLAGS_format[0], "skp")) {
         sink = skstd::make_unique<SKPSink>();
     } else {
@@ -184,29 +319,50 @@ int main(int argc, char** argv) {
         return 1;
     }
 
-    auto logger = sk_make_sp<Logger>();
-
-    auto anim = skottie::Animation::Builder()
-            .setLogger(logger)
-            .setResourceProvider(
-                skottie_utils::FileResourceProvider::Make(SkOSPath::Dirname(FLAGS_input[0])))
-            .makeFromFile(FLAGS_input[0]);
-    if (!anim) {
-        SkDebugf("Could not load animation: '%s'.\n", FLAGS_input[0]);
-        return 1;
+    std::vector<SkString> inputs;
+    if (FLAGS_bench && sk_isdir(FLAGS_input[0])) {
+        SkOSFile::Iter it(FLAGS_input[0], ".json");
+        for (SkString name; it.next(&name); ) {
+            inputs.push_back(SkOSPath::Join(FLAGS_input[0], name.c_str()));
+        }
+    } else {
+        inputs.push_back(SkString(FLAGS_input[0]));
     }
 
-    logger->report();
+    for (const auto& input : inputs) {
+        auto logger = sk_make_sp<Logger>();
+
+        skottie::Animation::Builder builder;
+        auto anim = builder
+                .setLogger(logger)
+                .setResourceProvider(
+                    skottie_utils::FileResourceProvider::Make(SkOSPath::Dirname(input.c_str())))
+                .makeFromFile(input.c_str());
+        if (!anim) {
+            SkDebugf("Could not load animation: '%s'.\n", input.c_str());
+            if (FLAGS_bench) {
+                continue;
+            }
+            return 1;
+        }
 
-    static constexpr double kMaxFrames = 10000;
-    const auto t0 = SkTPin(FLAGS_t0, 0.0, 1.0),
-               t1 = SkTPin(FLAGS_t1,  t0, 1.0),
-               advance = 1 / std::min(anim->duration() * FLAGS_fps, kMaxFrames);
+        if (!FLAGS_bench) {
+            logger->report();
+        }
 
-    size_t frame_index = 0;
-    for (auto t = t0; t <= t1; t += advance) {
-        anim->seek(t);
-        sink->handleFrame(anim, frame_index++);
+        StageTimes times;
+        const auto wall_start = SkTime::GetMSecs();
+        const auto frames = export_frames(anim, sink.get(), &times);
+        const auto wall = SkTime::GetMSecs() - wall_start;
+
+        if (FLAGS_bench && frames) {
+            SkDebugf("%s: %zu frames, load %.2f ms, per frame: seek %.3f ms, render %.3f ms, "
+                     "encode %.3f ms, wall %.3f ms\n",
+                     SkOSPath::Basename(input.c_str()).c_str(), frames,
+                     builder.getStats().fTotalLoadTimeMS,
+                     times.fSeek / frames, times.fRender / frames, times.fEncode / frames,
+                     wall / frames);
+        }
     }
 
     return 0;
@@ -33,6 +33,10 @@ public:
     size_t size() const { return fChildren.size(); }
     bool  empty() const { return fChildren.empty(); }
 
+    // When set, the group is recorded into a picture once it renders unchanged for a couple of
+    // frames, and the picture is drawn until the group or a descendant changes. Off by default.
+    SG_ATTRIBUTE(CacheContent, bool, fCacheContent)
+
 protected:
     explicit Group(std::vector<sk_sp<RenderNode>>);
     ~Group() override;
@@ -40,8 +44,12 @@ protected:
     void onRender(SkCanvas*, const RenderContext*) const override;
     SkRect onRevalidate(InvalidationController*, const SkMatrix&) override;
 
+    // A single child is cached on its own, if at all.
+    bool isCacheable() const override { return fCacheContent && fChildren.size() > 1; }
+
 private:
     std::vector<sk_sp<RenderNode>> fChildren;
+    bool                           fCacheContent = false;
 
     typedef RenderNode INHERITED;
 };
@@ -58,6 +58,9 @@ protected:
     // and return their bounding box in local coordinates.
     virtual SkRect onRevalidate(InvalidationController*, const SkMatrix& ctm) = 0;
 
+    // Dispatched when the node or one of its descendants is tagged for invalidation.
+    virtual void onInvalidate() {}
+
     // Register/unregister |this| to receive invalidation events from a descendant.
     void observeInval(const sk_sp<Node>&);
     void unobserveInval(const sk_sp<Node>&);
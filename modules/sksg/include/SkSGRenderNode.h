@@ -11,6 +11,7 @@
 #include "SkSGNode.h"
 
 #include "SkColorFilter.h"
+#include "SkPicture.h"
 
 class SkCanvas;
 class SkPaint;
@@ -33,6 +34,13 @@ protected:
 
     virtual void onRender(SkCanvas*, const RenderContext*) const = 0;
 
+    // Whether the subtree rooted at this node should be cached: once it renders unchanged for a
+    // couple of frames, it is recorded into a picture, which is drawn instead until the subtree
+    // is invalidated. Changes above the node (e.g. to an ancestor transform) keep the picture.
+    virtual bool isCacheable() const { return false; }
+
+    void onInvalidate() override;
+
     // Paint property overrides.
     // These are deferred until we can determine whether they can be applied to the individual
     // draw paints, or whether they require content isolation (applied to a layer).
@@ -87,6 +95,12 @@ protected:
     };
 
 private:
+    mutable sk_sp<SkPicture>     fCachedPicture;
+    // The render context overrides of the last render, which the picture is recorded with.
+    mutable sk_sp<SkColorFilter> fLastColorFilter;
+    mutable float                fLastOpacity = 1;
+    mutable int                  fUnchangedRenders = 0;
+
     typedef Node INHERITED;
 };
 
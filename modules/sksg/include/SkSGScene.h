@@ -8,6 +8,7 @@
 #ifndef SkSGScene_DEFINED
 #define SkSGScene_DEFINED
 
+#include "SkRect.h"
 #include "SkRefCnt.h"
 #include "SkTypes.h"
 
@@ -68,6 +69,16 @@ public:
     void render(SkCanvas*) const;
     void animate(float t);
 
+    /**
+     * Like render(), but assumes the canvas still holds the frame drawn by the previous call
+     * (e.g. it targets a retained surface, with the same matrix), and only redraws the area
+     * damaged since: it is cleared, and render nodes outside of it are skipped.
+     * Calling render() in between causes the next call to redraw everything.
+     *
+     * Returns the redrawn area, in device space.
+     */
+    SkIRect renderDamage(SkCanvas*);
+
     void setShowInval(bool show) { fShowInval = show; }
 
 private:
@@ -77,6 +88,8 @@ private:
     const AnimatorList      fAnimators;
 
     bool                    fShowInval = false;
+    // Set when the damage since the last renderDamage() was consumed by render().
+    mutable bool            fNeedsFullRedraw = false;
 };
 
 } // namespace sksg
@@ -53,6 +53,7 @@ private:
     Text(sk_sp<SkTypeface>, const SkString&);
 
     SkPoint alignedPosition(SkScalar advance) const;
+    void rebuildBlob(const SkFont&);
 
     sk_sp<SkTypeface> fTypeface;
     SkString                fText;
@@ -64,7 +65,10 @@ private:
     SkFont::Edging          fEdging   = SkFont::Edging::kAntiAlias;
     SkFontHinting           fHinting  = kNormal_SkFontHinting;
 
-    sk_sp<SkTextBlob> fBlob; // cached text blob
+    sk_sp<SkTextBlob> fBlob;              // cached text blob, null if the text shapes to nothing
+    SkFont            fBlobFont;          //  - font and text fBlob was built from
+    SkString          fBlobText;          //  /
+    bool              fBlobBuilt = false; //  /
 
     using INHERITED = GeometryNode;
 };
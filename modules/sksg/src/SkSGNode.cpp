@@ -122,6 +122,7 @@ void Node::invalidate(bool damageBubbling) {
     }
 
     fFlags |= kInvalidated_Flag;
+    this->onInvalidate();
 
     forEachInvalObserver([&](Node* observer) {
         observer->invalidate(damageBubbling);
@@ -9,16 +9,60 @@
 
 #include "SkCanvas.h"
 #include "SkPaint.h"
+#include "SkPictureRecorder.h"
+#include "SkRectPriv.h"
 
 namespace sksg {
 
+// Subtrees are only recorded once they have rendered unchanged this many times in a row.
+static constexpr int kUnchangedRendersBeforeCaching = 2;
+
 RenderNode::RenderNode() : INHERITED(0) {}
 
 void RenderNode::render(SkCanvas* canvas, const RenderContext* ctx) const {
     SkASSERT(!this->hasInval());
+
+    // Skips whole subtrees outside of the clip, e.g. when only redrawing damaged areas.
+    if (canvas->quickReject(this->bounds())) {
+        return;
+    }
+
+    if (this->isCacheable()) {
+        // Overrides that are not applied through a layer end up in the recorded draws, so the
+        // picture is only good for the context it was recorded with.
+        const auto opacity = ctx ? ctx->fOpacity : 1;
+        const auto*     cf = ctx ? ctx->fColorFilter.get() : nullptr;
+        if (opacity != fLastOpacity || cf != fLastColorFilter.get()) {
+            fCachedPicture.reset();
+            fUnchangedRenders = 0;
+            fLastOpacity      = opacity;
+            fLastColorFilter  = sk_ref_sp(cf);
+        }
+
+        if (!fCachedPicture && ++fUnchangedRenders >= kUnchangedRendersBeforeCaching) {
+            // Unbounded content (e.g. planes) is recorded with a cull the recorder can handle.
+            SkRect cull = SkRectPriv::MakeLargeS32();
+            if (!cull.intersect(this->bounds())) {
+                return;
+            }
+            SkPictureRecorder recorder;
+            this->onRender(recorder.beginRecording(cull), ctx);
+            fCachedPicture = recorder.finishRecordingAsPicture();
+        }
+        if (fCachedPicture) {
+            canvas->drawPicture(fCachedPicture);
+            return;
+        }
+    }
+
     this->onRender(canvas, ctx);
 }
 
+void RenderNode::onInvalidate() {
+    fCachedPicture.reset();
+    fUnchangedRenders = 0;
+}
+
 bool RenderNode::RenderContext::modulatePaint(SkPaint* paint) const {
     const auto initial_alpha = paint->getAlpha(),
                        alpha = SkToU8(sk_float_round2int(initial_alpha * fOpacity));
@@ -45,6 +45,7 @@ void Scene::render(SkCanvas* canvas) const {
     InvalidationController ic;
     fRoot->revalidate(&ic, SkMatrix::I());
     fRoot->render(canvas);
+    fNeedsFullRedraw = true;
 
     if (fShowInval) {
         SkPaint fill, stroke;
@@ -61,6 +62,35 @@ void Scene::render(SkCanvas* canvas) const {
     }
 }
 
+SkIRect Scene::renderDamage(SkCanvas* canvas) {
+    InvalidationController ic;
+    fRoot->revalidate(&ic, SkMatrix::I());
+
+    const SkMatrix ctm = canvas->getTotalMatrix();
+    SkIRect damage = canvas->getDeviceClipBounds();
+    if (!fNeedsFullRedraw) {
+        if (ic.bounds().isEmpty()) {
+            return SkIRect::MakeEmpty();
+        }
+        // Node bounds don't account for antialiasing, which can touch one more pixel.
+        const SkIRect devInval = ctm.mapRect(ic.bounds()).roundOut().makeOutset(1, 1);
+        if (!damage.intersect(devInval)) {
+            return SkIRect::MakeEmpty();
+        }
+    }
+    fNeedsFullRedraw = false;
+
+    // The damage is clipped to in device space, to keep its edges on whole pixels.
+    SkAutoCanvasRestore acr(canvas, true);
+    canvas->resetMatrix();
+    canvas->clipRect(SkRect::Make(damage));
+    canvas->clear(SK_ColorTRANSPARENT);
+    canvas->setMatrix(ctm);
+    fRoot->render(canvas);
+
+    return damage;
+}
+
 void Scene::animate(float t) {
     for (const auto& anim : fAnimators) {
         anim->tick(t);
@@ -43,8 +43,6 @@ SkPoint Text::alignedPosition(SkScalar advance) const {
 }
 
 SkRect Text::onRevalidate(InvalidationController*, const SkMatrix&) {
-    // TODO: we could potentially track invals which don't require rebuilding the blob.
-
     SkFont font;
     font.setTypeface(fTypeface);
     font.setSize(fSize);
@@ -56,6 +54,24 @@ SkRect Text::onRevalidate(InvalidationController*, const SkMatrix&) {
     // N.B.: fAlign is applied externally (in alignedPosition()), because
     //  1) SkTextBlob has some trouble computing accurate bounds with alignment.
     //  2) SkPaint::Align is slated for deprecation.
+    // Position and alignment changes therefore reuse the blob.
+    if (!fBlobBuilt || font != fBlobFont || fText != fBlobText) {
+        this->rebuildBlob(font);
+    }
+    if (!fBlob) {
+        return SkRect::MakeEmpty();
+    }
+
+    const auto& bounds = fBlob->bounds();
+    const auto aligned_pos = this->alignedPosition(bounds.width());
+
+    return bounds.makeOffset(aligned_pos.x(), aligned_pos.y());
+}
+
+void Text::rebuildBlob(const SkFont& font) {
+    fBlobFont  = font;
+    fBlobText  = fText;
+    fBlobBuilt = true;
 
     // First, convert to glyphIDs.
     SkSTArray<256, SkGlyphID, true> glyphs;
@@ -68,20 +84,12 @@ SkRect Text::onRevalidate(InvalidationController*, const SkMatrix&) {
     const auto& buf = builder.allocRun(font, glyphs.count(), 0, 0, nullptr);
     if (!buf.glyphs) {
         fBlob.reset();
-        return SkRect::MakeEmpty();
+        return;
     }
 
     memcpy(buf.glyphs, glyphs.begin(), glyphs.count() * sizeof(SkGlyphID));
 
     fBlob = builder.make();
-    if (!fBlob) {
-        return SkRect::MakeEmpty();
-    }
-
-    const auto& bounds = fBlob->bounds();
-    const auto aligned_pos = this->alignedPosition(bounds.width());
-
-    return bounds.makeOffset(aligned_pos.x(), aligned_pos.y());
 }
 
 void Text::onDraw(SkCanvas* canvas, const SkPaint& paint) const {
@@ -9,14 +9,18 @@
 
 #if !defined(SK_BUILD_FOR_GOOGLE3)
 
+#include "SkCanvas.h"
 #include "SkRect.h"
 #include "SkRectPriv.h"
 #include "SkSGColor.h"
 #include "SkSGDraw.h"
 #include "SkSGGroup.h"
 #include "SkSGInvalidationController.h"
+#include "SkSGPath.h"
 #include "SkSGRect.h"
+#include "SkSGScene.h"
 #include "SkSGTransform.h"
+#include "SkSurface.h"
 #include "SkTo.h"
 
 #include "Test.h"
@@ -208,4 +212,178 @@ DEF_TEST(SGInvalidation, reporter) {
     inval_group_remove(reporter);
 }
 
+DEF_TEST(SGRenderDamage, reporter) {
+    auto r1    = sksg::Rect::Make(SkRect::MakeXYWH(10, 10, 20, 20)),
+         r2    = sksg::Rect::Make(SkRect::MakeXYWH(60, 60, 20, 20));
+    auto color = sksg::Color::Make(SK_ColorRED);
+    auto grp   = sksg::Group::Make();
+    grp->addChild(sksg::Draw::Make(r1, sksg::Color::Make(SK_ColorBLUE)));
+    grp->addChild(sksg::Draw::Make(r2, color));
+    color->setAntiAlias(true);
+
+    // A fractional scale, so that damage edges don't fall on pixel boundaries.
+    auto root  = sksg::Transform::Make(grp, sksg::Matrix::Make(SkMatrix::MakeScale(1.3f)));
+    auto scene = sksg::Scene::Make(root, sksg::AnimatorList());
+
+    const auto info = SkImageInfo::MakeN32Premul(128, 128);
+    auto retained = SkSurface::MakeRaster(info),
+         expected = SkSurface::MakeRaster(info);
+
+    // The first frame is redrawn entirely.
+    REPORTER_ASSERT(reporter, scene->renderDamage(retained->getCanvas()) == info.bounds());
+
+    // Nothing changed, nothing to redraw.
+    REPORTER_ASSERT(reporter, scene->renderDamage(retained->getCanvas()).isEmpty());
+
+    // Only the area covering r2's old and new positions is redrawn.
+    r2->setL(62.5f); r2->setT(58.25f); r2->setR(82.5f); r2->setB(78.25f);
+    const auto damage = scene->renderDamage(retained->getCanvas());
+    REPORTER_ASSERT(reporter, !damage.isEmpty());
+    REPORTER_ASSERT(reporter, !SkIRect::Intersects(damage, SkIRect::MakeXYWH(13, 13, 26, 26)));
+
+    expected->getCanvas()->clear(SK_ColorTRANSPARENT);
+    scene->render(expected->getCanvas());
+
+    SkBitmap bm1, bm2;
+    bm1.allocPixels(info);
+    bm2.allocPixels(info);
+    REPORTER_ASSERT(reporter, retained->readPixels(bm1, 0, 0));
+    REPORTER_ASSERT(reporter, expected->readPixels(bm2, 0, 0));
+    REPORTER_ASSERT(reporter, !memcmp(bm1.getPixels(), bm2.getPixels(), bm1.computeByteSize()));
+
+    // render() consumes the damage, so the next renderDamage() redraws everything.
+    REPORTER_ASSERT(reporter, scene->renderDamage(retained->getCanvas()) == info.bounds());
+}
+
+namespace {
+
+// Draws a rect, counting how many times it actually renders.
+class CountingRect final : public sksg::RenderNode {
+public:
+    explicit CountingRect(const SkRect& rect) : fRect(rect) {}
+
+    SG_ATTRIBUTE(Color, SkColor, fColor)
+
+    int renders() const { return fRenders; }
+
+protected:
+    void onRender(SkCanvas* canvas, const RenderContext*) const override {
+        fRenders++;
+        SkPaint paint;
+        paint.setColor(fColor);
+        canvas->drawRect(fRect, paint);
+    }
+
+    SkRect onRevalidate(sksg::InvalidationController*, const SkMatrix&) override {
+        return fRect;
+    }
+
+private:
+    const SkRect fRect;
+    SkColor      fColor = SK_ColorRED;
+    mutable int  fRenders = 0;
+};
+
+} // namespace
+
+DEF_TEST(SGRenderCache, reporter) {
+    auto r1 = sk_make_sp<CountingRect>(SkRect::MakeXYWH( 0, 0, 10, 10)),
+         r2 = sk_make_sp<CountingRect>(SkRect::MakeXYWH(20, 0, 10, 10));
+    auto group  = sksg::Group::Make({ r1, r2 });
+    auto matrix = sksg::Matrix::Make(SkMatrix::I());
+    auto scene  = sksg::Scene::Make(sksg::Transform::Make(group, matrix), sksg::AnimatorList());
+
+    const auto info = SkImageInfo::MakeN32Premul(64, 64);
+    auto surface = SkSurface::MakeRaster(info);
+    SkBitmap bm;
+    bm.allocPixels(info);
+    auto render = [&]() {
+        surface->getCanvas()->clear(SK_ColorTRANSPARENT);
+        scene->render(surface->getCanvas());
+        surface->readPixels(bm, 0, 0);
+    };
+
+    // Groups aren't cached unless asked to be.
+    for (int i = 0; i < 4; ++i) {
+        render();
+    }
+    REPORTER_ASSERT(reporter, r1->renders() == 4);
+    REPORTER_ASSERT(reporter, bm.getColor(25, 5) == SK_ColorRED);
+
+    // The group renders directly once, then once more into its cached picture.
+    group->setCacheContent(true);
+    for (int i = 0; i < 4; ++i) {
+        render();
+    }
+    REPORTER_ASSERT(reporter, r1->renders() == 6);
+    REPORTER_ASSERT(reporter, bm.getColor(25, 5) == SK_ColorRED);
+
+    // Transform changes above the group reuse the picture.
+    matrix->setMatrix(SkMatrix::MakeTrans(0, 20));
+    render();
+    REPORTER_ASSERT(reporter, r1->renders() == 6);
+    REPORTER_ASSERT(reporter, bm.getColor(25,  5) == SK_ColorTRANSPARENT);
+    REPORTER_ASSERT(reporter, bm.getColor(25, 25) == SK_ColorRED);
+
+    // Changes below the group drop it.
+    r2->setColor(SK_ColorBLUE);
+    render();
+    REPORTER_ASSERT(reporter, r1->renders() == 7);
+    REPORTER_ASSERT(reporter, bm.getColor(25, 25) == SK_ColorBLUE);
+    render();
+    render();
+    REPORTER_ASSERT(reporter, r1->renders() == 8);
+    REPORTER_ASSERT(reporter, bm.getColor(25, 25) == SK_ColorBLUE);
+}
+
+DEF_TEST(SGRenderCacheScaled, reporter) {
+    // The same anti-aliased content, in a cached group and in an uncached one.
+    auto make_scene = [](bool cache, const sk_sp<sksg::Matrix>& matrix) {
+        SkPath path;
+        path.addCircle(20, 20, 13.3f);
+        path.moveTo(5, 40);
+        path.quadTo(30, 2, 45, 38);
+        path.close();
+        auto paint = sksg::Color::Make(SK_ColorBLUE);
+        paint->setAntiAlias(true);
+        auto stroke = sksg::Color::Make(SK_ColorRED);
+        stroke->setAntiAlias(true);
+        stroke->setStyle(SkPaint::kStroke_Style);
+        stroke->setStrokeWidth(1.5f);
+        auto group = sksg::Group::Make({ sksg::Draw::Make(sksg::Path::Make(path), paint),
+                                         sksg::Draw::Make(sksg::Path::Make(path), stroke) });
+        group->setCacheContent(cache);
+        return sksg::Scene::Make(sksg::Transform::Make(std::move(group), matrix),
+                                 sksg::AnimatorList());
+    };
+    auto matrix   = sksg::Matrix::Make(SkMatrix::I());
+    auto cached   = make_scene(true, matrix),
+         uncached = make_scene(false, matrix);
+
+    const auto info = SkImageInfo::MakeN32Premul(200, 200);
+    auto surface = SkSurface::MakeRaster(info);
+    auto render = [&](const std::unique_ptr<sksg::Scene>& scene, SkBitmap* bm) {
+        surface->getCanvas()->clear(SK_ColorTRANSPARENT);
+        scene->render(surface->getCanvas());
+        bm->allocPixels(info);
+        surface->readPixels(*bm, 0, 0);
+    };
+
+    // The cached group is recorded unscaled, and then replayed under each scale.
+    SkBitmap expected, actual;
+    for (int i = 0; i < 3; ++i) {
+        render(cached, &actual);
+    }
+    for (float scale : { 1.0f, 3.7f, 0.45f }) {
+        auto m = SkMatrix::MakeScale(scale);
+        m.postTranslate(3.25f, 1.5f);
+        matrix->setMatrix(m);
+        render(uncached, &expected);
+        render(cached, &actual);
+        REPORTER_ASSERT(reporter, 0 == memcmp(expected.getPixels(), actual.getPixels(),
+                                              expected.computeByteSize()),
+                        "scale %g", scale);
+    }
+}
+
 #endif // !defined(SK_BUILD_FOR_GOOGLE3)
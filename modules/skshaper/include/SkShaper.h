@@ -13,7 +13,9 @@
 #include "SkPoint.h"
 #include "SkTypeface.h"
 
+class SkExecutor;
 class SkFont;
+class SkTextBlob;
 class SkTextBlobBuilder;
 
 /**
@@ -21,6 +23,10 @@ class SkTextBlobBuilder;
    TextBlob.
 
    If compiled without HarfBuzz, fall back on SkPaint::textToGlyphs.
+
+   The shaping of recently seen (text, font, direction) is kept, so shaping
+   the same text again, e.g. at a new width, only redoes line breaking.
+   An SkShaper must not be used on more than one thread at a time.
  */
 class SkShaper {
 public:
@@ -36,6 +42,27 @@ public:
                   SkPoint point,
                   SkScalar width) const;
 
+    struct Paragraph {
+        const char* fUtf8;
+        size_t fUtf8Bytes;
+        bool fLeftToRight;
+    };
+    struct ShapedParagraph {
+        sk_sp<SkTextBlob> fBlob;  // nullptr if the paragraph has nothing to draw.
+        SkPoint fEnd;             // What shape() would have returned, starting at (0, 0).
+    };
+    /** Shapes and lays out each paragraph as shape() would, starting at (0, 0), working on
+        several of them at once on the executor (or SkExecutor::GetDefault() if null).
+        This neither uses nor fills the cache.
+     */
+    void shapeParagraphs(const SkFont& srcPaint, const Paragraph paragraphs[], int count,
+                         SkScalar width, ShapedParagraph results[],
+                         SkExecutor* executor = nullptr) const;
+
+    /** How many calls to shape() reused earlier shaping, and how many did not. */
+    int cacheHits() const;
+    int cacheMisses() const;
+
 private:
     SkShaper(const SkShaper&) = delete;
     SkShaper& operator=(const SkShaper&) = delete;
@@ -5,11 +5,14 @@
  * found in the LICENSE file.
  */
 
+#include "SkExecutor.h"
 #include "SkFontArguments.h"
 #include "SkFontMgr.h"
+#include "SkLRUCache.h"
 #include "SkLoadICU.h"
 #include "SkMalloc.h"
 #include "SkOnce.h"
+#include "SkOpts.h"
 #include "SkFont.h"
 #include "SkPoint.h"
 #include "SkRefCnt.h"
@@ -21,6 +24,7 @@
 #include "SkTDPQueue.h"
 #include "SkTFitsIn.h"
 #include "SkTLazy.h"
+#include "SkTaskGroup.h"
 #include "SkTemplates.h"
 #include "SkTextBlobPriv.h"
 #include "SkTo.h"
@@ -39,7 +43,9 @@
 #include <unicode/utext.h>
 #include <unicode/utypes.h>
 
+#include <atomic>
 #include <memory>
+#include <thread>
 #include <utility>
 #include <cstring>
 
@@ -106,9 +112,23 @@ HBFont create_hb_font(SkTypeface* tf) {
                                    axis_count);
         }
     }
+    // Lets shapeParagraphs() shape with the same font on several threads at once.
+    hb_font_make_immutable(font.get());
     return font;
 }
 
+std::unique_ptr<icu::BreakIterator> make_line_break_iterator() {
+    icu::Locale thai("th");
+    UErrorCode status = U_ZERO_ERROR;
+    std::unique_ptr<icu::BreakIterator> iterator(
+            icu::BreakIterator::createLineInstance(thai, status));
+    if (U_FAILURE(status)) {
+        SkDebugf("Could not create break iterator: %s", u_errorName(status));
+        return nullptr;
+    }
+    return iterator;
+}
+
 /** this version replaces invalid utf-8 sequences with code point U+FFFD. */
 static inline SkUnichar utf8_next(const char** ptr, const char* end) {
     SkUnichar val = SkUTF::NextUTF8(ptr, end);
@@ -481,85 +501,43 @@ struct ShapedRunGlyphIterator {
     int fGlyphIndex;
 };
 
-}  // namespace
-
-struct SkShaper::Impl {
-    HBFont fHarfBuzzFont;
-    HBBuffer fBuffer;
-    sk_sp<SkTypeface> fTypeface;
-    std::unique_ptr<icu::BreakIterator> fBreakIterator;
-};
-
-SkShaper::SkShaper(sk_sp<SkTypeface> tf) : fImpl(new Impl) {
-    SkOnce once;
-    once([] { SkLoadICU(); });
-
-    fImpl->fTypeface = tf ? std::move(tf) : SkTypeface::MakeDefault();
-    fImpl->fHarfBuzzFont = create_hb_font(fImpl->fTypeface.get());
-    SkASSERT(fImpl->fHarfBuzzFont);
-    fImpl->fBuffer.reset(hb_buffer_create());
-    SkASSERT(fImpl->fBuffer);
-
-    icu::Locale thai("th");
-    UErrorCode status = U_ZERO_ERROR;
-    fImpl->fBreakIterator.reset(icu::BreakIterator::createLineInstance(thai, status));
-    if (U_FAILURE(status)) {
-        SkDebugf("Could not create break iterator: %s", u_errorName(status));
-        SK_ABORT("");
-    }
-}
-
-SkShaper::~SkShaper() {}
-
-bool SkShaper::good() const {
-    return fImpl->fHarfBuzzFont &&
-           fImpl->fBuffer &&
-           fImpl->fTypeface &&
-           fImpl->fBreakIterator;
-}
-
-SkPoint SkShaper::shape(SkTextBlobBuilder* builder,
-                        const SkFont& srcPaint,
-                        const char* utf8,
-                        size_t utf8Bytes,
-                        bool leftToRight,
-                        SkPoint point,
-                        SkScalar width) const {
+/** Itemizes the text into runs of a single level, script and font, and shapes each of them.
+ *  The results only depend on the text, the font and the direction, so they can be reused.
+ */
+static bool shape_runs(hb_buffer_t* buffer, SkTypeface* typeface, hb_font_t* hbFont,
+                       icu::BreakIterator& breakIterator, const SkFont& srcPaint,
+                       const char* utf8, size_t utf8Bytes, bool leftToRight,
+                       SkTArray<ShapedRun>* runs) {
     sk_sp<SkFontMgr> fontMgr = SkFontMgr::RefDefault();
-    SkASSERT(builder);
     UBiDiLevel defaultLevel = leftToRight ? UBIDI_DEFAULT_LTR : UBIDI_DEFAULT_RTL;
     //hb_script_t script = ...
 
-    SkTArray<ShapedRun> runs;
-{
     RunIteratorQueue runSegmenter;
 
     SkTLazy<BiDiRunIterator> maybeBidi(BiDiRunIterator::Make(utf8, utf8Bytes, defaultLevel));
     BiDiRunIterator* bidi = maybeBidi.getMaybeNull();
     if (!bidi) {
-        return point;
+        return false;
     }
     runSegmenter.insert(bidi);
 
-    hb_unicode_funcs_t* hbUnicode = hb_buffer_get_unicode_funcs(fImpl->fBuffer.get());
+    hb_unicode_funcs_t* hbUnicode = hb_buffer_get_unicode_funcs(buffer);
     SkTLazy<ScriptRunIterator> maybeScript(ScriptRunIterator::Make(utf8, utf8Bytes, hbUnicode));
     ScriptRunIterator* script = maybeScript.getMaybeNull();
     if (!script) {
-        return point;
+        return false;
     }
     runSegmenter.insert(script);
 
     SkTLazy<FontRunIterator> maybeFont(FontRunIterator::Make(utf8, utf8Bytes,
-                                                             fImpl->fTypeface,
-                                                             fImpl->fHarfBuzzFont.get(),
+                                                             sk_ref_sp(typeface), hbFont,
                                                              std::move(fontMgr)));
     FontRunIterator* font = maybeFont.getMaybeNull();
     if (!font) {
-        return point;
+        return false;
     }
     runSegmenter.insert(font);
 
-    icu::BreakIterator& breakIterator = *fImpl->fBreakIterator;
     {
         UErrorCode status = U_ZERO_ERROR;
         UText utf8UText = UTEXT_INITIALIZER;
@@ -567,13 +545,13 @@ SkPoint SkShaper::shape(SkTextBlobBuilder* builder,
         std::unique_ptr<UText, SkFunctionWrapper<UText*, UText, utext_close>> autoClose(&utf8UText);
         if (U_FAILURE(status)) {
             SkDebugf("Could not create utf8UText: %s", u_errorName(status));
-            return point;
+            return false;
         }
         breakIterator.setText(&utf8UText, status);
         //utext_close(&utf8UText);
         if (U_FAILURE(status)) {
             SkDebugf("Could not setText on break iterator: %s", u_errorName(status));
-            return point;
+            return false;
         }
     }
 
@@ -583,7 +561,6 @@ SkPoint SkShaper::shape(SkTextBlobBuilder* builder,
         utf8Start = utf8End;
         utf8End = runSegmenter.endOfCurrentRun();
 
-        hb_buffer_t* buffer = fImpl->fBuffer.get();
         SkAutoTCallVProc<hb_buffer_t, hb_buffer_clear_contents> autoClearBuffer(buffer);
         hb_buffer_set_content_type(buffer, HB_BUFFER_CONTENT_TYPE_UNICODE);
         hb_buffer_set_cluster_level(buffer, HB_BUFFER_CLUSTER_LEVEL_MONOTONE_CHARACTERS);
@@ -605,7 +582,7 @@ SkPoint SkShaper::shape(SkTextBlobBuilder* builder,
         size_t utf8runLength = utf8End - utf8Start;
         if (!SkTFitsIn<int>(utf8runLength)) {
             SkDebugf("Shaping error: utf8 too long");
-            return point;
+            return false;
         }
         hb_buffer_set_script(buffer, script->currentScript());
         hb_direction_t direction = is_LTR(bidi->currentLevel()) ? HB_DIRECTION_LTR:HB_DIRECTION_RTL;
@@ -632,13 +609,13 @@ SkPoint SkShaper::shape(SkTextBlobBuilder* builder,
 
         if (!SkTFitsIn<int>(len)) {
             SkDebugf("Shaping error: too many glyphs");
-            return point;
+            return false;
         }
 
         SkFont paint(srcPaint);
         paint.setTypeface(sk_ref_sp(font->currentTypeface()));
-        ShapedRun& run = runs.emplace_back(utf8Start, utf8End, len, paint, bidi->currentLevel(),
-                                           std::unique_ptr<ShapedGlyph[]>(new ShapedGlyph[len]));
+        ShapedRun& run = runs->emplace_back(utf8Start, utf8End, len, paint, bidi->currentLevel(),
+                                            std::unique_ptr<ShapedGlyph[]>(new ShapedGlyph[len]));
         int scaleX, scaleY;
         hb_font_get_scale(font->currentHBFont(), &scaleX, &scaleY);
         double textSizeY = run.fPaint.getSize() / scaleY;
@@ -672,109 +649,262 @@ SkPoint SkShaper::shape(SkTextBlobBuilder* builder,
             previousCluster = glyph.fCluster;
         }
     }
+    return true;
 }
 
-// Iterate over the glyphs in logical order to mark line endings.
-{
-    SkScalar widthSoFar = 0;
-    bool previousBreakValid = false; // Set when previousBreak is set to a valid candidate break.
-    bool canAddBreakNow = false; // Disallow line breaks before the first glyph of a run.
-    ShapedRunGlyphIterator previousBreak(runs);
-    ShapedRunGlyphIterator glyphIterator(runs);
-    while (ShapedGlyph* glyph = glyphIterator.current()) {
-        if (canAddBreakNow && glyph->fMayLineBreakBefore) {
-            previousBreakValid = true;
-            previousBreak = glyphIterator;
-        }
-        SkScalar glyphWidth = glyph->fAdvance.fX;
-        // TODO: if the glyph is non-visible it can be added.
-        if (widthSoFar + glyphWidth < width) {
-            widthSoFar += glyphWidth;
-            glyphIterator.next();
-            canAddBreakNow = true;
-            continue;
+/** The runs shaped from some text, which they point into. */
+struct ShapedText {
+    SkString fText;
+    SkTArray<ShapedRun> fRuns;
+};
+
+struct ShapeCacheKey {
+    SkString fText;
+    SkFont fFont;
+    bool fLeftToRight;
+
+    bool operator==(const ShapeCacheKey& that) const {
+        return fLeftToRight == that.fLeftToRight && fText == that.fText && fFont == that.fFont;
+    }
+    struct Hash {
+        uint32_t operator()(const ShapeCacheKey& key) const {
+            uint32_t hash = SkOpts::hash(key.fText.c_str(), key.fText.size(), key.fLeftToRight);
+            SkScalar size = key.fFont.getSize();
+            return SkOpts::hash(&size, sizeof(size), hash);
         }
+    };
+};
 
-        // TODO: for both of these emergency break cases
-        // don't break grapheme clusters and pull in any zero width or non-visible
-        if (widthSoFar == 0) {
-            // Adding just this glyph is too much, just break with this glyph
-            glyphIterator.next();
-            previousBreak = glyphIterator;
-        } else if (!previousBreakValid) {
-            // No break opportunity found yet, just break without this glyph
-            previousBreak = glyphIterator;
+/** Breaks the shaped runs into lines no wider than width and writes them, starting at point. */
+static SkPoint layout_runs(SkTextBlobBuilder* builder, SkTArray<ShapedRun>& runs,
+                           SkPoint point, SkScalar width) {
+    // Iterate over the glyphs in logical order to mark line endings.
+    {
+        // Cached runs still carry the line endings for whatever width they were last laid out at.
+        for (ShapedRun& run : runs) {
+            for (int i = 0; i < run.fNumGlyphs; ++i) {
+                run.fGlyphs[i].fMustLineBreakBefore = false;
+            }
         }
-        glyphIterator = previousBreak;
-        glyph = glyphIterator.current();
-        if (glyph) {
-            glyph->fMustLineBreakBefore = true;
+        SkScalar widthSoFar = 0;
+        // Set when previousBreak is set to a valid candidate break.
+        bool previousBreakValid = false;
+        bool canAddBreakNow = false; // Disallow line breaks before the first glyph of a run.
+        ShapedRunGlyphIterator previousBreak(runs);
+        ShapedRunGlyphIterator glyphIterator(runs);
+        while (ShapedGlyph* glyph = glyphIterator.current()) {
+            if (canAddBreakNow && glyph->fMayLineBreakBefore) {
+                previousBreakValid = true;
+                previousBreak = glyphIterator;
+            }
+            SkScalar glyphWidth = glyph->fAdvance.fX;
+            // TODO: if the glyph is non-visible it can be added.
+            if (widthSoFar + glyphWidth < width) {
+                widthSoFar += glyphWidth;
+                glyphIterator.next();
+                canAddBreakNow = true;
+                continue;
+            }
+
+            // TODO: for both of these emergency break cases
+            // don't break grapheme clusters and pull in any zero width or non-visible
+            if (widthSoFar == 0) {
+                // Adding just this glyph is too much, just break with this glyph
+                glyphIterator.next();
+                previousBreak = glyphIterator;
+            } else if (!previousBreakValid) {
+                // No break opportunity found yet, just break without this glyph
+                previousBreak = glyphIterator;
+            }
+            glyphIterator = previousBreak;
+            glyph = glyphIterator.current();
+            if (glyph) {
+                glyph->fMustLineBreakBefore = true;
+            }
+            widthSoFar = 0;
+            previousBreakValid = false;
+            canAddBreakNow = false;
         }
-        widthSoFar = 0;
-        previousBreakValid = false;
-        canAddBreakNow = false;
     }
-}
 
-// Reorder the runs and glyphs per line and write them out.
+    // Reorder the runs and glyphs per line and write them out.
     SkPoint currentPoint = point;
-{
-    ShapedRunGlyphIterator previousBreak(runs);
-    ShapedRunGlyphIterator glyphIterator(runs);
-    SkScalar maxAscent = 0;
-    SkScalar maxDescent = 0;
-    SkScalar maxLeading = 0;
-    int previousRunIndex = -1;
-    while (glyphIterator.current()) {
-        int runIndex = glyphIterator.fRunIndex;
-        int glyphIndex = glyphIterator.fGlyphIndex;
-        ShapedGlyph* nextGlyph = glyphIterator.next();
-
-        if (previousRunIndex != runIndex) {
-            SkFontMetrics metrics;
-            runs[runIndex].fPaint.getMetrics(&metrics);
-            maxAscent = SkTMin(maxAscent, metrics.fAscent);
-            maxDescent = SkTMax(maxDescent, metrics.fDescent);
-            maxLeading = SkTMax(maxLeading, metrics.fLeading);
-            previousRunIndex = runIndex;
-        }
+    {
+        ShapedRunGlyphIterator previousBreak(runs);
+        ShapedRunGlyphIterator glyphIterator(runs);
+        SkScalar maxAscent = 0;
+        SkScalar maxDescent = 0;
+        SkScalar maxLeading = 0;
+        int previousRunIndex = -1;
+        while (glyphIterator.current()) {
+            int runIndex = glyphIterator.fRunIndex;
+            int glyphIndex = glyphIterator.fGlyphIndex;
+            ShapedGlyph* nextGlyph = glyphIterator.next();
+
+            if (previousRunIndex != runIndex) {
+                SkFontMetrics metrics;
+                runs[runIndex].fPaint.getMetrics(&metrics);
+                maxAscent = SkTMin(maxAscent, metrics.fAscent);
+                maxDescent = SkTMax(maxDescent, metrics.fDescent);
+                maxLeading = SkTMax(maxLeading, metrics.fLeading);
+                previousRunIndex = runIndex;
+            }
 
-        // Nothing can be written until the baseline is known.
-        if (!(nextGlyph == nullptr || nextGlyph->fMustLineBreakBefore)) {
-            continue;
-        }
+            // Nothing can be written until the baseline is known.
+            if (!(nextGlyph == nullptr || nextGlyph->fMustLineBreakBefore)) {
+                continue;
+            }
 
-        currentPoint.fY -= maxAscent;
+            currentPoint.fY -= maxAscent;
 
-        int numRuns = runIndex - previousBreak.fRunIndex + 1;
-        SkAutoSTMalloc<4, UBiDiLevel> runLevels(numRuns);
-        for (int i = 0; i < numRuns; ++i) {
-            runLevels[i] = runs[previousBreak.fRunIndex + i].fLevel;
-        }
-        SkAutoSTMalloc<4, int32_t> logicalFromVisual(numRuns);
-        ubidi_reorderVisual(runLevels, numRuns, logicalFromVisual);
-
-        for (int i = 0; i < numRuns; ++i) {
-            int logicalIndex = previousBreak.fRunIndex + logicalFromVisual[i];
-
-            int startGlyphIndex = (logicalIndex == previousBreak.fRunIndex)
-                                ? previousBreak.fGlyphIndex
-                                : 0;
-            int endGlyphIndex = (logicalIndex == runIndex)
-                              ? glyphIndex + 1
-                              : runs[logicalIndex].fNumGlyphs;
-            append(builder, runs[logicalIndex], startGlyphIndex, endGlyphIndex, &currentPoint);
+            int numRuns = runIndex - previousBreak.fRunIndex + 1;
+            SkAutoSTMalloc<4, UBiDiLevel> runLevels(numRuns);
+            for (int i = 0; i < numRuns; ++i) {
+                runLevels[i] = runs[previousBreak.fRunIndex + i].fLevel;
+            }
+            SkAutoSTMalloc<4, int32_t> logicalFromVisual(numRuns);
+            ubidi_reorderVisual(runLevels, numRuns, logicalFromVisual);
+
+            for (int i = 0; i < numRuns; ++i) {
+                int logicalIndex = previousBreak.fRunIndex + logicalFromVisual[i];
+
+                int startGlyphIndex = (logicalIndex == previousBreak.fRunIndex)
+                                    ? previousBreak.fGlyphIndex
+                                    : 0;
+                int endGlyphIndex = (logicalIndex == runIndex)
+                                  ? glyphIndex + 1
+                                  : runs[logicalIndex].fNumGlyphs;
+                append(builder, runs[logicalIndex], startGlyphIndex, endGlyphIndex, &currentPoint);
+            }
+
+            currentPoint.fY += maxDescent + maxLeading;
+            currentPoint.fX = point.fX;
+            maxAscent = 0;
+            maxDescent = 0;
+            maxLeading = 0;
+            previousRunIndex = -1;
+            previousBreak = glyphIterator;
         }
+    }
+
+    return currentPoint;
+}
+
+}  // namespace
+
+// How many of the most recently shaped (text, font, direction) each SkShaper remembers.
+#ifndef SK_SHAPER_CACHE_COUNT
+#define SK_SHAPER_CACHE_COUNT 64
+#endif
+
+struct SkShaper::Impl {
+    HBFont fHarfBuzzFont;
+    HBBuffer fBuffer;
+    sk_sp<SkTypeface> fTypeface;
+    std::unique_ptr<icu::BreakIterator> fBreakIterator;
+
+    SkLRUCache<ShapeCacheKey, ShapedText, ShapeCacheKey::Hash> fShapeCache{
+            SkTMax(SK_SHAPER_CACHE_COUNT, 1)};
+    int fCacheHits = 0;
+    int fCacheMisses = 0;
+};
+
+SkShaper::SkShaper(sk_sp<SkTypeface> tf) : fImpl(new Impl) {
+    SkOnce once;
+    once([] { SkLoadICU(); });
 
-        currentPoint.fY += maxDescent + maxLeading;
-        currentPoint.fX = point.fX;
-        maxAscent = 0;
-        maxDescent = 0;
-        maxLeading = 0;
-        previousRunIndex = -1;
-        previousBreak = glyphIterator;
+    fImpl->fTypeface = tf ? std::move(tf) : SkTypeface::MakeDefault();
+    fImpl->fHarfBuzzFont = create_hb_font(fImpl->fTypeface.get());
+    SkASSERT(fImpl->fHarfBuzzFont);
+    fImpl->fBuffer.reset(hb_buffer_create());
+    SkASSERT(fImpl->fBuffer);
+
+    fImpl->fBreakIterator = make_line_break_iterator();
+    if (!fImpl->fBreakIterator) {
+        SK_ABORT("");
     }
 }
 
-    return currentPoint;
+SkShaper::~SkShaper() {}
+
+bool SkShaper::good() const {
+    return fImpl->fHarfBuzzFont &&
+           fImpl->fBuffer &&
+           fImpl->fTypeface &&
+           fImpl->fBreakIterator;
+}
+
+int SkShaper::cacheHits() const { return fImpl->fCacheHits; }
+int SkShaper::cacheMisses() const { return fImpl->fCacheMisses; }
+
+SkPoint SkShaper::shape(SkTextBlobBuilder* builder,
+                        const SkFont& srcPaint,
+                        const char* utf8,
+                        size_t utf8Bytes,
+                        bool leftToRight,
+                        SkPoint point,
+                        SkScalar width) const {
+    SkASSERT(builder);
+
+    ShapeCacheKey key = { SkString(utf8, utf8Bytes), srcPaint, leftToRight };
+    ShapedText* shaped = fImpl->fShapeCache.find(key);
+    if (shaped) {
+        ++fImpl->fCacheHits;
+    } else {
+        ++fImpl->fCacheMisses;
+        ShapedText text;
+        // Shape the cache's copy of the text, which the runs can keep pointing into.
+        text.fText = key.fText;
+        if (!shape_runs(fImpl->fBuffer.get(), fImpl->fTypeface.get(), fImpl->fHarfBuzzFont.get(),
+                        *fImpl->fBreakIterator, srcPaint, text.fText.c_str(), utf8Bytes,
+                        leftToRight, &text.fRuns)) {
+            return point;
+        }
+        shaped = fImpl->fShapeCache.insert(key, std::move(text));
+    }
+    SkTArray<ShapedRun>& runs = shaped->fRuns;
+
+    return layout_runs(builder, runs, point, width);
+}
+
+void SkShaper::shapeParagraphs(const SkFont& srcPaint, const Paragraph paragraphs[], int count,
+                               SkScalar width, ShapedParagraph results[],
+                               SkExecutor* executor) const {
+    // The hb_font_t is immutable, so the workers share it. Each needs its own hb_buffer_t and
+    // break iterator though, which are made up front, so no worker makes more than one.
+    struct Worker {
+        HBBuffer fBuffer;
+        std::unique_ptr<icu::BreakIterator> fBreakIterator;
+    };
+    int workerCount = SkTMin(count, SkTMax(1, (int)std::thread::hardware_concurrency()));
+    std::unique_ptr<Worker[]> workers(new Worker[SkTMax(workerCount, 0)]);
+    for (int i = 0; i < workerCount; ++i) {
+        workers[i].fBuffer.reset(hb_buffer_create());
+        workers[i].fBreakIterator = make_line_break_iterator();
+        if (!workers[i].fBreakIterator) {
+            workerCount = i;
+            break;
+        }
+    }
+    for (int i = 0; i < count; ++i) {
+        results[i] = { nullptr, SkPoint::Make(0, 0) };
+    }
+
+    std::atomic<int> nextParagraph{0};
+    SkTaskGroup(executor ? *executor : SkExecutor::GetDefault()).batch(workerCount, [&](int w) {
+        Worker& worker = workers[w];
+        for (int i; (i = nextParagraph.fetch_add(1, std::memory_order_relaxed)) < count;) {
+            const Paragraph& paragraph = paragraphs[i];
+            SkTArray<ShapedRun> runs;
+            if (!shape_runs(worker.fBuffer.get(), fImpl->fTypeface.get(),
+                            fImpl->fHarfBuzzFont.get(), *worker.fBreakIterator, srcPaint,
+                            paragraph.fUtf8, paragraph.fUtf8Bytes, paragraph.fLeftToRight,
+                            &runs)) {
+                continue;
+            }
+            SkTextBlobBuilder builder;
+            results[i].fEnd = layout_runs(&builder, runs, SkPoint::Make(0, 0), width);
+            results[i].fBlob = builder.make();
+        }
+    });
 }
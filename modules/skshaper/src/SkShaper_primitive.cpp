@@ -24,6 +24,9 @@ SkShaper::~SkShaper() {}
 
 bool SkShaper::good() const { return true; }
 
+int SkShaper::cacheHits() const { return 0; }
+int SkShaper::cacheMisses() const { return 0; }
+
 // This example only uses public API, so we don't use SkUTF8_NextUnichar.
 unsigned utf8_lead_byte_to_count(const char* ptr) {
     uint8_t c = *(const uint8_t*)ptr;
@@ -78,3 +81,15 @@ SkPoint SkShaper::shape(SkTextBlobBuilder* builder,
 
     return point;
 }
+
+void SkShaper::shapeParagraphs(const SkFont& srcPaint, const Paragraph paragraphs[], int count,
+                               SkScalar width, ShapedParagraph results[],
+                               SkExecutor*) const {
+    for (int i = 0; i < count; ++i) {
+        SkTextBlobBuilder builder;
+        results[i].fEnd = this->shape(&builder, srcPaint, paragraphs[i].fUtf8,
+                                      paragraphs[i].fUtf8Bytes, paragraphs[i].fLeftToRight,
+                                      SkPoint::Make(0, 0), width);
+        results[i].fBlob = builder.make();
+    }
+}
@@ -6,15 +6,189 @@
  */
 
 #include "SkAndroidCodec.h"
+#include "SkBitmapCache.h"
 #include "SkBitmapRegionCodec.h"
 #include "SkBitmapRegionDecoderPriv.h"
 #include "SkCodecPriv.h"
+#include "SkConvertPixels.h"
+#include "SkNextID.h"
 
-SkBitmapRegionCodec::SkBitmapRegionCodec(SkAndroidCodec* codec)
+// The width and height of a cached tile, in decoded (sampled) pixels.
+#ifndef SK_BRD_TILE_SIZE
+    #define SK_BRD_TILE_SIZE 256
+#endif
+
+/*
+ * Whether decoding a tile gives exactly the pixels that decoding a larger region around it would.
+ * That holds when the codec point samples.  JPEG and WebP scale natively, with filters that reach
+ * across tile seams, and crop before upsampling chroma, so their tiles would show the seams.
+ */
+static bool tiles_match_regions(SkEncodedImageFormat format) {
+    switch (format) {
+        case SkEncodedImageFormat::kPNG:
+            return true;
+        default:
+            return false;
+    }
+}
+
+SkBitmapRegionCodec::SkBitmapRegionCodec(SkAndroidCodec* codec, bool cacheTiles)
     : INHERITED(codec->getInfo().width(), codec->getInfo().height())
     , fCodec(codec)
+    , fCacheTiles(cacheTiles)
 {}
 
+SkBitmapRegionCodec::~SkBitmapRegionCodec() {
+    for (const TileConfig& config : fTileConfigs) {
+        SkNotifyBitmapGenIDIsStale(config.fID);
+    }
+}
+
+uint32_t SkBitmapRegionCodec::tileCacheID(const SkImageInfo& decodeInfo, int sampleSize) {
+    for (const TileConfig& config : fTileConfigs) {
+        if (config.fSampleSize == sampleSize && config.fColorType == decodeInfo.colorType() &&
+            config.fAlphaType == decodeInfo.alphaType() &&
+            SkColorSpace::Equals(config.fColorSpace.get(), decodeInfo.colorSpace())) {
+            return config.fID;
+        }
+    }
+    uint32_t id = SkNextID::ImageID();
+    fTileConfigs.push_back({ sampleSize, decodeInfo.colorType(), decodeInfo.alphaType(),
+                             decodeInfo.refColorSpace(), id });
+    return id;
+}
+
+bool SkBitmapRegionCodec::decodeTiles(const SkImageInfo& decodeInfo, void* dst, size_t rowBytes,
+        const SkIRect& subset, int sampleSize, SkCodec::Result* result) {
+    // Tiles sit on the grid of pixels that sampling the whole image decodes, so only subsets
+    // which start on that grid can be put together from them.
+    if (!tiles_match_regions(fCodec->getEncodedFormat()) ||
+            subset.x() % sampleSize != 0 || subset.y() % sampleSize != 0) {
+        return false;
+    }
+
+    // Tiles and regions are in the coordinates of the sampled image.
+    const SkISize imageSize = fCodec->getSampledDimensions(sampleSize);
+    const SkIRect imageBounds = SkIRect::MakeSize(imageSize);
+    const SkIRect region = SkIRect::MakeXYWH(subset.x() / sampleSize, subset.y() / sampleSize,
+                                             decodeInfo.width(), decodeInfo.height());
+    if (!imageBounds.contains(region)) {
+        return false;
+    }
+    auto tileBounds = [&](int tileX, int tileY) {
+        SkIRect bounds = SkIRect::MakeXYWH(tileX * SK_BRD_TILE_SIZE, tileY * SK_BRD_TILE_SIZE,
+                                           SK_BRD_TILE_SIZE, SK_BRD_TILE_SIZE);
+        SkAssertResult(bounds.intersect(imageBounds));
+        return bounds;
+    };
+
+    const int left   =  region.fLeft        / SK_BRD_TILE_SIZE,
+              top    =  region.fTop         / SK_BRD_TILE_SIZE,
+              right  = (region.fRight  - 1) / SK_BRD_TILE_SIZE + 1,
+              bottom = (region.fBottom - 1) / SK_BRD_TILE_SIZE + 1;
+    const uint32_t cacheID = this->tileCacheID(decodeInfo, sampleSize);
+    SkAutoTArray<SkBitmap> tiles((right - left) * (bottom - top));
+    auto tileAt = [&](int tileX, int tileY) -> SkBitmap& {
+        return tiles[(tileY - top) * (right - left) + (tileX - left)];
+    };
+
+    SkIRect missing = SkIRect::MakeEmpty();
+    for (int tileY = top; tileY < bottom; tileY++) {
+        for (int tileX = left; tileX < right; tileX++) {
+            auto desc = SkBitmapCacheDesc::Make(cacheID, tileBounds(tileX, tileY));
+            if (!SkBitmapCache::Find(desc, &tileAt(tileX, tileY))) {
+                missing.join(SkIRect::MakeXYWH(tileX, tileY, 1, 1));
+            }
+        }
+    }
+
+    *result = SkCodec::kSuccess;
+    if (!missing.isEmpty()) {
+        // Decode the missing tiles together, so that formats which can only start decoding at
+        // the top of the image pass over the rows above them once.
+        SkIRect decodedBounds = tileBounds(missing.fLeft, missing.fTop);
+        decodedBounds.join(tileBounds(missing.fRight - 1, missing.fBottom - 1));
+        SkIRect decodeSubset = SkIRect::MakeLTRB(decodedBounds.fLeft * sampleSize,
+                                                 decodedBounds.fTop * sampleSize,
+                                                 decodedBounds.fRight * sampleSize,
+                                                 decodedBounds.fBottom * sampleSize);
+        // The sampled image ignores the columns and rows left over past its last pixels.
+        if (decodedBounds.fRight == imageSize.width()) {
+            decodeSubset.fRight = fCodec->getInfo().width();
+        }
+        if (decodedBounds.fBottom == imageSize.height()) {
+            decodeSubset.fBottom = fCodec->getInfo().height();
+        }
+        if (fCodec->getSampledSubsetDimensions(sampleSize, decodeSubset) !=
+                decodedBounds.size()) {
+            return false;
+        }
+
+        SkBitmap decoded;
+        if (!decoded.tryAllocPixels(decodeInfo.makeWH(decodedBounds.width(),
+                                                      decodedBounds.height()))) {
+            return false;
+        }
+        SkAndroidCodec::AndroidOptions options;
+        options.fSampleSize = sampleSize;
+        options.fSubset = &decodeSubset;
+        *result = fCodec->getAndroidPixels(decoded.info(), decoded.getPixels(), decoded.rowBytes(),
+                                           &options);
+        switch (*result) {
+            case SkCodec::kSuccess:
+            case SkCodec::kIncompleteInput:
+            case SkCodec::kErrorInInput:
+                break;
+            default:
+                return true;
+        }
+
+        for (int tileY = missing.fTop; tileY < missing.fBottom; tileY++) {
+            for (int tileX = missing.fLeft; tileX < missing.fRight; tileX++) {
+                SkBitmap& tile = tileAt(tileX, tileY);
+                if (!tile.isNull()) {
+                    continue;
+                }
+                const SkIRect bounds = tileBounds(tileX, tileY);
+                const SkIRect inDecoded = bounds.makeOffset(-decodedBounds.x(),
+                                                            -decodedBounds.y());
+                SkPixmap src;
+                SkAssertResult(decoded.pixmap().extractSubset(&src, inDecoded));
+
+                // Only complete decodes are cached; a damaged image's tiles serve this region.
+                SkPixmap cached;
+                SkBitmapCache::RecPtr rec = SkCodec::kSuccess == *result
+                        ? SkBitmapCache::Alloc(SkBitmapCacheDesc::Make(cacheID, bounds),
+                                               src.info(), &cached)
+                        : nullptr;
+                if (rec) {
+                    SkRectMemcpy(cached.writable_addr(), cached.rowBytes(), src.addr(),
+                                 src.rowBytes(), src.info().minRowBytes(), src.height());
+                    SkBitmapCache::Add(std::move(rec), &tile);
+                } else {
+                    SkAssertResult(decoded.extractSubset(&tile, inDecoded));
+                }
+            }
+        }
+    }
+
+    const size_t bpp = decodeInfo.bytesPerPixel();
+    for (int tileY = top; tileY < bottom; tileY++) {
+        for (int tileX = left; tileX < right; tileX++) {
+            const SkIRect bounds = tileBounds(tileX, tileY);
+            SkIRect overlap = bounds;
+            SkAssertResult(overlap.intersect(region));
+            const SkBitmap& tile = tileAt(tileX, tileY);
+            SkRectMemcpy(SkTAddOffset<void>(dst, (overlap.fTop - region.fTop) * rowBytes +
+                                                 (overlap.fLeft - region.fLeft) * bpp),
+                         rowBytes,
+                         tile.getAddr(overlap.fLeft - bounds.fLeft, overlap.fTop - bounds.fTop),
+                         tile.rowBytes(), overlap.width() * bpp, overlap.height());
+        }
+    }
+    return true;
+}
+
 bool SkBitmapRegionCodec::decodeRegion(SkBitmap* bitmap, SkBRDAllocator* allocator,
         const SkIRect& desiredSubset, int sampleSize, SkColorType dstColorType,
         bool requireUnpremul, sk_sp<SkColorSpace> dstColorSpace) {
@@ -96,15 +270,17 @@ bool SkBitmapRegionCodec::decodeRegion(SkBitmap* bitmap, SkBRDAllocator* allocat
         memset(pixels, 0, bytes);
     }
 
-    // Decode into the destination bitmap
-    SkAndroidCodec::AndroidOptions options;
-    options.fSampleSize = sampleSize;
-    options.fSubset = &subset;
-    options.fZeroInitialized = zeroInit;
     void* dst = bitmap->getAddr(scaledOutX, scaledOutY);
-
-    SkCodec::Result result = fCodec->getAndroidPixels(decodeInfo, dst, bitmap->rowBytes(),
-            &options);
+    SkCodec::Result result;
+    if (!fCacheTiles ||
+            !this->decodeTiles(decodeInfo, dst, bitmap->rowBytes(), subset, sampleSize, &result)) {
+        // Decode into the destination bitmap
+        SkAndroidCodec::AndroidOptions options;
+        options.fSampleSize = sampleSize;
+        options.fSubset = &subset;
+        options.fZeroInitialized = zeroInit;
+        result = fCodec->getAndroidPixels(decodeInfo, dst, bitmap->rowBytes(), &options);
+    }
     switch (result) {
         case SkCodec::kSuccess:
         case SkCodec::kIncompleteInput:
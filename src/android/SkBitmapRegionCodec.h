@@ -11,6 +11,7 @@
 #include "SkBitmap.h"
 #include "SkBitmapRegionDecoder.h"
 #include "SkAndroidCodec.h"
+#include "SkTArray.h"
 
 /*
  * This class implements SkBitmapRegionDecoder using an SkAndroidCodec.
@@ -20,8 +21,13 @@ public:
 
     /*
      * Takes ownership of pointer to codec
+     *
+     * If cacheTiles is true, decoded regions are kept in SkResourceCache as a grid of tiles,
+     * and later regions are put together from the cached tiles, decoding only the missing ones.
      */
-    SkBitmapRegionCodec(SkAndroidCodec* codec);
+    SkBitmapRegionCodec(SkAndroidCodec* codec, bool cacheTiles = false);
+
+    ~SkBitmapRegionCodec() override;
 
     bool decodeRegion(SkBitmap* bitmap, SkBRDAllocator* allocator,
                       const SkIRect& desiredSubset, int sampleSize,
@@ -41,7 +47,28 @@ public:
 
 private:
 
+    /*
+     * Decodes the scaled subset into dst from cached tiles, decoding and caching the tiles
+     * which are missing.  Returns false, having written nothing, if the tiles could not produce
+     * the same pixels as decoding the subset directly.
+     */
+    bool decodeTiles(const SkImageInfo& decodeInfo, void* dst, size_t rowBytes,
+                     const SkIRect& subset, int sampleSize, SkCodec::Result* result);
+
+    // The cache ID of the tiles decoded with these settings.
+    uint32_t tileCacheID(const SkImageInfo& decodeInfo, int sampleSize);
+
+    struct TileConfig {
+        int                 fSampleSize;
+        SkColorType         fColorType;
+        SkAlphaType         fAlphaType;
+        sk_sp<SkColorSpace> fColorSpace;
+        uint32_t            fID;
+    };
+
     std::unique_ptr<SkAndroidCodec> fCodec;
+    const bool                      fCacheTiles;
+    SkTArray<TileConfig>            fTileConfigs;
 
     typedef SkBitmapRegionDecoder INHERITED;
 
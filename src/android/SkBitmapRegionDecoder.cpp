@@ -21,7 +21,8 @@ SkBitmapRegionDecoder* SkBitmapRegionDecoder::Create(
         SkStreamRewindable* stream, Strategy strategy) {
     std::unique_ptr<SkStreamRewindable> streamDeleter(stream);
     switch (strategy) {
-        case kAndroidCodec_Strategy: {
+        case kAndroidCodec_Strategy:
+        case kTiledAndroidCodec_Strategy: {
             auto codec = SkAndroidCodec::MakeFromStream(std::move(streamDeleter));
             if (nullptr == codec) {
                 SkCodecPrintf("Error: Failed to create codec.\n");
@@ -38,7 +39,8 @@ SkBitmapRegionDecoder* SkBitmapRegionDecoder::Create(
                     return nullptr;
             }
 
-            return new SkBitmapRegionCodec(codec.release());
+            return new SkBitmapRegionCodec(codec.release(),
+                                           kTiledAndroidCodec_Strategy == strategy);
         }
         default:
             SkASSERT(false);
@@ -9,6 +9,8 @@
 #include "SkCodec.h"
 #include "SkCodecPriv.h"
 #include "SkColorSpace.h"
+#include "SkColorSpacePriv.h"
+#include "SkConvertPixels.h"
 #include "SkData.h"
 #include "SkFrameHolder.h"
 #include "SkHalf.h"
@@ -22,6 +24,7 @@
 #endif
 #include "SkRawCodec.h"
 #include "SkStream.h"
+#include "SkTaskGroup.h"
 #include "SkWbmpCodec.h"
 #include "SkWebpCodec.h"
 #ifdef SK_HAS_WUFFS_LIBRARY
@@ -632,7 +635,7 @@ bool SkCodec::initializeColorXform(const SkImageInfo& dstInfo, SkEncodedInfo::Al
             if (!srcProfile) {
                 srcProfile = skcms_sRGB_profile();
             }
-            if (!skcms_ApproximatelyEqualProfiles(srcProfile, &fDstProfile) ) {
+            if (!sk_approximately_equal_profiles(srcProfile, &fDstProfile)) {
                 needsColorXform = true;
             }
         }
@@ -668,6 +671,90 @@ void SkCodec::applyColorXform(void* dst, const void* src, int count) const {
                                    count));
 }
 
+std::unique_ptr<SkStream> SkCodec::onDuplicateStream() const {
+    return fStream ? fStream->duplicate() : nullptr;
+}
+
+// The most codecs getAllFrames() will decode with at once.
+#ifndef SK_CODEC_MAX_FRAME_DECODERS
+    #define SK_CODEC_MAX_FRAME_DECODERS 8
+#endif
+
+SkCodec::Result SkCodec::getAllFrames(const SkImageInfo& info, void* const pixels[],
+                                      size_t rowBytes, SkExecutor* executor) {
+    const std::vector<FrameInfo> frameInfos = this->getFrameInfo();
+    if (frameInfos.empty()) {
+        return this->getPixels(info, pixels[0], rowBytes);
+    }
+
+    // Each run starts at an independent frame, and holds the frames which build on it.
+    std::vector<std::vector<int>> runs;
+    std::vector<int> runOfFrame(frameInfos.size());
+    for (int i = 0; i < (int) frameInfos.size(); i++) {
+        const int requiredFrame = frameInfos[i].fRequiredFrame;
+        SkASSERT(requiredFrame < i);
+        if (kNoFrame == requiredFrame) {
+            runOfFrame[i] = (int) runs.size();
+            runs.emplace_back();
+        } else {
+            runOfFrame[i] = runOfFrame[requiredFrame];
+        }
+        runs[runOfFrame[i]].push_back(i);
+    }
+
+    auto decodeRun = [&](SkCodec* codec, const std::vector<int>& run) {
+        for (int i : run) {
+            Options options;
+            options.fFrameIndex = i;
+            const int requiredFrame = frameInfos[i].fRequiredFrame;
+            if (kNoFrame != requiredFrame) {
+                SkRectMemcpy(pixels[i], rowBytes, pixels[requiredFrame], rowBytes,
+                             info.minRowBytes(), info.height());
+                options.fPriorFrame = requiredFrame;
+            }
+            const Result result = codec->getPixels(info, pixels[i], rowBytes, &options);
+            if (kSuccess != result) {
+                return result;
+            }
+        }
+        return kSuccess;
+    };
+
+    // This codec decodes some of the runs, and each other decoder needs a codec of its own.
+    std::vector<std::unique_ptr<SkCodec>> codecs;
+    codecs.emplace_back(nullptr);
+    const int maxDecoders = executor ? SkTMin<int>(runs.size(), SK_CODEC_MAX_FRAME_DECODERS) : 1;
+    while ((int) codecs.size() < maxDecoders) {
+        std::unique_ptr<SkStream> stream = this->onDuplicateStream();
+        std::unique_ptr<SkCodec> codec = stream ? MakeFromStream(std::move(stream)) : nullptr;
+        if (!codec) {
+            break;
+        }
+        codecs.push_back(std::move(codec));
+    }
+
+    const int decoders = (int) codecs.size();
+    std::vector<Result> results(runs.size(), kSuccess);
+    auto decodeRuns = [&](int decoder) {
+        SkCodec* codec = decoder ? codecs[decoder].get() : this;
+        for (size_t run = decoder; run < runs.size(); run += decoders) {
+            results[run] = decodeRun(codec, runs[run]);
+        }
+    };
+    if (decoders > 1) {
+        SkTaskGroup(*executor).batch(decoders, decodeRuns);
+    } else {
+        decodeRuns(0);
+    }
+
+    for (Result result : results) {
+        if (kSuccess != result) {
+            return result;
+        }
+    }
+    return kSuccess;
+}
+
 std::vector<SkCodec::FrameInfo> SkCodec::getFrameInfo() {
     const int frameCount = this->getFrameCount();
     SkASSERT(frameCount >= 0);
@@ -60,6 +60,10 @@ protected:
         return fReader.get();
     }
 
+    std::unique_ptr<SkStream> onDuplicateStream() const override {
+        return fReader->duplicateStream();
+    }
+
 private:
 
     /*
@@ -14,6 +14,9 @@
 #include "SkEndian.h"
 #include "SkStream.h"
 #include "SkHeifCodec.h"
+#include "SkTaskGroup.h"
+
+#include <atomic>
 
 #define FOURCC(c1, c2, c3, c4) \
     ((c1) << 24 | (c2) << 16 | (c3) << 8 | (c4))
@@ -118,6 +121,16 @@ private:
     std::unique_ptr<SkStream> fStream;
 };
 
+// Whether the tiles exactly cover the image, with only the last row and column cropped.
+static bool grid_covers(const HeifGridInfo& grid, const HeifFrameInfo& frameInfo) {
+    auto covers = [](int64_t tiles, int64_t tileSize, int64_t size) {
+        return tiles > 0 && tileSize > 0 && tiles * tileSize >= size
+                                         && (tiles - 1) * tileSize < size;
+    };
+    return covers(grid.mCols, grid.mTileWidth,  frameInfo.mWidth)
+        && covers(grid.mRows, grid.mTileHeight, frameInfo.mHeight);
+}
+
 std::unique_ptr<SkCodec> SkHeifCodec::MakeFromStream(
         std::unique_ptr<SkStream> stream, Result* result) {
     std::unique_ptr<HeifDecoder> heifDecoder(createHeifDecoder());
@@ -148,16 +161,27 @@ std::unique_ptr<SkCodec> SkHeifCodec::MakeFromStream(
             SkEncodedInfo::kYUV_Color, SkEncodedInfo::kOpaque_Alpha, 8, std::move(profile));
     SkEncodedOrigin orientation = get_orientation(frameInfo);
 
+    // Treat an image without a (sensible) grid as a single tile.
+    HeifGridInfo gridInfo;
+    if (!heifDecoder->getGridInfo(&gridInfo) || !grid_covers(gridInfo, frameInfo)) {
+        gridInfo = { 1, 1, frameInfo.mWidth, frameInfo.mHeight };
+    }
+
     *result = kSuccess;
     return std::unique_ptr<SkCodec>(new SkHeifCodec(std::move(info), heifDecoder.release(),
-                                                    orientation));
+                                                    gridInfo, orientation));
 }
 
-SkHeifCodec::SkHeifCodec(SkEncodedInfo&& info, HeifDecoder* heifDecoder, SkEncodedOrigin origin)
+SkHeifCodec::SkHeifCodec(SkEncodedInfo&& info, HeifDecoder* heifDecoder,
+                         const HeifGridInfo& gridInfo, SkEncodedOrigin origin)
     : INHERITED(std::move(info), skcms_PixelFormat_RGBA_8888, nullptr, origin)
     , fHeifDecoder(heifDecoder)
+    , fGridInfo(gridInfo)
     , fSwizzleSrcRow(nullptr)
     , fColorXformSrcRow(nullptr)
+    , fIncrementalDst(nullptr)
+    , fIncrementalRowBytes(0)
+    , fIncrementalSrcRect(SkIRect::MakeEmpty())
 {}
 
 
@@ -249,6 +273,69 @@ int SkHeifCodec::readRows(const SkImageInfo& dstInfo, void* dst, size_t rowBytes
     return count;
 }
 
+bool SkHeifCodec::decodeTiles(const SkImageInfo& dstInfo, void* dst, size_t dstRowBytes,
+                              const SkIRect& srcRect, const Options& options) {
+    SkASSERT(this->bounds().contains(srcRect) && !srcRect.isEmpty());
+    const int tileWidth  = fGridInfo.mTileWidth,
+              tileHeight = fGridInfo.mTileHeight;
+    const int firstCol = srcRect.left() / tileWidth,
+              firstRow = srcRect.top()  / tileHeight,
+              cols     = (srcRect.right()  - 1) / tileWidth  - firstCol + 1,
+              rows     = (srcRect.bottom() - 1) / tileHeight - firstRow + 1;
+
+    SkImageInfo swizzlerDstInfo = dstInfo;
+    int srcBPP = 4;
+    if (this->colorXform()) {
+        // The color xform will be expecting RGBA 8888 input.
+        swizzlerDstInfo = swizzlerDstInfo.makeColorType(kRGBA_8888_SkColorType);
+    } else if (dstInfo.colorType() == kRGB_565_SkColorType) {
+        srcBPP = 2;
+    }
+    const int dstBPP = dstInfo.bytesPerPixel();
+
+    std::atomic<bool> failed{false};
+    SkTaskGroup().batch(rows * cols, [&](int i) {
+        if (failed.load(std::memory_order_relaxed)) {
+            return;
+        }
+        const int row = firstRow + i / cols,
+                  col = firstCol + i % cols;
+        SkIRect tileRect = SkIRect::MakeXYWH(col * tileWidth, row * tileHeight,
+                                             tileWidth, tileHeight);
+        SkAssertResult(tileRect.intersect(this->bounds()));
+        SkIRect rect = tileRect;
+        SkAssertResult(rect.intersect(srcRect));
+
+        const size_t tileRowBytes = (size_t) tileRect.width() * srcBPP;
+        SkAutoTMalloc<uint8_t> tile(tileRowBytes * tileRect.height());
+        if (!fHeifDecoder->decodeTile(row, col, tile.get(), tileRowBytes)) {
+            failed.store(true, std::memory_order_relaxed);
+            return;
+        }
+
+        // The swizzler copies the columns of the tile that are within srcRect.
+        SkIRect subset = SkIRect::MakeXYWH(rect.left() - tileRect.left(), 0, rect.width(), 1);
+        Options swizzlerOptions = options;
+        swizzlerOptions.fSubset = &subset;
+        auto swizzler = SkSwizzler::MakeSimple(srcBPP, swizzlerDstInfo, swizzlerOptions);
+        SkASSERT(swizzler);
+
+        SkAutoTMalloc<uint32_t> xformSrcRow(this->colorXform() ? rect.width() : 0);
+        for (int y = rect.top(); y < rect.bottom(); y++) {
+            const uint8_t* src = tile.get() + (y - tileRect.top()) * tileRowBytes;
+            void* dstRow = SkTAddOffset<void>(dst, (y - srcRect.top()) * dstRowBytes
+                                                 + (rect.left() - srcRect.left()) * dstBPP);
+            if (this->colorXform()) {
+                swizzler->swizzle(xformSrcRow.get(), src);
+                this->applyColorXform(dstRow, xformSrcRow.get(), rect.width());
+            } else {
+                swizzler->swizzle(dstRow, src);
+            }
+        }
+    });
+    return !failed.load();
+}
+
 /*
  * Performs the heif decode
  */
@@ -257,12 +344,16 @@ SkCodec::Result SkHeifCodec::onGetPixels(const SkImageInfo& dstInfo,
                                          const Options& options,
                                          int* rowsDecoded) {
     if (options.fSubset) {
-        // Not supporting subsets on this path for now.
-        // TODO: if the heif has tiles, we can support subset here, but
-        // need to retrieve tile config from metadata retriever first.
+        // Subsets of grids are decoded by the incremental decode.
         return kUnimplemented;
     }
 
+    // If a tile fails to decode, fall back to the sequential decode, which can report how much
+    // of the image it decoded.
+    if (this->isGrid() && this->decodeTiles(dstInfo, dst, dstRowBytes, this->bounds(), options)) {
+        return kSuccess;
+    }
+
     if (!fHeifDecoder->decode(&fFrameInfo)) {
         return kInvalidInput;
     }
@@ -279,6 +370,28 @@ SkCodec::Result SkHeifCodec::onGetPixels(const SkImageInfo& dstInfo,
     return kSuccess;
 }
 
+SkCodec::Result SkHeifCodec::onStartIncrementalDecode(const SkImageInfo& dstInfo, void* dst,
+        size_t rowBytes, const Options& options) {
+    // Without a grid, subsets are decoded a scanline at a time.
+    if (!this->isGrid()) {
+        return kUnimplemented;
+    }
+
+    fIncrementalDst = dst;
+    fIncrementalRowBytes = rowBytes;
+    fIncrementalSrcRect = options.fSubset ? *options.fSubset : this->bounds();
+    return kSuccess;
+}
+
+SkCodec::Result SkHeifCodec::onIncrementalDecode(int* rowsDecoded) {
+    if (!this->decodeTiles(this->dstInfo(), fIncrementalDst, fIncrementalRowBytes,
+                           fIncrementalSrcRect, this->options())) {
+        *rowsDecoded = 0;
+        return kErrorInInput;
+    }
+    return kSuccess;
+}
+
 void SkHeifCodec::allocateStorage(const SkImageInfo& dstInfo) {
     int dstWidth = dstInfo.width();
 
@@ -334,9 +447,8 @@ SkSampler* SkHeifCodec::getSampler(bool createIfNecessary) {
 
 SkCodec::Result SkHeifCodec::onStartScanlineDecode(
         const SkImageInfo& dstInfo, const Options& options) {
-    // TODO: For now, just decode the whole thing even when there is a subset.
-    // If the heif image has tiles, we could potentially do this much faster,
-    // but the tile configuration needs to be retrieved from the metadata.
+    // This decodes the whole image even when there is a subset. Subsets of grids are decoded
+    // a tile at a time by the incremental decode instead.
     if (!fHeifDecoder->decode(&fFrameInfo)) {
         return kInvalidInput;
     }
@@ -43,18 +43,29 @@ protected:
 
     bool conversionSupported(const SkImageInfo&, bool, bool) override;
 
+    Result onStartIncrementalDecode(const SkImageInfo& dstInfo, void* dst, size_t rowBytes,
+            const Options&) override;
+    Result onIncrementalDecode(int* rowsDecoded) override;
+
 private:
     /*
      * Creates an instance of the decoder
      * Called only by NewFromStream
      */
-    SkHeifCodec(SkEncodedInfo&&, HeifDecoder*, SkEncodedOrigin);
+    SkHeifCodec(SkEncodedInfo&&, HeifDecoder*, const HeifGridInfo&, SkEncodedOrigin);
 
     void initializeSwizzler(const SkImageInfo& dstInfo, const Options& options);
     void allocateStorage(const SkImageInfo& dstInfo);
     int readRows(const SkImageInfo& dstInfo, void* dst,
             size_t rowBytes, int count, const Options&);
 
+    /*
+     * Grid decoding.  Decodes the tiles that cover srcRect concurrently, writing srcRect to dst.
+     */
+    bool isGrid() const { return fGridInfo.mRows * fGridInfo.mCols > 1; }
+    bool decodeTiles(const SkImageInfo& dstInfo, void* dst, size_t dstRowBytes,
+            const SkIRect& srcRect, const Options&);
+
     /*
      * Scanline decoding.
      */
@@ -66,12 +77,18 @@ private:
 
     std::unique_ptr<HeifDecoder>       fHeifDecoder;
     HeifFrameInfo                      fFrameInfo;
+    const HeifGridInfo                 fGridInfo;
     SkAutoTMalloc<uint8_t>             fStorage;
     uint8_t*                           fSwizzleSrcRow;
     uint32_t*                          fColorXformSrcRow;
 
     std::unique_ptr<SkSwizzler>        fSwizzler;
 
+    // The incremental decode, which is only supported for grids.
+    void*                              fIncrementalDst;
+    size_t                             fIncrementalRowBytes;
+    SkIRect                            fIncrementalSrcRect;
+
     typedef SkCodec INHERITED;
 };
 
@@ -13,10 +13,14 @@
 #include "SkJpegDecoderMgr.h"
 #include "SkJpegInfo.h"
 #include "SkStream.h"
+#include "SkTDArray.h"
+#include "SkTaskGroup.h"
 #include "SkTemplates.h"
 #include "SkTo.h"
 #include "SkTypes.h"
 
+#include <atomic>
+
 // stdio is needed for libjpeg-turbo
 #include <stdio.h>
 #include "SkJpegUtility.h"
@@ -306,6 +310,9 @@ SkJpegCodec::SkJpegCodec(SkEncodedInfo&& info, std::unique_ptr<SkStream> stream,
     , fSwizzleSrcRow(nullptr)
     , fColorXformSrcRow(nullptr)
     , fSwizzlerSubset(SkIRect::MakeEmpty())
+    , fIncrementalDst(nullptr)
+    , fIncrementalRowBytes(0)
+    , fIncrementalScan(0)
 {}
 
 /*
@@ -500,44 +507,52 @@ int SkJpegCodec::readRows(const SkImageInfo& dstInfo, void* dst, size_t rowBytes
         return 0;
     }
 
-    // When fSwizzleSrcRow is non-null, it means that we need to swizzle.  In this case,
-    // we will always decode into fSwizzlerSrcRow before swizzling into the next buffer.
+    return this->readRows(fDecoderMgr->dinfo(), fSwizzler.get(), fSwizzleSrcRow,
+                          fColorXformSrcRow, dstInfo, dst, rowBytes, count, opts);
+}
+
+int SkJpegCodec::readRows(jpeg_decompress_struct* dinfo, SkSwizzler* swizzler,
+                          uint8_t* swizzleSrcRow, uint32_t* colorXformSrcRow,
+                          const SkImageInfo& dstInfo, void* dst, size_t rowBytes, int count,
+                          const Options& opts) const {
+    // When swizzleSrcRow is non-null, it means that we need to swizzle.  In this case,
+    // we will always decode into swizzleSrcRow before swizzling into the next buffer.
     // We can never swizzle "in place" because the swizzler may perform sampling and/or
     // subsetting.
-    // When fColorXformSrcRow is non-null, it means that we need to color xform and that
+    // When colorXformSrcRow is non-null, it means that we need to color xform and that
     // we cannot color xform "in place" (many times we can, but not when the src and dst
     // are different sizes).
-    // In this case, we will color xform from fColorXformSrcRow into the dst.
+    // In this case, we will color xform from colorXformSrcRow into the dst.
     JSAMPLE* decodeDst = (JSAMPLE*) dst;
     uint32_t* swizzleDst = (uint32_t*) dst;
     size_t decodeDstRowBytes = rowBytes;
     size_t swizzleDstRowBytes = rowBytes;
     int dstWidth = opts.fSubset ? opts.fSubset->width() : dstInfo.width();
-    if (fSwizzleSrcRow && fColorXformSrcRow) {
-        decodeDst = (JSAMPLE*) fSwizzleSrcRow;
-        swizzleDst = fColorXformSrcRow;
+    if (swizzleSrcRow && colorXformSrcRow) {
+        decodeDst = (JSAMPLE*) swizzleSrcRow;
+        swizzleDst = colorXformSrcRow;
         decodeDstRowBytes = 0;
         swizzleDstRowBytes = 0;
-        dstWidth = fSwizzler->swizzleWidth();
-    } else if (fColorXformSrcRow) {
-        decodeDst = (JSAMPLE*) fColorXformSrcRow;
-        swizzleDst = fColorXformSrcRow;
+        dstWidth = swizzler->swizzleWidth();
+    } else if (colorXformSrcRow) {
+        decodeDst = (JSAMPLE*) colorXformSrcRow;
+        swizzleDst = colorXformSrcRow;
         decodeDstRowBytes = 0;
         swizzleDstRowBytes = 0;
-    } else if (fSwizzleSrcRow) {
-        decodeDst = (JSAMPLE*) fSwizzleSrcRow;
+    } else if (swizzleSrcRow) {
+        decodeDst = (JSAMPLE*) swizzleSrcRow;
         decodeDstRowBytes = 0;
-        dstWidth = fSwizzler->swizzleWidth();
+        dstWidth = swizzler->swizzleWidth();
     }
 
     for (int y = 0; y < count; y++) {
-        uint32_t lines = jpeg_read_scanlines(fDecoderMgr->dinfo(), &decodeDst, 1);
+        uint32_t lines = jpeg_read_scanlines(dinfo, &decodeDst, 1);
         if (0 == lines) {
             return y;
         }
 
-        if (fSwizzler) {
-            fSwizzler->swizzle(swizzleDst, decodeDst);
+        if (swizzler) {
+            swizzler->swizzle(swizzleDst, decodeDst);
         }
 
         if (this->colorXform()) {
@@ -569,6 +584,264 @@ static inline bool needs_swizzler_to_convert_from_cmyk(J_COLOR_SPACE jpegColorTy
     return !hasCMYKColorSpace || !hasColorSpaceXform;
 }
 
+// Images with restart markers and at least this many pixels are decoded in strips, in parallel
+// on the default SkExecutor.
+#ifndef SK_JPEG_MIN_PIXELS_FOR_STRIPS
+    #define SK_JPEG_MIN_PIXELS_FOR_STRIPS (1 << 20)
+#endif
+
+// Each strip is at least this many pixels, so that the per strip setup stays cheap, and there are
+// at most this many strips.
+static constexpr int kMinPixelsPerStrip = 1 << 20;
+static constexpr int kMaxStrips = 16;
+
+namespace {
+
+// Where each restart interval of a sequential jpeg with a single scan starts, so that any run of
+// intervals can be decoded by itself.
+struct RestartIndex {
+    size_t              fHeightOffset;  // Of the image height in the SOF segment.
+    size_t              fScanStart;     // Of the entropy coded data, just after the SOS segment.
+    size_t              fScanEnd;       // Of the EOI marker.
+    SkTDArray<uint32_t> fMarkers;       // Of each RSTn marker, in order.
+};
+
+}  // namespace
+
+static size_t get_big_endian_short(const uint8_t* data) {
+    return (data[0] << 8) | data[1];
+}
+
+static bool index_restart_markers(const uint8_t* data, size_t size, RestartIndex* index) {
+    // Walk the segments up to the SOS.
+    size_t offset = 2;
+    index->fHeightOffset = 0;
+    for (;;) {
+        if (offset >= size || 0xFF != data[offset]) {
+            return false;
+        }
+        while (offset < size && 0xFF == data[offset]) {
+            offset++;
+        }
+        if (offset + 3 > size) {
+            return false;
+        }
+        uint8_t marker = data[offset];
+        size_t segmentSize = get_big_endian_short(data + offset + 1);
+        if (segmentSize < 2 || offset + 1 + segmentSize > size) {
+            return false;
+        }
+        if (0xC0 == marker || 0xC1 == marker) {
+            // Baseline or extended sequential, Huffman coded.
+            index->fHeightOffset = offset + 4;
+        } else if (marker >= 0xC2 && marker <= 0xCF && 0xC4 != marker && 0xC8 != marker &&
+                   0xCC != marker) {
+            // Progressive, lossless, hierarchical or arithmetic coded.
+            return false;
+        } else if (0xDA == marker) {
+            index->fScanStart = offset + 1 + segmentSize;
+            break;
+        }
+        offset += 1 + segmentSize;
+    }
+    if (!index->fHeightOffset) {
+        return false;
+    }
+
+    // Find the markers in the entropy coded data. Anything but RSTn and EOI means more scans.
+    index->fMarkers.rewind();
+    for (size_t i = index->fScanStart; i + 1 < size; i++) {
+        if (0xFF != data[i] || 0x00 == data[i + 1] || 0xFF == data[i + 1]) {
+            continue;
+        }
+        uint8_t marker = data[i + 1];
+        if (marker >= 0xD0 && marker <= 0xD7) {
+            if (marker - 0xD0 != index->fMarkers.count() % 8) {
+                return false;
+            }
+            index->fMarkers.push_back(SkToU32(i));
+            i++;
+        } else if (0xD9 == marker) {
+            index->fScanEnd = i;
+            return true;
+        } else {
+            return false;
+        }
+    }
+    return false;
+}
+
+// Assembles a jpeg of just the intervals [first, end): the headers, with the height patched,
+// then their entropy coded data, with the restart markers renumbered from zero, then an EOI.
+static sk_sp<SkData> make_strip(const SkData* data, const RestartIndex& index, int first, int end,
+                                int height) {
+    const uint8_t* src = data->bytes();
+    size_t srcBegin = first ? index.fMarkers[first - 1] + 2 : index.fScanStart,
+           srcEnd   = end <= index.fMarkers.count() ? index.fMarkers[end - 1] : index.fScanEnd;
+    sk_sp<SkData> strip = SkData::MakeUninitialized(index.fScanStart + (srcEnd - srcBegin) + 2);
+    uint8_t* dst = (uint8_t*) strip->writable_data();
+
+    memcpy(dst, src, index.fScanStart);
+    dst[index.fHeightOffset + 0] = height >> 8;
+    dst[index.fHeightOffset + 1] = height & 0xFF;
+    memcpy(dst + index.fScanStart, src + srcBegin, srcEnd - srcBegin);
+    for (int i = first; i + 1 < end; i++) {
+        dst[index.fScanStart + (index.fMarkers[i] - srcBegin) + 1] = 0xD0 + (i - first) % 8;
+    }
+    dst[strip->size() - 2] = 0xFF;
+    dst[strip->size() - 1] = 0xD9;
+    return strip;
+}
+
+static int gcd(int a, int b) {
+    while (b) {
+        int t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+bool SkJpegCodec::decodeStrips(const SkImageInfo& dstInfo, void* dst, size_t dstRowBytes,
+                               const Options& options) {
+    jpeg_decompress_struct* dinfo = fDecoderMgr->dinfo();
+    if (dinfo->progressive_mode || !dinfo->restart_interval ||
+        dinfo->comps_in_scan != dinfo->num_components ||
+        dstInfo.dimensions() != this->dimensions() ||
+        (int64_t) dstInfo.width() * dstInfo.height() < SK_JPEG_MIN_PIXELS_FOR_STRIPS) {
+        return false;
+    }
+
+    // Each strip gets its own decompressor, over its own copy of the headers and its intervals.
+    sk_sp<SkData> data;
+    if (this->stream()->getMemoryBase() && this->stream()->hasLength()) {
+        data = SkData::MakeWithoutCopy(this->stream()->getMemoryBase(),
+                                       this->stream()->getLength());
+    } else {
+        std::unique_ptr<SkStream> stream(this->stream()->duplicate());
+        if (!stream || !stream->hasLength()) {
+            return false;
+        }
+        data = SkData::MakeFromStream(stream.get(), stream->getLength());
+    }
+    RestartIndex index;
+    if (!data || !index_restart_markers(data->bytes(), data->size(), &index)) {
+        return false;
+    }
+
+    // A single component scan is made of single blocks, whatever the sampling factors.
+    const int mcuWidth  = dinfo->comps_in_scan > 1 ? dinfo->max_h_samp_factor * DCTSIZE : DCTSIZE,
+              mcuHeight = dinfo->comps_in_scan > 1 ? dinfo->max_v_samp_factor * DCTSIZE : DCTSIZE;
+    const int width = dinfo->image_width,
+              height = dinfo->image_height;
+    const int mcusPerRow = (width + mcuWidth - 1) / mcuWidth,
+              mcuRows = (height + mcuHeight - 1) / mcuHeight,
+              interval = dinfo->restart_interval;
+    const int intervals = SkToInt(((int64_t) mcusPerRow * mcuRows + interval - 1) / interval);
+    if (index.fMarkers.count() != intervals - 1) {
+        return false;
+    }
+    auto interval_at_row = [&](int row) {
+        return row == mcuRows ? intervals : SkToInt((int64_t) row * mcusPerRow / interval);
+    };
+
+    // Strips must start at a restart marker, which is at the start of every |rowStep| MCU rows.
+    // Fancy upsampling of vertically subsampled chroma reads the rows around it, so then each
+    // strip also decodes |rowStep| MCU rows on either side of the ones it keeps. Keeping at least
+    // four times that many rows bounds the extra work.
+    const int rowStep = interval / gcd(interval, mcusPerRow);
+    int context = 0;
+    for (int i = 0; i < dinfo->num_components; i++) {
+        if (dinfo->do_fancy_upsampling &&
+            dinfo->comp_info[i].v_samp_factor != dinfo->max_v_samp_factor) {
+            context = rowStep;
+        }
+    }
+    int strips = SkToInt(SkTMin<int64_t>(mcuRows / SkTMax(rowStep, 4 * context),
+                                         (int64_t) width * height / kMinPixelsPerStrip));
+    strips = SkTMin(strips, kMaxStrips);
+    if (strips < 2) {
+        return false;
+    }
+    int rowsPerStrip = (mcuRows + strips - 1) / strips;
+    rowsPerStrip = (rowsPerStrip + rowStep - 1) / rowStep * rowStep;
+    strips = (mcuRows + rowsPerStrip - 1) / rowsPerStrip;
+
+    const bool needsCMYKToRGB = needs_swizzler_to_convert_from_cmyk(
+            dinfo->out_color_space, this->getEncodedInfo().profile(), this->colorXform());
+    std::atomic<bool> failed{false};
+    SkTaskGroup().batch(strips, [&](int strip) {
+        if (failed.load(std::memory_order_relaxed)) {
+            return;
+        }
+        int keepStart = strip * rowsPerStrip,
+            keepEnd   = SkTMin(keepStart + rowsPerStrip, mcuRows),
+            start     = SkTMax(keepStart - context, 0),
+            end       = SkTMin(keepEnd + context, mcuRows);
+        int top    = keepStart * mcuHeight,
+            bottom = SkTMin(keepEnd * mcuHeight, height);
+        sk_sp<SkData> stripData = make_strip(data.get(), index, interval_at_row(start),
+                                             interval_at_row(end),
+                                             SkTMin(end * mcuHeight, height) - start * mcuHeight);
+        if (!this->decodeStrip(std::move(stripData), needsCMYKToRGB, top - start * mcuHeight,
+                               SkTAddOffset<void>(dst, top * dstRowBytes), bottom - top,
+                               dstInfo, dstRowBytes, options)) {
+            failed.store(true, std::memory_order_relaxed);
+        }
+    });
+    return !failed.load();
+}
+
+bool SkJpegCodec::decodeStrip(sk_sp<SkData> stripData, bool needsCMYKToRGB, int skipRows,
+                              void* dst, int rows, const SkImageInfo& dstInfo, size_t dstRowBytes,
+                              const Options& options) const {
+    SkMemoryStream stream(std::move(stripData));
+    JpegDecoderMgr decoderMgr(&stream);
+    skjpeg_error_mgr::AutoPushJmpBuf jmp(decoderMgr.errorMgr());
+    if (setjmp(jmp)) {
+        return decoderMgr.returnFalse("decodeStrip");
+    }
+
+    decoderMgr.init();
+    jpeg_decompress_struct* dinfo = decoderMgr.dinfo();
+    if (JPEG_HEADER_OK != jpeg_read_header(dinfo, true)) {
+        return false;
+    }
+    const jpeg_decompress_struct* fullInfo = fDecoderMgr->dinfo();
+    dinfo->out_color_space = fullInfo->out_color_space;
+    dinfo->dither_mode = fullInfo->dither_mode;
+    dinfo->dct_method = fullInfo->dct_method;
+    dinfo->do_fancy_upsampling = fullInfo->do_fancy_upsampling;
+    if (!jpeg_start_decompress(dinfo)) {
+        return false;
+    }
+
+    std::unique_ptr<SkSwizzler> swizzler;
+    if (needsCMYKToRGB) {
+        swizzler = this->makeSwizzler(dinfo->out_color_space, dstInfo, options, true);
+    }
+    size_t swizzleBytes = swizzler ? get_row_bytes(dinfo) : 0;
+    size_t xformBytes = 0;
+    if (this->colorXform() && sizeof(uint32_t) != dstInfo.bytesPerPixel()) {
+        xformBytes = dstInfo.width() * sizeof(uint32_t);
+    }
+    SkAutoTMalloc<uint8_t> storage(SkTMax(swizzleBytes + xformBytes, get_row_bytes(dinfo)));
+
+    // Throw away the rows which were only decoded to upsample the ones we keep.
+    for (int y = 0; y < skipRows; y++) {
+        JSAMPLE* row = storage.get();
+        if (1 != jpeg_read_scanlines(dinfo, &row, 1)) {
+            return false;
+        }
+    }
+
+    uint8_t* swizzleSrcRow = swizzleBytes ? storage.get() : nullptr;
+    uint32_t* colorXformSrcRow = xformBytes ? SkTAddOffset<uint32_t>(storage.get(), swizzleBytes)
+                                            : nullptr;
+    return rows == this->readRows(dinfo, swizzler.get(), swizzleSrcRow, colorXformSrcRow,
+                                  dstInfo, dst, dstRowBytes, rows, options);
+}
+
 /*
  * Performs the jpeg decode
  */
@@ -590,6 +863,10 @@ SkCodec::Result SkJpegCodec::onGetPixels(const SkImageInfo& dstInfo,
         return fDecoderMgr->returnFailure("setjmp", kInvalidInput);
     }
 
+    if (this->decodeStrips(dstInfo, dst, dstRowBytes, options)) {
+        return kSuccess;
+    }
+
     if (!jpeg_start_decompress(dinfo)) {
         return fDecoderMgr->returnFailure("startDecompress", kInvalidInput);
     }
@@ -641,6 +918,15 @@ void SkJpegCodec::allocateStorage(const SkImageInfo& dstInfo) {
 
 void SkJpegCodec::initializeSwizzler(const SkImageInfo& dstInfo, const Options& options,
         bool needsCMYKToRGB) {
+    fSwizzler = this->makeSwizzler(fDecoderMgr->dinfo()->out_color_space, dstInfo, options,
+                                   needsCMYKToRGB);
+    SkASSERT(fSwizzler);
+}
+
+std::unique_ptr<SkSwizzler> SkJpegCodec::makeSwizzler(int outColorSpace,
+                                                      const SkImageInfo& dstInfo,
+                                                      const Options& options,
+                                                      bool needsCMYKToRGB) const {
     Options swizzlerOptions = options;
     if (options.fSubset) {
         // Use fSwizzlerSubset if this is a subset decode.  This is necessary in the case
@@ -662,28 +948,27 @@ void SkJpegCodec::initializeSwizzler(const SkImageInfo& dstInfo, const Options&
         // The swizzler does not use the width or height on SkEncodedInfo.
         auto swizzlerInfo = SkEncodedInfo::Make(0, 0, SkEncodedInfo::kInvertedCMYK_Color,
                                                 SkEncodedInfo::kOpaque_Alpha, 8);
-        fSwizzler = SkSwizzler::Make(swizzlerInfo, nullptr, swizzlerDstInfo, swizzlerOptions);
-    } else {
-        int srcBPP = 0;
-        switch (fDecoderMgr->dinfo()->out_color_space) {
-            case JCS_EXT_RGBA:
-            case JCS_EXT_BGRA:
-            case JCS_CMYK:
-                srcBPP = 4;
-                break;
-            case JCS_RGB565:
-                srcBPP = 2;
-                break;
-            case JCS_GRAYSCALE:
-                srcBPP = 1;
-                break;
-            default:
-                SkASSERT(false);
-                break;
-        }
-        fSwizzler = SkSwizzler::MakeSimple(srcBPP, swizzlerDstInfo, swizzlerOptions);
+        return SkSwizzler::Make(swizzlerInfo, nullptr, swizzlerDstInfo, swizzlerOptions);
     }
-    SkASSERT(fSwizzler);
+
+    int srcBPP = 0;
+    switch ((J_COLOR_SPACE) outColorSpace) {
+        case JCS_EXT_RGBA:
+        case JCS_EXT_BGRA:
+        case JCS_CMYK:
+            srcBPP = 4;
+            break;
+        case JCS_RGB565:
+            srcBPP = 2;
+            break;
+        case JCS_GRAYSCALE:
+            srcBPP = 1;
+            break;
+        default:
+            SkASSERT(false);
+            break;
+    }
+    return SkSwizzler::MakeSimple(srcBPP, swizzlerDstInfo, swizzlerOptions);
 }
 
 SkSampler* SkJpegCodec::getSampler(bool createIfNecessary) {
@@ -764,6 +1049,108 @@ SkCodec::Result SkJpegCodec::onStartScanlineDecode(const SkImageInfo& dstInfo,
     return kSuccess;
 }
 
+SkCodec::Result SkJpegCodec::onStartIncrementalDecode(const SkImageInfo& dstInfo, void* dst,
+        size_t rowBytes, const Options& options) {
+    // Sequential jpegs, and subsets, are decoded a scanline at a time instead.
+    jpeg_decompress_struct* dinfo = fDecoderMgr->dinfo();
+    if (options.fSubset || !jpeg_has_multiple_scans(dinfo)) {
+        return kUnimplemented;
+    }
+
+    // Set the jump location for libjpeg errors
+    skjpeg_error_mgr::AutoPushJmpBuf jmp(fDecoderMgr->errorMgr());
+    if (setjmp(jmp)) {
+        return fDecoderMgr->returnFailure("startIncrementalDecode", kInvalidInput);
+    }
+
+    // In buffered image mode, libjpeg reads the scans into its coefficient buffer as they
+    // arrive, and we output the image from them as many times as we like.
+    fDecoderMgr->setSuspending();
+    dinfo->buffered_image = TRUE;
+    if (!jpeg_start_decompress(dinfo)) {
+        return fDecoderMgr->returnFailure("startDecompress", kInvalidInput);
+    }
+
+    if (needs_swizzler_to_convert_from_cmyk(dinfo->out_color_space,
+                                            this->getEncodedInfo().profile(), this->colorXform())) {
+        this->initializeSwizzler(dstInfo, options, true);
+    }
+    this->allocateStorage(dstInfo);
+
+    fIncrementalDst = dst;
+    fIncrementalRowBytes = rowBytes;
+    fIncrementalScan = 0;
+    return kSuccess;
+}
+
+SkCodec::Result SkJpegCodec::onIncrementalDecode(int* rowsDecoded) {
+    jpeg_decompress_struct* dinfo = fDecoderMgr->dinfo();
+    const SkImageInfo& dstInfo = this->dstInfo();
+
+    // libjpeg-turbo scales natively, so the swizzler only samples rows for SkSampledCodec.
+    const int sampleY = fSwizzler ? fSwizzler->sampleY() : 1;
+    const int dstHeight = get_scaled_dimension(dstInfo.height(), sampleY);
+
+    // Once a scan has been output, every row has been written.
+    int rowsDecodedStorage;
+    if (!rowsDecoded) {
+        rowsDecoded = &rowsDecodedStorage;
+    }
+    *rowsDecoded = fIncrementalScan > 0 ? dstHeight : 0;
+
+    // Set the jump location for libjpeg errors
+    skjpeg_error_mgr::AutoPushJmpBuf jmp(fDecoderMgr->errorMgr());
+    if (setjmp(jmp)) {
+        return fDecoderMgr->returnFailure("incrementalDecode", kErrorInInput);
+    }
+
+    // Read all of the data that has arrived.
+    for (;;) {
+        int status = jpeg_consume_input(dinfo);
+        if (JPEG_REACHED_EOI == status ||
+                (JPEG_SUSPENDED == status && !fDecoderMgr->readMore())) {
+            break;
+        }
+    }
+
+    // Output the scans that have all arrived: those before the one being read, or all of them.
+    const bool complete = jpeg_input_complete(dinfo);
+    const int scan = complete ? dinfo->input_scan_number : dinfo->input_scan_number - 1;
+    if (scan <= fIncrementalScan && !complete) {
+        return kIncompleteInput;
+    }
+
+    if (!jpeg_start_output(dinfo, scan)) {
+        return fDecoderMgr->returnFailure("startOutput", kErrorInInput);
+    }
+
+    int rows = 0;
+    if (1 == sampleY) {
+        rows = this->readRows(dstInfo, fIncrementalDst, fIncrementalRowBytes, dstInfo.height(),
+                              this->options());
+    } else {
+        SkAutoTMalloc<uint8_t> skippedRow(fIncrementalRowBytes);
+        for (int srcY = 0; srcY < (int) dinfo->output_height; srcY++) {
+            void* dst = skippedRow.get();
+            if (is_coord_necessary(srcY, sampleY, dstHeight)) {
+                dst = SkTAddOffset<void>(fIncrementalDst,
+                                         get_dst_coord(srcY, sampleY) * fIncrementalRowBytes);
+                rows++;
+            }
+            if (1 != this->readRows(dstInfo, dst, fIncrementalRowBytes, 1, this->options())) {
+                return fDecoderMgr->returnFailure("readRows", kErrorInInput);
+            }
+        }
+    }
+    if (rows < dstHeight || !jpeg_finish_output(dinfo)) {
+        return fDecoderMgr->returnFailure("finishOutput", kErrorInInput);
+    }
+
+    fIncrementalScan = scan;
+    *rowsDecoded = dstHeight;
+    return complete ? kSuccess : kIncompleteInput;
+}
+
 int SkJpegCodec::onGetScanlines(void* dst, int count, size_t dstRowBytes) {
     int rows = this->readRows(this->dstInfo(), dst, dstRowBytes, count, this->options());
     if (rows < count) {
@@ -15,6 +15,7 @@
 #include "SkTemplates.h"
 
 class JpegDecoderMgr;
+struct jpeg_decompress_struct;
 
 /*
  *
@@ -59,6 +60,14 @@ protected:
 
     bool conversionSupported(const SkImageInfo&, bool, bool) override;
 
+    /*
+     * Progressive jpegs are decoded incrementally, outputting the scans that have arrived each
+     * time, so each incrementalDecode() improves on the image from the last one.
+     */
+    Result onStartIncrementalDecode(const SkImageInfo& dstInfo, void* dst, size_t rowBytes,
+            const Options&) override;
+    Result onIncrementalDecode(int* rowsDecoded) override;
+
 private:
     /*
      * Allows SkRawCodec to communicate the color profile from the exif data.
@@ -106,8 +115,29 @@ private:
 
     void initializeSwizzler(const SkImageInfo& dstInfo, const Options& options,
                             bool needsCMYKToRGB);
+    std::unique_ptr<SkSwizzler> makeSwizzler(int outColorSpace, const SkImageInfo& dstInfo,
+                                             const Options& options, bool needsCMYKToRGB) const;
     void allocateStorage(const SkImageInfo& dstInfo);
     int readRows(const SkImageInfo& dstInfo, void* dst, size_t rowBytes, int count, const Options&);
+    int readRows(jpeg_decompress_struct* dinfo, SkSwizzler* swizzler, uint8_t* swizzleSrcRow,
+                 uint32_t* colorXformSrcRow, const SkImageInfo& dstInfo, void* dst,
+                 size_t rowBytes, int count, const Options&) const;
+
+    /*
+     * If the image has restart markers and is big enough, decodes it in strips of rows which
+     * start at restart markers, in parallel, each with its own decompressor.
+     * Returns false if the image was not decoded this way, so the caller should decode it
+     * normally.
+     */
+    bool decodeStrips(const SkImageInfo& dstInfo, void* dst, size_t dstRowBytes, const Options&);
+
+    /*
+     * Decodes the jpeg in stripData, which is part of this image, skipping its first skipRows
+     * rows and writing the next rows rows to dst.
+     */
+    bool decodeStrip(sk_sp<SkData> stripData, bool needsCMYKToRGB, int skipRows, void* dst,
+                     int rows, const SkImageInfo& dstInfo, size_t dstRowBytes,
+                     const Options&) const;
 
     /*
      * Scanline decoding.
@@ -136,6 +166,11 @@ private:
 
     std::unique_ptr<SkSwizzler>        fSwizzler;
 
+    // The incremental decode, and the last scan that it output (or 0).
+    void*                              fIncrementalDst;
+    size_t                             fIncrementalRowBytes;
+    int                                fIncrementalScan;
+
     friend class SkRawCodec;
 
     typedef SkCodec INHERITED;
@@ -63,6 +63,13 @@ public:
      */
     jpeg_decompress_struct* dinfo() { return &fDInfo; }
 
+    /*
+     * Have libjpeg suspend when the stream has no more data for now, and check whether the
+     * stream had more data the last time that it did.
+     */
+    void setSuspending() { fSrcMgr.setSuspending(); }
+    bool readMore() const { return fSrcMgr.fReadMore; }
+
 private:
 
     jpeg_decompress_struct fDInfo;
@@ -88,6 +88,57 @@ static void sk_term_source(j_decompress_ptr dinfo)
     // need to modify SkJpegCodec to call jpeg_finish_decompress().
 }
 
+// Functions for suspending sources //
+
+/*
+ * Read more of the stream, keeping the data from next_input_byte on, and suspend
+ */
+static boolean sk_fill_suspending_input_buffer(j_decompress_ptr dinfo) {
+    skjpeg_source_mgr* src = (skjpeg_source_mgr*) dinfo->src;
+    SkTDArray<uint8_t>& buffer = src->fSuspendingBuffer;
+
+    // libjpeg backs up to next_input_byte when it resumes, so keep the bytes from there on.
+    size_t kept = src->bytes_in_buffer;
+    if (kept > 0) {
+        memmove(buffer.begin(), src->next_input_byte, kept);
+    }
+
+    size_t bytes = 0;
+    if (src->fBytesToSkip > 0) {
+        bytes = src->fStream->skip(src->fBytesToSkip);
+        src->fBytesToSkip -= bytes;
+    } else {
+        buffer.setCount(SkToInt(kept + skjpeg_source_mgr::kSuspendingReadSize));
+        bytes = src->fStream->read(buffer.begin() + kept, skjpeg_source_mgr::kSuspendingReadSize);
+        kept += bytes;
+    }
+    buffer.setCount(SkToInt(kept));
+    src->next_input_byte = (const JOCTET*) buffer.begin();
+    src->bytes_in_buffer = kept;
+    src->fReadMore = bytes > 0;
+
+    // Suspend even if there is more data.  libjpeg rescans from where it backed up to when it
+    // resumes, so returning true would have it skip the data that we kept.
+    return false;
+}
+
+/*
+ * Skip a certain number of bytes, some of which may not have arrived yet
+ */
+static void sk_skip_suspending_input_data(j_decompress_ptr dinfo, long numBytes) {
+    skjpeg_source_mgr* src = (skjpeg_source_mgr*) dinfo->src;
+    size_t bytes = (size_t) numBytes;
+
+    if (bytes > src->bytes_in_buffer) {
+        src->fBytesToSkip += bytes - src->bytes_in_buffer;
+        src->next_input_byte += src->bytes_in_buffer;
+        src->bytes_in_buffer = 0;
+    } else {
+        src->next_input_byte += numBytes;
+        src->bytes_in_buffer -= numBytes;
+    }
+}
+
 // Functions for memory backed sources //
 
 /*
@@ -140,3 +191,18 @@ skjpeg_source_mgr::skjpeg_source_mgr(SkStream* stream)
         term_source = sk_term_source;
     }
 }
+
+void skjpeg_source_mgr::setSuspending() {
+    // A memory backed source already has all of the data, and suspends at the end of it.
+    if (fill_input_buffer == sk_fill_mem_input_buffer) {
+        return;
+    }
+
+    fSuspendingBuffer.setCount(SkToInt(bytes_in_buffer));
+    if (bytes_in_buffer > 0) {
+        memcpy(fSuspendingBuffer.begin(), next_input_byte, bytes_in_buffer);
+    }
+    next_input_byte = (const JOCTET*) fSuspendingBuffer.begin();
+    fill_input_buffer = sk_fill_suspending_input_buffer;
+    skip_input_data = sk_skip_suspending_input_data;
+}
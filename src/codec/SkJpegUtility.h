@@ -11,6 +11,7 @@
 
 #include "SkJpegPriv.h"
 #include "SkStream.h"
+#include "SkTDArray.h"
 
 #include <setjmp.h>
 // stdio is needed for jpeglib
@@ -32,13 +33,28 @@ void skjpeg_err_exit(j_common_ptr cinfo);
 struct skjpeg_source_mgr : jpeg_source_mgr {
     skjpeg_source_mgr(SkStream* stream);
 
+    /*
+     * From now on, have libjpeg suspend when the stream has no more data for now, so that it can
+     * pick up where it left off once more has arrived.
+     */
+    void setSuspending();
+
     SkStream* fStream; // unowned
     enum {
         // TODO (msarett): Experiment with different buffer sizes.
         // This size was chosen because it matches SkImageDecoder.
-        kBufferSize = 1024
+        kBufferSize = 1024,
+
+        // How much to read at a time when suspending, as libjpeg backs up after each read.
+        kSuspendingReadSize = 16 * 1024,
     };
     uint8_t fBuffer[kBufferSize];
+
+    // When suspending, this holds the data that libjpeg has not finished with.
+    SkTDArray<uint8_t> fSuspendingBuffer;
+    size_t             fBytesToSkip = 0;
+    // Whether the last read of the stream got any data.
+    bool               fReadMore = false;
 };
 
 #endif
@@ -520,6 +520,30 @@ public:
         return fIsXtransImage;
     }
 
+    /*
+     * The size of the JPEG thumbnail that piex found, or empty if there isn't one with the same
+     * aspect ratio as the image. Decoding it is much faster than rendering the raw image.
+     */
+    SkISize thumbnailSize() const {
+        return fThumbnailSize;
+    }
+
+    bool thumbnailIsAdobeRgb() const {
+        return fThumbnailIsAdobeRgb;
+    }
+
+    // Returns the thumbnail's JPEG data. Does not affect the rendering of the raw image.
+    std::unique_ptr<SkStream> readThumbnail() {
+        if (fThumbnailSize.isEmpty()) {
+            return nullptr;
+        }
+        sk_sp<SkData> data = SkData::MakeUninitialized(fThumbnailLength);
+        if (!fStream->read(data->writable_data(), fThumbnailOffset, fThumbnailLength)) {
+            return nullptr;
+        }
+        return SkMemoryStream::Make(std::move(data));
+    }
+
     // Quick check if the image contains a valid TIFF header as requested by DNG format.
     // Does not affect ownership of stream.
     static bool IsTiffHeaderValid(SkRawStream* stream) {
@@ -559,8 +583,26 @@ private:
             && ::piex::GetPreviewImageData(&piexStream, &imageData) == ::piex::Error::kOk)
         {
             dng_point cfaPatternSize(imageData.cfa_pattern_dim[1], imageData.cfa_pattern_dim[0]);
-            return this->init(static_cast<int>(imageData.full_width),
-                              static_cast<int>(imageData.full_height), cfaPatternSize);
+            if (!this->init(static_cast<int>(imageData.full_width),
+                            static_cast<int>(imageData.full_height), cfaPatternSize)) {
+                return false;
+            }
+
+            // Many thumbnails are letterboxed to 4:3, which isn't a scaled version of the image,
+            // so only keep those with the image's aspect ratio (give or take a pixel).
+            const ::piex::Image& thumbnail = imageData.thumbnail;
+            const int64_t tw = thumbnail.width,
+                          th = thumbnail.height;
+            if (thumbnail.format == ::piex::Image::kJpegCompressed && thumbnail.length > 0 &&
+                tw > 0 && th > 0 && tw < fWidth && th < fHeight &&
+                SkTAbs(tw * fHeight - th * fWidth) <= SkTMax(fWidth, fHeight)) {
+                fThumbnailSize = SkISize::Make(thumbnail.width, thumbnail.height);
+                fThumbnailOffset = thumbnail.offset;
+                fThumbnailLength = thumbnail.length;
+                fThumbnailIsAdobeRgb =
+                        imageData.color_space == ::piex::PreviewImageData::kAdobeRgb;
+            }
+            return true;
         }
         return false;
     }
@@ -611,6 +653,11 @@ private:
     int fHeight;
     bool fIsScalable;
     bool fIsXtransImage;
+
+    SkISize fThumbnailSize = SkISize::MakeEmpty();
+    uint32_t fThumbnailOffset = 0;
+    uint32_t fThumbnailLength = 0;
+    bool fThumbnailIsAdobeRgb = false;
 };
 
 static constexpr skcms_Matrix3x3 gAdobe_RGB_to_XYZD50 = {{
@@ -623,6 +670,24 @@ static constexpr skcms_Matrix3x3 gAdobe_RGB_to_XYZD50 = {{
     { SkFixedToFloat(0x04fc), SkFixedToFloat(0x0f95), SkFixedToFloat(0xbe9c) }, // Rz, Gz, Bz
 }};
 
+/*
+ * Makes a codec for one of the JPEG images that PIEX finds embedded in a RAW image.
+ */
+static std::unique_ptr<SkCodec> make_embedded_jpeg_codec(std::unique_ptr<SkStream> stream,
+                                                         bool isAdobeRgb,
+                                                         SkCodec::Result* result) {
+    std::unique_ptr<SkEncodedInfo::ICCProfile> profile;
+    if (isAdobeRgb) {
+        constexpr skcms_TransferFunction twoDotTwo =
+                { 2.2f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f };
+        skcms_ICCProfile skcmsProfile;
+        skcms_Init(&skcmsProfile);
+        skcms_SetTransferFunction(&skcmsProfile, &twoDotTwo);
+        skcms_SetXYZD50(&skcmsProfile, &gAdobe_RGB_to_XYZD50);
+        profile = SkEncodedInfo::ICCProfile::Make(skcmsProfile);
+    }
+    return SkJpegCodec::MakeFromStream(std::move(stream), result, std::move(profile));
+}
 
 /*
  * Tries to handle the image with PIEX. If PIEX returns kOk and finds the preview image, create a
@@ -648,17 +713,6 @@ std::unique_ptr<SkCodec> SkRawCodec::MakeFromStream(std::unique_ptr<SkStream> st
             return nullptr;
         }
 
-        std::unique_ptr<SkEncodedInfo::ICCProfile> profile;
-        if (imageData.color_space == ::piex::PreviewImageData::kAdobeRgb) {
-            constexpr skcms_TransferFunction twoDotTwo =
-                    { 2.2f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f };
-            skcms_ICCProfile skcmsProfile;
-            skcms_Init(&skcmsProfile);
-            skcms_SetTransferFunction(&skcmsProfile, &twoDotTwo);
-            skcms_SetXYZD50(&skcmsProfile, &gAdobe_RGB_to_XYZD50);
-            profile = SkEncodedInfo::ICCProfile::Make(skcmsProfile);
-        }
-
         //  Theoretically PIEX can return JPEG compressed image or uncompressed RGB image. We only
         //  handle the JPEG compressed preview image here.
         if (error == ::piex::Error::kOk && imageData.preview.length > 0 &&
@@ -673,8 +727,8 @@ std::unique_ptr<SkCodec> SkRawCodec::MakeFromStream(std::unique_ptr<SkStream> st
                 *result = kInvalidInput;
                 return nullptr;
             }
-            return SkJpegCodec::MakeFromStream(std::move(memoryStream), result,
-                                               std::move(profile));
+            return make_embedded_jpeg_codec(std::move(memoryStream),
+                    imageData.color_space == ::piex::PreviewImageData::kAdobeRgb, result);
         }
     }
 
@@ -697,6 +751,28 @@ std::unique_ptr<SkCodec> SkRawCodec::MakeFromStream(std::unique_ptr<SkStream> st
 SkCodec::Result SkRawCodec::onGetPixels(const SkImageInfo& dstInfo, void* dst,
                                         size_t dstRowBytes, const Options& options,
                                         int* rowsDecoded) {
+    if (dstInfo.dimensions() == fDngImage->thumbnailSize()) {
+        // The embedded thumbnail is exactly the requested size, so decode it instead of
+        // rendering the raw image.
+        Result result;
+        std::unique_ptr<SkCodec> thumbnailCodec;
+        if (auto stream = fDngImage->readThumbnail()) {
+            thumbnailCodec = make_embedded_jpeg_codec(std::move(stream),
+                                                      fDngImage->thumbnailIsAdobeRgb(), &result);
+        }
+        if (thumbnailCodec && thumbnailCodec->dimensions() == dstInfo.dimensions()) {
+            Options thumbnailOptions;
+            thumbnailOptions.fZeroInitialized = options.fZeroInitialized;
+            result = thumbnailCodec->getPixels(dstInfo, dst, dstRowBytes, &thumbnailOptions);
+            if (result == kSuccess || result == kIncompleteInput) {
+                // The thumbnail codec has already filled in any rows it couldn't decode.
+                *rowsDecoded = dstInfo.height();
+                return result;
+            }
+        }
+        // Fall back to rendering the raw image, which can make any size that the thumbnail can.
+    }
+
     SkImageInfo swizzlerInfo = dstInfo;
     std::unique_ptr<uint32_t[]> xformBuffer = nullptr;
     if (this->colorXform()) {
@@ -765,6 +841,13 @@ SkISize SkRawCodec::onGetScaledDimensions(float desiredScale) const {
     const SkISize dim = this->dimensions();
     SkASSERT(dim.fWidth != 0 && dim.fHeight != 0);
 
+    // The thumbnail is much faster to decode, so it's preferred whenever it's big enough.
+    const SkISize thumbnailSize = fDngImage->thumbnailSize();
+    if (!thumbnailSize.isEmpty() && dim.fWidth  * desiredScale <= thumbnailSize.fWidth
+                                 && dim.fHeight * desiredScale <= thumbnailSize.fHeight) {
+        return thumbnailSize;
+    }
+
     if (!fDngImage->isScalable()) {
         return dim;
     }
@@ -788,6 +871,9 @@ SkISize SkRawCodec::onGetScaledDimensions(float desiredScale) const {
 }
 
 bool SkRawCodec::onDimensionsSupported(const SkISize& dim) {
+    if (dim == fDngImage->thumbnailSize()) {
+        return true;
+    }
     const SkISize fullDim = this->dimensions();
     const float fullShortEdge = static_cast<float>(SkTMin(fullDim.fWidth, fullDim.fHeight));
     const float shortEdge = static_cast<float>(SkTMin(dim.fWidth, dim.fHeight));
@@ -86,6 +86,12 @@ public:
      */
     sk_sp<SkData> getDataAtPosition(size_t position, size_t length);
 
+    /**
+     *  Return a new stream over the same data, from its start, or nullptr if the stream cannot
+     *  be duplicated.
+     */
+    std::unique_ptr<SkStream> duplicateStream() const { return fStream->duplicate(); }
+
 private:
     static constexpr size_t kMaxSize = 256 * 3;
 
@@ -41,6 +41,15 @@ struct HeifFrameInfo {
     std::unique_ptr<char[]> mIccData;
 };
 
+// HEIC images are usually coded as a grid of tiles which can be decoded independently. Tiles in
+// the last row and column are cropped to the image.
+struct HeifGridInfo {
+    int mRows;
+    int mCols;
+    int mTileWidth;
+    int mTileHeight;
+};
+
 struct HeifDecoder {
     bool init(HeifStream* stream, HeifFrameInfo*) {
         delete stream;
@@ -62,6 +71,17 @@ struct HeifDecoder {
     int skipScanlines(int) {
         return 0;
     }
+
+    // Fails if the image is not a grid.
+    bool getGridInfo(HeifGridInfo*) {
+        return false;
+    }
+
+    // Decodes the tile at (row, col) in the current output color, independently of decode() and
+    // getScanline().  This may be called from several threads at once.
+    bool decodeTile(int /*row*/, int /*col*/, uint8_t* /*dst*/, size_t /*rowBytes*/) {
+        return false;
+    }
 };
 
 static inline HeifDecoder* createHeifDecoder() { return new HeifDecoder; }
@@ -39,19 +39,42 @@ bool SkWebpCodec::IsWebp(const void* buf, size_t bytesRead) {
     return bytesRead >= 14 && !memcmp(bytes, "RIFF", 4) && !memcmp(&bytes[8], "WEBPVP", 6);
 }
 
+// Appends the data that has arrived so far, stopping when a read returns nothing (even if the
+// stream is not at its end).  Returns the number of bytes appended.
+static size_t copy_available_data(SkStream* stream, SkWStream* dst) {
+    char buffer[4096];
+    size_t total = 0;
+    while (size_t bytes = stream->read(buffer, sizeof(buffer))) {
+        dst->write(buffer, bytes);
+        total += bytes;
+    }
+    return total;
+}
+
 // Parse headers of RIFF container, and check for valid Webp (VP8) content.
 // Returns an SkWebpCodec on success
 std::unique_ptr<SkCodec> SkWebpCodec::MakeFromStream(std::unique_ptr<SkStream> stream,
                                                      Result* result) {
     // Webp demux needs a contiguous data buffer.
     sk_sp<SkData> data = nullptr;
+    std::unique_ptr<SkStream> unreadStream;
     if (stream->getMemoryBase()) {
         // It is safe to make without copy because we'll hold onto the stream.
         data = SkData::MakeWithoutCopy(stream->getMemoryBase(), stream->getLength());
     } else {
-        data = SkCopyStreamToData(stream.get());
+        if (stream->hasLength()) {
+            data = SkCopyStreamToData(stream.get());
+        } else {
+            SkDynamicMemoryWStream copy;
+            copy_available_data(stream.get(), &copy);
+            data = copy.detachAsData();
+        }
 
-        // If we are forced to copy the stream to a data, we can go ahead and delete the stream.
+        // If we are forced to copy the stream to a data, we can go ahead and delete the stream,
+        // unless the rest of it has yet to arrive.
+        if (!stream->isAtEnd()) {
+            unreadStream = std::move(stream);
+        }
         stream.reset(nullptr);
     }
 
@@ -173,7 +196,8 @@ std::unique_ptr<SkCodec> SkWebpCodec::MakeFromStream(std::unique_ptr<SkStream> s
     *result = kSuccess;
     SkEncodedInfo info = SkEncodedInfo::Make(width, height, color, alpha, 8, std::move(profile));
     return std::unique_ptr<SkCodec>(new SkWebpCodec(std::move(info), std::move(stream),
-                                                    demux.release(), std::move(data), origin));
+                                                    demux.release(), std::move(data),
+                                                    std::move(unreadStream), origin));
 }
 
 SkISize SkWebpCodec::onGetScaledDimensions(float desiredScale) const {
@@ -568,14 +592,149 @@ SkCodec::Result SkWebpCodec::onGetPixels(const SkImageInfo& dstInfo, void* dst,
     return result;
 }
 
+struct SkWebpCodec::IncrementalDecode {
+    ~IncrementalDecode() {
+        // The decoder refers to the config's output buffer.
+        fDecoder.reset(nullptr);
+        WebPFreeDecBuffer(&fConfig.output);
+    }
+
+    WebPDecoderConfig                           fConfig;
+    SkAutoTCallVProc<WebPIDecoder, WebPIDelete> fDecoder{nullptr};
+    // The rows that libwebp has finished, and that have been color transformed if necessary.
+    int                                         fRowsDecoded = 0;
+};
+
+SkCodec::Result SkWebpCodec::onStartIncrementalDecode(const SkImageInfo& dstInfo, void* dst,
+                                                      size_t rowBytes, const Options& options) {
+    // Animations, subsets, scaling, and color transforms that need a copy of the image are only
+    // supported by getPixels().
+    auto flags = WebPDemuxGetI(fDemux.get(), WEBP_FF_FORMAT_FLAGS);
+    if ((flags & ANIMATION_FLAG) || options.fSubset || dstInfo.dimensions() != this->dimensions()
+            || (this->colorXform() && !is_8888(dstInfo.colorType()))) {
+        return kUnimplemented;
+    }
+
+    std::unique_ptr<IncrementalDecode> decode(new IncrementalDecode);
+    WebPDecoderConfig& config = decode->fConfig;
+    if (0 == WebPInitDecoderConfig(&config)) {
+        // ABI mismatch.
+        return kInvalidInput;
+    }
+
+    // As in onGetPixels(), the color transform is done in place, from BGRA.
+    const bool hasAlpha = !this->getEncodedInfo().opaque();
+    SkImageInfo webpInfo = dstInfo;
+    if (!hasAlpha) {
+        webpInfo = webpInfo.makeAlphaType(kOpaque_SkAlphaType);
+    }
+    if (this->colorXform()) {
+        webpInfo = webpInfo.makeColorType(kBGRA_8888_SkColorType);
+        if (webpInfo.alphaType() == kPremul_SkAlphaType) {
+            webpInfo = webpInfo.makeAlphaType(kUnpremul_SkAlphaType);
+        }
+    }
+
+    config.output.colorspace = webp_decode_mode(webpInfo.colorType(),
+            hasAlpha && dstInfo.alphaType() == kPremul_SkAlphaType && !this->colorXform());
+    if (MODE_LAST == config.output.colorspace) {
+        return kUnimplemented;
+    }
+    config.output.is_external_memory = 1;
+    config.output.u.RGBA.rgba = reinterpret_cast<uint8_t*>(dst);
+    config.output.u.RGBA.stride = SkToInt(rowBytes);
+    config.output.u.RGBA.size = dstInfo.computeByteSize(rowBytes);
+
+    decode->fDecoder.reset(WebPIDecode(nullptr, 0, &config));
+    if (!decode->fDecoder) {
+        return kInvalidInput;
+    }
+    fIncrementalDecode = std::move(decode);
+    return kSuccess;
+}
+
+SkCodec::Result SkWebpCodec::onIncrementalDecode(int* rowsDecoded) {
+    IncrementalDecode* decode = fIncrementalDecode.get();
+    SkASSERT(decode);
+    if (rowsDecoded) {
+        *rowsDecoded = decode->fRowsDecoded;
+    }
+
+    this->readMoreData();
+
+    WebPIterator frame;
+    SkAutoTCallVProc<WebPIterator, WebPDemuxReleaseIterator> autoFrame(&frame);
+    // This succeeded when the codec was made, with less data.
+    SkAssertResult(WebPDemuxGetFrame(fDemux, 1, &frame));
+
+    // libwebp picks up where it left off, even though fData may have moved.
+    VP8StatusCode status = WebPIUpdate(decode->fDecoder, frame.fragment.bytes,
+                                       frame.fragment.size);
+    if (VP8_STATUS_OK != status && VP8_STATUS_SUSPENDED != status) {
+        return kErrorInInput;
+    }
+
+    int lastRow = this->dimensions().height();
+    if (VP8_STATUS_SUSPENDED == status &&
+            !WebPIDecGetRGB(decode->fDecoder, &lastRow, nullptr, nullptr, nullptr)) {
+        lastRow = 0;
+    }
+
+    if (this->colorXform()) {
+        const WebPRGBABuffer& output = decode->fConfig.output.u.RGBA;
+        for (int y = decode->fRowsDecoded; y < lastRow; y++) {
+            void* row = SkTAddOffset<void>(output.rgba, (size_t) y * output.stride);
+            this->applyColorXform(row, row, this->dimensions().width());
+        }
+    }
+    decode->fRowsDecoded = SkTMax(decode->fRowsDecoded, lastRow);
+    if (rowsDecoded) {
+        *rowsDecoded = decode->fRowsDecoded;
+    }
+
+    return VP8_STATUS_OK == status ? kSuccess : kIncompleteInput;
+}
+
+bool SkWebpCodec::readMoreData() {
+    if (!fUnreadStream) {
+        return false;
+    }
+
+    SkDynamicMemoryWStream data;
+    data.write(fData->data(), fData->size());
+    size_t bytes = copy_available_data(fUnreadStream.get(), &data);
+    if (fUnreadStream->isAtEnd()) {
+        fUnreadStream.reset(nullptr);
+    }
+    if (0 == bytes) {
+        return false;
+    }
+
+    // Replace the demux before freeing the data that it points into.
+    sk_sp<SkData> moreData = data.detachAsData();
+    WebPData webpData = { moreData->bytes(), moreData->size() };
+    WebPDemuxer* demux = WebPDemuxPartial(&webpData, nullptr);
+    if (!demux) {
+        fUnreadStream.reset(nullptr);
+        return false;
+    }
+    fDemux.reset(demux);
+    fData = std::move(moreData);
+    return true;
+}
+
 SkWebpCodec::SkWebpCodec(SkEncodedInfo&& info, std::unique_ptr<SkStream> stream,
-                         WebPDemuxer* demux, sk_sp<SkData> data, SkEncodedOrigin origin)
+                         WebPDemuxer* demux, sk_sp<SkData> data,
+                         std::unique_ptr<SkStream> unreadStream, SkEncodedOrigin origin)
     : INHERITED(std::move(info), skcms_PixelFormat_BGRA_8888, std::move(stream),
                 origin)
     , fDemux(demux)
     , fData(std::move(data))
+    , fUnreadStream(std::move(unreadStream))
     , fFailed(false)
 {
     const auto& eInfo = this->getEncodedInfo();
     fFrameHolder.setScreenSize(eInfo.width(), eInfo.height());
 }
+
+SkWebpCodec::~SkWebpCodec() {}
@@ -14,6 +14,7 @@
 #include "SkImageInfo.h"
 #include "SkTypes.h"
 
+#include <memory>
 #include <vector>
 
 class SkStream;
@@ -45,9 +46,24 @@ protected:
         return &fFrameHolder;
     }
 
+    /*
+     * Still images are decoded incrementally, reading whatever more of the stream has arrived
+     * each time.
+     */
+    Result onStartIncrementalDecode(const SkImageInfo& dstInfo, void* dst, size_t rowBytes,
+            const Options&) override;
+    Result onIncrementalDecode(int* rowsDecoded) override;
+
 private:
     SkWebpCodec(SkEncodedInfo&&, std::unique_ptr<SkStream>, WebPDemuxer*, sk_sp<SkData>,
-                SkEncodedOrigin);
+                std::unique_ptr<SkStream> unreadStream, SkEncodedOrigin);
+    ~SkWebpCodec() override;
+
+    /*
+     * Appends whatever more of fUnreadStream has arrived to fData, returning whether there was
+     * any.
+     */
+    bool readMoreData();
 
     SkAutoTCallVProc<WebPDemuxer, WebPDemuxDelete> fDemux;
 
@@ -55,6 +71,12 @@ private:
     // This should not be freed until the decode is completed.
     sk_sp<SkData> fData;
 
+    // If the stream was not all there when fData was copied from it, the rest of it.
+    std::unique_ptr<SkStream> fUnreadStream;
+
+    struct IncrementalDecode;
+    std::unique_ptr<IncrementalDecode> fIncrementalDecode;
+
     class Frame : public SkFrame {
     public:
         Frame(int i, SkEncodedInfo::Alpha alpha)
@@ -173,7 +173,7 @@ private:
     bool                 onGetFrameInfo(int, FrameInfo*) const override;
     int                  onGetRepetitionCount() override;
     SkSampler*           getSampler(bool createIfNecessary) override;
-    bool                 conversionSupported(const SkImageInfo& dst, bool, bool) override;
+    std::unique_ptr<SkStream> onDuplicateStream() const override;
 
     void   readFrames();
     Result seekFrame(int frameIndex);
@@ -183,6 +183,9 @@ private:
     const char* decodeFrame();
     void        updateNumFullyReceivedFrames();
 
+    void initializeColorTable();
+    void applyXformRow(void* dst, const uint8_t* src);
+
     SkWuffsSpySampler                                       fSpySampler;
     SkWuffsFrameHolder                                      fFrameHolder;
     std::unique_ptr<SkStream>                               fStream;
@@ -203,6 +206,7 @@ private:
 
     std::unique_ptr<SkSwizzler> fSwizzler;
     SkPMColor                   fColorTable[256];
+    std::unique_ptr<uint32_t[]> fXformBuffer;
 
     uint64_t                  fNumFullyReceivedFrames;
     std::vector<SkWuffsFrame> fFrames;
@@ -376,6 +380,11 @@ SkCodec::Result SkWuffsCodec::onStartIncrementalDecode(const SkImageInfo&      d
     if (options.fSubset) {
         return SkCodec::kUnimplemented;
     }
+    if (options.fFrameIndex > 0 && kRGB_565_SkColorType == dstInfo.colorType()) {
+        // As in SkGifCodec, 565 has no way to leave a frame's transparent pixels showing the
+        // frame below, so only the first frame can be decoded to it.
+        return SkCodec::kInvalidConversion;
+    }
     SkCodec::Result result = this->seekFrame(options.fFrameIndex);
     if (result != SkCodec::kSuccess) {
         return result;
@@ -386,6 +395,11 @@ SkCodec::Result SkWuffsCodec::onStartIncrementalDecode(const SkImageInfo&      d
     fIncrDecHaveFrameConfig = false;
     fIncrDecRowBytes = rowBytes;
     fSwizzler = nullptr;
+    fXformBuffer = nullptr;
+    if (this->xformOnDecode()) {
+        fXformBuffer.reset(new uint32_t[dstInfo.width()]);
+        sk_bzero(fXformBuffer.get(), dstInfo.width() * sizeof(uint32_t));
+    }
 
     return SkCodec::kSuccess;
 }
@@ -400,9 +414,12 @@ static bool independent_frame(SkCodec* codec, int frameIndex) {
     return frameInfo.fRequiredFrame == SkCodec::kNoFrame;
 }
 
-static void blend(uint32_t* dst, const uint32_t* src, int width) {
+template <typename T>
+static void blend(void* dstAsVoid, const void* srcAsVoid, int width) {
+    T*       dst = reinterpret_cast<T*>(dstAsVoid);
+    const T* src = reinterpret_cast<const T*>(srcAsVoid);
     while (width --> 0) {
-        if (*src != 0) {
+        if (*src != 0) {   // GIF pixels are either transparent (== 0) or opaque (!= 0).
             *dst = *src;
         }
         src++;
@@ -410,6 +427,35 @@ static void blend(uint32_t* dst, const uint32_t* src, int width) {
     }
 }
 
+static constexpr SkColorType kXformSrcColorType = kRGBA_8888_SkColorType;
+
+void SkWuffsCodec::initializeColorTable() {
+    wuffs_base__slice_u8 palette = fPixelBuffer.palette();
+    SkASSERT(palette.len == 4 * 256);
+    auto proc = choose_pack_color_proc(false, this->colorXform() ? kXformSrcColorType
+                                                                 : dstInfo().colorType());
+    for (int i = 0; i < 256; i++) {
+        uint8_t* p = palette.ptr + 4 * i;
+        fColorTable[i] = proc(p[3], p[2], p[1], p[0]);
+    }
+    if (this->colorXform() && !this->xformOnDecode()) {
+        SkPMColor srcColors[256];
+        memcpy(srcColors, fColorTable, sizeof(srcColors));
+        this->applyColorXform(fColorTable, srcColors, 256);
+    }
+}
+
+void SkWuffsCodec::applyXformRow(void* dst, const uint8_t* src) {
+    if (this->xformOnDecode()) {
+        SkASSERT(fXformBuffer);
+        fSwizzler->swizzle(fXformBuffer.get(), src);
+        this->applyColorXform(dst, fXformBuffer.get(),
+                              get_scaled_dimension(dstInfo().width(), fSwizzler->sampleX()));
+    } else {
+        fSwizzler->swizzle(dst, src);
+    }
+}
+
 SkCodec::Result SkWuffsCodec::onIncrementalDecode(int* rowsDecoded) {
     if (!fIncrDecDst) {
         return SkCodec::kInternalError;
@@ -443,7 +489,14 @@ SkCodec::Result SkWuffsCodec::onIncrementalDecode(int* rowsDecoded) {
     wuffs_base__rect_ie_u32 r = fFrameConfig.bounds();
     if (!fSwizzler) {
         SkIRect swizzleRect = SkIRect::MakeLTRB(r.min_incl_x, 0, r.max_excl_x, 1);
-        fSwizzler = SkSwizzler::Make(this->getEncodedInfo(), fColorTable, dstInfo(), Options(),
+        SkImageInfo swizzlerInfo = dstInfo();
+        if (this->colorXform()) {
+            swizzlerInfo = swizzlerInfo.makeColorType(kXformSrcColorType);
+            if (kPremul_SkAlphaType == dstInfo().alphaType()) {
+                swizzlerInfo = swizzlerInfo.makeAlphaType(kUnpremul_SkAlphaType);
+            }
+        }
+        fSwizzler = SkSwizzler::Make(this->getEncodedInfo(), fColorTable, swizzlerInfo, Options(),
                                      &swizzleRect);
         fSwizzler->setSampleX(fSpySampler.sampleX());
         fSwizzler->setSampleY(fSpySampler.sampleY());
@@ -456,13 +509,7 @@ SkCodec::Result SkWuffsCodec::onIncrementalDecode(int* rowsDecoded) {
         }
     }
 
-    wuffs_base__slice_u8 palette = fPixelBuffer.palette();
-    SkASSERT(palette.len == 4 * 256);
-    auto proc = choose_pack_color_proc(false, dstInfo().colorType());
-    for (int i = 0; i < 256; i++) {
-        uint8_t* p = palette.ptr + 4 * i;
-        fColorTable[i] = proc(p[3], p[2], p[1], p[0]);
-    }
+    this->initializeColorTable();
 
     std::unique_ptr<uint8_t[]> tmpBuffer;
     if (!independent) {
@@ -498,14 +545,22 @@ SkCodec::Result SkWuffsCodec::onIncrementalDecode(int* rowsDecoded) {
         // of the frame, we adjust s by (r.min_incl_x * src_bpp).
         uint8_t* s = pixels.ptr + (y * pixels.stride) + (r.min_incl_x * src_bpp);
         if (independent) {
-            fSwizzler->swizzle(d, s);
+            this->applyXformRow(d, s);
         } else {
             SkASSERT(tmpBuffer.get());
-            fSwizzler->swizzle(tmpBuffer.get(), s);
-            d = SkTAddOffset<uint8_t>(d, fSwizzler->swizzleOffsetBytes());
-            const auto* swizzled = SkTAddOffset<uint32_t>(tmpBuffer.get(),
-                                                          fSwizzler->swizzleOffsetBytes());
-            blend(reinterpret_cast<uint32_t*>(d), swizzled, fSwizzler->swizzleWidth());
+            this->applyXformRow(tmpBuffer.get(), s);
+            size_t offsetBytes = fSwizzler->swizzleOffsetBytes();
+            if (kRGBA_F16_SkColorType == dstInfo().colorType()) {
+                // The swizzler's offset is into the 8888 xform buffer. F16 is twice as wide.
+                offsetBytes *= 2;
+            }
+            d = SkTAddOffset<uint8_t>(d, offsetBytes);
+            const void* swizzled = SkTAddOffset<uint8_t>(tmpBuffer.get(), offsetBytes);
+            if (kRGBA_F16_SkColorType == dstInfo().colorType()) {
+                blend<uint64_t>(d, swizzled, fSwizzler->swizzleWidth());
+            } else {
+                blend<uint32_t>(d, swizzled, fSwizzler->swizzleWidth());
+            }
         }
     }
 
@@ -536,6 +591,7 @@ SkCodec::Result SkWuffsCodec::onIncrementalDecode(int* rowsDecoded) {
         fIncrDecHaveFrameConfig = false;
         fIncrDecRowBytes = 0;
         fSwizzler = nullptr;
+        fXformBuffer = nullptr;
     } else {
         // Make fSpySampler return whatever fSwizzler would have for fillWidth.
         fSpySampler.fFillWidth = fSwizzler->fillWidth();
@@ -585,20 +641,8 @@ SkSampler* SkWuffsCodec::getSampler(bool createIfNecessary) {
     return nullptr;
 }
 
-bool SkWuffsCodec::conversionSupported(const SkImageInfo& dst, bool srcIsOpaque, bool needsColorXform) {
-    if (!this->INHERITED::conversionSupported(dst, srcIsOpaque, needsColorXform)) {
-        return false;
-    }
-
-    switch (dst.colorType()) {
-        case kRGBA_8888_SkColorType:
-        case kBGRA_8888_SkColorType:
-            return true;
-        default:
-            // FIXME: Add skcms to support F16
-            // FIXME: Add support for 565 on the first frame
-            return false;
-    }
+std::unique_ptr<SkStream> SkWuffsCodec::onDuplicateStream() const {
+    return fStream->duplicate();
 }
 
 void SkWuffsCodec::readFrames() {
@@ -105,7 +105,7 @@
 //
 //
 
-#if   defined( _MSC_VER )
+#if   defined( _MSC_VER ) || defined( __cplusplus )
 
 #define STATIC_ASSERT_MACRO(...) static_assert(__VA_ARGS__)
 
@@ -291,19 +291,30 @@ skc_surface_grid_pfn_execute(skc_grid_t const grid)
           cl(EnqueueReleaseGLObjects(impl->cq,1,&render->fb->mem,0,NULL,&complete));
 
           //
-          // blit the rbo to fbo0
+          // framebuffers that aren't presented by an interop (e.g. a
+          // texture owned by Skia) are left as they are
           //
-          render->fb->post_render(render->fb->interop);
-
-          //
-          // clear the rbo -- FIXME -- we shouldn't have to do this here
-          //
-          float    const rgba[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
-          uint32_t       rect[4] = { 0 };
-
-          skc_interop_get_size(render->fb->interop,rect+2,rect+3);
-
-          skc_surface_debug_clear(impl,render->fb,rgba,rect);
+          if (render->fb->interop != NULL)
+            {
+              //
+              // blit the rbo to fbo0
+              //
+              render->fb->post_render(render->fb->interop);
+
+              //
+              // clear the rbo -- FIXME -- we shouldn't have to do this here
+              //
+              float    const rgba[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+              uint32_t       rect[4] = { 0 };
+
+              skc_interop_get_size(render->fb->interop,rect+2,rect+3);
+
+              skc_surface_debug_clear(impl,render->fb,rgba,rect);
+            }
+        }
+      else
+        {
+          cl(EnqueueMarkerWithWaitList(impl->cq,0,NULL,&complete));
         }
 
       // notify anyone listening...
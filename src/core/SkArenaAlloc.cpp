@@ -6,11 +6,119 @@
  */
 
 #include "SkArenaAlloc.h"
+#include "SkMemoryCounters.h"
+#include "SkTLS.h"
 #include <algorithm>
 #include <new>
 
 static char* end_chain(char*) { return nullptr; }
 
+// Heap blocks start with their size, and the arena gets what follows, still 16-byte aligned.
+static constexpr uint32_t kBlockHeaderSize = 16;
+static constexpr int      kMaxRecycledBlocks = 8;
+
+static std::atomic<size_t> gBlockRecyclingLimit{0};
+
+namespace {
+// One thread's freed heap blocks, waiting to be reused.
+struct RecycledBlocks {
+    ~RecycledBlocks() {
+        for (int i = 0; i < fCount; i++) {
+            delete [] (fBlocks[i] - kBlockHeaderSize);
+        }
+    }
+
+    char*    fBlocks[kMaxRecycledBlocks];
+    uint32_t fSizes[kMaxRecycledBlocks];
+    int      fCount = 0;
+    size_t   fBytes = 0;
+};
+}
+
+static void* create_recycled_blocks() { return new RecycledBlocks; }
+static void delete_recycled_blocks(void* blocks) { delete (RecycledBlocks*)blocks; }
+
+// Returns a block of at least *size bytes, and sets *size to its actual size.
+static char* alloc_block(uint32_t* size) {
+    char* block = nullptr;
+    if (gBlockRecyclingLimit.load(std::memory_order_relaxed) > 0) {
+        if (auto blocks = (RecycledBlocks*)SkTLS::Find(create_recycled_blocks)) {
+            // Take the smallest block that fits, leaving bigger ones for bigger arenas.
+            int best = -1;
+            for (int i = 0; i < blocks->fCount; i++) {
+                if (blocks->fSizes[i] >= *size &&
+                    (best < 0 || blocks->fSizes[i] < blocks->fSizes[best])) {
+                    best = i;
+                }
+            }
+            if (best >= 0) {
+                block = blocks->fBlocks[best];
+                *size = blocks->fSizes[best];
+                blocks->fBytes -= *size;
+                blocks->fCount--;
+                blocks->fBlocks[best] = blocks->fBlocks[blocks->fCount];
+                blocks->fSizes [best] = blocks->fSizes [blocks->fCount];
+            }
+        }
+    }
+
+    if (!block) {
+        char* header = new char[kBlockHeaderSize + *size];
+        memcpy(header, size, sizeof(uint32_t));
+        block = header + kBlockHeaderSize;
+    }
+    SkMemoryCounters::Add(SkGraphics::MemoryCounters::kArenaAlloc, *size);
+    return block;
+}
+
+static void free_block(char* block) {
+    char* header = block - kBlockHeaderSize;
+    uint32_t size;
+    memcpy(&size, header, sizeof(uint32_t));
+    SkMemoryCounters::Remove(SkGraphics::MemoryCounters::kArenaAlloc, size);
+
+    size_t limit = gBlockRecyclingLimit.load(std::memory_order_relaxed);
+    if (size <= limit) {
+        auto blocks = (RecycledBlocks*)SkTLS::Get(create_recycled_blocks,
+                                                  delete_recycled_blocks);
+        if (blocks->fCount < kMaxRecycledBlocks && blocks->fBytes + size <= limit) {
+            blocks->fBlocks[blocks->fCount] = block;
+            blocks->fSizes [blocks->fCount] = size;
+            blocks->fCount++;
+            blocks->fBytes += size;
+            return;
+        }
+    }
+    delete [] header;
+}
+
+void SkArenaAlloc::SetBlockRecyclingLimit(size_t bytesPerThread) {
+    gBlockRecyclingLimit.store(bytesPerThread, std::memory_order_relaxed);
+}
+
+static std::atomic<const SkArenaAlloc::Site*> gSites{nullptr};
+
+const SkArenaAlloc::Site* SkArenaAlloc::Site::Head() {
+    return gSites.load(std::memory_order_acquire);
+}
+
+void SkArenaAlloc::Site::record(size_t bytesUsed, bool usedHeap) {
+    // Most arenas fit, so this only writes shared memory when something new happens.
+    size_t highWaterMark = fHighWaterMark.load(std::memory_order_relaxed);
+    while (bytesUsed > highWaterMark &&
+           !fHighWaterMark.compare_exchange_weak(highWaterMark, bytesUsed,
+                                                 std::memory_order_relaxed)) {}
+    if (usedHeap) {
+        fHeapCount.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    if (!fListed.load(std::memory_order_relaxed) && !fListed.exchange(true)) {
+        fNext = gSites.load(std::memory_order_relaxed);
+        while (!gSites.compare_exchange_weak(fNext, this, std::memory_order_release,
+                                             std::memory_order_relaxed)) {}
+    }
+}
+
 static uint32_t first_allocated_block(uint32_t blockSize, uint32_t firstHeapAllocation) {
     return firstHeapAllocation > 0 ? firstHeapAllocation :
            blockSize           > 0 ? blockSize           : 1024;
@@ -34,12 +142,25 @@ SkArenaAlloc::SkArenaAlloc(char* block, size_t size, size_t firstHeapAllocation)
 }
 
 SkArenaAlloc::~SkArenaAlloc() {
+    if (fSite) {
+        fSite->record(this->bytesUsed(), fHeapBytes > 0);
+    }
     RunDtorsOnBlock(fDtorCursor);
 }
 
 void SkArenaAlloc::reset() {
+    Site* site = fSite;
     this->~SkArenaAlloc();
     new (this) SkArenaAlloc{fFirstBlock, fFirstSize, fFirstHeapAllocationSize};
+    fSite = site;
+}
+
+size_t SkArenaAlloc::bytesUsed() const {
+    if (0 == fHeapBytes) {
+        return fCursor ? fCursor - fFirstBlock : 0;
+    }
+    size_t firstSize = fFirstSize >= sizeof(Footer) ? fFirstSize : 0;
+    return firstSize + fHeapBytes - (fEnd - fCursor);
 }
 
 void SkArenaAlloc::installFooter(FooterAction* action, uint32_t padding) {
@@ -84,7 +205,7 @@ char* SkArenaAlloc::NextBlock(char* footerEnd) {
     char* next;
     memmove(&next, objEnd, sizeof(char*));
     RunDtorsOnBlock(next);
-    delete [] objEnd;
+    free_block(objEnd);
     return nullptr;
 }
 
@@ -127,8 +248,10 @@ void SkArenaAlloc::ensureSpace(uint32_t size, uint32_t alignment) {
         AssertRelease(allocationSize <= maxSize - mask);
         allocationSize = (allocationSize + mask) & ~mask;
     }
+    AssertRelease(allocationSize <= maxSize - kBlockHeaderSize);
 
-    char* newBlock = new char[allocationSize];
+    char* newBlock = alloc_block(&allocationSize);
+    fHeapBytes += allocationSize;
 
     auto previousDtor = fDtorCursor;
     fCursor = newBlock;
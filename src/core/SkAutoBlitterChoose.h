@@ -31,6 +31,8 @@ public:
     SkBlitter* choose(const SkDraw& draw, const SkMatrix* matrix, const SkPaint& paint,
                       bool drawCoverage = false) {
         SkASSERT(!fBlitter);
+        static SkArenaAlloc::Site gSite{"SkAutoBlitterChoose"};
+        fAlloc.setSite(&gSite);
         if (!matrix) {
             matrix = draw.fMatrix;
         }
@@ -42,6 +44,7 @@ public:
                                                            &fAlloc, true);
             fBlitter = fAlloc.make<SkPairBlitter>(fBlitter, coverageBlitter);
         }
+        fBlitter = draw.clipToTile(fBlitter, &fAlloc);
         return fBlitter;
     }
 
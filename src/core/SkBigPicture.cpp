@@ -7,6 +7,7 @@
 
 #include "SkBBoxHierarchy.h"
 #include "SkBigPicture.h"
+#include "SkMemoryCounters.h"
 #include "SkPictureCommon.h"
 #include "SkRecord.h"
 #include "SkRecordDraw.h"
@@ -22,7 +23,15 @@ SkBigPicture::SkBigPicture(const SkRect& cull,
     , fRecord(record)               // Take ownership of caller's ref.
     , fDrawablePicts(drawablePicts) // Take ownership.
     , fBBH(bbh)                     // Take ownership of caller's ref.
-{}
+{
+    // Sub-pictures count themselves.
+    fCountedBytes = fRecord->bytesUsed() + (fBBH ? fBBH->bytesUsed() : 0);
+    SkMemoryCounters::Add(SkGraphics::MemoryCounters::kPicture, fCountedBytes);
+}
+
+SkBigPicture::~SkBigPicture() {
+    SkMemoryCounters::Remove(SkGraphics::MemoryCounters::kPicture, fCountedBytes);
+}
 
 void SkBigPicture::playback(SkCanvas* canvas, AbortCallback* callback) const {
     SkASSERT(canvas);
@@ -39,7 +39,7 @@ public:
                  SnapshotArray*,       // We take exclusive ownership.
                  SkBBoxHierarchy*,     // We take ownership of the caller's ref.
                  size_t approxBytesUsedBySubPictures);
-
+    ~SkBigPicture() override;
 
 // SkPicture overrides
     void playback(SkCanvas*, AbortCallback*) const override;
@@ -66,6 +66,7 @@ private:
     sk_sp<const SkRecord>                fRecord;
     std::unique_ptr<const SnapshotArray> fDrawablePicts;
     sk_sp<const SkBBoxHierarchy>         fBBH;
+    size_t                               fCountedBytes;  // Reported to SkMemoryCounters.
 };
 
 #endif//SkBigPicture_DEFINED
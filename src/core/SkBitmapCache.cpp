@@ -7,11 +7,16 @@
 
 #include "SkBitmapCache.h"
 #include "SkBitmapProvider.h"
+#include "SkExecutor.h"
 #include "SkImage.h"
 #include "SkResourceCache.h"
 #include "SkMipMap.h"
+#include "SkMutex.h"
 #include "SkPixelRef.h"
 #include "SkRect.h"
+#include "SkTHash.h"
+
+std::atomic<bool> gSkBuildMipMapsInBackground{false};
 
 /**
  *  Use this for bitmapcache and mipmapcache entries.
@@ -142,6 +147,7 @@ public:
             } else {
                 SkASSERT(fExternalCounter == 0);
                 if (!fDM->lock()) {
+                    SkResourceCache::NotifyDiscardablePurged(fInfo.computeByteSize(fRowBytes));
                     fDM.reset(nullptr);
                     return false;
                 }
@@ -314,7 +320,8 @@ const SkMipMap* SkMipMapCache::AddAndRef(const SkBitmapProvider& provider,
         return nullptr;
     }
 
-    SkMipMap* mipmap = SkMipMap::Build(src, get_fact(localCache));
+    // The caller only needs the level it is about to sample, so leave the rest for later.
+    SkMipMap* mipmap = SkMipMap::Build(src, get_fact(localCache), 1);
     if (mipmap) {
         MipMapRec* rec = new MipMapRec(provider.makeCacheDesc(), mipmap);
         CHECK_LOCAL(localCache, add, Add, rec);
@@ -322,3 +329,90 @@ const SkMipMap* SkMipMapCache::AddAndRef(const SkBitmapProvider& provider,
     }
     return mipmap;
 }
+
+SK_DECLARE_STATIC_MUTEX(gPendingMipMapsMutex);
+
+// IDs of the images whose mipmaps are being built in the background.
+static SkTHashSet<uint32_t>* pending_mipmaps() {
+    static SkTHashSet<uint32_t>* pending = new SkTHashSet<uint32_t>;
+    return pending;
+}
+
+bool SkMipMapCache::AddInBackground(const SkBitmapProvider& provider) {
+    SkBitmap src;
+    if (!provider.asBitmap(&src)) {
+        return false;
+    }
+
+    const SkBitmapCacheDesc desc = provider.makeCacheDesc();
+    {
+        SkAutoMutexAcquire lock(gPendingMipMapsMutex);
+        if (pending_mipmaps()->contains(desc.fImageID)) {
+            return true;
+        }
+        pending_mipmaps()->add(desc.fImageID);
+    }
+
+    // Registered now, while we know the image is alive, so its entry is purged along with it.
+    provider.notifyAddedToCache();
+    // src holds a ref on the pixels, so they outlive the image if need be.
+    SkExecutor::GetDefault().add([src, desc] {
+        if (SkMipMap* mipmap = SkMipMap::Build(src, SkResourceCache::GetDiscardableFactory())) {
+            SkResourceCache::Add(new MipMapRec(desc, mipmap));
+            mipmap->unref();
+        }
+        SkAutoMutexAcquire lock(gPendingMipMapsMutex);
+        pending_mipmaps()->remove(desc.fImageID);
+    });
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+static unsigned gResizedKeyNamespaceLabel;
+
+struct ResizedKey : public SkResourceCache::Key {
+public:
+    ResizedKey(const SkBitmapCacheDesc& desc, int width, int height)
+        : fDesc(desc), fWidth(width), fHeight(height) {
+        this->init(&gResizedKeyNamespaceLabel,
+                   SkMakeResourceCacheSharedIDForBitmap(fDesc.fImageID),
+                   sizeof(fDesc) + sizeof(fWidth) + sizeof(fHeight));
+    }
+
+    const SkBitmapCacheDesc fDesc;
+    const int32_t           fWidth;
+    const int32_t           fHeight;
+};
+
+struct ResizedRec : public SkResourceCache::Rec {
+    ResizedRec(const SkBitmapCacheDesc& desc, const SkBitmap& resized)
+        : fKey(desc, resized.width(), resized.height())
+        , fBitmap(resized) {}
+
+    const Key& getKey() const override { return fKey; }
+    size_t bytesUsed() const override { return sizeof(fKey) + fBitmap.computeByteSize(); }
+    const char* getCategory() const override { return "resized-bitmap"; }
+    SkDiscardableMemory* diagnostic_only_getDiscardable() const override { return nullptr; }
+
+    static bool Finder(const SkResourceCache::Rec& baseRec, void* contextBitmap) {
+        const ResizedRec& rec = static_cast<const ResizedRec&>(baseRec);
+        *static_cast<SkBitmap*>(contextBitmap) = rec.fBitmap;
+        return true;
+    }
+
+    ResizedKey fKey;
+    SkBitmap   fBitmap;
+};
+}
+
+bool SkResizedBitmapCache::Find(const SkBitmapCacheDesc& desc, int width, int height,
+                                SkBitmap* result) {
+    return SkResourceCache::Find(ResizedKey(desc, width, height), ResizedRec::Finder, result);
+}
+
+void SkResizedBitmapCache::Add(const SkBitmapProvider& provider, const SkBitmap& resized) {
+    SkResourceCache::Add(new ResizedRec(provider.makeCacheDesc(), resized));
+    provider.notifyAddedToCache();
+}
@@ -9,6 +9,7 @@
 #define SkBitmapCache_DEFINED
 
 #include "SkRect.h"
+#include <atomic>
 #include <memory>
 
 class SkBitmap;
@@ -56,12 +57,30 @@ private:
     static void PrivateDeleteRec(Rec*);
 };
 
+// When set, raster draws that need a mipmap that isn't cached yet draw without one and have it
+// built on SkExecutor::GetDefault() instead of building it themselves. Off by default.
+extern std::atomic<bool> gSkBuildMipMapsInBackground;
+
 class SkMipMapCache {
 public:
     static const SkMipMap* FindAndRef(const SkBitmapCacheDesc&,
                                       SkResourceCache* localCache = nullptr);
+    // Only generates the first level right away; the rest are generated as they are used.
     static const SkMipMap* AddAndRef(const SkBitmapProvider&,
                                      SkResourceCache* localCache = nullptr);
+    // Builds the mipmap on SkExecutor::GetDefault() and adds it to the global cache, unless a
+    // build for this image is already underway. Returns false if the pixels aren't available.
+    static bool AddInBackground(const SkBitmapProvider&);
+};
+
+/**
+ *  Caches images that SkResizer resampled for high quality downscales, keyed by the image and
+ *  the size they were resampled to.
+ */
+class SkResizedBitmapCache {
+public:
+    static bool Find(const SkBitmapCacheDesc&, int width, int height, SkBitmap* result);
+    static void Add(const SkBitmapProvider&, const SkBitmap& resized);
 };
 
 #endif
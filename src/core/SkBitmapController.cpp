@@ -12,6 +12,7 @@
 #include "SkBitmapProvider.h"
 #include "SkMatrix.h"
 #include "SkMipMap.h"
+#include "SkResizer.h"
 #include "SkTemplates.h"
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -46,8 +47,9 @@ bool SkBitmapController::State::processHighRequest(const SkBitmapProvider& provi
     invScaleY = SkScalarAbs(invScaleY);
 
     if (invScaleX >= 1 - SK_ScalarNearlyZero || invScaleY >= 1 - SK_ScalarNearlyZero) {
-        // we're down-scaling so abort HQ
-        return false;
+        // We're down-scaling. Large downscales are resampled to size up front, the rest use
+        // mip levels.
+        return this->processResizeRequest(provider, invScaleX, invScaleY);
     }
 
     // Confirmed that we can use HQ (w/ rasterpipeline)
@@ -56,6 +58,41 @@ bool SkBitmapController::State::processHighRequest(const SkBitmapProvider& provi
     return true;
 }
 
+bool SkBitmapController::State::processResizeRequest(const SkBitmapProvider& provider,
+                                                     SkScalar invScaleX, SkScalar invScaleY) {
+    // Resampling to one size only suits scales and translates.
+    if ((fInvMatrix.getType() & ~(SkMatrix::kScale_Mask | SkMatrix::kTranslate_Mask)) ||
+        !SkResizer::IsLargeDownscale(SkScalarInvert(invScaleX), SkScalarInvert(invScaleY))) {
+        return false;
+    }
+
+    const SkBitmapCacheDesc desc = provider.makeCacheDesc();
+    const int srcW = desc.fSubset.width(),
+              srcH = desc.fSubset.height();
+    const int dstW = SkTMax(1, SkScalarRoundToInt(srcW / invScaleX)),
+              dstH = SkTMax(1, SkScalarRoundToInt(srcH / invScaleY));
+    if (!SkResizedBitmapCache::Find(desc, dstW, dstH, &fResultBitmap)) {
+        SkBitmap src;
+        SkPixmap srcPixmap;
+        if (!provider.asBitmap(&src) || !src.peekPixels(&srcPixmap)) {
+            return false;
+        }
+        SkBitmap resized;
+        if (!resized.tryAllocPixels(srcPixmap.info().makeWH(dstW, dstH)) ||
+            !SkResizer::Resize(resized.pixmap(), srcPixmap)) {
+            return false;
+        }
+        resized.setImmutable();
+        SkResizedBitmapCache::Add(provider, resized);
+        fResultBitmap = resized;
+    }
+
+    // The resampled image is about the size it's drawn at, so bilerp takes care of the rest.
+    fInvMatrix.postScale(SkIntToScalar(dstW) / srcW, SkIntToScalar(dstH) / srcH);
+    fQuality = kLow_SkFilterQuality;
+    return true;
+}
+
 /*
  *  Modulo internal errors, this should always succeed *if* the matrix is downscaling
  *  (in this case, we have the inverse, so it succeeds if fInvMatrix is upscaling)
@@ -77,6 +114,16 @@ bool SkBitmapController::State::processMediumRequest(const SkBitmapProvider& pro
 
     if (invScaleSize.width() > SK_Scalar1 || invScaleSize.height() > SK_Scalar1) {
         fCurrMip.reset(SkMipMapCache::FindAndRef(provider.makeCacheDesc()));
+        if (nullptr == fCurrMip.get() && gSkBuildMipMapsInBackground) {
+            if (SkMipMapCache::AddInBackground(provider)) {
+                // Found right away if the default executor ran the build inline; otherwise this
+                // draw goes without, and later ones will find it.
+                fCurrMip.reset(SkMipMapCache::FindAndRef(provider.makeCacheDesc()));
+                if (nullptr == fCurrMip.get()) {
+                    return false;
+                }
+            }
+        }
         if (nullptr == fCurrMip.get()) {
             fCurrMip.reset(SkMipMapCache::AddAndRef(provider));
             if (nullptr == fCurrMip.get()) {
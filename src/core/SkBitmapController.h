@@ -31,6 +31,8 @@ public:
 
     private:
         bool processHighRequest(const SkBitmapProvider&);
+        bool processResizeRequest(const SkBitmapProvider&, SkScalar invScaleX,
+                                  SkScalar invScaleY);
         bool processMediumRequest(const SkBitmapProvider&);
 
         SkPixmap              fPixmap;
@@ -10,6 +10,9 @@
 #include "SkGlyphRun.h"
 #include "SkImageFilter.h"
 #include "SkImageFilterCache.h"
+#include "SkImageFilterPriv.h"
+#include "SkImage_Base.h"
+#include "SkLatticeIter.h"
 #include "SkMakeUnique.h"
 #include "SkMatrix.h"
 #include "SkPaint.h"
@@ -17,6 +20,7 @@
 #include "SkPixmap.h"
 #include "SkRasterClip.h"
 #include "SkRasterHandleAllocator.h"
+#include "SkRSXform.h"
 #include "SkShader.h"
 #include "SkSpecialImage.h"
 #include "SkSurface.h"
@@ -221,6 +225,14 @@ SkBitmapDevice::SkBitmapDevice(const SkBitmap& bitmap)
     SkASSERT(valid_for_bitmap_device(bitmap.info(), nullptr));
 }
 
+bool SkBitmapDevice::needsDrawTiling() const {
+    return SkDrawTiler::NeedsTiling(const_cast<SkBitmapDevice*>(this));
+}
+
+SkScalerContextFlags SkBitmapDevice::scalerContextFlags() const {
+    return scaler_context_flags(fBitmap);
+}
+
 SkBitmapDevice* SkBitmapDevice::Create(const SkImageInfo& info) {
     return Create(info, SkSurfaceProps(SkSurfaceProps::kLegacyFontHost_InitType));
 }
@@ -537,6 +549,61 @@ void SkBitmapDevice::drawBitmapRect(const SkBitmap& bitmap,
     this->drawRect(*dstPtr, paintWithShader);
 }
 
+bool SkBitmapDevice::drawLatticeAsSprites(const SkBitmap& bitmap, const SkCanvas::Lattice& lattice,
+                                          const SkRect& dst, const SkPaint& paint,
+                                          bool drawFixedColors) {
+    const SkMatrix& ctm = this->ctm();
+    if ((ctm.getType() & ~SkMatrix::kTranslate_Mask) ||
+        kAlpha_8_SkColorType == bitmap.colorType()) {
+        return false;
+    }
+    SkLatticeIter iter(lattice, dst);
+    const SkScalar tx = ctm.getTranslateX(),
+                   ty = ctm.getTranslateY();
+    if (!iter.isIntegerTranslate(tx, ty)) {
+        return false;
+    }
+
+    SkIRect srcR;
+    SkRect dstR;
+    SkColor c;
+    bool isFixedColor = false;
+    while (iter.next(&srcR, &dstR, &isFixedColor, &c)) {
+        if (drawFixedColors && isFixedColor) {
+            if (0 != c || !paint.isSrcOver()) {
+                SkPaint paintCopy(paint);
+                int alpha = SkAlphaMul(SkColorGetA(c), SkAlpha255To256(paint.getAlpha()));
+                paintCopy.setColor(SkColorSetA(c, alpha));
+                this->drawRect(dstR, paintCopy);
+            }
+            continue;
+        }
+        // Each patch is copied 1:1, so it needs no more than its own pixels.
+        SkBitmap subset;
+        if (bitmap.extractSubset(&subset, srcR)) {
+            this->drawSprite(subset, SkScalarRoundToInt(dstR.fLeft + tx),
+                             SkScalarRoundToInt(dstR.fTop + ty), paint);
+        }
+    }
+    return true;
+}
+
+void SkBitmapDevice::drawBitmapLattice(const SkBitmap& bitmap, const SkCanvas::Lattice& lattice,
+                                       const SkRect& dst, const SkPaint& paint) {
+    if (!this->drawLatticeAsSprites(bitmap, lattice, dst, paint, false)) {
+        this->INHERITED::drawBitmapLattice(bitmap, lattice, dst, paint);
+    }
+}
+
+void SkBitmapDevice::drawImageLattice(const SkImage* image, const SkCanvas::Lattice& lattice,
+                                      const SkRect& dst, const SkPaint& paint) {
+    SkBitmap bm;
+    if (!as_IB(image)->getROPixels(&bm) ||
+        !this->drawLatticeAsSprites(bm, lattice, dst, paint, true)) {
+        this->INHERITED::drawImageLattice(image, lattice, dst, paint);
+    }
+}
+
 void SkBitmapDevice::drawSprite(const SkBitmap& bitmap, int x, int y, const SkPaint& paint) {
     BDDraw(this).drawSprite(bitmap, x, y, paint);
 }
@@ -553,6 +620,37 @@ void SkBitmapDevice::drawVertices(const SkVertices* vertices, const SkVertices::
                               vertices->indexCount(), paint, bones, boneCount);
 }
 
+void SkBitmapDevice::drawAtlas(const SkImage* atlas, const SkRSXform xform[], const SkRect tex[],
+                               const SkColor colors[], int count, SkBlendMode mode,
+                               const SkPaint& paint) {
+    // When no sprite is rotated, each one is just an image rect, which the sprite and bitmap
+    // blitters draw much faster than the two shaded triangles the base device turns it into.
+    // Colors, mask filters, and tex rects that sample outside the atlas behave differently
+    // between the two, so those go the slow way.
+    SkBitmap bm;
+    bool axisAligned = !colors && !paint.getMaskFilter() && !atlas->isAlphaOnly() &&
+                       as_IB(atlas)->getROPixels(&bm);
+    SkRect atlasBounds = SkRect::Make(atlas->bounds());
+    for (int i = 0; axisAligned && i < count; ++i) {
+        axisAligned = 0 == xform[i].fSSin && xform[i].fSCos > 0 && tex[i].isSorted() &&
+                      atlasBounds.contains(tex[i]);
+    }
+    if (!axisAligned) {
+        this->INHERITED::drawAtlas(atlas, xform, tex, colors, count, mode, paint);
+        return;
+    }
+
+    // Vertices are never antialiased.
+    SkPaint p(paint);
+    p.setAntiAlias(false);
+    for (int i = 0; i < count; ++i) {
+        SkScalar scale = xform[i].fSCos;
+        SkRect dst = SkRect::MakeXYWH(xform[i].fTx, xform[i].fTy,
+                                      tex[i].width() * scale, tex[i].height() * scale);
+        this->drawBitmapRect(bm, &tex[i], dst, p, SkCanvas::kFast_SrcRectConstraint);
+    }
+}
+
 void SkBitmapDevice::drawDevice(SkBaseDevice* device, int x, int y, const SkPaint& origPaint) {
     SkASSERT(!origPaint.getImageFilter());
 
@@ -621,6 +719,39 @@ void SkBitmapDevice::drawSpecial(SkSpecialImage* src, int x, int y, const SkPain
         SkImageFilter::OutputProperties outputProperties(fBitmap.colorType(), fBitmap.colorSpace());
         SkImageFilter::Context ctx(matrix, clipBounds, cache.get(), outputProperties);
 
+        int tileSize = gSkImageFilterTileSize.load(std::memory_order_relaxed);
+        if (tileSize > 0 && !clipImage && !paint->getMaskFilter() &&
+            (clipBounds.width() > tileSize || clipBounds.height() > tileSize)) {
+            // Filter and draw one tile of the clip at a time. Each tile's result is clipped to
+            // its tile, so the tiles composite exactly as the whole result would.
+            SkPaint tilePaint(*paint);
+            tilePaint.setImageFilter(nullptr);
+            const SkIRect deviceClipBounds = fRCStack.rc().getBounds();
+            for (int top = deviceClipBounds.fTop; top < deviceClipBounds.fBottom;
+                 top += tileSize) {
+                for (int left = deviceClipBounds.fLeft; left < deviceClipBounds.fRight;
+                     left += tileSize) {
+                    SkIRect tile = SkIRect::MakeXYWH(left, top, tileSize, tileSize);
+                    tile.intersect(deviceClipBounds);
+                    SkImageFilter::Context tileCtx(matrix, tile.makeOffset(-x, -y), cache.get(),
+                                                   outputProperties);
+                    SkIPoint tileOffset = SkIPoint::Make(0, 0);
+                    sk_sp<SkSpecialImage> tileImage = filter->filterImage(src, tileCtx,
+                                                                          &tileOffset);
+                    if (!tileImage) {
+                        continue;
+                    }
+                    fRCStack.save();
+                    fRCStack.clipRect(SkMatrix::I(), SkRect::Make(tile), SkClipOp::kIntersect,
+                                      false);
+                    this->drawSpecial(tileImage.get(), x + tileOffset.x(), y + tileOffset.y(),
+                                      tilePaint, nullptr, clipMatrix);
+                    fRCStack.restore();
+                }
+            }
+            return;
+        }
+
         filteredImage = filter->filterImage(src, ctx, &offset);
         if (!filteredImage) {
             return;
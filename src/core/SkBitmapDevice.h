@@ -98,10 +98,16 @@ protected:
      */
     void drawBitmapRect(const SkBitmap&, const SkRect*, const SkRect&,
                         const SkPaint&, SkCanvas::SrcRectConstraint) override;
+    void drawBitmapLattice(const SkBitmap&, const SkCanvas::Lattice&, const SkRect& dst,
+                           const SkPaint&) override;
+    void drawImageLattice(const SkImage*, const SkCanvas::Lattice&, const SkRect& dst,
+                          const SkPaint&) override;
 
     void drawGlyphRunList(const SkGlyphRunList& glyphRunList) override;
     void drawVertices(const SkVertices*, const SkVertices::Bone bones[], int boneCount, SkBlendMode,
                       const SkPaint& paint) override;
+    void drawAtlas(const SkImage* atlas, const SkRSXform[], const SkRect[], const SkColor[],
+                   int count, SkBlendMode, const SkPaint&) override;
     void drawDevice(SkBaseDevice*, int x, int y, const SkPaint&) override;
 
     ///////////////////////////////////////////////////////////////////////////
@@ -135,6 +141,13 @@ protected:
     virtual void drawBitmap(const SkBitmap&, const SkMatrix&, const SkRect* dstOrNull,
                             const SkPaint&);
 
+    // True if draws have to be split up to keep coordinates in range of SkFixed.
+    bool needsDrawTiling() const;
+
+    SkScalerContextFlags scalerContextFlags() const;
+
+    const SkRasterClip& rasterClip() const { return fRCStack.rc(); }
+
 private:
     friend class SkCanvas;
     friend struct DeviceCM; //for setMatrixClip
@@ -156,6 +169,11 @@ private:
 
     SkImageFilterCache* getImageFilterCache() override;
 
+    // If every patch of the lattice lands unscaled on whole pixels, draws them with drawSprite()
+    // and returns true. Otherwise draws nothing and returns false.
+    bool drawLatticeAsSprites(const SkBitmap&, const SkCanvas::Lattice&, const SkRect& dst,
+                              const SkPaint&, bool drawFixedColors);
+
     SkBitmap    fBitmap;
     void*       fRasterHandle = nullptr;
     SkRasterClipStack  fRCStack;
@@ -587,6 +587,23 @@ const SkPixmap* SkRectClipBlitter::justAnOpaqueColor(uint32_t* value) {
     return fBlitter->justAnOpaqueColor(value);
 }
 
+// Blitters may blend these pairs differently than they do runs, so pass them on whole when we can.
+void SkRectClipBlitter::blitAntiH2(int x, int y, U8CPU a0, U8CPU a1) {
+    if (fClipRect.contains(SkIRect::MakeXYWH(x, y, 2, 1))) {
+        fBlitter->blitAntiH2(x, y, a0, a1);
+    } else {
+        SkBlitter::blitAntiH2(x, y, a0, a1);
+    }
+}
+
+void SkRectClipBlitter::blitAntiV2(int x, int y, U8CPU a0, U8CPU a1) {
+    if (fClipRect.contains(SkIRect::MakeXYWH(x, y, 1, 2))) {
+        fBlitter->blitAntiV2(x, y, a0, a1);
+    } else {
+        SkBlitter::blitAntiV2(x, y, a0, a1);
+    }
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 void SkRgnClipBlitter::blitH(int x, int y, int width) {
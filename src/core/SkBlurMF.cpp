@@ -80,9 +80,9 @@ protected:
                                    const SkIRect& clipBounds,
                                    NinePatch*) const override;
 
-    bool filterRectMask(SkMask* dstM, const SkRect& r, const SkMatrix& matrix,
+    bool filterRectMask(SkMask* dstM, const SkRect& r, SkScalar sigma,
                         SkIPoint* margin, SkMask::CreateMode createMode) const;
-    bool filterRRectMask(SkMask* dstM, const SkRRect& r, const SkMatrix& matrix,
+    bool filterRRectMask(SkMask* dstM, const SkRRect& r, SkScalar sigma,
                         SkIPoint* margin, SkMask::CreateMode createMode) const;
 
     bool ignoreXform() const { return !fRespectCTM; }
@@ -290,19 +290,13 @@ bool SkBlurMaskFilterImpl::filterMask(SkMask* dst, const SkMask& src,
     return SkBlurMask::BoxBlur(dst, src, sigma, fBlurStyle, margin);
 }
 
-bool SkBlurMaskFilterImpl::filterRectMask(SkMask* dst, const SkRect& r,
-                                          const SkMatrix& matrix,
+bool SkBlurMaskFilterImpl::filterRectMask(SkMask* dst, const SkRect& r, SkScalar sigma,
                                           SkIPoint* margin, SkMask::CreateMode createMode) const {
-    SkScalar sigma = computeXformedSigma(matrix);
-
     return SkBlurMask::BlurRect(sigma, dst, r, fBlurStyle, margin, createMode);
 }
 
-bool SkBlurMaskFilterImpl::filterRRectMask(SkMask* dst, const SkRRect& r,
-                                          const SkMatrix& matrix,
+bool SkBlurMaskFilterImpl::filterRRectMask(SkMask* dst, const SkRRect& r, SkScalar sigma,
                                           SkIPoint* margin, SkMask::CreateMode createMode) const {
-    SkScalar sigma = computeXformedSigma(matrix);
-
     return SkBlurMask::BlurRRect(sigma, dst, r, fBlurStyle, margin, createMode);
 }
 
@@ -422,6 +416,21 @@ static SkCachedData* add_cached_rects(SkMask* mask, SkScalar sigma, SkBlurStyle
 
 static const bool c_analyticBlurRRect{true};
 
+// Nine-patch masks are cached by their sigma and corner radii.  Snapping both to a fine grid lets
+// blurs that differ by a sliver of a pixel (say, a shadow whose size is animating) share a mask.
+static SkScalar quantize_ninepatch_sigma(SkScalar sigma) {
+    // Small blurs change visibly with small changes in sigma, so leave them be.
+    if (sigma < 1) {
+        return sigma;
+    }
+    return SkScalarRoundToScalar(sigma * 8) * 0.125f;
+}
+
+static SkVector quantize_ninepatch_radii(const SkVector& radii) {
+    return { SkScalarRoundToScalar(radii.fX * 4) * 0.25f,
+             SkScalarRoundToScalar(radii.fY * 4) * 0.25f };
+}
+
 SkMaskFilterBase::FilterReturn
 SkBlurMaskFilterImpl::filterRRectToNine(const SkRRect& rrect, const SkMatrix& matrix,
                                         const SkIRect& clipBounds,
@@ -460,6 +469,9 @@ SkBlurMaskFilterImpl::filterRRectToNine(const SkRRect& rrect, const SkMatrix& ma
         return kUnimplemented_FilterReturn;
     }
 
+    // The mask is both drawn and cached with the quantized sigma and radii.
+    const SkScalar sigma = quantize_ninepatch_sigma(this->computeXformedSigma(matrix));
+
     SkIPoint margin;
     SkMask  srcM, dstM;
     srcM.fBounds = rrect.rect().roundOut();
@@ -470,12 +482,12 @@ SkBlurMaskFilterImpl::filterRRectToNine(const SkRRect& rrect, const SkMatrix& ma
     if (c_analyticBlurRRect) {
         // special case for fast round rect blur
         // don't actually do the blur the first time, just compute the correct size
-        filterResult = this->filterRRectMask(&dstM, rrect, matrix, &margin,
+        filterResult = this->filterRRectMask(&dstM, rrect, sigma, &margin,
                                             SkMask::kJustComputeBounds_CreateMode);
     }
 
     if (!filterResult) {
-        filterResult = this->filterMask(&dstM, srcM, matrix, &margin);
+        filterResult = SkBlurMask::BoxBlur(&dstM, srcM, sigma, fBlurStyle, &margin);
     }
 
     if (!filterResult) {
@@ -485,10 +497,10 @@ SkBlurMaskFilterImpl::filterRRectToNine(const SkRRect& rrect, const SkMatrix& ma
     // Now figure out the appropriate width and height of the smaller round rectangle
     // to stretch. It will take into account the larger radius per side as well as double
     // the margin, to account for inner and outer blur.
-    const SkVector& UL = rrect.radii(SkRRect::kUpperLeft_Corner);
-    const SkVector& UR = rrect.radii(SkRRect::kUpperRight_Corner);
-    const SkVector& LR = rrect.radii(SkRRect::kLowerRight_Corner);
-    const SkVector& LL = rrect.radii(SkRRect::kLowerLeft_Corner);
+    const SkVector UL = quantize_ninepatch_radii(rrect.radii(SkRRect::kUpperLeft_Corner));
+    const SkVector UR = quantize_ninepatch_radii(rrect.radii(SkRRect::kUpperRight_Corner));
+    const SkVector LR = quantize_ninepatch_radii(rrect.radii(SkRRect::kLowerRight_Corner));
+    const SkVector LL = quantize_ninepatch_radii(rrect.radii(SkRRect::kLowerLeft_Corner));
 
     const SkScalar leftUnstretched = SkTMax(UL.fX, LL.fX) + SkIntToScalar(2 * margin.fX);
     const SkScalar rightUnstretched = SkTMax(UR.fX, LR.fX) + SkIntToScalar(2 * margin.fX);
@@ -522,13 +534,12 @@ SkBlurMaskFilterImpl::filterRRectToNine(const SkRRect& rrect, const SkMatrix& ma
     radii[SkRRect::kLowerLeft_Corner] = LL;
     smallRR.setRectRadii(smallR, radii);
 
-    const SkScalar sigma = this->computeXformedSigma(matrix);
     SkCachedData* cache = find_cached_rrect(&patch->fMask, sigma, fBlurStyle, smallRR);
     if (!cache) {
         bool analyticBlurWorked = false;
         if (c_analyticBlurRRect) {
             analyticBlurWorked =
-                this->filterRRectMask(&patch->fMask, smallRR, matrix, &margin,
+                this->filterRRectMask(&patch->fMask, smallRR, sigma, &margin,
                                       SkMask::kComputeBoundsAndRenderImage_CreateMode);
         }
 
@@ -539,7 +550,7 @@ SkBlurMaskFilterImpl::filterRRectToNine(const SkRRect& rrect, const SkMatrix& ma
 
             SkAutoMaskFreeImage amf(srcM.fImage);
 
-            if (!this->filterMask(&patch->fMask, srcM, matrix, &margin)) {
+            if (!SkBlurMask::BoxBlur(&patch->fMask, srcM, sigma, fBlurStyle, &margin)) {
                 return kFalse_FilterReturn;
             }
         }
@@ -579,6 +590,8 @@ SkBlurMaskFilterImpl::filterRectsToNine(const SkRect rects[], int count,
         return kUnimplemented_FilterReturn;
     }
 
+    const SkScalar sigma = quantize_ninepatch_sigma(this->computeXformedSigma(matrix));
+
     SkIPoint margin;
     SkMask  srcM, dstM;
     srcM.fBounds = rects[0].roundOut();
@@ -589,10 +602,10 @@ SkBlurMaskFilterImpl::filterRectsToNine(const SkRect rects[], int count,
     if (count == 1 && c_analyticBlurNinepatch) {
         // special case for fast rect blur
         // don't actually do the blur the first time, just compute the correct size
-        filterResult = this->filterRectMask(&dstM, rects[0], matrix, &margin,
+        filterResult = this->filterRectMask(&dstM, rects[0], sigma, &margin,
                                             SkMask::kJustComputeBounds_CreateMode);
     } else {
-        filterResult = this->filterMask(&dstM, srcM, matrix, &margin);
+        filterResult = SkBlurMask::BoxBlur(&dstM, srcM, sigma, fBlurStyle, &margin);
     }
 
     if (!filterResult) {
@@ -655,7 +668,6 @@ SkBlurMaskFilterImpl::filterRectsToNine(const SkRect rects[], int count,
         SkASSERT(!smallR[1].isEmpty());
     }
 
-    const SkScalar sigma = this->computeXformedSigma(matrix);
     SkCachedData* cache = find_cached_rects(&patch->fMask, sigma, fBlurStyle, smallR, count);
     if (!cache) {
         if (count > 1 || !c_analyticBlurNinepatch) {
@@ -665,11 +677,11 @@ SkBlurMaskFilterImpl::filterRectsToNine(const SkRect rects[], int count,
 
             SkAutoMaskFreeImage amf(srcM.fImage);
 
-            if (!this->filterMask(&patch->fMask, srcM, matrix, &margin)) {
+            if (!SkBlurMask::BoxBlur(&patch->fMask, srcM, sigma, fBlurStyle, &margin)) {
                 return kFalse_FilterReturn;
             }
         } else {
-            if (!this->filterRectMask(&patch->fMask, smallR[0], matrix, &margin,
+            if (!this->filterRectMask(&patch->fMask, smallR[0], sigma, &margin,
                                       SkMask::kComputeBoundsAndRenderImage_CreateMode)) {
                 return kFalse_FilterReturn;
             }
@@ -8,6 +8,7 @@
 #include "SkCachedData.h"
 #include "SkDiscardableMemory.h"
 #include "SkMalloc.h"
+#include "SkResourceCache.h"
 
 SkCachedData::SkCachedData(void* data, size_t size)
     : fData(data)
@@ -130,6 +131,7 @@ void SkCachedData::inMutexLock() {
                 SkASSERT(ptr);
                 this->setData(ptr);
             } else {
+                SkResourceCache::NotifyDiscardablePurged(fSize);
                 this->setData(nullptr);   // signal failure to lock, contents are gone
             }
             break;
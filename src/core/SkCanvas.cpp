@@ -168,7 +168,8 @@ void SkCanvas::predrawNotify(const SkRect* rect, const SkPaint* paint,
                 mode = SkSurface::kDiscard_ContentChangeMode;
             }
         }
-        fSurfaceBase->aboutToDraw(mode);
+        SkIRect storage;
+        fSurfaceBase->aboutToDraw(mode, this->computeDirtyBounds(rect, paint, &storage));
     }
 }
 
@@ -228,12 +229,19 @@ public:
     SkConservativeClip  fRasterClip;
     SkMatrix            fMatrix;
     int                 fDeferredSaveCount;
+    /*  Devices only keep clip state in their save stacks, so a level that only changes the
+        matrix doesn't need to save and restore them. This is false until the level's first clip
+        (see checkForDeferredDeviceSave()), and on restore tells whether the devices below need
+        restoring or just their matrix reset.
+    */
+    bool                fDevicesSaved;
 
     MCRec() {
         fLayer      = nullptr;
         fTopLayer   = nullptr;
         fMatrix.reset();
         fDeferredSaveCount = 0;
+        fDevicesSaved = true;
 
         // don't bother initializing fNext
         inc_rec();
@@ -242,6 +250,7 @@ public:
         fLayer = nullptr;
         fTopLayer = prev.fTopLayer;
         fDeferredSaveCount = 0;
+        fDevicesSaved = false;
 
         // don't bother initializing fNext
         inc_rec();
@@ -378,6 +387,26 @@ public:
             fPaint = paint;
         }
 
+        // An imagefilter that just offsets the source moves the draw by whole device pixels, so
+        // draw moved instead of through a layer.
+        SkVector offset;
+        if (!skipLayerForImageFilter && fPaint->getImageFilter() &&
+            fPaint->getImageFilter()->asAnOffset(&offset) &&
+            SkBlendMode::kSrcOver == fPaint->getBlendMode()) {
+            const SkMatrix& ctm = canvas->getTotalMatrix();
+            SkVector devOffset = ctm.mapVector(offset.fX, offset.fY);
+            SkMatrix moved = ctm;
+            moved.postTranslate(SkIntToScalar(SkScalarRoundToInt(devOffset.fX)),
+                                SkIntToScalar(SkScalarRoundToInt(devOffset.fY)));
+            if (moved.isFinite()) {
+                SkPaint* paint = set_if_needed(&fLazyPaintInit, fOrigPaint);
+                paint->setImageFilter(nullptr);
+                fPaint = paint;
+                fRestoreMatrix.set(ctm);
+                canvas->internalSetMatrix(moved);
+            }
+        }
+
         if (!skipLayerForImageFilter && fPaint->getImageFilter()) {
             /**
              *  We implement ImageFilters for a given draw by creating a layer, then applying the
@@ -422,6 +451,9 @@ public:
         if (fTempLayerForImageFilter) {
             fCanvas->internalRestore();
         }
+        if (fRestoreMatrix.isValid()) {
+            fCanvas->internalSetMatrix(*fRestoreMatrix.get());
+        }
         SkASSERT(fCanvas->getSaveCount() == fSaveCount);
     }
 
@@ -445,6 +477,7 @@ public:
 private:
     SkLazyPaint     fLazyPaintInit;       // base paint storage in case we need to modify it
     SkLazyPaint     fLazyPaintPerLooper;  // per-draw-looper storage, so the looper can modify it
+    SkTLazy<SkMatrix> fRestoreMatrix;     // the CTM to put back after a draw moved by an offset
     SkCanvas*       fCanvas;
     const SkPaint&  fOrigPaint;
     const SkPaint*  fPaint;
@@ -486,23 +519,51 @@ bool AutoDrawLooper::doNext() {
     return true;
 }
 
+const SkIRect* SkCanvas::computeDirtyBounds(const SkRect* bounds, const SkPaint* paint,
+                                            SkIRect* storage) const {
+    if (!fSurfaceBase->tracksContentChanges()) {
+        return nullptr;
+    }
+    *storage = fMCRec->fRasterClip.getBounds();
+    if (bounds && paint && paint->canComputeFastBounds() && !fMCRec->fMatrix.hasPerspective()) {
+        // Stroke bounds, as points are drawn with the stroke width whatever the paint's style.
+        SkRect tmp, devBounds;
+        fMCRec->fMatrix.mapRect(&devBounds, paint->computeFastStrokeBounds(*bounds, &tmp));
+        if (devBounds.isFinite()) {
+            // Outset for antialiasing.
+            if (!storage->intersect(devBounds.roundOut().makeOutset(1, 1))) {
+                storage->setEmpty();
+            }
+        }
+    }
+    return storage;
+}
+
+void SkCanvas::predrawNotify(const SkRect* bounds, const SkPaint& paint) {
+    if (fSurfaceBase) {
+        SkIRect storage;
+        fSurfaceBase->aboutToDraw(SkSurface::kRetain_ContentChangeMode,
+                                  this->computeDirtyBounds(bounds, &paint, &storage));
+    }
+}
+
 ////////// macros to place around the internal draw calls //////////////////
 
 #define LOOPER_BEGIN_DRAWBITMAP(paint, skipLayerForFilter, bounds)  \
-    this->predrawNotify();                                          \
+    this->predrawNotify(bounds, paint);                             \
     AutoDrawLooper looper(this, paint, skipLayerForFilter, bounds); \
     while (looper.next()) {                                         \
         SkDrawIter iter(this);
 
 
 #define LOOPER_BEGIN_DRAWDEVICE(paint)                              \
-    this->predrawNotify();                                          \
+    this->predrawNotify(nullptr, paint);                            \
     AutoDrawLooper  looper(this, paint, true);                      \
     while (looper.next()) {                                         \
         SkDrawIter          iter(this);
 
 #define LOOPER_BEGIN(paint, bounds)                                 \
-    this->predrawNotify();                                          \
+    this->predrawNotify(bounds, paint);                             \
     AutoDrawLooper  looper(this, paint, false, bounds);             \
     while (looper.next()) {                                         \
         SkDrawIter          iter(this);
@@ -759,6 +820,13 @@ void SkCanvas::checkForDeferredSave() {
     }
 }
 
+void SkCanvas::checkForDeferredDeviceSave() {
+    if (!fMCRec->fDevicesSaved) {
+        fMCRec->fDevicesSaved = true;
+        FOR_EACH_TOP_DEVICE(device->save());
+    }
+}
+
 int SkCanvas::getSaveCount() const {
 #ifdef SK_DEBUG
     int count = 0;
@@ -822,8 +890,7 @@ void SkCanvas::internalSave() {
     MCRec* newTop = (MCRec*)fMCStack.push_back();
     new (newTop) MCRec(*fMCRec);    // balanced in restore()
     fMCRec = newTop;
-
-    FOR_EACH_TOP_DEVICE(device->save());
+    // The devices are saved by checkForDeferredDeviceSave(), if this level clips.
 }
 
 bool SkCanvas::BoundsAffectsClip(SaveLayerFlags saveLayerFlags) {
@@ -1005,6 +1072,8 @@ void SkCanvas::internalSaveLayer(const SaveLayerRec& rec, SaveLayerStrategy stra
     // do this before we create the layer. We don't call the public save() since
     // that would invoke a possibly overridden virtual
     this->internalSave();
+    // The devices below may be clipped when the layer is added, so save them now.
+    this->checkForDeferredDeviceSave();
 
     SkIRect ir;
     if (!this->clipRectBounds(bounds, saveLayerFlags, &ir, imageFilter)) {
@@ -1097,6 +1166,7 @@ void SkCanvas::internalRestore() {
     DeviceCM* layer = fMCRec->fLayer;   // may be null
     // now detach it from fMCRec so we can pop(). Gets freed after its drawn
     fMCRec->fLayer = nullptr;
+    const bool devicesSaved = fMCRec->fDevicesSaved;
 
     // now do the normal restore()
     fMCRec->~MCRec();       // balanced in save()
@@ -1104,7 +1174,11 @@ void SkCanvas::internalRestore() {
     fMCRec = (MCRec*)fMCStack.back();
 
     if (fMCRec) {
-        FOR_EACH_TOP_DEVICE(device->restore(fMCRec->fMatrix));
+        if (devicesSaved) {
+            FOR_EACH_TOP_DEVICE(device->restore(fMCRec->fMatrix));
+        } else {
+            FOR_EACH_TOP_DEVICE(device->setGlobalCTM(fMCRec->fMatrix));
+        }
     }
 
     /*  Time to draw the layer's offscreen. We can't call the public drawSprite,
@@ -1323,6 +1397,7 @@ void SkCanvas::clipRect(const SkRect& rect, SkClipOp op, bool doAA) {
 void SkCanvas::onClipRect(const SkRect& rect, SkClipOp op, ClipEdgeStyle edgeStyle) {
     const bool isAA = kSoft_ClipEdgeStyle == edgeStyle;
 
+    this->checkForDeferredDeviceSave();
     FOR_EACH_TOP_DEVICE(device->clipRect(rect, op, isAA));
 
     AutoValidateClip avc(this);
@@ -1339,6 +1414,7 @@ void SkCanvas::androidFramework_setDeviceClipRestriction(const SkIRect& rect) {
         FOR_EACH_TOP_DEVICE(device->androidFramework_setDeviceClipRestriction(&fClipRestrictionRect));
     } else {
         this->checkForDeferredSave();
+        this->checkForDeferredDeviceSave();
         FOR_EACH_TOP_DEVICE(device->androidFramework_setDeviceClipRestriction(&fClipRestrictionRect));
         AutoValidateClip avc(this);
         fMCRec->fRasterClip.opIRect(fClipRestrictionRect, SkRegion::kIntersect_Op);
@@ -1361,6 +1437,7 @@ void SkCanvas::onClipRRect(const SkRRect& rrect, SkClipOp op, ClipEdgeStyle edge
 
     bool isAA = kSoft_ClipEdgeStyle == edgeStyle;
 
+    this->checkForDeferredDeviceSave();
     FOR_EACH_TOP_DEVICE(device->clipRRect(rrect, op, isAA));
 
     fMCRec->fRasterClip.opRRect(rrect, fMCRec->fMatrix, this->getTopLayerBounds(), (SkRegion::Op)op,
@@ -1398,6 +1475,7 @@ void SkCanvas::onClipPath(const SkPath& path, SkClipOp op, ClipEdgeStyle edgeSty
 
     bool isAA = kSoft_ClipEdgeStyle == edgeStyle;
 
+    this->checkForDeferredDeviceSave();
     FOR_EACH_TOP_DEVICE(device->clipPath(path, op, isAA));
 
     const SkPath* rasterClipPath = &path;
@@ -1413,6 +1491,7 @@ void SkCanvas::clipRegion(const SkRegion& rgn, SkClipOp op) {
 }
 
 void SkCanvas::onClipRegion(const SkRegion& rgn, SkClipOp op) {
+    this->checkForDeferredDeviceSave();
     FOR_EACH_TOP_DEVICE(device->clipRegion(rgn, op));
 
     AutoValidateClip avc(this);
@@ -1800,7 +1879,22 @@ void SkCanvas::experimental_DrawImageSetV1(const ImageSetEntry imageSet[], int c
     RETURN_ON_NULL(imageSet);
     RETURN_ON_FALSE(cnt);
 
-    this->onDrawImageSet(imageSet, cnt, filterQuality, mode);
+    this->onDrawImageSet(imageSet, cnt, nullptr, filterQuality, mode);
+}
+
+void SkCanvas::experimental_DrawImageSetV2(const ImageSetEntry imageSet[], int cnt,
+                                           const SkMatrix preViewMatrices[],
+                                           SkFilterQuality filterQuality, SkBlendMode mode) {
+    TRACE_EVENT0("skia", TRACE_FUNC);
+    RETURN_ON_NULL(imageSet);
+    RETURN_ON_FALSE(cnt);
+#ifdef SK_DEBUG
+    for (int i = 0; i < cnt; ++i) {
+        SkASSERT(imageSet[i].fMatrixIndex < 0 || preViewMatrices);
+    }
+#endif
+
+    this->onDrawImageSet(imageSet, cnt, preViewMatrices, filterQuality, mode);
 }
 
 void SkCanvas::drawBitmap(const SkBitmap& bitmap, SkScalar dx, SkScalar dy, const SkPaint* paint) {
@@ -1913,9 +2007,8 @@ void SkCanvas::private_draw_shadow_rec(const SkPath& path, const SkDrawShadowRec
 
 void SkCanvas::onDrawShadowRec(const SkPath& path, const SkDrawShadowRec& rec) {
     SkPaint paint;
-    const SkRect& pathBounds = path.getBounds();
-
-    LOOPER_BEGIN(paint, &pathBounds)
+    // The shadow reaches past the path, and paint has nothing for a layer to bound.
+    LOOPER_BEGIN(paint, nullptr)
     while (iter.next()) {
         iter.fDevice->drawShadow(path, rec);
     }
@@ -2134,7 +2227,8 @@ void SkCanvas::onDrawPath(const SkPath& path, const SkPaint& paint) {
         }
     }
 
-    LOOPER_BEGIN(paint, &pathBounds)
+    // Inverse fills reach past their bounds.
+    LOOPER_BEGIN(paint, path.isInverseFillType() ? nullptr : &pathBounds)
 
     while (iter.next()) {
         iter.fDevice->drawPath(path, looper.paint());
@@ -2405,11 +2499,12 @@ void SkCanvas::onDrawImageLattice(const SkImage* image, const Lattice& lattice,
 }
 
 void SkCanvas::onDrawImageSet(const ImageSetEntry imageSet[], int count,
-                              SkFilterQuality filterQuality, SkBlendMode mode) {
+                              const SkMatrix preViewMatrices[], SkFilterQuality filterQuality,
+                              SkBlendMode mode) {
     SkPaint paint;
     LOOPER_BEGIN(paint, nullptr)
     while (iter.next()) {
-        iter.fDevice->drawImageSet(imageSet, count, filterQuality, mode);
+        iter.fDevice->drawImageSet(imageSet, count, preViewMatrices, filterQuality, mode);
     }
     LOOPER_END
 }
@@ -2652,6 +2747,7 @@ void SkCanvas::drawDrawable(SkDrawable* dr, const SkMatrix* matrix) {
 void SkCanvas::onDrawDrawable(SkDrawable* dr, const SkMatrix* matrix) {
     // drawable bounds are no longer reliable (e.g. android displaylist)
     // so don't use them for quick-reject
+    this->predrawNotify();
     this->getDevice()->drawDrawable(dr, matrix, this);
 }
 
@@ -2787,6 +2883,11 @@ void SkCanvas::onDrawPicture(const SkPicture* picture, const SkMatrix* matrix,
         }
     }
 
+    this->predrawNotify();
+    if (this->getTopDevice()->drawCachedPicture(picture, matrix, paint)) {
+        return;
+    }
+
     SkAutoCanvasMatrixPaint acmp(this, matrix, paint, picture->cullRect());
     picture->playback(this);
 }
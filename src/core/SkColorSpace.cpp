@@ -8,6 +8,8 @@
 #include "SkColorSpace.h"
 #include "SkColorSpacePriv.h"
 #include "SkData.h"
+#include "SkLRUCache.h"
+#include "SkMutex.h"
 #include "SkOpts.h"
 #include "../../third_party/skcms/skcms.h"
 
@@ -272,7 +274,110 @@ void SkColorSpace::toProfile(skcms_ICCProfile* profile) const {
     skcms_SetXYZD50          (profile, &toXYZD50);
 }
 
+namespace {
+
+// Everything SkColorSpace::Make() and skcms_Transform() look at in a profile with parametric
+// curves and a matrix.  Images that embed the same profile get the same key.
+struct ProfileKey {
+    uint32_t               fDataColorSpace;
+    skcms_Matrix3x3        fToXYZD50;
+    skcms_TransferFunction fTRC[3];
+
+    bool operator==(const ProfileKey& that) const {
+        return 0 == memcmp(this, &that, sizeof(*this));
+    }
+};
+
+struct ProfilePairKey {
+    ProfileKey fA, fB;
+
+    bool operator==(const ProfilePairKey& that) const {
+        return fA == that.fA && fB == that.fB;
+    }
+};
+
+}  // namespace
+
+// Profiles with tables or an A2B transform aren't keyed; they're rare enough not to cache.
+static bool make_profile_key(const skcms_ICCProfile& profile, ProfileKey* key) {
+    if (!profile.has_toXYZD50 || !profile.has_trc || profile.has_A2B) {
+        return false;
+    }
+    memset(key, 0, sizeof(*key));
+    key->fDataColorSpace = profile.data_color_space;
+    key->fToXYZD50       = profile.toXYZD50;
+    for (int i = 0; i < 3; i++) {
+        if (profile.trc[i].table_entries != 0) {
+            return false;
+        }
+        key->fTRC[i] = profile.trc[i].parametric;
+    }
+    return true;
+}
+
+// Both caches are small: most processes only see a handful of distinct profiles.
+static constexpr int kProfileCacheCount = 32;
+
+SK_DECLARE_STATIC_MUTEX(gProfileCacheMutex);
+
+static SkLRUCache<ProfileKey, sk_sp<SkColorSpace>>* color_space_cache() {
+    gProfileCacheMutex.assertHeld();
+    static auto* cache = new SkLRUCache<ProfileKey, sk_sp<SkColorSpace>>(kProfileCacheCount);
+    return cache;
+}
+
+static SkLRUCache<ProfilePairKey, bool>* equal_profiles_cache() {
+    gProfileCacheMutex.assertHeld();
+    static auto* cache = new SkLRUCache<ProfilePairKey, bool>(kProfileCacheCount);
+    return cache;
+}
+
+bool sk_approximately_equal_profiles(const skcms_ICCProfile* a, const skcms_ICCProfile* b) {
+    ProfilePairKey key;
+    if (a == b || !make_profile_key(*a, &key.fA) || !make_profile_key(*b, &key.fB)) {
+        return skcms_ApproximatelyEqualProfiles(a, b);
+    }
+    {
+        SkAutoMutexAcquire lock(gProfileCacheMutex);
+        if (bool* equal = equal_profiles_cache()->find(key)) {
+            return *equal;
+        }
+    }
+    bool equal = skcms_ApproximatelyEqualProfiles(a, b);
+
+    SkAutoMutexAcquire lock(gProfileCacheMutex);
+    if (!equal_profiles_cache()->find(key)) {
+        equal_profiles_cache()->insert(key, equal);
+    }
+    return equal;
+}
+
+static sk_sp<SkColorSpace> make_uncached(const skcms_ICCProfile& profile);
+
 sk_sp<SkColorSpace> SkColorSpace::Make(const skcms_ICCProfile& profile) {
+    // Interning by profile makes decoding many images with the same embedded profile cheap,
+    // and lets them share an SkColorSpace (so Equals() returns early).
+    ProfileKey key;
+    if (!make_profile_key(profile, &key)) {
+        return make_uncached(profile);
+    }
+    {
+        SkAutoMutexAcquire lock(gProfileCacheMutex);
+        if (sk_sp<SkColorSpace>* cs = color_space_cache()->find(key)) {
+            return *cs;
+        }
+    }
+    sk_sp<SkColorSpace> cs = make_uncached(profile);
+
+    SkAutoMutexAcquire lock(gProfileCacheMutex);
+    if (sk_sp<SkColorSpace>* cached = color_space_cache()->find(key)) {
+        return *cached;  // Another thread got here first.
+    }
+    color_space_cache()->insert(key, cs);
+    return cs;
+}
+
+static sk_sp<SkColorSpace> make_uncached(const skcms_ICCProfile& profile) {
     // TODO: move below ≈sRGB test?
     if (!profile.has_toXYZD50 || !profile.has_trc) {
         return nullptr;
@@ -12,6 +12,8 @@
 #include "SkColorSpace.h"
 #include "SkFixed.h"
 
+struct skcms_ICCProfile;
+
 #define SkColorSpacePrintf(...)
 
 static constexpr float gSRGB_toXYZD50[] {
@@ -192,4 +194,8 @@ static inline bool is_almost_linear(const SkColorSpaceTransferFn& coeffs) {
 SkColorSpace* sk_srgb_singleton();
 SkColorSpace* sk_srgb_linear_singleton();
 
+// As skcms_ApproximatelyEqualProfiles(), but remembers the answer for recently compared pairs
+// of common (parametric) profiles, so decoding many images with the same profile compares once.
+bool sk_approximately_equal_profiles(const skcms_ICCProfile*, const skcms_ICCProfile*);
+
 #endif  // SkColorSpacePriv_DEFINED
@@ -172,7 +172,8 @@ public:
         }
     }
     void onDrawImageSet(const SkCanvas::ImageSetEntry set[], int count,
-                        SkFilterQuality filterQuality, SkBlendMode mode) override {
+                        const SkMatrix preViewMatrices[], SkFilterQuality filterQuality,
+                        SkBlendMode mode) override {
         SkAutoTArray<ImageSetEntry> xformedSet(count);
         for (int i = 0; i < count; ++i) {
             xformedSet[i].fImage = this->prepareImage(set[i].fImage.get());
@@ -180,8 +181,10 @@ public:
             xformedSet[i].fDstRect = set[i].fDstRect;
             xformedSet[i].fAlpha = set[i].fAlpha;
             xformedSet[i].fAAFlags = set[i].fAAFlags;
+            xformedSet[i].fMatrixIndex = set[i].fMatrixIndex;
         }
-        fTarget->experimental_DrawImageSetV1(xformedSet.get(), count, filterQuality, mode);
+        fTarget->experimental_DrawImageSetV2(xformedSet.get(), count, preViewMatrices,
+                                             filterQuality, mode);
     }
 
     void onDrawAtlas(const SkImage* atlas, const SkRSXform* xforms, const SkRect* tex,
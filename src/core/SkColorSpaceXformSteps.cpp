@@ -7,6 +7,7 @@
 
 #include "SkColorSpaceXformSteps.h"
 #include "SkColorSpacePriv.h"
+#include "SkMutex.h"
 #include "SkRasterPipeline.h"
 #include "../../third_party/skcms/skcms.h"
 
@@ -174,3 +175,48 @@ void SkColorSpaceXformSteps::apply(SkRasterPipeline* p, bool src_is_normalized)
     }
     if (flags.premul) { p->append(SkRasterPipeline::premul); }
 }
+
+bool SkColorSpaceXformSteps::byteTable(uint8_t table[256]) const {
+    if (flags.unpremul || flags.gamut_transform || flags.premul ||
+        !(flags.linearize || flags.encode)) {
+        return false;
+    }
+
+    struct Entry {
+        Flags                  flags;
+        SkColorSpaceTransferFn srcTF,
+                               dstTFInv;
+        uint8_t                table[256];
+    };
+    auto matches = [this](const Entry& e) {
+        return e.flags.mask() == flags.mask() &&
+               (!flags.linearize || 0 == memcmp(&e.srcTF,    &srcTF,    sizeof(srcTF))) &&
+               (!flags.encode    || 0 == memcmp(&e.dstTFInv, &dstTFInv, sizeof(dstTFInv)));
+    };
+
+    static SkMutex gMutex;
+    static Entry   gCache[4];
+    static int     gCount = 0,  // How many entries of gCache are filled in,
+                   gNext  = 0;  // and which to replace next.
+    SkAutoMutexAcquire lock(gMutex);
+    for (int i = 0; i < gCount; i++) {
+        if (matches(gCache[i])) {
+            memcpy(table, gCache[i].table, 256);
+            return true;
+        }
+    }
+
+    Entry& e = gCache[gNext];
+    gNext  = (gNext + 1) % SK_ARRAY_COUNT(gCache);
+    gCount = SkTMin(gCount + 1, (int)SK_ARRAY_COUNT(gCache));
+    e.flags    = flags;
+    e.srcTF    = srcTF;
+    e.dstTFInv = dstTFInv;
+    for (int i = 0; i < 256; i++) {
+        float rgba[4] = { i * (1/255.0f), 0, 0, 1 };
+        this->apply(rgba);
+        e.table[i] = (uint8_t)(SkTPin(rgba[0], 0.0f, 1.0f) * 255 + 0.5f);
+    }
+    memcpy(table, e.table, 256);
+    return true;
+}
@@ -40,6 +40,11 @@ struct SkColorSpaceXformSteps {
         this->apply(p, srcCT < kRGBA_F16_SkColorType);
     }
 
+    // If these steps only change the transfer function, leaving gamut and alpha alone, each
+    // 8-bit color channel maps on its own: fill table with what each value maps to and return
+    // true. Recently built tables are cached, so this is cheap to call for every conversion.
+    bool byteTable(uint8_t table[256]) const;
+
     Flags flags;
 
     bool srcTF_is_sRGB,
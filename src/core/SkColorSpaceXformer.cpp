@@ -5,6 +5,7 @@
  * found in the LICENSE file.
  */
 
+#include "SkBitmapCache.h"
 #include "SkColorFilter.h"
 #include "SkColorSpacePriv.h"
 #include "SkColorSpaceXformer.h"
@@ -14,6 +15,8 @@
 #include "SkImage_Base.h"
 #include "SkImageFilter.h"
 #include "SkImagePriv.h"
+#include "SkPixelRef.h"
+#include "SkResourceCache.h"
 #include "SkShaderBase.h"
 
 SkColorSpaceXformer::SkColorSpaceXformer(sk_sp<SkColorSpace> dst)
@@ -33,6 +36,77 @@ SkColorSpaceXformer::SkColorSpaceXformer(sk_sp<SkColorSpace> dst)
 
 SkColorSpaceXformer::~SkColorSpaceXformer() {}
 
+// Transformed images are also kept in SkResourceCache, keyed by the source's unique ID and the
+// destination color space, so that an image drawn again and again (e.g. tiles or sprites), by
+// any xformer, is only transformed once. Entries are purged with the source's pixels.
+namespace {
+static unsigned gXformedImageKeyNamespaceLabel;
+
+struct XformedImageKey : public SkResourceCache::Key {
+public:
+    XformedImageKey(uint32_t imageID, const SkColorSpace& dst)
+        : fDstHash_lo((uint32_t)dst.hash())
+        , fDstHash_hi((uint32_t)(dst.hash() >> 32))
+    {
+        this->init(&gXformedImageKeyNamespaceLabel, SkMakeResourceCacheSharedIDForBitmap(imageID),
+                   sizeof(fDstHash_lo) + sizeof(fDstHash_hi));
+    }
+
+    uint32_t fDstHash_lo;
+    uint32_t fDstHash_hi;
+};
+
+struct XformedImageRec : public SkResourceCache::Rec {
+    XformedImageRec(const XformedImageKey& key, sk_sp<SkImage> image)
+        : fKey(key), fImage(std::move(image)) {}
+
+    XformedImageKey fKey;
+    sk_sp<SkImage>  fImage;
+
+    const Key& getKey() const override { return fKey; }
+    size_t bytesUsed() const override {
+        SkPixmap pixmap;
+        return sizeof(*this) + (fImage->peekPixels(&pixmap) ? pixmap.computeByteSize() : 0);
+    }
+    const char* getCategory() const override { return "color-xformed-image"; }
+    SkDiscardableMemory* diagnostic_only_getDiscardable() const override { return nullptr; }
+
+    static bool Visitor(const SkResourceCache::Rec& baseRec, void* contextData) {
+        const XformedImageRec& rec = static_cast<const XformedImageRec&>(baseRec);
+        *static_cast<sk_sp<SkImage>*>(contextData) = rec.fImage;
+        return true;
+    }
+};
+} // namespace
+
+// The entry is purged when 'src' is deleted, or if 'pixelRef' is not null, when its pixels change
+// or are deleted (then 'src' must be a temporary image of them, with their generation ID).
+static sk_sp<SkImage> make_color_space_cached(const SkImage* src, sk_sp<SkColorSpace> dst,
+                                              SkPixelRef* pixelRef = nullptr) {
+    // Texture-backed images belong to their GrContext, not to the global cache.
+    if (src->isTextureBacked()) {
+        return src->makeColorSpace(std::move(dst));
+    }
+
+    XformedImageKey key(src->uniqueID(), *dst);
+    sk_sp<SkImage> xformed;
+    if (SkResourceCache::Find(key, XformedImageRec::Visitor, &xformed)) {
+        return xformed;
+    }
+    xformed = src->makeColorSpace(std::move(dst));
+    if (xformed && xformed.get() != src) {
+        SkResourceCache::Add(new XformedImageRec(key, xformed));
+        if (pixelRef) {
+            pixelRef->notifyAddedToCache();
+        } else {
+            // Not the raster override: that ties the entry to the pixels' generation ID, which
+            // need not be this image's unique ID.
+            as_IB(src)->SkImage_Base::notifyAddedToRasterCache();
+        }
+    }
+    return xformed;
+}
+
 std::unique_ptr<SkColorSpaceXformer> SkColorSpaceXformer::Make(sk_sp<SkColorSpace> dst) {
     return std::unique_ptr<SkColorSpaceXformer>(new SkColorSpaceXformer{std::move(dst)});
 }
@@ -101,7 +175,7 @@ sk_sp<SkImage> SkColorSpaceXformer::apply(const SkImage* src) {
     const AutoCachePurge autoPurge(this);
     return this->cachedApply<SkImage>(src, &fImageCache,
         [](const SkImage* img, SkColorSpaceXformer* xformer) {
-            return img->makeColorSpace(xformer->fDst);
+            return make_color_space_cached(img, xformer->fDst);
         });
 }
 
@@ -112,7 +186,11 @@ sk_sp<SkImage> SkColorSpaceXformer::apply(const SkBitmap& src) {
         return nullptr;
     }
 
-    sk_sp<SkImage> xformed = image->makeColorSpace(fDst);
+    // Mutable pixels may change without a new generation ID, so only immutable ones are cached.
+    // An image of a subset gets a new unique ID each time, and isn't worth caching either.
+    const bool cacheable = src.isImmutable() && image->uniqueID() == src.getGenerationID();
+    sk_sp<SkImage> xformed = cacheable ? make_color_space_cached(image.get(), fDst, src.pixelRef())
+                                       : image->makeColorSpace(fDst);
     // We want to be sure we don't let the kNever_SkCopyPixelsMode image escape this stack frame.
     SkASSERT(xformed != image);
     return xformed;
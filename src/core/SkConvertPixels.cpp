@@ -13,6 +13,26 @@
 #include "SkImageInfoPriv.h"
 #include "SkOpts.h"
 #include "SkRasterPipeline.h"
+#include "SkTaskGroup.h"
+
+// Conversions of at least this many pixels are split into bands of rows, which are converted in
+// parallel on the default SkExecutor.
+static constexpr int64_t kMinPixelsPerBand = 1 << 18;
+
+// Calls fn(y, rows) for bands of rows which together cover info's height.
+template <typename Fn>
+static void for_each_band(const SkImageInfo& info, Fn&& fn) {
+    int64_t bands = SkTMin<int64_t>(info.height(),
+                                    (int64_t)info.width() * info.height() / kMinPixelsPerBand);
+    if (bands <= 1) {
+        fn(0, info.height());
+        return;
+    }
+    int rowsPerBand = (info.height() + bands - 1) / bands;
+    SkTaskGroup().parallelFor(info.height(), rowsPerBand, [&](int top, int bottom) {
+        fn(top, bottom - top);
+    });
+}
 
 static bool rect_memcpy(const SkImageInfo& dstInfo,       void* dstPixels, size_t dstRB,
                         const SkImageInfo& srcInfo, const void* srcPixels, size_t srcRB,
@@ -159,6 +179,41 @@ static bool convert_to_alpha8(const SkImageInfo& dstInfo,       void* vdst, size
     return false;
 }
 
+// 8888 whose transfer function changes, but not its gamut or alpha: each color channel is mapped
+// independently, so one table lookup per channel does it all.
+static bool convert_with_byte_table(const SkImageInfo& dstInfo,       void* dstPixels, size_t dstRB,
+                                    const SkImageInfo& srcInfo, const void* srcPixels, size_t srcRB,
+                                    const SkColorSpaceXformSteps& steps) {
+    auto is_8888 = [](SkColorType ct) {
+        return ct == kRGBA_8888_SkColorType || ct == kBGRA_8888_SkColorType;
+    };
+    uint8_t table[256];
+    if (!is_8888(dstInfo.colorType()) ||
+        !is_8888(srcInfo.colorType()) ||
+        !steps.byteTable(table)) {
+        return false;
+    }
+
+    // Red and blue share a table, so swapping them is just a matter of where they're stored.
+    const int rShift = dstInfo.colorType() == srcInfo.colorType() ? 0 : 16,
+              bShift = 16 - rShift;
+
+    for_each_band(dstInfo, [&](int y, int rows) {
+        for (int j = y; j < y + rows; j++) {
+            auto dst = SkTAddOffset<      uint32_t>(dstPixels, j * dstRB);
+            auto src = SkTAddOffset<const uint32_t>(srcPixels, j * srcRB);
+            for (int x = 0; x < dstInfo.width(); x++) {
+                uint32_t c = src[x];
+                dst[x] = (uint32_t)table[(c >>  0) & 0xFF] << rShift
+                       | (uint32_t)table[(c >>  8) & 0xFF] <<  8
+                       | (uint32_t)table[(c >> 16) & 0xFF] << bShift
+                       | (c & 0xFF000000);
+            }
+        }
+    });
+    return true;
+}
+
 // Default: Use the pipeline.
 static void convert_with_pipeline(const SkImageInfo& dstInfo, void* dstRow, size_t dstRB,
                                   const SkImageInfo& srcInfo, const void* srcRow, size_t srcRB,
@@ -187,7 +242,9 @@ static void convert_with_pipeline(const SkImageInfo& dstInfo, void* dstRow, size
     }
 
     pipeline.append_store(dstInfo.colorType(), &dst);
-    pipeline.run(0,0, srcInfo.width(), srcInfo.height());
+    for_each_band(dstInfo, [&](int y, int rows) {
+        pipeline.run(0,y, srcInfo.width(), rows);
+    });
 }
 
 void SkConvertPixels(const SkImageInfo& dstInfo,       void* dstPixels, size_t dstRB,
@@ -198,7 +255,7 @@ void SkConvertPixels(const SkImageInfo& dstInfo,       void* dstPixels, size_t d
     SkColorSpaceXformSteps steps{srcInfo.colorSpace(), srcInfo.alphaType(),
                                  dstInfo.colorSpace(), dstInfo.alphaType()};
 
-    for (auto fn : {rect_memcpy, swizzle_or_premul, convert_to_alpha8}) {
+    for (auto fn : {rect_memcpy, swizzle_or_premul, convert_to_alpha8, convert_with_byte_table}) {
         if (fn(dstInfo, dstPixels, dstRB, srcInfo, srcPixels, srcRB, steps)) {
             return;
         }
@@ -8,8 +8,16 @@
 #include "SkDeferredDisplayList.h"
 
 #include "SkCanvas.h"
+#include "SkData.h"
+#include "SkDeferredDisplayListPriv.h"
+#include "SkPicture.h"
+#include "SkStream.h"
 #include "SkSurface.h"
 
+#if SK_SUPPORT_GPU
+#include "GrRenderTargetOpList.h"
+#endif
+
 SkDeferredDisplayList::SkDeferredDisplayList(const SkSurfaceCharacterization& characterization,
                                              sk_sp<LazyProxyData> lazyProxyData)
         : fCharacterization(characterization)
@@ -18,3 +26,55 @@ SkDeferredDisplayList::SkDeferredDisplayList(const SkSurfaceCharacterization& ch
 
 SkDeferredDisplayList::~SkDeferredDisplayList() {
 }
+
+// A serialized display list is this header followed by the serialized picture of its draws.
+struct SerializedDDLHeader {
+    uint32_t fMagic;
+    uint32_t fVersion;
+    int32_t  fWidth;
+    int32_t  fHeight;
+};
+static constexpr uint32_t kSerializedDDLMagic   = SkSetFourByteTag('s', 'D', 'D', 'L');
+static constexpr uint32_t kSerializedDDLVersion = 1;
+
+sk_sp<SkData> SkDeferredDisplayList::serialize(const SkSerialProcs* procs) const {
+    if (!fPicture) {
+        return nullptr;
+    }
+
+    SerializedDDLHeader header = { kSerializedDDLMagic, kSerializedDDLVersion,
+                                   fCharacterization.width(), fCharacterization.height() };
+    SkDynamicMemoryWStream stream;
+    stream.write(&header, sizeof(header));
+    fPicture->serialize(&stream, procs);
+    return stream.detachAsData();
+}
+
+sk_sp<SkPicture> SkDeferredDisplayList::Deserialize(const void* data, size_t length,
+                                                    SkISize* dimensions,
+                                                    const SkDeserialProcs* procs) {
+    SerializedDDLHeader header;
+    if (!data || length < sizeof(header)) {
+        return nullptr;
+    }
+    memcpy(&header, data, sizeof(header));
+    if (header.fMagic != kSerializedDDLMagic || header.fVersion != kSerializedDDLVersion) {
+        return nullptr;
+    }
+
+    *dimensions = SkISize::Make(header.fWidth, header.fHeight);
+    return SkPicture::MakeFromData(SkTAddOffset<const void>(data, sizeof(header)),
+                                   length - sizeof(header), procs);
+}
+
+int SkDeferredDisplayListPriv::numOpChains() const {
+    int count = 0;
+#if SK_SUPPORT_GPU
+    for (const sk_sp<GrOpList>& opList : fDDL->fOpLists) {
+        if (GrRenderTargetOpList* rtOpList = opList->asRenderTargetOpList()) {
+            count += rtOpList->numOpChains();
+        }
+    }
+#endif
+    return count;
+}
@@ -23,6 +23,10 @@ public:
 #endif
     }
 
+    // Number of non-empty op chains in the DDL's render target opLists. The ops in a chain are
+    // executed together, so this is roughly the number of draws replaying the DDL will issue.
+    int numOpChains() const;
+
 private:
     explicit SkDeferredDisplayListPriv(SkDeferredDisplayList* ddl) : fDDL(ddl) {}
     SkDeferredDisplayListPriv(const SkDeferredDisplayListPriv&);            // unimpl
@@ -12,7 +12,9 @@
 #include "SkSurfaceCharacterization.h"
 
 #if !SK_SUPPORT_GPU
-SkDeferredDisplayListRecorder::SkDeferredDisplayListRecorder(const SkSurfaceCharacterization&) {}
+SkDeferredDisplayListRecorder::SkDeferredDisplayListRecorder(const SkSurfaceCharacterization&,
+                                                             Serializable serializable)
+        : fSerializable(serializable) {}
 
 SkDeferredDisplayListRecorder::~SkDeferredDisplayListRecorder() {}
 
@@ -22,6 +24,16 @@ SkCanvas* SkDeferredDisplayListRecorder::getCanvas() { return nullptr; }
 
 std::unique_ptr<SkDeferredDisplayList> SkDeferredDisplayListRecorder::detach() { return nullptr; }
 
+void SkDeferredDisplayListRecorder::setPromiseTextureBatchProcs(TextureBatchFulfillProc,
+                                                                TextureBatchReleaseProc,
+                                                                void*,
+                                                                SkExecutor*) {}
+
+bool SkDeferredDisplayListRecorder::playback(const void* data, size_t length,
+                                             const SkDeserialProcs* procs) {
+    return false;
+}
+
 sk_sp<SkImage> SkDeferredDisplayListRecorder::makePromiseTexture(
         const GrBackendFormat& backendFormat,
         int width,
@@ -63,11 +75,15 @@ sk_sp<SkImage> SkDeferredDisplayListRecorder::makeYUVAPromiseTexture(
 #include "SkGr.h"
 #include "SkImage_Gpu.h"
 #include "SkImage_GpuYUVA.h"
+#include "SkNWayCanvas.h"
+#include "SkPictureRecorder.h"
 #include "SkSurface_Gpu.h"
 #include "SkYUVASizeInfo.h"
 
-SkDeferredDisplayListRecorder::SkDeferredDisplayListRecorder(const SkSurfaceCharacterization& c)
-        : fCharacterization(c) {
+SkDeferredDisplayListRecorder::SkDeferredDisplayListRecorder(const SkSurfaceCharacterization& c,
+                                                             Serializable serializable)
+        : fCharacterization(c)
+        , fSerializable(serializable) {
     if (fCharacterization.isValid()) {
         fContext = GrContextPriv::MakeDDL(fCharacterization.refContextInfo());
     }
@@ -88,6 +104,10 @@ SkDeferredDisplayListRecorder::~SkDeferredDisplayListRecorder() {
         // same cached resource.
         proxyProvider->orphanAllUniqueKeys();
     }
+    if (fPromiseBatcher) {
+        // The batcher keeps the textures it made until they're detached.
+        fPromiseBatcher->detachTextures();
+    }
 }
 
 
@@ -173,7 +193,21 @@ bool SkDeferredDisplayListRecorder::init() {
                                                                  &fCharacterization.surfaceProps());
     fSurface = SkSurface_Gpu::MakeWrappedRenderTarget(fContext.get(),
                                                       sk_ref_sp(c->asRenderTargetContext()));
-    return SkToBool(fSurface.get());
+    if (!fSurface) {
+        return false;
+    }
+
+    if (Serializable::kYes == fSerializable) {
+        // Draws are recorded into a picture alongside the ops. Note that the tee canvas, unlike
+        // the surface's, has no GrContext to report.
+        int width = fCharacterization.width(), height = fCharacterization.height();
+        fPictureRecorder.reset(new SkPictureRecorder);
+        fTeeCanvas.reset(new SkNWayCanvas(width, height));
+        fTeeCanvas->addCanvas(fSurface->getCanvas());
+        fTeeCanvas->addCanvas(fPictureRecorder->beginRecording(SkIntToScalar(width),
+                                                               SkIntToScalar(height)));
+    }
+    return true;
 }
 
 SkCanvas* SkDeferredDisplayListRecorder::getCanvas() {
@@ -185,7 +219,7 @@ SkCanvas* SkDeferredDisplayListRecorder::getCanvas() {
         return nullptr;
     }
 
-    return fSurface->getCanvas();
+    return fTeeCanvas ? fTeeCanvas.get() : fSurface->getCanvas();
 }
 
 std::unique_ptr<SkDeferredDisplayList> SkDeferredDisplayListRecorder::detach() {
@@ -197,9 +231,57 @@ std::unique_ptr<SkDeferredDisplayList> SkDeferredDisplayListRecorder::detach() {
                            new SkDeferredDisplayList(fCharacterization, std::move(fLazyProxyData)));
 
     fContext->contextPriv().moveOpListsToDDL(ddl.get());
+    ddl->fPromiseTextures = std::move(fPromiseTextures);
+    if (fPromiseBatcher) {
+        for (auto& texture : fPromiseBatcher->detachTextures()) {
+            ddl->fPromiseTextures.push_back(std::move(texture));
+        }
+    }
+    if (fPictureRecorder) {
+        fTeeCanvas.reset();
+        ddl->fPicture = fPictureRecorder->finishRecordingAsPicture();
+    }
     return ddl;
 }
 
+bool SkDeferredDisplayListRecorder::playback(const void* data, size_t length,
+                                             const SkDeserialProcs* procs) {
+    SkISize dimensions;
+    sk_sp<SkPicture> picture = SkDeferredDisplayList::Deserialize(data, length, &dimensions,
+                                                                  procs);
+    if (!picture || dimensions != SkISize::Make(fCharacterization.width(),
+                                                fCharacterization.height())) {
+        return false;
+    }
+
+    SkCanvas* canvas = this->getCanvas();
+    if (!canvas) {
+        return false;
+    }
+    canvas->drawPicture(picture);
+    return true;
+}
+
+void SkDeferredDisplayListRecorder::setPromiseTextureBatchProcs(
+        TextureBatchFulfillProc textureBatchFulfillProc,
+        TextureBatchReleaseProc textureBatchReleaseProc,
+        void* batchContext,
+        SkExecutor* releaseExecutor) {
+    if (fPromiseBatcher) {
+        // Images made with the old procs keep them, and still go in the next DDL.
+        for (auto& texture : fPromiseBatcher->detachTextures()) {
+            fPromiseTextures.push_back(std::move(texture));
+        }
+        fPromiseBatcher.reset();
+    }
+    if (textureBatchFulfillProc) {
+        SkASSERT(textureBatchReleaseProc);
+        fPromiseBatcher.reset(new GrPromiseTextureBatcher(textureBatchFulfillProc,
+                                                          textureBatchReleaseProc, batchContext,
+                                                          releaseExecutor));
+    }
+}
+
 sk_sp<SkImage> SkDeferredDisplayListRecorder::makePromiseTexture(
         const GrBackendFormat& backendFormat,
         int width,
@@ -229,7 +311,8 @@ sk_sp<SkImage> SkDeferredDisplayListRecorder::makePromiseTexture(
                                            textureFulfillProc,
                                            textureReleaseProc,
                                            promiseDoneProc,
-                                           textureContext);
+                                           textureContext,
+                                           fPromiseBatcher.get());
 }
 
 sk_sp<SkImage> SkDeferredDisplayListRecorder::makeYUVAPromiseTexture(
@@ -261,7 +344,8 @@ sk_sp<SkImage> SkDeferredDisplayListRecorder::makeYUVAPromiseTexture(
                                                    textureFulfillProc,
                                                    textureReleaseProc,
                                                    promiseDoneProc,
-                                                   textureContexts);
+                                                   textureContexts,
+                                                   fPromiseBatcher.get());
 }
 
 sk_sp<SkImage> SkDeferredDisplayListRecorder::makeYUVAPromiseTexture(
@@ -291,7 +375,8 @@ sk_sp<SkImage> SkDeferredDisplayListRecorder::makeYUVAPromiseTexture(
                                                textureFulfillProc,
                                                textureReleaseProc,
                                                promiseDoneProc,
-                                               textureContexts);
+                                               textureContexts,
+                                               fPromiseBatcher.get());
 }
 
 #endif
@@ -82,6 +82,20 @@ public:
         return nullptr;
     }
 
+    // Returns true if the entries fit in, and exactly fill, the descriptor's length. Check this
+    // before looking up entries in a descriptor read from untrusted data.
+    bool isValid() const {
+        size_t offset = sizeof(SkDescriptor);
+        for (uint32_t i = 0; i < fCount; i++) {
+            if (offset + sizeof(Entry) > fLength) {
+                return false;
+            }
+            const Entry* entry = (const Entry*)((const char*)this + offset);
+            offset += sizeof(Entry) + entry->fLen;
+        }
+        return offset == fLength;
+    }
+
     std::unique_ptr<SkDescriptor> copy() const {
         std::unique_ptr<SkDescriptor> desc = SkDescriptor::Alloc(fLength);
         memcpy(desc.get(), this, fLength);
@@ -204,18 +204,28 @@ void SkBaseDevice::drawImageLattice(const SkImage* image,
 }
 
 void SkBaseDevice::drawImageSet(const SkCanvas::ImageSetEntry images[], int count,
-                                SkFilterQuality filterQuality, SkBlendMode mode) {
+                                const SkMatrix preViewMatrices[], SkFilterQuality filterQuality,
+                                SkBlendMode mode) {
     SkPaint paint;
     paint.setFilterQuality(SkTPin(filterQuality, kNone_SkFilterQuality, kLow_SkFilterQuality));
     paint.setBlendMode(mode);
+    const SkMatrix ctm = this->ctm();
     for (int i = 0; i < count; ++i) {
         // TODO: Handle per-edge AA. Right now this mirrors the SkiaRenderer component of Chrome
         // which turns off antialiasing unless all four edges should be antialiased. This avoids
         // seaming in tiled composited layers.
         paint.setAntiAlias(images[i].fAAFlags == SkCanvas::kAll_QuadAAFlags);
         paint.setAlpha(SkToUInt(SkTClamp(SkScalarRoundToInt(images[i].fAlpha * 255), 0, 255)));
-        this->drawImageRect(images[i].fImage.get(), &images[i].fSrcRect, images[i].fDstRect, paint,
-                            SkCanvas::kFast_SrcRectConstraint);
+        if (images[i].fMatrixIndex >= 0) {
+            SkAutoDeviceCTMRestore adctmr(this,
+                                          SkMatrix::Concat(ctm,
+                                                           preViewMatrices[images[i].fMatrixIndex]));
+            this->drawImageRect(images[i].fImage.get(), &images[i].fSrcRect, images[i].fDstRect,
+                                paint, SkCanvas::kFast_SrcRectConstraint);
+        } else {
+            this->drawImageRect(images[i].fImage.get(), &images[i].fSrcRect, images[i].fDstRect,
+                                paint, SkCanvas::kFast_SrcRectConstraint);
+        }
     }
 }
 
@@ -21,6 +21,7 @@ class SkGlyphRunList;
 class SkImageFilterCache;
 struct SkIRect;
 class SkMatrix;
+class SkPicture;
 class SkRasterHandleAllocator;
 class SkSpecialImage;
 
@@ -212,8 +213,9 @@ protected:
     virtual void drawImageLattice(const SkImage*, const SkCanvas::Lattice&,
                                   const SkRect& dst, const SkPaint&);
 
-    virtual void drawImageSet(const SkCanvas::ImageSetEntry[], int count, SkFilterQuality,
-                              SkBlendMode);
+    // preViewMatrices may be null when no entry has a matrix index
+    virtual void drawImageSet(const SkCanvas::ImageSetEntry[], int count,
+                              const SkMatrix preViewMatrices[], SkFilterQuality, SkBlendMode);
 
     virtual void drawVertices(const SkVertices*, const SkVertices::Bone bones[], int boneCount,
                               SkBlendMode, const SkPaint&) = 0;
@@ -239,6 +241,14 @@ protected:
 
     virtual void drawDrawable(SkDrawable*, const SkMatrix*, SkCanvas*);
 
+    /**
+     *  Draws the picture as SkCanvas::drawPicture() would if the device has a faster way than
+     *  playing it back, e.g. a raster of it kept from earlier draws. Returns false if it didn't.
+     */
+    virtual bool drawCachedPicture(const SkPicture*, const SkMatrix*, const SkPaint*) {
+        return false;
+    }
+
     virtual void drawSpecial(SkSpecialImage*, int x, int y, const SkPaint&,
                              SkImage* clipImage, const SkMatrix& clipMatrix);
     virtual sk_sp<SkSpecialImage> makeSpecial(const SkBitmap&);
@@ -9,15 +9,20 @@
 #include "SkColorData.h"
 #include "SkDistanceFieldGen.h"
 #include "SkMask.h"
+#include "SkNx.h"
 #include "SkPointPriv.h"
 #include "SkTemplates.h"
 
 #include <utility>
 
+// The temp data is kept as separate planes, one float per texel each, so that the distance
+// transform can work on several texels at once.
 struct DFData {
-    float   fAlpha;      // alpha value of source texel
-    float   fDistSq;     // distance squared to nearest (so far) edge texel
-    SkPoint fDistVector; // distance vector to nearest (so far) edge texel
+    float*         fAlpha;   // alpha value of source texel
+    float*         fDistSq;  // distance squared to nearest (so far) edge texel
+    float*         fDistX;   // distance vector to nearest (so far) edge texel
+    float*         fDistY;
+    unsigned char* fEdges;   // non-zero for edge texels, whose distances are final
 };
 
 enum NeighborFlags {
@@ -69,43 +74,79 @@ static bool found_edge(const unsigned char* imagePtr, int width, int neighborFla
     return false;
 }
 
-static void init_glyph_data(DFData* data, unsigned char* edges, const unsigned char* image,
+static int neighbor_flags(int i, int j, int width, int height) {
+    int checkMask = kAll_NeighborFlags;
+    if (i == 0) {
+        checkMask &= ~(kLeft_NeighborFlag|kTopLeft_NeighborFlag|kBottomLeft_NeighborFlag);
+    }
+    if (i == width-1) {
+        checkMask &= ~(kRight_NeighborFlag|kTopRight_NeighborFlag|kBottomRight_NeighborFlag);
+    }
+    if (j == 0) {
+        checkMask &= ~(kTopLeft_NeighborFlag|kTop_NeighborFlag|kTopRight_NeighborFlag);
+    }
+    if (j == height-1) {
+        checkMask &= ~(kBottomLeft_NeighborFlag|kBottom_NeighborFlag|kBottomRight_NeighborFlag);
+    }
+    return checkMask;
+}
+
+// Does what found_edge() does for the 16 pixels starting at imagePtr, which must all have
+// their 8 neighbors. Given the smallest and largest of its neighbors, a pixel is on an edge if
+//     it is >= 128 and minNeighbor < 128,
+//     it is 0 and maxNeighbor >= 128, or
+//     it is in (0, 128) and maxNeighbor > 0.
+static Sk16b found_edges(const unsigned char* imagePtr, int width) {
+    const int offsets[8] = {-1, 1, -width-1, -width, -width+1, width-1, width, width+1 };
+    Sk16b curr = Sk16b::Load(imagePtr);
+    Sk16b minNeighbor(255),
+          maxNeighborInv(255);  // 255 - maxNeighbor, as there is only Min()
+    for (int offset : offsets) {
+        Sk16b neighbor = Sk16b::Load(imagePtr + offset);
+        minNeighbor = Sk16b::Min(minNeighbor, neighbor);
+        maxNeighborInv = Sk16b::Min(maxNeighborInv, Sk16b(255) - neighbor);
+    }
+    const Sk16b kTrue(255), kFalse(0);
+    return (Sk16b(127) < curr).thenElse((minNeighbor < Sk16b(128)).thenElse(kTrue, kFalse),
+           (curr < Sk16b(1)).thenElse((maxNeighborInv < Sk16b(128)).thenElse(kTrue, kFalse),
+                                      (maxNeighborInv < Sk16b(255)).thenElse(kTrue, kFalse)));
+}
+
+static void init_glyph_data(const DFData& data, const unsigned char* image,
                             int dataWidth, int dataHeight,
                             int imageWidth, int imageHeight,
                             int pad) {
-    data += pad*dataWidth;
-    data += pad;
-    edges += (pad*dataWidth + pad);
+    float* alpha = data.fAlpha + pad*dataWidth + pad;
+    unsigned char* edges = data.fEdges + pad*dataWidth + pad;
 
     for (int j = 0; j < imageHeight; ++j) {
         for (int i = 0; i < imageWidth; ++i) {
-            if (255 == *image) {
-                data->fAlpha = 1.0f;
+            if (255 == image[i]) {
+                alpha[i] = 1.0f;
             } else {
-                data->fAlpha = (*image)*0.00392156862f;  // 1/255
-            }
-            int checkMask = kAll_NeighborFlags;
-            if (i == 0) {
-                checkMask &= ~(kLeft_NeighborFlag|kTopLeft_NeighborFlag|kBottomLeft_NeighborFlag);
+                alpha[i] = image[i]*0.00392156862f;  // 1/255
             }
-            if (i == imageWidth-1) {
-                checkMask &= ~(kRight_NeighborFlag|kTopRight_NeighborFlag|kBottomRight_NeighborFlag);
-            }
-            if (j == 0) {
-                checkMask &= ~(kTopLeft_NeighborFlag|kTop_NeighborFlag|kTopRight_NeighborFlag);
+        }
+
+        int i = 0;
+        if (j > 0 && j < imageHeight-1) {
+            // using 255 makes for convenient debug rendering
+            if (found_edge(image, imageWidth, neighbor_flags(0, j, imageWidth, imageHeight))) {
+                edges[0] = 255;
             }
-            if (j == imageHeight-1) {
-                checkMask &= ~(kBottomLeft_NeighborFlag|kBottom_NeighborFlag|kBottomRight_NeighborFlag);
+            for (i = 1; i + 16 <= imageWidth-1; i += 16) {
+                found_edges(image + i, imageWidth).store(edges + i);
             }
-            if (found_edge(image, imageWidth, checkMask)) {
-                *edges = 255;  // using 255 makes for convenient debug rendering
+        }
+        for (; i < imageWidth; ++i) {
+            if (found_edge(image + i, imageWidth, neighbor_flags(i, j, imageWidth, imageHeight))) {
+                edges[i] = 255;
             }
-            ++data;
-            ++image;
-            ++edges;
         }
-        data += 2*pad;
-        edges += 2*pad;
+
+        alpha += dataWidth;
+        image += imageWidth;
+        edges += dataWidth;
     }
 }
 
@@ -152,169 +193,132 @@ static float edge_distance(const SkPoint& direction, float alpha) {
     return distance;
 }
 
-static void init_distances(DFData* data, unsigned char* edges, int width, int height) {
+static void init_distances(const DFData& data, int width, int height) {
     // skip one pixel border
-    DFData* currData = data;
-    DFData* prevData = data - width;
-    DFData* nextData = data + width;
-
+    const float* alpha = data.fAlpha;
     for (int j = 0; j < height; ++j) {
         for (int i = 0; i < width; ++i) {
-            if (*edges) {
+            int curr = j*width + i;
+            if (data.fEdges[curr]) {
                 // we should not be in the one-pixel outside band
                 SkASSERT(i > 0 && i < width-1 && j > 0 && j < height-1);
+                int prev = curr - width;
+                int next = curr + width;
                 // gradient will point from low to high
                 // +y is down in this case
                 // i.e., if you're outside, gradient points towards edge
                 // if you're inside, gradient points away from edge
                 SkPoint currGrad;
-                currGrad.fX = (prevData+1)->fAlpha - (prevData-1)->fAlpha
-                             + SK_ScalarSqrt2*(currData+1)->fAlpha
-                             - SK_ScalarSqrt2*(currData-1)->fAlpha
-                             + (nextData+1)->fAlpha - (nextData-1)->fAlpha;
-                currGrad.fY = (nextData-1)->fAlpha - (prevData-1)->fAlpha
-                             + SK_ScalarSqrt2*nextData->fAlpha
-                             - SK_ScalarSqrt2*prevData->fAlpha
-                             + (nextData+1)->fAlpha - (prevData+1)->fAlpha;
+                currGrad.fX = alpha[prev+1] - alpha[prev-1]
+                             + SK_ScalarSqrt2*alpha[curr+1]
+                             - SK_ScalarSqrt2*alpha[curr-1]
+                             + alpha[next+1] - alpha[next-1];
+                currGrad.fY = alpha[next-1] - alpha[prev-1]
+                             + SK_ScalarSqrt2*alpha[next]
+                             - SK_ScalarSqrt2*alpha[prev]
+                             + alpha[next+1] - alpha[prev+1];
                 SkPointPriv::SetLengthFast(&currGrad, 1.0f);
 
                 // init squared distance to edge and distance vector
-                float dist = edge_distance(currGrad, currData->fAlpha);
-                currGrad.scale(dist, &currData->fDistVector);
-                currData->fDistSq = dist*dist;
+                float dist = edge_distance(currGrad, alpha[curr]);
+                data.fDistX[curr] = currGrad.fX*dist;
+                data.fDistY[curr] = currGrad.fY*dist;
+                data.fDistSq[curr] = dist*dist;
             } else {
                 // init distance to "far away"
-                currData->fDistSq = 2000000.f;
-                currData->fDistVector.fX = 1000.f;
-                currData->fDistVector.fY = 1000.f;
+                data.fDistSq[curr] = 2000000.f;
+                data.fDistX[curr] = 1000.f;
+                data.fDistY[curr] = 1000.f;
             }
-            ++currData;
-            ++prevData;
-            ++nextData;
-            ++edges;
         }
     }
 }
 
 // Danielsson's 8SSEDT
+//
+// Each check offers a texel the distance vector of its neighbor at (dx, dy), moved by (dx, dy).
+// The squared length of the moved vector v + d is |v|^2 + 2(v.d) + |d|^2.
 
-// first stage forward pass
-// (forward in Y, forward in X)
-static void F1(DFData* curr, int width) {
-    // upper left
-    DFData* check = curr - width-1;
-    SkPoint distVec = check->fDistVector;
-    float distSq = check->fDistSq - 2.0f*(distVec.fX + distVec.fY - 1.0f);
-    if (distSq < curr->fDistSq) {
-        distVec.fX -= 1.0f;
-        distVec.fY -= 1.0f;
-        curr->fDistSq = distSq;
-        curr->fDistVector = distVec;
-    }
-
-    // up
-    check = curr - width;
-    distVec = check->fDistVector;
-    distSq = check->fDistSq - 2.0f*distVec.fY + 1.0f;
-    if (distSq < curr->fDistSq) {
-        distVec.fY -= 1.0f;
-        curr->fDistSq = distSq;
-        curr->fDistVector = distVec;
-    }
-
-    // upper right
-    check = curr - width+1;
-    distVec = check->fDistVector;
-    distSq = check->fDistSq + 2.0f*(distVec.fX - distVec.fY + 1.0f);
-    if (distSq < curr->fDistSq) {
-        distVec.fX += 1.0f;
-        distVec.fY -= 1.0f;
-        curr->fDistSq = distSq;
-        curr->fDistVector = distVec;
-    }
-
-    // left
-    check = curr - 1;
-    distVec = check->fDistVector;
-    distSq = check->fDistSq - 2.0f*distVec.fX + 1.0f;
-    if (distSq < curr->fDistSq) {
-        distVec.fX -= 1.0f;
-        curr->fDistSq = distSq;
-        curr->fDistVector = distVec;
-    }
+static float if_then_else(bool cond, float t, float e) { return cond ? t : e; }
+static Sk4f if_then_else(const Sk4f& cond, const Sk4f& t, const Sk4f& e) {
+    return cond.thenElse(t, e);
 }
 
-// second stage forward pass
-// (forward in Y, backward in X)
-static void F2(DFData* curr, int width) {
-    // right
-    DFData* check = curr + 1;
-    SkPoint distVec = check->fDistVector;
-    float distSq = check->fDistSq + 2.0f*distVec.fX + 1.0f;
-    if (distSq < curr->fDistSq) {
-        distVec.fX += 1.0f;
-        curr->fDistSq = distSq;
-        curr->fDistVector = distVec;
-    }
+template <typename T>
+static void check_distance(const T& distSq, const T& distX, const T& distY, float dx, float dy,
+                           T* currDistSq, T* currDistX, T* currDistY) {
+    T movedDistSq = distSq + 2.0f*(distX*dx + distY*dy) + (dx*dx + dy*dy);
+    auto closer = movedDistSq < *currDistSq;
+    *currDistSq = if_then_else(closer, movedDistSq, *currDistSq);
+    *currDistX  = if_then_else(closer, distX + dx, *currDistX);
+    *currDistY  = if_then_else(closer, distY + dy, *currDistY);
 }
 
-// first stage backward pass
-// (backward in Y, forward in X)
-static void B1(DFData* curr, int width) {
-    // left
-    DFData* check = curr - 1;
-    SkPoint distVec = check->fDistVector;
-    float distSq = check->fDistSq - 2.0f*distVec.fX + 1.0f;
-    if (distSq < curr->fDistSq) {
-        distVec.fX -= 1.0f;
-        curr->fDistSq = distSq;
-        curr->fDistVector = distVec;
-    }
-}
-
-// second stage backward pass
-// (backward in Y, backwards in X)
-static void B2(DFData* curr, int width) {
-    // right
-    DFData* check = curr + 1;
-    SkPoint distVec = check->fDistVector;
-    float distSq = check->fDistSq + 2.0f*distVec.fX + 1.0f;
-    if (distSq < curr->fDistSq) {
-        distVec.fX += 1.0f;
-        curr->fDistSq = distSq;
-        curr->fDistVector = distVec;
-    }
-
-    // bottom left
-    check = curr + width-1;
-    distVec = check->fDistVector;
-    distSq = check->fDistSq - 2.0f*(distVec.fX - distVec.fY - 1.0f);
-    if (distSq < curr->fDistSq) {
-        distVec.fX -= 1.0f;
-        distVec.fY += 1.0f;
-        curr->fDistSq = distSq;
-        curr->fDistVector = distVec;
+// Checks the 'count' texels of a row, starting at 'curr', against their three neighbors in the
+// row at 'dy', which must already be done. The texels don't depend on each other, so this works
+// on four of them at a time.
+static void check_row_neighbors(const DFData& data, int curr, int count, int width, float dy) {
+    int rowOffset = dy > 0 ? width : -width;
+    auto check_texels = [&](int i, auto load, auto store) {
+        using T = decltype(load(data.fDistSq));
+        T distSq = load(data.fDistSq + i),
+          distX  = load(data.fDistX + i),
+          distY  = load(data.fDistY + i);
+        for (int dx = -1; dx <= 1; ++dx) {
+            int neighbor = i + rowOffset + dx;
+            check_distance<T>(load(data.fDistSq + neighbor), load(data.fDistX + neighbor),
+                              load(data.fDistY + neighbor), dx, dy, &distSq, &distX, &distY);
+        }
+        store(data.fDistSq + i, distSq);
+        store(data.fDistX + i, distX);
+        store(data.fDistY + i, distY);
+    };
+
+    int i = curr;
+    for (; i + 4 <= curr + count; i += 4) {
+        // don't need to calculate distance for edge pixels
+        auto isEdge = SkNx_cast<float>(Sk4b::Load(data.fEdges + i)) != 0.0f;
+        check_texels(i, [](const float* p) { return Sk4f::Load(p); },
+                        [&](float* p, const Sk4f& v) {
+                            isEdge.thenElse(Sk4f::Load(p), v).store(p);
+                        });
     }
-
-    // bottom
-    check = curr + width;
-    distVec = check->fDistVector;
-    distSq = check->fDistSq + 2.0f*distVec.fY + 1.0f;
-    if (distSq < curr->fDistSq) {
-        distVec.fY += 1.0f;
-        curr->fDistSq = distSq;
-        curr->fDistVector = distVec;
+    for (; i < curr + count; ++i) {
+        if (!data.fEdges[i]) {
+            check_texels(i, [](const float* p) { return *p; },
+                            [](float* p, float v) { *p = v; });
+        }
     }
+}
 
-    // bottom right
-    check = curr + width+1;
-    distVec = check->fDistVector;
-    distSq = check->fDistSq + 2.0f*(distVec.fX + distVec.fY + 1.0f);
-    if (distSq < curr->fDistSq) {
-        distVec.fX += 1.0f;
-        distVec.fY += 1.0f;
-        curr->fDistSq = distSq;
-        curr->fDistVector = distVec;
+// Checks the 'count' texels of a row, starting at 'curr', against their left (step = 1) or
+// right (step = -1) neighbor, in order.
+static void check_row_sweep(const DFData& data, int curr, int count, int step) {
+    float dx = -step;
+    int neighbor = curr - step;
+    float distSq = data.fDistSq[neighbor],
+          distX  = data.fDistX[neighbor],
+          distY  = data.fDistY[neighbor];
+    for (int i = curr; count > 0; i += step, --count) {
+        float currDistSq = data.fDistSq[i],
+              currDistX  = data.fDistX[i],
+              currDistY  = data.fDistY[i];
+        // don't need to calculate distance for edge pixels
+        if (!data.fEdges[i]) {
+            // check_distance(), specialized to keep this serial dependency chain short
+            float movedDistSq = (distSq + 1.0f) + distX*(2.0f*dx);
+            if (movedDistSq < currDistSq) {
+                currDistSq = movedDistSq;
+                currDistX  = distX + dx;
+                currDistY  = distY;
+                data.fDistSq[i] = currDistSq;
+                data.fDistX[i]  = currDistX;
+                data.fDistY[i]  = currDistY;
+            }
+        }
+        distSq = currDistSq;
+        distX  = currDistX;
+        distY  = currDistY;
     }
 }
 
@@ -356,90 +360,56 @@ static bool generate_distance_field_from_image(unsigned char* distanceField,
     int dataHeight = height + 2*pad;
 
     // create zeroed temp DFData+edge storage
-    SkAutoFree storage(sk_calloc_throw(dataWidth*dataHeight*(sizeof(DFData) + 1)));
-    DFData*        dataPtr = (DFData*)storage.get();
-    unsigned char* edgePtr = (unsigned char*)storage.get() + dataWidth*dataHeight*sizeof(DFData);
+    int dataCount = dataWidth*dataHeight;
+    SkAutoFree storage(sk_calloc_throw(dataCount*(4*sizeof(float) + 1)));
+    DFData data;
+    data.fAlpha  = (float*)storage.get();
+    data.fDistSq = data.fAlpha + dataCount;
+    data.fDistX  = data.fDistSq + dataCount;
+    data.fDistY  = data.fDistX + dataCount;
+    data.fEdges  = (unsigned char*)(data.fDistY + dataCount);
 
     // copy glyph into distance field storage
-    init_glyph_data(dataPtr, edgePtr, copyPtr,
+    init_glyph_data(data, copyPtr,
                     dataWidth, dataHeight,
                     width+2, height+2, SK_DistanceFieldPad);
 
     // create initial distance data, particularly at edges
-    init_distances(dataPtr, edgePtr, dataWidth, dataHeight);
+    init_distances(data, dataWidth, dataHeight);
 
-    // now perform Euclidean distance transform to propagate distances
+    // now perform Euclidean distance transform to propagate distances,
+    // skipping the outer buffer
+    int rowWidth = dataWidth-2;
 
     // forwards in y
-    DFData* currData = dataPtr+dataWidth+1; // skip outer buffer
-    unsigned char* currEdge = edgePtr+dataWidth+1;
     for (int j = 1; j < dataHeight-1; ++j) {
-        // forwards in x
-        for (int i = 1; i < dataWidth-1; ++i) {
-            // don't need to calculate distance for edge pixels
-            if (!*currEdge) {
-                F1(currData, dataWidth);
-            }
-            ++currData;
-            ++currEdge;
-        }
-
-        // backwards in x
-        --currData; // reset to end
-        --currEdge;
-        for (int i = 1; i < dataWidth-1; ++i) {
-            // don't need to calculate distance for edge pixels
-            if (!*currEdge) {
-                F2(currData, dataWidth);
-            }
-            --currData;
-            --currEdge;
-        }
-
-        currData += dataWidth+1;
-        currEdge += dataWidth+1;
+        int rowStart = j*dataWidth + 1;
+        // up left, up, and up right
+        check_row_neighbors(data, rowStart, rowWidth, dataWidth, -1.0f);
+        // forwards in x, then backwards in x
+        check_row_sweep(data, rowStart, rowWidth, 1);
+        check_row_sweep(data, rowStart + rowWidth - 1, rowWidth, -1);
     }
 
     // backwards in y
-    currData = dataPtr+dataWidth*(dataHeight-2) - 1; // skip outer buffer
-    currEdge = edgePtr+dataWidth*(dataHeight-2) - 1;
-    for (int j = 1; j < dataHeight-1; ++j) {
-        // forwards in x
-        for (int i = 1; i < dataWidth-1; ++i) {
-            // don't need to calculate distance for edge pixels
-            if (!*currEdge) {
-                B1(currData, dataWidth);
-            }
-            ++currData;
-            ++currEdge;
-        }
-
-        // backwards in x
-        --currData; // reset to end
-        --currEdge;
-        for (int i = 1; i < dataWidth-1; ++i) {
-            // don't need to calculate distance for edge pixels
-            if (!*currEdge) {
-                B2(currData, dataWidth);
-            }
-            --currData;
-            --currEdge;
-        }
-
-        currData -= dataWidth-1;
-        currEdge -= dataWidth-1;
+    for (int j = dataHeight-2; j > 0; --j) {
+        int rowStart = j*dataWidth + 1;
+        // bottom left, bottom, and bottom right
+        check_row_neighbors(data, rowStart, rowWidth, dataWidth, 1.0f);
+        // forwards in x, then backwards in x
+        check_row_sweep(data, rowStart, rowWidth, 1);
+        check_row_sweep(data, rowStart + rowWidth - 1, rowWidth, -1);
     }
 
     // copy results to final distance field data
-    currData = dataPtr + dataWidth+1;
-    currEdge = edgePtr + dataWidth+1;
     unsigned char *dfPtr = distanceField;
     for (int j = 1; j < dataHeight-1; ++j) {
         for (int i = 1; i < dataWidth-1; ++i) {
+            int curr = j*dataWidth + i;
 #if DUMP_EDGE
-            float alpha = currData->fAlpha;
+            float alpha = data.fAlpha[curr];
             float edge = 0.0f;
-            if (*currEdge) {
+            if (data.fEdges[curr]) {
                 edge = 0.25f;
             }
             // blend with original image
@@ -448,18 +418,14 @@ static bool generate_distance_field_from_image(unsigned char* distanceField,
             *dfPtr++ = val;
 #else
             float dist;
-            if (currData->fAlpha > 0.5f) {
-                dist = -SkScalarSqrt(currData->fDistSq);
+            if (data.fAlpha[curr] > 0.5f) {
+                dist = -SkScalarSqrt(data.fDistSq[curr]);
             } else {
-                dist = SkScalarSqrt(currData->fDistSq);
+                dist = SkScalarSqrt(data.fDistSq[curr]);
             }
             *dfPtr++ = pack_distance_field_val<SK_DistanceFieldMagnitude>(dist);
 #endif
-            ++currData;
-            ++currEdge;
         }
-        currData += 2;
-        currEdge += 2;
     }
 
     return true;
@@ -15,6 +15,7 @@
 #include "SkColorData.h"
 #include "SkDevice.h"
 #include "SkDrawProcs.h"
+#include "SkEdgeCache.h"
 #include "SkMaskFilterBase.h"
 #include "SkMacros.h"
 #include "SkMatrix.h"
@@ -29,6 +30,7 @@
 #include "SkShader.h"
 #include "SkString.h"
 #include "SkStroke.h"
+#include "SkStrokeCache.h"
 #include "SkStrokeRec.h"
 #include "SkTLazy.h"
 #include "SkTemplates.h"
@@ -50,6 +52,29 @@ static SkPaint make_paint_with_image(
 
 SkDraw::SkDraw() {}
 
+namespace {
+
+// Unlike SkRectClipBlitter, this never exposes the destination pixels via justAnOpaqueColor(),
+// so callers can't write outside of the tile behind our back.
+class TileClipBlitter final : public SkRectClipBlitter {
+public:
+    TileClipBlitter(SkBlitter* blitter, const SkIRect& tile) { this->init(blitter, tile); }
+
+    const SkPixmap* justAnOpaqueColor(uint32_t*) override { return nullptr; }
+};
+
+}  // namespace
+
+SkBlitter* SkDraw::clipToTile(SkBlitter* blitter, SkArenaAlloc* alloc) const {
+    if (!fTileClip || !blitter) {
+        return blitter;
+    }
+    if (fTileClip->isEmpty()) {
+        return alloc->make<SkNullBlitter>();
+    }
+    return alloc->make<TileClipBlitter>(blitter, *fTileClip);
+}
+
 bool SkDraw::computeConservativeLocalClipBounds(SkRect* localBounds) const {
     if (fRC->isEmpty()) {
         return false;
@@ -949,8 +974,11 @@ void SkDraw::drawPath(const SkPath& origSrcPath, const SkPaint& origPaint,
         if (this->computeConservativeLocalClipBounds(&cullRect)) {
             cullRectPtr = &cullRect;
         }
-        doFill = paint->getFillPath(*pathPtr, tmpPath, cullRectPtr,
-                                    ComputeResScaleForStroking(*fMatrix));
+        SkScalar resScale = ComputeResScaleForStroking(*fMatrix);
+        // Caching the outlines of our own temporaries would only churn the cache.
+        doFill = pathIsMutable
+               ? paint->getFillPath(*pathPtr, tmpPath, cullRectPtr, resScale)
+               : SkStrokeCache::GetFillPath(*paint, *pathPtr, tmpPath, cullRectPtr, resScale);
         pathPtr = tmpPath;
     }
 
@@ -958,7 +986,12 @@ void SkDraw::drawPath(const SkPath& origSrcPath, const SkPaint& origPaint,
     SkPath* devPathPtr = pathIsMutable ? pathPtr : tmpPath;
 
     // transform the path into device space
-    pathPtr->transform(*matrix, devPathPtr);
+    if (doFill && pathPtr == &origSrcPath && !pathIsMutable) {
+        // Filling the caller's path with the same matrix again then finds its edges cached.
+        SkEdgeCache::TransformPath(*pathPtr, *matrix, devPathPtr);
+    } else {
+        pathPtr->transform(*matrix, devPathPtr);
+    }
 
     this->drawDevPath(*devPathPtr, *paint, drawCoverage, customBlitter, doFill);
 }
@@ -1056,6 +1089,8 @@ static bool clipped_out(const SkMatrix& matrix, const SkRasterClip& clip,
     return clipped_out(matrix, clip, r);
 }
 
+static SkArenaAlloc::Site gSpriteArenaSite{"SkDraw sprite"};
+
 static bool clipHandlesSprite(const SkRasterClip& clip, int x, int y, const SkPixmap& pmap) {
     return clip.isBW() || clip.quickContains(x, y, x + pmap.width(), y + pmap.height());
 }
@@ -1097,9 +1132,11 @@ void SkDraw::drawBitmap(const SkBitmap& bitmap, const SkMatrix& prematrix,
         int iy = SkScalarRoundToInt(matrix.getTranslateY());
         if (clipHandlesSprite(*fRC, ix, iy, pmap)) {
             SkSTArenaAlloc<kSkBlitterContextSize> allocator;
+            allocator.setSite(&gSpriteArenaSite);
             // blitter will be owned by the allocator.
             SkBlitter* blitter = SkBlitter::ChooseSprite(fDst, *paint, pmap, ix, iy, &allocator);
             if (blitter) {
+                blitter = this->clipToTile(blitter, &allocator);
                 SkScan::FillIRect(SkIRect::MakeXYWH(ix, iy, pmap.width(), pmap.height()),
                                   *fRC, blitter);
                 return;
@@ -1153,8 +1190,10 @@ void SkDraw::drawSprite(const SkBitmap& bitmap, int x, int y, const SkPaint& ori
     if (nullptr == paint.getColorFilter() && clipHandlesSprite(*fRC, x, y, pmap)) {
         // blitter will be owned by the allocator.
         SkSTArenaAlloc<kSkBlitterContextSize> allocator;
+        allocator.setSite(&gSpriteArenaSite);
         SkBlitter* blitter = SkBlitter::ChooseSprite(fDst, paint, pmap, x, y, &allocator);
         if (blitter) {
+            blitter = this->clipToTile(blitter, &allocator);
             SkScan::FillIRect(bounds, *fRC, blitter);
             return;
         }
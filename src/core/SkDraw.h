@@ -20,6 +20,7 @@
 
 class SkBitmap;
 class SkClipStack;
+class SkArenaAlloc;
 class SkBaseDevice;
 class SkBlitter;
 class SkMatrix;
@@ -127,6 +128,13 @@ public:
                                       SkScalar sizeLimit = 1024);
 
     static SkScalar ComputeResScaleForStroking(const SkMatrix& );
+
+    /**
+     *  If fTileClip is set, return a blitter (allocated in alloc) that forwards to blitter but
+     *  drops everything outside of fTileClip. Otherwise return blitter unchanged.
+     */
+    SkBlitter* clipToTile(SkBlitter* blitter, SkArenaAlloc* alloc) const;
+
 private:
     void drawBitmapAsMask(const SkBitmap&, const SkPaint&) const;
 
@@ -162,6 +170,10 @@ public:
     // optional, will be same dimensions as fDst if present
     const SkPixmap* fCoverage{nullptr};
 
+    // optional, restricts the pixels written without changing how geometry is rasterized
+    // against fRC. Drawing the same op once per tile is then identical to drawing it untiled.
+    const SkIRect* fTileClip{nullptr};
+
 #ifdef SK_DEBUG
     void validate() const;
 #else
@@ -56,13 +56,16 @@ bool SkDraw::ShouldDrawTextAsPaths(const SkFont& font, const SkPaint& paint,
 void SkDraw::paintMasks(SkSpan<const SkMask> masks, const SkPaint& paint) const {
 
     // The size used for a typical blitter.
+    static SkArenaAlloc::Site gSite{"SkDraw::paintMasks"};
     SkSTArenaAlloc<3308> alloc;
+    alloc.setSite(&gSite);
     SkBlitter* blitter = SkBlitter::Choose(fDst, *fMatrix, paint, &alloc, false);
     if (fCoverage) {
         blitter = alloc.make<SkPairBlitter>(
                 blitter,
                 SkBlitter::Choose(*fCoverage, *fMatrix, SkPaint(), &alloc, true));
     }
+    blitter = this->clipToTile(blitter, &alloc);
 
     SkAAClipBlitterWrapper wrapper{*fRC, blitter};
     blitter = wrapper.getBlitter();
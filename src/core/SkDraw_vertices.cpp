@@ -207,7 +207,9 @@ void SkDraw::drawVertices(SkVertices::VertexMode vmode, int vertexCount,
     constexpr size_t kOuterSize = sizeof(SkTriColorShader) +
                                  sizeof(SkComposeShader) +
                                  (2 * sizeof(SkPoint) + sizeof(SkColor4f)) * kDefVertexCount;
+    static SkArenaAlloc::Site gSite{"SkDraw::drawVertices"};
     SkSTArenaAlloc<kOuterSize> outerAlloc;
+    outerAlloc.setSite(&gSite);
 
     // deform vertices using the skeleton if it is passed in
     if (bones && boneCount) {
@@ -290,7 +292,8 @@ void SkDraw::drawVertices(SkVertices::VertexMode vmode, int vertexCount,
 
         if (!textures) {    // only tricolor shader
             SkASSERT(matrix43);
-            auto blitter = SkCreateRasterPipelineBlitter(fDst, p, *fMatrix, &outerAlloc);
+            auto blitter = this->clipToTile(
+                    SkCreateRasterPipelineBlitter(fDst, p, *fMatrix, &outerAlloc), &outerAlloc);
             while (vertProc(&state)) {
                 if (!update_tricolor_matrix(ctmInv, vertices, dstColors,
                                             state.f0, state.f1, state.f2,
@@ -327,7 +330,8 @@ void SkDraw::drawVertices(SkVertices::VertexMode vmode, int vertexCount,
                 SkPoint tmp[] = {
                     devVerts[state.f0], devVerts[state.f1], devVerts[state.f2]
                 };
-                auto blitter = SkCreateRasterPipelineBlitter(fDst, p, *ctm, &innerAlloc);
+                auto blitter = this->clipToTile(
+                        SkCreateRasterPipelineBlitter(fDst, p, *ctm, &innerAlloc), &innerAlloc);
                 SkScan::FillTriangle(tmp, *fRC, blitter);
             }
         }
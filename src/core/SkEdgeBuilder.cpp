@@ -8,6 +8,7 @@
 #include "SkAnalyticEdge.h"
 #include "SkEdge.h"
 #include "SkEdgeBuilder.h"
+#include "SkEdgeCache.h"
 #include "SkEdgeClipper.h"
 #include "SkGeometry.h"
 #include "SkLineClipper.h"
@@ -252,6 +253,38 @@ char* SkBezierEdgeBuilder::allocEdges(size_t n, size_t* size) {
     return (char*)fAlloc.makeArrayDefault<SkLine>(n);
 }
 
+uint32_t SkBasicEdgeBuilder::cacheTag() const {
+    return SkSetFourByteTag('b', 'a', 's', fClipShift);
+}
+uint32_t SkAnalyticEdgeBuilder::cacheTag() const {
+    return SkSetFourByteTag('a', 'n', 'a', 0);
+}
+uint32_t SkBezierEdgeBuilder::cacheTag() const {
+    return SkSetFourByteTag('b', 'e', 'z', 0);
+}
+
+// Curves whose fCurveCount has already run down to 0 are walked as lines, so their line prefix
+// is all that needs copying.
+size_t SkBasicEdgeBuilder::edgeSize(const char* edge) const {
+    int curveCount = ((const SkEdge*)edge)->fCurveCount;
+    return curveCount < 0 ? sizeof(SkCubicEdge)
+         : curveCount > 0 ? sizeof(SkQuadraticEdge)
+         :                  sizeof(SkEdge);
+}
+size_t SkAnalyticEdgeBuilder::edgeSize(const char* edge) const {
+    int curveCount = ((const SkAnalyticEdge*)edge)->fCurveCount;
+    return curveCount < 0 ? sizeof(SkAnalyticCubicEdge)
+         : curveCount > 0 ? sizeof(SkAnalyticQuadraticEdge)
+         :                  sizeof(SkAnalyticEdge);
+}
+size_t SkBezierEdgeBuilder::edgeSize(const char* edge) const {
+    switch (((const SkBezier*)edge)->fCount) {
+        case 2:  return sizeof(SkLine);
+        case 3:  return sizeof(SkQuad);
+        default: return sizeof(SkCubic);
+    }
+}
+
 // TODO: maybe get rid of buildPoly() entirely?
 int SkEdgeBuilder::buildPoly(const SkPath& path, const SkIRect* iclip, bool canCullToTheRight) {
     SkPath::Iter    iter(path, true);
@@ -479,3 +512,43 @@ int SkEdgeBuilder::buildEdges(const SkPath& path,
 
     return count;
 }
+
+int SkEdgeBuilder::findCachedEdges(const SkPath& path, const SkIRect* shiftedClip) {
+    if (!SkEdgeCache::WorthCaching(path)) {
+        return -1;
+    }
+    int count;
+    sk_sp<SkData> edges = SkEdgeCache::FindEdges(path, shiftedClip, this->cacheTag(), &count);
+    if (!edges) {
+        return -1;
+    }
+    // The walk updates the edges in place, so it gets its own copy.
+    char* edge = (char*)fAlloc.makeBytesAlignedTo(edges->size(), alignof(std::max_align_t));
+    memcpy(edge, edges->data(), edges->size());
+    fList.setCount(count);
+    for (int i = 0; i < count; i++) {
+        fList[i] = edge;
+        edge += this->edgeSize(edge);
+    }
+    SkASSERT(edge == (char*)fList[0] + edges->size());
+    fEdgeList = fList.begin();
+    return count;
+}
+
+void SkEdgeBuilder::cacheEdges(const SkPath& path, const SkIRect* shiftedClip, int count) {
+    if (count <= 0 || !SkEdgeCache::WorthCaching(path)) {
+        return;
+    }
+    size_t size = 0;
+    for (int i = 0; i < count; i++) {
+        size += this->edgeSize((const char*)fEdgeList[i]);
+    }
+    sk_sp<SkData> edges = SkData::MakeUninitialized(size);
+    char* dst = (char*)edges->writable_data();
+    for (int i = 0; i < count; i++) {
+        size_t edgeSize = this->edgeSize((const char*)fEdgeList[i]);
+        memcpy(dst, fEdgeList[i], edgeSize);
+        dst += edgeSize;
+    }
+    SkEdgeCache::AddEdges(path, shiftedClip, this->cacheTag(), std::move(edges), count);
+}
@@ -20,6 +20,19 @@ public:
     int buildEdges(const SkPath& path,
                    const SkIRect* shiftedClip);
 
+    /**
+     *  If SkEdgeCache holds the edges built for this path and clip by this kind of builder, copies
+     *  them into this builder's edge list and returns their count. They are already sorted.
+     *  Otherwise returns -1, and the caller should call buildEdges().
+     */
+    int findCachedEdges(const SkPath& path, const SkIRect* shiftedClip);
+
+    /**
+     *  Adds the 'count' edges from buildEdges() to SkEdgeCache, in the order of the edge list.
+     *  Call this once they're sorted, before they're walked.
+     */
+    void cacheEdges(const SkPath& path, const SkIRect* shiftedClip, int count);
+
 protected:
     SkEdgeBuilder() = default;
     virtual ~SkEdgeBuilder() = default;
@@ -48,6 +61,10 @@ private:
     virtual void addQuad (const SkPoint pts[]) = 0;
     virtual void addCubic(const SkPoint pts[]) = 0;
     virtual Combine addPolyLine(SkPoint pts[], char* edge, char** edgePtr) = 0;
+
+    // Identifies the kind of edges in SkEdgeCache, and how they're sized.
+    virtual uint32_t cacheTag() const = 0;
+    virtual size_t edgeSize(const char* edge) const = 0;
 };
 
 class SkBasicEdgeBuilder final : public SkEdgeBuilder {
@@ -68,6 +85,9 @@ private:
     void addCubic(const SkPoint pts[]) override;
     Combine addPolyLine(SkPoint pts[], char* edge, char** edgePtr) override;
 
+    uint32_t cacheTag() const override;
+    size_t edgeSize(const char* edge) const override;
+
     const int fClipShift;
 };
 
@@ -88,6 +108,9 @@ private:
     void addQuad (const SkPoint pts[]) override;
     void addCubic(const SkPoint pts[]) override;
     Combine addPolyLine(SkPoint pts[], char* edge, char** edgePtr) override;
+
+    uint32_t cacheTag() const override;
+    size_t edgeSize(const char* edge) const override;
 };
 
 class SkBezierEdgeBuilder final : public SkEdgeBuilder {
@@ -105,6 +128,9 @@ private:
     void addQuad (const SkPoint pts[]) override;
     void addCubic(const SkPoint pts[]) override;
     Combine addPolyLine(SkPoint pts[], char* edge, char** edgePtr) override;
+
+    uint32_t cacheTag() const override;
+    size_t edgeSize(const char* edge) const override;
 };
 
 #endif
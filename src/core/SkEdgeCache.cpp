@@ -0,0 +1,162 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkEdgeCache.h"
+
+#include "SkMatrix.h"
+#include "SkPathPriv.h"
+#include "SkPathRef.h"
+#include "SkResourceCache.h"
+
+// Building the edges of paths this small costs about as much as a cache lookup.
+#ifndef SK_EDGE_CACHE_MIN_POINTS
+    #define SK_EDGE_CACHE_MIN_POINTS 16
+#endif
+
+namespace {
+static unsigned gDevPathKeyNamespaceLabel;
+static unsigned gEdgeKeyNamespaceLabel;
+
+uint64_t shared_id_for_path(uint32_t tag, uint32_t pathGenID) {
+    return ((uint64_t)tag << 32) | pathGenID;
+}
+
+struct DevPathKey : public SkResourceCache::Key {
+public:
+    DevPathKey(const SkPath& src, const SkMatrix& matrix) {
+        matrix.get9(fMatrix);
+        this->init(&gDevPathKeyNamespaceLabel,
+                   shared_id_for_path(SkSetFourByteTag('d', 'p', 't', 'h'),
+                                      src.getGenerationID()),
+                   sizeof(fMatrix));
+    }
+
+    SkScalar fMatrix[9];
+};
+
+struct DevPathRec : public SkResourceCache::Rec {
+    DevPathRec(const DevPathKey& key, const SkPath& devPath) : fKey(key), fDevPath(devPath) {}
+
+    DevPathKey fKey;
+    SkPath     fDevPath;
+
+    const Key& getKey() const override { return fKey; }
+    size_t bytesUsed() const override {
+        return sizeof(*this) + fDevPath.countPoints() * sizeof(SkPoint) + fDevPath.countVerbs();
+    }
+    const char* getCategory() const override { return "device-path"; }
+    SkDiscardableMemory* diagnostic_only_getDiscardable() const override { return nullptr; }
+
+    static bool Visitor(const SkResourceCache::Rec& baseRec, void* contextData) {
+        const DevPathRec& rec = static_cast<const DevPathRec&>(baseRec);
+        *static_cast<SkPath*>(contextData) = rec.fDevPath;
+        return true;
+    }
+};
+
+struct EdgeKey : public SkResourceCache::Key {
+public:
+    EdgeKey(const SkPath& devPath, const SkIRect* clip, uint32_t builderTag)
+        : fBuilderTag(builderTag)
+        // Convex paths keep the edges to the right of the clip.
+        , fIsConvex(devPath.isConvex())
+        , fHasClip(clip != nullptr)
+        , fClip(clip ? *clip : SkIRect::MakeEmpty())
+    {
+        this->init(&gEdgeKeyNamespaceLabel,
+                   shared_id_for_path(SkSetFourByteTag('e', 'd', 'g', 'e'),
+                                      devPath.getGenerationID()),
+                   sizeof(fBuilderTag) + sizeof(fIsConvex) + sizeof(fHasClip) + sizeof(fClip));
+    }
+
+    uint32_t fBuilderTag;
+    int32_t  fIsConvex;
+    int32_t  fHasClip;
+    SkIRect  fClip;
+};
+
+struct EdgeRec : public SkResourceCache::Rec {
+    EdgeRec(const EdgeKey& key, sk_sp<SkData> edges, int count)
+        : fKey(key), fEdges(std::move(edges)), fCount(count) {}
+
+    EdgeKey       fKey;
+    sk_sp<SkData> fEdges;
+    int           fCount;
+
+    const Key& getKey() const override { return fKey; }
+    size_t bytesUsed() const override { return sizeof(*this) + fEdges->size(); }
+    const char* getCategory() const override { return "edges"; }
+    SkDiscardableMemory* diagnostic_only_getDiscardable() const override { return nullptr; }
+
+    struct Result {
+        sk_sp<SkData> fEdges;
+        int           fCount;
+    };
+
+    static bool Visitor(const SkResourceCache::Rec& baseRec, void* contextData) {
+        const EdgeRec& rec = static_cast<const EdgeRec&>(baseRec);
+        Result* result = static_cast<Result*>(contextData);
+        result->fEdges = rec.fEdges;
+        result->fCount = rec.fCount;
+        return true;
+    }
+};
+
+// Purges a path's device paths or edges when its SkPathRef changes or is deleted.
+class PathInvalidator : public SkPathRef::GenIDChangeListener {
+public:
+    explicit PathInvalidator(uint64_t sharedID) : fSharedID(sharedID) {}
+
+private:
+    void onChange() override { SkResourceCache::PostPurgeSharedID(fSharedID); }
+
+    uint64_t fSharedID;
+};
+
+} // namespace
+
+bool SkEdgeCache::WorthCaching(const SkPath& path) {
+    return !path.isVolatile() && path.countPoints() >= SK_EDGE_CACHE_MIN_POINTS;
+}
+
+void SkEdgeCache::TransformPath(const SkPath& src, const SkMatrix& matrix, SkPath* dst) {
+    if (matrix.isIdentity() || !WorthCaching(src)) {
+        src.transform(matrix, dst);
+        return;
+    }
+    DevPathKey key(src, matrix);
+    SkPath devPath;
+    if (!SkResourceCache::Find(key, DevPathRec::Visitor, &devPath)) {
+        src.transform(matrix, &devPath);
+        SkResourceCache::Add(new DevPathRec(key, devPath));
+        SkPathPriv::AddGenIDChangeListener(src, sk_make_sp<PathInvalidator>(key.getSharedID()));
+    }
+    // Keep what SkPath::transform() keeps: the source's fill type and dst's DAA hint.
+    const SkPath::FillType fillType = src.getFillType();
+    const bool isBadForDAA = SkPathPriv::IsBadForDAA(*dst);
+    *dst = std::move(devPath);
+    dst->setFillType(fillType);
+    SkPathPriv::SetIsBadForDAA(*dst, isBadForDAA);
+}
+
+sk_sp<SkData> SkEdgeCache::FindEdges(const SkPath& devPath, const SkIRect* clip,
+                                     uint32_t builderTag, int* count) {
+    EdgeRec::Result result;
+    if (!SkResourceCache::Find(EdgeKey(devPath, clip, builderTag), EdgeRec::Visitor, &result)) {
+        return nullptr;
+    }
+    *count = result.fCount;
+    return std::move(result.fEdges);
+}
+
+void SkEdgeCache::AddEdges(const SkPath& devPath, const SkIRect* clip, uint32_t builderTag,
+                           sk_sp<SkData> edges, int count) {
+    EdgeKey key(devPath, clip, builderTag);
+    SkResourceCache::Add(new EdgeRec(key, std::move(edges), count));
+    SkPathPriv::AddGenIDChangeListener(devPath,
+                                       sk_make_sp<PathInvalidator>(key.getSharedID()));
+}
@@ -0,0 +1,50 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkEdgeCache_DEFINED
+#define SkEdgeCache_DEFINED
+
+#include "SkData.h"
+#include "SkPath.h"
+#include "SkRect.h"
+
+class SkMatrix;
+
+/**
+ *  Caches the sorted edge lists that the scan converters build from immutable device paths in
+ *  SkResourceCache, keyed by the path's generation ID, the edge builder and the clip, so that
+ *  filling the same path again needn't build and sort its edges again. Entries are purged when
+ *  the path's SkPathRef changes or goes away.
+ *
+ *  Device paths are usually temporaries transformed from the caller's path, so this also caches
+ *  those, keyed by the source path's generation ID and the matrix: drawing the same path with the
+ *  same matrix then finds the same device path, and with it the same edges.
+ */
+class SkEdgeCache {
+public:
+    /** Only non-volatile paths with at least SK_EDGE_CACHE_MIN_POINTS points are cached. */
+    static bool WorthCaching(const SkPath&);
+
+    /**
+     *  Like SkPath::transform(), but if the source is worth caching, 'dst' shares the points of
+     *  the device path cached for the source and the matrix, adding it to the cache if needed.
+     */
+    static void TransformPath(const SkPath& src, const SkMatrix&, SkPath* dst);
+
+    /**
+     *  Returns the edges cached for the device path, the clip (null if the path needn't be
+     *  clipped) and 'builderTag', and sets 'count' to the number of edges, or returns null.
+     *  The edges are packed back to back, in their sorted order.
+     */
+    static sk_sp<SkData> FindEdges(const SkPath& devPath, const SkIRect* clip,
+                                   uint32_t builderTag, int* count);
+
+    static void AddEdges(const SkPath& devPath, const SkIRect* clip, uint32_t builderTag,
+                         sk_sp<SkData> edges, int count);
+};
+
+#endif
@@ -8,9 +8,11 @@
 #include "SkExecutor.h"
 #include "SkMakeUnique.h"
 #include "SkMutex.h"
+#include "SkRandom.h"
 #include "SkSemaphore.h"
 #include "SkSpinlock.h"
 #include "SkTArray.h"
+#include <atomic>
 #include <deque>
 #include <thread>
 
@@ -60,6 +62,7 @@ static inline std::function<void(void)> pop(SkTArray<std::function<void(void)>>*
 }
 
 // An SkThreadPool is an executor that runs work on a fixed pool of OS threads.
+// It keeps a WorkList for each priority, taking work from the most urgent one that has any.
 template <typename WorkList>
 class SkThreadPool final : public SkExecutor {
 public:
@@ -70,9 +73,9 @@ public:
     }
 
     ~SkThreadPool() override {
-        // Signal each thread that it's time to shut down.
+        // Signal each thread that it's time to shut down, once more urgent work is done.
         for (int i = 0; i < fThreads.count(); i++) {
-            this->add(nullptr);
+            this->addWithPriority(nullptr, Priority::kBackground);
         }
         // Wait for each thread to shut down.
         for (int i = 0; i < fThreads.count(); i++) {
@@ -81,10 +84,14 @@ public:
     }
 
     virtual void add(std::function<void(void)> work) override {
+        this->addWithPriority(std::move(work), Priority::kNormal);
+    }
+
+    void addWithPriority(std::function<void(void)> work, Priority priority) override {
         // Add some work to our pile of work to do.
         {
             SkAutoExclusive lock(fWorkLock);
-            fWork.emplace_back(std::move(work));
+            fWork[static_cast<int>(priority)].emplace_back(std::move(work));
         }
         // Tell the Loop() threads to pick it up.
         fWorkAvailable.signal(1);
@@ -103,8 +110,12 @@ private:
         std::function<void(void)> work;
         {
             SkAutoExclusive lock(fWorkLock);
-            SkASSERT(!fWork.empty());        // TODO: if (fWork.empty()) { return true; } ?
-            work = pop(&fWork);
+            int lane = 0;
+            while (fWork[lane].empty()) {
+                lane++;
+                SkASSERT(lane < kPriorityCount);
+            }
+            work = pop(&fWork[lane]);
         }
 
         if (!work) {
@@ -126,7 +137,7 @@ private:
     using Lock = SkMutex;
 
     SkTArray<std::thread> fThreads;
-    WorkList              fWork;
+    WorkList              fWork[kPriorityCount];
     Lock                  fWorkLock;
     SkSemaphore           fWorkAvailable;
 };
@@ -139,3 +150,282 @@ std::unique_ptr<SkExecutor> SkExecutor::MakeLIFOThreadPool(int threads) {
     using WorkList = SkTArray<std::function<void(void)>>;
     return skstd::make_unique<SkThreadPool<WorkList>>(threads > 0 ? threads : num_cores());
 }
+
+// A Chase-Lev work-stealing deque, following "Correct and Efficient Work-Stealing for Weak
+// Memory Models" (Lê et al., PPoPP '13).  Only its owner may push() and pop() at the bottom;
+// any thread may steal() from the top.  Work is passed around by pointer so slots stay atomic.
+class SkWorkStealingDeque {
+public:
+    using Work = std::function<void(void)>;
+
+    SkWorkStealingDeque() : fRing(new Ring(64)) {
+        fRings.emplace_back(fRing.load(std::memory_order_relaxed));
+    }
+
+    ~SkWorkStealingDeque() {
+        while (Work* work = this->pop()) {
+            delete work;
+        }
+    }
+
+    void push(Work* work) {
+        int64_t b = fBottom.load(std::memory_order_relaxed),
+                t = fTop.load(std::memory_order_acquire);
+        Ring* ring = fRing.load(std::memory_order_relaxed);
+        if (b - t > ring->fMask) {
+            ring = this->grow(ring, t, b);
+        }
+        ring->put(b, work);
+        std::atomic_thread_fence(std::memory_order_release);
+        fBottom.store(b + 1, std::memory_order_relaxed);
+    }
+
+    // Returns null if the deque is empty.
+    Work* pop() {
+        int64_t b = fBottom.load(std::memory_order_relaxed) - 1;
+        Ring* ring = fRing.load(std::memory_order_relaxed);
+        fBottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t t = fTop.load(std::memory_order_relaxed);
+
+        Work* work = nullptr;
+        if (t <= b) {
+            work = ring->get(b);
+            if (t == b) {
+                // This is the last item, so we may be racing thieves for it.
+                if (!fTop.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                                            std::memory_order_relaxed)) {
+                    work = nullptr;
+                }
+                fBottom.store(b + 1, std::memory_order_relaxed);
+            }
+        } else {
+            fBottom.store(b + 1, std::memory_order_relaxed);
+        }
+        return work;
+    }
+
+    // Returns null if the deque is empty, or if we lost a race for its top item.
+    Work* steal() {
+        int64_t t = fTop.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t b = fBottom.load(std::memory_order_acquire);
+        if (t >= b) {
+            return nullptr;
+        }
+        Work* work = fRing.load(std::memory_order_acquire)->get(t);
+        if (!fTop.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                                    std::memory_order_relaxed)) {
+            return nullptr;
+        }
+        return work;
+    }
+
+private:
+    struct Ring {
+        explicit Ring(int64_t capacity)
+            : fMask(capacity - 1)
+            , fSlots(new std::atomic<Work*>[capacity]) {}
+
+        Work* get(int64_t i) const { return fSlots[i & fMask].load(std::memory_order_relaxed); }
+        void  put(int64_t i, Work* w) { fSlots[i & fMask].store(w, std::memory_order_relaxed); }
+
+        const int64_t                         fMask;
+        std::unique_ptr<std::atomic<Work*>[]> fSlots;
+    };
+
+    Ring* grow(Ring* ring, int64_t t, int64_t b) {
+        auto bigger = new Ring(2 * (ring->fMask + 1));
+        for (int64_t i = t; i < b; i++) {
+            bigger->put(i, ring->get(i));
+        }
+        // Thieves may still be reading the old ring, so we keep it around until we're destroyed.
+        fRings.emplace_back(bigger);
+        fRing.store(bigger, std::memory_order_release);
+        return bigger;
+    }
+
+    std::atomic<int64_t>            fTop{0},
+                                    fBottom{0};
+    std::atomic<Ring*>              fRing;
+    SkTArray<std::unique_ptr<Ring>> fRings;  // Only touched by the deque's owner.
+};
+
+// An SkWorkStealingPool gives each of its threads its own deque.  Work added from a pool thread
+// goes onto that thread's deque, where it runs most-recent-first, and is only touched by other
+// threads when they run out of work of their own; work added from any other thread goes onto a
+// shared FIFO queue.  fWorkAvailable counts work not yet claimed, parking idle threads.
+// Frame-critical and background work each have a shared FIFO queue of their own, looked at
+// before and after everything else.
+class SkWorkStealingPool final : public SkExecutor {
+public:
+    using Work = std::function<void(void)>;
+
+    explicit SkWorkStealingPool(int threads)
+        : fWorkers(new Worker[threads])
+        , fWorkerCount(threads) {
+        for (int i = 0; i < threads; i++) {
+            fWorkers[i].fRand.setSeed(i + 1);
+            fWorkers[i].fThread = std::thread(&Loop, this, i);
+        }
+        // Threads look each other up by fThread, so they can't start until it's all written.
+        fStarted.signal(threads);
+    }
+
+    ~SkWorkStealingPool() override {
+        // Wake each thread one last time, so it can notice there's nothing left to do and exit.
+        fShuttingDown.store(true, std::memory_order_release);
+        fWorkAvailable.signal(fWorkerCount);
+        for (int i = 0; i < fWorkerCount; i++) {
+            fWorkers[i].fThread.join();
+        }
+        for (auto* queue : {&fUrgent, &fShared, &fBackground}) {
+            for (Work* work : *queue) {
+                delete work;
+            }
+        }
+    }
+
+    void add(Work work) override {
+        auto heapWork = new Work(std::move(work));
+        if (Worker* me = this->currentWorker()) {
+            me->fDeque.push(heapWork);
+        } else {
+            SkAutoExclusive lock(fSharedLock);
+            fShared.push_back(heapWork);
+        }
+        fWorkAvailable.signal(1);
+    }
+
+    void addWithPriority(Work work, Priority priority) override {
+        if (Priority::kNormal == priority) {
+            return this->add(std::move(work));
+        }
+        auto heapWork = new Work(std::move(work));
+        {
+            SkAutoExclusive lock(fSharedLock);
+            if (Priority::kFrameCritical == priority) {
+                fUrgent.push_back(heapWork);
+                fUrgentCount.fetch_add(1, std::memory_order_relaxed);
+            } else {
+                fBackground.push_back(heapWork);
+            }
+        }
+        fWorkAvailable.signal(1);
+    }
+
+    void borrow() override {
+        // If there is unclaimed work, claim it.  Pool threads will find their own first.
+        if (fWorkAvailable.try_wait()) {
+            if (Work* work = this->find_work(this->currentWorker())) {
+                this->run(work);
+            } else {
+                // We took one of the destructor's wake-ups; give it back for a pool thread.
+                fWorkAvailable.signal(1);
+            }
+        }
+    }
+
+private:
+    struct Worker {
+        SkWorkStealingDeque fDeque;
+        SkRandom            fRand;
+        std::thread         fThread;
+    };
+
+    Worker* currentWorker() {
+        // There are only ever a few threads, so a linear search is cheap enough.
+        std::thread::id id = std::this_thread::get_id();
+        for (int i = 0; i < fWorkerCount; i++) {
+            if (fWorkers[i].fThread.get_id() == id) {
+                return &fWorkers[i];
+            }
+        }
+        return nullptr;
+    }
+
+    // Call only after claiming a count from fWorkAvailable.  The work that count stands for
+    // might be anywhere, so we keep looking until we find it.  Returns null only at shutdown.
+    Work* find_work(Worker* me) {
+        for (;;) {
+            // The count spares us the lock in the usual case that nothing is urgent.
+            if (fUrgentCount.load(std::memory_order_relaxed) > 0) {
+                if (Work* work = this->pop_shared(&fUrgent)) {
+                    fUrgentCount.fetch_sub(1, std::memory_order_relaxed);
+                    return work;
+                }
+            }
+            if (me) {
+                if (Work* work = me->fDeque.pop()) {
+                    return work;
+                }
+            }
+            if (Work* work = this->pop_shared(&fShared)) {
+                return work;
+            }
+            // Try to steal from everyone, starting at a random victim to spread out contention.
+            int n = fWorkerCount,
+                start = me ? me->fRand.nextULessThan(n) : 0;
+            for (int i = 0; i < n; i++) {
+                Worker* victim = &fWorkers[(start + i) % n];
+                if (victim == me) {
+                    continue;
+                }
+                if (Work* work = victim->fDeque.steal()) {
+                    return work;
+                }
+            }
+            if (Work* work = this->pop_shared(&fBackground)) {
+                return work;
+            }
+            // Our count might have been one of the extras signaled by the destructor.
+            if (fShuttingDown.load(std::memory_order_acquire)) {
+                return nullptr;
+            }
+            std::this_thread::yield();
+        }
+    }
+
+    Work* pop_shared(std::deque<Work*>* queue) {
+        SkAutoExclusive lock(fSharedLock);
+        if (queue->empty()) {
+            return nullptr;
+        }
+        Work* work = queue->front();
+        queue->pop_front();
+        return work;
+    }
+
+    void run(Work* work) {
+        (*work)();
+        delete work;
+    }
+
+    static void Loop(SkWorkStealingPool* pool, int index) {
+        pool->fStarted.wait();
+        Worker* me = &pool->fWorkers[index];
+        for (;;) {
+            pool->fWorkAvailable.wait();
+            Work* work = pool->find_work(me);
+            if (!work) {
+                return;
+            }
+            pool->run(work);
+        }
+    }
+
+    std::unique_ptr<Worker[]> fWorkers;
+    const int                 fWorkerCount;
+    SkSemaphore               fStarted;
+    std::deque<Work*>         fUrgent,
+                              fShared,
+                              fBackground;
+    std::atomic<int>          fUrgentCount{0};
+    SkMutex                   fSharedLock;
+    SkSemaphore               fWorkAvailable;
+    std::atomic<bool>         fShuttingDown{false};
+};
+
+std::unique_ptr<SkExecutor> SkExecutor::MakeWorkStealingPool(int threads) {
+    return skstd::make_unique<SkWorkStealingPool>(threads > 0 ? threads : num_cores());
+}
@@ -72,10 +72,35 @@ struct EntryComparator {
 int gCount = 0;
 Entry gEntries[128];
 
+// Finalize() indexes gEntries by a hash of their names, so NameToFactory() usually needs just one
+// strcmp(). Each slot holds an index into gEntries plus one, or 0 if it's empty.
+uint8_t gNameIndex[2 * SK_ARRAY_COUNT(gEntries)];
+
+// FNV-1a. (SkOpts::hash() may change implementation once SkOpts is initialized.)
+uint32_t name_slot(const char name[]) {
+    uint32_t hash = 2166136261u;
+    for (; *name; ++name) {
+        hash = (hash ^ (uint8_t)*name) * 16777619u;
+    }
+    return hash & (SK_ARRAY_COUNT(gNameIndex) - 1);
+}
+
+uint32_t next_slot(uint32_t slot) {
+    return (slot + 1) & (SK_ARRAY_COUNT(gNameIndex) - 1);
+}
+
 }  // namespace
 
 void SkFlattenable::Finalize() {
     std::sort(gEntries, gEntries + gCount, EntryComparator());
+
+    for (int i = 0; i < gCount; ++i) {
+        uint32_t slot = name_slot(gEntries[i].fName);
+        while (gNameIndex[slot]) {
+            slot = next_slot(slot);
+        }
+        gNameIndex[slot] = SkToU8(i + 1);
+    }
 }
 
 void SkFlattenable::Register(const char name[], Factory factory) {
@@ -92,11 +117,13 @@ SkFlattenable::Factory SkFlattenable::NameToFactory(const char name[]) {
     RegisterFlattenablesIfNeeded();
 
     SkASSERT(std::is_sorted(gEntries, gEntries + gCount, EntryComparator()));
-    auto pair = std::equal_range(gEntries, gEntries + gCount, name, EntryComparator());
-    if (pair.first == pair.second) {
-        return nullptr;
+    for (uint32_t slot = name_slot(name); gNameIndex[slot]; slot = next_slot(slot)) {
+        const Entry& entry = gEntries[gNameIndex[slot] - 1];
+        if (0 == strcmp(entry.fName, name)) {
+            return entry.fFactory;
+        }
     }
-    return pair.first->fFactory;
+    return nullptr;
 }
 
 const char* SkFlattenable::FactoryToName(Factory fact) {
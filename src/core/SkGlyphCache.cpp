@@ -12,6 +12,9 @@
 #include "SkMutex.h"
 #include "SkOnce.h"
 #include "SkPath.h"
+#include "SkStrikeCache.h"
+#include "SkTArray.h"
+#include "SkTaskGroup.h"
 #include "SkTemplates.h"
 #include "SkTypeface.h"
 #include <cctype>
@@ -481,6 +484,73 @@ bool SkGlyphCache::hasPath(const SkGlyph& glyph) {
     return !glyph.isEmpty() && this->findPath(glyph) != nullptr;
 }
 
+void SkGlyphCache::prefetchImages(SkSpan<const SkGlyphID> glyphIDs, const SkPoint positions[]) {
+    // Rasterizing on other threads only pays for itself when each gets a few glyphs.
+    static constexpr int kMaxRasterThreads = 4;
+    static constexpr int kMinGlyphsPerRasterThread = 8;
+
+    SkExecutor* executor = SkStrikeCache::GlobalStrikeCache()->getRasterExecutor();
+    if (executor == nullptr && !fScalerContext->batchesImages()) {
+        // findImage will rasterize them one by one on this thread anyway.
+        return;
+    }
+
+    // Adding a glyph to fGlyphMap may move the others, so add them all before holding on to any.
+    for (size_t i = 0; i < glyphIDs.size(); i++) {
+        SkPoint pt = positions[i];
+        if (SkScalarsAreFinite(pt.x(), pt.y())) {
+            this->getGlyphMetrics(glyphIDs[i], pt);
+        }
+    }
+
+    // The arena is not thread safe, so the images are allocated up front. A glyph that is listed
+    // twice already has its image the second time, so it is only rasterized once.
+    SkSTArray<64, const SkGlyph*> missing;
+    for (size_t i = 0; i < glyphIDs.size(); i++) {
+        SkPoint pt = positions[i];
+        if (!SkScalarsAreFinite(pt.x(), pt.y())) {
+            continue;
+        }
+        const SkGlyph& glyph = this->getGlyphMetrics(glyphIDs[i], pt);
+        if (glyph.fWidth > 0 && glyph.fWidth < kMaxGlyphWidth && nullptr == glyph.fImage &&
+            !SkGlyphCacheCommon::GlyphTooBigForAtlas(glyph)) {
+            size_t size = const_cast<SkGlyph&>(glyph).allocImage(&fAlloc);
+            if (glyph.fImage) {
+                fMemoryUsed += size;
+                missing.push_back(&glyph);
+            }
+        }
+    }
+
+    int threads = executor ? SkTMin(kMaxRasterThreads, missing.count() / kMinGlyphsPerRasterThread)
+                           : 1;
+    while (threads > 1 && SkToInt(fRasterScalerContexts.size()) < threads - 1) {
+        auto context = fScalerContext->getTypeface()->createScalerContext(
+                fScalerContext->getEffects(), fDesc.getDesc(), true /* can fail */);
+        if (!context) {
+            threads = SkToInt(fRasterScalerContexts.size()) + 1;
+            break;
+        }
+        fRasterScalerContexts.push_back(std::move(context));
+    }
+
+    if (threads <= 1) {
+        fScalerContext->getImages(missing.begin(), missing.count());
+        return;
+    }
+
+    // Each thread takes every threads-th glyph, so runs of large and small glyphs are shared out.
+    SkTaskGroup(*executor).batch(threads, [&](int i) {
+        SkScalerContext* context = i == 0 ? fScalerContext.get()
+                                          : fRasterScalerContexts[i - 1].get();
+        SkSTArray<64, const SkGlyph*> glyphs;
+        for (int j = i; j < missing.count(); j += threads) {
+            glyphs.push_back(missing[j]);
+        }
+        context->getImages(glyphs.begin(), glyphs.count());
+    });
+}
+
 #ifdef SK_DEBUG
 void SkGlyphCache::forceValidate() const {
     size_t memoryUsed = sizeof(*this);
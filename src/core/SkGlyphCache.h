@@ -12,10 +12,11 @@
 #include "SkGlyph.h"
 #include "SkGlyphRunPainter.h"
 #include "SkPaint.h"
-#include "SkTHash.h"
 #include "SkScalerContext.h"
+#include "SkTSwissHash.h"
 #include "SkTemplates.h"
 #include <memory>
+#include <vector>
 
 /** \class SkGlyphCache
 
@@ -142,6 +143,13 @@ public:
 
     bool hasPath(const SkGlyph& glyph) override;
 
+    /** Generates the images that findImage would for the glyphs that fit in the GPU atlas and
+        don't have one yet, splitting them between copies of the scaler context that rasterize in
+        parallel on the executor set by SkGraphics::SetFontCacheRasterExecutor(). Does nothing if
+        there is no such executor. Glyphs at non-finite positions are skipped.
+    */
+    void prefetchImages(SkSpan<const SkGlyphID> glyphIDs, const SkPoint positions[]) override;
+
     /** Return the approx RAM usage for this cache. */
     size_t getMemoryUsed() const { return fMemoryUsed; }
 
@@ -149,6 +157,10 @@ public:
 
     SkScalerContext* getScalerContext() const { return fScalerContext.get(); }
 
+    // Calls fn(const SkGlyph&) for every glyph in the cache.
+    template <typename Fn>
+    void forEachGlyph(Fn&& fn) const { fGlyphMap.foreach(std::forward<Fn>(fn)); }
+
 #ifdef SK_DEBUG
     void forceValidate() const;
     void validate() const;
@@ -224,10 +236,12 @@ private:
 
     const SkAutoDescriptor fDesc;
     const std::unique_ptr<SkScalerContext> fScalerContext;
+    // Copies of fScalerContext, made as prefetchImages() needs them to rasterize on other threads.
+    std::vector<std::unique_ptr<SkScalerContext>> fRasterScalerContexts;
     SkFontMetrics          fFontMetrics;
 
     // Map from a combined GlyphID and sub-pixel position to a SkGlyph.
-    SkTHashTable<SkGlyph, SkPackedGlyphID, SkGlyph::HashTraits> fGlyphMap;
+    SkTSwissHashTable<SkGlyph, SkPackedGlyphID, SkGlyph::HashTraits> fGlyphMap;
 
     // so we don't grow our arrays a lot
     static constexpr size_t kMinGlyphCount = 8;
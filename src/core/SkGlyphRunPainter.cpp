@@ -214,6 +214,7 @@ void SkGlyphRunListPainter::drawForBitmapDevice(
             SkPoint rounding = cache->rounding();
             matrix.postTranslate(rounding.x(), rounding.y());
             matrix.mapPoints(fPositions, glyphRun.positions().data(), runSize);
+            cache->prefetchImages(glyphRun.glyphsIDs(), fPositions);
 
             SkTDArray<SkMask> masks;
             masks.setReserve(runSize);
@@ -372,6 +373,7 @@ void SkGlyphRunListPainter::drawGlyphRunAsBMPWithPathFallback(
     auto runSize = glyphRun.runSize();
     this->ensureBitmapBuffers(runSize);
     mapping.mapPoints(fPositions, glyphRun.positions().data(), runSize);
+    cache->prefetchImages(glyphRun.glyphsIDs(), fPositions);
     const SkPoint* mappedPtCursor = fPositions;
     for (auto glyphID : glyphRun.glyphsIDs()) {
         auto mappedPt = *mappedPtCursor++;
@@ -508,17 +510,46 @@ void GrTextContext::drawGlyphRunList(
     }
 
     if (cacheBlob) {
-        if (cacheBlob->mustRegenerate(listPaint, glyphRunList.anyRunsSubpixelPositioned(),
-                                      blurRec, viewMatrix, origin.x(),origin.y())) {
+        bool regenerate = cacheBlob->mustRegenerate(listPaint,
+                                                    glyphRunList.anyRunsSubpixelPositioned(),
+                                                    blurRec, viewMatrix, origin.x(), origin.y(),
+                                                    fOptions);
+        bool wasDistanceFieldForScaleChange = cacheBlob->distanceFieldForScaleChange();
+        bool forceDistanceField = false;
+        if (fOptions.fDistanceFieldTextForScaleChanges) {
+            bool sameScaleAsLastDraw = cacheBlob->updateLastViewMatrix(viewMatrix);
+            if (wasDistanceFieldForScaleChange) {
+                // Stay with distance fields while the scale keeps changing, and go back to the
+                // sharper bitmap glyphs once it has settled.
+                forceDistanceField = !sameScaleAsLastDraw;
+                regenerate |= sameScaleAsLastDraw;
+            } else {
+                forceDistanceField = regenerate && !cacheBlob->hasDistanceField() &&
+                                     cacheBlob->scaleChanged(viewMatrix);
+            }
+        }
+
+        if (regenerate) {
             // We have to remake the blob because changes may invalidate our masks.
             // TODO we could probably get away reuse most of the time if the pointer is unique,
             // but we'd have to clear the subrun information
             textBlobCache->remove(cacheBlob.get());
             cacheBlob = textBlobCache->makeCachedBlob(glyphRunList, key, blurRec, listPaint);
+            // Device independent fonts let any run that distance fields support use them.
+            uint32_t generateFlags = props.flags();
+            if (forceDistanceField) {
+                generateFlags |= SkSurfaceProps::kUseDeviceIndependentFonts_Flag;
+            }
+            SkSurfaceProps generateProps(generateFlags, props.pixelGeometry());
             cacheBlob->generateFromGlyphRunList(
                     glyphCache, *context->contextPriv().caps()->shaderCaps(), fOptions,
-                    listPaint, filteredColor, scalerContextFlags, viewMatrix, props,
+                    listPaint, filteredColor, scalerContextFlags, viewMatrix, generateProps,
                     glyphRunList, target->glyphPainter());
+            // Blobs that still have bitmap glyphs can't be reused at another scale anyway.
+            cacheBlob->setDistanceFieldForScaleChange(forceDistanceField &&
+                                                      !cacheBlob->hasBitmap());
+            textBlobCache->didRegenerate(cacheBlob->distanceFieldForScaleChange() !=
+                                         wasDistanceFieldForScaleChange);
         } else {
             textBlobCache->makeMRU(cacheBlob.get());
 
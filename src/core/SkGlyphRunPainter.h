@@ -26,6 +26,10 @@ public:
     virtual const SkGlyph& getGlyphMetrics(SkGlyphID glyphID, SkPoint position) = 0;
     virtual bool hasImage(const SkGlyph& glyph) = 0;
     virtual bool hasPath(const SkGlyph& glyph) = 0;
+
+    // Called before the images of a run's glyphs are asked for one by one, so that the missing
+    // ones can be generated together. positions are as they will be passed to getGlyphMetrics.
+    virtual void prefetchImages(SkSpan<const SkGlyphID> glyphIDs, const SkPoint positions[]) {}
 };
 
 class SkGlyphCacheCommon {
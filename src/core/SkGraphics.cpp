@@ -7,6 +7,7 @@
 
 #include "SkGraphics.h"
 
+#include "SkArenaAlloc.h"
 #include "SkBlitter.h"
 #include "SkCanvas.h"
 #include "SkCpu.h"
@@ -17,6 +18,7 @@
 #include "SkOpts.h"
 #include "SkPath.h"
 #include "SkPathEffect.h"
+#include "SkRasterPipeline.h"
 #include "SkRefCnt.h"
 #include "SkResourceCache.h"
 #include "SkScalerContext.h"
@@ -25,6 +27,7 @@
 #include "SkStrikeCache.h"
 #include "SkTSearch.h"
 #include "SkTime.h"
+#include "SkTraceMemoryDump.h"
 #include "SkTypefaceCache.h"
 #include "SkUTF.h"
 
@@ -53,14 +56,51 @@ void SkGraphics::Init() {
 void SkGraphics::DumpMemoryStatistics(SkTraceMemoryDump* dump) {
   SkResourceCache::DumpMemoryStatistics(dump);
   SkStrikeCache::DumpMemoryStatistics(dump);
+
+  for (auto site = SkArenaAlloc::Site::Head(); site; site = site->next()) {
+      SkString dumpName = SkStringPrintf("skia/arena_alloc/%s", site->name());
+      dump->dumpNumericValue(dumpName.c_str(), "high_water_mark", "bytes",
+                             site->highWaterMark());
+      dump->dumpNumericValue(dumpName.c_str(), "heap_count", "objects", site->heapCount());
+  }
+
+  MemoryCounters counters;
+  GetMemoryCounters(&counters);
+  for (int i = 0; i < MemoryCounters::kCounterCount; i++) {
+      auto counter = (MemoryCounters::Counter)i;
+      SkString dumpName = SkStringPrintf("skia/memory_counters/%s", MemoryCounters::Name(counter));
+      dump->dumpNumericValue(dumpName.c_str(), "size", "bytes", counters.fBytes[i]);
+      dump->dumpNumericValue(dumpName.c_str(), "peak_size", "bytes", counters.fPeakBytes[i]);
+  }
 }
 
 void SkGraphics::PurgeAllCaches() {
     SkGraphics::PurgeFontCache();
     SkGraphics::PurgeResourceCache();
+    SkGraphics::PurgeRasterPipelineCache();
     SkImageFilter::PurgeCache();
 }
 
+SkGraphics::MemoryPressureResult SkGraphics::PurgeForMemoryPressure(MemoryPressureLevel level,
+                                                                    size_t bytesToFree) {
+    MemoryPressureResult result;
+    SkStrikeCache* strikeCache = SkStrikeCache::GlobalStrikeCache();
+    if (MemoryPressureLevel::kCritical == level) {
+        result.fResourceCacheBytes = SkResourceCache::PurgeBytes(SIZE_MAX);
+        result.fFontCacheBytes = strikeCache->purgeBytes(strikeCache->getTotalMemoryUsed());
+        result.fTypefaceCount = SkTypefaceCache::PurgeAll();
+        SkGraphics::PurgeRasterPipelineCache();
+        SkImageFilter::PurgeCache();
+        return result;
+    }
+
+    result.fResourceCacheBytes = SkResourceCache::PurgeBytes(bytesToFree);
+    if (result.fResourceCacheBytes < bytesToFree) {
+        result.fFontCacheBytes = strikeCache->purgeBytes(bytesToFree - result.fResourceCacheBytes);
+    }
+    return result;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 static const char kFontCacheLimitStr[] = "font-cache-limit";
@@ -141,6 +181,30 @@ int SkGraphics::SetFontCachePointSizeLimit(int limit) {
     return SkStrikeCache::GlobalStrikeCache()->setCachePointSizeLimit(limit);
 }
 
+SkExecutor* SkGraphics::GetFontCacheRasterExecutor() {
+    return SkStrikeCache::GlobalStrikeCache()->getRasterExecutor();
+}
+
+SkExecutor* SkGraphics::SetFontCacheRasterExecutor(SkExecutor* executor) {
+    return SkStrikeCache::GlobalStrikeCache()->setRasterExecutor(executor);
+}
+
+int SkGraphics::GetRasterPipelineCacheCountUsed() {
+    return SkRasterPipeline::ProgramCacheCountUsed();
+}
+
+int SkGraphics::GetRasterPipelineCacheHitCount() {
+    return SkRasterPipeline::ProgramCacheHitCount();
+}
+
+int SkGraphics::GetRasterPipelineCacheMissCount() {
+    return SkRasterPipeline::ProgramCacheMissCount();
+}
+
+void SkGraphics::PurgeRasterPipelineCache() {
+    SkRasterPipeline::PurgeProgramCache();
+}
+
 void SkGraphics::PurgeFontCache() {
     SkStrikeCache::GlobalStrikeCache()->purgeAll();
     SkTypefaceCache::PurgeAll();
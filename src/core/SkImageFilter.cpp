@@ -10,6 +10,7 @@
 #include "SkCanvas.h"
 #include "SkFuzzLogging.h"
 #include "SkImageFilterCache.h"
+#include "SkImageFilterPriv.h"
 #include "SkLocalMatrixImageFilter.h"
 #include "SkMatrixImageFilter.h"
 #include "SkReadBuffer.h"
@@ -17,6 +18,7 @@
 #include "SkSafe32.h"
 #include "SkSpecialImage.h"
 #include "SkSpecialSurface.h"
+#include "SkTaskGroup.h"
 #include "SkValidationUtils.h"
 #include "SkWriteBuffer.h"
 #if SK_SUPPORT_GPU
@@ -69,6 +71,8 @@ void SkImageFilter::CropRect::applyTo(const SkIRect& imageBounds,
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
+std::atomic<int> gSkImageFilterTileSize{0};
+
 static int32_t next_image_filter_unique_id() {
     static std::atomic<int32_t> nextID{1};
 
@@ -167,10 +171,27 @@ sk_sp<SkSpecialImage> SkImageFilter::filterImage(SkSpecialImage* src, const Cont
 
     uint32_t srcGenID = fUsesSrcInput ? src->uniqueID() : 0;
     const SkIRect srcSubset = fUsesSrcInput ? src->subset() : SkIRect::MakeWH(0, 0);
-    SkImageFilterCacheKey key(fUniqueID, context.ctm(), context.clipBounds(), srcGenID, srcSubset);
+
+    // If the filter doesn't read the source, moving the CTM by whole pixels just moves the result.
+    // Such results are cached relative to the CTM with its whole-pixel translation removed, so
+    // they are reused as the content scrolls.
+    SkMatrix cacheCTM = context.ctm();
+    SkIPoint cacheShift = SkIPoint::Make(0, 0);
+    static constexpr SkScalar kMaxCacheShift = 1 << 24;
+    if (!fUsesSrcInput && !cacheCTM.hasPerspective() &&
+        SkScalarAbs(cacheCTM.getTranslateX()) < kMaxCacheShift &&
+        SkScalarAbs(cacheCTM.getTranslateY()) < kMaxCacheShift) {
+        cacheShift.set(sk_float_floor2int(cacheCTM.getTranslateX()),
+                       sk_float_floor2int(cacheCTM.getTranslateY()));
+        cacheCTM.postTranslate(-SkIntToScalar(cacheShift.fX), -SkIntToScalar(cacheShift.fY));
+    }
+    SkImageFilterCacheKey key(fUniqueID, cacheCTM,
+                              context.clipBounds().makeOffset(-cacheShift.fX, -cacheShift.fY),
+                              srcGenID, srcSubset);
     if (context.cache()) {
         sk_sp<SkSpecialImage> result = context.cache()->get(key, offset);
         if (result) {
+            *offset += cacheShift;
             return result;
         }
     }
@@ -187,7 +208,14 @@ sk_sp<SkSpecialImage> SkImageFilter::filterImage(SkSpecialImage* src, const Cont
 #endif
 
     if (result && context.cache()) {
-        context.cache()->set(key, result.get(), *offset, this);
+        // Clip bounds only cut a filter's output at or outside their edges, so a result that stays
+        // clear of them is everything the filter draws, unless it fills transparent black too.
+        SkIRect resultBounds = SkIRect::MakeXYWH(offset->fX, offset->fY,
+                                                 result->width(), result->height());
+        resultBounds.outset(1, 1);
+        bool unclipped = context.clipBounds().contains(resultBounds) &&
+                         this->canComputeFastBounds();
+        context.cache()->set(key, result.get(), *offset - cacheShift, this, unclipped);
     }
 
     return result;
@@ -285,6 +313,17 @@ bool SkImageFilter::asAColorFilter(SkColorFilter** filterPtr) const {
     return true;
 }
 
+bool SkImageFilter::asAnOffset(SkVector* offset) const {
+    SkVector nodeOffset;
+    if (!this->onIsOffsetNode(&nodeOffset) || this->getInput(0)) {
+        return false;
+    }
+    if (offset) {
+        *offset = nodeOffset;
+    }
+    return true;
+}
+
 bool SkImageFilter::canHandleComplexCTM() const {
     if (!this->onCanHandleComplexCTM()) {
         return false;
@@ -464,6 +503,49 @@ sk_sp<SkSpecialImage> SkImageFilter::filterInput(int index,
     return result;
 }
 
+void SkImageFilter::filterInputs(SkSpecialImage* src, const Context& ctx,
+                                 sk_sp<SkSpecialImage> results[], SkIPoint offsets[]) const {
+    int count = this->countInputs();
+    // GPU filters must run on the thread that owns the GrContext.
+    if (count < 2 || src->isTextureBacked()) {
+        for (int i = 0; i < count; ++i) {
+            results[i] = this->filterInput(i, src, ctx, &offsets[i]);
+        }
+        return;
+    }
+
+    // Inputs repeated in a DAG are only filtered once; the copies share that result.
+    SkAutoSTArray<8, int> firstUse(count);
+    SkAutoSTArray<8, int> unique(count);
+    int uniqueCount = 0;
+    for (int i = 0; i < count; ++i) {
+        firstUse[i] = i;
+        for (int j = 0; j < i; ++j) {
+            if (this->getInput(j) == this->getInput(i)) {
+                firstUse[i] = firstUse[j];
+                break;
+            }
+        }
+        if (firstUse[i] == i) {
+            unique[uniqueCount++] = i;
+        }
+    }
+
+    SkTaskGroup tg;
+    tg.batch(uniqueCount, [&](int u) {
+        int i = unique[u];
+        results[i] = this->filterInput(i, src, ctx, &offsets[i]);
+    });
+    tg.wait();
+
+    for (int i = 0; i < count; ++i) {
+        if (firstUse[i] != i) {
+            results[i] = results[firstUse[i]];
+            offsets[i] = offsets[firstUse[i]];
+        }
+    }
+}
+
 void SkImageFilter::PurgeCache() {
     SkImageFilterCache::Get()->purge();
 }
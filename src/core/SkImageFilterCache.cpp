@@ -41,10 +41,14 @@ public:
         }
     }
     struct Value {
-        Value(const Key& key, SkSpecialImage* image, const SkIPoint& offset, const SkImageFilter* filter)
-            : fKey(key), fImage(SkRef(image)), fOffset(offset), fFilter(filter) {}
+        Value(const Key& key, SkSpecialImage* image, const SkIPoint& offset,
+              const SkImageFilter* filter, bool unclipped)
+            : fKey(LookupKey(key)), fClipBounds(key.fClipBounds), fUnclipped(unclipped)
+            , fImage(SkRef(image)), fOffset(offset), fFilter(filter) {}
 
         Key fKey;
+        SkIRect fClipBounds;
+        bool fUnclipped;
         sk_sp<SkSpecialImage> fImage;
         SkIPoint fOffset;
         const SkImageFilter* fFilter;
@@ -57,25 +61,39 @@ public:
         SK_DECLARE_INTERNAL_LLIST_INTERFACE(Value);
     };
 
+    // Entries are looked up without their clip bounds, which are checked separately.
+    static Key LookupKey(const Key& key) {
+        Key lookupKey = key;
+        lookupKey.fClipBounds.setEmpty();
+        return lookupKey;
+    }
+
     sk_sp<SkSpecialImage> get(const Key& key, SkIPoint* offset) const override {
         SkAutoMutexAcquire mutex(fMutex);
-        if (Value* v = fLookup.find(key)) {
-            *offset = v->fOffset;
-            if (v != fLRU.head()) {
-                fLRU.remove(v);
-                fLRU.addToHead(v);
-            }
-            return v->fImage;
+        Value* v = fLookup.find(LookupKey(key));
+        if (!v || !(v->fUnclipped || v->fClipBounds.contains(key.fClipBounds))) {
+            fStats.fMisses++;
+            return nullptr;
+        }
+        fStats.fHits++;
+        if (v->fClipBounds != key.fClipBounds) {
+            fStats.fClipReuseHits++;
         }
-        return nullptr;
+        *offset = v->fOffset;
+        if (v != fLRU.head()) {
+            fLRU.remove(v);
+            fLRU.addToHead(v);
+        }
+        return v->fImage;
     }
 
-    void set(const Key& key, SkSpecialImage* image, const SkIPoint& offset, const SkImageFilter* filter) override {
+    void set(const Key& key, SkSpecialImage* image, const SkIPoint& offset,
+             const SkImageFilter* filter, bool unclipped) override {
         SkAutoMutexAcquire mutex(fMutex);
-        if (Value* v = fLookup.find(key)) {
+        if (Value* v = fLookup.find(LookupKey(key))) {
             this->removeInternal(v);
         }
-        Value* v = new Value(key, image, offset, filter);
+        Value* v = new Value(key, image, offset, filter, unclipped);
         fLookup.add(v);
         fLRU.addToHead(v);
         fCurrentBytes += image->getSize();
@@ -119,6 +137,11 @@ public:
         fImageFilterValues.remove(filter);
     }
 
+    Stats stats() const override {
+        SkAutoMutexAcquire mutex(fMutex);
+        return fStats;
+    }
+
     SkDEBUGCODE(int count() const override { return fLookup.count(); })
 private:
     void removeInternal(Value* v) {
@@ -149,6 +172,7 @@ private:
     SkTHashMap<const SkImageFilter*, std::vector<Value*>> fImageFilterValues;
     size_t                                                fMaxBytes;
     size_t                                                fCurrentBytes;
+    mutable Stats                                         fStats;
     mutable SkMutex                                       fMutex;
 };
 
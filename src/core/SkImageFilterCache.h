@@ -20,12 +20,12 @@ struct SkImageFilterCacheKey {
         const SkIRect& clipBounds, uint32_t srcGenID, const SkIRect& srcSubset)
         : fUniqueID(uniqueID)
         , fMatrix(matrix)
-        , fClipBounds(clipBounds)
         , fSrcGenID(srcGenID)
-        , fSrcSubset(srcSubset) {
+        , fSrcSubset(srcSubset)
+        , fClipBounds(clipBounds) {
         // Assert that Key is tightly-packed, since it is hashed.
         static_assert(sizeof(SkImageFilterCacheKey) == sizeof(uint32_t) + sizeof(SkMatrix) +
-                                     sizeof(SkIRect) + sizeof(uint32_t) + 4 * sizeof(int32_t),
+                                     sizeof(uint32_t) + 4 * sizeof(int32_t) + sizeof(SkIRect),
                                      "image_filter_key_tight_packing");
         fMatrix.getType();  // force initialization of type, so hashes match
         SkASSERT(fMatrix.isFinite());   // otherwise we can't rely on == self when comparing keys
@@ -33,9 +33,10 @@ struct SkImageFilterCacheKey {
 
     uint32_t fUniqueID;
     SkMatrix fMatrix;
-    SkIRect fClipBounds;
     uint32_t fSrcGenID;
     SkIRect fSrcSubset;
+    // Not hashed: a cached result is found for any clip its own clip contains (see set()).
+    SkIRect fClipBounds;
 
     bool operator==(const SkImageFilterCacheKey& other) const {
         return fUniqueID == other.fUniqueID &&
@@ -46,20 +47,32 @@ struct SkImageFilterCacheKey {
     }
 };
 
-// This cache maps from (filter's unique ID + CTM + clipBounds + src bitmap generation ID) to
-// (result, offset).
+// This cache maps from (filter's unique ID + CTM + src bitmap generation ID) to (result, offset).
+// A result is found for a key's clipBounds if it was made for clip bounds that contain them, or
+// if it was not cut by its clip bounds at all.
 class SkImageFilterCache : public SkRefCnt {
 public:
     enum { kDefaultTransientSize = 32 * 1024 * 1024 };
 
+    struct Stats {
+        int fHits = 0;
+        int fMisses = 0;
+        // The hits whose clip bounds differed from those the result was made for.
+        int fClipReuseHits = 0;
+    };
+
     virtual ~SkImageFilterCache() {}
     static SkImageFilterCache* Create(size_t maxBytes);
     static SkImageFilterCache* Get();
     virtual sk_sp<SkSpecialImage> get(const SkImageFilterCacheKey& key, SkIPoint* offset) const = 0;
+    // If unclipped is true, the result holds everything the filter draws, so it can be used for
+    // any clip bounds.
     virtual void set(const SkImageFilterCacheKey& key, SkSpecialImage* image,
-                     const SkIPoint& offset, const SkImageFilter* filter) = 0;
+                     const SkIPoint& offset, const SkImageFilter* filter,
+                     bool unclipped = false) = 0;
     virtual void purge() = 0;
     virtual void purgeByImageFilter(const SkImageFilter*) = 0;
+    virtual Stats stats() const = 0;
     SkDEBUGCODE(virtual int count() const = 0;)
 };
 
@@ -10,6 +10,17 @@
 
 #include "SkImageFilter.h"
 
+#include <atomic>
+
+/**
+ *  When positive, raster devices evaluate an image filter DAG one square tile of this many pixels
+ *  of the clip at a time, drawing each tile's result before filtering the next. This bounds the
+ *  size of the intermediate images to about a tile (plus each node's margins) instead of the whole
+ *  clip. Per-tile results are cached in SkImageFilterCache like any other result. Zero (the
+ *  default) filters the whole clip at once.
+ */
+extern std::atomic<int> gSkImageFilterTileSize;
+
 /**
  *  Helper to unflatten the common data, and return nullptr if we fail.
  */
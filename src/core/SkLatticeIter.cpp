@@ -164,6 +164,8 @@ SkLatticeIter::SkLatticeIter(const SkCanvas::Lattice& lattice, const SkRect& dst
     fCurrX = fCurrY = 0;
     fNumRectsInLattice = (xCount + 1) * (yCount + 1);
     fNumRectsToDraw = fNumRectsInLattice;
+    fIsNinePatch = 2 == xCount && !xIsScalable && 2 == yCount && !yIsScalable &&
+                   !lattice.fRectTypes;
 
     if (lattice.fRectTypes) {
         fRectTypes.push_back_n(fNumRectsInLattice);
@@ -251,6 +253,7 @@ SkLatticeIter::SkLatticeIter(int w, int h, const SkIRect& c, const SkRect& dst)
     fCurrX = fCurrY = 0;
     fNumRectsInLattice = 9;
     fNumRectsToDraw = 9;
+    fIsNinePatch = true;
 }
 
 bool SkLatticeIter::next(SkIRect* src, SkRect* dst, bool* isFixedColor, SkColor* fixedColor) {
@@ -300,3 +303,31 @@ void SkLatticeIter::mapDstScaleTranslate(const SkMatrix& matrix) {
         fDstY[i] = fDstY[i] * sy + ty;
     }
 }
+
+bool SkLatticeIter::isNinePatch(SkIRect* src, SkIRect* center) const {
+    if (!fIsNinePatch) {
+        return false;
+    }
+    SkASSERT(4 == fSrcX.count() && 4 == fSrcY.count());
+    src->set(fSrcX[0], fSrcY[0], fSrcX[3], fSrcY[3]);
+    center->set(fSrcX[1], fSrcY[1], fSrcX[2], fSrcY[2]);
+    return true;
+}
+
+static bool is_integer_translate(const SkTArray<int>& src, const SkTArray<SkScalar>& dst,
+                                 SkScalar offset) {
+    for (int i = 0; i < dst.count(); i++) {
+        SkScalar d = dst[i] + offset;
+        if (d != SkScalarFloorToScalar(d)) {
+            return false;
+        }
+        if (i > 0 && dst[i] - dst[i - 1] != SkIntToScalar(src[i] - src[i - 1])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool SkLatticeIter::isIntegerTranslate(SkScalar dx, SkScalar dy) const {
+    return is_integer_translate(fSrcX, fDstX, dx) && is_integer_translate(fSrcY, fDstY, dy);
+}
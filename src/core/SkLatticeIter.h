@@ -60,6 +60,19 @@ public:
         return fNumRectsToDraw;
     }
 
+    /**
+     *  Returns true if the lattice is a plain nine-patch: fixed corners, a scalable center, and no
+     *  rect types. If so, sets src to its bounds and center to its center. Call this before
+     *  mapDstScaleTranslate(); the answer doesn't depend on the dst.
+     */
+    bool isNinePatch(SkIRect* src, SkIRect* center) const;
+
+    /**
+     *  Returns true if, once offset by (dx, dy), every dst rect lands on whole pixels at the size
+     *  of its src rect, i.e. the patches could be copied rather than resampled.
+     */
+    bool isIntegerTranslate(SkScalar dx, SkScalar dy) const;
+
 private:
     SkTArray<int> fSrcX;
     SkTArray<int> fSrcY;
@@ -72,6 +85,7 @@ private:
     int  fCurrY;
     int  fNumRectsInLattice;
     int  fNumRectsToDraw;
+    bool fIsNinePatch;
 };
 
 #endif
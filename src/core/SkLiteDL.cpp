@@ -328,17 +328,21 @@ namespace {
     };
     struct DrawImageSet final : Op {
         static const auto kType = Type::DrawImageSet;
-        DrawImageSet(const SkCanvas::ImageSetEntry set[], int count, SkFilterQuality quality,
-                     SkBlendMode xfermode)
-                : count(count), quality(quality), xfermode(xfermode), set(count) {
+        DrawImageSet(const SkCanvas::ImageSetEntry set[], int count, int matrixCount,
+                     SkFilterQuality quality, SkBlendMode xfermode)
+                : count(count), matrixCount(matrixCount), quality(quality), xfermode(xfermode)
+                , set(count) {
             std::copy_n(set, count, this->set.get());
         }
         int                                   count;
+        int                                   matrixCount;
         SkFilterQuality                       quality;
         SkBlendMode                           xfermode;
         SkAutoTArray<SkCanvas::ImageSetEntry> set;
         void draw(SkCanvas* c, const SkMatrix&) const {
-            c->experimental_DrawImageSetV1(set.get(), count, quality, xfermode);
+            c->experimental_DrawImageSetV2(set.get(), count,
+                                           matrixCount ? pod<SkMatrix>(this) : nullptr, quality,
+                                           xfermode);
         }
     };
     struct DrawText final : Op {
@@ -620,8 +624,15 @@ void SkLiteDL::drawImageLattice(sk_sp<const SkImage> image, const SkCanvas::Latt
 }
 
 void SkLiteDL::drawImageSet(const SkCanvas::ImageSetEntry set[], int count,
-                            SkFilterQuality filterQuality, SkBlendMode mode) {
-    this->push<DrawImageSet>(0, set, count, filterQuality, mode);
+                            const SkMatrix preViewMatrices[], SkFilterQuality filterQuality,
+                            SkBlendMode mode) {
+    int matrixCount = 0;
+    for (int i = 0; i < count; ++i) {
+        matrixCount = SkTMax(matrixCount, set[i].fMatrixIndex + 1);
+    }
+    void* pod = this->push<DrawImageSet>(matrixCount * sizeof(SkMatrix), set, count, matrixCount,
+                                         filterQuality, mode);
+    copy_v(pod, preViewMatrices, matrixCount);
 }
 
 void SkLiteDL::drawText(const void* text, size_t bytes,
@@ -160,8 +160,9 @@ void SkLiteRecorder::onDrawImageLattice(const SkImage* img,
 }
 
 void SkLiteRecorder::onDrawImageSet(const ImageSetEntry set[], int count,
+                                    const SkMatrix preViewMatrices[],
                                     SkFilterQuality filterQuality, SkBlendMode mode) {
-    fDL->drawImageSet(set, count, filterQuality, mode);
+    fDL->drawImageSet(set, count, preViewMatrices, filterQuality, mode);
 }
 
 void SkLiteRecorder::onDrawPatch(const SkPoint cubics[12],
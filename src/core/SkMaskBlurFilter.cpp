@@ -12,6 +12,7 @@
 #include "SkGaussFilter.h"
 #include "SkMalloc.h"
 #include "SkNx.h"
+#include "SkTaskGroup.h"
 #include "SkTemplates.h"
 #include "SkTo.h"
 
@@ -949,6 +950,198 @@ static SkIPoint small_blur(double sigmaX, double sigmaY, const SkMask& src, SkMa
     return {radiusX, radiusY};
 }
 
+// Masks blurred with a sigma of at least kLargeSigma are blurred at a reduced resolution: the mask
+// is box-downsampled, blurred with a proportionally smaller sigma, and bilinearly upsampled. Each
+// axis is reduced by a factor that leaves a sigma of about kLowResSigma.
+//
+// Both resampling steps are small blurs themselves. Averaging f pixels has variance (f*f - 1)/12,
+// and the tent of the bilinear upsample has variance f*f/6, so they are taken out of the reduced
+// sigma. What remains is the error of resampling a function this smooth, which at these sigmas is
+// well below the error of approximating a gaussian with three box passes in the first place.
+static constexpr double kLargeSigma  = 64.0;
+static constexpr double kLowResSigma = 16.0;
+
+// Rows are split into tasks of this many rows for SkTaskGroup.
+static constexpr int kRowsPerTask = 32;
+
+static int downsample_factor(double sigma) {
+    return std::max(1, static_cast<int>(sigma / kLowResSigma));
+}
+
+static double low_res_sigma(double sigma, int factor) {
+    if (factor == 1) {
+        return sigma;
+    }
+    double f2 = factor * factor;
+    double variance = sigma * sigma - (f2 - 1) / 12 - f2 / 6;
+    return sqrt(std::max(variance, 0.0)) / factor;
+}
+
+// Converts width mask values of a row to A8. Formats other than A8 are converted 8 values at a
+// time; strideOf8 is the number of bytes taken by 8 values.
+static void row_to_a8(ToA8* toA8, int strideOf8, const uint8_t* from, int width, uint8_t* a8) {
+    if (!toA8) {
+        memcpy(a8, from, width);
+        return;
+    }
+    for (int x = 0; x < width; x += 8, from += strideOf8) {
+        toA8(a8 + x, from, std::min(8, width - x));
+    }
+}
+
+// Averages fx by fy blocks of src into the A8 mask low. Blocks hanging off the right or bottom of
+// src are averaged as if padded with zeros.
+static void downsample(ToA8* toA8, int strideOf8, const SkMask& src, int fx, int fy,
+                       const SkMask& low) {
+    int srcW = src.fBounds.width(),
+        srcH = src.fBounds.height(),
+        lowW = low.fBounds.width(),
+        lowH = low.fBounds.height();
+    uint32_t divisor = fx * fy;
+
+    SkTaskGroup tg;
+    tg.parallelFor(lowH, kRowsPerTask, [&](int lowTop, int lowBottom) {
+        // Column sums of up to fy rows fit in 16 bits: fy is at most 136 / kLowResSigma.
+        SkAutoTMalloc<uint16_t> sums(SkAlign8(srcW) + 8 * fx);
+        // Only the first srcW values are ever written, so the tail stays zero for the Sk8h loads.
+        SkAutoTMalloc<uint8_t>  a8(SkAlign8(srcW));
+        sk_bzero(a8.get(), SkAlign8(srcW));
+        for (int ly = lowTop; ly < lowBottom; ++ly) {
+            sk_bzero(sums.get(), (SkAlign8(srcW) + 8 * fx) * sizeof(uint16_t));
+            int rowBottom = std::min(srcH, (ly + 1) * fy);
+            for (int y = ly * fy; y < rowBottom; ++y) {
+                row_to_a8(toA8, strideOf8, src.fImage + y * src.fRowBytes, srcW, a8.get());
+                for (int x = 0; x < srcW; x += 8) {
+                    Sk8h sum = Sk8h::Load(&sums[x]) + SkNx_cast<uint16_t>(Sk8b::Load(&a8[x]));
+                    sum.store(&sums[x]);
+                }
+            }
+            uint8_t* lowRow = low.fImage + ly * low.fRowBytes;
+            for (int lx = 0; lx < lowW; ++lx) {
+                uint32_t sum = 0;
+                for (int i = 0; i < fx; ++i) {
+                    sum += sums[lx * fx + i];
+                }
+                lowRow[lx] = SkTo<uint8_t>((sum + divisor / 2) / divisor);
+            }
+        }
+    });
+}
+
+// For each of count destination pixels along one axis, finds the blurred low resolution pixel
+// to its left (or top) and the weight of the one after it. Destination pixel d sits at
+// d - border + 0.5 in source coordinates, and low resolution pixel p is centered at
+// (p - lowBorder + 0.5) * factor. Pixels outside the low resolution mask read as zero; their
+// index is clamped into the zero padding around it.
+static void plan_upsample(int count, int border, int factor, int lowBorder, int lowCount,
+                          int* index, float* weight) {
+    for (int d = 0; d < count; ++d) {
+        double p = (d - border + 0.5) / factor - 0.5 + lowBorder;
+        double p0 = floor(p);
+        index[d] = static_cast<int>(p0);
+        weight[d] = static_cast<float>(p - p0);
+        if (index[d] < -1) {
+            index[d] = -1;
+            weight[d] = 0;
+        } else if (index[d] >= lowCount) {
+            index[d] = lowCount;
+            weight[d] = 0;
+        }
+    }
+}
+
+static SkIPoint large_blur(double sigmaW, double sigmaH, int borderW, int borderH,
+                           const SkMask& src, SkMask* dst) {
+    ToA8* toA8;
+    int strideOf8;
+    switch (src.fFormat) {
+        case SkMask::kBW_Format:     toA8 = bw_to_a8;     strideOf8 = 1;  break;
+        case SkMask::kA8_Format:     toA8 = nullptr;      strideOf8 = 8;  break;
+        case SkMask::kARGB32_Format: toA8 = argb32_to_a8; strideOf8 = 32; break;
+        case SkMask::kLCD16_Format:  toA8 = lcd_to_a8;    strideOf8 = 16; break;
+        default:
+            SK_ABORT("Unhandled format.");
+            return {0, 0};
+    }
+
+    int fx = downsample_factor(sigmaW),
+        fy = downsample_factor(sigmaH);
+
+    int srcW = src.fBounds.width(),
+        srcH = src.fBounds.height(),
+        dstW = dst->fBounds.width(),
+        dstH = dst->fBounds.height();
+
+    SkMask low;
+    low.fBounds.set(0, 0, (srcW + fx - 1) / fx, (srcH + fy - 1) / fy);
+    low.fRowBytes = low.fBounds.width();
+    low.fFormat = SkMask::kA8_Format;
+    low.fImage = SkMask::AllocImage(low.computeImageSize());
+    SkAutoMaskFreeImage lowImage(low.fImage);
+    downsample(toA8, strideOf8, src, fx, fy, low);
+
+    SkMaskBlurFilter lowFilter{low_res_sigma(sigmaW, fx), low_res_sigma(sigmaH, fy)};
+    SkMask blurred;
+    SkIPoint lowBorder = lowFilter.blur(low, &blurred);
+    SkAutoMaskFreeImage blurredImage(blurred.fImage);
+    if (blurred.fImage == nullptr) {
+        sk_bzero(dst->fImage, dst->computeImageSize());
+        return {SkTo<int32_t>(borderW), SkTo<int32_t>(borderH)};
+    }
+    int blurredW = blurred.fBounds.width(),
+        blurredH = blurred.fBounds.height();
+
+    SkAutoTMalloc<int>   indexX(dstW), indexY(dstH);
+    SkAutoTMalloc<float> weightX(dstW), weightY(dstH);
+    plan_upsample(dstW, borderW, fx, lowBorder.fX, blurredW, indexX.get(), weightX.get());
+    plan_upsample(dstH, borderH, fy, lowBorder.fY, blurredH, indexY.get(), weightY.get());
+
+    SkTaskGroup tg;
+    tg.parallelFor(dstH, kRowsPerTask, [&](int dstTop, int dstBottom) {
+        // Holds a vertically interpolated row, with a zero on the left and one past the right.
+        int rowSize = SkAlign4(blurredW) + 2;
+        SkAutoTMalloc<float> row(rowSize + 4);
+        float* rowStart = row.get() + 1;
+        for (int y = dstTop; y < dstBottom; ++y) {
+            sk_bzero(row.get(), (rowSize + 4) * sizeof(float));
+            int   iy = indexY[y];
+            float ty = weightY[y];
+            const uint8_t* row0 = 0 <= iy && iy < blurredH
+                                ? blurred.fImage + iy * blurred.fRowBytes : nullptr;
+            const uint8_t* row1 = 0 <= iy + 1 && iy + 1 < blurredH
+                                ? blurred.fImage + (iy + 1) * blurred.fRowBytes : nullptr;
+            Sk4f w0{1 - ty},
+                 w1{ty};
+            for (int x = 0; x < blurredW; x += 4) {
+                int n = std::min(4, blurredW - x);
+                uint8_t a0[4] = {0, 0, 0, 0},
+                        a1[4] = {0, 0, 0, 0};
+                for (int i = 0; i < n; ++i) {
+                    if (row0) { a0[i] = row0[x + i]; }
+                    if (row1) { a1[i] = row1[x + i]; }
+                }
+                Sk4f v = SkNx_cast<float>(Sk4b::Load(a0)) * w0 +
+                         SkNx_cast<float>(Sk4b::Load(a1)) * w1;
+                v.store(rowStart + x);
+            }
+            // The loads above may have written up to 3 values past blurredW; they must read as 0.
+            for (int x = blurredW; x < blurredW + 4; ++x) {
+                rowStart[x] = 0;
+            }
+
+            uint8_t* dstRow = dst->fImage + y * dst->fRowBytes;
+            for (int x = 0; x < dstW; ++x) {
+                int   ix = indexX[x];
+                float tx = weightX[x];
+                float v = rowStart[ix] * (1 - tx) + rowStart[ix + 1] * tx;
+                dstRow[x] = SkTo<uint8_t>(std::min(255, static_cast<int>(v + 0.5f)));
+            }
+        }
+    });
+
+    return {SkTo<int32_t>(borderW), SkTo<int32_t>(borderH)};
+}
+
 // TODO: assuming sigmaW = sigmaH. Allow different sigmas. Right now the
 // API forces the sigmas to be the same.
 SkIPoint SkMaskBlurFilter::blur(const SkMask& src, SkMask* dst) const {
@@ -976,6 +1169,10 @@ SkIPoint SkMaskBlurFilter::blur(const SkMask& src, SkMask* dst) const {
         return {0, 0};
     }
 
+    if (fSigmaW >= kLargeSigma || fSigmaH >= kLargeSigma) {
+        return large_blur(fSigmaW, fSigmaH, borderW, borderH, src, dst);
+    }
+
     int srcW = src.fBounds.width(),
         srcH = src.fBounds.height(),
         dstW = dst->fBounds.width(),
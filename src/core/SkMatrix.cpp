@@ -11,6 +11,7 @@
 #include "SkMathPriv.h"
 #include "SkMatrixPriv.h"
 #include "SkNx.h"
+#include "SkOpts.h"
 #include "SkPaint.h"
 #include "SkPoint3.h"
 #include "SkRSXform.h"
@@ -264,11 +265,6 @@ static inline SkScalar sdot(SkScalar a, SkScalar b, SkScalar c, SkScalar d) {
     return a * b + c * d;
 }
 
-static inline SkScalar sdot(SkScalar a, SkScalar b, SkScalar c, SkScalar d,
-                             SkScalar e, SkScalar f) {
-    return a * b + c * d + e * f;
-}
-
 static inline SkScalar scross(SkScalar a, SkScalar b, SkScalar c, SkScalar d) {
     return a * b - c * d;
 }
@@ -971,58 +967,12 @@ void SkMatrix::Scale_pts(const SkMatrix& m, SkPoint dst[], const SkPoint src[],
 void SkMatrix::Persp_pts(const SkMatrix& m, SkPoint dst[],
                          const SkPoint src[], int count) {
     SkASSERT(m.hasPerspective());
-
-    if (count > 0) {
-        do {
-            SkScalar sy = src->fY;
-            SkScalar sx = src->fX;
-            src += 1;
-
-            SkScalar x = sdot(sx, m.fMat[kMScaleX], sy, m.fMat[kMSkewX])  + m.fMat[kMTransX];
-            SkScalar y = sdot(sx, m.fMat[kMSkewY],  sy, m.fMat[kMScaleY]) + m.fMat[kMTransY];
-#ifdef SK_LEGACY_MATRIX_MATH_ORDER
-            SkScalar z = sx * m.fMat[kMPersp0] + (sy * m.fMat[kMPersp1] + m.fMat[kMPersp2]);
-#else
-            SkScalar z = sdot(sx, m.fMat[kMPersp0], sy, m.fMat[kMPersp1]) + m.fMat[kMPersp2];
-#endif
-            if (z) {
-                z = 1 / z;
-            }
-
-            dst->fY = y * z;
-            dst->fX = x * z;
-            dst += 1;
-        } while (--count);
-    }
+    SkOpts::map_points_persp(m.fMat, dst, src, count);
 }
 
 void SkMatrix::Affine_vpts(const SkMatrix& m, SkPoint dst[], const SkPoint src[], int count) {
     SkASSERT(m.getType() != SkMatrix::kPerspective_Mask);
-    if (count > 0) {
-        SkScalar tx = m.getTranslateX();
-        SkScalar ty = m.getTranslateY();
-        SkScalar sx = m.getScaleX();
-        SkScalar sy = m.getScaleY();
-        SkScalar kx = m.getSkewX();
-        SkScalar ky = m.getSkewY();
-        if (count & 1) {
-            dst->set(src->fX * sx + src->fY * kx + tx,
-                     src->fX * ky + src->fY * sy + ty);
-            src += 1;
-            dst += 1;
-        }
-        Sk4s trans4(tx, ty, tx, ty);
-        Sk4s scale4(sx, sy, sx, sy);
-        Sk4s  skew4(kx, ky, kx, ky);    // applied to swizzle of src4
-        count >>= 1;
-        for (int i = 0; i < count; ++i) {
-            Sk4s src4 = Sk4s::Load(src);
-            Sk4s swz4 = SkNx_shuffle<1,0,3,2>(src4);  // y0 x0, y1 x1
-            (src4 * scale4 + swz4 * skew4 + trans4).store(dst);
-            src += 2;
-            dst += 2;
-        }
-    }
+    SkOpts::map_points_affine(m.fMat, dst, src, count);
 }
 
 const SkMatrix::MapPtsProc SkMatrix::gMapPtsProcs[] = {
@@ -1062,18 +1012,17 @@ void SkMatrixPriv::MapHomogeneousPointsWithStride(const SkMatrix& mx, SkPoint3 d
             }
             return;
         }
+        // Sum the matrix's columns scaled by each point, which maps x, y and w all at once.
+        const SkScalar* mat = mx.fMat;
+        typedef SkMatrix M;
+        const Sk4f cx(mat[M::kMScaleX], mat[M::kMSkewY],  mat[M::kMPersp0], 0),
+                   cy(mat[M::kMSkewX],  mat[M::kMScaleY], mat[M::kMPersp1], 0),
+                   cw(mat[M::kMTransX], mat[M::kMTransY], mat[M::kMPersp2], 0);
         do {
-            SkScalar sx = src->fX;
-            SkScalar sy = src->fY;
-            SkScalar sw = src->fZ;
+            Sk4f r = cx * src->fX + cy * src->fY + cw * src->fZ;
             src = reinterpret_cast<const SkPoint3*>(reinterpret_cast<const char*>(src) + srcStride);
-            const SkScalar* mat = mx.fMat;
-            typedef SkMatrix M;
-            SkScalar x = sdot(sx, mat[M::kMScaleX], sy, mat[M::kMSkewX],  sw, mat[M::kMTransX]);
-            SkScalar y = sdot(sx, mat[M::kMSkewY],  sy, mat[M::kMScaleY], sw, mat[M::kMTransY]);
-            SkScalar w = sdot(sx, mat[M::kMPersp0], sy, mat[M::kMPersp1], sw, mat[M::kMPersp2]);
 
-            dst->set(x, y, w);
+            dst->set(r[0], r[1], r[2]);
             dst = reinterpret_cast<SkPoint3*>(reinterpret_cast<char*>(dst) + dstStride);
         } while (--count);
     }
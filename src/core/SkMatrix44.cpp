@@ -6,6 +6,7 @@
  */
 
 #include "SkMatrix44.h"
+#include "SkNx.h"
 #include <utility>
 
 static inline bool eq4(const SkMScalar* SK_RESTRICT a,
@@ -709,6 +710,14 @@ void SkMatrix44::transpose() {
 ///////////////////////////////////////////////////////////////////////////////
 
 void SkMatrix44::mapScalars(const SkScalar src[4], SkScalar dst[4]) const {
+#ifdef SK_MSCALAR_IS_FLOAT
+    // Our columns are contiguous, so we can sum them scaled by src all at once.
+    Sk4f result = 0;
+    for (int j = 0; j < 4; j++) {
+        result = result + Sk4f::Load(fMat[j]) * src[j];
+    }
+    result.store(dst);
+#else
     SkScalar storage[4];
     SkScalar* result = (src == dst) ? storage : dst;
 
@@ -723,6 +732,7 @@ void SkMatrix44::mapScalars(const SkScalar src[4], SkScalar dst[4]) const {
     if (storage == result) {
         memcpy(dst, storage, sizeof(storage));
     }
+#endif
 }
 
 #ifdef SK_MSCALAR_IS_DOUBLE
@@ -827,6 +837,17 @@ static void map2_sd(const SkMScalar mat[][4], const double* SK_RESTRICT src2,
 
 static void map2_af(const SkMScalar mat[][4], const float* SK_RESTRICT src2,
                     int count, float* SK_RESTRICT dst4) {
+#ifdef SK_MSCALAR_IS_FLOAT
+    Sk4f c0 = Sk4f::Load(mat[0]),
+         c1 = Sk4f::Load(mat[1]),
+         c3 = Sk4f::Load(mat[3]);
+    for (int n = 0; n < count; ++n) {
+        (c0 * src2[0] + c1 * src2[1] + c3).store(dst4);
+        dst4[3] = 1;
+        src2 += 2;
+        dst4 += 4;
+    }
+#else
     SkMScalar r;
     for (int n = 0; n < count; ++n) {
         SkMScalar sx = SkFloatToMScalar(src2[0]);
@@ -841,6 +862,7 @@ static void map2_af(const SkMScalar mat[][4], const float* SK_RESTRICT src2,
         src2 += 2;
         dst4 += 4;
     }
+#endif
 }
 
 static void map2_ad(const SkMScalar mat[][4], const double* SK_RESTRICT src2,
@@ -859,6 +881,16 @@ static void map2_ad(const SkMScalar mat[][4], const double* SK_RESTRICT src2,
 
 static void map2_pf(const SkMScalar mat[][4], const float* SK_RESTRICT src2,
                     int count, float* SK_RESTRICT dst4) {
+#ifdef SK_MSCALAR_IS_FLOAT
+    Sk4f c0 = Sk4f::Load(mat[0]),
+         c1 = Sk4f::Load(mat[1]),
+         c3 = Sk4f::Load(mat[3]);
+    for (int n = 0; n < count; ++n) {
+        (c0 * src2[0] + c1 * src2[1] + c3).store(dst4);
+        src2 += 2;
+        dst4 += 4;
+    }
+#else
     SkMScalar r;
     for (int n = 0; n < count; ++n) {
         SkMScalar sx = SkFloatToMScalar(src2[0]);
@@ -870,6 +902,7 @@ static void map2_pf(const SkMScalar mat[][4], const float* SK_RESTRICT src2,
         src2 += 2;
         dst4 += 4;
     }
+#endif
 }
 
 static void map2_pd(const SkMScalar mat[][4], const double* SK_RESTRICT src2,
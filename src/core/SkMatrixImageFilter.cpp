@@ -27,6 +27,10 @@ SkMatrixImageFilter::SkMatrixImageFilter(const SkMatrix& transform,
 sk_sp<SkImageFilter> SkMatrixImageFilter::Make(const SkMatrix& transform,
                                                SkFilterQuality filterQuality,
                                                sk_sp<SkImageFilter> input) {
+    if (transform.isIdentity() && input) {
+        // Drawing the input untransformed just copies it.
+        return input;
+    }
     return sk_sp<SkImageFilter>(new SkMatrixImageFilter(transform,
                                                         filterQuality,
                                                         std::move(input)));
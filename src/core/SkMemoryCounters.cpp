@@ -0,0 +1,50 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkMemoryCounters.h"
+
+#include <atomic>
+
+using MemoryCounters = SkGraphics::MemoryCounters;
+
+static std::atomic<size_t> gBytes    [MemoryCounters::kCounterCount];
+static std::atomic<size_t> gPeakBytes[MemoryCounters::kCounterCount];
+
+void SkMemoryCounters::Add(Counter counter, size_t bytes) {
+    size_t now = gBytes[counter].fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    size_t peak = gPeakBytes[counter].load(std::memory_order_relaxed);
+    while (now > peak &&
+           !gPeakBytes[counter].compare_exchange_weak(peak, now, std::memory_order_relaxed)) {}
+}
+
+void SkMemoryCounters::Remove(Counter counter, size_t bytes) {
+    SkASSERT(gBytes[counter].load(std::memory_order_relaxed) >= bytes);
+    gBytes[counter].fetch_sub(bytes, std::memory_order_relaxed);
+}
+
+const char* MemoryCounters::Name(Counter counter) {
+    switch (counter) {
+        case kArenaAlloc:        return "arena_alloc";
+        case kPathRef:           return "path_ref";
+        case kPicture:           return "picture";
+        case kGrOpMemoryPool:    return "gr_op_memory_pool";
+        case kGrBufferAllocPool: return "gr_buffer_alloc_pool";
+        case kGrDrawOpAtlas:     return "gr_draw_op_atlas";
+        case kGrCCAtlas:         return "gr_ccpr_atlas";
+    }
+    SkASSERT(false);
+    return "";
+}
+
+void SkGraphics::GetMemoryCounters(MemoryCounters* counters) {
+    for (int i = 0; i < MemoryCounters::kCounterCount; i++) {
+        counters->fBytes    [i] = gBytes    [i].load(std::memory_order_relaxed);
+        // Add() may not have raised the peak yet for bytes we just counted.
+        counters->fPeakBytes[i] = SkTMax(gPeakBytes[i].load(std::memory_order_relaxed),
+                                         counters->fBytes[i]);
+    }
+}
@@ -0,0 +1,22 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkMemoryCounters_DEFINED
+#define SkMemoryCounters_DEFINED
+
+#include "SkGraphics.h"
+
+// Allocators call these as they take and release memory, to keep SkGraphics::MemoryCounters
+// up to date. Each is a relaxed atomic add, plus a compare-exchange when a new peak is reached.
+namespace SkMemoryCounters {
+    using Counter = SkGraphics::MemoryCounters::Counter;
+
+    void Add(Counter, size_t bytes);
+    void Remove(Counter, size_t bytes);
+}
+
+#endif
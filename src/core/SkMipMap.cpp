@@ -13,6 +13,7 @@
 #include "SkImageInfoPriv.h"
 #include "SkMathPriv.h"
 #include "SkNx.h"
+#include "SkOpts.h"
 #include "SkTo.h"
 #include "SkTypes.h"
 #include <new>
@@ -311,76 +312,112 @@ size_t SkMipMap::AllocLevelsSize(int levelCount, size_t pixelSize) {
     return SkTo<int32_t>(size);
 }
 
-SkMipMap* SkMipMap::Build(const SkPixmap& src, SkDiscardableFactoryProc fact) {
-    typedef void FilterProc(void*, const void* srcPtr, size_t srcRB, int count);
-
-    FilterProc* proc_1_2 = nullptr;
-    FilterProc* proc_1_3 = nullptr;
-    FilterProc* proc_2_1 = nullptr;
-    FilterProc* proc_2_2 = nullptr;
-    FilterProc* proc_2_3 = nullptr;
-    FilterProc* proc_3_1 = nullptr;
-    FilterProc* proc_3_2 = nullptr;
-    FilterProc* proc_3_3 = nullptr;
+typedef void FilterProc(void*, const void* srcPtr, size_t srcRB, int count);
+
+struct FilterProcs {
+    FilterProc* proc_1_2;
+    FilterProc* proc_1_3;
+    FilterProc* proc_2_1;
+    FilterProc* proc_2_2;
+    FilterProc* proc_2_3;
+    FilterProc* proc_3_1;
+    FilterProc* proc_3_2;
+    FilterProc* proc_3_3;
+};
 
-    const SkColorType ct = src.colorType();
-    const SkAlphaType at = src.alphaType();
+template <typename F> static void set_procs(FilterProcs* procs) {
+    procs->proc_1_2 = downsample_1_2<F>;
+    procs->proc_1_3 = downsample_1_3<F>;
+    procs->proc_2_1 = downsample_2_1<F>;
+    procs->proc_2_2 = downsample_2_2<F>;
+    procs->proc_2_3 = downsample_2_3<F>;
+    procs->proc_3_1 = downsample_3_1<F>;
+    procs->proc_3_2 = downsample_3_2<F>;
+    procs->proc_3_3 = downsample_3_3<F>;
+}
 
+static bool choose_procs(SkColorType ct, FilterProcs* procs) {
+    // The 2x2 case, which is every level of an even-sized image, has SIMD versions in SkOpts.
     switch (ct) {
         case kRGBA_8888_SkColorType:
         case kBGRA_8888_SkColorType:
-            proc_1_2 = downsample_1_2<ColorTypeFilter_8888>;
-            proc_1_3 = downsample_1_3<ColorTypeFilter_8888>;
-            proc_2_1 = downsample_2_1<ColorTypeFilter_8888>;
-            proc_2_2 = downsample_2_2<ColorTypeFilter_8888>;
-            proc_2_3 = downsample_2_3<ColorTypeFilter_8888>;
-            proc_3_1 = downsample_3_1<ColorTypeFilter_8888>;
-            proc_3_2 = downsample_3_2<ColorTypeFilter_8888>;
-            proc_3_3 = downsample_3_3<ColorTypeFilter_8888>;
-            break;
+            set_procs<ColorTypeFilter_8888>(procs);
+            procs->proc_2_2 = SkOpts::downsample_2_2_8888;
+            return true;
         case kRGB_565_SkColorType:
-            proc_1_2 = downsample_1_2<ColorTypeFilter_565>;
-            proc_1_3 = downsample_1_3<ColorTypeFilter_565>;
-            proc_2_1 = downsample_2_1<ColorTypeFilter_565>;
-            proc_2_2 = downsample_2_2<ColorTypeFilter_565>;
-            proc_2_3 = downsample_2_3<ColorTypeFilter_565>;
-            proc_3_1 = downsample_3_1<ColorTypeFilter_565>;
-            proc_3_2 = downsample_3_2<ColorTypeFilter_565>;
-            proc_3_3 = downsample_3_3<ColorTypeFilter_565>;
-            break;
+            set_procs<ColorTypeFilter_565>(procs);
+            return true;
         case kARGB_4444_SkColorType:
-            proc_1_2 = downsample_1_2<ColorTypeFilter_4444>;
-            proc_1_3 = downsample_1_3<ColorTypeFilter_4444>;
-            proc_2_1 = downsample_2_1<ColorTypeFilter_4444>;
-            proc_2_2 = downsample_2_2<ColorTypeFilter_4444>;
-            proc_2_3 = downsample_2_3<ColorTypeFilter_4444>;
-            proc_3_1 = downsample_3_1<ColorTypeFilter_4444>;
-            proc_3_2 = downsample_3_2<ColorTypeFilter_4444>;
-            proc_3_3 = downsample_3_3<ColorTypeFilter_4444>;
-            break;
+            set_procs<ColorTypeFilter_4444>(procs);
+            return true;
         case kAlpha_8_SkColorType:
         case kGray_8_SkColorType:
-            proc_1_2 = downsample_1_2<ColorTypeFilter_8>;
-            proc_1_3 = downsample_1_3<ColorTypeFilter_8>;
-            proc_2_1 = downsample_2_1<ColorTypeFilter_8>;
-            proc_2_2 = downsample_2_2<ColorTypeFilter_8>;
-            proc_2_3 = downsample_2_3<ColorTypeFilter_8>;
-            proc_3_1 = downsample_3_1<ColorTypeFilter_8>;
-            proc_3_2 = downsample_3_2<ColorTypeFilter_8>;
-            proc_3_3 = downsample_3_3<ColorTypeFilter_8>;
-            break;
+            set_procs<ColorTypeFilter_8>(procs);
+            procs->proc_2_2 = SkOpts::downsample_2_2_a8;
+            return true;
         case kRGBA_F16_SkColorType:
-            proc_1_2 = downsample_1_2<ColorTypeFilter_F16>;
-            proc_1_3 = downsample_1_3<ColorTypeFilter_F16>;
-            proc_2_1 = downsample_2_1<ColorTypeFilter_F16>;
-            proc_2_2 = downsample_2_2<ColorTypeFilter_F16>;
-            proc_2_3 = downsample_2_3<ColorTypeFilter_F16>;
-            proc_3_1 = downsample_3_1<ColorTypeFilter_F16>;
-            proc_3_2 = downsample_3_2<ColorTypeFilter_F16>;
-            proc_3_3 = downsample_3_3<ColorTypeFilter_F16>;
-            break;
+            set_procs<ColorTypeFilter_F16>(procs);
+            procs->proc_2_2 = SkOpts::downsample_2_2_f16;
+            return true;
         default:
-            return nullptr;
+            return false;
+    }
+}
+
+// Fills dstPM, which is srcPM's next level down.
+static void downsample(const FilterProcs& procs, const SkPixmap& srcPM, const SkPixmap& dstPM) {
+    const int width = srcPM.width();
+    const int height = srcPM.height();
+
+    FilterProc* proc;
+    if (height & 1) {
+        if (height == 1) {        // src-height is 1
+            if (width & 1) {      // src-width is 3
+                proc = procs.proc_3_1;
+            } else {              // src-width is 2
+                proc = procs.proc_2_1;
+            }
+        } else {                  // src-height is 3
+            if (width & 1) {
+                if (width == 1) { // src-width is 1
+                    proc = procs.proc_1_3;
+                } else {          // src-width is 3
+                    proc = procs.proc_3_3;
+                }
+            } else {              // src-width is 2
+                proc = procs.proc_2_3;
+            }
+        }
+    } else {                      // src-height is 2
+        if (width & 1) {
+            if (width == 1) {     // src-width is 1
+                proc = procs.proc_1_2;
+            } else {              // src-width is 3
+                proc = procs.proc_3_2;
+            }
+        } else {                  // src-width is 2
+            proc = procs.proc_2_2;
+        }
+    }
+
+    const void* srcBasePtr = srcPM.addr();
+    void* dstBasePtr = dstPM.writable_addr();
+
+    const size_t srcRB = srcPM.rowBytes();
+    for (int y = 0; y < dstPM.height(); y++) {
+        proc(dstBasePtr, srcBasePtr, srcRB, dstPM.width());
+        srcBasePtr = (char*)srcBasePtr + srcRB * 2; // jump two rows
+        dstBasePtr = (char*)dstBasePtr + dstPM.rowBytes();
+    }
+}
+
+SkMipMap* SkMipMap::Build(const SkPixmap& src, SkDiscardableFactoryProc fact, int eagerLevels) {
+    const SkColorType ct = src.colorType();
+    const SkAlphaType at = src.alphaType();
+
+    FilterProcs procs;
+    if (!choose_procs(ct, &procs)) {
+        return nullptr;
     }
 
     if (src.width() <= 1 && src.height() <= 1) {
@@ -422,43 +459,12 @@ SkMipMap* SkMipMap::Build(const SkPixmap& src, SkDiscardableFactoryProc fact) {
     int         width = src.width();
     int         height = src.height();
     uint32_t    rowBytes;
-    SkPixmap    srcPM(src);
 
     // Depending on architecture and other factors, the pixel data alignment may need to be as
     // large as 8 (for F16 pixels). See the comment on SkMipMap::Level.
     SkASSERT(SkIsAlign8((uintptr_t)addr));
 
     for (int i = 0; i < countLevels; ++i) {
-        FilterProc* proc;
-        if (height & 1) {
-            if (height == 1) {        // src-height is 1
-                if (width & 1) {      // src-width is 3
-                    proc = proc_3_1;
-                } else {              // src-width is 2
-                    proc = proc_2_1;
-                }
-            } else {                  // src-height is 3
-                if (width & 1) {
-                    if (width == 1) { // src-width is 1
-                        proc = proc_1_3;
-                    } else {          // src-width is 3
-                        proc = proc_3_3;
-                    }
-                } else {              // src-width is 2
-                    proc = proc_2_3;
-                }
-            }
-        } else {                      // src-height is 2
-            if (width & 1) {
-                if (width == 1) {     // src-width is 1
-                    proc = proc_1_2;
-                } else {              // src-width is 3
-                    proc = proc_3_2;
-                }
-            } else {                  // src-width is 2
-                proc = proc_2_2;
-            }
-        }
         width = SkTMax(1, width >> 1);
         height = SkTMax(1, height >> 1);
         rowBytes = SkToU32(SkColorTypeMinRowBytes(ct, width));
@@ -469,26 +475,38 @@ SkMipMap* SkMipMap::Build(const SkPixmap& src, SkDiscardableFactoryProc fact) {
         new (&levels[i].fPixmap) SkPixmap(SkImageInfo::Make(width, height, ct, at), addr, rowBytes);
         levels[i].fScale  = SkSize::Make(SkIntToScalar(width)  / src.width(),
                                          SkIntToScalar(height) / src.height());
-
-        const SkPixmap& dstPM = levels[i].fPixmap;
-        const void* srcBasePtr = srcPM.addr();
-        void* dstBasePtr = dstPM.writable_addr();
-
-        const size_t srcRB = srcPM.rowBytes();
-        for (int y = 0; y < height; y++) {
-            proc(dstBasePtr, srcBasePtr, srcRB, width);
-            srcBasePtr = (char*)srcBasePtr + srcRB * 2; // jump two rows
-            dstBasePtr = (char*)dstBasePtr + dstPM.rowBytes();
-        }
-        srcPM = dstPM;
         addr += height * rowBytes;
     }
     SkASSERT(addr == baseAddr + size);
 
+    // The first level is the only one that needs src, so it is always generated here.
+    downsample(procs, src, levels[0].fPixmap);
+    mipmap->fGeneratedCount.store(1, std::memory_order_relaxed);
+    mipmap->generateLevels(eagerLevels);
+
     SkASSERT(mipmap->fLevels);
     return mipmap;
 }
 
+bool SkMipMap::generateLevels(int count) const {
+    count = SkTMin(count, fCount);
+    if (fGeneratedCount.load(std::memory_order_acquire) >= count) {
+        return nullptr != fLevels;
+    }
+
+    SkAutoMutexAcquire lock(fGenerateMutex);
+    if (nullptr == fLevels) {
+        return false;
+    }
+    FilterProcs procs;
+    SkAssertResult(choose_procs(fLevels[0].fPixmap.colorType(), &procs));
+    for (int i = fGeneratedCount.load(std::memory_order_relaxed); i < count; ++i) {
+        downsample(procs, fLevels[i - 1].fPixmap, fLevels[i].fPixmap);
+        fGeneratedCount.store(i + 1, std::memory_order_release);
+    }
+    return true;
+}
+
 int SkMipMap::ComputeLevelCount(int baseWidth, int baseHeight) {
     if (baseWidth < 1 || baseHeight < 1) {
         return 0;
@@ -584,6 +602,9 @@ bool SkMipMap::extractLevel(const SkSize& scaleSize, Level* levelPtr) const {
     if (level > fCount) {
         level = fCount;
     }
+    if (!this->generateLevels(level)) {
+        return false;
+    }
     if (levelPtr) {
         *levelPtr = fLevels[level - 1];
         // need to augment with our colorspace
@@ -594,12 +615,12 @@ bool SkMipMap::extractLevel(const SkSize& scaleSize, Level* levelPtr) const {
 
 // Helper which extracts a pixmap from the src bitmap
 //
-SkMipMap* SkMipMap::Build(const SkBitmap& src, SkDiscardableFactoryProc fact) {
+SkMipMap* SkMipMap::Build(const SkBitmap& src, SkDiscardableFactoryProc fact, int eagerLevels) {
     SkPixmap srcPixmap;
     if (!src.peekPixels(&srcPixmap)) {
         return nullptr;
     }
-    return Build(srcPixmap, fact);
+    return Build(srcPixmap, fact, eagerLevels);
 }
 
 int SkMipMap::countLevels() const {
@@ -616,6 +637,9 @@ bool SkMipMap::getLevel(int index, Level* levelPtr) const {
     if (index > fCount - 1) {
         return false;
     }
+    if (!this->generateLevels(index + 1)) {
+        return false;
+    }
     if (levelPtr) {
         *levelPtr = fLevels[index];
     }
@@ -10,10 +10,12 @@
 
 #include "SkCachedData.h"
 #include "SkImageInfoPriv.h"
+#include "SkMutex.h"
 #include "SkPixmap.h"
 #include "SkScalar.h"
 #include "SkSize.h"
 #include "SkShaderBase.h"
+#include <atomic>
 
 class SkBitmap;
 class SkDiscardableMemory;
@@ -29,8 +31,13 @@ typedef SkDiscardableMemory* (*SkDiscardableFactoryProc)(size_t bytes);
  */
 class SkMipMap : public SkCachedData {
 public:
-    static SkMipMap* Build(const SkPixmap& src, SkDiscardableFactoryProc);
-    static SkMipMap* Build(const SkBitmap& src, SkDiscardableFactoryProc);
+    // Generates the first |eagerLevels| levels right away (all of them by default). The rest are
+    // generated from the deepest level generated so far the first time extractLevel() or
+    // getLevel() needs them, so src need not outlive Build() either way.
+    static SkMipMap* Build(const SkPixmap& src, SkDiscardableFactoryProc,
+                           int eagerLevels = SK_MaxS32);
+    static SkMipMap* Build(const SkBitmap& src, SkDiscardableFactoryProc,
+                           int eagerLevels = SK_MaxS32);
 
     // Determines how many levels a SkMipMap will have without creating that mipmap.
     // This does not include the base mipmap level that the user provided when
@@ -71,11 +78,19 @@ private:
     Level*              fLevels;    // managed by the baseclass, may be null due to onDataChanged.
     int                 fCount;
 
+    // Levels [0, fGeneratedCount) hold pixels; the rest are generated under fGenerateMutex.
+    mutable SkMutex            fGenerateMutex;
+    mutable std::atomic<int>   fGeneratedCount{0};
+
     SkMipMap(void* malloc, size_t size) : INHERITED(malloc, size) {}
     SkMipMap(size_t size, SkDiscardableMemory* dm) : INHERITED(size, dm) {}
 
     static size_t AllocLevelsSize(int levelCount, size_t pixelSize);
 
+    // Makes sure the first |count| levels have been generated. Returns false if our storage
+    // has gone away.
+    bool generateLevels(int count) const;
+
     typedef SkCachedData INHERITED;
 };
 
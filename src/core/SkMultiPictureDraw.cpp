@@ -5,10 +5,13 @@
  * found in the LICENSE file.
  */
 
+#include "SkBitmap.h"
 #include "SkCanvas.h"
 #include "SkCanvasPriv.h"
 #include "SkMultiPictureDraw.h"
 #include "SkPicture.h"
+#include "SkPixmap.h"
+#include "SkSurfaceProps.h"
 #include "SkTaskGroup.h"
 
 void SkMultiPictureDraw::DrawData::draw() {
@@ -107,3 +110,31 @@ void SkMultiPictureDraw::draw(bool flush) {
         }
     }
 }
+
+void SkMultiPictureDraw::DrawTiled(const SkPixmap& dst, const SkPicture* picture,
+                                   const SkMatrix* matrix, int tileSize,
+                                   const SkSurfaceProps* props) {
+    if (nullptr == picture || nullptr == dst.addr() || tileSize <= 0) {
+        SkDEBUGFAIL("parameters to SkMultiPictureDraw::DrawTiled are invalid");
+        return;
+    }
+    const SkSurfaceProps tileProps =
+            props ? *props : SkSurfaceProps(SkSurfaceProps::kLegacyFontHost_InitType);
+    const int cols = (dst.width()  + tileSize - 1) / tileSize,
+              rows = (dst.height() + tileSize - 1) / tileSize;
+
+    // Every tile's canvas wraps all of dst but is clipped to its own tile, so the geometry is
+    // rasterized exactly as on a single canvas, and tiles never write each other's pixels.
+    // Playback culls with the picture's BBH against that clip, and layers are bounded by it too.
+    SkTaskGroup().batch(cols * rows, [&](int i) {
+        SkIRect tile = SkIRect::MakeXYWH((i % cols) * tileSize, (i / cols) * tileSize,
+                                         tileSize, tileSize);
+        SkBitmap bitmap;
+        if (!tile.intersect(dst.bounds()) || !bitmap.installPixels(dst)) {
+            return;
+        }
+        SkCanvas canvas(bitmap, tileProps);
+        canvas.clipRect(SkRect::Make(tile));
+        canvas.drawPicture(picture, matrix, nullptr);
+    });
+}
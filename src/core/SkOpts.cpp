@@ -40,10 +40,16 @@
 #include "SkBlitMask_opts.h"
 #include "SkBlitRow_opts.h"
 #include "SkChecksum_opts.h"
+#include "SkHalf_opts.h"
+#include "SkMatrix_opts.h"
+#include "SkMipMap_opts.h"
+#include "SkPngFilter_opts.h"
 #include "SkRasterPipeline_opts.h"
+#include "SkScan_opts.h"
 #include "SkSwizzler_opts.h"
 #include "SkUtils_opts.h"
 #include "SkXfermode_opts.h"
+#include "SkYCbCr_opts.h"
 
 namespace SkOpts {
     // Define default function pointer values here...
@@ -54,8 +60,11 @@ namespace SkOpts {
     DEFINE_DEFAULT(create_xfermode);
 
     DEFINE_DEFAULT(blit_mask_d32_a8);
+    DEFINE_DEFAULT(blit_row_lcd16);
+    DEFINE_DEFAULT(blit_row_lcd16_opaque);
 
     DEFINE_DEFAULT(blit_row_s32a_opaque);
+    DEFINE_DEFAULT(blit_row_color_f16);
 
     DEFINE_DEFAULT(RGBA_to_BGRA);
     DEFINE_DEFAULT(RGBA_to_rgbA);
@@ -68,6 +77,32 @@ namespace SkOpts {
     DEFINE_DEFAULT(inverted_CMYK_to_RGB1);
     DEFINE_DEFAULT(inverted_CMYK_to_BGR1);
 
+    DEFINE_DEFAULT(downsample_2_2_8888);
+    DEFINE_DEFAULT(downsample_2_2_a8);
+    DEFINE_DEFAULT(downsample_2_2_f16);
+
+    DEFINE_DEFAULT(png_filter_sub);
+    DEFINE_DEFAULT(png_filter_up);
+    DEFINE_DEFAULT(png_filter_avg);
+    DEFINE_DEFAULT(png_filter_paeth);
+    DEFINE_DEFAULT(png_filter_cost);
+
+    DEFINE_DEFAULT(RGBA_to_YCbCr);
+    DEFINE_DEFAULT(BGRA_to_YCbCr);
+
+    DEFINE_DEFAULT(map_points_affine);
+    DEFINE_DEFAULT(map_points_persp);
+
+    DEFINE_DEFAULT(add_alphas);
+    DEFINE_DEFAULT(add_alphas_saturating);
+    DEFINE_DEFAULT(subtract_alphas_saturating);
+    DEFINE_DEFAULT(add_alpha);
+    DEFINE_DEFAULT(add_alpha_saturating);
+    DEFINE_DEFAULT(alpha_ramp);
+
+    DEFINE_DEFAULT(half_to_float);
+    DEFINE_DEFAULT(float_to_half);
+
     DEFINE_DEFAULT(memset16);
     DEFINE_DEFAULT(memset32);
     DEFINE_DEFAULT(memset64);
@@ -98,6 +133,7 @@ namespace SkOpts {
     void Init_sse42();
     void Init_avx();
     void Init_hsw();
+    void Init_skx();
     void Init_crc32();
 
     static void init() {
@@ -120,6 +156,10 @@ namespace SkOpts {
             if (SkCpu::Supports(SkCpu::HSW)) { Init_hsw();   }
         #endif
 
+        #if SK_CPU_SSE_LEVEL < SK_CPU_SSE_LEVEL_SKX
+            if (SkCpu::Supports(SkCpu::SKX)) { Init_skx();   }
+        #endif
+
     #elif defined(SK_CPU_ARM64)
         if (SkCpu::Supports(SkCpu::CRC32)) { Init_crc32(); }
 
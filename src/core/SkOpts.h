@@ -13,6 +13,7 @@
 #include "SkXfermodePriv.h"
 
 struct SkBitmapProcState;
+struct SkPoint;
 
 namespace SkOpts {
     // Call to replace pointers to portable functions with pointers to CPU-specific functions.
@@ -26,7 +27,14 @@ namespace SkOpts {
     extern SkXfermode* (*create_xfermode)(SkBlendMode);
 
     extern void (*blit_mask_d32_a8)(SkPMColor*, size_t, const SkAlpha*, size_t, SkColor, int, int);
+    // Blend color through one row of an LCD16 mask onto dst, which is assumed to be opaque.
+    // The _opaque variant requires color to be opaque, and opaqueDst to be it premultiplied.
+    extern void (*blit_row_lcd16)(SkPMColor[], const uint16_t[], SkColor, int, SkPMColor);
+    extern void (*blit_row_lcd16_opaque)(SkPMColor[], const uint16_t[], SkColor, int, SkPMColor);
     extern void (*blit_row_s32a_opaque)(SkPMColor*, const SkPMColor*, int, U8CPU);
+    // dst = color + dst*dstScale over count F16 pixels (see SkBlitRow_opts.h).
+    extern void (*blit_row_color_f16)(uint64_t dst[], int count, const float color[4],
+                                      float dstScale);
 
     // Swizzle input into some sort of 8888 pixel, {premul,unpremul} x {rgba,bgra}.
     typedef void (*Swizzle_8888_u32)(uint32_t*, const uint32_t*, int);
@@ -43,6 +51,53 @@ namespace SkOpts {
                            grayA_to_RGBA,   // i.e. expand to color channels
                            grayA_to_rgbA;   // i.e. expand to color channels and premultiply
 
+    // SkMipMap's 2x2 box filters: write count pixels, each the average of a 2x2 block of the two
+    // src rows starting at src (see SkMipMap_opts.h).
+    typedef void (*Downsample_2_2)(void* dst, const void* src, size_t srcRB, int count);
+    extern Downsample_2_2 downsample_2_2_8888,
+                          downsample_2_2_a8,
+                          downsample_2_2_f16;
+
+    // PNG's Sub, Up, Average and Paeth filters: write the rowBytes filtered bytes of row, given
+    // prev, the row above it, and bpp bytes per pixel (see SkPngFilter_opts.h).
+    typedef void (*PngFilter)(uint8_t* dst, const uint8_t* row, const uint8_t* prev,
+                              size_t rowBytes, size_t bpp);
+    extern PngFilter png_filter_sub,
+                     png_filter_up,
+                     png_filter_avg,
+                     png_filter_paeth;
+    // The sum of the absolute values of count bytes taken as signed, a filtered row's cost.
+    extern size_t (*png_filter_cost)(const uint8_t*, size_t count);
+
+    // Convert count 8888 pixels to full resolution JPEG YCbCr, one plane per component, ignoring
+    // alpha (see SkYCbCr_opts.h).
+    typedef void (*Convert_8888_YCbCr)(uint8_t* y, uint8_t* cb, uint8_t* cr, const uint32_t*,
+                                       int count);
+    extern Convert_8888_YCbCr RGBA_to_YCbCr,
+                              BGRA_to_YCbCr;
+
+    // Map count points by an SkMatrix's 9 values; src may equal dst (see SkMatrix_opts.h).
+    typedef void (*MapPoints)(const float m[9], SkPoint dst[], const SkPoint src[], int count);
+    extern MapPoints map_points_affine,
+                     map_points_persp;
+
+    // Analytic AA's coverage rows: add or subtract count deltas, or one delta, to count alphas
+    // (see SkScan_opts.h). add_alphas turns a sum of 256 into 255; the others saturate.
+    typedef void (*AccumulateAlphas)(uint8_t alphas[], const uint8_t deltas[], int count);
+    typedef void (*AccumulateAlpha)(uint8_t alphas[], uint8_t delta, int count);
+    extern AccumulateAlphas add_alphas,
+                            add_alphas_saturating,
+                            subtract_alphas_saturating;
+    extern AccumulateAlpha add_alpha,
+                           add_alpha_saturating;
+    // alphas[i] = (start + i*step) >> 8, the coverage beside an edge that crosses count pixels.
+    extern void (*alpha_ramp)(uint8_t alphas[], int count, int32_t start, int32_t step);
+
+    // Convert count halfs to floats, or count floats to halfs. Values must be finite, and
+    // denormal halfs may be flushed to zero (see SkHalf_opts.h).
+    extern void (*half_to_float)(float dst[], const uint16_t src[], int count);
+    extern void (*float_to_half)(uint16_t dst[], const float src[], int count);
+
     extern void (*memset16)(uint16_t[], uint16_t, int);
     extern void SK_API (*memset32)(uint32_t[], uint32_t, int);
     extern void (*memset64)(uint64_t[], uint64_t, int);
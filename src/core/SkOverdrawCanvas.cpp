@@ -274,10 +274,18 @@ void SkOverdrawCanvas::onDrawImageLattice(const SkImage* image, const Lattice& l
     }
 }
 
-void SkOverdrawCanvas::onDrawImageSet(const ImageSetEntry set[], int count, SkFilterQuality,
+void SkOverdrawCanvas::onDrawImageSet(const ImageSetEntry set[], int count,
+                                      const SkMatrix preViewMatrices[], SkFilterQuality,
                                       SkBlendMode) {
     for (int i = 0; i < count; ++i) {
-        fList[0]->onDrawRect(set[i].fDstRect, fPaint);
+        if (set[i].fMatrixIndex >= 0) {
+            fList[0]->save();
+            fList[0]->concat(preViewMatrices[set[i].fMatrixIndex]);
+            fList[0]->onDrawRect(set[i].fDstRect, fPaint);
+            fList[0]->restore();
+        } else {
+            fList[0]->onDrawRect(set[i].fDstRect, fPaint);
+        }
     }
 }
 
@@ -14,6 +14,7 @@
 #include "SkMacros.h"
 #include "SkMath.h"
 #include "SkMatrixPriv.h"
+#include "SkOpts.h"
 #include "SkPathPriv.h"
 #include "SkPathRef.h"
 #include "SkPointPriv.h"
@@ -3343,6 +3344,14 @@ int SkPath::ConvertConicToQuads(const SkPoint& p0, const SkPoint& p1, const SkPo
     return conic.chopIntoQuadsPOW2(pts, pow2);
 }
 
+uint32_t SkPathPriv::ContentHash(const SkPath& path) {
+    const SkPathRef& ref = *path.fPathRef;
+    uint32_t hash = SkOpts::hash(ref.points(), ref.countPoints() * sizeof(SkPoint),
+                                 path.getFillType());
+    hash = SkOpts::hash(ref.verbsMemBegin(), ref.countVerbs(), hash);
+    return SkOpts::hash(ref.conicWeights(), ref.countWeights() * sizeof(SkScalar), hash);
+}
+
 bool SkPathPriv::IsSimpleClosedRect(const SkPath& path, SkRect* rect, SkPath::Direction* direction,
                                     unsigned* start) {
     if (path.getSegmentMasks() != SkPath::kLine_SegmentMask) {
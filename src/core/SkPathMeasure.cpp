@@ -499,6 +499,7 @@ SkPathMeasure::SkPathMeasure() {
     fLength = -1;   // signal we need to compute it
     fForceClosed = false;
     fFirstPtIndex = -1;
+    fContourIndex = 0;
 }
 
 SkPathMeasure::SkPathMeasure(const SkPath& path, bool forceClosed, SkScalar resScale) {
@@ -507,6 +508,7 @@ SkPathMeasure::SkPathMeasure(const SkPath& path, bool forceClosed, SkScalar resS
     fLength = -1;   // signal we need to compute it
     fForceClosed = forceClosed;
     fFirstPtIndex = -1;
+    fContourIndex = 0;
 
     fIter.setPath(fPath, forceClosed);
 }
@@ -528,6 +530,61 @@ void SkPathMeasure::setPath(const SkPath* path, bool forceClosed) {
     fIter.setPath(fPath, forceClosed);
     fSegments.reset();
     fPts.reset();
+    fTable = nullptr;
+    fContourIndex = 0;
+}
+
+sk_sp<const SkPathMeasure::Table> SkPathMeasure::MeasureAll(const SkPath& path, bool forceClosed,
+                                                            SkScalar resScale) {
+    SkPathMeasure meas(path, forceClosed, resScale);
+    sk_sp<Table> table = sk_make_sp<Table>();
+    // Record the contour where nextContour() returns false as well, as that's where the walk ends.
+    for (bool more = true;; more = meas.nextContour()) {
+        (void)meas.getLength();
+        Table::Contour* contour = table->fContours.append();
+        contour->fFirstSegment = table->fSegments.count();
+        contour->fSegmentCount = meas.fSegments.count();
+        contour->fLength = meas.fLength;
+        contour->fIsClosed = meas.fIsClosed;
+        table->fSegments.append(meas.fSegments.count(), meas.fSegments.begin());
+        if (!more) {
+            break;
+        }
+    }
+    table->fPts = std::move(meas.fPts);
+    return table;
+}
+
+void SkPathMeasure::setResScale(SkScalar resScale) {
+    fTolerance = CHEAP_DIST_LIMIT * SkScalarInvert(resScale);
+}
+
+void SkPathMeasure::setTable(sk_sp<const Table> table) {
+    SkASSERT(table && table->fContours.count() > 0);
+    fTable = std::move(table);
+    fSegments.reset();
+    fPts.reset();
+    this->setContour(0);
+}
+
+void SkPathMeasure::setContour(int index) {
+    const Table::Contour& contour = fTable->fContours[index];
+    fContourIndex = index;
+    fLength = contour.fLength;
+    fIsClosed = contour.fIsClosed;
+}
+
+const SkPathMeasure::Segment* SkPathMeasure::segments() const {
+    return fTable ? fTable->fSegments.begin() + fTable->fContours[fContourIndex].fFirstSegment
+                  : fSegments.begin();
+}
+
+int SkPathMeasure::segmentCount() const {
+    return fTable ? fTable->fContours[fContourIndex].fSegmentCount : fSegments.count();
+}
+
+const SkPoint* SkPathMeasure::points() const {
+    return fTable ? fTable->fPts.begin() : fPts.begin();
 }
 
 SkScalar SkPathMeasure::getLength() {
@@ -577,8 +634,8 @@ const SkPathMeasure::Segment* SkPathMeasure::distanceToSegment(
     SkDEBUGCODE(SkScalar length = ) this->getLength();
     SkASSERT(distance >= 0 && distance <= length);
 
-    const Segment*  seg = fSegments.begin();
-    int             count = fSegments.count();
+    const Segment*  seg = this->segments();
+    int             count = this->segmentCount();
 
     int index = SkTKSearch<Segment, SkScalar>(seg, count, distance);
     // don't care if we hit an exact match or not, so we xor index if it is negative
@@ -606,7 +663,7 @@ const SkPathMeasure::Segment* SkPathMeasure::distanceToSegment(
 
 bool SkPathMeasure::getPosTan(SkScalar distance, SkPoint* pos, SkVector* tangent) {
     SkScalar    length = this->getLength(); // call this to force computing it
-    int         count = fSegments.count();
+    int         count = this->segmentCount();
 
     if (count == 0 || length == 0 || SkScalarIsNaN(distance)) {
         return false;
@@ -625,7 +682,7 @@ bool SkPathMeasure::getPosTan(SkScalar distance, SkPoint* pos, SkVector* tangent
         return false;
     }
 
-    compute_pos_tan(&fPts[seg->fPtIndex], seg->fType, t, pos, tangent);
+    compute_pos_tan(&this->points()[seg->fPtIndex], seg->fType, t, pos, tangent);
     return true;
 }
 
@@ -665,7 +722,7 @@ bool SkPathMeasure::getSegment(SkScalar startD, SkScalar stopD, SkPath* dst,
     if (!(startD <= stopD)) {   // catch NaN values as well
         return false;
     }
-    if (!fSegments.count()) {
+    if (!this->segmentCount()) {
         return false;
     }
 
@@ -680,20 +737,21 @@ bool SkPathMeasure::getSegment(SkScalar startD, SkScalar stopD, SkPath* dst,
         return false;
     }
     SkASSERT(seg <= stopSeg);
+    const SkPoint* pts = this->points();
     if (startWithMoveTo) {
-        compute_pos_tan(&fPts[seg->fPtIndex], seg->fType, startT, &p, nullptr);
+        compute_pos_tan(&pts[seg->fPtIndex], seg->fType, startT, &p, nullptr);
         dst->moveTo(p);
     }
 
     if (seg->fPtIndex == stopSeg->fPtIndex) {
-        SkPathMeasure_segTo(&fPts[seg->fPtIndex], seg->fType, startT, stopT, dst);
+        SkPathMeasure_segTo(&pts[seg->fPtIndex], seg->fType, startT, stopT, dst);
     } else {
         do {
-            SkPathMeasure_segTo(&fPts[seg->fPtIndex], seg->fType, startT, SK_Scalar1, dst);
+            SkPathMeasure_segTo(&pts[seg->fPtIndex], seg->fType, startT, SK_Scalar1, dst);
             seg = SkPathMeasure::NextSegment(seg);
             startT = 0;
         } while (seg->fPtIndex < stopSeg->fPtIndex);
-        SkPathMeasure_segTo(&fPts[seg->fPtIndex], seg->fType, 0, stopT, dst);
+        SkPathMeasure_segTo(&pts[seg->fPtIndex], seg->fType, 0, stopT, dst);
     }
 
     return true;
@@ -708,6 +766,13 @@ bool SkPathMeasure::isClosed() {
     we're done with the path.
 */
 bool SkPathMeasure::nextContour() {
+    if (fTable) {
+        if (fContourIndex + 1 >= fTable->fContours.count()) {
+            return false;
+        }
+        this->setContour(fContourIndex + 1);
+        return fLength > 0;
+    }
     (void)this->getLength();    // make sure we measure the current contour
 #if defined(IS_FUZZING_WITH_LIBFUZZER)
     if (fSubdivisionsMax < 0) {
@@ -724,10 +789,10 @@ bool SkPathMeasure::nextContour() {
 #ifdef SK_DEBUG
 
 void SkPathMeasure::dump() {
-    SkDebugf("pathmeas: length=%g, segs=%d\n", fLength, fSegments.count());
+    SkDebugf("pathmeas: length=%g, segs=%d\n", fLength, this->segmentCount());
 
-    for (int i = 0; i < fSegments.count(); i++) {
-        const Segment* seg = &fSegments[i];
+    for (int i = 0; i < this->segmentCount(); i++) {
+        const Segment* seg = &this->segments()[i];
         SkDebugf("pathmeas: seg[%d] distance=%g, point=%d, t=%g, type=%d\n",
                 i, seg->fDistance, seg->fPtIndex, seg->getScalarT(),
                  seg->fType);
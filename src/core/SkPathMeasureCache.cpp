@@ -0,0 +1,103 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkPathMeasureCache.h"
+
+#include "SkPathMeasurePriv.h"
+#include "SkPathPriv.h"
+#include "SkPathRef.h"
+
+// Measuring paths this small costs about as much as a cache lookup.
+#ifndef SK_PATH_MEASURE_CACHE_MIN_POINTS
+    #define SK_PATH_MEASURE_CACHE_MIN_POINTS 4
+#endif
+
+namespace {
+static unsigned gPathMeasureKeyNamespaceLabel;
+
+uint64_t shared_id_for_path(uint32_t pathGenID) {
+    uint64_t sharedID = SkSetFourByteTag('m', 'e', 'a', 's');
+    return (sharedID << 32) | pathGenID;
+}
+
+struct PathMeasureKey : public SkResourceCache::Key {
+public:
+    PathMeasureKey(const SkPath& path, bool forceClosed, SkScalar resScale)
+        : fResScale(resScale)
+        , fForceClosed(forceClosed)
+    {
+        this->init(&gPathMeasureKeyNamespaceLabel, shared_id_for_path(path.getGenerationID()),
+                   sizeof(fResScale) + sizeof(fForceClosed));
+    }
+
+    SkScalar fResScale;
+    int32_t  fForceClosed;
+};
+
+// Purges a path's measurements when its SkPathRef changes or is deleted.
+class PathMeasureInvalidator : public SkPathRef::GenIDChangeListener {
+public:
+    explicit PathMeasureInvalidator(uint64_t sharedID) : fSharedID(sharedID) {}
+
+private:
+    void onChange() override { SkResourceCache::PostPurgeSharedID(fSharedID); }
+
+    uint64_t fSharedID;
+};
+
+bool worth_caching(const SkPath& path) {
+    return !path.isVolatile() && path.isFinite() &&
+           path.countPoints() >= SK_PATH_MEASURE_CACHE_MIN_POINTS;
+}
+
+} // namespace
+
+struct SkPathMeasureCache::Rec : public SkResourceCache::Rec {
+    using Table = SkPathMeasure::Table;
+
+    Rec(const PathMeasureKey& key, sk_sp<const Table> table)
+        : fKey(key), fTable(std::move(table)) {}
+
+    PathMeasureKey      fKey;
+    sk_sp<const Table>  fTable;
+
+    const Key& getKey() const override { return fKey; }
+    size_t bytesUsed() const override { return sizeof(*this) + fTable->bytesUsed(); }
+    const char* getCategory() const override { return "path-measure"; }
+    SkDiscardableMemory* diagnostic_only_getDiscardable() const override { return nullptr; }
+
+    static bool Visitor(const SkResourceCache::Rec& baseRec, void* contextData) {
+        const Rec& rec = static_cast<const Rec&>(baseRec);
+        *static_cast<sk_sp<const Table>*>(contextData) = rec.fTable;
+        return true;
+    }
+};
+
+void SkPathMeasureCache::SetPath(SkPathMeasure* meas, const SkPath& path, bool forceClosed,
+                                 SkScalar resScale, SkResourceCache* localCache) {
+    meas->setPath(&path, forceClosed);
+    meas->setResScale(resScale);
+    if (!worth_caching(path)) {
+        return;
+    }
+
+    PathMeasureKey key(path, forceClosed, resScale);
+    sk_sp<const SkPathMeasure::Table> table;
+    if (!(localCache ? localCache->find(key, Rec::Visitor, &table)
+                     : SkResourceCache::Find(key, Rec::Visitor, &table))) {
+        table = SkPathMeasure::MeasureAll(path, forceClosed, resScale);
+        auto* cacheRec = new Rec(key, table);
+        if (localCache) {
+            localCache->add(cacheRec);
+        } else {
+            SkResourceCache::Add(cacheRec);
+        }
+        SkPathPriv::AddGenIDChangeListener(path,
+                                           sk_make_sp<PathMeasureInvalidator>(key.getSharedID()));
+    }
+    meas->setTable(std::move(table));
+}
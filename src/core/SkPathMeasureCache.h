@@ -0,0 +1,34 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkPathMeasureCache_DEFINED
+#define SkPathMeasureCache_DEFINED
+
+#include "SkPath.h"
+#include "SkPathMeasure.h"
+#include "SkResourceCache.h"
+
+/**
+ *  Caches the measured contours of immutable paths in SkResourceCache, keyed by the path's
+ *  generation ID, forceClosed and resScale, so that path effects which measure the same path on
+ *  every draw (trims, dashes, 1D path effects) only measure it once.  Entries are purged when the
+ *  path's SkPathRef changes or goes away.
+ */
+class SkPathMeasureCache {
+public:
+    /**
+     *  Like meas->setPath(&path, forceClosed) with meas made for resScale, but shares the
+     *  measurements with every other measure set up this way, if the path is worth caching.
+     */
+    static void SetPath(SkPathMeasure* meas, const SkPath& path, bool forceClosed,
+                        SkScalar resScale = 1, SkResourceCache* localCache = nullptr);
+
+private:
+    struct Rec;
+};
+
+#endif
@@ -9,6 +9,7 @@
 #define SkPathMeasurePriv_DEFINED
 
 #include "SkPath.h"
+#include "SkPathMeasure.h"
 #include "SkPoint.h"
 #include "SkGeometry.h"
 
@@ -26,4 +27,24 @@ enum SkSegType {
 void SkPathMeasure_segTo(const SkPoint pts[], unsigned segType,
                    SkScalar startT, SkScalar stopT, SkPath* dst);
 
+class SkPathMeasure::Table : public SkNVRefCnt<Table> {
+public:
+    struct Contour {
+        int         fFirstSegment;
+        int         fSegmentCount;
+        SkScalar    fLength;
+        bool        fIsClosed;
+    };
+
+    size_t bytesUsed() const {
+        return sizeof(*this) + fSegments.bytes() + fPts.bytes() + fContours.bytes();
+    }
+
+    SkTDArray<Segment>  fSegments;  // every contour's segments, one after another
+    SkTDArray<SkPoint>  fPts;
+    // Each contour an SkPathMeasure would visit, ending with the one where nextContour()
+    // returns false.
+    SkTDArray<Contour>  fContours;
+};
+
 #endif  // SkPathMeasurePriv_DEFINED
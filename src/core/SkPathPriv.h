@@ -91,6 +91,17 @@ public:
         path.fPathRef->addGenIDChangeListener(std::move(listener));
     }
 
+    /**
+     * Hashes the fill type, verbs, points and conic weights: paths that are == hash the same,
+     * whether or not they share an SkPathRef.
+     */
+    static uint32_t ContentHash(const SkPath& path);
+
+    /** Hash functor for SkTHashMap/SkTHashSet keyed on path contents. */
+    struct ContentHasher {
+        uint32_t operator()(const SkPath& path) const { return ContentHash(path); }
+    };
+
     /**
      * This returns true for a rect that begins and ends at the same corner and has either a move
      * followed by four lines or a move followed by 3 lines and a close. None of the parameters are
@@ -8,6 +8,7 @@
 #include "SkPathRef.h"
 
 #include "SkBuffer.h"
+#include "SkMemoryCounters.h"
 #include "SkNx.h"
 #include "SkOnce.h"
 #include "SkPath.h"
@@ -53,7 +54,7 @@ SkPathRef::Editor::Editor(sk_sp<SkPathRef>* pathRef,
 void SkPath::shrinkToFit() {
     const size_t kMinFreeSpaceForShrink = 8;    // just made up a small number
 
-    if (fPathRef->fFreeSpace <= kMinFreeSpaceForShrink) {
+    if (fPathRef->fFreeSpace <= kMinFreeSpaceForShrink || fPathRef->usesInlineStorage()) {
         return;
     }
 
@@ -65,6 +66,22 @@ void SkPath::shrinkToFit() {
         size_t vrbSize = sizeof(uint8_t) * verbCount;
         size_t minSize = ptsSize + vrbSize;
 
+        if (minSize <= SkPathRef::kInlineStorageSize) {
+            // Move into the path ref's inline storage, and free the heap allocation.
+            SkPoint* points = reinterpret_cast<SkPoint*>(fPathRef->fInlineStorage);
+            sk_careful_memcpy(points, fPathRef->fPoints, ptsSize);
+            sk_careful_memcpy((char*)points + SkPathRef::kInlineStorageSize - vrbSize,
+                              fPathRef->verbsMemBegin(), vrbSize);
+            SkPathRef::TrackStorage(fPathRef->currSize(), 0);
+            sk_free(fPathRef->fPoints);
+            fPathRef->fPoints = points;
+            fPathRef->fVerbs = (uint8_t*)points + SkPathRef::kInlineStorageSize;
+            fPathRef->fFreeSpace = SkPathRef::kInlineStorageSize - minSize;
+            fPathRef->fConicWeights.shrinkToFit();
+            SkDEBUGCODE(fPathRef->validate();)
+            return;
+        }
+
         void* newAlloc = sk_malloc_canfail(minSize);
         if (!newAlloc) {
             return; // couldn't allocate the smaller buffer, but that's ok
@@ -73,6 +90,7 @@ void SkPath::shrinkToFit() {
         sk_careful_memcpy(newAlloc, fPathRef->fPoints, ptsSize);
         sk_careful_memcpy((char*)newAlloc + minSize - vrbSize, fPathRef->verbsMemBegin(), vrbSize);
 
+        SkPathRef::TrackStorage(fPathRef->currSize(), minSize);
         sk_free(fPathRef->fPoints);
         fPathRef->fPoints = static_cast<SkPoint*>(newAlloc);
         fPathRef->fVerbs = (uint8_t*)newAlloc + minSize;
@@ -89,15 +107,21 @@ void SkPath::shrinkToFit() {
 
 //////////////////////////////////////////////////////////////////////////////
 
+void SkPathRef::TrackStorage(size_t oldSize, size_t newSize) {
+    if (newSize > oldSize) {
+        SkMemoryCounters::Add(SkGraphics::MemoryCounters::kPathRef, newSize - oldSize);
+    } else if (newSize < oldSize) {
+        SkMemoryCounters::Remove(SkGraphics::MemoryCounters::kPathRef, oldSize - newSize);
+    }
+}
+
 SkPathRef::~SkPathRef() {
     // Deliberately don't validate() this path ref, otherwise there's no way
     // to read one that's not valid and then free its memory without asserting.
     this->callGenIDChangeListeners();
     SkASSERT(fGenIDChangeListeners.empty());  // These are raw ptrs.
-    sk_free(fPoints);
+    this->freeStorage();
 
-    SkDEBUGCODE(fPoints = nullptr;)
-    SkDEBUGCODE(fVerbs = nullptr;)
     SkDEBUGCODE(fVerbCnt = 0x9999999;)
     SkDEBUGCODE(fPointCnt = 0xAAAAAAA;)
     SkDEBUGCODE(fPointCnt = 0xBBBBBBB;)
@@ -277,15 +277,32 @@ void SkPictureData::flatten(SkWriteBuffer& buffer) const {
 
 ///////////////////////////////////////////////////////////////////////////////
 
+// Reads the next size bytes of stream. If stream reads mapped from its start, this returns them
+// as a subset of mapped instead of a copy, if they are 4-byte aligned as SkReadBuffer needs.
+static sk_sp<SkData> data_from_stream(SkStream* stream, const SkData* mapped, size_t size) {
+    if (mapped && stream->hasPosition()) {
+        const size_t offset = stream->getPosition();
+        if (SkIsAlign4((uintptr_t)mapped->bytes() + offset)) {
+            auto data = SkData::MakeSubset(mapped, offset, size);
+            if (!data || stream->skip(size) != size) {
+                return nullptr;
+            }
+            return data;
+        }
+    }
+    return SkData::MakeFromStream(stream, size);
+}
+
 bool SkPictureData::parseStreamTag(SkStream* stream,
                                    uint32_t tag,
                                    uint32_t size,
                                    const SkDeserialProcs& procs,
-                                   SkTypefacePlayback* topLevelTFPlayback) {
+                                   SkTypefacePlayback* topLevelTFPlayback,
+                                   const SkData* mapped) {
     switch (tag) {
         case SK_PICT_READER_TAG:
             SkASSERT(nullptr == fOpData);
-            fOpData = SkData::MakeFromStream(stream, size);
+            fOpData = data_from_stream(stream, mapped, size);
             if (!fOpData) {
                 return false;
             }
@@ -321,7 +338,7 @@ bool SkPictureData::parseStreamTag(SkStream* stream,
             fPictures.reserve(SkToInt(size));
 
             for (uint32_t i = 0; i < size; i++) {
-                auto pic = SkPicture::MakeFromStream(stream, &procs, topLevelTFPlayback);
+                auto pic = SkPicture::MakeFromStream(stream, &procs, topLevelTFPlayback, mapped);
                 if (!pic) {
                     return false;
                 }
@@ -329,13 +346,18 @@ bool SkPictureData::parseStreamTag(SkStream* stream,
             }
         } break;
         case SK_PICT_BUFFER_SIZE_TAG: {
-            SkAutoMalloc storage(size);
-            if (stream->read(storage.get(), size) != size) {
+            const size_t offset = stream->hasPosition() ? stream->getPosition() : 0;
+            sk_sp<SkData> storage = data_from_stream(stream, mapped, size);
+            if (!storage) {
                 return false;
             }
 
-            SkReadBuffer buffer(storage.get(), size);
+            SkReadBuffer buffer(storage->data(), size);
             buffer.setVersion(fInfo.getVersion());
+            if (mapped) {
+                // Even if storage is a copy, images and vertices can reference the mapping.
+                buffer.setBackingData(mapped, offset);
+            }
 
             if (!fFactoryPlayback) {
                 return false;
@@ -443,9 +465,8 @@ void SkPictureData::parseBufferTag(SkReadBuffer& buffer, uint32_t tag, uint32_t
             if (!buffer.validateCanReadN<uint8_t>(size)) {
                 return;
             }
-            auto data(SkData::MakeUninitialized(size));
-            if (!buffer.readByteArray(data->writable_data(), size) ||
-                !buffer.validate(nullptr == fOpData)) {
+            auto data = buffer.readByteArrayAsData();
+            if (!buffer.validate(data && data->size() == size && nullptr == fOpData)) {
                 return;
             }
             SkASSERT(nullptr == fOpData);
@@ -466,13 +487,14 @@ void SkPictureData::parseBufferTag(SkReadBuffer& buffer, uint32_t tag, uint32_t
 SkPictureData* SkPictureData::CreateFromStream(SkStream* stream,
                                                const SkPictInfo& info,
                                                const SkDeserialProcs& procs,
-                                               SkTypefacePlayback* topLevelTFPlayback) {
+                                               SkTypefacePlayback* topLevelTFPlayback,
+                                               const SkData* mapped) {
     std::unique_ptr<SkPictureData> data(new SkPictureData(info));
     if (!topLevelTFPlayback) {
         topLevelTFPlayback = &data->fTFPlayback;
     }
 
-    if (!data->parseStream(stream, procs, topLevelTFPlayback)) {
+    if (!data->parseStream(stream, procs, topLevelTFPlayback, mapped)) {
         return nullptr;
     }
     return data.release();
@@ -491,7 +513,8 @@ SkPictureData* SkPictureData::CreateFromBuffer(SkReadBuffer& buffer,
 
 bool SkPictureData::parseStream(SkStream* stream,
                                 const SkDeserialProcs& procs,
-                                SkTypefacePlayback* topLevelTFPlayback) {
+                                SkTypefacePlayback* topLevelTFPlayback,
+                                const SkData* mapped) {
     for (;;) {
         uint32_t tag;
         if (!stream->readU32(&tag)) { return false; }
@@ -501,7 +524,7 @@ bool SkPictureData::parseStream(SkStream* stream,
 
         uint32_t size;
         if (!stream->readU32(&size)) { return false; }
-        if (!this->parseStreamTag(stream, tag, size, procs, topLevelTFPlayback)) {
+        if (!this->parseStreamTag(stream, tag, size, procs, topLevelTFPlayback, mapped)) {
             return false; // we're invalid
         }
     }
@@ -0,0 +1,200 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkPicture.h"
+
+#include "SkBitmapCache.h"
+#include "SkBitmapProvider.h"
+#include "SkDrawable.h"
+#include "SkExecutor.h"
+#include "SkImage_Base.h"
+#include "SkMipMap.h"
+#include "SkNoDrawCanvas.h"
+#include "SkTArray.h"
+#include "SkTHash.h"
+#include "SkTaskGroup.h"
+
+#if SK_SUPPORT_GPU
+#include "GrSamplerState.h"
+#include "SkYUVAIndex.h"
+#include "SkYUVASizeInfo.h"
+#endif
+
+namespace {
+
+// What playback will need of one lazily generated image.
+struct ImageUse {
+    sk_sp<const SkImage> fImage;
+    // Whether it is drawn smaller, filtered through its mipmap, and if so the smallest scale.
+    bool                 fMipped = false;
+    SkSize               fMinScale = { SK_Scalar1, SK_Scalar1 };
+};
+
+// Plays back a picture to find the lazily generated images it draws, and at what scales,
+// without drawing anything. Nested pictures and drawables are played back too.
+class ImageUseCanvas : public SkNoDrawCanvas {
+public:
+    ImageUseCanvas(const SkIRect& bounds) : SkNoDrawCanvas(bounds) {}
+
+    const SkTArray<ImageUse>& uses() const { return fUses; }
+
+protected:
+    void onDrawImage(const SkImage* image, SkScalar x, SkScalar y,
+                     const SkPaint* paint) override {
+        SkRect dst = SkRect::MakeXYWH(x, y, image->width(), image->height());
+        this->use(image, SkMatrix::MakeTrans(x, y), &dst, paint);
+    }
+
+    void onDrawImageRect(const SkImage* image, const SkRect* src, const SkRect& dst,
+                         const SkPaint* paint, SrcRectConstraint) override {
+        SkRect bounds = src ? *src : SkRect::Make(image->bounds());
+        this->use(image, SkMatrix::MakeRectToRect(bounds, dst, SkMatrix::kFill_ScaleToFit), &dst,
+                  paint);
+    }
+
+    // Nine patches and lattices stretch, but their corners are drawn unscaled.
+    void onDrawImageNine(const SkImage* image, const SkIRect&, const SkRect& dst,
+                         const SkPaint*) override {
+        this->use(image, SkMatrix::I(), &dst, nullptr);
+    }
+
+    void onDrawImageLattice(const SkImage* image, const Lattice&, const SkRect& dst,
+                            const SkPaint*) override {
+        this->use(image, SkMatrix::I(), &dst, nullptr);
+    }
+
+    void onDrawImageSet(const ImageSetEntry set[], int count, const SkMatrix preViewMatrices[],
+                        SkFilterQuality quality, SkBlendMode) override {
+        SkPaint paint;
+        paint.setFilterQuality(quality);
+        for (int i = 0; i < count; ++i) {
+            SkMatrix local = SkMatrix::MakeRectToRect(set[i].fSrcRect, set[i].fDstRect,
+                                                      SkMatrix::kFill_ScaleToFit);
+            SkRect dst = set[i].fDstRect;
+            if (set[i].fMatrixIndex >= 0) {
+                const SkMatrix& preView = preViewMatrices[set[i].fMatrixIndex];
+                local.postConcat(preView);
+                preView.mapRect(&dst);
+            }
+            this->use(set[i].fImage.get(), local, &dst, &paint);
+        }
+    }
+
+    void onDrawAtlas(const SkImage* atlas, const SkRSXform[], const SkRect[], const SkColor[],
+                     int, SkBlendMode, const SkRect* cull, const SkPaint*) override {
+        this->use(atlas, SkMatrix::I(), cull, nullptr);
+    }
+
+    void onDrawPicture(const SkPicture* picture, const SkMatrix* matrix,
+                       const SkPaint* paint) override {
+        this->SkCanvas::onDrawPicture(picture, matrix, paint);
+    }
+
+    void onDrawDrawable(SkDrawable* drawable, const SkMatrix* matrix) override {
+        drawable->draw(this, matrix);
+    }
+
+private:
+    // local maps the image's pixels to where they are drawn, within dst if it is known, before
+    // the canvas matrix.
+    void use(const SkImage* image, const SkMatrix& local, const SkRect* dst,
+             const SkPaint* paint) {
+        if (!image->isLazyGenerated() || (dst && this->quickReject(*dst))) {
+            return;
+        }
+
+        ImageUse* use;
+        if (int* index = fIndices.find(image->uniqueID())) {
+            use = &fUses[*index];
+        } else {
+            fIndices.set(image->uniqueID(), fUses.count());
+            use = &fUses.push_back();
+            use->fImage = sk_ref_sp(image);
+        }
+
+        // This mirrors SkBitmapController and GrSkFilterQualityToGrFilterMode(), which filter
+        // through the mipmap when a medium (or high, which falls back to medium) quality draw
+        // scales down.
+        SkSize scale;
+        if (paint && paint->getFilterQuality() >= kMedium_SkFilterQuality &&
+            SkMatrix::Concat(this->getTotalMatrix(), local).decomposeScale(&scale) &&
+            (scale.width() < SK_Scalar1 || scale.height() < SK_Scalar1)) {
+            use->fMipped = true;
+            use->fMinScale.set(SkTMin(use->fMinScale.width(),  scale.width()),
+                               SkTMin(use->fMinScale.height(), scale.height()));
+        }
+    }
+
+    SkTArray<ImageUse>        fUses;
+    SkTHashMap<uint32_t, int> fIndices;  // Image unique ID to its index in fUses.
+};
+
+}  // namespace
+
+static void prefetch_image(const ImageUse& use, bool gpu) {
+    SkImage_Base* image = as_IB(const_cast<SkImage*>(use.fImage.get()));
+#if SK_SUPPORT_GPU
+    // Without a mipmap, the GPU converts YUV planes itself, if the image has them.
+    if (gpu && !use.fMipped) {
+        SkYUVASizeInfo sizeInfo;
+        SkYUVAIndex yuvaIndices[SkYUVAIndex::kIndexCount];
+        SkYUVColorSpace colorSpace;
+        const void* planes[SkYUVASizeInfo::kMaxCount];
+        if (image->getPlanes(&sizeInfo, yuvaIndices, &colorSpace, planes)) {
+            return;
+        }
+    }
+#endif
+
+    SkBitmap bitmap;
+    if (!image->getROPixels(&bitmap) || !use.fMipped || gpu) {
+        return;
+    }
+
+    // Mipmaps generate their levels lazily, so also ask for the smallest one playback will use.
+    SkBitmapProvider provider(use.fImage.get());
+    sk_sp<const SkMipMap> mipmap(SkMipMapCache::FindAndRef(provider.makeCacheDesc()));
+    if (!mipmap) {
+        mipmap.reset(SkMipMapCache::AddAndRef(provider));
+    }
+    SkMipMap::Level level;
+    if (mipmap) {
+        mipmap->extractLevel(use.fMinScale, &level);
+    }
+}
+
+void SkPicture::prefetchImages(SkExecutor* executor, const SkMatrix& matrix, const SkRect& clip,
+                               GrContext* context) const {
+    ImageUseCanvas canvas(clip.roundOut());
+    canvas.clipRect(clip);
+    canvas.setMatrix(matrix);
+    this->playback(&canvas);
+
+    const SkTArray<ImageUse>& uses = canvas.uses();
+    auto prefetch = [&](int i) { prefetch_image(uses[i], SkToBool(context)); };
+    if (executor) {
+        // Drawing should never wait behind a prefetch.
+        SkTaskGroup(*executor).batch(uses.count(), prefetch, SkExecutor::Priority::kBackground);
+    } else {
+        for (int i = 0; i < uses.count(); ++i) {
+            prefetch(i);
+        }
+    }
+
+#if SK_SUPPORT_GPU
+    // Textures are cached under the image's key, where drawing it will find them.
+    if (context) {
+        for (const ImageUse& use : uses) {
+            GrSamplerState sampler(GrSamplerState::WrapMode::kClamp,
+                                   use.fMipped ? GrSamplerState::Filter::kMipMap
+                                               : GrSamplerState::Filter::kBilerp);
+            SkScalar scaleAdjust[2];
+            as_IB(use.fImage.get())->asTextureProxyRef(context, sampler, scaleAdjust);
+        }
+    }
+#endif
+}
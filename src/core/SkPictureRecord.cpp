@@ -543,7 +543,29 @@ void SkPictureRecord::onDrawImageLattice(const SkImage* image, const Lattice& la
 }
 
 void SkPictureRecord::onDrawImageSet(const SkCanvas::ImageSetEntry set[], int count,
+                                     const SkMatrix preViewMatrices[],
                                      SkFilterQuality filterQuality, SkBlendMode mode) {
+    if (preViewMatrices) {
+        // DRAW_IMAGE_SET has no per-entry matrices, so runs of entries that share a matrix are
+        // written as a concat and a set of their own.
+        int base = 0;
+        for (int i = 1; i <= count; ++i) {
+            if (i < count && set[i].fMatrixIndex == set[base].fMatrixIndex) {
+                continue;
+            }
+            int matrixIndex = set[base].fMatrixIndex;
+            if (matrixIndex >= 0) {
+                this->save();
+                this->concat(preViewMatrices[matrixIndex]);
+            }
+            this->onDrawImageSet(set + base, i - base, nullptr, filterQuality, mode);
+            if (matrixIndex >= 0) {
+                this->restore();
+            }
+            base = i;
+        }
+        return;
+    }
     // op + count + alpha + fq + mode + (image index, src rect, dst rect, alpha, aa flags) * cnt
     size_t size =
             4 * kUInt32Size + (2 * kUInt32Size + 2 * sizeof(SkRect) + sizeof(SkScalar)) * count;
@@ -844,8 +866,12 @@ void SkPictureRecord::addMatrix(const SkMatrix& matrix) {
 
 void SkPictureRecord::addPaintPtr(const SkPaint* paint) {
     if (paint) {
-        fPaints.push_back(*paint);
-        this->addInt(fPaints.count());
+        int* n = fPaintIndices.find(*paint);
+        if (!n) {
+            fPaints.push_back(*paint);
+            n = fPaintIndices.set(*paint, fPaints.count());
+        }
+        this->addInt(*n);
     } else {
         this->addInt(0);
     }
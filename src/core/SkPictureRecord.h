@@ -11,6 +11,7 @@
 #include "SkCanvas.h"
 #include "SkCanvasVirtualEnforcer.h"
 #include "SkFlattenable.h"
+#include "SkPathPriv.h"
 #include "SkPicture.h"
 #include "SkPictureData.h"
 #include "SkTArray.h"
@@ -193,8 +194,8 @@ protected:
                          const SkPaint*) override;
     void onDrawImageLattice(const SkImage*, const SkCanvas::Lattice& lattice, const SkRect& dst,
                             const SkPaint*) override;
-    void onDrawImageSet(const SkCanvas::ImageSetEntry[], int count, SkFilterQuality,
-                        SkBlendMode) override;
+    void onDrawImageSet(const SkCanvas::ImageSetEntry[], int count, const SkMatrix[],
+                        SkFilterQuality, SkBlendMode) override;
     void onDrawShadowRec(const SkPath&, const SkDrawShadowRec&) override;
     void onDrawVerticesObject(const SkVertices*, const SkVertices::Bone bones[], int boneCount,
                               SkBlendMode, const SkPaint&) override;
@@ -243,12 +244,15 @@ protected:
     }
 
 private:
+    // Paints and paths are deduplicated by contents, so equal ones rebuilt for each draw are
+    // only written once.
     SkTArray<SkPaint>  fPaints;
-
-    struct PathHash {
-        uint32_t operator()(const SkPath& p) { return p.getGenerationID(); }
+    struct PaintHash {
+        uint32_t operator()(const SkPaint& p) const { return p.getHash(); }
     };
-    SkTHashMap<SkPath, int, PathHash> fPaths;
+    SkTHashMap<SkPaint, int, PaintHash> fPaintIndices;
+
+    SkTHashMap<SkPath, int, SkPathPriv::ContentHasher> fPaths;
 
     SkWriter32 fWriter;
 
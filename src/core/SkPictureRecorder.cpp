@@ -45,6 +45,7 @@ SkCanvas* SkPictureRecorder::beginRecording(const SkRect& userCullRect,
         ? SkRecorder::Playback_DrawPictureMode
         : SkRecorder::Record_DrawPictureMode;
     fRecorder->reset(fRecord.get(), cullRect, dpm, fMiniRecorder.get());
+    fRecorder->setDedupesContent(recordFlags & kDedupeContent_RecordFlag);
     fActivelyRecording = true;
     return this->getRecordingCanvas();
 }
@@ -65,6 +66,9 @@ sk_sp<SkPicture> SkPictureRecorder::finishRecordingAsPicture(uint32_t finishFlag
 
     // TODO: delay as much of this work until just before first playback?
     SkRecordOptimize(fRecord.get());
+    if (finishFlags & kOptimizeDrawCalls_FinishFlag) {
+        SkRecordOptimizeDrawCalls(fRecord.get());
+    }
 
     SkDrawableList* drawableList = fRecorder->getDrawableList();
     SkBigPicture::SnapshotArray* pictList =
@@ -119,6 +123,9 @@ sk_sp<SkDrawable> SkPictureRecorder::finishRecordingAsDrawable(uint32_t finishFl
     fRecorder->restoreToCount(1);  // If we were missing any restores, add them now.
 
     SkRecordOptimize(fRecord.get());
+    if (finishFlags & kOptimizeDrawCalls_FinishFlag) {
+        SkRecordOptimizeDrawCalls(fRecord.get());
+    }
 
     if (fBBH.get()) {
         SkAutoTMalloc<SkRect> bounds(fRecord->count());
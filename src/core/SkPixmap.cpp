@@ -12,6 +12,7 @@
 #include "SkConvertPixels.h"
 #include "SkData.h"
 #include "SkDraw.h"
+#include "SkExecutor.h"
 #include "SkHalf.h"
 #include "SkImageInfoPriv.h"
 #include "SkImageShader.h"
@@ -20,6 +21,7 @@
 #include "SkPixmapPriv.h"
 #include "SkRasterClip.h"
 #include "SkReadPixelsRec.h"
+#include "SkResizer.h"
 #include "SkSurface.h"
 #include "SkTemplates.h"
 #include "SkTo.h"
@@ -203,6 +205,15 @@ bool SkPixmap::scalePixels(const SkPixmap& actualDst, SkFilterQuality quality) c
         clampAsIfUnpremul = true;
     }
 
+    // Large high quality downscales are resampled directly, filtering every source pixel.
+    if (kHigh_SkFilterQuality == quality &&
+        SkResizer::IsLargeDownscale((float)dst.width()  / src.width(),
+                                    (float)dst.height() / src.height()) &&
+        SkResizer::CanResize(dst, src)) {
+        return SkResizer::Resize(dst, src, SkResizer::Filter::kMitchell,
+                                 &SkExecutor::GetDefault());
+    }
+
     SkBitmap bitmap;
     if (!bitmap.installPixels(src)) {
         return false;
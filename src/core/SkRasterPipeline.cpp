@@ -6,8 +6,11 @@
  */
 
 #include "SkRasterPipeline.h"
+#include "SkLRUCache.h"
+#include "SkMutex.h"
 #include "SkOpts.h"
 #include <algorithm>
+#include <atomic>
 
 SkRasterPipeline::SkRasterPipeline(SkArenaAlloc* alloc) : fAlloc(alloc) {
     this->reset();
@@ -340,15 +343,104 @@ void SkRasterPipeline::run(size_t x, size_t y, size_t w, size_t h) const {
     start_pipeline(x,y,x+w,y+h, program.get());
 }
 
+// compile() is called every time a blitter is built, usually with one of a small set of stage
+// lists.  We cache the stage and start functions picked by build_pipeline() for each list: the
+// key records each stage and whether it has a context, which fixes the layout of the program,
+// and the cached program has null context slots to be filled in for each compile().
+namespace {
+    struct ProgramKey {
+        SkTArray<uint64_t> fWords;   // stage (or raw function), flags, ... per stage, back to front
+        uint32_t           fHash;
+
+        bool operator==(const ProgramKey& that) const {
+            return fHash == that.fHash && fWords == that.fWords;
+        }
+        struct Hash {
+            uint32_t operator()(const ProgramKey& k) const { return k.fHash; }
+        };
+    };
+
+    struct CachedProgram {
+        void (*fStart)(size_t,size_t,size_t,size_t, void** program);
+        SkTArray<void*> fSlots;      // fSlotsNeeded entries, with nullptr for each context
+    };
+
+    static constexpr int kProgramCacheCountLimit = 256;
+
+    SK_DECLARE_STATIC_MUTEX(gProgramCacheMutex);
+    static SkLRUCache<ProgramKey, CachedProgram, ProgramKey::Hash>* program_cache() {
+        static auto* cache =
+            new SkLRUCache<ProgramKey, CachedProgram, ProgramKey::Hash>(kProgramCacheCountLimit);
+        return cache;
+    }
+    static std::atomic<int> gProgramCacheHits{0},
+                            gProgramCacheMisses{0};
+}
+
 std::function<void(size_t, size_t, size_t, size_t)> SkRasterPipeline::compile() const {
     if (this->empty()) {
         return [](size_t, size_t, size_t, size_t) {};
     }
 
+    ProgramKey key;
+    key.fWords.reserve(2*fNumStages);
+    for (const StageList* st = fStages; st; st = st->prev) {
+        key.fWords.push_back(st->stage);
+        key.fWords.push_back((st->ctx ? 1 : 0) | (st->rawFunction ? 2 : 0));
+    }
+    key.fHash = SkOpts::hash(key.fWords.begin(), key.fWords.count() * sizeof(uint64_t));
+
     void** program = fAlloc->makeArray<void*>(fSlotsNeeded);
+    StartPipelineFn start_pipeline;
+    {
+        SkAutoMutexAcquire lock(gProgramCacheMutex);
+        if (const CachedProgram* cached = program_cache()->find(key)) {
+            start_pipeline = cached->fStart;
+            memcpy(program, cached->fSlots.begin(), fSlotsNeeded * sizeof(void*));
+            gProgramCacheHits++;
+        } else {
+            start_pipeline = this->build_pipeline(program + fSlotsNeeded);
+            gProgramCacheMisses++;
+
+            CachedProgram entry;
+            entry.fStart = start_pipeline;
+            entry.fSlots.push_back_n(fSlotsNeeded, program);
+            // Contexts come just after their stage function; clear them out of the cached copy.
+            void** ip = entry.fSlots.begin() + fSlotsNeeded - 1;   // just_return()
+            for (const StageList* st = fStages; st; st = st->prev) {
+                if (st->ctx) {
+                    *--ip = nullptr;
+                }
+                --ip;
+            }
+            SkASSERT(ip == entry.fSlots.begin());
+            program_cache()->insert(key, std::move(entry));
+        }
+    }
+
+    // Fill in this pipeline's contexts, in the same back to front order build_pipeline() uses.
+    void** ip = program + fSlotsNeeded - 1;
+    for (const StageList* st = fStages; st; st = st->prev) {
+        if (st->ctx) {
+            *--ip = st->ctx;
+        }
+        --ip;
+    }
 
-    auto start_pipeline = this->build_pipeline(program + fSlotsNeeded);
     return [=](size_t x, size_t y, size_t w, size_t h) {
         start_pipeline(x,y,x+w,y+h, program);
     };
 }
+
+int SkRasterPipeline::ProgramCacheCountUsed() {
+    SkAutoMutexAcquire lock(gProgramCacheMutex);
+    return program_cache()->count();
+}
+
+int SkRasterPipeline::ProgramCacheHitCount()  { return gProgramCacheHits.load(); }
+int SkRasterPipeline::ProgramCacheMissCount() { return gProgramCacheMisses.load(); }
+
+void SkRasterPipeline::PurgeProgramCache() {
+    SkAutoMutexAcquire lock(gProgramCacheMutex);
+    program_cache()->reset();
+}
@@ -209,8 +209,15 @@ public:
     void run(size_t x, size_t y, size_t w, size_t h) const;
 
     // Allocates a thunk which amortizes run() setup cost in alloc.
+    // The stages picked for each distinct stage list are kept in a process-wide cache.
     std::function<void(size_t, size_t, size_t, size_t)> compile() const;
 
+    // Stats and control for the compile() cache, see SkGraphics.
+    static int  ProgramCacheCountUsed();
+    static int  ProgramCacheHitCount();
+    static int  ProgramCacheMissCount();
+    static void PurgeProgramCache();
+
     void dump() const;
 
     // Appends a stage for the specified matrix.
@@ -54,6 +54,9 @@ private:
     // If we have an burst context, use it to fill our shader buffer.
     void burst_shade(int x, int y, int w);
 
+    // Blend our constant color into F16 pixels, scaled by coverage (see fBlitColorF16).
+    void blit_color_f16(int x, int y, int w, int h, float coverage);
+
     SkPixmap               fDst;
     SkBlendMode            fBlend;
     SkArenaAlloc*          fAlloc;
@@ -70,6 +73,11 @@ private:
     void   (*fMemset2D)(SkPixmap*, int x,int y, int w,int h, uint64_t color) = nullptr;
     uint64_t fMemsetColor = 0;   // Big enough for largest memsettable dst format, F16.
 
+    // Constant colors drawn with SrcOver or Src into premul F16 can skip the pipeline too,
+    // blending fConstantColor (in the dst color space) with SkOpts::blit_row_color_f16().
+    bool        fBlitColorF16 = false;
+    SkPMColor4f fConstantColor = SK_PMColor4fTRANSPARENT;
+
     // Built lazily on first use.
     std::function<void(size_t, size_t, size_t, size_t)> fBlitRect,
                                                         fBlitAntiH,
@@ -214,6 +222,9 @@ SkBlitter* SkRasterPipelineBlitter::Create(const SkPixmap& dst,
         colorPipeline->append_constant_color(alloc, constantColor);
 
         is_opaque = constantColor.fA == 1.0f;
+        // The pipeline works in premul, so constantColor already is, despite its type.
+        blitter->fConstantColor = { constantColor.fR, constantColor.fG,
+                                    constantColor.fB, constantColor.fA };
     }
 
     // We can strength-reduce SrcOver into Src when opaque.
@@ -273,6 +284,13 @@ SkBlitter* SkRasterPipelineBlitter::Create(const SkPixmap& dst,
         }
     }
 
+    if (is_constant
+            && (blitter->fBlend == SkBlendMode::kSrcOver || blitter->fBlend == SkBlendMode::kSrc)
+            && dst.colorType() == kRGBA_F16_SkColorType
+            && dst.alphaType() == kPremul_SkAlphaType) {
+        blitter->fBlitColorF16 = true;
+    }
+
     blitter->fDstPtr = SkRasterPipeline_MemoryCtx{
         blitter->fDst.writable_addr(),
         blitter->fDst.rowBytesAsPixels(),
@@ -318,6 +336,10 @@ void SkRasterPipelineBlitter::blitRect(int x, int y, int w, int h) {
         fMemset2D(&fDst, x,y, w,h, fMemsetColor);
         return;
     }
+    if (fBlitColorF16) {
+        this->blit_color_f16(x,y, w,h, 1.0f);
+        return;
+    }
 
     if (!fBlitRect) {
         SkRasterPipeline p(fAlloc);
@@ -355,7 +377,35 @@ void SkRasterPipelineBlitter::blitRect(int x, int y, int w, int h) {
     }
 }
 
+void SkRasterPipelineBlitter::blit_color_f16(int x, int y, int w, int h, float coverage) {
+    SkASSERT(fBlitColorF16);
+    // Src and SrcOver both scale the color by coverage, differing only in what's left of dst.
+    SkPMColor4f src = fConstantColor * coverage;
+    float dstScale = fBlend == SkBlendMode::kSrc ? 1 - coverage : 1 - src.fA;
+
+    uint64_t* p = fDst.writable_addr64(x,y);
+    auto fn = SkOpts::blit_row_color_f16;
+    while (h --> 0) {
+        fn(p, w, src.vec(), dstScale);
+        p = SkTAddOffset<uint64_t>(p, fDst.rowBytes());
+    }
+}
+
 void SkRasterPipelineBlitter::blitAntiH(int x, int y, const SkAlpha aa[], const int16_t runs[]) {
+    if (fBlitColorF16) {
+        for (int16_t run = *runs; run > 0; run = *runs) {
+            switch (*aa) {
+                case 0x00:                       break;
+                case 0xff: this->blitH(x,y,run); break;  // Might still memset.
+                default:   this->blit_color_f16(x,y, run,1, *aa * (1/255.0f));
+            }
+            x    += run;
+            runs += run;
+            aa   += run;
+        }
+        return;
+    }
+
     if (!fBlitAntiH) {
         SkRasterPipeline p(fAlloc);
         p.extend(fColorPipeline);
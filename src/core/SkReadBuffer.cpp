@@ -5,7 +5,6 @@
  * found in the LICENSE file.
  */
 
-#include "SkAutoMalloc.h"
 #include "SkBitmap.h"
 #include "SkData.h"
 #include "SkImage.h"
@@ -75,6 +74,9 @@ void SkReadBuffer::setInvalid() {
 }
 
 const void* SkReadBuffer::skip(size_t size) {
+    if (fTrusted) {
+        return fReader.skip(size);
+    }
     size_t inc = SkAlign4(size);
     this->validate(inc >= size);
     const void* addr = fReader.peek();
@@ -93,12 +95,16 @@ const void* SkReadBuffer::skip(size_t count, size_t size) {
 
 void SkReadBuffer::setDeserialProcs(const SkDeserialProcs& procs) {
     fProcs = procs;
+    fTrusted = procs.fTrusted;
 }
 
 bool SkReadBuffer::readBool() {
     uint32_t value = this->readUInt();
     // Boolean value should be either 0 or 1
-    this->validate(!(value & ~1));
+    SkASSERT(!fTrusted || !(value & ~1));
+    if (!fTrusted) {
+        this->validate(!(value & ~1));
+    }
     return value != 0;
 }
 
@@ -107,12 +113,18 @@ SkColor SkReadBuffer::readColor() {
 }
 
 int32_t SkReadBuffer::readInt() {
+    if (fTrusted) {
+        return fReader.readInt();
+    }
     const size_t inc = sizeof(int32_t);
     this->validate(IsPtrAlign4(fReader.peek()) && fReader.isAvailable(inc));
     return fError ? 0 : fReader.readInt();
 }
 
 SkScalar SkReadBuffer::readScalar() {
+    if (fTrusted) {
+        return fReader.readScalar();
+    }
     const size_t inc = sizeof(SkScalar);
     this->validate(IsPtrAlign4(fReader.peek()) && fReader.isAvailable(inc));
     return fError ? 0 : fReader.readScalar();
@@ -146,7 +158,8 @@ void SkReadBuffer::readString(SkString* string) {
     const size_t len = this->readUInt();
     // skip over the string + '\0'
     if (const char* src = this->skipT<char>(len + 1)) {
-        if (this->validate(src[len] == 0)) {
+        SkASSERT(!fTrusted || src[len] == 0);
+        if (fTrusted || this->validate(src[len] == 0)) {
             string->set(src, len);
             return;
         }
@@ -223,7 +236,8 @@ void SkReadBuffer::readPath(SkPath* path) {
 
 bool SkReadBuffer::readArray(void* value, size_t size, size_t elementSize) {
     const uint32_t count = this->readUInt();
-    return this->validate(size == count) &&
+    SkASSERT(!fTrusted || size == count);
+    return (fTrusted || this->validate(size == count)) &&
            this->readPad32(value, SkSafeMath::Mul(size, elementSize));
 }
 
@@ -251,21 +265,34 @@ bool SkReadBuffer::readScalarArray(SkScalar* values, size_t size) {
     return this->readArray(values, size, sizeof(SkScalar));
 }
 
-sk_sp<SkData> SkReadBuffer::readByteArrayAsData() {
-    size_t numBytes = this->getArrayCount();
-    if (!this->validate(fReader.isAvailable(numBytes))) {
+sk_sp<SkData> SkReadBuffer::readPad32AsData(size_t bytes) {
+    const size_t offset = fReader.offset();
+    const void* src = this->skip(bytes);
+    if (!src) {
         return nullptr;
     }
+    if (fBackingData) {
+        auto data = SkData::MakeSubset(fBackingData, fBackingOffset + offset, bytes);
+        this->validate(data != nullptr);
+        return data;
+    }
+    return SkData::MakeWithCopy(src, bytes);
+}
 
-    SkAutoMalloc buffer(numBytes);
-    if (!this->readByteArray(buffer.get(), numBytes)) {
+sk_sp<SkData> SkReadBuffer::readByteArrayAsData() {
+    size_t numBytes = this->getArrayCount();
+    if (!this->validate(fReader.isAvailable(numBytes))) {
         return nullptr;
     }
 
-    return SkData::MakeFromMalloc(buffer.release(), numBytes);
+    (void)this->readUInt();     // numBytes, again
+    return this->readPad32AsData(numBytes);
 }
 
 uint32_t SkReadBuffer::getArrayCount() {
+    if (fTrusted) {
+        return *(const uint32_t*)fReader.peek();
+    }
     const size_t inc = sizeof(uint32_t);
     fError = fError || !IsPtrAlign4(fReader.peek()) || !fReader.isAvailable(inc);
     return fError ? 0 : *(uint32_t*)fReader.peek();
@@ -319,8 +346,8 @@ sk_sp<SkImage> SkReadBuffer::readImage() {
         return nullptr;
     }
 
-    sk_sp<SkData> data = SkData::MakeUninitialized(size);
-    if (!this->readPad32(data->writable_data(), size)) {
+    sk_sp<SkData> data = this->readPad32AsData(size);
+    if (!data) {
         this->validate(false);
         return nullptr;
     }
@@ -419,11 +446,13 @@ SkFlattenable* SkReadBuffer::readFlattenable(SkFlattenable::Type ft) {
         obj = (*factory)(*this);
         // check that we read the amount we expected
         size_t sizeRead = fReader.offset() - offset;
-        if (sizeRecorded != sizeRead) {
+        SkASSERT(!fTrusted || sizeRecorded == sizeRead);
+        if (!fTrusted && sizeRecorded != sizeRead) {
             this->validate(false);
             return nullptr;
         }
-        if (obj && obj->getFlattenableType() != ft) {
+        SkASSERT(!fTrusted || !obj || obj->getFlattenableType() == ft);
+        if (!fTrusted && obj && obj->getFlattenableType() != ft) {
             this->validate(false);
             return nullptr;
         }
@@ -442,7 +471,8 @@ SkFlattenable* SkReadBuffer::readFlattenable(SkFlattenable::Type ft) {
 int32_t SkReadBuffer::checkInt(int32_t min, int32_t max) {
     SkASSERT(min <= max);
     int32_t value = this->read32();
-    if (value < min || value > max) {
+    SkASSERT(!fTrusted || (value >= min && value <= max));
+    if (!fTrusted && (value < min || value > max)) {
         this->validate(false);
         value = min;
     }
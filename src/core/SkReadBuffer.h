@@ -85,7 +85,8 @@ public:
 
     template <typename T> T read32LE(T max) {
         uint32_t value = this->readUInt();
-        if (!this->validate(value <= static_cast<uint32_t>(max))) {
+        SkASSERT(!fTrusted || value <= static_cast<uint32_t>(max));
+        if (!fTrusted && !this->validate(value <= static_cast<uint32_t>(max))) {
             value = 0;
         }
         return static_cast<T>(value);
@@ -135,6 +136,16 @@ public:
 
     sk_sp<SkData> readByteArrayAsData();
 
+    /**
+     *  Tells the buffer that its memory holds the bytes of data starting at offset (either in
+     *  place, or a copy of them). readByteArrayAsData() and readImage() then return subsets of
+     *  data instead of copying. data must outlive the buffer.
+     */
+    void setBackingData(const SkData* data, size_t offset) {
+        fBackingData = data;
+        fBackingOffset = offset;
+    }
+
     // helpers to get info about arrays and binary data
     uint32_t getArrayCount();
 
@@ -161,6 +172,12 @@ public:
     void setDeserialProcs(const SkDeserialProcs& procs);
     const SkDeserialProcs& getDeserialProcs() const { return fProcs; }
 
+    /**
+     *  True if the procs marked the data as trusted (see SkDeserialProcs::fTrusted). Reads then
+     *  only assert, in debug builds, what they would otherwise validate.
+     */
+    bool isTrusted() const { return fTrusted; }
+
     /**
      *  If isValid is false, sets the buffer to be "invalid". Returns true if the buffer
      *  is still valid.
@@ -203,6 +220,8 @@ public:
 private:
     void setInvalid();
     bool readArray(void* value, size_t size, size_t elementSize);
+    // Like readPad32(), but returns the bytes as SkData, a subset of fBackingData if there is one.
+    sk_sp<SkData> readPad32AsData(size_t bytes);
     void setMemory(const void*, size_t);
 
     SkReader32 fReader;
@@ -219,6 +238,10 @@ private:
     int                     fFactoryCount;
 
     SkDeserialProcs fProcs;
+    bool            fTrusted = false;
+
+    const SkData* fBackingData = nullptr;
+    size_t        fBackingOffset = 0;
 
     static bool IsPtrAlign4(const void* ptr) {
         return SkIsAlign4((uintptr_t)ptr);
@@ -305,6 +328,7 @@ public:
     bool readScalarArray (SkScalar*,  size_t) { return false; }
 
     sk_sp<SkData> readByteArrayAsData() { return nullptr; }
+    void setBackingData(const SkData*, size_t) {}
     uint32_t getArrayCount() { return 0; }
 
     sk_sp<SkImage>    readImage()    { return nullptr; }
@@ -328,6 +352,8 @@ public:
         static const SkDeserialProcs procs;
         return procs;
     }
+
+    bool isTrusted() const { return false; }
 };
 
 #endif // #ifndef SK_DISABLE_READBUFFER
@@ -109,7 +109,8 @@ template <> void Draw::draw(const DrawImageLattice& r) {
 
 DRAW(DrawImageRect, legacy_drawImageRect(r.image.get(), r.src, r.dst, r.paint, r.constraint));
 DRAW(DrawImageNine, drawImageNine(r.image.get(), r.center, r.dst, r.paint));
-DRAW(DrawImageSet, experimental_DrawImageSetV1(r.set.get(), r.count, r.quality, r.mode));
+DRAW(DrawImageSet, experimental_DrawImageSetV2(r.set.get(), r.count, r.preViewMatrices,
+                                               r.quality, r.mode));
 DRAW(DrawOval, drawOval(r.oval, r.paint));
 DRAW(DrawPaint, drawPaint(r.paint));
 DRAW(DrawPath, drawPath(r.path, r.paint));
@@ -387,7 +388,11 @@ private:
     Bounds bounds(const DrawImageSet& op) const {
         SkRect rect = SkRect::MakeEmpty();
         for (int i = 0; i < op.count; ++i) {
-            rect.join(this->adjustAndMap(op.set[i].fDstRect, nullptr));
+            SkRect dst = op.set[i].fDstRect;
+            if (op.set[i].fMatrixIndex >= 0) {
+                op.preViewMatrices[op.set[i].fMatrixIndex].mapRect(&dst);
+            }
+            rect.join(this->adjustAndMap(dst, nullptr));
         }
         return rect;
     }
@@ -8,8 +8,12 @@
 #include "SkRecordOpts.h"
 
 #include "SkCanvasPriv.h"
+#include "SkClipOpPriv.h"
 #include "SkRecordPattern.h"
 #include "SkRecords.h"
+#include "SkRegion.h"
+#include "SkShader.h"
+#include "SkTArray.h"
 #include "SkTDArray.h"
 
 using namespace SkRecords;
@@ -289,6 +293,352 @@ void SkRecordMergeSvgOpacityAndFilterLayers(SkRecord* record) {
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
+// Matches a Translate, or a Concat of a matrix that only translates, and stores the offset.
+class IsTranslation {
+public:
+    typedef SkVector type;
+    type* get() { return &fOffset; }
+
+    bool operator()(Translate* op) {
+        fOffset.set(op->dx, op->dy);
+        return true;
+    }
+
+    bool operator()(Concat* op) {
+        if (op->matrix.getType() & ~SkMatrix::kTranslate_Mask) {
+            return false;
+        }
+        fOffset.set(op->matrix.getTranslateX(), op->matrix.getTranslateY());
+        return true;
+    }
+
+    template <typename T>
+    bool operator()(T*) { return false; }
+
+private:
+    SkVector fOffset;
+};
+
+// Folds Translation-NoOp*-Translation into a single Translate.
+struct TranslateMerger {
+    typedef Pattern<IsTranslation, Greedy<Is<NoOp>>, IsTranslation> Match;
+
+    bool onMatch(SkRecord* record, Match* match, int begin, int end) {
+        SkVector offset = *match->first<SkVector>() + *match->third<SkVector>();
+        record->replace<NoOp>(begin);
+        new (record->replace<Translate>(end-1)) Translate{offset.fX, offset.fY};
+        return true;
+    }
+};
+
+void SkRecordMergeTranslates(SkRecord* record) {
+    TranslateMerger pass;
+    while (apply(&pass, record));
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+static bool clip_op_shrinks(SkClipOp op) {
+    return op == kIntersect_SkClipOp || op == kDifference_SkClipOp;
+}
+
+// Tracks, per save level, a rect that bounds the clip in the current local coordinates: the
+// intersection of all the non-AA intersect ClipRects since the last matrix change. A later non-AA
+// intersect ClipRect that contains it can't change which pixels the clip lets through.
+struct RedundantClipRectNooper {
+    struct Frame {
+        SkRect fBounds;
+        bool   fValid;
+    };
+
+    explicit RedundantClipRectNooper(SkRecord* record) : fRecord(record) {
+        fFrames.push_back({SkRect::MakeEmpty(), false});
+    }
+
+    Frame& top() { return fFrames.back(); }
+
+    void operator()(Save*)      { fFrames.push_back(this->top()); }
+    void operator()(SaveLayer*) { fFrames.push_back(this->top()); }
+    void operator()(Restore*) {
+        if (fFrames.count() > 1) {
+            fFrames.pop_back();
+        }
+    }
+
+    void operator()(SetMatrix*) { this->top().fValid = false; }
+    void operator()(Translate*) { this->top().fValid = false; }
+    void operator()(Concat*)    { this->top().fValid = false; }
+
+    void operator()(ClipRect* op) {
+        Frame& frame = this->top();
+        if (op->opAA.op() != kIntersect_SkClipOp || op->opAA.aa()) {
+            frame.fValid &= clip_op_shrinks(op->opAA.op());
+            return;
+        }
+        if (frame.fValid && op->rect.contains(frame.fBounds)) {
+            fRecord->replace<NoOp>(fIndex);
+            return;
+        }
+        if (!frame.fValid) {
+            frame.fBounds = op->rect;
+            frame.fValid = true;
+        } else if (!frame.fBounds.intersect(op->rect)) {
+            frame.fBounds.setEmpty();
+        }
+    }
+    void operator()(ClipRRect* op)  { this->top().fValid &= clip_op_shrinks(op->opAA.op()); }
+    void operator()(ClipPath* op)   { this->top().fValid &= clip_op_shrinks(op->opAA.op()); }
+    void operator()(ClipRegion* op) { this->top().fValid &= clip_op_shrinks(op->op); }
+
+    template <typename T>
+    void operator()(T*) {}
+
+    SkRecord*             fRecord;
+    int                   fIndex = 0;
+    SkSTArray<16, Frame>  fFrames;
+};
+
+void SkRecordNoopRedundantClipRects(SkRecord* record) {
+    RedundantClipRectNooper nooper(record);
+    for (nooper.fIndex = 0; nooper.fIndex < record->count(); nooper.fIndex++) {
+        record->mutate(nooper.fIndex, nooper);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+// A DrawRect that replaces every pixel it touches, whatever was drawn there before.
+static bool is_opaque_rect_fill(const SkPaint& paint) {
+    return SkPaint::kFill_Style == paint.getStyle() &&
+           !paint.isAntiAlias() &&
+           0xFF == paint.getAlpha() &&
+           (paint.isSrcOver() || SkBlendMode::kSrc == paint.getBlendMode()) &&
+           (!paint.getShader() || paint.getShader()->isOpaque()) &&
+           !paint.getColorFilter() &&
+           !paint.getMaskFilter() &&
+           !paint.getImageFilter() &&
+           !paint.getLooper() &&
+           !paint.getPathEffect();
+}
+
+// Finds the local bounds of draws that only touch pixels whose centers fall inside those bounds,
+// i.e. draws that a later opaque, non-AA DrawRect covering the bounds will completely hide.
+struct OccludableDraw {
+    SkRect fBounds;
+    bool   fOccluder;
+
+    bool operator()(DrawRect* op) {
+        fOccluder = is_opaque_rect_fill(op->paint);
+        return this->set(&op->paint, op->rect);
+    }
+    bool operator()(DrawRRect* op)  { return this->set(&op->paint, op->rrect.getBounds()); }
+    bool operator()(DrawOval* op)   { return this->set(&op->paint, op->oval); }
+    bool operator()(DrawRegion* op) {
+        return this->set(&op->paint, SkRect::Make(op->region.getBounds()));
+    }
+    bool operator()(DrawPath* op) {
+        return !op->path.isInverseFillType() && this->set(&op->paint, op->path.getBounds());
+    }
+    bool operator()(DrawImage* op) {
+        return this->set(op->paint, SkRect::MakeXYWH(op->left, op->top, op->image->width(),
+                                                     op->image->height()));
+    }
+    bool operator()(DrawImageRect* op) { return this->set(op->paint, op->dst); }
+
+    template <typename T>
+    bool operator()(T*) { return false; }
+
+    bool set(const SkPaint* paint, const SkRect& bounds) {
+        fBounds = bounds;
+        if (!paint) {
+            return true;
+        }
+        // Antialiased draws and hairlines can touch pixels whose centers lie outside their bounds.
+        bool hairline = SkPaint::kFill_Style != paint->getStyle() && 0 == paint->getStrokeWidth();
+        if (paint->isAntiAlias() || hairline || paint->getMaskFilter() ||
+            paint->getImageFilter() || paint->getLooper() || !paint->canComputeFastBounds()) {
+            return false;
+        }
+        SkRect storage;
+        fBounds = paint->computeFastBounds(bounds, &storage);
+        return true;
+    }
+};
+
+void SkRecordNoopOccludedDraws(SkRecord* record) {
+    // Looking back is quadratic, so we only keep this many candidates at a time.
+    static constexpr int kMaxCandidates = 64;
+
+    // Draws since the last change to the matrix, clip, or layer.
+    SkSTArray<kMaxCandidates, int, true>    candidates;
+    SkSTArray<kMaxCandidates, SkRect, true> candidateBounds;
+
+    Is<NoOp> isNoOp;
+    IsDraw isDraw;
+    for (int i = 0; i < record->count(); i++) {
+        OccludableDraw draw;
+        draw.fOccluder = false;
+        if (record->mutate(i, draw)) {
+            if (draw.fOccluder) {
+                for (int j = candidates.count() - 1; j >= 0; j--) {
+                    if (draw.fBounds.contains(candidateBounds[j])) {
+                        record->replace<NoOp>(candidates[j]);
+                        candidates.removeShuffle(j);
+                        candidateBounds.removeShuffle(j);
+                    }
+                }
+            }
+            if (candidates.count() == kMaxCandidates) {
+                candidates.removeShuffle(0);
+                candidateBounds.removeShuffle(0);
+            }
+            candidates.push_back(i);
+            candidateBounds.push_back(draw.fBounds);
+        } else if (!record->mutate(i, isNoOp) && !record->mutate(i, isDraw)) {
+            // Other draws can stay in between, but anything else changes what later draws cover.
+            candidates.reset();
+            candidateBounds.reset();
+        }
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Non-AA fills of rects whose edges fall on integers can be drawn together as one region, as long
+// as no two overlap (that would blend twice) and nothing else about the paint depends on the shape.
+static bool is_batchable_rect_fill(const SkPaint& paint) {
+    return SkPaint::kFill_Style == paint.getStyle() &&
+           !paint.isAntiAlias() &&
+           !paint.getPathEffect() &&
+           !paint.getMaskFilter() &&
+           !paint.getImageFilter() &&
+           !paint.getLooper();
+}
+
+static bool as_integer_rect(const SkRect& rect, SkIRect* irect) {
+    rect.round(irect);
+    return !irect->isEmpty() && SkRect::Make(*irect) == rect;
+}
+
+// Turns runs of DrawRects sharing a paint into a DrawRegion.
+static void batch_rects(SkRecord* record) {
+    Is<DrawRect> isRect;
+    Is<NoOp> isNoOp;
+    SkIRect irect;
+    for (int i = 0; i < record->count();) {
+        if (!record->mutate(i, isRect) || !is_batchable_rect_fill(isRect.get()->paint) ||
+            !as_integer_rect(isRect.get()->rect, &irect)) {
+            i++;
+            continue;
+        }
+        const SkPaint paint = isRect.get()->paint;
+        SkRegion region(irect);
+        int last = i, next = i + 1;
+        for (; next < record->count(); next++) {
+            if (record->mutate(next, isNoOp)) {
+                continue;
+            }
+            if (!record->mutate(next, isRect) || isRect.get()->paint != paint ||
+                !as_integer_rect(isRect.get()->rect, &irect) || region.intersects(irect)) {
+                break;
+            }
+            region.op(irect, SkRegion::kUnion_Op);
+            last = next;
+        }
+        if (last > i) {
+            for (int j = i + 1; j <= last; j++) {
+                record->replace<NoOp>(j);
+            }
+            new (record->replace<DrawRegion>(i)) DrawRegion{paint, region};
+        }
+        i = next;
+    }
+}
+
+// A DrawImageRect that draws the same as an entry of a DrawImageSet, whose only paint-like state
+// is a per-entry alpha and AA bit and a shared filter quality and blend mode.
+static bool is_batchable_image_rect(const DrawImageRect& op) {
+    if (SkCanvas::kFast_SrcRectConstraint != op.constraint || op.image->isAlphaOnly()) {
+        return false;
+    }
+    if (op.src && !SkRect::Make(op.image->bounds()).contains(*op.src)) {
+        return false;
+    }
+    const SkPaint* paint = op.paint;
+    return !paint || (!paint->getShader() &&
+                      !paint->getColorFilter() &&
+                      !paint->getMaskFilter() &&
+                      !paint->getImageFilter() &&
+                      !paint->getLooper() &&
+                      !paint->getPathEffect() &&
+                      paint->getFilterQuality() <= kLow_SkFilterQuality);
+}
+
+static SkFilterQuality image_rect_quality(const DrawImageRect& op) {
+    return op.paint ? op.paint->getFilterQuality() : kNone_SkFilterQuality;
+}
+
+static SkBlendMode image_rect_mode(const DrawImageRect& op) {
+    return op.paint ? op.paint->getBlendMode() : SkBlendMode::kSrcOver;
+}
+
+// Turns runs of simple DrawImageRects sharing a filter quality and blend mode into a DrawImageSet.
+static void batch_image_rects(SkRecord* record) {
+    Is<DrawImageRect> isImageRect;
+    Is<NoOp> isNoOp;
+    SkTDArray<int> run;
+    for (int i = 0; i < record->count();) {
+        if (!record->mutate(i, isImageRect) || !is_batchable_image_rect(*isImageRect.get())) {
+            i++;
+            continue;
+        }
+        const SkFilterQuality quality = image_rect_quality(*isImageRect.get());
+        const SkBlendMode mode = image_rect_mode(*isImageRect.get());
+        run.rewind();
+        *run.append() = i;
+        int next = i + 1;
+        for (; next < record->count(); next++) {
+            if (record->mutate(next, isNoOp)) {
+                continue;
+            }
+            if (!record->mutate(next, isImageRect) ||
+                !is_batchable_image_rect(*isImageRect.get()) ||
+                image_rect_quality(*isImageRect.get()) != quality ||
+                image_rect_mode(*isImageRect.get()) != mode) {
+                break;
+            }
+            *run.append() = next;
+        }
+        if (run.count() > 1) {
+            SkAutoTArray<SkCanvas::ImageSetEntry> set(run.count());
+            for (int j = 0; j < run.count(); j++) {
+                SkAssertResult(record->mutate(run[j], isImageRect));
+                const DrawImageRect& op = *isImageRect.get();
+                const SkPaint* paint = op.paint;
+                set[j].fImage = op.image;
+                set[j].fSrcRect = op.src ? *op.src : SkRect::Make(op.image->bounds());
+                set[j].fDstRect = op.dst;
+                set[j].fAlpha = paint ? paint->getAlpha() / 255.f : 1.f;
+                set[j].fAAFlags = paint && paint->isAntiAlias() ? SkCanvas::kAll_QuadAAFlags
+                                                                : SkCanvas::kNone_QuadAAFlags;
+                if (j > 0) {
+                    record->replace<NoOp>(run[j]);
+                }
+            }
+            new (record->replace<DrawImageSet>(i)) DrawImageSet{std::move(set), run.count(),
+                                                                nullptr, quality, mode};
+        }
+        i = next;
+    }
+}
+
+void SkRecordBatchDraws(SkRecord* record) {
+    batch_rects(record);
+    batch_image_rects(record);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
 void SkRecordOptimize(SkRecord* record) {
     // This might be useful  as a first pass in the future if we want to weed
     // out junk for other optimization passes.  Right now, nothing needs it,
@@ -310,6 +660,16 @@ void SkRecordOptimize(SkRecord* record) {
     record->defrag();
 }
 
+void SkRecordOptimizeDrawCalls(SkRecord* record) {
+    SkRecordMergeTranslates(record);
+    SkRecordNoopRedundantClipRects(record);
+    // Cull before batching, so the batches don't hide draws that are covered.
+    SkRecordNoopOccludedDraws(record);
+    SkRecordBatchDraws(record);
+
+    record->defrag();
+}
+
 void SkRecordOptimize2(SkRecord* record) {
     multiple_set_matrices(record);
     SkRecordNoopSaveRestores(record);
@@ -26,6 +26,24 @@ void SkRecordNoopSaveLayerDrawRestores(SkRecord*);
 // the alpha of the first SaveLayer to the second SaveLayer.
 void SkRecordMergeSvgOpacityAndFilterLayers(SkRecord*);
 
+// Folds runs of Translates (and translate-only Concats) into a single Translate.
+void SkRecordMergeTranslates(SkRecord*);
+
+// Turns non-AA intersect ClipRects that contain the clip already in effect into no-ops.
+void SkRecordNoopRedundantClipRects(SkRecord*);
+
+// Turns draws that a later opaque, non-AA DrawRect completely covers into no-ops.
+void SkRecordNoopOccludedDraws(SkRecord*);
+
+// Merges runs of DrawRects sharing a paint into DrawRegions, and runs of simple DrawImageRects into
+// DrawImageSets.
+void SkRecordBatchDraws(SkRecord*);
+
+// Run the four draw call optimizations above, in recommended order. These are not part of
+// SkRecordOptimize: region and image set draws can rasterize a little differently than the
+// individual draws did when the matrix scales or rotates.
+void SkRecordOptimizeDrawCalls(SkRecord*);
+
 // Experimental optimizers
 void SkRecordOptimize2(SkRecord*);
 
@@ -9,11 +9,18 @@
 
 #include "SkBigPicture.h"
 #include "SkCanvasPriv.h"
+#include "SkData.h"
 #include "SkImage.h"
+#include "SkOpts.h"
 #include "SkPatchUtils.h"
+#include "SkPathPriv.h"
 #include "SkPicture.h"
+#include "SkSerialProcs.h"
 #include "SkSurface.h"
+#include "SkTHash.h"
+#include "SkTextBlob.h"
 #include "SkTo.h"
+#include "SkTypeface.h"
 
 #include <new>
 
@@ -39,6 +46,24 @@ void SkDrawableList::append(SkDrawable* drawable) {
 
 ///////////////////////////////////////////////////////////////////////////////////////////////
 
+struct SkRecorder::Deduper {
+    // Text blobs are keyed on their serialized contents, with typefaces written as their IDs.
+    struct BlobKey {
+        sk_sp<SkData> fData;
+        bool operator==(const BlobKey& that) const { return fData->equals(that.fData.get()); }
+    };
+    struct BlobKeyHash {
+        uint32_t operator()(const BlobKey& key) const {
+            return SkOpts::hash(key.fData->data(), key.fData->size());
+        }
+    };
+
+    SkTHashSet<SkPath, SkPathPriv::ContentHasher>           fPaths;
+    SkTHashMap<BlobKey, sk_sp<const SkTextBlob>, BlobKeyHash> fBlobs;
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////
+
 SkRecorder::SkRecorder(SkRecord* record, int width, int height, SkMiniRecorder* mr)
     : SkCanvasVirtualEnforcer<SkNoDrawCanvas>(width, height)
     , fDrawPictureMode(Record_DrawPictureMode)
@@ -53,9 +78,12 @@ SkRecorder::SkRecorder(SkRecord* record, const SkRect& bounds, SkMiniRecorder* m
     , fRecord(record)
     , fMiniRecorder(mr) {}
 
+SkRecorder::~SkRecorder() {}
+
 void SkRecorder::reset(SkRecord* record, const SkRect& bounds,
                        DrawPictureMode dpm, SkMiniRecorder* mr) {
     this->forgetRecord();
+    fDeduper.reset();
     fDrawPictureMode = dpm;
     fRecord = record;
     SkIRect rounded = bounds.roundOut();
@@ -69,6 +97,39 @@ void SkRecorder::forgetRecord() {
     fRecord = nullptr;
 }
 
+void SkRecorder::setDedupesContent(bool dedupe) {
+    fDeduper.reset(dedupe ? new Deduper : nullptr);
+}
+
+const SkPath& SkRecorder::dedupe(const SkPath& path) {
+    if (!fDeduper) {
+        return path;
+    }
+    if (const SkPath* recorded = fDeduper->fPaths.find(path)) {
+        return *recorded;
+    }
+    fDeduper->fPaths.add(path);
+    return path;
+}
+
+static sk_sp<SkData> serialize_typeface_id(SkTypeface* typeface, void*) {
+    uint32_t id = typeface->uniqueID();
+    return SkData::MakeWithCopy(&id, sizeof(id));
+}
+
+sk_sp<const SkTextBlob> SkRecorder::dedupe(const SkTextBlob* blob) {
+    if (!fDeduper) {
+        return sk_ref_sp(blob);
+    }
+    SkSerialProcs procs;
+    procs.fTypefaceProc = serialize_typeface_id;
+    Deduper::BlobKey key{blob->serialize(procs)};
+    if (sk_sp<const SkTextBlob>* recorded = fDeduper->fBlobs.find(key)) {
+        return *recorded;
+    }
+    return *fDeduper->fBlobs.set(std::move(key), sk_ref_sp(blob));
+}
+
 // To make appending to fRecord a little less verbose.
 template<typename T, typename... Args>
 void SkRecorder::append(Args&&... args) {
@@ -187,7 +248,7 @@ void SkRecorder::onDrawDrawable(SkDrawable* drawable, const SkMatrix* matrix) {
 
 void SkRecorder::onDrawPath(const SkPath& path, const SkPaint& paint) {
     TRY_MINIRECORDER(drawPath, path, paint);
-    this->append<SkRecords::DrawPath>(paint, path);
+    this->append<SkRecords::DrawPath>(paint, this->dedupe(path));
 }
 
 void SkRecorder::onDrawBitmap(const SkBitmap& bitmap,
@@ -253,13 +314,18 @@ void SkRecorder::onDrawImageLattice(const SkImage* image, const Lattice& lattice
            this->copy(lattice.fColors, flagCount), *lattice.fBounds, dst);
 }
 
-void SkRecorder::onDrawImageSet(const ImageSetEntry set[], int count, SkFilterQuality filterQuality,
+void SkRecorder::onDrawImageSet(const ImageSetEntry set[], int count,
+                                const SkMatrix preViewMatrices[], SkFilterQuality filterQuality,
                                 SkBlendMode mode) {
     SkAutoTArray<ImageSetEntry> setCopy(count);
+    int matrixCount = 0;
     for (int i = 0; i < count; ++i) {
         setCopy[i] = set[i];
+        matrixCount = SkTMax(matrixCount, set[i].fMatrixIndex + 1);
     }
-    this->append<SkRecords::DrawImageSet>(std::move(setCopy), count, filterQuality, mode);
+    this->append<SkRecords::DrawImageSet>(std::move(setCopy), count,
+                                          this->copy(preViewMatrices, matrixCount), filterQuality,
+                                          mode);
 }
 
 void SkRecorder::onDrawText(const void* text, size_t byteLength,
@@ -302,7 +368,7 @@ void SkRecorder::onDrawTextRSXform(const void* text, size_t byteLength, const Sk
 void SkRecorder::onDrawTextBlob(const SkTextBlob* blob, SkScalar x, SkScalar y,
                                 const SkPaint& paint) {
     TRY_MINIRECORDER(drawTextBlob, blob, x, y, paint);
-    this->append<SkRecords::DrawTextBlob>(paint, sk_ref_sp(blob), x, y);
+    this->append<SkRecords::DrawTextBlob>(paint, this->dedupe(blob), x, y);
 }
 
 void SkRecorder::onDrawPicture(const SkPicture* pic, const SkMatrix* matrix, const SkPaint* paint) {
@@ -349,7 +415,7 @@ void SkRecorder::onDrawAtlas(const SkImage* atlas, const SkRSXform xform[], cons
 }
 
 void SkRecorder::onDrawShadowRec(const SkPath& path, const SkDrawShadowRec& rec) {
-    this->append<SkRecords::DrawShadowRec>(path, rec);
+    this->append<SkRecords::DrawShadowRec>(this->dedupe(path), rec);
 }
 
 void SkRecorder::onDrawAnnotation(const SkRect& rect, const char key[], SkData* value) {
@@ -405,7 +471,7 @@ void SkRecorder::onClipRRect(const SkRRect& rrect, SkClipOp op, ClipEdgeStyle ed
 void SkRecorder::onClipPath(const SkPath& path, SkClipOp op, ClipEdgeStyle edgeStyle) {
     INHERITED(onClipPath, path, op, edgeStyle);
     SkRecords::ClipOpAndAA opAA(op, kSoft_ClipEdgeStyle == edgeStyle);
-    this->append<SkRecords::ClipPath>(path, opAA);
+    this->append<SkRecords::ClipPath>(this->dedupe(path), opAA);
 }
 
 void SkRecorder::onClipRegion(const SkRegion& deviceRgn, SkClipOp op) {
@@ -42,10 +42,15 @@ public:
     // Does not take ownership of the SkRecord.
     SkRecorder(SkRecord*, int width, int height, SkMiniRecorder* = nullptr);   // legacy version
     SkRecorder(SkRecord*, const SkRect& bounds, SkMiniRecorder* = nullptr);
+    ~SkRecorder() override;
 
     enum DrawPictureMode { Record_DrawPictureMode, Playback_DrawPictureMode };
     void reset(SkRecord*, const SkRect& bounds, DrawPictureMode, SkMiniRecorder* = nullptr);
 
+    // If set, draws of paths and text blobs with the same contents as ones already recorded
+    // share the recorded copy, even if they were built separately.  Cleared by reset().
+    void setDedupesContent(bool);
+
     size_t approxBytesUsedBySubPictures() const { return fApproxBytesUsedBySubPictures; }
 
     SkDrawableList* getDrawableList() const { return fDrawableList.get(); }
@@ -116,8 +121,8 @@ public:
                             const SkPaint*) override;
     void onDrawBitmapLattice(const SkBitmap&, const Lattice& lattice, const SkRect& dst,
                              const SkPaint*) override;
-    void onDrawImageSet(const SkCanvas::ImageSetEntry[], int count, SkFilterQuality,
-                        SkBlendMode) override;
+    void onDrawImageSet(const SkCanvas::ImageSetEntry[], int count, const SkMatrix[],
+                        SkFilterQuality, SkBlendMode) override;
     void onDrawVerticesObject(const SkVertices*, const SkVertices::Bone bones[], int boneCount,
                               SkBlendMode, const SkPaint&) override;
     void onDrawAtlas(const SkImage*, const SkRSXform[], const SkRect[], const SkColor[],
@@ -147,12 +152,18 @@ private:
     template<typename T, typename... Args>
     void append(Args&&...);
 
+    const SkPath& dedupe(const SkPath&);
+    sk_sp<const SkTextBlob> dedupe(const SkTextBlob*);
+
     DrawPictureMode fDrawPictureMode;
     size_t fApproxBytesUsedBySubPictures;
     SkRecord* fRecord;
     std::unique_ptr<SkDrawableList> fDrawableList;
 
     SkMiniRecorder* fMiniRecorder;
+
+    struct Deduper;
+    std::unique_ptr<Deduper> fDeduper;
 };
 
 #endif//SkRecorder_DEFINED
@@ -269,6 +269,7 @@ RECORD(DrawImageNine, kDraw_Tag|kHasImage_Tag|kHasPaint_Tag,
 RECORD(DrawImageSet, kDraw_Tag|kHasImage_Tag,
        SkAutoTArray<SkCanvas::ImageSetEntry> set;
        int count;
+       PODArray<SkMatrix> preViewMatrices;
        SkFilterQuality quality;
        SkBlendMode mode);
 RECORD(DrawOval, kDraw_Tag|kHasPaint_Tag,
@@ -10,6 +10,8 @@
 #include "SkMacros.h"
 #include "SkRegionPriv.h"
 #include "SkSafeMath.h"
+#include "SkTDArray.h"
+#include "SkTSort.h"
 #include "SkTemplates.h"
 #include "SkTo.h"
 #include "SkUTF.h"
@@ -647,9 +649,92 @@ void SkRegion::translate(int dx, int dy, SkRegion* dst) const {
 
 ///////////////////////////////////////////////////////////////////////////////
 
+/*  Rects that come from a region, or from a grid, are usually already in bands: rects that
+ *  share a top share their bottom, and no band overlaps the next. Their runs can then be written
+ *  one band at a time, instead of being built up by a union per rect. Returns false (leaving
+ *  'runs' in an unspecified state) if the rects are not in bands.
+ */
+static bool build_banded_runs(const SkIRect rects[], int count,
+                              SkTDArray<SkRegionPriv::RunType>* runs) {
+    using RunType = SkRegionPriv::RunType;
+
+    SkTDArray<SkIRect> sorted;
+    sorted.setReserve(count);
+    for (int i = 0; i < count; i++) {
+        // Like setRect(), skip the rects that can't be represented.
+        if (!rects[i].isEmpty() &&
+            SkRegion_kRunTypeSentinel != rects[i].right() &&
+            SkRegion_kRunTypeSentinel != rects[i].bottom()) {
+            sorted.push_back(rects[i]);
+        }
+    }
+    if (sorted.isEmpty()) {
+        runs->push_back(SkRegion_kRunTypeSentinel);
+        return true;
+    }
+    SkTQSort(sorted.begin(), sorted.end() - 1, [](const SkIRect& a, const SkIRect& b) {
+        return a.fTop != b.fTop ? a.fTop < b.fTop :
+               a.fBottom != b.fBottom ? a.fBottom < b.fBottom : a.fLeft < b.fLeft;
+    });
+
+    runs->push_back(sorted[0].fTop);
+    int prevBottom = sorted[0].fTop;
+    int prevSpan = -1;  // index of the previous band's bottom in 'runs'
+    for (int i = 0; i < sorted.count();) {
+        const int top = sorted[i].fTop,
+                  bottom = sorted[i].fBottom;
+        if (top < prevBottom) {
+            return false;
+        }
+        if (top > prevBottom) {
+            // An empty span for the gap between the bands.
+            runs->push_back(top);
+            runs->push_back(0);
+            runs->push_back(SkRegion_kRunTypeSentinel);
+        }
+
+        const int span = runs->count();
+        runs->push_back(bottom);
+        runs->push_back(0);
+        int intervals = 0;
+        for (; i < sorted.count() && sorted[i].fTop == top; i++) {
+            if (sorted[i].fBottom != bottom) {
+                return false;
+            }
+            if (intervals > 0 && sorted[i].fLeft <= (*runs)[runs->count() - 1]) {
+                // Overlapping or abutting rects merge, as they would in a union.
+                (*runs)[runs->count() - 1] = SkMax32((*runs)[runs->count() - 1],
+                                                     sorted[i].fRight);
+            } else {
+                runs->push_back(sorted[i].fLeft);
+                runs->push_back(sorted[i].fRight);
+                intervals += 1;
+            }
+        }
+        runs->push_back(SkRegion_kRunTypeSentinel);
+        (*runs)[span + 1] = intervals;
+
+        // A band that continues the previous one with the same intervals just extends it.
+        if (prevSpan >= 0 && top == prevBottom && (*runs)[prevSpan + 1] == intervals &&
+                !memcmp(&(*runs)[prevSpan + 2], &(*runs)[span + 2],
+                        2 * intervals * sizeof(RunType))) {
+            (*runs)[prevSpan] = bottom;
+            runs->setCount(span);
+        } else {
+            prevSpan = span;
+        }
+        prevBottom = bottom;
+    }
+    runs->push_back(SkRegion_kRunTypeSentinel);
+    return true;
+}
+
 bool SkRegion::setRects(const SkIRect rects[], int count) {
+    SkTDArray<RunType> runs;
     if (0 == count) {
         this->setEmpty();
+    } else if (count > 1 && build_banded_runs(rects, count, &runs)) {
+        this->setRuns(runs.begin(), runs.count());
     } else {
         this->setRect(rects[0]);
         for (int i = 1; i < count; i++) {
@@ -772,15 +857,79 @@ static int distance_to_sentinel(const SkRegionPriv::RunType* runs) {
     return ptr - runs;
 }
 
+// Returns the number of the 'count' [left, rite) intervals in runs, which are sorted and apart,
+// for which pred(left, rite) is true. pred must be true for a prefix of them.
+template <typename Pred>
+static int count_leading_intervals(const SkRegionPriv::RunType runs[], int count, Pred pred) {
+    int lo = 0, hi = count;
+    while (lo < hi) {
+        int mid = (lo + hi) >> 1;
+        if (pred(runs[2 * mid], runs[2 * mid + 1])) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+// Intersects or unites the 'count' intervals of runs with the single interval [left, rite), as
+// the general loop in operate_on_span() would, but finds the intervals that [left, rite) touches
+// with binary searches and copies the others as they are. Returns the end of dst.
+static SkRegionPriv::RunType* operate_on_interval(const SkRegionPriv::RunType runs[], int count,
+                                                  int left, int rite, bool unite,
+                                                  SkRegionPriv::RunType* dst) {
+    using RunType = SkRegionPriv::RunType;
+    // The intervals in [first, last) touch [left, rite); for an intersection they must overlap.
+    int first = count_leading_intervals(runs, count, [=](int l, int r) {
+        return unite ? r < left : r <= left;
+    });
+    int last = first + count_leading_intervals(runs + 2 * first, count - first,
+                                               [=](int l, int r) {
+        return unite ? l <= rite : l < rite;
+    });
+
+    if (unite) {
+        memcpy(dst, runs, 2 * first * sizeof(RunType));
+        dst += 2 * first;
+        *dst++ = (RunType)(first < last ? SkMin32(left, runs[2 * first]) : left);
+        *dst++ = (RunType)(first < last ? SkMax32(rite, runs[2 * last - 1]) : rite);
+        memcpy(dst, runs + 2 * last, 2 * (count - last) * sizeof(RunType));
+        return dst + 2 * (count - last);
+    }
+    if (first == last) {
+        return dst;
+    }
+    memcpy(dst, runs + 2 * first, 2 * (last - first) * sizeof(RunType));
+    dst[0] = (RunType)SkMax32(left, dst[0]);
+    dst += 2 * (last - first);
+    dst[-1] = (RunType)SkMin32(rite, dst[-1]);
+    return dst;
+}
+
 static int operate_on_span(const SkRegionPriv::RunType a_runs[],
                            const SkRegionPriv::RunType b_runs[],
                            RunArray* array, int dstOffset,
                            int min, int max) {
+    const int a_count = distance_to_sentinel(a_runs),
+              b_count = distance_to_sentinel(b_runs);
     // This is a worst-case for this span plus two for TWO terminating sentinels.
-    array->resizeToAtLeast(
-            dstOffset + distance_to_sentinel(a_runs) + distance_to_sentinel(b_runs) + 2);
+    array->resizeToAtLeast(dstOffset + a_count + b_count + 2);
     SkRegionPriv::RunType* dst = &(*array)[dstOffset]; // get pointer AFTER resizing.
 
+    // Intersections and unions with a single interval (e.g. a clip rect's) are the common case,
+    // and don't need to visit every interval of the other span.
+    const bool intersect = 3 == min && 3 == max,
+               unite     = 1 == min && 3 == max;
+    if ((intersect || unite) && (2 == a_count || 2 == b_count)) {
+        const SkRegionPriv::RunType* single = 2 == b_count ? b_runs : a_runs;
+        const SkRegionPriv::RunType* other  = 2 == b_count ? a_runs : b_runs;
+        dst = operate_on_interval(other, (2 == b_count ? a_count : b_count) >> 1,
+                                  single[0], single[1], unite, dst);
+        *dst++ = SkRegion_kRunTypeSentinel;
+        return dst - &(*array)[0];
+    }
+
     spanRec rec;
     bool    firstInterval = true;
 
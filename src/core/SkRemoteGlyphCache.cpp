@@ -7,6 +7,7 @@
 
 #include "SkRemoteGlyphCache.h"
 
+#include <algorithm>
 #include <iterator>
 #include <memory>
 #include <new>
@@ -17,8 +18,11 @@
 #include "SkDraw.h"
 #include "SkGlyphRun.h"
 #include "SkGlyphCache.h"
+#include "SkOpts.h"
 #include "SkRemoteGlyphCacheImpl.h"
+#include "SkStream.h"
 #include "SkStrikeCache.h"
+#include "SkTextBlob.h"
 #include "SkTraceEvent.h"
 #include "SkTypeface_remote.h"
 
@@ -130,12 +134,14 @@ public:
         uint32_t desc_length = 0u;
         if (!read<uint32_t>(&desc_length)) return false;
 
+        if (desc_length < sizeof(SkDescriptor)) return false;
+
         auto* result = this->ensureAtLeast(desc_length, alignof(SkDescriptor));
         if (!result) return false;
 
         ad->reset(desc_length);
         memcpy(ad->getDesc(), const_cast<const char*>(result), desc_length);
-        return true;
+        return ad->getDesc()->getLength() == desc_length;
     }
 
     const volatile void* read(size_t size, size_t alignment) {
@@ -449,7 +455,6 @@ void SkStrikeServer::SkGlyphCacheState::writePendingGlyphs(Serializer* serialize
     serializer->emplace<bool>(this->hasPendingGlyphs());
     if (!this->hasPendingGlyphs()) {
         fContext.reset();
-        fPaint = nullptr;
         return;
     }
 
@@ -492,7 +497,6 @@ void SkStrikeServer::SkGlyphCacheState::writePendingGlyphs(Serializer* serialize
     }
     fPendingGlyphPaths.clear();
     fContext.reset();
-    fPaint = nullptr;
 }
 
 const SkGlyph& SkStrikeServer::SkGlyphCacheState::findGlyph(SkPackedGlyphID glyphID) {
@@ -509,14 +513,15 @@ const SkGlyph& SkStrikeServer::SkGlyphCacheState::findGlyph(SkPackedGlyphID glyp
 
 void SkStrikeServer::SkGlyphCacheState::ensureScalerContext() {
     if (fContext == nullptr) {
-        SkScalerContextEffects effects{*fPaint};
-        auto tf = fPaint->getTypeface();
-        fContext = tf->createScalerContext(effects, fDeviceDescriptor.getDesc());
+        SkScalerContextEffects effects{fPathEffect.get(), fMaskFilter.get()};
+        fContext = fTypeface->createScalerContext(effects, fDeviceDescriptor.getDesc());
     }
 }
 
 void SkStrikeServer::SkGlyphCacheState::setPaint(const SkPaint& paint) {
-    fPaint = &paint;
+    fTypeface   = paint.refTypeface();
+    fPathEffect = paint.refPathEffect();
+    fMaskFilter = paint.refMaskFilter();
 }
 
 SkVector SkStrikeServer::SkGlyphCacheState::rounding() const {
@@ -574,7 +579,8 @@ SkStrikeClient::SkStrikeClient(sk_sp<DiscardableHandleManager> discardableManage
                                SkStrikeCache* strikeCache)
         : fDiscardableHandleManager(std::move(discardableManager))
         , fStrikeCache{strikeCache ? strikeCache : SkStrikeCache::GlobalStrikeCache()}
-        , fIsLogging{isLogging} {}
+        , fIsLogging{isLogging}
+        , fGlyphRequests{sk_make_sp<GlyphRequests>()} {}
 
 SkStrikeClient::~SkStrikeClient() = default;
 
@@ -720,7 +726,370 @@ sk_sp<SkTypeface> SkStrikeClient::addTypeface(const WireTypeface& wire) {
 
     auto newTypeface = sk_make_sp<SkTypefaceProxy>(
             wire.typefaceID, wire.glyphCount, wire.style, wire.isFixed,
-            fDiscardableHandleManager, fIsLogging);
+            fDiscardableHandleManager, fIsLogging, fGlyphRequests);
     fRemoteFontIdToTypeface.set(wire.typefaceID, newTypeface);
     return std::move(newTypeface);
 }
+
+// Glyph requests -----------------------------------------
+void SkStrikeClient::GlyphRequests::add(const SkDescriptor& clientDesc, SkFontID remoteFontID,
+                                        SkPackedGlyphID glyphID, bool asPath) {
+    // The server knows the strike by its key descriptor, which is the client's with the
+    // server's typeface id.
+    SkAutoDescriptor ad;
+    auto* serverDesc = auto_descriptor_from_desc(&clientDesc, remoteFontID, &ad);
+
+    SkAutoMutexAcquire lock(fMutex);
+    auto it = fStrikes.find(serverDesc);
+    if (it == fStrikes.end()) {
+        auto strike = skstd::make_unique<Strike>(*serverDesc);
+        it = fStrikes.emplace(strike->fServerDesc.getDesc(), std::move(strike)).first;
+    }
+    Strike* strike = it->second.get();
+    auto* set     = asPath ? &strike->fPathSet : &strike->fImageSet;
+    auto* pending = asPath ? &strike->fPaths   : &strike->fImages;
+    if (!set->contains(glyphID)) {
+        set->add(glyphID);
+        pending->push_back(glyphID);
+    }
+}
+
+int SkStrikeClient::GlyphRequests::write(Serializer* serializer) {
+    SkAutoMutexAcquire lock(fMutex);
+    if (fStrikes.empty()) {
+        return 0;
+    }
+
+    int glyphCount = 0;
+    serializer->emplace<uint64_t>(fStrikes.size());
+    for (const auto& it : fStrikes) {
+        const Strike& strike = *it.second;
+        serializer->writeDescriptor(*strike.fServerDesc.getDesc());
+        for (const auto* glyphs : {&strike.fImages, &strike.fPaths}) {
+            serializer->emplace<uint64_t>(glyphs->size());
+            for (SkPackedGlyphID glyphID : *glyphs) {
+                serializer->write<SkPackedGlyphID>(glyphID);
+            }
+            glyphCount += SkToInt(glyphs->size());
+        }
+    }
+    fStrikes.clear();
+    return glyphCount;
+}
+
+int SkStrikeClient::writeGlyphRequests(std::vector<uint8_t>* memory) {
+    Serializer serializer(memory);
+    int glyphCount = fGlyphRequests->write(&serializer);
+    if (glyphCount > 0) {
+        fGlyphRequestStats.fMessages += 1;
+        fGlyphRequestStats.fGlyphs   += glyphCount;
+    }
+    return glyphCount;
+}
+
+bool SkStrikeServer::readGlyphRequests(const volatile void* memory, size_t memorySize) {
+    Deserializer deserializer(static_cast<const volatile char*>(memory), memorySize);
+
+    uint64_t strikeCount = 0u;
+    if (!deserializer.read<uint64_t>(&strikeCount)) READ_FAILURE
+
+    for (size_t i = 0; i < strikeCount; ++i) {
+        SkAutoDescriptor ad;
+        if (!deserializer.readDescriptor(&ad) || !ad.getDesc()->isValid()) READ_FAILURE
+
+        // Lock the strike, as getOrCreateCache() would, so its glyphs go out with the next
+        // writeStrikeData(). If the client has deleted it, the requests are read and dropped.
+        SkGlyphCacheState* cache = nullptr;
+        auto it = fRemoteGlyphStateMap.find(ad.getDesc());
+        if (it != fRemoteGlyphStateMap.end()) {
+            if (fLockedDescs.find(it->first) != fLockedDescs.end()) {
+                cache = it->second.get();
+            } else if (fDiscardableHandleManager->lockHandle(it->second->discardableHandleId())) {
+                fLockedDescs.insert(it->first);
+                cache = it->second.get();
+            } else {
+                fRemoteGlyphStateMap.erase(it);
+            }
+        }
+
+        for (bool asPath : {false, true}) {
+            uint64_t glyphCount = 0u;
+            if (!deserializer.read<uint64_t>(&glyphCount)) READ_FAILURE
+            for (size_t j = 0; j < glyphCount; j++) {
+                SkPackedGlyphID glyphID;
+                if (!deserializer.read<SkPackedGlyphID>(&glyphID)) READ_FAILURE
+                if (cache) {
+                    cache->addGlyph(glyphID, asPath);
+                }
+            }
+        }
+    }
+
+    return true;
+}
+
+void SkStrikeServer::prefetchTextBlob(const SkTextBlob& blob, SkPoint origin,
+                                      const SkPaint& paint, const SkSurfaceProps& props,
+                                      const SkMatrix& matrix) {
+    SkRect devRect;
+    matrix.mapRect(&devRect, blob.bounds().makeOffset(origin.fX, origin.fY));
+    SkIRect devBounds = devRect.roundOut();
+    if (devBounds.isEmpty()) {
+        return;
+    }
+
+    // Translating by whole pixels leaves the glyphs' sub-pixel positions, and so the glyphs
+    // sent, the same as drawing with matrix itself.
+    SkTextBlobCacheDiffCanvas canvas(devBounds.width(), devBounds.height(), props, this);
+    canvas.translate(-devBounds.fLeft, -devBounds.fTop);
+    canvas.concat(matrix);
+    canvas.drawTextBlob(&blob, origin.fX, origin.fY, paint);
+}
+
+// SkStrikeStore -----------------------------------------
+static constexpr uint32_t kStrikeStoreMagic   = SkSetFourByteTag('s', 'k', 's', 't');
+static constexpr uint32_t kStrikeStoreVersion = 1;
+
+struct StoredStrikeSpec {
+    uint32_t    typefaceKey;
+    SkFontStyle style;
+    uint32_t    familyNameLength;
+    /* family name */
+    /* desc */
+};
+
+// Identifies a typeface across processes, where SkFontIDs are meaningless.
+static uint32_t typeface_key(const SkTypeface& tf) {
+    uint32_t key[3] = {
+        (uint32_t)tf.countGlyphs(),
+        (uint32_t)tf.getUnitsPerEm(),
+        0,
+    };
+    static constexpr SkFontTableTag kHeadTag = SkSetFourByteTag('h', 'e', 'a', 'd');
+    if (size_t headSize = tf.getTableSize(kHeadTag)) {
+        SkAutoTMalloc<uint8_t> head(headSize);
+        tf.getTableData(kHeadTag, 0, headSize, head.get());
+        key[2] = SkOpts::hash(head.get(), headSize);
+    }
+    return SkOpts::hash(key, sizeof(key));
+}
+
+void SkStrikeStore::Serialize(SkStrikeCache* strikeCache, std::vector<uint8_t>* memory) {
+    if (!strikeCache) {
+        strikeCache = SkStrikeCache::GlobalStrikeCache();
+    }
+    Serializer serializer(memory);
+    serializer.write<uint32_t>(kStrikeStoreMagic);
+    serializer.write<uint32_t>(kStrikeStoreVersion);
+    auto* strikeCount = serializer.emplace<uint64_t>(0u);
+    size_t strikeCountOffset = (uint8_t*)strikeCount - memory->data();
+
+    uint64_t count = 0u;
+    SkTHashMap<SkFontID, uint32_t> typefaceKeys;
+    strikeCache->forEachStrike([&](const SkGlyphCache& cache) {
+        const SkDescriptor& desc = cache.getDescriptor();
+        if (desc.findEntry(kEffects_SkDescriptorTag, nullptr)) {
+            return;
+        }
+        const SkTypeface* tf = cache.getScalerContext()->getTypeface();
+        SkString familyName;
+        tf->getFamilyName(&familyName);
+        if (familyName.isEmpty()) {
+            return;
+        }
+        uint32_t* key = typefaceKeys.find(tf->uniqueID());
+        if (!key) {
+            key = typefaceKeys.set(tf->uniqueID(), typeface_key(*tf));
+        }
+
+        serializer.emplace<StoredStrikeSpec>(*key, tf->fontStyle(), (uint32_t)familyName.size());
+        memcpy(serializer.allocate(familyName.size(), 1), familyName.c_str(), familyName.size());
+        serializer.writeDescriptor(desc);
+        serializer.write<SkFontMetrics>(cache.getFontMetrics());
+
+        // Glyph metrics and images.
+        uint64_t* glyphCount = serializer.emplace<uint64_t>(0u);
+        size_t glyphCountOffset = (uint8_t*)glyphCount - memory->data();
+        uint64_t glyphs = 0u;
+        cache.forEachGlyph([&](const SkGlyph& glyph) {
+            if (!glyph.isFullMetrics()) {
+                return;
+            }
+            writeGlyph(const_cast<SkGlyph*>(&glyph), &serializer);
+            serializer.write<bool>(glyph.fImage != nullptr);
+            if (glyph.fImage) {
+                auto imageSize = glyph.computeImageSize();
+                memcpy(serializer.allocate(imageSize, glyph.formatAlignment()),
+                       glyph.fImage, imageSize);
+            }
+            glyphs++;
+        });
+        memcpy(memory->data() + glyphCountOffset, &glyphs, sizeof(glyphs));
+
+        // Glyph paths.
+        uint64_t* pathCount = serializer.emplace<uint64_t>(0u);
+        size_t pathCountOffset = (uint8_t*)pathCount - memory->data();
+        uint64_t paths = 0u;
+        cache.forEachGlyph([&](const SkGlyph& glyph) {
+            if (!glyph.isFullMetrics() || !glyph.fPathData || !glyph.fPathData->fPath) {
+                return;
+            }
+            writeGlyph(const_cast<SkGlyph*>(&glyph), &serializer);
+            const SkPath& path = *glyph.fPathData->fPath;
+            size_t pathSize = path.writeToMemory(nullptr);
+            serializer.write<uint64_t>(pathSize);
+            path.writeToMemory(serializer.allocate(pathSize, kPathAlignment));
+            paths++;
+        });
+        memcpy(memory->data() + pathCountOffset, &paths, sizeof(paths));
+
+        count++;
+    });
+    // The serializer may have moved the buffer, so the count is written through an offset.
+    memcpy(memory->data() + strikeCountOffset, &count, sizeof(count));
+}
+
+bool SkStrikeStore::Save(const char path[], SkStrikeCache* strikeCache) {
+    std::vector<uint8_t> memory;
+    Serialize(strikeCache, &memory);
+
+    SkFILEWStream stream(path);
+    return stream.isValid() && stream.write(memory.data(), memory.size());
+}
+
+int SkStrikeStore::Deserialize(const void* memory, size_t memorySize,
+                               SkStrikeCache* strikeCache) {
+    #define STORE_READ_FAILURE return -1;
+
+    if (!strikeCache) {
+        strikeCache = SkStrikeCache::GlobalStrikeCache();
+    }
+    Deserializer deserializer(static_cast<const volatile char*>(memory), memorySize);
+
+    uint32_t magic = 0u, version = 0u;
+    if (!deserializer.read<uint32_t>(&magic) || magic != kStrikeStoreMagic) STORE_READ_FAILURE
+    if (!deserializer.read<uint32_t>(&version) || version != kStrikeStoreVersion) {
+        STORE_READ_FAILURE
+    }
+
+    uint64_t strikeCount = 0u;
+    if (!deserializer.read<uint64_t>(&strikeCount)) STORE_READ_FAILURE
+
+    // Typefaces found so far, by family name and style, with their keys.
+    struct FoundTypeface {
+        SkString          familyName;
+        SkFontStyle       style;
+        sk_sp<SkTypeface> typeface;
+        uint32_t          key;
+    };
+    std::vector<FoundTypeface> found;
+
+    int loaded = 0;
+    for (size_t i = 0; i < strikeCount; ++i) {
+        StoredStrikeSpec spec;
+        if (!deserializer.read<StoredStrikeSpec>(&spec)) STORE_READ_FAILURE
+
+        auto* name = deserializer.read(spec.familyNameLength, 1);
+        if (!name) STORE_READ_FAILURE
+        SkString familyName((const char*)const_cast<const void*>(name), spec.familyNameLength);
+
+        SkAutoDescriptor sourceAd;
+        if (!deserializer.readDescriptor(&sourceAd)) STORE_READ_FAILURE
+        uint32_t recSize = 0u;
+        if (!sourceAd.getDesc()->isValid() ||
+            !sourceAd.getDesc()->findEntry(kRec_SkDescriptorTag, &recSize) ||
+            recSize != sizeof(SkScalerContextRec)) {
+            STORE_READ_FAILURE
+        }
+
+        SkFontMetrics fontMetrics;
+        if (!deserializer.read<SkFontMetrics>(&fontMetrics)) STORE_READ_FAILURE
+
+        auto match = std::find_if(found.begin(), found.end(), [&](const FoundTypeface& f) {
+            return f.familyName == familyName && f.style == spec.style;
+        });
+        if (match == found.end()) {
+            sk_sp<SkTypeface> tf = SkTypeface::MakeFromName(familyName.c_str(), spec.style);
+            uint32_t key = tf ? typeface_key(*tf) : 0u;
+            found.push_back({familyName, spec.style, std::move(tf), key});
+            match = found.end() - 1;
+        }
+
+        // If the typeface has gone, or is a different version, the strike is read but dropped.
+        SkExclusiveStrikePtr strike;
+        if (match->typeface && match->key == spec.typefaceKey) {
+            SkAutoDescriptor ad;
+            auto* client_desc = auto_descriptor_from_desc(sourceAd.getDesc(),
+                                                          match->typeface->uniqueID(), &ad);
+            strike = strikeCache->findStrikeExclusive(*client_desc);
+            if (strike == nullptr) {
+                SkScalerContextEffects effects;
+                auto scaler = SkStrikeCache::CreateScalerContext(*client_desc, effects,
+                                                                 *match->typeface);
+                strike = strikeCache->createStrikeExclusive(
+                        *client_desc, std::move(scaler), &fontMetrics);
+            }
+            loaded++;
+        }
+
+        uint64_t glyphCount = 0u;
+        if (!deserializer.read<uint64_t>(&glyphCount)) STORE_READ_FAILURE
+        for (size_t j = 0; j < glyphCount; j++) {
+            SkGlyph glyph;
+            if (!readGlyph(&glyph, &deserializer)) STORE_READ_FAILURE
+            bool hasImage = false;
+            if (!deserializer.read<bool>(&hasImage)) STORE_READ_FAILURE
+
+            const volatile void* image = nullptr;
+            auto imageSize = glyph.computeImageSize();
+            if (hasImage) {
+                image = deserializer.read(imageSize, glyph.formatAlignment());
+                if (!image) STORE_READ_FAILURE
+            }
+            if (!strike) {
+                continue;
+            }
+
+            // Strikes already in the cache keep the glyphs they have.
+            SkGlyph* allocatedGlyph = strike->getRawGlyphByID(glyph.getPackedID());
+            if (allocatedGlyph->isJustAdvance() && allocatedGlyph->fPathData == nullptr) {
+                *allocatedGlyph = glyph;
+            }
+            if (image && allocatedGlyph->computeImageSize() == imageSize) {
+                strike->initializeImage(image, imageSize, allocatedGlyph);
+            }
+        }
+
+        uint64_t pathCount = 0u;
+        if (!deserializer.read<uint64_t>(&pathCount)) STORE_READ_FAILURE
+        for (size_t j = 0; j < pathCount; j++) {
+            SkGlyph glyph;
+            if (!readGlyph(&glyph, &deserializer)) STORE_READ_FAILURE
+
+            uint64_t pathSize = 0u;
+            if (!deserializer.read<uint64_t>(&pathSize)) STORE_READ_FAILURE
+            auto* path = deserializer.read(pathSize, kPathAlignment);
+            if (!path) STORE_READ_FAILURE
+            if (!strike) {
+                continue;
+            }
+
+            SkGlyph* allocatedGlyph = strike->getRawGlyphByID(glyph.getPackedID());
+            if (allocatedGlyph->isJustAdvance() && allocatedGlyph->fPathData == nullptr) {
+                *allocatedGlyph = glyph;
+            }
+            if (!strike->initializePath(allocatedGlyph, path, pathSize)) STORE_READ_FAILURE
+        }
+    }
+
+    #undef STORE_READ_FAILURE
+    return loaded;
+}
+
+int SkStrikeStore::Load(const char path[], SkStrikeCache* strikeCache) {
+    sk_sp<SkData> data = SkData::MakeFromFileName(path);
+    if (!data) {
+        return -1;
+    }
+    return Deserialize(data->data(), data->size(), strikeCache);
+}
@@ -31,6 +31,7 @@ class SkGlyphCache;
 struct SkPackedGlyphID;
 enum SkScalerContextFlags : uint32_t;
 class SkStrikeCache;
+class SkTextBlob;
 class SkTypefaceProxy;
 struct WireTypeface;
 
@@ -121,6 +122,18 @@ public:
     // unlocked after this call.
     void writeStrikeData(std::vector<uint8_t>* memory);
 
+    // Reads the glyphs a client asked for with SkStrikeClient::writeGlyphRequests(); they are
+    // sent, all together, by the next writeStrikeData(). Requests for strikes the client has
+    // since deleted are ignored.
+    // Returns false if the data is invalid.
+    bool readGlyphRequests(const volatile void* memory, size_t memorySize);
+
+    // Hints that blob is likely to be drawn soon, e.g. because it was in a recent frame, so its
+    // glyphs are pushed to the client by the next writeStrikeData() before it is drawn. This is
+    // the same as drawing blob at origin to a SkTextBlobCacheDiffCanvas with matrix.
+    void prefetchTextBlob(const SkTextBlob& blob, SkPoint origin, const SkPaint& paint,
+                          const SkSurfaceProps& props, const SkMatrix& matrix);
+
     // Methods used internally in skia ------------------------------------------
     class SkGlyphCacheState;
 
@@ -196,6 +209,24 @@ public:
     // Returns false if the data is invalid.
     bool readStrikeData(const volatile void* memory, size_t memorySize);
 
+    // Glyphs missing from the strikes sent by the server are recorded as they are looked up.
+    // This writes a request for all of them in one message, to be read by
+    // SkStrikeServer::readGlyphRequests(), and forgets them. Nothing is written if no glyphs
+    // are missing. Returns the number of glyphs requested.
+    int writeGlyphRequests(std::vector<uint8_t>* memory);
+
+    struct GlyphRequestStats {
+        int fMessages = 0;  // writeGlyphRequests() calls that wrote a request, i.e. round trips
+        int fGlyphs   = 0;  // glyphs requested
+    };
+    // Counts since the last resetGlyphRequestStats(); e.g. reset every frame to get the round
+    // trips per frame.
+    GlyphRequestStats glyphRequestStats() const { return fGlyphRequestStats; }
+    void resetGlyphRequestStats() { fGlyphRequestStats = GlyphRequestStats(); }
+
+    // Methods used internally in skia ------------------------------------------
+    class GlyphRequests;
+
 private:
     class DiscardableStrikePinner;
 
@@ -205,6 +236,32 @@ private:
     sk_sp<DiscardableHandleManager> fDiscardableHandleManager;
     SkStrikeCache* const fStrikeCache;
     const bool fIsLogging;
+    sk_sp<GlyphRequests> fGlyphRequests;
+    GlyphRequestStats fGlyphRequestStats;
+};
+
+// SkStrikeStore saves the strikes in an SkStrikeCache so that a later process can start with them
+// already populated, e.g. to skip rasterizing the same glyphs again on every cold start. It uses
+// the same serialization as the SkStrikeServer and SkStrikeClient.
+//
+// Typefaces are found again with SkTypeface::MakeFromName() using their family name and style,
+// and a strike is only loaded if the typeface found has the same glyph count, units per em and
+// 'head' table as the one it was saved from. Strikes with path effects or mask filters, and
+// strikes for remote typefaces, are not saved.
+class SK_API SkStrikeStore {
+public:
+    // Writes the strikes in strikeCache (the global cache if null) to a file at path.
+    // Returns false if the file could not be written.
+    static bool Save(const char path[], SkStrikeCache* strikeCache = nullptr);
+
+    // Adds the strikes in the file at path, which is memory mapped, to strikeCache (the global
+    // cache if null). Returns the number of strikes loaded, or -1 if the file could not be read
+    // or is invalid.
+    static int Load(const char path[], SkStrikeCache* strikeCache = nullptr);
+
+    // As above, but to and from memory.
+    static void Serialize(SkStrikeCache* strikeCache, std::vector<uint8_t>* memory);
+    static int Deserialize(const void* memory, size_t memorySize, SkStrikeCache* strikeCache);
 };
 
 #endif  // SkRemoteGlyphCache_DEFINED
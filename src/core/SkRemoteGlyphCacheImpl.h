@@ -11,6 +11,8 @@
 #include "SkDescriptor.h"
 #include "SkGlyphRun.h"
 #include "SkGlyphRunPainter.h"
+#include "SkMaskFilter.h"
+#include "SkPathEffect.h"
 #include "SkRemoteGlyphCache.h"
 
 class SkStrikeServer::SkGlyphCacheState : public SkGlyphCacheInterface {
@@ -80,9 +82,11 @@ private:
     // The context built using fDeviceDescriptor
     std::unique_ptr<SkScalerContext> fContext;
 
-    // This field is set everytime getOrCreateCache. This allows the code to maintain the fContext
-    // as lazy as possible.
-    const SkPaint* fPaint{nullptr};
+    // These fields are set everytime getOrCreateCache. This allows the code to maintain the
+    // fContext as lazy as possible, and to make it again for glyphs requested by the client.
+    sk_sp<SkTypeface>   fTypeface;
+    sk_sp<SkPathEffect> fPathEffect;
+    sk_sp<SkMaskFilter> fMaskFilter;
 
     // FallbackTextHelper cases require glyph metrics when analyzing a glyph run, in which case
     // we cache them here.
@@ -0,0 +1,211 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkResizer.h"
+
+#include "SkAutoPixmapStorage.h"
+#include "SkColorSpace.h"
+#include "SkNx.h"
+#include "SkTaskGroup.h"
+#include "SkTemplates.h"
+
+#include <cmath>
+#include <functional>
+
+// Rows are filtered in bands of this many, one band per task when there is an executor.
+static constexpr int kBandRows = 32;
+
+static float mitchell(float x) {
+    constexpr float B = 1.0f / 3,
+                    C = 1.0f / 3;
+    x = std::fabs(x);
+    if (x < 1) {
+        return ((12 - 9*B - 6*C) * x*x*x + (-18 + 12*B + 6*C) * x*x + (6 - 2*B)) * (1.0f / 6);
+    }
+    if (x < 2) {
+        return ((-B - 6*C) * x*x*x + (6*B + 30*C) * x*x + (-12*B - 48*C) * x + (8*B + 24*C))
+               * (1.0f / 6);
+    }
+    return 0;
+}
+
+static float sinc(float x) {
+    if (x == 0) {
+        return 1;
+    }
+    x *= SK_ScalarPI;
+    return std::sin(x) / x;
+}
+
+static float lanczos3(float x) {
+    x = std::fabs(x);
+    return x < 3 ? sinc(x) * sinc(x / 3) : 0;
+}
+
+namespace {
+
+// Which source pixels each of dstSize outputs filters, and their weights.
+class Contributions {
+public:
+    Contributions(int srcSize, int dstSize, SkResizer::Filter filter) {
+        const bool isMitchell = SkResizer::Filter::kMitchell == filter;
+        float (*kernel)(float) = isMitchell ? mitchell : lanczos3;
+        const float srcPerDst = (float)srcSize / dstSize;
+        // Downscaling widens the filter so that it covers every source pixel.
+        const float scale = SkTMax(1.0f, srcPerDst);
+        const float radius = (isMitchell ? 2 : 3) * scale;
+
+        fMaxTaps = SkTMin(srcSize, (int)std::ceil(2 * radius) + 2);
+        fFirst.reset(dstSize);
+        fCount.reset(dstSize);
+        fWeights.reset(dstSize * fMaxTaps);
+        for (int i = 0; i < dstSize; ++i) {
+            const float center = (i + 0.5f) * srcPerDst;
+            const int first = SkTMax(0, (int)std::floor(center - radius));
+            const int last = SkTMin(SkTMin(srcSize - 1, (int)std::ceil(center + radius)),
+                                    first + fMaxTaps - 1);
+            float* weights = &fWeights[i * fMaxTaps];
+            float sum = 0;
+            for (int j = first; j <= last; ++j) {
+                weights[j - first] = kernel((j + 0.5f - center) / scale);
+                sum += weights[j - first];
+            }
+            // Where the edges cut the filter off, the weights left still need to sum to 1.
+            if (sum != 0) {
+                for (int j = first; j <= last; ++j) {
+                    weights[j - first] /= sum;
+                }
+            }
+            fFirst[i] = first;
+            fCount[i] = last - first + 1;
+        }
+    }
+
+    int first(int i) const { return fFirst[i]; }
+    int count(int i) const { return fCount[i]; }
+    const float* weights(int i) const { return &fWeights[i * fMaxTaps]; }
+
+private:
+    int                  fMaxTaps;
+    SkAutoTMalloc<int>   fFirst;
+    SkAutoTMalloc<int>   fCount;
+    SkAutoTMalloc<float> fWeights;
+};
+
+}  // namespace
+
+static void for_each_band(SkExecutor* executor, int rows,
+                          const std::function<void(int top, int bottom)>& fn) {
+    if (executor && rows > kBandRows) {
+        SkTaskGroup taskGroup(*executor);
+        taskGroup.parallelFor(rows, kBandRows, fn);
+        taskGroup.wait();
+    } else {
+        for (int top = 0; top < rows; top += kBandRows) {
+            fn(top, SkTMin(rows, top + kBandRows));
+        }
+    }
+}
+
+// Box filters each 2x2 block of src into a pixel of dst, which is half src's size, rounded down.
+static void halve(const SkPixmap& dst, const SkPixmap& src, SkExecutor* executor) {
+    for_each_band(executor, dst.height(), [&](int top, int bottom) {
+        for (int y = top; y < bottom; ++y) {
+            const uint32_t* row0 = src.addr32(0, 2 * y);
+            const uint32_t* row1 = src.addr32(0, 2 * y + 1);
+            uint32_t* out = dst.writable_addr32(0, y);
+            for (int x = 0; x < dst.width(); ++x) {
+                Sk4h sum = SkNx_cast<uint16_t>(Sk4b::Load(row0 + 2 * x))
+                         + SkNx_cast<uint16_t>(Sk4b::Load(row0 + 2 * x + 1))
+                         + SkNx_cast<uint16_t>(Sk4b::Load(row1 + 2 * x))
+                         + SkNx_cast<uint16_t>(Sk4b::Load(row1 + 2 * x + 1));
+                SkNx_cast<uint8_t>((sum + Sk4h(2)) >> 2).store(out + x);
+            }
+        }
+    });
+}
+
+bool SkResizer::CanResize(const SkPixmap& dst, const SkPixmap& src) {
+    return (kRGBA_8888_SkColorType == src.colorType() ||
+            kBGRA_8888_SkColorType == src.colorType()) &&
+           src.colorType() == dst.colorType() &&
+           kUnpremul_SkAlphaType != src.alphaType() &&
+           kUnpremul_SkAlphaType != dst.alphaType() &&
+           SkColorSpace::Equals(src.colorSpace(), dst.colorSpace()) &&
+           src.addr() && dst.addr() &&
+           src.width() > 0 && src.height() > 0 && dst.width() > 0 && dst.height() > 0;
+}
+
+bool SkResizer::Resize(const SkPixmap& dst, const SkPixmap& origSrc, Filter filter,
+                       SkExecutor* executor) {
+    if (!CanResize(dst, origSrc)) {
+        return false;
+    }
+
+    // Halving is much cheaper than a filter wide enough for a large downscale, and while the
+    // source is still at least twice the size of dst the filter that follows smooths it over.
+    SkPixmap src = origSrc;
+    SkAutoPixmapStorage halves[2];
+    for (int i = 0; src.width() >= 4 * dst.width() && src.height() >= 4 * dst.height(); ++i) {
+        SkAutoPixmapStorage& half = halves[i % 2];
+        if (!half.tryAlloc(src.info().makeWH(src.width() / 2, src.height() / 2))) {
+            return false;
+        }
+        halve(half, src, executor);
+        src = half;
+    }
+
+    const int dstW = dst.width();
+    const Contributions columns(src.width(), dstW, filter);
+    const Contributions rows(src.height(), dst.height(), filter);
+
+    // The horizontal pass filters every source row into dstW float pixels.
+    SkAutoTMalloc<float> filtered(src.height() * dstW * 4);
+    for_each_band(executor, src.height(), [&](int top, int bottom) {
+        for (int y = top; y < bottom; ++y) {
+            const uint32_t* in = src.addr32(0, y);
+            float* out = &filtered[y * dstW * 4];
+            for (int x = 0; x < dstW; ++x) {
+                const uint32_t* pixels = in + columns.first(x);
+                const float* weights = columns.weights(x);
+                Sk4f sum(0);
+                for (int k = 0; k < columns.count(x); ++k) {
+                    sum = sum + Sk4f(weights[k]) * SkNx_cast<float>(Sk4b::Load(pixels + k));
+                }
+                sum.store(out + 4 * x);
+            }
+        }
+    });
+
+    // The vertical pass sums whole filtered rows at a time, then clamps and rounds them.
+    const bool premul = kPremul_SkAlphaType == dst.alphaType();
+    for_each_band(executor, dst.height(), [&](int top, int bottom) {
+        SkAutoTMalloc<float> sums(dstW * 4);
+        for (int y = top; y < bottom; ++y) {
+            sk_bzero(sums.get(), dstW * 4 * sizeof(float));
+            const float* weights = rows.weights(y);
+            for (int k = 0; k < rows.count(y); ++k) {
+                const float* in = &filtered[(rows.first(y) + k) * dstW * 4];
+                const Sk4f weight(weights[k]);
+                for (int x = 0; x < dstW; ++x) {
+                    (Sk4f::Load(sums.get() + 4 * x) + weight * Sk4f::Load(in + 4 * x))
+                            .store(sums.get() + 4 * x);
+                }
+            }
+            uint32_t* out = dst.writable_addr32(0, y);
+            for (int x = 0; x < dstW; ++x) {
+                // The filters' negative lobes can overshoot, past alpha too when premultiplied.
+                Sk4f pixel = Sk4f::Max(0, Sk4f::Min(Sk4f::Load(sums.get() + 4 * x), 255));
+                if (premul) {
+                    pixel = Sk4f::Min(pixel, Sk4f(pixel[3], pixel[3], pixel[3], 255));
+                }
+                SkNx_cast<uint8_t>(pixel + 0.5f).store(out + x);
+            }
+        }
+    });
+    return true;
+}
@@ -0,0 +1,52 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkResizer_DEFINED
+#define SkResizer_DEFINED
+
+#include "SkPixmap.h"
+
+class SkExecutor;
+
+/**
+ *  Resamples 8888 pixmaps with a separable filter: a horizontal pass into a float buffer, then a
+ *  vertical one. The filters are widened by the downscale factor so every source pixel counts,
+ *  which makes the result much better than sampling a mip level, and large downscales first
+ *  halve the source with 2x2 box filters so the filters needn't be as wide.
+ */
+class SkResizer {
+public:
+    enum class Filter {
+        kMitchell,  // Cubic with B = C = 1/3, the usual choice.
+        kLanczos3,  // Sharper, with more ringing.
+    };
+
+    /**
+     *  Whether Resize() can resample src into dst: both must be RGBA or BGRA 8888, of the same
+     *  color type and color space, and neither unpremultiplied. A premultiplied dst is
+     *  clamped so its colors don't exceed its alpha; any other dst is clamped to [0,255].
+     */
+    static bool CanResize(const SkPixmap& dst, const SkPixmap& src);
+
+    /**
+     *  Whether a kHigh_SkFilterQuality scale by (sx, sy) downscales enough that resampling with
+     *  Resize() is worth it over sampling a mip level: neither axis may grow, and one must at
+     *  least halve.
+     */
+    static bool IsLargeDownscale(float sx, float sy) {
+        return sx > 0 && sy > 0 && sx <= 1 && sy <= 1 && (sx <= 0.5f || sy <= 0.5f);
+    }
+
+    /**
+     *  Resamples all of src into all of dst. If executor is set, bands of rows are filtered on
+     *  its threads, and this waits for them. Returns false if !CanResize(dst, src).
+     */
+    static bool Resize(const SkPixmap& dst, const SkPixmap& src, Filter = Filter::kMitchell,
+                       SkExecutor* executor = nullptr);
+};
+
+#endif
@@ -11,12 +11,15 @@
 #include "SkMessageBus.h"
 #include "SkMipMap.h"
 #include "SkMutex.h"
+#include "SkOnce.h"
 #include "SkOpts.h"
 #include "SkTo.h"
 #include "SkTraceMemoryDump.h"
 
+#include <atomic>
 #include <stddef.h>
 #include <stdlib.h>
+#include <string.h>
 
 DECLARE_SKMESSAGEBUS_MESSAGE(SkResourceCache::PurgeSharedIDMessage)
 
@@ -84,15 +87,19 @@ void SkResourceCache::init() {
     fTotalBytesUsed = 0;
     fCount = 0;
     fSingleAllocationByteLimit = 0;
+    fDiscardableCountLimit = SK_DISCARDABLEMEMORY_SCALEDIMAGECACHE_COUNT_LIMIT;
 
     // One of these should be explicit set by the caller after we return.
     fTotalByteLimit = 0;
     fDiscardableFactory = nullptr;
 }
 
-SkResourceCache::SkResourceCache(DiscardableFactory factory) {
+SkResourceCache::SkResourceCache(DiscardableFactory factory, int countLimit) {
     this->init();
     fDiscardableFactory = factory;
+    if (countLimit > 0) {
+        fDiscardableCountLimit = countLimit;
+    }
 }
 
 SkResourceCache::SkResourceCache(size_t byteLimit) {
@@ -144,6 +151,10 @@ void SkResourceCache::add(Rec* rec, void* payload) {
     this->checkMessages();
 
     SkASSERT(rec);
+    CategoryBudget* budget = nullptr;
+    if (!fCategoryBudgets.isEmpty()) {
+        budget = this->findCategoryBudget(rec->getCategory());
+    }
     // See if we already have this key (racy inserts, etc.)
     if (Rec** preexisting = fHash->find(rec->getKey())) {
         Rec* prev = *preexisting;
@@ -171,6 +182,9 @@ void SkResourceCache::add(Rec* rec, void* payload) {
     }
 
     // since the new rec may push us over-budget, we perform a purge check now
+    if (budget) {
+        this->purgeCategoryAsNeeded(budget);
+    }
     this->purgeAsNeeded();
 }
 
@@ -184,6 +198,12 @@ void SkResourceCache::remove(Rec* rec) {
 
     fTotalBytesUsed -= used;
     fCount -= 1;
+    if (!fCategoryBudgets.isEmpty()) {
+        if (CategoryBudget* budget = this->findCategoryBudget(rec->getCategory())) {
+            SkASSERT(used <= budget->fUsed);
+            budget->fUsed -= used;
+        }
+    }
 
     //SkDebugf("-RC count [%3d] bytes %d\n", fCount, fTotalBytesUsed);
 
@@ -203,7 +223,7 @@ void SkResourceCache::purgeAsNeeded(bool forcePurge) {
     int    countLimit;
 
     if (fDiscardableFactory) {
-        countLimit = SK_DISCARDABLEMEMORY_SCALEDIMAGECACHE_COUNT_LIMIT;
+        countLimit = fDiscardableCountLimit;
         byteLimit = UINT32_MAX;  // no limit based on bytes
     } else {
         countLimit = SK_MaxS32; // no limit based on count
@@ -224,6 +244,78 @@ void SkResourceCache::purgeAsNeeded(bool forcePurge) {
     }
 }
 
+size_t SkResourceCache::purgeBytes(size_t bytesToFree) {
+    this->checkMessages();
+
+    size_t freed = 0;
+    Rec* rec = fTail;
+    while (rec && freed < bytesToFree) {
+        Rec* prev = rec->fPrev;
+        if (rec->canBePurged()) {
+            freed += rec->bytesUsed();
+            this->remove(rec);
+        }
+        rec = prev;
+    }
+    return freed;
+}
+
+SkResourceCache::CategoryBudget* SkResourceCache::findCategoryBudget(const char* category) {
+    for (CategoryBudget& budget : fCategoryBudgets) {
+        if (!strcmp(budget.fCategory, category)) {
+            return &budget;
+        }
+    }
+    return nullptr;
+}
+
+void SkResourceCache::purgeCategoryAsNeeded(CategoryBudget* budget) {
+    Rec* rec = fTail;
+    while (rec && budget->fUsed > budget->fLimit) {
+        Rec* prev = rec->fPrev;
+        if (rec->canBePurged() && !strcmp(rec->getCategory(), budget->fCategory)) {
+            this->remove(rec);
+        }
+        rec = prev;
+    }
+}
+
+size_t SkResourceCache::setCategoryByteLimit(const char* category, size_t newLimit) {
+    CategoryBudget* budget = this->findCategoryBudget(category);
+    size_t prevLimit = budget ? budget->fLimit : 0;
+    if (0 == newLimit) {
+        if (budget) {
+            fCategoryBudgets.removeShuffle(SkToInt(budget - fCategoryBudgets.begin()));
+        }
+        return prevLimit;
+    }
+    if (!budget) {
+        size_t used = this->getCategoryBytesUsed(category);
+        budget = fCategoryBudgets.append();
+        budget->fCategory = category;
+        budget->fUsed = used;
+    }
+    budget->fLimit = newLimit;
+    this->purgeCategoryAsNeeded(budget);
+    return prevLimit;
+}
+
+size_t SkResourceCache::getCategoryBytesUsed(const char* category) const {
+    for (const CategoryBudget& budget : fCategoryBudgets) {
+        if (!strcmp(budget.fCategory, category)) {
+            return budget.fUsed;
+        }
+    }
+    // Not tracked, so count it up.
+    size_t used = 0;
+    for (const Rec* rec = fHead; rec; rec = rec->fNext) {
+        if (!strcmp(rec->getCategory(), category)) {
+            used += rec->bytesUsed();
+        }
+    }
+    return used;
+}
+
 //#define SK_TRACK_PURGE_SHAREDID_HITRATE
 
 #ifdef SK_TRACK_PURGE_SHAREDID_HITRATE
@@ -289,17 +381,20 @@ size_t SkResourceCache::setTotalByteLimit(size_t newLimit) {
     return prevLimit;
 }
 
-SkCachedData* SkResourceCache::newCachedData(size_t bytes) {
-    this->checkMessages();
-
-    if (fDiscardableFactory) {
-        SkDiscardableMemory* dm = fDiscardableFactory(bytes);
+static SkCachedData* new_cached_data(SkResourceCache::DiscardableFactory factory, size_t bytes) {
+    if (factory) {
+        SkDiscardableMemory* dm = factory(bytes);
         return dm ? new SkCachedData(bytes, dm) : nullptr;
     } else {
         return new SkCachedData(sk_malloc_throw(bytes), bytes);
     }
 }
 
+SkCachedData* SkResourceCache::newCachedData(size_t bytes) {
+    this->checkMessages();
+    return new_cached_data(fDiscardableFactory, bytes);
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 void SkResourceCache::release(Rec* rec) {
@@ -355,6 +450,11 @@ void SkResourceCache::addToHead(Rec* rec) {
     }
     fTotalBytesUsed += rec->bytesUsed();
     fCount += 1;
+    if (!fCategoryBudgets.isEmpty()) {
+        if (CategoryBudget* budget = this->findCategoryBudget(rec->getCategory())) {
+            budget->fUsed += rec->bytesUsed();
+        }
+    }
 
     this->validate();
 }
@@ -449,91 +549,229 @@ void SkResourceCache::checkMessages() {
 
 ///////////////////////////////////////////////////////////////////////////////
 
-SK_DECLARE_STATIC_MUTEX(gMutex);
-static SkResourceCache* gResourceCache = nullptr;
+// The global cache is split into kShardCount shards, picked by the top bits of the key's hash
+// (the low ones pick the bucket in each shard's hash table), each behind its own lock. Bytes are
+// budgeted across all of them: when an add goes over, we purge from the least recently used end of
+// the shard it went to first, then from the others in turn.
+static constexpr int kShardBits = 3;
+static constexpr int kShardCount = 1 << kShardBits;
+
+namespace {
+struct Shard {
+    SkBaseMutex      fMutex;
+    SkResourceCache* fCache;
+};
+}
+static Shard gShards[kShardCount];
+static SkOnce gShardsOnce;
 
-/** Must hold gMutex when calling. */
-static SkResourceCache* get_cache() {
-    // gMutex is always held when this is called, so we don't need to be fancy in here.
-    gMutex.assertHeld();
-    if (nullptr == gResourceCache) {
 #ifdef SK_USE_DISCARDABLE_SCALEDIMAGECACHE
-        gResourceCache = new SkResourceCache(SkDiscardableMemory::Create);
+static std::atomic<size_t> gByteLimit{0};
 #else
-        gResourceCache = new SkResourceCache(SK_DEFAULT_IMAGE_CACHE_LIMIT);
+static std::atomic<size_t> gByteLimit{SK_DEFAULT_IMAGE_CACHE_LIMIT};
 #endif
+static std::atomic<size_t> gBytesUsed{0};
+static std::atomic<size_t> gSingleAllocationByteLimit{0};
+// Purge messages go to every shard's inbox, but a shard only reads its own when it's next used.
+// So that purged entries don't linger in idle shards, the next Find() or Add() after a post has
+// them all read theirs.
+static std::atomic<uint32_t> gPurgesPosted{0};
+static std::atomic<uint32_t> gPurgesChecked{0};
+
+static Shard* get_shards() {
+    gShardsOnce([] {
+        for (Shard& shard : gShards) {
+#ifdef SK_USE_DISCARDABLE_SCALEDIMAGECACHE
+            shard.fCache = new SkResourceCache(SkDiscardableMemory::Create,
+                    SkTMax(1, SK_DISCARDABLEMEMORY_SCALEDIMAGECACHE_COUNT_LIMIT / kShardCount));
+#else
+            // The shards never purge for bytes themselves; see purge_as_needed().
+            shard.fCache = new SkResourceCache(SIZE_MAX);
+#endif
+        }
+    });
+    return gShards;
+}
+
+static int shard_index(const SkResourceCache::Key& key) {
+    return key.hash() >> (32 - kShardBits);
+}
+
+namespace {
+// Locks a shard, and folds any change in its size into gBytesUsed when done with it.
+class AutoShard {
+public:
+    explicit AutoShard(int index) : fShard(get_shards()[index]) {
+        fShard.fMutex.acquire();
+        fBytesBefore = fShard.fCache->getTotalBytesUsed();
     }
-    return gResourceCache;
+    ~AutoShard() {
+        // Unsigned wraparound makes this right when the shard shrank, too.
+        gBytesUsed.fetch_add(fShard.fCache->getTotalBytesUsed() - fBytesBefore);
+        fShard.fMutex.release();
+    }
+
+    SkResourceCache* operator->() const { return fShard.fCache; }
+
+private:
+    Shard& fShard;
+    size_t fBytesBefore;
+};
+}
+
+static void purge_as_needed(int firstShard) {
+#ifndef SK_USE_DISCARDABLE_SCALEDIMAGECACHE
+    for (int i = 0; i < kShardCount; ++i) {
+        size_t used = gBytesUsed.load(),
+               limit = gByteLimit.load();
+        if (used <= limit) {
+            return;
+        }
+        AutoShard shard((firstShard + i) % kShardCount);
+        shard->purgeBytes(used - limit);
+    }
+#endif
 }
 
 size_t SkResourceCache::GetTotalBytesUsed() {
-    SkAutoMutexAcquire am(gMutex);
-    return get_cache()->getTotalBytesUsed();
+    return gBytesUsed.load();
 }
 
 size_t SkResourceCache::GetTotalByteLimit() {
-    SkAutoMutexAcquire am(gMutex);
-    return get_cache()->getTotalByteLimit();
+    return gByteLimit.load();
 }
 
 size_t SkResourceCache::SetTotalByteLimit(size_t newLimit) {
-    SkAutoMutexAcquire am(gMutex);
-    return get_cache()->setTotalByteLimit(newLimit);
+#ifdef SK_USE_DISCARDABLE_SCALEDIMAGECACHE
+    return 0;
+#else
+    size_t prevLimit = gByteLimit.exchange(newLimit);
+    if (newLimit < prevLimit) {
+        purge_as_needed(0);
+    }
+    return prevLimit;
+#endif
 }
 
 SkResourceCache::DiscardableFactory SkResourceCache::GetDiscardableFactory() {
-    SkAutoMutexAcquire am(gMutex);
-    return get_cache()->discardableFactory();
+    // Set once when the shards are made, so no need to lock.
+    return get_shards()[0].fCache->discardableFactory();
 }
 
 SkCachedData* SkResourceCache::NewCachedData(size_t bytes) {
-    SkAutoMutexAcquire am(gMutex);
-    return get_cache()->newCachedData(bytes);
+    return new_cached_data(GetDiscardableFactory(), bytes);
 }
 
 void SkResourceCache::Dump() {
-    SkAutoMutexAcquire am(gMutex);
-    get_cache()->dump();
+    for (int i = 0; i < kShardCount; ++i) {
+        AutoShard shard(i);
+        shard->dump();
+    }
 }
 
 size_t SkResourceCache::SetSingleAllocationByteLimit(size_t size) {
-    SkAutoMutexAcquire am(gMutex);
-    return get_cache()->setSingleAllocationByteLimit(size);
+    return gSingleAllocationByteLimit.exchange(size);
 }
 
 size_t SkResourceCache::GetSingleAllocationByteLimit() {
-    SkAutoMutexAcquire am(gMutex);
-    return get_cache()->getSingleAllocationByteLimit();
+    return gSingleAllocationByteLimit.load();
 }
 
 size_t SkResourceCache::GetEffectiveSingleAllocationByteLimit() {
-    SkAutoMutexAcquire am(gMutex);
-    return get_cache()->getEffectiveSingleAllocationByteLimit();
+    // Just like getEffectiveSingleAllocationByteLimit(), but with the global budget.
+    size_t limit = gSingleAllocationByteLimit.load();
+    if (nullptr == GetDiscardableFactory()) {
+        if (0 == limit) {
+            limit = gByteLimit.load();
+        } else {
+            limit = SkTMin(limit, gByteLimit.load());
+        }
+    }
+    return limit;
+}
+
+void SkResourceCache::SetCategoryByteLimit(const char* category, size_t limit) {
+    size_t shardLimit = limit ? SkTMax<size_t>(1, limit / kShardCount) : 0;
+    for (int i = 0; i < kShardCount; ++i) {
+        AutoShard shard(i);
+        shard->setCategoryByteLimit(category, shardLimit);
+    }
+}
+
+size_t SkResourceCache::GetCategoryBytesUsed(const char* category) {
+    size_t used = 0;
+    for (int i = 0; i < kShardCount; ++i) {
+        AutoShard shard(i);
+        used += shard->getCategoryBytesUsed(category);
+    }
+    return used;
 }
 
 void SkResourceCache::PurgeAll() {
-    SkAutoMutexAcquire am(gMutex);
-    return get_cache()->purgeAll();
+    for (int i = 0; i < kShardCount; ++i) {
+        AutoShard shard(i);
+        shard->purgeAll();
+    }
+}
+
+size_t SkResourceCache::PurgeBytes(size_t bytesToFree) {
+    // Like SkStrikeCache::purge(), the first pass takes an even share from each shard, and the
+    // second whatever is still needed.
+    const size_t share = bytesToFree / kShardCount + 1;
+    size_t freed = 0;
+    for (int pass = 0; pass < 2; ++pass) {
+        for (int i = 0; i < kShardCount && freed < bytesToFree; ++i) {
+            size_t left = bytesToFree - freed;
+            AutoShard shard(i);
+            freed += shard->purgeBytes(0 == pass ? SkTMin(share, left) : left);
+        }
+    }
+    return freed;
+}
+
+void SkResourceCache::CheckAllMessages() {
+    // Lookups only read the counts. A shard checks its messages before the new count is
+    // published, so no lookup can see it and skip purges that haven't been processed yet.
+    uint32_t checked = gPurgesChecked.load();
+    uint32_t posted = gPurgesPosted.load();
+    if (checked == posted) {
+        return;
+    }
+    for (int i = 0; i < kShardCount; ++i) {
+        AutoShard shard(i);
+        shard->checkMessages();
+    }
+    // If another thread published first, a later lookup will check again if its count was older.
+    gPurgesChecked.compare_exchange_strong(checked, posted);
 }
 
 bool SkResourceCache::Find(const Key& key, FindVisitor visitor, void* context) {
-    SkAutoMutexAcquire am(gMutex);
-    return get_cache()->find(key, visitor, context);
+    CheckAllMessages();
+    AutoShard shard(shard_index(key));
+    return shard->find(key, visitor, context);
 }
 
 void SkResourceCache::Add(Rec* rec, void* payload) {
-    SkAutoMutexAcquire am(gMutex);
-    get_cache()->add(rec, payload);
+    CheckAllMessages();
+    int index = shard_index(rec->getKey());
+    {
+        AutoShard shard(index);
+        shard->add(rec, payload);
+    }
+    purge_as_needed(index);
 }
 
 void SkResourceCache::VisitAll(Visitor visitor, void* context) {
-    SkAutoMutexAcquire am(gMutex);
-    get_cache()->visitAll(visitor, context);
+    for (int i = 0; i < kShardCount; ++i) {
+        AutoShard shard(i);
+        shard->visitAll(visitor, context);
+    }
 }
 
 void SkResourceCache::PostPurgeSharedID(uint64_t sharedID) {
     if (sharedID) {
         SkMessageBus<PurgeSharedIDMessage>::Post(PurgeSharedIDMessage(sharedID));
+        gPurgesPosted.fetch_add(1);
     }
 }
 
@@ -594,8 +832,25 @@ static void sk_trace_dump_visitor(const SkResourceCache::Rec& rec, void* context
     }
 }
 
+static std::atomic<uint64_t> gDiscardablePurgedCount{0};
+static std::atomic<uint64_t> gDiscardablePurgedBytes{0};
+
+void SkResourceCache::NotifyDiscardablePurged(size_t bytes) {
+    gDiscardablePurgedCount.fetch_add(1, std::memory_order_relaxed);
+    gDiscardablePurgedBytes.fetch_add(bytes, std::memory_order_relaxed);
+}
+
 void SkResourceCache::DumpMemoryStatistics(SkTraceMemoryDump* dump) {
     // Since resource could be backed by malloc or discardable, the cache always dumps detailed
     // stats to be accurate.
     VisitAll(sk_trace_dump_visitor, dump);
+
+    if (GetDiscardableFactory()) {
+        // What has been lost so far to purging (by the OS, or a pool's budget) while unlocked.
+        const char* dumpName = "skia/sk_resource_cache/discardable_purged";
+        dump->dumpNumericValue(dumpName, "purged_count", "objects",
+                               gDiscardablePurgedCount.load(std::memory_order_relaxed));
+        dump->dumpNumericValue(dumpName, "purged_size", "bytes",
+                               gDiscardablePurgedBytes.load(std::memory_order_relaxed));
+    }
 }
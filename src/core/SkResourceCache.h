@@ -25,6 +25,8 @@ class SkTraceMemoryDump;
  *
  *  As a convenience, a global instance is also defined, which can be safely
  *  access across threads via the static methods (e.g. FindAndLock, etc.).
+ *  It is split into shards by key hash, each with its own lock, so threads
+ *  rarely wait on each other; its LRU order is only kept per shard.
  */
 class SkResourceCache {
 public:
@@ -164,8 +166,20 @@ public:
     static size_t GetSingleAllocationByteLimit();
     static size_t GetEffectiveSingleAllocationByteLimit();
 
+    // See setCategoryByteLimit(). Each shard of the global cache enforces an even share of the
+    // limit, so it suits categories of many small recs (e.g. masks) best.
+    static void SetCategoryByteLimit(const char* category, size_t limit);
+    static size_t GetCategoryBytesUsed(const char* category);
+
     static void PurgeAll();
 
+    /**
+     *  Purge the least recently used recs that can be purged from every shard of the global cache
+     *  until at least bytesToFree bytes have been freed, or there are none left. Returns the
+     *  number of bytes freed.
+     */
+    static size_t PurgeBytes(size_t bytesToFree);
+
     static void TestDumpMemoryStatistics();
 
     /** Dump memory usage statistics of every Rec in the cache using the
@@ -173,6 +187,12 @@ public:
      */
     static void DumpMemoryStatistics(SkTraceMemoryDump* dump);
 
+    /**
+     *  Called when a cached resource's discardable memory fails to lock because it was purged,
+     *  so that DumpMemoryStatistics() can report how much was lost that way.
+     */
+    static void NotifyDiscardablePurged(size_t bytes);
+
     /**
      *  Returns the DiscardableFactory used by the global cache, or nullptr.
      */
@@ -194,9 +214,10 @@ public:
      *  allocates memory for the pixels. In this mode, the cache has
      *  not explicit budget, and so methods like getTotalBytesUsed()
      *  and getTotalByteLimit() will return 0, and setTotalByteLimit
-     *  will ignore its argument and return 0.
+     *  will ignore its argument and return 0. Instead it holds at most
+     *  countLimit recs (0 means the default).
      */
-    SkResourceCache(DiscardableFactory);
+    SkResourceCache(DiscardableFactory, int countLimit = 0);
 
     /**
      *  Construct the cache, allocating memory with malloc, and respect the
@@ -241,6 +262,21 @@ public:
      */
     size_t setTotalByteLimit(size_t newLimit);
 
+    /**
+     *  Limit the bytes used by recs whose getCategory() matches category (by strcmp), purging
+     *  the least recently used of them, and only them, to stay under it. That keeps a busy
+     *  category from evicting everything else. category must outlive the cache (e.g. a string
+     *  literal). 0 removes the limit. Returns the previous limit.
+     */
+    size_t setCategoryByteLimit(const char* category, size_t newLimit);
+    size_t getCategoryBytesUsed(const char* category) const;
+
+    /**
+     *  Purge the least recently used recs that can be purged until at least bytesToFree bytes
+     *  have been freed, or there are none left. Returns the number of bytes freed.
+     */
+    size_t purgeBytes(size_t bytesToFree);
+
     void purgeSharedID(uint64_t sharedID);
 
     void purgeAll() {
@@ -269,12 +305,25 @@ private:
     size_t  fTotalByteLimit;
     size_t  fSingleAllocationByteLimit;
     int     fCount;
+    int     fDiscardableCountLimit;
+
+    struct CategoryBudget {
+        const char* fCategory;
+        size_t      fLimit;
+        size_t      fUsed;
+    };
+    SkTDArray<CategoryBudget> fCategoryBudgets;
 
     SkMessageBus<PurgeSharedIDMessage>::Inbox fPurgeSharedIDInbox;
 
     void checkMessages();
+    // Has every shard of the global cache check its messages, if any were posted since last time.
+    static void CheckAllMessages();
     void purgeAsNeeded(bool forcePurge = false);
 
+    CategoryBudget* findCategoryBudget(const char* category);
+    void purgeCategoryAsNeeded(CategoryBudget*);
+
     // linklist management
     void moveToHead(Rec*);
     void addToHead(Rec*);
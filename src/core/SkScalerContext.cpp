@@ -546,6 +546,27 @@ void SkScalerContext::getImage(const SkGlyph& origGlyph) {
     }
 }
 
+void SkScalerContext::getImages(const SkGlyph* const glyphs[], int count) {
+    if (this->batchesImages()) {
+        this->generateImages(glyphs, count);
+        return;
+    }
+    for (int i = 0; i < count; i++) {
+        this->getImage(*glyphs[i]);
+    }
+}
+
+bool SkScalerContext::batchesImages() const {
+    // Mask filters and paths take the glyphs one at a time.
+    return !fMaskFilter && !fGenerateImageFromPath && this->generatesImageBatches();
+}
+
+void SkScalerContext::generateImages(const SkGlyph* const glyphs[], int count) {
+    for (int i = 0; i < count; i++) {
+        this->generateImage(*glyphs[i]);
+    }
+}
+
 bool SkScalerContext::getPath(SkPackedGlyphID glyphID, SkPath* path) {
     return this->internalGetPath(glyphID, path);
 }
@@ -297,6 +297,11 @@ public:
     void        getMetrics(SkGlyph*);
     void        getImage(const SkGlyph&);
     bool SK_WARN_UNUSED_RESULT getPath(SkPackedGlyphID, SkPath*);
+
+    /** Like getImage() on each of the glyphs, whose images must all be allocated. */
+    void        getImages(const SkGlyph* const glyphs[], int count);
+    /** Whether getImages() is faster than calling getImage() on each glyph. */
+    bool        batchesImages() const;
     void        getFontMetrics(SkFontMetrics*);
 
     /** Return the size in bytes of the associated gamma lookup table
@@ -394,6 +399,13 @@ protected:
      */
     virtual void generateImage(const SkGlyph& glyph) = 0;
 
+    /** Generates the images of several glyphs, as generateImage() would one at a time.
+     *  Ports that can rasterize a run of glyphs faster together override this, and
+     *  generatesImageBatches() to return true.
+     */
+    virtual void generateImages(const SkGlyph* const glyphs[], int count);
+    virtual bool generatesImageBatches() const { return false; }
+
     /** Sets the passed path to the glyph outline.
      *  If this cannot be done the path is set to empty;
      *  @return false if this glyph does not have any path.
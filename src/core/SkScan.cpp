@@ -15,6 +15,7 @@ std::atomic<bool> gSkForceAnalyticAA{false};
 
 std::atomic<bool> gSkUseDeltaAA{true};
 std::atomic<bool> gSkForceDeltaAA{false};
+std::atomic<int>  gSkDAABandPixelThreshold{0};
 
 static inline void blitrect(SkBlitter* blitter, const SkIRect& r) {
     blitter->blitRect(r.fLeft, r.fTop, r.width(), r.height());
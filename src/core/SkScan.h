@@ -26,6 +26,9 @@ typedef SkIRect SkXRect;
 
 extern std::atomic<bool> gSkUseDeltaAA;
 extern std::atomic<bool> gSkForceDeltaAA;
+// Delta AA fills covering at least this many (clipped) pixels build their coverage deltas in
+// horizontal bands on SkExecutor::GetDefault(). Zero disables banding.
+extern std::atomic<int>  gSkDAABandPixelThreshold;
 extern std::atomic<bool> gSkUseAnalyticAA;
 extern std::atomic<bool> gSkForceAnalyticAA;
 
@@ -12,6 +12,7 @@
 #include "SkEdge.h"
 #include "SkEdgeBuilder.h"
 #include "SkGeometry.h"
+#include "SkOpts.h"
 #include "SkPath.h"
 #include "SkQuadClipper.h"
 #include "SkRasterClip.h"
@@ -22,6 +23,7 @@
 #include "SkTemplates.h"
 #include "SkTo.h"
 #include "SkUTF.h"
+#include "SkUtils.h"
 
 #include <utility>
 
@@ -246,10 +248,7 @@ void MaskAdditiveBlitter::blitAntiH(int x, int y, const SkAlpha alpha) {
 
 void MaskAdditiveBlitter::blitAntiH(int x, int y, int width, const SkAlpha alpha) {
     SkASSERT(x >= fMask.fBounds.fLeft -1);
-    uint8_t* row = this->getRow(y);
-    for (int i = 0; i < width; ++i) {
-        addAlpha(&row[x + i], alpha);
-    }
+    SkOpts::add_alpha(this->getRow(y) + x, alpha, width);
 }
 
 void MaskAdditiveBlitter::blitV(int x, int y, int height, SkAlpha alpha) {
@@ -351,6 +350,14 @@ protected:
         fRuns.reset(fWidth);
     }
 
+    // Splits [x, x + len), whose runs start at x and end at x + len, into runs of 1.
+    inline void splitIntoSingleRuns(int x, int len) {
+        for (int i = x; i < x + len; i += fRuns.fRuns[i]) {
+            memset(fRuns.fAlpha + i + 1, fRuns.fAlpha[i], fRuns.fRuns[i] - 1);
+        }
+        sk_memset16((uint16_t*)fRuns.fRuns + x, 1, len);
+    }
+
     // Blitting 0xFF and 0 is much faster so we snap alphas close to them
     inline SkAlpha snapAlpha(SkAlpha alpha) {
         return alpha > 247 ? 0xFF : alpha < 8 ? 0 : alpha;
@@ -438,16 +445,8 @@ void RunBasedAdditiveBlitter::blitAntiH(int x, int y, const SkAlpha antialias[],
     }
 
     fOffsetX = fRuns.add(x, 0, len, 0, 0, fOffsetX); // Break the run
-    for (int i = 0; i < len; i += fRuns.fRuns[x + i]) {
-        for (int j = 1; j < fRuns.fRuns[x + i]; j++) {
-            fRuns.fRuns[x + i + j] = 1;
-            fRuns.fAlpha[x + i + j] = fRuns.fAlpha[x + i];
-        }
-        fRuns.fRuns[x + i] = 1;
-    }
-    for (int i = 0; i < len; ++i) {
-        addAlpha(&fRuns.fAlpha[x + i], antialias[i]);
-    }
+    this->splitIntoSingleRuns(x, len);
+    SkOpts::add_alphas(fRuns.fAlpha + x, antialias, len);
 }
 void RunBasedAdditiveBlitter::blitAntiH(int x, int y, const SkAlpha alpha) {
     checkY(y);
@@ -506,16 +505,8 @@ void SafeRLEAdditiveBlitter::blitAntiH(int x, int y, const SkAlpha antialias[],
     }
 
     fOffsetX = fRuns.add(x, 0, len, 0, 0, fOffsetX); // Break the run
-    for (int i = 0; i < len; i += fRuns.fRuns[x + i]) {
-        for (int j = 1; j < fRuns.fRuns[x + i]; j++) {
-            fRuns.fRuns[x + i + j] = 1;
-            fRuns.fAlpha[x + i + j] = fRuns.fAlpha[x + i];
-        }
-        fRuns.fRuns[x + i] = 1;
-    }
-    for (int i = 0; i < len; ++i) {
-        safelyAddAlpha(&fRuns.fAlpha[x + i], antialias[i]);
-    }
+    this->splitIntoSingleRuns(x, len);
+    SkOpts::add_alphas_saturating(fRuns.fAlpha + x, antialias, len);
 }
 
 void SafeRLEAdditiveBlitter::blitAntiH(int x, int y, const SkAlpha alpha) {
@@ -611,10 +602,7 @@ static inline void computeAlphaAboveLine(SkAlpha* alphas, SkFixed l, SkFixed r,
         SkFixed firstH = SkFixedMul(first, dY); // vertical edge of the left-most triangle
         alphas[0] = SkFixedMul(first, firstH) >> 9; // triangle alpha
         SkFixed alpha16 = firstH + (dY >> 1); // rectangle plus triangle
-        for (int i = 1; i < R - 1; ++i) {
-            alphas[i] = alpha16 >> 8;
-            alpha16 += dY;
-        }
+        SkOpts::alpha_ramp(alphas + 1, R - 2, alpha16, dY);
         alphas[R - 1] = fullAlpha - partialTriangleToAlpha(last, dY);
     }
 }
@@ -635,10 +623,8 @@ static inline void computeAlphaBelowLine(
         SkFixed lastH = SkFixedMul(last, dY); // vertical edge of the right-most triangle
         alphas[R-1] = SkFixedMul(last, lastH) >> 9; // triangle alpha
         SkFixed alpha16 = lastH + (dY >> 1); // rectangle plus triangle
-        for (int i = R - 2; i > 0; i--) {
-            alphas[i] = alpha16 >> 8;
-            alpha16 += dY;
-        }
+        // alphas[R - 2] gets alpha16, and each alpha to its left dY more.
+        SkOpts::alpha_ramp(alphas + 1, R - 2, alpha16 + (R - 3) * dY, -dY);
         alphas[0] = fullAlpha - partialTriangleToAlpha(first, dY);
     }
 }
@@ -690,12 +676,10 @@ static SK_ALWAYS_INLINE void blit_full_alpha(AdditiveBlitter* blitter, int y, in
                             SkAlpha fullAlpha, SkAlpha* maskRow, bool isUsingMask,
                             bool noRealBlitter, bool needSafeCheck) {
     if (isUsingMask) {
-        for (int i = 0; i < len; ++i) {
-            if (needSafeCheck) {
-                safelyAddAlpha(&maskRow[x + i], fullAlpha);
-            } else {
-                addAlpha(&maskRow[x + i], fullAlpha);
-            }
+        if (needSafeCheck) {
+            SkOpts::add_alpha_saturating(maskRow + x, fullAlpha, len);
+        } else {
+            SkOpts::add_alpha(maskRow + x, fullAlpha, len);
         }
     } else {
         if (fullAlpha == 0xFF && !noRealBlitter) {
@@ -737,10 +721,8 @@ static void blit_aaa_trapezoid_row(AdditiveBlitter* blitter, int y,
     SkAlpha* tempAlphas = alphas + len + 1;
     int16_t* runs = (int16_t*)(alphas + (len + 1) * 2);
 
-    for (int i = 0; i < len; ++i) {
-        runs[i] = 1;
-        alphas[i] = fullAlpha;
-    }
+    memset(alphas, fullAlpha, len);
+    sk_memset16((uint16_t*)runs, 1, len);
     runs[len] = 0;
 
     int uL = SkFixedFloorToInt(ul);
@@ -755,13 +737,7 @@ static void blit_aaa_trapezoid_row(AdditiveBlitter* blitter, int y,
     } else {
         computeAlphaBelowLine(tempAlphas + uL - L, ul - SkIntToFixed(uL), ll - SkIntToFixed(uL),
                 lDY, fullAlpha);
-        for (int i = uL; i < lL; ++i) {
-            if (alphas[i - L] > tempAlphas[i - L]) {
-                alphas[i - L] -= tempAlphas[i - L];
-            } else {
-                alphas[i - L] = 0;
-            }
-        }
+        SkOpts::subtract_alphas_saturating(alphas + uL - L, tempAlphas + uL - L, lL - uL);
     }
 
     int uR = SkFixedFloorToInt(ur);
@@ -776,22 +752,14 @@ static void blit_aaa_trapezoid_row(AdditiveBlitter* blitter, int y,
     } else {
         computeAlphaAboveLine(tempAlphas + uR - L, ur - SkIntToFixed(uR), lr - SkIntToFixed(uR),
                 rDY, fullAlpha);
-        for (int i = uR; i < lR; ++i) {
-            if (alphas[i - L] > tempAlphas[i - L]) {
-                alphas[i - L] -= tempAlphas[i - L];
-            } else {
-                alphas[i - L] = 0;
-            }
-        }
+        SkOpts::subtract_alphas_saturating(alphas + uR - L, tempAlphas + uR - L, lR - uR);
     }
 
     if (isUsingMask) {
-        for (int i = 0; i < len; ++i) {
-            if (needSafeCheck) {
-                safelyAddAlpha(&maskRow[L + i], alphas[i]);
-            } else {
-                addAlpha(&maskRow[L + i], alphas[i]);
-            }
+        if (needSafeCheck) {
+            SkOpts::add_alphas_saturating(maskRow + L, alphas, len);
+        } else {
+            SkOpts::add_alphas(maskRow + L, alphas, len);
         }
     } else {
         if (fullAlpha == 0xFF && !noRealBlitter) {
@@ -915,8 +883,12 @@ static bool operator<(const SkAnalyticEdge& a, const SkAnalyticEdge& b) {
     return valuea < valueb;
 }
 
-static SkAnalyticEdge* sort_edges(SkAnalyticEdge* list[], int count, SkAnalyticEdge** last) {
-    SkTQSort(list, list + count - 1);
+// Edges from SkEdgeCache were cached in sorted order, and only need to be linked again.
+static SkAnalyticEdge* sort_edges(SkAnalyticEdge* list[], int count, SkAnalyticEdge** last,
+                                  bool alreadySorted) {
+    if (!alreadySorted) {
+        SkTQSort(list, list + count - 1);
+    }
 
     // now make the edges linked in sorted order
     for (int i = 1; i < count; ++i) {
@@ -1594,8 +1566,13 @@ static SK_ALWAYS_INLINE void aaa_fill_path(const SkPath& path, const SkIRect& cl
         bool isUsingMask, bool forceRLE) { // forceRLE implies that SkAAClip is calling us
     SkASSERT(blitter);
 
+    const SkIRect* edgeClip = pathContainedInClip ? nullptr : &clipRect;
     SkAnalyticEdgeBuilder builder;
-    int count = builder.buildEdges(path, pathContainedInClip ? nullptr : &clipRect);
+    int count = builder.findCachedEdges(path, edgeClip);
+    const bool edgesAreCached = count >= 0;
+    if (!edgesAreCached) {
+        count = builder.buildEdges(path, edgeClip);
+    }
     SkAnalyticEdge** list = builder.analyticEdgeList();
 
     SkIRect rect = clipRect;
@@ -1623,7 +1600,10 @@ static SK_ALWAYS_INLINE void aaa_fill_path(const SkPath& path, const SkIRect& cl
 
     SkAnalyticEdge headEdge, tailEdge, *last;
     // this returns the first and last edge after they're sorted into a dlink list
-    SkAnalyticEdge* edge = sort_edges(list, count, &last);
+    SkAnalyticEdge* edge = sort_edges(list, count, &last, edgesAreCached);
+    if (!edgesAreCached) {
+        builder.cacheEdges(path, edgeClip, count);
+    }
 
     headEdge.fRiteE = nullptr;
     headEdge.fPrev = nullptr;
@@ -21,9 +21,12 @@
 #include "SkScan.h"
 #include "SkScanPriv.h"
 #include "SkTSort.h"
+#include "SkTaskGroup.h"
 #include "SkTemplates.h"
 #include "SkUTF.h"
 
+#include <memory>
+
 #if defined(SK_DISABLE_DAA)
 void SkScan::DAAFillPath(const SkPath& path, SkBlitter* blitter, const SkIRect& ir,
                          const SkIRect& clipBounds, bool forceRLE, SkDAARecord* record) {
@@ -156,82 +159,47 @@ public:
     }
 };
 
-template<class Deltas> static SK_ALWAYS_INLINE
-void gen_alpha_deltas(const SkPath& path, const SkIRect& clippedIR, const SkIRect& clipBounds,
-        Deltas& result, SkBlitter* blitter, bool skipRect, bool pathContainedInClip) {
-    // 1. Build edges
-    SkBezierEdgeBuilder builder;
-    // We have to use clipBounds instead of clippedIR to build edges because of "canCullToTheRight":
-    // if the builder finds a right edge past the right clip, it won't build that right edge.
-    int  count = builder.buildEdges(path, pathContainedInClip ? nullptr : &clipBounds);
-
-    if (count == 0) {
-        return;
-    }
-    SkBezier** list = builder.bezierList();
-
-    // 2. Try to find the rect part because blitAntiRect is so much faster than blitCoverageDeltas
-    int rectTop = clippedIR.fBottom;   // the rect is initialized to be empty as top = bot
-    int rectBot = clippedIR.fBottom;
-    if (skipRect) {             // only find that rect is skipRect == true
-        YLessThan lessThan;     // sort edges in YX order
-        SkTQSort(list, list + count - 1, lessThan);
-        for(int i = 0; i < count - 1; ++i) {
-            SkBezier* lb = list[i];
-            SkBezier* rb = list[i + 1];
-
-            // fCount == 2 ensures that lb and rb are lines instead of quads or cubics.
-            bool lDX0 = lb->fP0.fX == lb->fP1.fX && lb->fCount == 2;
-            bool rDX0 = rb->fP0.fX == rb->fP1.fX && rb->fCount == 2;
-            if (!lDX0 || !rDX0) { // make sure that the edges are vertical
-                continue;
-            }
-
-            SkAnalyticEdge l, r;
-            if (!l.setLine(lb->fP0, lb->fP1) || !r.setLine(rb->fP0, rb->fP1)) {
-                continue;
-            }
-
-            SkFixed xorUpperY = l.fUpperY ^ r.fUpperY;
-            SkFixed xorLowerY = l.fLowerY ^ r.fLowerY;
-            if ((xorUpperY | xorLowerY) == 0) { // equal upperY and lowerY
-                rectTop = SkFixedCeilToInt(l.fUpperY);
-                rectBot = SkFixedFloorToInt(l.fLowerY);
-                if (rectBot > rectTop) { // if bot == top, the rect is too short for blitAntiRect
-                    int L = SkFixedCeilToInt(l.fUpperX);
-                    int R = SkFixedFloorToInt(r.fUpperX);
-                    if (L <= R) {
-                        SkAlpha la = (SkIntToFixed(L) - l.fUpperX) >> 8;
-                        SkAlpha ra = (r.fUpperX - SkIntToFixed(R)) >> 8;
-                        result.setAntiRect(L - 1, rectTop, R - L, rectBot - rectTop, la, ra);
-                    } else { // too thin to use blitAntiRect; reset the rect region to be emtpy
-                        rectTop = rectBot = clippedIR.fBottom;
-                    }
-                }
-                break;
-            }
-
-        }
-    }
-
-    // 3. Sort edges in x so we may need less sorting for delta based on x. This only helps
-    //    SkCoverageDeltaList. And we don't want to sort more than SORT_THRESHOLD edges where
-    //    the log(count) factor of the quick sort may become a bottleneck; when there are so
-    //    many edges, we're unlikely to make deltas sorted anyway.
+static void sort_edges_in_x(SkBezier** list, int count) {
+    // Sort edges in x so we may need less sorting for delta based on x. This only helps
+    // SkCoverageDeltaList. And we don't want to sort more than SORT_THRESHOLD edges where
+    // the log(count) factor of the quick sort may become a bottleneck; when there are so
+    // many edges, we're unlikely to make deltas sorted anyway.
     constexpr int SORT_THRESHOLD = 256;
-    if (std::is_same<Deltas, SkCoverageDeltaList>::value && count < SORT_THRESHOLD) {
+    if (count < SORT_THRESHOLD) {
         XLessThan lessThan;
         SkTQSort(list, list + count - 1, lessThan);
     }
+}
 
-    // Future todo: parallize and SIMD the following code.
-    // 4. iterate through edges and generate deltas
+// Whether the bezier's control points, and so the whole curve, lie outside rows [top, bottom).
+static bool is_outside_rows(const SkBezier* bezier, int top, int bottom) {
+    SkScalar minY = SkTMin(bezier->fP0.fY, bezier->fP1.fY),
+             maxY = SkTMax(bezier->fP0.fY, bezier->fP1.fY);
+    if (bezier->fCount == 3) {
+        const SkQuad* quad = static_cast<const SkQuad*>(bezier);
+        minY = SkTMin(minY, quad->fP2.fY);
+        maxY = SkTMax(maxY, quad->fP2.fY);
+    } else if (bezier->fCount == 4) {
+        const SkCubic* cubic = static_cast<const SkCubic*>(bezier);
+        minY = SkTMin(minY, SkTMin(cubic->fP2.fY, cubic->fP3.fY));
+        maxY = SkTMax(maxY, SkTMax(cubic->fP2.fY, cubic->fP3.fY));
+    }
+    return maxY < top || minY > bottom;
+}
+
+// Future todo: parallize and SIMD the following code.
+template<class Deltas> static SK_ALWAYS_INLINE
+void add_edge_deltas(SkBezier** list, int count, const SkIRect& clippedIR, int rectTop,
+                     int rectBot, Deltas* result) {
     for(int index = 0; index < count; ++index) {
         SkAnalyticCubicEdge storage;
         SkASSERT(sizeof(SkAnalyticQuadraticEdge) >= sizeof(SkAnalyticEdge));
         SkASSERT(sizeof(SkAnalyticCubicEdge) >= sizeof(SkAnalyticQuadraticEdge));
 
         SkBezier* bezier        = list[index];
+        if (is_outside_rows(bezier, clippedIR.fTop, clippedIR.fBottom)) {
+            continue;
+        }
         SkAnalyticEdge* currE   = &storage;
         bool edgeSet            = false;
 
@@ -265,6 +233,15 @@ void gen_alpha_deltas(const SkPath& path, const SkIRect& clippedIR, const SkIRec
         }
 
         do {
+            // Skip the segments above our rows, and stop at the first one below them, so that a
+            // band walks only its own rows of edges that cross many bands.
+            if (currE->fLowerY <= SkIntToFixed(clippedIR.fTop)) {
+                continue;
+            }
+            if (currE->fUpperY >= SkIntToFixed(clippedIR.fBottom)) {
+                break;
+            }
+
             currE->fX =  currE->fUpperX;
 
             SkFixed upperFloor  = SkFixedFloorToFixed(currE->fUpperY);
@@ -275,7 +252,7 @@ void gen_alpha_deltas(const SkPath& path, const SkIRect& clippedIR, const SkIRec
                 SkFixed rowHeight = currE->fLowerY - currE->fUpperY;
                 SkFixed nextX = currE->fX + SkFixedMul(currE->fDX, rowHeight);
                 if (iy >= clippedIR.fTop && iy < clippedIR.fBottom) {
-                    add_coverage_delta_segment<true>(iy, rowHeight, currE, nextX, &result);
+                    add_coverage_delta_segment<true>(iy, rowHeight, currE, nextX, result);
                 }
                 continue;
             }
@@ -285,20 +262,27 @@ void gen_alpha_deltas(const SkPath& path, const SkIRect& clippedIR, const SkIRec
             SkFixed nextX;
             if (rowHeight != SK_Fixed1) {   // it's a partial row
                 nextX = currE->fX + SkFixedMul(currE->fDX, rowHeight);
-                add_coverage_delta_segment<true>(iy, rowHeight, currE, nextX, &result);
+                add_coverage_delta_segment<true>(iy, rowHeight, currE, nextX, result);
             } else {                        // it's a full row so we can leave it to the while loop
                 iy--;                       // compensate the iy++ in the while loop
                 nextX = currE->fX;
             }
 
+            // Jump to our first row. Walking adds exactly fDX per row, so this gets the same x.
+            if (iy + 1 < clippedIR.fTop) {
+                int skippedRows = clippedIR.fTop - (iy + 1);
+                iy += skippedRows;
+                nextX += skippedRows * currE->fDX;
+            }
+
             while (true) { // process the full rows in the middle
                 iy++;
                 SkFixed y = SkIntToFixed(iy);
                 currE->fX = nextX;
                 nextX += currE->fDX;
 
-                if (y + SK_Fixed1 > currE->fLowerY) {
-                    break; // no full rows left, break
+                if (y + SK_Fixed1 > currE->fLowerY || iy >= clippedIR.fBottom) {
+                    break; // no full rows left in the edge or in our rows, break
                 }
 
                 // Check whether we're in the rect part that will be covered by blitAntiRect
@@ -309,7 +293,7 @@ void gen_alpha_deltas(const SkPath& path, const SkIRect& clippedIR, const SkIRec
                 }
 
                 // Add current edge's coverage deltas on this full row
-                add_coverage_delta_segment<false>(iy, SK_Fixed1, currE, nextX, &result);
+                add_coverage_delta_segment<false>(iy, SK_Fixed1, currE, nextX, result);
             }
 
             // last partial row
@@ -317,13 +301,169 @@ void gen_alpha_deltas(const SkPath& path, const SkIRect& clippedIR, const SkIRec
                     iy >= clippedIR.fTop && iy < clippedIR.fBottom) {
                 rowHeight = currE->fLowerY - SkIntToFixed(iy);
                 nextX = currE->fX + SkFixedMul(currE->fDX, rowHeight);
-                add_coverage_delta_segment<true>(iy, rowHeight, currE, nextX, &result);
+                add_coverage_delta_segment<true>(iy, rowHeight, currE, nextX, result);
             }
         // Intended assignment to fWinding to restore the maybe-negated winding (during updateLine)
         } while ((currE->fWinding = originalWinding) && currE->update(currE->fLowerY, sortY));
     }
 }
 
+// Finds the rect part of a convex path, between two vertical lines with the same top and
+// bottom, so that it can be filled by blitAntiRect. Sorts the edges in YX order. Returns false if
+// there's no such rect, or if it's too short or too thin for blitAntiRect.
+static bool find_anti_rect(SkBezier** list, int count, SkAntiRect* rect) {
+    YLessThan lessThan;     // sort edges in YX order
+    SkTQSort(list, list + count - 1, lessThan);
+    for(int i = 0; i < count - 1; ++i) {
+        SkBezier* lb = list[i];
+        SkBezier* rb = list[i + 1];
+
+        // fCount == 2 ensures that lb and rb are lines instead of quads or cubics.
+        bool lDX0 = lb->fP0.fX == lb->fP1.fX && lb->fCount == 2;
+        bool rDX0 = rb->fP0.fX == rb->fP1.fX && rb->fCount == 2;
+        if (!lDX0 || !rDX0) { // make sure that the edges are vertical
+            continue;
+        }
+
+        SkAnalyticEdge l, r;
+        if (!l.setLine(lb->fP0, lb->fP1) || !r.setLine(rb->fP0, rb->fP1)) {
+            continue;
+        }
+
+        SkFixed xorUpperY = l.fUpperY ^ r.fUpperY;
+        SkFixed xorLowerY = l.fLowerY ^ r.fLowerY;
+        if ((xorUpperY | xorLowerY) == 0) { // equal upperY and lowerY
+            int rectTop = SkFixedCeilToInt(l.fUpperY);
+            int rectBot = SkFixedFloorToInt(l.fLowerY);
+            int L = SkFixedCeilToInt(l.fUpperX);
+            int R = SkFixedFloorToInt(r.fUpperX);
+            // If bot == top, the rect is too short for blitAntiRect, and if L > R, too thin.
+            if (rectBot <= rectTop || L > R) {
+                return false;
+            }
+            SkAlpha la = (SkIntToFixed(L) - l.fUpperX) >> 8;
+            SkAlpha ra = (r.fUpperX - SkIntToFixed(R)) >> 8;
+            *rect = {L - 1, rectTop, R - L, rectBot - rectTop, la, ra};
+            return true;
+        }
+    }
+    return false;
+}
+
+template<class Deltas> static SK_ALWAYS_INLINE
+void gen_alpha_deltas(const SkPath& path, const SkIRect& clippedIR, const SkIRect& clipBounds,
+        Deltas& result, SkBlitter* blitter, bool skipRect, bool pathContainedInClip) {
+    // 1. Build edges
+    SkBezierEdgeBuilder builder;
+    // We have to use clipBounds instead of clippedIR to build edges because of "canCullToTheRight":
+    // if the builder finds a right edge past the right clip, it won't build that right edge.
+    int  count = builder.buildEdges(path, pathContainedInClip ? nullptr : &clipBounds);
+
+    if (count == 0) {
+        return;
+    }
+    SkBezier** list = builder.bezierList();
+
+    // 2. Try to find the rect part because blitAntiRect is so much faster than blitCoverageDeltas
+    int rectTop = clippedIR.fBottom;   // the rect is initialized to be empty as top = bot
+    int rectBot = clippedIR.fBottom;
+    SkAntiRect rect;
+    if (skipRect && find_anti_rect(list, count, &rect)) { // only find that rect if skipRect
+        rectTop = rect.fY;
+        rectBot = rect.fY + rect.fHeight;
+        result.setAntiRect(rect.fX, rect.fY, rect.fWidth, rect.fHeight,
+                           rect.fLeftAlpha, rect.fRightAlpha);
+    }
+
+    // 3. Sort edges in x
+    if (std::is_same<Deltas, SkCoverageDeltaList>::value) {
+        sort_edges_in_x(list, count);
+    }
+
+    // 4. iterate through edges and generate deltas
+    add_edge_deltas(list, count, clippedIR, rectTop, rectBot, &result);
+}
+
+// Bands are at least this many rows tall. We make more bands than there are threads in a typical
+// pool so that bands crossing dense parts of the path don't leave the other workers idle.
+static constexpr int kMinBandHeight = 32;
+static constexpr int kMaxBandCount  = 64;
+
+// Passes on only the deltas in one band's rows, so that a band can walk the same edges as the
+// whole path, and get exactly the whole path's coverage in its rows.
+class SkBandDeltas {
+public:
+    SkBandDeltas(SkCoverageDeltaList* list, int top, int bottom)
+        : fList(list), fTop(top), fBottom(bottom) {}
+
+    SK_ALWAYS_INLINE void addDelta(int x, int y, SkFixed delta) {
+        if (y >= fTop && y < fBottom) {
+            fList->addDelta(x, y, delta);
+        }
+    }
+
+private:
+    SkCoverageDeltaList* fList;
+    int                  fTop;
+    int                  fBottom;
+};
+
+// Splits clippedIR into horizontal bands and builds each band's SkCoverageDeltaList on
+// SkExecutor::GetDefault(). The edges and the rect part of a convex path are found once, as for a
+// serial fill, and each band then walks the edges read-only, from its top row to its bottom one,
+// keeping only its own rows' deltas in its own list and arena. Each band fills its share of the
+// rect with blitAntiRect. The bands are then blitted in order on the caller thread.
+static void daa_fill_path_in_bands(const SkPath& path, SkBlitter* blitter,
+                                   const SkIRect& clippedIR, const SkIRect& clipBounds,
+                                   int bandCount, bool forceRLE, bool isEvenOdd, bool isConvex,
+                                   bool containedInClip) {
+    SkBezierEdgeBuilder builder;
+    int count = builder.buildEdges(path, containedInClip ? nullptr : &clipBounds);
+    if (count == 0) {
+        return;
+    }
+    SkBezier** list = builder.bezierList();
+    SkAntiRect rect = {0, clippedIR.fBottom, 0, 0, 0, 0};
+    if (isConvex) {
+        find_anti_rect(list, count, &rect);
+    }
+    sort_edges_in_x(list, count);
+
+    int bandHeight = (clippedIR.height() + bandCount - 1) / bandCount;
+    SkAutoTArray<std::unique_ptr<SkArenaAlloc>> allocs(bandCount);
+    SkAutoTArray<SkCoverageDeltaList*> deltaLists(bandCount);
+
+    SkTaskGroup tg;
+    tg.batch(bandCount, [&](int i) {
+        deltaLists[i] = nullptr;
+        SkIRect bandIR = SkIRect::MakeLTRB(clippedIR.fLeft, clippedIR.fTop + i * bandHeight,
+                                           clippedIR.fRight, clippedIR.fTop + (i + 1) * bandHeight);
+        if (!bandIR.intersect(clippedIR)) {
+            return;
+        }
+        allocs[i].reset(new SkArenaAlloc(bandIR.height() * sizeof(SkCoverageDelta) *
+                                         SkCoverageDeltaList::INIT_ROW_SIZE));
+        deltaLists[i] = allocs[i]->make<SkCoverageDeltaList>(allocs[i].get(), bandIR, forceRLE);
+        int rectTop = SkTMax(rect.fY, bandIR.fTop);
+        int rectBot = SkTMin(rect.fY + rect.fHeight, bandIR.fBottom);
+        if (rectBot > rectTop) {
+            deltaLists[i]->setAntiRect(rect.fX, rectTop, rect.fWidth, rectBot - rectTop,
+                                       rect.fLeftAlpha, rect.fRightAlpha);
+        } else {
+            rectTop = rectBot = bandIR.fBottom;
+        }
+        SkBandDeltas deltas(deltaLists[i], bandIR.fTop, bandIR.fBottom);
+        add_edge_deltas(list, count, bandIR, rectTop, rectBot, &deltas);
+    });
+    tg.wait();
+
+    for (int i = 0; i < bandCount; ++i) {
+        if (deltaLists[i]) {
+            blitter->blitCoverageDeltas(deltaLists[i], clipBounds, isEvenOdd, false, isConvex);
+        }
+    }
+}
+
 void SkScan::DAAFillPath(const SkPath& path, SkBlitter* blitter, const SkIRect& ir,
                          const SkIRect& clipBounds, bool forceRLE, SkDAARecord* record) {
     bool containedInClip = clipBounds.contains(ir);
@@ -343,6 +483,20 @@ void SkScan::DAAFillPath(const SkPath& path, SkBlitter* blitter, const SkIRect&
         return;
     }
 
+    // Big fills without a record (i.e., not in the threaded backend's init-once/blit split) may
+    // build their deltas in parallel bands.
+    int pixelThreshold = gSkDAABandPixelThreshold.load(std::memory_order_relaxed);
+    if (!record && !isInverse && pixelThreshold > 0 &&
+            (forceRLE || !SkCoverageDeltaMask::Suitable(clippedIR)) &&
+            (int64_t)clippedIR.width() * clippedIR.height() >= pixelThreshold) {
+        int bandCount = SkTMin(clippedIR.height() / kMinBandHeight, kMaxBandCount);
+        if (bandCount > 1) {
+            daa_fill_path_in_bands(path, blitter, clippedIR, clipBounds, bandCount, forceRLE,
+                                   isEvenOdd, isConvex, containedInClip);
+            return;
+        }
+    }
+
 #ifdef SK_BUILD_FOR_GOOGLE3
     constexpr int STACK_SIZE = 12 << 10; // 12K stack size alloc; Google3 has 16K limit.
 #else
@@ -382,8 +382,11 @@ static bool operator<(const SkEdge& a, const SkEdge& b) {
     return valuea < valueb;
 }
 
-static SkEdge* sort_edges(SkEdge* list[], int count, SkEdge** last) {
-    SkTQSort(list, list + count - 1);
+// Edges from SkEdgeCache were cached in sorted order, and only need to be linked again.
+static SkEdge* sort_edges(SkEdge* list[], int count, SkEdge** last, bool alreadySorted = false) {
+    if (!alreadySorted) {
+        SkTQSort(list, list + count - 1);
+    }
 
     // now make the edges linked in sorted order
     for (int i = 1; i < count; i++) {
@@ -406,8 +409,13 @@ void sk_fill_path(const SkPath& path, const SkIRect& clipRect, SkBlitter* blitte
     shiftedClip.fTop = SkLeftShift(shiftedClip.fTop, shiftEdgesUp);
     shiftedClip.fBottom = SkLeftShift(shiftedClip.fBottom, shiftEdgesUp);
 
+    const SkIRect* edgeClip = pathContainedInClip ? nullptr : &shiftedClip;
     SkBasicEdgeBuilder builder(shiftEdgesUp);
-    int count = builder.buildEdges(path, pathContainedInClip ? nullptr : &shiftedClip);
+    int count = builder.findCachedEdges(path, edgeClip);
+    const bool edgesAreCached = count >= 0;
+    if (!edgesAreCached) {
+        count = builder.buildEdges(path, edgeClip);
+    }
     SkEdge** list = builder.edgeList();
 
     if (0 == count) {
@@ -437,7 +445,10 @@ void sk_fill_path(const SkPath& path, const SkIRect& clipRect, SkBlitter* blitte
 
     SkEdge headEdge, tailEdge, *last;
     // this returns the first and last edge after they're sorted into a dlink list
-    SkEdge* edge = sort_edges(list, count, &last);
+    SkEdge* edge = sort_edges(list, count, &last, edgesAreCached);
+    if (!edgesAreCached) {
+        builder.cacheEdges(path, edgeClip, count);
+    }
 
     headEdge.fPrev = nullptr;
     headEdge.fNext = edge;
@@ -7,6 +7,8 @@
 
 #include "SkSharedMutex.h"
 
+#include "SkChecksum.h"
+#include "SkThreadID.h"
 #include "SkTypes.h"
 #include "SkSemaphore.h"
 
@@ -356,3 +358,62 @@
     }
 
 #endif
+
+///////////////////////////////////////////////////////////////////////////////
+
+SkDistributedSharedMutex::SkDistributedSharedMutex() { ANNOTATE_RWLOCK_CREATE(this); }
+SkDistributedSharedMutex::~SkDistributedSharedMutex() { ANNOTATE_RWLOCK_DESTROY(this); }
+
+int SkDistributedSharedMutex::SlotIndex() {
+    // Thread IDs are often pointers to page aligned thread data, so mix all their bits down.
+    uint64_t id = (uint64_t)SkGetThreadID();
+    return SkChecksum::Mix((uint32_t)(id ^ (id >> 32))) % kSlotCount;
+}
+
+void SkDistributedSharedMutex::acquire() {
+    fWriterMutex.acquire();
+
+    // Turn away new readers, then wait for the ones already counted to leave. The stores to
+    // fWriting and the slots are sequentially consistent so that a reader and this writer can't
+    // both miss each other: either the reader sees fWriting, or we see its count.
+    fWriting.store(true, std::memory_order_seq_cst);
+    for (Slot& slot : fSlots) {
+        while (slot.fReaders.load(std::memory_order_seq_cst) > 0) {
+            // May also wake for slots drained by earlier writers; we just check again.
+            fSlotDrained.wait();
+        }
+    }
+    ANNOTATE_RWLOCK_ACQUIRED(this, 1);
+}
+
+void SkDistributedSharedMutex::release() {
+    ANNOTATE_RWLOCK_RELEASED(this, 1);
+    fWriting.store(false, std::memory_order_release);
+    fWriterMutex.release();
+}
+
+void SkDistributedSharedMutex::acquireShared() {
+    Slot* slot = &fSlots[SlotIndex()];
+    slot->fReaders.fetch_add(1, std::memory_order_seq_cst);
+    if (fWriting.load(std::memory_order_seq_cst)) {
+        // A writer is in, or on its way in. Back out, and count ourselves once it is done. No
+        // writer can start while we hold fWriterMutex, and the next one will see our count.
+        this->releaseSlot(slot);
+        fWriterMutex.acquire();
+        slot->fReaders.fetch_add(1, std::memory_order_relaxed);
+        fWriterMutex.release();
+    }
+    ANNOTATE_RWLOCK_ACQUIRED(this, 0);
+}
+
+void SkDistributedSharedMutex::releaseShared() {
+    ANNOTATE_RWLOCK_RELEASED(this, 0);
+    this->releaseSlot(&fSlots[SlotIndex()]);
+}
+
+void SkDistributedSharedMutex::releaseSlot(Slot* slot) {
+    if (1 == slot->fReaders.fetch_sub(1, std::memory_order_seq_cst) &&
+        fWriting.load(std::memory_order_seq_cst)) {
+        fSlotDrained.signal();
+    }
+}
@@ -9,12 +9,12 @@
 #define SkSharedLock_DEFINED
 
 #include "SkMacros.h"
+#include "SkMutex.h"
 #include "SkSemaphore.h"
 #include "SkTypes.h"
 #include <atomic>
 
 #ifdef SK_DEBUG
-    #include "SkMutex.h"
     #include <memory>
 #endif  // SK_DEBUG
 
@@ -70,12 +70,65 @@ inline void SkSharedMutex::assertHeld() const {};
 inline void SkSharedMutex::assertHeldShared() const {};
 #endif  // SK_DEBUG
 
+// A shared lock for data that is read far more often than it is written. SkSharedMutex keeps all
+// of its counts in one atomic, so readers on different cores fight over that cache line even when
+// no writer is around. Here each reader only counts itself in one of kSlotCount counters, picked
+// by its thread ID and each on its own cache line, and then checks that no writer is active.
+//
+// The price is paid by writers: acquire() takes a mutex, turns new readers away, and then waits
+// for every slot to drain. Readers that are turned away wait on that same mutex. A shared lock
+// must be released on the thread that acquired it.
+class SkDistributedSharedMutex {
+public:
+    SkDistributedSharedMutex();
+    ~SkDistributedSharedMutex();
+
+    // Acquire lock for exclusive use.
+    void acquire();
+
+    // Release lock for exclusive use.
+    void release();
+
+    // Fail if exclusive is not held.
+    void assertHeld() const { fWriterMutex.assertHeld(); }
+
+    // Acquire lock for shared use.
+    void acquireShared();
+
+    // Release lock for shared use.
+    void releaseShared();
+
+private:
+    static constexpr int kSlotCount     = 32;
+    static constexpr int kCacheLineSize = 64;
+
+    struct Slot {
+        std::atomic<int32_t> fReaders{0};
+        char                 fPadding[kCacheLineSize - sizeof(std::atomic<int32_t>)];
+    };
+
+    static int SlotIndex();
+    void releaseSlot(Slot*);
+
+    Slot              fSlots[kSlotCount];
+    std::atomic<bool> fWriting{false};
+    mutable SkMutex   fWriterMutex;
+    SkSemaphore       fSlotDrained;
+};
+
 class SkAutoSharedMutexShared {
 public:
-    SkAutoSharedMutexShared(SkSharedMutex& lock) : fLock(lock) { lock.acquireShared(); }
-    ~SkAutoSharedMutexShared() { fLock.releaseShared(); }
+    template <typename T>
+    SkAutoSharedMutexShared(T& lock) : fLock(&lock) {
+        lock.acquireShared();
+
+        fRelease = [](void* lock) { ((T*)lock)->releaseShared(); };
+    }
+    ~SkAutoSharedMutexShared() { fRelease(fLock); }
+
 private:
-    SkSharedMutex& fLock;
+    void* fLock;
+    void (*fRelease)(void*);
 };
 
 #define SkAutoSharedMutexShared(...) SK_REQUIRE_LOCAL_VAR(SkAutoSharedMutexShared)
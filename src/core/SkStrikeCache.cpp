@@ -46,6 +46,10 @@ public:
         return fCache.hasPath(glyph);
     }
 
+    void prefetchImages(SkSpan<const SkGlyphID> glyphIDs, const SkPoint positions[]) override {
+        fCache.prefetchImages(glyphIDs, positions);
+    }
+
     SkStrikeCache* const            fStrikeCache;
     Node*                           fNext{nullptr};
     Node*                           fPrev{nullptr};
@@ -115,11 +119,13 @@ bool operator == (decltype(nullptr), const SkStrikeCache::ExclusiveStrikePtr& rh
 }
 
 SkStrikeCache::~SkStrikeCache() {
-    Node* node = fHead;
-    while (node) {
-        Node* next = node->fNext;
-        delete node;
-        node = next;
+    for (Shard& shard : fShards) {
+        Node* node = shard.fHead;
+        while (node) {
+            Node* next = node->fNext;
+            delete node;
+            node = next;
+        }
     }
 }
 
@@ -294,13 +300,16 @@ void SkStrikeCache::attachNode(Node* node) {
     if (node == nullptr) {
         return;
     }
-    SkAutoExclusive ac(fLock);
+    Shard* shard = &this->shardFor(node->fCache.getDescriptor());
+    {
+        SkAutoExclusive ac(shard->fLock);
 
-    this->validate();
-    node->fCache.validate();
+        this->internalValidate(*shard);
+        node->fCache.validate();
 
-    this->internalAttachToHead(node);
-    this->internalPurge();
+        this->internalAttachToHead(shard, node);
+    }
+    this->purge();
 }
 
 SkExclusiveStrikePtr SkStrikeCache::findStrikeExclusive(const SkDescriptor& desc) {
@@ -308,11 +317,12 @@ SkExclusiveStrikePtr SkStrikeCache::findStrikeExclusive(const SkDescriptor& desc
 }
 
 auto SkStrikeCache::findAndDetachStrike(const SkDescriptor& desc) -> Node* {
-    SkAutoExclusive ac(fLock);
+    Shard* shard = &this->shardFor(desc);
+    SkAutoExclusive ac(shard->fLock);
 
-    for (Node* node = internalGetHead(); node != nullptr; node = node->fNext) {
+    for (Node* node = shard->fHead; node != nullptr; node = node->fNext) {
         if (node->fCache.getDescriptor() == desc) {
-            this->internalDetachCache(node);
+            this->internalDetachCache(shard, node);
             return node;
         }
     }
@@ -349,28 +359,31 @@ static bool loose_compare(const SkDescriptor& lhs, const SkDescriptor& rhs) {
 
 bool SkStrikeCache::desperationSearchForImage(const SkDescriptor& desc, SkGlyph* glyph,
                                               SkGlyphCache* targetCache) {
-    SkAutoExclusive ac(fLock);
-
     SkGlyphID glyphID = glyph->getGlyphID();
     SkFixed targetSubX = glyph->getSubXFixed(),
             targetSubY = glyph->getSubYFixed();
 
-    for (Node* node = internalGetHead(); node != nullptr; node = node->fNext) {
-        if (loose_compare(node->fCache.getDescriptor(), desc)) {
-            auto targetGlyphID = SkPackedGlyphID(glyphID, targetSubX, targetSubY);
-            if (node->fCache.isGlyphCached(glyphID, targetSubX, targetSubY)) {
-                SkGlyph* fallback = node->fCache.getRawGlyphByID(targetGlyphID);
-                // This desperate-match node may disappear as soon as we drop fLock, so we
-                // need to copy the glyph from node into this strike, including a
-                // deep copy of the mask.
-                targetCache->initializeGlyphFromFallback(glyph, *fallback);
-                return true;
-            }
+    // A loose match can have a different checksum, so it may be in any shard.
+    for (Shard& shard : fShards) {
+        SkAutoExclusive ac(shard.fLock);
+
+        for (Node* node = shard.fHead; node != nullptr; node = node->fNext) {
+            if (loose_compare(node->fCache.getDescriptor(), desc)) {
+                auto targetGlyphID = SkPackedGlyphID(glyphID, targetSubX, targetSubY);
+                if (node->fCache.isGlyphCached(glyphID, targetSubX, targetSubY)) {
+                    SkGlyph* fallback = node->fCache.getRawGlyphByID(targetGlyphID);
+                    // This desperate-match node may disappear as soon as we drop the shard's
+                    // lock, so we need to copy the glyph from node into this strike, including
+                    // a deep copy of the mask.
+                    targetCache->initializeGlyphFromFallback(glyph, *fallback);
+                    return true;
+                }
 
-            // Look for any sub-pixel pos for this glyph, in case there is a pos mismatch.
-            if (const auto* fallback = node->fCache.getCachedGlyphAnySubPix(glyphID)) {
-                targetCache->initializeGlyphFromFallback(glyph, *fallback);
-                return true;
+                // Look for any sub-pixel pos for this glyph, in case there is a pos mismatch.
+                if (const auto* fallback = node->fCache.getCachedGlyphAnySubPix(glyphID)) {
+                    targetCache->initializeGlyphFromFallback(glyph, *fallback);
+                    return true;
+                }
             }
         }
     }
@@ -380,23 +393,25 @@ bool SkStrikeCache::desperationSearchForImage(const SkDescriptor& desc, SkGlyph*
 
 bool SkStrikeCache::desperationSearchForPath(
         const SkDescriptor& desc, SkGlyphID glyphID, SkPath* path) {
-    SkAutoExclusive ac(fLock);
-
     // The following is wrong there is subpixel positioning with paths...
     // Paths are only ever at sub-pixel position (0,0), so we can just try that directly rather
     // than try our packed position first then search all others on failure like for masks.
     //
     // This will have to search the sub-pixel positions too.
     // There is also a problem with accounting for cache size with shared path data.
-    for (Node* node = internalGetHead(); node != nullptr; node = node->fNext) {
-        if (loose_compare(node->fCache.getDescriptor(), desc)) {
-            if (node->fCache.isGlyphCached(glyphID, 0, 0)) {
-                SkGlyph* from = node->fCache.getRawGlyphByID(SkPackedGlyphID(glyphID));
-                if (from->fPathData != nullptr && from->fPathData->fPath != nullptr) {
-                    // We can just copy the path out by value here, so no need to worry
-                    // about the lifetime of this desperate-match node.
-                    *path = *from->fPathData->fPath;
-                    return true;
+    for (Shard& shard : fShards) {
+        SkAutoExclusive ac(shard.fLock);
+
+        for (Node* node = shard.fHead; node != nullptr; node = node->fNext) {
+            if (loose_compare(node->fCache.getDescriptor(), desc)) {
+                if (node->fCache.isGlyphCached(glyphID, 0, 0)) {
+                    SkGlyph* from = node->fCache.getRawGlyphByID(SkPackedGlyphID(glyphID));
+                    if (from->fPathData != nullptr && from->fPathData->fPath != nullptr) {
+                        // We can just copy the path out by value here, so no need to worry
+                        // about the lifetime of this desperate-match node.
+                        *path = *from->fPathData->fPath;
+                        return true;
+                    }
                 }
             }
         }
@@ -440,22 +455,22 @@ auto SkStrikeCache::createStrike(
 }
 
 void SkStrikeCache::purgeAll() {
-    SkAutoExclusive ac(fLock);
-    this->internalPurge(fTotalMemoryUsed);
+    this->purge(fTotalMemoryUsed);
+}
+
+size_t SkStrikeCache::purgeBytes(size_t bytesToFree) {
+    return bytesToFree ? this->purge(bytesToFree) : 0;
 }
 
 size_t SkStrikeCache::getTotalMemoryUsed() const {
-    SkAutoExclusive ac(fLock);
     return fTotalMemoryUsed;
 }
 
 int SkStrikeCache::getCacheCountUsed() const {
-    SkAutoExclusive ac(fLock);
     return fCacheCount;
 }
 
 int SkStrikeCache::getCacheCountLimit() const {
-    SkAutoExclusive ac(fLock);
     return fCacheCountLimit;
 }
 
@@ -465,16 +480,12 @@ size_t SkStrikeCache::setCacheSizeLimit(size_t newLimit) {
         newLimit = minLimit;
     }
 
-    SkAutoExclusive ac(fLock);
-
-    size_t prevLimit = fCacheSizeLimit;
-    fCacheSizeLimit = newLimit;
-    this->internalPurge();
+    size_t prevLimit = fCacheSizeLimit.exchange(newLimit);
+    this->purge();
     return prevLimit;
 }
 
 size_t  SkStrikeCache::getCacheSizeLimit() const {
-    SkAutoExclusive ac(fLock);
     return fCacheSizeLimit;
 }
 
@@ -483,16 +494,12 @@ int SkStrikeCache::setCacheCountLimit(int newCount) {
         newCount = 0;
     }
 
-    SkAutoExclusive ac(fLock);
-
-    int prevCount = fCacheCountLimit;
-    fCacheCountLimit = newCount;
-    this->internalPurge();
+    int prevCount = fCacheCountLimit.exchange(newCount);
+    this->purge();
     return prevCount;
 }
 
 int SkStrikeCache::getCachePointSizeLimit() const {
-    SkAutoExclusive ac(fLock);
     return fPointSizeLimit;
 }
 
@@ -501,41 +508,48 @@ int SkStrikeCache::setCachePointSizeLimit(int newLimit) {
         newLimit = 0;
     }
 
-    SkAutoExclusive ac(fLock);
+    return fPointSizeLimit.exchange(newLimit);
+}
 
-    int prevLimit = fPointSizeLimit;
-    fPointSizeLimit = newLimit;
-    return prevLimit;
+SkExecutor* SkStrikeCache::getRasterExecutor() const {
+    return fRasterExecutor;
+}
+
+SkExecutor* SkStrikeCache::setRasterExecutor(SkExecutor* executor) {
+    return fRasterExecutor.exchange(executor);
 }
 
 void SkStrikeCache::forEachStrike(std::function<void(const SkGlyphCache&)> visitor) const {
-    SkAutoExclusive ac(fLock);
+    for (const Shard& shard : fShards) {
+        SkAutoExclusive ac(shard.fLock);
 
-    this->validate();
+        this->internalValidate(shard);
 
-    for (Node* node = this->internalGetHead(); node != nullptr; node = node->fNext) {
-        visitor(node->fCache);
+        for (Node* node = shard.fHead; node != nullptr; node = node->fNext) {
+            visitor(node->fCache);
+        }
     }
 }
 
-size_t SkStrikeCache::internalPurge(size_t minBytesNeeded) {
-    this->validate();
+size_t SkStrikeCache::purge(size_t minBytesNeeded) {
+    size_t totalMemoryUsed = fTotalMemoryUsed;
+    int cacheCount = fCacheCount;
 
     size_t bytesNeeded = 0;
-    if (fTotalMemoryUsed > fCacheSizeLimit) {
-        bytesNeeded = fTotalMemoryUsed - fCacheSizeLimit;
+    if (totalMemoryUsed > fCacheSizeLimit) {
+        bytesNeeded = totalMemoryUsed - fCacheSizeLimit;
     }
     bytesNeeded = SkTMax(bytesNeeded, minBytesNeeded);
     if (bytesNeeded) {
         // no small purges!
-        bytesNeeded = SkTMax(bytesNeeded, fTotalMemoryUsed >> 2);
+        bytesNeeded = SkTMax(bytesNeeded, totalMemoryUsed >> 2);
     }
 
     int countNeeded = 0;
-    if (fCacheCount > fCacheCountLimit) {
-        countNeeded = fCacheCount - fCacheCountLimit;
+    if (cacheCount > fCacheCountLimit) {
+        countNeeded = cacheCount - fCacheCountLimit;
         // no small purges!
-        countNeeded = SkMax32(countNeeded, fCacheCount >> 2);
+        countNeeded = SkMax32(countNeeded, cacheCount >> 2);
     }
 
     // early exit
@@ -546,24 +560,30 @@ size_t SkStrikeCache::internalPurge(size_t minBytesNeeded) {
     size_t  bytesFreed = 0;
     int     countFreed = 0;
 
-    // Start at the tail and proceed backwards deleting; the list is in LRU
-    // order, with unimportant entries at the tail.
-    Node* node = this->internalGetTail();
-    while (node != nullptr && (bytesFreed < bytesNeeded || countFreed < countNeeded)) {
-        Node* prev = node->fPrev;
+    // The first pass takes an even share from each shard so the strikes in one shard are not
+    // all thrown out for the sake of the others; the second takes whatever is still needed.
+    // Shards are locked one at a time, starting from a different shard on each purge.
+    const size_t bytesShare = (bytesNeeded + kShardCount - 1) / kShardCount;
+    const int    countShare = (countNeeded + kShardCount - 1) / kShardCount;
+    const int    firstShard = fNextPurgeShard++;
+    for (int pass = 0; pass < 2; pass++) {
+        for (int i = 0; i < kShardCount; i++) {
+            size_t bytesLeft = bytesNeeded > bytesFreed ? bytesNeeded - bytesFreed : 0;
+            int    countLeft = SkMax32(countNeeded - countFreed, 0);
+            if (!bytesLeft && !countLeft) {
+                break;
+            }
+            if (pass == 0) {
+                bytesLeft = SkTMin(bytesLeft, bytesShare);
+                countLeft = SkMin32(countLeft, countShare);
+            }
 
-        // Only delete if the strike is not pinned.
-        if (node->fPinner == nullptr || node->fPinner->canDelete()) {
-            bytesFreed += node->fCache.getMemoryUsed();
-            countFreed += 1;
-            this->internalDetachCache(node);
-            delete node;
+            Shard* shard = &fShards[(unsigned)(firstShard + i) % kShardCount];
+            SkAutoExclusive ac(shard->fLock);
+            this->internalPurgeShard(shard, bytesLeft, countLeft, &bytesFreed, &countFreed);
         }
-        node = prev;
     }
 
-    this->validate();
-
 #ifdef SPEW_PURGE_STATUS
     if (countFreed) {
         SkDebugf("purging %dK from font cache [%d entries]\n",
@@ -574,36 +594,71 @@ size_t SkStrikeCache::internalPurge(size_t minBytesNeeded) {
     return bytesFreed;
 }
 
-void SkStrikeCache::internalAttachToHead(Node* node) {
+void SkStrikeCache::internalPurgeShard(Shard* shard, size_t bytesNeeded, int countNeeded,
+                                       size_t* bytesFreed, int* countFreed) {
+    this->internalValidate(*shard);
+
+    size_t bytes = 0;
+    int    count = 0;
+
+    // Start at the tail and proceed backwards deleting; the list is in LRU
+    // order, with unimportant entries at the tail.
+    Node* node = shard->fTail;
+    while (node != nullptr && (bytes < bytesNeeded || count < countNeeded)) {
+        Node* prev = node->fPrev;
+
+        // Only delete if the strike is not pinned.
+        if (node->fPinner == nullptr || node->fPinner->canDelete()) {
+            bytes += node->fCache.getMemoryUsed();
+            count += 1;
+            this->internalDetachCache(shard, node);
+            delete node;
+        }
+        node = prev;
+    }
+
+    this->internalValidate(*shard);
+
+    *bytesFreed += bytes;
+    *countFreed += count;
+}
+
+void SkStrikeCache::internalAttachToHead(Shard* shard, Node* node) {
     SkASSERT(nullptr == node->fPrev && nullptr == node->fNext);
-    if (fHead) {
-        fHead->fPrev = node;
-        node->fNext = fHead;
+    if (shard->fHead) {
+        shard->fHead->fPrev = node;
+        node->fNext = shard->fHead;
     }
-    fHead = node;
+    shard->fHead = node;
 
-    if (fTail == nullptr) {
-        fTail = node;
+    if (shard->fTail == nullptr) {
+        shard->fTail = node;
     }
 
-    fCacheCount += 1;
-    fTotalMemoryUsed += node->fCache.getMemoryUsed();
+    size_t memoryUsed = node->fCache.getMemoryUsed();
+    shard->fCount      += 1;
+    shard->fMemoryUsed += memoryUsed;
+    fCacheCount        += 1;
+    fTotalMemoryUsed   += memoryUsed;
 }
 
-void SkStrikeCache::internalDetachCache(Node* node) {
-    SkASSERT(fCacheCount > 0);
-    fCacheCount -= 1;
-    fTotalMemoryUsed -= node->fCache.getMemoryUsed();
+void SkStrikeCache::internalDetachCache(Shard* shard, Node* node) {
+    SkASSERT(shard->fCount > 0);
+    size_t memoryUsed = node->fCache.getMemoryUsed();
+    shard->fCount      -= 1;
+    shard->fMemoryUsed -= memoryUsed;
+    fCacheCount        -= 1;
+    fTotalMemoryUsed   -= memoryUsed;
 
     if (node->fPrev) {
         node->fPrev->fNext = node->fNext;
     } else {
-        fHead = node->fNext;
+        shard->fHead = node->fNext;
     }
     if (node->fNext) {
         node->fNext->fPrev = node->fPrev;
     } else {
-        fTail = node->fPrev;
+        shard->fTail = node->fPrev;
     }
     node->fPrev = node->fNext = nullptr;
 }
@@ -624,20 +679,41 @@ void SkStrikeCache::validateGlyphCacheDataSize() const {
 
 #ifdef SK_DEBUG
 void SkStrikeCache::validate() const {
+    // Lock every shard, always in the same order, so the global totals can be checked too.
+    size_t totalBytes = 0;
+    int totalCount = 0;
+    for (const Shard& shard : fShards) {
+        shard.fLock.acquire();
+        this->internalValidate(shard);
+        totalBytes += shard.fMemoryUsed;
+        totalCount += shard.fCount;
+    }
+
+    SkASSERTF(fCacheCount == totalCount, "fCacheCount: %d, totalCount: %d",
+              fCacheCount.load(), totalCount);
+    SkASSERTF(fTotalMemoryUsed == totalBytes, "fTotalMemoryUsed: %zu, totalBytes: %zu",
+              fTotalMemoryUsed.load(), totalBytes);
+
+    for (const Shard& shard : fShards) {
+        shard.fLock.release();
+    }
+}
+
+void SkStrikeCache::internalValidate(const Shard& shard) const {
     size_t computedBytes = 0;
     int computedCount = 0;
 
-    const Node* node = fHead;
+    const Node* node = shard.fHead;
     while (node != nullptr) {
         computedBytes += node->fCache.getMemoryUsed();
         computedCount += 1;
         node = node->fNext;
     }
 
-    SkASSERTF(fCacheCount == computedCount, "fCacheCount: %d, computedCount: %d", fCacheCount,
+    SkASSERTF(shard.fCount == computedCount, "fCount: %d, computedCount: %d", shard.fCount,
               computedCount);
-    SkASSERTF(fTotalMemoryUsed == computedBytes, "fTotalMemoryUsed: %d, computedBytes: %d",
-              fTotalMemoryUsed, computedBytes);
+    SkASSERTF(shard.fMemoryUsed == computedBytes, "fMemoryUsed: %zu, computedBytes: %zu",
+              shard.fMemoryUsed, computedBytes);
 }
 #endif
 
@@ -8,6 +8,7 @@
 #ifndef SkStrikeCache_DEFINED
 #define SkStrikeCache_DEFINED
 
+#include <atomic>
 #include <unordered_map>
 #include <unordered_set>
 
@@ -16,6 +17,7 @@
 #include "SkSpinlock.h"
 #include "SkTemplates.h"
 
+class SkExecutor;
 class SkGlyphCache;
 class SkTraceMemoryDump;
 
@@ -157,6 +159,10 @@ public:
 
     void purgeAll(); // does not change budget
 
+    // Frees at least bytesToFree, or a quarter of the cache if that is more, from the least
+    // recently used strikes that are not pinned. Returns the number of bytes freed.
+    size_t purgeBytes(size_t bytesToFree);
+
     int getCacheCountLimit() const;
     int setCacheCountLimit(int limit);
     int getCacheCountUsed() const;
@@ -168,6 +174,9 @@ public:
     int  getCachePointSizeLimit() const;
     int  setCachePointSizeLimit(int limit);
 
+    SkExecutor* getRasterExecutor() const;
+    SkExecutor* setRasterExecutor(SkExecutor* executor);
+
 #ifdef SK_DEBUG
     // A simple accounting of what each glyph cache reports and the strike cache total.
     void validate() const;
@@ -179,28 +188,52 @@ public:
 #endif
 
 private:
+    friend class SkStrikeStore;
+
+    // Strikes are spread over kShardCount shards by descriptor checksum, each with its own lock
+    // and LRU list, so threads drawing text with different strikes rarely contend. The byte and
+    // count budgets are global; purging frees from the tail of every shard.
+    static constexpr int kShardCount = 8;
+
+    struct Shard {
+        mutable SkSpinlock fLock;
+        Node*              fHead{nullptr};
+        Node*              fTail{nullptr};
+        size_t             fMemoryUsed{0};
+        int32_t            fCount{0};
+    };
+
+    Shard& shardFor(const SkDescriptor& desc) {
+        return fShards[desc.getChecksum() % kShardCount];
+    }
 
-    // The following methods can only be called when mutex is already held.
-    Node* internalGetHead() const { return fHead; }
-    Node* internalGetTail() const { return fTail; }
-    void internalDetachCache(Node*);
-    void internalAttachToHead(Node*);
+    // The following methods can only be called when the shard's lock is already held.
+    void internalDetachCache(Shard*, Node*);
+    void internalAttachToHead(Shard*, Node*);
+    // Frees up to bytesNeeded / countNeeded from the tail of the shard.
+    void internalPurgeShard(Shard*, size_t bytesNeeded, int countNeeded,
+                            size_t* bytesFreed, int* countFreed);
+#ifdef SK_DEBUG
+    void internalValidate(const Shard&) const;
+#else
+    void internalValidate(const Shard&) const {}
+#endif
 
     // Checkout budgets, modulated by the specified min-bytes-needed-to-purge,
-    // and attempt to purge caches to match.
+    // and attempt to purge caches to match. Must be called with no shard lock held.
     // Returns number of bytes freed.
-    size_t internalPurge(size_t minBytesNeeded = 0);
+    size_t purge(size_t minBytesNeeded = 0);
 
     void forEachStrike(std::function<void(const SkGlyphCache&)> visitor) const;
 
-    mutable SkSpinlock fLock;
-    Node*              fHead{nullptr};
-    Node*              fTail{nullptr};
-    size_t             fTotalMemoryUsed{0};
-    size_t             fCacheSizeLimit{SK_DEFAULT_FONT_CACHE_LIMIT};
-    int32_t            fCacheCountLimit{SK_DEFAULT_FONT_CACHE_COUNT_LIMIT};
-    int32_t            fCacheCount{0};
-    int32_t            fPointSizeLimit{SK_DEFAULT_FONT_CACHE_POINT_SIZE_LIMIT};
+    Shard                fShards[kShardCount];
+    std::atomic<size_t>  fTotalMemoryUsed{0};
+    std::atomic<int32_t> fCacheCount{0};
+    std::atomic<size_t>  fCacheSizeLimit{SK_DEFAULT_FONT_CACHE_LIMIT};
+    std::atomic<int32_t> fCacheCountLimit{SK_DEFAULT_FONT_CACHE_COUNT_LIMIT};
+    std::atomic<int32_t> fPointSizeLimit{SK_DEFAULT_FONT_CACHE_POINT_SIZE_LIMIT};
+    std::atomic<int32_t> fNextPurgeShard{0};
+    std::atomic<SkExecutor*> fRasterExecutor{nullptr};
 };
 
 using SkExclusiveStrikePtr = SkStrikeCache::ExclusiveStrikePtr;
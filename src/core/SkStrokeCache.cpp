@@ -0,0 +1,132 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkStrokeCache.h"
+
+#include "SkPathPriv.h"
+#include "SkPathRef.h"
+
+#include <cmath>
+
+// Stroking paths this small costs about as much as a cache lookup.
+#ifndef SK_STROKE_CACHE_MIN_POINTS
+    #define SK_STROKE_CACHE_MIN_POINTS 8
+#endif
+
+namespace {
+static unsigned gStrokeKeyNamespaceLabel;
+
+uint64_t shared_id_for_path(uint32_t pathGenID) {
+    uint64_t sharedID = SkSetFourByteTag('s', 't', 'r', 'k');
+    return (sharedID << 32) | pathGenID;
+}
+
+struct StrokeKey : public SkResourceCache::Key {
+public:
+    StrokeKey(const SkPath& path, const SkStrokeRec& rec)
+        : fFillType(path.getFillType())
+        , fRec(rec)
+    {
+        this->init(&gStrokeKeyNamespaceLabel, shared_id_for_path(path.getGenerationID()),
+                   sizeof(fFillType) + sizeof(fRec));
+    }
+
+    int32_t     fFillType;
+    SkStrokeRec fRec;
+};
+
+struct StrokeRec : public SkResourceCache::Rec {
+    StrokeRec(const StrokeKey& key, const SkPath& stroked) : fKey(key), fStroked(stroked) {}
+
+    StrokeKey fKey;
+    SkPath    fStroked;
+
+    const Key& getKey() const override { return fKey; }
+    size_t bytesUsed() const override {
+        return sizeof(*this) + fStroked.countPoints() * sizeof(SkPoint) + fStroked.countVerbs();
+    }
+    const char* getCategory() const override { return "stroke"; }
+    SkDiscardableMemory* diagnostic_only_getDiscardable() const override { return nullptr; }
+
+    static bool Visitor(const SkResourceCache::Rec& baseRec, void* contextData) {
+        const StrokeRec& rec = static_cast<const StrokeRec&>(baseRec);
+        *static_cast<SkPath*>(contextData) = rec.fStroked;
+        return true;
+    }
+};
+
+// Purges a path's outlines when its SkPathRef changes or is deleted.
+class StrokeInvalidator : public SkPathRef::GenIDChangeListener {
+public:
+    explicit StrokeInvalidator(uint64_t sharedID) : fSharedID(sharedID) {}
+
+private:
+    void onChange() override { SkResourceCache::PostPurgeSharedID(fSharedID); }
+
+    uint64_t fSharedID;
+};
+
+bool worth_caching(const SkPath& path) {
+    return !path.isVolatile() && path.countPoints() >= SK_STROKE_CACHE_MIN_POINTS;
+}
+
+} // namespace
+
+SkScalar SkStrokeCache::BucketResScale(SkScalar resScale) {
+    if (!(resScale > 0) || !SkScalarIsFinite(resScale)) {
+        return resScale;
+    }
+    int exp;
+    SkScalar mantissa = std::frexp(resScale, &exp);
+    // resScale is mantissa * 2^exp, with mantissa in [0.5, 1).
+    return 0.5f == mantissa ? resScale : std::ldexp(1.0f, exp);
+}
+
+bool SkStrokeCache::ApplyToPath(const SkStrokeRec& rec, const SkPath& src, SkPath* dst,
+                                SkResourceCache* localCache) {
+    if (!rec.needToApply() || !worth_caching(src)) {
+        return rec.applyToPath(dst, src);
+    }
+    StrokeKey key(src, rec);
+    SkPath stroked;
+    if (localCache ? localCache->find(key, StrokeRec::Visitor, &stroked)
+                   : SkResourceCache::Find(key, StrokeRec::Visitor, &stroked)) {
+        *dst = stroked;
+        return true;
+    }
+    if (!rec.applyToPath(&stroked, src)) {
+        return false;
+    }
+    auto* cacheRec = new StrokeRec(key, stroked);
+    if (localCache) {
+        localCache->add(cacheRec);
+    } else {
+        SkResourceCache::Add(cacheRec);
+    }
+    SkPathPriv::AddGenIDChangeListener(src, sk_make_sp<StrokeInvalidator>(key.getSharedID()));
+    *dst = std::move(stroked);
+    return true;
+}
+
+bool SkStrokeCache::GetFillPath(const SkPaint& paint, const SkPath& src, SkPath* dst,
+                                const SkRect* cullRect, SkScalar resScale) {
+    if (paint.getPathEffect() || !src.isFinite() || !worth_caching(src)) {
+        return paint.getFillPath(src, dst, cullRect, resScale);
+    }
+    SkStrokeRec rec(paint, BucketResScale(resScale));
+    if (!rec.needToApply()) {
+        return paint.getFillPath(src, dst, cullRect, resScale);
+    }
+    if (!ApplyToPath(rec, src, dst)) {
+        *dst = src;
+    }
+    if (!dst->isFinite()) {
+        dst->reset();
+        return false;
+    }
+    return true;
+}
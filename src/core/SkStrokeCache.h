@@ -0,0 +1,45 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkStrokeCache_DEFINED
+#define SkStrokeCache_DEFINED
+
+#include "SkPaint.h"
+#include "SkPath.h"
+#include "SkResourceCache.h"
+#include "SkStrokeRec.h"
+
+/**
+ *  Caches stroked outlines of immutable paths in SkResourceCache, keyed by the path's generation
+ *  ID and the stroke, so that drawing a path again with the same stroke needn't stroke it again.
+ *  Entries are purged when the path's SkPathRef changes or goes away.
+ */
+class SkStrokeCache {
+public:
+    /**
+     *  Returns the resScale to stroke with, so that nearby scales can share outlines: resScale
+     *  rounded up to a power of two, so that the outline is always at least as precise as asked.
+     */
+    static SkScalar BucketResScale(SkScalar resScale);
+
+    /**
+     *  Like SkStrokeRec::applyToPath(), but looks for the outline in the cache first, and adds it
+     *  after stroking if the path is worth caching.  The rec's resScale should be bucketed.
+     */
+    static bool ApplyToPath(const SkStrokeRec&, const SkPath& src, SkPath* dst,
+                            SkResourceCache* localCache = nullptr);
+
+    /**
+     *  Like SkPaint::getFillPath().  Strokes without a path effect go through the cache, with
+     *  resScale bucketed.  Path effects (dashes in particular) don't: their output is a new path
+     *  each time, and may depend on the cull rect.
+     */
+    static bool GetFillPath(const SkPaint&, const SkPath& src, SkPath* dst,
+                            const SkRect* cullRect, SkScalar resScale);
+};
+
+#endif
@@ -10,22 +10,40 @@
 
 SkTaskGroup::SkTaskGroup(SkExecutor& executor) : fPending(0), fExecutor(executor) {}
 
-void SkTaskGroup::add(std::function<void(void)> fn) {
+void SkTaskGroup::add(std::function<void(void)> fn, Priority priority) {
     fPending.fetch_add(+1, std::memory_order_relaxed);
-    fExecutor.add([=] {
+    fExecutor.addWithPriority([=] {
         fn();
         fPending.fetch_add(-1, std::memory_order_release);
-    });
+    }, priority);
 }
 
-void SkTaskGroup::batch(int N, std::function<void(int)> fn) {
-    // TODO: I really thought we had some sort of more clever chunking logic.
+void SkTaskGroup::batch(int N, std::function<void(int)> fn, Priority priority) {
+    // See parallelFor() for work that should be chunked.
     fPending.fetch_add(+N, std::memory_order_relaxed);
     for (int i = 0; i < N; i++) {
-        fExecutor.add([=] {
+        fExecutor.addWithPriority([=] {
             fn(i);
             fPending.fetch_add(-1, std::memory_order_release);
-        });
+        }, priority);
+    }
+}
+
+void SkTaskGroup::parallelFor(int N, int grain, std::function<void(int, int)> fn,
+                              Priority priority) {
+    if (N <= 0) {
+        return;
+    }
+    grain = SkTMax(grain, 1);
+    const int tasks = (N - 1) / grain + 1;
+    fPending.fetch_add(+tasks, std::memory_order_relaxed);
+    for (int i = 0; i < tasks; i++) {
+        const int start = i * grain,
+                  end   = SkTMin(N - start, grain) + start;
+        fExecutor.addWithPriority([=] {
+            fn(start, end);
+            fPending.fetch_add(-1, std::memory_order_release);
+        }, priority);
     }
 }
 
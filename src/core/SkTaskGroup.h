@@ -20,11 +20,18 @@ public:
     explicit SkTaskGroup(SkExecutor& executor = SkExecutor::GetDefault());
     ~SkTaskGroup() { this->wait(); }
 
+    using Priority = SkExecutor::Priority;
+
     // Add a task to this SkTaskGroup.
-    void add(std::function<void(void)> fn);
+    void add(std::function<void(void)> fn, Priority = Priority::kNormal);
 
     // Add a batch of N tasks, all calling fn with different arguments.
-    void batch(int N, std::function<void(int)> fn);
+    void batch(int N, std::function<void(int)> fn, Priority = Priority::kNormal);
+
+    // Calls fn(start, end) over [0, N) in tasks of grain (at least 1) indices each, so that
+    // work too small to be worth a task each is still spread over the executor.
+    void parallelFor(int N, int grain, std::function<void(int start, int end)> fn,
+                     Priority = Priority::kNormal);
 
     // Returns true if all Tasks previously add()ed to this SkTaskGroup have run.
     // It is safe to reuse this SkTaskGroup once done().
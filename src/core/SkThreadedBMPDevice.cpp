@@ -0,0 +1,384 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkThreadedBMPDevice.h"
+
+#include "SkDraw.h"
+#include "SkExecutor.h"
+#include "SkGlyphRun.h"
+#include "SkRTree.h"
+#include "SkSpecialImage.h"
+#include "SkTSort.h"
+#include "SkTaskGroup.h"
+#include "SkTextBlobPriv.h"
+#include "SkVertices.h"
+
+// Aim for bands this tall when the caller doesn't ask for a specific band count. Every band a draw
+// touches re-runs its geometry (only the blitting is split), so bands shouldn't get too thin.
+static constexpr int kDefaultBandHeight = 64;
+static constexpr int kMaxBandCount      = 256;
+
+static int pick_band_count(int height, int requested) {
+    int count = requested > 0 ? requested : (height + kDefaultBandHeight - 1) / kDefaultBandHeight;
+    return SkTPin(count, 1, SkTMax(1, SkTMin(height, kMaxBandCount)));
+}
+
+class SkThreadedBMPDevice::AutoDrawImmediately {
+public:
+    AutoDrawImmediately(SkThreadedBMPDevice* device)
+        : fDevice(device)
+        , fWasImmediate(device->fDrawImmediately) {
+        fDevice->flush();
+        fDevice->fDrawImmediately = true;
+    }
+    ~AutoDrawImmediately() { fDevice->fDrawImmediately = fWasImmediate; }
+
+private:
+    SkThreadedBMPDevice* fDevice;
+    bool                 fWasImmediate;
+};
+
+SkThreadedBMPDevice::SkThreadedBMPDevice(const SkBitmap& bitmap,
+                                         const SkSurfaceProps& surfaceProps,
+                                         SkExecutor* executor, int bandCount)
+    : INHERITED(bitmap, surfaceProps, nullptr, nullptr)
+    , fExecutor(executor ? executor : &SkExecutor::GetDefault())
+    , fBandCount(pick_band_count(bitmap.height(), bandCount)) {
+    // SkDraw can't handle devices this large on its own, only SkBitmapDevice's tiling can.
+    fDrawImmediately = this->needsDrawTiling();
+}
+
+SkThreadedBMPDevice::~SkThreadedBMPDevice() {
+    // The pixels may belong to someone else (e.g. a raster-direct surface), so they have to be
+    // complete by the time we go away.
+    this->flush();
+}
+
+const SkIRect* SkThreadedBMPDevice::computeDevBounds(const SkRect& localBounds,
+                                                     const SkPaint& paint, SkIRect* storage) {
+    if (!paint.canComputeFastBounds()) {
+        return nullptr;
+    }
+    SkRect devBounds;
+    this->ctm().mapRect(&devBounds, paint.computeFastBounds(localBounds, &devBounds));
+    if (!devBounds.isFinite()) {
+        return nullptr;
+    }
+    // Leave room for antialiasing and hairlines.
+    *storage = devBounds.roundOut().makeOutset(2, 2);
+    return storage;
+}
+
+bool SkThreadedBMPDevice::recordDraw(const SkIRect* devBounds, DrawFn&& drawFn) {
+    const SkRasterClip& rc = this->rasterClip();
+    SkIRect bounds = rc.getBounds();
+    if (devBounds && !bounds.intersect(*devBounds)) {
+        return false;
+    }
+    if (bounds.isEmpty()) {
+        return false;
+    }
+
+    // Consecutive draws usually share a clip, so only copy it when it changes.
+    if (fClips.empty() || !(fClips.back() == rc)) {
+        fClips.push_back(rc);
+    }
+    fQueue.push_back(DrawElement{std::move(drawFn), bounds, this->ctm(), fClips.count() - 1});
+    return true;
+}
+
+void SkThreadedBMPDevice::flush() {
+    if (fQueue.empty()) {
+        return;
+    }
+
+    // Accessing our pixels calls back into flush(), which must find nothing left to do.
+    SkTArray<DrawElement> queue;
+    queue.swap(fQueue);
+
+    SkPixmap dst;
+    if (!INHERITED::onAccessPixels(&dst)) {
+        fClips.reset();
+        fAlloc.reset();
+        return;
+    }
+
+    const int count = queue.count();
+    SkAutoTMalloc<SkRect> drawBounds(count);
+    for (int i = 0; i < count; ++i) {
+        drawBounds[i] = SkRect::Make(queue[i].fDrawBounds);
+    }
+    SkRTree bbh;
+    bbh.insert(drawBounds.get(), count);
+
+    const int bandHeight = (dst.height() + fBandCount - 1) / fBandCount;
+    const SkScalerContextFlags scalerFlags = this->scalerContextFlags();
+    auto drawBand = [&](int band) {
+        const SkIRect tile = SkIRect::MakeLTRB(0, band * bandHeight, dst.width(),
+                                               SkTMin((band + 1) * bandHeight, dst.height()));
+        if (tile.isEmpty()) {
+            return;
+        }
+
+        SkTDArray<int> hits;
+        bbh.search(SkRect::Make(tile), &hits);
+        if (hits.isEmpty()) {
+            return;
+        }
+        // Draws must land in the order they were made.
+        SkTQSort(hits.begin(), hits.end() - 1);
+
+        SkGlyphRunListPainter glyphPainter(this->surfaceProps(), dst.colorType(), scalerFlags);
+        for (int index : hits) {
+            const DrawElement& element = queue[index];
+            SkDraw draw;
+            draw.fDst = dst;
+            draw.fMatrix = &element.fMatrix;
+            draw.fRC = &fClips[element.fClipIndex];
+            draw.fTileClip = &tile;
+            element.fDrawFn(draw, &glyphPainter);
+        }
+    };
+
+    if (fBandCount == 1) {
+        drawBand(0);
+    } else {
+        SkTaskGroup(*fExecutor).batch(fBandCount, drawBand, SkExecutor::Priority::kFrameCritical);
+    }
+
+    queue.reset();
+    fClips.reset();
+    fAlloc.reset();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void SkThreadedBMPDevice::drawPaint(const SkPaint& paint) {
+    if (fDrawImmediately) {
+        return INHERITED::drawPaint(paint);
+    }
+    this->recordDraw(nullptr, [paint](const SkDraw& draw, SkGlyphRunListPainter*) {
+        draw.drawPaint(paint);
+    });
+}
+
+void SkThreadedBMPDevice::drawPoints(SkCanvas::PointMode mode, size_t count,
+                                     const SkPoint pts[], const SkPaint& paint) {
+    if (fDrawImmediately) {
+        return INHERITED::drawPoints(mode, count, pts, paint);
+    }
+    if (0 == count) {
+        return;
+    }
+    SkRect bounds;
+    bounds.setBounds(pts, SkToInt(count));
+    SkRect strokeBounds;
+    SkIRect storage;
+    const SkIRect* devBounds =
+            paint.canComputeFastBounds()
+                    ? this->computeDevBounds(paint.computeFastStrokeBounds(bounds, &strokeBounds),
+                                             SkPaint(), &storage)
+                    : nullptr;
+
+    SkPoint* ptsCopy = fAlloc.makeArrayDefault<SkPoint>(count);
+    memcpy(ptsCopy, pts, count * sizeof(SkPoint));
+    this->recordDraw(devBounds, [mode, count, ptsCopy, paint](const SkDraw& draw,
+                                                              SkGlyphRunListPainter*) {
+        draw.drawPoints(mode, count, ptsCopy, paint, nullptr);
+    });
+}
+
+void SkThreadedBMPDevice::drawRect(const SkRect& r, const SkPaint& paint) {
+    if (fDrawImmediately) {
+        return INHERITED::drawRect(r, paint);
+    }
+    SkIRect storage;
+    this->recordDraw(this->computeDevBounds(r, paint, &storage),
+                     [r, paint](const SkDraw& draw, SkGlyphRunListPainter*) {
+        draw.drawRect(r, paint);
+    });
+}
+
+void SkThreadedBMPDevice::drawRRect(const SkRRect& rrect, const SkPaint& paint) {
+    if (fDrawImmediately) {
+        return INHERITED::drawRRect(rrect, paint);
+    }
+#ifdef SK_IGNORE_BLURRED_RRECT_OPT
+    SkPath path;
+    path.addRRect(rrect);
+    this->drawPath(path, paint, true);
+#else
+    SkIRect storage;
+    this->recordDraw(this->computeDevBounds(rrect.getBounds(), paint, &storage),
+                     [rrect, paint](const SkDraw& draw, SkGlyphRunListPainter*) {
+        draw.drawRRect(rrect, paint);
+    });
+#endif
+}
+
+void SkThreadedBMPDevice::drawPath(const SkPath& path, const SkPaint& paint, bool pathIsMutable) {
+    if (fDrawImmediately) {
+        return INHERITED::drawPath(path, paint, pathIsMutable);
+    }
+    SkIRect storage;
+    const SkIRect* devBounds = path.isInverseFillType()
+                                       ? nullptr
+                                       : this->computeDevBounds(path.getBounds(), paint, &storage);
+    // The recorded copy is only ever drawn from one band at a time, but it is drawn more than
+    // once, so it can never be treated as mutable.
+    this->recordDraw(devBounds, [path, paint](const SkDraw& draw, SkGlyphRunListPainter*) {
+        draw.drawPath(path, paint, nullptr, false);
+    });
+}
+
+void SkThreadedBMPDevice::drawBitmap(const SkBitmap& bitmap, const SkMatrix& matrix,
+                                     const SkRect* dstOrNull, const SkPaint& paint) {
+    if (fDrawImmediately) {
+        return INHERITED::drawBitmap(bitmap, matrix, dstOrNull, paint);
+    }
+    if (!bitmap.isImmutable()) {
+        AutoDrawImmediately adi(this);
+        return INHERITED::drawBitmap(bitmap, matrix, dstOrNull, paint);
+    }
+
+    SkRect bounds;
+    if (dstOrNull) {
+        bounds = *dstOrNull;
+    } else {
+        matrix.mapRect(&bounds, SkRect::MakeIWH(bitmap.width(), bitmap.height()));
+    }
+    SkIRect storage;
+    const SkIRect* devBounds = this->computeDevBounds(bounds, paint, &storage);
+
+    bool hasDst = dstOrNull != nullptr;
+    SkRect dst = hasDst ? *dstOrNull : SkRect::MakeEmpty();
+    this->recordDraw(devBounds, [bitmap, matrix, hasDst, dst, paint](const SkDraw& draw,
+                                                                     SkGlyphRunListPainter*) {
+        draw.drawBitmap(bitmap, matrix, hasDst ? &dst : nullptr, paint);
+    });
+}
+
+void SkThreadedBMPDevice::drawSprite(const SkBitmap& bitmap, int x, int y, const SkPaint& paint) {
+    if (fDrawImmediately) {
+        return INHERITED::drawSprite(bitmap, x, y, paint);
+    }
+    if (!bitmap.isImmutable()) {
+        AutoDrawImmediately adi(this);
+        return INHERITED::drawSprite(bitmap, x, y, paint);
+    }
+
+    // Sprites are drawn in device space, ignoring the matrix.
+    SkIRect bounds = SkIRect::MakeXYWH(x, y, bitmap.width(), bitmap.height());
+    SkIRect* devBounds = &bounds;
+    if (paint.getMaskFilter()) {
+        devBounds = nullptr;
+    }
+    this->recordDraw(devBounds, [bitmap, x, y, paint](const SkDraw& draw, SkGlyphRunListPainter*) {
+        draw.drawSprite(bitmap, x, y, paint);
+    });
+}
+
+void SkThreadedBMPDevice::drawBitmapRect(const SkBitmap& bitmap, const SkRect* src,
+                                         const SkRect& dst, const SkPaint& paint,
+                                         SkCanvas::SrcRectConstraint constraint) {
+    // SkBitmapDevice may wrap the bitmap in a shader without copying it, so mutable bitmaps
+    // have to be drawn before the caller gets a chance to change them.
+    if (!fDrawImmediately && !bitmap.isImmutable()) {
+        AutoDrawImmediately adi(this);
+        return INHERITED::drawBitmapRect(bitmap, src, dst, paint, constraint);
+    }
+    INHERITED::drawBitmapRect(bitmap, src, dst, paint, constraint);
+}
+
+void SkThreadedBMPDevice::drawGlyphRunList(const SkGlyphRunList& glyphRunList) {
+    if (fDrawImmediately) {
+        return INHERITED::drawGlyphRunList(glyphRunList);
+    }
+
+    // The glyph run list only lives as long as this call, so copy the glyphs and positions.
+    // Text and clusters are only used by document backends and are dropped.
+    std::vector<SkGlyphRun> runs;
+    runs.reserve(glyphRunList.size());
+    for (const SkGlyphRun& run : glyphRunList) {
+        const size_t glyphCount = run.runSize();
+        SkGlyphID* glyphIDs = fAlloc.makeArrayDefault<SkGlyphID>(glyphCount);
+        SkPoint* positions = fAlloc.makeArrayDefault<SkPoint>(glyphCount);
+        memcpy(glyphIDs, run.glyphsIDs().data(), glyphCount * sizeof(SkGlyphID));
+        memcpy(positions, run.positions().data(), glyphCount * sizeof(SkPoint));
+        runs.emplace_back(run.paint(), SkRunFont(run.paint()),
+                          SkSpan<const SkPoint>{positions, glyphCount},
+                          SkSpan<const SkGlyphID>{glyphIDs, glyphCount},
+                          SkSpan<const char>{}, SkSpan<const uint32_t>{});
+    }
+
+    SkPaint paint(glyphRunList.paint());
+    SkPoint origin = glyphRunList.origin();
+    this->recordDraw(nullptr, [paint, origin, runs{std::move(runs)}](
+                                      const SkDraw& draw, SkGlyphRunListPainter* painter) {
+        SkGlyphRunList list(paint, nullptr, origin,
+                            SkSpan<const SkGlyphRun>{runs.data(), runs.size()});
+        draw.drawGlyphRunList(list, painter);
+    });
+}
+
+void SkThreadedBMPDevice::drawVertices(const SkVertices* vertices, const SkVertices::Bone bones[],
+                                       int boneCount, SkBlendMode bmode, const SkPaint& paint) {
+    if (fDrawImmediately) {
+        return INHERITED::drawVertices(vertices, bones, boneCount, bmode, paint);
+    }
+
+    SkIRect storage;
+    // Bones move the vertices around, so the recorded bounds aren't useful.
+    const SkIRect* devBounds = boneCount ? nullptr
+                                         : this->computeDevBounds(vertices->bounds(), paint,
+                                                                  &storage);
+    SkVertices::Bone* bonesCopy = nullptr;
+    if (boneCount) {
+        bonesCopy = fAlloc.makeArrayDefault<SkVertices::Bone>(boneCount);
+        memcpy(bonesCopy, bones, boneCount * sizeof(SkVertices::Bone));
+    }
+    sk_sp<SkVertices> verts = sk_ref_sp(const_cast<SkVertices*>(vertices));
+    this->recordDraw(devBounds, [verts, bonesCopy, boneCount, bmode, paint](
+                                        const SkDraw& draw, SkGlyphRunListPainter*) {
+        draw.drawVertices(verts->mode(), verts->vertexCount(), verts->positions(),
+                          verts->texCoords(), verts->colors(), verts->boneIndices(),
+                          verts->boneWeights(), bmode, verts->indices(), verts->indexCount(),
+                          paint, bonesCopy, boneCount);
+    });
+}
+
+void SkThreadedBMPDevice::drawDevice(SkBaseDevice* device, int x, int y, const SkPaint& paint) {
+    // Layers are composited from a bitmap that dies with the layer, and the coverage path reads
+    // our own pixels directly, so draw them right away.
+    AutoDrawImmediately adi(this);
+    INHERITED::drawDevice(device, x, y, paint);
+}
+
+sk_sp<SkSpecialImage> SkThreadedBMPDevice::snapSpecial() {
+    this->flush();
+    return INHERITED::snapSpecial();
+}
+
+bool SkThreadedBMPDevice::onReadPixels(const SkPixmap& pm, int x, int y) {
+    this->flush();
+    return INHERITED::onReadPixels(pm, x, y);
+}
+
+bool SkThreadedBMPDevice::onWritePixels(const SkPixmap& pm, int x, int y) {
+    this->flush();
+    return INHERITED::onWritePixels(pm, x, y);
+}
+
+bool SkThreadedBMPDevice::onPeekPixels(SkPixmap* pm) {
+    this->flush();
+    return INHERITED::onPeekPixels(pm);
+}
+
+bool SkThreadedBMPDevice::onAccessPixels(SkPixmap* pm) {
+    this->flush();
+    return INHERITED::onAccessPixels(pm);
+}
@@ -0,0 +1,101 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkThreadedBMPDevice_DEFINED
+#define SkThreadedBMPDevice_DEFINED
+
+#include "SkArenaAlloc.h"
+#include "SkBitmapDevice.h"
+#include "SkRasterClip.h"
+#include "SkTArray.h"
+
+#include <functional>
+
+class SkExecutor;
+
+/**
+ *  An SkBitmapDevice that records draws instead of rasterizing them immediately. When the pixels
+ *  are needed (peek/read/write/access, snapSpecial, flush() or destruction), the recorded draws
+ *  are binned into full-width horizontal bands with an SkRTree and each band is rasterized on its
+ *  own task.
+ *
+ *  Every draw is rasterized against its original clip in every band it touches and only the
+ *  pixels written are restricted to the band (see SkDraw::fTileClip), so the result is identical
+ *  to drawing into a plain SkBitmapDevice.
+ *
+ *  Draws whose inputs could change after the call returns (e.g. mutable bitmaps) flush and are
+ *  drawn immediately on the calling thread.
+ */
+class SkThreadedBMPDevice : public SkBitmapDevice {
+public:
+    // When executor is null, SkExecutor::GetDefault() is used.
+    // When bandCount is <= 0, a band count is picked based on the height of the bitmap.
+    SkThreadedBMPDevice(const SkBitmap& bitmap, const SkSurfaceProps& surfaceProps,
+                        SkExecutor* executor = nullptr, int bandCount = 0);
+    ~SkThreadedBMPDevice() override;
+
+    void flush() override;
+
+    int bandCount() const { return fBandCount; }
+
+protected:
+    void drawPaint(const SkPaint&) override;
+    void drawPoints(SkCanvas::PointMode, size_t count, const SkPoint[], const SkPaint&) override;
+    void drawRect(const SkRect&, const SkPaint&) override;
+    void drawRRect(const SkRRect&, const SkPaint&) override;
+    void drawPath(const SkPath&, const SkPaint&, bool pathIsMutable) override;
+    using SkBitmapDevice::drawBitmap;
+    void drawBitmap(const SkBitmap&, const SkMatrix&, const SkRect* dstOrNull,
+                    const SkPaint&) override;
+    void drawSprite(const SkBitmap&, int x, int y, const SkPaint&) override;
+    void drawBitmapRect(const SkBitmap&, const SkRect*, const SkRect&,
+                        const SkPaint&, SkCanvas::SrcRectConstraint) override;
+    void drawGlyphRunList(const SkGlyphRunList&) override;
+    void drawVertices(const SkVertices*, const SkVertices::Bone bones[], int boneCount, SkBlendMode,
+                      const SkPaint&) override;
+    void drawDevice(SkBaseDevice*, int x, int y, const SkPaint&) override;
+
+    sk_sp<SkSpecialImage> snapSpecial() override;
+
+    bool onReadPixels(const SkPixmap&, int x, int y) override;
+    bool onWritePixels(const SkPixmap&, int, int) override;
+    bool onPeekPixels(SkPixmap*) override;
+    bool onAccessPixels(SkPixmap*) override;
+
+private:
+    using DrawFn = std::function<void(const SkDraw&, SkGlyphRunListPainter*)>;
+
+    struct DrawElement {
+        DrawFn   fDrawFn;
+        SkIRect  fDrawBounds;   // device space, already intersected with the clip bounds
+        SkMatrix fMatrix;
+        int      fClipIndex;
+    };
+
+    // Returns true if something was recorded, false if the draw can be skipped entirely.
+    // devBounds is a conservative device space bound of the draw, null means unbounded.
+    bool recordDraw(const SkIRect* devBounds, DrawFn&&);
+
+    // Device space bounds of drawing localBounds with paint and the current matrix, or null if
+    // they can't be computed.
+    const SkIRect* computeDevBounds(const SkRect& localBounds, const SkPaint&, SkIRect* storage);
+
+    // While fDrawImmediately is set, every draw goes straight to SkBitmapDevice.
+    class AutoDrawImmediately;
+
+    SkExecutor*              fExecutor;
+    int                      fBandCount;
+    bool                     fDrawImmediately = false;
+
+    SkTArray<DrawElement>    fQueue;
+    SkTArray<SkRasterClip>   fClips;
+    SkArenaAlloc             fAlloc{4096};  // holds copies of point and glyph arrays
+
+    typedef SkBitmapDevice INHERITED;
+};
+
+#endif // SkThreadedBMPDevice_DEFINED
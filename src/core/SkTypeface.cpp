@@ -17,6 +17,8 @@
 #include "SkSurfacePriv.h"
 #include "SkTypeface.h"
 #include "SkTypefaceCache.h"
+#include "SkUnicharToGlyphCache.h"
+#include "SkUtils.h"
 
 SkTypeface::SkTypeface(const SkFontStyle& style, bool isFixedPitch)
     : fUniqueID(SkTypefaceCache::NewFontID()), fStyle(style), fIsFixedPitch(isFixedPitch) { }
@@ -295,12 +297,99 @@ int SkTypeface::charsToGlyphs(const void* chars, Encoding encoding,
         }
         return 0;
     }
-    return this->onCharsToGlyphs(chars, encoding, glyphs, glyphCount);
+
+    // Decode and map the characters in chunks, so the glyphs can come from cached pages.
+    constexpr int kChunkSize = 256;
+    SkUnichar unichars[kChunkSize];
+    SkGlyphID scratch[kChunkSize];
+    const char* utf8 = (const char*)chars;
+    const uint16_t* utf16 = (const uint16_t*)chars;
+    const SkUnichar* utf32 = (const SkUnichar*)chars;
+    int firstMissing = glyphCount;
+    for (int start = 0; start < glyphCount; start += kChunkSize) {
+        int count = SkTMin(glyphCount - start, kChunkSize);
+        switch (encoding) {
+            case kUTF8_Encoding:
+                for (int i = 0; i < count;) {
+                    // Each of the remaining characters is at least one byte, so this stays in
+                    // the text.
+                    int ascii = (int)SkUTF::CountASCII(utf8, count - i);
+                    for (int j = 0; j < ascii; ++j) {
+                        unichars[i++] = (uint8_t)*utf8++;
+                    }
+                    if (i < count) {
+                        unichars[i++] = SkUTF8_NextUnichar(&utf8);
+                    }
+                }
+                break;
+            case kUTF16_Encoding:
+                for (int i = 0; i < count; ++i) {
+                    uint16_t c = *utf16;
+                    if (!SkUTF16_IsLeadingSurrogate(c) && !SkUTF16_IsTrailingSurrogate(c)) {
+                        unichars[i] = c;
+                        ++utf16;
+                    } else {
+                        unichars[i] = SkUTF16_NextUnichar(&utf16);
+                    }
+                }
+                break;
+            case kUTF32_Encoding:
+                memcpy(unichars, utf32, count * sizeof(SkUnichar));
+                utf32 += count;
+                break;
+        }
+
+        SkGlyphID* dst = glyphs ? glyphs + start : scratch;
+        this->unicharsToGlyphs(unichars, count, dst);
+        if (firstMissing == glyphCount) {
+            for (int i = 0; i < count; ++i) {
+                if (0 == dst[i]) {
+                    firstMissing = start + i;
+                    break;
+                }
+            }
+            if (!glyphs && firstMissing < glyphCount) {
+                break;
+            }
+        }
+    }
+    return firstMissing;
+}
+
+void SkTypeface::unicharsToGlyphs(const SkUnichar unichars[], int count,
+                                  SkGlyphID glyphs[]) const {
+    fUnicharToGlyphCacheOnce([this] {
+        fUnicharToGlyphCache = skstd::make_unique<SkUnicharToGlyphCache>();
+    });
+    SkUnicharToGlyphCache* cache = fUnicharToGlyphCache.get();
+
+    for (int i = 0; i < count; ++i) {
+        SkUnichar uni = unichars[i];
+        if (uni < 0 || uni >= 0x10000) {
+            // Characters outside of the BMP are rare enough to look up one at a time.
+            this->onCharsToGlyphs(&uni, kUTF32_Encoding, &glyphs[i], 1);
+            continue;
+        }
+        const SkGlyphID* page = cache->findPage(uni);
+        if (!page) {
+            constexpr int kPageSize = SkUnicharToGlyphCache::kPageSize;
+            SkUnichar pageUnichars[kPageSize];
+            SkUnichar first = uni & ~(kPageSize - 1);
+            for (int j = 0; j < kPageSize; ++j) {
+                pageUnichars[j] = first + j;
+            }
+            std::unique_ptr<SkGlyphID[]> pageGlyphs(new SkGlyphID[kPageSize]);
+            this->onCharsToGlyphs(pageUnichars, kUTF32_Encoding, pageGlyphs.get(), kPageSize);
+            page = cache->setPage(uni, std::move(pageGlyphs));
+        }
+        glyphs[i] = page[uni & (SkUnicharToGlyphCache::kPageSize - 1)];
+    }
 }
 
 SkGlyphID SkTypeface::unicharToGlyph(SkUnichar uni) const {
-    SkGlyphID glyphs[1];
-    return this->onCharsToGlyphs(&uni, kUTF32_Encoding, glyphs, 1) == 1 ? glyphs[0] : 0;
+    SkGlyphID glyph;
+    this->unicharsToGlyphs(&uni, 1, &glyph);
+    return glyph;
 }
 
 int SkTypeface::countGlyphs() const {
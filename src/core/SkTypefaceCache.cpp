@@ -7,6 +7,7 @@
 
 #include "SkTypefaceCache.h"
 #include "SkMutex.h"
+#include "SkSharedMutex.h"
 #include <atomic>
 
 #define TYPEFACE_CACHE_LIMIT    1024
@@ -30,24 +31,26 @@ SkTypeface* SkTypefaceCache::findByProcAndRef(FindProc proc, void* ctx) const {
     return nullptr;
 }
 
-void SkTypefaceCache::purge(int numToPurge) {
+int SkTypefaceCache::purge(int numToPurge) {
     int count = fTypefaces.count();
     int i = 0;
+    int purged = 0;
     while (i < count) {
         if (fTypefaces[i]->unique()) {
             fTypefaces.removeShuffle(i);
             --count;
-            if (--numToPurge == 0) {
-                return;
+            if (++purged == numToPurge) {
+                break;
             }
         } else {
             ++i;
         }
     }
+    return purged;
 }
 
-void SkTypefaceCache::purgeAll() {
-    this->purge(fTypefaces.count());
+int SkTypefaceCache::purgeAll() {
+    return this->purge(fTypefaces.count());
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -62,21 +65,25 @@ SkFontID SkTypefaceCache::NewFontID() {
     return nextID++;
 }
 
-SK_DECLARE_STATIC_MUTEX(gMutex);
+// Lookups far outnumber additions, so they share the lock and only wait for Add() and purges.
+static SkDistributedSharedMutex& global_lock() {
+    static SkDistributedSharedMutex* gLock = new SkDistributedSharedMutex;
+    return *gLock;
+}
 
 void SkTypefaceCache::Add(SkTypeface* face) {
-    SkAutoMutexAcquire ama(gMutex);
+    SkAutoExclusive lock(global_lock());
     Get().add(face);
 }
 
 SkTypeface* SkTypefaceCache::FindByProcAndRef(FindProc proc, void* ctx) {
-    SkAutoMutexAcquire ama(gMutex);
+    SkAutoSharedMutexShared lock(global_lock());
     return Get().findByProcAndRef(proc, ctx);
 }
 
-void SkTypefaceCache::PurgeAll() {
-    SkAutoMutexAcquire ama(gMutex);
-    Get().purgeAll();
+int SkTypefaceCache::PurgeAll() {
+    SkAutoExclusive lock(global_lock());
+    return Get().purgeAll();
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -44,9 +44,9 @@ public:
      *  This will unref all of the typefaces in the cache for which the cache
      *  is the only owner. Normally this is handled automatically as needed.
      *  This function is exposed for clients that explicitly want to purge the
-     *  cache (e.g. to look for leaks).
+     *  cache (e.g. to look for leaks). Returns the number of typefaces removed.
      */
-    void purgeAll();
+    int purgeAll();
 
     /**
      *  Helper: returns a unique fontID to pass to the constructor of
@@ -58,7 +58,7 @@ public:
 
     static void Add(SkTypeface*);
     static SkTypeface* FindByProcAndRef(FindProc proc, void* ctx);
-    static void PurgeAll();
+    static int PurgeAll();
 
     /**
      *  Debugging only: dumps the status of the typefaces in the cache
@@ -68,7 +68,7 @@ public:
 private:
     static SkTypefaceCache& Get();
 
-    void purge(int count);
+    int purge(int count);
 
     SkTArray<sk_sp<SkTypeface>> fTypefaces;
 };
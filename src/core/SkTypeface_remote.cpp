@@ -48,6 +48,7 @@ void SkScalerContextProxy::generateMetrics(SkGlyph* glyph) {
     }
 
     glyph->fMaskFormat = fRec.fMaskFormat;
+    this->requestGlyph(glyph->getPackedID(), false);
 
     // Since the scaler context is being called, we don't have the needed data. Try to find a
     // fallback before failing.
@@ -81,6 +82,7 @@ void SkScalerContextProxy::generateImage(const SkGlyph& glyph) {
 
     // There is no desperation search here, because if there was an image to be found it was
     // copied over with the metrics search.
+    this->requestGlyph(glyph.getPackedID(), false);
     fDiscardableManager->notifyCacheMiss(SkStrikeClient::CacheMissType::kGlyphImage);
 }
 
@@ -90,6 +92,8 @@ bool SkScalerContextProxy::generatePath(SkGlyphID glyphID, SkPath* path) {
         SkDebugf("GlyphCacheMiss generatePath: %s\n", this->getRec().dump().c_str());
     }
 
+    this->requestGlyph(SkPackedGlyphID(glyphID), true);
+
     // Since the scaler context is being called, we don't have the needed data. Try to find a
     // fallback before failing.
     auto desc = SkScalerContext::DescriptorGivenRecAndEffects(this->getRec(), this->getEffects());
@@ -113,6 +117,14 @@ void SkScalerContextProxy::generateFontMetrics(SkFontMetrics* metrics) {
     sk_bzero(metrics, sizeof(*metrics));
 }
 
+void SkScalerContextProxy::requestGlyph(SkPackedGlyphID glyphID, bool asPath) {
+    SkStrikeClient::GlyphRequests* requests = this->getProxyTypeface()->glyphRequests();
+    if (requests && fCache) {
+        requests->add(fCache->getDescriptor(), this->getProxyTypeface()->remoteTypefaceID(),
+                      glyphID, asPath);
+    }
+}
+
 SkTypefaceProxy* SkScalerContextProxy::getProxyTypeface() const {
     return (SkTypefaceProxy*)this->getTypeface();
 }
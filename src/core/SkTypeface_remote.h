@@ -12,6 +12,7 @@
 #include "SkDescriptor.h"
 #include "SkFontDescriptor.h"
 #include "SkFontStyle.h"
+#include "SkMutex.h"
 #include "SkPaint.h"
 #include "SkRemoteGlyphCache.h"
 #include "SkScalerContext.h"
@@ -20,6 +21,35 @@
 class SkTypefaceProxy;
 class SkStrikeCache;
 
+// Glyphs the client found missing from the strikes sent by the server, to be requested from the
+// server in one message by SkStrikeClient::writeGlyphRequests(). Scaler contexts on any thread
+// may add to it.
+class SkStrikeClient::GlyphRequests : public SkRefCnt {
+public:
+    // clientDesc is the descriptor of the client's strike, remoteFontID the server's id for its
+    // typeface.
+    void add(const SkDescriptor& clientDesc, SkFontID remoteFontID, SkPackedGlyphID glyphID,
+             bool asPath);
+
+    // Writes all the requests and forgets them. Nothing is written if there are none.
+    // Returns the number of glyphs requested.
+    int write(Serializer* serializer);
+
+private:
+    struct Strike {
+        explicit Strike(const SkDescriptor& serverDesc) : fServerDesc{serverDesc} {}
+
+        SkAutoDescriptor             fServerDesc;
+        SkTHashSet<SkPackedGlyphID>  fImageSet;
+        SkTHashSet<SkPackedGlyphID>  fPathSet;
+        std::vector<SkPackedGlyphID> fImages;
+        std::vector<SkPackedGlyphID> fPaths;
+    };
+
+    SkMutex                                  fMutex;
+    SkDescriptorMap<std::unique_ptr<Strike>> fStrikes;
+};
+
 class SkScalerContextProxy : public SkScalerContext {
 public:
     SkScalerContextProxy(sk_sp<SkTypeface> tf,
@@ -40,6 +70,9 @@ protected:
     SkTypefaceProxy* getProxyTypeface() const;
 
 private:
+    // Asks the client to request glyphID from the server the next time it writes its requests.
+    void requestGlyph(SkPackedGlyphID glyphID, bool asPath);
+
     sk_sp<SkStrikeClient::DiscardableHandleManager> fDiscardableManager;
     SkGlyphCache* fCache = nullptr;
     SkStrikeCache* fStrikeCache = nullptr;
@@ -53,15 +86,18 @@ public:
                     const SkFontStyle& style,
                     bool isFixed,
                     sk_sp<SkStrikeClient::DiscardableHandleManager> manager,
-                    bool isLogging = true)
+                    bool isLogging = true,
+                    sk_sp<SkStrikeClient::GlyphRequests> glyphRequests = nullptr)
             : INHERITED{style, false}
             , fFontId{fontId}
             , fGlyphCount{glyphCount}
             , fIsLogging{isLogging}
-            , fDiscardableManager{std::move(manager)} {}
+            , fDiscardableManager{std::move(manager)}
+            , fGlyphRequests{std::move(glyphRequests)} {}
     SkFontID remoteTypefaceID() const {return fFontId;}
     int glyphCount() const {return fGlyphCount;}
     bool isLogging() const {return fIsLogging;}
+    SkStrikeClient::GlyphRequests* glyphRequests() const {return fGlyphRequests.get();}
 
 protected:
     int onGetUPEM() const override { SK_ABORT("Should never be called."); return 0; }
@@ -142,7 +178,7 @@ private:
     const int                                       fGlyphCount;
     const bool                                      fIsLogging;
     sk_sp<SkStrikeClient::DiscardableHandleManager> fDiscardableManager;
-
+    sk_sp<SkStrikeClient::GlyphRequests>            fGlyphRequests;
 
     typedef SkTypeface INHERITED;
 };
@@ -0,0 +1,49 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkUnicharToGlyphCache.h"
+
+static const SkGlyphID gEmptyPage[SkUnicharToGlyphCache::kPageSize] = {};
+
+SkUnicharToGlyphCache::SkUnicharToGlyphCache() {
+    for (auto& page : fPages) {
+        page.store(nullptr, std::memory_order_relaxed);
+    }
+}
+
+SkUnicharToGlyphCache::~SkUnicharToGlyphCache() {
+    for (auto& page : fPages) {
+        const SkGlyphID* glyphs = page.load(std::memory_order_relaxed);
+        if (glyphs != gEmptyPage) {
+            delete[] glyphs;
+        }
+    }
+}
+
+const SkGlyphID* SkUnicharToGlyphCache::setPage(SkUnichar uni,
+                                                 std::unique_ptr<SkGlyphID[]> glyphs) {
+    SkASSERT(uni >= 0 && uni < 0x10000);
+    const SkGlyphID* page = glyphs.get();
+    bool empty = true;
+    for (int i = 0; i < kPageSize && empty; ++i) {
+        empty = 0 == glyphs[i];
+    }
+    if (empty) {
+        page = gEmptyPage;
+    }
+
+    const SkGlyphID* expected = nullptr;
+    if (fPages[uni >> kPageBits].compare_exchange_strong(expected, page,
+                                                          std::memory_order_acq_rel,
+                                                          std::memory_order_acquire)) {
+        if (!empty) {
+            glyphs.release();
+        }
+        return page;
+    }
+    return expected;
+}
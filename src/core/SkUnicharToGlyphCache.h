@@ -0,0 +1,46 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkUnicharToGlyphCache_DEFINED
+#define SkUnicharToGlyphCache_DEFINED
+
+#include "SkTypes.h"
+
+#include <atomic>
+#include <memory>
+
+/**
+ * A typeface's map from the Basic Multilingual Plane to its glyph IDs, as 256 pages of 256
+ * glyphs. A page is filled in one batch the first time one of its characters is looked up, and
+ * is then read without locking by every thread using the typeface. Pages with no glyphs at all
+ * share one page of zeros.
+ */
+class SkUnicharToGlyphCache {
+public:
+    static constexpr int kPageBits = 8;
+    static constexpr int kPageSize = 1 << kPageBits;
+    static constexpr int kPageCount = 0x10000 >> kPageBits;
+
+    SkUnicharToGlyphCache();
+    ~SkUnicharToGlyphCache();
+
+    // Returns the page holding 'uni', which must be in the BMP, or null if it isn't filled yet.
+    const SkGlyphID* findPage(SkUnichar uni) const {
+        SkASSERT(uni >= 0 && uni < 0x10000);
+        return fPages[uni >> kPageBits].load(std::memory_order_acquire);
+    }
+
+    // Publishes the page holding 'uni', whose glyphs are those of the characters
+    // (uni & ~(kPageSize - 1)) + i. Returns the page to use, which is another thread's if it
+    // published the same page first.
+    const SkGlyphID* setPage(SkUnichar uni, std::unique_ptr<SkGlyphID[]> glyphs);
+
+private:
+    std::atomic<const SkGlyphID*> fPages[kPageCount];
+};
+
+#endif
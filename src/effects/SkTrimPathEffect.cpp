@@ -6,6 +6,7 @@
  */
 
 #include "SkPathMeasure.h"
+#include "SkPathMeasureCache.h"
 #include "SkTrimPathEffect.h"
 #include "SkTrimPE.h"
 #include "SkReadBuffer.h"
@@ -16,8 +17,9 @@ namespace {
 class Segmentator : public SkNoncopyable {
 public:
     Segmentator(const SkPath& src, SkPath* dst)
-        : fMeasure(src, false)
-        , fDst(dst) {}
+        : fDst(dst) {
+        SkPathMeasureCache::SetPath(&fMeasure, src, false);
+    }
 
     void add(SkScalar start, SkScalar stop) {
         SkASSERT(start < stop);
@@ -60,9 +62,11 @@ bool SkTrimPE::onFilterPath(SkPath* dst, const SkPath& src, SkStrokeRec* rec,
         return true;
     }
 
-    // First pass: compute the total len.
+    // First pass: compute the total len.  Both passes share src's cached measurements, as trims
+    // are usually animated over the same path.
     SkScalar len = 0;
-    SkPathMeasure meas(src, false);
+    SkPathMeasure meas;
+    SkPathMeasureCache::SetPath(&meas, src, false);
     do {
         len += meas.getLength();
     } while (meas.nextContour());
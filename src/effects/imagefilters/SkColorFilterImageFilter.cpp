@@ -9,6 +9,7 @@
 
 #include "SkCanvas.h"
 #include "SkColorFilter.h"
+#include "SkColorMatrix.h"
 #include "SkColorSpaceXformer.h"
 #include "SkImageFilterPriv.h"
 #include "SkReadBuffer.h"
@@ -29,12 +30,20 @@ sk_sp<SkImageFilter> SkColorFilterImageFilter::Make(sk_sp<SkColorFilter> cf,
         // colorfilters into a single one, which the new imagefilter will wrap.
         sk_sp<SkColorFilter> newCF = cf->makeComposed(sk_sp<SkColorFilter>(inputCF));
         if (newCF) {
-            return sk_sp<SkImageFilter>(new SkColorFilterImageFilter(std::move(newCF),
-                                                                     sk_ref_sp(input->getInput(0)),
-                                                                     cropRect));
+            cf = std::move(newCF);
+            input = sk_ref_sp(input->getInput(0));
         }
     }
 
+    // Likewise, a color matrix that changes nothing (e.g. one that undoes the filter it was
+    // combined with) can be dropped, leaving the input.
+    SkColorMatrix matrix, identity;
+    identity.setIdentity();
+    if (input && (!cropRect || !cropRect->flags()) && cf->asColorMatrix(matrix.fMat) &&
+        matrix == identity) {
+        return input;
+    }
+
     return sk_sp<SkImageFilter>(new SkColorFilterImageFilter(std::move(cf),
                                                              std::move(input),
                                                              cropRect));
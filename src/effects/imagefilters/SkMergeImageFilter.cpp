@@ -44,7 +44,9 @@ sk_sp<SkSpecialImage> SkMergeImageFilter::onFilterImage(SkSpecialImage* source,
     // Filter all of the inputs.
     for (int i = 0; i < inputCount; ++i) {
         offsets[i] = { 0, 0 };
-        inputs[i] = this->filterInput(i, source, ctx, &offsets[i]);
+    }
+    this->filterInputs(source, ctx, inputs.get(), offsets.get());
+    for (int i = 0; i < inputCount; ++i) {
         if (!inputs[i]) {
             continue;
         }
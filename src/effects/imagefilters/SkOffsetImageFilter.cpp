@@ -28,6 +28,10 @@ sk_sp<SkImageFilter> SkOffsetImageFilter::Make(SkScalar dx, SkScalar dy,
     if (!SkScalarIsFinite(dx) || !SkScalarIsFinite(dy)) {
         return nullptr;
     }
+    if (0 == dx && 0 == dy && input && (!cropRect || !cropRect->flags())) {
+        // Moving the input by nothing leaves it as it is.
+        return input;
+    }
 
     return sk_sp<SkImageFilter>(new SkOffsetImageFilter(dx, dy, std::move(input), cropRect));
 }
@@ -106,6 +110,14 @@ SkIRect SkOffsetImageFilter::onFilterNodeBounds(const SkIRect& src, const SkMatr
     return src.makeOffset(vec.fX, vec.fY);
 }
 
+bool SkOffsetImageFilter::onIsOffsetNode(SkVector* offset) const {
+    if (this->cropRectIsSet()) {
+        return false;
+    }
+    *offset = fOffset;
+    return true;
+}
+
 sk_sp<SkFlattenable> SkOffsetImageFilter::CreateProc(SkReadBuffer& buffer) {
     SK_IMAGEFILTER_UNFLATTEN_COMMON(common, 1);
     SkPoint offset;
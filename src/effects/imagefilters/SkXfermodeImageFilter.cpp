@@ -111,11 +111,15 @@ void SkXfermodeImageFilter_Base::flatten(SkWriteBuffer& buffer) const {
 sk_sp<SkSpecialImage> SkXfermodeImageFilter_Base::onFilterImage(SkSpecialImage* source,
                                                                 const Context& ctx,
                                                                 SkIPoint* offset) const {
-    SkIPoint backgroundOffset = SkIPoint::Make(0, 0);
-    sk_sp<SkSpecialImage> background(this->filterInput(0, source, ctx, &backgroundOffset));
+    sk_sp<SkSpecialImage> inputs[2];
+    SkIPoint inputOffsets[2] = { SkIPoint::Make(0, 0), SkIPoint::Make(0, 0) };
+    this->filterInputs(source, ctx, inputs, inputOffsets);
 
-    SkIPoint foregroundOffset = SkIPoint::Make(0, 0);
-    sk_sp<SkSpecialImage> foreground(this->filterInput(1, source, ctx, &foregroundOffset));
+    SkIPoint backgroundOffset = inputOffsets[0];
+    sk_sp<SkSpecialImage> background(std::move(inputs[0]));
+
+    SkIPoint foregroundOffset = inputOffsets[1];
+    sk_sp<SkSpecialImage> foreground(std::move(inputs[1]));
 
     SkIRect foregroundBounds = SkIRect::EmptyIRect();
     if (foreground) {
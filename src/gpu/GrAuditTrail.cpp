@@ -6,6 +6,7 @@
  */
 
 #include "GrAuditTrail.h"
+#include "GrGpu.h"
 #include "ops/GrOp.h"
 
 const int GrAuditTrail::kGrAuditTrailInvalidID = -1;
@@ -82,6 +83,44 @@ void GrAuditTrail::opsCombined(const GrOp* consumer, const GrOp* consumed) {
     // NOTE: because we can't change the shape of the oplist, we use a sentinel
     fOpList[consumedIndex].reset(nullptr);
     fIDLookup.remove(consumed->uniqueID());
+    ++fNumOpsMerged;
+}
+
+void GrAuditTrail::opChainTimed(const GrOp* head, GrGpu* gpu, GrTimerQuery query) {
+    SkASSERT(query);
+    SkASSERT(!fTimerGpu || fTimerGpu == gpu);
+    fTimerGpu = gpu;
+    int* indexPtr = fIDLookup.find(head->uniqueID());
+    fPendingTimers.push_back({indexPtr ? *indexPtr : kGrAuditTrailInvalidID, query});
+}
+
+void GrAuditTrail::resolveGpuTimes() {
+    for (const PendingTimer& timer : fPendingTimers) {
+        uint64_t nanos;
+        if (fTimerGpu->getTimerQueryResult(timer.fQuery, &nanos) &&
+            kGrAuditTrailInvalidID != timer.fOpListID && fOpList[timer.fOpListID]) {
+            fOpList[timer.fOpListID]->fGpuNanos = (int64_t)nanos;
+        }
+        fTimerGpu->deleteTimerQuery(timer.fQuery);
+    }
+    fPendingTimers.reset();
+}
+
+bool GrAuditTrail::addGpuTimesByClientID(double clientNanos[], int clientCount) const {
+    bool timed = false;
+    for (const std::unique_ptr<OpNode>& node : fOpList) {
+        if (!node || node->fGpuNanos < 0 || node->fChildren.empty()) {
+            continue;
+        }
+        timed = true;
+        double share = (double)node->fGpuNanos / node->fChildren.count();
+        for (const Op* op : node->fChildren) {
+            if (op->fClientID >= 0 && op->fClientID < clientCount) {
+                clientNanos[op->fClientID] += share;
+            }
+        }
+    }
+    return timed;
 }
 
 void GrAuditTrail::copyOutFromOpList(OpInfo* outOpInfo, int opListID) {
@@ -90,6 +129,7 @@ void GrAuditTrail::copyOutFromOpList(OpInfo* outOpInfo, int opListID) {
     SkASSERT(bn);
     outOpInfo->fBounds = bn->fBounds;
     outOpInfo->fProxyUniqueID    = bn->fProxyUniqueID;
+    outOpInfo->fGpuNanos = bn->fGpuNanos;
     for (int j = 0; j < bn->fChildren.count(); j++) {
         OpInfo::Op& outOp = outOpInfo->fOps.push_back();
         const Op* currentOp = bn->fChildren[j];
@@ -127,11 +167,16 @@ void GrAuditTrail::getBoundsByOpListID(OpInfo* outInfo, int opListID) {
 
 void GrAuditTrail::fullReset() {
     SkASSERT(fEnabled);
+    for (const PendingTimer& timer : fPendingTimers) {
+        fTimerGpu->deleteTimerQuery(timer.fQuery);
+    }
+    fPendingTimers.reset();
     fOpList.reset();
     fIDLookup.reset();
     // free all client ops
     fClientIDLookup.foreach ([](const int&, Ops** ops) { delete *ops; });
     fClientIDLookup.reset();
+    fNumOpsMerged = 0;
     fOpPool.reset();  // must be last, frees all of the memory
 }
 
@@ -287,6 +332,9 @@ SkString GrAuditTrail::OpNode::toJson() const {
     SkString json;
     json.append("{");
     json.appendf("\"ProxyID\": \"%u\",", fProxyUniqueID.asUInt());
+    if (fGpuNanos >= 0) {
+        json.appendf("\"GpuTimeMs\": %f,", fGpuNanos * 1e-6);
+    }
     skrect_to_json(&json, "Bounds", fBounds);
     JsonifyTArray(&json, "Ops", fChildren, true);
     json.append("}");
@@ -12,9 +12,11 @@
 #include "GrContext.h"
 #include "GrContextPriv.h"
 #include "GrGpu.h"
+#include "GrMesh.h"
 #include "GrResourceProvider.h"
 #include "GrTypes.h"
 #include "SkMacros.h"
+#include "SkMemoryCounters.h"
 #include "SkSafeMath.h"
 #include "SkTraceEvent.h"
 
@@ -288,6 +290,8 @@ bool GrBufferAllocPool::createBlock(size_t requestSize) {
     }
 
     block.fBytesFree = block.fBuffer->gpuMemorySize();
+    SkMemoryCounters::Add(SkGraphics::MemoryCounters::kGrBufferAllocPool,
+                          block.fBuffer->gpuMemorySize());
     if (fBufferPtr) {
         SkASSERT(fBlocks.count() > 1);
         BufferBlock& prev = fBlocks.fromBack(1);
@@ -328,6 +332,8 @@ void GrBufferAllocPool::destroyBlock() {
     BufferBlock& block = fBlocks.back();
 
     SkASSERT(!block.fBuffer->isMapped());
+    SkMemoryCounters::Remove(SkGraphics::MemoryCounters::kGrBufferAllocPool,
+                             block.fBuffer->gpuMemorySize());
     block.fBuffer->unref();
     fBlocks.pop_back();
     fBufferPtr = nullptr;
@@ -485,3 +491,17 @@ void* GrIndexBufferAllocPool::makeSpaceAtLeast(int minIndexCount, int fallbackIn
     *actualIndexCount = static_cast<int>(actualSize / sizeof(uint16_t));
     return ptr;
 }
+
+////////////////////////////////////////////////////////////////////////////////
+
+GrDrawIndexedIndirectCommand* GrDrawIndirectBufferAllocPool::makeSpace(int commandCount,
+                                                                      const GrBuffer** buffer,
+                                                                      size_t* offset) {
+    SkASSERT(commandCount >= 0);
+    SkASSERT(buffer);
+    SkASSERT(offset);
+
+    size_t size = SkSafeMath::Mul(commandCount, sizeof(GrDrawIndexedIndirectCommand));
+    return static_cast<GrDrawIndexedIndirectCommand*>(
+            INHERITED::makeSpace(size, sizeof(uint32_t), buffer, offset));
+}
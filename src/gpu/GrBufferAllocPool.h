@@ -16,6 +16,7 @@
 
 class GrBuffer;
 class GrGpu;
+struct GrDrawIndexedIndirectCommand;
 
 /**
  * A pool of geometry buffers tied to a GrGpu.
@@ -297,4 +298,28 @@ private:
     typedef GrBufferAllocPool INHERITED;
 };
 
+/**
+ * A GrBufferAllocPool of draw indirect buffers
+ */
+class GrDrawIndirectBufferAllocPool : public GrBufferAllocPool {
+public:
+    GrDrawIndirectBufferAllocPool(GrGpu* gpu)
+            : GrBufferAllocPool(gpu, kDrawIndirect_GrBufferType, nullptr) {}
+
+    /**
+     * Returns space for 'commandCount' GrDrawIndexedIndirectCommands, like makeSpace() in the
+     * other pools.
+     *
+     * @param commandCount   number of commands to allocate space for
+     * @param buffer         returns the indirect buffer that will hold the commands.
+     * @param offset         returns the offset in bytes into buffer of the first command.
+     * @return pointer to the first command.
+     */
+    GrDrawIndexedIndirectCommand* makeSpace(int commandCount, const GrBuffer** buffer,
+                                            size_t* offset);
+
+private:
+    typedef GrBufferAllocPool INHERITED;
+};
+
 #endif
@@ -36,7 +36,10 @@ GrCaps::GrCaps(const GrContextOptions& options) {
     fSampleShadingSupport = false;
     fFenceSyncSupport = false;
     fCrossContextTextureSupport = false;
+    fTransferFromSurfaceToBufferSupport = false;
     fHalfFloatVertexAttributeSupport = false;
+    fMultiDrawIndexedIndirectSupport = false;
+    fIndirectBaseInstanceSupport = false;
     fDynamicStateArrayGeometryProcessorTextureSupport = false;
 
     fBlendEquationSupport = kBasic_BlendEquationSupport;
@@ -177,9 +180,13 @@ void GrCaps::dumpJSON(SkJSONWriter* writer) const {
     writer->appendBool("Prefer fullscreen clears", fPreferFullscreenClears);
     writer->appendBool("Must clear buffer memory", fMustClearUploadedBufferData);
     writer->appendBool("Supports importing AHardwareBuffers", fSupportsAHardwareBufferImages);
+    writer->appendBool("Multi draw indexed indirect support", fMultiDrawIndexedIndirectSupport);
+    writer->appendBool("Indirect base instance support", fIndirectBaseInstanceSupport);
     writer->appendBool("Sample shading support", fSampleShadingSupport);
     writer->appendBool("Fence sync support", fFenceSyncSupport);
     writer->appendBool("Cross context texture support", fCrossContextTextureSupport);
+    writer->appendBool("Transfer from surface to buffer support",
+                       fTransferFromSurfaceToBufferSupport);
     writer->appendBool("Half float vertex attribute support", fHalfFloatVertexAttributeSupport);
     writer->appendBool("Specify GeometryProcessor textures as a dynamic state array",
                        fDynamicStateArrayGeometryProcessorTextureSupport);
@@ -60,6 +60,12 @@ public:
     bool usesMixedSamples() const { return fUsesMixedSamples; }
     bool halfFloatVertexAttributeSupport() const { return fHalfFloatVertexAttributeSupport; }
 
+    // Can consecutive indexed meshes of a draw that share their buffers be issued as a single
+    // multi-draw-indirect call (see GrMesh::setIndirect)? If so, the indirect draws can only
+    // start past an instance buffer's first instance when indirectBaseInstanceSupport() is true.
+    bool multiDrawIndexedIndirectSupport() const { return fMultiDrawIndexedIndirectSupport; }
+    bool indirectBaseInstanceSupport() const { return fIndirectBaseInstanceSupport; }
+
     // Primitive restart functionality is core in ES 3.0, but using it will cause slowdowns on some
     // systems. This cap is only set if primitive restart will improve performance.
     bool usePrimitiveRestart() const { return fUsePrimitiveRestart; }
@@ -242,6 +248,9 @@ public:
     bool sampleShadingSupport() const { return fSampleShadingSupport; }
 
     bool fenceSyncSupport() const { return fFenceSyncSupport; }
+    // Can GrGpu::transferPixelsFrom() copy a surface's pixels into a transfer buffer that is
+    // mapped once a fence signals?
+    bool transferFromSurfaceToBufferSupport() const { return fTransferFromSurfaceToBufferSupport; }
     bool crossContextTextureSupport() const { return fCrossContextTextureSupport; }
     /**
      * Returns whether or not we will be able to do a copy given the passed in params
@@ -349,6 +358,8 @@ protected:
     bool fMustClearUploadedBufferData                : 1;
     bool fSupportsAHardwareBufferImages              : 1;
     bool fHalfFloatVertexAttributeSupport            : 1;
+    bool fMultiDrawIndexedIndirectSupport            : 1;
+    bool fIndirectBaseInstanceSupport                : 1;
 
     // Driver workaround
     bool fBlacklistCoverageCounting                  : 1;
@@ -364,6 +375,7 @@ protected:
 
     // Requires fence sync support in GL.
     bool fCrossContextTextureSupport                 : 1;
+    bool fTransferFromSurfaceToBufferSupport         : 1;
 
     // Not (yet) implemented in VK backend.
     bool fDynamicStateArrayGeometryProcessorTextureSupport : 1;
@@ -28,12 +28,19 @@
 #include "effects/GrRRectEffect.h"
 #include "effects/GrTextureDomain.h"
 
+#include <atomic>
+
 typedef SkClipStack::Element Element;
 typedef GrReducedClip::InitialState InitialState;
 typedef GrReducedClip::ElementList ElementList;
 
 const char GrClipStackClip::kMaskTestTag[] = "clip_mask";
 
+// Threaded SW clip masks at least twice this tall are drawn in bands, by up to kMaxClipMaskBands
+// tasks.
+static constexpr int kMinClipMaskBandHeight = 128;
+static constexpr int kMaxClipMaskBands = 4;
+
 bool GrClipStackClip::quickContains(const SkRect& rect) const {
     if (!fStack || fStack->isWideOpen()) {
         return true;
@@ -209,10 +216,14 @@ bool GrClipStackClip::apply(GrContext* context, GrRenderTargetContext* renderTar
         // We disable MSAA when avoiding stencil.
         SkASSERT(!context->contextPriv().caps()->avoidStencilBuffers());
     }
-    auto* ccpr = context->contextPriv().drawingManager()->getCoverageCountingPathRenderer();
-
-    GrReducedClip reducedClip(*fStack, devBounds, context->contextPriv().caps(),
-                              maxWindowRectangles, maxAnalyticFPs, ccpr ? maxAnalyticFPs : 0);
+    GrDrawingManager* drawingManager = context->contextPriv().drawingManager();
+    auto* ccpr = drawingManager->getCoverageCountingPathRenderer();
+
+    // Reductions are cached by clip gen ID and query bounds, so repeated draws under an unchanged
+    // clip (even on later frames) don't walk the stack again.
+    const GrReducedClip& reducedClip = drawingManager->getReducedClipCache()->findOrCreate(
+            *fStack, devBounds, context->contextPriv().caps(), maxWindowRectangles, maxAnalyticFPs,
+            ccpr ? maxAnalyticFPs : 0);
     if (InitialState::kAllOut == reducedClip.initialState() &&
         reducedClip.maskElements().isEmpty()) {
         return false;
@@ -238,7 +249,7 @@ bool GrClipStackClip::apply(GrContext* context, GrRenderTargetContext* renderTar
     // can cause a flush or otherwise change which opList our draw is going into.
     uint32_t opListID = renderTargetContext->getOpList()->uniqueID();
     int rtWidth = renderTargetContext->width(), rtHeight = renderTargetContext->height();
-    if (auto clipFPs = reducedClip.finishAndDetachAnalyticFPs(ccpr, opListID, rtWidth, rtHeight)) {
+    if (auto clipFPs = reducedClip.makeAnalyticFPs(ccpr, opListID, rtWidth, rtHeight)) {
         out->addCoverageFP(std::move(clipFPs));
     }
 
@@ -398,10 +409,16 @@ public:
     InitialState initialState() const { return fInitialState; }
     const ElementList& elements() const { return fElements; }
 
+    // The mask is drawn in this many bands, each by its own task.
+    void setBandCount(int count) { fBandsLeft.store(count, std::memory_order_relaxed); }
+    // Returns true for the last band to finish, which then signals that the pixels are ready.
+    bool finishBand() { return 1 == fBandsLeft.fetch_sub(1, std::memory_order_acq_rel); }
+
 private:
     SkIRect fScissor;
     InitialState fInitialState;
     ElementList fElements;
+    std::atomic<int> fBandsLeft{1};
 };
 
 }
@@ -488,20 +505,34 @@ sk_sp<GrTextureProxy> GrClipStackClip::createSoftwareClipMask(
 
         auto uploader = skstd::make_unique<GrTDeferredProxyUploader<ClipMaskData>>(reducedClip);
         GrTDeferredProxyUploader<ClipMaskData>* uploaderRaw = uploader.get();
-        auto drawAndUploadMask = [uploaderRaw, maskSpaceIBounds] {
-            TRACE_EVENT0("skia", "Threaded SW Clip Mask Render");
-            GrSWMaskHelper helper(uploaderRaw->getPixels());
-            if (helper.init(maskSpaceIBounds)) {
+        if (!uploaderRaw->getPixels()->tryAlloc(SkImageInfo::MakeA8(maskSpaceIBounds.width(),
+                                                                    maskSpaceIBounds.height()))) {
+            SkDEBUGFAIL("Unable to allocate SW clip mask.");
+            uploaderRaw->signalAndFreeData();
+            return nullptr;
+        }
+
+        // Tall masks are split into bands of rows, so that clips with many elements rasterize
+        // on several threads. Each band draws every element, clipped to its rows.
+        int bandCount = SkTPin(maskSpaceIBounds.height() / kMinClipMaskBandHeight,
+                               1, kMaxClipMaskBands);
+        uploaderRaw->data().setBandCount(bandCount);
+        for (int i = 0; i < bandCount; i++) {
+            int bandTop = maskSpaceIBounds.height() * i / bandCount;
+            int bandBottom = maskSpaceIBounds.height() * (i + 1) / bandCount;
+            auto drawAndUploadMask = [uploaderRaw, maskSpaceIBounds, bandTop, bandBottom] {
+                TRACE_EVENT0("skia", "Threaded SW Clip Mask Render");
+                GrSWMaskHelper helper(uploaderRaw->getPixels());
+                helper.initBand(maskSpaceIBounds, bandTop, bandBottom);
                 draw_clip_elements_to_mask_helper(helper, uploaderRaw->data().elements(),
                                                   uploaderRaw->data().scissor(),
                                                   uploaderRaw->data().initialState());
-            } else {
-                SkDEBUGFAIL("Unable to allocate SW clip mask.");
-            }
-            uploaderRaw->signalAndFreeData();
-        };
-
-        taskGroup->add(std::move(drawAndUploadMask));
+                if (uploaderRaw->data().finishBand()) {
+                    uploaderRaw->signalAndFreeData();
+                }
+            };
+            taskGroup->add(std::move(drawAndUploadMask));
+        }
         proxy->texPriv().setDeferredUploader(std::move(uploader));
     } else {
         GrSWMaskHelper helper;
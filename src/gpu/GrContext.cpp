@@ -13,6 +13,7 @@
 #include "GrDrawingManager.h"
 #include "GrGpu.h"
 #include "GrMemoryPool.h"
+#include "GrPictureRasterCache.h"
 #include "GrProxyProvider.h"
 #include "GrRenderTargetContext.h"
 #include "GrRenderTargetProxy.h"
@@ -37,6 +38,8 @@
 #include "effects/GrConfigConversionEffect.h"
 #include "effects/GrSkSLFP.h"
 #include "ccpr/GrCoverageCountingPathRenderer.h"
+#include "ops/GrSmallPathRenderer.h"
+#include "text/GrAtlasManager.h"
 #include "text/GrTextBlobCache.h"
 #include <atomic>
 #include <unordered_map>
@@ -57,6 +60,11 @@
 #define RETURN_FALSE_IF_ABANDONED_PRIV if (fContext->fDrawingManager->wasAbandoned()) { return false; }
 #define RETURN_NULL_IF_ABANDONED if (fDrawingManager->wasAbandoned()) { return nullptr; }
 
+// How much of the op memory pool's emptied blocks it keeps for the next flush.
+#ifndef GR_OP_MEMORY_POOL_WARM_BYTES
+#define GR_OP_MEMORY_POOL_WARM_BYTES (256 * 1024)
+#endif
+
 ////////////////////////////////////////////////////////////////////////////////
 
 static int32_t next_id() {
@@ -85,8 +93,11 @@ bool GrContext::initCommon(const GrContextOptions& options) {
     if (fGpu) {
         fCaps = fGpu->refCaps();
         fResourceCache = new GrResourceCache(fCaps.get(), &fSingleOwner, fUniqueID);
+        fResourceCache->setMaxUnusedLimits(options.fResourceCacheMaxUnusedFlushes,
+                                           options.fResourceCacheMaxUnusedTime);
         fResourceProvider = new GrResourceProvider(fGpu.get(), fResourceCache, &fSingleOwner,
-                                                   options.fExplicitlyAllocateGPUResources);
+                                                   options.fExplicitlyAllocateGPUResources,
+                                                   options.fReuseLargerTransientSurfaces);
         fProxyProvider =
                 new GrProxyProvider(fResourceProvider, fResourceCache, fCaps, &fSingleOwner);
     } else {
@@ -97,12 +108,21 @@ bool GrContext::initCommon(const GrContextOptions& options) {
         fResourceCache->setProxyProvider(fProxyProvider);
     }
 
+    // Vulkan semaphores can only be waited on by one context, so textures can't be shared there.
+    if (options.fSharedTexturePool && fResourceProvider &&
+        fCaps->crossContextTextureSupport() && GrBackendApi::kVulkan != fBackend) {
+        fProxyProvider->setSharedTexturePool(options.fSharedTexturePool);
+    }
+
     fDisableGpuYUVConversion = options.fDisableGpuYUVConversion;
     fSharpenMipmappedTextures = options.fSharpenMipmappedTextures;
     fDidTestPMConversions = false;
 
     GrPathRendererChain::Options prcOptions;
     prcOptions.fAllowPathMaskCaching = options.fAllowPathMaskCaching;
+    prcOptions.fPathMaskCachingTolerance = options.fPathMaskCachingTolerance;
+    prcOptions.fOpenCLContext = options.fOpenCLContext;
+    prcOptions.fOpenCLDevice = options.fOpenCLDevice;
 #if GR_TEST_UTILS
     prcOptions.fGpuPathRenderers = options.fGpuPathRenderers;
 #endif
@@ -119,12 +139,17 @@ bool GrContext::initCommon(const GrContextOptions& options) {
         // unified when the opLists are added back to the destination drawing manager.
         prcOptions.fGpuPathRenderers &= ~GpuPathRenderers::kSmall;
         prcOptions.fGpuPathRenderers &= ~GpuPathRenderers::kStencilAndCover;
+        prcOptions.fGpuPathRenderers &= ~GpuPathRenderers::kSkc;
     }
 
     GrTextContext::Options textContextOptions;
     textContextOptions.fMaxDistanceFieldFontSize = options.fGlyphsAsPathsFontSize;
     textContextOptions.fMinDistanceFieldFontSize = options.fMinDistanceFieldFontSize;
     textContextOptions.fDistanceFieldVerticesAlwaysHaveW = false;
+    textContextOptions.fReuseBlobsUnderFractionalTranslation =
+            options.fReuseTextBlobsUnderFractionalTranslation;
+    textContextOptions.fDistanceFieldTextForScaleChanges =
+            options.fDistanceFieldTextForScaleChanges;
 #if SK_SUPPORT_ATLAS_TEXT
     if (GrContextOptions::Enable::kYes == options.fDistanceFieldGlyphVerticesAlwaysHaveW) {
         textContextOptions.fDistanceFieldVerticesAlwaysHaveW = true;
@@ -148,6 +173,14 @@ bool GrContext::initCommon(const GrContextOptions& options) {
     // get passed on to/shared between all the DDLRecorders created with this context.
     if (options.fExecutor) {
         fTaskGroup = skstd::make_unique<SkTaskGroup>(*options.fExecutor);
+        if (fResourceProvider) {
+            fProxyProvider->setUploadTaskGroup(fTaskGroup.get(),
+                                               options.fMaxPendingMipMapUploadBytes);
+        }
+    }
+
+    if (options.fPictureRasterCacheBytes && fResourceProvider) {
+        fPictureRasterCache.reset(new GrPictureRasterCache(this, options.fPictureRasterCacheBytes));
     }
 
     fPersistentCache = options.fPersistentCache;
@@ -158,6 +191,11 @@ bool GrContext::initCommon(const GrContextOptions& options) {
 GrContext::~GrContext() {
     ASSERT_SINGLE_OWNER
 
+    // Its proxies must go before the providers do.
+    fPictureRasterCache.reset();
+    if (fProxyProvider) {
+        fProxyProvider->withdrawSharedTextures();
+    }
     if (fDrawingManager) {
         fDrawingManager->cleanup();
     }
@@ -256,6 +294,9 @@ void GrContext::abandonContext() {
 
     fGlyphCache->freeAll();
     fTextBlobCache->freeAll();
+    if (fPictureRasterCache) {
+        fPictureRasterCache->purgeAll();
+    }
 }
 
 bool GrContext::abandoned() const {
@@ -280,6 +321,9 @@ void GrContext::releaseResourcesAndAbandonContext() {
 
     fGlyphCache->freeAll();
     fTextBlobCache->freeAll();
+    if (fPictureRasterCache) {
+        fPictureRasterCache->purgeAll();
+    }
 }
 
 void GrContext::resetContext(uint32_t state) {
@@ -291,10 +335,17 @@ void GrContext::freeGpuResources() {
     ASSERT_SINGLE_OWNER
 
     fGlyphCache->freeAll();
+    if (fPictureRasterCache) {
+        fPictureRasterCache->purgeAll();
+    }
 
     fDrawingManager->freeGpuResources();
 
     fResourceCache->purgeAllUnlocked();
+
+    if (fOpMemoryPool) {
+        fOpMemoryPool->purgeWarmBlocks();
+    }
 }
 
 void GrContext::purgeUnlockedResources(bool scratchResourcesOnly) {
@@ -324,6 +375,50 @@ void GrContext::purgeUnlockedResources(size_t bytesToPurge, bool preferScratchRe
     fResourceCache->purgeUnlockedResources(bytesToPurge, preferScratchResources);
 }
 
+GrContext::MemoryPressureResult GrContext::purgeForMemoryPressure(
+        SkGraphics::MemoryPressureLevel level, size_t bytesToFree) {
+    ASSERT_SINGLE_OWNER
+
+    MemoryPressureResult result;
+    if (this->abandoned()) {
+        return result;
+    }
+
+    if (SkGraphics::MemoryPressureLevel::kModerate == level) {
+        result.fTextBlobCacheBytes = fTextBlobCache->purgeBytes(bytesToFree);
+        if (result.fTextBlobCacheBytes < bytesToFree) {
+            size_t before = fResourceCache->getResourceBytes();
+            fResourceCache->purgeUnlockedResources(bytesToFree - result.fTextBlobCacheBytes, true);
+            result.fResourceCacheBytes = before - fResourceCache->getResourceBytes();
+        }
+        return result;
+    }
+
+    result.fTextBlobCacheBytes = fTextBlobCache->purgeBytes(fTextBlobCache->usedBytes());
+
+    // Evicting every path lets the cache drop its atlases, which purgeAsNeeded() then frees.
+    size_t before = fResourceCache->getResourceBytes();
+    if (auto ccpr = fDrawingManager->getCoverageCountingPathRenderer()) {
+        ccpr->purgeCacheEntriesOlderThan(GrStdSteadyClock::time_point::max());
+        fResourceCache->purgeAsNeeded();
+    }
+    result.fPathCacheBytes = before - fResourceCache->getResourceBytes();
+
+    // Dropping the picture rasters unlocks their textures.
+    if (fPictureRasterCache) {
+        fPictureRasterCache->purgeAll();
+    }
+    before = fResourceCache->getResourceBytes();
+    fResourceCache->purgeAllUnlocked();
+    result.fResourceCacheBytes = before - fResourceCache->getResourceBytes();
+
+    // Now all that freeGpuResources() adds is what it unlocks: mostly the glyph atlases.
+    before = fResourceCache->getResourceBytes();
+    this->freeGpuResources();
+    result.fGlyphAtlasBytes = before - fResourceCache->getResourceBytes();
+    return result;
+}
+
 void GrContext::getResourceCacheUsage(int* resourceCount, size_t* resourceBytes) const {
     ASSERT_SINGLE_OWNER
 
@@ -377,6 +472,29 @@ void GrContext::flush() {
     fDrawingManager->flush(nullptr);
 }
 
+void GrContext::checkAsyncWorkCompletion() {
+    ASSERT_SINGLE_OWNER
+    RETURN_IF_ABANDONED
+
+    fDrawingManager->checkAsyncReads();
+}
+
+void GrContext::storeVkPipelineCacheData() {
+    ASSERT_SINGLE_OWNER
+    RETURN_IF_ABANDONED
+
+    if (fGpu) {
+        fGpu->storeVkPipelineCacheData();
+    }
+}
+
+void GrContext::prewarmPathMasks(const SkPath paths[], int count, const SkMatrix& viewMatrix) {
+    ASSERT_SINGLE_OWNER
+    RETURN_IF_ABANDONED
+
+    GrSmallPathRenderer::PrewarmMasks(*fCaps, paths, count, viewMatrix, fTaskGroup.get());
+}
+
 GrSemaphoresSubmitted GrContext::flushAndSignalSemaphores(int numSemaphores,
                                                           GrBackendSemaphore signalSemaphores[]) {
     ASSERT_SINGLE_OWNER
@@ -868,7 +986,13 @@ sk_sp<GrOpMemoryPool> GrContextPriv::refOpMemoryPool() {
         // DDL TODO: should the size of the memory pool be decreased in DDL mode? CPU-side memory
         // consumed in DDL mode vs. normal mode for a single skp might be a good metric of wasted
         // memory.
-        fContext->fOpMemoryPool = sk_sp<GrOpMemoryPool>(new GrOpMemoryPool(16384, 16384));
+        // Ops are released when their opList is flushed, so keep the blocks they used for the
+        // next flush, and reuse the space of ops released out of order before then.
+        GrMemoryPool::Options options;
+        options.fSizeClassFreeLists = true;
+        options.fWarmBlockBytes = GR_OP_MEMORY_POOL_WARM_BYTES;
+        fContext->fOpMemoryPool = sk_sp<GrOpMemoryPool>(new GrOpMemoryPool(16384, 16384,
+                                                                           options));
     }
 
     SkASSERT(fContext->fOpMemoryPool);
@@ -879,6 +1003,14 @@ GrOpMemoryPool* GrContextPriv::opMemoryPool() {
     return this->refOpMemoryPool().get();
 }
 
+GrMemoryPool::Stats GrContextPriv::opMemoryPoolStats() const {
+    return fContext->fOpMemoryPool ? fContext->fOpMemoryPool->stats() : GrMemoryPool::Stats();
+}
+
+size_t GrContextPriv::lastFlushPeakTransientBytes() const {
+    return fContext->fDrawingManager->lastFlushPeakTransientBytes();
+}
+
 sk_sp<GrSurfaceContext> GrContextPriv::makeWrappedSurfaceContext(sk_sp<GrSurfaceProxy> proxy,
                                                                  sk_sp<SkColorSpace> colorSpace,
                                                                  const SkSurfaceProps* props) {
@@ -991,6 +1123,10 @@ sk_sp<GrRenderTargetContext> GrContextPriv::makeBackendTextureAsRenderTargetRend
                                                            props);
 }
 
+int GrContextPriv::numPendingPrograms() const {
+    return fContext->fGpu ? fContext->fGpu->numPendingPrograms() : 0;
+}
+
 void GrContextPriv::addOnFlushCallbackObject(GrOnFlushCallbackObject* onFlushCBObject) {
     fContext->fDrawingManager->addOnFlushCallbackObject(onFlushCBObject);
 }
@@ -1167,6 +1303,12 @@ void GrContext::dumpMemoryStatistics(SkTraceMemoryDump* traceMemoryDump) const {
     fResourceCache->dumpMemoryStatistics(traceMemoryDump);
     traceMemoryDump->dumpNumericValue("skia/gr_text_blob_cache", "size", "bytes",
                                       fTextBlobCache->usedBytes());
+    // Only direct contexts, which have a GrGpu, own glyph atlases.
+    if (fGpu) {
+        if (auto atlasManager = const_cast<GrContext*>(this)->onGetAtlasManager()) {
+            atlasManager->dumpMemoryStatistics(traceMemoryDump);
+        }
+    }
 }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -9,12 +9,12 @@
 #define GrContextPriv_DEFINED
 
 #include "GrContext.h"
+#include "GrMemoryPool.h"
 #include "GrSurfaceContext.h"
 #include "text/GrAtlasManager.h"
 
 class GrBackendFormat;
 class GrBackendRenderTarget;
-class GrOpMemoryPool;
 class GrOnFlushCallbackObject;
 class GrSemaphore;
 class GrSkSLFPFactory;
@@ -37,6 +37,14 @@ public:
 
     sk_sp<GrOpMemoryPool> refOpMemoryPool();
     GrOpMemoryPool* opMemoryPool();
+    /** Stats of the pool ops are allocated from, all zero if it hasn't been made yet. */
+    GrMemoryPool::Stats opMemoryPoolStats() const;
+
+    /**
+     * The most bytes of render targets and textures the last flush allocated for its own use that
+     * were in use at once. Only counted when GPU resources are explicitly allocated.
+     */
+    size_t lastFlushPeakTransientBytes() const;
 
     GrDrawingManager* drawingManager() { return fContext->fDrawingManager.get(); }
 
@@ -196,6 +204,8 @@ public:
 
     GrGlyphCache* getGlyphCache() { return fContext->fGlyphCache; }
     GrTextBlobCache* getTextBlobCache() { return fContext->fTextBlobCache.get(); }
+    // Null unless GrContextOptions::fPictureRasterCacheBytes is set.
+    GrPictureRasterCache* getPictureRasterCache() { return fContext->fPictureRasterCache.get(); }
 
     // This accessor should only ever be called by the GrOpFlushState.
     GrAtlasManager* getAtlasManager() {
@@ -276,6 +286,13 @@ public:
 
     GrContextOptions::PersistentCache* getPersistentCache() { return fContext->fPersistentCache; }
 
+    /**
+     * Number of programs that are still being compiled in the background (see
+     * GrContextOptions::fAllowAsyncProgramCompilation). Programs that complete are picked up at
+     * the end of each flush, so this reflects the state after the last flush.
+     */
+    int numPendingPrograms() const;
+
     sk_sp<GrSkSLFPFactoryCache> getFPFactoryCache() {
         return fContext->fFPFactoryCache;
     }
@@ -9,6 +9,7 @@
 
 #include "GrContext.h"
 #include "GrContextPriv.h"
+#include "GrGpuResourcePriv.h"
 #include "GrOnFlushResourceProvider.h"
 #include "GrOpFlushState.h"
 #include "GrRectanizer.h"
@@ -17,6 +18,8 @@
 #include "GrSurfaceProxyPriv.h"
 #include "GrTexture.h"
 #include "GrTracing.h"
+#include "SkMemoryCounters.h"
+#include "SkTraceMemoryDump.h"
 
 // When proxy allocation is deferred until flush time the proxies acting as atlases require
 // special handling. This is because the usage that can be determined from the ops themselves
@@ -38,10 +41,11 @@ std::unique_ptr<GrDrawOpAtlas> GrDrawOpAtlas::Make(GrProxyProvider* proxyProvide
                                                    GrPixelConfig config, int width,
                                                    int height, int numPlotsX, int numPlotsY,
                                                    AllowMultitexturing allowMultitexturing,
-                                                   GrDrawOpAtlas::EvictionFunc func, void* data) {
+                                                   GrDrawOpAtlas::EvictionFunc func, void* data,
+                                                   uint32_t maxPages) {
     std::unique_ptr<GrDrawOpAtlas> atlas(new GrDrawOpAtlas(proxyProvider, format, config, width,
                                                            height, numPlotsX, numPlotsY,
-                                                           allowMultitexturing));
+                                                           allowMultitexturing, maxPages));
     if (!atlas->getProxies()[0]) {
         return nullptr;
     }
@@ -60,6 +64,7 @@ GrDrawOpAtlas::Plot::Plot(int pageIndex, int plotIndex, uint64_t genID, int offX
         : fLastUpload(GrDeferredUploadToken::AlreadyFlushedToken())
         , fLastUse(GrDeferredUploadToken::AlreadyFlushedToken())
         , fFlushesSinceLastUse(0)
+        , fUseScore(0)
         , fPageIndex(pageIndex)
         , fPlotIndex(plotIndex)
         , fGenID(genID)
@@ -158,6 +163,21 @@ void GrDrawOpAtlas::Plot::uploadToTexture(GrDeferredTextureUploadWritePixelsFn&
     SkDEBUGCODE(fDirty = false;)
 }
 
+// Each flush that uses the atlas decays the scores of all its plots by an eighth, and adds this to
+// the plots it used. A plot used in every flush settles at a score of eight times this.
+static constexpr uint32_t kUseScorePerFlush = 64;
+
+void GrDrawOpAtlas::Plot::updateUseScore(bool usedThisFlush) {
+    fUseScore -= fUseScore >> 3;
+    if (usedThisFlush) {
+        fUseScore += kUseScorePerFlush;
+    }
+}
+
+float GrDrawOpAtlas::Plot::occupancy() const {
+    return fRects ? fRects->percentFull() : 0;
+}
+
 void GrDrawOpAtlas::Plot::resetRects() {
     if (fRects) {
         fRects->reset();
@@ -181,14 +201,16 @@ void GrDrawOpAtlas::Plot::resetRects() {
 
 GrDrawOpAtlas::GrDrawOpAtlas(GrProxyProvider* proxyProvider, const GrBackendFormat& format,
                              GrPixelConfig config, int width, int height,
-                             int numPlotsX, int numPlotsY, AllowMultitexturing allowMultitexturing)
+                             int numPlotsX, int numPlotsY, AllowMultitexturing allowMultitexturing,
+                             uint32_t maxPages)
         : fFormat(format)
         , fPixelConfig(config)
         , fTextureWidth(width)
         , fTextureHeight(height)
         , fAtlasGeneration(kInvalidAtlasGeneration + 1)
         , fPrevFlushToken(GrDeferredUploadToken::AlreadyFlushedToken())
-        , fMaxPages(AllowMultitexturing::kYes == allowMultitexturing ? kMaxMultitexturePages : 1)
+        , fMaxPages(AllowMultitexturing::kYes == allowMultitexturing
+                            ? SkTPin<uint32_t>(maxPages, 1, kMaxMultitexturePages) : 1)
         , fNumActivePages(0) {
     fPlotWidth = fTextureWidth / numPlotsX;
     fPlotHeight = fTextureHeight / numPlotsY;
@@ -201,11 +223,91 @@ GrDrawOpAtlas::GrDrawOpAtlas(GrProxyProvider* proxyProvider, const GrBackendForm
     this->createPages(proxyProvider);
 }
 
+GrDrawOpAtlas::~GrDrawOpAtlas() {
+    SkMemoryCounters::Remove(SkGraphics::MemoryCounters::kGrDrawOpAtlas,
+                             fNumActivePages * this->pageBytes());
+}
+
+void GrDrawOpAtlas::dumpMemoryStatistics(SkTraceMemoryDump* traceMemoryDump,
+                                         const char* dumpName) const {
+    for (uint32_t pageIdx = 0; pageIdx < fNumActivePages; ++pageIdx) {
+        float occupancy = 0;
+        for (uint32_t plotIdx = 0; plotIdx < fNumPlots; ++plotIdx) {
+            occupancy += fPages[pageIdx].fPlotArray[plotIdx]->occupancy();
+        }
+        occupancy /= fNumPlots;
+
+        SkString pageName = SkStringPrintf("%s/page_%u", dumpName, pageIdx);
+        traceMemoryDump->dumpNumericValue(pageName.c_str(), "size", "bytes", this->pageBytes());
+        traceMemoryDump->dumpNumericValue(pageName.c_str(), "occupancy", "percent",
+                                          (uint64_t)(occupancy * 100));
+    }
+}
+
 inline void GrDrawOpAtlas::processEviction(AtlasID id) {
     for (int i = 0; i < fEvictionCallbacks.count(); i++) {
         (*fEvictionCallbacks[i].fFunc)(id, fEvictionCallbacks[i].fData);
     }
     ++fAtlasGeneration;
+    ++fStats.fEvictions;
+}
+
+void GrDrawOpAtlas::relocatePlot(Plot* from, Plot* to) {
+    SkASSERT(from->fData && from->bpp() == to->bpp());
+    SkASSERT(from->fWidth == to->fWidth && from->fHeight == to->fHeight);
+
+    // Whatever 'to' held is stale, and goes away as usual.
+    this->processEvictionAndResetRects(to);
+
+    // Hand 'from's contents and layout over to 'to', which then has to upload all of it.
+    AtlasID fromID = from->id();
+    std::swap(from->fData, to->fData);
+    std::swap(from->fRects, to->fRects);
+    to->fDirtyRect.setXYWH(0, 0, to->fWidth, to->fHeight);
+    SkDEBUGCODE(to->fDirty = true;)
+    to->setLastUseToken(from->lastUseToken());
+    to->fFlushesSinceLastUse = from->fFlushesSinceLastUse;
+    to->fUseScore = from->fUseScore;
+    from->resetRects();
+
+    SkIPoint16 offset = SkIPoint16::Make(to->fOffset.fX - from->fOffset.fX,
+                                         to->fOffset.fY - from->fOffset.fY);
+    for (int i = 0; i < fRelocationCallbacks.count(); i++) {
+        (*fRelocationCallbacks[i].fFunc)(fromID, to->id(), offset, fRelocationCallbacks[i].fData);
+    }
+    this->makeMRU(to, GetPageIndexFromID(to->id()));
+    ++fAtlasGeneration;
+    ++fStats.fRelocations;
+
+    fRelocatedPlots.push_back({sk_ref_sp(to), to->genID()});
+}
+
+void GrDrawOpAtlas::uploadRelocatedPlots(GrDeferredUploadTarget* target) {
+    for (const RelocatedPlot& relocated : fRelocatedPlots) {
+        Plot* plot = relocated.fPlot.get();
+        int pageIdx = GetPageIndexFromID(plot->id());
+        // Skip plots that have since been evicted, or whose page has been deactivated.
+        if (plot->genID() != relocated.fGenID || (uint32_t)pageIdx >= fNumActivePages ||
+            fPages[pageIdx].fPlotArray[plot->index()].get() != plot) {
+            continue;
+        }
+        // An upload that's already scheduled for the plot will send its whole dirty area.
+        if (plot->fDirtyRect.isEmpty() ||
+            !(plot->lastUploadToken() < target->tokenTracker()->nextTokenToFlush())) {
+            continue;
+        }
+
+        sk_sp<Plot> plotsp(SkRef(plot));
+        GrTextureProxy* proxy = fProxies[pageIdx].get();
+        SkASSERT(proxy->isInstantiated());
+        GrDeferredUploadToken lastUploadToken = target->addASAPUpload(
+                [plotsp, proxy](GrDeferredTextureUploadWritePixelsFn& writePixels) {
+                    plotsp->uploadToTexture(writePixels, proxy);
+                });
+        plot->setLastUploadToken(lastUploadToken);
+        fStats.fUploadBytes += plot->fWidth * plot->fHeight * plot->fBytesPerPixel;
+    }
+    fRelocatedPlots.reset();
 }
 
 inline bool GrDrawOpAtlas::updatePlot(GrDeferredUploadTarget* target, AtlasID* id, Plot* plot) {
@@ -259,10 +361,41 @@ bool GrDrawOpAtlas::uploadToPage(unsigned int pageIdx, AtlasID* id, GrDeferredUp
 // are rare; i.e., we are not continually refreshing the frame.
 static constexpr auto kRecentlyUsedCount = 256;
 
+GrDrawOpAtlas::Plot* GrDrawOpAtlas::findPlotToEvict(GrDeferredUploadToken nextTokenToFlush) {
+    // Of the plots that have already been flushed to the gpu, or have aged out, pick the one used
+    // least lately. Ties go to the first pages, and then to the least recently used.
+    Plot* victim = nullptr;
+    for (unsigned int pageIdx = 0; pageIdx < fNumActivePages; ++pageIdx) {
+        PlotList::Iter plotIter;
+        plotIter.init(fPages[pageIdx].fPlotList, PlotList::Iter::kTail_IterStart);
+        for (Plot* plot = plotIter.get(); plot; plot = plotIter.prev()) {
+            if ((plot->lastUseToken() < nextTokenToFlush ||
+                 plot->flushesSinceLastUsed() >= kRecentlyUsedCount) &&
+                (!victim || plot->useScore() < victim->useScore())) {
+                victim = plot;
+            }
+        }
+    }
+    return victim;
+}
+
 GrDrawOpAtlas::ErrorCode GrDrawOpAtlas::addToAtlas(GrResourceProvider* resourceProvider,
                                                    AtlasID* id, GrDeferredUploadTarget* target,
                                                    int width, int height,
                                                    const void* image, SkIPoint16* loc) {
+    ErrorCode code = this->internalAddToAtlas(resourceProvider, id, target, width, height, image,
+                                              loc);
+    if (ErrorCode::kSucceeded == code) {
+        fStats.fUploadBytes += width * height * GrBytesPerPixel(fPixelConfig);
+    }
+    return code;
+}
+
+GrDrawOpAtlas::ErrorCode GrDrawOpAtlas::internalAddToAtlas(GrResourceProvider* resourceProvider,
+                                                           AtlasID* id,
+                                                           GrDeferredUploadTarget* target,
+                                                           int width, int height,
+                                                           const void* image, SkIPoint16* loc) {
     if (width > fPlotWidth || height > fPlotHeight) {
         return ErrorCode::kError;
     }
@@ -276,26 +409,20 @@ GrDrawOpAtlas::ErrorCode GrDrawOpAtlas::addToAtlas(GrResourceProvider* resourceP
         }
     }
 
-    // If the above fails, then see if the least recently used plot per page has already been
-    // flushed to the gpu if we're at max page allocation, or if the plot has aged out otherwise.
+    // If the above fails, then see if any plot has already been flushed to the gpu if we're at
+    // max page allocation, or if the plot has aged out otherwise, and evict the one used least.
     // We wait until we've grown to the full number of pages to begin evicting already flushed
     // plots so that we can maximize the opportunity for reuse.
-    // As before we prioritize this upload to the first pages, not the most recently used.
     if (fNumActivePages == this->maxPages()) {
-        for (unsigned int pageIdx = 0; pageIdx < fNumActivePages; ++pageIdx) {
-            Plot* plot = fPages[pageIdx].fPlotList.tail();
-            SkASSERT(plot);
-            if (plot->lastUseToken() < target->tokenTracker()->nextTokenToFlush() ||
-                plot->flushesSinceLastUsed() >= kRecentlyUsedCount) {
-                this->processEvictionAndResetRects(plot);
-                SkASSERT(GrBytesPerPixel(fProxies[pageIdx]->config()) == plot->bpp());
-                SkDEBUGCODE(bool verify = )plot->addSubImage(width, height, image, loc);
-                SkASSERT(verify);
-                if (!this->updatePlot(target, id, plot)) {
-                    return ErrorCode::kError;
-                }
-                return ErrorCode::kSucceeded;
+        if (Plot* plot = this->findPlotToEvict(target->tokenTracker()->nextTokenToFlush())) {
+            this->processEvictionAndResetRects(plot);
+            SkASSERT(GrBytesPerPixel(fPixelConfig) == plot->bpp());
+            SkDEBUGCODE(bool verify = )plot->addSubImage(width, height, image, loc);
+            SkASSERT(verify);
+            if (!this->updatePlot(target, id, plot)) {
+                return ErrorCode::kError;
             }
+            return ErrorCode::kSucceeded;
         }
     } else {
         // If we haven't activated all the available pages, try to create a new one and add to it
@@ -367,11 +494,6 @@ GrDrawOpAtlas::ErrorCode GrDrawOpAtlas::addToAtlas(GrResourceProvider* resourceP
 }
 
 void GrDrawOpAtlas::compact(GrDeferredUploadToken startTokenForNextFlush) {
-    if (fNumActivePages <= 1) {
-        fPrevFlushToken = startTokenForNextFlush;
-        return;
-    }
-
     // For all plots, reset number of flushes since used if used this frame.
     PlotList::Iter plotIter;
     bool atlasUsedThisFlush = false;
@@ -388,6 +510,23 @@ void GrDrawOpAtlas::compact(GrDeferredUploadToken startTokenForNextFlush) {
         }
     }
 
+    // Like the counts above, use scores only change with flushes that used the atlas.
+    if (atlasUsedThisFlush) {
+        for (uint32_t pageIndex = 0; pageIndex < fNumActivePages; ++pageIndex) {
+            plotIter.init(fPages[pageIndex].fPlotList, PlotList::Iter::kHead_IterStart);
+            while (Plot* plot = plotIter.get()) {
+                plot->updateUseScore(
+                        plot->lastUseToken().inInterval(fPrevFlushToken, startTokenForNextFlush));
+                plotIter.next();
+            }
+        }
+    }
+
+    if (fNumActivePages <= 1) {
+        fPrevFlushToken = startTokenForNextFlush;
+        return;
+    }
+
     // We only try to compact if the atlas was used in the recently completed flush.
     // This is to handle the case where a lot of text or path rendering has occurred but then just
     // a blinking cursor is drawn.
@@ -471,9 +610,9 @@ void GrDrawOpAtlas::compact(GrDeferredUploadToken startTokenForNextFlush) {
 #endif
 
         // If recently used plots in the last page are using less than a quarter of the page, try
-        // to evict them if there's available space in earlier pages. Since we prioritize uploading
-        // to the first pages, this will eventually clear out usage of this page unless we have a
-        // large need.
+        // to move them to available space in earlier pages, or else to evict them. Since we
+        // prioritize uploading to the first pages, this will eventually clear out usage of this
+        // page unless we have a large need.
         if (availablePlots.count() && usedPlots && usedPlots <= fNumPlots / 4) {
             plotIter.init(fPages[lastPageIndex].fPlotList, PlotList::Iter::kHead_IterStart);
             while (Plot* plot = plotIter.get()) {
@@ -483,8 +622,13 @@ void GrDrawOpAtlas::compact(GrDeferredUploadToken startTokenForNextFlush) {
                     // We need to be somewhat harsh here so that a handful of plots that are
                     // consistently in use don't end up locking the page in memory.
                     if (availablePlots.count() > 0) {
-                        this->processEvictionAndResetRects(plot);
-                        this->processEvictionAndResetRects(availablePlots.back());
+                        if (this->canRelocate() && plot->fData) {
+                            // Moving the plot saves its users from regenerating its contents.
+                            this->relocatePlot(plot, availablePlots.back());
+                        } else {
+                            this->processEvictionAndResetRects(plot);
+                            this->processEvictionAndResetRects(availablePlots.back());
+                        }
                         availablePlots.pop_back();
                         --usedPlots;
                     }
@@ -557,6 +701,8 @@ bool GrDrawOpAtlas::activateNewPage(GrResourceProvider* resourceProvider) {
     if (!fProxies[fNumActivePages]->instantiate(resourceProvider)) {
         return false;
     }
+    fProxies[fNumActivePages]->peekTexture()->resourcePriv().setPurgePriority(
+            GrGpuResource::PurgePriority::kGlyphAtlas);
 
 #ifdef DUMP_ATLAS_DATA
     if (gDumpAtlasData) {
@@ -564,6 +710,7 @@ bool GrDrawOpAtlas::activateNewPage(GrResourceProvider* resourceProvider) {
     }
 #endif
 
+    SkMemoryCounters::Add(SkGraphics::MemoryCounters::kGrDrawOpAtlas, this->pageBytes());
     ++fNumActivePages;
     return true;
 }
@@ -595,15 +742,17 @@ inline void GrDrawOpAtlas::deactivateLastPage() {
 
     // remove ref to the backing texture
     fProxies[lastPageIndex]->deInstantiate();
+    SkMemoryCounters::Remove(SkGraphics::MemoryCounters::kGrDrawOpAtlas, this->pageBytes());
     --fNumActivePages;
 }
 
 GrDrawOpAtlasConfig::GrDrawOpAtlasConfig(int maxDimension, size_t maxBytes)
-        : fPlotsPerLongDimension{PlotsPerLongDimensionForARGB(maxDimension)} {
+        : fPlotsPerLongDimension{PlotsPerLongDimensionForARGB(maxDimension)}
+        , fMaxBytes{maxBytes} {
     SkASSERT(kPlotSize >= SkGlyphCacheCommon::kSkSideTooBigForAtlas);
 }
 
-GrDrawOpAtlasConfig::GrDrawOpAtlasConfig() : fPlotsPerLongDimension{1} {
+GrDrawOpAtlasConfig::GrDrawOpAtlasConfig() : fPlotsPerLongDimension{1}, fMaxBytes{SIZE_MAX} {
     SkASSERT(kPlotSize >= SkGlyphCacheCommon::kSkSideTooBigForAtlas);
 }
 
@@ -636,6 +785,13 @@ SkISize GrDrawOpAtlasConfig::atlasDimensions(GrMaskFormat type) const {
     return {plots.width() * kPlotSize, plots.height() * kPlotSize};
 }
 
+uint32_t GrDrawOpAtlasConfig::maxPages(GrMaskFormat type) const {
+    SkISize dimensions = this->atlasDimensions(type);
+    size_t pageBytes = dimensions.width() * dimensions.height() * GrMaskFormatBytesPerPixel(type);
+    return (uint32_t)SkTPin<size_t>(fMaxBytes / pageBytes, 1,
+                                    GrDrawOpAtlas::kMaxMultitexturePages);
+}
+
 int GrDrawOpAtlasConfig::PlotsPerLongDimensionForARGB(int maxDimension) {
 
     SkASSERT(maxDimension > 0);
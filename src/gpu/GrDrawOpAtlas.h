@@ -13,6 +13,7 @@
 #include "SkGlyphRunPainter.h"
 #include "SkIPoint16.h"
 #include "SkSize.h"
+#include "SkTArray.h"
 #include "SkTDArray.h"
 #include "SkTInternalLList.h"
 
@@ -20,6 +21,7 @@
 
 class GrOnFlushResourceProvider;
 class GrRectanizer;
+class SkTraceMemoryDump;
 
 
 /**
@@ -48,14 +50,12 @@ class GrRectanizer;
  * and passes in the given GrDrawUploadToken.
  */
 class GrDrawOpAtlas {
-private:
-    static constexpr auto kMaxMultitexturePages = 4;
-
-
 public:
     /** Is the atlas allowed to use more than one texture? */
     enum class AllowMultitexturing : bool { kNo, kYes };
 
+    static constexpr auto kMaxMultitexturePages = 4;
+
     static constexpr int kMaxPlots = 32;
 
     /**
@@ -73,6 +73,14 @@ public:
      */
     typedef void (*EvictionFunc)(GrDrawOpAtlas::AtlasID, void*);
 
+    /**
+     * A function pointer for use as a callback when GrDrawOpAtlas compacts its pages by moving the
+     * contents of a plot into another one. Everything that was stored under the 'from' AtlasID is
+     * now stored under 'to', and its location in the backing textures has moved by 'offset'.
+     */
+    typedef void (*RelocationFunc)(GrDrawOpAtlas::AtlasID from, GrDrawOpAtlas::AtlasID to,
+                                   SkIPoint16 offset, void*);
+
     /**
      * Returns a GrDrawOpAtlas. This function can be called anywhere, but the returned atlas
      * should only be used inside of GrMeshDrawOp::onPrepareDraws.
@@ -88,6 +96,8 @@ public:
      *                          evict data
      *  @param data             User supplied data which will be passed into func whenever an
      *                          eviction occurs
+     *  @param maxPages         The most textures the atlas may grow to if multitexturing is
+     *                          allowed
      *  @return                 An initialized GrDrawOpAtlas, or nullptr if creation fails
      */
     static std::unique_ptr<GrDrawOpAtlas> Make(GrProxyProvider*,
@@ -96,7 +106,8 @@ public:
                                                int width, int height,
                                                int numPlotsX, int numPlotsY,
                                                AllowMultitexturing allowMultitexturing,
-                                               GrDrawOpAtlas::EvictionFunc func, void* data);
+                                               GrDrawOpAtlas::EvictionFunc func, void* data,
+                                               uint32_t maxPages = kMaxMultitexturePages);
 
     /**
      * Adds a width x height subimage to the atlas. Upon success it returns 'kSucceeded' and returns
@@ -157,6 +168,31 @@ public:
         data->fData = userData;
     }
 
+    /**
+     * The atlas only compacts by moving plots if every client that registered an eviction
+     * callback has registered a relocation callback too. Otherwise it evicts them.
+     */
+    inline void registerRelocationCallback(RelocationFunc func, void* userData) {
+        RelocationData* data = fRelocationCallbacks.append();
+        data->fFunc = func;
+        data->fData = userData;
+    }
+
+    /**
+     * Plots moved by compact() must be uploaded to their new place before anything is drawn from
+     * them. Clients that register a relocation callback call this whenever a change in
+     * atlasGeneration() makes them look up their entries' locations again.
+     */
+    void uploadRelocatedPlots(GrDeferredUploadTarget*);
+
+    struct Stats {
+        size_t fUploadBytes = 0;  ///< bytes of subimages and moved plots uploaded to the textures
+        int    fEvictions = 0;    ///< plots whose contents were evicted
+        int    fRelocations = 0;  ///< plots moved to an earlier page by compact()
+    };
+
+    const Stats& stats() const { return fStats; }
+
     uint32_t numActivePages() { return fNumActivePages; }
 
     /**
@@ -241,10 +277,17 @@ public:
     int numAllocated_TestingOnly() const;
     void setMaxPages_TestingOnly(uint32_t maxPages);
 
+    /**
+     * Dumps the size and plot occupancy of each active page, under "<dumpName>/page_<n>".
+     */
+    void dumpMemoryStatistics(SkTraceMemoryDump*, const char* dumpName) const;
+
+    ~GrDrawOpAtlas();
+
 private:
     GrDrawOpAtlas(GrProxyProvider*, const GrBackendFormat& format, GrPixelConfig, int width,
                   int height, int numPlotsX, int numPlotsY,
-                  AllowMultitexturing allowMultitexturing);
+                  AllowMultitexturing allowMultitexturing, uint32_t maxPages);
 
     /**
      * The backing GrTexture for a GrDrawOpAtlas is broken into a spatial grid of Plots. The Plots
@@ -287,10 +330,20 @@ private:
         void uploadToTexture(GrDeferredTextureUploadWritePixelsFn&, GrTextureProxy*);
         void resetRects();
 
+        /** The fraction of this plot's area covered by subimages, from 0 to 1. */
+        float occupancy() const;
+
         int flushesSinceLastUsed() { return fFlushesSinceLastUse; }
         void resetFlushesSinceLastUsed() { fFlushesSinceLastUse = 0; }
         void incFlushesSinceLastUsed() { fFlushesSinceLastUse++; }
 
+        /**
+         * How much this plot has been used lately: a count of the flushes it was used in that
+         * decays with each flush that uses the atlas. Eviction prefers plots with low scores.
+         */
+        uint32_t useScore() const { return fUseScore; }
+        void updateUseScore(bool usedThisFlush);
+
     private:
         Plot(int pageIndex, int plotIndex, uint64_t genID, int offX, int offY, int width, int height,
              GrPixelConfig config);
@@ -318,6 +371,7 @@ private:
         GrDeferredUploadToken fLastUse;
         // the number of flushes since this plot has been last used
         int                   fFlushesSinceLastUse;
+        uint32_t              fUseScore;
 
         struct {
             const uint32_t fPageIndex : 16;
@@ -353,8 +407,18 @@ private:
         return (id >> 16) & 0xffffffffffff;
     }
 
+    ErrorCode internalAddToAtlas(GrResourceProvider*, AtlasID*, GrDeferredUploadTarget*,
+                                 int width, int height, const void* image, SkIPoint16* loc);
+
     inline bool updatePlot(GrDeferredUploadTarget*, AtlasID*, Plot*);
 
+    Plot* findPlotToEvict(GrDeferredUploadToken nextTokenToFlush);
+    bool canRelocate() const {
+        return fRelocationCallbacks.count() &&
+               fRelocationCallbacks.count() >= fEvictionCallbacks.count();
+    }
+    void relocatePlot(Plot* from, Plot* to);
+
     inline void makeMRU(Plot* plot, int pageIdx) {
         if (fPages[pageIdx].fPlotList.head() == plot) {
             return;
@@ -372,6 +436,9 @@ private:
 
     bool createPages(GrProxyProvider*);
     bool activateNewPage(GrResourceProvider*);
+    size_t pageBytes() const {
+        return (size_t)fTextureWidth * fTextureHeight * GrBytesPerPixel(fPixelConfig);
+    }
     void deactivateLastPage();
 
     void processEviction(AtlasID);
@@ -399,6 +466,22 @@ private:
 
     SkTDArray<EvictionData> fEvictionCallbacks;
 
+    struct RelocationData {
+        RelocationFunc fFunc;
+        void* fData;
+    };
+
+    SkTDArray<RelocationData> fRelocationCallbacks;
+
+    // Plots that compact() moved, and their generations then, which still need to be uploaded.
+    struct RelocatedPlot {
+        sk_sp<Plot> fPlot;
+        uint64_t fGenID;
+    };
+    SkTArray<RelocatedPlot> fRelocatedPlots;
+
+    Stats fStats;
+
     struct Page {
         // allocated array of Plots
         std::unique_ptr<sk_sp<Plot>[]> fPlotArray;
@@ -428,6 +511,10 @@ public:
 
     SkISize atlasDimensions(GrMaskFormat type) const;
 
+    // The most pages an atlas may grow to without its textures exceeding the maximum bytes.
+    // Every atlas gets at least one page.
+    uint32_t maxPages(GrMaskFormat type) const;
+
     static int PlotsPerLongDimensionForARGB(int maxDimension);
 
 private:
@@ -439,6 +526,8 @@ private:
 
     // This is the height (longest dimension) of the ARGB atlas divided by the plot size.
     const int fPlotsPerLongDimension;
+
+    const size_t fMaxBytes;
 };
 
 #endif
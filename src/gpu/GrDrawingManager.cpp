@@ -13,6 +13,7 @@
 #include "GrMemoryPool.h"
 #include "GrOnFlushResourceProvider.h"
 #include "GrOpList.h"
+#include "GrReducedClip.h"
 #include "GrRenderTargetContext.h"
 #include "GrRenderTargetProxy.h"
 #include "GrResourceAllocator.h"
@@ -26,10 +27,13 @@
 #include "GrTextureProxy.h"
 #include "GrTextureProxyPriv.h"
 #include "GrTracing.h"
+#include "SkAutoPixmapStorage.h"
+#include "SkConvertPixels.h"
 #include "SkDeferredDisplayList.h"
 #include "SkSurface_Gpu.h"
 #include "SkTTopoSort.h"
 #include "ccpr/GrCoverageCountingPathRenderer.h"
+#include "text/GrTextBlobCache.h"
 #include "text/GrTextContext.h"
 
 GrDrawingManager::OpListDAG::OpListDAG(bool explicitlyAllocating,
@@ -173,9 +177,62 @@ GrDrawingManager::GrDrawingManager(GrContext* context,
     }
 }
 
+// Maps the read's planes, converts them to what was asked for if need be, and calls its callback
+// with them. Calls it with nullptr if !succeeded or anything fails.
+static void deliver_async_read(const GrDrawingManager::AsyncRead& read, bool succeeded) {
+    const int planeCount = read.fPlanes.count();
+    SkASSERT(planeCount == (read.fCallbackYUV420 ? 3 : 1));
+
+    const void* data[3] = {nullptr, nullptr, nullptr};
+    size_t rowBytes[3] = {0, 0, 0};
+    SkAutoPixmapStorage converted[3];
+    for (int i = 0; succeeded && i < planeCount; ++i) {
+        const GrDrawingManager::AsyncRead::Plane& plane = read.fPlanes[i];
+        const void* mapped = plane.fBuffer->map();
+        if (!mapped) {
+            succeeded = false;
+            break;
+        }
+        data[i] = mapped;
+        rowBytes[i] = plane.fBufferInfo.minRowBytes();
+        if (plane.fBufferInfo != plane.fDstInfo) {
+            if (!converted[i].tryAlloc(plane.fDstInfo)) {
+                succeeded = false;
+                break;
+            }
+            SkConvertPixels(plane.fDstInfo, converted[i].writable_addr(), converted[i].rowBytes(),
+                            plane.fBufferInfo, data[i], rowBytes[i]);
+            data[i] = converted[i].addr();
+            rowBytes[i] = converted[i].rowBytes();
+        }
+    }
+
+    if (read.fCallbackYUV420) {
+        read.fCallbackYUV420(read.fContext, succeeded ? data : nullptr,
+                             succeeded ? rowBytes : nullptr);
+    } else {
+        read.fCallback(read.fContext, succeeded ? data[0] : nullptr, succeeded ? rowBytes[0] : 0);
+    }
+
+    for (const GrDrawingManager::AsyncRead::Plane& plane : read.fPlanes) {
+        if (plane.fBuffer && plane.fBuffer->isMapped()) {
+            plane.fBuffer->unmap();
+        }
+    }
+}
+
 void GrDrawingManager::cleanup() {
     fDAG.cleanup(fContext->contextPriv().caps());
 
+    // Reads that haven't finished fail, after which their buffers can go.
+    for (const AsyncRead& read : fAsyncReads) {
+        if (!fAbandoned) {
+            fContext->contextPriv().getGpu()->deleteFence(read.fFence);
+        }
+        deliver_async_read(read, false);
+    }
+    fAsyncReads.clear();
+
     fPathRendererChain = nullptr;
     fSoftwarePathRenderer = nullptr;
 
@@ -191,6 +248,33 @@ void GrDrawingManager::abandon() {
     this->cleanup();
 }
 
+void GrDrawingManager::addAsyncRead(AsyncRead&& read) {
+    fAsyncReads.push_back(std::move(read));
+}
+
+void GrDrawingManager::checkAsyncReads() {
+    if (fAsyncReads.empty() || this->wasAbandoned()) {
+        return;
+    }
+    GrGpu* gpu = fContext->contextPriv().getGpu();
+    // Fences signal in order, so stop at the first read that hasn't finished. The finished reads
+    // are taken out of the list first, in case a callback starts another read.
+    size_t finished = 0;
+    while (finished < fAsyncReads.size() && gpu->waitFence(fAsyncReads[finished].fFence, 0)) {
+        gpu->deleteFence(fAsyncReads[finished].fFence);
+        ++finished;
+    }
+    if (!finished) {
+        return;
+    }
+    std::vector<AsyncRead> reads(std::make_move_iterator(fAsyncReads.begin()),
+                                 std::make_move_iterator(fAsyncReads.begin() + finished));
+    fAsyncReads.erase(fAsyncReads.begin(), fAsyncReads.begin() + finished);
+    for (const AsyncRead& read : reads) {
+        deliver_async_read(read, true);
+    }
+}
+
 void GrDrawingManager::freeGpuResources() {
     for (int i = fOnFlushCBObjects.count() - 1; i >= 0; --i) {
         if (!fOnFlushCBObjects[i]->retainOnFreeGpuResources()) {
@@ -202,6 +286,9 @@ void GrDrawingManager::freeGpuResources() {
     // a path renderer may be holding onto resources
     fPathRendererChain = nullptr;
     fSoftwarePathRenderer = nullptr;
+
+    // The cached reductions hold FPs and clip elements (paths) that can be rebuilt when needed.
+    fReducedClipCache = nullptr;
 }
 
 // MDB TODO: make use of the 'proxy' parameter.
@@ -282,6 +369,10 @@ GrSemaphoresSubmitted GrDrawingManager::flush(GrSurfaceProxy*,
     int startIndex, stopIndex;
     bool flushed = false;
 
+    // Fulfill the replayed DDLs' promise textures in batches, before the allocator instantiates
+    // their proxies one at a time.
+    GrPromiseTextureBatcher::FulfillAll(fPromiseTextures);
+
     {
         GrResourceAllocator alloc(fContext->contextPriv().resourceProvider(),
                                   flushState.uninstantiateProxyTracker());
@@ -310,6 +401,7 @@ GrSemaphoresSubmitted GrDrawingManager::flush(GrSurfaceProxy*,
                 flushed = true;
             }
         }
+        fLastFlushPeakTransientBytes = alloc.peakTransientBytes();
     }
 
 #ifdef SK_DEBUG
@@ -335,9 +427,17 @@ GrSemaphoresSubmitted GrDrawingManager::flush(GrSurfaceProxy*,
 
     flushState.uninstantiateProxyTracker()->uninstantiateAllProxies();
 
-    // Give the cache a chance to purge resources that become purgeable due to flushing.
+    // Now that the promise textures' proxies have let go of them, hand the releases to the client.
+    GrPromiseTextureBatcher::FinishFlush(fPromiseTextures);
+    fPromiseTextures.reset();
+
+    // Give the cache a chance to purge resources that become purgeable due to flushing, and
+    // those that have gone unused for too long.
     if (flushed) {
-        fContext->contextPriv().getResourceCache()->purgeAsNeeded();
+        fContext->contextPriv().getResourceCache()->notifyFlushOccurred();
+    }
+    if (GrTextBlobCache* textBlobCache = fContext->contextPriv().getTextBlobCache()) {
+        textBlobCache->postFlush();
     }
     for (GrOnFlushCallbackObject* onFlushCBObject : fOnFlushCBObjects) {
         onFlushCBObject->postFlush(fTokenTracker.nextTokenToFlush(), fFlushingOpListIDs.begin(),
@@ -346,6 +446,8 @@ GrSemaphoresSubmitted GrDrawingManager::flush(GrSurfaceProxy*,
     fFlushingOpListIDs.reset();
     fFlushing = false;
 
+    this->checkAsyncReads();
+
     return result;
 }
 
@@ -511,6 +613,7 @@ void GrDrawingManager::copyOpListsFromDDL(const SkDeferredDisplayList* ddl,
     }
 
     fDAG.add(ddl->fOpLists);
+    fPromiseTextures.push_back_n(ddl->fPromiseTextures.count(), ddl->fPromiseTextures.begin());
 
     SkDEBUGCODE(this->validate());
 }
@@ -671,6 +774,13 @@ GrCoverageCountingPathRenderer* GrDrawingManager::getCoverageCountingPathRendere
     return fPathRendererChain->getCoverageCountingPathRenderer();
 }
 
+GrReducedClipCache* GrDrawingManager::getReducedClipCache() {
+    if (!fReducedClipCache) {
+        fReducedClipCache.reset(new GrReducedClipCache);
+    }
+    return fReducedClipCache.get();
+}
+
 void GrDrawingManager::flushIfNecessary() {
     GrResourceCache* resourceCache = fContext->contextPriv().getResourceCache();
     if (resourceCache && resourceCache->requestsFlush()) {
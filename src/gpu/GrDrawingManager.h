@@ -8,17 +8,23 @@
 #ifndef GrDrawingManager_DEFINED
 #define GrDrawingManager_DEFINED
 
+#include "GrBuffer.h"
 #include "GrDeferredUpload.h"
 #include "GrPathRenderer.h"
 #include "GrPathRendererChain.h"
+#include "GrPromiseTextureBatcher.h"
 #include "GrResourceCache.h"
+#include "SkSurface.h"
 #include "SkTArray.h"
 #include "text/GrTextContext.h"
 
+#include <vector>
+
 class GrContext;
 class GrCoverageCountingPathRenderer;
 class GrOnFlushCallbackObject;
 class GrOpFlushState;
+class GrReducedClipCache;
 class GrRenderTargetContext;
 class GrRenderTargetProxy;
 class GrSingleOWner;
@@ -68,8 +74,14 @@ public:
     // supported and turned on.
     GrCoverageCountingPathRenderer* getCoverageCountingPathRenderer();
 
+    // Recently used clip stack reductions, shared by every GrClipStackClip drawn in this context.
+    GrReducedClipCache* getReducedClipCache();
+
     void flushIfNecessary();
 
+    // The most bytes of surfaces the last flush allocated to its proxies that were in use at once.
+    size_t lastFlushPeakTransientBytes() const { return fLastFlushPeakTransientBytes; }
+
     static bool ProgramUnitTest(GrContext* context, int maxStages, int maxLevels);
 
     GrSemaphoresSubmitted prepareSurfaceForExternalIO(GrSurfaceProxy*,
@@ -82,6 +94,26 @@ public:
     void moveOpListsToDDL(SkDeferredDisplayList* ddl);
     void copyOpListsFromDDL(const SkDeferredDisplayList*, GrRenderTargetProxy* newDest);
 
+    // A readback of an RGBA image, or of Y, U and V planes, that GrRenderTargetContext copied
+    // into transfer buffers. Its callback gets the pixels once its fence has signaled.
+    struct AsyncRead {
+        struct Plane {
+            sk_sp<GrBuffer> fBuffer;      // Tightly packed rows of fBufferInfo's pixels.
+            SkImageInfo     fBufferInfo;
+            SkImageInfo     fDstInfo;     // What the callback gets, converted if need be.
+        };
+        GrFence                             fFence;
+        SkSTArray<3, Plane>                 fPlanes;
+        SkSurface::ReadPixelsCallback       fCallback = nullptr;
+        SkSurface::ReadPixelsCallbackYUV420 fCallbackYUV420 = nullptr;
+        SkSurface::ReadPixelsContext        fContext = nullptr;
+    };
+    void addAsyncRead(AsyncRead&&);
+
+    // Calls the callbacks of the async reads whose fences have signaled. This happens at the end
+    // of every flush, and in GrContext::checkAsyncWorkCompletion().
+    void checkAsyncReads();
+
 private:
     // This class encapsulates maintenance and manipulation of the drawing manager's DAG of opLists.
     class OpListDAG {
@@ -171,17 +203,25 @@ private:
     SkSTArray<8, uint32_t, true>      fFlushingOpListIDs;
     // These are the new opLists generated by the onFlush CBs
     SkSTArray<8, sk_sp<GrOpList>>     fOnFlushCBOpLists;
+    // The promise textures of the DDLs replayed since the last flush
+    SkTArray<sk_sp<GrPromiseTextureBatcher::Texture>> fPromiseTextures;
 
     std::unique_ptr<GrTextContext>    fTextContext;
 
     std::unique_ptr<GrPathRendererChain> fPathRendererChain;
     sk_sp<GrSoftwarePathRenderer>     fSoftwarePathRenderer;
 
+    std::unique_ptr<GrReducedClipCache> fReducedClipCache;
+
     GrTokenTracker                    fTokenTracker;
     bool                              fFlushing;
     bool                              fReduceOpListSplitting;
+    size_t                            fLastFlushPeakTransientBytes = 0;
 
     SkTArray<GrOnFlushCallbackObject*> fOnFlushCBObjects;
+
+    // In the order they were issued, which is the order their fences signal in.
+    std::vector<AsyncRead>            fAsyncReads;
 };
 
 #endif
@@ -374,7 +374,8 @@ private:
 
     SkSTArray<4, const GrCoordTransform*, true> fCoordTransforms;
 
-    SkSTArray<1, std::unique_ptr<GrFragmentProcessor>, true> fChildProcessors;
+    // Compose and blend processors have two children, which shouldn't need a separate allocation.
+    SkSTArray<2, std::unique_ptr<GrFragmentProcessor>, true> fChildProcessors;
 
     typedef GrProcessor INHERITED;
 };
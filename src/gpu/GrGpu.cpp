@@ -292,6 +292,29 @@ bool GrGpu::transferPixels(GrTexture* texture, int left, int top, int width, int
     return false;
 }
 
+bool GrGpu::transferPixelsFrom(GrSurface* surface, int left, int top, int width, int height,
+                               GrColorType dstColorType, GrBuffer* transferBuffer,
+                               size_t offset) {
+    SkASSERT(surface);
+    SkASSERT(transferBuffer);
+    SkASSERT(this->caps()->transferFromSurfaceToBufferSupport());
+
+    // We require that the read region is contained in the surface
+    SkIRect subRect = SkIRect::MakeXYWH(left, top, width, height);
+    SkIRect bounds = SkIRect::MakeWH(surface->width(), surface->height());
+    if (!bounds.contains(subRect)) {
+        return false;
+    }
+    if (transferBuffer->sizeInBytes() <
+        offset + (size_t)width * height * GrColorTypeBytesPerPixel(dstColorType)) {
+        return false;
+    }
+
+    this->handleDirtyContext();
+    return this->onTransferPixelsFrom(surface, left, top, width, height, dstColorType,
+                                      transferBuffer, offset);
+}
+
 bool GrGpu::regenerateMipMapLevels(GrTexture* texture) {
     SkASSERT(texture);
     SkASSERT(this->caps()->mipMapSupport());
@@ -214,6 +214,25 @@ public:
                         GrColorType bufferColorType, GrBuffer* transferBuffer, size_t offset,
                         size_t rowBytes);
 
+    /**
+     * Starts copying a rectangle of a surface's pixels into a buffer, in tightly packed rows from
+     * top to bottom, without waiting for the GPU. The pixels can be read from the buffer once a
+     * fence inserted after this call has signaled. Only supported if the caps'
+     * transferFromSurfaceToBufferSupport() is true.
+     *
+     * @param surface          The surface to read from.
+     * @param left             left edge of the rectangle to read (inclusive)
+     * @param top              top edge of the rectangle to read (inclusive)
+     * @param width            width of rectangle to read in pixels.
+     * @param height           height of rectangle to read in pixels.
+     * @param dstColorType     the color type of the pixels written to the buffer. This must be
+     *                         the caps' supportedReadPixelsColorType() for the surface's config.
+     * @param transferBuffer   GrBuffer to write pixels to (type must be "kXferGpuToCpu")
+     * @param offset           offset from the start of the buffer
+     */
+    bool transferPixelsFrom(GrSurface* surface, int left, int top, int width, int height,
+                            GrColorType dstColorType, GrBuffer* transferBuffer, size_t offset);
+
     // After the client interacts directly with the 3D context state the GrGpu
     // must resync its internal state and assumptions about 3D context state.
     // Each time this occurs the GrGpu bumps a timestamp.
@@ -263,6 +282,11 @@ public:
     virtual bool waitFence(GrFence, uint64_t timeout = 1000) = 0;
     virtual void deleteFence(GrFence) const = 0;
 
+    // Waits for a timer query started by GrGpuRTCommandBuffer::beginTimerQuery() to finish. Returns
+    // false if its result is unusable, e.g. the GPU was reset or its clock changed meanwhile.
+    virtual bool getTimerQueryResult(GrTimerQuery, uint64_t* nanos) { return false; }
+    virtual void deleteTimerQuery(GrTimerQuery) {}
+
     virtual sk_sp<GrSemaphore> SK_WARN_UNUSED_RESULT makeSemaphore(bool isOwned = true) = 0;
     virtual sk_sp<GrSemaphore> wrapBackendSemaphore(const GrBackendSemaphore& semaphore,
                                                     GrResourceProvider::SemaphoreWrapType wrapType,
@@ -277,6 +301,22 @@ public:
      */
     virtual sk_sp<GrSemaphore> prepareTextureForCrossContextUsage(GrTexture*) = 0;
 
+    // Writes the VkPipelineCache to the PersistentCache. Only the Vulkan backend has one.
+    virtual void storeVkPipelineCacheData() {}
+
+    // Number of programs whose compilation is still in progress in the background.
+    virtual int numPendingPrograms() const { return 0; }
+
+    // Returns how many 64-bit keys a vertex buffer passed to sortKeys() must have room for in
+    // order to sort 'count' keys, or 0 if this GPU can't sort keys. Only the Vulkan backend can,
+    // when Skia is built with skia_use_hotsort.
+    virtual int sortKeysBufferCount(int count) { return 0; }
+
+    // Sorts the first 'count' 64-bit keys of a vertex buffer in place, in ascending order. The
+    // sort executes after the commands already issued and before the ops of the next flush, so
+    // it has to be issued from outside of op execution (e.g. preFlush).
+    virtual void sortKeys(GrBuffer* keys, int count) { SK_ABORT("This GPU can't sort keys."); }
+
     ///////////////////////////////////////////////////////////////////////////
     // Debugging and Stats
 
@@ -294,6 +334,9 @@ public:
             fStencilAttachmentCreates = 0;
             fNumDraws = 0;
             fNumFailedDraws = 0;
+            fNumDrawsSkippedForPendingPrograms = 0;
+            fUniformUploads = 0;
+            fUniformUploadsSkipped = 0;
         }
 
         int renderTargetBinds() const { return fRenderTargetBinds; }
@@ -309,10 +352,20 @@ public:
         void incStencilAttachmentCreates() { fStencilAttachmentCreates++; }
         void incNumDraws() { fNumDraws++; }
         void incNumFailedDraws() { ++fNumFailedDraws; }
+        void incNumDrawsSkippedForPendingPrograms() { ++fNumDrawsSkippedForPendingPrograms; }
+        // Uniform uploads requested by processors, and those that were dropped because the
+        // program already held the values.
+        int uniformUploads() const { return fUniformUploads; }
+        void incUniformUploads() { ++fUniformUploads; }
+        int uniformUploadsSkipped() const { return fUniformUploadsSkipped; }
+        void incUniformUploadsSkipped() { ++fUniformUploadsSkipped; }
         void dump(SkString*);
         void dumpKeyValuePairs(SkTArray<SkString>* keys, SkTArray<double>* values);
         int numDraws() const { return fNumDraws; }
         int numFailedDraws() const { return fNumFailedDraws; }
+        int numDrawsSkippedForPendingPrograms() const {
+            return fNumDrawsSkippedForPendingPrograms;
+        }
     private:
         int fRenderTargetBinds;
         int fShaderCompilations;
@@ -322,6 +375,9 @@ public:
         int fStencilAttachmentCreates;
         int fNumDraws;
         int fNumFailedDraws;
+        int fNumDrawsSkippedForPendingPrograms;
+        int fUniformUploads;
+        int fUniformUploadsSkipped;
 #else
         void dump(SkString*) {}
         void dumpKeyValuePairs(SkTArray<SkString>*, SkTArray<double>*) {}
@@ -333,6 +389,9 @@ public:
         void incStencilAttachmentCreates() {}
         void incNumDraws() {}
         void incNumFailedDraws() {}
+        void incNumDrawsSkippedForPendingPrograms() {}
+        void incUniformUploads() {}
+        void incUniformUploadsSkipped() {}
 #endif
     };
 
@@ -468,6 +527,11 @@ private:
                                   GrColorType colorType, GrBuffer* transferBuffer, size_t offset,
                                   size_t rowBytes) = 0;
 
+    // overridden by backend-specific derived class to perform the surface to buffer transfer
+    virtual bool onTransferPixelsFrom(GrSurface*, int left, int top, int width, int height,
+                                      GrColorType colorType, GrBuffer* transferBuffer,
+                                      size_t offset) = 0;
+
     // overridden by backend-specific derived class to perform the resolve
     virtual void onResolveRenderTarget(GrRenderTarget* target) = 0;
 
@@ -123,6 +123,14 @@ public:
      */
     virtual void executeDrawable(std::unique_ptr<SkDrawable::GpuDrawHandler>) {}
 
+    /**
+     * Starts timing the commands recorded from here until endTimerQuery(). Returns 0 if the
+     * backend can't time them. Timer queries may not overlap. The result is read back with
+     * GrGpu::getTimerQueryResult().
+     */
+    virtual GrTimerQuery beginTimerQuery() { return 0; }
+    virtual void endTimerQuery(GrTimerQuery) {}
+
 protected:
     GrGpuRTCommandBuffer() : fOrigin(kTopLeft_GrSurfaceOrigin), fRenderTarget(nullptr) {}
 
@@ -22,7 +22,10 @@ static inline GrResourceCache* get_resource_cache(GrGpu* gpu) {
 }
 
 GrGpuResource::GrGpuResource(GrGpu* gpu)
-    : fGpu(gpu)
+    : fFlushCntWhenBecamePurgeable(0)
+    , fPurgePriority(PurgePriority::kScratch)
+    , fPurgeablePriority(PurgePriority::kScratch)
+    , fGpu(gpu)
     , fGpuMemorySize(kInvalidGpuMemorySize)
     , fBudgeted(SkBudgeted::kNo)
     , fShouldPurgeImmediately(false)
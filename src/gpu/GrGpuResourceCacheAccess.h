@@ -58,14 +58,18 @@ private:
     void setUniqueKey(const GrUniqueKey& key) { fResource->fUniqueKey = key; }
 
     /** Called by the cache to make the unique key invalid. */
-    void removeUniqueKey() { fResource->fUniqueKey.reset(); }
+    void removeUniqueKey() {
+        fResource->fUniqueKey.reset();
+        fResource->fPurgePriority = PurgePriority::kScratch;
+    }
 
     uint32_t timestamp() const { return fResource->fTimestamp; }
     void setTimestamp(uint32_t ts) { fResource->fTimestamp = ts; }
 
-    void setTimeWhenResourceBecomePurgeable() {
+    void setTimeWhenResourceBecomePurgeable(uint32_t flushCnt) {
         SkASSERT(fResource->isPurgeable());
         fResource->fTimeWhenBecamePurgeable = GrStdSteadyClock::now();
+        fResource->fFlushCntWhenBecamePurgeable = flushCnt;
     }
     /**
      * Called by the cache to determine whether this resource should be purged based on the length
@@ -76,6 +80,26 @@ private:
         return fResource->fTimeWhenBecamePurgeable;
     }
 
+    /** The cache's flush count when the resource became purgeable. */
+    uint32_t flushCntWhenResourceBecamePurgeable() const {
+        SkASSERT(fResource->isPurgeable());
+        return fResource->fFlushCntWhenBecamePurgeable;
+    }
+
+    /**
+     * Called by the cache when the resource becomes purgeable, to fix the class it orders the
+     * resource by until it's used again. Once nothing refers to a resource without a unique key,
+     * its contents are lost and it's only good as scratch.
+     */
+    void setPurgeablePriority() {
+        SkASSERT(fResource->isPurgeable());
+        if (!fResource->getUniqueKey().isValid()) {
+            fResource->fPurgePriority = PurgePriority::kScratch;
+        }
+        fResource->fPurgeablePriority = fResource->resourcePriv().purgePriority();
+    }
+    PurgePriority purgeablePriority() const { return fResource->fPurgeablePriority; }
+
     int* accessCacheIndex() const { return &fResource->fCacheArrayIndex; }
 
     CacheAccess(GrGpuResource* resource) : fResource(resource) {}
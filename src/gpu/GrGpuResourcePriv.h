@@ -69,6 +69,25 @@ public:
      */
     void removeScratchKey() const { fResource->removeScratchKey();  }
 
+    /**
+     * Marks the resource's contents as more expensive to regenerate than those of other uniquely
+     * keyed resources, so that the cache purges it after them. This lasts until the resource
+     * loses its unique key, or becomes purgeable without one (and is then only good as scratch).
+     */
+    void setPurgePriority(PurgePriority priority) {
+        SkASSERT(priority > PurgePriority::kUniqueKey);
+        fResource->fPurgePriority = priority;
+    }
+
+    /** The class the cache would purge this resource as, were it purgeable. */
+    PurgePriority purgePriority() const {
+        if (fResource->fPurgePriority > PurgePriority::kUniqueKey) {
+            return fResource->fPurgePriority;
+        }
+        return fResource->getUniqueKey().isValid() ? PurgePriority::kUniqueKey
+                                                   : PurgePriority::kScratch;
+    }
+
 protected:
     ResourcePriv(GrGpuResource* resource) : fResource(resource) {   }
     ResourcePriv(const ResourcePriv& that) : fResource(that.fResource) {}
@@ -89,12 +89,16 @@ std::unique_ptr<GrFragmentProcessor> GrYUVAImageTextureMaker::createFragmentProc
     bool coordsLimitedToConstraintRect,
     const GrSamplerState::Filter* filterOrNullForBicubic) {
 
-    // Check simple cases to see if we need to fall back to flattening the image
-    // TODO: See if we can relax this -- for example, if filterConstraint
-    //       is kYes_FilterConstraint we still may not need a TextureDomain
-    //       in some cases.
-    if (!textureMatrix.isIdentity() || kNo_FilterConstraint != filterConstraint ||
-        !coordsLimitedToConstraintRect || !filterOrNullForBicubic) {
+    // The planes are sampled directly unless the draw needs bicubic filtering or a texture
+    // domain, neither of which GrYUVtoRGBEffect supports; then we fall back to flattening the
+    // image. The Y plane is the size of the image, so we ask whether it would need a domain. When
+    // it doesn't, clamping to the edges of the subsampled planes is just as correct.
+    SkRect domain;
+    if (!filterOrNullForBicubic ||
+        kNoDomain_DomainMode != DetermineDomainMode(
+                constraintRect, filterConstraint, coordsLimitedToConstraintRect,
+                fImage->fProxies[fImage->fYUVAIndices[SkYUVAIndex::kY_Index].fIndex].get(),
+                filterOrNullForBicubic, &domain)) {
         return this->INHERITED::createFragmentProcessor(textureMatrix, constraintRect,
                                                         filterConstraint,
                                                         coordsLimitedToConstraintRect,
@@ -109,6 +113,6 @@ std::unique_ptr<GrFragmentProcessor> GrYUVAImageTextureMaker::createFragmentProc
     }
 
     return GrYUVtoRGBEffect::Make(fImage->fProxies, fImage->fYUVAIndices,
-                                  fImage->fYUVColorSpace, filter);
+                                  fImage->fYUVColorSpace, filter, textureMatrix);
 
 }
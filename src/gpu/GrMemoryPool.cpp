@@ -7,6 +7,7 @@
 
 #include "GrMemoryPool.h"
 #include "SkMalloc.h"
+#include "SkMemoryCounters.h"
 #include "ops/GrOp.h"
 #ifdef SK_DEBUG
     #include <atomic>
@@ -26,8 +27,13 @@ void GrOpMemoryPool::release(std::unique_ptr<GrOp> op) {
 }
 
 constexpr size_t GrMemoryPool::kSmallestMinAllocSize;
+constexpr size_t GrMemoryPool::kMaxSizeClassSize;
 
-GrMemoryPool::GrMemoryPool(size_t preallocSize, size_t minAllocSize) {
+GrMemoryPool::GrMemoryPool(size_t preallocSize, size_t minAllocSize)
+        : GrMemoryPool(preallocSize, minAllocSize, Options()) {}
+
+GrMemoryPool::GrMemoryPool(size_t preallocSize, size_t minAllocSize, const Options& options)
+        : fOptions(options) {
     SkDEBUGCODE(fAllocationCnt = 0);
     SkDEBUGCODE(fAllocBlockCnt = 0);
 
@@ -41,6 +47,10 @@ GrMemoryPool::GrMemoryPool(size_t preallocSize, size_t minAllocSize) {
     fTail = fHead;
     fHead->fNext = nullptr;
     fHead->fPrev = nullptr;
+    fWarmBlocks = nullptr;
+    for (FreeNode*& list : fFreeLists) {
+        list = nullptr;
+    }
     VALIDATE;
 };
 
@@ -62,6 +72,7 @@ GrMemoryPool::~GrMemoryPool() {
     SkASSERT(0 == fAllocationCnt);
     SkASSERT(fHead == fTail);
     SkASSERT(0 == fHead->fLiveCount);
+    this->purgeWarmBlocks();
     DeleteBlock(fHead);
 };
 
@@ -69,10 +80,29 @@ void* GrMemoryPool::allocate(size_t size) {
     VALIDATE;
     size += kPerAllocPad;
     size = GrSizeAlignUp(size, kAlignment);
+    ++fStats.fAllocations;
+    if (fOptions.fSizeClassFreeLists && size <= kMaxSizeClassSize) {
+        // Round up to the size class, so that this can be reused by anything else in it.
+        size = SkTMax<size_t>(size, kPerAllocPad + sizeof(FreeNode));
+        size = GrSizeAlignUp(size, kSizeClassStep);
+        if (FreeNode* node = fFreeLists[SizeClass(size)]) {
+            AllocHeader* allocData = reinterpret_cast<AllocHeader*>(
+                    reinterpret_cast<intptr_t>(node) - kPerAllocPad);
+            this->removeFromFreeList(allocData);
+            ++fStats.fFreeListHits;
+            void* ptr = this->assignAllocation(allocData, allocData->fHeader, allocData->fSize);
+            VALIDATE;
+            return ptr;
+        }
+    }
     if (fTail->fFreeSize < size) {
         size_t blockSize = size + kHeaderSize;
         blockSize = SkTMax<size_t>(blockSize, fMinAllocSize);
-        BlockHeader* block = CreateBlock(blockSize);
+        BlockHeader* block = this->takeWarmBlock(blockSize);
+        if (!block) {
+            block = CreateBlock(blockSize);
+            ++fStats.fBlocksCreated;
+        }
 
         block->fPrev = fTail;
         block->fNext = nullptr;
@@ -85,9 +115,17 @@ void* GrMemoryPool::allocate(size_t size) {
     SkASSERT(kAssignedMarker == fTail->fBlockSentinal);
     SkASSERT(fTail->fFreeSize >= size);
     intptr_t ptr = fTail->fCurrPtr;
+    fTail->fPrevPtr = fTail->fCurrPtr;
+    fTail->fCurrPtr += size;
+    fTail->fFreeSize -= size;
+    void* result = this->assignAllocation(reinterpret_cast<AllocHeader*>(ptr), fTail, size);
+    VALIDATE;
+    return result;
+}
+
+void* GrMemoryPool::assignAllocation(AllocHeader* allocData, BlockHeader* block, size_t size) {
     // We stash a pointer to the block header, just before the allocated space,
     // so that we can decrement the live count on delete in constant time.
-    AllocHeader* allocData = reinterpret_cast<AllocHeader*>(ptr);
     SkDEBUGCODE(allocData->fSentinal = kAssignedMarker);
     SkDEBUGCODE(allocData->fID = []{
         static std::atomic<int32_t> nextID{1};
@@ -95,15 +133,12 @@ void* GrMemoryPool::allocate(size_t size) {
     }());
     // You can set a breakpoint here when a leaked ID is allocated to see the stack frame.
     SkDEBUGCODE(fAllocatedIDs.add(allocData->fID));
-    allocData->fHeader = fTail;
-    ptr += kPerAllocPad;
-    fTail->fPrevPtr = fTail->fCurrPtr;
-    fTail->fCurrPtr += size;
-    fTail->fFreeSize -= size;
-    fTail->fLiveCount += 1;
+    allocData->fHeader = block;
+    allocData->fSize = SkToU32(size);
+    allocData->fFree = false;
+    block->fLiveCount += 1;
     SkDEBUGCODE(++fAllocationCnt);
-    VALIDATE;
-    return reinterpret_cast<void*>(ptr);
+    return reinterpret_cast<void*>(reinterpret_cast<intptr_t>(allocData) + kPerAllocPad);
 }
 
 void GrMemoryPool::release(void* p) {
@@ -116,11 +151,13 @@ void GrMemoryPool::release(void* p) {
     BlockHeader* block = allocData->fHeader;
     SkASSERT(kAssignedMarker == block->fBlockSentinal);
     if (1 == block->fLiveCount) {
+        // Everything else in the block has been released, so none of it can stay in a free list.
+        if (fOptions.fSizeClassFreeLists) {
+            this->removeFreeListEntries(block);
+        }
         // the head block is special, it is reset rather than deleted
         if (fHead == block) {
-            fHead->fCurrPtr = reinterpret_cast<intptr_t>(fHead) + kHeaderSize;
-            fHead->fLiveCount = 0;
-            fHead->fFreeSize = fHead->fSize - kHeaderSize;
+            ResetBlock(fHead);
         } else {
             BlockHeader* prev = block->fPrev;
             BlockHeader* next = block->fNext;
@@ -133,8 +170,16 @@ void GrMemoryPool::release(void* p) {
                 fTail = prev;
             }
             fSize -= block->fSize;
-            DeleteBlock(block);
             SkDEBUGCODE(fAllocBlockCnt--);
+            if (fStats.fWarmBytes + block->fSize <= fOptions.fWarmBlockBytes) {
+                ResetBlock(block);
+                block->fPrev = nullptr;
+                block->fNext = fWarmBlocks;
+                fWarmBlocks = block;
+                fStats.fWarmBytes += block->fSize;
+            } else {
+                DeleteBlock(block);
+            }
         }
     } else {
         --block->fLiveCount;
@@ -142,12 +187,76 @@ void GrMemoryPool::release(void* p) {
         if (block->fPrevPtr == ptr) {
             block->fFreeSize += (block->fCurrPtr - block->fPrevPtr);
             block->fCurrPtr = block->fPrevPtr;
+        } else if (fOptions.fSizeClassFreeLists && allocData->fSize <= kMaxSizeClassSize) {
+            this->addToFreeList(allocData);
         }
     }
     SkDEBUGCODE(--fAllocationCnt);
     VALIDATE;
 }
 
+void GrMemoryPool::addToFreeList(AllocHeader* allocData) {
+    FreeNode* node = reinterpret_cast<FreeNode*>(
+            reinterpret_cast<intptr_t>(allocData) + kPerAllocPad);
+    FreeNode*& list = fFreeLists[SizeClass(allocData->fSize)];
+    node->fPrev = nullptr;
+    node->fNext = list;
+    if (list) {
+        list->fPrev = node;
+    }
+    list = node;
+    allocData->fFree = true;
+}
+
+void GrMemoryPool::removeFromFreeList(AllocHeader* allocData) {
+    SkASSERT(allocData->fFree);
+    FreeNode* node = reinterpret_cast<FreeNode*>(
+            reinterpret_cast<intptr_t>(allocData) + kPerAllocPad);
+    if (node->fPrev) {
+        node->fPrev->fNext = node->fNext;
+    } else {
+        SkASSERT(fFreeLists[SizeClass(allocData->fSize)] == node);
+        fFreeLists[SizeClass(allocData->fSize)] = node->fNext;
+    }
+    if (node->fNext) {
+        node->fNext->fPrev = node->fPrev;
+    }
+    allocData->fFree = false;
+}
+
+void GrMemoryPool::removeFreeListEntries(BlockHeader* block) {
+    // The block's allocations are packed from its start to fCurrPtr, each headed by its size.
+    intptr_t ptr = reinterpret_cast<intptr_t>(block) + kHeaderSize;
+    while (ptr < block->fCurrPtr) {
+        AllocHeader* allocData = reinterpret_cast<AllocHeader*>(ptr);
+        if (allocData->fFree) {
+            this->removeFromFreeList(allocData);
+        }
+        ptr += allocData->fSize;
+    }
+}
+
+GrMemoryPool::BlockHeader* GrMemoryPool::takeWarmBlock(size_t blockSize) {
+    for (BlockHeader** prev = &fWarmBlocks; *prev; prev = &(*prev)->fNext) {
+        BlockHeader* block = *prev;
+        if (block->fSize >= blockSize) {
+            *prev = block->fNext;
+            fStats.fWarmBytes -= block->fSize;
+            ++fStats.fWarmBlockHits;
+            return block;
+        }
+    }
+    return nullptr;
+}
+
+void GrMemoryPool::purgeWarmBlocks() {
+    while (BlockHeader* block = fWarmBlocks) {
+        fWarmBlocks = block->fNext;
+        DeleteBlock(block);
+    }
+    fStats.fWarmBytes = 0;
+}
+
 GrMemoryPool::BlockHeader* GrMemoryPool::CreateBlock(size_t blockSize) {
     blockSize = SkTMax<size_t>(blockSize, kHeaderSize);
     BlockHeader* block =
@@ -155,17 +264,23 @@ GrMemoryPool::BlockHeader* GrMemoryPool::CreateBlock(size_t blockSize) {
     // we assume malloc gives us aligned memory
     SkASSERT(!(reinterpret_cast<intptr_t>(block) % kAlignment));
     SkDEBUGCODE(block->fBlockSentinal = kAssignedMarker);
+    block->fSize = blockSize;
+    ResetBlock(block);
+    SkMemoryCounters::Add(SkGraphics::MemoryCounters::kGrOpMemoryPool, blockSize);
+    return block;
+}
+
+void GrMemoryPool::ResetBlock(BlockHeader* block) {
     block->fLiveCount = 0;
-    block->fFreeSize = blockSize - kHeaderSize;
+    block->fFreeSize = block->fSize - kHeaderSize;
     block->fCurrPtr = reinterpret_cast<intptr_t>(block) + kHeaderSize;
     block->fPrevPtr = 0; // gcc warns on assigning nullptr to an intptr_t.
-    block->fSize = blockSize;
-    return block;
 }
 
 void GrMemoryPool::DeleteBlock(BlockHeader* block) {
     SkASSERT(kAssignedMarker == block->fBlockSentinal);
     SkDEBUGCODE(block->fBlockSentinal = kFreedMarker); // FWIW
+    SkMemoryCounters::Remove(SkGraphics::MemoryCounters::kGrOpMemoryPool, block->fSize);
     sk_free(block);
 }
 
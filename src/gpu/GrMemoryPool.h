@@ -25,6 +25,32 @@
  */
 class GrMemoryPool {
 public:
+    /**
+     * Behaviour beyond plain bump allocation, all off by default.
+     */
+    struct Options {
+        /**
+         * Keep released allocations of up to kMaxSizeClassSize bytes in free lists, one per
+         * size class, and hand them out again to allocations of the same class. Without these,
+         * space is only reclaimed when the most recent allocation or a whole block is released.
+         */
+        bool   fSizeClassFreeLists = false;
+        /**
+         * Keep up to this many bytes of blocks whose allocations have all been released, and
+         * reuse them before allocating new ones, e.g. so that the blocks freed at the end of one
+         * flush are still there for the next.
+         */
+        size_t fWarmBlockBytes = 0;
+    };
+
+    struct Stats {
+        int    fAllocations = 0;    ///< calls to allocate()
+        int    fFreeListHits = 0;   ///< allocations reusing a released one of the same class
+        int    fBlocksCreated = 0;  ///< blocks allocated from the system after the first one
+        int    fWarmBlockHits = 0;  ///< blocks reused from the warm blocks
+        size_t fWarmBytes = 0;      ///< size of the warm blocks currently kept
+    };
+
     /**
      * Prealloc size is the amount of space to allocate at pool creation
      * time and keep around until pool destruction. The min alloc size is
@@ -38,6 +64,7 @@ public:
      * portions of the allocated memory is used for internal bookkeeping.
      */
     GrMemoryPool(size_t preallocSize, size_t minAllocSize);
+    GrMemoryPool(size_t preallocSize, size_t minAllocSize, const Options& options);
 
     ~GrMemoryPool();
 
@@ -66,18 +93,44 @@ public:
      */
     size_t preallocSize() const { return fHead->fSize; }
 
+    const Stats& stats() const { return fStats; }
+
+    /**
+     * Frees the warm blocks kept for reuse by Options::fWarmBlockBytes.
+     */
+    void purgeWarmBlocks();
+
     /**
      * Minimum value of minAllocSize constructor argument.
      */
     constexpr static size_t kSmallestMinAllocSize = 1 << 10;
 
+    /**
+     * Largest allocation, including the pool's own per-allocation bookkeeping, that goes in a
+     * free list when Options::fSizeClassFreeLists is set.
+     */
+    constexpr static size_t kMaxSizeClassSize = 512;
+
 private:
+    struct AllocHeader;
     struct BlockHeader;
 
     static BlockHeader* CreateBlock(size_t size);
 
     static void DeleteBlock(BlockHeader* block);
 
+    static void ResetBlock(BlockHeader* block);
+
+    BlockHeader* takeWarmBlock(size_t blockSize);
+
+    void* assignAllocation(AllocHeader*, BlockHeader*, size_t size);
+
+    void addToFreeList(AllocHeader*);
+
+    void removeFromFreeList(AllocHeader*);
+
+    void removeFreeListEntries(BlockHeader*);
+
     void validate();
 
     struct BlockHeader {
@@ -103,12 +156,29 @@ private:
         int32_t fID;             ///< ID that can be used to track down leaks by clients.
 #endif
         BlockHeader* fHeader;    ///< pointer back to the block header in which an alloc resides
+        uint32_t     fSize;      ///< size of the allocation, including this header
+        bool         fFree;      ///< whether the allocation is in a free list
+    };
+
+    // A released allocation in a free list keeps this just after its AllocHeader.
+    struct FreeNode {
+        FreeNode* fPrev;
+        FreeNode* fNext;
     };
 
+    static constexpr size_t kSizeClassStep  = 16;
+    static constexpr int    kSizeClassCount = kMaxSizeClassSize / kSizeClassStep;
+
+    static int SizeClass(size_t size) { return (int)(size / kSizeClassStep) - 1; }
+
+    Options                           fOptions;
+    Stats                             fStats;
     size_t                            fSize;
     size_t                            fMinAllocSize;
     BlockHeader*                      fHead;
     BlockHeader*                      fTail;
+    BlockHeader*                      fWarmBlocks;  ///< singly-linked through fNext
+    FreeNode*                         fFreeLists[kSizeClassCount];
 #ifdef SK_DEBUG
     int                               fAllocationCnt;
     int                               fAllocBlockCnt;
@@ -134,6 +204,10 @@ public:
             : fMemoryPool(preallocSize, minAllocSize) {
     }
 
+    GrOpMemoryPool(size_t preallocSize, size_t minAllocSize, const GrMemoryPool::Options& options)
+            : fMemoryPool(preallocSize, minAllocSize, options) {
+    }
+
     template <typename Op, typename... OpArgs>
     std::unique_ptr<Op> allocate(OpArgs&&... opArgs) {
         char* mem = (char*) fMemoryPool.allocate(sizeof(Op));
@@ -148,6 +222,10 @@ public:
 
     bool isEmpty() const { return fMemoryPool.isEmpty(); }
 
+    const GrMemoryPool::Stats& stats() const { return fMemoryPool.stats(); }
+
+    void purgeWarmBlocks() { fMemoryPool.purgeWarmBlocks(); }
+
 private:
     GrMemoryPool fMemoryPool;
 };
@@ -13,6 +13,18 @@
 
 class GrPrimitiveProcessor;
 
+/**
+ * The counts and bases of one of the draws of an indirect GrMesh (see GrMesh::setIndirect()). This
+ * is laid out like both GL's DrawElementsIndirectCommand and VkDrawIndexedIndirectCommand.
+ */
+struct GrDrawIndexedIndirectCommand {
+    uint32_t fIndexCount;
+    uint32_t fInstanceCount;
+    uint32_t fBaseIndex;
+    int32_t  fBaseVertex;
+    uint32_t fBaseInstance;
+};
+
 /**
  * Used to communicate index and vertex buffers, counts, and offsets for a draw from GrOp to
  * GrGpu. It also holds the primitive type for the draw. TODO: Consider moving ownership of this
@@ -32,6 +44,7 @@ public:
     bool isIndexed() const { return SkToBool(fIndexBuffer.get()); }
     bool isInstanced() const { return SkToBool(fInstanceBuffer.get()); }
     bool hasVertexData() const { return SkToBool(fVertexBuffer.get()); }
+    bool isIndirect() const { return SkToBool(fIndirectBuffer.get()); }
 
     void setNonIndexedNonInstanced(int vertexCount);
 
@@ -48,6 +61,26 @@ public:
 
     void setVertexData(const GrBuffer* vertexBuffer, int baseVertex = 0);
 
+    /**
+     * Can this mesh be one of the draws of an indirect mesh? Only indexed meshes that aren't
+     * patterned, and whose buffers are in GPU memory, can be. Instanced meshes that don't start
+     * at their first instance also need the backend's indirect base instance support.
+     */
+    bool canDrawIndirect(bool indirectBaseInstanceSupport) const;
+
+    /** Can 'that' be drawn by the same indirect mesh as this one, i.e. with the same buffers? */
+    bool canShareIndirectDrawWith(const GrMesh& that) const;
+
+    /** The command that draws this mesh as one of the draws of an indirect mesh. */
+    GrDrawIndexedIndirectCommand indirectCommand() const;
+
+    /**
+     * Makes this mesh issue 'drawCount' indexed draws in one call, with its primitive type and
+     * buffers. The draws' counts and bases are the GrDrawIndexedIndirectCommands in
+     * 'indirectBuffer' at 'indirectOffset', and replace the mesh's own.
+     */
+    void setIndirect(const GrBuffer* indirectBuffer, size_t indirectOffset, int drawCount);
+
     class SendToGpuImpl {
     public:
         virtual void sendMeshToGpu(GrPrimitiveType, const GrBuffer* vertexBuffer, int vertexCount,
@@ -70,6 +103,13 @@ public:
                                                    int instanceCount, int baseInstance,
                                                    GrPrimitiveRestart) = 0;
 
+        virtual void sendIndexedIndirectMeshToGpu(GrPrimitiveType, const GrBuffer* indexBuffer,
+                                                  const GrBuffer* vertexBuffer,
+                                                  const GrBuffer* instanceBuffer,
+                                                  const GrBuffer* indirectBuffer,
+                                                  size_t indirectOffset, int drawCount,
+                                                  GrPrimitiveRestart) = 0;
+
         virtual ~SendToGpuImpl() {}
     };
 
@@ -82,10 +122,16 @@ private:
     PendingBuffer fIndexBuffer;
     PendingBuffer fInstanceBuffer;
     PendingBuffer fVertexBuffer;
+    PendingBuffer fIndirectBuffer;
     int fBaseVertex;
     GrPrimitiveRestart fPrimitiveRestart;
 
     union {
+        struct { // When fIndirectBuffer != nullptr.
+            size_t fIndirectOffset;
+            int    fDrawCount;
+        } fIndirectData;
+
         struct { // When fIndexBuffer == nullptr and fInstanceBuffer == nullptr.
             int   fVertexCount;
         } fNonIndexNonInstanceData;
@@ -132,6 +178,7 @@ private:
 inline void GrMesh::setNonIndexedNonInstanced(int vertexCount) {
     fIndexBuffer.reset(nullptr);
     fInstanceBuffer.reset(nullptr);
+    fIndirectBuffer.reset(nullptr);
     fNonIndexNonInstanceData.fVertexCount = vertexCount;
     fPrimitiveRestart = GrPrimitiveRestart::kNo;
 }
@@ -145,6 +192,7 @@ inline void GrMesh::setIndexed(const GrBuffer* indexBuffer, int indexCount, int
     SkASSERT(maxIndexValue >= minIndexValue);
     fIndexBuffer.reset(indexBuffer);
     fInstanceBuffer.reset(nullptr);
+    fIndirectBuffer.reset(nullptr);
     fIndexData.fIndexCount = indexCount;
     fIndexData.fPatternRepeatCount = 0;
     fNonPatternIndexData.fBaseIndex = baseIndex;
@@ -163,6 +211,7 @@ inline void GrMesh::setIndexedPatterned(const GrBuffer* indexBuffer, int indexCo
     SkASSERT(maxPatternRepetitionsInIndexBuffer >= 1);
     fIndexBuffer.reset(indexBuffer);
     fInstanceBuffer.reset(nullptr);
+    fIndirectBuffer.reset(nullptr);
     fIndexData.fIndexCount = indexCount;
     fIndexData.fPatternRepeatCount = patternRepeatCount;
     fPatternData.fVertexCount = vertexCount;
@@ -177,6 +226,7 @@ inline void GrMesh::setInstanced(const GrBuffer* instanceBuffer, int instanceCou
     SkASSERT(baseInstance >= 0);
     fIndexBuffer.reset(nullptr);
     fInstanceBuffer.reset(instanceBuffer);
+    fIndirectBuffer.reset(nullptr);
     fInstanceData.fInstanceCount = instanceCount;
     fInstanceData.fBaseInstance = baseInstance;
     fInstanceNonIndexData.fVertexCount = vertexCount;
@@ -193,19 +243,70 @@ inline void GrMesh::setIndexedInstanced(const GrBuffer* indexBuffer, int indexCo
     SkASSERT(baseInstance >= 0);
     fIndexBuffer.reset(indexBuffer);
     fInstanceBuffer.reset(instanceBuffer);
+    fIndirectBuffer.reset(nullptr);
     fInstanceData.fInstanceCount = instanceCount;
     fInstanceData.fBaseInstance = baseInstance;
     fInstanceIndexData.fIndexCount = indexCount;
     fPrimitiveRestart = primitiveRestart;
 }
 
+inline void GrMesh::setIndirect(const GrBuffer* indirectBuffer, size_t indirectOffset,
+                                int drawCount) {
+    SkASSERT(this->canDrawIndirect(true));
+    SkASSERT(indirectBuffer);
+    SkASSERT(drawCount >= 1);
+    fIndirectBuffer.reset(indirectBuffer);
+    fBaseVertex = 0;
+    fIndirectData.fIndirectOffset = indirectOffset;
+    fIndirectData.fDrawCount = drawCount;
+}
+
 inline void GrMesh::setVertexData(const GrBuffer* vertexBuffer, int baseVertex) {
     SkASSERT(baseVertex >= 0);
     fVertexBuffer.reset(vertexBuffer);
     fBaseVertex = baseVertex;
 }
 
+inline bool GrMesh::canDrawIndirect(bool indirectBaseInstanceSupport) const {
+    if (!this->isIndexed() || this->isIndirect() || fIndexBuffer.get()->isCPUBacked() ||
+        (fVertexBuffer.get() && fVertexBuffer.get()->isCPUBacked())) {
+        return false;
+    }
+    if (this->isInstanced()) {
+        return !fInstanceBuffer.get()->isCPUBacked() &&
+               (0 == fInstanceData.fBaseInstance || indirectBaseInstanceSupport);
+    }
+    return 0 == fIndexData.fPatternRepeatCount;
+}
+
+inline bool GrMesh::canShareIndirectDrawWith(const GrMesh& that) const {
+    return fPrimitiveType == that.fPrimitiveType &&
+           fIndexBuffer.get() == that.fIndexBuffer.get() &&
+           fVertexBuffer.get() == that.fVertexBuffer.get() &&
+           fInstanceBuffer.get() == that.fInstanceBuffer.get() &&
+           fPrimitiveRestart == that.fPrimitiveRestart;
+}
+
+inline GrDrawIndexedIndirectCommand GrMesh::indirectCommand() const {
+    SkASSERT(this->isIndexed() && !this->isIndirect());
+    if (this->isInstanced()) {
+        return {SkToU32(fInstanceIndexData.fIndexCount), SkToU32(fInstanceData.fInstanceCount), 0,
+                fBaseVertex, SkToU32(fInstanceData.fBaseInstance)};
+    }
+    SkASSERT(0 == fIndexData.fPatternRepeatCount);
+    return {SkToU32(fIndexData.fIndexCount), 1, SkToU32(fNonPatternIndexData.fBaseIndex),
+            fBaseVertex, 0};
+}
+
 inline void GrMesh::sendToGpu(SendToGpuImpl* impl) const {
+    if (this->isIndirect()) {
+        impl->sendIndexedIndirectMeshToGpu(fPrimitiveType, fIndexBuffer.get(), fVertexBuffer.get(),
+                                           fInstanceBuffer.get(), fIndirectBuffer.get(),
+                                           fIndirectData.fIndirectOffset,
+                                           fIndirectData.fDrawCount, fPrimitiveRestart);
+        return;
+    }
+
     if (this->isInstanced()) {
         if (!this->isIndexed()) {
             impl->sendInstancedMeshToGpu(fPrimitiveType, fVertexBuffer.get(),
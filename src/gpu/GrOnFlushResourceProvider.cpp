@@ -9,6 +9,7 @@
 #include "GrContext.h"
 #include "GrContextPriv.h"
 #include "GrDrawingManager.h"
+#include "GrGpu.h"
 #include "GrProxyProvider.h"
 #include "GrRenderTargetContext.h"
 #include "GrSurfaceProxy.h"
@@ -89,6 +90,14 @@ sk_sp<const GrBuffer> GrOnFlushResourceProvider::findOrMakeStaticBuffer(GrBuffer
     return buffer;
 }
 
+int GrOnFlushResourceProvider::sortKeysBufferCount(int count) {
+    return fDrawingMgr->getContext()->contextPriv().getGpu()->sortKeysBufferCount(count);
+}
+
+void GrOnFlushResourceProvider::sortKeys(GrBuffer* keys, int count) {
+    fDrawingMgr->getContext()->contextPriv().getGpu()->sortKeys(keys, count);
+}
+
 uint32_t GrOnFlushResourceProvider::contextUniqueID() const {
     return fDrawingMgr->getContext()->uniqueID();
 }
@@ -91,6 +91,12 @@ public:
     sk_sp<const GrBuffer> findOrMakeStaticBuffer(GrBufferType, size_t, const void* data,
                                                  const GrUniqueKey&);
 
+    // Sorts 64-bit keys on the GPU, ahead of the ops of this flush. sortKeysBufferCount() returns
+    // how many keys a vertex buffer from makeBuffer() must hold to sort 'count' of them, or 0 if
+    // the GPU can't sort (callers then sort on the CPU). See GrGpu::sortKeys().
+    int sortKeysBufferCount(int count);
+    void sortKeys(GrBuffer* keys, int count);
+
     uint32_t contextUniqueID() const;
     const GrCaps* caps() const;
 
@@ -19,6 +19,7 @@ GrOpFlushState::GrOpFlushState(GrGpu* gpu, GrResourceProvider* resourceProvider,
                                GrTokenTracker* tokenTracker, void* vertexSpace, void* indexSpace)
         : fVertexPool(gpu, vertexSpace)
         , fIndexPool(gpu, indexSpace)
+        , fDrawIndirectPool(gpu)
         , fGpu(gpu)
         , fResourceProvider(resourceProvider)
         , fTokenTracker(tokenTracker) {}
@@ -52,6 +53,7 @@ void GrOpFlushState::executeDrawsAndUploadsForMeshDrawOp(const GrOp* op, const S
 void GrOpFlushState::preExecuteDraws() {
     fVertexPool.unmap();
     fIndexPool.unmap();
+    fDrawIndirectPool.unmap();
     for (auto& upload : fASAPUploads) {
         this->doUpload(upload);
     }
@@ -65,6 +67,7 @@ void GrOpFlushState::reset() {
     SkASSERT(fCurrUpload == fInlineUploads.end());
     fVertexPool.reset();
     fIndexPool.reset();
+    fDrawIndirectPool.reset();
     fArena.reset();
     fASAPUploads.reset();
     fInlineUploads.reset();
@@ -118,6 +121,11 @@ void GrOpFlushState::draw(sk_sp<const GrGeometryProcessor> gp, const GrPipeline*
             dynamicStateArrays->fPrimitiveProcessorTextures[i]->addPendingRead();
         }
     }
+    // Meshes can only be batched when nothing has to happen between them.
+    if (meshCnt > 1 && this->caps().multiDrawIndexedIndirectSupport() && !dynamicStateArrays &&
+        kNone_GrXferBarrierType == pipeline->xferBarrierType(this->caps())) {
+        meshes = this->batchMeshesIndirect(meshes, &meshCnt);
+    }
     draw.fGeometryProcessor = std::move(gp);
     draw.fPipeline = pipeline;
     draw.fFixedDynamicState = fixedDynamicState;
@@ -130,6 +138,60 @@ void GrOpFlushState::draw(sk_sp<const GrGeometryProcessor> gp, const GrPipeline*
     }
 }
 
+const GrMesh* GrOpFlushState::batchMeshesIndirect(const GrMesh meshes[], int* meshCnt) {
+    // Well within the least number of draws that a backend must support in one call.
+    static constexpr int kMaxDrawsPerBatch = 4096;
+    bool baseInstanceSupport = this->caps().indirectBaseInstanceSupport();
+
+    // Find where each run of meshes that can share an indirect draw ends.
+    SkSTArray<8, int, true> runEnds;
+    int batchedMeshCnt = 0;
+    for (int i = 0; i < *meshCnt;) {
+        int end = i + 1;
+        if (meshes[i].canDrawIndirect(baseInstanceSupport)) {
+            while (end < *meshCnt && end - i < kMaxDrawsPerBatch &&
+                   meshes[end].canDrawIndirect(baseInstanceSupport) &&
+                   meshes[i].canShareIndirectDrawWith(meshes[end])) {
+                ++end;
+            }
+        }
+        runEnds.push_back(end);
+        batchedMeshCnt += end - i > 1 ? end - i : 0;
+        i = end;
+    }
+    if (!batchedMeshCnt) {
+        return meshes;
+    }
+
+    const GrBuffer* indirectBuffer;
+    size_t offset;
+    GrDrawIndexedIndirectCommand* commands =
+            fDrawIndirectPool.makeSpace(batchedMeshCnt, &indirectBuffer, &offset);
+    if (!commands) {
+        return meshes;
+    }
+
+    GrMesh* batched = fArena.makeArray<GrMesh>(runEnds.count());
+    int start = 0;
+    for (int r = 0; r < runEnds.count(); ++r) {
+        int count = runEnds[r] - start;
+        // GrMesh can be copied but not assigned.
+        batched[r].~GrMesh();
+        new (&batched[r]) GrMesh(meshes[start]);
+        if (count > 1) {
+            for (int i = 0; i < count; ++i) {
+                commands[i] = meshes[start + i].indirectCommand();
+            }
+            batched[r].setIndirect(indirectBuffer, offset, count);
+            commands += count;
+            offset += count * sizeof(GrDrawIndexedIndirectCommand);
+        }
+        start = runEnds[r];
+    }
+    *meshCnt = runEnds.count();
+    return batched;
+}
+
 void* GrOpFlushState::makeVertexSpace(size_t vertexSize, int vertexCount, const GrBuffer** buffer,
                                       int* startVertex) {
     return fVertexPool.makeSpace(vertexSize, vertexCount, buffer, startVertex);
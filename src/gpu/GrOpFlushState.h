@@ -113,6 +113,13 @@ private:
     /** GrMeshDrawOp::Target override. */
     SkArenaAlloc* pipelineArena() override { return &fArena; }
 
+    /**
+     * Replaces each run of consecutive meshes that can share an indirect draw with one indirect
+     * mesh, so the backend issues the run with a single call. Returns 'meshes' if no run is long
+     * enough, or else the new meshes, and updates meshCnt.
+     */
+    const GrMesh* batchMeshesIndirect(const GrMesh meshes[], int* meshCnt);
+
     struct InlineUpload {
         InlineUpload(GrDeferredTextureUploadFn&& upload, GrDeferredUploadToken token)
                 : fUpload(std::move(upload)), fUploadBeforeToken(token) {}
@@ -141,6 +148,8 @@ private:
     // Store vertex and index data on behalf of ops that are flushed.
     GrVertexBufferAllocPool fVertexPool;
     GrIndexBufferAllocPool fIndexPool;
+    // Stores the commands of the indirect meshes that batchMeshesIndirect() makes.
+    GrDrawIndirectBufferAllocPool fDrawIndirectPool;
 
     // Data stored on behalf of the ops being flushed.
     SkArenaAllocList<GrDeferredTextureUploadFn> fASAPUploads;
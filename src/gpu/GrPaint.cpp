@@ -6,6 +6,7 @@
  */
 
 #include "GrPaint.h"
+#include "GrProcessorAnalysis.h"
 #include "GrXferProcessor.h"
 #include "effects/GrCoverageSetOpXP.h"
 #include "effects/GrPorterDuffXferProcessor.h"
@@ -75,3 +76,20 @@ bool GrPaint::isConstantBlendedColor(SkPMColor4f* constantColor) const {
     }
     return false;
 }
+
+bool GrPaint::overwritesDst() const {
+    static const GrXPFactory* kSrc = GrPorterDuffXPFactory::Get(SkBlendMode::kSrc);
+    static const GrXPFactory* kSrcOver = GrPorterDuffXPFactory::Get(SkBlendMode::kSrcOver);
+    static const GrXPFactory* kClear = GrPorterDuffXPFactory::Get(SkBlendMode::kClear);
+    if (kSrc == fXPFactory || kClear == fXPFactory) {
+        return true;
+    }
+    if (fXPFactory && kSrcOver != fXPFactory) {
+        return false;
+    }
+    GrColorFragmentProcessorAnalysis analysis(
+            GrProcessorAnalysisColor(fColor),
+            unique_ptr_address_as_pointer_address(fColorFragmentProcessors.begin()),
+            fColorFragmentProcessors.count());
+    return analysis.isOpaque();
+}
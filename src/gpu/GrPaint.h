@@ -109,6 +109,13 @@ public:
      */
     bool isConstantBlendedColor(SkPMColor4f* constantColor) const;
 
+    /**
+     * Returns true if, at full coverage, the colors the paint writes don't depend on the dst's
+     * previous contents (e.g. src-over with an opaque color and color fragment processors).
+     * Coverage fragment processors are not considered.
+     */
+    bool overwritesDst() const;
+
     /**
      * A trivial paint is one that uses src-over and has no fragment processors.
      * It may have variable sRGB settings.
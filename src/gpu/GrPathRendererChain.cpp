@@ -21,6 +21,7 @@
 #include "ops/GrDefaultPathRenderer.h"
 #include "ops/GrStencilAndCoverPathRenderer.h"
 #include "ops/GrTessellatingPathRenderer.h"
+#include "skc/GrSkcPathRenderer.h"
 
 GrPathRendererChain::GrPathRendererChain(GrContext* context, const Options& options) {
     const GrCaps& caps = *context->contextPriv().caps();
@@ -37,10 +38,18 @@ GrPathRendererChain::GrPathRendererChain(GrContext* context, const Options& opti
     if (options.fGpuPathRenderers & GpuPathRenderers::kAAConvex) {
         fChain.push_back(sk_make_sp<GrAAConvexPathRenderer>());
     }
+    // skc only takes large, complex paths, which are slow for all of the renderers below.
+    if (options.fGpuPathRenderers & GpuPathRenderers::kSkc) {
+        if (auto skc = GrSkcPathRenderer::CreateIfSupported(context, options.fOpenCLContext,
+                                                            options.fOpenCLDevice)) {
+            fChain.push_back(std::move(skc));
+        }
+    }
     if (options.fGpuPathRenderers & GpuPathRenderers::kCoverageCounting) {
         using AllowCaching = GrCoverageCountingPathRenderer::AllowCaching;
         if (auto ccpr = GrCoverageCountingPathRenderer::CreateIfSupported(
-                                caps, AllowCaching(options.fAllowPathMaskCaching))) {
+                                caps, AllowCaching(options.fAllowPathMaskCaching),
+                                options.fPathMaskCachingTolerance)) {
             fCoverageCountingPathRenderer = ccpr.get();
             context->contextPriv().addOnFlushCallbackObject(fCoverageCountingPathRenderer);
             fChain.push_back(std::move(ccpr));
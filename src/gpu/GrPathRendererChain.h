@@ -28,7 +28,10 @@ class GrPathRendererChain : public SkNoncopyable {
 public:
     struct Options {
         bool fAllowPathMaskCaching = false;
+        float fPathMaskCachingTolerance = 0;
         GpuPathRenderers fGpuPathRenderers = GpuPathRenderers::kAll;
+        void* fOpenCLContext = nullptr;
+        void* fOpenCLDevice = nullptr;
     };
     GrPathRendererChain(GrContext* context, const Options&);
 
@@ -0,0 +1,319 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "GrPictureRasterCache.h"
+
+#include "GrCaps.h"
+#include "GrContext.h"
+#include "GrContextPriv.h"
+#include "GrProxyProvider.h"
+#include "SkBigPicture.h"
+#include "SkCanvas.h"
+#include "SkDrawable.h"
+#include "SkImage_Base.h"
+#include "SkMaskFilterBase.h"
+#include "SkOpts.h"
+#include "SkPicture.h"
+#include "SkPicturePriv.h"
+#include "SkRecord.h"
+#include "SkRecords.h"
+#include "SkShader.h"
+#include "SkSurface.h"
+#include "SkTLogic.h"
+
+static bool picture_may_draw_images(const sk_sp<const SkPicture>&);
+
+namespace {
+
+// SkRecord visitor that returns true when the op may draw an image, either itself, through its
+// paint, or through a drawable that can't be seen into.
+struct ImageHunter {
+    static const SkPaint* AsPtr(const SkPaint& p) { return &p; }
+    static const SkPaint* AsPtr(const SkRecords::Optional<SkPaint>& p) { return p; }
+
+    static bool PaintMayDrawImages(const SkPaint* paint) {
+        if (!paint) {
+            return false;
+        }
+        // Colors and gradients are the shaders known not to, and blurs the mask filters.
+        const SkShader* shader = paint->getShader();
+        if (shader && SkShader::kNone_GradientType == shader->asAGradient(nullptr)) {
+            return true;
+        }
+        SkMaskFilterBase::BlurRec blur;
+        if (paint->getMaskFilter() && !as_MFB(paint->getMaskFilter())->asABlur(&blur)) {
+            return true;
+        }
+        return SkToBool(paint->getImageFilter());
+    }
+
+    bool operator()(const SkRecords::DrawPicture& op) {
+        return PaintMayDrawImages(AsPtr(op.paint)) || picture_may_draw_images(op.picture);
+    }
+
+    bool operator()(const SkRecords::DrawDrawable&) { return true; }
+
+    bool operator()(const SkRecords::SaveLayer& op) {
+        return op.backdrop || op.clipMask || PaintMayDrawImages(AsPtr(op.paint));
+    }
+
+    template <typename T>
+    SK_WHEN(T::kTags & SkRecords::kHasImage_Tag, bool) operator()(const T&) { return true; }
+
+    template <typename T>
+    SK_WHEN(!(T::kTags & SkRecords::kHasImage_Tag) && (T::kTags & SkRecords::kHasPaint_Tag),
+            bool) operator()(const T& op) {
+        return PaintMayDrawImages(AsPtr(op.paint));
+    }
+
+    template <typename T>
+    SK_WHEN(!(T::kTags & (SkRecords::kHasImage_Tag | SkRecords::kHasPaint_Tag)), bool)
+      operator()(const T&) { return false; }
+};
+
+}  // anonymous namespace
+
+// Images may be textures, which only the context's thread may read.
+static bool picture_may_draw_images(const sk_sp<const SkPicture>& picture) {
+    const SkBigPicture* bigPicture = SkPicturePriv::AsSkBigPicture(picture);
+    if (!bigPicture) {
+        // Mini pictures hold a single op, and are never rasterized.
+        return true;
+    }
+    const SkRecord* record = bigPicture->record();
+    ImageHunter hunter;
+    for (int i = 0; i < record->count(); ++i) {
+        if (record->visit(i, hunter)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+uint32_t GrPictureRasterCache::Entry::Hash(const Key& key) {
+    return SkOpts::hash(&key, sizeof(Key));
+}
+
+GrPictureRasterCache::GrPictureRasterCache(GrContext* context, size_t maxBytes)
+        : fContext(context)
+        , fMaxBytes(maxBytes) {}
+
+GrPictureRasterCache::~GrPictureRasterCache() {
+    this->purgeAll();
+}
+
+bool GrPictureRasterCache::Place(const SkRect& cull, const SkMatrix& matrix, Key* key,
+                                 SkIRect* bounds, SkIPoint* translate) {
+    if (matrix.hasPerspective() || !matrix.isFinite()) {
+        return false;
+    }
+    // Keep the whole pixels in range of the device's ints.
+    SkScalar tx = SkScalarFloorToScalar(matrix.getTranslateX()),
+             ty = SkScalarFloorToScalar(matrix.getTranslateY());
+    if (SkScalarAbs(tx) > (1 << 24) || SkScalarAbs(ty) > (1 << 24)) {
+        return false;
+    }
+    int subX = SkScalarRoundToInt((matrix.getTranslateX() - tx) * kSubpixelSteps),
+        subY = SkScalarRoundToInt((matrix.getTranslateY() - ty) * kSubpixelSteps);
+    if (kSubpixelSteps == subX) {
+        subX = 0;
+        tx += 1;
+    }
+    if (kSubpixelSteps == subY) {
+        subY = 0;
+        ty += 1;
+    }
+
+    key->fMatrix[0] = matrix.getScaleX();
+    key->fMatrix[1] = matrix.getSkewX();
+    key->fMatrix[2] = matrix.getSkewY();
+    key->fMatrix[3] = matrix.getScaleY();
+    key->fSubpixel[0] = subX;
+    key->fSubpixel[1] = subY;
+
+    SkMatrix keyMatrix = matrix;
+    keyMatrix.setTranslateX(SkIntToScalar(subX) / kSubpixelSteps);
+    keyMatrix.setTranslateY(SkIntToScalar(subY) / kSubpixelSteps);
+    SkRect keyBounds;
+    keyMatrix.mapRect(&keyBounds, cull);
+    if (!keyBounds.isFinite()) {
+        return false;
+    }
+    keyBounds.roundOut(bounds);
+    translate->set(SkScalarTruncToInt(tx), SkScalarTruncToInt(ty));
+    return !bounds->isEmpty();
+}
+
+template <typename Fn>
+bool GrPictureRasterCache::findOrRasterize(const Key& key, const SkIRect& bounds,
+                                           const SkIPoint& translate, SkColorSpace* dstColorSpace,
+                                           Fn&& makePicture, Raster* raster) {
+    // Pictures within the one being drawn into a render target are played back.
+    if (fRasterizing) {
+        return false;
+    }
+    Entry* entry = this->findOrAdd(key);
+    if (!entry->fProxy) {
+        if (entry->fUncacheable || ++entry->fDrawCount < kMinDrawCount) {
+            return false;
+        }
+        sk_sp<SkPicture> picture = makePicture();
+        if (!picture) {
+            entry->fUncacheable = true;
+            return false;
+        }
+        this->rasterize(entry, std::move(picture), bounds, dstColorSpace);
+        if (!entry->fProxy) {
+            return false;
+        }
+    }
+    raster->fProxy = entry->fProxy;
+    raster->fColorSpace = entry->fColorSpace;
+    raster->fDeviceBounds = bounds.makeOffset(translate.fX, translate.fY);
+    return true;
+}
+
+bool GrPictureRasterCache::findOrRasterize(const SkPicture* picture, const SkMatrix& matrix,
+                                           SkColorSpace* dstColorSpace, Raster* raster) {
+    if (picture->approximateOpCount() < kMinOpCount) {
+        return false;
+    }
+    Key key;
+    SkIRect bounds;
+    SkIPoint translate;
+    if (!Place(picture->cullRect(), matrix, &key, &bounds, &translate)) {
+        return false;
+    }
+    key.fID = picture->uniqueID();
+    key.fIsDrawable = false;
+    key.fColorSpaceHash = dstColorSpace ? dstColorSpace->hash() : 0;
+    return this->findOrRasterize(key, bounds, translate, dstColorSpace,
+                                 [picture] { return sk_ref_sp(picture); }, raster);
+}
+
+bool GrPictureRasterCache::findOrRasterize(SkDrawable* drawable, const SkMatrix& matrix,
+                                           SkColorSpace* dstColorSpace, Raster* raster) {
+    Key key;
+    SkIRect bounds;
+    SkIPoint translate;
+    if (!Place(drawable->getBounds(), matrix, &key, &bounds, &translate)) {
+        return false;
+    }
+    // The generation ID changes whenever the drawable's drawing does.
+    key.fID = drawable->getGenerationID();
+    key.fIsDrawable = true;
+    key.fColorSpaceHash = dstColorSpace ? dstColorSpace->hash() : 0;
+    return this->findOrRasterize(key, bounds, translate, dstColorSpace, [drawable] {
+        sk_sp<SkPicture> picture(drawable->newPictureSnapshot());
+        // Only now is there an op count to check.
+        if (picture && picture->approximateOpCount() < kMinOpCount) {
+            picture.reset();
+        }
+        return picture;
+    }, raster);
+}
+
+GrPictureRasterCache::Entry* GrPictureRasterCache::findOrAdd(const Key& key) {
+    Entry* entry = fEntries.find(key);
+    if (entry) {
+        fLRU.remove(entry);
+        fLRU.addToHead(entry);
+        return entry;
+    }
+    entry = new Entry(key);
+    fEntries.add(entry);
+    fLRU.addToHead(entry);
+    while (fEntries.count() > kMaxEntries) {
+        this->remove(fLRU.tail());
+    }
+    return entry;
+}
+
+void GrPictureRasterCache::remove(Entry* entry) {
+    fBytes -= entry->fBytes;
+    fLRU.remove(entry);
+    fEntries.remove(entry->fKey);
+    delete entry;
+}
+
+void GrPictureRasterCache::purgeAll() {
+    while (Entry* entry = fLRU.head()) {
+        this->remove(entry);
+    }
+    SkASSERT(0 == fBytes);
+}
+
+void GrPictureRasterCache::rasterize(Entry* entry, sk_sp<SkPicture> picture,
+                                     const SkIRect& bounds, SkColorSpace* dstColorSpace) {
+    SkASSERT(!entry->fProxy);
+    SkASSERT(fLRU.head() == entry);
+
+    const int maxTextureSize = fContext->contextPriv().caps()->maxTextureSize();
+    const size_t bytes = SkToSizeT(bounds.width()) * bounds.height() * 4;
+    if (bounds.width() > maxTextureSize || bounds.height() > maxTextureSize || bytes > fMaxBytes) {
+        entry->fUncacheable = true;
+        return;
+    }
+    // Make room by dropping the least recently drawn rasters.
+    for (Entry* lru = fLRU.tail(); lru != entry && fBytes + bytes > fMaxBytes;) {
+        Entry* prev = lru->fPrev;
+        if (lru->fProxy) {
+            this->remove(lru);
+        }
+        lru = prev;
+    }
+
+    SkMatrix matrix = SkMatrix::MakeAll(
+            entry->fKey.fMatrix[0], entry->fKey.fMatrix[1],
+            SkIntToScalar(entry->fKey.fSubpixel[0]) / kSubpixelSteps,
+            entry->fKey.fMatrix[2], entry->fKey.fMatrix[3],
+            SkIntToScalar(entry->fKey.fSubpixel[1]) / kSubpixelSteps,
+            0, 0, 1);
+    matrix.postTranslate(-SkIntToScalar(bounds.fLeft), -SkIntToScalar(bounds.fTop));
+
+    sk_sp<GrTextureProxy> proxy;
+    // Rasters made on the CPU need a color space; without one sRGB blends like legacy does.
+    sk_sp<SkColorSpace> colorSpace = dstColorSpace ? sk_ref_sp(dstColorSpace)
+                                                   : SkColorSpace::MakeSRGB();
+    if (fContext->contextPriv().getTaskGroup() && !picture_may_draw_images(picture)) {
+        // Played back on the executor, and uploaded by the first flush that draws it.
+        sk_sp<SkImage> image = SkImage::MakeFromPicture(std::move(picture), bounds.size(),
+                                                        &matrix, nullptr,
+                                                        SkImage::BitDepth::kU8, colorSpace);
+        if (image) {
+            proxy = fContext->contextPriv().proxyProvider()->createDeferredTextureProxy(
+                    std::move(image), GrMipMapped::kNo);
+        }
+    } else {
+        colorSpace = sk_ref_sp(dstColorSpace);
+        SkImageInfo info = SkImageInfo::MakeN32Premul(bounds.width(), bounds.height(),
+                                                      colorSpace);
+        SkSurfaceProps props(0, kUnknown_SkPixelGeometry);
+        sk_sp<SkSurface> surface = SkSurface::MakeRenderTarget(fContext, SkBudgeted::kYes, info,
+                                                               0, kTopLeft_GrSurfaceOrigin,
+                                                               &props);
+        if (surface) {
+            SkCanvas* canvas = surface->getCanvas();
+            canvas->clear(SK_ColorTRANSPARENT);
+            canvas->concat(matrix);
+            fRasterizing = true;
+            picture->playback(canvas);
+            fRasterizing = false;
+            sk_sp<SkImage> image = surface->makeImageSnapshot();
+            proxy = image ? as_IB(image)->asTextureProxyRef() : nullptr;
+        }
+    }
+    if (!proxy) {
+        entry->fUncacheable = true;
+        return;
+    }
+
+    entry->fProxy = std::move(proxy);
+    entry->fColorSpace = std::move(colorSpace);
+    entry->fBytes = bytes;
+    fBytes += bytes;
+}
@@ -0,0 +1,112 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef GrPictureRasterCache_DEFINED
+#define GrPictureRasterCache_DEFINED
+
+#include "GrTextureProxy.h"
+#include "SkColorSpace.h"
+#include "SkRect.h"
+#include "SkTDynamicHash.h"
+#include "SkTInternalLList.h"
+
+class GrContext;
+class SkDrawable;
+class SkMatrix;
+class SkPicture;
+
+/**
+ * Keeps rasterizations of pictures and drawables that are drawn again and again, unchanged and
+ * under the same scale and skew, so that SkGpuDevice can draw them as a single textured rect
+ * instead of playing them back. Rasters are keyed on the picture's unique ID (a drawable's
+ * generation ID), the matrix without its translate, the translate's subpixel offset quantized to
+ * kSubpixelSteps and the destination color space; whole pixel translates reuse them.
+ *
+ * A picture is rasterized on its kMinDrawCount'th draw. Pictures that draw no images are played
+ * back on the context's executor if it has one, and uploaded by the flush that first draws them;
+ * the rest are drawn into a render target. The least recently drawn rasters are dropped to keep
+ * their bytes under the budget.
+ */
+class GrPictureRasterCache {
+public:
+    static constexpr int kMinOpCount = 16;    // Simpler pictures aren't worth a texture.
+    static constexpr int kMinDrawCount = 2;
+    static constexpr int kSubpixelSteps = 4;
+    static constexpr int kMaxEntries = 256;   // Including pictures not drawn enough to rasterize.
+
+    GrPictureRasterCache(GrContext*, size_t maxBytes);
+    ~GrPictureRasterCache();
+
+    struct Raster {
+        sk_sp<GrTextureProxy> fProxy;
+        sk_sp<SkColorSpace>   fColorSpace;
+        SkIRect               fDeviceBounds;  // Where the texture goes, one texel per pixel.
+    };
+
+    /**
+     * Finds the raster of the picture drawn with this matrix, making it if the picture has been
+     * drawn often enough. Returns false if the picture should be played back instead.
+     */
+    bool findOrRasterize(const SkPicture*, const SkMatrix&, SkColorSpace* dstColorSpace, Raster*);
+    bool findOrRasterize(SkDrawable*, const SkMatrix&, SkColorSpace* dstColorSpace, Raster*);
+
+    void purgeAll();
+
+    int count() const { return fEntries.count(); }
+    size_t usedBytes() const { return fBytes; }
+
+private:
+    struct Key {
+        uint32_t fID;
+        uint32_t fIsDrawable;
+        float    fMatrix[4];       // scaleX, skewX, skewY, scaleY
+        int32_t  fSubpixel[2];     // The translate's fractional part, in 1/kSubpixelSteps.
+        uint64_t fColorSpaceHash;
+
+        bool operator==(const Key& that) const { return 0 == memcmp(this, &that, sizeof(Key)); }
+    };
+
+    struct Entry {
+        explicit Entry(const Key& key) : fKey(key) {}
+
+        static const Key& GetKey(const Entry& entry) { return entry.fKey; }
+        static uint32_t Hash(const Key&);
+
+        const Key             fKey;
+        int                   fDrawCount = 0;
+        bool                  fUncacheable = false;
+        sk_sp<GrTextureProxy> fProxy;
+        sk_sp<SkColorSpace>   fColorSpace;
+        size_t                fBytes = 0;
+
+        SK_DECLARE_INTERNAL_LLIST_INTERFACE(Entry);
+    };
+
+    // Splits the matrix into the key's part and the whole pixels the raster is drawn at, and
+    // finds the raster's bounds in the key's space. Returns false if the picture can't be drawn
+    // from a raster, e.g. under perspective.
+    static bool Place(const SkRect& cull, const SkMatrix&, Key*, SkIRect* bounds,
+                      SkIPoint* translate);
+
+    // Looks up the key, rasterizing the picture made by makePicture() if it is time to.
+    template <typename Fn>
+    bool findOrRasterize(const Key&, const SkIRect& bounds, const SkIPoint& translate,
+                         SkColorSpace*, Fn&& makePicture, Raster*);
+
+    Entry* findOrAdd(const Key&);
+    void remove(Entry*);
+    void rasterize(Entry*, sk_sp<SkPicture>, const SkIRect& bounds, SkColorSpace*);
+
+    GrContext* const               fContext;
+    const size_t                   fMaxBytes;
+    SkTDynamicHash<Entry, Key>     fEntries;
+    SkTInternalLList<Entry>        fLRU;  // Most recently drawn first.
+    size_t                         fBytes = 0;
+    bool                           fRasterizing = false;
+};
+
+#endif
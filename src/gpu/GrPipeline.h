@@ -27,6 +27,7 @@
 #include "effects/GrSimpleTextureEffect.h"
 
 class GrAppliedClip;
+class GrGpu;
 class GrOp;
 class GrRenderTargetContext;
 
@@ -191,6 +192,19 @@ public:
 
     GrXferBarrierType xferBarrierType(const GrCaps& caps) const;
 
+    /**
+     * The fragment and xfer processors' part of a program key is the same for every draw with
+     * this pipeline, so GrProgramDesc::Build() keeps it here and copies it for later draws rather
+     * than walking the processors again. The processors' meta keys include their offset into the
+     * key, so a cached key is only reused at the offset it was built at.
+     */
+    struct ProcessorKeyCache {
+        const GrGpu* fGpu = nullptr;
+        size_t fOffset = 0;
+        SkSTArray<64, uint8_t, true> fKey;
+    };
+    ProcessorKeyCache* processorKeyCache() const { return &fProcessorKeyCache; }
+
     static SkString DumpFlags(uint32_t flags) {
         if (flags) {
             SkString result;
@@ -232,6 +246,8 @@ private:
 
     // This value is also the index in fFragmentProcessors where coverage processors begin.
     int fNumColorProcessors;
+
+    mutable ProcessorKeyCache fProcessorKeyCache;
 };
 
 #endif
@@ -112,7 +112,15 @@ public:
 #endif
 
     GrMemoryPool* pool() const {
-        static GrMemoryPool gPool(4096, 4096);
+        // Paints' processor trees are made for each draw and released with their ops at flush, in
+        // no particular order, so released processors are recycled through the size class free
+        // lists and the blocks emptied by one flush are kept for the next.
+        static GrMemoryPool gPool(4096, 4096, [] {
+            GrMemoryPool::Options options;
+            options.fSizeClassFreeLists = true;
+            options.fWarmBlockBytes = 64 * 1024;
+            return options;
+        }());
         return &gPool;
     }
 };
@@ -54,8 +54,8 @@ private:
 /** Provides custom shader code to the Ganesh shading pipeline. GrProcessor objects *must* be
     immutable: after being constructed, their fields may not change.
 
-    Dynamically allocated GrProcessors are managed by a per-thread memory pool. The ref count of an
-    processor must reach 0 before the thread terminates and the pool is destroyed.
+    Dynamically allocated GrProcessors are managed by a global memory pool. The ref count of a
+    processor must reach 0 before the pool is destroyed at exit.
  */
 class GrProcessor {
 public:
@@ -84,6 +84,7 @@ public:
         kGP_ClassID,
         kVertexColorSpaceBenchGP_ClassID,
         kGrAAFillRRectOp_Processor_ClassID,
+        kGrDrawAtlasOp_Processor_ClassID,
         kGrAARectEffect_ClassID,
         kGrAlphaThresholdFragmentProcessor_ClassID,
         kGrArithmeticFP_ClassID,
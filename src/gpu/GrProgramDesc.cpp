@@ -217,25 +217,38 @@ bool GrProgramDesc::Build(GrProgramDesc* desc,
         return false;
     }
 
-    for (int i = 0; i < pipeline.numFragmentProcessors(); ++i) {
-        const GrFragmentProcessor& fp = pipeline.getFragmentProcessor(i);
-        if (!gen_frag_proc_and_meta_keys(primProc, fp, gpu, shaderCaps, &b)) {
+    GrPipeline::ProcessorKeyCache* cache = pipeline.processorKeyCache();
+    const int processorKeysStart = desc->key().count();
+    if (cache->fGpu == gpu && cache->fOffset == b.size()) {
+        desc->key().push_back_n(cache->fKey.count(), cache->fKey.begin());
+    } else {
+        const size_t offset = b.size();
+        for (int i = 0; i < pipeline.numFragmentProcessors(); ++i) {
+            const GrFragmentProcessor& fp = pipeline.getFragmentProcessor(i);
+            if (!gen_frag_proc_and_meta_keys(primProc, fp, gpu, shaderCaps, &b)) {
+                desc->key().reset();
+                return false;
+            }
+        }
+
+        const GrXferProcessor& xp = pipeline.getXferProcessor();
+        const GrSurfaceOrigin* originIfDstTexture = nullptr;
+        GrSurfaceOrigin origin;
+        if (pipeline.dstTextureProxy()) {
+            origin = pipeline.dstTextureProxy()->origin();
+            originIfDstTexture = &origin;
+        }
+        xp.getGLSLProcessorKey(shaderCaps, &b, originIfDstTexture);
+        if (!gen_meta_key(xp, shaderCaps, &b)) {
             desc->key().reset();
             return false;
         }
-    }
 
-    const GrXferProcessor& xp = pipeline.getXferProcessor();
-    const GrSurfaceOrigin* originIfDstTexture = nullptr;
-    GrSurfaceOrigin origin;
-    if (pipeline.dstTextureProxy()) {
-        origin = pipeline.dstTextureProxy()->origin();
-        originIfDstTexture = &origin;
-    }
-    xp.getGLSLProcessorKey(shaderCaps, &b, originIfDstTexture);
-    if (!gen_meta_key(xp, shaderCaps, &b)) {
-        desc->key().reset();
-        return false;
+        cache->fGpu = gpu;
+        cache->fOffset = offset;
+        cache->fKey.reset();
+        cache->fKey.push_back_n(desc->key().count() - processorKeysStart,
+                                desc->key().begin() + processorKeysStart);
     }
 
     // --------DO NOT MOVE HEADER ABOVE THIS LINE--------------------------------------------------
@@ -0,0 +1,195 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "GrPromiseTextureBatcher.h"
+
+#include "SkExecutor.h"
+#include "SkTemplates.h"
+
+#include <algorithm>
+
+GrPromiseTextureBatcher::GrPromiseTextureBatcher(FulfillProc fulfillProc, ReleaseProc releaseProc,
+                                                 void* batchContext, SkExecutor* releaseExecutor)
+        : fFulfillProc(fulfillProc)
+        , fReleaseProc(releaseProc)
+        , fBatchContext(batchContext)
+        , fReleaseExecutor(releaseExecutor) {}
+
+GrPromiseTextureBatcher::~GrPromiseTextureBatcher() {
+    // Held releases and new textures both keep their batcher alive.
+    SkASSERT(fHeldReleases.empty());
+    SkASSERT(fNewTextures.empty());
+}
+
+GrPromiseTextureBatcher::Texture::Texture(sk_sp<GrPromiseTextureBatcher> batcher,
+                                          TextureContext context,
+                                          sk_sp<GrReleaseProcHelper> doneHelper)
+        : fBatcher(std::move(batcher))
+        , fContext(context)
+        , fDoneHelper(std::move(doneHelper)) {}
+
+GrPromiseTextureBatcher::Texture::~Texture() {
+    SkASSERT(!fHasPrefulfilled);
+    SkASSERT(!fFulfilled);
+}
+
+GrBackendTexture GrPromiseTextureBatcher::Texture::fulfill() {
+    SkASSERT(!fFulfilled);
+
+    // The client must see this texture's last release before it is fulfilled again.
+    bool releaseHeld;
+    {
+        SkAutoMutexAcquire lock(fBatcher->fMutex);
+        releaseHeld = fReleaseHeld;
+    }
+    if (releaseHeld) {
+        fBatcher->deliverReleases();
+    }
+
+    GrBackendTexture texture;
+    if (fHasPrefulfilled) {
+        texture = fPrefulfilled;
+        fPrefulfilled = GrBackendTexture();
+        fHasPrefulfilled = false;
+    } else {
+        fBatcher->fFulfillProc(fBatcher->fBatchContext, &fContext, &texture, 1);
+    }
+    fFulfilled = true;
+    return texture;
+}
+
+void GrPromiseTextureBatcher::Texture::release() {
+    SkASSERT(fFulfilled);
+    fFulfilled = false;
+    fBatcher->holdRelease(this);
+}
+
+sk_sp<GrPromiseTextureBatcher::Texture> GrPromiseTextureBatcher::makeTexture(
+        TextureContext context, sk_sp<GrReleaseProcHelper> doneHelper) {
+    sk_sp<Texture> texture(new Texture(sk_ref_sp(this), context, std::move(doneHelper)));
+    SkAutoMutexAcquire lock(fMutex);
+    fNewTextures.push_back(texture);
+    return texture;
+}
+
+SkTArray<sk_sp<GrPromiseTextureBatcher::Texture>> GrPromiseTextureBatcher::detachTextures() {
+    SkTArray<sk_sp<Texture>> textures;
+    SkAutoMutexAcquire lock(fMutex);
+    textures.swap(fNewTextures);
+    return textures;
+}
+
+void GrPromiseTextureBatcher::FulfillAll(const SkTArray<sk_sp<Texture>>& textures) {
+    // Find the textures that need fulfilling, in the order they were given, and their batchers.
+    // A DDL replayed more than once gives its textures more than once.
+    SkSTArray<16, Texture*> needed;
+    SkSTArray<4, GrPromiseTextureBatcher*> batchers;
+    for (const sk_sp<Texture>& texture : textures) {
+        GrPromiseTextureBatcher* batcher = texture->fBatcher.get();
+        {
+            SkAutoMutexAcquire lock(batcher->fMutex);
+            batcher->fFlushingTextures++;
+        }
+        if (texture->fFulfilled || texture->fHasPrefulfilled) {
+            continue;
+        }
+        texture->fHasPrefulfilled = true;
+        needed.push_back(texture.get());
+        if (std::find(batchers.begin(), batchers.end(), batcher) == batchers.end()) {
+            batchers.push_back(batcher);
+        }
+    }
+
+    SkSTArray<16, Texture*> batch;
+    for (GrPromiseTextureBatcher* batcher : batchers) {
+        batch.reset();
+        for (Texture* texture : needed) {
+            if (texture->fBatcher.get() == batcher) {
+                batch.push_back(texture);
+            }
+        }
+        // The client must see any of these textures' last releases before they're fulfilled.
+        batcher->deliverReleases();
+
+        SkAutoSTMalloc<16, TextureContext> contexts(batch.count());
+        SkAutoSTArray<16, GrBackendTexture> backendTextures(batch.count());
+        for (int i = 0; i < batch.count(); ++i) {
+            contexts[i] = batch[i]->fContext;
+        }
+        batcher->fFulfillProc(batcher->fBatchContext, contexts.get(), backendTextures.get(),
+                              batch.count());
+        for (int i = 0; i < batch.count(); ++i) {
+            batch[i]->fPrefulfilled = backendTextures[i];
+        }
+    }
+}
+
+void GrPromiseTextureBatcher::FinishFlush(const SkTArray<sk_sp<Texture>>& textures) {
+    // Textures fulfilled for the flush that it didn't draw still need their release.
+    for (const sk_sp<Texture>& texture : textures) {
+        if (texture->fHasPrefulfilled) {
+            texture->fPrefulfilled = GrBackendTexture();
+            texture->fHasPrefulfilled = false;
+            texture->fBatcher->holdRelease(texture.get());
+        }
+    }
+    for (const sk_sp<Texture>& texture : textures) {
+        GrPromiseTextureBatcher* batcher = texture->fBatcher.get();
+        bool done;
+        {
+            SkAutoMutexAcquire lock(batcher->fMutex);
+            done = 0 == --batcher->fFlushingTextures;
+        }
+        if (done) {
+            batcher->deliverReleases();
+        }
+    }
+}
+
+void GrPromiseTextureBatcher::holdRelease(Texture* texture) {
+    {
+        SkAutoMutexAcquire lock(fMutex);
+        SkASSERT(!texture->fReleaseHeld);
+        texture->fReleaseHeld = true;
+        fHeldReleases.push_back(sk_ref_sp(texture));
+        if (fFlushingTextures > 0) {
+            return;
+        }
+    }
+    // Outside of a flush there is nothing to batch with.
+    this->deliverReleases();
+}
+
+void GrPromiseTextureBatcher::deliverReleases() {
+    SkTArray<sk_sp<Texture>> textures;
+    {
+        SkAutoMutexAcquire lock(fMutex);
+        textures.swap(fHeldReleases);
+        for (const sk_sp<Texture>& texture : textures) {
+            texture->fReleaseHeld = false;
+        }
+    }
+    if (textures.empty()) {
+        return;
+    }
+
+    // The textures' refs keep their done procs from being called until the client has these.
+    ReleaseProc releaseProc = fReleaseProc;
+    void* batchContext = fBatchContext;
+    auto deliver = [releaseProc, batchContext, textures] {
+        SkAutoSTMalloc<16, TextureContext> contexts(textures.count());
+        for (int i = 0; i < textures.count(); ++i) {
+            contexts[i] = textures[i]->fContext;
+        }
+        releaseProc(batchContext, contexts.get(), textures.count());
+    };
+    if (fReleaseExecutor) {
+        fReleaseExecutor->add(std::move(deliver));
+    } else {
+        deliver();
+    }
+}
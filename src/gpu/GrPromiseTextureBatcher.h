@@ -0,0 +1,109 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef GrPromiseTextureBatcher_DEFINED
+#define GrPromiseTextureBatcher_DEFINED
+
+#include "GrBackendSurface.h"
+#include "GrTypesPriv.h"
+#include "SkMutex.h"
+#include "SkRefCnt.h"
+#include "SkTArray.h"
+
+class SkExecutor;
+
+/**
+ * Fulfills and releases the promise textures of images made after
+ * SkDeferredDisplayListRecorder::setPromiseTextureBatchProcs(), with as few calls to the client
+ * as it can. Replaying a DDL hands its promise textures to the GrDrawingManager, which fulfills
+ * all of them that need it with one call per batcher at the start of the next flush. Releases
+ * made during a flush are held until its end and then handed to the client together, on the
+ * batcher's executor if it has one.
+ */
+class GrPromiseTextureBatcher : public SkRefCnt {
+public:
+    // These match the definitions in SkDeferredDisplayListRecorder.
+    typedef void* TextureContext;
+    typedef void (*FulfillProc)(void* batchContext, const TextureContext textureContexts[],
+                                GrBackendTexture outTextures[], int count);
+    typedef void (*ReleaseProc)(void* batchContext, const TextureContext textureContexts[],
+                                int count);
+
+    GrPromiseTextureBatcher(FulfillProc, ReleaseProc, void* batchContext,
+                            SkExecutor* releaseExecutor);
+    ~GrPromiseTextureBatcher() override;
+
+    /**
+     * One promise texture: a promise image's, or one plane of a YUVA promise image's. Its
+     * SkPromiseImageHelper calls fulfill() and release() in place of the per image procs.
+     */
+    class Texture : public SkRefCnt {
+    public:
+        Texture(sk_sp<GrPromiseTextureBatcher>, TextureContext,
+                sk_sp<GrReleaseProcHelper> doneHelper);
+        ~Texture() override;
+
+        /** Returns the texture fulfilled for this flush, or else fulfills this one alone. */
+        GrBackendTexture fulfill();
+
+        /** Releases what fulfill() returned. */
+        void release();
+
+    private:
+        friend class GrPromiseTextureBatcher;
+
+        sk_sp<GrPromiseTextureBatcher> fBatcher;
+        TextureContext                 fContext;
+        // Held so that the done proc can't be called while a fulfill has no release yet.
+        sk_sp<GrReleaseProcHelper>     fDoneHelper;
+        // Fulfilled by FulfillAll() and waiting to be returned by fulfill().
+        GrBackendTexture               fPrefulfilled;
+        bool                           fHasPrefulfilled = false;
+        // fulfill() returned a texture that hasn't been released.
+        bool                           fFulfilled = false;
+        // The release is held by the batcher and hasn't reached the client. Guarded by its fMutex.
+        bool                           fReleaseHeld = false;
+    };
+
+    /**
+     * Makes a promise texture, which is also kept until the next detachTextures(). Textures are
+     * made by the DDL recording thread.
+     */
+    sk_sp<Texture> makeTexture(TextureContext, sk_sp<GrReleaseProcHelper> doneHelper);
+
+    /** Returns the textures made since the last call. */
+    SkTArray<sk_sp<Texture>> detachTextures();
+
+    /**
+     * Called at the start of a flush with the promise textures of the DDLs it replays. Those that
+     * aren't already fulfilled are, with one call per batcher.
+     */
+    static void FulfillAll(const SkTArray<sk_sp<Texture>>&);
+
+    /**
+     * Called at the end of the flush with the same textures. Releases those fulfilled for the flush
+     * that it didn't use, and hands the client every release held during the flush.
+     */
+    static void FinishFlush(const SkTArray<sk_sp<Texture>>&);
+
+private:
+    void holdRelease(Texture*);
+    void deliverReleases();
+
+    const FulfillProc        fFulfillProc;
+    const ReleaseProc        fReleaseProc;
+    void* const              fBatchContext;
+    SkExecutor* const        fReleaseExecutor;
+
+    SkMutex                  fMutex;
+    SkTArray<sk_sp<Texture>> fNewTextures;       // Guarded by fMutex.
+    SkTArray<sk_sp<Texture>> fHeldReleases;      // Guarded by fMutex.
+    // How many of this batcher's textures the flushes in progress were given. Guarded by fMutex.
+    int                      fFlushingTextures = 0;
+};
+
+#endif
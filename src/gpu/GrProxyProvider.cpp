@@ -8,9 +8,15 @@
 #include "GrProxyProvider.h"
 
 #include "GrCaps.h"
+#include "GrGpu.h"
+#include "GrGpuResourcePriv.h"
 #include "GrRenderTarget.h"
+#include "GrResourceCache.h"
 #include "GrResourceKey.h"
 #include "GrResourceProvider.h"
+#include "GrResourceProviderPriv.h"
+#include "GrSemaphore.h"
+#include "GrSharedTexturePool.h"
 #include "GrSurfaceProxy.h"
 #include "GrSurfaceProxyPriv.h"
 #include "GrTexture.h"
@@ -25,8 +31,12 @@
 #include "SkImageInfoPriv.h"
 #include "SkImagePriv.h"
 #include "SkMipMap.h"
+#include "SkSemaphore.h"
+#include "SkTaskGroup.h"
 #include "SkTraceEvent.h"
 
+#include <atomic>
+
 #define ASSERT_SINGLE_OWNER \
     SkDEBUGCODE(GrSingleOwner::AutoEnforce debug_SingleOwner(fSingleOwner);)
 
@@ -92,9 +102,35 @@ bool GrProxyProvider::assignUniqueKeyToProxy(const GrUniqueKey& key, GrTexturePr
     proxy->cacheAccess().setUniqueKey(this, key);
     SkASSERT(proxy->getUniqueKey() == key);
     fUniquelyKeyedProxies.add(proxy);
+
+    if (fSharedTexturePool) {
+        this->publishSharedTexture(proxy);
+    }
     return true;
 }
 
+void GrProxyProvider::publishSharedTexture(GrTextureProxy* proxy) {
+    SkASSERT(fSharedTexturePool && fResourceProvider);
+    // Only textures whose contents are final by now are shared. That rules out render targets and
+    // lazily uploaded textures, which aren't instantiated yet.
+    GrTexture* texture = proxy->peekTexture();
+    if (!texture || texture->asRenderTarget() ||
+        SkBudgeted::kNo == texture->resourcePriv().isBudgeted()) {
+        return;
+    }
+    GrBackendTexture backendTexture = texture->getBackendTexture();
+    backendTexture.fConfig = texture->config();
+    // Makes sure the upload is visible to other contexts before they sample the texture.
+    sk_sp<GrSemaphore> semaphore =
+            fResourceProvider->priv().gpu()->prepareTextureForCrossContextUsage(texture);
+    if (fSharedTexturePool->publish(texture, backendTexture, proxy->origin(),
+                                    std::move(semaphore))) {
+        // Keeps the texture alive while other contexts borrow it. The pool releases this ref with
+        // a GrGpuResourceFreedMessage.
+        fResourceCache->insertCrossContextGpuResource(texture);
+    }
+}
+
 void GrProxyProvider::adoptUniqueKeyFromSurface(GrTextureProxy* proxy, const GrSurface* surf) {
     SkASSERT(surf->getUniqueKey().isValid());
     proxy->cacheAccess().setUniqueKey(this, surf->getUniqueKey());
@@ -161,7 +197,18 @@ sk_sp<GrTextureProxy> GrProxyProvider::findOrCreateProxyByUniqueKey(const GrUniq
 
     GrGpuResource* resource = fResourceCache->findAndRefUniqueResource(key);
     if (!resource) {
-        return nullptr;
+        if (!fSharedTexturePool) {
+            return nullptr;
+        }
+        // Wrap the texture if another context in the share group already uploaded it. The
+        // wrapped texture keeps the key, so the next lookup finds it in our own cache.
+        sk_sp<GrTexture> borrowed = fSharedTexturePool->borrow(key, origin, fResourceProvider,
+                                                               fContextUniqueID);
+        if (!borrowed) {
+            return nullptr;
+        }
+        borrowed->resourcePriv().setUniqueKey(key);
+        return this->createWrapped(std::move(borrowed), origin);
     }
 
     sk_sp<GrTexture> texture(static_cast<GrSurface*>(resource)->asTexture());
@@ -284,6 +331,29 @@ sk_sp<GrTextureProxy> GrProxyProvider::createMipMapProxy(const GrBackendFormat&
                              budgeted, GrInternalSurfaceFlags::kNone);
 }
 
+// Uploads pixmap and the levels generated from it by the cpu to a new texture.
+static sk_sp<GrTexture> create_mip_mapped_texture(GrResourceProvider* resourceProvider,
+                                                  const GrSurfaceDesc& desc,
+                                                  const SkPixmap& pixmap, const SkMipMap& mipmaps) {
+    const int mipLevelCount = mipmaps.countLevels() + 1;
+    std::unique_ptr<GrMipLevel[]> texels(new GrMipLevel[mipLevelCount]);
+
+    // DDL TODO: Instead of copying all this info into GrMipLevels we should just plumb
+    // the use of SkMipMap down through Ganesh.
+    texels[0].fPixels = pixmap.addr();
+    texels[0].fRowBytes = pixmap.rowBytes();
+
+    for (int i = 1; i < mipLevelCount; ++i) {
+        SkMipMap::Level generatedMipLevel;
+        mipmaps.getLevel(i - 1, &generatedMipLevel);
+        texels[i].fPixels = generatedMipLevel.fPixmap.addr();
+        texels[i].fRowBytes = generatedMipLevel.fPixmap.rowBytes();
+        SkASSERT(texels[i].fPixels);
+    }
+
+    return resourceProvider->createTexture(desc, SkBudgeted::kYes, texels.get(), mipLevelCount);
+}
+
 sk_sp<GrTextureProxy> GrProxyProvider::createMipMapProxyFromBitmap(const SkBitmap& bitmap) {
     if (!SkImageInfoIsValid(bitmap.info())) {
         return nullptr;
@@ -336,28 +406,9 @@ sk_sp<GrTextureProxy> GrProxyProvider::createMipMapProxyFromBitmap(const SkBitma
                 if (!resourceProvider) {
                     return sk_sp<GrTexture>();
                 }
-
-                const int mipLevelCount = mipmaps->countLevels() + 1;
-                std::unique_ptr<GrMipLevel[]> texels(new GrMipLevel[mipLevelCount]);
-
                 SkPixmap pixmap;
                 SkAssertResult(baseLevel->peekPixels(&pixmap));
-
-                // DDL TODO: Instead of copying all this info into GrMipLevels we should just plumb
-                // the use of SkMipMap down through Ganesh.
-                texels[0].fPixels = pixmap.addr();
-                texels[0].fRowBytes = pixmap.rowBytes();
-
-                for (int i = 1; i < mipLevelCount; ++i) {
-                    SkMipMap::Level generatedMipLevel;
-                    mipmaps->getLevel(i - 1, &generatedMipLevel);
-                    texels[i].fPixels = generatedMipLevel.fPixmap.addr();
-                    texels[i].fRowBytes = generatedMipLevel.fPixmap.rowBytes();
-                    SkASSERT(texels[i].fPixels);
-                }
-
-                return resourceProvider->createTexture(desc, SkBudgeted::kYes, texels.get(),
-                                                       mipLevelCount);
+                return create_mip_mapped_texture(resourceProvider, desc, pixmap, *mipmaps);
             },
             format, desc, kTopLeft_GrSurfaceOrigin, GrMipMapped::kYes, SkBackingFit::kExact,
             SkBudgeted::kYes);
@@ -376,6 +427,205 @@ sk_sp<GrTextureProxy> GrProxyProvider::createMipMapProxyFromBitmap(const SkBitma
     return proxy;
 }
 
+/**
+ * Bytes of pixels and mip levels prepared by worker threads that haven't been uploaded yet. It is
+ * shared with the DeferredUploads, which may outlive the provider.
+ */
+class GrProxyProvider::PendingUploadBytes : public SkNVRefCnt<PendingUploadBytes> {
+public:
+    explicit PendingUploadBytes(size_t maxBytes) : fMaxBytes(maxBytes) {}
+
+    bool reserve(size_t bytes) {
+        if (fBytes.fetch_add(bytes) + bytes > fMaxBytes) {
+            fBytes.fetch_sub(bytes);
+            return false;
+        }
+        return true;
+    }
+
+    void release(size_t bytes) { fBytes.fetch_sub(bytes); }
+
+private:
+    const size_t        fMaxBytes;
+    std::atomic<size_t> fBytes{0};
+};
+
+/**
+ * The pixels of an image, and their mip levels if it is to be mipped, prepared on a worker thread
+ * and uploaded when a proxy created by createDeferredProxy is instantiated. Without a worker they
+ * are prepared then, on the calling thread.
+ */
+class GrProxyProvider::DeferredUpload : public SkNVRefCnt<DeferredUpload> {
+public:
+    DeferredUpload(sk_sp<SkImage> image, GrMipMapped mipMapped, bool convertTo8888, size_t bytes,
+                   sk_sp<PendingUploadBytes> pendingBytes)
+            : fImage(std::move(image))
+            , fMipMapped(mipMapped)
+            , fConvertTo8888(convertTo8888)
+            , fBytes(bytes)
+            , fPendingBytes(std::move(pendingBytes)) {}
+
+    ~DeferredUpload() {
+        if (fPendingBytes) {
+            fPendingBytes->release(fBytes);
+        }
+    }
+
+    // Called on a worker thread, or by createTexture() if the upload has no worker.
+    void build() {
+        TRACE_EVENT0("skia", "Threaded Upload Build");
+        // Lazy images are decoded here, without caching the result: the texture is the cache.
+        if (!as_IB(fImage)->getROPixels(&fBaseLevel, SkImage::kDisallow_CachingHint)) {
+            fBaseLevel.reset();
+        }
+        fImage = nullptr;
+        if (fConvertTo8888 && !fBaseLevel.isNull()) {
+            SkBitmap copy8888;
+            if (copy8888.tryAllocPixels(fBaseLevel.info().makeColorType(kRGBA_8888_SkColorType)) &&
+                fBaseLevel.readPixels(copy8888.pixmap())) {
+                fBaseLevel = copy8888;
+            } else {
+                fBaseLevel.reset();
+            }
+        }
+        if (GrMipMapped::kYes == fMipMapped && !fBaseLevel.isNull()) {
+            fMipMaps.reset(SkMipMap::Build(fBaseLevel.pixmap(), nullptr));
+        }
+        fReady.signal();
+    }
+
+    // Called by the proxy's instantiation, after build() was added to the task group if it was.
+    sk_sp<GrTexture> createTexture(GrResourceProvider* resourceProvider,
+                                   const GrSurfaceDesc& desc) {
+        if (!fBuilt) {
+            if (fPendingBytes) {
+                fReady.wait();
+            } else {
+                this->build();
+            }
+            fBuilt = true;
+        }
+        if (fBaseLevel.isNull()) {
+            return nullptr;
+        }
+        if (GrMipMapped::kYes == fMipMapped) {
+            if (!fMipMaps) {
+                return nullptr;
+            }
+            return create_mip_mapped_texture(resourceProvider, desc, fBaseLevel.pixmap(),
+                                             *fMipMaps);
+        }
+        GrMipLevel mipLevel = { fBaseLevel.getPixels(), fBaseLevel.rowBytes() };
+        return resourceProvider->createTexture(desc, SkBudgeted::kYes, SkBackingFit::kExact,
+                                               mipLevel, GrResourceProvider::Flags::kNone);
+    }
+
+    bool hasWorker() const { return SkToBool(fPendingBytes); }
+
+private:
+    sk_sp<SkImage>            fImage;
+    SkBitmap                  fBaseLevel;
+    sk_sp<SkMipMap>           fMipMaps;
+    const GrMipMapped         fMipMapped;
+    const bool                fConvertTo8888;
+    const size_t              fBytes;
+    // Only set if build() runs on a worker, whose result is counted against the budget.
+    sk_sp<PendingUploadBytes> fPendingBytes;
+    SkSemaphore               fReady;
+    bool                      fBuilt = false;
+};
+
+void GrProxyProvider::setUploadTaskGroup(SkTaskGroup* taskGroup, size_t maxPendingBytes) {
+    SkASSERT(!taskGroup || fResourceProvider);
+    fUploadTaskGroup = taskGroup;
+    fPendingUploadBytes = taskGroup ? sk_make_sp<PendingUploadBytes>(maxPendingBytes) : nullptr;
+}
+
+sk_sp<GrTextureProxy> GrProxyProvider::createDeferredMipMapProxyFromBitmap(const SkBitmap& bitmap) {
+    // Mutable pixels could change before the worker reads them.
+    if (!fUploadTaskGroup || !bitmap.isImmutable() || !SkImageInfoIsValid(bitmap.info()) ||
+        0 == SkMipMap::ComputeLevelCount(bitmap.width(), bitmap.height())) {
+        return this->createMipMapProxyFromBitmap(bitmap);
+    }
+    sk_sp<SkImage> image = SkMakeImageFromRasterBitmap(bitmap, kNever_SkCopyPixelsMode);
+    sk_sp<GrTextureProxy> proxy;
+    if (image) {
+        proxy = this->createDeferredProxy(std::move(image), GrMipMapped::kYes,
+                                          /* requireWorker */ true);
+    }
+    // Too much may be waiting for a flush already; if so build the levels here instead.
+    return proxy ? proxy : this->createMipMapProxyFromBitmap(bitmap);
+}
+
+sk_sp<GrTextureProxy> GrProxyProvider::createDeferredTextureProxy(sk_sp<SkImage> image,
+                                                                  GrMipMapped mipMapped) {
+    return this->createDeferredProxy(std::move(image), mipMapped, /* requireWorker */ false);
+}
+
+sk_sp<GrTextureProxy> GrProxyProvider::createDeferredProxy(sk_sp<SkImage> image,
+                                                           GrMipMapped mipMapped,
+                                                           bool requireWorker) {
+    ASSERT_SINGLE_OWNER
+    SkASSERT(image);
+
+    if (this->isAbandoned()) {
+        return nullptr;
+    }
+
+    const SkImageInfo info = as_IB(image)->onImageInfo();
+    if (!SkImageInfoIsValid(info)) {
+        return nullptr;
+    }
+    if (0 == SkMipMap::ComputeLevelCount(info.width(), info.height())) {
+        mipMapped = GrMipMapped::kNo;
+    }
+
+    const GrBackendFormat format = fCaps->getBackendFormatFromColorType(info.colorType());
+    if (!format.isValid()) {
+        return nullptr;
+    }
+
+    GrSurfaceDesc desc = GrImageInfoToSurfaceDesc(info);
+    if (kUnknown_GrPixelConfig == desc.fConfig) {
+        return nullptr;
+    }
+    bool convertTo8888 = !this->caps()->isConfigTexturable(desc.fConfig);
+    if (convertTo8888) {
+        desc.fConfig = kRGBA_8888_GrPixelConfig;
+    }
+
+    // A mip chain adds a third to the size of the base level.
+    size_t bytes = desc.fWidth * desc.fHeight * GrBytesPerPixel(desc.fConfig);
+    if (GrMipMapped::kYes == mipMapped) {
+        bytes = bytes * 4 / 3;
+    }
+    sk_sp<PendingUploadBytes> pendingBytes;
+    if (fUploadTaskGroup && fPendingUploadBytes->reserve(bytes)) {
+        pendingBytes = fPendingUploadBytes;
+    } else if (requireWorker) {
+        return nullptr;
+    }
+
+    ATRACE_ANDROID_FRAMEWORK("Deferred Upload Texture [%ux%u]", desc.fWidth, desc.fHeight);
+
+    sk_sp<DeferredUpload> upload(new DeferredUpload(std::move(image), mipMapped, convertTo8888,
+                                                    bytes, std::move(pendingBytes)));
+    if (upload->hasWorker()) {
+        fUploadTaskGroup->add([upload] { upload->build(); });
+    }
+
+    // The proxy stays lazy so that the worker has until the flush to finish.
+    return this->createLazyProxy(
+            [desc, upload](GrResourceProvider* resourceProvider) {
+                if (!resourceProvider) {
+                    return sk_sp<GrTexture>();
+                }
+                return upload->createTexture(resourceProvider, desc);
+            },
+            format, desc, kTopLeft_GrSurfaceOrigin, mipMapped, SkBackingFit::kExact,
+            SkBudgeted::kYes);
+}
+
 sk_sp<GrTextureProxy> GrProxyProvider::createProxy(const GrBackendFormat& format,
                                                    const GrSurfaceDesc& desc,
                                                    GrSurfaceOrigin origin,
@@ -664,6 +914,9 @@ bool GrProxyProvider::IsFunctionallyExact(GrSurfaceProxy* proxy) {
 }
 
 void GrProxyProvider::processInvalidProxyUniqueKey(const GrUniqueKey& key) {
+    if (fSharedTexturePool) {
+        fSharedTexturePool->withdraw(key, fContextUniqueID);
+    }
     // Note: this method is called for the whole variety of GrGpuResources so often 'key'
     // will not be in 'fUniquelyKeyedProxies'.
     GrTextureProxy* proxy = fUniquelyKeyedProxies.find(key);
@@ -686,6 +939,29 @@ void GrProxyProvider::processInvalidProxyUniqueKey(const GrUniqueKey& key, GrTex
         if (surface) {
             surface->resourcePriv().removeUniqueKey();
         }
+        if (fSharedTexturePool) {
+            fSharedTexturePool->withdraw(key, fContextUniqueID);
+        }
+    }
+}
+
+void GrProxyProvider::abandon() {
+    this->withdrawSharedTextures();
+    fSharedTexturePool = nullptr;
+    fResourceCache = nullptr;
+    fResourceProvider = nullptr;
+    fAbandoned = true;
+}
+
+void GrProxyProvider::setSharedTexturePool(GrSharedTexturePool* pool) {
+    SkASSERT(!pool || fResourceProvider);
+    this->withdrawSharedTextures();
+    fSharedTexturePool = pool;
+}
+
+void GrProxyProvider::withdrawSharedTextures() {
+    if (fSharedTexturePool) {
+        fSharedTexturePool->withdrawAll(fContextUniqueID);
     }
 }
 
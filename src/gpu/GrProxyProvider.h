@@ -16,10 +16,12 @@
 #include "SkTDynamicHash.h"
 
 class GrResourceProvider;
+class GrSharedTexturePool;
 class GrSingleOwner;
 class GrBackendRenderTarget;
 class SkBitmap;
 class SkImage;
+class SkTaskGroup;
 
 /*
  * A factory for creating GrSurfaceProxy-derived objects.
@@ -84,6 +86,21 @@ public:
      */
     sk_sp<GrTextureProxy> createMipMapProxyFromBitmap(const SkBitmap& bitmap);
 
+    /*
+     * Like createMipMapProxyFromBitmap, but if an upload task group is set the mip levels of an
+     * immutable bitmap are built on a worker thread, and the texture is created and uploaded when
+     * the proxy is instantiated at flush time. The returned proxy may thus be uninstantiated.
+     */
+    sk_sp<GrTextureProxy> createDeferredMipMapProxyFromBitmap(const SkBitmap& bitmap);
+
+    /*
+     * Creates a lazy proxy for the pixels of a raster or lazy generated image that is only
+     * instantiated, and uploaded, by the first flush that uses it. If an upload task group is
+     * set and its budget allows, the image is decoded, converted to a texturable config and
+     * mipped on a worker thread in the meantime; otherwise that happens at instantiation.
+     */
+    sk_sp<GrTextureProxy> createDeferredTextureProxy(sk_sp<SkImage>, GrMipMapped);
+
     /*
      * Create a GrSurfaceProxy without any data.
      */
@@ -208,11 +225,23 @@ public:
     const GrCaps* caps() const { return fCaps.get(); }
     sk_sp<const GrCaps> refCaps() const { return fCaps; }
 
-    void abandon() {
-        fResourceCache = nullptr;
-        fResourceProvider = nullptr;
-        fAbandoned = true;
-    }
+    void abandon();
+
+    /**
+     * Shares this provider's uniquely keyed textures with the other GrContexts using the pool, and
+     * looks up keys it can't find itself in the pool. Only valid in a direct context.
+     */
+    void setSharedTexturePool(GrSharedTexturePool*);
+
+    /** Withdraws every texture this provider published to its GrSharedTexturePool. */
+    void withdrawSharedTextures();
+
+    /*
+     * Sets the task group that createDeferredMipMapProxyFromBitmap builds mip levels on. Once
+     * maxPendingBytes of levels are waiting to be uploaded, further bitmaps are mipped on the
+     * calling thread.
+     */
+    void setUploadTaskGroup(SkTaskGroup*, size_t maxPendingBytes);
 
     bool isAbandoned() const {
 #ifdef SK_DEBUG
@@ -247,8 +276,17 @@ private:
     friend class GrAHardwareBufferImageGenerator; // for createWrapped
     friend class GrResourceProvider; // for createWrapped
 
+    class DeferredUpload;
+    class PendingUploadBytes;
+
     sk_sp<GrTextureProxy> createWrapped(sk_sp<GrTexture> tex, GrSurfaceOrigin origin);
 
+    // Returns null if requireWorker is set and the image can't be prepared on a worker thread.
+    sk_sp<GrTextureProxy> createDeferredProxy(sk_sp<SkImage>, GrMipMapped, bool requireWorker);
+
+    // Publishes the uniquely keyed proxy's texture to fSharedTexturePool, if it can be shared.
+    void publishSharedTexture(GrTextureProxy*);
+
     struct UniquelyKeyedProxyHashTraits {
         static const GrUniqueKey& GetKey(const GrTextureProxy& p) { return p.getUniqueKey(); }
 
@@ -262,6 +300,9 @@ private:
 
     GrResourceProvider*    fResourceProvider;
     GrResourceCache*       fResourceCache;
+    GrSharedTexturePool*   fSharedTexturePool = nullptr;
+    SkTaskGroup*           fUploadTaskGroup = nullptr;
+    sk_sp<PendingUploadBytes> fPendingUploadBytes;
     bool                   fAbandoned;
     sk_sp<const GrCaps>    fCaps;
     // If this provider is owned by a DDLContext then this is the DirectContext's ID.
@@ -21,6 +21,7 @@
 #include "GrStyle.h"
 #include "GrUserStencilSettings.h"
 #include "SkClipOpPriv.h"
+#include "SkPathOps.h"
 #include "ccpr/GrCoverageCountingPathRenderer.h"
 #include "effects/GrAARectEffect.h"
 #include "effects/GrConvexPolyEffect.h"
@@ -615,7 +616,7 @@ GrClipEdgeType GrReducedClip::GetClipEdgeType(Invert invert, GrAA aa) {
 GrReducedClip::ClipResult GrReducedClip::addAnalyticFP(const SkRect& deviceSpaceRect,
                                                        Invert invert, GrAA aa) {
     if (this->numAnalyticFPs() >= fMaxAnalyticFPs) {
-        return ClipResult::kNotClipped;
+        return this->mergeIntoCCPRClipPath(SkPath().addRect(deviceSpaceRect), invert, aa);
     }
 
     fAnalyticFPs.push_back(GrAARectEffect::Make(GetClipEdgeType(invert, aa), deviceSpaceRect));
@@ -627,7 +628,7 @@ GrReducedClip::ClipResult GrReducedClip::addAnalyticFP(const SkRect& deviceSpace
 GrReducedClip::ClipResult GrReducedClip::addAnalyticFP(const SkRRect& deviceSpaceRRect,
                                                        Invert invert, GrAA aa) {
     if (this->numAnalyticFPs() >= fMaxAnalyticFPs) {
-        return ClipResult::kNotClipped;
+        return this->mergeIntoCCPRClipPath(SkPath().addRRect(deviceSpaceRRect), invert, aa);
     }
 
     if (auto fp = GrRRectEffect::Make(GetClipEdgeType(invert, aa), deviceSpaceRRect,
@@ -645,7 +646,7 @@ GrReducedClip::ClipResult GrReducedClip::addAnalyticFP(const SkRRect& deviceSpac
 GrReducedClip::ClipResult GrReducedClip::addAnalyticFP(const SkPath& deviceSpacePath,
                                                        Invert invert, GrAA aa) {
     if (this->numAnalyticFPs() >= fMaxAnalyticFPs) {
-        return ClipResult::kNotClipped;
+        return this->mergeIntoCCPRClipPath(deviceSpacePath, invert, aa);
     }
 
     if (auto fp = GrConvexPolyEffect::Make(GetClipEdgeType(invert, aa), deviceSpacePath)) {
@@ -663,7 +664,31 @@ GrReducedClip::ClipResult GrReducedClip::addAnalyticFP(const SkPath& deviceSpace
         return ClipResult::kClipped;
     }
 
-    return ClipResult::kNotClipped;
+    return this->mergeIntoCCPRClipPath(deviceSpacePath, invert, aa);
+}
+
+GrReducedClip::ClipResult GrReducedClip::mergeIntoCCPRClipPath(const SkPath& deviceSpacePath,
+                                                               Invert invert, GrAA aa) {
+    if (fCCPRClipPaths.empty() || GrAA::kNo == aa) {
+        return ClipResult::kNotClipped;
+    }
+
+    // We are out of FPs, but the clip is an intersection so far. Rather than falling back on a
+    // mask, fold this element into the last CCPR path on the CPU. It then shares that path's atlas
+    // entry and clip processor. (Reductions are cached, so this only happens once per clip.)
+    SkPath& ccprClipPath = fCCPRClipPaths.back();
+    SkPath merged;
+    if (!Op(ccprClipPath, deviceSpacePath,
+            Invert::kYes == invert ? kDifference_SkPathOp : kIntersect_SkPathOp, &merged)) {
+        return ClipResult::kNotClipped;
+    }
+    if (merged.isEmpty() && !merged.isInverseFillType()) {
+        this->makeEmpty();
+        return ClipResult::kMadeEmpty;
+    }
+    merged.setIsVolatile(true);
+    ccprClipPath = std::move(merged);
+    return ClipResult::kClipped;
 }
 
 void GrReducedClip::makeEmpty() {
@@ -976,3 +1001,57 @@ std::unique_ptr<GrFragmentProcessor> GrReducedClip::finishAndDetachAnalyticFPs(
 
     return GrFragmentProcessor::RunInSeries(fAnalyticFPs.begin(), fAnalyticFPs.count());
 }
+
+std::unique_ptr<GrFragmentProcessor> GrReducedClip::makeAnalyticFPs(
+        GrCoverageCountingPathRenderer* ccpr, uint32_t opListID, int rtWidth, int rtHeight) const {
+    SkSTArray<4, std::unique_ptr<GrFragmentProcessor>> fps;
+    fps.reserve(this->numAnalyticFPs());
+    for (const auto& fp : fAnalyticFPs) {
+        SkASSERT(fp);
+        fps.push_back(fp->clone());
+    }
+    for (const SkPath& ccprClipPath : fCCPRClipPaths) {
+        SkASSERT(ccpr);
+        SkASSERT(fHasScissor);
+        fps.push_back(ccpr->makeClipProcessor(opListID, ccprClipPath, fScissor, rtWidth, rtHeight,
+                                              *fCaps));
+    }
+    return GrFragmentProcessor::RunInSeries(fps.begin(), fps.count());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+const GrReducedClip& GrReducedClipCache::findOrCreate(const SkClipStack& stack,
+                                                      const SkRect& queryBounds,
+                                                      const GrCaps* caps, int maxWindowRectangles,
+                                                      int maxAnalyticFPs, int maxCCPRClipPaths) {
+    uint32_t genID = stack.getTopmostGenID();
+    ++fUseCounter;
+
+    Entry* lru = nullptr;
+    for (int i = 0; i < fCount; ++i) {
+        Entry& entry = fEntries[i];
+        if (entry.fGenID == genID && entry.fQueryBounds == queryBounds &&
+            entry.fMaxWindowRectangles == maxWindowRectangles &&
+            entry.fMaxAnalyticFPs == maxAnalyticFPs &&
+            entry.fMaxCCPRClipPaths == maxCCPRClipPaths) {
+            entry.fLastUse = fUseCounter;
+            return *entry.fReducedClip;
+        }
+        // Unsigned differences keep this right if the counter wraps.
+        if (!lru || fUseCounter - entry.fLastUse > fUseCounter - lru->fLastUse) {
+            lru = &entry;
+        }
+    }
+
+    Entry& entry = fCount < kMaxEntries ? fEntries[fCount++] : *lru;
+    entry.fGenID = genID;
+    entry.fQueryBounds = queryBounds;
+    entry.fMaxWindowRectangles = maxWindowRectangles;
+    entry.fMaxAnalyticFPs = maxAnalyticFPs;
+    entry.fMaxCCPRClipPaths = maxCCPRClipPaths;
+    entry.fLastUse = fUseCounter;
+    entry.fReducedClip.reset(new GrReducedClip(stack, queryBounds, caps, maxWindowRectangles,
+                                               maxAnalyticFPs, maxCCPRClipPaths));
+    return *entry.fReducedClip;
+}
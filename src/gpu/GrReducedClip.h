@@ -100,6 +100,14 @@ public:
                                                                     uint32_t opListID, int rtWidth,
                                                                     int rtHeight);
 
+    /**
+     * Like finishAndDetachAnalyticFPs, but leaves this object intact by cloning its FPs. This is
+     * how reduced clips that outlive a single draw (see GrReducedClipCache) hand out their FPs.
+     */
+    std::unique_ptr<GrFragmentProcessor> makeAnalyticFPs(GrCoverageCountingPathRenderer*,
+                                                         uint32_t opListID, int rtWidth,
+                                                         int rtHeight) const;
+
 private:
     void walkStack(const SkClipStack&, const SkRect& queryBounds);
 
@@ -128,6 +136,8 @@ private:
     ClipResult addAnalyticFP(const SkRect& deviceSpaceRect, Invert, GrAA);
     ClipResult addAnalyticFP(const SkRRect& deviceSpaceRRect, Invert, GrAA);
     ClipResult addAnalyticFP(const SkPath& deviceSpacePath, Invert, GrAA);
+    // Once we run out of FPs, AA elements can still be combined into the last CCPR clip path.
+    ClipResult mergeIntoCCPRClipPath(const SkPath& deviceSpacePath, Invert, GrAA);
 
     void makeEmpty();
 
@@ -149,4 +159,40 @@ private:
     SkSTArray<4, SkPath> fCCPRClipPaths; // Will convert to FPs once we have an opList ID for CCPR.
 };
 
+/**
+ * A small cache of recently used reduced clips. Clip stacks tend to stay the same across many draws
+ * (and across frames), so GrClipStackClip looks here before reducing the stack again. Entries are
+ * keyed by the stack's topmost gen ID, the query bounds, and the reduction limits. Gen IDs are not
+ * reused, so an entry can't go stale; it just ages out once kMaxEntries newer clips are used.
+ */
+class GrReducedClipCache : SkNoncopyable {
+public:
+    /**
+     * Returns the reduction of the given clip stack, creating it if it isn't already cached. The
+     * result is owned by the cache and is only valid until the next call.
+     */
+    const GrReducedClip& findOrCreate(const SkClipStack&, const SkRect& queryBounds,
+                                      const GrCaps*, int maxWindowRectangles = 0,
+                                      int maxAnalyticFPs = 0, int maxCCPRClipPaths = 0);
+
+    int count() const { return fCount; }
+
+    static constexpr int kMaxEntries = 16;
+
+private:
+    struct Entry {
+        uint32_t                       fGenID;
+        SkRect                         fQueryBounds;
+        int                            fMaxWindowRectangles;
+        int                            fMaxAnalyticFPs;
+        int                            fMaxCCPRClipPaths;
+        uint32_t                       fLastUse;
+        std::unique_ptr<GrReducedClip> fReducedClip;
+    };
+
+    Entry    fEntries[kMaxEntries];
+    int      fCount = 0;
+    uint32_t fUseCounter = 0;
+};
+
 #endif
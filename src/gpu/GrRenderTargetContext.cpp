@@ -12,9 +12,11 @@
 #include "GrBackendSemaphore.h"
 #include "GrBlurUtils.h"
 #include "GrColor.h"
+#include "GrColorSpaceXform.h"
 #include "GrContextPriv.h"
 #include "GrDrawingManager.h"
 #include "GrFixedClip.h"
+#include "GrGpu.h"
 #include "GrGpuResourcePriv.h"
 #include "GrOpList.h"
 #include "GrPathRenderer.h"
@@ -26,6 +28,8 @@
 #include "GrStencilAttachment.h"
 #include "GrStyle.h"
 #include "GrTracing.h"
+#include "SkAutoPixmapStorage.h"
+#include "SkColorFilter.h"
 #include "SkDrawable.h"
 #include "SkDrawShadowInfo.h"
 #include "SkGlyphRunPainter.h"
@@ -35,7 +39,9 @@
 #include "SkRRectPriv.h"
 #include "SkShadowUtils.h"
 #include "SkSurfacePriv.h"
+#include "effects/GrBicubicEffect.h"
 #include "effects/GrRRectEffect.h"
+#include "effects/GrTextureDomain.h"
 #include "ops/GrAtlasTextOp.h"
 #include "ops/GrClearOp.h"
 #include "ops/GrClearStencilClipOp.h"
@@ -462,6 +468,23 @@ static inline bool rect_contains_inclusive(const SkRect& rect, const SkPoint& po
            point.fY >= rect.fTop && point.fY <= rect.fBottom;
 }
 
+// Finds the device pixels that a rect drawn with 'viewMatrix' covers entirely, as long as the clip
+// doesn't cut into them. Returns false if there are none.
+static bool find_covered_pixels(const GrClip& clip, const SkMatrix& viewMatrix, const SkRect& rect,
+                                SkRect* coveredPixels) {
+    if (!viewMatrix.rectStaysRect()) {
+        return false;
+    }
+    // Pixels entirely inside the rect have full coverage, with or without antialiasing.
+    SkIRect pixels;
+    viewMatrix.mapRect(rect).roundIn(&pixels);
+    if (pixels.isEmpty()) {
+        return false;
+    }
+    *coveredPixels = SkRect::Make(pixels);
+    return clip.quickContains(*coveredPixels);
+}
+
 // Attempts to crop a rect and optional local rect to the clip boundaries.
 // Returns false if the draw can be skipped entirely.
 static bool crop_filled_rect(int width, int height, const GrClip& clip,
@@ -518,6 +541,11 @@ bool GrRenderTargetContext::drawFilledRect(const GrClip& clip,
         return true;
     }
 
+    // An opaque rect hides whatever was drawn under it before.
+    SkRect opaqueRect;
+    bool isOpaque = !ss && !paint.numCoverageFragmentProcessors() && paint.overwritesDst() &&
+                    find_covered_pixels(clip, viewMatrix, croppedRect, &opaqueRect);
+
     GrAAType aaType = this->chooseAAType(aa, GrAllowMixedSamples::kNo);
     std::unique_ptr<GrDrawOp> op;
     if (GrAAType::kCoverage == aaType) {
@@ -529,7 +557,7 @@ bool GrRenderTargetContext::drawFilledRect(const GrClip& clip,
     if (!op) {
         return false;
     }
-    this->addDrawOp(clip, std::move(op));
+    this->addDrawOp(clip, std::move(op), nullptr, isOpaque ? &opaqueRect : nullptr);
     return true;
 }
 
@@ -576,6 +604,10 @@ void GrRenderTargetContext::drawRect(const GrClip& clip,
                                 GrRenderTargetContext::CanClearFullscreen::kYes);
                     return;
                 }
+                // If it replaces every pixel, the opList needn't load the previous contents.
+                if (paint.overwritesDst()) {
+                    this->getRTOpList()->discard();
+                }
             }
         }
 
@@ -832,10 +864,15 @@ void GrRenderTargetContext::drawTexture(const GrClip& clip, sk_sp<GrTextureProxy
                           &clippedSrcRect)) {
         return;
     }
+    // An opaque texture hides whatever was drawn under it before. Over the whole target, the
+    // opList needn't load the previous contents either.
+    SkRect opaqueRect;
+    bool isOpaque = color.isOpaque() && GrPixelConfigIsOpaque(proxy->config()) &&
+                    find_covered_pixels(clip, viewMatrix, clippedDstRect, &opaqueRect);
     auto op = GrTextureOp::Make(fContext, std::move(proxy), filter, color, clippedSrcRect,
                                 clippedDstRect, aaType, aaFlags, constraint, viewMatrix,
                                 std::move(textureColorSpaceXform));
-    this->addDrawOp(clip, std::move(op));
+    this->addDrawOp(clip, std::move(op), nullptr, isOpaque ? &opaqueRect : nullptr);
 }
 
 void GrRenderTargetContext::drawTextureSet(const GrClip& clip, const TextureSetEntry set[], int cnt,
@@ -1516,6 +1553,326 @@ bool GrRenderTargetContext::waitOnSemaphores(int numSemaphores,
     return true;
 }
 
+sk_sp<GrRenderTargetContext> GrRenderTargetContext::rescale(const SkImageInfo& info,
+                                                            const SkIRect& srcRect,
+                                                            SkFilterQuality quality) {
+    const GrCaps* caps = this->caps();
+    sk_sp<GrTextureProxy> texProxy = this->asTextureProxyRef();
+    SkIRect rect = srcRect;
+    if (!texProxy) {
+        texProxy = GrSurfaceProxy::Copy(fContext, fRenderTargetProxy.get(), GrMipMapped::kNo,
+                                        srcRect, SkBudgeted::kYes);
+        if (!texProxy) {
+            return nullptr;
+        }
+        rect = SkIRect::MakeWH(srcRect.width(), srcRect.height());
+    }
+    sk_sp<SkColorSpace> srcColorSpace = this->colorSpaceInfo().refColorSpace();
+
+    sk_sp<GrRenderTargetContext> stepRTC;
+    for (;;) {
+        int nextW = info.width();
+        int nextH = info.height();
+        if (quality >= kMedium_SkFilterQuality) {
+            // Stepping down by at most half keeps bilerp from skipping over source texels.
+            if (rect.width() > 2 * nextW) {
+                nextW = (rect.width() + 1) / 2;
+            }
+            if (rect.height() > 2 * nextH) {
+                nextH = (rect.height() + 1) / 2;
+            }
+        }
+        const bool lastStep = nextW == info.width() && nextH == info.height();
+
+        // Intermediate steps stay in the source's config and color space.
+        SkColorType ct = lastStep ? info.colorType()
+                                  : GrColorTypeToSkColorType(
+                                            GrPixelConfigToColorType(texProxy->config()));
+        GrPixelConfig config = SkColorType2GrPixelConfig(ct);
+        if (kUnknown_GrPixelConfig == config || !caps->isConfigRenderable(config)) {
+            ct = kRGBA_8888_SkColorType;
+            config = kRGBA_8888_GrPixelConfig;
+        }
+        sk_sp<SkColorSpace> stepColorSpace = lastStep ? info.refColorSpace() : srcColorSpace;
+        stepRTC = fContext->contextPriv().makeDeferredRenderTargetContext(
+                caps->getBackendFormatFromColorType(ct), SkBackingFit::kExact, nextW, nextH,
+                config, stepColorSpace, 1, GrMipMapped::kNo, kTopLeft_GrSurfaceOrigin);
+        if (!stepRTC) {
+            return nullptr;
+        }
+
+        std::unique_ptr<GrFragmentProcessor> fp;
+        if (lastStep && kHigh_SkFilterQuality == quality) {
+            fp = GrBicubicEffect::Make(std::move(texProxy), SkMatrix::I(), SkRect::Make(rect));
+        } else {
+            GrSamplerState::Filter filter = kNone_SkFilterQuality == quality
+                                                    ? GrSamplerState::Filter::kNearest
+                                                    : GrSamplerState::Filter::kBilerp;
+            fp = GrTextureDomainEffect::Make(
+                    std::move(texProxy), SkMatrix::I(),
+                    GrTextureDomain::MakeTexelDomainForMode(rect, GrTextureDomain::kClamp_Mode),
+                    GrTextureDomain::kClamp_Mode, filter);
+        }
+        fp = GrColorSpaceXformEffect::Make(std::move(fp), srcColorSpace.get(),
+                                           kPremul_SkAlphaType, stepColorSpace.get());
+        GrPaint paint;
+        paint.addColorFragmentProcessor(std::move(fp));
+        paint.setPorterDuffXPFactory(SkBlendMode::kSrc);
+        stepRTC->fillRectToRect(GrNoClip(), std::move(paint), GrAA::kNo, SkMatrix::I(),
+                                SkRect::MakeWH(nextW, nextH), SkRect::Make(rect));
+        if (lastStep) {
+            return stepRTC;
+        }
+        texProxy = stepRTC->asTextureProxyRef();
+        if (!texProxy) {
+            return nullptr;
+        }
+        rect = SkIRect::MakeWH(nextW, nextH);
+        srcColorSpace = std::move(stepColorSpace);
+    }
+}
+
+// Copies 'rect' of 'rtc' into a new transfer buffer, in whatever color type the caps read the
+// plane's dstInfo as, and fills in the plane. Returns false if that can't be done, in which case
+// the caller reads synchronously instead.
+static bool transfer_to_buffer(GrContext* context, GrRenderTargetContext* rtc,
+                               const SkIRect& rect, const SkImageInfo& dstInfo,
+                               GrDrawingManager::AsyncRead::Plane* plane) {
+    const GrCaps* caps = context->contextPriv().caps();
+    GrSurfaceProxy* proxy = rtc->asSurfaceProxy();
+    if (!proxy->instantiate(context->contextPriv().resourceProvider())) {
+        return false;
+    }
+    GrColorType readCT = caps->supportedReadPixelsColorType(
+            proxy->config(), SkColorTypeToGrColorType(dstInfo.colorType()));
+    SkColorType bufferCT = GrColorTypeToSkColorType(readCT);
+    if (kUnknown_SkColorType == bufferCT) {
+        return false;
+    }
+    // The render target holds premultiplied colors.
+    SkAlphaType bufferAT = kUnpremul_SkAlphaType == dstInfo.alphaType() ? kPremul_SkAlphaType
+                                                                         : dstInfo.alphaType();
+    SkImageInfo bufferInfo = SkImageInfo::Make(rect.width(), rect.height(), bufferCT, bufferAT,
+                                               rtc->colorSpaceInfo().refColorSpace());
+
+    context->contextPriv().flush(proxy);
+    sk_sp<GrBuffer> buffer(context->contextPriv().resourceProvider()->createBuffer(
+            bufferInfo.computeMinByteSize(), kXferGpuToCpu_GrBufferType, kStream_GrAccessPattern,
+            GrResourceProvider::Flags::kNoPendingIO));
+    if (!buffer || !context->contextPriv().getGpu()->transferPixelsFrom(
+                           proxy->peekSurface(), rect.fLeft, rect.fTop, rect.width(),
+                           rect.height(), readCT, buffer.get(), 0)) {
+        return false;
+    }
+    plane->fBuffer = std::move(buffer);
+    plane->fBufferInfo = bufferInfo;
+    plane->fDstInfo = dstInfo;
+    return true;
+}
+
+// Submits the transfers the planes were given and hands them to the drawing manager, which calls
+// the read's callback when the fence inserted after them signals.
+static void add_async_read(GrContext* context, GrDrawingManager* drawingManager,
+                           GrDrawingManager::AsyncRead&& read) {
+    GrGpu* gpu = context->contextPriv().getGpu();
+    gpu->finishFlush(0, nullptr);
+    read.fFence = gpu->insertFence();
+    drawingManager->addAsyncRead(std::move(read));
+}
+
+static bool can_transfer(GrContext* context) {
+    const GrCaps* caps = context->contextPriv().caps();
+    return caps->transferFromSurfaceToBufferSupport() && caps->fenceSyncSupport();
+}
+
+void GrRenderTargetContext::asyncRescaleAndReadPixels(const SkImageInfo& info,
+                                                      const SkIRect& srcRect,
+                                                      SkFilterQuality quality,
+                                                      SkSurface::ReadPixelsCallback callback,
+                                                      SkSurface::ReadPixelsContext context) {
+    ASSERT_SINGLE_OWNER
+    if (this->drawingManager()->wasAbandoned()) {
+        callback(context, nullptr, 0);
+        return;
+    }
+    SkDEBUGCODE(this->validate();)
+    GR_CREATE_TRACE_MARKER_CONTEXT("GrRenderTargetContext", "asyncRescaleAndReadPixels",
+                                   fContext);
+
+    // A transfer copies rows as they are, so only top-left surfaces are read in place.
+    sk_sp<GrRenderTargetContext> rtc;
+    SkIRect rect = srcRect;
+    if (srcRect.width() == info.width() && srcRect.height() == info.height() &&
+        kTopLeft_GrSurfaceOrigin == this->origin()) {
+        rtc = sk_ref_sp(this);
+    } else {
+        rtc = this->rescale(info, srcRect, quality);
+        rect = SkIRect::MakeWH(info.width(), info.height());
+    }
+    if (!rtc) {
+        callback(context, nullptr, 0);
+        return;
+    }
+
+    GrDrawingManager::AsyncRead read;
+    read.fCallback = callback;
+    read.fContext = context;
+    read.fPlanes.push_back();
+    if (can_transfer(fContext) &&
+        transfer_to_buffer(fContext, rtc.get(), rect, info, &read.fPlanes.back())) {
+        add_async_read(fContext, this->drawingManager(), std::move(read));
+        return;
+    }
+
+    SkAutoPixmapStorage pm;
+    if (!pm.tryAlloc(info) ||
+        !rtc->readPixels(info, pm.writable_addr(), pm.rowBytes(), rect.fLeft, rect.fTop)) {
+        callback(context, nullptr, 0);
+        return;
+    }
+    callback(context, pm.addr(), pm.rowBytes());
+}
+
+// Rows of SkColorMatrix that compute Y, U and V from unpremultiplied RGB in the alpha channel.
+// The coefficients apply to colors in 0..1 and the offsets are in 0..255.
+static void yuv_alpha_rows(SkYUVColorSpace yuvColorSpace, float rows[3][20]) {
+    static constexpr float kJPEG[3][4] = {
+        {  0.299f,     0.587f,     0.114f,     0.0f  },
+        { -0.168736f, -0.331264f,  0.5f,     128.0f  },
+        {  0.5f,      -0.418688f, -0.081312f, 128.0f },
+    };
+    static constexpr float kRec601[3][4] = {
+        {  0.256788f,  0.504129f,  0.097906f,  16.0f  },
+        { -0.148223f, -0.290993f,  0.439216f, 128.0f  },
+        {  0.439216f, -0.367788f, -0.071427f, 128.0f  },
+    };
+    static constexpr float kRec709[3][4] = {
+        {  0.182586f,  0.614231f,  0.062007f,  16.0f  },
+        { -0.100644f, -0.338572f,  0.439216f, 128.0f  },
+        {  0.439216f, -0.398942f, -0.040274f, 128.0f  },
+    };
+    const float (*coeffs)[4] = kJPEG;
+    switch (yuvColorSpace) {
+        case kJPEG_SkYUVColorSpace:
+            coeffs = kJPEG;
+            break;
+        case kRec601_SkYUVColorSpace:
+            coeffs = kRec601;
+            break;
+        case kRec709_SkYUVColorSpace:
+            coeffs = kRec709;
+            break;
+    }
+    for (int i = 0; i < 3; ++i) {
+        memset(rows[i], 0, sizeof(rows[i]));
+        rows[i][15] = coeffs[i][0];
+        rows[i][16] = coeffs[i][1];
+        rows[i][17] = coeffs[i][2];
+        rows[i][19] = coeffs[i][3];
+    }
+}
+
+void GrRenderTargetContext::asyncRescaleAndReadPixelsYUV420(
+        SkYUVColorSpace yuvColorSpace, sk_sp<SkColorSpace> dstColorSpace, const SkIRect& srcRect,
+        int dstW, int dstH, SkFilterQuality quality, SkSurface::ReadPixelsCallbackYUV420 callback,
+        SkSurface::ReadPixelsContext context) {
+    ASSERT_SINGLE_OWNER
+    if (this->drawingManager()->wasAbandoned()) {
+        callback(context, nullptr, nullptr);
+        return;
+    }
+    SkDEBUGCODE(this->validate();)
+    GR_CREATE_TRACE_MARKER_CONTEXT("GrRenderTargetContext", "asyncRescaleAndReadPixelsYUV420",
+                                   fContext);
+
+    SkImageInfo rgbaInfo = SkImageInfo::Make(dstW, dstH, kRGBA_8888_SkColorType,
+                                             kPremul_SkAlphaType, std::move(dstColorSpace));
+    sk_sp<GrRenderTargetContext> rgbaRTC = this->rescale(rgbaInfo, srcRect, quality);
+    sk_sp<GrTextureProxy> rgbaProxy = rgbaRTC ? rgbaRTC->asTextureProxyRef() : nullptr;
+    if (!rgbaProxy) {
+        callback(context, nullptr, nullptr);
+        return;
+    }
+
+    // Each plane is drawn into the alpha of its own render target: A8 if it can be both rendered
+    // and read as such, otherwise RGBA, whose alpha the readback extracts.
+    const GrCaps* caps = this->caps();
+    GrPixelConfig planeConfig = kAlpha_8_GrPixelConfig;
+    SkColorType planeCT = kAlpha_8_SkColorType;
+    if (!caps->isConfigRenderable(kAlpha_8_GrPixelConfig) ||
+        GrColorType::kAlpha_8 != caps->supportedReadPixelsColorType(kAlpha_8_GrPixelConfig,
+                                                                    GrColorType::kAlpha_8)) {
+        planeConfig = kRGBA_8888_GrPixelConfig;
+        planeCT = kRGBA_8888_SkColorType;
+    }
+
+    float rows[3][20];
+    yuv_alpha_rows(yuvColorSpace, rows);
+    const int uvW = (dstW + 1) / 2;
+    const int uvH = (dstH + 1) / 2;
+    sk_sp<GrRenderTargetContext> planeRTCs[3];
+    SkImageInfo planeInfos[3];
+    for (int i = 0; i < 3; ++i) {
+        const int w = i ? uvW : dstW;
+        const int h = i ? uvH : dstH;
+        planeInfos[i] = SkImageInfo::MakeA8(w, h);
+        planeRTCs[i] = fContext->contextPriv().makeDeferredRenderTargetContext(
+                caps->getBackendFormatFromColorType(planeCT), SkBackingFit::kExact, w, h,
+                planeConfig, nullptr, 1, GrMipMapped::kNo, kTopLeft_GrSurfaceOrigin);
+        if (!planeRTCs[i]) {
+            callback(context, nullptr, nullptr);
+            return;
+        }
+        auto fp = SkColorFilter::MakeMatrixFilterRowMajor255(rows[i])->asFragmentProcessor(
+                fContext, planeRTCs[i]->colorSpaceInfo());
+        if (!fp) {
+            callback(context, nullptr, nullptr);
+            return;
+        }
+        // U and V average each 2x2 block of Y's pixels.
+        GrPaint paint;
+        paint.addColorTextureProcessor(rgbaProxy, SkMatrix::I(),
+                                       i ? GrSamplerState::ClampBilerp()
+                                         : GrSamplerState::ClampNearest());
+        paint.addColorFragmentProcessor(std::move(fp));
+        paint.setPorterDuffXPFactory(SkBlendMode::kSrc);
+        planeRTCs[i]->fillRectToRect(GrNoClip(), std::move(paint), GrAA::kNo, SkMatrix::I(),
+                                     SkRect::MakeWH(w, h), SkRect::MakeWH(dstW, dstH));
+    }
+
+    if (can_transfer(fContext)) {
+        GrDrawingManager::AsyncRead read;
+        read.fCallbackYUV420 = callback;
+        read.fContext = context;
+        bool transferred = true;
+        for (int i = 0; transferred && i < 3; ++i) {
+            read.fPlanes.push_back();
+            transferred = transfer_to_buffer(fContext, planeRTCs[i].get(),
+                                             SkIRect::MakeSize(planeInfos[i].dimensions()),
+                                             planeInfos[i], &read.fPlanes.back());
+        }
+        if (transferred) {
+            add_async_read(fContext, this->drawingManager(), std::move(read));
+            return;
+        }
+    }
+
+    SkAutoPixmapStorage pms[3];
+    const void* data[3];
+    size_t rowBytes[3];
+    for (int i = 0; i < 3; ++i) {
+        if (!pms[i].tryAlloc(planeInfos[i]) ||
+            !planeRTCs[i]->readPixels(planeInfos[i], pms[i].writable_addr(), pms[i].rowBytes(),
+                                      0, 0)) {
+            callback(context, nullptr, nullptr);
+            return;
+        }
+        data[i] = pms[i].addr();
+        rowBytes[i] = pms[i].rowBytes();
+    }
+    callback(context, data, rowBytes);
+}
+
 void GrRenderTargetContext::insertEventMarker(const SkString& str) {
     std::unique_ptr<GrOp> op(GrDebugMarkerOp::Make(fContext, fRenderTargetProxy.get(), str));
     this->getRTOpList()->addOp(std::move(op), *this->caps());
@@ -1785,7 +2142,8 @@ static void op_bounds(SkRect* bounds, const GrOp* op) {
 }
 
 void GrRenderTargetContext::addDrawOp(const GrClip& clip, std::unique_ptr<GrDrawOp> op,
-                                      const std::function<WillAddOpFn>& willAddFn) {
+                                      const std::function<WillAddOpFn>& willAddFn,
+                                      const SkRect* opaqueRect) {
     ASSERT_SINGLE_OWNER
     if (this->drawingManager()->wasAbandoned()) {
         fContext->contextPriv().opMemoryPool()->release(std::move(op));
@@ -1827,7 +2185,7 @@ void GrRenderTargetContext::addDrawOp(const GrClip& clip, std::unique_ptr<GrDraw
     if (willAddFn) {
         willAddFn(op.get(), opList->uniqueID());
     }
-    opList->addOp(std::move(op), *this->caps(), std::move(appliedClip), dstProxy);
+    opList->addOp(std::move(op), *this->caps(), std::move(appliedClip), dstProxy, opaqueRect);
 }
 
 bool GrRenderTargetContext::setupDstProxy(GrRenderTargetProxy* rtProxy, const GrClip& clip,
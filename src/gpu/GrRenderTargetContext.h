@@ -18,6 +18,7 @@
 #include "SkCanvas.h"
 #include "SkDrawable.h"
 #include "SkRefCnt.h"
+#include "SkSurface.h"
 #include "SkSurfaceProps.h"
 #include "text/GrTextTarget.h"
 
@@ -156,10 +157,12 @@ public:
         SkRect fDstRect;
         float fAlpha;
         GrQuadAAFlags fAAFlags;
+        const SkMatrix* fPreViewMatrix = nullptr;  // applied to fDstRect before the view matrix
     };
     /**
      * Draws a set of textures with a shared filter, color, view matrix, color xform, and
      * texture color xform. The textures must all have the same GrTextureType and GrConfig.
+     * Consecutive entries with the same proxy share a texture binding.
      */
     void drawTextureSet(const GrClip&, const TextureSetEntry[], int cnt, GrSamplerState::Filter,
                         const SkMatrix& viewMatrix, sk_sp<GrColorSpaceXform> texXform);
@@ -367,6 +370,19 @@ public:
      */
     bool waitOnSemaphores(int numSemaphores, const GrBackendSemaphore* waitSemaphores);
 
+    /**
+     * Implement SkSurface's async readbacks. The pixels are copied into transfer buffers and the
+     * callback is called once a fence after the copies has signaled. Backends that can't transfer
+     * read synchronously and call the callback before returning.
+     */
+    void asyncRescaleAndReadPixels(const SkImageInfo& info, const SkIRect& srcRect,
+                                   SkFilterQuality, SkSurface::ReadPixelsCallback,
+                                   SkSurface::ReadPixelsContext);
+    void asyncRescaleAndReadPixelsYUV420(SkYUVColorSpace, sk_sp<SkColorSpace> dstColorSpace,
+                                         const SkIRect& srcRect, int dstW, int dstH,
+                                         SkFilterQuality, SkSurface::ReadPixelsCallbackYUV420,
+                                         SkSurface::ReadPixelsContext);
+
     void insertEventMarker(const SkString&);
 
     GrFSAAType fsaaType() const { return fRenderTargetProxy->fsaaType(); }
@@ -423,6 +439,11 @@ protected:
 private:
     class TextTarget;
 
+    // Draws srcRect of this into a new top-left render target context the size, color type and
+    // color space of 'info', in steps of at most halving for medium and high quality.
+    sk_sp<GrRenderTargetContext> rescale(const SkImageInfo& info, const SkIRect& srcRect,
+                                         SkFilterQuality);
+
     inline GrAAType chooseAAType(GrAA aa, GrAllowMixedSamples allowMixedSamples) {
         return GrChooseAAType(aa, this->fsaaType(), allowMixedSamples, *this->caps());
     }
@@ -445,6 +466,7 @@ private:
     friend class GrTessellatingPathRenderer;         // for access to add[Mesh]DrawOp
     friend class GrCCPerFlushResources;              // for access to addDrawOp
     friend class GrCoverageCountingPathRenderer;     // for access to addDrawOp
+    friend class GrSkcPathRenderer;                  // for access to addDrawOp
     // for a unit test
     friend void test_draw_op(GrContext*,
                              GrRenderTargetContext*,
@@ -478,8 +500,11 @@ private:
     // op list. Before adding the op to an op list the WillAddOpFn is called. Note that it
     // will not be called in the event that the op is discarded. Moreover, the op may merge into
     // another op after the function is called (either before addDrawOp returns or some time later).
+    // If 'opaqueRect' is given, the op replaces every pixel inside it (in device space), which lets
+    // the op list drop earlier ops that it hides.
     void addDrawOp(const GrClip&, std::unique_ptr<GrDrawOp>,
-                   const std::function<WillAddOpFn>& = std::function<WillAddOpFn>());
+                   const std::function<WillAddOpFn>& = std::function<WillAddOpFn>(),
+                   const SkRect* opaqueRect = nullptr);
 
     // Makes a copy of the proxy if it is necessary for the draw and places the texture that should
     // be used by GrXferProcessor to access the destination color in 'result'. If the return
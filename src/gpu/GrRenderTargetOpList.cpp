@@ -15,6 +15,8 @@
 #include "GrRenderTargetContext.h"
 #include "GrResourceAllocator.h"
 #include "SkRectPriv.h"
+#include "SkTDArray.h"
+#include "SkTHash.h"
 #include "SkTraceEvent.h"
 #include "ops/GrClearOp.h"
 #include "ops/GrCopySurfaceOp.h"
@@ -23,7 +25,9 @@
 
 // Experimentally we have found that most combining occurs within the first 10 comparisons.
 static const int kMaxOpMergeDistance = 10;
-static const int kMaxOpChainDistance = 10;
+// recordOp() and forwardCombine() only visit chains holding the same type of op, however far away
+// they are. This bounds the number of those that are tried before giving up.
+static const int kMaxOpChainCandidates = 32;
 
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -331,6 +335,134 @@ inline void GrRenderTargetOpList::OpChain::validate() const {
 
 ////////////////////////////////////////////////////////////////////////////////
 
+// A coarse grid over the render target. Each cell holds the sorted indices of the chains whose
+// bounds touch it, so overlap queries only look at chains near the op. Bounds outside the target
+// are clamped to the edge cells. Chains of the same op type are linked in order so candidates for
+// combining can be visited without touching the chains in between.
+class GrRenderTargetOpList::OpChainIndex {
+public:
+    OpChainIndex(int width, int height)
+            : fCols(SkTPin(width / kMinCellSize, 1, kMaxGridSize))
+            , fRows(SkTPin(height / kMinCellSize, 1, kMaxGridSize))
+            , fInvCellWidth(fCols / SkTMax(1.f, (float)width))
+            , fInvCellHeight(fRows / SkTMax(1.f, (float)height))
+            , fCells(fCols * fRows) {}
+
+    // Adds a chain, which must be the newest one.
+    void addChain(int index, uint32_t classID, const SkRect& bounds) {
+        SkASSERT(index == fPrevWithSameClass.count());
+        const int* last = fLastWithClass.find(classID);
+        *fPrevWithSameClass.append() = last ? *last : -1;
+        *fNextWithSameClass.append() = -1;
+        if (last) {
+            fNextWithSameClass[*last] = index;
+        }
+        fLastWithClass.set(classID, index);
+        this->addBounds(index, bounds);
+    }
+
+    // Must be called whenever the bounds of a chain grow, with the bounds that were added.
+    void addBounds(int index, const SkRect& bounds) {
+        SkIRect cells = this->cellRange(bounds);
+        for (int y = cells.fTop; y <= cells.fBottom; ++y) {
+            for (int x = cells.fLeft; x <= cells.fRight; ++x) {
+                SkTDArray<int>& cell = fCells[y * fCols + x];
+                int i = cell.count();
+                while (i > 0 && cell[i - 1] > index) {
+                    --i;
+                }
+                if (i == 0 || cell[i - 1] != index) {
+                    cell.insert(i, 1, &index);
+                }
+            }
+        }
+    }
+
+    // Returns the index of the last chain before 'end' whose bounds overlap 'bounds', or -1.
+    int lastOverlapping(const SkRect& bounds, int end, const OpChainArray& chains) const {
+        int result = -1;
+        SkIRect cells = this->cellRange(bounds);
+        for (int y = cells.fTop; y <= cells.fBottom; ++y) {
+            for (int x = cells.fLeft; x <= cells.fRight; ++x) {
+                const SkTDArray<int>& cell = fCells[y * fCols + x];
+                for (int i = cell.count() - 1; i >= 0 && cell[i] > result; --i) {
+                    if (cell[i] < end && chains[cell[i]].head() &&
+                        !can_reorder(chains[cell[i]].bounds(), bounds)) {
+                        result = cell[i];
+                        break;
+                    }
+                }
+            }
+        }
+        return result;
+    }
+
+    // Returns the index of the first chain after 'begin' whose bounds overlap 'bounds', or the
+    // number of chains.
+    int firstOverlapping(const SkRect& bounds, int begin, const OpChainArray& chains) const {
+        int result = chains.count();
+        SkIRect cells = this->cellRange(bounds);
+        for (int y = cells.fTop; y <= cells.fBottom; ++y) {
+            for (int x = cells.fLeft; x <= cells.fRight; ++x) {
+                const SkTDArray<int>& cell = fCells[y * fCols + x];
+                const int* i = std::upper_bound(cell.begin(), cell.end(), begin);
+                for (; i != cell.end() && *i < result; ++i) {
+                    if (chains[*i].head() && !can_reorder(chains[*i].bounds(), bounds)) {
+                        result = *i;
+                        break;
+                    }
+                }
+            }
+        }
+        return result;
+    }
+
+    // Calls fn with the index of every chain whose bounds might touch 'bounds'. A chain may be
+    // visited more than once.
+    template <typename Fn> void forEachNear(const SkRect& bounds, Fn&& fn) const {
+        SkIRect cells = this->cellRange(bounds);
+        for (int y = cells.fTop; y <= cells.fBottom; ++y) {
+            for (int x = cells.fLeft; x <= cells.fRight; ++x) {
+                for (int index : fCells[y * fCols + x]) {
+                    fn(index);
+                }
+            }
+        }
+    }
+
+    int lastWithClass(uint32_t classID) const {
+        const int* last = fLastWithClass.find(classID);
+        return last ? *last : -1;
+    }
+    int prevWithSameClass(int index) const { return fPrevWithSameClass[index]; }
+    int nextWithSameClass(int index) const { return fNextWithSameClass[index]; }
+
+private:
+    static constexpr int kMinCellSize = 64;
+    static constexpr int kMaxGridSize = 16;
+
+    SkIRect cellRange(const SkRect& bounds) const {
+        auto toCell = [](float v, float invCellSize, int count) {
+            return (int)SkTPin(v * invCellSize, 0.f, (float)(count - 1));
+        };
+        return SkIRect::MakeLTRB(toCell(bounds.fLeft, fInvCellWidth, fCols),
+                                 toCell(bounds.fTop, fInvCellHeight, fRows),
+                                 toCell(bounds.fRight, fInvCellWidth, fCols),
+                                 toCell(bounds.fBottom, fInvCellHeight, fRows));
+    }
+
+    const int                 fCols;
+    const int                 fRows;
+    const float               fInvCellWidth;
+    const float               fInvCellHeight;
+    SkAutoTArray<SkTDArray<int>> fCells;
+    SkTDArray<int>            fPrevWithSameClass;
+    SkTDArray<int>            fNextWithSameClass;
+    SkTHashMap<uint32_t, int> fLastWithClass;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
 GrRenderTargetOpList::GrRenderTargetOpList(GrResourceProvider* resourceProvider,
                                            sk_sp<GrOpMemoryPool> opMemoryPool,
                                            GrRenderTargetProxy* proxy,
@@ -345,6 +477,7 @@ void GrRenderTargetOpList::deleteOps() {
         chain.deleteOps(fOpMemoryPool.get());
     }
     fOpChains.reset();
+    fOpChainIndex.reset();
 }
 
 GrRenderTargetOpList::~GrRenderTargetOpList() {
@@ -425,14 +558,12 @@ static GrGpuRTCommandBuffer* create_command_buffer(GrGpu* gpu,
         loadClearColor
     };
 
-    // TODO:
-    // We would like to (at this level) only ever clear & discard. We would need
-    // to stop splitting up higher level opLists for copyOps to achieve that.
-    // Note: we would still need SB loads and stores but they would happen at a
-    // lower level (inside the VK command buffer).
+    // Every opList that uses the stencil buffer clears it first, and stencil clips are only
+    // reused within an opList, so the stencil values never need to be loaded or stored. Backends
+    // that split an opList into several render passes still keep them between those passes.
     const GrGpuRTCommandBuffer::StencilLoadAndStoreInfo stencilLoadAndStoreInfo {
-        stencilLoadOp,
-        GrStoreOp::kStore,
+        GrLoadOp::kClear == stencilLoadOp ? GrLoadOp::kClear : GrLoadOp::kDiscard,
+        GrStoreOp::kDiscard,
     };
 
     return gpu->getCommandBuffer(rt, origin, bounds, kColorLoadStoreInfo, stencilLoadAndStoreInfo);
@@ -456,8 +587,6 @@ bool GrRenderTargetOpList::onExecute(GrOpFlushState* flushState) {
     SkASSERT(fTarget.get()->peekRenderTarget());
     TRACE_EVENT0("skia", TRACE_FUNC);
 
-    // TODO: at the very least, we want the stencil store op to always be discard (at this
-    // level). In Vulkan, sub-command buffers would still need to load & store the stencil buffer.
     GrGpuRTCommandBuffer* commandBuffer = create_command_buffer(
                                                     flushState->gpu(),
                                                     fTarget.get()->peekRenderTarget(),
@@ -485,9 +614,19 @@ bool GrRenderTargetOpList::onExecute(GrOpFlushState* flushState) {
             chain.dstProxy()
         };
 
+        GrTimerQuery timer = 0;
+        if (fAuditTrail && fAuditTrail->isEnabled() && fAuditTrail->isGpuTimingEnabled()) {
+            timer = commandBuffer->beginTimerQuery();
+        }
+
         flushState->setOpArgs(&opArgs);
         chain.head()->execute(flushState, chain.bounds());
         flushState->setOpArgs(nullptr);
+
+        if (timer) {
+            commandBuffer->endTimerQuery(timer);
+            fAuditTrail->opChainTimed(chain.head(), flushState->gpu(), timer);
+        }
     }
 
     commandBuffer->end();
@@ -624,10 +763,11 @@ void GrRenderTargetOpList::recordOp(std::unique_ptr<GrOp> op,
         return;
     }
 
-    // Check if there is an op we can combine with by linearly searching back until we either
-    // 1) check every op
-    // 2) intersect with something
-    // 3) find a 'blocker'
+    // Check if there is an op we can combine with by searching back through the chains of the
+    // same op type until we either
+    // 1) check every such chain
+    // 2) pass the last chain we intersect with
+    // 3) reach kMaxOpChainCandidates
     GR_AUDIT_TRAIL_ADD_OP(fAuditTrail, op.get(), fTarget.get()->uniqueID());
     GrOP_INFO("opList: %d Recording (%s, opID: %u)\n"
               "\tBounds [L: %.2f, T: %.2f R: %.2f B: %.2f]\n",
@@ -638,27 +778,33 @@ void GrRenderTargetOpList::recordOp(std::unique_ptr<GrOp> op,
                op->bounds().fRight, op->bounds().fBottom);
     GrOP_INFO(SkTabString(op->dumpInfo(), 1).c_str());
     GrOP_INFO("\tOutcome:\n");
-    int maxCandidates = SkTMin(kMaxOpChainDistance, fOpChains.count());
-    if (maxCandidates) {
-        int i = 0;
-        while (true) {
-            OpChain& candidate = fOpChains.fromBack(i);
+    if (!fOpChainIndex) {
+        fOpChainIndex.reset(new OpChainIndex(fTarget.get()->width(), fTarget.get()->height()));
+    }
+    const SkRect opBounds = op->bounds();
+    const uint32_t classID = op->classID();
+    if (fOpChains.count()) {
+        // We can't move the op before a chain it intersects, but may still combine with that chain.
+        int firstCandidate = fOpChainIndex->lastOverlapping(opBounds, fOpChains.count(), fOpChains);
+        int numCandidates = 0;
+        for (int i = fOpChainIndex->lastWithClass(classID); i >= 0 && i >= firstCandidate;
+             i = fOpChainIndex->prevWithSameClass(i)) {
+            OpChain& candidate = fOpChains[i];
+            if (!candidate.head()) {
+                continue;  // Occluded.
+            }
             op = candidate.appendOp(std::move(op), dstProxy, clip, caps, fOpMemoryPool.get(),
                                     fAuditTrail);
             if (!op) {
+                fOpChainIndex->addBounds(i, opBounds);
                 return;
             }
-            // Stop going backwards if we would cause a painter's order violation.
-            if (!can_reorder(candidate.bounds(), op->bounds())) {
-                GrOP_INFO("\t\tBackward: Intersects with chain (%s, head opID: %u)\n",
-                          candidate.head()->name(), candidate.head()->uniqueID());
-                break;
-            }
-            if (++i == maxCandidates) {
-                GrOP_INFO("\t\tBackward: Reached max lookback or beginning of op array %d\n", i);
+            if (++numCandidates == kMaxOpChainCandidates) {
+                GrOP_INFO("\t\tBackward: Reached max candidates %d\n", numCandidates);
                 break;
             }
         }
+        GrOP_INFO("\t\tBackward: No chain to combine with before chain %d\n", firstCandidate);
     } else {
         GrOP_INFO("\t\tBackward: FirstOp\n");
     }
@@ -667,6 +813,7 @@ void GrRenderTargetOpList::recordOp(std::unique_ptr<GrOp> op,
         SkDEBUGCODE(fNumClips++;)
     }
     fOpChains.emplace_back(std::move(op), clip, dstProxy);
+    fOpChainIndex->addChain(fOpChains.count() - 1, classID, opBounds);
 }
 
 void GrRenderTargetOpList::forwardCombine(const GrCaps& caps) {
@@ -675,28 +822,55 @@ void GrRenderTargetOpList::forwardCombine(const GrCaps& caps) {
 
     for (int i = 0; i < fOpChains.count() - 1; ++i) {
         OpChain& chain = fOpChains[i];
-        int maxCandidateIdx = SkTMin(i + kMaxOpChainDistance, fOpChains.count() - 1);
-        int j = i + 1;
-        while (true) {
+        if (!chain.head()) {
+            continue;  // Occluded.
+        }
+        // We can't move the chain past a chain it intersects, but may still combine with that one.
+        int lastCandidate = fOpChainIndex->firstOverlapping(chain.bounds(), i, fOpChains);
+        int numCandidates = 0;
+        for (int j = fOpChainIndex->nextWithSameClass(i); j >= 0 && j <= lastCandidate;
+             j = fOpChainIndex->nextWithSameClass(j)) {
             OpChain& candidate = fOpChains[j];
-            if (candidate.prependChain(&chain, caps, fOpMemoryPool.get(), fAuditTrail)) {
-                break;
+            if (!candidate.head()) {
+                continue;
             }
-            // Stop traversing if we would cause a painter's order violation.
-            if (!can_reorder(chain.bounds(), candidate.bounds())) {
-                GrOP_INFO(
-                        "\t\t%d: chain (%s head opID: %u) -> "
-                        "Intersects with chain (%s, head opID: %u)\n",
-                        i, chain.head()->name(), chain.head()->uniqueID(), candidate.head()->name(),
-                        candidate.head()->uniqueID());
+            if (candidate.prependChain(&chain, caps, fOpMemoryPool.get(), fAuditTrail)) {
+                fOpChainIndex->addBounds(j, chain.bounds());
                 break;
             }
-            if (++j > maxCandidateIdx) {
-                GrOP_INFO("\t\t%d: chain (%s opID: %u) -> Reached max lookahead or end of array\n",
+            if (++numCandidates == kMaxOpChainCandidates) {
+                GrOP_INFO("\t\t%d: chain (%s opID: %u) -> Reached max candidates\n",
                           i, chain.head()->name(), chain.head()->uniqueID());
                 break;
             }
         }
     }
+    // No more ops can be recorded.
+    fOpChainIndex.reset();
 }
 
+void GrRenderTargetOpList::occlude(const SkRect& opaqueRect) {
+    // As in fullClear(), hidden ops may still write the stencil buffer for later ops to test.
+    if (fTarget.get()->asRenderTargetProxy()->needsStencil()) {
+        return;
+    }
+    if (opaqueRect.contains(fTarget.get()->getBoundsRect())) {
+        // Nothing drawn before shows through, so the target needn't be loaded or cleared either.
+        this->deleteOps();
+        fColorLoadOp = GrLoadOp::kDiscard;
+        fStencilLoadOp = GrLoadOp::kDiscard;
+        return;
+    }
+    if (!fOpChainIndex) {
+        return;
+    }
+    // The chains stay in place, empty, so that the index's chain numbers remain valid.
+    fOpChainIndex->forEachNear(opaqueRect, [&](int i) {
+        OpChain& chain = fOpChains[i];
+        if (chain.head() && opaqueRect.contains(chain.bounds())) {
+            GrOP_INFO("opList: %d Occluded chain %d (%s opID: %u)\n", this->uniqueID(), i,
+                      chain.head()->name(), chain.head()->uniqueID());
+            chain.deleteOps(fOpMemoryPool.get());
+        }
+    });
+}
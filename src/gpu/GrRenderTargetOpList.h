@@ -49,6 +49,16 @@ public:
 
     bool isEmpty() const { return fOpChains.empty(); }
 
+    // Number of op chains that still hold ops. Chains are emptied when they are combined into a
+    // later chain.
+    int numOpChains() const {
+        int count = 0;
+        for (const OpChain& chain : fOpChains) {
+            count += SkToBool(chain.head());
+        }
+        return count;
+    }
+
     /**
      * Empties the draw buffer of any queued up draws.
      */
@@ -71,8 +81,12 @@ public:
         this->recordOp(std::move(op), caps);
     }
 
+    /**
+     * If 'opaqueRect' is given, the op replaces every pixel inside it (in device space), so any
+     * earlier ops that only draw inside it are dropped.
+     */
     void addOp(std::unique_ptr<GrOp> op, const GrCaps& caps, GrAppliedClip&& clip,
-               const DstProxy& dstProxy) {
+               const DstProxy& dstProxy, const SkRect* opaqueRect = nullptr) {
         auto addDependency = [ &caps, this ] (GrSurfaceProxy* p) {
             this->addDependency(p, caps);
         };
@@ -82,6 +96,9 @@ public:
         if (dstProxy.proxy()) {
             addDependency(dstProxy.proxy());
         }
+        if (opaqueRect) {
+            this->occlude(*opaqueRect);
+        }
 
         this->recordOp(std::move(op), caps, clip.doesClip() ? &clip : nullptr, &dstProxy);
     }
@@ -191,6 +208,13 @@ private:
         SkRect fBounds;
     };
 
+    using OpChainArray = SkSTArray<25, OpChain, true>;
+
+    // Bins op chains by their bounds so that recordOp() and forwardCombine() can find the nearest
+    // chain an op can't be reordered across, and the chains of the same op type before it, without
+    // visiting every chain in between. Only exists while ops are being recorded.
+    class OpChainIndex;
+
     void purgeOpsWithUninstantiatedProxies() override;
 
     void gatherProxyIntervals(GrResourceAllocator*) const override;
@@ -200,12 +224,16 @@ private:
 
     void forwardCombine(const GrCaps&);
 
+    // Drops the ops that an op replacing every pixel of 'opaqueRect' would hide.
+    void occlude(const SkRect& opaqueRect);
+
     uint32_t                       fLastClipStackGenID;
     SkIRect                        fLastDevClipBounds;
     int                            fLastClipNumAnalyticFPs;
 
     // For ops/opList we have mean: 5 stdDev: 28
-    SkSTArray<25, OpChain, true> fOpChains;
+    OpChainArray                   fOpChains;
+    std::unique_ptr<OpChainIndex>  fOpChainIndex;
 
     // MDB TODO: 4096 for the first allocation of the clip space will be huge overkill.
     // Gather statistics to determine the correct size.
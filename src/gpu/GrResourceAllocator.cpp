@@ -15,6 +15,7 @@
 #include "GrSurfacePriv.h"
 #include "GrSurfaceProxy.h"
 #include "GrSurfaceProxyPriv.h"
+#include "GrTexturePriv.h"
 #include "GrTextureProxy.h"
 #include "GrUninstantiateProxyTracker.h"
 
@@ -224,6 +225,22 @@ void GrResourceAllocator::recycleSurface(sk_sp<GrSurface> surface) {
     fFreePool.insert(key, surface.release());
 }
 
+// Removes a surface with the given scratch key that 'proxy' can use from the free pool.
+sk_sp<GrSurface> GrResourceAllocator::findFreeSurface(const GrScratchKey& key,
+                                                      const GrSurfaceProxy* proxy) {
+    auto filter = [&] (const GrSurface* s) {
+        return !proxy->priv().requiresNoPendingIO() || !s->surfacePriv().hasPendingIO();
+    };
+    sk_sp<GrSurface> surface(fFreePool.findAndRemove(key, filter));
+    if (surface && SkBudgeted::kYes == proxy->isBudgeted() &&
+        SkBudgeted::kNo == surface->resourcePriv().isBudgeted()) {
+        // This gets the job done but isn't quite correct. It would be better to try to
+        // match budgeted proxies w/ budgeted surface and unbudgeted w/ unbudgeted.
+        surface->resourcePriv().makeBudgeted();
+    }
+    return surface;
+}
+
 // First try to reuse one of the recently allocated/used GrSurfaces in the free pool.
 // If we can't find a useable one, create a new one.
 sk_sp<GrSurface> GrResourceAllocator::findSurfaceFor(const GrSurfaceProxy* proxy,
@@ -248,18 +265,30 @@ sk_sp<GrSurface> GrResourceAllocator::findSurfaceFor(const GrSurfaceProxy* proxy
 
     proxy->priv().computeScratchKey(&key);
 
-    auto filter = [&] (const GrSurface* s) {
-        return !proxy->priv().requiresNoPendingIO() || !s->surfacePriv().hasPendingIO();
-    };
-    sk_sp<GrSurface> surface(fFreePool.findAndRemove(key, filter));
-    if (surface) {
-        if (SkBudgeted::kYes == proxy->isBudgeted() &&
-            SkBudgeted::kNo == surface->resourcePriv().isBudgeted()) {
-            // This gets the job done but isn't quite correct. It would be better to try to
-            // match budgeted proxies w/ budgeted surface and unbudgeted w/ unbudgeted.
-            surface->resourcePriv().makeBudgeted();
+    sk_sp<GrSurface> surface = this->findFreeSurface(key, proxy);
+
+    // An approx-fit proxy only promises its contents within its own width and height, so it can
+    // also be backed by a surface one size bucket larger that is free for the rest of its interval.
+    if (!surface && !proxy->priv().isExact() && fResourceProvider->reuseLargerTransientSurfaces()) {
+        const GrRenderTargetProxy* rtProxy = proxy->asRenderTargetProxy();
+        const GrTextureProxy* texProxy = proxy->asTextureProxy();
+        int sampleCount = rtProxy ? rtProxy->numStencilSamples() : 1;
+        GrMipMapped mipMapped = texProxy ? texProxy->mipMapped() : GrMipMapped::kNo;
+        int width = proxy->worstCaseWidth();
+        int height = proxy->worstCaseHeight();
+        const SkISize kLargerSizes[] = {
+            { 2 * width, height }, { width, 2 * height }, { 2 * width, 2 * height }
+        };
+        for (int i = 0; !surface && i < (int)SK_ARRAY_COUNT(kLargerSizes); ++i) {
+            GrScratchKey largerKey;
+            GrTexturePriv::ComputeScratchKey(proxy->config(), kLargerSizes[i].width(),
+                                             kLargerSizes[i].height(), SkToBool(rtProxy),
+                                             sampleCount, mipMapped, &largerKey);
+            surface = this->findFreeSurface(largerKey, proxy);
         }
+    }
 
+    if (surface) {
         if (!GrSurfaceProxyPriv::AttachStencilIfNeeded(fResourceProvider, surface.get(),
                                                        needsStencil)) {
             return nullptr;
@@ -281,6 +310,8 @@ void GrResourceAllocator::expire(unsigned int curIndex) {
 
         if (temp->wasAssignedSurface()) {
             sk_sp<GrSurface> surface = temp->detachSurface();
+            SkASSERT(fTransientBytes >= surface->gpuMemorySize());
+            fTransientBytes -= surface->gpuMemorySize();
 
             // If the proxy has an actual live ref on it that means someone wants to retain its
             // contents. In that case we cannot recycle it (until the external holder lets
@@ -387,6 +418,8 @@ bool GrResourceAllocator::assign(int* startIndex, int* stopIndex, AssignError* o
                  cur->proxy()->uniqueID().asUInt());
 #endif
 
+            fTransientBytes += surface->gpuMemorySize();
+            fPeakTransientBytes = SkTMax(fPeakTransientBytes, fTransientBytes);
             cur->assign(std::move(surface));
         } else {
             SkASSERT(!cur->proxy()->isInstantiated());
@@ -78,6 +78,10 @@ public:
 
     void markEndOfOpList(int opListIndex);
 
+    // The most bytes of GrSurfaces that assign() gave to proxies (rather than finding them already
+    // instantiated) that were in use at once. This covers all the calls to assign() so far.
+    size_t peakTransientBytes() const { return fPeakTransientBytes; }
+
 #if GR_ALLOCATION_SPEW
     void dumpIntervals();
 #endif
@@ -91,6 +95,7 @@ private:
     // These two methods wrap the interactions with the free pool
     void recycleSurface(sk_sp<GrSurface> surface);
     sk_sp<GrSurface> findSurfaceFor(const GrSurfaceProxy* proxy, bool needsStencil);
+    sk_sp<GrSurface> findFreeSurface(const GrScratchKey&, const GrSurfaceProxy*);
 
     struct FreePoolTraits {
         static const GrScratchKey& GetKey(const GrSurface& s) {
@@ -224,6 +229,9 @@ private:
     SkTArray<unsigned int>       fEndOfOpListOpIndices;
     int                          fCurOpListIndex = 0;
 
+    size_t                       fTransientBytes = 0;      // Bytes assigned to active intervals
+    size_t                       fPeakTransientBytes = 0;
+
     SkDEBUGCODE(bool             fAssigned = false;)
 
     char                         fStorage[kInitialArenaSize];
@@ -17,6 +17,8 @@
 #include "SkMessageBus.h"
 #include "SkOpts.h"
 #include "SkRandom.h"
+#include "SkString.h"
+#include "SkTraceMemoryDump.h"
 #include "SkTSort.h"
 #include "SkTo.h"
 #include <atomic>
@@ -74,6 +76,9 @@ GrResourceCache::GrResourceCache(const GrCaps* caps, GrSingleOwner* singleOwner,
         , fTimestamp(0)
         , fMaxCount(kDefaultMaxCount)
         , fMaxBytes(kDefaultMaxSize)
+        , fMaxUnusedFlushes(0)
+        , fMaxUnusedTime(GrStdSteadyClock::duration::zero())
+        , fFlushCnt(0)
 #if GR_CACHE_STATS
         , fHighWaterCount(0)
         , fHighWaterBytes(0)
@@ -104,6 +109,12 @@ void GrResourceCache::setLimits(int count, size_t bytes) {
     this->purgeAsNeeded();
 }
 
+void GrResourceCache::setMaxUnusedLimits(int flushes, GrStdSteadyClock::duration time) {
+    SkASSERT(flushes >= 0 && time >= GrStdSteadyClock::duration::zero());
+    fMaxUnusedFlushes = flushes;
+    fMaxUnusedTime = time;
+}
+
 void GrResourceCache::insertResource(GrGpuResource* resource) {
     ASSERT_SINGLE_OWNER
     SkASSERT(resource);
@@ -317,6 +328,16 @@ void GrResourceCache::removeUniqueKey(GrGpuResource* resource) {
         fScratchMap.insert(resource->resourcePriv().getScratchKey(), resource);
     }
 
+    // Without its key a purgeable resource is only good as scratch, so it goes back in the queue
+    // with that priority.
+    int index = *resource->cacheAccess().accessCacheIndex();
+    if (resource->isPurgeable() && index >= 0 && index < fPurgeableQueue.count() &&
+        fPurgeableQueue.at(index) == resource) {
+        fPurgeableQueue.remove(resource);
+        resource->cacheAccess().setPurgeablePriority();
+        fPurgeableQueue.insert(resource);
+    }
+
     this->validate();
 }
 
@@ -406,8 +427,9 @@ void GrResourceCache::notifyCntReachedZero(GrGpuResource* resource, uint32_t fla
 
     SkASSERT(resource->isPurgeable());
     this->removeFromNonpurgeableArray(resource);
+    resource->cacheAccess().setPurgeablePriority();
     fPurgeableQueue.insert(resource);
-    resource->cacheAccess().setTimeWhenResourceBecomePurgeable();
+    resource->cacheAccess().setTimeWhenResourceBecomePurgeable(fFlushCnt);
     fPurgeableBytes += resource->gpuMemorySize();
 
     bool hasUniqueKey = resource->getUniqueKey().isValid();
@@ -523,22 +545,48 @@ void GrResourceCache::purgeUnlockedResources(bool scratchResourcesOnly) {
     this->validate();
 }
 
-void GrResourceCache::purgeResourcesNotUsedSince(GrStdSteadyClock::time_point purgeTime) {
-    while (fPurgeableQueue.count()) {
-        const GrStdSteadyClock::time_point resourceTime =
-                fPurgeableQueue.peek()->cacheAccess().timeWhenResourceBecamePurgeable();
-        if (resourceTime >= purgeTime) {
-            // Resources were given both LRU timestamps and tagged with a frame number when
-            // they first became purgeable. The LRU timestamp won't change again until the
-            // resource is made non-purgeable again. So, at this point all the remaining
-            // resources in the timestamp-sorted queue will have a frame number >= to this
-            // one.
-            break;
-        }
-        GrGpuResource* resource = fPurgeableQueue.peek();
+template <typename Fn> void GrResourceCache::purgeResourcesIf(Fn&& shouldPurge) {
+    // The queue is ordered by purge priority before age, so every resource must be checked.
+    SkTDArray<GrGpuResource*> resourcesToPurge;
+    for (int i = 0; i < fPurgeableQueue.count(); i++) {
+        GrGpuResource* resource = fPurgeableQueue.at(i);
         SkASSERT(resource->isPurgeable());
-        resource->cacheAccess().release();
+        if (shouldPurge(resource)) {
+            *resourcesToPurge.append() = resource;
+        }
     }
+
+    // Releasing the resources reorders the queue, so this must be done as a separate pass.
+    for (int i = 0; i < resourcesToPurge.count(); i++) {
+        resourcesToPurge[i]->cacheAccess().release();
+    }
+
+    this->validate();
+}
+
+void GrResourceCache::purgeResourcesNotUsedSince(GrStdSteadyClock::time_point purgeTime) {
+    this->purgeResourcesIf([purgeTime](GrGpuResource* resource) {
+        return resource->cacheAccess().timeWhenResourceBecamePurgeable() < purgeTime;
+    });
+}
+
+void GrResourceCache::notifyFlushOccurred() {
+    ++fFlushCnt;
+    if (fMaxUnusedFlushes > 0 || fMaxUnusedTime > GrStdSteadyClock::duration::zero()) {
+        const uint32_t flushCnt = fFlushCnt;
+        const uint32_t maxUnusedFlushes = fMaxUnusedFlushes;
+        const bool checkTime = fMaxUnusedTime > GrStdSteadyClock::duration::zero();
+        const GrStdSteadyClock::time_point purgeTime = GrStdSteadyClock::now() - fMaxUnusedTime;
+        this->purgeResourcesIf([=](GrGpuResource* resource) {
+            // Unsigned subtraction keeps this right when the flush count wraps.
+            uint32_t unusedFlushes =
+                    flushCnt - resource->cacheAccess().flushCntWhenResourceBecamePurgeable();
+            return (maxUnusedFlushes > 0 && unusedFlushes >= maxUnusedFlushes) ||
+                   (checkTime &&
+                    resource->cacheAccess().timeWhenResourceBecamePurgeable() < purgeTime);
+        });
+    }
+    this->purgeAsNeeded();
 }
 
 void GrResourceCache::purgeUnlockedResources(size_t bytesToPurge, bool preferScratchResources) {
@@ -573,7 +621,7 @@ void GrResourceCache::purgeUnlockedResources(size_t bytesToPurge, bool preferScr
         this->validate();
     }
 
-    // Purge any remaining resources in LRU order
+    // Purge any remaining resources in purge priority, then LRU, order
     if (stillOverbudget) {
         const size_t cachedByteCount = fMaxBytes;
         fMaxBytes = tmpByteBudget;
@@ -654,6 +702,9 @@ uint32_t GrResourceCache::getNextTimestamp() {
                 *sortedPurgeableResources.append() = fPurgeableQueue.peek();
                 fPurgeableQueue.pop();
             }
+            // The queue orders by purge priority first, so that isn't yet timestamp order.
+            SkTQSort(sortedPurgeableResources.begin(), sortedPurgeableResources.end() - 1,
+                     CompareTimestamp);
 
             SkTQSort(fNonpurgeableResources.begin(), fNonpurgeableResources.end() - 1,
                      CompareTimestamp);
@@ -701,11 +752,33 @@ uint32_t GrResourceCache::getNextTimestamp() {
 }
 
 void GrResourceCache::dumpMemoryStatistics(SkTraceMemoryDump* traceMemoryDump) const {
+    size_t bytes[GrGpuResource::kPurgePriorityCount] = {};
+    size_t purgeableBytes[GrGpuResource::kPurgePriorityCount] = {};
+
     for (int i = 0; i < fNonpurgeableResources.count(); ++i) {
-        fNonpurgeableResources[i]->dumpMemoryStatistics(traceMemoryDump);
+        GrGpuResource* resource = fNonpurgeableResources[i];
+        resource->dumpMemoryStatistics(traceMemoryDump);
+        bytes[(int)resource->resourcePriv().purgePriority()] += resource->gpuMemorySize();
     }
     for (int i = 0; i < fPurgeableQueue.count(); ++i) {
-        fPurgeableQueue.at(i)->dumpMemoryStatistics(traceMemoryDump);
+        GrGpuResource* resource = fPurgeableQueue.at(i);
+        resource->dumpMemoryStatistics(traceMemoryDump);
+        int priority = (int)resource->cacheAccess().purgeablePriority();
+        bytes[priority] += resource->gpuMemorySize();
+        purgeableBytes[priority] += resource->gpuMemorySize();
+    }
+
+    // The totals aren't "size" values, which would count the resources' bytes twice.
+    static const char* kPriorityNames[] = { "scratch", "unique_key", "ccpr_cache", "glyph_atlas" };
+    static_assert(SK_ARRAY_COUNT(kPriorityNames) == GrGpuResource::kPurgePriorityCount, "");
+    for (int i = 0; i < GrGpuResource::kPurgePriorityCount; ++i) {
+        traceMemoryDump->dumpNumericValue("skia/gpu_resources/purge_priorities",
+                                          SkStringPrintf("%s_bytes", kPriorityNames[i]).c_str(),
+                                          "bytes", bytes[i]);
+        traceMemoryDump->dumpNumericValue(
+                "skia/gpu_resources/purge_priorities",
+                SkStringPrintf("%s_purgeable_bytes", kPriorityNames[i]).c_str(), "bytes",
+                purgeableBytes[i]);
     }
 }
 
@@ -73,6 +73,13 @@ public:
     /** Sets the cache limits in terms of number of resources and max gpu memory byte size. */
     void setLimits(int count, size_t bytes);
 
+    /**
+     * Sets how long purgeable resources may go unused before notifyFlushOccurred() purges them,
+     * even when the cache is under budget: a number of flushes, and a length of time. Zero
+     * disables either limit, and both are disabled by default.
+     */
+    void setMaxUnusedLimits(int flushes, GrStdSteadyClock::duration time);
+
     /**
      * Returns the number of resources.
      */
@@ -176,13 +183,19 @@ public:
     /** Purge all resources not used since the passed in time. */
     void purgeResourcesNotUsedSince(GrStdSteadyClock::time_point);
 
+    /**
+     * Called after each flush that executed work. Purges resources that have gone unused for
+     * longer than the limits set by setMaxUnusedLimits(), then purges as needed.
+     */
+    void notifyFlushOccurred();
+
     bool overBudget() const { return fBudgetedBytes > fMaxBytes || fBudgetedCount > fMaxCount; }
 
     /**
      * Purge unlocked resources from the cache until the the provided byte count has been reached
-     * or we have purged all unlocked resources. The default policy is to purge in LRU order, but
-     * can be overridden to prefer purging scratch resources (in LRU order) prior to purging other
-     * resource types.
+     * or we have purged all unlocked resources. The default policy is to purge in LRU order within
+     * each GrGpuResource::PurgePriority, lowest first, but can be overridden to prefer purging
+     * scratch resources (in LRU order) prior to purging other resource types.
      *
      * @param maxBytesToPurge the desired number of bytes to be purged.
      * @param preferScratchResources If true scratch resources will be purged prior to other
@@ -245,7 +258,10 @@ public:
     // This function is for unit testing and is only defined in test tools.
     void changeTimestamp(uint32_t newTimestamp);
 
-    // Enumerates all cached resources and dumps their details to traceMemoryDump.
+    // Enumerates all cached resources and dumps their details to traceMemoryDump, then the total
+    // and purgeable bytes of each GrGpuResource::PurgePriority, as values of
+    // "skia/gpu_resources/purge_priorities" named "<priority>_bytes" and
+    // "<priority>_purgeable_bytes", e.g. "scratch_bytes".
     void dumpMemoryStatistics(SkTraceMemoryDump* traceMemoryDump) const;
 
     void setProxyProvider(GrProxyProvider* proxyProvider) { fProxyProvider = proxyProvider; }
@@ -275,6 +291,9 @@ private:
 
     uint32_t getNextTimestamp();
 
+    // Releases the purgeable resources for which 'shouldPurge' returns true.
+    template <typename Fn> void purgeResourcesIf(Fn&& shouldPurge);
+
 #ifdef SK_DEBUG
     bool isInCache(const GrGpuResource* r) const;
     void validate() const;
@@ -307,19 +326,26 @@ private:
         return a->cacheAccess().timestamp() < b->cacheAccess().timestamp();
     }
 
+    static bool ComparePurgeOrder(GrGpuResource* const& a, GrGpuResource* const& b) {
+        auto priorityA = a->cacheAccess().purgeablePriority(),
+             priorityB = b->cacheAccess().purgeablePriority();
+        return priorityA != priorityB ? priorityA < priorityB : CompareTimestamp(a, b);
+    }
+
     static int* AccessResourceIndex(GrGpuResource* const& res) {
         return res->cacheAccess().accessCacheIndex();
     }
 
     typedef SkMessageBus<GrUniqueKeyInvalidatedMessage>::Inbox InvalidUniqueKeyInbox;
     typedef SkMessageBus<GrGpuResourceFreedMessage>::Inbox FreedGpuResourceInbox;
-    typedef SkTDPQueue<GrGpuResource*, CompareTimestamp, AccessResourceIndex> PurgeableQueue;
+    typedef SkTDPQueue<GrGpuResource*, ComparePurgeOrder, AccessResourceIndex> PurgeableQueue;
     typedef SkTDArray<GrGpuResource*> ResourceArray;
 
     GrProxyProvider*                    fProxyProvider;
     // Whenever a resource is added to the cache or the result of a cache lookup, fTimestamp is
     // assigned as the resource's timestamp and then incremented. fPurgeableQueue orders the
-    // purgeable resources by this value, and thus is used to purge resources in LRU order.
+    // purgeable resources of each purge priority by this value, and thus is used to purge
+    // resources in LRU order, the lowest priority first.
     uint32_t                            fTimestamp;
     PurgeableQueue                      fPurgeableQueue;
     ResourceArray                       fNonpurgeableResources;
@@ -333,6 +359,11 @@ private:
     int                                 fMaxCount;
     size_t                              fMaxBytes;
 
+    // How long purgeable resources may go unused, used in notifyFlushOccurred(). Zero is no limit.
+    int                                 fMaxUnusedFlushes;
+    GrStdSteadyClock::duration          fMaxUnusedTime;
+    uint32_t                            fFlushCnt;
+
 #if GR_CACHE_STATS
     int                                 fHighWaterCount;
     size_t                              fHighWaterBytes;
@@ -40,9 +40,11 @@ static const bool kDefaultExplicitlyAllocateGPUResources = true;
     SkDEBUGCODE(GrSingleOwner::AutoEnforce debug_SingleOwner(fSingleOwner);)
 
 GrResourceProvider::GrResourceProvider(GrGpu* gpu, GrResourceCache* cache, GrSingleOwner* owner,
-                                       GrContextOptions::Enable explicitlyAllocateGPUResources)
+                                       GrContextOptions::Enable explicitlyAllocateGPUResources,
+                                       bool reuseLargerTransientSurfaces)
         : fCache(cache)
         , fGpu(gpu)
+        , fReuseLargerTransientSurfaces(reuseLargerTransientSurfaces)
 #ifdef SK_DEBUG
         , fSingleOwner(owner)
 #endif
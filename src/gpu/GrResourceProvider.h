@@ -58,7 +58,8 @@ public:
     };
 
     GrResourceProvider(GrGpu*, GrResourceCache*, GrSingleOwner*,
-                       GrContextOptions::Enable explicitlyAllocateGPUResources);
+                       GrContextOptions::Enable explicitlyAllocateGPUResources,
+                       bool reuseLargerTransientSurfaces = false);
 
     /**
      * Finds a resource in the cache, based on the specified key. Prior to calling this, the caller
@@ -254,6 +255,11 @@ public:
 
     bool testingOnly_setExplicitlyAllocateGPUResources(bool newValue);
 
+    // Whether GrResourceAllocator may back approx-fit proxies with larger free surfaces.
+    bool reuseLargerTransientSurfaces() const { return fReuseLargerTransientSurfaces; }
+
+    bool testingOnly_setReuseLargerTransientSurfaces(bool newValue);
+
 private:
     sk_sp<GrGpuResource> findResourceByUniqueKey(const GrUniqueKey&);
 
@@ -294,6 +300,7 @@ private:
     sk_sp<const GrCaps> fCaps;
     GrUniqueKey         fQuadIndexBufferKey;
     bool                fExplicitlyAllocateGPUResources;
+    bool                fReuseLargerTransientSurfaces;
 
     // In debug builds we guard against improper thread handling
     SkDEBUGCODE(mutable GrSingleOwner* fSingleOwner;)
@@ -91,6 +91,20 @@ bool GrSWMaskHelper::init(const SkIRect& resultBounds) {
     return true;
 }
 
+void GrSWMaskHelper::initBand(const SkIRect& resultBounds, int bandTop, int bandBottom) {
+    SkASSERT(fPixels->width() == resultBounds.width());
+    SkASSERT(fPixels->height() == resultBounds.height());
+    SkASSERT(0 <= bandTop && bandTop < bandBottom && bandBottom <= resultBounds.height());
+    fTranslate = {-SkIntToScalar(resultBounds.fLeft), -SkIntToScalar(resultBounds.fTop)};
+    SkIRect band = SkIRect::MakeLTRB(0, bandTop, resultBounds.width(), bandBottom);
+
+    fPixels->erase(0, band);
+
+    fDraw.fDst      = *fPixels;
+    fRasterClip.setRect(band);
+    fDraw.fRC       = &fRasterClip;
+}
+
 sk_sp<GrTextureProxy> GrSWMaskHelper::toTextureProxy(GrContext* context, SkBackingFit fit) {
     SkImageInfo ii = SkImageInfo::MakeA8(fPixels->width(), fPixels->height());
     size_t rowBytes = fPixels->rowBytes();
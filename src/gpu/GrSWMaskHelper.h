@@ -44,6 +44,11 @@ public:
     // amount of work.
     bool init(const SkIRect& resultBounds);
 
+    // Like init(), but for pixels already allocated to the size of resultBounds, and only drawing
+    // (and clearing) their rows [bandTop, bandBottom). Helpers drawing disjoint bands of the same
+    // pixels may run on different threads.
+    void initBand(const SkIRect& resultBounds, int bandTop, int bandBottom);
+
     // Draw a single rect into the accumulation bitmap using the specified op
     void drawRect(const SkRect& rect, const SkMatrix& matrix, SkRegion::Op op, GrAA, uint8_t alpha);
 
@@ -54,7 +59,7 @@ public:
 
     // Reset the internal bitmap
     void clear(uint8_t alpha) {
-        fPixels->erase(SkColorSetARGB(alpha, 0xFF, 0xFF, 0xFF));
+        fPixels->erase(SkColorSetARGB(alpha, 0xFF, 0xFF, 0xFF), fRasterClip.getBounds());
     }
 
 private:
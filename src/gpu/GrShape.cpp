@@ -6,6 +6,7 @@
  */
 
 #include "GrShape.h"
+#include "SkStrokeCache.h"
 
 #include <utility>
 
@@ -493,8 +494,18 @@ GrShape::GrShape(const GrShape& parent, GrStyle::Apply apply, SkScalar scale) {
         SkStrokeRec::InitStyle fillOrHairline;
         SkASSERT(parent.fStyle.applies());
         SkASSERT(!parent.fStyle.pathEffect());
-        SkAssertResult(parent.fStyle.applyToPath(&this->path(), &fillOrHairline, *srcForParentStyle,
-                                                 scale));
+        if (Type::kPath == parent.fType) {
+            // Share the outline with other draws of the path with the same stroke.
+            SkStrokeRec strokeRec = parent.fStyle.strokeRec();
+            strokeRec.setResScale(SkStrokeCache::BucketResScale(scale));
+            SkAssertResult(SkStrokeCache::ApplyToPath(strokeRec, *srcForParentStyle,
+                                                      &this->path()));
+            this->path().setIsVolatile(true);
+            fillOrHairline = SkStrokeRec::kFill_InitStyle;
+        } else {
+            SkAssertResult(parent.fStyle.applyToPath(&this->path(), &fillOrHairline,
+                                                     *srcForParentStyle, scale));
+        }
         fStyle.resetToInitStyle(fillOrHairline);
     }
     if (parent.fInheritedPathForListeners.isValid()) {
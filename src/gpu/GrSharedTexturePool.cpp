@@ -0,0 +1,153 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "GrSharedTexturePool.h"
+
+#include "GrBackendSurface.h"
+#include "GrContext.h"
+#include "GrGpu.h"
+#include "GrResourceCache.h"
+#include "GrResourceProvider.h"
+#include "GrResourceProviderPriv.h"
+#include "GrSemaphore.h"
+#include "GrTexture.h"
+#include "SkMessageBus.h"
+
+/**
+ * A published texture. The pool holds one ref while the texture is published and every borrowed
+ * copy holds another through its release proc. The last unref tells the owning context that it
+ * can drop the ref it keeps on the texture, so that happens on the owning context's thread.
+ */
+class GrSharedTexturePool::Entry : public SkNVRefCnt<Entry> {
+public:
+    Entry(const GrUniqueKey& key, GrTexture* texture, uint32_t owningContextID,
+          const GrBackendTexture& backendTexture, GrSurfaceOrigin origin,
+          sk_sp<GrSemaphore> semaphore)
+            : fKey(key)
+            , fTexture(texture)
+            , fOwningContextID(owningContextID)
+            , fBackendTexture(backendTexture)
+            , fOrigin(origin)
+            , fSemaphore(std::move(semaphore))
+            , fBytes(texture->gpuMemorySize()) {}
+
+    ~Entry() {
+        GrGpuResourceFreedMessage msg { fTexture, fOwningContextID };
+        SkMessageBus<GrGpuResourceFreedMessage>::Post(msg);
+    }
+
+    static void ReleaseBorrowedTexture(void* ctx) { static_cast<Entry*>(ctx)->unref(); }
+
+    const GrUniqueKey  fKey;
+    GrTexture* const   fTexture;  // never dereferenced outside of the owning context
+    const uint32_t     fOwningContextID;
+    GrBackendTexture   fBackendTexture;
+    GrSurfaceOrigin    fOrigin;
+    sk_sp<GrSemaphore> fSemaphore;
+    const size_t       fBytes;
+
+    SK_DECLARE_INTERNAL_LLIST_INTERFACE(Entry);
+};
+
+GrSharedTexturePool::GrSharedTexturePool(size_t maxBytes) : fMaxBytes(maxBytes) {}
+
+GrSharedTexturePool::~GrSharedTexturePool() {
+    // Every context is expected to have withdrawn its textures by now.
+    SkASSERT(!fEntries.count());
+    while (Entry* entry = fLRU.head()) {
+        this->removeEntry(entry);
+    }
+}
+
+size_t GrSharedTexturePool::bytesUsed() const {
+    SkAutoMutexAcquire lock(fMutex);
+    return fBytesUsed;
+}
+
+int GrSharedTexturePool::count() const {
+    SkAutoMutexAcquire lock(fMutex);
+    return fEntries.count();
+}
+
+void GrSharedTexturePool::removeEntry(Entry* entry) {
+    fEntries.remove(entry->fKey);
+    fLRU.remove(entry);
+    fBytesUsed -= entry->fBytes;
+    entry->unref();
+}
+
+bool GrSharedTexturePool::publish(GrTexture* texture, const GrBackendTexture& backendTexture,
+                                  GrSurfaceOrigin origin, sk_sp<GrSemaphore> semaphore) {
+    const GrUniqueKey& key = texture->getUniqueKey();
+    SkASSERT(key.isValid());
+    size_t bytes = texture->gpuMemorySize();
+
+    SkAutoMutexAcquire lock(fMutex);
+    if (bytes > fMaxBytes || fEntries.find(key)) {
+        return false;
+    }
+    while (fBytesUsed + bytes > fMaxBytes) {
+        this->removeEntry(fLRU.tail());
+    }
+    Entry* entry = new Entry(key, texture, texture->getContext()->uniqueID(), backendTexture,
+                             origin, std::move(semaphore));
+    fEntries.set(key, entry);
+    fLRU.addToHead(entry);
+    fBytesUsed += bytes;
+    return true;
+}
+
+sk_sp<GrTexture> GrSharedTexturePool::borrow(const GrUniqueKey& key, GrSurfaceOrigin origin,
+                                             GrResourceProvider* resourceProvider,
+                                             uint32_t contextID) {
+    Entry* entry;
+    {
+        SkAutoMutexAcquire lock(fMutex);
+        Entry** found = fEntries.find(key);
+        if (!found || (*found)->fOwningContextID == contextID || (*found)->fOrigin != origin) {
+            return nullptr;
+        }
+        entry = *found;
+        fLRU.remove(entry);
+        fLRU.addToHead(entry);
+        // This ref is passed to the borrowed texture's release proc.
+        entry->ref();
+    }
+
+    sk_sp<GrTexture> texture = resourceProvider->wrapBackendTexture(entry->fBackendTexture,
+                                                                    kBorrow_GrWrapOwnership);
+    if (!texture) {
+        entry->unref();
+        return nullptr;
+    }
+    texture->setRelease(Entry::ReleaseBorrowedTexture, entry);
+    if (entry->fSemaphore) {
+        resourceProvider->priv().gpu()->waitSemaphore(entry->fSemaphore);
+    }
+    return texture;
+}
+
+void GrSharedTexturePool::withdraw(const GrUniqueKey& key, uint32_t owningContextID) {
+    SkAutoMutexAcquire lock(fMutex);
+    Entry** found = fEntries.find(key);
+    if (found && (*found)->fOwningContextID == owningContextID) {
+        this->removeEntry(*found);
+    }
+}
+
+void GrSharedTexturePool::withdrawAll(uint32_t owningContextID) {
+    SkAutoMutexAcquire lock(fMutex);
+    SkTInternalLList<Entry>::Iter iter;
+    Entry* entry = iter.init(fLRU, SkTInternalLList<Entry>::Iter::kHead_IterStart);
+    while (entry) {
+        Entry* next = iter.next();
+        if (entry->fOwningContextID == owningContextID) {
+            this->removeEntry(entry);
+        }
+        entry = next;
+    }
+}
@@ -28,6 +28,9 @@ public:
     bool isDirty() const { return fIsDirty; }
 
     void cleared() { fIsDirty = false; }
+    // Called when the backend lets the stencil values become undefined, e.g. by invalidating them
+    // at the end of a render pass.
+    void discarded() { fIsDirty = true; }
 
     // We create a unique stencil buffer at each width, height and sampleCnt and share it for
     // all render targets that require a stencil with those params.
@@ -469,25 +469,35 @@ const GrUserStencilSettings* GrStencilSettings::SetClipBitSettings(bool setToIns
     return setToInside ? &gReplaceClip : &gZeroStencilClipBit;
 }
 
-void GrStencilSettings::genKey(GrProcessorKeyBuilder* b) const {
+void GrStencilSettings::genKey(GrProcessorKeyBuilder* b, bool includeRefsAndMasks) const {
     b->add32(fFlags);
     if (this->isDisabled()) {
         return;
     }
+    Face faces[2];
+    faces[0] = fFront;
+    if (this->isTwoSided()) {
+        faces[1] = fBack;
+    }
+    if (!includeRefsAndMasks) {
+        for (Face& face : faces) {
+            face.fRef = 0;
+            face.fTestMask = 0;
+            face.fWriteMask = 0;
+        }
+    }
     if (!this->isTwoSided()) {
         constexpr int kCount16 = sizeof(Face) / sizeof(uint16_t);
         GR_STATIC_ASSERT(0 == sizeof(Face) % sizeof(uint16_t));
         uint16_t* key = reinterpret_cast<uint16_t*>(b->add32n((kCount16 + 1) / 2));
-        memcpy(key, &fFront, sizeof(Face));
+        memcpy(key, &faces[0], sizeof(Face));
         key[kCount16] = 0;
         GR_STATIC_ASSERT(1 == kCount16 % 2);
     } else {
         constexpr int kCount32 = (2 * sizeof(Face)) / sizeof(uint32_t);
         GR_STATIC_ASSERT(0 == (2 * sizeof(Face)) % sizeof(uint32_t));
         uint32_t* key = b->add32n(kCount32);
-        memcpy(key, &fFront, 2 * sizeof(Face));
-        GR_STATIC_ASSERT(sizeof(Face) ==
-                         offsetof(GrStencilSettings, fBack) - offsetof(GrStencilSettings, fFront));
+        memcpy(key, faces, 2 * sizeof(Face));
     }
     // We rely on GrStencilSettings::Face being tightly packed for the key to be reliable.
     GR_STATIC_ASSERT(0 == offsetof(Face, fRef));
@@ -68,7 +68,9 @@ public:
     bool usesWrapOp() const { SkASSERT(this->isValid());
                               return !(fFlags & kNoWrapOps_StencilFlag); }
 
-    void genKey(GrProcessorKeyBuilder* b) const;
+    // Backends that set the stencil references and masks separately from the rest of the state
+    // can leave them out of the key.
+    void genKey(GrProcessorKeyBuilder* b, bool includeRefsAndMasks) const;
 
     bool operator!=(const GrStencilSettings& that) const { return !(*this == that); }
     bool operator==(const GrStencilSettings&) const;
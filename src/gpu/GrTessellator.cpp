@@ -12,10 +12,13 @@
 #include "GrVertexWriter.h"
 
 #include "SkArenaAlloc.h"
+#include "SkExecutor.h"
 #include "SkGeometry.h"
 #include "SkPath.h"
 #include "SkPointPriv.h"
 #include "SkTDPQueue.h"
+#include "SkTaskGroup.h"
+#include "SkTemplates.h"
 
 #include <algorithm>
 #include <cstdio>
@@ -2233,6 +2236,45 @@ void* outer_mesh_to_triangles(const VertexList& outerMesh, const AAParams* aaPar
     return data;
 }
 
+// PathToTrianglesInBands only splits paths that linearize to at least this many points per band.
+const int kMinPointsPerBand = 256;
+
+// Returns the point where the edge p0-p1 crosses the horizontal line at y. The crossing is always
+// computed from the upper endpoint, so both bands that share the line get bit-identical points.
+SkPoint band_crossing(SkPoint p0, SkPoint p1, SkScalar y) {
+    if (p0.fY > p1.fY) {
+        std::swap(p0, p1);
+    }
+    return { p0.fX + (y - p0.fY) * (p1.fX - p0.fX) / (p1.fY - p0.fY), y };
+}
+
+// Clips a contour to the band [top, bottom]. Parts of the contour outside the band are projected
+// onto the band's edges; they enclose no area, so the winding inside the band is unchanged.
+void clip_contour_to_band(const VertexList& contour, SkScalar top, SkScalar bottom,
+                          VertexList* out, SkArenaAlloc& alloc) {
+    SkPoint a = contour.fTail->fPoint;
+    for (Vertex* v = contour.fHead; v; v = v->fNext) {
+        SkPoint b = v->fPoint;
+        if (a.fY < b.fY) {
+            if (a.fY < top && top < b.fY) {
+                append_point_to_contour(band_crossing(a, b, top), out, alloc);
+            }
+            if (a.fY < bottom && bottom < b.fY) {
+                append_point_to_contour(band_crossing(a, b, bottom), out, alloc);
+            }
+        } else if (a.fY > b.fY) {
+            if (b.fY < bottom && bottom < a.fY) {
+                append_point_to_contour(band_crossing(a, b, bottom), out, alloc);
+            }
+            if (b.fY < top && top < a.fY) {
+                append_point_to_contour(band_crossing(a, b, top), out, alloc);
+            }
+        }
+        append_point_to_contour({ b.fX, SkTPin(b.fY, top, bottom) }, out, alloc);
+        a = b;
+    }
+}
+
 } // namespace
 
 namespace GrTessellator {
@@ -2281,6 +2323,117 @@ int PathToTriangles(const SkPath& path, SkScalar tolerance, const SkRect& clipBo
     return actualCount;
 }
 
+int PathToTrianglesInBands(const SkPath& path, SkScalar tolerance, const SkRect& clipBounds,
+                           VertexAllocator* vertexAllocator, int bandCount, SkExecutor* executor,
+                           bool* isLinear) {
+    SkASSERT(vertexAllocator->stride() == sizeof(SkPoint));
+    int contourCnt = get_contour_count(path, tolerance);
+    if (contourCnt <= 0) {
+        *isLinear = true;
+        return 0;
+    }
+    SkPath::FillType fillType = path.getFillType();
+    if (SkPath::IsInverseFillType(fillType)) {
+        contourCnt++;
+    }
+    SkArenaAlloc alloc(kArenaChunkSize);
+    std::unique_ptr<VertexList[]> contours(new VertexList[contourCnt]);
+    path_to_contours(path, tolerance, clipBounds, contours.get(), alloc, isLinear);
+
+    // Find the vertical extent of each contour, so bands can skip the contours they don't touch.
+    SkAutoTMalloc<SkPoint> yRanges(contourCnt);
+    SkRect bounds = { SK_ScalarMax, SK_ScalarMax, SK_ScalarMin, SK_ScalarMin };
+    int pointCount = 0;
+    for (int i = 0; i < contourCnt; ++i) {
+        yRanges[i] = { SK_ScalarMax, SK_ScalarMin };
+        for (Vertex* v = contours[i].fHead; v; v = v->fNext) {
+            yRanges[i].fX = SkTMin(yRanges[i].fX, v->fPoint.fY);
+            yRanges[i].fY = SkTMax(yRanges[i].fY, v->fPoint.fY);
+            bounds.fLeft = SkTMin(bounds.fLeft, v->fPoint.fX);
+            bounds.fRight = SkTMax(bounds.fRight, v->fPoint.fX);
+            ++pointCount;
+        }
+        bounds.fTop = SkTMin(bounds.fTop, yRanges[i].fX);
+        bounds.fBottom = SkTMax(bounds.fBottom, yRanges[i].fY);
+    }
+    if (!pointCount) {
+        return 0;
+    }
+    bandCount = SkTMax(1, SkTMin(bandCount, pointCount / kMinPointsPerBand));
+
+    // Band i spans [bandLine(i), bandLine(i + 1)]. Neighbouring bands use the same value for
+    // their shared line, so their clipped edges meet exactly.
+    auto bandLine = [&](int i) {
+        return i == bandCount ? bounds.fBottom
+                              : bounds.fTop + bounds.height() * i / bandCount;
+    };
+
+    struct Band {
+        SkAutoTMalloc<SkPoint> fVerts;
+        int64_t                fCount = 0;
+    };
+    std::unique_ptr<Band[]> bands(new Band[bandCount]);
+    auto tessellateBand = [&](int i) {
+        SkRect bandBounds = { bounds.fLeft, bandLine(i), bounds.fRight, bandLine(i + 1) };
+        SkArenaAlloc bandAlloc(kArenaChunkSize);
+        std::unique_ptr<VertexList[]> bandContours(new VertexList[contourCnt]);
+        int bandContourCnt = 0;
+        for (int j = 0; j < contourCnt; ++j) {
+            if (!contours[j].fHead ||
+                yRanges[j].fY <= bandBounds.fTop || yRanges[j].fX >= bandBounds.fBottom) {
+                continue;
+            }
+            clip_contour_to_band(contours[j], bandBounds.fTop, bandBounds.fBottom,
+                                 &bandContours[bandContourCnt++], bandAlloc);
+        }
+        Poly* polys = contours_to_polys(bandContours.get(), bandContourCnt, fillType, bandBounds,
+                                        false, nullptr, bandAlloc);
+        int64_t count64 = count_points(polys, fillType);
+        if (0 == count64 || count64 > SK_MaxS32) {
+            bands[i].fCount = count64;
+            return;
+        }
+        bands[i].fVerts.reset(count64);
+        SkPoint* end = static_cast<SkPoint*>(polys_to_triangles(polys, fillType, nullptr,
+                                                                bands[i].fVerts.get()));
+        bands[i].fCount = end - bands[i].fVerts.get();
+        SkASSERT(bands[i].fCount <= count64);
+    };
+    if (executor && bandCount > 1) {
+        SkTaskGroup taskGroup(*executor);
+        taskGroup.batch(bandCount, tessellateBand);
+        taskGroup.wait();
+    } else {
+        for (int i = 0; i < bandCount; ++i) {
+            tessellateBand(i);
+        }
+    }
+
+    int64_t count64 = 0;
+    for (int i = 0; i < bandCount; ++i) {
+        count64 += bands[i].fCount;
+    }
+    if (0 == count64 || count64 > SK_MaxS32) {
+        return 0;
+    }
+    int count = count64;
+
+    SkPoint* verts = static_cast<SkPoint*>(vertexAllocator->lock(count));
+    if (!verts) {
+        SkDebugf("Could not allocate vertices\n");
+        return 0;
+    }
+    LOG("emitting %d verts in %d bands\n", count, bandCount);
+    for (int i = 0; i < bandCount; ++i) {
+        if (bands[i].fCount) {
+            memcpy(verts, bands[i].fVerts.get(), bands[i].fCount * sizeof(SkPoint));
+            verts += bands[i].fCount;
+        }
+    }
+    vertexAllocator->unlock(count);
+    return count;
+}
+
 int PathToVertices(const SkPath& path, SkScalar tolerance, const SkRect& clipBounds,
                    GrTessellator::WindingVertex** verts) {
     int contourCnt = get_contour_count(path, tolerance);
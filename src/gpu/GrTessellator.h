@@ -12,6 +12,7 @@
 #include "SkColorData.h"
 #include "SkPoint.h"
 
+class SkExecutor;
 class SkPath;
 struct SkRect;
 
@@ -49,6 +50,14 @@ int PathToVertices(const SkPath& path, SkScalar tolerance, const SkRect& clipBou
 int PathToTriangles(const SkPath& path, SkScalar tolerance, const SkRect& clipBounds,
                     VertexAllocator*, bool antialias, const GrColor& color,
                     bool canTweakAlphaForCoverage, bool *isLinear);
+
+// Non-antialiased PathToTriangles that splits the path into bandCount horizontal bands and
+// tessellates each band on its own task. The bands share their clipped edges exactly, so the
+// result covers the same pixels as PathToTriangles. The allocator's stride must be
+// sizeof(SkPoint). When executor is null, or the path is too small to be worth splitting, the
+// bands are tessellated serially on the calling thread.
+int PathToTrianglesInBands(const SkPath& path, SkScalar tolerance, const SkRect& clipBounds,
+                           VertexAllocator*, int bandCount, SkExecutor* executor, bool* isLinear);
 }
 
 #endif
@@ -117,6 +117,21 @@ sk_sp<GrTextureProxy> GrYUVProvider::refAsTextureProxy(GrContext* ctx,
         return nullptr;
     }
 
+    return MakeTextureProxy(ctx, format, desc, yuvSizeInfo, yuvaIndices, yuvColorSpace, planes,
+                            std::move(dataStorage), srcColorSpace, dstColorSpace);
+}
+
+sk_sp<GrTextureProxy> GrYUVProvider::MakeTextureProxy(
+        GrContext* ctx,
+        const GrBackendFormat& format,
+        const GrSurfaceDesc& desc,
+        const SkYUVASizeInfo& yuvSizeInfo,
+        const SkYUVAIndex yuvaIndices[SkYUVAIndex::kIndexCount],
+        SkYUVColorSpace yuvColorSpace,
+        const void* planes[SkYUVASizeInfo::kMaxCount],
+        sk_sp<SkCachedData> dataStorage,
+        SkColorSpace* srcColorSpace,
+        SkColorSpace* dstColorSpace) {
     sk_sp<GrTextureProxy> yuvTextureProxies[SkYUVASizeInfo::kMaxCount];
     for (int i = 0; i < SkYUVASizeInfo::kMaxCount; ++i) {
         if (yuvSizeInfo.fSizes[i].isEmpty()) {
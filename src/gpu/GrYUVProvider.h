@@ -50,6 +50,21 @@ public:
     sk_sp<SkCachedData> getPlanes(SkYUVASizeInfo*, SkYUVAIndex[SkYUVAIndex::kIndexCount],
                                   SkYUVColorSpace*, const void* planes[SkYUVASizeInfo::kMaxCount]);
 
+    /**
+     *  As refAsTextureProxy(), but for planes already returned by getPlanes(). This lets a caller
+     *  which must serialize decoding release its lock before the planes are uploaded.
+     */
+    static sk_sp<GrTextureProxy> MakeTextureProxy(GrContext*,
+                                                  const GrBackendFormat&,
+                                                  const GrSurfaceDesc&,
+                                                  const SkYUVASizeInfo&,
+                                                  const SkYUVAIndex[SkYUVAIndex::kIndexCount],
+                                                  SkYUVColorSpace,
+                                                  const void* planes[SkYUVASizeInfo::kMaxCount],
+                                                  sk_sp<SkCachedData> planeStorage,
+                                                  SkColorSpace* srcColorSpace,
+                                                  SkColorSpace* dstColorSpace);
+
 private:
     virtual uint32_t onGetID() const = 0;
 
@@ -15,6 +15,7 @@
 #include "GrContextPriv.h"
 #include "GrGpu.h"
 #include "GrImageTextureMaker.h"
+#include "GrPictureRasterCache.h"
 #include "GrRenderTargetContextPriv.h"
 #include "GrShape.h"
 #include "GrStyle.h"
@@ -1455,11 +1456,12 @@ void SkGpuDevice::drawBitmapLattice(const SkBitmap& bitmap,
 }
 
 void SkGpuDevice::drawImageSet(const SkCanvas::ImageSetEntry set[], int count,
-                               SkFilterQuality filterQuality, SkBlendMode mode) {
+                               const SkMatrix preViewMatrices[], SkFilterQuality filterQuality,
+                               SkBlendMode mode) {
     SkASSERT(count > 0);
     if (mode != SkBlendMode::kSrcOver ||
         !fContext->contextPriv().caps()->dynamicStateArrayGeometryProcessorTextureSupport()) {
-        INHERITED::drawImageSet(set, count, filterQuality, mode);
+        INHERITED::drawImageSet(set, count, preViewMatrices, filterQuality, mode);
         return;
     }
     GrSamplerState sampler;
@@ -1488,8 +1490,13 @@ void SkGpuDevice::drawImageSet(const SkCanvas::ImageSetEntry set[], int count,
             n = 0;
             continue;
         }
-        uint32_t uniqueID;
-        textures[i].fProxy = as_IB(set[i].fImage.get())->refPinnedTextureProxy(&uniqueID);
+        // Sprite sets often draw runs of the same image, only look its proxy up once.
+        if (i > base && set[i].fImage == set[i - 1].fImage) {
+            textures[i].fProxy = textures[i - 1].fProxy;
+        } else {
+            uint32_t uniqueID;
+            textures[i].fProxy = as_IB(set[i].fImage.get())->refPinnedTextureProxy(&uniqueID);
+        }
         if (!textures[i].fProxy) {
             textures[i].fProxy =
                     as_IB(set[i].fImage.get())
@@ -1508,6 +1515,8 @@ void SkGpuDevice::drawImageSet(const SkCanvas::ImageSetEntry set[], int count,
         textures[i].fDstRect = set[i].fDstRect;
         textures[i].fAlpha = set[i].fAlpha;
         textures[i].fAAFlags = SkToGrQuadAAFlags(set[i].fAAFlags);
+        textures[i].fPreViewMatrix =
+                set[i].fMatrixIndex >= 0 ? &preViewMatrices[set[i].fMatrixIndex] : nullptr;
         if (n > 0 &&
             (!GrTextureProxy::ProxiesAreCompatibleAsDynamicState(textures[i].fProxy.get(),
                                                                  textures[base].fProxy.get()) ||
@@ -1703,6 +1712,19 @@ void SkGpuDevice::drawGlyphRunList(const SkGlyphRunList& glyphRunList) {
 
 ///////////////////////////////////////////////////////////////////////////////
 
+static void draw_picture_raster(SkGpuDevice* device, const GrPictureRasterCache::Raster& raster,
+                                const SkPaint& paint) {
+    const SkIRect& bounds = raster.fDeviceBounds;
+    sk_sp<SkSpecialImage> special = SkSpecialImage::MakeDeferredFromGpu(
+            device->context(), SkIRect::MakeWH(bounds.width(), bounds.height()),
+            kNeedNewImageUniqueID_SpecialImage, raster.fProxy, raster.fColorSpace,
+            &device->surfaceProps());
+    if (special) {
+        device->drawSpecial(special.get(), bounds.fLeft, bounds.fTop, paint, nullptr,
+                            SkMatrix::I());
+    }
+}
+
 void SkGpuDevice::drawDrawable(SkDrawable* drawable, const SkMatrix* matrix, SkCanvas* canvas) {
     GrBackendApi api = this->context()->contextPriv().getBackend();
     if (GrBackendApi::kVulkan == api) {
@@ -1715,9 +1737,55 @@ void SkGpuDevice::drawDrawable(SkDrawable* drawable, const SkMatrix* matrix, SkC
             return;
         }
     }
+    if (GrPictureRasterCache* cache = this->pictureRasterCache()) {
+        SkMatrix ctm = this->ctm();
+        if (matrix) {
+            ctm.preConcat(*matrix);
+        }
+        SkColorSpace* colorSpace = fRenderTargetContext->colorSpaceInfo().colorSpace();
+        GrPictureRasterCache::Raster raster;
+        if (cache->findOrRasterize(drawable, ctm, colorSpace, &raster)) {
+            draw_picture_raster(this, raster, SkPaint());
+            return;
+        }
+    }
     this->INHERITED::drawDrawable(drawable, matrix, canvas);
 }
 
+bool SkGpuDevice::drawCachedPicture(const SkPicture* picture, const SkMatrix* matrix,
+                                    const SkPaint* paint) {
+    ASSERT_SINGLE_OWNER
+    // Drawing the raster with the paint is what drawing the picture into a layer with the paint
+    // does, unless the paint looks beyond the picture's draws.
+    if (paint && (paint->getImageFilter() || paint->getMaskFilter() || paint->getLooper())) {
+        return false;
+    }
+    GrPictureRasterCache* cache = this->pictureRasterCache();
+    if (!cache) {
+        return false;
+    }
+    SkMatrix ctm = this->ctm();
+    if (matrix) {
+        ctm.preConcat(*matrix);
+    }
+    GrPictureRasterCache::Raster raster;
+    if (!cache->findOrRasterize(picture, ctm, fRenderTargetContext->colorSpaceInfo().colorSpace(),
+                                &raster)) {
+        return false;
+    }
+    draw_picture_raster(this, raster, paint ? *paint : SkPaint());
+    return true;
+}
+
+GrPictureRasterCache* SkGpuDevice::pictureRasterCache() const {
+    // Rasters are 8888, so other configs would lose precision drawing them.
+    GrPixelConfig config = fRenderTargetContext->colorSpaceInfo().config();
+    if (kRGBA_8888_GrPixelConfig != config && kBGRA_8888_GrPixelConfig != config) {
+        return nullptr;
+    }
+    return fContext->contextPriv().getPictureRasterCache();
+}
+
 
 ///////////////////////////////////////////////////////////////////////////////
 
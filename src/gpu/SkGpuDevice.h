@@ -21,6 +21,7 @@
 #include "SkSurface.h"
 
 class GrAccelData;
+class GrPictureRasterCache;
 class GrTextureMaker;
 class GrTextureProducer;
 struct GrCachedLayer;
@@ -105,10 +106,11 @@ public:
                           const SkRect& dst, const SkPaint&) override;
     void drawBitmapLattice(const SkBitmap&, const SkCanvas::Lattice&,
                            const SkRect& dst, const SkPaint&) override;
-    void drawImageSet(const SkCanvas::ImageSetEntry[], int count, SkFilterQuality,
-                      SkBlendMode) override;
+    void drawImageSet(const SkCanvas::ImageSetEntry[], int count, const SkMatrix[],
+                      SkFilterQuality, SkBlendMode) override;
 
     void drawDrawable(SkDrawable*, const SkMatrix*, SkCanvas* canvas) override;
+    bool drawCachedPicture(const SkPicture*, const SkMatrix*, const SkPaint*) override;
 
     void drawSpecial(SkSpecialImage*, int left, int top, const SkPaint& paint,
                      SkImage*, const SkMatrix&) override;
@@ -156,6 +158,9 @@ private:
 
     const GrCaps* caps() const { return fContext->contextPriv().caps(); }
 
+    // Returns the context's picture raster cache if this device can draw its rasters.
+    GrPictureRasterCache* pictureRasterCache() const;
+
     /**
      * Helper functions called by drawBitmapCommon. By the time these are called the SkDraw's
      * matrix, clip, and the device's render target has already been set on GrContext.
@@ -8,6 +8,7 @@
 #include "GrCCAtlas.h"
 
 #include "GrCaps.h"
+#include "GrGpuResourcePriv.h"
 #include "GrOnFlushResourceProvider.h"
 #include "GrProxyProvider.h"
 #include "GrRectanizer_skyline.h"
@@ -16,6 +17,7 @@
 #include "GrTextureProxy.h"
 #include "SkMakeUnique.h"
 #include "SkMathPriv.h"
+#include "SkMemoryCounters.h"
 #include <atomic>
 
 class GrCCAtlas::Node {
@@ -99,6 +101,7 @@ GrCCAtlas::GrCCAtlas(GrPixelConfig pixelConfig, const Specs& specs, const GrCaps
 }
 
 GrCCAtlas::~GrCCAtlas() {
+    SkMemoryCounters::Remove(SkGraphics::MemoryCounters::kGrCCAtlas, fCountedBytes);
 }
 
 bool GrCCAtlas::addRect(const SkIRect& devIBounds, SkIVector* offset) {
@@ -169,6 +172,8 @@ const GrUniqueKey& GrCCAtlas::getOrAssignUniqueKey(GrOnFlushResourceProvider* on
 
         if (fTextureProxy->isInstantiated()) {
             onFlushRP->assignUniqueKeyToProxy(fUniqueKey, fTextureProxy.get());
+            fTextureProxy->peekTexture()->resourcePriv().setPurgePriority(
+                    GrGpuResource::PurgePriority::kCCPRCache);
         }
     }
     return fUniqueKey;
@@ -207,8 +212,13 @@ sk_sp<GrRenderTargetContext> GrCCAtlas::makeRenderTargetContext(
 
     if (fUniqueKey.isValid()) {
         onFlushRP->assignUniqueKeyToProxy(fUniqueKey, fTextureProxy.get());
+        fTextureProxy->peekTexture()->resourcePriv().setPurgePriority(
+                GrGpuResource::PurgePriority::kCCPRCache);
     }
 
+    fCountedBytes = fTextureProxy->gpuMemorySize();
+    SkMemoryCounters::Add(SkGraphics::MemoryCounters::kGrCCAtlas, fCountedBytes);
+
     SkIRect clearRect = SkIRect::MakeSize(fDrawBounds);
     rtc->clear(&clearRect, SK_PMColor4fTRANSPARENT,
                GrRenderTargetContext::CanClearFullscreen::kYes);
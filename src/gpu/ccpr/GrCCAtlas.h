@@ -112,6 +112,7 @@ private:
     sk_sp<CachedAtlasInfo> fCachedAtlasInfo;
     sk_sp<GrTextureProxy> fTextureProxy;
     sk_sp<GrTexture> fBackingTexture;
+    size_t fCountedBytes = 0;  // Reported to SkMemoryCounters once we have a render target.
 };
 
 /**
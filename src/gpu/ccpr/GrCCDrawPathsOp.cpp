@@ -30,7 +30,7 @@ static int64_t area(const SkIRect& r) {
 
 std::unique_ptr<GrCCDrawPathsOp> GrCCDrawPathsOp::Make(
         GrContext* context, const SkIRect& clipIBounds, const SkMatrix& m, const GrShape& shape,
-        GrPaint&& paint) {
+        GrPaint&& paint, float maskCacheTolerance) {
     SkRect conservativeDevBounds;
     m.mapRect(&conservativeDevBounds, shape.bounds());
 
@@ -70,16 +70,17 @@ std::unique_ptr<GrCCDrawPathsOp> GrCCDrawPathsOp::Make(
 
         // FIXME: This breaks local coords: http://skbug.com/8003
         return InternalMake(context, clipIBounds, SkMatrix::I(), croppedDevShape, strokeDevWidth,
-                            conservativeDevBounds, std::move(paint));
+                            conservativeDevBounds, std::move(paint), maskCacheTolerance);
     }
 
     return InternalMake(context, clipIBounds, m, shape, strokeDevWidth, conservativeDevBounds,
-                        std::move(paint));
+                        std::move(paint), maskCacheTolerance);
 }
 
 std::unique_ptr<GrCCDrawPathsOp> GrCCDrawPathsOp::InternalMake(
         GrContext* context, const SkIRect& clipIBounds, const SkMatrix& m, const GrShape& shape,
-        float strokeDevWidth, const SkRect& conservativeDevBounds, GrPaint&& paint) {
+        float strokeDevWidth, const SkRect& conservativeDevBounds, GrPaint&& paint,
+        float maskCacheTolerance) {
     // The path itself should have been cropped if larger than kPathCropThreshold. If it had a
     // stroke, that would have further inflated its draw bounds.
     SkASSERT(SkTMax(conservativeDevBounds.height(), conservativeDevBounds.width()) <
@@ -106,10 +107,17 @@ std::unique_ptr<GrCCDrawPathsOp> GrCCDrawPathsOp::InternalMake(
                 : Visibility::kPartial;
     }
 
+    // A mask reused from the path cache with a slightly different matrix can land up to
+    // maskCacheTolerance pixels away from the path's actual bounds.
+    SkRect opBounds = conservativeDevBounds;
+    if (maskCacheTolerance > 0 && shape.hasUnstyledKey()) {
+        opBounds.outset(maskCacheTolerance, maskCacheTolerance);
+    }
+
     GrOpMemoryPool* pool = context->contextPriv().opMemoryPool();
 
     return pool->allocate<GrCCDrawPathsOp>(m, shape, strokeDevWidth, shapeConservativeIBounds,
-                                           maskDevIBounds, maskVisibility, conservativeDevBounds,
+                                           maskDevIBounds, maskVisibility, opBounds,
                                            std::move(paint));
 }
 
@@ -320,12 +328,18 @@ void GrCCDrawPathsOp::setupResources(GrOnFlushResourceProvider* onFlushRP,
                  SkPath::kWinding_FillType == path.getFillType());
 
         if (auto cacheEntry = draw.fCacheEntry.get()) {
+            // The cached mask may have been rendered with a slightly different matrix (see
+            // GrContextOptions::fPathMaskCachingTolerance). Find the shift that best aligns it.
+            SkIVector unusedShift;
+            SkIVector reuseShift = draw.fCachedMaskShift + cacheEntry->maskShiftAdjustment(
+                    GrCCPathCache::MaskTransform(draw.fMatrix, &unusedShift));
+
             // Does the path already exist in a cached atlas texture?
             if (auto proxy = draw.fCachedAtlasProxy.get()) {
                 SkASSERT(!cacheEntry->currFlushAtlas());
                 this->recordInstance(proxy, resources->nextPathInstanceIdx());
                 // TODO4F: Preserve float colors
-                resources->appendDrawPathInstance().set(*cacheEntry, draw.fCachedMaskShift,
+                resources->appendDrawPathInstance().set(*cacheEntry, reuseShift,
                                                         draw.fColor.toBytes_RGBA());
                 continue;
             }
@@ -336,7 +350,7 @@ void GrCCDrawPathsOp::setupResources(GrOnFlushResourceProvider* onFlushRP,
                 this->recordInstance(atlas->textureProxy(), resources->nextPathInstanceIdx());
                 // TODO4F: Preserve float colors
                 resources->appendDrawPathInstance().set(
-                        *cacheEntry, draw.fCachedMaskShift, draw.fColor.toBytes_RGBA(),
+                        *cacheEntry, reuseShift, draw.fColor.toBytes_RGBA(),
                         cacheEntry->hasCachedAtlas() ? DoEvenOddFill::kNo : doEvenOddFill);
                 continue;
             }
@@ -353,7 +367,7 @@ void GrCCDrawPathsOp::setupResources(GrOnFlushResourceProvider* onFlushRP,
                         atlas->refOrMakeCachedAtlasInfo(onFlushRP->contextUniqueID()));
                 this->recordInstance(atlas->textureProxy(), resources->nextPathInstanceIdx());
                 // TODO4F: Preserve float colors
-                resources->appendDrawPathInstance().set(*cacheEntry, draw.fCachedMaskShift,
+                resources->appendDrawPathInstance().set(*cacheEntry, reuseShift,
                                                         draw.fColor.toBytes_RGBA());
                 // Remember this atlas in case we encounter the path again during the same flush.
                 cacheEntry->setCurrFlushAtlas(atlas);
@@ -397,8 +411,11 @@ void GrCCDrawPathsOp::setupResources(GrOnFlushResourceProvider* onFlushRP,
 
                 const GrUniqueKey& atlasKey =
                         resources->nextAtlasToStash()->getOrAssignUniqueKey(onFlushRP);
-                cacheEntry->initAsStashedAtlas(atlasKey, devToAtlasOffset, devBounds, devBounds45,
-                                               devIBounds, draw.fCachedMaskShift);
+                SkIVector maskShift;
+                cacheEntry->initAsStashedAtlas(
+                        atlasKey, GrCCPathCache::MaskTransform(draw.fMatrix, &maskShift),
+                        devToAtlasOffset, devBounds, devBounds45, devIBounds, maskShift);
+                SkASSERT(maskShift == draw.fCachedMaskShift);
                 // Remember this atlas in case we encounter the path again during the same flush.
                 cacheEntry->setCurrFlushAtlas(atlas);
             }
@@ -29,8 +29,11 @@ public:
     DEFINE_OP_CLASS_ID
     SK_DECLARE_INTERNAL_LLIST_INTERFACE(GrCCDrawPathsOp);
 
+    // 'maskCacheTolerance' is the path cache's maximum error for reusing a mask with a different
+    // matrix. The op's bounds get outset by this amount to cover a reused mask.
     static std::unique_ptr<GrCCDrawPathsOp> Make(GrContext*, const SkIRect& clipIBounds,
-                                                 const SkMatrix&, const GrShape&, GrPaint&&);
+                                                 const SkMatrix&, const GrShape&, GrPaint&&,
+                                                 float maskCacheTolerance = 0);
     ~GrCCDrawPathsOp() override;
 
     const char* name() const override { return "GrCCDrawPathsOp"; }
@@ -75,7 +78,7 @@ private:
                                                          const SkMatrix&, const GrShape&,
                                                          float strokeDevWidth,
                                                          const SkRect& conservativeDevBounds,
-                                                         GrPaint&&);
+                                                         GrPaint&&, float maskCacheTolerance);
     enum class Visibility {
         kPartial,
         kMostlyComplete,  // (i.e., can we cache the whole path mask if we think it will be reused?)
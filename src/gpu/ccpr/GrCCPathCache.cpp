@@ -64,6 +64,41 @@ inline static bool fuzzy_equals(const GrCCPathCache::MaskTransform& a,
     return true;
 }
 
+// Returns the integer translate that best aligns a mask rendered with 'cached' to 'm'.
+static SkIVector mask_shift_adjustment(const GrCCPathCache::MaskTransform& cached,
+                                       const GrCCPathCache::MaskTransform& m) {
+#ifndef SK_BUILD_FOR_ANDROID_FRAMEWORK
+    Sk2f delta = Sk2f::Load(m.fSubpixelTranslate) - Sk2f::Load(cached.fSubpixelTranslate);
+    Sk2f adjust = (delta + .5f).floor();
+    return {(int)adjust[0], (int)adjust[1]};
+#else
+    return {0, 0};
+#endif
+}
+
+// Returns the farthest distance, in device pixels, that any point inside 'localBounds' lands from
+// where it belongs when a mask rendered with 'cached' is drawn (shifted by mask_shift_adjustment)
+// in place of 'm'. The error is affine in the point, so its maximum is at one of the corners.
+static float max_mask_error(const GrCCPathCache::MaskTransform& cached,
+                            const GrCCPathCache::MaskTransform& m, const SkRect& localBounds) {
+    Sk4f matrixDelta = Sk4f::Load(cached.fMatrix2x2) - Sk4f::Load(m.fMatrix2x2);
+    float dx = 0, dy = 0;
+#ifndef SK_BUILD_FOR_ANDROID_FRAMEWORK
+    SkIVector adjust = mask_shift_adjustment(cached, m);
+    dx = cached.fSubpixelTranslate[0] + adjust.fX - m.fSubpixelTranslate[0];
+    dy = cached.fSubpixelTranslate[1] + adjust.fY - m.fSubpixelTranslate[1];
+#endif
+    SkPoint corners[4];
+    localBounds.toQuad(corners);
+    float maxErrorSquared = 0;
+    for (const SkPoint& p : corners) {
+        float x = matrixDelta[0] * p.fX + matrixDelta[1] * p.fY + dx;
+        float y = matrixDelta[2] * p.fX + matrixDelta[3] * p.fY + dy;
+        maxErrorSquared = SkTMax(maxErrorSquared, x*x + y*y);
+    }
+    return std::sqrt(maxErrorSquared);
+}
+
 sk_sp<GrCCPathCache::Key> GrCCPathCache::Key::Make(uint32_t pathCacheUniqueID,
                                                    int dataCountU32, const void* data) {
     void* memory = ::operator new (sizeof(Key) + dataCountU32 * sizeof(uint32_t));
@@ -136,8 +171,9 @@ inline void GrCCPathCache::HashNode::willExitHashTable() {
 }
 
 
-GrCCPathCache::GrCCPathCache()
-        : fInvalidatedKeysInbox(next_path_cache_id())
+GrCCPathCache::GrCCPathCache(float maxMaskError)
+        : fMaxMaskError(maxMaskError)
+        , fInvalidatedKeysInbox(next_path_cache_id())
         , fScratchKey(Key::Make(fInvalidatedKeysInbox.uniqueID(), kMaxKeyDataCountU32)) {
 }
 
@@ -190,6 +226,18 @@ private:
 
 }
 
+bool GrCCPathCache::isCompatible(const MaskTransform& cached, const MaskTransform& m,
+                                 const GrShape& shape) {
+    if (fuzzy_equals(cached, m)) {
+        return true;
+    }
+    if (fMaxMaskError > 0 && max_mask_error(cached, m, shape.styledBounds()) <= fMaxMaskError) {
+        ++fNumInexactHits;
+        return true;
+    }
+    return false;
+}
+
 sk_sp<GrCCPathCacheEntry> GrCCPathCache::find(const GrShape& shape, const MaskTransform& m,
                                               CreateIfAbsent createIfAbsent) {
     if (!shape.hasUnstyledKey()) {
@@ -209,7 +257,7 @@ sk_sp<GrCCPathCacheEntry> GrCCPathCache::find(const GrShape& shape, const MaskTr
     if (HashNode* node = fHashTable.find(*fScratchKey)) {
         entry = node->entry();
         SkASSERT(fLRU.isInList(entry));
-        if (!fuzzy_equals(m, entry->fMaskTransform)) {
+        if (!this->isCompatible(entry->fMaskTransform, m, shape)) {
             // The path was reused with an incompatible matrix.
             if (CreateIfAbsent::kYes == createIfAbsent && entry->unique()) {
                 // This entry is unique: recycle it instead of deleting and malloc-ing a new one.
@@ -296,12 +344,14 @@ void GrCCPathCache::purgeInvalidatedKeys() {
 
 
 void GrCCPathCacheEntry::initAsStashedAtlas(const GrUniqueKey& atlasKey,
+                                            const MaskTransform& maskTransform,
                                             const SkIVector& atlasOffset, const SkRect& devBounds,
                                             const SkRect& devBounds45, const SkIRect& devIBounds,
                                             const SkIVector& maskShift) {
     SkASSERT(atlasKey.isValid());
     SkASSERT(!fCurrFlushAtlas);  // Otherwise we should reuse the atlas from last time.
 
+    fMaskTransform = maskTransform;
     fAtlasKey = atlasKey;
     fAtlasOffset = atlasOffset + maskShift;
     SkASSERT(!fCachedAtlasInfo);  // Otherwise they should have reused the cached atlas instead.
@@ -312,6 +362,10 @@ void GrCCPathCacheEntry::initAsStashedAtlas(const GrUniqueKey& atlasKey,
     fDevIBounds = devIBounds.makeOffset(-maskShift.fX, -maskShift.fY);
 }
 
+SkIVector GrCCPathCacheEntry::maskShiftAdjustment(const MaskTransform& drawTransform) const {
+    return mask_shift_adjustment(fMaskTransform, drawTransform);
+}
+
 void GrCCPathCacheEntry::updateToCachedAtlas(const GrUniqueKey& atlasKey,
                                              const SkIVector& newAtlasOffset,
                                              sk_sp<GrCCAtlas::CachedAtlasInfo> info) {
@@ -19,12 +19,16 @@ class GrShape;
 
 /**
  * This class implements an LRU cache that maps from GrShape to GrCCPathCacheEntry objects. Shapes
- * are only given one entry in the cache, so any time they are accessed with a different matrix, the
- * old entry gets evicted.
+ * are only given one entry in the cache, so any time they are accessed with an incompatible matrix,
+ * the old entry gets evicted.
+ *
+ * If maxMaskError is nonzero, a matrix is also compatible when drawing the cached mask in its place
+ * moves no point on the shape's bounds by more than maxMaskError device pixels. This lets masks
+ * survive fractional scrolling and slow zooms.
  */
 class GrCCPathCache {
 public:
-    GrCCPathCache();
+    GrCCPathCache(float maxMaskError = 0);
     ~GrCCPathCache();
 
     class Key : public SkPathRef::GenIDChangeListener {
@@ -89,6 +93,12 @@ public:
     void doPostFlushProcessing();
     void purgeEntriesOlderThan(const GrStdSteadyClock::time_point& purgeTime);
 
+    float maxMaskError() const { return fMaxMaskError; }
+
+    // Returns the number of find() calls that matched an entry only within maxMaskError, and
+    // resets the count.
+    int takeNumInexactHits() { return skstd::exchange(fNumInexactHits, 0); }
+
 private:
     // This is a special ref ptr for GrCCPathCacheEntry, used by the hash table. It provides static
     // methods for SkTHash, and can only be moved. This guarantees the hash table holds exactly one
@@ -133,6 +143,12 @@ private:
 
     void purgeInvalidatedKeys();
 
+    // Can a mask rendered with 'cached' be drawn in place of 'm' for the given shape?
+    bool isCompatible(const MaskTransform& cached, const MaskTransform& m, const GrShape&);
+
+    const float fMaxMaskError;
+    int fNumInexactHits = 0;
+
     SkTHashTable<HashNode, const GrCCPathCache::Key&> fHashTable;
     SkTInternalLList<GrCCPathCacheEntry> fLRU;
     SkMessageBus<sk_sp<Key>>::Inbox fInvalidatedKeysInbox;
@@ -175,9 +191,12 @@ public:
     // Called once our path has been rendered into the mainline CCPR (fp16, coverage count) atlas.
     // The caller will stash this atlas texture away after drawing, and during the next flush,
     // recover it and attempt to copy any paths that got reused into permanent 8-bit atlases.
-    void initAsStashedAtlas(const GrUniqueKey& atlasKey, const SkIVector& atlasOffset,
-                            const SkRect& devBounds, const SkRect& devBounds45,
-                            const SkIRect& devIBounds, const SkIVector& maskShift);
+    // 'maskTransform' is the transform the path was rendered with, which replaces the one this entry
+    // was found with.
+    void initAsStashedAtlas(const GrUniqueKey& atlasKey, const GrCCPathCache::MaskTransform&,
+                            const SkIVector& atlasOffset, const SkRect& devBounds,
+                            const SkRect& devBounds45, const SkIRect& devIBounds,
+                            const SkIVector& maskShift);
 
     // Called once our path mask has been copied into a permanent, 8-bit atlas. This method points
     // the entry at the new atlas and updates the CachedAtlasInfo data.
@@ -186,6 +205,11 @@ public:
 
     const GrUniqueKey& atlasKey() const { return fAtlasKey; }
 
+    // Returns the integer translate to add to a draw's mask shift so this entry's mask lines up as
+    // closely as possible with the draw. This is only nonzero when the draw's matrix matched our
+    // mask transform inexactly and the two subpixel translates straddle a pixel boundary.
+    SkIVector maskShiftAdjustment(const GrCCPathCache::MaskTransform& drawTransform) const;
+
     void resetAtlasKeyAndInfo() {
         fAtlasKey.reset();
         fCachedAtlasInfo.reset();
@@ -9,6 +9,7 @@
 
 #include "GrGpuCommandBuffer.h"
 #include "GrOnFlushResourceProvider.h"
+#include "SkGeometry.h"
 #include "SkPathPriv.h"
 #include "SkStrokeRec.h"
 #include "ccpr/GrCCCoverageProcessor.h"
@@ -310,6 +311,8 @@ void GrCCStroker::parseDeviceSpaceStroke(const SkPath& path, const SkPoint* devi
 
     fPathInfos.push_back() = {devToAtlasOffset, strokeDevWidth/2, scissorTest};
 
+    const float* conicWeights = SkPathPriv::ConicWeightData(path);
+    int conicWeightsIdx = 0;
     int devPtsIdx = 0;
     SkPath::Verb previousVerb = SkPath::kClose_Verb;
 
@@ -344,10 +347,21 @@ void GrCCStroker::parseDeviceSpaceStroke(const SkPath& path, const SkPoint* devi
                 devPtsIdx += 3;
                 break;
             }
-            case SkPath::kConic_Verb:
+            case SkPath::kConic_Verb: {
                 SkASSERT(SkPath::kClose_Verb != previousVerb);
-                SK_ABORT("Stroked conics not supported.");
+                // The stroker has no conic segments of its own, so we approximate conics with
+                // quadratics. The points are already in device space, so a quarter pixel tolerance
+                // is well below what the stroke's coverage can show.
+                SkAutoConicToQuads quadder;
+                const SkPoint* quadPts = quadder.computeQuads(P, conicWeights[conicWeightsIdx],
+                                                              0.25f);
+                for (int i = 0; i < quadder.countQuads(); ++i) {
+                    fGeometry.quadraticTo(&quadPts[i * 2]);
+                }
+                devPtsIdx += 2;
+                ++conicWeightsIdx;
                 break;
+            }
             case SkPath::kDone_Verb:
                 break;
         }
@@ -357,6 +371,7 @@ void GrCCStroker::parseDeviceSpaceStroke(const SkPath& path, const SkPoint* devi
     if (devPtsIdx > 0 && SkPath::kClose_Verb != previousVerb) {
         fGeometry.capContourAndExit();
     }
+    SkASSERT(conicWeightsIdx == SkPathPriv::ConicWeightCnt(path));
 }
 
 // This class encapsulates the process of expanding ready-to-draw geometry from GrCCStrokeGeometry
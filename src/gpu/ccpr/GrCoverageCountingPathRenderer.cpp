@@ -30,15 +30,16 @@ bool GrCoverageCountingPathRenderer::IsSupported(const GrCaps& caps) {
 }
 
 sk_sp<GrCoverageCountingPathRenderer> GrCoverageCountingPathRenderer::CreateIfSupported(
-        const GrCaps& caps, AllowCaching allowCaching) {
+        const GrCaps& caps, AllowCaching allowCaching, float cachingTolerance) {
     return sk_sp<GrCoverageCountingPathRenderer>((IsSupported(caps))
-            ? new GrCoverageCountingPathRenderer(allowCaching)
+            ? new GrCoverageCountingPathRenderer(allowCaching, cachingTolerance)
             : nullptr);
 }
 
-GrCoverageCountingPathRenderer::GrCoverageCountingPathRenderer(AllowCaching allowCaching) {
+GrCoverageCountingPathRenderer::GrCoverageCountingPathRenderer(AllowCaching allowCaching,
+                                                               float cachingTolerance) {
     if (AllowCaching::kYes == allowCaching) {
-        fPathCache = skstd::make_unique<GrCCPathCache>();
+        fPathCache = skstd::make_unique<GrCCPathCache>(SkTPin(cachingTolerance, 0.f, 1.f));
     }
 }
 
@@ -116,10 +117,6 @@ GrPathRenderer::CanDrawPath GrCoverageCountingPathRenderer::onCanDrawPath(
                 return CanDrawPath::kNo;
             }
             SkASSERT(!SkScalarIsNaN(inflationRadius));
-            if (SkPathPriv::ConicWeightCnt(path)) {
-                // The stroker does not support conics yet.
-                return CanDrawPath::kNo;
-            }
             return CanDrawPath::kYes;
         }
 
@@ -139,7 +136,8 @@ bool GrCoverageCountingPathRenderer::onDrawPath(const DrawPathArgs& args) {
     args.fClip->getConservativeBounds(rtc->width(), rtc->height(), &clipIBounds, nullptr);
 
     auto op = GrCCDrawPathsOp::Make(args.fContext, clipIBounds, *args.fViewMatrix, *args.fShape,
-                                    std::move(args.fPaint));
+                                    std::move(args.fPaint),
+                                    fPathCache ? fPathCache->maxMaskError() : 0);
     this->recordOp(std::move(op), args);
     return true;
 }
@@ -192,6 +190,7 @@ void GrCoverageCountingPathRenderer::preFlush(GrOnFlushResourceProvider* onFlush
     SkASSERT(!fFlushing);
     SkASSERT(fFlushingPaths.empty());
     SkDEBUGCODE(fFlushing = true);
+    fLastFlushCacheStats = CacheStats();
 
     // Dig up the stashed atlas from the previous flush (if any) so we can attempt to copy any
     // reusable paths out of it and into the resource cache. We also need to clear its unique key.
@@ -240,6 +239,9 @@ void GrCoverageCountingPathRenderer::preFlush(GrOnFlushResourceProvider* onFlush
         }
     }
     fStashedAtlasKey.reset();
+    if (fPathCache) {
+        fLastFlushCacheStats.fNumInexactHits = fPathCache->takeNumInexactHits();
+    }
 
     if (specs.isEmpty()) {
         return;  // Nothing to draw.
@@ -255,8 +257,15 @@ void GrCoverageCountingPathRenderer::preFlush(GrOnFlushResourceProvider* onFlush
         specs.convertCopiesToRenders();
         SkASSERT(!specs.fNumCopiedPaths[GrCCPerFlushResourceSpecs::kFillIdx]);
         SkASSERT(!specs.fNumCopiedPaths[GrCCPerFlushResourceSpecs::kStrokeIdx]);
+        numCopies = 0;
     }
 
+    fLastFlushCacheStats.fNumCachedPaths = specs.fNumCachedPaths;
+    fLastFlushCacheStats.fNumCopiedPaths = numCopies;
+    fLastFlushCacheStats.fNumPaths = specs.fNumCachedPaths + numCopies +
+                                     specs.fNumRenderedPaths[GrCCPerFlushResourceSpecs::kFillIdx] +
+                                     specs.fNumRenderedPaths[GrCCPerFlushResourceSpecs::kStrokeIdx];
+
     auto resources = sk_make_sp<GrCCPerFlushResources>(onFlushRP, specs);
     if (!resources->isMapped()) {
         return;  // Some allocation failed.
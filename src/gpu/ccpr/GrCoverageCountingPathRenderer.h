@@ -34,7 +34,10 @@ public:
         kYes = true
     };
 
-    static sk_sp<GrCoverageCountingPathRenderer> CreateIfSupported(const GrCaps&, AllowCaching);
+    // 'cachingTolerance' is the maximum error, in device pixels, allowed when reusing a cached path
+    // mask drawn with a different matrix (see GrContextOptions::fPathMaskCachingTolerance).
+    static sk_sp<GrCoverageCountingPathRenderer> CreateIfSupported(const GrCaps&, AllowCaching,
+                                                                   float cachingTolerance = 0);
 
     using PendingPathsMap = std::map<uint32_t, sk_sp<GrCCPerOpListPaths>>;
 
@@ -67,6 +70,21 @@ public:
 
     void purgeCacheEntriesOlderThan(const GrStdSteadyClock::time_point& purgeTime);
 
+    // Describes how the paths in the most recent flush were drawn. Clip paths are not included.
+    struct CacheStats {
+        int fNumPaths = 0;
+        int fNumCachedPaths = 0;  // Drawn straight from an 8-bit atlas in the resource cache.
+        int fNumCopiedPaths = 0;  // Found in the previous flush's atlas and copied to the cache.
+        int fNumInexactHits = 0;  // Cache hits that only matched within the caching tolerance.
+
+        // Fraction of paths whose masks were reused instead of rendered.
+        float hitRate() const {
+            return fNumPaths ? (float)(fNumCachedPaths + fNumCopiedPaths) / fNumPaths : 0;
+        }
+    };
+
+    const CacheStats& lastFlushCacheStats() const { return fLastFlushCacheStats; }
+
     void testingOnly_drawPathDirectly(const DrawPathArgs&);
     const GrUniqueKey& testingOnly_getStashedAtlasKey() const;
 
@@ -84,7 +102,7 @@ public:
                                    float* inflationRadius = nullptr);
 
 private:
-    GrCoverageCountingPathRenderer(AllowCaching);
+    GrCoverageCountingPathRenderer(AllowCaching, float cachingTolerance);
 
     // GrPathRenderer overrides.
     StencilSupport onGetStencilSupport(const GrShape&) const override {
@@ -107,6 +125,7 @@ private:
 
     std::unique_ptr<GrCCPathCache> fPathCache;
     GrUniqueKey fStashedAtlasKey;
+    CacheStats fLastFlushCacheStats;
 
     SkDEBUGCODE(bool fFlushing = false);
 };
@@ -29,6 +29,7 @@ protected:
 
 private:
     UniformHandle fKernelUni;
+    UniformHandle fOffsetsUni;
     UniformHandle fImageIncrementUni;
     UniformHandle fBoundsUni;
 
@@ -40,20 +41,27 @@ void GrGLConvolutionEffect::emitCode(EmitArgs& args) {
             args.fFp.cast<GrGaussianConvolutionFragmentProcessor>();
 
     GrGLSLUniformHandler* uniformHandler = args.fUniformHandler;
-    fImageIncrementUni = uniformHandler->addUniform(kFragment_GrShaderFlag, kHalf2_GrSLType,
+    // The bilinear taps land between texels, which needs more precision than a half has.
+    fImageIncrementUni = uniformHandler->addUniform(kFragment_GrShaderFlag,
+                                                    ce.useBilerpTaps() ? kFloat2_GrSLType
+                                                                       : kHalf2_GrSLType,
                                                     "ImageIncrement");
     if (ce.useBounds()) {
         fBoundsUni = uniformHandler->addUniform(kFragment_GrShaderFlag, kHalf2_GrSLType,
                                                 "Bounds");
     }
 
-    int width = ce.width();
+    int taps = ce.numTaps();
 
-    int arrayCount = (width + 3) / 4;
-    SkASSERT(4 * arrayCount >= width);
+    int arrayCount = (taps + 3) / 4;
+    SkASSERT(4 * arrayCount >= taps);
 
     fKernelUni = uniformHandler->addUniformArray(kFragment_GrShaderFlag, kHalf4_GrSLType,
                                                  "Kernel", arrayCount);
+    if (ce.useBilerpTaps()) {
+        fOffsetsUni = uniformHandler->addUniformArray(kFragment_GrShaderFlag, kFloat4_GrSLType,
+                                                      "Offsets", arrayCount);
+    }
 
     GrGLSLFPFragmentBuilder* fragBuilder = args.fFragBuilder;
     SkString coords2D = fragBuilder->ensureCoords2D(args.fTransformedCoords[0]);
@@ -63,12 +71,35 @@ void GrGLConvolutionEffect::emitCode(EmitArgs& args) {
     const GrShaderVar& kernel = uniformHandler->getUniformVariable(fKernelUni);
     const char* imgInc = uniformHandler->getUniformCStr(fImageIncrementUni);
 
+    // Manually unroll loop because some drivers don't; yields 20-30% speedup.
+    const char* kVecSuffix[4] = {".x", ".y", ".z", ".w"};
+    if (ce.useBilerpTaps()) {
+        const GrShaderVar& offsets = uniformHandler->getUniformVariable(fOffsetsUni);
+        for (int i = 0; i < taps; i++) {
+            SkString index;
+            SkString kernelIndex;
+            SkString offsetIndex;
+            index.appendS32(i / 4);
+            kernel.appendArrayAccess(index.c_str(), &kernelIndex);
+            kernelIndex.append(kVecSuffix[i & 0x3]);
+            offsets.appendArrayAccess(index.c_str(), &offsetIndex);
+            offsetIndex.append(kVecSuffix[i & 0x3]);
+
+            SkString coord;
+            coord.printf("%s + %s * %s", coords2D.c_str(), offsetIndex.c_str(), imgInc);
+            fragBuilder->codeAppendf("%s += ", args.fOutputColor);
+            fragBuilder->appendTextureLookup(args.fTexSamplers[0], coord.c_str(),
+                                             kFloat2_GrSLType);
+            fragBuilder->codeAppendf(" * %s;\n", kernelIndex.c_str());
+        }
+        fragBuilder->codeAppendf("%s *= %s;\n", args.fOutputColor, args.fInputColor);
+        return;
+    }
+
     fragBuilder->codeAppendf("float2 coord = %s - %d.0 * %s;", coords2D.c_str(), ce.radius(), imgInc);
     fragBuilder->codeAppend("float2 coordSampled = half2(0, 0);");
 
-    // Manually unroll loop because some drivers don't; yields 20-30% speedup.
-    const char* kVecSuffix[4] = {".x", ".y", ".z", ".w"};
-    for (int i = 0; i < width; i++) {
+    for (int i = 0; i < taps; i++) {
         SkString index;
         SkString kernelIndex;
         index.appendS32(i / 4);
@@ -163,11 +194,14 @@ void GrGLConvolutionEffect::onSetData(const GrGLSLProgramDataManager& pdman,
         SkASSERT(bounds[0] <= bounds[1]);
         pdman.set2f(fBoundsUni, bounds[0], bounds[1]);
     }
-    int width = conv.width();
+    int taps = conv.numTaps();
 
-    int arrayCount = (width + 3) / 4;
-    SkASSERT(4 * arrayCount >= width);
+    int arrayCount = (taps + 3) / 4;
+    SkASSERT(4 * arrayCount >= taps);
     pdman.set4fv(fKernelUni, arrayCount, conv.kernel());
+    if (conv.useBilerpTaps()) {
+        pdman.set4fv(fOffsetsUni, arrayCount, conv.offsets());
+    }
 }
 
 void GrGLConvolutionEffect::GenKey(const GrProcessor& processor, const GrShaderCaps&,
@@ -208,6 +242,21 @@ static void fill_in_1D_gaussian_kernel(float* kernel, int width, float gaussianS
     }
 }
 
+// Folds each pair of neighboring weights (the last weight stands alone) into one tap. A bilinear
+// sample at offset i + w[i + 1] / (w[i] + w[i + 1]) from the center texel blends texels i and i + 1
+// in the ratio of their weights, so scaling it by their sum reproduces both terms.
+static void fold_kernel_into_bilerp_taps(float* kernel, float* offsets, int radius) {
+    int width = 2 * radius + 1;
+    for (int tap = 0; tap <= radius; ++tap) {
+        int i = 2 * tap;
+        float w0 = kernel[i];
+        float w1 = i + 1 < width ? kernel[i + 1] : 0.0f;
+        float sum = w0 + w1;
+        kernel[tap] = sum;
+        offsets[tap] = (i - radius) + (sum > 0 ? w1 / sum : 0.0f);
+    }
+}
+
 GrGaussianConvolutionFragmentProcessor::GrGaussianConvolutionFragmentProcessor(
                                                             sk_sp<GrTextureProxy> proxy,
                                                             Direction direction,
@@ -218,7 +267,9 @@ GrGaussianConvolutionFragmentProcessor::GrGaussianConvolutionFragmentProcessor(
         : INHERITED(kGrGaussianConvolutionFragmentProcessor_ClassID,
                     ModulateByConfigOptimizationFlags(proxy->config()))
         , fCoordTransform(proxy.get())
-        , fTextureSampler(std::move(proxy))
+        , fTextureSampler(std::move(proxy), GrTextureDomain::kIgnore_Mode == mode
+                                                    ? GrSamplerState::ClampBilerp()
+                                                    : GrSamplerState::ClampNearest())
         , fRadius(radius)
         , fDirection(direction)
         , fMode(mode) {
@@ -227,6 +278,9 @@ GrGaussianConvolutionFragmentProcessor::GrGaussianConvolutionFragmentProcessor(
     SkASSERT(radius <= kMaxKernelRadius);
 
     fill_in_1D_gaussian_kernel(fKernel, this->width(), gaussianSigma, this->radius());
+    if (this->useBilerpTaps()) {
+        fold_kernel_into_bilerp_taps(fKernel, fOffsets, this->radius());
+    }
 
     memcpy(fBounds, bounds, sizeof(fBounds));
 }
@@ -241,7 +295,10 @@ GrGaussianConvolutionFragmentProcessor::GrGaussianConvolutionFragmentProcessor(
         , fMode(that.fMode) {
     this->addCoordTransform(&fCoordTransform);
     this->setTextureSamplerCnt(1);
-    memcpy(fKernel, that.fKernel, that.width() * sizeof(float));
+    memcpy(fKernel, that.fKernel, that.numTaps() * sizeof(float));
+    if (that.useBilerpTaps()) {
+        memcpy(fOffsets, that.fOffsets, that.numTaps() * sizeof(float));
+    }
     memcpy(fBounds, that.fBounds, sizeof(fBounds));
 }
 
@@ -260,7 +317,9 @@ bool GrGaussianConvolutionFragmentProcessor::onIsEqual(const GrFragmentProcessor
     return (this->radius() == s.radius() && this->direction() == s.direction() &&
             this->mode() == s.mode() &&
             0 == memcmp(fBounds, s.fBounds, sizeof(fBounds)) &&
-            0 == memcmp(fKernel, s.fKernel, this->width() * sizeof(float)));
+            0 == memcmp(fKernel, s.fKernel, this->numTaps() * sizeof(float)) &&
+            (!this->useBilerpTaps() ||
+             0 == memcmp(fOffsets, s.fOffsets, this->numTaps() * sizeof(float))));
 }
 
 ///////////////////////////////////////////////////////////////////////////////
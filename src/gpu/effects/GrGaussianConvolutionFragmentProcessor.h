@@ -16,6 +16,10 @@
  * A 1D Gaussian convolution effect. The kernel is computed as an array of 2 * half-width weights.
  * Each texel is multiplied by it's weight and summed to determine the filtered color. The output
  * color is set to a modulation of the filtered and input colors.
+ *
+ * When no bounds are enforced, pairs of neighboring texels are read with a single bilinear tap
+ * placed between them so that the hardware blends them in the ratio of their weights. This halves
+ * the number of texture fetches.
  */
 class GrGaussianConvolutionFragmentProcessor : public GrFragmentProcessor {
 public:
@@ -33,11 +37,16 @@ public:
     }
 
     const float* kernel() const { return fKernel; }
+    // The position of each tap relative to the center texel, when useBilerpTaps() is true.
+    const float* offsets() const { return fOffsets; }
 
     const int* bounds() const { return fBounds; }
     bool useBounds() const { return fMode != GrTextureDomain::kIgnore_Mode; }
     int radius() const { return fRadius; }
     int width() const { return 2 * fRadius + 1; }
+    // Per-tap bounds checks must see exactly one texel, so we only pair texels without them.
+    bool useBilerpTaps() const { return !this->useBounds(); }
+    int numTaps() const { return this->useBilerpTaps() ? fRadius + 1 : this->width(); }
     Direction direction() const { return fDirection; }
 
     GrTextureDomain::Mode mode() const { return fMode; }
@@ -92,6 +101,7 @@ private:
     // TODO: Inline the kernel constants into the generated shader code. This may involve pulling
     // some of the logic from SkGpuBlurUtils into this class related to radius/sigma calculations.
     float                 fKernel[kMaxKernelWidth];
+    float                 fOffsets[kMaxKernelRadius + 1];
     int                   fBounds[2];
     int                   fRadius;
     Direction             fDirection;
@@ -14,8 +14,10 @@
 #include "GrTexture.h"
 #include "SkSLUtil.h"
 
-GrSkSLFPFactory::GrSkSLFPFactory(const char* name, const GrShaderCaps* shaderCaps, const char* sksl)
-        : fName(name) {
+GrSkSLFPFactory::GrSkSLFPFactory(const char* name, const GrShaderCaps* shaderCaps, const char* sksl,
+                                 SkSL::Compiler* compiler)
+        : fName(name)
+        , fCompiler(*compiler) {
     SkSL::Program::Settings settings;
     settings.fCaps = shaderCaps;
     fBaseProgram = fCompiler.convertProgram(SkSL::Program::kPipelineStage_Kind,
@@ -42,11 +44,13 @@ GrSkSLFPFactory::GrSkSLFPFactory(const char* name, const GrShaderCaps* shaderCap
     }
 }
 
-const SkSL::Program* GrSkSLFPFactory::getSpecialization(const SkSL::String& key, const void* inputs,
-                                                        size_t inputSize) {
+const GrSkSLFPFactory::Specialization* GrSkSLFPFactory::getSpecialization(
+                                                                       const SkSL::String& key,
+                                                                       const void* inputs,
+                                                                       size_t inputSize) {
     const auto& found = fSpecializations.find(key);
     if (found != fSpecializations.end()) {
-        return found->second.get();
+        return &found->second;
     }
 
     std::unordered_map<SkSL::String, SkSL::Program::Settings::Value> inputMap;
@@ -75,9 +79,13 @@ const SkSL::Program* GrSkSLFPFactory::getSpecialization(const SkSL::String& key,
 
     std::unique_ptr<SkSL::Program> specialized = fCompiler.specialize(*fBaseProgram, inputMap);
     SkAssertResult(fCompiler.optimize(*specialized));
-    const SkSL::Program* result = specialized.get();
-    fSpecializations.insert(std::make_pair(key, std::move(specialized)));
-    return result;
+    Specialization& result = fSpecializations[key];
+    if (!fCompiler.toPipelineStage(*specialized, &result.fGLSL, &result.fFormatArgs)) {
+        printf("%s\n", fCompiler.errorText().c_str());
+        SkASSERT(false);
+    }
+    result.fProgram = std::move(specialized);
+    return &result;
 }
 
 class GrGLSLSkSLFP : public GrGLSLFragmentProcessor {
@@ -274,7 +282,8 @@ void GrSkSLFP::createFactory() const {
     if (!fFactory) {
         fFactory = fFactoryCache->get(fIndex);
         if (!fFactory) {
-            fFactory = sk_sp<GrSkSLFPFactory>(new GrSkSLFPFactory(fName, fShaderCaps.get(), fSkSL));
+            fFactory = sk_sp<GrSkSLFPFactory>(new GrSkSLFPFactory(fName, fShaderCaps.get(), fSkSL,
+                                                                  fFactoryCache->compiler()));
             fFactoryCache->set(fIndex, fFactory);
         }
     }
@@ -286,19 +295,17 @@ void GrSkSLFP::addChild(std::unique_ptr<GrFragmentProcessor> child) {
 
 GrGLSLFragmentProcessor* GrSkSLFP::onCreateGLSLInstance() const {
     this->createFactory();
-    const SkSL::Program* specialized = fFactory->getSpecialization(fKey, fInputs.get(), fInputSize);
-    SkSL::String glsl;
-    std::vector<SkSL::Compiler::FormatArg> formatArgs;
-    if (!fFactory->fCompiler.toPipelineStage(*specialized, &glsl, &formatArgs)) {
-        printf("%s\n", fFactory->fCompiler.errorText().c_str());
-        SkASSERT(false);
-    }
-    return new GrGLSLSkSLFP(specialized->fContext.get(), &fFactory->fInputVars, glsl, formatArgs);
+    const GrSkSLFPFactory::Specialization* specialized =
+            fFactory->getSpecialization(fKey, fInputs.get(), fInputSize);
+    return new GrGLSLSkSLFP(specialized->fProgram->fContext.get(), &fFactory->fInputVars,
+                            specialized->fGLSL, specialized->fFormatArgs);
 }
 
 void GrSkSLFP::onGetGLSLProcessorKey(const GrShaderCaps& caps,
                                      GrProcessorKeyBuilder* b) const {
     this->createFactory();
+    // the key may be computed more than once, e.g. for each program cache lookup
+    fKey.clear();
     size_t offset = 0;
     char* inputs = (char*) fInputs.get();
     const SkSL::Context& context = fFactory->fCompiler.context();
@@ -366,6 +373,8 @@ std::unique_ptr<GrFragmentProcessor> GrSkSLFP::clone() const {
 // require GrContext to include GrSkSLFP, which creates much bigger headaches than a few manual
 // refcounts.
 
+GrSkSLFPFactoryCache::GrSkSLFPFactoryCache() {}
+
 sk_sp<GrSkSLFPFactory> GrSkSLFPFactoryCache::get(int index) {
     if (index >= (int) fFactories.size()) {
         return nullptr;
@@ -384,6 +393,13 @@ void GrSkSLFPFactoryCache::set(int index, sk_sp<GrSkSLFPFactory> factory) {
     fFactories[index] = factory.get();
 }
 
+SkSL::Compiler* GrSkSLFPFactoryCache::compiler() {
+    if (!fCompiler) {
+        fCompiler.reset(new SkSL::Compiler());
+    }
+    return fCompiler.get();
+}
+
 GrSkSLFPFactoryCache::~GrSkSLFPFactoryCache() {
     for (GrSkSLFPFactory* factory : fFactories) {
         if (factory) {
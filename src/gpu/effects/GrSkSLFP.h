@@ -135,14 +135,32 @@ public:
      * the produced shaders to differ), so it is important to reuse the same factory instance for
      * the same shader in order to avoid repeatedly re-parsing the SkSL.
      */
-    GrSkSLFPFactory(const char* name, const GrShaderCaps* shaderCaps, const char* sksl);
+    GrSkSLFPFactory(const char* name, const GrShaderCaps* shaderCaps, const char* sksl,
+                    SkSL::Compiler* compiler);
 
-    const SkSL::Program* getSpecialization(const SkSL::String& key, const void* inputs,
-                                           size_t inputSize);
+    /**
+     * A version of the program specialized for a particular set of key inputs, along with the
+     * pipeline stage code generated from it.
+     */
+    struct Specialization {
+        std::unique_ptr<const SkSL::Program> fProgram;
+        // nearly-finished GLSL; still contains printf-style "%s" format tokens
+        SkSL::String fGLSL;
+        std::vector<SkSL::Compiler::FormatArg> fFormatArgs;
+    };
+
+    /**
+     * Returns the specialization for the given key, creating and caching it on first use. Every
+     * GrSkSLFP of this factory with the same key inputs shares it, so only the first of them pays
+     * for specializing the program and generating its code.
+     */
+    const Specialization* getSpecialization(const SkSL::String& key, const void* inputs,
+                                            size_t inputSize);
 
     const char* fName;
 
-    SkSL::Compiler fCompiler;
+    // shared by every factory in the GrSkSLFPFactoryCache that owns this factory
+    SkSL::Compiler& fCompiler;
 
     std::shared_ptr<SkSL::Program> fBaseProgram;
 
@@ -150,7 +168,7 @@ public:
 
     std::vector<const SkSL::Variable*> fKeyVars;
 
-    std::unordered_map<SkSL::String, std::unique_ptr<const SkSL::Program>> fSpecializations;
+    std::unordered_map<SkSL::String, Specialization> fSpecializations;
 
     friend class GrSkSLFP;
 };
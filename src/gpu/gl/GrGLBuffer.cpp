@@ -98,7 +98,9 @@ GrGLBuffer::GrGLBuffer(GrGLGpu* gpu, size_t size, GrBufferType intendedType,
     , fBufferID(0)
     , fUsage(gr_to_gl_access_pattern(intendedType, accessPattern))
     , fGLSizeInBytes(0)
-    , fHasAttachedToTexture(false) {
+    , fHasAttachedToTexture(false)
+    // Any initial data is for the flush being recorded.
+    , fFlushSerial(gpu->currentFlushSerial()) {
     GL_CALL(GenBuffers(1, &fBufferID));
     if (fBufferID) {
         GrGLenum target = gpu->bindBuffer(fIntendedType, this);
@@ -155,6 +157,20 @@ void GrGLBuffer::onAbandon() {
     INHERITED::onAbandon();
 }
 
+bool GrGLBuffer::canRewriteInPlace() {
+    // Transfer buffers are read back or uploaded from once, and static buffers may be drawn from
+    // in many flushes after the one that wrote them, so only dynamic buffers are tracked.
+    if (GrGLCaps::kFenced_DynamicBufferStrategy != this->glCaps().dynamicBufferStrategy() ||
+        kStatic_GrAccessPattern == this->accessPattern() ||
+        kXferCpuToGpu_GrBufferType == fIntendedType ||
+        kXferGpuToCpu_GrBufferType == fIntendedType) {
+        return false;
+    }
+    bool done = this->glGpu()->flushHasCompleted(fFlushSerial);
+    fFlushSerial = this->glGpu()->currentFlushSerial();
+    return done;
+}
+
 void GrGLBuffer::onMap() {
     SkASSERT(fBufferID);
     if (this->wasDestroyed()) {
@@ -174,7 +190,8 @@ void GrGLBuffer::onMap() {
         case GrGLCaps::kMapBuffer_MapBufferType: {
             GrGLenum target = this->glGpu()->bindBuffer(fIntendedType, this);
             // Let driver know it can discard the old data
-            if (this->glCaps().useBufferDataNullHint() || fGLSizeInBytes != this->sizeInBytes()) {
+            if (this->glCaps().useBufferDataNullHint() || fGLSizeInBytes != this->sizeInBytes() ||
+                (!readOnly && kXferCpuToGpu_GrBufferType != fIntendedType)) {
                 GL_CALL(BufferData(target, this->sizeInBytes(), nullptr, fUsage));
             }
             GL_CALL_RET(fMapPtr, MapBuffer(target, readOnly ? GR_GL_READ_ONLY : GR_GL_WRITE_ONLY));
@@ -187,7 +204,10 @@ void GrGLBuffer::onMap() {
                 GL_CALL(BufferData(target, this->sizeInBytes(), nullptr, fUsage));
             }
             GrGLbitfield writeAccess = GR_GL_MAP_WRITE_BIT;
-            if (kXferCpuToGpu_GrBufferType != fIntendedType) {
+            if (this->canRewriteInPlace()) {
+                // Nothing in flight draws from the old contents, so don't wait for the GPU.
+                writeAccess |= GR_GL_MAP_UNSYNCHRONIZED_BIT;
+            } else if (kXferCpuToGpu_GrBufferType != fIntendedType) {
                 // TODO: Make this a function parameter.
                 writeAccess |= GR_GL_MAP_INVALIDATE_BUFFER_BIT;
             }
@@ -256,7 +276,10 @@ bool GrGLBuffer::onUpdateData(const void* src, size_t srcSizeInBytes) {
     // bindbuffer handles dirty context
     GrGLenum target = this->glGpu()->bindBuffer(fIntendedType, this);
 
-    if (this->glCaps().useBufferDataNullHint()) {
+    if (this->canRewriteInPlace() && fGLSizeInBytes == this->sizeInBytes()) {
+        // Nothing in flight draws from the old contents, so write over them.
+        GL_CALL(BufferSubData(target, 0, (GrGLsizeiptr) srcSizeInBytes, src));
+    } else if (this->glCaps().useBufferDataNullHint()) {
         if (this->sizeInBytes() == srcSizeInBytes) {
             GL_CALL(BufferData(target, (GrGLsizeiptr) srcSizeInBytes, src, fUsage));
         } else {
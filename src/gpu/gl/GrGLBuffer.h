@@ -51,6 +51,11 @@ private:
     void onUnmap() override;
     bool onUpdateData(const void* src, size_t srcSizeInBytes) override;
 
+    // Called before the buffer's contents are replaced for the current flush. Returns true if
+    // they needn't be orphaned: the caps say to rewrite in place, and the GPU is done with the
+    // flush that drew from the old contents.
+    bool canRewriteInPlace();
+
 #ifdef SK_DEBUG
     void validate() const;
 #endif
@@ -60,6 +65,8 @@ private:
     GrGLenum       fUsage;
     size_t         fGLSizeInBytes;
     bool           fHasAttachedToTexture;
+    // The flush whose draws read the current contents, for kFenced_DynamicBufferStrategy.
+    uint64_t       fFlushSerial;
 
     typedef GrBuffer INHERITED;
 };
@@ -29,6 +29,7 @@ GrGLCaps::GrGLCaps(const GrContextOptions& contextOptions,
     fInvalidateFBType = kNone_InvalidateFBType;
     fMapBufferType = kNone_MapBufferType;
     fTransferBufferType = kNone_TransferBufferType;
+    fDynamicBufferStrategy = kOrphan_DynamicBufferStrategy;
     fMaxFragmentUniformVectors = 0;
     fUnpackRowLengthSupport = false;
     fUnpackFlipYSupport = false;
@@ -65,6 +66,9 @@ GrGLCaps::GrGLCaps(const GrContextOptions& contextOptions,
     fDontSetBaseOrMaxLevelForExternalTextures = false;
     fProgramBinarySupport = false;
     fSamplerObjectSupport = false;
+    fTimerQuerySupport = false;
+    fDisjointTimerQuery = false;
+    fAsyncProgramLinkingSupport = false;
 
     fBlitFramebufferFlags = kNoSupport_BlitFramebufferFlag;
     fMaxInstancesPerDrawWithoutCrashing = 0;
@@ -593,12 +597,30 @@ void GrGLCaps::init(const GrContextOptions& contextOptions,
         GR_GL_GetIntegerv(gli, GR_GL_NUM_PROGRAM_BINARY_FORMATS, &count);
         fProgramBinarySupport = count > 0;
     }
+    // Linking in the background means draws are dropped until the program is ready, so this is
+    // opt-in.
+    fAsyncProgramLinkingSupport = contextOptions.fAllowAsyncProgramCompilation &&
+                                  ctxInfo.hasExtension("GL_KHR_parallel_shader_compile");
     if (kGL_GrGLStandard == standard) {
         fSamplerObjectSupport =
                 version >= GR_GL_VER(3,3) || ctxInfo.hasExtension("GL_ARB_sampler_objects");
     } else {
         fSamplerObjectSupport = version >= GR_GL_VER(3,0);
     }
+    if (kGL_GrGLStandard == standard) {
+        fTimerQuerySupport = version >= GR_GL_VER(3,3) ||
+                             ctxInfo.hasExtension("GL_ARB_timer_query") ||
+                             ctxInfo.hasExtension("GL_EXT_timer_query");
+    } else {
+        fTimerQuerySupport = fDisjointTimerQuery =
+                ctxInfo.hasExtension("GL_EXT_disjoint_timer_query");
+    }
+    // Not every client's GL bindings include the query functions.
+    const GrGLInterface::Functions& glFuncs = gli->fFunctions;
+    if (!glFuncs.fGenQueries || !glFuncs.fDeleteQueries || !glFuncs.fBeginQuery ||
+        !glFuncs.fEndQuery || !glFuncs.fGetQueryObjectui64v) {
+        fTimerQuerySupport = fDisjointTimerQuery = false;
+    }
     // Requires fTextureRedSupport, fTextureSwizzleSupport, msaa support, ES compatibility have
     // already been detected.
     this->initConfigTable(contextOptions, ctxInfo, gli, shaderCaps);
@@ -607,6 +629,25 @@ void GrGLCaps::init(const GrContextOptions& contextOptions,
         this->applyDriverCorrectnessWorkarounds(ctxInfo, contextOptions, shaderCaps);
     }
 
+    // Asynchronous readbacks glReadPixels into a PBO, then wait on a fence to map it.
+    fTransferFromSurfaceToBufferSupport = kPBO_TransferBufferType == fTransferBufferType &&
+                                          kNone_MapBufferType != fMapBufferType &&
+                                          fFenceSyncSupport;
+
+    // Rewriting buffers in place once their flush is done saves most drivers reallocating them
+    // every flush. ANGLE and the command buffer orphan cheaply but add round trips to fences, so
+    // they stick with orphaning.
+    if (kMapBufferRange_MapBufferType == fMapBufferType && fFenceSyncSupport &&
+        kANGLE_GrGLDriver != ctxInfo.driver() && kChromium_GrGLDriver != ctxInfo.driver()) {
+        fDynamicBufferStrategy = kFenced_DynamicBufferStrategy;
+    }
+
+    // Batching meshes into glMultiDrawElementsIndirect would get around the cap on instances per
+    // draw that some drivers need.
+    fMultiDrawIndexedIndirectSupport = fMultiDrawIndirectSupport &&
+                                       !fMaxInstancesPerDrawWithoutCrashing;
+    fIndirectBaseInstanceSupport = fMultiDrawIndexedIndirectSupport && fBaseInstanceSupport;
+
     this->applyOptionsOverrides(contextOptions);
     shaderCaps->applyOptionsOverrides(contextOptions);
 
@@ -1126,10 +1167,21 @@ void GrGLCaps::onDumpJSON(SkJSONWriter* writer) const {
     GR_STATIC_ASSERT(3 == kChromium_MapBufferType);
     GR_STATIC_ASSERT(SK_ARRAY_COUNT(kMapBufferTypeStr) == kLast_MapBufferType + 1);
 
+    static const char* kDynamicBufferStrategyStr[] = {
+        "Orphan",
+        "Fenced",
+    };
+    GR_STATIC_ASSERT(0 == kOrphan_DynamicBufferStrategy);
+    GR_STATIC_ASSERT(1 == kFenced_DynamicBufferStrategy);
+    GR_STATIC_ASSERT(SK_ARRAY_COUNT(kDynamicBufferStrategyStr) ==
+                     kLast_DynamicBufferStrategy + 1);
+
     writer->appendBool("Core Profile", fIsCoreProfile);
     writer->appendString("MSAA Type", kMSFBOExtStr[fMSFBOType]);
     writer->appendString("Invalidate FB Type", kInvalidateFBTypeStr[fInvalidateFBType]);
     writer->appendString("Map Buffer Type", kMapBufferTypeStr[fMapBufferType]);
+    writer->appendString("Dynamic Buffer Strategy",
+                         kDynamicBufferStrategyStr[fDynamicBufferStrategy]);
     writer->appendS32("Max FS Uniform Vectors", fMaxFragmentUniformVectors);
     writer->appendBool("Unpack Row length support", fUnpackRowLengthSupport);
     writer->appendBool("Unpack Flip Y support", fUnpackFlipYSupport);
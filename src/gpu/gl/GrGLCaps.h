@@ -103,6 +103,22 @@ public:
         kLast_TransferBufferType = kChromium_TransferBufferType,
     };
 
+    /**
+     * How dynamic vertex and index buffers are rewritten each flush, while the GPU may still be
+     * drawing from what they held in earlier ones.
+     */
+    enum DynamicBufferStrategy {
+        // Have the driver orphan the old storage on every map or update, so it can hand out new
+        // storage rather than wait for the GPU.
+        kOrphan_DynamicBufferStrategy,
+        // Fence each flush. A buffer whose last flush has finished is rewritten in place with an
+        // unsynchronized map, and only one whose flush is still in flight is orphaned. Requires
+        // glMapBufferRange and fence syncs.
+        kFenced_DynamicBufferStrategy,
+
+        kLast_DynamicBufferStrategy = kFenced_DynamicBufferStrategy,
+    };
+
     /**
      * Initializes the GrGLCaps to the set of features supported in the current
      * OpenGL context accessible via ctxInfo.
@@ -251,6 +267,9 @@ public:
     /// What type of transfer buffer is supported?
     TransferBufferType transferBufferType() const { return fTransferBufferType; }
 
+    /// How are dynamic buffers rewritten?
+    DynamicBufferStrategy dynamicBufferStrategy() const { return fDynamicBufferStrategy; }
+
     /// The maximum number of fragment uniform vectors (GLES has min. 16).
     int maxFragmentUniformVectors() const { return fMaxFragmentUniformVectors; }
 
@@ -427,8 +446,22 @@ public:
 
     bool programBinarySupport() const { return fProgramBinarySupport; }
 
+    /**
+     * Programs that miss the program cache are linked without blocking and polled with
+     * GL_COMPLETION_STATUS (KHR_parallel_shader_compile). Requires
+     * GrContextOptions::fAllowAsyncProgramCompilation.
+     */
+    bool asyncProgramLinkingSupport() const { return fAsyncProgramLinkingSupport; }
+
     bool samplerObjectSupport() const { return fSamplerObjectSupport; }
 
+    /**
+     * GL_TIME_ELAPSED queries, from GL 3.3, ARB/EXT_timer_query, or EXT_disjoint_timer_query. With
+     * the last, results are invalid whenever GL_GPU_DISJOINT is set.
+     */
+    bool timerQuerySupport() const { return fTimerQuerySupport; }
+    bool disjointTimerQuery() const { return fDisjointTimerQuery; }
+
     bool validateBackendTexture(const GrBackendTexture&, SkColorType,
                                 GrPixelConfig*) const override;
     bool validateBackendRenderTarget(const GrBackendRenderTarget&, SkColorType,
@@ -491,6 +524,7 @@ private:
     InvalidateFBType    fInvalidateFBType;
     MapBufferType       fMapBufferType;
     TransferBufferType  fTransferBufferType;
+    DynamicBufferStrategy fDynamicBufferStrategy;
 
     bool fUnpackRowLengthSupport : 1;
     bool fUnpackFlipYSupport : 1;
@@ -521,6 +555,9 @@ private:
     bool fClearTextureSupport : 1;
     bool fProgramBinarySupport : 1;
     bool fSamplerObjectSupport : 1;
+    bool fAsyncProgramLinkingSupport : 1;
+    bool fTimerQuerySupport : 1;
+    bool fDisjointTimerQuery : 1;
 
     // Driver workarounds
     bool fDoManualMipmapping : 1;
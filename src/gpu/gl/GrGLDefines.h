@@ -871,6 +871,7 @@
 #define GR_GL_ANY_SAMPLES_PASSED             0x8C2F
 #define GR_GL_TIME_ELAPSED                   0x88BF
 #define GR_GL_TIMESTAMP                      0x8E28
+#define GR_GL_GPU_DISJOINT                   0x8FBB
 #define GR_GL_PRIMITIVES_GENERATED           0x8C87
 #define GR_GL_TRANSFORM_FEEDBACK_PRIMITIVES_WRITTEN 0x8C88
 
@@ -1047,6 +1048,10 @@
 #define GR_GL_INCLUSIVE                                     0x8f10
 #define GR_GL_EXCLUSIVE                                     0x8f11
 
+/* GL_KHR_parallel_shader_compile */
+#define GR_GL_MAX_SHADER_COMPILER_THREADS                   0x91B0
+#define GR_GL_COMPLETION_STATUS                             0x91B1
+
 /* GL_ARB_sync */
 #define GR_GL_SYNC_GPU_COMMANDS_COMPLETE                    0x9117
 #define GR_GL_ALREADY_SIGNALED                              0x911A
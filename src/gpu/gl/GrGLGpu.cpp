@@ -364,6 +364,11 @@ GrGLGpu::GrGLGpu(std::unique_ptr<GrGLContext> ctx, GrContext* context)
     if (this->glCaps().samplerObjectSupport()) {
         fSamplerObjectCache.reset(new SamplerObjectCache(this));
     }
+
+    if (this->glCaps().asyncProgramLinkingSupport()) {
+        // Let the driver pick how many threads to compile and link with.
+        GL_CALL(MaxShaderCompilerThreads(0xFFFFFFFF));
+    }
 }
 
 GrGLGpu::~GrGLGpu() {
@@ -450,6 +455,9 @@ void GrGLGpu::disconnect(DisconnectType type) {
         if (fSamplerObjectCache) {
             fSamplerObjectCache->release();
         }
+        for (const FlushFence& flushFence : fFlushFences) {
+            this->deleteFence(flushFence.fFence);
+        }
     } else {
         if (fProgramCache) {
             fProgramCache->abandon();
@@ -467,6 +475,7 @@ void GrGLGpu::disconnect(DisconnectType type) {
     fTempSrcFBOID = 0;
     fTempDstFBOID = 0;
     fStencilClearFBOID = 0;
+    fFlushFences.clear();
     fCopyProgramArrayBuffer.reset();
     for (size_t i = 0; i < SK_ARRAY_COUNT(fCopyPrograms); ++i) {
         fCopyPrograms[i].fProgram = 0;
@@ -2075,6 +2084,40 @@ void GrGLGpu::clearStencil(GrRenderTarget* target, int clearValue) {
     }
 }
 
+void GrGLGpu::invalidateAttachments(GrRenderTarget* target, bool color, bool stencil) {
+    SkASSERT(target);
+    GrGLCaps::InvalidateFBType invalidateType = this->glCaps().invalidateFBType();
+    if (GrGLCaps::kNone_InvalidateFBType == invalidateType) {
+        return;
+    }
+    GrStencilAttachment* sb = target->renderTargetPriv().getStencilAttachment();
+    stencil = stencil && sb;
+    if (!color && !stencil) {
+        return;
+    }
+
+    GrGLRenderTarget* glRT = static_cast<GrGLRenderTarget*>(target);
+    this->flushRenderTargetNoColorWrites(glRT);
+
+    // The default framebuffer names its attachments differently.
+    bool isDefaultFBO = 0 == glRT->renderFBOID();
+    GrGLenum attachments[2];
+    int attachmentCount = 0;
+    if (color) {
+        attachments[attachmentCount++] = isDefaultFBO ? GR_GL_COLOR : GR_GL_COLOR_ATTACHMENT0;
+    }
+    if (stencil) {
+        attachments[attachmentCount++] = isDefaultFBO ? GR_GL_STENCIL : GR_GL_STENCIL_ATTACHMENT;
+        sb->discarded();
+    }
+    if (GrGLCaps::kInvalidate_InvalidateFBType == invalidateType) {
+        GL_CALL(InvalidateFramebuffer(GR_GL_FRAMEBUFFER, attachmentCount, attachments));
+    } else {
+        SkASSERT(GrGLCaps::kDiscard_InvalidateFBType == invalidateType);
+        GL_CALL(DiscardFramebuffer(GR_GL_FRAMEBUFFER, attachmentCount, attachments));
+    }
+}
+
 void GrGLGpu::clearStencilClip(const GrFixedClip& clip,
                                bool insideStencilMask,
                                GrRenderTarget* target, GrSurfaceOrigin origin) {
@@ -2192,6 +2235,40 @@ bool GrGLGpu::readPixelsSupported(GrSurface* surfaceForConfig, GrPixelConfig rea
 
 bool GrGLGpu::onReadPixels(GrSurface* surface, int left, int top, int width, int height,
                            GrColorType dstColorType, void* buffer, size_t rowBytes) {
+    // A pack buffer left bound (e.g. by mapping a readback buffer) would receive the pixels.
+    this->unbindXferBuffer(kXferGpuToCpu_GrBufferType);
+    return this->readOrTransferPixelsFrom(surface, left, top, width, height, dstColorType,
+                                          buffer, rowBytes);
+}
+
+bool GrGLGpu::onTransferPixelsFrom(GrSurface* surface, int left, int top, int width, int height,
+                                   GrColorType dstColorType, GrBuffer* transferBuffer,
+                                   size_t offset) {
+    SkASSERT(!transferBuffer->isMapped());
+    SkASSERT(!transferBuffer->isCPUBacked());
+    const GrGLBuffer* glBuffer = static_cast<const GrGLBuffer*>(transferBuffer);
+    this->bindBuffer(kXferGpuToCpu_GrBufferType, glBuffer);
+    // With a pack buffer bound, glReadPixels's destination pointer is an offset into the buffer.
+    // Tight rows never need the scratch copy that would write through that pointer.
+    size_t rowBytes = GrColorTypeBytesPerPixel(dstColorType) * width;
+    bool result = this->readOrTransferPixelsFrom(surface, left, top, width, height, dstColorType,
+                                                 reinterpret_cast<void*>(offset), rowBytes);
+    this->unbindXferBuffer(kXferGpuToCpu_GrBufferType);
+    return result;
+}
+
+void GrGLGpu::unbindXferBuffer(GrBufferType type) {
+    auto& bufferState = fHWBufferState[type];
+    if (!bufferState.fBufferZeroKnownBound) {
+        GL_CALL(BindBuffer(bufferState.fGLTarget, 0));
+        bufferState.fBoundBufferUniqueID.makeInvalid();
+        bufferState.fBufferZeroKnownBound = true;
+    }
+}
+
+bool GrGLGpu::readOrTransferPixelsFrom(GrSurface* surface, int left, int top, int width,
+                                       int height, GrColorType dstColorType, void* buffer,
+                                       size_t rowBytes) {
     SkASSERT(surface);
 
     GrGLRenderTarget* renderTarget = static_cast<GrGLRenderTarget*>(surface->asRenderTarget());
@@ -2549,6 +2626,24 @@ void GrGLGpu::sendIndexedInstancedMeshToGpu(GrPrimitiveType primitiveType,
     }
 }
 
+void GrGLGpu::sendIndexedIndirectMeshToGpu(GrPrimitiveType primitiveType,
+                                           const GrBuffer* indexBuffer,
+                                           const GrBuffer* vertexBuffer,
+                                           const GrBuffer* instanceBuffer,
+                                           const GrBuffer* indirectBuffer, size_t indirectOffset,
+                                           int drawCount,
+                                           GrPrimitiveRestart enablePrimitiveRestart) {
+    SkASSERT(this->caps()->multiDrawIndexedIndirectSupport());
+    SkASSERT(!indirectBuffer->isCPUBacked());
+    const GrGLenum glPrimType = gr_primitive_type_to_gl_mode(primitiveType);
+    // The commands hold the base vertices and instances.
+    this->setupGeometry(indexBuffer, vertexBuffer, 0, instanceBuffer, 0, enablePrimitiveRestart);
+    this->bindBuffer(kDrawIndirect_GrBufferType, indirectBuffer);
+    GL_CALL(MultiDrawElementsIndirect(glPrimType, GR_GL_UNSIGNED_SHORT,
+                                      reinterpret_cast<void*>(indirectOffset), drawCount, 0));
+    fStats.incNumDraws();
+}
+
 void GrGLGpu::onResolveRenderTarget(GrRenderTarget* target) {
     GrGLRenderTarget* rt = static_cast<GrGLRenderTarget*>(target);
     if (rt->needsResolve()) {
@@ -4302,6 +4397,29 @@ void GrGLGpu::onFinishFlush(bool insertedSemaphore) {
     if (insertedSemaphore) {
         GL_CALL(Flush());
     }
+    // Pick up any programs that finished linking in the background so they're ready for the
+    // next flush.
+    if (fProgramCache) {
+        fProgramCache->finishCompletedPrograms();
+    }
+    if (GrGLCaps::kFenced_DynamicBufferStrategy == this->glCaps().dynamicBufferStrategy()) {
+        if (kMaxFlushFences == (int)fFlushFences.size()) {
+            this->deleteFence(fFlushFences.front().fFence);
+            fFlushFences.pop_front();
+        }
+        fFlushFences.push_back({fCurrentFlushSerial, this->insertFence()});
+    }
+    ++fCurrentFlushSerial;
+}
+
+bool GrGLGpu::flushHasCompleted(uint64_t serial) {
+    while (serial > fCompletedFlushSerial && !fFlushFences.empty() &&
+           this->waitFence(fFlushFences.front().fFence, 0)) {
+        fCompletedFlushSerial = fFlushFences.front().fSerial;
+        this->deleteFence(fFlushFences.front().fFence);
+        fFlushFences.pop_front();
+    }
+    return serial <= fCompletedFlushSerial;
 }
 
 void GrGLGpu::submit(GrGpuCommandBuffer* buffer) {
@@ -4325,7 +4443,9 @@ GrFence SK_WARN_UNUSED_RESULT GrGLGpu::insertFence() {
 bool GrGLGpu::waitFence(GrFence fence, uint64_t timeout) {
     GrGLenum result;
     GL_CALL_RET(result, ClientWaitSync((GrGLsync)fence, GR_GL_SYNC_FLUSH_COMMANDS_BIT, timeout));
-    return (GR_GL_CONDITION_SATISFIED == result);
+    // A sync that signaled before the call reports ALREADY_SIGNALED, which polling with a zero
+    // timeout always sees.
+    return (GR_GL_CONDITION_SATISFIED == result || GR_GL_ALREADY_SIGNALED == result);
 }
 
 void GrGLGpu::deleteFence(GrFence fence) const {
@@ -4366,6 +4486,49 @@ void GrGLGpu::deleteSync(GrGLsync sync) const {
     GL_CALL(DeleteSync(sync));
 }
 
+GrTimerQuery GrGLGpu::beginTimerQuery() {
+    if (!this->glCaps().timerQuerySupport()) {
+        return 0;
+    }
+    if (this->glCaps().disjointTimerQuery()) {
+        // Reading GL_GPU_DISJOINT clears it, so we only see disjoint events after this point.
+        GrGLint disjoint;
+        GL_CALL(GetIntegerv(GR_GL_GPU_DISJOINT, &disjoint));
+    }
+    GrGLuint id = 0;
+    GL_CALL(GenQueries(1, &id));
+    if (id) {
+        GL_CALL(BeginQuery(GR_GL_TIME_ELAPSED, id));
+    }
+    return id;
+}
+
+void GrGLGpu::endTimerQuery(GrTimerQuery query) {
+    SkASSERT(query);
+    GL_CALL(EndQuery(GR_GL_TIME_ELAPSED));
+}
+
+bool GrGLGpu::getTimerQueryResult(GrTimerQuery query, uint64_t* nanos) {
+    SkASSERT(query);
+    // Asking for GL_QUERY_RESULT blocks until the query has finished.
+    GrGLuint64 result = 0;
+    GL_CALL(GetQueryObjectui64v((GrGLuint)query, GR_GL_QUERY_RESULT, &result));
+    if (this->glCaps().disjointTimerQuery()) {
+        GrGLint disjoint = 0;
+        GL_CALL(GetIntegerv(GR_GL_GPU_DISJOINT, &disjoint));
+        if (disjoint) {
+            return false;
+        }
+    }
+    *nanos = result;
+    return true;
+}
+
+void GrGLGpu::deleteTimerQuery(GrTimerQuery query) {
+    GrGLuint id = (GrGLuint)query;
+    GL_CALL(DeleteQueries(1, &id));
+}
+
 void GrGLGpu::insertEventMarker(const char* msg) {
     GL_CALL(InsertEventMarker(strlen(msg), msg));
 }
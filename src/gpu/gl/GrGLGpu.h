@@ -24,6 +24,8 @@
 #include "SkTArray.h"
 #include "SkTypes.h"
 
+#include <deque>
+
 class GrGLBuffer;
 class GrGLGpuRTCommandBuffer;
 class GrGLGpuTextureCommandBuffer;
@@ -105,6 +107,11 @@ public:
                                        const GrBuffer* instanceBuffer, int instanceCount,
                                        int baseInstance, GrPrimitiveRestart) final;
 
+    void sendIndexedIndirectMeshToGpu(GrPrimitiveType, const GrBuffer* indexBuffer,
+                                      const GrBuffer* vertexBuffer, const GrBuffer* instanceBuffer,
+                                      const GrBuffer* indirectBuffer, size_t indirectOffset,
+                                      int drawCount, GrPrimitiveRestart) final;
+
     // The GrGLGpuRTCommandBuffer does not buffer up draws before submitting them to the gpu.
     // Thus this is the implementation of the clear call for the corresponding passthrough function
     // on GrGLGpuRTCommandBuffer.
@@ -120,6 +127,11 @@ public:
 
     void clearStencil(GrRenderTarget*, int clearValue);
 
+    // Tells a tiled GPU that the render target's color and/or stencil values are no longer
+    // needed, so it needn't load them into or store them from tile memory. Does nothing if the
+    // driver can't invalidate framebuffers.
+    void invalidateAttachments(GrRenderTarget*, bool color, bool stencil);
+
     GrGpuRTCommandBuffer* getCommandBuffer(
             GrRenderTarget*, GrSurfaceOrigin, const SkRect&,
             const GrGpuRTCommandBuffer::LoadAndStoreInfo&,
@@ -159,6 +171,11 @@ public:
     bool waitFence(GrFence, uint64_t timeout) override;
     void deleteFence(GrFence) const override;
 
+    GrTimerQuery beginTimerQuery();
+    void endTimerQuery(GrTimerQuery);
+    bool getTimerQueryResult(GrTimerQuery, uint64_t* nanos) override;
+    void deleteTimerQuery(GrTimerQuery) override;
+
     sk_sp<GrSemaphore> SK_WARN_UNUSED_RESULT makeSemaphore(bool isOwned) override;
     sk_sp<GrSemaphore> wrapBackendSemaphore(const GrBackendSemaphore& semaphore,
                                             GrResourceProvider::SemaphoreWrapType wrapType,
@@ -170,6 +187,12 @@ public:
 
     void deleteSync(GrGLsync) const;
 
+    // The serial of the flush being recorded. With kFenced_DynamicBufferStrategy, a buffer notes
+    // this when it is rewritten, and may be rewritten in place once flushHasCompleted() says the
+    // GPU is done with that flush.
+    uint64_t currentFlushSerial() const { return fCurrentFlushSerial; }
+    bool flushHasCompleted(uint64_t serial);
+
     void insertEventMarker(const char*);
 
     void bindFramebuffer(GrGLenum fboTarget, GrGLuint fboid);
@@ -235,6 +258,17 @@ private:
     bool onTransferPixels(GrTexture*, int left, int top, int width, int height, GrColorType,
                           GrBuffer* transferBuffer, size_t offset, size_t rowBytes) override;
 
+    bool onTransferPixelsFrom(GrSurface*, int left, int top, int width, int height, GrColorType,
+                              GrBuffer* transferBuffer, size_t offset) override;
+
+    // Reads into client memory, or into the bound pack buffer, in which case 'buffer' is an
+    // offset into it.
+    bool readOrTransferPixelsFrom(GrSurface*, int left, int top, int width, int height,
+                                  GrColorType, void* buffer, size_t rowBytes);
+
+    // Binds buffer zero to the target of a transfer buffer type, if it isn't already.
+    void unbindXferBuffer(GrBufferType);
+
     // Before calling any variation of TexImage, TexSubImage, etc..., call this to ensure that the
     // PIXEL_UNPACK_BUFFER is unbound.
     void unbindCpuToGpuXferBuffer();
@@ -287,6 +321,10 @@ private:
 
     void onFinishFlush(bool insertedSemaphores) override;
 
+    int numPendingPrograms() const override {
+        return fProgramCache ? fProgramCache->numPendingPrograms() : 0;
+    }
+
     bool hasExtension(const char* ext) const { return fGLContext->hasExtension(ext); }
 
     bool copySurfaceAsDraw(GrSurface* dst, GrSurfaceOrigin dstOrigin,
@@ -309,10 +347,17 @@ private:
         ~ProgramCache();
 
         void abandon();
+        // Returns nullptr if the program failed to build or, when programs are linked
+        // asynchronously, if it is not ready yet.
         GrGLProgram* refProgram(GrGLGpu*, const GrPrimitiveProcessor&,
                                 const GrTextureProxy* const primProcProxies[],
                                 const GrPipeline&, bool hasPointSize);
 
+        // Creates the programs for any background links that have completed.
+        void finishCompletedPrograms();
+        // Number of programs whose link is still in progress.
+        int numPendingPrograms();
+
     private:
         // We may actually have kMaxEntries+1 shaders in the GL context because we create a new
         // shader before evicting from the cache.
@@ -640,6 +685,17 @@ private:
 
     friend class GrGLPathRendering; // For accessing setTextureUnit.
 
+    // Fences inserted at the end of recent flushes, oldest first, for
+    // kFenced_DynamicBufferStrategy. Older flushes are known to be done only once a newer one is.
+    struct FlushFence {
+        uint64_t fSerial;
+        GrFence  fFence;
+    };
+    static constexpr int kMaxFlushFences = 3;
+    std::deque<FlushFence> fFlushFences;
+    uint64_t fCurrentFlushSerial = 1;
+    uint64_t fCompletedFlushSerial = 0;
+
     typedef GrGpu INHERITED;
 };
 
@@ -11,6 +11,10 @@
 #include "GrRenderTargetPriv.h"
 
 void GrGLGpuRTCommandBuffer::begin() {
+    // The stencil values were already invalidated when the last render pass to use them ended.
+    if (GrLoadOp::kDiscard == fColorLoadAndStoreInfo.fLoadOp) {
+        fGpu->invalidateAttachments(fRenderTarget, true, false);
+    }
     if (GrLoadOp::kClear == fColorLoadAndStoreInfo.fLoadOp) {
         fGpu->clear(GrFixedClip::Disabled(), fColorLoadAndStoreInfo.fClearColor,
                     fRenderTarget, fOrigin);
@@ -23,6 +27,12 @@ void GrGLGpuRTCommandBuffer::begin() {
     }
 }
 
+void GrGLGpuRTCommandBuffer::end() {
+    fGpu->invalidateAttachments(fRenderTarget,
+                                GrStoreOp::kDiscard == fColorLoadAndStoreInfo.fStoreOp,
+                                GrStoreOp::kDiscard == fStencilLoadAndStoreInfo.fStoreOp);
+}
+
 void GrGLGpuRTCommandBuffer::set(GrRenderTarget* rt, GrSurfaceOrigin origin,
                                  const GrGpuRTCommandBuffer::LoadAndStoreInfo& colorInfo,
                                  const GrGpuRTCommandBuffer::StencilLoadAndStoreInfo& stencilInfo) {
@@ -50,7 +50,7 @@ public:
     GrGLGpuRTCommandBuffer(GrGLGpu* gpu) : fGpu(gpu) {}
 
     void begin() override;
-    void end() override {}
+    void end() override;
 
     void discard() override { }
 
@@ -58,6 +58,9 @@ public:
         fGpu->insertEventMarker(msg);
     }
 
+    GrTimerQuery beginTimerQuery() override { return fGpu->beginTimerQuery(); }
+    void endTimerQuery(GrTimerQuery query) override { fGpu->endTimerQuery(query); }
+
     void inlineUpload(GrOpFlushState* state, GrDeferredTextureUploadFn& upload) override {
         state->doUpload(upload);
     }
@@ -24,8 +24,19 @@ typedef GrGLSLProgramDataManager::UniformHandle UniformHandle;
 
 struct GrGLGpu::ProgramCache::Entry {
     Entry(sk_sp<GrGLProgram> program) : fProgram(std::move(program)) {}
+    Entry(std::unique_ptr<GrGLProgramBuilder> builder) : fPendingBuilder(std::move(builder)) {}
+
+    // Turns a pending entry into a finished one. fProgram stays null if linking failed, in which
+    // case the entry remembers the failure so we don't try to build the program again.
+    void finish() {
+        SkASSERT(fPendingBuilder);
+        fProgram.reset(fPendingBuilder->finishProgram());
+        fPendingBuilder.reset();
+    }
 
     sk_sp<GrGLProgram> fProgram;
+    // Non-null while the program's link is still in progress.
+    std::unique_ptr<GrGLProgramBuilder> fPendingBuilder;
 };
 
 GrGLGpu::ProgramCache::ProgramCache(GrGLGpu* gpu)
@@ -63,11 +74,34 @@ void GrGLGpu::ProgramCache::abandon() {
 #endif
 
     fMap.foreach([](std::unique_ptr<Entry>* e) {
-        (*e)->fProgram->abandon();
+        if ((*e)->fProgram) {
+            (*e)->fProgram->abandon();
+        }
+        if ((*e)->fPendingBuilder) {
+            (*e)->fPendingBuilder->abandon();
+        }
     });
     fMap.reset();
 }
 
+void GrGLGpu::ProgramCache::finishCompletedPrograms() {
+    fMap.foreach([](std::unique_ptr<Entry>* e) {
+        if ((*e)->fPendingBuilder && (*e)->fPendingBuilder->isLinkComplete()) {
+            (*e)->finish();
+        }
+    });
+}
+
+int GrGLGpu::ProgramCache::numPendingPrograms() {
+    int count = 0;
+    fMap.foreach([&count](std::unique_ptr<Entry>* e) {
+        if ((*e)->fPendingBuilder) {
+            ++count;
+        }
+    });
+    return count;
+}
+
 GrGLProgram* GrGLGpu::ProgramCache::refProgram(GrGLGpu* gpu,
                                                const GrPrimitiveProcessor& primProc,
                                                const GrTextureProxy* const primProcProxies[],
@@ -97,13 +131,34 @@ GrGLProgram* GrGLGpu::ProgramCache::refProgram(GrGLGpu* gpu,
 #ifdef PROGRAM_CACHE_STATS
         ++fCacheMisses;
 #endif
-        GrGLProgram* program = GrGLProgramBuilder::CreateProgram(primProc, primProcProxies,
-                                                                 pipeline, &desc, fGpu);
-        if (nullptr == program) {
-            return nullptr;
+        if (gpu->glCaps().asyncProgramLinkingSupport()) {
+            std::unique_ptr<GrGLProgramBuilder> builder = GrGLProgramBuilder::StartProgram(
+                    primProc, primProcProxies, pipeline, &desc, fGpu);
+            if (!builder) {
+                return nullptr;
+            }
+            entry = fMap.insert(desc, std::unique_ptr<Entry>(new Entry(std::move(builder))));
+        } else {
+            GrGLProgram* program = GrGLProgramBuilder::CreateProgram(primProc, primProcProxies,
+                                                                     pipeline, &desc, fGpu);
+            if (nullptr == program) {
+                return nullptr;
+            }
+            entry = fMap.insert(desc,
+                                std::unique_ptr<Entry>(new Entry(sk_sp<GrGLProgram>(program))));
         }
-        entry = fMap.insert(desc, std::unique_ptr<Entry>(new Entry(sk_sp<GrGLProgram>(program))));
     }
 
+    if ((*entry)->fPendingBuilder) {
+        if (!(*entry)->fPendingBuilder->isLinkComplete()) {
+            // Still linking in the background, the caller will skip the draw.
+            gpu->stats()->incNumDrawsSkippedForPendingPrograms();
+            return nullptr;
+        }
+        (*entry)->finish();
+    }
+    if (!(*entry)->fProgram) {
+        return nullptr;
+    }
     return SkRef((*entry)->fProgram.get());
 }
@@ -581,6 +581,12 @@ bool GrGLInterface::validate() const {
         }
     }
 
+    if (fExtensions.has("GL_KHR_parallel_shader_compile")) {
+        if (!fFunctions.fMaxShaderCompilerThreads) {
+            RETURN_FALSE_INTERFACE;
+        }
+    }
+
     if ((kGL_GrGLStandard == fStandard && glVer >= GR_GL_VER(4,0)) ||
         fExtensions.has("GL_ARB_sample_shading")) {
         if (!fFunctions.fMinSampleShading) {
@@ -14,6 +14,7 @@
 #include "glsl/GrGLSLProgramDataManager.h"
 
 #include "SkTArray.h"
+#include "SkTemplates.h"
 
 class GrGLGpu;
 class SkMatrix;
@@ -86,6 +87,11 @@ private:
 
     struct Uniform {
         GrGLint     fLocation;
+        // This uniform's last uploaded values are at fShadowOffset in fShadowValues, one 32-bit
+        // word per component. fShadowCount of them hold values, out of fShadowCapacity.
+        int         fShadowOffset;
+        int         fShadowCapacity;
+        mutable int fShadowCount;
 #ifdef SK_DEBUG
         GrSLType    fType;
         int         fArrayCount;
@@ -106,7 +112,13 @@ private:
     template<int N> inline void setMatrices(UniformHandle, int arrayCount,
                                             const float matrices[]) const;
 
+    // The program keeps its uniform values between draws, so uploads that match the uniform's
+    // last values are redundant. Returns false for those, otherwise records the new values and
+    // returns true.
+    bool updateShadow(const Uniform&, const void* values, int count) const;
+
     SkTArray<Uniform, true> fUniforms;
+    SkAutoTMalloc<uint32_t> fShadowValues;
     SkTArray<PathProcVarying, true> fPathProcVaryings;
     GrGLGpu* fGpu;
     GrGLuint fProgramID;
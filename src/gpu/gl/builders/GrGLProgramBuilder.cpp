@@ -34,6 +34,20 @@ GrGLProgram* GrGLProgramBuilder::CreateProgram(const GrPrimitiveProcessor& primP
                                                const GrPipeline& pipeline,
                                                GrProgramDesc* desc,
                                                GrGLGpu* gpu) {
+    std::unique_ptr<GrGLProgramBuilder> builder = StartProgram(primProc, primProcProxies, pipeline,
+                                                               desc, gpu);
+    if (!builder) {
+        return nullptr;
+    }
+    return builder->finishProgram();
+}
+
+std::unique_ptr<GrGLProgramBuilder> GrGLProgramBuilder::StartProgram(
+        const GrPrimitiveProcessor& primProc,
+        const GrTextureProxy* const primProcProxies[],
+        const GrPipeline& pipeline,
+        GrProgramDesc* desc,
+        GrGLGpu* gpu) {
     SkASSERT(!pipeline.isBad());
 
     ATRACE_ANDROID_FRAMEWORK("Shader Compile");
@@ -41,20 +55,21 @@ GrGLProgram* GrGLProgramBuilder::CreateProgram(const GrPrimitiveProcessor& primP
 
     // create a builder.  This will be handed off to effects so they can use it to add
     // uniforms, varyings, textures, etc
-    GrGLProgramBuilder builder(gpu, pipeline, primProc, primProcProxies, desc);
+    std::unique_ptr<GrGLProgramBuilder> builder(
+            new GrGLProgramBuilder(gpu, pipeline, primProc, primProcProxies, desc));
 
     auto persistentCache = gpu->getContext()->contextPriv().getPersistentCache();
     if (persistentCache && gpu->glCaps().programBinarySupport()) {
         sk_sp<SkData> key = SkData::MakeWithoutCopy(desc->asKey(), desc->keyLength());
-        builder.fCached = persistentCache->load(*key);
+        builder->fCached = persistentCache->load(*key);
         // the eventual end goal is to completely skip emitAndInstallProcs on a cache hit, but it's
         // doing necessary setup in addition to generating the SkSL code. Currently we are only able
         // to skip the SkSL->GLSL step on a cache hit.
     }
-    if (!builder.emitAndInstallProcs()) {
+    if (!builder->emitAndInstallProcs() || !builder->startLink()) {
         return nullptr;
     }
-    return builder.finalize();
+    return builder;
 }
 
 /////////////////////////////////////////////////////////////////////////////
@@ -71,7 +86,22 @@ GrGLProgramBuilder::GrGLProgramBuilder(GrGLGpu* gpu,
         , fVertexAttributeCnt(0)
         , fInstanceAttributeCnt(0)
         , fVertexStride(0)
-        , fInstanceStride(0) {}
+        , fInstanceStride(0)
+        , fProgramID(0)
+        , fLinkPending(false)
+        , fLinkedFromBinary(false)
+        , fWillUseGeoShader(false) {}
+
+GrGLProgramBuilder::~GrGLProgramBuilder() {
+    if (fProgramID) {
+        this->cleanupProgram(fProgramID, fShadersToDelete);
+    }
+}
+
+void GrGLProgramBuilder::abandon() {
+    fProgramID = 0;
+    fShadersToDelete.reset();
+}
 
 const GrCaps* GrGLProgramBuilder::caps() const {
     return fGpu->caps();
@@ -169,14 +199,14 @@ void GrGLProgramBuilder::addInputVars(const SkSL::Program::Inputs& inputs) {
     }
 }
 
-GrGLProgram* GrGLProgramBuilder::finalize() {
+bool GrGLProgramBuilder::startLink() {
     TRACE_EVENT0("skia", TRACE_FUNC);
 
     // verify we can get a program id
     GrGLuint programID;
     GL_CALL_RET(programID, CreateProgram());
     if (0 == programID) {
-        return nullptr;
+        return false;
     }
 
     if (this->gpu()->glCaps().programBinarySupport() &&
@@ -188,14 +218,15 @@ GrGLProgram* GrGLProgramBuilder::finalize() {
 
     // compile shaders and bind attributes / uniforms
     const GrPrimitiveProcessor& primProc = this->primitiveProcessor();
-    SkSL::Program::Settings settings;
+    SkSL::Program::Settings& settings = fSettings;
     settings.fCaps = this->gpu()->glCaps().shaderCaps();
     settings.fFlipY = this->pipeline().proxy()->origin() != kTopLeft_GrSurfaceOrigin;
     settings.fSharpenTextures = this->gpu()->getContext()->contextPriv().sharpenMipmappedTextures();
     settings.fFragColorIsInOut = this->fragColorIsInOut();
 
-    SkSL::Program::Inputs inputs;
-    SkTDArray<GrGLuint> shadersToDelete;
+    SkSL::Program::Inputs& inputs = fInputs;
+    SkTDArray<GrGLuint>& shadersToDelete = fShadersToDelete;
+    fWillUseGeoShader = primProc.willUseGeoShader();
     bool cached = fGpu->glCaps().programBinarySupport() && nullptr != fCached.get();
     if (cached) {
         this->bindProgramResourceLocations(programID);
@@ -236,7 +267,7 @@ GrGLProgram* GrGLProgramBuilder::finalize() {
                                                          &glsl);
         if (!fs) {
             this->cleanupProgram(programID, shadersToDelete);
-            return nullptr;
+            return false;
         }
         inputs = fs->fInputs;
         this->addInputVars(inputs);
@@ -244,7 +275,7 @@ GrGLProgram* GrGLProgramBuilder::finalize() {
                                            GR_GL_FRAGMENT_SHADER, &shadersToDelete, settings,
                                            inputs)) {
             this->cleanupProgram(programID, shadersToDelete);
-            return nullptr;
+            return false;
         }
 
         std::unique_ptr<SkSL::Program> vs = GrSkSLtoGLSL(gpu()->glContext(),
@@ -258,7 +289,7 @@ GrGLProgram* GrGLProgramBuilder::finalize() {
                                                   GR_GL_VERTEX_SHADER, &shadersToDelete, settings,
                                                   inputs)) {
             this->cleanupProgram(programID, shadersToDelete);
-            return nullptr;
+            return false;
         }
 
         // NVPR actually requires a vertex shader to compile
@@ -267,7 +298,7 @@ GrGLProgram* GrGLProgramBuilder::finalize() {
             this->computeCountsAndStrides(programID, primProc, true);
         }
 
-        if (primProc.willUseGeoShader()) {
+        if (fWillUseGeoShader) {
             std::unique_ptr<SkSL::Program> gs;
             gs = GrSkSLtoGLSL(gpu()->glContext(),
                               GR_GL_GEOMETRY_SHADER,
@@ -280,13 +311,42 @@ GrGLProgram* GrGLProgramBuilder::finalize() {
                                                       GR_GL_GEOMETRY_SHADER, &shadersToDelete,
                                                       settings, inputs)) {
                 this->cleanupProgram(programID, shadersToDelete);
-                return nullptr;
+                return false;
             }
         }
         this->bindProgramResourceLocations(programID);
 
         GL_CALL(LinkProgram(programID));
+        fLinkPending = true;
+    }
+    fProgramID = programID;
+    fLinkedFromBinary = cached;
+    // The desc is final at this point (compileAndAttachShaders may have set the origin key). Keep
+    // our own copy of the key since the desc may not outlive the builder.
+    fPersistentCacheKey = SkData::MakeWithCopy(this->desc()->asKey(), this->desc()->keyLength());
+    return true;
+}
+
+bool GrGLProgramBuilder::isLinkComplete() const {
+    if (!fLinkPending || !fGpu->glCaps().asyncProgramLinkingSupport()) {
+        return true;
     }
+    GrGLint complete = GR_GL_INIT_ZERO;
+    GL_CALL(GetProgramiv(fProgramID, GR_GL_COMPLETION_STATUS, &complete));
+    return SkToBool(complete);
+}
+
+GrGLProgram* GrGLProgramBuilder::finishProgram() {
+    TRACE_EVENT0("skia", TRACE_FUNC);
+    SkASSERT(fProgramID);
+
+    // Release ownership of the GL objects so only the program we create, if any, holds them.
+    GrGLuint programID = fProgramID;
+    SkTDArray<GrGLuint> shadersToDelete;
+    shadersToDelete.swap(fShadersToDelete);
+    fProgramID = 0;
+    fLinkPending = false;
+
     // Calling GetProgramiv is expensive in Chromium. Assume success in release builds.
     bool checkLinked = kChromium_GrGLDriver != fGpu->ctxInfo().driver();
 #ifdef SK_DEBUG
@@ -297,43 +357,43 @@ GrGLProgram* GrGLProgramBuilder::finalize() {
             SkDebugf("VS:\n");
             GrGLPrintShader(fGpu->glContext(), GR_GL_VERTEX_SHADER, fVS.fCompilerStrings.begin(),
                             fVS.fCompilerStringLengths.begin(), fVS.fCompilerStrings.count(),
-                            settings);
-            if (primProc.willUseGeoShader()) {
+                            fSettings);
+            if (fWillUseGeoShader) {
                 SkDebugf("\nGS:\n");
                 GrGLPrintShader(fGpu->glContext(), GR_GL_GEOMETRY_SHADER,
                                 fGS.fCompilerStrings.begin(), fGS.fCompilerStringLengths.begin(),
-                                fGS.fCompilerStrings.count(), settings);
+                                fGS.fCompilerStrings.count(), fSettings);
             }
             SkDebugf("\nFS:\n");
             GrGLPrintShader(fGpu->glContext(), GR_GL_FRAGMENT_SHADER, fFS.fCompilerStrings.begin(),
                             fFS.fCompilerStringLengths.begin(), fFS.fCompilerStrings.count(),
-                            settings);
+                            fSettings);
+            this->cleanupShaders(shadersToDelete);
             return nullptr;
         }
     }
     this->resolveProgramResourceLocations(programID);
 
     this->cleanupShaders(shadersToDelete);
-    if (!cached && this->gpu()->getContext()->contextPriv().getPersistentCache() &&
+    if (!fLinkedFromBinary && this->gpu()->getContext()->contextPriv().getPersistentCache() &&
         fGpu->glCaps().programBinarySupport()) {
         GrGLsizei length = 0;
         GL_CALL(GetProgramiv(programID, GL_PROGRAM_BINARY_LENGTH, &length));
         if (length > 0) {
             // store shader in cache
-            sk_sp<SkData> key = SkData::MakeWithoutCopy(desc()->asKey(), desc()->keyLength());
             GrGLenum binaryFormat;
             std::unique_ptr<char[]> binary(new char[length]);
             GL_CALL(GetProgramBinary(programID, length, &length, &binaryFormat, binary.get()));
-            size_t dataLength = sizeof(inputs) + sizeof(binaryFormat) + length;
+            size_t dataLength = sizeof(fInputs) + sizeof(binaryFormat) + length;
             std::unique_ptr<uint8_t[]> data(new uint8_t[dataLength]);
             size_t offset = 0;
-            memcpy(data.get() + offset, &inputs, sizeof(inputs));
-            offset += sizeof(inputs);
+            memcpy(data.get() + offset, &fInputs, sizeof(fInputs));
+            offset += sizeof(fInputs);
             memcpy(data.get() + offset, &binaryFormat, sizeof(binaryFormat));
             offset += sizeof(binaryFormat);
             memcpy(data.get() + offset, binary.get(), length);
             this->gpu()->getContext()->contextPriv().getPersistentCache()->store(
-                                            *key, *SkData::MakeWithoutCopy(data.get(), dataLength));
+                             *fPersistentCacheKey, *SkData::MakeWithoutCopy(data.get(), dataLength));
         }
     }
     return this->createProgram(programID);
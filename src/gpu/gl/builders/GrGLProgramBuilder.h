@@ -41,6 +41,33 @@ public:
                                       GrProgramDesc*,
                                       GrGLGpu*);
 
+    /**
+     * Does everything CreateProgram() does up to and including issuing the link. When
+     * GrGLCaps::asyncProgramLinkingSupport() is true the link may still be in progress when this
+     * returns; poll isLinkComplete() and call finishProgram() once it returns true. The returned
+     * builder does not refer to the processors, pipeline or desc after this returns, so it may
+     * outlive them. Returns nullptr on failure.
+     */
+    static std::unique_ptr<GrGLProgramBuilder> StartProgram(const GrPrimitiveProcessor&,
+                                                            const GrTextureProxy* const[],
+                                                            const GrPipeline&,
+                                                            GrProgramDesc*,
+                                                            GrGLGpu*);
+
+    ~GrGLProgramBuilder() override;
+
+    /** Returns true if finishProgram() can be called without waiting on the driver. */
+    bool isLinkComplete() const;
+
+    /**
+     * Checks the link status and creates the GrGLProgram. Returns nullptr if linking failed. This
+     * must only be called once.
+     */
+    GrGLProgram* finishProgram();
+
+    /** Drops the GL objects owned by the builder without deleting them. */
+    void abandon();
+
     const GrCaps* caps() const override;
 
     GrGLGpu* gpu() const { return fGpu; }
@@ -66,7 +93,7 @@ private:
                                  SkSL::Program::Inputs* outInputs);
     void computeCountsAndStrides(GrGLuint programID, const GrPrimitiveProcessor& primProc,
                                  bool bindAttribLocations);
-    GrGLProgram* finalize();
+    bool startLink();
     void bindProgramResourceLocations(GrGLuint programID);
     bool checkLinkStatus(GrGLuint programID);
     void resolveProgramResourceLocations(GrGLuint programID);
@@ -96,6 +123,16 @@ private:
     // (all remaining bytes) char[] binary
     sk_sp<SkData> fCached;
 
+    // State carried from startLink() to finishProgram().
+    GrGLuint                fProgramID;
+    SkTDArray<GrGLuint>     fShadersToDelete;
+    SkSL::Program::Settings fSettings;
+    SkSL::Program::Inputs   fInputs;
+    sk_sp<SkData>           fPersistentCacheKey;
+    bool                    fLinkPending;
+    bool                    fLinkedFromBinary;
+    bool                    fWillUseGeoShader;
+
     typedef GrGLSLProgramBuilder INHERITED;
 };
 #endif
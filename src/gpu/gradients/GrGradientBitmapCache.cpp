@@ -11,6 +11,7 @@
 #include "SkMalloc.h"
 #include "SkFloatBits.h"
 #include "SkHalf.h"
+#include "SkOpts.h"
 #include "SkTemplates.h"
 
 #include <functional>
@@ -131,12 +132,13 @@ void GrGradientBitmapCache::fillGradient(const SkPMColor4f* colors, const SkScal
 
     typedef std::function<void(const Sk4f&, int)> pixelWriteFn_t;
 
+    // F16 pixels are interpolated as floats, then converted to halfs all at once.
+    SkAutoTMalloc<float> pixelsF32;
+    if (colorType == kRGBA_F16_SkColorType) {
+        pixelsF32.reset(4 * fResolution);
+    }
     pixelWriteFn_t writeF16Pixel = [&](const Sk4f& x, int index) {
-        Sk4h c = SkFloatToHalf_finite_ftz(x);
-        pixelsF16[4*index+0] = c[0];
-        pixelsF16[4*index+1] = c[1];
-        pixelsF16[4*index+2] = c[2];
-        pixelsF16[4*index+3] = c[3];
+        x.store(pixelsF32.get() + 4*index);
     };
     pixelWriteFn_t write8888Pixel = [&](const Sk4f& c, int index) {
         pixels32[index] = Sk4f_toL32(c);
@@ -168,6 +170,10 @@ void GrGradientBitmapCache::fillGradient(const SkPMColor4f* colors, const SkScal
         prevIndex = nextIndex;
     }
     SkASSERT(prevIndex == fResolution - 1);
+
+    if (colorType == kRGBA_F16_SkColorType) {
+        SkOpts::float_to_half(pixelsF16, pixelsF32.get(), 4 * fResolution);
+    }
 }
 
 void GrGradientBitmapCache::getGradient(const SkPMColor4f* colors, const SkScalar* positions,
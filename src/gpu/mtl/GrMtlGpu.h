@@ -159,7 +159,12 @@ private:
         return false;
     }
 
-    bool onRegenerateMipMapLevels(GrTexture*) override { return false; }
+    bool onTransferPixelsFrom(GrSurface*, int left, int top, int width, int height, GrColorType,
+                              GrBuffer*, size_t offset) override {
+        return false;
+    }
+
+    bool onRegenerateMipMapLevels(GrTexture*) override;
 
     void onResolveRenderTarget(GrRenderTarget* target) override { return; }
 
@@ -216,6 +216,22 @@ bool GrMtlGpu::uploadToTexture(GrMtlTexture* tex, int left, int top, int width,
     return true;
 }
 
+bool GrMtlGpu::onRegenerateMipMapLevels(GrTexture* texture) {
+    // Metal can only generate the levels of color renderable, filterable formats.
+    if (!this->caps()->isConfigRenderable(texture->config())) {
+        return false;
+    }
+
+    // This builds every level in a single command, letting the driver pick how to do it on the
+    // GPU (rather than us blitting or drawing level by level). It filters sRGB formats in linear
+    // space.
+    id<MTLTexture> mtlTexture = static_cast<GrMtlTexture*>(texture)->mtlTexture();
+    id<MTLBlitCommandEncoder> blitCmdEncoder = [fCmdBuffer blitCommandEncoder];
+    [blitCmdEncoder generateMipmapsForTexture: mtlTexture];
+    [blitCmdEncoder endEncoding];
+    return true;
+}
+
 GrStencilAttachment* GrMtlGpu::createStencilAttachmentForRenderTarget(const GrRenderTarget* rt,
                                                                       int width,
                                                                       int height) {
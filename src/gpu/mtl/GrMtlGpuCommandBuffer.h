@@ -119,6 +119,13 @@ private:
                                        const GrBuffer* instanceBuffer, int instanceCount,
                                        int baseInstance, GrPrimitiveRestart) final;
 
+    void sendIndexedIndirectMeshToGpu(GrPrimitiveType, const GrBuffer*, const GrBuffer*,
+                                      const GrBuffer*, const GrBuffer*, size_t, int,
+                                      GrPrimitiveRestart) final {
+        // GrMtlCaps doesn't support multi-draw indirect.
+        SK_ABORT("Indirect meshes not supported in Metal backend.");
+    }
+
     GrMtlGpu*                                     fGpu;
     // GrRenderTargetProxy bounds
 #ifdef SK_DEBUG
@@ -13,6 +13,7 @@
 #include "GrMtlPipelineStateBuilder.h"
 #include "GrMtlRenderTarget.h"
 #include "GrRenderTargetPriv.h"
+#include "GrTexturePriv.h"
 
 GrMtlGpuRTCommandBuffer::GrMtlGpuRTCommandBuffer(
         GrMtlGpu* gpu, GrRenderTarget* rt, GrSurfaceOrigin origin, const SkRect& bounds,
@@ -57,14 +58,9 @@ GrMtlGpuRTCommandBuffer::GrMtlGpuRTCommandBuffer(
             fRenderPassDesc.stencilAttachment.loadAction = MTLLoadActionDontCare;
             break;
     }
-    switch (stencilInfo.fStoreOp) {
-        case GrStoreOp::kStore:
-            fRenderPassDesc.stencilAttachment.storeAction = MTLStoreActionStore;
-            break;
-        case GrStoreOp::kDiscard:
-            fRenderPassDesc.stencilAttachment.storeAction = MTLStoreActionDontCare;
-            break;
-    }
+    // Each draw is encoded as its own render pass, and we don't know which will be the last, so
+    // the stencil values are always stored for the next one.
+    fRenderPassDesc.stencilAttachment.storeAction = MTLStoreActionStore;
 }
 
 GrMtlGpuRTCommandBuffer::~GrMtlGpuRTCommandBuffer() {
@@ -78,6 +74,14 @@ void GrMtlGpuRTCommandBuffer::internalBegin() {
                     renderCommandEncoderWithDescriptor: fRenderPassDesc];
     SkASSERT(fActiveRenderCmdEncoder);
     [fActiveRenderCmdEncoder setFrontFacingWinding: MTLWindingCounterClockwise];
+    // Only the first render pass may skip loading what's already in the attachments; the later
+    // ones continue its work.
+    if (MTLLoadActionDontCare == fRenderPassDesc.colorAttachments[0].loadAction) {
+        fRenderPassDesc.colorAttachments[0].loadAction = MTLLoadActionLoad;
+    }
+    if (MTLLoadActionDontCare == fRenderPassDesc.stencilAttachment.loadAction) {
+        fRenderPassDesc.stencilAttachment.loadAction = MTLLoadActionLoad;
+    }
 }
 
 void GrMtlGpuRTCommandBuffer::internalEnd() {
@@ -110,7 +114,7 @@ GrMtlPipelineState* GrMtlGpuRTCommandBuffer::prepareDrawState(
         const GrPipeline::FixedDynamicState* fixedDynamicState,
         const GrMesh meshes[],
         int meshCount) {
-    // TODO: resolve textures and regenerate mipmaps as needed
+    // TODO: resolve textures as needed
     bool hasPoints = false;
     for (int i = 0; i < meshCount; ++i) {
         if (meshes[i].primitiveType() == GrPrimitiveType::kPoints) {
@@ -130,6 +134,27 @@ GrMtlPipelineState* GrMtlGpuRTCommandBuffer::prepareDrawState(
     }
     SkASSERT(SkToBool(primProcProxies) == SkToBool(primProc.numTextureSamplers()));
 
+    // Mip levels are regenerated with a blit encoder, so this must happen before the draw's
+    // render encoder begins.
+    auto genLevelsIfNeeded = [this](GrTexture* tex, const GrSamplerState& sampler) {
+        if (sampler.filter() == GrSamplerState::Filter::kMipMap &&
+            tex->texturePriv().mipMapped() == GrMipMapped::kYes &&
+            tex->texturePriv().mipMapsAreDirty()) {
+            fGpu->regenerateMipMapLevels(tex);
+        }
+    };
+    for (int i = 0; i < primProc.numTextureSamplers(); ++i) {
+        genLevelsIfNeeded(primProcProxies[i]->peekTexture(),
+                          primProc.textureSampler(i).samplerState());
+    }
+    GrFragmentProcessor::Iter iter(pipeline);
+    while (const GrFragmentProcessor* fp = iter.next()) {
+        for (int i = 0; i < fp->numTextureSamplers(); ++i) {
+            const auto& textureSampler = fp->textureSampler(i);
+            genLevelsIfNeeded(textureSampler.peekTexture(), textureSampler.samplerState());
+        }
+    }
+
     // TODO: use resource provider for pipeline
     GrMtlPipelineState* pipelineState =
             GrMtlPipelineStateBuilder::CreatePipelineState(primProc, primProcProxies, pipeline,
@@ -19,6 +19,7 @@
 
 class GrMtlGpu;
 class GrMtlPipelineState;
+class SkData;
 
 class GrMtlPipelineStateBuilder : public GrGLSLProgramBuilder {
 public:
@@ -49,7 +50,19 @@ private:
     id<MTLLibrary> createMtlShaderLibrary(const GrGLSLShaderBuilder& builder,
                                           SkSL::Program::Kind kind,
                                           const SkSL::Program::Settings& settings,
-                                          GrProgramDesc* desc);
+                                          GrProgramDesc* desc,
+                                          SkSL::String* outMSL,
+                                          SkSL::Program::Inputs* outInputs);
+
+    void handleShaderInputs(const SkSL::Program::Inputs& inputs, GrProgramDesc* desc);
+
+    // Compiles the vertex and fragment MSL stored in the PersistentCache into outLibraries.
+    // Returns false, leaving desc untouched, if the cached data can't be used.
+    bool loadShadersFromCache(const SkData& cached, __strong id<MTLLibrary> outLibraries[2],
+                              GrProgramDesc* desc);
+
+    void storeShadersInCache(const SkData& key, const SkSL::String msl[2],
+                             const SkSL::Program::Inputs inputs[2]);
 
     GrMtlPipelineState* finalize(const GrPrimitiveProcessor&, const GrPipeline&, GrProgramDesc*);
 
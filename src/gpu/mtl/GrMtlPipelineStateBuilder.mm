@@ -13,6 +13,8 @@
 #include "GrMtlGpu.h"
 #include "GrMtlPipelineState.h"
 #include "GrMtlUtil.h"
+#include "SkReader32.h"
+#include "SkWriter32.h"
 
 #import <simd/simd.h>
 
@@ -57,7 +59,9 @@ id<MTLLibrary> GrMtlPipelineStateBuilder::createMtlShaderLibrary(
         const GrGLSLShaderBuilder& builder,
         SkSL::Program::Kind kind,
         const SkSL::Program::Settings& settings,
-        GrProgramDesc* desc) {
+        GrProgramDesc* desc,
+        SkSL::String* outMSL,
+        SkSL::Program::Inputs* outInputs) {
     SkString shaderString;
     for (int i = 0; i < builder.fCompilerStrings.count(); ++i) {
         if (builder.fCompilerStrings[i]) {
@@ -66,12 +70,19 @@ id<MTLLibrary> GrMtlPipelineStateBuilder::createMtlShaderLibrary(
         }
     }
 
-    SkSL::Program::Inputs inputs;
-    id<MTLLibrary> shaderLibrary = GrCompileMtlShaderLibrary(fGpu, shaderString.c_str(),
-                                                             kind, settings, &inputs);
+    if (!GrSkSLToMSL(fGpu, shaderString.c_str(), kind, settings, outMSL, outInputs)) {
+        return nil;
+    }
+    id<MTLLibrary> shaderLibrary = GrCompileMtlShaderLibrary(fGpu, *outMSL);
     if (shaderLibrary == nil) {
         return nil;
     }
+    this->handleShaderInputs(*outInputs, desc);
+    return shaderLibrary;
+}
+
+void GrMtlPipelineStateBuilder::handleShaderInputs(const SkSL::Program::Inputs& inputs,
+                                                   GrProgramDesc* desc) {
     if (inputs.fRTHeight) {
         this->addRTHeightUniform(SKSL_RTHEIGHT_NAME);
     }
@@ -80,7 +91,63 @@ id<MTLLibrary> GrMtlPipelineStateBuilder::createMtlShaderLibrary(
                                                                this->pipeline().proxy()->origin()));
         desc->finalize();
     }
-    return shaderLibrary;
+}
+
+// The MSL stored in the PersistentCache is, for the vertex and then the fragment stage: the
+// SkSL::Program::Inputs, and the length of the MSL followed by the MSL itself. Caching the MSL
+// skips the SkSL compiler; Metal still compiles the MSL, but its own shader cache usually makes
+// that quick on later launches.
+static constexpr uint32_t kShaderCacheVersion = 1;
+static constexpr int kShaderStageCount = 2;
+
+bool GrMtlPipelineStateBuilder::loadShadersFromCache(const SkData& cached,
+                                                     __strong id<MTLLibrary> outLibraries[2],
+                                                     GrProgramDesc* desc) {
+    if (!SkIsAlign4(cached.size())) {
+        return false;
+    }
+    SkReader32 reader(cached.data(), cached.size());
+    if (!reader.isAvailable(2 * sizeof(uint32_t)) || reader.readU32() != kShaderCacheVersion ||
+        reader.readInt() != kShaderStageCount) {
+        return false;
+    }
+
+    SkSL::Program::Inputs inputs[kShaderStageCount];
+    for (int i = 0; i < kShaderStageCount; ++i) {
+        if (!reader.isAvailable(SkAlign4(sizeof(SkSL::Program::Inputs)) + sizeof(uint32_t))) {
+            return false;
+        }
+        reader.read(&inputs[i], sizeof(SkSL::Program::Inputs));
+        size_t mslSize = reader.readU32();
+        if (!reader.isAvailable(SkAlign4(mslSize))) {
+            return false;
+        }
+        SkSL::String msl((const char*)reader.skip(mslSize), mslSize);
+        outLibraries[i] = GrCompileMtlShaderLibrary(fGpu, msl);
+        if (outLibraries[i] == nil) {
+            return false;
+        }
+    }
+
+    for (int i = 0; i < kShaderStageCount; ++i) {
+        this->handleShaderInputs(inputs[i], desc);
+    }
+    return true;
+}
+
+void GrMtlPipelineStateBuilder::storeShadersInCache(const SkData& key,
+                                                    const SkSL::String msl[2],
+                                                    const SkSL::Program::Inputs inputs[2]) {
+    SkWriter32 writer;
+    writer.write32(kShaderCacheVersion);
+    writer.write32(kShaderStageCount);
+    for (int i = 0; i < kShaderStageCount; ++i) {
+        writer.writePad(&inputs[i], sizeof(SkSL::Program::Inputs));
+        writer.write32(SkToS32(msl[i].size()));
+        writer.writePad(msl[i].c_str(), msl[i].size());
+    }
+    auto persistentCache = fGpu->getContext()->contextPriv().getPersistentCache();
+    persistentCache->store(key, *writer.snapshotAsData());
 }
 
 static inline MTLVertexFormat attribute_type_to_mtlformat(GrVertexAttribType type) {
@@ -321,16 +388,39 @@ GrMtlPipelineState* GrMtlPipelineStateBuilder::finalize(const GrPrimitiveProcess
     settings.fSharpenTextures = fGpu->getContext()->contextPriv().sharpenMipmappedTextures();
     SkASSERT(!this->fragColorIsInOut());
 
-    id<MTLLibrary> vertexLibrary = nil;
-    id<MTLLibrary> fragmentLibrary = nil;
-    vertexLibrary = this->createMtlShaderLibrary(fVS,
-                                                 SkSL::Program::kVertex_Kind,
-                                                 settings,
-                                                 desc);
-    fragmentLibrary = this->createMtlShaderLibrary(fFS,
-                                                   SkSL::Program::kFragment_Kind,
-                                                   settings,
-                                                   desc);
+    // The key is copied, since compiling the shaders can change the surface origin in desc.
+    auto persistentCache = fGpu->getContext()->contextPriv().getPersistentCache();
+    sk_sp<SkData> key;
+    id<MTLLibrary> libraries[kShaderStageCount] = { nil, nil };
+    bool loadedFromCache = false;
+    if (persistentCache) {
+        key = SkData::MakeWithCopy(desc->asKey(), desc->keyLength());
+        if (sk_sp<SkData> cached = persistentCache->load(*key)) {
+            loadedFromCache = this->loadShadersFromCache(*cached, libraries, desc);
+        }
+    }
+
+    if (!loadedFromCache) {
+        SkSL::String msl[kShaderStageCount];
+        SkSL::Program::Inputs inputs[kShaderStageCount];
+        libraries[0] = this->createMtlShaderLibrary(fVS,
+                                                    SkSL::Program::kVertex_Kind,
+                                                    settings,
+                                                    desc,
+                                                    &msl[0],
+                                                    &inputs[0]);
+        libraries[1] = this->createMtlShaderLibrary(fFS,
+                                                    SkSL::Program::kFragment_Kind,
+                                                    settings,
+                                                    desc,
+                                                    &msl[1],
+                                                    &inputs[1]);
+        if (persistentCache && libraries[0] && libraries[1]) {
+            this->storeShadersInCache(*key, msl, inputs);
+        }
+    }
+    id<MTLLibrary> vertexLibrary = libraries[0];
+    id<MTLLibrary> fragmentLibrary = libraries[1];
     SkASSERT(!this->primitiveProcessor().willUseGeoShader());
 
     SkASSERT(vertexLibrary);
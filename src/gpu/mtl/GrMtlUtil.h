@@ -57,6 +57,21 @@ id<MTLLibrary> GrCompileMtlShaderLibrary(const GrMtlGpu* gpu,
                                          const SkSL::Program::Settings& settings,
                                          SkSL::Program::Inputs* outInputs);
 
+/**
+ * Translates SkSL to MSL with SkSLC, without compiling the MSL. Returns false on failure.
+ */
+bool GrSkSLToMSL(const GrMtlGpu* gpu,
+                 const char* shaderString,
+                 SkSL::Program::Kind kind,
+                 const SkSL::Program::Settings& settings,
+                 SkSL::String* outMSL,
+                 SkSL::Program::Inputs* outInputs);
+
+/**
+ * Returns a compiled MTLLibrary created from MSL code, e.g. as returned by GrSkSLToMSL
+ */
+id<MTLLibrary> GrCompileMtlShaderLibrary(const GrMtlGpu* gpu, const SkSL::String& msl);
+
 /**
  * Returns a MTLTexture corresponding to the GrSurface. Optionally can do a resolve.
  */
@@ -13,19 +13,39 @@
 #include "ops/GrDashOp.h"
 #include "ops/GrMeshDrawOp.h"
 
+static GrDashOp::AAMode dash_aa_mode(GrAAType aaType) {
+    switch (aaType) {
+        case GrAAType::kNone:
+            break;
+        case GrAAType::kCoverage:
+        case GrAAType::kMixedSamples:
+            return GrDashOp::AAMode::kCoverage;
+        case GrAAType::kMSAA:
+            // In this mode we will use aa between dashes but the outer border uses MSAA. Otherwise,
+            // we can wind up with external edges antialiased and internal edges unantialiased.
+            return GrDashOp::AAMode::kCoverageWithMSAA;
+    }
+    return GrDashOp::AAMode::kNone;
+}
+
 GrPathRenderer::CanDrawPath
 GrDashLinePathRenderer::onCanDrawPath(const CanDrawPathArgs& args) const {
+    if (!args.fShape->style().isDashed() || args.fAAType == GrAAType::kMixedSamples) {
+        return CanDrawPath::kNo;
+    }
     SkPoint pts[2];
     bool inverted;
-    if (args.fShape->style().isDashed() && args.fShape->asLine(pts, &inverted)) {
-        if (args.fAAType == GrAAType::kMixedSamples) {
-            return CanDrawPath::kNo;
-        }
+    if (args.fShape->asLine(pts, &inverted)) {
         // We should never have an inverse dashed case.
         SkASSERT(!inverted);
-        if (!GrDashOp::CanDrawDashLine(pts, args.fShape->style(), *args.fViewMatrix)) {
-            return CanDrawPath::kNo;
+        if (GrDashOp::CanDrawDashLine(pts, args.fShape->style(), *args.fViewMatrix)) {
+            return CanDrawPath::kYes;
         }
+    }
+    SkPath path;
+    args.fShape->asPath(&path);
+    if (GrDashOp::CanDrawDashPath(path, args.fShape->style(), *args.fViewMatrix,
+                                  dash_aa_mode(args.fAAType))) {
         return CanDrawPath::kYes;
     }
     return CanDrawPath::kNo;
@@ -34,25 +54,20 @@ GrDashLinePathRenderer::onCanDrawPath(const CanDrawPathArgs& args) const {
 bool GrDashLinePathRenderer::onDrawPath(const DrawPathArgs& args) {
     GR_AUDIT_TRAIL_AUTO_FRAME(args.fRenderTargetContext->auditTrail(),
                               "GrDashLinePathRenderer::onDrawPath");
-    GrDashOp::AAMode aaMode = GrDashOp::AAMode::kNone;
-    switch (args.fAAType) {
-        case GrAAType::kNone:
-            break;
-        case GrAAType::kCoverage:
-        case GrAAType::kMixedSamples:
-            aaMode = GrDashOp::AAMode::kCoverage;
-            break;
-        case GrAAType::kMSAA:
-            // In this mode we will use aa between dashes but the outer border uses MSAA. Otherwise,
-            // we can wind up with external edges antialiased and internal edges unantialiased.
-            aaMode = GrDashOp::AAMode::kCoverageWithMSAA;
-            break;
-    }
+    GrDashOp::AAMode aaMode = dash_aa_mode(args.fAAType);
+    const GrStyle& style = args.fShape->style();
+    std::unique_ptr<GrDrawOp> op;
     SkPoint pts[2];
-    SkAssertResult(args.fShape->asLine(pts, nullptr));
-    std::unique_ptr<GrDrawOp> op =
-            GrDashOp::MakeDashLineOp(args.fContext, std::move(args.fPaint), *args.fViewMatrix, pts,
-                                     aaMode, args.fShape->style(), args.fUserStencilSettings);
+    if (args.fShape->asLine(pts, nullptr) &&
+        GrDashOp::CanDrawDashLine(pts, style, *args.fViewMatrix)) {
+        op = GrDashOp::MakeDashLineOp(args.fContext, std::move(args.fPaint), *args.fViewMatrix,
+                                      pts, aaMode, style, args.fUserStencilSettings);
+    } else {
+        SkPath path;
+        args.fShape->asPath(&path);
+        op = GrDashOp::MakeDashPathOp(args.fContext, std::move(args.fPaint), *args.fViewMatrix,
+                                      path, aaMode, style, args.fUserStencilSettings);
+    }
     if (!op) {
         return false;
     }
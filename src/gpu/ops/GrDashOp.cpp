@@ -16,10 +16,12 @@
 #include "GrGeometryProcessor.h"
 #include "GrMemoryPool.h"
 #include "GrOpFlushState.h"
+#include "GrPathUtils.h"
 #include "GrProcessor.h"
 #include "GrQuad.h"
 #include "GrStyle.h"
 #include "GrVertexWriter.h"
+#include "SkGeometry.h"
 #include "SkGr.h"
 #include "SkMatrixPriv.h"
 #include "SkPointPriv.h"
@@ -749,6 +751,523 @@ std::unique_ptr<GrDrawOp> GrDashOp::MakeDashLineOp(GrContext* context,
 
 //////////////////////////////////////////////////////////////////////////////
 
+// The most we let the seam between two flattened segments stray from the join the CPU stroker
+// would have drawn there, in device pixels.
+static const SkScalar kDashPathJoinTolerance = 0.25f;
+// We give up on curves that need more segments than this to turn gently enough.
+static const int kMaxDashCurveSegments = 1 << 10;
+
+#ifndef GR_DASH_PATH_MAX_SEGMENTS
+    #define GR_DASH_PATH_MAX_SEGMENTS (1 << 14)
+#endif
+
+struct DashContour {
+    int  fStart;
+    int  fCount;
+    bool fClosed;
+};
+
+// The device space half stroke width DashingLineEffect is given for a style, or 0 if the path
+// dash can't draw it.
+static SkScalar dash_path_half_dev_stroke(const GrStyle& style, const SkMatrix& viewMatrix,
+                                          AAMode aaMode) {
+    // Arc length has to scale the same in every direction for the dash to be measured on the
+    // device space polyline.
+    if (!viewMatrix.isSimilarity()) {
+        return 0;
+    }
+    SkScalar strokeWidth = style.strokeRec().getWidth() * viewMatrix.getMaxScale();
+    if ((strokeWidth < 1.f && aaMode != AAMode::kNone) || 0.f == strokeWidth) {
+        strokeWidth = 1.f;
+    }
+    return SkScalarHalf(strokeWidth);
+}
+
+// Appends the points of a curve flattened into segments that each turn at most
+// acos(maxTurnCos) from the one before. The curve's first point is assumed to already be in pts.
+template <typename EvalProc>
+static bool flatten_dash_curve(int segments, SkScalar maxTurnCos, EvalProc eval,
+                               SkTDArray<SkPoint>* pts) {
+    SkSTArray<32, SkPoint, true> curve;
+    for (segments = SkTPin(segments, 1, kMaxDashCurveSegments); ; segments *= 2) {
+        curve.reset();
+        curve.push_back(eval(0));
+        SkVector prevDir = {0, 0};
+        bool smooth = true;
+        for (int i = 1; i <= segments && smooth; ++i) {
+            SkPoint pt = eval(SkScalar(i) / segments);
+            SkVector dir = pt - curve.back();
+            if (!dir.normalize()) {
+                continue;
+            }
+            smooth = prevDir.isZero() || SkPoint::DotProduct(prevDir, dir) >= maxTurnCos;
+            prevDir = dir;
+            curve.push_back(pt);
+        }
+        if (smooth) {
+            break;
+        }
+        if (segments >= kMaxDashCurveSegments) {
+            return false;
+        }
+    }
+    for (int i = 1; i < curve.count(); ++i) {
+        if (curve[i] != pts->top()) {
+            pts->push_back(curve[i]);
+        }
+    }
+    return true;
+}
+
+// Checks that the quads of a contour's segments can abut along mitered seams: each join has to
+// stay within the join tolerance, and the seams at either end of a segment can't cross on the
+// inside of a turn.
+static bool check_dash_contour(const SkPoint* pts, int count, bool closed, SkScalar maxTurnCos,
+                               SkScalar outerHalfStroke) {
+    SkScalar prevTan = 0;
+    SkVector prevDir = pts[1] - pts[0];
+    prevDir.normalize();
+    if (closed) {
+        SkVector lastDir = pts[count - 1] - pts[count - 2];
+        lastDir.normalize();
+        SkScalar cos = SkPoint::DotProduct(lastDir, prevDir);
+        if (cos < maxTurnCos) {
+            return false;
+        }
+        prevTan = SkScalarSqrt((1 - cos) / (1 + cos));
+    }
+    for (int i = 1; i < count; ++i) {
+        SkScalar length = SkPoint::Distance(pts[i - 1], pts[i]);
+        SkScalar tan = 0;
+        SkVector dir = prevDir;
+        if (i + 1 < count) {
+            dir = pts[i + 1] - pts[i];
+            dir.normalize();
+        } else if (closed) {
+            dir = pts[1] - pts[0];
+            dir.normalize();
+        }
+        SkScalar cos = SkPoint::DotProduct(prevDir, dir);
+        if (cos < maxTurnCos) {
+            return false;
+        }
+        tan = SkScalarSqrt((1 - cos) / (1 + cos));
+        if (outerHalfStroke * (prevTan + tan) >= length) {
+            return false;
+        }
+        prevTan = tan;
+        prevDir = dir;
+    }
+    return true;
+}
+
+// Flattens a device space path into polylines the dash path op can draw, or returns false.
+static bool flatten_dash_path(const SkPath& devPath, SkScalar halfDevStroke, AAMode aaMode,
+                              SkTDArray<SkPoint>* pts, SkTDArray<DashContour>* contours) {
+    // The widest turn whose mitered seam stays within the tolerance of the stroker's join.
+    SkScalar maxTurnCos = SkScalarCos(2 * SkScalarATan2(kDashPathJoinTolerance, halfDevStroke));
+    SkScalar outerHalfStroke = halfDevStroke + (AAMode::kCoverage == aaMode ? 0.5f : 0.f);
+    SkScalar tol = GrPathUtils::kDefaultTolerance;
+
+    int start = -1;
+    auto endContour = [&](bool closed) {
+        if (start < 0) {
+            return true;
+        }
+        int count = pts->count() - start;
+        if (count < 2) {
+            pts->setCount(start);
+        } else if (!check_dash_contour(pts->begin() + start, count, closed, maxTurnCos,
+                                       outerHalfStroke)) {
+            return false;
+        } else {
+            contours->push_back({start, count, closed});
+        }
+        start = -1;
+        return pts->count() <= GR_DASH_PATH_MAX_SEGMENTS;
+    };
+
+    SkPath::Iter iter(devPath, false);
+    SkPoint p[4];
+    SkPath::Verb verb;
+    while ((verb = iter.next(p)) != SkPath::kDone_Verb) {
+        bool ok = true;
+        switch (verb) {
+            case SkPath::kMove_Verb:
+                ok = endContour(false);
+                start = pts->count();
+                pts->push_back(p[0]);
+                break;
+            case SkPath::kLine_Verb:
+                if (p[1] != pts->top()) {
+                    pts->push_back(p[1]);
+                }
+                break;
+            case SkPath::kQuad_Verb:
+                ok = flatten_dash_curve(GrPathUtils::quadraticPointCount(p, tol) - 1, maxTurnCos,
+                                        [&p](SkScalar t) { return SkEvalQuadAt(p, t); }, pts);
+                break;
+            case SkPath::kConic_Verb: {
+                SkConic conic(p, iter.conicWeight());
+                ok = flatten_dash_curve(2 << conic.computeQuadPOW2(tol), maxTurnCos,
+                                        [&conic](SkScalar t) { return conic.evalAt(t); }, pts);
+                break;
+            }
+            case SkPath::kCubic_Verb:
+                ok = flatten_dash_curve(GrPathUtils::cubicPointCount(p, tol) - 1, maxTurnCos,
+                                        [&p](SkScalar t) {
+                                            SkPoint pt;
+                                            SkEvalCubicAt(p, t, &pt, nullptr, nullptr);
+                                            return pt;
+                                        }, pts);
+                break;
+            case SkPath::kClose_Verb:
+                ok = endContour(true);
+                break;
+            case SkPath::kDone_Verb:
+                break;
+        }
+        if (!ok) {
+            return false;
+        }
+    }
+    return endContour(false);
+}
+
+bool GrDashOp::CanDrawDashPath(const SkPath& path, const GrStyle& style,
+                               const SkMatrix& viewMatrix, AAMode aaMode) {
+    if (!style.isDashed() || 2 != style.dashIntervalCnt() || path.isInverseFillType()) {
+        return false;
+    }
+    const SkStrokeRec& rec = style.strokeRec();
+    if (SkStrokeRec::kStroke_Style != rec.getStyle() &&
+        SkStrokeRec::kHairline_Style != rec.getStyle()) {
+        return false;
+    }
+    // Round caps would need the circle effect to know where along the path each dash ends.
+    SkPaint::Cap cap = rec.getCap();
+    if (SkPaint::kRound_Cap == cap || (SkPaint::kSquare_Cap == cap && 0 == rec.getWidth())) {
+        return false;
+    }
+    const SkScalar* intervals = style.dashIntervals();
+    if (intervals[0] <= 0) {
+        return false;
+    }
+    SkScalar halfDevStroke = dash_path_half_dev_stroke(style, viewMatrix, aaMode);
+    if (!halfDevStroke) {
+        return false;
+    }
+    if (SkPaint::kSquare_Cap == cap &&
+        intervals[1] * viewMatrix.getMaxScale() <= 2 * halfDevStroke) {
+        return false;
+    }
+    if (path.countPoints() > GR_DASH_PATH_MAX_SEGMENTS) {
+        return false;
+    }
+
+    SkPath devPath;
+    path.transform(viewMatrix, &devPath);
+    SkTDArray<SkPoint> pts;
+    SkTDArray<DashContour> contours;
+    return flatten_dash_path(devPath, halfDevStroke, aaMode, &pts, &contours);
+}
+
+/**
+ * Draws a dashed path of any shape by flattening it in device space and drawing one quad per
+ * segment with DashingLineEffect. Each quad's dash position runs along the path's arc length
+ * and across its stroke, so the fragment shader cuts the dashes out of the whole stroke. The
+ * quads of a contour share mitered seams, which is why the path has to turn gently everywhere.
+ */
+class DashPathOp final : public GrMeshDrawOp {
+public:
+    DEFINE_OP_CLASS_ID
+
+    struct PathData {
+        SkTDArray<SkPoint> fPts;
+        SkTDArray<DashContour> fContours;
+        SkScalar fDevIntervals[2];
+        SkScalar fDevPhase;
+        SkScalar fHalfDevStroke;
+        bool fSquareCap;
+    };
+
+    static std::unique_ptr<GrDrawOp> Make(GrContext* context,
+                                          GrPaint&& paint,
+                                          PathData&& path,
+                                          const SkMatrix& viewMatrix,
+                                          AAMode aaMode,
+                                          const GrUserStencilSettings* stencilSettings) {
+        GrOpMemoryPool* pool = context->contextPriv().opMemoryPool();
+
+        return pool->allocate<DashPathOp>(std::move(paint), std::move(path), viewMatrix, aaMode,
+                                          stencilSettings);
+    }
+
+    const char* name() const override { return "DashPathOp"; }
+
+    void visitProxies(const VisitProxyFunc& func, VisitorType) const override {
+        fProcessorSet.visitProxies(func);
+    }
+
+#ifdef SK_DEBUG
+    SkString dumpInfo() const override {
+        SkString string;
+        for (const auto& path : fPaths) {
+            string.appendf("Points: %d, Contours: %d, HalfStroke: %.2f, Ival0: %.2f, "
+                           "Ival1 : %.2f, Phase: %.2f\n",
+                           path.fPts.count(), path.fContours.count(), path.fHalfDevStroke,
+                           path.fDevIntervals[0], path.fDevIntervals[1], path.fDevPhase);
+        }
+        string += fProcessorSet.dumpProcessors();
+        string += INHERITED::dumpInfo();
+        return string;
+    }
+#endif
+
+    FixedFunctionFlags fixedFunctionFlags() const override {
+        FixedFunctionFlags flags = FixedFunctionFlags::kNone;
+        if (AAMode::kCoverageWithMSAA == fAAMode) {
+            flags |= FixedFunctionFlags::kUsesHWAA;
+        }
+        if (fStencilSettings != &GrUserStencilSettings::kUnused) {
+            flags |= FixedFunctionFlags::kUsesStencil;
+        }
+        return flags;
+    }
+
+    RequiresDstTexture finalize(const GrCaps& caps, const GrAppliedClip* clip) override {
+        GrProcessorAnalysisCoverage coverage;
+        if (AAMode::kNone == fAAMode && !clip->numClipCoverageFragmentProcessors()) {
+            coverage = GrProcessorAnalysisCoverage::kNone;
+        } else {
+            coverage = GrProcessorAnalysisCoverage::kSingleChannel;
+        }
+        auto analysis = fProcessorSet.finalize(fColor, coverage, clip, false, caps, &fColor);
+        fDisallowCombineOnTouchOrOverlap = analysis.requiresDstTexture() ||
+                                           (fProcessorSet.xferProcessor() &&
+                                            fProcessorSet.xferProcessor()->xferBarrierType(caps));
+        fUsesLocalCoords = analysis.usesLocalCoords();
+        return analysis.requiresDstTexture() ? RequiresDstTexture::kYes : RequiresDstTexture::kNo;
+    }
+
+private:
+    friend class GrOpMemoryPool; // for ctor
+
+    DashPathOp(GrPaint&& paint, PathData&& path, const SkMatrix& viewMatrix, AAMode aaMode,
+               const GrUserStencilSettings* stencilSettings)
+            : INHERITED(ClassID())
+            , fViewMatrix(viewMatrix)
+            , fColor(paint.getColor4f())
+            , fAAMode(aaMode)
+            , fProcessorSet(std::move(paint))
+            , fStencilSettings(stencilSettings) {
+        SkRect bounds;
+        bounds.setBounds(path.fPts.begin(), path.fPts.count());
+        SkScalar outset = this->outerHalfStroke(path) + this->endExtension(path);
+        bounds.outset(outset, outset);
+        fPaths.push_back(std::move(path));
+        this->setBounds(bounds, HasAABloat::kNo, IsZeroArea::kNo);
+    }
+
+    SkScalar bloat() const { return AAMode::kCoverage == fAAMode ? 0.5f : 0.f; }
+
+    SkScalar outerHalfStroke(const PathData& path) const {
+        return path.fHalfDevStroke + this->bloat();
+    }
+
+    // How far the quads reach past the ends of an open contour.
+    SkScalar endExtension(const PathData& path) const {
+        return this->bloat() + (path.fSquareCap ? path.fHalfDevStroke : 0);
+    }
+
+    void onPrepareDraws(Target* target) override {
+        sk_sp<GrGeometryProcessor> gp = make_dash_gp(fColor, fAAMode, kNonRound_DashCap,
+                                                     fViewMatrix, fUsesLocalCoords);
+        if (!gp) {
+            SkDebugf("Could not create GrGeometryProcessor\n");
+            return;
+        }
+
+        int segmentCount = 0;
+        for (const PathData& path : fPaths) {
+            for (const DashContour& contour : path.fContours) {
+                segmentCount += contour.fCount - 1;
+            }
+        }
+        if (!segmentCount) {
+            return;
+        }
+
+        QuadHelper helper(target, gp->vertexStride(), segmentCount);
+        GrVertexWriter vertices{ helper.vertices() };
+        if (!vertices.fPtr) {
+            return;
+        }
+
+        SkSTArray<64, SkVector, true> offsets;
+        SkSTArray<64, SkScalar, true> dashPos;
+        for (const PathData& path : fPaths) {
+            SkScalar onInterval = path.fDevIntervals[0];
+            SkScalar offInterval = path.fDevIntervals[1];
+            SkScalar capExtension = path.fSquareCap ? path.fHalfDevStroke : 0;
+            if (path.fSquareCap) {
+                // add cap to on interval and remove from off interval
+                onInterval += 2 * capExtension;
+                offInterval -= 2 * capExtension;
+            }
+            SkScalar intervalLength = onInterval + offInterval;
+            SkScalar halfOffLen = SkScalarHalf(offInterval);
+            SkRect rectParam;
+            rectParam.set(halfOffLen              + 0.5f, -path.fHalfDevStroke + 0.5f,
+                          halfOffLen + onInterval - 0.5f,  path.fHalfDevStroke - 0.5f);
+            SkScalar outerHalfStroke = this->outerHalfStroke(path);
+            SkScalar endExtension = this->endExtension(path);
+
+            for (const DashContour& contour : path.fContours) {
+                const SkPoint* pts = path.fPts.begin() + contour.fStart;
+                int count = contour.fCount;
+
+                // The seam at each point bisects the turn there, and its ends lie a half stroke
+                // from both segments.
+                offsets.reset(count);
+                dashPos.reset(count);
+                SkScalar pos = halfOffLen + path.fDevPhase + capExtension;
+                for (int i = 0; i < count; ++i) {
+                    SkVector inDir, outDir;
+                    if (i > 0) {
+                        inDir = pts[i] - pts[i - 1];
+                    } else {
+                        inDir = contour.fClosed ? pts[count - 1] - pts[count - 2] : pts[1] - pts[0];
+                    }
+                    if (i + 1 < count) {
+                        outDir = pts[i + 1] - pts[i];
+                    } else {
+                        outDir = contour.fClosed ? pts[1] - pts[0] : pts[i] - pts[i - 1];
+                    }
+                    inDir.normalize();
+                    outDir.normalize();
+                    SkVector miter = {-(inDir.fY + outDir.fY), inDir.fX + outDir.fX};
+                    miter.scale(2 * outerHalfStroke / SkPointPriv::LengthSqd(miter));
+                    offsets[i] = miter;
+                    if (i > 0) {
+                        pos += SkPoint::Distance(pts[i - 1], pts[i]);
+                    }
+                    dashPos[i] = pos;
+                }
+
+                for (int i = 0; i + 1 < count; ++i) {
+                    SkPoint start = pts[i];
+                    SkPoint end = pts[i + 1];
+                    // Keep the dash positions small, since the effect reads them at half
+                    // precision. Both ends of a quad have to move by the same amount.
+                    SkScalar base = dashPos[i] - SkScalarMod(dashPos[i], intervalLength);
+                    SkScalar startPos = dashPos[i] - base;
+                    SkScalar endPos = dashPos[i + 1] - base;
+                    if (!contour.fClosed) {
+                        SkVector dir = end - start;
+                        dir.setLength(endExtension);
+                        if (0 == i) {
+                            start -= dir;
+                            startPos -= endExtension;
+                        }
+                        if (i + 2 == count) {
+                            end += dir;
+                            endPos += endExtension;
+                        }
+                    }
+                    vertices.write(start - offsets[i], startPos, -outerHalfStroke,
+                                   intervalLength, rectParam);
+                    vertices.write(start + offsets[i], startPos, outerHalfStroke,
+                                   intervalLength, rectParam);
+                    vertices.write(end - offsets[i + 1], endPos, -outerHalfStroke,
+                                   intervalLength, rectParam);
+                    vertices.write(end + offsets[i + 1], endPos, outerHalfStroke,
+                                   intervalLength, rectParam);
+                }
+            }
+        }
+
+        uint32_t pipelineFlags = 0;
+        if (AAMode::kCoverageWithMSAA == fAAMode) {
+            pipelineFlags |= GrPipeline::kHWAntialias_Flag;
+        }
+        auto pipe = target->makePipeline(pipelineFlags, std::move(fProcessorSet),
+                                         target->detachAppliedClip());
+        helper.recordDraw(target, std::move(gp), pipe.fPipeline, pipe.fFixedDynamicState);
+    }
+
+    CombineResult onCombineIfPossible(GrOp* t, const GrCaps& caps) override {
+        DashPathOp* that = t->cast<DashPathOp>();
+        if (fProcessorSet != that->fProcessorSet) {
+            return CombineResult::kCannotCombine;
+        }
+        if (fDisallowCombineOnTouchOrOverlap &&
+            GrRectsTouchOrOverlap(this->bounds(), that->bounds())) {
+            return CombineResult::kCannotCombine;
+        }
+
+        if (fAAMode != that->fAAMode) {
+            return CombineResult::kCannotCombine;
+        }
+
+        // TODO vertex color
+        if (fColor != that->fColor) {
+            return CombineResult::kCannotCombine;
+        }
+
+        if (fUsesLocalCoords && !fViewMatrix.cheapEqualTo(that->fViewMatrix)) {
+            return CombineResult::kCannotCombine;
+        }
+
+        for (PathData& path : that->fPaths) {
+            fPaths.push_back(std::move(path));
+        }
+        return CombineResult::kMerged;
+    }
+
+    SkSTArray<1, PathData> fPaths;
+    SkMatrix fViewMatrix;
+    SkPMColor4f fColor;
+    bool fDisallowCombineOnTouchOrOverlap : 1;
+    bool fUsesLocalCoords : 1;
+    AAMode fAAMode;
+    GrProcessorSet fProcessorSet;
+    const GrUserStencilSettings* fStencilSettings;
+
+    typedef GrMeshDrawOp INHERITED;
+};
+
+std::unique_ptr<GrDrawOp> GrDashOp::MakeDashPathOp(GrContext* context,
+                                                   GrPaint&& paint,
+                                                   const SkMatrix& viewMatrix,
+                                                   const SkPath& path,
+                                                   AAMode aaMode,
+                                                   const GrStyle& style,
+                                                   const GrUserStencilSettings* stencilSettings) {
+    SkASSERT(GrDashOp::CanDrawDashPath(path, style, viewMatrix, aaMode));
+    const SkScalar* intervals = style.dashIntervals();
+    SkScalar scale = viewMatrix.getMaxScale();
+
+    DashPathOp::PathData pathData;
+    pathData.fHalfDevStroke = dash_path_half_dev_stroke(style, viewMatrix, aaMode);
+    pathData.fDevIntervals[0] = intervals[0] * scale;
+    pathData.fDevIntervals[1] = intervals[1] * scale;
+    pathData.fDevPhase = style.dashPhase() * scale;
+    pathData.fSquareCap = SkPaint::kSquare_Cap == style.strokeRec().getCap();
+
+    SkPath devPath;
+    path.transform(viewMatrix, &devPath);
+    if (!flatten_dash_path(devPath, pathData.fHalfDevStroke, aaMode, &pathData.fPts,
+                           &pathData.fContours)) {
+        return nullptr;
+    }
+
+    return DashPathOp::Make(context, std::move(paint), std::move(pathData), viewMatrix, aaMode,
+                            stencilSettings);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
 class GLDashingCircleEffect;
 
 /*
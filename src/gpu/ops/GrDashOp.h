@@ -14,6 +14,7 @@
 class GrContext;
 class GrDrawOp;
 class GrPaint;
+class SkPath;
 class GrStyle;
 struct GrUserStencilSettings;
 
@@ -33,6 +34,21 @@ std::unique_ptr<GrDrawOp> MakeDashLineOp(GrContext*,
                                          const GrStyle& style,
                                          const GrUserStencilSettings*);
 bool CanDrawDashLine(const SkPoint pts[2], const GrStyle& style, const SkMatrix& viewMatrix);
+
+/**
+ * Dashes a path of lines and curves on the gpu. The path is flattened once in device space and
+ * the fragment shader measures each dash along its arc length, so this works for any stroke width
+ * with butt or square caps, as long as the path turns gently enough for its segments to meet at
+ * mitered seams.
+ */
+std::unique_ptr<GrDrawOp> MakeDashPathOp(GrContext*,
+                                         GrPaint&&,
+                                         const SkMatrix& viewMatrix,
+                                         const SkPath&,
+                                         AAMode,
+                                         const GrStyle& style,
+                                         const GrUserStencilSettings*);
+bool CanDrawDashPath(const SkPath&, const GrStyle& style, const SkMatrix& viewMatrix, AAMode);
 }
 
 #endif
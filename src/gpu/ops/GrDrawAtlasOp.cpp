@@ -8,10 +8,23 @@
 #include "GrDrawAtlasOp.h"
 #include "GrDrawOpTest.h"
 #include "GrOpFlushState.h"
+#include "GrQuadPerEdgeAA.h"
+#include "GrResourceProvider.h"
 #include "SkGr.h"
 #include "SkRSXform.h"
 #include "SkRandom.h"
 #include "SkRectPriv.h"
+#include "glsl/GrGLSLFragmentShaderBuilder.h"
+#include "glsl/GrGLSLGeometryProcessor.h"
+#include "glsl/GrGLSLUtil.h"
+#include "glsl/GrGLSLVarying.h"
+#include "glsl/GrGLSLVertexGeoBuilder.h"
+
+static constexpr size_t kSpriteXformAndRectSize = sizeof(SkRSXform) + sizeof(SkRect);
+
+static size_t sprite_stride(bool hasColors) {
+    return kSpriteXformAndRectSize + (hasColors ? sizeof(GrColor) : 0);
+}
 
 static sk_sp<GrGeometryProcessor> make_gp(const GrShaderCaps* shaderCaps,
                                           bool hasColors,
@@ -27,6 +40,130 @@ static sk_sp<GrGeometryProcessor> make_gp(const GrShaderCaps* shaderCaps,
                                          LocalCoords::kHasExplicit_Type, viewMatrix);
 }
 
+namespace {
+
+// Draws each sprite as an instance of the quad corner buffer. The vertex shader maps the corner
+// through the sprite's tex rect and RSXform, so a sprite costs one 32 (or 36, with colors) byte
+// instance instead of four vertices.
+class AtlasSpriteProcessor : public GrGeometryProcessor {
+public:
+    AtlasSpriteProcessor(bool hasColors, const SkPMColor4f& color, const SkMatrix& viewMatrix)
+            : INHERITED(kGrDrawAtlasOp_Processor_ClassID)
+            , fColor(color)
+            , fViewMatrix(viewMatrix)
+            , fHasColors(hasColors) {
+        this->setVertexAttributes(&kCornerAttrib, 1);
+        this->setInstanceAttributes(kInstanceAttribs, hasColors ? 3 : 2);
+        SkASSERT(this->instanceStride() == sprite_stride(hasColors));
+    }
+
+    const char* name() const override { return "AtlasSpriteProcessor"; }
+
+    void getGLSLProcessorKey(const GrShaderCaps&, GrProcessorKeyBuilder* b) const override;
+
+    GrGLSLPrimitiveProcessor* createGLSLInstance(const GrShaderCaps&) const override;
+
+private:
+    static constexpr Attribute kCornerAttrib =
+            {"corner", kFloat4_GrVertexAttribType, kFloat4_GrSLType};
+
+    static constexpr Attribute kInstanceAttribs[] = {
+            {"xform", kFloat4_GrVertexAttribType, kFloat4_GrSLType},
+            {"texRect", kFloat4_GrVertexAttribType, kFloat4_GrSLType},
+            {"color", kUByte4_norm_GrVertexAttribType, kHalf4_GrSLType}};  // Conditional.
+
+    static constexpr int kColorAttribIdx = 2;
+
+    SkPMColor4f fColor;
+    SkMatrix fViewMatrix;
+    bool fHasColors;
+
+    class Impl;
+
+    typedef GrGeometryProcessor INHERITED;
+};
+
+constexpr GrPrimitiveProcessor::Attribute AtlasSpriteProcessor::kCornerAttrib;
+constexpr GrPrimitiveProcessor::Attribute AtlasSpriteProcessor::kInstanceAttribs[];
+
+class AtlasSpriteProcessor::Impl : public GrGLSLGeometryProcessor {
+public:
+    Impl() : fViewMatrix(SkMatrix::InvalidMatrix()), fColor(SK_PMColor4fILLEGAL) {}
+
+    static void GenKey(const AtlasSpriteProcessor& proc, GrProcessorKeyBuilder* b) {
+        uint32_t key = proc.fHasColors ? 0x1 : 0x0;
+        key |= ComputePosKey(proc.fViewMatrix) << 1;
+        b->add32(key);
+    }
+
+    void onEmitCode(EmitArgs& args, GrGPArgs* gpArgs) override {
+        const auto& proc = args.fGP.cast<AtlasSpriteProcessor>();
+        GrGLSLVertexBuilder* v = args.fVertBuilder;
+        GrGLSLVaryingHandler* varyings = args.fVaryingHandler;
+        GrGLSLUniformHandler* uniforms = args.fUniformHandler;
+
+        varyings->emitAttributes(proc);
+        if (proc.fHasColors) {
+            varyings->addPassThroughAttribute(proc.kInstanceAttribs[kColorAttribIdx],
+                                              args.fOutputColor,
+                                              GrGLSLVaryingHandler::Interpolation::kCanBeFlat);
+        } else {
+            this->setupUniformColor(args.fFragBuilder, uniforms, args.fOutputColor,
+                                    &fColorUniform);
+        }
+
+        // The corners are one-hot selectors in SkRSXform::toTriStrip order: the sprite's top
+        // left, bottom left, top right, and bottom right.
+        v->codeAppend("float2 unitcorner = float2(dot(corner, float4(0, 0, 1, 1)), "
+                                                 "dot(corner, float4(0, 1, 0, 1)));");
+        v->codeAppend("float2 localcoord = mix(texRect.xy, texRect.zw, unitcorner);");
+        v->codeAppend("float2 offset = (texRect.zw - texRect.xy) * unitcorner;");
+        // xform is [scos, ssin, tx, ty].
+        v->codeAppend("float2 spritepos = float2(xform.x * offset.x - xform.y * offset.y, "
+                                                "xform.y * offset.x + xform.x * offset.y) + "
+                                         "xform.zw;");
+        this->writeOutputPosition(v, uniforms, gpArgs, "spritepos", proc.fViewMatrix,
+                                  &fViewMatrixUniform);
+        this->emitTransforms(v, varyings, uniforms, GrShaderVar("localcoord", kFloat2_GrSLType),
+                             args.fFPCoordTransformHandler);
+
+        args.fFragBuilder->codeAppendf("%s = half4(1);", args.fOutputCoverage);
+    }
+
+    void setData(const GrGLSLProgramDataManager& pdman, const GrPrimitiveProcessor& gp,
+                 FPCoordTransformIter&& transformIter) override {
+        const auto& proc = gp.cast<AtlasSpriteProcessor>();
+        if (!proc.fViewMatrix.isIdentity() && !fViewMatrix.cheapEqualTo(proc.fViewMatrix)) {
+            fViewMatrix = proc.fViewMatrix;
+            float viewMatrix[3 * 3];
+            GrGLSLGetMatrix<3>(viewMatrix, fViewMatrix);
+            pdman.setMatrix3f(fViewMatrixUniform, viewMatrix);
+        }
+        if (!proc.fHasColors && proc.fColor != fColor) {
+            pdman.set4fv(fColorUniform, 1, proc.fColor.vec());
+            fColor = proc.fColor;
+        }
+        this->setTransformDataHelper(SkMatrix::I(), pdman, &transformIter);
+    }
+
+private:
+    SkMatrix fViewMatrix;
+    SkPMColor4f fColor;
+    UniformHandle fViewMatrixUniform;
+    UniformHandle fColorUniform;
+};
+
+void AtlasSpriteProcessor::getGLSLProcessorKey(const GrShaderCaps&,
+                                               GrProcessorKeyBuilder* b) const {
+    Impl::GenKey(*this, b);
+}
+
+GrGLSLPrimitiveProcessor* AtlasSpriteProcessor::createGLSLInstance(const GrShaderCaps&) const {
+    return new Impl();
+}
+
+}  // anonymous namespace
+
 GrDrawAtlasOp::GrDrawAtlasOp(const Helper::MakeArgs& helperArgs, const SkPMColor4f& color,
                              const SkMatrix& viewMatrix, GrAAType aaType, int spriteCount,
                              const SkRSXform* xforms, const SkRect* rects, const SkColor* colors)
@@ -38,32 +175,26 @@ GrDrawAtlasOp::GrDrawAtlasOp(const Helper::MakeArgs& helperArgs, const SkPMColor
     Geometry& installedGeo = fGeoData.push_back();
     installedGeo.fColor = color;
 
-    // Figure out stride and offsets
-    // Order within the vertex is: position [color] texCoord
-    size_t texOffset = sizeof(SkPoint);
-    size_t vertexStride = 2 * sizeof(SkPoint);
     fHasColors = SkToBool(colors);
-    if (colors) {
-        texOffset += sizeof(GrColor);
-        vertexStride += sizeof(GrColor);
-    }
+    size_t spriteStride = sprite_stride(fHasColors);
 
-    // Compute buffer size and alloc buffer
     fQuadCount = spriteCount;
-    int allocSize = static_cast<int>(4 * vertexStride * spriteCount);
-    installedGeo.fVerts.reset(allocSize);
-    uint8_t* currVertex = installedGeo.fVerts.begin();
+    installedGeo.fSprites.reset(static_cast<int>(spriteStride * spriteCount));
+    uint8_t* currSprite = installedGeo.fSprites.begin();
 
     SkRect bounds = SkRectPriv::MakeLargestInverted();
     // TODO4F: Preserve float colors
     int paintAlpha = GrColorUnpackA(installedGeo.fColor.toBytes_RGBA());
     for (int spriteIndex = 0; spriteIndex < spriteCount; ++spriteIndex) {
-        // Transform rect
-        SkPoint strip[4];
         const SkRect& currRect = rects[spriteIndex];
+        SkPoint strip[4];
         xforms[spriteIndex].toTriStrip(currRect.width(), currRect.height(), strip);
+        for (const SkPoint& pt : strip) {
+            SkRectPriv::GrowToInclude(&bounds, pt);
+        }
 
-        // Copy colors if necessary
+        memcpy(currSprite, &xforms[spriteIndex], sizeof(SkRSXform));
+        memcpy(currSprite + sizeof(SkRSXform), &currRect, sizeof(SkRect));
         if (colors) {
             // convert to GrColor
             SkColor color = colors[spriteIndex];
@@ -71,39 +202,9 @@ GrDrawAtlasOp::GrDrawAtlasOp(const Helper::MakeArgs& helperArgs, const SkPMColor
                 color = SkColorSetA(color, SkMulDiv255Round(SkColorGetA(color), paintAlpha));
             }
             GrColor grColor = SkColorToPremulGrColor(color);
-
-            *(reinterpret_cast<GrColor*>(currVertex + sizeof(SkPoint))) = grColor;
-            *(reinterpret_cast<GrColor*>(currVertex + vertexStride + sizeof(SkPoint))) = grColor;
-            *(reinterpret_cast<GrColor*>(currVertex + 2 * vertexStride + sizeof(SkPoint))) =
-                    grColor;
-            *(reinterpret_cast<GrColor*>(currVertex + 3 * vertexStride + sizeof(SkPoint))) =
-                    grColor;
+            memcpy(currSprite + kSpriteXformAndRectSize, &grColor, sizeof(GrColor));
         }
-
-        // Copy position and uv to verts
-        *(reinterpret_cast<SkPoint*>(currVertex)) = strip[0];
-        *(reinterpret_cast<SkPoint*>(currVertex + texOffset)) =
-                SkPoint::Make(currRect.fLeft, currRect.fTop);
-        SkRectPriv::GrowToInclude(&bounds, strip[0]);
-        currVertex += vertexStride;
-
-        *(reinterpret_cast<SkPoint*>(currVertex)) = strip[1];
-        *(reinterpret_cast<SkPoint*>(currVertex + texOffset)) =
-                SkPoint::Make(currRect.fLeft, currRect.fBottom);
-        SkRectPriv::GrowToInclude(&bounds, strip[1]);
-        currVertex += vertexStride;
-
-        *(reinterpret_cast<SkPoint*>(currVertex)) = strip[2];
-        *(reinterpret_cast<SkPoint*>(currVertex + texOffset)) =
-                SkPoint::Make(currRect.fRight, currRect.fTop);
-        SkRectPriv::GrowToInclude(&bounds, strip[2]);
-        currVertex += vertexStride;
-
-        *(reinterpret_cast<SkPoint*>(currVertex)) = strip[3];
-        *(reinterpret_cast<SkPoint*>(currVertex + texOffset)) =
-                SkPoint::Make(currRect.fRight, currRect.fBottom);
-        SkRectPriv::GrowToInclude(&bounds, strip[3]);
-        currVertex += vertexStride;
+        currSprite += spriteStride;
     }
 
     this->setTransformedBounds(bounds, viewMatrix, HasAABloat::kNo, IsZeroArea::kNo);
@@ -112,9 +213,10 @@ GrDrawAtlasOp::GrDrawAtlasOp(const Helper::MakeArgs& helperArgs, const SkPMColor
 #ifdef SK_DEBUG
 SkString GrDrawAtlasOp::dumpInfo() const {
     SkString string;
+    size_t spriteStride = sprite_stride(this->hasColors());
     for (const auto& geo : fGeoData) {
         string.appendf("Color: 0x%08x, Quads: %d\n", geo.fColor.toBytes_RGBA(),
-                       geo.fVerts.count() / 4);
+                       static_cast<int>(geo.fSprites.count() / spriteStride));
     }
     string += fHelper.dumpInfo();
     string += INHERITED::dumpInfo();
@@ -122,14 +224,75 @@ SkString GrDrawAtlasOp::dumpInfo() const {
 }
 #endif
 
+// Expands a sprite into a triangle strip of vertices laid out as: position [color] texCoord.
+static uint8_t* write_sprite_vertices(uint8_t* currVertex, const uint8_t* sprite, bool hasColors,
+                                      size_t vertexStride) {
+    SkRSXform xform;
+    SkRect texRect;
+    memcpy(&xform, sprite, sizeof(SkRSXform));
+    memcpy(&texRect, sprite + sizeof(SkRSXform), sizeof(SkRect));
+
+    SkPoint strip[4];
+    xform.toTriStrip(texRect.width(), texRect.height(), strip);
+    const SkPoint texCoords[4] = {{texRect.fLeft, texRect.fTop},
+                                  {texRect.fLeft, texRect.fBottom},
+                                  {texRect.fRight, texRect.fTop},
+                                  {texRect.fRight, texRect.fBottom}};
+    size_t texOffset = sizeof(SkPoint) + (hasColors ? sizeof(GrColor) : 0);
+    for (int i = 0; i < 4; ++i) {
+        *(reinterpret_cast<SkPoint*>(currVertex)) = strip[i];
+        if (hasColors) {
+            memcpy(currVertex + sizeof(SkPoint), sprite + kSpriteXformAndRectSize,
+                   sizeof(GrColor));
+        }
+        *(reinterpret_cast<SkPoint*>(currVertex + texOffset)) = texCoords[i];
+        currVertex += vertexStride;
+    }
+    return currVertex;
+}
+
 void GrDrawAtlasOp::onPrepareDraws(Target* target) {
+    size_t spriteStride = sprite_stride(this->hasColors());
+
+    if (target->caps().instanceAttribSupport()) {
+        sk_sp<const GrBuffer> cornerBuffer =
+                GrQuadPerEdgeAA::FindOrMakeCornerBuffer(target->resourceProvider());
+        if (!cornerBuffer) {
+            SkDebugf("Could not allocate quad corners\n");
+            return;
+        }
+
+        const GrBuffer* instanceBuffer;
+        int firstInstance;
+        void* instances = target->makeVertexSpace(spriteStride, this->quadCount(),
+                                                  &instanceBuffer, &firstInstance);
+        if (!instances) {
+            SkDebugf("Could not allocate vertices\n");
+            return;
+        }
+
+        uint8_t* instancePtr = reinterpret_cast<uint8_t*>(instances);
+        for (const Geometry& args : fGeoData) {
+            memcpy(instancePtr, args.fSprites.begin(), args.fSprites.count());
+            instancePtr += args.fSprites.count();
+        }
+
+        sk_sp<GrGeometryProcessor> gp(new AtlasSpriteProcessor(this->hasColors(), this->color(),
+                                                               this->viewMatrix()));
+        GrMesh* mesh = target->allocMesh(GrPrimitiveType::kTriangleStrip);
+        mesh->setInstanced(instanceBuffer, this->quadCount(), firstInstance, 4);
+        mesh->setVertexData(cornerBuffer.get());
+        auto pipe = fHelper.makePipeline(target);
+        target->draw(std::move(gp), pipe.fPipeline, pipe.fFixedDynamicState, mesh);
+        return;
+    }
+
     // Setup geometry processor
     sk_sp<GrGeometryProcessor> gp(make_gp(target->caps().shaderCaps(),
                                           this->hasColors(),
                                           this->color(),
                                           this->viewMatrix()));
 
-    int instanceCount = fGeoData.count();
     size_t vertexStride = gp->vertexStride();
 
     int numQuads = this->quadCount();
@@ -141,12 +304,12 @@ void GrDrawAtlasOp::onPrepareDraws(Target* target) {
     }
 
     uint8_t* vertPtr = reinterpret_cast<uint8_t*>(verts);
-    for (int i = 0; i < instanceCount; i++) {
-        const Geometry& args = fGeoData[i];
-
-        size_t allocSize = args.fVerts.count();
-        memcpy(vertPtr, args.fVerts.begin(), allocSize);
-        vertPtr += allocSize;
+    for (const Geometry& args : fGeoData) {
+        const uint8_t* sprite = args.fSprites.begin();
+        const uint8_t* spritesEnd = args.fSprites.end();
+        for (; sprite < spritesEnd; sprite += spriteStride) {
+            vertPtr = write_sprite_vertices(vertPtr, sprite, this->hasColors(), vertexStride);
+        }
     }
     auto pipe = fHelper.makePipeline(target);
     helper.recordDraw(target, std::move(gp), pipe.fPipeline, pipe.fFixedDynamicState);
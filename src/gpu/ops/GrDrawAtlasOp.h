@@ -60,9 +60,12 @@ private:
 
     CombineResult onCombineIfPossible(GrOp* t, const GrCaps&) override;
 
+    // Each sprite is stored as its SkRSXform and tex rect, followed by its premul GrColor if the
+    // op has colors. Instanced draws upload these as they are; otherwise they are expanded into
+    // quads when the op is prepared.
     struct Geometry {
         SkPMColor4f fColor;
-        SkTArray<uint8_t, true> fVerts;
+        SkTArray<uint8_t, true> fSprites;
     };
 
     SkSTArray<1, Geometry, true> fGeoData;
@@ -9,6 +9,7 @@
 #include "GrCaps.h"
 #include "GrDefaultGeoProcFactory.h"
 #include "GrOpFlushState.h"
+#include "SkAutoMalloc.h"
 #include "SkGr.h"
 #include "SkRectPriv.h"
 
@@ -209,8 +210,7 @@ sk_sp<GrGeometryProcessor> GrDrawVerticesOp::makeGP(const GrShaderCaps* shaderCa
 }
 
 void GrDrawVerticesOp::onPrepareDraws(Target* target) {
-    bool hasMapBufferSupport = GrCaps::kNone_MapFlags != target->caps().mapBufferFlags();
-    if (fMeshes[0].fVertices->isVolatile() || !hasMapBufferSupport) {
+    if (fMeshes[0].fVertices->isVolatile()) {
         this->drawVolatile(target);
     } else {
         this->drawNonVolatile(target);
@@ -275,12 +275,16 @@ void GrDrawVerticesOp::drawNonVolatile(Target* target) {
     // Get the resource provider.
     GrResourceProvider* rp = target->resourceProvider();
 
-    // Generate keys for the buffers.
+    // Generate keys for the buffers. Which attributes the vertex buffer holds depends on the paint
+    // (e.g. local coords are only written for shaders), so the vertex key includes the layout.
     GrUniqueKey vertexKey, indexKey;
-    GrUniqueKey::Builder vertexKeyBuilder(&vertexKey, kDomain, 2);
+    GrUniqueKey::Builder vertexKeyBuilder(&vertexKey, kDomain, 3);
     GrUniqueKey::Builder indexKeyBuilder(&indexKey, kDomain, 2);
     vertexKeyBuilder[0] = indexKeyBuilder[0] = fMeshes[0].fVertices->uniqueID();
     vertexKeyBuilder[1] = 0;
+    vertexKeyBuilder[2] = (hasColorAttribute       ? 0x1 : 0x0) |
+                          (hasLocalCoordsAttribute ? 0x2 : 0x0) |
+                          (hasBoneAttribute        ? 0x4 : 0x0);
     indexKeyBuilder[1] = 1;
     vertexKeyBuilder.finish();
     indexKeyBuilder.finish();
@@ -297,44 +301,79 @@ void GrDrawVerticesOp::drawNonVolatile(Target* target) {
         return;
     }
 
-    // Allocate vertex buffer.
     size_t vertexStride = gp->vertexStride();
-    vertexBuffer.reset(rp->createBuffer(fVertexCount * vertexStride,
-                                        kVertex_GrBufferType,
-                                        kStatic_GrAccessPattern,
-                                        GrResourceProvider::Flags::kNone));
-    void* verts = vertexBuffer ? vertexBuffer->map() : nullptr;
-    if (!verts) {
-        SkDebugf("Could not allocate vertices\n");
-        return;
-    }
-
-    // Allocate index buffer.
-    uint16_t* indices = nullptr;
-    if (this->isIndexed()) {
-        indexBuffer.reset(rp->createBuffer(fIndexCount * sizeof(uint16_t),
-                                           kIndex_GrBufferType,
-                                           kStatic_GrAccessPattern,
-                                           GrResourceProvider::Flags::kNone));
-        indices = indexBuffer ? static_cast<uint16_t*>(indexBuffer->map()) : nullptr;
-        if (!indices) {
-            SkDebugf("Could not allocate indices\n");
+    size_t vertexBytes = fVertexCount * vertexStride;
+    size_t indexBytes = this->isIndexed() ? fIndexCount * sizeof(uint16_t) : 0;
+
+    if (GrCaps::kNone_MapFlags == target->caps().mapBufferFlags()) {
+        // Without buffer mapping, fill the data on the CPU and upload it as the buffers are
+        // created. This is still only done the first time the vertices are drawn.
+        SkAutoMalloc data(vertexBytes + indexBytes);
+        void* verts = data.get();
+        uint16_t* indices = this->isIndexed()
+                ? reinterpret_cast<uint16_t*>(static_cast<char*>(data.get()) + vertexBytes)
+                : nullptr;
+        this->fillBuffers(hasColorAttribute,
+                          hasLocalCoordsAttribute,
+                          hasBoneAttribute,
+                          vertexStride,
+                          verts,
+                          indices);
+        vertexBuffer.reset(rp->createBuffer(vertexBytes, kVertex_GrBufferType,
+                                            kStatic_GrAccessPattern,
+                                            GrResourceProvider::Flags::kNone, verts));
+        if (!vertexBuffer) {
+            SkDebugf("Could not allocate vertices\n");
+            return;
+        }
+        if (indices) {
+            indexBuffer.reset(rp->createBuffer(indexBytes, kIndex_GrBufferType,
+                                               kStatic_GrAccessPattern,
+                                               GrResourceProvider::Flags::kNone, indices));
+            if (!indexBuffer) {
+                SkDebugf("Could not allocate indices\n");
+                return;
+            }
+        }
+    } else {
+        // Allocate vertex buffer.
+        vertexBuffer.reset(rp->createBuffer(vertexBytes,
+                                            kVertex_GrBufferType,
+                                            kStatic_GrAccessPattern,
+                                            GrResourceProvider::Flags::kNone));
+        void* verts = vertexBuffer ? vertexBuffer->map() : nullptr;
+        if (!verts) {
+            SkDebugf("Could not allocate vertices\n");
             return;
         }
-    }
 
-    // Fill the buffers.
-    this->fillBuffers(hasColorAttribute,
-                      hasLocalCoordsAttribute,
-                      hasBoneAttribute,
-                      vertexStride,
-                      verts,
-                      indices);
+        // Allocate index buffer.
+        uint16_t* indices = nullptr;
+        if (this->isIndexed()) {
+            indexBuffer.reset(rp->createBuffer(indexBytes,
+                                               kIndex_GrBufferType,
+                                               kStatic_GrAccessPattern,
+                                               GrResourceProvider::Flags::kNone));
+            indices = indexBuffer ? static_cast<uint16_t*>(indexBuffer->map()) : nullptr;
+            if (!indices) {
+                SkDebugf("Could not allocate indices\n");
+                return;
+            }
+        }
 
-    // Unmap the buffers.
-    vertexBuffer->unmap();
-    if (indexBuffer) {
-        indexBuffer->unmap();
+        // Fill the buffers.
+        this->fillBuffers(hasColorAttribute,
+                          hasLocalCoordsAttribute,
+                          hasBoneAttribute,
+                          vertexStride,
+                          verts,
+                          indices);
+
+        // Unmap the buffers.
+        vertexBuffer->unmap();
+        if (indexBuffer) {
+            indexBuffer->unmap();
+        }
     }
 
     // Cache the buffers.
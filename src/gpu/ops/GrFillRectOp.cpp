@@ -205,20 +205,33 @@ private:
         using Domain = GrQuadPerEdgeAA::Domain;
         static constexpr SkRect kEmptyDomain = SkRect::MakeEmpty();
 
+        using Instanced = GrQuadPerEdgeAA::Instanced;
+        Instanced instanced = GrQuadPerEdgeAA::CanUseInstancing(target->caps(), fHelper.aaType())
+                ? Instanced::kYes : Instanced::kNo;
         VertexSpec vertexSpec(this->deviceQuadType(),
                               fWideColor ? ColorType::kHalf : ColorType::kByte,
                               this->localQuadType(), fHelper.usesLocalCoords(), Domain::kNo,
-                              fHelper.aaType());
+                              fHelper.aaType(), instanced);
 
         sk_sp<GrGeometryProcessor> gp = GrQuadPerEdgeAA::MakeProcessor(vertexSpec);
-        size_t vertexSize = gp->vertexStride();
+        size_t vertexSize = vertexSpec.isInstanced() ? gp->instanceStride() : gp->vertexStride();
+        int verticesPerQuad = vertexSpec.isInstanced() ? 1 : 4;
+
+        sk_sp<const GrBuffer> cornerBuffer;
+        if (vertexSpec.isInstanced()) {
+            cornerBuffer = GrQuadPerEdgeAA::FindOrMakeCornerBuffer(target->resourceProvider());
+            if (!cornerBuffer) {
+                SkDebugf("Could not allocate quad corners\n");
+                return;
+            }
+        }
 
         const GrBuffer* vbuffer;
         int vertexOffsetInBuffer = 0;
 
         // Fill the allocated vertex data
-        void* vdata = target->makeVertexSpace(vertexSize, fQuads.count() * 4, &vbuffer,
-                                              &vertexOffsetInBuffer);
+        void* vdata = target->makeVertexSpace(vertexSize, fQuads.count() * verticesPerQuad,
+                                              &vbuffer, &vertexOffsetInBuffer);
         if (!vdata) {
             SkDebugf("Could not allocate vertices\n");
             return;
@@ -234,20 +247,26 @@ private:
 
         // Configure the mesh for the vertex data
         GrMesh* mesh;
-        if (fQuads.count() > 1) {
-            mesh = target->allocMesh(GrPrimitiveType::kTriangles);
-            sk_sp<const GrBuffer> ibuffer = target->resourceProvider()->refQuadIndexBuffer();
-            if (!ibuffer) {
-                SkDebugf("Could not allocate quad indices\n");
-                return;
-            }
-            mesh->setIndexedPatterned(ibuffer.get(), 6, 4, fQuads.count(),
-                                      GrResourceProvider::QuadCountOfQuadBuffer());
-        } else {
+        if (vertexSpec.isInstanced()) {
             mesh = target->allocMesh(GrPrimitiveType::kTriangleStrip);
-            mesh->setNonIndexedNonInstanced(4);
+            mesh->setInstanced(vbuffer, fQuads.count(), vertexOffsetInBuffer, 4);
+            mesh->setVertexData(cornerBuffer.get());
+        } else {
+            if (fQuads.count() > 1) {
+                mesh = target->allocMesh(GrPrimitiveType::kTriangles);
+                sk_sp<const GrBuffer> ibuffer = target->resourceProvider()->refQuadIndexBuffer();
+                if (!ibuffer) {
+                    SkDebugf("Could not allocate quad indices\n");
+                    return;
+                }
+                mesh->setIndexedPatterned(ibuffer.get(), 6, 4, fQuads.count(),
+                                          GrResourceProvider::QuadCountOfQuadBuffer());
+            } else {
+                mesh = target->allocMesh(GrPrimitiveType::kTriangleStrip);
+                mesh->setNonIndexedNonInstanced(4);
+            }
+            mesh->setVertexData(vbuffer, vertexOffsetInBuffer);
         }
-        mesh->setVertexData(vbuffer, vertexOffsetInBuffer);
 
         auto pipe = fHelper.makePipeline(target);
         target->draw(std::move(gp), pipe.fPipeline, pipe.fFixedDynamicState, mesh);
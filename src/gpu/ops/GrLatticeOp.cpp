@@ -22,6 +22,7 @@
 #include "glsl/GrGLSLColorSpaceXformHelper.h"
 #include "glsl/GrGLSLGeometryProcessor.h"
 #include "glsl/GrGLSLVarying.h"
+#include "glsl/GrGLSLVertexGeoBuilder.h"
 
 namespace {
 
@@ -30,14 +31,17 @@ public:
     static sk_sp<GrGeometryProcessor> Make(GrGpu* gpu,
                                            const GrTextureProxy* proxy,
                                            sk_sp<GrColorSpaceXform> csxf,
-                                           GrSamplerState::Filter filter) {
-        return sk_sp<GrGeometryProcessor>(new LatticeGP(gpu, proxy, std::move(csxf), filter));
+                                           GrSamplerState::Filter filter,
+                                           bool instanced) {
+        return sk_sp<GrGeometryProcessor>(new LatticeGP(gpu, proxy, std::move(csxf), filter,
+                                                        instanced));
     }
 
     const char* name() const override { return "LatticeGP"; }
 
     void getGLSLProcessorKey(const GrShaderCaps&, GrProcessorKeyBuilder* b) const override {
         b->add32(GrColorSpaceXform::XformKey(fColorSpaceXform.get()));
+        b->add32(fInstanced);
     }
 
     GrGLSLPrimitiveProcessor* createGLSLInstance(const GrShaderCaps& caps) const override {
@@ -48,6 +52,10 @@ public:
                 const auto& latticeGP = proc.cast<LatticeGP>();
                 this->setTransformDataHelper(SkMatrix::I(), pdman, &transformIter);
                 fColorSpaceXformHelper.setData(pdman, latticeGP.fColorSpaceXform.get());
+                if (latticeGP.fInstanced) {
+                    pdman.set2f(fHalfTexelUniform, latticeGP.fHalfTexel.fX,
+                                latticeGP.fHalfTexel.fY);
+                }
             }
 
         private:
@@ -58,21 +66,27 @@ public:
                                                 latticeGP.fColorSpaceXform.get());
 
                 args.fVaryingHandler->emitAttributes(latticeGP);
-                this->writeOutputPosition(args.fVertBuilder, gpArgs, latticeGP.fInPosition.name());
-                this->emitTransforms(args.fVertBuilder,
-                                     args.fVaryingHandler,
-                                     args.fUniformHandler,
-                                     latticeGP.fInTextureCoords.asShaderVar(),
-                                     args.fFPCoordTransformHandler);
-                args.fFragBuilder->codeAppend("float2 textureCoords;");
-                args.fVaryingHandler->addPassThroughAttribute(latticeGP.fInTextureCoords,
-                                                              "textureCoords");
-                args.fFragBuilder->codeAppend("float4 textureDomain;");
+                if (latticeGP.fInstanced) {
+                    this->emitInstancedVertexCode(args, gpArgs, latticeGP);
+                } else {
+                    this->writeOutputPosition(args.fVertBuilder, gpArgs,
+                                              latticeGP.fInPosition.name());
+                    this->emitTransforms(args.fVertBuilder,
+                                         args.fVaryingHandler,
+                                         args.fUniformHandler,
+                                         latticeGP.fInTextureCoords.asShaderVar(),
+                                         args.fFPCoordTransformHandler);
+                    args.fFragBuilder->codeAppend("float2 textureCoords;");
+                    args.fVaryingHandler->addPassThroughAttribute(latticeGP.fInTextureCoords,
+                                                                  "textureCoords");
+                    args.fFragBuilder->codeAppend("float4 textureDomain;");
+                    args.fVaryingHandler->addPassThroughAttribute(
+                            latticeGP.fInTextureDomain, "textureDomain",
+                            Interpolation::kCanBeFlat);
+                }
                 args.fVaryingHandler->addPassThroughAttribute(
-                        latticeGP.fInTextureDomain, "textureDomain", Interpolation::kCanBeFlat);
-                args.fVaryingHandler->addPassThroughAttribute(latticeGP.fInColor,
-                                                              args.fOutputColor,
-                                                              Interpolation::kCanBeFlat);
+                        latticeGP.fInstanced ? latticeGP.fInInstanceColor : latticeGP.fInColor,
+                        args.fOutputColor, Interpolation::kCanBeFlat);
                 args.fFragBuilder->codeAppendf("%s = ", args.fOutputColor);
                 args.fFragBuilder->appendTextureLookupAndModulate(
                         args.fOutputColor,
@@ -83,15 +97,70 @@ public:
                 args.fFragBuilder->codeAppend(";");
                 args.fFragBuilder->codeAppendf("%s = half4(1);", args.fOutputCoverage);
             }
+
+            // Divides each instance's dst rect into its nine patches, the way SkLatticeIter does.
+            // Each vertex selects the edges of its patch and which of them it sits on.
+            void emitInstancedVertexCode(EmitArgs& args, GrGPArgs* gpArgs,
+                                         const LatticeGP& latticeGP) {
+                using Interpolation = GrGLSLVaryingHandler::Interpolation;
+                GrGLSLVertexBuilder* v = args.fVertBuilder;
+                const char* halfTexel;
+                fHalfTexelUniform = args.fUniformHandler->addUniform(
+                        kVertex_GrShaderFlag, kFloat2_GrSLType, "halfTexel", &halfTexel);
+
+                // When the dst is too small for the fixed patches, they shrink to fit and the
+                // scalable center disappears.
+                v->codeAppend("float2 dstSize = dstRect.zw - dstRect.xy;");
+                v->codeAppend("float2 fixedSize = insets.xy + insets.zw;");
+                v->codeAppend("float2 shrink = float2("
+                                      "fixedSize.x > dstSize.x ? dstSize.x / fixedSize.x : 1,"
+                                      "fixedSize.y > dstSize.y ? dstSize.y / fixedSize.y : 1);");
+                v->codeAppend("float4 edgesX = float4("
+                                      "dstRect.x, dstRect.x + insets.x * shrink.x,"
+                                      "dstRect.z - insets.z * shrink.x, dstRect.z);");
+                v->codeAppend("float4 edgesY = float4("
+                                      "dstRect.y, dstRect.y + insets.y * shrink.y,"
+                                      "dstRect.w - insets.w * shrink.y, dstRect.w);");
+                v->codeAppend("float2 devPosition = mix("
+                                      "float2(dot(edgesX, loX), dot(edgesY, loY)),"
+                                      "float2(dot(edgesX, hiX), dot(edgesY, hiY)), corner);");
+                v->codeAppend("float2 texLo = float2(dot(texX, loX), dot(texY, loY));");
+                v->codeAppend("float2 texHi = float2(dot(texX, hiX), dot(texY, hiY));");
+                v->codeAppend("float2 texCoords = mix(texLo, texHi, corner);");
+                this->writeOutputPosition(v, gpArgs, "devPosition");
+                this->emitTransforms(v, args.fVaryingHandler, args.fUniformHandler,
+                                     GrShaderVar("texCoords", kFloat2_GrSLType),
+                                     args.fFPCoordTransformHandler);
+
+                GrGLSLVarying textureCoords(kFloat2_GrSLType);
+                args.fVaryingHandler->addVarying("textureCoords", &textureCoords);
+                v->codeAppendf("%s = texCoords;", textureCoords.vsOut());
+                // The tex coords of a bottom-left origin proxy are flipped, so sort them.
+                GrGLSLVarying textureDomain(kFloat4_GrSLType);
+                args.fVaryingHandler->addVarying("textureDomain", &textureDomain,
+                                                 Interpolation::kCanBeFlat);
+                v->codeAppendf("%s = float4(min(texLo, texHi) + %s, max(texLo, texHi) - %s);",
+                               textureDomain.vsOut(), halfTexel, halfTexel);
+
+                args.fFragBuilder->codeAppendf("float2 textureCoords = %s;",
+                                               textureCoords.fsIn());
+                args.fFragBuilder->codeAppendf("float4 textureDomain = %s;",
+                                               textureDomain.fsIn());
+            }
+
             GrGLSLColorSpaceXformHelper fColorSpaceXformHelper;
+            UniformHandle fHalfTexelUniform;
         };
         return new GLSLProcessor;
     }
 
 private:
     LatticeGP(GrGpu* gpu, const GrTextureProxy* proxy, sk_sp<GrColorSpaceXform> csxf,
-              GrSamplerState::Filter filter)
-            : INHERITED(kLatticeGP_ClassID), fColorSpaceXform(std::move(csxf)) {
+              GrSamplerState::Filter filter, bool instanced)
+            : INHERITED(kLatticeGP_ClassID)
+            , fColorSpaceXform(std::move(csxf))
+            , fInstanced(instanced)
+            , fHalfTexel(SkPoint::Make(0.5f / proxy->width(), 0.5f / proxy->height())) {
 
         GrSamplerState samplerState = GrSamplerState(GrSamplerState::WrapMode::kClamp,
                                                      filter);
@@ -101,26 +170,111 @@ private:
         fSampler.reset(proxy->textureType(), proxy->config(), samplerState,
                        extraSamplerKey);
         this->setTextureSamplerCnt(1);
-        fInPosition = {"position", kFloat2_GrVertexAttribType, kFloat2_GrSLType};
-        fInTextureCoords = {"textureCoords", kFloat2_GrVertexAttribType, kFloat2_GrSLType};
-        fInTextureDomain = {"textureDomain", kFloat4_GrVertexAttribType, kFloat4_GrSLType};
-        fInColor = {"color", kUByte4_norm_GrVertexAttribType, kHalf4_GrSLType};
-        this->setVertexAttributes(&fInPosition, 4);
+        if (instanced) {
+            fInLoX = {"loX", kFloat4_GrVertexAttribType, kFloat4_GrSLType};
+            fInHiX = {"hiX", kFloat4_GrVertexAttribType, kFloat4_GrSLType};
+            fInLoY = {"loY", kFloat4_GrVertexAttribType, kFloat4_GrSLType};
+            fInHiY = {"hiY", kFloat4_GrVertexAttribType, kFloat4_GrSLType};
+            fInCorner = {"corner", kFloat2_GrVertexAttribType, kFloat2_GrSLType};
+            this->setVertexAttributes(&fInLoX, 5);
+            fInDstRect = {"dstRect", kFloat4_GrVertexAttribType, kFloat4_GrSLType};
+            fInInsets = {"insets", kFloat4_GrVertexAttribType, kFloat4_GrSLType};
+            fInTexX = {"texX", kFloat4_GrVertexAttribType, kFloat4_GrSLType};
+            fInTexY = {"texY", kFloat4_GrVertexAttribType, kFloat4_GrSLType};
+            fInInstanceColor = {"color", kUByte4_norm_GrVertexAttribType, kHalf4_GrSLType};
+            this->setInstanceAttributes(&fInDstRect, 5);
+        } else {
+            fInPosition = {"position", kFloat2_GrVertexAttribType, kFloat2_GrSLType};
+            fInTextureCoords = {"textureCoords", kFloat2_GrVertexAttribType, kFloat2_GrSLType};
+            fInTextureDomain = {"textureDomain", kFloat4_GrVertexAttribType, kFloat4_GrSLType};
+            fInColor = {"color", kUByte4_norm_GrVertexAttribType, kHalf4_GrSLType};
+            this->setVertexAttributes(&fInPosition, 4);
+        }
     }
 
     const TextureSampler& onTextureSampler(int) const override { return fSampler; }
 
+    // Per-vertex attributes when drawing a rect per patch.
     Attribute fInPosition;
     Attribute fInTextureCoords;
     Attribute fInTextureDomain;
     Attribute fInColor;
 
+    // Per-vertex attributes when instancing nine-patches: one-hot selectors of the patch's low
+    // and high edges, and which of the two the vertex is on.
+    Attribute fInLoX;
+    Attribute fInHiX;
+    Attribute fInLoY;
+    Attribute fInHiY;
+    Attribute fInCorner;
+
+    // Per-instance attributes: the device space dst rect, the device space sizes of the fixed
+    // patches (left, top, right, bottom), the normalized texture coords of the four x and four y
+    // edges, and the color.
+    Attribute fInDstRect;
+    Attribute fInInsets;
+    Attribute fInTexX;
+    Attribute fInTexY;
+    Attribute fInInstanceColor;
+
     sk_sp<GrColorSpaceXform> fColorSpaceXform;
+    bool fInstanced;
+    SkPoint fHalfTexel;
     TextureSampler fSampler;
 
     typedef GrGeometryProcessor INHERITED;
 };
 
+// The nine patches of an instance, as quads of four vertices in triangle strip order.
+struct NinePatchVertex {
+    float fLoX[4];
+    float fHiX[4];
+    float fLoY[4];
+    float fHiY[4];
+    float fCorner[2];
+};
+
+static constexpr int kNinePatchVertexCount = 9 * 4;
+static constexpr int kNinePatchIndexCount = 9 * 6;
+
+GR_DECLARE_STATIC_UNIQUE_KEY(gNinePatchVertexBufferKey);
+GR_DECLARE_STATIC_UNIQUE_KEY(gNinePatchIndexBufferKey);
+
+static sk_sp<const GrBuffer> find_or_make_nine_patch_vertex_buffer(GrResourceProvider* provider) {
+    NinePatchVertex vertices[kNinePatchVertexCount];
+    memset(vertices, 0, sizeof(vertices));
+    NinePatchVertex* vertex = vertices;
+    for (int y = 0; y < 3; ++y) {
+        for (int x = 0; x < 3; ++x) {
+            for (int corner = 0; corner < 4; ++corner) {
+                vertex->fLoX[x] = 1;
+                vertex->fHiX[x + 1] = 1;
+                vertex->fLoY[y] = 1;
+                vertex->fHiY[y + 1] = 1;
+                vertex->fCorner[0] = corner & 1;
+                vertex->fCorner[1] = corner >> 1;
+                ++vertex;
+            }
+        }
+    }
+    GR_DEFINE_STATIC_UNIQUE_KEY(gNinePatchVertexBufferKey);
+    return provider->findOrMakeStaticBuffer(kVertex_GrBufferType, sizeof(vertices), vertices,
+                                            gNinePatchVertexBufferKey);
+}
+
+static sk_sp<const GrBuffer> find_or_make_nine_patch_index_buffer(GrResourceProvider* provider) {
+    uint16_t indices[kNinePatchIndexCount];
+    for (int i = 0; i < 9; ++i) {
+        static constexpr uint16_t kQuad[6] = {0, 1, 2, 2, 1, 3};
+        for (int j = 0; j < 6; ++j) {
+            indices[6 * i + j] = 4 * i + kQuad[j];
+        }
+    }
+    GR_DEFINE_STATIC_UNIQUE_KEY(gNinePatchIndexBufferKey);
+    return provider->findOrMakeStaticBuffer(kIndex_GrBufferType, sizeof(indices), indices,
+                                            gNinePatchIndexBufferKey);
+}
+
 class NonAALatticeOp final : public GrMeshDrawOp {
 private:
     using Helper = GrSimpleMeshDrawOpHelper;
@@ -160,6 +314,7 @@ public:
         patch.fColor = color;
         patch.fIter = std::move(iter);
         patch.fDst = dst;
+        patch.fIsNinePatch = patch.fIter->isNinePatch(&patch.fSrc, &patch.fCenter);
 
         // setup bounds
         this->setTransformedBounds(patch.fDst, viewMatrix, HasAABloat::kNo, IsZeroArea::kNo);
@@ -202,9 +357,28 @@ public:
     }
 
 private:
+    // Nine-patches whose view matrices don't flip or rotate them can be instanced, with the
+    // vertex shader dividing each one's device space dst rect into its patches.
+    bool canDrawInstanced(const GrCaps& caps) const {
+        if (!caps.instanceAttribSupport()) {
+            return false;
+        }
+        for (const Patch& patch : fPatches) {
+            if (!patch.fIsNinePatch || !patch.fViewMatrix.isScaleTranslate() ||
+                patch.fViewMatrix.getScaleX() <= 0 || patch.fViewMatrix.getScaleY() <= 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+
     void onPrepareDraws(Target* target) override {
         GrGpu* gpu = target->resourceProvider()->priv().gpu();
-        auto gp = LatticeGP::Make(gpu, fProxy.get(), fColorSpaceXform, fFilter);
+        if (this->canDrawInstanced(target->caps())) {
+            this->prepareInstancedDraws(target, gpu);
+            return;
+        }
+        auto gp = LatticeGP::Make(gpu, fProxy.get(), fColorSpaceXform, fFilter, false);
         if (!gp) {
             SkDebugf("Couldn't create GrGeometryProcessor\n");
             return;
@@ -283,6 +457,66 @@ private:
         helper.recordDraw(target, std::move(gp), pipe.fPipeline, pipe.fFixedDynamicState);
     }
 
+    void prepareInstancedDraws(Target* target, GrGpu* gpu) {
+        auto gp = LatticeGP::Make(gpu, fProxy.get(), fColorSpaceXform, fFilter, true);
+        if (!gp) {
+            SkDebugf("Couldn't create GrGeometryProcessor\n");
+            return;
+        }
+
+        sk_sp<const GrBuffer> vertexBuffer =
+                find_or_make_nine_patch_vertex_buffer(target->resourceProvider());
+        sk_sp<const GrBuffer> indexBuffer =
+                find_or_make_nine_patch_index_buffer(target->resourceProvider());
+        if (!vertexBuffer || !indexBuffer) {
+            SkDebugf("Could not allocate nine-patch geometry\n");
+            return;
+        }
+        SkASSERT(gp->vertexStride() == sizeof(NinePatchVertex));
+
+        const GrBuffer* instanceBuffer;
+        int firstInstance;
+        GrVertexWriter instances{target->makeVertexSpace(gp->instanceStride(), fPatches.count(),
+                                                         &instanceBuffer, &firstInstance)};
+        if (!instances.fPtr) {
+            SkDebugf("Could not allocate instances\n");
+            return;
+        }
+
+        const float iw = 1.f / fProxy->width(),
+                    ih = 1.f / fProxy->height();
+        const bool flipY = kBottomLeft_GrSurfaceOrigin == fProxy->origin();
+        for (const Patch& patch : fPatches) {
+            const SkMatrix& m = patch.fViewMatrix;
+            const SkScalar sx = m.getScaleX(),
+                           sy = m.getScaleY();
+            const SkRect dstRect = m.mapRect(patch.fDst);
+            const float insets[4] = {(patch.fCenter.fLeft - patch.fSrc.fLeft) * sx,
+                                     (patch.fCenter.fTop - patch.fSrc.fTop) * sy,
+                                     (patch.fSrc.fRight - patch.fCenter.fRight) * sx,
+                                     (patch.fSrc.fBottom - patch.fCenter.fBottom) * sy};
+            const float texX[4] = {patch.fSrc.fLeft * iw, patch.fCenter.fLeft * iw,
+                                   patch.fCenter.fRight * iw, patch.fSrc.fRight * iw};
+            float texY[4] = {patch.fSrc.fTop * ih, patch.fCenter.fTop * ih,
+                             patch.fCenter.fBottom * ih, patch.fSrc.fBottom * ih};
+            if (flipY) {
+                for (float& y : texY) {
+                    y = 1 - y;
+                }
+            }
+            // TODO4F: Preserve float colors
+            instances.write(dstRect, insets, texX, texY, patch.fColor.toBytes_RGBA());
+        }
+
+        GrMesh* mesh = target->allocMesh(GrPrimitiveType::kTriangles);
+        mesh->setIndexedInstanced(indexBuffer.get(), kNinePatchIndexCount, instanceBuffer,
+                                  fPatches.count(), firstInstance, GrPrimitiveRestart::kNo);
+        mesh->setVertexData(vertexBuffer.get());
+        auto pipe = fHelper.makePipeline(target, 1);
+        pipe.fFixedDynamicState->fPrimitiveProcessorTextures[0] = fProxy.get();
+        target->draw(std::move(gp), pipe.fPipeline, pipe.fFixedDynamicState, mesh);
+    }
+
     CombineResult onCombineIfPossible(GrOp* t, const GrCaps& caps) override {
         NonAALatticeOp* that = t->cast<NonAALatticeOp>();
         if (fProxy != that->fProxy) {
@@ -291,7 +525,7 @@ private:
         if (fFilter != that->fFilter) {
             return CombineResult::kCannotCombine;
         }
-        if (GrColorSpaceXform::Equals(fColorSpaceXform.get(), that->fColorSpaceXform.get())) {
+        if (!GrColorSpaceXform::Equals(fColorSpaceXform.get(), that->fColorSpaceXform.get())) {
             return CombineResult::kCannotCombine;
         }
         if (!fHelper.isCompatible(that->fHelper, caps, this->bounds(), that->bounds())) {
@@ -307,6 +541,10 @@ private:
         std::unique_ptr<SkLatticeIter> fIter;
         SkRect fDst;
         SkPMColor4f fColor;
+        // The lattice's bounds and center in the image, if fIsNinePatch.
+        SkIRect fSrc;
+        SkIRect fCenter;
+        bool fIsNinePatch;
     };
 
     Helper fHelper;
@@ -72,12 +72,15 @@ static inline GrVertexWriter::TriStrip<float> origin_centered_tri_strip(float x,
  * types of arcs.
  * Round caps for stroking are allowed as well. The caps are specified as two circle center points
  * in the same space as p.xy.
+ * Local coords are normally the position mapped by the local matrix. They can instead be given
+ * explicitly per vertex, which lets circles drawn with different view matrices share a draw.
  */
 
 class CircleGeometryProcessor : public GrGeometryProcessor {
 public:
     CircleGeometryProcessor(bool stroke, bool clipPlane, bool isectPlane, bool unionPlane,
-                            bool roundCaps, bool wideColor, const SkMatrix& localMatrix)
+                            bool roundCaps, bool wideColor, bool explicitLocalCoords,
+                            const SkMatrix& localMatrix)
             : INHERITED(kCircleGeometryProcessor_ClassID)
             , fLocalMatrix(localMatrix)
             , fStroke(stroke) {
@@ -100,7 +103,11 @@ public:
             fInRoundCapCenters =
                     {"inRoundCapCenters", kFloat4_GrVertexAttribType, kFloat4_GrSLType};
         }
-        this->setVertexAttributes(&fInPosition, 7);
+        if (explicitLocalCoords) {
+            SkASSERT(localMatrix.isIdentity());
+            fInLocalCoords = {"inLocalCoords", kFloat2_GrVertexAttribType, kFloat2_GrSLType};
+        }
+        this->setVertexAttributes(&fInPosition, 8);
     }
 
     ~CircleGeometryProcessor() override {}
@@ -166,7 +173,9 @@ private:
             this->emitTransforms(vertBuilder,
                                  varyingHandler,
                                  uniformHandler,
-                                 cgp.fInPosition.asShaderVar(),
+                                 cgp.fInLocalCoords.isInitialized()
+                                         ? cgp.fInLocalCoords.asShaderVar()
+                                         : cgp.fInPosition.asShaderVar(),
                                  cgp.fLocalMatrix,
                                  args.fFPCoordTransformHandler);
 
@@ -223,6 +232,7 @@ private:
             key |= cgp.fInIsectPlane.isInitialized() ? 0x08 : 0x0;
             key |= cgp.fInUnionPlane.isInitialized() ? 0x10 : 0x0;
             key |= cgp.fInRoundCapCenters.isInitialized() ? 0x20 : 0x0;
+            key |= cgp.fInLocalCoords.isInitialized() ? 0x40 : 0x0;
             b->add32(key);
         }
 
@@ -246,6 +256,7 @@ private:
     Attribute fInIsectPlane;
     Attribute fInUnionPlane;
     Attribute fInRoundCapCenters;
+    Attribute fInLocalCoords;
 
     bool fStroke;
     GR_DECLARE_GEOMETRY_PROCESSOR_TEST
@@ -263,9 +274,11 @@ sk_sp<GrGeometryProcessor> CircleGeometryProcessor::TestCreate(GrProcessorTestDa
     bool clipPlane = d->fRandom->nextBool();
     bool isectPlane = d->fRandom->nextBool();
     bool unionPlane = d->fRandom->nextBool();
-    const SkMatrix& matrix = GrTest::TestMatrix(d->fRandom);
+    bool explicitLocalCoords = d->fRandom->nextBool();
+    const SkMatrix& matrix = explicitLocalCoords ? SkMatrix::I() : GrTest::TestMatrix(d->fRandom);
     return sk_sp<GrGeometryProcessor>(new CircleGeometryProcessor(
-            stroke, clipPlane, isectPlane, unionPlane, roundCaps, wideColor, matrix));
+            stroke, clipPlane, isectPlane, unionPlane, roundCaps, wideColor, explicitLocalCoords,
+            matrix));
 }
 #endif
 
@@ -1170,15 +1183,18 @@ public:
 
 private:
     void onPrepareDraws(Target* target) override {
+        bool explicitLocalCoords = !fLocalMatrices.empty();
         SkMatrix localMatrix;
-        if (!fViewMatrixIfUsingLocalCoords.invert(&localMatrix)) {
+        if (explicitLocalCoords) {
+            localMatrix.reset();
+        } else if (!fViewMatrixIfUsingLocalCoords.invert(&localMatrix)) {
             return;
         }
 
         // Setup geometry processor
         sk_sp<GrGeometryProcessor> gp(new CircleGeometryProcessor(
                 !fAllFill, fClipPlane, fClipPlaneIsect, fClipPlaneUnion, fRoundCaps, fWideColor,
-                localMatrix));
+                explicitLocalCoords, localMatrix));
 
         const GrBuffer* vertexBuffer;
         int firstVertex;
@@ -1197,8 +1213,29 @@ private:
             return;
         }
 
+        // Writes the attributes that only some circles need, in the GP's attribute order.
+        auto writeOptionalAttribs = [&](int circleIdx, const SkPoint& devPos) {
+            const Circle& circle = fCircles[circleIdx];
+            if (fClipPlane) {
+                vertices.write(circle.fClipPlane);
+            }
+            if (fClipPlaneIsect) {
+                vertices.write(circle.fIsectPlane);
+            }
+            if (fClipPlaneUnion) {
+                vertices.write(circle.fUnionPlane);
+            }
+            if (fRoundCaps) {
+                vertices.write(circle.fRoundCapCenters);
+            }
+            if (explicitLocalCoords) {
+                vertices.write(fLocalMatrices[circleIdx].mapXY(devPos.fX, devPos.fY));
+            }
+        };
+
         int currStartVertex = 0;
-        for (const auto& circle : fCircles) {
+        for (int circleIdx = 0; circleIdx < fCircles.count(); ++circleIdx) {
+            const Circle& circle = fCircles[circleIdx];
             SkScalar innerRadius = circle.fInnerRadius;
             SkScalar outerRadius = circle.fOuterRadius;
             GrVertexColor color(circle.fColor, fWideColor);
@@ -1231,58 +1268,30 @@ private:
                 // compute the vertex position from this.
                 SkScalar dist = SkTMin(kOctagonOuter[i].dot(geoClipPlane) + offsetClipDist, 0.0f);
                 SkVector offset = kOctagonOuter[i] - geoClipPlane * dist;
-                vertices.write(center + offset * halfWidth,
+                SkPoint devPos = center + offset * halfWidth;
+                vertices.write(devPos,
                                color,
                                offset,
                                radii);
-                if (fClipPlane) {
-                    vertices.write(circle.fClipPlane);
-                }
-                if (fClipPlaneIsect) {
-                    vertices.write(circle.fIsectPlane);
-                }
-                if (fClipPlaneUnion) {
-                    vertices.write(circle.fUnionPlane);
-                }
-                if (fRoundCaps) {
-                    vertices.write(circle.fRoundCapCenters);
-                }
+                writeOptionalAttribs(circleIdx, devPos);
             }
 
             if (circle.fStroked) {
                 // compute the inner ring
 
                 for (int i = 0; i < 8; ++i) {
-                    vertices.write(center + kOctagonInner[i] * circle.fInnerRadius,
+                    SkPoint devPos = center + kOctagonInner[i] * circle.fInnerRadius;
+                    vertices.write(devPos,
                                    color,
                                    kOctagonInner[i] * innerRadius,
                                    radii);
-                    if (fClipPlane) {
-                        vertices.write(circle.fClipPlane);
-                    }
-                    if (fClipPlaneIsect) {
-                        vertices.write(circle.fIsectPlane);
-                    }
-                    if (fClipPlaneUnion) {
-                        vertices.write(circle.fUnionPlane);
-                    }
-                    if (fRoundCaps) {
-                        vertices.write(circle.fRoundCapCenters);
-                    }
+                    writeOptionalAttribs(circleIdx, devPos);
                 }
             } else {
                 // filled
                 vertices.write(center, color, SkPoint::Make(0, 0), radii);
-                if (fClipPlane) {
-                    vertices.write(circle.fClipPlane);
-                }
-                if (fClipPlaneIsect) {
-                    vertices.write(circle.fIsectPlane);
-                }
-                if (fClipPlaneUnion) {
-                    vertices.write(circle.fUnionPlane);
-                }
                 SkASSERT(!fRoundCaps);
+                writeOptionalAttribs(circleIdx, center);
             }
 
             const uint16_t* primIndices = circle_type_to_indices(circle.fStroked);
@@ -1314,9 +1323,14 @@ private:
             return CombineResult::kCannotCombine;
         }
 
+        // Circles drawn with different view matrices can still be batched by giving each vertex
+        // its own local coords.
         if (fHelper.usesLocalCoords() &&
-            !fViewMatrixIfUsingLocalCoords.cheapEqualTo(that->fViewMatrixIfUsingLocalCoords)) {
-            return CombineResult::kCannotCombine;
+            (!fLocalMatrices.empty() || !that->fLocalMatrices.empty() ||
+             !fViewMatrixIfUsingLocalCoords.cheapEqualTo(that->fViewMatrixIfUsingLocalCoords))) {
+            if (!this->makeLocalCoordsExplicit() || !that->makeLocalCoordsExplicit()) {
+                return CombineResult::kCannotCombine;
+            }
         }
 
         // Because we've set up the ops that don't use the planes with noop values
@@ -1328,12 +1342,27 @@ private:
         fWideColor |= that->fWideColor;
 
         fCircles.push_back_n(that->fCircles.count(), that->fCircles.begin());
+        fLocalMatrices.push_back_n(that->fLocalMatrices.count(), that->fLocalMatrices.begin());
         fVertCount += that->fVertCount;
         fIndexCount += that->fIndexCount;
         fAllFill = fAllFill && that->fAllFill;
         return CombineResult::kMerged;
     }
 
+    // Records the device-to-local matrix of every circle, so each vertex can carry its own local
+    // coords. Fails if the view matrix is not invertible.
+    bool makeLocalCoordsExplicit() {
+        if (!fLocalMatrices.empty()) {
+            return true;
+        }
+        SkMatrix localMatrix;
+        if (!fViewMatrixIfUsingLocalCoords.invert(&localMatrix)) {
+            return false;
+        }
+        fLocalMatrices.push_back_n(fCircles.count(), localMatrix);
+        return true;
+    }
+
     struct Circle {
         SkPMColor4f fColor;
         SkScalar fInnerRadius;
@@ -1349,6 +1378,9 @@ private:
     SkMatrix fViewMatrixIfUsingLocalCoords;
     Helper fHelper;
     SkSTArray<1, Circle, true> fCircles;
+    // Parallel to fCircles once circles with different view matrices have been merged, otherwise
+    // empty.
+    SkSTArray<1, SkMatrix, true> fLocalMatrices;
     int fVertCount;
     int fIndexCount;
     bool fAllFill;
@@ -2391,7 +2423,7 @@ private:
 
         // Setup geometry processor
         sk_sp<GrGeometryProcessor> gp(
-                new CircleGeometryProcessor(!fAllFill, false, false, false, false, false,
+                new CircleGeometryProcessor(!fAllFill, false, false, false, false, false, false,
                                             localMatrix));
 
         SkASSERT(sizeof(CircleVertex) == gp->vertexStride());
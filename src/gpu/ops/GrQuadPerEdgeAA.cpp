@@ -6,7 +6,9 @@
  */
 
 #include "GrQuadPerEdgeAA.h"
+#include "GrCaps.h"
 #include "GrQuad.h"
+#include "GrResourceProvider.h"
 #include "GrVertexWriter.h"
 #include "glsl/GrGLSLColorSpaceXformHelper.h"
 #include "glsl/GrGLSLGeometryProcessor.h"
@@ -362,6 +364,30 @@ static float compute_nonaa_edge_distances(const Sk4f& w, bool hasPersp, Sk4f edg
     return 1.f;
 }
 
+// Writes the quad as one instance; the vertex shader selects each corner with dot products.
+static void* write_instance(void* instances, const GrQuadPerEdgeAA::VertexSpec& spec,
+                            const GrPerspQuad& deviceQuad, const GrVertexColor& color,
+                            const GrPerspQuad& localQuad, const SkRect& domain) {
+    GrVertexWriter vb{instances};
+    vb.write(deviceQuad.x4f(), deviceQuad.y4f());
+    if (spec.deviceQuadType() == GrQuadType::kPerspective) {
+        vb.write(deviceQuad.w4f());
+    }
+    if (spec.hasVertexColors()) {
+        vb.write(color);
+    }
+    if (spec.hasLocalCoords()) {
+        vb.write(localQuad.x4f(), localQuad.y4f());
+        if (spec.localQuadType() == GrQuadType::kPerspective) {
+            vb.write(localQuad.w4f());
+        }
+    }
+    if (spec.hasDomain()) {
+        vb.write(domain);
+    }
+    return vb.fPtr;
+}
+
 } // anonymous namespace
 
 namespace GrQuadPerEdgeAA {
@@ -375,6 +401,10 @@ void* Tessellate(void* vertices, const VertexSpec& spec, const GrPerspQuad& devi
     bool localHasPerspective = spec.localQuadType() == GrQuadType::kPerspective;
     GrVertexColor color(color4f, GrQuadPerEdgeAA::ColorType::kHalf == spec.colorType());
 
+    if (spec.isInstanced()) {
+        return write_instance(vertices, spec, deviceQuad, color, localQuad, domain);
+    }
+
     // Load position data into Sk4fs (always x, y, and load w to avoid branching down the road)
     Sk4f x = deviceQuad.x4f();
     Sk4f y = deviceQuad.y4f();
@@ -451,6 +481,25 @@ void* Tessellate(void* vertices, const VertexSpec& spec, const GrPerspQuad& devi
     return vb.fPtr;
 }
 
+////////////////// Instancing Implementation
+
+bool CanUseInstancing(const GrCaps& caps, GrAAType aaType) {
+    return caps.instanceAttribSupport() && GrAAType::kCoverage != aaType;
+}
+
+GR_DECLARE_STATIC_UNIQUE_KEY(gCornerBufferKey);
+
+sk_sp<const GrBuffer> FindOrMakeCornerBuffer(GrResourceProvider* resourceProvider) {
+    // One-hot selectors for the corners in their triangle strip order.
+    static constexpr float kCorners[4][4] = {{1, 0, 0, 0},
+                                             {0, 1, 0, 0},
+                                             {0, 0, 1, 0},
+                                             {0, 0, 0, 1}};
+    GR_DEFINE_STATIC_UNIQUE_KEY(gCornerBufferKey);
+    return resourceProvider->findOrMakeStaticBuffer(kVertex_GrBufferType, sizeof(kCorners),
+                                                    kCorners, gCornerBufferKey);
+}
+
 ////////////////// VertexSpec Implementation
 
 int VertexSpec::deviceDimensionality() const {
@@ -485,7 +534,7 @@ public:
     void getGLSLProcessorKey(const GrShaderCaps&, GrProcessorKeyBuilder* b) const override {
         // aa, domain, texturing are single bit flags
         uint32_t x = fAAEdgeDistances.isInitialized() ? 0 : 1;
-        x |= fDomain.isInitialized() ? 0 : 2;
+        x |= this->domain().isInitialized() ? 0 : 2;
         x |= fSampler.isInitialized() ? 0 : 4;
         // regular position has two options as well
         x |= fNeedsPerspective ? 0 : 8;
@@ -494,9 +543,14 @@ public:
             x |= kFloat3_GrVertexAttribType == fLocalCoord.cpuType() ? 16 : 32;
         }
         // similar for colors, 00 for none, 01 for bytes, 10 for half-floats
-        if (this->fColor.isInitialized()) {
-            x |= kUByte4_norm_GrVertexAttribType == fColor.cpuType() ? 64 : 128;
+        if (this->color().isInitialized()) {
+            x |= kUByte4_norm_GrVertexAttribType == this->color().cpuType() ? 64 : 128;
         }
+        // local coords of instances are split into channels, so they need their own bits
+        if (fLocalX.isInitialized()) {
+            x |= fLocalW.isInitialized() ? 256 : 512;
+        }
+        x |= fCorner.isInitialized() ? 1024 : 0;
 
         b->add32(GrColorSpaceXform::XformKey(fTextureColorSpaceXform.get()));
         b->add32(x);
@@ -508,7 +562,7 @@ public:
             void setData(const GrGLSLProgramDataManager& pdman, const GrPrimitiveProcessor& proc,
                          FPCoordTransformIter&& transformIter) override {
                 const auto& gp = proc.cast<QuadPerEdgeAAGeometryProcessor>();
-                if (gp.fLocalCoord.isInitialized()) {
+                if (gp.hasLocalCoords()) {
                     this->setTransformDataHelper(SkMatrix::I(), pdman, &transformIter);
                 }
                 fTextureColorSpaceXformHelper.setData(pdman, gp.fTextureColorSpaceXform.get());
@@ -524,8 +578,33 @@ public:
 
                 args.fVaryingHandler->emitAttributes(gp);
 
-                // Extract effective position out of vec4 as a local variable in the vertex shader
-                if (gp.fNeedsPerspective) {
+                if (gp.fCorner.isInitialized()) {
+                    // Select this vertex's corner out of the instance's x4, y4 and w4 vectors
+                    const char* corner = gp.fCorner.name();
+                    if (gp.fNeedsPerspective) {
+                        args.fVertBuilder->codeAppendf(
+                                "float3 position = float3(dot(%s, %s), dot(%s, %s), dot(%s, %s));",
+                                gp.fDeviceX.name(), corner, gp.fDeviceY.name(), corner,
+                                gp.fDeviceW.name(), corner);
+                    } else {
+                        args.fVertBuilder->codeAppendf(
+                                "float2 position = float2(dot(%s, %s), dot(%s, %s));",
+                                gp.fDeviceX.name(), corner, gp.fDeviceY.name(), corner);
+                    }
+                    if (gp.fLocalW.isInitialized()) {
+                        args.fVertBuilder->codeAppendf(
+                                "float3 localCoord = float3(dot(%s, %s), dot(%s, %s), "
+                                                           "dot(%s, %s));",
+                                gp.fLocalX.name(), corner, gp.fLocalY.name(), corner,
+                                gp.fLocalW.name(), corner);
+                    } else if (gp.fLocalX.isInitialized()) {
+                        args.fVertBuilder->codeAppendf(
+                                "float2 localCoord = float2(dot(%s, %s), dot(%s, %s));",
+                                gp.fLocalX.name(), corner, gp.fLocalY.name(), corner);
+                    }
+                } else if (gp.fNeedsPerspective) {
+                    // Extract effective position out of vec4 as a local variable in the vertex
+                    // shader
                     args.fVertBuilder->codeAppendf("float3 position = %s.xyz;",
                                                    gp.fPositionWithCoverage.name());
                 } else {
@@ -536,21 +615,22 @@ public:
                                         gp.fNeedsPerspective ? kFloat3_GrSLType : kFloat2_GrSLType,
                                         GrShaderVar::kNone_TypeModifier};
 
-                // Handle local coordinates if they exist
-                if (gp.fLocalCoord.isInitialized()) {
+                // Handle local coordinates if they exist. Either way they're available to the
+                // vertex shader as "localCoord".
+                if (gp.hasLocalCoords()) {
                     // NOTE: If the only usage of local coordinates is for the inline texture fetch
                     // before FPs, then there are no registered FPCoordTransforms and this ends up
                     // emitting nothing, so there isn't a duplication of local coordinates
                     this->emitTransforms(args.fVertBuilder,
                                          args.fVaryingHandler,
                                          args.fUniformHandler,
-                                         gp.fLocalCoord.asShaderVar(),
+                                         GrShaderVar("localCoord", gp.localCoordType()),
                                          args.fFPCoordTransformHandler);
                 }
 
                 // Solid color before any texturing gets modulated in
-                if (gp.fColor.isInitialized()) {
-                    args.fVaryingHandler->addPassThroughAttribute(gp.fColor, args.fOutputColor,
+                if (gp.color().isInitialized()) {
+                    args.fVaryingHandler->addPassThroughAttribute(gp.color(), args.fOutputColor,
                                                                   Interpolation::kCanBeFlat);
                 }
 
@@ -560,22 +640,27 @@ public:
                     // Texture coordinates clamped by the domain on the fragment shader; if the GP
                     // has a texture, it's guaranteed to have local coordinates
                     args.fFragBuilder->codeAppend("float2 texCoord;");
-                    if (gp.fLocalCoord.cpuType() == kFloat3_GrVertexAttribType) {
+                    if (kFloat3_GrSLType == gp.localCoordType()) {
                         // Can't do a pass through since we need to perform perspective division
-                        GrGLSLVarying v(gp.fLocalCoord.gpuType());
-                        args.fVaryingHandler->addVarying(gp.fLocalCoord.name(), &v);
-                        args.fVertBuilder->codeAppendf("%s = %s;",
-                                                       v.vsOut(), gp.fLocalCoord.name());
+                        GrGLSLVarying v(kFloat3_GrSLType);
+                        args.fVaryingHandler->addVarying("localCoord", &v);
+                        args.fVertBuilder->codeAppendf("%s = localCoord;", v.vsOut());
                         args.fFragBuilder->codeAppendf("texCoord = %s.xy / %s.z;",
                                                        v.fsIn(), v.fsIn());
+                    } else if (gp.fCorner.isInitialized()) {
+                        // Instanced local coords are computed, not read from an attribute
+                        GrGLSLVarying v(kFloat2_GrSLType);
+                        args.fVaryingHandler->addVarying("localCoord", &v);
+                        args.fVertBuilder->codeAppendf("%s = localCoord;", v.vsOut());
+                        args.fFragBuilder->codeAppendf("texCoord = %s;", v.fsIn());
                     } else {
                         args.fVaryingHandler->addPassThroughAttribute(gp.fLocalCoord, "texCoord");
                     }
 
                     // Clamp the now 2D localCoordName variable by the domain if it is provided
-                    if (gp.fDomain.isInitialized()) {
+                    if (gp.domain().isInitialized()) {
                         args.fFragBuilder->codeAppend("float4 domain;");
-                        args.fVaryingHandler->addPassThroughAttribute(gp.fDomain, "domain",
+                        args.fVaryingHandler->addPassThroughAttribute(gp.domain(), "domain",
                                                                       Interpolation::kCanBeFlat);
                         args.fFragBuilder->codeAppend(
                                 "texCoord = clamp(texCoord, domain.xy, domain.zw);");
@@ -648,6 +733,10 @@ private:
 
     void initializeAttrs(const VertexSpec& spec) {
         fNeedsPerspective = spec.deviceDimensionality() == 3;
+        if (spec.isInstanced()) {
+            this->initializeInstanceAttrs(spec);
+            return;
+        }
         fPositionWithCoverage = {"posAndCoverage", kFloat4_GrVertexAttribType, kFloat4_GrSLType};
 
         int localDim = spec.localDimensionality();
@@ -673,14 +762,67 @@ private:
         this->setVertexAttributes(&fPositionWithCoverage, 5);
     }
 
+    void initializeInstanceAttrs(const VertexSpec& spec) {
+        SkASSERT(!spec.usesCoverageAA());
+        fCorner = {"corner", kFloat4_GrVertexAttribType, kFloat4_GrSLType};
+
+        fDeviceX = {"deviceX", kFloat4_GrVertexAttribType, kFloat4_GrSLType};
+        fDeviceY = {"deviceY", kFloat4_GrVertexAttribType, kFloat4_GrSLType};
+        if (fNeedsPerspective) {
+            fDeviceW = {"deviceW", kFloat4_GrVertexAttribType, kFloat4_GrSLType};
+        }
+
+        if (ColorType::kByte == spec.colorType()) {
+            fInstanceColor = {"color", kUByte4_norm_GrVertexAttribType, kHalf4_GrSLType};
+        } else if (ColorType::kHalf == spec.colorType()) {
+            fInstanceColor = {"color", kHalf4_GrVertexAttribType, kHalf4_GrSLType};
+        }
+
+        if (spec.hasLocalCoords()) {
+            fLocalX = {"localX", kFloat4_GrVertexAttribType, kFloat4_GrSLType};
+            fLocalY = {"localY", kFloat4_GrVertexAttribType, kFloat4_GrSLType};
+            if (spec.localDimensionality() == 3) {
+                fLocalW = {"localW", kFloat4_GrVertexAttribType, kFloat4_GrSLType};
+            }
+        }
+
+        if (spec.hasDomain()) {
+            fInstanceDomain = {"domain", kFloat4_GrVertexAttribType, kFloat4_GrSLType};
+        }
+        this->setVertexAttributes(&fCorner, 1);
+        this->setInstanceAttributes(&fDeviceX, 8);
+    }
+
     const TextureSampler& onTextureSampler(int) const override { return fSampler; }
 
+    const Attribute& color() const { return fCorner.isInitialized() ? fInstanceColor : fColor; }
+    const Attribute& domain() const {
+        return fCorner.isInitialized() ? fInstanceDomain : fDomain;
+    }
+    bool hasLocalCoords() const { return fLocalCoord.isInitialized() || fLocalX.isInitialized(); }
+    GrSLType localCoordType() const {
+        return fLocalW.isInitialized() || kFloat3_GrSLType == fLocalCoord.gpuType()
+                ? kFloat3_GrSLType : kFloat2_GrSLType;
+    }
+
+    // Per vertex attributes when not instanced
     Attribute fPositionWithCoverage;
     Attribute fColor;
     Attribute fLocalCoord;
     Attribute fDomain;
     Attribute fAAEdgeDistances;
 
+    // Attributes when instanced, which never has coverage AA. fCorner is the only vertex attribute.
+    Attribute fCorner;
+    Attribute fDeviceX;
+    Attribute fDeviceY;
+    Attribute fDeviceW;
+    Attribute fInstanceColor;
+    Attribute fLocalX;
+    Attribute fLocalY;
+    Attribute fLocalW;
+    Attribute fInstanceDomain;
+
     // The positions attribute is always a vec4 and can't be used to encode perspectiveness
     bool fNeedsPerspective;
 
@@ -16,12 +16,16 @@
 #include "SkPoint.h"
 #include "SkPoint3.h"
 
+class GrBuffer;
+class GrCaps;
 class GrColorSpaceXform;
+class GrResourceProvider;
 class GrShaderCaps;
 
 namespace GrQuadPerEdgeAA {
 
     enum class Domain : bool { kNo = false, kYes = true };
+    enum class Instanced : bool { kNo = false, kYes = true };
     enum class ColorType { kNone, kByte, kHalf, kLast = kHalf };
     static const int kColorTypeCount = static_cast<int>(ColorType::kLast) + 1;
 
@@ -29,16 +33,24 @@ namespace GrQuadPerEdgeAA {
     // order (when enabled) is device position, color, local position, domain, aa edge equations.
     // This order matches the constructor argument order of VertexSpec and is the order that
     // GPAttributes maintains. If hasLocalCoords is false, then the local quad type can be ignored.
+    //
+    // When instanced, each quad is written as a single instance that holds the four corners of the
+    // positions and local coords (as x4, y4 and optionally w4 vectors) followed by the color and
+    // domain. The vertex shader picks the corner. See CanUseInstancing.
     struct VertexSpec {
     public:
         VertexSpec(GrQuadType deviceQuadType, ColorType colorType, GrQuadType localQuadType,
-                   bool hasLocalCoords, Domain domain, GrAAType aa)
+                   bool hasLocalCoords, Domain domain, GrAAType aa,
+                   Instanced instanced = Instanced::kNo)
                 : fDeviceQuadType(static_cast<unsigned>(deviceQuadType))
                 , fLocalQuadType(static_cast<unsigned>(localQuadType))
                 , fHasLocalCoords(hasLocalCoords)
                 , fColorType(static_cast<unsigned>(colorType))
                 , fHasDomain(static_cast<unsigned>(domain))
-                , fUsesCoverageAA(aa == GrAAType::kCoverage) { }
+                , fUsesCoverageAA(aa == GrAAType::kCoverage)
+                , fInstanced(static_cast<unsigned>(instanced)) {
+            SkASSERT(!fInstanced || !fUsesCoverageAA);
+        }
 
         GrQuadType deviceQuadType() const { return static_cast<GrQuadType>(fDeviceQuadType); }
         GrQuadType localQuadType() const { return static_cast<GrQuadType>(fLocalQuadType); }
@@ -47,6 +59,7 @@ namespace GrQuadPerEdgeAA {
         bool hasVertexColors() const { return ColorType::kNone != this->colorType(); }
         bool hasDomain() const { return fHasDomain; }
         bool usesCoverageAA() const { return fUsesCoverageAA; }
+        bool isInstanced() const { return fInstanced; }
 
         // Will always be 2 or 3
         int deviceDimensionality() const;
@@ -63,8 +76,17 @@ namespace GrQuadPerEdgeAA {
         unsigned fColorType : 2;
         unsigned fHasDomain: 1;
         unsigned fUsesCoverageAA: 1;
+        unsigned fInstanced: 1;
     };
 
+    // Instancing moves the per-vertex expansion of a quad to the vertex shader. It needs instanced
+    // attributes and isn't used with coverage AA, whose outset corners are computed on the CPU.
+    bool CanUseInstancing(const GrCaps&, GrAAType);
+
+    // Returns the static vertex buffer that instanced draws expand each quad with. Draw it as a
+    // 4 vertex triangle strip.
+    sk_sp<const GrBuffer> FindOrMakeCornerBuffer(GrResourceProvider*);
+
     sk_sp<GrGeometryProcessor> MakeProcessor(const VertexSpec& spec);
 
     sk_sp<GrGeometryProcessor> MakeTexturedProcessor(const VertexSpec& spec,
@@ -75,7 +97,8 @@ namespace GrQuadPerEdgeAA {
     // Fill vertices with the vertex data needed to represent the given quad. The device position,
     // local coords, vertex color, domain, and edge coefficients will be written and/or computed
     // based on the configuration in the vertex spec; if that attribute is disabled in the spec,
-    // then its corresponding function argument is ignored.
+    // then its corresponding function argument is ignored. An instanced spec writes one instance
+    // instead of four vertices.
     //
     // Returns the advanced pointer in vertices.
     void* Tessellate(void* vertices, const VertexSpec& spec, const GrPerspQuad& deviceQuad,
@@ -16,13 +16,16 @@
 #include "GrResourceProvider.h"
 #include "GrSimpleMeshDrawOpHelper.h"
 #include "GrVertexWriter.h"
-#include "SkAutoMalloc.h"
 #include "SkAutoPixmapStorage.h"
 #include "SkDistanceFieldGen.h"
 #include "SkDraw.h"
+#include "SkLRUCache.h"
+#include "SkMutex.h"
 #include "SkPaint.h"
 #include "SkPointPriv.h"
 #include "SkRasterClip.h"
+#include "SkSemaphore.h"
+#include "SkTaskGroup.h"
 #include "effects/GrBitmapTextGeoProc.h"
 #include "effects/GrDistanceFieldGeoProc.h"
 #include "ops/GrMeshDrawOp.h"
@@ -133,6 +136,357 @@ public:
     }
 };
 
+// padding around path bounds to allow for antialiased pixels
+static const SkScalar kAntiAliasPad = 1.0f;
+
+// A shape's distance field or coverage mask, rendered on the CPU. Nothing in it belongs to a
+// context, so it is made on any thread and can be uploaded to any context's atlas.
+class PathMask : public SkNVRefCnt<PathMask> {
+public:
+    // The distance field of the path scaled by 'scale', with its fractional offset burnt in.
+    static sk_sp<PathMask> MakeDistanceField(const SkPath& path, const SkRect& bounds,
+                                             SkScalar scale) {
+        // generate bounding rect for bitmap draw
+        SkRect scaledBounds = bounds;
+        // scale to mip level size
+        scaledBounds.fLeft *= scale;
+        scaledBounds.fTop *= scale;
+        scaledBounds.fRight *= scale;
+        scaledBounds.fBottom *= scale;
+        // subtract out integer portion of origin
+        // (SDF created will be placed with fractional offset burnt in)
+        SkScalar dx = SkScalarFloorToScalar(scaledBounds.fLeft);
+        SkScalar dy = SkScalarFloorToScalar(scaledBounds.fTop);
+        scaledBounds.offset(-dx, -dy);
+        // get integer boundary
+        SkIRect devPathBounds;
+        scaledBounds.roundOut(&devPathBounds);
+        // pad to allow room for antialiasing
+        const int intPad = SkScalarCeilToInt(kAntiAliasPad);
+        // place devBounds at origin
+        int width = devPathBounds.width() + 2*intPad;
+        int height = devPathBounds.height() + 2*intPad;
+        devPathBounds = SkIRect::MakeWH(width, height);
+        SkScalar translateX = intPad - dx;
+        SkScalar translateY = intPad - dy;
+
+        // draw path to bitmap
+        SkMatrix drawMatrix;
+        drawMatrix.setScale(scale, scale);
+        drawMatrix.postTranslate(translateX, translateY);
+
+        SkASSERT(devPathBounds.fLeft == 0);
+        SkASSERT(devPathBounds.fTop == 0);
+        SkASSERT(devPathBounds.width() > 0);
+        SkASSERT(devPathBounds.height() > 0);
+
+        // setup signed distance field storage
+        SkIRect dfBounds = devPathBounds.makeOutset(SK_DistanceFieldPad, SK_DistanceFieldPad);
+        sk_sp<PathMask> mask(new PathMask(dfBounds.width(), dfBounds.height()));
+        width = mask->fWidth;
+        height = mask->fHeight;
+
+#ifndef SK_USE_LEGACY_DISTANCE_FIELDS
+        // Generate signed distance field directly from SkPath
+        bool succeed = GrGenerateDistanceFieldFromPath(mask->fImage.get(),
+                                        path, drawMatrix,
+                                        width, height, width * sizeof(unsigned char));
+        if (!succeed) {
+#endif
+            // setup bitmap backing
+            SkAutoPixmapStorage dst;
+            if (!dst.tryAlloc(SkImageInfo::MakeA8(devPathBounds.width(),
+                                                  devPathBounds.height()))) {
+                return nullptr;
+            }
+            sk_bzero(dst.writable_addr(), dst.computeByteSize());
+
+            // rasterize path
+            SkPaint paint;
+            paint.setStyle(SkPaint::kFill_Style);
+            paint.setAntiAlias(true);
+
+            SkDraw draw;
+
+            SkRasterClip rasterClip;
+            rasterClip.setRect(devPathBounds);
+            draw.fRC = &rasterClip;
+            draw.fMatrix = &drawMatrix;
+            draw.fDst = dst;
+
+            draw.drawPathCoverage(path, paint);
+
+            // Generate signed distance field
+            SkGenerateDistanceFieldFromA8Image(mask->fImage.get(),
+                                               (const unsigned char*)dst.addr(),
+                                               dst.width(), dst.height(), dst.rowBytes());
+#ifndef SK_USE_LEGACY_DISTANCE_FIELDS
+        }
+#endif
+
+        mask->fBounds = SkRect::Make(devPathBounds);
+        mask->fBounds.offset(-translateX, -translateY);
+        mask->fBounds.fLeft /= scale;
+        mask->fBounds.fTop /= scale;
+        mask->fBounds.fRight /= scale;
+        mask->fBounds.fBottom /= scale;
+        mask->fTexRect = devPathBounds.makeOffset(SK_DistanceFieldPad, SK_DistanceFieldPad);
+        return mask;
+    }
+
+    // The coverage of the path drawn with ctm, keeping only the fractional part of its
+    // translation.
+    static sk_sp<PathMask> MakeBitmap(const SkPath& path, const SkRect& bounds,
+                                      const SkMatrix& ctm) {
+        if (bounds.isEmpty()) {
+            return nullptr;
+        }
+        SkMatrix drawMatrix(ctm);
+        SkScalar tx = ctm.getTranslateX();
+        SkScalar ty = ctm.getTranslateY();
+        tx -= SkScalarFloorToScalar(tx);
+        ty -= SkScalarFloorToScalar(ty);
+        drawMatrix.set(SkMatrix::kMTransX, tx);
+        drawMatrix.set(SkMatrix::kMTransY, ty);
+        SkRect shapeDevBounds;
+        drawMatrix.mapRect(&shapeDevBounds, bounds);
+        SkScalar dx = SkScalarFloorToScalar(shapeDevBounds.fLeft);
+        SkScalar dy = SkScalarFloorToScalar(shapeDevBounds.fTop);
+
+        // get integer boundary
+        SkIRect devPathBounds;
+        shapeDevBounds.roundOut(&devPathBounds);
+        // pad to allow room for antialiasing
+        const int intPad = SkScalarCeilToInt(kAntiAliasPad);
+        // place devBounds at origin
+        int width = devPathBounds.width() + 2 * intPad;
+        int height = devPathBounds.height() + 2 * intPad;
+        devPathBounds = SkIRect::MakeWH(width, height);
+        SkScalar translateX = intPad - dx;
+        SkScalar translateY = intPad - dy;
+
+        SkASSERT(devPathBounds.fLeft == 0);
+        SkASSERT(devPathBounds.fTop == 0);
+        SkASSERT(devPathBounds.width() > 0);
+        SkASSERT(devPathBounds.height() > 0);
+
+        // setup bitmap backing
+        sk_sp<PathMask> mask(new PathMask(width, height));
+        SkPixmap dst(SkImageInfo::MakeA8(width, height), mask->fImage.get(), width);
+        sk_bzero(dst.writable_addr(), dst.computeByteSize());
+
+        // rasterize path
+        SkPaint paint;
+        paint.setStyle(SkPaint::kFill_Style);
+        paint.setAntiAlias(true);
+
+        SkDraw draw;
+
+        SkRasterClip rasterClip;
+        rasterClip.setRect(devPathBounds);
+        draw.fRC = &rasterClip;
+        drawMatrix.postTranslate(translateX, translateY);
+        draw.fMatrix = &drawMatrix;
+        draw.fDst = dst;
+
+        draw.drawPathCoverage(path, paint);
+
+        mask->fBounds = SkRect::Make(devPathBounds);
+        mask->fBounds.offset(-translateX, -translateY);
+        mask->fTexRect = devPathBounds;
+        return mask;
+    }
+
+    int width() const { return fWidth; }
+    int height() const { return fHeight; }
+    const void* image() const { return fImage.get(); }
+    // Where the shape is drawn, in its local space for distance fields and in device space less
+    // the integer translation for bitmaps.
+    const SkRect& bounds() const { return fBounds; }
+    // The part of the image that bounds() maps to.
+    const SkIRect& texRect() const { return fTexRect; }
+
+private:
+    PathMask(int width, int height)
+            : fWidth(width), fHeight(height), fImage(width * height) {}
+
+    int fWidth;
+    int fHeight;
+    SkAutoTMalloc<uint8_t> fImage;
+    SkRect fBounds;
+    SkIRect fTexRect;
+};
+
+// Masks are the expensive part of drawing a small path, and don't depend on the context, so the
+// most recently used ones are kept for every context in the process to upload. This lets the
+// contexts of a share group, and contexts that draw prewarmed paths, skip generating them.
+class SharedPathMasks {
+public:
+    static sk_sp<PathMask> Find(const ShapeDataKey& key) {
+        SkAutoMutexAcquire lock(gMutex);
+        sk_sp<PathMask>* mask = Cache()->find(key);
+        return mask ? *mask : nullptr;
+    }
+
+    static void Add(const ShapeDataKey& key, sk_sp<PathMask> mask) {
+        SkAutoMutexAcquire lock(gMutex);
+        if (!Cache()->find(key)) {
+            Cache()->insert(key, std::move(mask));
+        }
+    }
+
+private:
+    struct KeyHash {
+        uint32_t operator()(const ShapeDataKey& key) const { return ShapeData::Hash(key); }
+    };
+    using Cache_t = SkLRUCache<ShapeDataKey, sk_sp<PathMask>, KeyHash>;
+
+    // Masks are at most a few tens of KB, and icons much smaller than that.
+    static constexpr int kMaxMasks = 256;
+
+    static Cache_t* Cache() {
+        static Cache_t* cache = new Cache_t(kMaxMasks);
+        return cache;
+    }
+
+    static SkMutex gMutex;
+};
+
+SkMutex SharedPathMasks::gMutex;
+
+// Whether the shape is drawn from a distance field rather than a coverage mask, given its device
+// bounds (including AA bloat).
+static bool uses_distance_field(const SkRect& devBounds, const SkMatrix& viewMatrix) {
+#if defined(SK_BUILD_FOR_ANDROID) && !defined(SK_BUILD_FOR_ANDROID_FRAMEWORK)
+    bool usesDistanceField = true;
+#else
+    // only use distance fields on desktop and Android framework to save space in the atlas
+    bool usesDistanceField = devBounds.width() > kMaxMIP || devBounds.height() > kMaxMIP;
+#endif
+    // always use distance fields if in perspective
+    return usesDistanceField || viewMatrix.hasPerspective();
+}
+
+// The dimension of the distance field for a shape drawn with viewMatrix. Its scale relative to
+// the shape is this over the shape's larger dimension.
+static SkScalar distance_field_dimension(const SkRect& bounds, const SkMatrix& viewMatrix) {
+    // get mip level
+    SkScalar maxScale;
+    if (viewMatrix.hasPerspective()) {
+        // approximate the scale since we can't get it from the matrix
+        SkRect xformedBounds;
+        viewMatrix.mapRect(&xformedBounds, bounds);
+        maxScale = SkScalarAbs(SkTMax(xformedBounds.width() / bounds.width(),
+                                      xformedBounds.height() / bounds.height()));
+    } else {
+        maxScale = SkScalarAbs(viewMatrix.getMaxScale());
+    }
+    SkScalar maxDim = SkMaxScalar(bounds.width(), bounds.height());
+    // We try to create the DF at a 2^n scaled path resolution (1/2, 1, 2, 4, etc.)
+    // In the majority of cases this will yield a crisper rendering.
+    SkScalar mipScale = 1.0f;
+    // Our mipscale is the maxScale clamped to the next highest power of 2
+    if (maxScale <= SK_ScalarHalf) {
+        SkScalar log = SkScalarFloorToScalar(SkScalarLog2(SkScalarInvert(maxScale)));
+        mipScale = SkScalarPow(2, -log);
+    } else if (maxScale > SK_Scalar1) {
+        SkScalar log = SkScalarCeilToScalar(SkScalarLog2(maxScale));
+        mipScale = SkScalarPow(2, log);
+    }
+    SkASSERT(maxScale <= mipScale);
+
+    SkScalar mipSize = mipScale*SkScalarAbs(maxDim);
+    // For sizes less than kIdealMinMIP we want to use as large a distance field as we can
+    // so we can preserve as much detail as possible. However, we can't scale down more
+    // than a 1/4 of the size without artifacts. So the idea is that we pick the mipsize
+    // just bigger than the ideal, and then scale down until we are no more than 4x the
+    // original mipsize.
+    if (mipSize < kIdealMinMIP) {
+        SkScalar newMipSize = mipSize;
+        do {
+            newMipSize *= 2;
+        } while (newMipSize < kIdealMinMIP);
+        while (newMipSize > 4 * mipSize) {
+            newMipSize *= 0.25f;
+        }
+        mipSize = newMipSize;
+    }
+    return SkTMin(mipSize, kMaxMIP);
+}
+
+// Only support paths with bounds within kMaxDim by kMaxDim,
+// scaled to have bounds within kMaxSize by kMaxSize.
+// The goal is to accelerate rendering of lots of small paths that may be scaling.
+static bool fits_size_limits(const SkRect& bounds, const SkMatrix& viewMatrix) {
+    SkScalar scaleFactors[2] = { 1, 1 };
+    if (!viewMatrix.hasPerspective() && !viewMatrix.getMinMaxScales(scaleFactors)) {
+        return false;
+    }
+    SkScalar minDim = SkMinScalar(bounds.width(), bounds.height());
+    SkScalar maxDim = SkMaxScalar(bounds.width(), bounds.height());
+    SkScalar minSize = minDim * SkScalarAbs(scaleFactors[0]);
+    SkScalar maxSize = maxDim * SkScalarAbs(scaleFactors[1]);
+    return maxDim <= kMaxDim && kMinSize <= minSize && maxSize <= kMaxSize;
+}
+
+// What to draw a shape with: its cache key, and how to generate its mask on a miss.
+struct MaskRequest {
+    MaskRequest(const GrShape& shape, const SkMatrix& viewMatrix, bool usesDistanceField)
+            : fBounds(shape.bounds())
+            , fViewMatrix(viewMatrix)
+            , fUsesDistanceField(usesDistanceField) {
+        if (usesDistanceField) {
+            SkScalar desiredDimension = distance_field_dimension(fBounds, viewMatrix);
+            fScale = desiredDimension / SkMaxScalar(fBounds.width(), fBounds.height());
+            fKey.set(shape, SkScalarCeilToInt(desiredDimension));
+        } else {
+            fKey.set(shape, viewMatrix);
+        }
+        shape.asPath(&fPath);
+    }
+
+    // Safe to call on any thread.
+    sk_sp<PathMask> makeMask() const {
+        return fUsesDistanceField ? PathMask::MakeDistanceField(fPath, fBounds, fScale)
+                                  : PathMask::MakeBitmap(fPath, fBounds, fViewMatrix);
+    }
+
+    ShapeDataKey fKey;
+    SkPath       fPath;
+    SkRect       fBounds;
+    SkMatrix     fViewMatrix;
+    SkScalar     fScale = 1;
+    bool         fUsesDistanceField;
+};
+
+// Makes the masks of requests[i] for each i in indices into masks[i], spreading them over the
+// task group's threads if there is one, and adds them to SharedPathMasks.
+static void make_masks(SkTaskGroup* taskGroup, const MaskRequest requests[],
+                       const SkTDArray<int>& indices, sk_sp<PathMask> masks[]) {
+    if (taskGroup && indices.count() > 1) {
+        // The task group may be running other work too, so we wait for just our masks.
+        SkSemaphore done;
+        for (int i : indices) {
+            taskGroup->add([&, i]() {
+                masks[i] = requests[i].makeMask();
+                done.signal();
+            });
+        }
+        for (int n = 0; n < indices.count(); n++) {
+            done.wait();
+        }
+    } else {
+        for (int i : indices) {
+            masks[i] = requests[i].makeMask();
+        }
+    }
+    for (int i : indices) {
+        if (masks[i]) {
+            SharedPathMasks::Add(requests[i].fKey, masks[i]);
+        }
+    }
+}
+
 
 
 // Callback to clear out internal path cache when eviction occurs
@@ -195,29 +549,52 @@ GrPathRenderer::CanDrawPath GrSmallPathRenderer::onCanDrawPath(const CanDrawPath
         return CanDrawPath::kNo;
     }
 
-    // Only support paths with bounds within kMaxDim by kMaxDim,
-    // scaled to have bounds within kMaxSize by kMaxSize.
-    // The goal is to accelerate rendering of lots of small paths that may be scaling.
-    SkScalar scaleFactors[2] = { 1, 1 };
-    if (!args.fViewMatrix->hasPerspective() && !args.fViewMatrix->getMinMaxScales(scaleFactors)) {
-        return CanDrawPath::kNo;
-    }
-    SkRect bounds = args.fShape->styledBounds();
-    SkScalar minDim = SkMinScalar(bounds.width(), bounds.height());
-    SkScalar maxDim = SkMaxScalar(bounds.width(), bounds.height());
-    SkScalar minSize = minDim * SkScalarAbs(scaleFactors[0]);
-    SkScalar maxSize = maxDim * SkScalarAbs(scaleFactors[1]);
-    if (maxDim > kMaxDim || kMinSize > minSize || maxSize > kMaxSize) {
+    if (!fits_size_limits(args.fShape->styledBounds(), *args.fViewMatrix)) {
         return CanDrawPath::kNo;
     }
 
     return CanDrawPath::kYes;
 }
 
-////////////////////////////////////////////////////////////////////////////////
+void GrSmallPathRenderer::PrewarmMasks(const GrCaps& caps, const SkPath paths[], int count,
+                                       const SkMatrix& viewMatrix, SkTaskGroup* taskGroup) {
+    if (!caps.shaderCaps()->shaderDerivativeSupport()) {
+        return;
+    }
+    SkSTArray<8, MaskRequest> requests(count);
+    SkTDArray<int> misses;
+    for (int i = 0; i < count; i++) {
+        GrShape shape(paths[i], GrStyle::SimpleFill());
+        if (!shape.hasUnstyledKey() || shape.isEmpty() || shape.inverseFilled() ||
+            !fits_size_limits(shape.bounds(), viewMatrix)) {
+            continue;
+        }
+        // The bounds SmallPathOp gets from setTransformedBounds().
+        SkRect devBounds;
+        viewMatrix.mapRect(&devBounds, shape.bounds());
+        devBounds.outset(0.5f, 0.5f);
+        requests.emplace_back(shape, viewMatrix, uses_distance_field(devBounds, viewMatrix));
+        if (!SharedPathMasks::Find(requests.back().fKey)) {
+            misses.push_back(requests.count() - 1);
+        }
+    }
+    SkAutoTArray<sk_sp<PathMask>> masks(requests.count());
+    make_masks(taskGroup, requests.begin(), misses, masks.get());
+}
 
-// padding around path bounds to allow for antialiased pixels
-static const SkScalar kAntiAliasPad = 1.0f;
+#if GR_TEST_UTILS
+bool GrSmallPathRenderer::HasSharedMask_ForTesting(const SkPath& path,
+                                                   const SkMatrix& viewMatrix) {
+    GrShape shape(path, GrStyle::SimpleFill());
+    SkRect devBounds;
+    viewMatrix.mapRect(&devBounds, shape.bounds());
+    devBounds.outset(0.5f, 0.5f);
+    MaskRequest request(shape, viewMatrix, uses_distance_field(devBounds, viewMatrix));
+    return SkToBool(SharedPathMasks::Find(request.fKey));
+}
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
 
 class GrSmallPathRenderer::SmallPathOp final : public GrMeshDrawOp {
 private:
@@ -240,26 +617,20 @@ public:
                                           const GrUserStencilSettings* stencilSettings) {
         return Helper::FactoryHelper<SmallPathOp>(context, std::move(paint), shape, viewMatrix,
                                                   atlas, shapeCache, shapeList, gammaCorrect,
-                                                  stencilSettings);
+                                                  stencilSettings,
+                                                  context->contextPriv().getTaskGroup());
     }
 
     SmallPathOp(Helper::MakeArgs helperArgs, const SkPMColor4f& color, const GrShape& shape,
                 const SkMatrix& viewMatrix, GrDrawOpAtlas* atlas, ShapeCache* shapeCache,
                 ShapeDataList* shapeList, bool gammaCorrect,
-                const GrUserStencilSettings* stencilSettings)
+                const GrUserStencilSettings* stencilSettings, SkTaskGroup* taskGroup)
             : INHERITED(ClassID()), fHelper(helperArgs, GrAAType::kCoverage, stencilSettings) {
         SkASSERT(shape.hasUnstyledKey());
         // Compute bounds
         this->setTransformedBounds(shape.bounds(), viewMatrix, HasAABloat::kYes, IsZeroArea::kNo);
 
-#if defined(SK_BUILD_FOR_ANDROID) && !defined(SK_BUILD_FOR_ANDROID_FRAMEWORK)
-        fUsesDistanceField = true;
-#else
-        // only use distance fields on desktop and Android framework to save space in the atlas
-        fUsesDistanceField = this->bounds().width() > kMaxMIP || this->bounds().height() > kMaxMIP;
-#endif
-        // always use distance fields if in perspective
-        fUsesDistanceField = fUsesDistanceField || viewMatrix.hasPerspective();
+        fUsesDistanceField = uses_distance_field(this->bounds(), viewMatrix);
 
         fShapes.emplace_back(Entry{color, shape, viewMatrix});
 
@@ -267,7 +638,7 @@ public:
         fShapeCache = shapeCache;
         fShapeList = shapeList;
         fGammaCorrect = gammaCorrect;
-
+        fTaskGroup = taskGroup;
     }
 
     const char* name() const override { return "SmallPathOp"; }
@@ -388,101 +759,51 @@ private:
         }
 
         flushInfo.fInstancesToFlush = 0;
+
+        // Find the shapes that are neither in the atlas nor in SharedPathMasks, and make their
+        // masks all at once, so that they can be spread over the executor's threads.
+        SkSTArray<1, MaskRequest> requests(instanceCount);
+        SkAutoTArray<sk_sp<PathMask>> masks(instanceCount);
+        SkTDArray<int> misses;
         for (int i = 0; i < instanceCount; i++) {
             const Entry& args = fShapes[i];
+            requests.emplace_back(args.fShape, args.fViewMatrix, fUsesDistanceField);
+            ShapeData* shapeData = fShapeCache->find(requests[i].fKey);
+            if (shapeData && fAtlas->hasID(shapeData->fID)) {
+                continue;
+            }
+            masks[i] = SharedPathMasks::Find(requests[i].fKey);
+            if (!masks[i]) {
+                misses.push_back(i);
+            }
+        }
+        make_masks(fTaskGroup, requests.begin(), misses, masks.get());
 
-            ShapeData* shapeData;
-            if (fUsesDistanceField) {
-                // get mip level
-                SkScalar maxScale;
-                const SkRect& bounds = args.fShape.bounds();
-                if (args.fViewMatrix.hasPerspective()) {
-                    // approximate the scale since we can't get it from the matrix
-                    SkRect xformedBounds;
-                    args.fViewMatrix.mapRect(&xformedBounds, bounds);
-                    maxScale = SkScalarAbs(SkTMax(xformedBounds.width() / bounds.width(),
-                                                  xformedBounds.height() / bounds.height()));
-                } else {
-                    maxScale = SkScalarAbs(args.fViewMatrix.getMaxScale());
-                }
-                SkScalar maxDim = SkMaxScalar(bounds.width(), bounds.height());
-                // We try to create the DF at a 2^n scaled path resolution (1/2, 1, 2, 4, etc.)
-                // In the majority of cases this will yield a crisper rendering.
-                SkScalar mipScale = 1.0f;
-                // Our mipscale is the maxScale clamped to the next highest power of 2
-                if (maxScale <= SK_ScalarHalf) {
-                    SkScalar log = SkScalarFloorToScalar(SkScalarLog2(SkScalarInvert(maxScale)));
-                    mipScale = SkScalarPow(2, -log);
-                } else if (maxScale > SK_Scalar1) {
-                    SkScalar log = SkScalarCeilToScalar(SkScalarLog2(maxScale));
-                    mipScale = SkScalarPow(2, log);
-                }
-                SkASSERT(maxScale <= mipScale);
-
-                SkScalar mipSize = mipScale*SkScalarAbs(maxDim);
-                // For sizes less than kIdealMinMIP we want to use as large a distance field as we can
-                // so we can preserve as much detail as possible. However, we can't scale down more
-                // than a 1/4 of the size without artifacts. So the idea is that we pick the mipsize
-                // just bigger than the ideal, and then scale down until we are no more than 4x the
-                // original mipsize.
-                if (mipSize < kIdealMinMIP) {
-                    SkScalar newMipSize = mipSize;
-                    do {
-                        newMipSize *= 2;
-                    } while (newMipSize < kIdealMinMIP);
-                    while (newMipSize > 4 * mipSize) {
-                        newMipSize *= 0.25f;
-                    }
-                    mipSize = newMipSize;
+        for (int i = 0; i < instanceCount; i++) {
+            const Entry& args = fShapes[i];
+            const MaskRequest& request = requests[i];
+
+            // check to see if path is cached
+            ShapeData* shapeData = fShapeCache->find(request.fKey);
+            if (nullptr == shapeData || !fAtlas->hasID(shapeData->fID)) {
+                // Remove the stale cache entry
+                if (shapeData) {
+                    fShapeCache->remove(shapeData->fKey);
+                    fShapeList->remove(shapeData);
+                    delete shapeData;
                 }
-                SkScalar desiredDimension = SkTMin(mipSize, kMaxMIP);
-
-                // check to see if df path is cached
-                ShapeDataKey key(args.fShape, SkScalarCeilToInt(desiredDimension));
-                shapeData = fShapeCache->find(key);
-                if (nullptr == shapeData || !fAtlas->hasID(shapeData->fID)) {
-                    // Remove the stale cache entry
-                    if (shapeData) {
-                        fShapeCache->remove(shapeData->fKey);
-                        fShapeList->remove(shapeData);
-                        delete shapeData;
-                    }
-                    SkScalar scale = desiredDimension / maxDim;
-
-                    shapeData = new ShapeData;
-                    if (!this->addDFPathToAtlas(target,
-                                                &flushInfo,
-                                                fAtlas,
-                                                shapeData,
-                                                args.fShape,
-                                                SkScalarCeilToInt(desiredDimension),
-                                                scale)) {
-                        delete shapeData;
-                        continue;
-                    }
+                // Without a mask, the shape was in the atlas when we looked above, but adding
+                // the shapes before it may have evicted it since.
+                sk_sp<PathMask> mask = masks[i] ? masks[i] : request.makeMask();
+                if (!mask) {
+                    continue;
                 }
-            } else {
-                // check to see if bitmap path is cached
-                ShapeDataKey key(args.fShape, args.fViewMatrix);
-                shapeData = fShapeCache->find(key);
-                if (nullptr == shapeData || !fAtlas->hasID(shapeData->fID)) {
-                    // Remove the stale cache entry
-                    if (shapeData) {
-                        fShapeCache->remove(shapeData->fKey);
-                        fShapeList->remove(shapeData);
-                        delete shapeData;
-                    }
-
-                    shapeData = new ShapeData;
-                    if (!this->addBMPathToAtlas(target,
-                                                &flushInfo,
-                                                fAtlas,
-                                                shapeData,
-                                                args.fShape,
-                                                args.fViewMatrix)) {
-                        delete shapeData;
-                        continue;
-                    }
+
+                shapeData = new ShapeData;
+                if (!this->addMaskToAtlas(target, &flushInfo, fAtlas, shapeData, request.fKey,
+                                          *mask)) {
+                    delete shapeData;
+                    continue;
                 }
             }
 
@@ -521,219 +842,33 @@ private:
         return GrDrawOpAtlas::ErrorCode::kSucceeded == code;
     }
 
-    bool addDFPathToAtlas(GrMeshDrawOp::Target* target, FlushInfo* flushInfo,
-                          GrDrawOpAtlas* atlas, ShapeData* shapeData, const GrShape& shape,
-                          uint32_t dimension, SkScalar scale) const {
-
-        const SkRect& bounds = shape.bounds();
-
-        // generate bounding rect for bitmap draw
-        SkRect scaledBounds = bounds;
-        // scale to mip level size
-        scaledBounds.fLeft *= scale;
-        scaledBounds.fTop *= scale;
-        scaledBounds.fRight *= scale;
-        scaledBounds.fBottom *= scale;
-        // subtract out integer portion of origin
-        // (SDF created will be placed with fractional offset burnt in)
-        SkScalar dx = SkScalarFloorToScalar(scaledBounds.fLeft);
-        SkScalar dy = SkScalarFloorToScalar(scaledBounds.fTop);
-        scaledBounds.offset(-dx, -dy);
-        // get integer boundary
-        SkIRect devPathBounds;
-        scaledBounds.roundOut(&devPathBounds);
-        // pad to allow room for antialiasing
-        const int intPad = SkScalarCeilToInt(kAntiAliasPad);
-        // place devBounds at origin
-        int width = devPathBounds.width() + 2*intPad;
-        int height = devPathBounds.height() + 2*intPad;
-        devPathBounds = SkIRect::MakeWH(width, height);
-        SkScalar translateX = intPad - dx;
-        SkScalar translateY = intPad - dy;
-
-        // draw path to bitmap
-        SkMatrix drawMatrix;
-        drawMatrix.setScale(scale, scale);
-        drawMatrix.postTranslate(translateX, translateY);
-
-        SkASSERT(devPathBounds.fLeft == 0);
-        SkASSERT(devPathBounds.fTop == 0);
-        SkASSERT(devPathBounds.width() > 0);
-        SkASSERT(devPathBounds.height() > 0);
-
-        // setup signed distance field storage
-        SkIRect dfBounds = devPathBounds.makeOutset(SK_DistanceFieldPad, SK_DistanceFieldPad);
-        width = dfBounds.width();
-        height = dfBounds.height();
-        // TODO We should really generate this directly into the plot somehow
-        SkAutoSMalloc<1024> dfStorage(width * height * sizeof(unsigned char));
-
-        SkPath path;
-        shape.asPath(&path);
-#ifndef SK_USE_LEGACY_DISTANCE_FIELDS
-        // Generate signed distance field directly from SkPath
-        bool succeed = GrGenerateDistanceFieldFromPath((unsigned char*)dfStorage.get(),
-                                        path, drawMatrix,
-                                        width, height, width * sizeof(unsigned char));
-        if (!succeed) {
-#endif
-            // setup bitmap backing
-            SkAutoPixmapStorage dst;
-            if (!dst.tryAlloc(SkImageInfo::MakeA8(devPathBounds.width(),
-                                                  devPathBounds.height()))) {
-                return false;
-            }
-            sk_bzero(dst.writable_addr(), dst.computeByteSize());
-
-            // rasterize path
-            SkPaint paint;
-            paint.setStyle(SkPaint::kFill_Style);
-            paint.setAntiAlias(true);
-
-            SkDraw draw;
-
-            SkRasterClip rasterClip;
-            rasterClip.setRect(devPathBounds);
-            draw.fRC = &rasterClip;
-            draw.fMatrix = &drawMatrix;
-            draw.fDst = dst;
-
-            draw.drawPathCoverage(path, paint);
-
-            // Generate signed distance field
-            SkGenerateDistanceFieldFromA8Image((unsigned char*)dfStorage.get(),
-                                               (const unsigned char*)dst.addr(),
-                                               dst.width(), dst.height(), dst.rowBytes());
-#ifndef SK_USE_LEGACY_DISTANCE_FIELDS
-        }
-#endif
-
+    bool addMaskToAtlas(GrMeshDrawOp::Target* target, FlushInfo* flushInfo,
+                        GrDrawOpAtlas* atlas, ShapeData* shapeData, const ShapeDataKey& key,
+                        const PathMask& mask) const {
         // add to atlas
         SkIPoint16 atlasLocation;
         GrDrawOpAtlas::AtlasID id;
 
         if (!this->addToAtlas(target, flushInfo, atlas,
-                              width, height, dfStorage.get(), &id, &atlasLocation)) {
+                              mask.width(), mask.height(), mask.image(), &id, &atlasLocation)) {
             return false;
         }
 
         // add to cache
-        shapeData->fKey.set(shape, dimension);
+        shapeData->fKey = key;
         shapeData->fID = id;
-
-        shapeData->fBounds = SkRect::Make(devPathBounds);
-        shapeData->fBounds.offset(-translateX, -translateY);
-        shapeData->fBounds.fLeft /= scale;
-        shapeData->fBounds.fTop /= scale;
-        shapeData->fBounds.fRight /= scale;
-        shapeData->fBounds.fBottom /= scale;
-
-        // We pack the 2bit page index in the low bit of the u and v texture coords
-        uint16_t pageIndex = GrDrawOpAtlas::GetPageIndexFromID(id);
-        SkASSERT(pageIndex < 4);
-        uint16_t uBit = (pageIndex >> 1) & 0x1;
-        uint16_t vBit = pageIndex & 0x1;
-        shapeData->fTextureCoords.set((atlasLocation.fX+SK_DistanceFieldPad) << 1 | uBit,
-                                      (atlasLocation.fY+SK_DistanceFieldPad) << 1 | vBit,
-                                      (atlasLocation.fX+SK_DistanceFieldPad+
-                                       devPathBounds.width()) << 1 | uBit,
-                                      (atlasLocation.fY+SK_DistanceFieldPad+
-                                       devPathBounds.height()) << 1 | vBit);
-
-        fShapeCache->add(shapeData);
-        fShapeList->addToTail(shapeData);
-#ifdef DF_PATH_TRACKING
-        ++g_NumCachedPaths;
-#endif
-        return true;
-    }
-
-    bool addBMPathToAtlas(GrMeshDrawOp::Target* target, FlushInfo* flushInfo,
-                          GrDrawOpAtlas* atlas, ShapeData* shapeData, const GrShape& shape,
-                          const SkMatrix& ctm) const {
-        const SkRect& bounds = shape.bounds();
-        if (bounds.isEmpty()) {
-            return false;
-        }
-        SkMatrix drawMatrix(ctm);
-        SkScalar tx = ctm.getTranslateX();
-        SkScalar ty = ctm.getTranslateY();
-        tx -= SkScalarFloorToScalar(tx);
-        ty -= SkScalarFloorToScalar(ty);
-        drawMatrix.set(SkMatrix::kMTransX, tx);
-        drawMatrix.set(SkMatrix::kMTransY, ty);
-        SkRect shapeDevBounds;
-        drawMatrix.mapRect(&shapeDevBounds, bounds);
-        SkScalar dx = SkScalarFloorToScalar(shapeDevBounds.fLeft);
-        SkScalar dy = SkScalarFloorToScalar(shapeDevBounds.fTop);
-
-        // get integer boundary
-        SkIRect devPathBounds;
-        shapeDevBounds.roundOut(&devPathBounds);
-        // pad to allow room for antialiasing
-        const int intPad = SkScalarCeilToInt(kAntiAliasPad);
-        // place devBounds at origin
-        int width = devPathBounds.width() + 2 * intPad;
-        int height = devPathBounds.height() + 2 * intPad;
-        devPathBounds = SkIRect::MakeWH(width, height);
-        SkScalar translateX = intPad - dx;
-        SkScalar translateY = intPad - dy;
-
-        SkASSERT(devPathBounds.fLeft == 0);
-        SkASSERT(devPathBounds.fTop == 0);
-        SkASSERT(devPathBounds.width() > 0);
-        SkASSERT(devPathBounds.height() > 0);
-
-        SkPath path;
-        shape.asPath(&path);
-        // setup bitmap backing
-        SkAutoPixmapStorage dst;
-        if (!dst.tryAlloc(SkImageInfo::MakeA8(devPathBounds.width(),
-                                              devPathBounds.height()))) {
-            return false;
-        }
-        sk_bzero(dst.writable_addr(), dst.computeByteSize());
-
-        // rasterize path
-        SkPaint paint;
-        paint.setStyle(SkPaint::kFill_Style);
-        paint.setAntiAlias(true);
-
-        SkDraw draw;
-
-        SkRasterClip rasterClip;
-        rasterClip.setRect(devPathBounds);
-        draw.fRC = &rasterClip;
-        drawMatrix.postTranslate(translateX, translateY);
-        draw.fMatrix = &drawMatrix;
-        draw.fDst = dst;
-
-        draw.drawPathCoverage(path, paint);
-
-        // add to atlas
-        SkIPoint16 atlasLocation;
-        GrDrawOpAtlas::AtlasID id;
-
-        if (!this->addToAtlas(target, flushInfo, atlas,
-                              dst.width(), dst.height(), dst.addr(), &id, &atlasLocation)) {
-            return false;
-        }
-
-        // add to cache
-        shapeData->fKey.set(shape, ctm);
-        shapeData->fID = id;
-
-        shapeData->fBounds = SkRect::Make(devPathBounds);
-        shapeData->fBounds.offset(-translateX, -translateY);
+        shapeData->fBounds = mask.bounds();
 
         // We pack the 2bit page index in the low bit of the u and v texture coords
         uint16_t pageIndex = GrDrawOpAtlas::GetPageIndexFromID(id);
         SkASSERT(pageIndex < 4);
         uint16_t uBit = (pageIndex >> 1) & 0x1;
         uint16_t vBit = pageIndex & 0x1;
-        shapeData->fTextureCoords.set(atlasLocation.fX << 1 | uBit, atlasLocation.fY << 1 | vBit,
-                                      (atlasLocation.fX+width) << 1 | uBit,
-                                      (atlasLocation.fY+height) << 1 | vBit);
+        const SkIRect& texRect = mask.texRect();
+        shapeData->fTextureCoords.set((atlasLocation.fX + texRect.fLeft) << 1 | uBit,
+                                      (atlasLocation.fY + texRect.fTop) << 1 | vBit,
+                                      (atlasLocation.fX + texRect.fRight) << 1 | uBit,
+                                      (atlasLocation.fY + texRect.fBottom) << 1 | vBit);
 
         fShapeCache->add(shapeData);
         fShapeList->addToTail(shapeData);
@@ -861,6 +996,7 @@ private:
     ShapeCache* fShapeCache;
     ShapeDataList* fShapeList;
     bool fGammaCorrect;
+    SkTaskGroup* fTaskGroup;  // Makes missing masks in onPrepareDraws() if not null.
 
     typedef GrMeshDrawOp INHERITED;
 };
@@ -18,6 +18,7 @@
 #include "SkTDynamicHash.h"
 
 class GrContext;
+class SkTaskGroup;
 
 class ShapeData;
 class ShapeDataKey;
@@ -47,6 +48,18 @@ public:
         }
     }
 
+    /**
+     * Makes the masks for drawing these filled paths with viewMatrix into a cache shared by every
+     * context, spreading the work over taskGroup's threads if it is not null. Paths this renderer
+     * would not draw are skipped.
+     */
+    static void PrewarmMasks(const GrCaps&, const SkPath paths[], int count,
+                             const SkMatrix& viewMatrix, SkTaskGroup*);
+
+#if GR_TEST_UTILS
+    static bool HasSharedMask_ForTesting(const SkPath&, const SkMatrix& viewMatrix);
+#endif
+
     using ShapeCache = SkTDynamicHash<ShapeData, ShapeDataKey>;
     typedef SkTInternalLList<ShapeData> ShapeDataList;
 
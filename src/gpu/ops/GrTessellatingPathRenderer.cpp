@@ -21,8 +21,12 @@
 #include "GrStyle.h"
 #include "GrTessellator.h"
 #include "SkGeometry.h"
+#include "SkSemaphore.h"
+#include "SkTaskGroup.h"
 #include "ops/GrMeshDrawOp.h"
 
+#include <cmath>
+
 #ifndef GR_AA_TESSELLATOR_MAX_VERB_COUNT
 #define GR_AA_TESSELLATOR_MAX_VERB_COUNT 10
 #endif
@@ -31,9 +35,18 @@
  * This path renderer tessellates the path into triangles using GrTessellator, uploads the
  * triangles to a vertex buffer, and renders them with a single draw call. It can do screenspace
  * antialiasing with a one-pixel coverage ramp.
+ *
+ * Non-AA tessellations are cached in the resource cache. Tolerances are rounded down to a power of
+ * two and each power of two gets its own entry, so a path drawn at several zoom levels keeps one
+ * vertex buffer per level instead of re-tessellating whenever the scale changes. Paths made only
+ * of lines don't depend on the tolerance and get a single entry. When the context has an executor,
+ * cache misses are tessellated on a worker thread as soon as the op is created.
  */
 namespace {
 
+// Bucket index used for paths whose tessellation doesn't depend on the tolerance.
+static constexpr uint32_t kLinearBucket = ~0U;
+
 struct TessInfo {
     SkScalar  fTolerance;
     int       fCount;
@@ -67,6 +80,65 @@ bool cache_match(GrBuffer* vertexBuffer, SkScalar tol, int* actualCount) {
     return false;
 }
 
+// Rounds 'tol' down to a power of two, 2^e. A tessellation made with the rounded tolerance is at
+// most twice as fine as needed for any tolerance in [2^e, 2^(e+1)). The bucket index is e + 128,
+// which keeps it (and the next finer bucket) positive and distinct from kLinearBucket.
+SkScalar bucket_tolerance(SkScalar tol, uint32_t* bucket) {
+    int exp = 1;
+    if (tol > 0 && SkScalarIsFinite(tol)) {
+        std::frexp(tol, &exp);  // tol = m * 2^exp, with m in [0.5, 1).
+    }
+    // 2^-13 is the smallest power of two above GrPathUtils' minimum curve tolerance (0.0001).
+    exp = SkTPin(exp - 1, -13, 127);
+    *bucket = static_cast<uint32_t>(exp + 128);
+    return std::ldexp(1.0f, exp);
+}
+
+// Collects the vertices of a tessellation on the CPU, for when it runs on a worker thread.
+class HeapVertexAllocator : public GrTessellator::VertexAllocator {
+public:
+    HeapVertexAllocator(size_t stride) : VertexAllocator(stride) {}
+    void* lock(int vertexCount) override {
+        fVertices.reset(vertexCount * this->stride());
+        return fVertices.get();
+    }
+    void unlock(int actualCount) override {}
+    const void* vertices() const { return fVertices.get(); }
+private:
+    SkAutoTMalloc<char> fVertices;
+};
+
+// A non-AA tessellation started when its op was created and finished on a worker thread. The op
+// waits for it during onPrepareDraws(). This is ref counted so the task stays valid even if the
+// op is deleted first.
+class PendingTessellation : public SkRefCnt {
+public:
+    PendingTessellation(const SkPath& path, SkScalar tol, const SkRect& clipBounds)
+            : fPath(path), fTolerance(tol), fClipBounds(clipBounds), fAllocator(sizeof(SkPoint)) {}
+
+    void run() {
+        fCount = GrTessellator::PathToTriangles(fPath, fTolerance, fClipBounds, &fAllocator, false,
+                                                GrColor(), false, &fIsLinear);
+        fDone.signal();
+    }
+
+    void wait() { fDone.wait(); }
+
+    SkScalar tolerance() const { return fTolerance; }
+    int count() const { return fCount; }
+    bool isLinear() const { return fIsLinear; }
+    const void* vertices() const { return fAllocator.vertices(); }
+
+private:
+    const SkPath fPath;
+    const SkScalar fTolerance;
+    const SkRect fClipBounds;
+    HeapVertexAllocator fAllocator;
+    int fCount = 0;
+    bool fIsLinear = false;
+    SkSemaphore fDone;
+};
+
 class StaticVertexAllocator : public GrTessellator::VertexAllocator {
 public:
     StaticVertexAllocator(size_t stride, GrResourceProvider* resourceProvider, bool canMapVB)
@@ -177,9 +249,11 @@ public:
                                           SkIRect devClipBounds,
                                           GrAAType aaType,
                                           const GrUserStencilSettings* stencilSettings) {
-        return Helper::FactoryHelper<TessellatingPathOp>(context, std::move(paint), shape,
-                                                         viewMatrix, devClipBounds,
-                                                         aaType, stencilSettings);
+        std::unique_ptr<GrDrawOp> op = Helper::FactoryHelper<TessellatingPathOp>(
+                context, std::move(paint), shape, viewMatrix, devClipBounds, aaType,
+                stencilSettings);
+        static_cast<TessellatingPathOp*>(op.get())->startAsyncTessellation(context);
+        return op;
     }
 
     const char* name() const override { return "TessellatingPathOp"; }
@@ -239,55 +313,137 @@ private:
         return path;
     }
 
-    void draw(Target* target, sk_sp<const GrGeometryProcessor> gp, size_t vertexStride) {
-        SkASSERT(!fAntiAlias);
-        GrResourceProvider* rp = target->resourceProvider();
-        bool inverseFill = fShape.inverseFilled();
-        // construct a cache key from the path's genID and the view matrix
+    // The tolerance to tessellate with, rounded down to its cache bucket.
+    SkScalar tolerance(uint32_t* bucket) const {
+        SkScalar tol = GrPathUtils::scaleToleranceToSrc(GrPathUtils::kDefaultTolerance,
+                                                        fViewMatrix, fShape.bounds());
+        return bucket_tolerance(tol, bucket);
+    }
+
+    // Constructs a cache key from the path's genID, the clip bounds (for inverse fills) and the
+    // tolerance bucket.
+    void makeKey(uint32_t bucket, GrUniqueKey* key) const {
         static const GrUniqueKey::Domain kDomain = GrUniqueKey::GenerateDomain();
-        GrUniqueKey key;
         static constexpr int kClipBoundsCnt = sizeof(fDevClipBounds) / sizeof(uint32_t);
         int shapeKeyDataCnt = fShape.unstyledKeySize();
         SkASSERT(shapeKeyDataCnt >= 0);
-        GrUniqueKey::Builder builder(&key, kDomain, shapeKeyDataCnt + kClipBoundsCnt, "Path");
+        GrUniqueKey::Builder builder(key, kDomain, shapeKeyDataCnt + kClipBoundsCnt + 1, "Path");
         fShape.writeUnstyledKey(&builder[0]);
         // For inverse fills, the tessellation is dependent on clip bounds.
-        if (inverseFill) {
+        if (fShape.inverseFilled()) {
             memcpy(&builder[shapeKeyDataCnt], &fDevClipBounds, sizeof(fDevClipBounds));
         } else {
             memset(&builder[shapeKeyDataCnt], 0, sizeof(fDevClipBounds));
         }
+        builder[shapeKeyDataCnt + kClipBoundsCnt] = bucket;
         builder.finish();
-        sk_sp<GrBuffer> cachedVertexBuffer(rp->findByUniqueKey<GrBuffer>(key));
-        int actualCount;
-        SkScalar tol = GrPathUtils::kDefaultTolerance;
-        tol = GrPathUtils::scaleToleranceToSrc(tol, fViewMatrix, fShape.bounds());
-        if (cache_match(cachedVertexBuffer.get(), tol, &actualCount)) {
-            this->drawVertices(target, std::move(gp), cachedVertexBuffer.get(), 0, actualCount);
-            return;
-        }
+    }
 
-        SkRect clipBounds = SkRect::Make(fDevClipBounds);
+    // Looks for a cached tessellation that is at least as fine as 'tol' requires: first in the
+    // path's own bucket, then in the tolerance independent bucket, then one bucket finer.
+    sk_sp<GrBuffer> findCachedVertexBuffer(GrResourceProvider* rp, SkScalar tol, uint32_t bucket,
+                                           int* actualCount) const {
+        uint32_t buckets[] = {bucket, kLinearBucket, bucket - 1};
+        for (uint32_t b : buckets) {
+            GrUniqueKey key;
+            this->makeKey(b, &key);
+            sk_sp<GrBuffer> cachedVertexBuffer(rp->findByUniqueKey<GrBuffer>(key));
+            if (cache_match(cachedVertexBuffer.get(), tol, actualCount)) {
+                return cachedVertexBuffer;
+            }
+        }
+        return nullptr;
+    }
 
+    // Device clip bounds mapped back to the path's space, which the tessellator needs for inverse
+    // fills.
+    bool localClipBounds(SkRect* clipBounds) const {
         SkMatrix vmi;
         if (!fViewMatrix.invert(&vmi)) {
+            return false;
+        }
+        vmi.mapRect(clipBounds, SkRect::Make(fDevClipBounds));
+        return true;
+    }
+
+    // Tessellates cache misses on the context's task group, if it has one, so the work is off the
+    // flush's critical path by the time onPrepareDraws() runs.
+    void startAsyncTessellation(GrContext* context) {
+        if (fAntiAlias) {
+            return;
+        }
+        SkTaskGroup* taskGroup = context->contextPriv().getTaskGroup();
+        GrResourceProvider* rp = context->contextPriv().resourceProvider();
+        if (!taskGroup || !rp) {
+            return;  // No executor, or a DDL recording context that can't see the cache.
+        }
+        uint32_t bucket;
+        SkScalar tol = this->tolerance(&bucket);
+        int unusedCount;
+        SkRect clipBounds;
+        if (this->findCachedVertexBuffer(rp, tol, bucket, &unusedCount) ||
+            !this->localClipBounds(&clipBounds)) {
+            return;
+        }
+        fPendingTessellation = sk_make_sp<PendingTessellation>(this->getPath(), tol, clipBounds);
+        taskGroup->add([pending = fPendingTessellation]() { pending->run(); });
+    }
+
+    void draw(Target* target, sk_sp<const GrGeometryProcessor> gp, size_t vertexStride) {
+        SkASSERT(!fAntiAlias);
+        GrResourceProvider* rp = target->resourceProvider();
+        uint32_t bucket;
+        SkScalar tol = this->tolerance(&bucket);
+        int actualCount;
+        if (sk_sp<GrBuffer> cachedVertexBuffer =
+                    this->findCachedVertexBuffer(rp, tol, bucket, &actualCount)) {
+            this->drawVertices(target, std::move(gp), cachedVertexBuffer.get(), 0, actualCount);
             return;
         }
-        vmi.mapRect(&clipBounds);
+
+        sk_sp<GrBuffer> vertexBuffer;
+        int count;
         bool isLinear;
-        bool canMapVB = GrCaps::kNone_MapFlags != target->caps().mapBufferFlags();
-        StaticVertexAllocator allocator(vertexStride, rp, canMapVB);
-        int count = GrTessellator::PathToTriangles(getPath(), tol, clipBounds, &allocator,
+        if (fPendingTessellation) {
+            SkASSERT(sizeof(SkPoint) == vertexStride);
+            fPendingTessellation->wait();
+            SkASSERT(fPendingTessellation->tolerance() == tol);
+            count = fPendingTessellation->count();
+            isLinear = fPendingTessellation->isLinear();
+            if (count == 0) {
+                return;
+            }
+            vertexBuffer.reset(rp->createBuffer(count * vertexStride, kVertex_GrBufferType,
+                                                kStatic_GrAccessPattern,
+                                                GrResourceProvider::Flags::kNone,
+                                                fPendingTessellation->vertices()));
+            fPendingTessellation.reset();
+            if (!vertexBuffer) {
+                return;
+            }
+        } else {
+            SkRect clipBounds;
+            if (!this->localClipBounds(&clipBounds)) {
+                return;
+            }
+            bool canMapVB = GrCaps::kNone_MapFlags != target->caps().mapBufferFlags();
+            StaticVertexAllocator allocator(vertexStride, rp, canMapVB);
+            count = GrTessellator::PathToTriangles(getPath(), tol, clipBounds, &allocator,
                                                    false, GrColor(), false, &isLinear);
-        if (count == 0) {
-            return;
+            if (count == 0) {
+                return;
+            }
+            vertexBuffer = sk_ref_sp(allocator.vertexBuffer());
         }
-        this->drawVertices(target, std::move(gp), allocator.vertexBuffer(), 0, count);
+        this->drawVertices(target, std::move(gp), vertexBuffer.get(), 0, count);
+
+        GrUniqueKey key;
+        this->makeKey(isLinear ? kLinearBucket : bucket, &key);
         TessInfo info;
         info.fTolerance = isLinear ? 0 : tol;
         info.fCount = count;
         key.setCustomData(SkData::MakeWithCopy(&info, sizeof(info)));
-        rp->assignUniqueKeyToResource(key, allocator.vertexBuffer());
+        rp->assignUniqueKeyToResource(key, vertexBuffer.get());
         fShape.addGenIDChangeListener(sk_make_sp<PathInvalidator>(key, target->contextUniqueID()));
     }
 
@@ -371,6 +527,7 @@ private:
     SkMatrix                fViewMatrix;
     SkIRect                 fDevClipBounds;
     bool                    fAntiAlias;
+    sk_sp<PendingTessellation> fPendingTessellation;
 
     typedef GrMeshDrawOp INHERITED;
 };
@@ -39,6 +39,7 @@ namespace {
 using Domain = GrQuadPerEdgeAA::Domain;
 using VertexSpec = GrQuadPerEdgeAA::VertexSpec;
 using ColorType = GrQuadPerEdgeAA::ColorType;
+using Instanced = GrQuadPerEdgeAA::Instanced;
 
 static bool filter_has_effect_for_rect_stays_rect(const GrPerspQuad& quad, const SkRect& srcRect) {
     SkASSERT(quad.quadType() == GrQuadType::kRect);
@@ -255,39 +256,59 @@ private:
             , fFilter(static_cast<unsigned>(filter))
             , fFinalized(0) {
         fQuads.reserve(cnt);
-        fProxyCnt = SkToUInt(cnt);
+        fProxyCnt = 0;
         SkRect bounds = SkRectPriv::MakeLargestInverted();
         GrAAType overallAAType = GrAAType::kNone; // aa type maximally compatible with all dst rects
         bool mustFilter = false;
         fCanSkipAllocatorGather = static_cast<unsigned>(true);
-        // All dst rects are transformed by the same view matrix, so their quad types are identical
-        GrQuadType quadType = GrQuadTypeForTransformedRect(viewMatrix);
-        for (unsigned p = 0; p < fProxyCnt; ++p) {
-            fProxies[p].fProxy = SkRef(set[p].fProxy.get());
-            fProxies[p].fQuadCnt = 1;
-            SkASSERT(fProxies[p].fProxy->textureType() == fProxies[0].fProxy->textureType());
-            SkASSERT(fProxies[p].fProxy->config() == fProxies[0].fProxy->config());
-            if (!fProxies[p].fProxy->canSkipResourceAllocator()) {
-                fCanSkipAllocatorGather = static_cast<unsigned>(false);
+        // Dst rects without a pre-view matrix are transformed by the same view matrix, so their
+        // quad types are identical. The op uses the most general type of all the quads.
+        GrQuadType viewQuadType = GrQuadTypeForTransformedRect(viewMatrix);
+        GrQuadType quadType = GrQuadType::kRect;
+        for (int i = 0; i < cnt; ++i) {
+            // Consecutive entries that draw the same proxy share its slot in fProxies
+            if (fProxyCnt && fProxies[fProxyCnt - 1].fProxy == set[i].fProxy.get()) {
+                ++fProxies[fProxyCnt - 1].fQuadCnt;
+            } else {
+                unsigned p = fProxyCnt++;
+                fProxies[p].fProxy = SkRef(set[i].fProxy.get());
+                fProxies[p].fQuadCnt = 1;
+                SkASSERT(fProxies[p].fProxy->textureType() == fProxies[0].fProxy->textureType());
+                SkASSERT(fProxies[p].fProxy->config() == fProxies[0].fProxy->config());
+                if (!fProxies[p].fProxy->canSkipResourceAllocator()) {
+                    fCanSkipAllocatorGather = static_cast<unsigned>(false);
+                }
+            }
+            SkMatrix ctm;
+            GrQuadType quadTypeForEntry = viewQuadType;
+            if (set[i].fPreViewMatrix) {
+                ctm.setConcat(viewMatrix, *set[i].fPreViewMatrix);
+                quadTypeForEntry = GrQuadTypeForTransformedRect(ctm);
+            } else {
+                ctm = viewMatrix;
             }
-            auto quad = GrPerspQuad(set[p].fDstRect, viewMatrix);
+            if (quadTypeForEntry > quadType) {
+                quadType = quadTypeForEntry;
+            }
+            auto quad = GrPerspQuad(set[i].fDstRect, ctm);
             bounds.joinPossiblyEmptyRect(quad.bounds());
             GrQuadAAFlags aaFlags;
             // Don't update the overall aaType, might be inappropriate for some of the quads
             GrAAType aaForQuad;
-            GrResolveAATypeForQuad(aaType, set[p].fAAFlags, quad, quadType, &aaForQuad, &aaFlags);
+            GrResolveAATypeForQuad(aaType, set[i].fAAFlags, quad, quadTypeForEntry, &aaForQuad,
+                                   &aaFlags);
             // Resolve sets aaForQuad to aaType or None, there is never a change between aa methods
             SkASSERT(aaForQuad == GrAAType::kNone || aaForQuad == aaType);
             if (overallAAType == GrAAType::kNone && aaForQuad != GrAAType::kNone) {
                 overallAAType = aaType;
             }
             if (!mustFilter && this->filter() != GrSamplerState::Filter::kNearest) {
-                mustFilter = quadType != GrQuadType::kRect ||
-                             filter_has_effect_for_rect_stays_rect(quad, set[p].fSrcRect);
+                mustFilter = quadTypeForEntry != GrQuadType::kRect ||
+                             filter_has_effect_for_rect_stays_rect(quad, set[i].fSrcRect);
             }
-            float alpha = SkTPin(set[p].fAlpha, 0.f, 1.f);
+            float alpha = SkTPin(set[i].fAlpha, 0.f, 1.f);
             SkPMColor4f color{alpha, alpha, alpha, alpha};
-            fQuads.emplace_back(set[p].fSrcRect, quad, aaFlags, SkCanvas::kFast_SrcRectConstraint,
+            fQuads.emplace_back(set[i].fSrcRect, quad, aaFlags, SkCanvas::kFast_SrcRectConstraint,
                                 color);
         }
         fAAType = static_cast<unsigned>(overallAAType);
@@ -351,8 +372,10 @@ private:
             }
         }
 
+        Instanced instanced = GrQuadPerEdgeAA::CanUseInstancing(target->caps(), aaType)
+                ? Instanced::kYes : Instanced::kNo;
         VertexSpec vertexSpec(quadType, wideColor ? ColorType::kHalf : ColorType::kByte,
-                              GrQuadType::kRect, /* hasLocal */ true, domain, aaType);
+                              GrQuadType::kRect, /* hasLocal */ true, domain, aaType, instanced);
 
         GrSamplerState samplerState = GrSamplerState(GrSamplerState::WrapMode::kClamp,
                                                      this->filter());
@@ -389,12 +412,23 @@ private:
         const auto* pipeline =
                 target->allocPipeline(args, GrProcessorSet::MakeEmptySet(), std::move(clip));
 
-        size_t vertexSize = gp->vertexStride();
+        // When instanced, each quad is a single "vertex" of instance data
+        size_t vertexSize = vertexSpec.isInstanced() ? gp->instanceStride() : gp->vertexStride();
+        int verticesPerQuad = vertexSpec.isInstanced() ? 1 : 4;
+
+        sk_sp<const GrBuffer> cornerBuffer;
+        if (vertexSpec.isInstanced()) {
+            cornerBuffer = GrQuadPerEdgeAA::FindOrMakeCornerBuffer(target->resourceProvider());
+            if (!cornerBuffer) {
+                SkDebugf("Could not allocate quad corners\n");
+                return;
+            }
+        }
 
         GrMesh* meshes = target->allocMeshes(numProxies);
         const GrBuffer* vbuffer;
         int vertexOffsetInBuffer = 0;
-        int numQuadVerticesLeft = numTotalQuads * 4;
+        int numQuadVerticesLeft = numTotalQuads * verticesPerQuad;
         int numAllocatedVertices = 0;
         void* vdata = nullptr;
 
@@ -404,7 +438,7 @@ private:
             for (unsigned p = 0; p < op.fProxyCnt; ++p) {
                 int quadCnt = op.fProxies[p].fQuadCnt;
                 auto* proxy = op.fProxies[p].fProxy;
-                int meshVertexCnt = quadCnt * 4;
+                int meshVertexCnt = quadCnt * verticesPerQuad;
                 if (numAllocatedVertices < meshVertexCnt) {
                     vdata = target->makeVertexSpaceAtLeast(
                             vertexSize, meshVertexCnt, numQuadVerticesLeft, &vbuffer,
@@ -419,7 +453,10 @@ private:
 
                 op.tess(vdata, vertexSpec, proxy, q, quadCnt);
 
-                if (quadCnt > 1) {
+                if (vertexSpec.isInstanced()) {
+                    meshes[m].setPrimitiveType(GrPrimitiveType::kTriangleStrip);
+                    meshes[m].setInstanced(vbuffer, quadCnt, vertexOffsetInBuffer, 4);
+                } else if (quadCnt > 1) {
                     meshes[m].setPrimitiveType(GrPrimitiveType::kTriangles);
                     sk_sp<const GrBuffer> ibuffer =
                             target->resourceProvider()->refQuadIndexBuffer();
@@ -433,7 +470,11 @@ private:
                     meshes[m].setPrimitiveType(GrPrimitiveType::kTriangleStrip);
                     meshes[m].setNonIndexedNonInstanced(4);
                 }
-                meshes[m].setVertexData(vbuffer, vertexOffsetInBuffer);
+                if (vertexSpec.isInstanced()) {
+                    meshes[m].setVertexData(cornerBuffer.get());
+                } else {
+                    meshes[m].setVertexData(vbuffer, vertexOffsetInBuffer);
+                }
                 if (dynamicStateArrays) {
                     dynamicStateArrays->fPrimitiveProcessorTextures[m] = proxy;
                 }
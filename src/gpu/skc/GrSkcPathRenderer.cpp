@@ -0,0 +1,388 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "GrSkcPathRenderer.h"
+
+#include "GrAuditTrail.h"
+#include "GrBackendSurface.h"
+#include "GrCaps.h"
+#include "GrClip.h"
+#include "GrContext.h"
+#include "GrContextPriv.h"
+#include "GrProxyProvider.h"
+#include "GrRenderTargetContext.h"
+#include "GrResourceProvider.h"
+#include "GrShape.h"
+#include "GrSoftwarePathRenderer.h"
+#include "GrTexture.h"
+#include "SkGeometry.h"
+#include "effects/GrSimpleTextureEffect.h"
+#include "gl/GrGLGpu.h"
+#include "ops/GrRectOpFactory.h"
+
+extern "C" {
+#include "skc.h"
+#include "platforms/cl_12/skc_cl.h"
+}
+
+// Paths with fewer verbs, or smaller device bounds, are cheaper to draw with the other path
+// renderers than to hand to OpenCL and wait on.
+static constexpr int kMinVerbCount = 256;
+static constexpr int kMinDevArea = 256 * 256;
+
+// skc's tile keys hold 9 bits of x and 8 bits of y, which covers 4096x4096 with 8x16 tiles.
+static constexpr int kMaxMaskSize = 4096;
+
+// skc rasterizes in 1/32 pixel units.
+static constexpr float kSubpixelScale = 32;
+
+class GrSkcPathRenderer::Context : public SkRefCnt {
+public:
+    static sk_sp<Context> Make(cl_context clContext, cl_device_id clDevice,
+                               sk_sp<const GrGLInterface> glInterface) {
+        cl_int clErr;
+        cl_command_queue queue = clCreateCommandQueue(clContext, clDevice, 0, &clErr);
+        if (CL_SUCCESS != clErr) {
+            return nullptr;
+        }
+        skc_context_t context;
+        if (SKC_ERR_SUCCESS != skc_context_create_cl(&context, clContext, clDevice)) {
+            clReleaseCommandQueue(queue);
+            return nullptr;
+        }
+        clRetainContext(clContext);
+        return sk_sp<Context>(new Context(clContext, queue, context, std::move(glInterface)));
+    }
+
+    ~Context() override {
+        skc_surface_release(fSurface);
+        skc_raster_builder_release(fRasterBuilder);
+        skc_path_builder_release(fPathBuilder);
+        skc_context_release(fContext);
+        clReleaseCommandQueue(fQueue);
+        clReleaseContext(fCLContext);
+    }
+
+    skc_context_t context() const { return fContext; }
+    skc_path_builder_t pathBuilder() const { return fPathBuilder; }
+    skc_raster_builder_t rasterBuilder() const { return fRasterBuilder; }
+    skc_surface_t surface() const { return fSurface; }
+    cl_context clContext() const { return fCLContext; }
+    cl_command_queue queue() const { return fQueue; }
+    const GrGLInterface* glInterface() const { return fGLInterface.get(); }
+
+private:
+    Context(cl_context clContext, cl_command_queue queue, skc_context_t context,
+            sk_sp<const GrGLInterface> glInterface)
+            : fCLContext(clContext)
+            , fQueue(queue)
+            , fContext(context)
+            , fGLInterface(std::move(glInterface)) {
+        skc_path_builder_create(fContext, &fPathBuilder);
+        skc_raster_builder_create(fContext, &fRasterBuilder);
+        skc_surface_create(fContext, &fSurface);
+    }
+
+    cl_context                  fCLContext;
+    cl_command_queue            fQueue;
+    skc_context_t               fContext;
+    skc_path_builder_t          fPathBuilder;
+    skc_raster_builder_t        fRasterBuilder;
+    skc_surface_t               fSurface;
+    sk_sp<const GrGLInterface>  fGLInterface;
+};
+
+namespace {
+
+/**
+ * A path's raster in skc, which is rendered into its mask texture when the flush instantiates the
+ * mask's proxy.
+ */
+class SkcMask : public SkNVRefCnt<SkcMask> {
+public:
+    SkcMask(sk_sp<GrSkcPathRenderer::Context> context, skc_raster_t raster, bool evenOdd,
+            int width, int height)
+            : fContext(std::move(context))
+            , fRaster(raster)
+            , fEvenOdd(evenOdd)
+            , fWidth(width)
+            , fHeight(height) {}
+
+    ~SkcMask() {
+        skc_raster_release(fContext->context(), &fRaster, 1);
+    }
+
+    sk_sp<GrTexture> render(GrResourceProvider*) const;
+
+private:
+    sk_sp<GrSkcPathRenderer::Context>  fContext;
+    skc_raster_t                       fRaster;
+    bool                               fEvenOdd;
+    int                                fWidth;
+    int                                fHeight;
+};
+
+}
+
+sk_sp<GrTexture> SkcMask::render(GrResourceProvider* resourceProvider) const {
+    GrSurfaceDesc desc;
+    desc.fWidth = fWidth;
+    desc.fHeight = fHeight;
+    desc.fConfig = kRGBA_8888_GrPixelConfig;
+    sk_sp<GrTexture> texture = resourceProvider->createTexture(desc, SkBudgeted::kYes);
+    GrGLTextureInfo info;
+    if (!texture || !texture->getBackendTexture().getGLTextureInfo(&info)) {
+        return nullptr;
+    }
+
+    // OpenCL may only use a GL object once GL is done with it.
+    GR_GL_CALL(fContext->glInterface(), Finish());
+
+    cl_int clErr;
+    cl_mem mem = clCreateFromGLTexture(fContext->clContext(), CL_MEM_READ_WRITE, info.fTarget, 0,
+                                       info.fID, &clErr);
+    if (CL_SUCCESS != clErr) {
+        return nullptr;
+    }
+
+    // skc only writes the tiles the path touches.
+    static const cl_float kTransparent[4] = { 0, 0, 0, 0 };
+    const size_t origin[3] = { 0, 0, 0 };
+    const size_t region[3] = { (size_t)fWidth, (size_t)fHeight, 1 };
+    cl_command_queue queue = fContext->queue();
+    clEnqueueAcquireGLObjects(queue, 1, &mem, 0, nullptr, nullptr);
+    clEnqueueFillImage(queue, mem, kTransparent, origin, region, 0, nullptr, nullptr);
+    clEnqueueReleaseGLObjects(queue, 1, &mem, 0, nullptr, nullptr);
+    clFinish(queue);
+
+    skc_context_t context = fContext->context();
+    skc_composition_t composition;
+    skc_composition_create(context, &composition);
+    const skc_layer_id layerID = 0;
+    const float tx = 0, ty = 0;
+    skc_composition_place(composition, &fRaster, &layerID, &tx, &ty, 1);
+    skc_composition_seal(composition);
+
+    // One group with one layer, which fills the raster with white. skc writes opaque pixels, so
+    // the coverage ends up in the color channels.
+    skc_styling_t styling;
+    skc_styling_create(context, &styling, 1, 1, 16);
+    skc_group_id groupID;
+    skc_styling_group_alloc(styling, &groupID);
+    skc_styling_group_parents(styling, groupID, 0, nullptr);
+    skc_styling_group_range_lo(styling, groupID, layerID);
+    skc_styling_group_range_hi(styling, groupID, layerID);
+
+    const skc_styling_cmd_t enterCmds[] = {
+        SKC_STYLING_OPCODE_COLOR_ACC_ZERO | SKC_STYLING_OPCODE_IS_FINAL
+    };
+    skc_styling_group_enter(styling, groupID, SK_ARRAY_COUNT(enterCmds), enterCmds);
+    const skc_styling_cmd_t leaveCmds[] = {
+        SKC_STYLING_OPCODE_SURFACE_COMPOSITE | SKC_STYLING_OPCODE_IS_FINAL
+    };
+    skc_styling_group_leave(styling, groupID, SK_ARRAY_COUNT(leaveCmds), leaveCmds);
+
+    static const float kWhite[4] = { 1, 1, 1, 1 };
+    skc_styling_cmd_t layerCmds[1 + 3 + 1];
+    layerCmds[0] = fEvenOdd ? SKC_STYLING_OPCODE_COVER_EVENODD : SKC_STYLING_OPCODE_COVER_NONZERO;
+    skc_styling_layer_fill_rgba_encoder(layerCmds + 1, kWhite);
+    layerCmds[4] = SKC_STYLING_OPCODE_BLEND_OVER | SKC_STYLING_OPCODE_IS_FINAL;
+    skc_styling_group_layer(styling, groupID, layerID, SK_ARRAY_COUNT(layerCmds), layerCmds);
+    skc_styling_seal(styling);
+
+    skc_framebuffer_cl framebuffer = { SKC_FRAMEBUFFER_CL_GL_TEXTURE, mem, nullptr, nullptr };
+    const uint32_t clip[4] = { 0, 0, (uint32_t)fWidth, (uint32_t)fHeight };
+    const int32_t txty[2] = { 0, 0 };
+    bool done = false;
+    skc_surface_render(fContext->surface(), styling, composition, &framebuffer, clip, txty,
+                       [](skc_surface_t, skc_styling_t, skc_composition_t, skc_framebuffer_t,
+                          void* done) { *static_cast<bool*>(done) = true; },
+                       &done);
+    // The texture is handed back to GL before skc notifies us.
+    while (!done) {
+        skc_context_wait(context);
+    }
+
+    skc_styling_release(styling);
+    skc_composition_release(composition);
+    clReleaseMemObject(mem);
+    return texture;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+sk_sp<GrSkcPathRenderer> GrSkcPathRenderer::CreateIfSupported(GrContext* context,
+                                                              void* clContext, void* clDevice) {
+    if (!clContext || !clDevice || !context->contextPriv().getGpu() ||
+        GrBackendApi::kOpenGL != context->contextPriv().getBackend()) {
+        return nullptr;
+    }
+    auto gpu = static_cast<GrGLGpu*>(context->contextPriv().getGpu());
+    sk_sp<Context> skcContext = Context::Make(static_cast<cl_context>(clContext),
+                                              static_cast<cl_device_id>(clDevice),
+                                              sk_ref_sp(gpu->glInterface()));
+    if (!skcContext) {
+        return nullptr;
+    }
+    return sk_sp<GrSkcPathRenderer>(new GrSkcPathRenderer(std::move(skcContext)));
+}
+
+GrSkcPathRenderer::GrSkcPathRenderer(sk_sp<Context> context) : fContext(std::move(context)) {}
+
+GrPathRenderer::CanDrawPath GrSkcPathRenderer::onCanDrawPath(const CanDrawPathArgs& args) const {
+    const GrShape& shape = *args.fShape;
+    if (!shape.style().isSimpleFill() || shape.inverseFilled() || shape.knownToBeConvex() ||
+        args.fViewMatrix->hasPerspective() || GrAAType::kCoverage != args.fAAType) {
+        return CanDrawPath::kNo;
+    }
+
+    SkPath path;
+    shape.asPath(&path);
+    if (path.countVerbs() < kMinVerbCount) {
+        return CanDrawPath::kNo;
+    }
+
+    SkRect devBounds;
+    args.fViewMatrix->mapRect(&devBounds, shape.bounds());
+    SkIRect clippedBounds;
+    if (!clippedBounds.intersect(devBounds.roundOut(), *args.fClipConservativeBounds)) {
+        return CanDrawPath::kNo;
+    }
+    int maxSize = SkTMin(kMaxMaskSize, args.fCaps->maxTextureSize());
+    if (clippedBounds.width() > maxSize || clippedBounds.height() > maxSize ||
+        devBounds.width() * devBounds.height() < kMinDevArea) {
+        return CanDrawPath::kNo;
+    }
+    return CanDrawPath::kYes;
+}
+
+bool GrSkcPathRenderer::onDrawPath(const DrawPathArgs& args) {
+    GR_AUDIT_TRAIL_AUTO_FRAME(args.fRenderTargetContext->auditTrail(),
+                              "GrSkcPathRenderer::onDrawPath");
+    const SkMatrix& viewMatrix = *args.fViewMatrix;
+
+    SkIRect unclippedDevShapeBounds, maskBounds, devClipBounds;
+    if (!GrSoftwarePathRenderer::GetShapeAndClipBounds(args.fRenderTargetContext, *args.fClip,
+                                                       *args.fShape, viewMatrix,
+                                                       &unclippedDevShapeBounds, &maskBounds,
+                                                       &devClipBounds)) {
+        return true;  // The path is clipped out.
+    }
+
+    SkPath path;
+    args.fShape->asPath(&path);
+
+    // skc builds the path and its raster asynchronously, while we keep recording.
+    skc_path_builder_t pathBuilder = fContext->pathBuilder();
+    skc_path_begin(pathBuilder);
+    SkPath::Iter iter(path, true);
+    SkPoint pts[4];
+    SkPath::Verb verb;
+    SkAutoConicToQuads converter;
+    while ((verb = iter.next(pts, false)) != SkPath::kDone_Verb) {
+        switch (verb) {
+            case SkPath::kMove_Verb:
+                skc_path_move_to(pathBuilder, pts[0].fX, pts[0].fY);
+                break;
+            case SkPath::kLine_Verb:
+                skc_path_line_to(pathBuilder, pts[1].fX, pts[1].fY);
+                break;
+            case SkPath::kQuad_Verb:
+                skc_path_quad_to(pathBuilder, pts[1].fX, pts[1].fY, pts[2].fX, pts[2].fY);
+                break;
+            case SkPath::kConic_Verb: {
+                const SkPoint* quadPts = converter.computeQuads(pts, iter.conicWeight(), 0.25f);
+                for (int i = 0; i < converter.countQuads(); ++i, quadPts += 2) {
+                    skc_path_quad_to(pathBuilder, quadPts[1].fX, quadPts[1].fY,
+                                     quadPts[2].fX, quadPts[2].fY);
+                }
+                break;
+            }
+            case SkPath::kCubic_Verb:
+                skc_path_cubic_to(pathBuilder, pts[1].fX, pts[1].fY, pts[2].fX, pts[2].fY,
+                                  pts[3].fX, pts[3].fY);
+                break;
+            case SkPath::kClose_Verb:
+                skc_path_close(pathBuilder);
+                break;
+            case SkPath::kDone_Verb:
+                break;
+        }
+    }
+    skc_path_t skcPath;
+    if (SKC_ERR_SUCCESS != skc_path_end(pathBuilder, &skcPath)) {
+        return false;
+    }
+
+    // Maps the path into the mask, in skc's subpixel units.
+    SkMatrix m = SkMatrix::MakeScale(kSubpixelScale);
+    m.preTranslate(-SkIntToScalar(maskBounds.fLeft), -SkIntToScalar(maskBounds.fTop));
+    m.preConcat(viewMatrix);
+    const float transform[8] = {
+        m.getScaleX(), m.getSkewX(),  m.getTranslateX(),
+        m.getSkewY(),  m.getScaleY(), m.getTranslateY(),
+        0, 0
+    };
+    static const float kNoRasterClip[4] = { 0, 0, 0, 0 };
+
+    skc_raster_builder_t rasterBuilder = fContext->rasterBuilder();
+    skc_raster_t raster;
+    skc_raster_begin(rasterBuilder);
+    skc_err err = skc_raster_add_filled(rasterBuilder, skcPath, nullptr, transform, nullptr,
+                                        kNoRasterClip);
+    skc_raster_end(rasterBuilder, &raster);
+    // The raster holds its own reference to the path.
+    skc_path_release(fContext->context(), &skcPath, 1);
+    if (SKC_ERR_SUCCESS != err) {
+        skc_raster_release(fContext->context(), &raster, 1);
+        return false;
+    }
+
+    bool evenOdd = SkPath::kEvenOdd_FillType == path.getFillType();
+    sk_sp<SkcMask> mask = sk_make_sp<SkcMask>(fContext, raster, evenOdd, maskBounds.width(),
+                                              maskBounds.height());
+
+    GrContext* context = args.fContext;
+    const GrCaps& caps = *context->contextPriv().caps();
+    GrSurfaceDesc desc;
+    desc.fWidth = maskBounds.width();
+    desc.fHeight = maskBounds.height();
+    desc.fConfig = kRGBA_8888_GrPixelConfig;
+    sk_sp<GrTextureProxy> proxy = context->contextPriv().proxyProvider()->createLazyProxy(
+            [mask](GrResourceProvider* resourceProvider) -> sk_sp<GrSurface> {
+                if (!resourceProvider) {
+                    return nullptr;
+                }
+                return mask->render(resourceProvider);
+            },
+            caps.getBackendFormatFromColorType(kRGBA_8888_SkColorType), desc,
+            kTopLeft_GrSurfaceOrigin, GrMipMapped::kNo, GrInternalSurfaceFlags::kNone,
+            SkBackingFit::kExact, SkBudgeted::kYes,
+            GrSurfaceProxy::LazyInstantiationType::kSingleUse);
+    if (!proxy) {
+        return false;
+    }
+
+    SkMatrix invert;
+    if (!viewMatrix.invert(&invert)) {
+        return true;
+    }
+    // Samples the mask in device space, spreading the coverage in red across all channels.
+    SkMatrix maskMatrix = SkMatrix::MakeTrans(-SkIntToScalar(maskBounds.fLeft),
+                                              -SkIntToScalar(maskBounds.fTop));
+    maskMatrix.preConcat(viewMatrix);
+    args.fPaint.addCoverageFragmentProcessor(GrFragmentProcessor::SwizzleOutput(
+            GrSimpleTextureEffect::Make(std::move(proxy), maskMatrix,
+                                        GrSamplerState::Filter::kNearest),
+            GrSwizzle::RRRR()));
+    args.fRenderTargetContext->addDrawOp(
+            *args.fClip,
+            GrRectOpFactory::MakeNonAAFillWithLocalMatrix(
+                    context, std::move(args.fPaint), SkMatrix::I(), invert,
+                    SkRect::Make(maskBounds), GrAAType::kNone, args.fUserStencilSettings));
+    return true;
+}
@@ -0,0 +1,51 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef GrSkcPathRenderer_DEFINED
+#define GrSkcPathRenderer_DEFINED
+
+#include "GrPathRenderer.h"
+
+class GrContext;
+
+/**
+ * This path renderer fills large, complex paths with skc, the OpenCL compute rasterizer in
+ * src/compute/skc, instead of tessellating them on the CPU or stenciling them.
+ *
+ * Each path and its raster are handed to skc as soon as the path is drawn, so skc builds them
+ * while the rest of the frame records. At flush, the raster is rendered into a coverage mask in a
+ * GL texture that OpenCL shares with GL, and the mask is drawn like a software path mask.
+ *
+ * This needs a GL context and an OpenCL context that can share objects with it (see
+ * GrContextOptions::fOpenCLContext). It is only built with skia_use_skc=true.
+ */
+class GrSkcPathRenderer : public GrPathRenderer {
+public:
+    // 'clContext' and 'clDevice' are a cl_context and cl_device_id.
+    static sk_sp<GrSkcPathRenderer> CreateIfSupported(GrContext*, void* clContext,
+                                                      void* clDevice);
+
+    class Context;
+
+private:
+    GrSkcPathRenderer(sk_sp<Context>);
+
+    StencilSupport onGetStencilSupport(const GrShape&) const override {
+        return GrPathRenderer::kNoSupport_StencilSupport;
+    }
+
+    CanDrawPath onCanDrawPath(const CanDrawPathArgs&) const override;
+
+    bool onDrawPath(const DrawPathArgs&) override;
+
+    // Shared with the masks of pending draws, which may outlive the path renderer.
+    sk_sp<Context> fContext;
+
+    typedef GrPathRenderer INHERITED;
+};
+
+#endif
@@ -0,0 +1,13 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "GrSkcPathRenderer.h"
+
+sk_sp<GrSkcPathRenderer> GrSkcPathRenderer::CreateIfSupported(GrContext*, void* clContext,
+                                                              void* clDevice) {
+    return nullptr;
+}
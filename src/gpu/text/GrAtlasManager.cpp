@@ -9,6 +9,7 @@
 
 #include "GrGlyph.h"
 #include "GrGlyphCache.h"
+#include "SkTraceMemoryDump.h"
 
 GrAtlasManager::GrAtlasManager(GrProxyProvider* proxyProvider, GrGlyphCache* glyphCache,
                                size_t maxTextureBytes,
@@ -52,10 +53,32 @@ static SkColorType mask_format_to_color_type(GrMaskFormat format) {
 
 void GrAtlasManager::freeAll() {
     for (int i = 0; i < kMaskFormatCount; ++i) {
+        if (fAtlases[i]) {
+            const GrDrawOpAtlas::Stats& stats = fAtlases[i]->stats();
+            fFreedAtlasStats.fUploadBytes += stats.fUploadBytes;
+            fFreedAtlasStats.fEvictions   += stats.fEvictions;
+            fFreedAtlasStats.fRelocations += stats.fRelocations;
+        }
         fAtlases[i] = nullptr;
     }
 }
 
+GrAtlasManager::Stats GrAtlasManager::stats() const {
+    Stats stats;
+    stats.fUploadBytes = fFreedAtlasStats.fUploadBytes;
+    stats.fEvictions   = fFreedAtlasStats.fEvictions;
+    stats.fRelocations = fFreedAtlasStats.fRelocations;
+    for (int i = 0; i < kMaskFormatCount; ++i) {
+        if (fAtlases[i]) {
+            stats.fUploadBytes += fAtlases[i]->stats().fUploadBytes;
+            stats.fEvictions   += fAtlases[i]->stats().fEvictions;
+            stats.fRelocations += fAtlases[i]->stats().fRelocations;
+        }
+    }
+    stats.fLastFlushUploadBytes = fLastFlushUploadBytes;
+    return stats;
+}
+
 bool GrAtlasManager::hasGlyph(GrGlyph* glyph) {
     SkASSERT(glyph);
     return this->getAtlas(glyph->fMaskFormat)->hasID(glyph->fID);
@@ -161,12 +184,23 @@ void GrAtlasManager::dump(GrContext* context) const {
 }
 #endif
 
+void GrAtlasManager::dumpMemoryStatistics(SkTraceMemoryDump* traceMemoryDump) const {
+    static const char* kAtlasNames[kMaskFormatCount] = {
+        "skia/gr_text_atlas/a8",
+        "skia/gr_text_atlas/a565",
+        "skia/gr_text_atlas/argb",
+    };
+    for (int i = 0; i < kMaskFormatCount; ++i) {
+        if (fAtlases[i]) {
+            fAtlases[i]->dumpMemoryStatistics(traceMemoryDump, kAtlasNames[i]);
+        }
+    }
+}
+
 void GrAtlasManager::setAtlasSizesToMinimum_ForTesting() {
     // Delete any old atlases.
     // This should be safe to do as long as we are not in the middle of a flush.
-    for (int i = 0; i < kMaskFormatCount; i++) {
-        fAtlases[i] = nullptr;
-    }
+    this->freeAll();
 
     // Set all the atlas sizes to 1x1 plot each.
     new (&fAtlasConfigs) GrDrawOpAtlasConfig{};
@@ -179,16 +213,18 @@ bool GrAtlasManager::initAtlas(GrMaskFormat format) {
         SkColorType colorType = mask_format_to_color_type(format);
         SkISize atlasDimensions = fAtlasConfigs.atlasDimensions(format);
         SkISize numPlots = fAtlasConfigs.numPlots(format);
+        uint32_t maxPages = fAtlasConfigs.maxPages(format);
 
         const GrBackendFormat format = fCaps->getBackendFormatFromColorType(colorType);
 
         fAtlases[index] = GrDrawOpAtlas::Make(
                 fProxyProvider, format, config, atlasDimensions.width(), atlasDimensions.height(),
                 numPlots.width(), numPlots.height(), fAllowMultitexturing,
-                &GrGlyphCache::HandleEviction, fGlyphCache);
+                &GrGlyphCache::HandleEviction, fGlyphCache, maxPages);
         if (!fAtlases[index]) {
             return false;
         }
+        fAtlases[index]->registerRelocationCallback(&GrGlyphCache::HandleRelocation, fGlyphCache);
     }
     return true;
 }
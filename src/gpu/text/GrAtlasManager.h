@@ -15,6 +15,7 @@
 
 class GrAtlasGlypCache;
 class GrTextStrike;
+class SkTraceMemoryDump;
 struct GrGlyph;
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
@@ -59,6 +60,12 @@ public:
 
     bool hasGlyph(GrGlyph* glyph);
 
+    // Compaction may move glyphs within an atlas, bumping its atlasGeneration. Clients that find
+    // the generation changed must call this before drawing any of the glyphs they look up again.
+    void uploadRelocatedGlyphs(GrDeferredUploadTarget* target, GrMaskFormat format) {
+        this->getAtlas(this->resolveMaskFormat(format))->uploadRelocatedPlots(target);
+    }
+
     // To ensure the GrDrawOpAtlas does not evict the Glyph Mask from its texture backing store,
     // the client must pass in the current op token along with the GrGlyph.
     // A BulkUseTokenUpdater is used to manage bulk last use token updating in the Atlas.
@@ -104,18 +111,34 @@ public:
                 fAtlases[i]->compact(startTokenForNextFlush);
             }
         }
+        size_t uploadBytes = this->stats().fUploadBytes;
+        fLastFlushUploadBytes = uploadBytes - fUploadBytesBeforeFlush;
+        fUploadBytesBeforeFlush = uploadBytes;
     }
 
     // The AtlasGlyph cache always survives freeGpuResources so we want it to remain in the active
     // OnFlushCallbackObject list
     bool retainOnFreeGpuResources() override { return true; }
 
+    struct Stats {
+        size_t fUploadBytes = 0;           ///< glyph bytes uploaded to the atlases in total
+        size_t fLastFlushUploadBytes = 0;  ///< glyph bytes uploaded in the most recent flush
+        int    fEvictions = 0;             ///< atlas plots whose glyphs were evicted
+        int    fRelocations = 0;           ///< atlas plots whose glyphs were moved by compaction
+    };
+
+    /** Totals over the atlases, including those freed by freeAll(). */
+    Stats stats() const;
+
     ///////////////////////////////////////////////////////////////////////////
     // Functions intended debug only
 #ifdef SK_DEBUG
     void dump(GrContext* context) const;
 #endif
 
+    /** Dumps the pages of each glyph atlas, with their sizes and occupancy. */
+    void dumpMemoryStatistics(SkTraceMemoryDump*) const;
+
     void setAtlasSizesToMinimum_ForTesting();
     void setMaxPages_TestingOnly(uint32_t maxPages);
 
@@ -144,6 +167,9 @@ private:
 
     GrDrawOpAtlas::AllowMultitexturing fAllowMultitexturing;
     std::unique_ptr<GrDrawOpAtlas> fAtlases[kMaskFormatCount];
+    GrDrawOpAtlas::Stats fFreedAtlasStats;  // Summed over atlases we've deleted.
+    size_t fUploadBytesBeforeFlush = 0;
+    size_t fLastFlushUploadBytes = 0;
     GrProxyProvider* fProxyProvider;
     sk_sp<const GrCaps> fCaps;
     GrGlyphCache* fGlyphCache;
@@ -56,6 +56,16 @@ void GrGlyphCache::HandleEviction(GrDrawOpAtlas::AtlasID id, void* ptr) {
     }
 }
 
+void GrGlyphCache::HandleRelocation(GrDrawOpAtlas::AtlasID from, GrDrawOpAtlas::AtlasID to,
+                                    SkIPoint16 offset, void* ptr) {
+    GrGlyphCache* glyphCache = reinterpret_cast<GrGlyphCache*>(ptr);
+
+    StrikeHash::Iter iter(&glyphCache->fCache);
+    for (; !iter.done(); ++iter) {
+        (*iter).relocateID(from, to, offset);
+    }
+}
+
 static GrMaskFormat get_packed_glyph_mask_format(const SkGlyph& glyph) {
     SkMask::Format format = static_cast<SkMask::Format>(glyph.fMaskFormat);
     switch (format) {
@@ -229,6 +239,19 @@ void GrTextStrike::removeID(GrDrawOpAtlas::AtlasID id) {
     }
 }
 
+void GrTextStrike::relocateID(GrDrawOpAtlas::AtlasID from, GrDrawOpAtlas::AtlasID to,
+                              SkIPoint16 offset) {
+    SkTDynamicHash<GrGlyph, GrGlyph::PackedID>::Iter iter(&fCache);
+    while (!iter.done()) {
+        if (from == (*iter).fID) {
+            (*iter).fID = to;
+            (*iter).fAtlasLocation.fX += offset.fX;
+            (*iter).fAtlasLocation.fY += offset.fY;
+        }
+        ++iter;
+    }
+}
+
 GrDrawOpAtlas::ErrorCode GrTextStrike::addGlyphToAtlas(
                                    GrResourceProvider* resourceProvider,
                                    GrDeferredUploadTarget* target,
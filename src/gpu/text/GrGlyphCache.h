@@ -75,6 +75,9 @@ public:
     // remove any references to this plot
     void removeID(GrDrawOpAtlas::AtlasID);
 
+    // point any references to the plot 'from' at the plot 'to', which is 'offset' away from it
+    void relocateID(GrDrawOpAtlas::AtlasID from, GrDrawOpAtlas::AtlasID to, SkIPoint16 offset);
+
     // If a TextStrike is abandoned by the cache, then the caller must get a new strike
     bool isAbandoned() const { return fIsAbandoned; }
 
@@ -131,6 +134,8 @@ public:
     void freeAll();
 
     static void HandleEviction(GrDrawOpAtlas::AtlasID, void*);
+    static void HandleRelocation(GrDrawOpAtlas::AtlasID from, GrDrawOpAtlas::AtlasID to,
+                                 SkIPoint16 offset, void*);
 
 private:
     sk_sp<GrTextStrike> generateStrike(const SkGlyphCache* cache) {
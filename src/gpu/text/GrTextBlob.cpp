@@ -79,9 +79,32 @@ void GrTextBlob::Run::appendPathGlyph(const SkPath& path, SkPoint position,
     fPathGlyphs.push_back(PathGlyph(path, position.x(), position.y(), scale, preTransformed));
 }
 
+static bool same_scale_and_skew(const SkMatrix& a, const SkMatrix& b) {
+    return a.getScaleX() == b.getScaleX() && a.getScaleY() == b.getScaleY() &&
+           a.getSkewX()  == b.getSkewX()  && a.getSkewY()  == b.getSkewY();
+}
+
+// Whether x is no further from a whole pixel than subpixel positioned glyphs are from their exact
+// positions, i.e. half a subpixel step.
+static bool within_subpixel_rounding(SkScalar x) {
+    static constexpr SkScalar kSubpixelRounding = SkFixedToScalar(SkGlyph::kSubpixelRound);
+    return SkScalarAbs(x - SkScalarRoundToScalar(x)) <= kSubpixelRounding;
+}
+
+bool GrTextBlob::scaleChanged(const SkMatrix& viewMatrix) const {
+    return !same_scale_and_skew(fInitialViewMatrix, viewMatrix);
+}
+
+bool GrTextBlob::updateLastViewMatrix(const SkMatrix& viewMatrix) {
+    bool sameScale = same_scale_and_skew(fLastViewMatrix, viewMatrix);
+    fLastViewMatrix = viewMatrix;
+    return sameScale;
+}
+
 bool GrTextBlob::mustRegenerate(const SkPaint& paint, bool anyRunHasSubpixelPosition,
                                 const SkMaskFilterBase::BlurRec& blurRec,
-                                const SkMatrix& viewMatrix, SkScalar x, SkScalar y) {
+                                const SkMatrix& viewMatrix, SkScalar x, SkScalar y,
+                                const GrTextContext::Options& options) {
     // If we have LCD text then our canonical color will be set to transparent, in this case we have
     // to regenerate the blob on any color change
     // We use the grPaint to get any color filter effects
@@ -124,10 +147,7 @@ bool GrTextBlob::mustRegenerate(const SkPaint& paint, bool anyRunHasSubpixelPosi
     }
 
     if (this->hasBitmap()) {
-        if (fInitialViewMatrix.getScaleX() != viewMatrix.getScaleX() ||
-            fInitialViewMatrix.getScaleY() != viewMatrix.getScaleY() ||
-            fInitialViewMatrix.getSkewX() != viewMatrix.getSkewX() ||
-            fInitialViewMatrix.getSkewY() != viewMatrix.getSkewY()) {
+        if (this->scaleChanged(viewMatrix)) {
             return true;
         }
 
@@ -147,7 +167,13 @@ bool GrTextBlob::mustRegenerate(const SkPaint& paint, bool anyRunHasSubpixelPosi
                               viewMatrix.getScaleY() * (y - fInitialY) -
                               fInitialViewMatrix.getTranslateY();
             if (!SkScalarIsInt(transX) || !SkScalarIsInt(transY)) {
-                return true;
+                // Bitmap glyphs are sampled with nearest filtering, so vertices moved less than
+                // half a pixel draw as if moved by the rounded translation. If that is within the
+                // rounding the painter applies to glyph positions anyway, the masks still match.
+                if (!options.fReuseBlobsUnderFractionalTranslation ||
+                    !within_subpixel_rounding(transX) || !within_subpixel_rounding(transY)) {
+                    return true;
+                }
             }
         }
     } else if (this->hasDistanceField()) {
@@ -167,7 +167,21 @@ public:
     }
 
     bool mustRegenerate(const SkPaint&, bool, const SkMaskFilterBase::BlurRec& blurRec,
-                        const SkMatrix& viewMatrix, SkScalar x, SkScalar y);
+                        const SkMatrix& viewMatrix, SkScalar x, SkScalar y,
+                        const GrTextContext::Options&);
+
+    // True if viewMatrix scales or skews differently than the matrix the blob was generated with.
+    bool scaleChanged(const SkMatrix& viewMatrix) const;
+
+    // Records the view matrix of this draw. Returns true if it scales and skews the same as the
+    // matrix of the previous draw.
+    bool updateLastViewMatrix(const SkMatrix& viewMatrix);
+
+    // Set when the blob was generated with distance fields only because its scale was changing.
+    void setDistanceFieldForScaleChange(bool forScaleChange) {
+        fDistanceFieldForScaleChange = forScaleChange;
+    }
+    bool distanceFieldForScaleChange() const { return fDistanceFieldForScaleChange; }
 
     void flush(GrTextTarget*, const SkSurfaceProps& props,
                const GrDistanceFieldAdjustTable* distanceAdjustTable,
@@ -262,6 +276,7 @@ private:
     // we can update the vertex bounds appropriately.
     void setupViewMatrix(const SkMatrix& viewMatrix, SkScalar x, SkScalar y) {
         fInitialViewMatrix = viewMatrix;
+        fLastViewMatrix = viewMatrix;
         if (!viewMatrix.invert(&fInitialViewMatrixInverse)) {
             fInitialViewMatrixInverse = SkMatrix::I();
         }
@@ -524,6 +539,7 @@ private:
     Key fKey;
     SkMatrix fInitialViewMatrix;
     SkMatrix fInitialViewMatrixInverse;
+    SkMatrix fLastViewMatrix;
     size_t fSize;
     SkColor fLuminanceColor;
     SkScalar fInitialX;
@@ -537,6 +553,7 @@ private:
     int fRunCount{0};
     int fRunCountLimit;
     uint8_t fTextType;
+    bool fDistanceFieldForScaleChange{false};
 };
 
 /**
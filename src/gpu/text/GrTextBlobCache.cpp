@@ -60,6 +60,20 @@ void GrTextBlobCache::purgeStaleBlobs() {
     }
 }
 
+size_t GrTextBlobCache::purgeBytes(size_t bytesToFree) {
+    size_t before = fCurrentSize;
+    this->purgeStaleBlobs();
+
+    BitmapBlobList::Iter iter;
+    iter.init(fBlobList, BitmapBlobList::Iter::kTail_IterStart);
+    GrTextBlob* lruBlob;
+    while (before - fCurrentSize < bytesToFree && (lruBlob = iter.get())) {
+        iter.prev();
+        this->remove(lruBlob);
+    }
+    return before - fCurrentSize;
+}
+
 void GrTextBlobCache::checkPurge(GrTextBlob* blob) {
     // First, purge all stale blob IDs.
     this->purgeStaleBlobs();
@@ -13,7 +13,7 @@
 #include "SkRefCnt.h"
 #include "SkTArray.h"
 #include "SkTextBlobPriv.h"
-#include "SkTHash.h"
+#include "SkTSwissHash.h"
 
 class GrTextBlobCache {
 public:
@@ -125,8 +125,34 @@ public:
 
     void purgeStaleBlobs();
 
+    // Frees stale blobs, then the least recently used ones until at least bytesToFree bytes
+    // have been freed or the cache is empty. Returns the number of bytes freed.
+    size_t purgeBytes(size_t bytesToFree);
+
     size_t usedBytes() const { return fCurrentSize; }
 
+    struct Stats {
+        int fRegenerations = 0;             ///< cached blobs regenerated for a new draw in total
+        int fLastFlushRegenerations = 0;    ///< cached blobs regenerated for the most recent flush
+        int fScaleChangeRegenerations = 0;  ///< regenerations switching between bitmap glyphs and
+                                            ///< distance fields because of a changing scale
+    };
+
+    // Called when a cached blob could not be reused for a draw and was generated again.
+    void didRegenerate(bool switchedForScaleChange) {
+        fStats.fRegenerations++;
+        if (switchedForScaleChange) {
+            fStats.fScaleChangeRegenerations++;
+        }
+    }
+
+    void postFlush() {
+        fStats.fLastFlushRegenerations = fStats.fRegenerations - fRegenerationsBeforeFlush;
+        fRegenerationsBeforeFlush = fStats.fRegenerations;
+    }
+
+    const Stats& stats() const { return fStats; }
+
 private:
     using BitmapBlobList = SkTInternalLList<GrTextBlob>;
 
@@ -197,12 +223,14 @@ private:
     static const int kMinGrowthSize = 1 << 16;
     static const int kDefaultBudget = 1 << 22;
     BitmapBlobList fBlobList;
-    SkTHashMap<uint32_t, BlobIDCacheEntry> fBlobIDCache;
+    SkTSwissHashMap<uint32_t, BlobIDCacheEntry> fBlobIDCache;
     PFOverBudgetCB fCallback;
     void* fData;
     size_t fSizeBudget;
     size_t fCurrentSize{0};
     uint32_t fUniqueID;      // unique id to use for messaging
+    Stats fStats;
+    int fRegenerationsBeforeFlush{0};
     SkMessageBus<PurgeBlobMessage>::Inbox fPurgeBlobInbox;
 };
 
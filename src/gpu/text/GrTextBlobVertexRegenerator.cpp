@@ -237,6 +237,7 @@ bool GrTextBlob::VertexRegenerator::doRegen(GrTextBlob::VertexRegenerator::Resul
     sk_sp<GrTextStrike> strike;
     if (regenTexCoords) {
         fSubRun->resetBulkUseToken();
+        fFullAtlasManager->uploadRelocatedGlyphs(fUploadTarget, fSubRun->maskFormat());
 
         const SkDescriptor* desc = fSubRun->desc();
 
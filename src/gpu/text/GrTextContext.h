@@ -40,6 +40,13 @@ public:
         SkScalar fMaxDistanceFieldFontSize = -1.f;
         /** Forces all distance field vertices to use 3 components, not just when in perspective. */
         bool fDistanceFieldVerticesAlwaysHaveW = false;
+        /**
+         * Reuses cached bitmap glyph blobs under fractional translations within the subpixel
+         * rounding error.
+         */
+        bool fReuseBlobsUnderFractionalTranslation = false;
+        /** Regenerates cached bitmap glyph blobs as distance fields while their scale changes. */
+        bool fDistanceFieldTextForScaleChanges = false;
     };
 
     static std::unique_ptr<GrTextContext> Make(const Options& options);
@@ -31,11 +31,15 @@ const GrVkBuffer::Resource* GrVkBuffer::Create(const GrVkGpu* gpu, const Desc& d
     bufInfo.size = desc.fSizeInBytes;
     switch (desc.fType) {
         case kVertex_Type:
-            bufInfo.usage = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT;
+            // Storage usage lets GrVkKeySorter sort keys in vertex buffers in place.
+            bufInfo.usage = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
             break;
         case kIndex_Type:
             bufInfo.usage = VK_BUFFER_USAGE_INDEX_BUFFER_BIT;
             break;
+        case kIndirect_Type:
+            bufInfo.usage = VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT;
+            break;
         case kUniform_Type:
             bufInfo.usage = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT;
             break;
@@ -113,6 +117,10 @@ void GrVkBuffer::vkRelease(const GrVkGpu* gpu) {
     VALIDATE();
     fResource->recycle(const_cast<GrVkGpu*>(gpu));
     fResource = nullptr;
+    for (const Resource* resource : fRetiredResources) {
+        resource->recycle(const_cast<GrVkGpu*>(gpu));
+    }
+    fRetiredResources.reset();
     if (!fDesc.fDynamic) {
         delete[] (unsigned char*)fMapPtr;
     }
@@ -123,6 +131,10 @@ void GrVkBuffer::vkRelease(const GrVkGpu* gpu) {
 void GrVkBuffer::vkAbandon() {
     fResource->unrefAndAbandon();
     fResource = nullptr;
+    for (const Resource* resource : fRetiredResources) {
+        resource->unrefAndAbandon();
+    }
+    fRetiredResources.reset();
     if (!fDesc.fDynamic) {
         delete[] (unsigned char*)fMapPtr;
     }
@@ -136,23 +148,60 @@ VkAccessFlags buffer_type_to_access_flags(GrVkBuffer::Type type) {
             return VK_ACCESS_INDEX_READ_BIT;
         case GrVkBuffer::kVertex_Type:
             return VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT;
+        case GrVkBuffer::kIndirect_Type:
+            return VK_ACCESS_INDIRECT_COMMAND_READ_BIT;
         default:
-            // This helper is only called for static buffers so we should only ever see index or
-            // vertex buffers types
+            // This helper is only called for static buffers so we should only ever see index,
+            // vertex or indirect buffers types
             SkASSERT(false);
             return 0;
     }
 }
 
+// The pipeline stage that reads static buffers of the type.
+static VkPipelineStageFlags buffer_type_to_stage(GrVkBuffer::Type type) {
+    return GrVkBuffer::kIndirect_Type == type ? VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT
+                                              : VK_PIPELINE_STAGE_VERTEX_INPUT_BIT;
+}
+
+void GrVkBuffer::swapInIdleResource(GrVkGpu* gpu) {
+    SkASSERT(fDesc.fDynamic);
+    if (kVertex_Type != fDesc.fType && kIndex_Type != fDesc.fType &&
+        kIndirect_Type != fDesc.fType) {
+        // Uniform buffers already get their resources from a pool in GrVkResourceProvider.
+        fResource->recycle(gpu);
+        fResource = this->createResource(gpu, fDesc);
+        return;
+    }
+
+    const Resource* idle = nullptr;
+    for (int i = 0; i < fRetiredResources.count(); ++i) {
+        // Once the command buffers are done with a resource we hold its only ref.
+        if (fRetiredResources[i]->unique()) {
+            idle = fRetiredResources[i];
+            fRetiredResources.removeShuffle(i);
+            break;
+        }
+    }
+    if (fRetiredResources.count() < kMaxRetiredResources) {
+        fRetiredResources.push_back(fResource);
+    } else {
+        fResource->recycle(gpu);
+    }
+    fResource = idle ? idle : this->createResource(gpu, fDesc);
+}
+
 void GrVkBuffer::internalMap(GrVkGpu* gpu, size_t size, bool* createdNewBuffer) {
     VALIDATE();
     SkASSERT(!this->vkIsMapped());
 
-    if (!fResource->unique()) {
+    // Buffers the GPU copies into are mapped to read what it wrote (after waiting on a fence), so
+    // they keep their resource even if a command buffer that used them hasn't been released yet.
+    bool gpuWritten = kCopyWrite_Type == fDesc.fType;
+    if (!fResource->unique() && !gpuWritten) {
         if (fDesc.fDynamic) {
-            // in use by the command buffer, so we need to create a new one
-            fResource->recycle(gpu);
-            fResource = this->createResource(gpu, fDesc);
+            // in use by the command buffer, so we need to switch to another one
+            this->swapInIdleResource(gpu);
             if (createdNewBuffer) {
                 *createdNewBuffer = true;
             }
@@ -161,7 +210,7 @@ void GrVkBuffer::internalMap(GrVkGpu* gpu, size_t size, bool* createdNewBuffer)
             this->addMemoryBarrier(gpu,
                                    buffer_type_to_access_flags(fDesc.fType),
                                    VK_ACCESS_TRANSFER_WRITE_BIT,
-                                   VK_PIPELINE_STAGE_VERTEX_INPUT_BIT,
+                                   buffer_type_to_stage(fDesc.fType),
                                    VK_PIPELINE_STAGE_TRANSFER_BIT,
                                    false);
         }
@@ -174,6 +223,9 @@ void GrVkBuffer::internalMap(GrVkGpu* gpu, size_t size, bool* createdNewBuffer)
         SkASSERT(0 == fOffset);
 
         fMapPtr = GrVkMemory::MapAlloc(gpu, alloc);
+        if (fMapPtr && gpuWritten) {
+            GrVkMemory::InvalidateMappedAlloc(gpu, alloc, 0, alloc.fSize);
+        }
     } else {
         if (!fMapPtr) {
             fMapPtr = new unsigned char[this->size()];
@@ -203,24 +255,21 @@ void GrVkBuffer::internalUnmap(GrVkGpu* gpu, size_t size) {
         if (size <= 65536 && 0 == (size & 0x3)) {
             gpu->updateBuffer(this, fMapPtr, this->offset(), size);
         } else {
-            GrVkTransferBuffer* transferBuffer =
-                    GrVkTransferBuffer::Create(gpu, size, GrVkBuffer::kCopyRead_Type);
-            if (!transferBuffer) {
+            GrVkGpu::StagingSlice slice;
+            if (!gpu->mapStagingSlice(size, 4, &slice)) {
                 return;
             }
 
-            char* buffer = (char*) transferBuffer->map();
-            memcpy (buffer, fMapPtr, size);
-            transferBuffer->unmap();
+            memcpy(slice.fMapPtr, fMapPtr, size);
+            gpu->unmapStagingSlice(slice, size);
 
-            gpu->copyBuffer(transferBuffer, this, 0, this->offset(), size);
-            transferBuffer->unref();
+            gpu->copyBuffer(slice.fBuffer.get(), this, slice.fOffset, this->offset(), size);
         }
         this->addMemoryBarrier(gpu,
                                VK_ACCESS_TRANSFER_WRITE_BIT,
                                buffer_type_to_access_flags(fDesc.fType),
                                VK_PIPELINE_STAGE_TRANSFER_BIT,
-                               VK_PIPELINE_STAGE_VERTEX_INPUT_BIT,
+                               buffer_type_to_stage(fDesc.fType),
                                false);
     }
 }
@@ -248,8 +297,35 @@ bool GrVkBuffer::vkUpdateData(GrVkGpu* gpu, const void* src, size_t srcSizeInByt
     return true;
 }
 
+bool GrVkBuffer::vkUpdateDataAt(GrVkGpu* gpu, const void* src, size_t srcSizeInBytes,
+                                size_t offset, bool discard, bool* createdNewBuffer) {
+    VALIDATE();
+    SkASSERT(fDesc.fDynamic);
+    SkASSERT(!this->vkIsMapped());
+    if (offset + srcSizeInBytes > fDesc.fSizeInBytes) {
+        return false;
+    }
+
+    if (discard && !fResource->unique()) {
+        this->swapInIdleResource(gpu);
+        *createdNewBuffer = true;
+    }
+
+    const GrVkAlloc& alloc = this->alloc();
+    void* mapPtr = GrVkMemory::MapAlloc(gpu, alloc);
+    if (!mapPtr) {
+        return false;
+    }
+    memcpy(SkTAddOffset<void>(mapPtr, offset), src, srcSizeInBytes);
+    // Non-coherent memory is flushed from its start, which rewrites the earlier data unchanged.
+    GrVkMemory::FlushMappedAlloc(gpu, alloc, 0, offset + srcSizeInBytes);
+    GrVkMemory::UnmapAlloc(gpu, alloc);
+    return true;
+}
+
 void GrVkBuffer::validate() const {
     SkASSERT(!fResource || kVertex_Type == fDesc.fType || kIndex_Type == fDesc.fType
-             || kTexel_Type == fDesc.fType || kCopyRead_Type == fDesc.fType
-             || kCopyWrite_Type == fDesc.fType || kUniform_Type == fDesc.fType);
+             || kIndirect_Type == fDesc.fType || kTexel_Type == fDesc.fType
+             || kCopyRead_Type == fDesc.fType || kCopyWrite_Type == fDesc.fType
+             || kUniform_Type == fDesc.fType);
 }
@@ -11,6 +11,7 @@
 #include "GrVkVulkan.h"
 
 #include "GrVkResource.h"
+#include "SkTArray.h"
 #include "vk/GrVkTypes.h"
 
 class GrVkGpu;
@@ -24,6 +25,7 @@ public:
     virtual ~GrVkBuffer() {
         // either release or abandon should have been called by the owner of this object.
         SkASSERT(!fResource);
+        SkASSERT(fRetiredResources.empty());
         delete [] (unsigned char*)fMapPtr;
     }
 
@@ -43,6 +45,7 @@ public:
     enum Type {
         kVertex_Type,
         kIndex_Type,
+        kIndirect_Type,
         kUniform_Type,
         kTexel_Type,
         kCopyRead_Type,
@@ -97,6 +100,12 @@ protected:
     bool vkUpdateData(GrVkGpu* gpu, const void* src, size_t srcSizeInBytes,
                       bool* createdNewBuffer = nullptr);
 
+    // Writes to the bytes at 'offset' of a dynamic buffer's VkBuffer even while a command buffer
+    // uses it, so the caller must know those bytes aren't read by it. If 'discard' is true and the
+    // VkBuffer is in use, another one is swapped in first and createdNewBuffer is set to true.
+    bool vkUpdateDataAt(GrVkGpu* gpu, const void* src, size_t srcSizeInBytes, size_t offset,
+                        bool discard, bool* createdNewBuffer);
+
     void vkAbandon();
     void vkRelease(const GrVkGpu* gpu);
 
@@ -109,6 +118,9 @@ private:
     void internalMap(GrVkGpu* gpu, size_t size, bool* createdNewBuffer = nullptr);
     void internalUnmap(GrVkGpu* gpu, size_t size);
 
+    // Replaces fResource, which is still in use by a command buffer, with one that isn't.
+    void swapInIdleResource(GrVkGpu* gpu);
+
     void validate() const;
     bool vkIsMapped() const;
 
@@ -117,6 +129,12 @@ private:
     VkDeviceSize            fOffset;
     void*                   fMapPtr;
 
+    // Dynamic vertex and index buffers are typically rewritten every flush while the previous
+    // flush's command buffer may still read them. Rather than allocating a new VkBuffer each time,
+    // the swapped out resources are kept here and reused once their command buffers finish.
+    static constexpr int kMaxRetiredResources = 3;
+    SkSTArray<kMaxRetiredResources, const Resource*> fRetiredResources;
+
     typedef SkNoncopyable INHERITED;
 };
 
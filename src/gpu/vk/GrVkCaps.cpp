@@ -35,6 +35,7 @@ GrVkCaps::GrVkCaps(const GrContextOptions& contextOptions, const GrVkInterface*
 
     fFenceSyncSupport = true;   // always available in Vulkan
     fCrossContextTextureSupport = true;
+    fTransferFromSurfaceToBufferSupport = true;
     fHalfFloatVertexAttributeSupport = true;
 
     fMapBufferFlags = kNone_MapFlags; //TODO: figure this out
@@ -450,6 +451,10 @@ void GrVkCaps::initGrCaps(const GrVkInterface* vkInterface,
 
     fOversizedStencilSupport = true;
     fSampleShadingSupport = features.features.sampleRateShading;
+    // vkCmdDrawIndexedIndirect only issues more than one draw with the multiDrawIndirect feature.
+    fMultiDrawIndexedIndirectSupport = features.features.multiDrawIndirect;
+    fIndirectBaseInstanceSupport = fMultiDrawIndexedIndirectSupport &&
+                                   features.features.drawIndirectFirstInstance;
 
     if (extensions.hasExtension(VK_EXT_BLEND_OPERATION_ADVANCED_EXTENSION_NAME, 2) &&
         this->supportsPhysicalDeviceProperties2()) {
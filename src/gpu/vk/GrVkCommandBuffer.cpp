@@ -12,6 +12,7 @@
 #include "GrVkImage.h"
 #include "GrVkImageView.h"
 #include "GrVkIndexBuffer.h"
+#include "GrVkIndirectBuffer.h"
 #include "GrVkPipeline.h"
 #include "GrVkPipelineState.h"
 #include "GrVkRenderPass.h"
@@ -38,6 +39,11 @@ void GrVkCommandBuffer::invalidateState() {
     for (int i = 0; i < 4; ++i) {
         fCachedBlendConstant[i] = -1.0;
     }
+
+    // Stencil values are at most 16 bits, so these never match.
+    for (StencilFaceState& face : fCachedStencil) {
+        face = {~0u, ~0u, ~0u};
+    }
 }
 
 void GrVkCommandBuffer::freeGPUData(const GrVkGpu* gpu) const {
@@ -296,6 +302,21 @@ void GrVkCommandBuffer::drawIndexed(const GrVkGpu* gpu,
                                                   firstInstance));
 }
 
+void GrVkCommandBuffer::drawIndexedIndirect(const GrVkGpu* gpu,
+                                            const GrVkIndirectBuffer* ibuffer,
+                                            VkDeviceSize offset,
+                                            uint32_t drawCount) {
+    SkASSERT(fIsActive);
+    SkASSERT(fActiveRenderPass);
+    SkASSERT(VK_NULL_HANDLE != ibuffer->buffer());
+    GR_VK_CALL(gpu->vkInterface(), CmdDrawIndexedIndirect(fCmdBuffer,
+                                                          ibuffer->buffer(),
+                                                          ibuffer->offset() + offset,
+                                                          drawCount,
+                                                          sizeof(VkDrawIndexedIndirectCommand)));
+    this->addResource(ibuffer->resource());
+}
+
 void GrVkCommandBuffer::draw(const GrVkGpu* gpu,
                              uint32_t vertexCount,
                              uint32_t instanceCount,
@@ -349,6 +370,39 @@ void GrVkCommandBuffer::setBlendConstants(const GrVkGpu* gpu,
     }
 }
 
+void GrVkCommandBuffer::setStencilState(const GrVkGpu* gpu, const StencilFaceState& front,
+                                        const StencilFaceState& back) {
+    SkASSERT(fIsActive);
+    if (!memcmp(&front, &fCachedStencil[0], sizeof(StencilFaceState)) &&
+        !memcmp(&back, &fCachedStencil[1], sizeof(StencilFaceState))) {
+        return;
+    }
+    const GrVkInterface* iface = gpu->vkInterface();
+    if (!memcmp(&front, &back, sizeof(StencilFaceState))) {
+        VkStencilFaceFlags faces = VK_STENCIL_FRONT_AND_BACK;
+        GR_VK_CALL(iface, CmdSetStencilCompareMask(fCmdBuffer, faces, front.fCompareMask));
+        GR_VK_CALL(iface, CmdSetStencilWriteMask(fCmdBuffer, faces, front.fWriteMask));
+        GR_VK_CALL(iface, CmdSetStencilReference(fCmdBuffer, faces, front.fReference));
+    } else {
+        const StencilFaceState* states[2] = { &front, &back };
+        const VkStencilFaceFlags faces[2] = { VK_STENCIL_FACE_FRONT_BIT, VK_STENCIL_FACE_BACK_BIT };
+        for (int i = 0; i < 2; ++i) {
+            GR_VK_CALL(iface, CmdSetStencilCompareMask(fCmdBuffer, faces[i],
+                                                       states[i]->fCompareMask));
+            GR_VK_CALL(iface, CmdSetStencilWriteMask(fCmdBuffer, faces[i], states[i]->fWriteMask));
+            GR_VK_CALL(iface, CmdSetStencilReference(fCmdBuffer, faces[i], states[i]->fReference));
+        }
+    }
+    fCachedStencil[0] = front;
+    fCachedStencil[1] = back;
+}
+
+void GrVkCommandBuffer::writeTimestamp(const GrVkGpu* gpu, VkPipelineStageFlagBits stage,
+                                       VkQueryPool pool, uint32_t query) {
+    SkASSERT(fIsActive);
+    GR_VK_CALL(gpu->vkInterface(), CmdWriteTimestamp(fCmdBuffer, stage, pool, query));
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 // PrimaryCommandBuffer
 ////////////////////////////////////////////////////////////////////////////////
@@ -444,15 +498,24 @@ void GrVkPrimaryCommandBuffer::endRenderPass(const GrVkGpu* gpu) {
 }
 
 void GrVkPrimaryCommandBuffer::executeCommands(const GrVkGpu* gpu,
-                                               GrVkSecondaryCommandBuffer* buffer) {
+                                               GrVkSecondaryCommandBuffer* const buffers[],
+                                               int count) {
     SkASSERT(fIsActive);
-    SkASSERT(!buffer->fIsActive);
     SkASSERT(fActiveRenderPass);
-    SkASSERT(fActiveRenderPass->isCompatible(*buffer->fActiveRenderPass));
+    if (!count) {
+        return;
+    }
 
-    GR_VK_CALL(gpu->vkInterface(), CmdExecuteCommands(fCmdBuffer, 1, &buffer->fCmdBuffer));
-    buffer->ref();
-    fSecondaryCommandBuffers.push_back(buffer);
+    SkSTArray<8, VkCommandBuffer, true> vkBuffers(count);
+    for (int i = 0; i < count; ++i) {
+        GrVkSecondaryCommandBuffer* buffer = buffers[i];
+        SkASSERT(!buffer->fIsActive);
+        SkASSERT(fActiveRenderPass->isCompatible(*buffer->fActiveRenderPass));
+        vkBuffers.push_back(buffer->fCmdBuffer);
+        buffer->ref();
+        fSecondaryCommandBuffers.push_back(buffer);
+    }
+    GR_VK_CALL(gpu->vkInterface(), CmdExecuteCommands(fCmdBuffer, count, vkBuffers.begin()));
     // When executing a secondary command buffer all state (besides render pass state) becomes
     // invalidated and must be reset. This includes bound buffers, pipelines, dynamic state, etc.
     this->invalidateState();
@@ -738,6 +801,13 @@ void GrVkPrimaryCommandBuffer::updateBuffer(GrVkGpu* gpu,
                                                    (const uint32_t*) data));
 }
 
+void GrVkPrimaryCommandBuffer::resetQueryPool(const GrVkGpu* gpu, VkQueryPool pool,
+                                              uint32_t firstQuery, uint32_t queryCount) {
+    SkASSERT(fIsActive);
+    SkASSERT(!fActiveRenderPass);
+    GR_VK_CALL(gpu->vkInterface(), CmdResetQueryPool(fCmdBuffer, pool, firstQuery, queryCount));
+}
+
 void GrVkPrimaryCommandBuffer::clearColorImage(const GrVkGpu* gpu,
                                                GrVkImage* image,
                                                const VkClearColorValue* color,
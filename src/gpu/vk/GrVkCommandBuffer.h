@@ -18,6 +18,7 @@
 class GrVkBuffer;
 class GrVkFramebuffer;
 class GrVkIndexBuffer;
+class GrVkIndirectBuffer;
 class GrVkImage;
 class GrVkPipeline;
 class GrVkPipelineState;
@@ -83,6 +84,17 @@ public:
 
     void setBlendConstants(const GrVkGpu* gpu, const float blendConstants[4]);
 
+    struct StencilFaceState {
+        uint32_t fCompareMask;
+        uint32_t fWriteMask;
+        uint32_t fReference;
+    };
+    void setStencilState(const GrVkGpu* gpu, const StencilFaceState& front,
+                         const StencilFaceState& back);
+
+    void writeTimestamp(const GrVkGpu* gpu, VkPipelineStageFlagBits stage, VkQueryPool pool,
+                        uint32_t query);
+
     // Commands that only work inside of a render pass
     void clearAttachments(const GrVkGpu* gpu,
                           int numAttachments,
@@ -97,6 +109,13 @@ public:
                      int32_t vertexOffset,
                      uint32_t firstInstance) const;
 
+    // Issues drawCount indexed draws whose parameters are VkDrawIndexedIndirectCommands in
+    // ibuffer, starting at offset.
+    void drawIndexedIndirect(const GrVkGpu* gpu,
+                             const GrVkIndirectBuffer* ibuffer,
+                             VkDeviceSize offset,
+                             uint32_t drawCount);
+
     void draw(const GrVkGpu* gpu,
               uint32_t vertexCount,
               uint32_t instanceCount,
@@ -178,6 +197,7 @@ private:
     VkViewport fCachedViewport;
     VkRect2D   fCachedScissor;
     float      fCachedBlendConstant[4];
+    StencilFaceState fCachedStencil[2];  // front and back
 };
 
 class GrVkSecondaryCommandBuffer;
@@ -201,11 +221,11 @@ public:
                          bool forSecondaryCB);
     void endRenderPass(const GrVkGpu* gpu);
 
-    // Submits the SecondaryCommandBuffer into this command buffer. It is required that we are
-    // currently inside a render pass that is compatible with the one used to create the
-    // SecondaryCommandBuffer.
+    // Submits the SecondaryCommandBuffers, in order, into this command buffer with a single
+    // vkCmdExecuteCommands. It is required that we are currently inside a render pass that is
+    // compatible with the ones used to create the SecondaryCommandBuffers.
     void executeCommands(const GrVkGpu* gpu,
-                         GrVkSecondaryCommandBuffer* secondaryBuffer);
+                         GrVkSecondaryCommandBuffer* const secondaryBuffers[], int count);
 
     // Commands that only work outside of a render pass
     void clearColorImage(const GrVkGpu* gpu,
@@ -272,6 +292,17 @@ public:
                       VkDeviceSize dataSize,
                       const void* data);
 
+    void resetQueryPool(const GrVkGpu* gpu, VkQueryPool pool, uint32_t firstQuery,
+                        uint32_t queryCount);
+
+    // For code that records its own commands outside of a render pass (e.g. GrVkKeySorter). It
+    // has to add the resources it uses and invalidate the bound state once it's done.
+    VkCommandBuffer vkCommandBuffer() {
+        SkASSERT(fIsActive);
+        SkASSERT(!fActiveRenderPass);
+        return fCmdBuffer;
+    }
+
     void resolveImage(GrVkGpu* gpu,
                       const GrVkImage& srcImage,
                       const GrVkImage& dstImage,
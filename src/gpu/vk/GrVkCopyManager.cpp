@@ -75,16 +75,19 @@ bool GrVkCopyManager::createCopyProgram(GrVkGpu* gpu) {
     );
 
     SkSL::Program::Settings settings;
+    SkSL::String spirv;
     SkSL::Program::Inputs inputs;
     if (!GrCompileVkShaderModule(gpu, vertShaderText.c_str(), VK_SHADER_STAGE_VERTEX_BIT,
-                                 &fVertShaderModule, &fShaderStageInfo[0], settings, &inputs)) {
+                                 &fVertShaderModule, &fShaderStageInfo[0], settings, &spirv,
+                                 &inputs)) {
         this->destroyResources(gpu);
         return false;
     }
     SkASSERT(inputs.isEmpty());
 
     if (!GrCompileVkShaderModule(gpu, fragShaderText.c_str(), VK_SHADER_STAGE_FRAGMENT_BIT,
-                                 &fFragShaderModule, &fShaderStageInfo[1], settings, &inputs)) {
+                                 &fFragShaderModule, &fShaderStageInfo[1], settings, &spirv,
+                                 &inputs)) {
         this->destroyResources(gpu);
         return false;
     }
@@ -245,7 +248,7 @@ bool GrVkCopyManager::copySurfaceAsDraw(GrVkGpu* gpu,
     descriptorWrites.dstBinding = GrVkUniformHandler::kGeometryBinding;
     descriptorWrites.dstArrayElement = 0;
     descriptorWrites.descriptorCount = 1;
-    descriptorWrites.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+    descriptorWrites.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
     descriptorWrites.pImageInfo = nullptr;
     descriptorWrites.pBufferInfo = &uniBufferInfo;
     descriptorWrites.pTexelBufferView = nullptr;
@@ -289,6 +292,8 @@ bool GrVkCopyManager::copySurfaceAsDraw(GrVkGpu* gpu,
                                                         0, nullptr));
 
     VkDescriptorSet vkDescSets[] = { uniformDS->descriptorSet(), samplerDS->descriptorSet() };
+    // The uniform descriptor set has dynamic offsets for both of its bindings.
+    static const uint32_t kUniformOffsets[] = { 0, 0 };
 
     GrVkRenderTarget* texRT = static_cast<GrVkRenderTarget*>(srcTex->asRenderTarget());
     if (texRT) {
@@ -378,8 +383,8 @@ bool GrVkCopyManager::copySurfaceAsDraw(GrVkGpu* gpu,
                                   0,
                                   2,
                                   vkDescSets,
-                                  0,
-                                  nullptr);
+                                  SK_ARRAY_COUNT(kUniformOffsets),
+                                  kUniformOffsets);
 
     // Set Dynamic viewport and stencil
     // We always use one viewport the size of the RT
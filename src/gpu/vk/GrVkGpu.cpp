@@ -21,6 +21,7 @@
 #include "GrVkGpuCommandBuffer.h"
 #include "GrVkImage.h"
 #include "GrVkIndexBuffer.h"
+#include "GrVkIndirectBuffer.h"
 #include "GrVkInterface.h"
 #include "GrVkMemory.h"
 #include "GrVkPipeline.h"
@@ -225,10 +226,20 @@ void GrVkGpu::destroyResources() {
 
 
     fCopyManager.destroyResources(this);
+    fStagingBuffers.reset();
+    fCurrentStagingBuffer = -1;
+
+    if (fKeySorter) {
+        fKeySorter->destroyResources(this);
+    }
 
     // must call this just before we destroy the command pool and VkDevice
     fResourceProvider.destroyResources(VK_ERROR_DEVICE_LOST == res);
 
+    if (fTimerQueryPool != VK_NULL_HANDLE) {
+        VK_CALL(DestroyQueryPool(fDevice, fTimerQueryPool, nullptr));
+    }
+
     if (fCmdPool != VK_NULL_HANDLE) {
         VK_CALL(DestroyCommandPool(fDevice, fCmdPool, nullptr));
     }
@@ -264,6 +275,11 @@ void GrVkGpu::disconnect(DisconnectType type) {
                 fSemaphoresToSignal[i]->unrefAndAbandon();
             }
             fCopyManager.abandonResources();
+            fStagingBuffers.reset();
+            fCurrentStagingBuffer = -1;
+            if (fKeySorter) {
+                fKeySorter->abandonResources();
+            }
 
             // must call this just before we destroy the command pool and VkDevice
             fResourceProvider.abandonResources();
@@ -274,6 +290,9 @@ void GrVkGpu::disconnect(DisconnectType type) {
         fSemaphoresToSignal.reset();
         fCurrentCmdBuffer = nullptr;
         fCmdPool = VK_NULL_HANDLE;
+        fTimerQueryPool = VK_NULL_HANDLE;
+        fFreeTimerQueries.reset();
+        fKeySorter.reset();
         fDisconnected = true;
     }
 }
@@ -355,8 +374,11 @@ GrBuffer* GrVkGpu::onCreateBuffer(size_t size, GrBufferType type, GrAccessPatter
             buff = GrVkTransferBuffer::Create(this, size, GrVkBuffer::kCopyWrite_Type);
             break;
         case kDrawIndirect_GrBufferType:
-            SK_ABORT("DrawIndirect Buffers not supported  in vulkan backend.");
-            return nullptr;
+            SkASSERT(kDynamic_GrAccessPattern == accessPattern ||
+                     kStatic_GrAccessPattern == accessPattern);
+            buff = GrVkIndirectBuffer::Create(this, size,
+                                              kDynamic_GrAccessPattern == accessPattern);
+            break;
         default:
             SK_ABORT("Unknown buffer type.");
             return nullptr;
@@ -650,10 +672,9 @@ bool GrVkGpu::uploadTexDataOptimal(GrVkTexture* tex, int left, int top, int widt
         return true;
     }
 
-    // allocate buffer to hold our mip data
-    GrVkTransferBuffer* transferBuffer =
-                   GrVkTransferBuffer::Create(this, combinedBufferSize, GrVkBuffer::kCopyRead_Type);
-    if (!transferBuffer) {
+    // find room in a staging buffer to hold our mip data
+    StagingSlice slice;
+    if (!this->mapStagingSlice(combinedBufferSize, alignmentMask + 1, &slice)) {
         return false;
     }
 
@@ -689,6 +710,7 @@ bool GrVkGpu::uploadTexDataOptimal(GrVkTexture* tex, int left, int top, int widt
         copyTexture = GrVkTexture::MakeNewTexture(this, SkBudgeted::kYes, surfDesc, imageDesc,
                                                   GrMipMapsStatus::kNotAllocated);
         if (!copyTexture) {
+            this->unmapStagingSlice(slice, combinedBufferSize);
             return false;
         }
         uploadTexture = copyTexture.get();
@@ -696,7 +718,7 @@ bool GrVkGpu::uploadTexDataOptimal(GrVkTexture* tex, int left, int top, int widt
         uploadTop = 0;
     }
 
-    char* buffer = (char*) transferBuffer->map();
+    char* buffer = (char*) slice.fMapPtr;
     SkTArray<VkBufferImageCopy> regions(mipLevelCount);
 
     currentWidth = width;
@@ -717,7 +739,7 @@ bool GrVkGpu::uploadTexDataOptimal(GrVkTexture* tex, int left, int top, int widt
 
             VkBufferImageCopy& region = regions.push_back();
             memset(&region, 0, sizeof(VkBufferImageCopy));
-            region.bufferOffset = transferBuffer->offset() + individualMipOffsets[currentMipLevel];
+            region.bufferOffset = slice.fOffset + individualMipOffsets[currentMipLevel];
             region.bufferRowLength = currentWidth;
             region.bufferImageHeight = currentHeight;
             region.imageSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, SkToU32(currentMipLevel), 0, 1 };
@@ -730,7 +752,7 @@ bool GrVkGpu::uploadTexDataOptimal(GrVkTexture* tex, int left, int top, int widt
     }
 
     // no need to flush non-coherent memory, unmap will do that for us
-    transferBuffer->unmap();
+    this->unmapStagingSlice(slice, combinedBufferSize);
 
     // Change layout of our target so it can be copied to
     uploadTexture->setImageLayout(this,
@@ -741,12 +763,11 @@ bool GrVkGpu::uploadTexDataOptimal(GrVkTexture* tex, int left, int top, int widt
 
     // Copy the buffer to the image
     fCurrentCmdBuffer->copyBufferToImage(this,
-                                         transferBuffer,
+                                         slice.fBuffer.get(),
                                          uploadTexture,
                                          VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
                                          regions.count(),
                                          regions.begin());
-    transferBuffer->unref();
 
     // If we copied the data into a temporary image first, copy that image into our main texture
     // now.
@@ -868,6 +889,70 @@ bool GrVkGpu::updateBuffer(GrVkBuffer* buffer, const void* src,
     return true;
 }
 
+bool GrVkGpu::mapStagingSlice(size_t size, size_t alignment, StagingSlice* slice) {
+    SkASSERT(SkIsPow2(alignment));
+    // Large uploads would quickly use up the shared buffers, so they get buffers of their own.
+    bool shared = size <= kStagingBufferSize / 4;
+    size_t offset = GrSizeAlignUp(fStagingOffset, alignment);
+    if (shared &&
+        (fCurrentStagingBuffer < 0 || offset + size > kStagingBufferSize)) {
+        // Once the command buffers that copied out of a staging buffer have finished, its
+        // GrVkBuffer holds the only ref on its resource.
+        fCurrentStagingBuffer = -1;
+        for (int i = 0; i < fStagingBuffers.count(); ++i) {
+            if (fStagingBuffers[i]->resource()->unique()) {
+                fCurrentStagingBuffer = i;
+                break;
+            }
+        }
+        if (fCurrentStagingBuffer < 0 && fStagingBuffers.count() < kMaxStagingBuffers) {
+            sk_sp<GrVkTransferBuffer> buffer(GrVkTransferBuffer::Create(
+                    this, kStagingBufferSize, GrVkBuffer::kCopyRead_Type));
+            if (buffer) {
+                fCurrentStagingBuffer = fStagingBuffers.count();
+                fStagingBuffers.push_back(std::move(buffer));
+            }
+        }
+        offset = 0;
+    }
+
+    if (!shared || fCurrentStagingBuffer < 0) {
+        slice->fBuffer.reset(GrVkTransferBuffer::Create(this, size, GrVkBuffer::kCopyRead_Type));
+        if (!slice->fBuffer) {
+            return false;
+        }
+        slice->fOffset = 0;
+        slice->fMapPtr = slice->fBuffer->map();
+        slice->fShared = false;
+        return SkToBool(slice->fMapPtr);
+    }
+
+    // Command buffers may still be reading the part of the buffer before 'offset', so map it
+    // directly rather than through GrBuffer::map(), which would swap in a new VkBuffer.
+    const sk_sp<GrVkTransferBuffer>& buffer = fStagingBuffers[fCurrentStagingBuffer];
+    void* mapPtr = GrVkMemory::MapAlloc(this, buffer->alloc());
+    if (!mapPtr) {
+        return false;
+    }
+    slice->fBuffer = buffer;
+    slice->fOffset = offset;
+    slice->fMapPtr = SkTAddOffset<void>(mapPtr, offset);
+    slice->fShared = true;
+    fStagingOffset = offset + size;
+    return true;
+}
+
+void GrVkGpu::unmapStagingSlice(const StagingSlice& slice, size_t size) {
+    if (!slice.fShared) {
+        slice.fBuffer->unmap();
+        return;
+    }
+    const GrVkAlloc& alloc = slice.fBuffer->alloc();
+    // Non-coherent memory is flushed from its start, which rewrites the earlier data unchanged.
+    GrVkMemory::FlushMappedAlloc(this, alloc, 0, slice.fOffset + size);
+    GrVkMemory::UnmapAlloc(this, alloc);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 static bool check_image_info(const GrVkCaps& caps,
@@ -1981,6 +2066,75 @@ bool GrVkGpu::onReadPixels(GrSurface* surface, int left, int top, int width, int
     return true;
 }
 
+bool GrVkGpu::onTransferPixelsFrom(GrSurface* surface, int left, int top, int width, int height,
+                                   GrColorType dstColorType, GrBuffer* transferBuffer,
+                                   size_t offset) {
+    // Unlike onReadPixels(), this doesn't go through an RGBA copy of RGB_888x surfaces.
+    if (GrPixelConfigToColorType(surface->config()) != dstColorType ||
+        GrColorType::kRGB_888x == dstColorType) {
+        return false;
+    }
+    // The copy must write exactly the requested rows to the buffer.
+    if (this->vkCaps().mustDoCopiesFromOrigin() && (left || top)) {
+        return false;
+    }
+
+    GrVkImage* image = nullptr;
+    GrVkRenderTarget* rt = static_cast<GrVkRenderTarget*>(surface->asRenderTarget());
+    if (rt) {
+        switch (rt->getResolveType()) {
+            case GrVkRenderTarget::kCantResolve_ResolveType:
+                return false;
+            case GrVkRenderTarget::kAutoResolves_ResolveType:
+                break;
+            case GrVkRenderTarget::kCanResolve_ResolveType:
+                this->internalResolveRenderTarget(rt, false);
+                break;
+            default:
+                SK_ABORT("Unknown resolve type");
+        }
+        image = rt;
+    } else {
+        image = static_cast<GrVkTexture*>(surface->asTexture());
+    }
+    if (!image) {
+        return false;
+    }
+
+    image->setImageLayout(this,
+                          VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                          VK_ACCESS_TRANSFER_READ_BIT,
+                          VK_PIPELINE_STAGE_TRANSFER_BIT,
+                          false);
+
+    GrVkTransferBuffer* vkBuffer = static_cast<GrVkTransferBuffer*>(transferBuffer);
+
+    VkBufferImageCopy region;
+    memset(&region, 0, sizeof(VkBufferImageCopy));
+    region.bufferOffset = vkBuffer->offset() + offset;
+    region.bufferRowLength = 0; // Tightly packed rows.
+    region.bufferImageHeight = 0;
+    region.imageSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1 };
+    region.imageOffset = { left, top, 0 };
+    region.imageExtent = { (uint32_t)width, (uint32_t)height, 1 };
+
+    fCurrentCmdBuffer->copyImageToBuffer(this,
+                                         image,
+                                         VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                                         vkBuffer,
+                                         1,
+                                         &region);
+
+    // Make the copy visible to the host once the command buffer's fence signals.
+    vkBuffer->addMemoryBarrier(this,
+                               VK_ACCESS_TRANSFER_WRITE_BIT,
+                               VK_ACCESS_HOST_READ_BIT,
+                               VK_PIPELINE_STAGE_TRANSFER_BIT,
+                               VK_PIPELINE_STAGE_HOST_BIT,
+                               false);
+    return true;
+}
+
 // The RenderArea bounds we pass into BeginRenderPass must have a start x value that is a multiple
 // of the granularity. The width must also be a multiple of the granularity or eaqual to the width
 // the the entire attachment. Similar requirements for the y and height components.
@@ -2065,9 +2219,7 @@ void GrVkGpu::submitSecondaryCommandBuffer(const SkTArray<GrVkSecondaryCommandBu
     clears[1].depthStencil.stencil = 0;
 
     fCurrentCmdBuffer->beginRenderPass(this, renderPass, clears, *target, *pBounds, true);
-    for (int i = 0; i < buffers.count(); ++i) {
-        fCurrentCmdBuffer->executeCommands(this, buffers[i]);
-    }
+    fCurrentCmdBuffer->executeCommands(this, buffers.begin(), buffers.count());
     fCurrentCmdBuffer->endRenderPass(this);
 
     this->didWriteToSurface(target, origin, &bounds);
@@ -2113,6 +2265,75 @@ void GrVkGpu::deleteFence(GrFence fence) const {
     VK_CALL(DestroyFence(this->device(), (VkFence)fence, nullptr));
 }
 
+GrTimerQuery GrVkGpu::beginTimerQuery(GrVkCommandBuffer* cmdBuffer) {
+    if (!fPhysDevProps.limits.timestampComputeAndGraphics) {
+        return 0;
+    }
+    if (VK_NULL_HANDLE == fTimerQueryPool) {
+        VkQueryPoolCreateInfo createInfo;
+        memset(&createInfo, 0, sizeof(VkQueryPoolCreateInfo));
+        createInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+        createInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+        createInfo.queryCount = 2 * kMaxTimerQueries;
+        VkResult err = VK_CALL(CreateQueryPool(fDevice, &createInfo, nullptr, &fTimerQueryPool));
+        if (VK_SUCCESS != err) {
+            fTimerQueryPool = VK_NULL_HANDLE;
+            return 0;
+        }
+        for (uint32_t i = kMaxTimerQueries; i > 0; --i) {
+            fFreeTimerQueries.push_back(i - 1);
+        }
+    }
+    if (fFreeTimerQueries.isEmpty()) {
+        return 0;
+    }
+    uint32_t index;
+    fFreeTimerQueries.pop(&index);
+
+    // The reset goes in the primary command buffer, which executes cmdBuffer after it.
+    fCurrentCmdBuffer->resetQueryPool(this, fTimerQueryPool, 2 * index, 2);
+    cmdBuffer->writeTimestamp(this, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, fTimerQueryPool, 2 * index);
+    return index + 1;
+}
+
+void GrVkGpu::endTimerQuery(GrVkCommandBuffer* cmdBuffer, GrTimerQuery query) {
+    SkASSERT(query);
+    uint32_t index = (uint32_t)(query - 1);
+    cmdBuffer->writeTimestamp(this, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, fTimerQueryPool,
+                              2 * index + 1);
+}
+
+bool GrVkGpu::getTimerQueryResult(GrTimerQuery query, uint64_t* nanos) {
+    SkASSERT(query);
+    uint32_t index = (uint32_t)(query - 1);
+
+    // Each timestamp is followed by its availability.
+    uint64_t results[4];
+    auto getResults = [&]() {
+        VkResult err = VK_CALL(GetQueryPoolResults(fDevice, fTimerQueryPool, 2 * index, 2,
+                                                   sizeof(results), results, 2 * sizeof(uint64_t),
+                                                   VK_QUERY_RESULT_64_BIT |
+                                                   VK_QUERY_RESULT_WITH_AVAILABILITY_BIT));
+        return (VK_SUCCESS == err || VK_NOT_READY == err) && results[1] && results[3];
+    };
+    if (!getResults()) {
+        // The timestamps may still be sitting in an unsubmitted command buffer. If they're not
+        // available after that, the secondary command buffer holding them was never executed.
+        this->submitCommandBuffer(kForce_SyncQueue);
+        if (!getResults()) {
+            return false;
+        }
+    }
+    double ticks = (double)(results[2] - results[0]);
+    *nanos = (uint64_t)(ticks * fPhysDevProps.limits.timestampPeriod);
+    return true;
+}
+
+void GrVkGpu::deleteTimerQuery(GrTimerQuery query) {
+    SkASSERT(query);
+    fFreeTimerQueries.push_back((uint32_t)(query - 1));
+}
+
 sk_sp<GrSemaphore> SK_WARN_UNUSED_RESULT GrVkGpu::makeSemaphore(bool isOwned) {
     return GrVkSemaphore::Make(this, isOwned);
 }
@@ -2147,6 +2368,27 @@ void GrVkGpu::waitSemaphore(sk_sp<GrSemaphore> semaphore) {
     }
 }
 
+int GrVkGpu::sortKeysBufferCount(int count) {
+    if (!fTriedMakingKeySorter) {
+        fKeySorter = GrVkKeySorter::Make(this);
+        fTriedMakingKeySorter = true;
+    }
+    return fKeySorter ? fKeySorter->paddedKeyCount(count) : 0;
+}
+
+void GrVkGpu::sortKeys(GrBuffer* keys, int count) {
+    SkASSERT(fKeySorter);
+    SkASSERT(!keys->isCPUBacked());
+    if (count <= 1) {
+        return;
+    }
+    fKeySorter->sort(this, static_cast<GrVkVertexBuffer*>(keys), count);
+}
+
+void GrVkGpu::storeVkPipelineCacheData() {
+    fResourceProvider.storePipelineCacheData();
+}
+
 sk_sp<GrSemaphore> GrVkGpu::prepareTextureForCrossContextUsage(GrTexture* texture) {
     SkASSERT(texture);
     GrVkTexture* vkTexture = static_cast<GrVkTexture*>(texture);
@@ -15,15 +15,18 @@
 #include "GrVkCaps.h"
 #include "GrVkCopyManager.h"
 #include "GrVkIndexBuffer.h"
+#include "GrVkKeySorter.h"
 #include "GrVkMemory.h"
 #include "GrVkResourceProvider.h"
 #include "GrVkSemaphore.h"
+#include "GrVkTransferBuffer.h"
 #include "GrVkVertexBuffer.h"
 #include "GrVkUtil.h"
 
 class GrPipeline;
 
 class GrVkBufferImpl;
+class GrVkCommandBuffer;
 class GrVkGpuRTCommandBuffer;
 class GrVkGpuTextureCommandBuffer;
 class GrVkMemoryAllocator;
@@ -135,6 +138,16 @@ public:
     bool waitFence(GrFence, uint64_t timeout) override;
     void deleteFence(GrFence) const override;
 
+    // Timer queries are pairs of timestamps in fTimerQueryPool, written into the given command
+    // buffer (one of GrVkGpuRTCommandBuffer's secondaries).
+    GrTimerQuery beginTimerQuery(GrVkCommandBuffer*);
+    void endTimerQuery(GrVkCommandBuffer*, GrTimerQuery);
+    bool getTimerQueryResult(GrTimerQuery, uint64_t* nanos) override;
+    void deleteTimerQuery(GrTimerQuery) override;
+
+    int sortKeysBufferCount(int count) override;
+    void sortKeys(GrBuffer* keys, int count) override;
+
     sk_sp<GrSemaphore> SK_WARN_UNUSED_RESULT makeSemaphore(bool isOwned) override;
     sk_sp<GrSemaphore> wrapBackendSemaphore(const GrBackendSemaphore& semaphore,
                                             GrResourceProvider::SemaphoreWrapType wrapType,
@@ -142,6 +155,8 @@ public:
     void insertSemaphore(sk_sp<GrSemaphore> semaphore, bool flush) override;
     void waitSemaphore(sk_sp<GrSemaphore> semaphore) override;
 
+    void storeVkPipelineCacheData() override;
+
     // These match the definitions in SkDrawable, from whence they came
     typedef void* SubmitContext;
     typedef void (*SubmitProc)(SubmitContext submitContext);
@@ -156,6 +171,20 @@ public:
                     VkDeviceSize dstOffset, VkDeviceSize size);
     bool updateBuffer(GrVkBuffer* buffer, const void* src, VkDeviceSize offset, VkDeviceSize size);
 
+    // Mapped room in a staging buffer for data to be copied into an image or buffer.
+    struct StagingSlice {
+        sk_sp<GrVkTransferBuffer> fBuffer;
+        VkDeviceSize              fOffset = 0;
+        void*                     fMapPtr = nullptr;
+        bool                      fShared = false;
+    };
+    // Sets aside 'size' bytes at an offset into a staging buffer that is a multiple of 'alignment'
+    // (a power of two) and maps them. Small uploads are packed into a few large staging buffers,
+    // each reused once no command buffer reads it anymore, rather than each creating a VkBuffer.
+    bool mapStagingSlice(size_t size, size_t alignment, StagingSlice*);
+    // Must be called before the slice is copied from, with the size passed to mapStagingSlice().
+    void unmapStagingSlice(const StagingSlice&, size_t size);
+
     uint32_t getExtraSamplerKeyForProgram(const GrSamplerState&,
                                           const GrBackendFormat& format) override;
 
@@ -192,6 +221,9 @@ private:
     bool onTransferPixels(GrTexture*, int left, int top, int width, int height, GrColorType,
                           GrBuffer* transferBuffer, size_t offset, size_t rowBytes) override;
 
+    bool onTransferPixelsFrom(GrSurface*, int left, int top, int width, int height, GrColorType,
+                              GrBuffer* transferBuffer, size_t offset) override;
+
     bool onCopySurface(GrSurface* dst, GrSurfaceOrigin dstOrigin, GrSurface* src,
                        GrSurfaceOrigin srcOrigin, const SkIRect& srcRect,
                        const SkIPoint& dstPoint, bool canDiscardOutsideDstRect) override;
@@ -266,6 +298,24 @@ private:
 
     GrVkCopyManager                                       fCopyManager;
 
+    // The staging buffers shared by small uploads. fStagingBuffers[fCurrentStagingBuffer] is
+    // filled up to fStagingOffset, and once it is full uploads move on to a buffer that no command
+    // buffer reads anymore.
+    static constexpr size_t                               kStagingBufferSize = 4 * 1024 * 1024;
+    static constexpr int                                  kMaxStagingBuffers = 4;
+    SkSTArray<kMaxStagingBuffers, sk_sp<GrVkTransferBuffer>> fStagingBuffers;
+    int                                                   fCurrentStagingBuffer = -1;
+    size_t                                                fStagingOffset = 0;
+
+    // Created on the first timer query. Each query uses two slots, and is 1 + its pair's index.
+    static constexpr int                                  kMaxTimerQueries = 256;
+    VkQueryPool                                           fTimerQueryPool = VK_NULL_HANDLE;
+    SkTDArray<uint32_t>                                   fFreeTimerQueries;
+
+    // Created on the first key sort, if HotSort supports the device.
+    std::unique_ptr<GrVkKeySorter>                        fKeySorter;
+    bool                                                  fTriedMakingKeySorter = false;
+
     // compiler used for compiling sksl into spirv. We only want to create the compiler once since
     // there is significant overhead to the first compile of any compiler.
     SkSL::Compiler*                                       fCompiler;
@@ -13,9 +13,11 @@
 #include "GrOpFlushState.h"
 #include "GrPipeline.h"
 #include "GrRenderTargetPriv.h"
+#include "GrStencilSettings.h"
 #include "GrTexturePriv.h"
 #include "GrVkCommandBuffer.h"
 #include "GrVkGpu.h"
+#include "GrVkIndirectBuffer.h"
 #include "GrVkPipeline.h"
 #include "GrVkRenderPass.h"
 #include "GrVkRenderTarget.h"
@@ -84,7 +86,9 @@ GrVkGpuRTCommandBuffer::GrVkGpuRTCommandBuffer(GrVkGpu* gpu)
 
 void GrVkGpuRTCommandBuffer::init() {
     GrVkRenderPass::LoadStoreOps vkColorOps(fVkColorLoadOp, fVkColorStoreOp);
-    GrVkRenderPass::LoadStoreOps vkStencilOps(fVkStencilLoadOp, fVkStencilStoreOp);
+    // Later render passes for this command buffer may still need the stencil values, so only the
+    // last one applies fVkStencilStoreOp (see end()).
+    GrVkRenderPass::LoadStoreOps vkStencilOps(fVkStencilLoadOp, VK_ATTACHMENT_STORE_OP_STORE);
 
     CommandBufferInfo& cbInfo = fCommandBufferInfos.push_back();
     SkASSERT(fCommandBufferInfos.count() == 1);
@@ -134,8 +138,33 @@ GrVkGpuRTCommandBuffer::~GrVkGpuRTCommandBuffer() {
 GrGpu* GrVkGpuRTCommandBuffer::gpu() { return fGpu; }
 
 void GrVkGpuRTCommandBuffer::end() {
-    if (fCurrentCmdInfo >= 0) {
-        fCommandBufferInfos[fCurrentCmdInfo].currentCmdBuf()->end(fGpu);
+    if (fCurrentCmdInfo < 0) {
+        return;
+    }
+    CommandBufferInfo& cbInfo = fCommandBufferInfos[fCurrentCmdInfo];
+    cbInfo.currentCmdBuf()->end(fGpu);
+
+    const GrVkRenderPass* oldRP = cbInfo.fRenderPass;
+    if (VK_ATTACHMENT_STORE_OP_STORE != fVkStencilStoreOp &&
+        fVkStencilStoreOp != oldRP->stencilLoadStoreOps().fStoreOp &&
+        fRenderTarget->renderTargetPriv().getStencilAttachment()) {
+        // Nothing reads the stencil values after the last render pass, so a tiler needn't write
+        // them back to memory. The new render pass is compatible with the one the secondary
+        // command buffers were recorded against.
+        GrVkRenderPass::LoadStoreOps vkStencilOps(oldRP->stencilLoadStoreOps().fLoadOp,
+                                                  fVkStencilStoreOp);
+        GrVkRenderTarget* vkRT = static_cast<GrVkRenderTarget*>(fRenderTarget);
+        const GrVkResourceProvider::CompatibleRPHandle& rpHandle =
+                vkRT->compatibleRenderPassHandle();
+        if (rpHandle.isValid()) {
+            cbInfo.fRenderPass = fGpu->resourceProvider().findRenderPass(
+                    rpHandle, oldRP->colorLoadStoreOps(), vkStencilOps);
+        } else {
+            cbInfo.fRenderPass = fGpu->resourceProvider().findRenderPass(
+                    *vkRT, oldRP->colorLoadStoreOps(), vkStencilOps);
+        }
+        SkASSERT(cbInfo.fRenderPass->isCompatible(*oldRP));
+        oldRP->unref(fGpu);
     }
 }
 
@@ -386,7 +415,7 @@ void GrVkGpuRTCommandBuffer::onClear(const GrFixedClip& clip, const SkPMColor4f&
         GrVkRenderPass::LoadStoreOps vkColorOps(VK_ATTACHMENT_LOAD_OP_CLEAR,
                                                 VK_ATTACHMENT_STORE_OP_STORE);
         // Preserve the stencil buffer's load & store settings
-        GrVkRenderPass::LoadStoreOps vkStencilOps(fVkStencilLoadOp, fVkStencilStoreOp);
+        GrVkRenderPass::LoadStoreOps vkStencilOps = cbInfo.fRenderPass->stencilLoadStoreOps();
 
         const GrVkRenderPass* oldRP = cbInfo.fRenderPass;
 
@@ -652,6 +681,11 @@ GrVkPipelineState* GrVkGpuRTCommandBuffer::prepareDrawState(
     GrVkPipeline::SetDynamicViewportState(fGpu, cbInfo.currentCmdBuf(), rt);
     GrVkPipeline::SetDynamicBlendConstantState(fGpu, cbInfo.currentCmdBuf(), rt->config(),
                                                pipeline.getXferProcessor());
+    if (pipeline.isStencilEnabled()) {
+        GrStencilSettings stencil(*pipeline.getUserStencil(), pipeline.hasStencilClip(),
+                                  rt->renderTargetPriv().numStencilBits());
+        GrVkPipeline::SetDynamicStencilState(fGpu, cbInfo.currentCmdBuf(), stencil);
+    }
 
     return pipelineState;
 }
@@ -787,6 +821,26 @@ void GrVkGpuRTCommandBuffer::sendIndexedInstancedMeshToGpu(GrPrimitiveType,
     fGpu->stats()->incNumDraws();
 }
 
+void GrVkGpuRTCommandBuffer::sendIndexedIndirectMeshToGpu(GrPrimitiveType,
+                                                          const GrBuffer* indexBuffer,
+                                                          const GrBuffer* vertexBuffer,
+                                                          const GrBuffer* instanceBuffer,
+                                                          const GrBuffer* indirectBuffer,
+                                                          size_t indirectOffset,
+                                                          int drawCount,
+                                                          GrPrimitiveRestart restart) {
+    GR_STATIC_ASSERT(sizeof(GrDrawIndexedIndirectCommand) == sizeof(VkDrawIndexedIndirectCommand));
+    SkASSERT(restart == GrPrimitiveRestart::kNo);
+    SkASSERT(fGpu->caps()->multiDrawIndexedIndirectSupport());
+    SkASSERT(!indirectBuffer->isCPUBacked());
+    CommandBufferInfo& cbInfo = fCommandBufferInfos[fCurrentCmdInfo];
+    this->bindGeometry(indexBuffer, vertexBuffer, instanceBuffer);
+    cbInfo.currentCmdBuf()->drawIndexedIndirect(
+            fGpu, static_cast<const GrVkIndirectBuffer*>(indirectBuffer), indirectOffset,
+            drawCount);
+    fGpu->stats()->incNumDraws();
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 void GrVkGpuRTCommandBuffer::executeDrawable(std::unique_ptr<SkDrawable::GpuDrawHandler> drawable) {
@@ -819,3 +873,11 @@ void GrVkGpuRTCommandBuffer::executeDrawable(std::unique_ptr<SkDrawable::GpuDraw
     }
 }
 
+
+GrTimerQuery GrVkGpuRTCommandBuffer::beginTimerQuery() {
+    return fGpu->beginTimerQuery(fCommandBufferInfos[fCurrentCmdInfo].currentCmdBuf());
+}
+
+void GrVkGpuRTCommandBuffer::endTimerQuery(GrTimerQuery query) {
+    fGpu->endTimerQuery(fCommandBufferInfos[fCurrentCmdInfo].currentCmdBuf(), query);
+}
@@ -78,6 +78,9 @@ public:
 
     void executeDrawable(std::unique_ptr<SkDrawable::GpuDrawHandler>) override;
 
+    GrTimerQuery beginTimerQuery() override;
+    void endTimerQuery(GrTimerQuery) override;
+
     void set(GrRenderTarget*, GrSurfaceOrigin,
              const GrGpuRTCommandBuffer::LoadAndStoreInfo&,
              const GrGpuRTCommandBuffer::StencilLoadAndStoreInfo&);
@@ -136,6 +139,11 @@ private:
                                        const GrBuffer* instanceBuffer, int instanceCount,
                                        int baseInstance, GrPrimitiveRestart) final;
 
+    void sendIndexedIndirectMeshToGpu(GrPrimitiveType, const GrBuffer* indexBuffer,
+                                      const GrBuffer* vertexBuffer, const GrBuffer* instanceBuffer,
+                                      const GrBuffer* indirectBuffer, size_t indirectOffset,
+                                      int drawCount, GrPrimitiveRestart) final;
+
     void onClear(const GrFixedClip&, const SkPMColor4f& color) override;
 
     void onClearStencilClip(const GrFixedClip&, bool insideStencilMask) override;
@@ -0,0 +1,73 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "GrVkIndirectBuffer.h"
+#include "GrVkGpu.h"
+
+GrVkIndirectBuffer::GrVkIndirectBuffer(GrVkGpu* gpu, const GrVkBuffer::Desc& desc,
+                                       const GrVkBuffer::Resource* bufferResource)
+    : INHERITED(gpu, desc.fSizeInBytes, kDrawIndirect_GrBufferType,
+                desc.fDynamic ? kDynamic_GrAccessPattern : kStatic_GrAccessPattern)
+    , GrVkBuffer(desc, bufferResource) {
+    this->registerWithCache(SkBudgeted::kYes);
+}
+
+GrVkIndirectBuffer* GrVkIndirectBuffer::Create(GrVkGpu* gpu, size_t size, bool dynamic) {
+    GrVkBuffer::Desc desc;
+    desc.fDynamic = dynamic;
+    desc.fType = GrVkBuffer::kIndirect_Type;
+    desc.fSizeInBytes = size;
+
+    const GrVkBuffer::Resource* bufferResource = GrVkBuffer::Create(gpu, desc);
+    if (!bufferResource) {
+        return nullptr;
+    }
+
+    GrVkIndirectBuffer* buffer = new GrVkIndirectBuffer(gpu, desc, bufferResource);
+    if (!buffer) {
+        bufferResource->unref(gpu);
+    }
+    return buffer;
+}
+
+void GrVkIndirectBuffer::onRelease() {
+    if (!this->wasDestroyed()) {
+        this->vkRelease(this->getVkGpu());
+    }
+
+    INHERITED::onRelease();
+}
+
+void GrVkIndirectBuffer::onAbandon() {
+    this->vkAbandon();
+    INHERITED::onAbandon();
+}
+
+void GrVkIndirectBuffer::onMap() {
+    if (!this->wasDestroyed()) {
+        this->GrBuffer::fMapPtr = this->vkMap(this->getVkGpu());
+    }
+}
+
+void GrVkIndirectBuffer::onUnmap() {
+    if (!this->wasDestroyed()) {
+        this->vkUnmap(this->getVkGpu());
+    }
+}
+
+bool GrVkIndirectBuffer::onUpdateData(const void* src, size_t srcSizeInBytes) {
+    if (!this->wasDestroyed()) {
+        return this->vkUpdateData(this->getVkGpu(), src, srcSizeInBytes);
+    } else {
+        return false;
+    }
+}
+
+GrVkGpu* GrVkIndirectBuffer::getVkGpu() const {
+    SkASSERT(!this->wasDestroyed());
+    return static_cast<GrVkGpu*>(this->getGpu());
+}
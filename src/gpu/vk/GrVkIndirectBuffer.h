@@ -0,0 +1,39 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef GrVkIndirectBuffer_DEFINED
+#define GrVkIndirectBuffer_DEFINED
+
+#include "GrVkVulkan.h"
+
+#include "GrBuffer.h"
+#include "GrVkBuffer.h"
+
+class GrVkGpu;
+
+class GrVkIndirectBuffer : public GrBuffer, public GrVkBuffer {
+public:
+    static GrVkIndirectBuffer* Create(GrVkGpu* gpu, size_t size, bool dynamic);
+
+protected:
+    void onAbandon() override;
+    void onRelease() override;
+
+private:
+    GrVkIndirectBuffer(GrVkGpu* gpu, const GrVkBuffer::Desc& desc,
+                       const GrVkBuffer::Resource* resource);
+
+    void onMap() override;
+    void onUnmap() override;
+    bool onUpdateData(const void* src, size_t srcSizeInBytes) override;
+
+    GrVkGpu* getVkGpu() const;
+
+    typedef GrBuffer INHERITED;
+};
+
+#endif
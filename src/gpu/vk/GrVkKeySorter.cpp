@@ -0,0 +1,122 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "GrVkKeySorter.h"
+
+#include "GrVkBuffer.h"
+#include "GrVkCommandBuffer.h"
+#include "GrVkDescriptorPool.h"
+#include "GrVkGpu.h"
+
+extern "C" {
+#include "hs_vk.h"
+#include "amd/gcn/u64/hs_target.h"
+#include "intel/gen8/u64/hs_target.h"
+#include "nvidia/sm_35/u64/hs_target.h"
+}
+
+static const hs_vk_target* find_target(const VkPhysicalDeviceProperties& props) {
+    switch (props.vendorID) {
+        case 0x10DE: return &hs_nvidia_sm35_u64;
+        case 0x8086: return &hs_intel_gen8_u64;
+        case 0x1002: return &hs_amd_gcn_u64;
+    }
+    return nullptr;
+}
+
+std::unique_ptr<GrVkKeySorter> GrVkKeySorter::Make(GrVkGpu* gpu) {
+    const VkPhysicalDeviceProperties& props = gpu->physicalDeviceProperties();
+    const hs_vk_target* target = find_target(props);
+    if (!target) {
+        return nullptr;
+    }
+    // The Intel shaders are built for the Gen8 GT shape; Gen9 LP parts (e.g. Apollo Lake) differ.
+    if (0x8086 == props.vendorID && (0x5A84 == props.deviceID || 0x5A85 == props.deviceID)) {
+        return nullptr;
+    }
+    hs_vk* hotSort = hs_vk_create(target, gpu->device(), nullptr,
+                                  gpu->resourceProvider().pipelineCache());
+    if (!hotSort) {
+        return nullptr;
+    }
+    return std::unique_ptr<GrVkKeySorter>(new GrVkKeySorter(hotSort));
+}
+
+GrVkKeySorter::GrVkKeySorter(hs_vk* hotSort) : fHotSort(hotSort) {}
+
+GrVkKeySorter::~GrVkKeySorter() {
+    SkASSERT(!fHotSort);
+}
+
+int GrVkKeySorter::paddedKeyCount(int count) const {
+    SkASSERT(fHotSort);
+    uint32_t paddedIn, paddedOut;
+    hs_vk_pad(fHotSort, count, &paddedIn, &paddedOut);
+    // The sort is in place, so the buffer is both the input and the output.
+    return SkTMax(paddedIn, paddedOut);
+}
+
+void GrVkKeySorter::sort(GrVkGpu* gpu, GrVkBuffer* keys, int count) {
+    SkASSERT(fHotSort);
+    SkASSERT(count > 0);
+    SkASSERT(keys->size() >= this->paddedKeyCount(count) * sizeof(uint64_t));
+
+    GrVkPrimaryCommandBuffer* cmdBuffer = gpu->currentCommandBuffer();
+    cmdBuffer->addResource(keys->resource());
+
+    // HotSort points its one descriptor set at the keys when the sort is recorded. Each sort gets
+    // a set from its own pool, which the command buffer keeps alive until it has executed.
+    GrVkDescriptorPool* pool = new GrVkDescriptorPool(gpu, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 2);
+    VkDescriptorSet descriptorSet = hs_vk_ds_alloc(fHotSort, pool->descPool());
+    cmdBuffer->addResource(pool);
+    pool->unref(gpu);
+
+    uint32_t paddedIn, paddedOut;
+    hs_vk_pad(fHotSort, count, &paddedIn, &paddedOut);
+
+    // Dynamic buffers are written by the host and static ones by a transfer.
+    VkPipelineStageFlags srcStage = VK_PIPELINE_STAGE_HOST_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT;
+    auto srcAccess = (VkAccessFlagBits)(VK_ACCESS_HOST_WRITE_BIT | VK_ACCESS_TRANSFER_WRITE_BIT);
+    VkCommandBuffer vkCmdBuffer = cmdBuffer->vkCommandBuffer();
+    hs_vk_ds_bind(fHotSort, descriptorSet, vkCmdBuffer, keys->buffer(), VK_NULL_HANDLE);
+    hs_vk_sort(fHotSort, vkCmdBuffer, keys->buffer(), srcStage, srcAccess, VK_NULL_HANDLE,
+               srcStage, srcAccess, count, paddedIn, paddedOut, true);
+
+    // Make the sorted keys visible to the draws and copies that read them.
+    VkBufferMemoryBarrier barrier;
+    memset(&barrier, 0, sizeof(VkBufferMemoryBarrier));
+    barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+    barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_INDEX_READ_BIT |
+                            VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_TRANSFER_READ_BIT;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.buffer = keys->buffer();
+    barrier.offset = 0;
+    barrier.size = VK_WHOLE_SIZE;
+    gpu->addBufferMemoryBarrier(VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                                VK_PIPELINE_STAGE_VERTEX_INPUT_BIT |
+                                VK_PIPELINE_STAGE_VERTEX_SHADER_BIT |
+                                VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT |
+                                VK_PIPELINE_STAGE_TRANSFER_BIT,
+                                false, &barrier);
+
+    // HotSort binds its own compute pipelines and descriptor sets.
+    cmdBuffer->invalidateState();
+}
+
+void GrVkKeySorter::destroyResources(GrVkGpu*) {
+    if (fHotSort) {
+        hs_vk_release(fHotSort);
+        fHotSort = nullptr;
+    }
+}
+
+void GrVkKeySorter::abandonResources() {
+    // The device may be gone, so the pipelines can't be destroyed.
+    fHotSort = nullptr;
+}
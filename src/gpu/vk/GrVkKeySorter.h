@@ -0,0 +1,51 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef GrVkKeySorter_DEFINED
+#define GrVkKeySorter_DEFINED
+
+#include "GrVkVulkan.h"
+
+#include "SkTypes.h"
+
+#include <memory>
+
+class GrVkBuffer;
+class GrVkGpu;
+
+/**
+ * Sorts buffers of 64-bit keys on the GPU with HotSort (src/compute/hs), a merge sort written as
+ * Vulkan compute shaders. The sort is recorded into the GrVkGpu's primary command buffer, so it
+ * runs after everything recorded before it and before the ops of the flush that follows.
+ *
+ * HotSort ships prebuilt shaders for NVIDIA (sm_35+), Intel (Gen8+) and AMD (GCN) devices; Make()
+ * returns null on others, and always returns null unless Skia is built with skia_use_hotsort.
+ */
+class GrVkKeySorter {
+public:
+    static std::unique_ptr<GrVkKeySorter> Make(GrVkGpu*);
+
+    ~GrVkKeySorter();
+
+    // The number of keys a buffer must have room for to sort 'count' keys in it. The keys past
+    // 'count' are overwritten with padding.
+    int paddedKeyCount(int count) const;
+
+    // Sorts the first 'count' keys of 'keys' in place, in ascending order. The buffer must have
+    // been created with room for paddedKeyCount(count) keys.
+    void sort(GrVkGpu*, GrVkBuffer* keys, int count);
+
+    void destroyResources(GrVkGpu*);
+    void abandonResources();
+
+private:
+    explicit GrVkKeySorter(struct hs_vk*);
+
+    struct hs_vk* fHotSort;
+};
+
+#endif
@@ -0,0 +1,26 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "GrVkKeySorter.h"
+
+std::unique_ptr<GrVkKeySorter> GrVkKeySorter::Make(GrVkGpu*) {
+    return nullptr;
+}
+
+GrVkKeySorter::~GrVkKeySorter() {}
+
+int GrVkKeySorter::paddedKeyCount(int count) const {
+    return count;
+}
+
+void GrVkKeySorter::sort(GrVkGpu*, GrVkBuffer*, int) {
+    SK_ABORT("HotSort is not built");
+}
+
+void GrVkKeySorter::destroyResources(GrVkGpu*) {}
+
+void GrVkKeySorter::abandonResources() {}
@@ -239,9 +239,7 @@ static void setup_depth_stencil_state(const GrStencilSettings& stencilSettings,
         stencilInfo->front.passOp = stencil_op_to_vk_stencil_op(front.fPassOp);
         stencilInfo->front.depthFailOp = stencilInfo->front.failOp;
         stencilInfo->front.compareOp = stencil_func_to_vk_compare_op(front.fTest);
-        stencilInfo->front.compareMask = front.fTestMask;
-        stencilInfo->front.writeMask = front.fWriteMask;
-        stencilInfo->front.reference = front.fRef;
+        // The compare masks, write masks and references are set dynamically
 
         // Set back face
         if (!stencilSettings.isTwoSided()) {
@@ -252,9 +250,6 @@ static void setup_depth_stencil_state(const GrStencilSettings& stencilSettings,
             stencilInfo->back.passOp = stencil_op_to_vk_stencil_op(back.fPassOp);
             stencilInfo->back.depthFailOp = stencilInfo->front.failOp;
             stencilInfo->back.compareOp = stencil_func_to_vk_compare_op(back.fTest);
-            stencilInfo->back.compareMask = back.fTestMask;
-            stencilInfo->back.writeMask = back.fWriteMask;
-            stencilInfo->back.reference = back.fRef;
         }
     }
     stencilInfo->minDepthBounds = 0.0f;
@@ -494,7 +489,10 @@ static void setup_dynamic_state(VkPipelineDynamicStateCreateInfo* dynamicInfo,
     dynamicStates[0] = VK_DYNAMIC_STATE_VIEWPORT;
     dynamicStates[1] = VK_DYNAMIC_STATE_SCISSOR;
     dynamicStates[2] = VK_DYNAMIC_STATE_BLEND_CONSTANTS;
-    dynamicInfo->dynamicStateCount = 3;
+    dynamicStates[3] = VK_DYNAMIC_STATE_STENCIL_COMPARE_MASK;
+    dynamicStates[4] = VK_DYNAMIC_STATE_STENCIL_WRITE_MASK;
+    dynamicStates[5] = VK_DYNAMIC_STATE_STENCIL_REFERENCE;
+    dynamicInfo->dynamicStateCount = 6;
     dynamicInfo->pDynamicStates = dynamicStates;
 }
 
@@ -532,7 +530,7 @@ GrVkPipeline* GrVkPipeline::Create(GrVkGpu* gpu, const GrPrimitiveProcessor& pri
     VkPipelineRasterizationStateCreateInfo rasterInfo;
     setup_raster_state(pipeline, gpu->caps(), &rasterInfo);
 
-    VkDynamicState dynamicStates[3];
+    VkDynamicState dynamicStates[6];
     VkPipelineDynamicStateCreateInfo dynamicInfo;
     setup_dynamic_state(&dynamicInfo, dynamicStates);
 
@@ -636,3 +634,16 @@ void GrVkPipeline::SetDynamicBlendConstantState(GrVkGpu* gpu,
     }
     cmdBuffer->setBlendConstants(gpu, floatColors);
 }
+
+void GrVkPipeline::SetDynamicStencilState(GrVkGpu* gpu,
+                                          GrVkCommandBuffer* cmdBuffer,
+                                          const GrStencilSettings& stencilSettings) {
+    if (stencilSettings.isDisabled()) {
+        return;
+    }
+    const GrStencilSettings::Face& front = stencilSettings.front();
+    const GrStencilSettings::Face& back = stencilSettings.isTwoSided() ? stencilSettings.back()
+                                                                       : front;
+    cmdBuffer->setStencilState(gpu, {front.fTestMask, front.fWriteMask, front.fRef},
+                               {back.fTestMask, back.fWriteMask, back.fRef});
+}
@@ -43,6 +43,7 @@ public:
     static void SetDynamicViewportState(GrVkGpu*, GrVkCommandBuffer*, const GrRenderTarget*);
     static void SetDynamicBlendConstantState(GrVkGpu*, GrVkCommandBuffer*, GrPixelConfig,
                                              const GrXferProcessor&);
+    static void SetDynamicStencilState(GrVkGpu*, GrVkCommandBuffer*, const GrStencilSettings&);
 
 #ifdef SK_TRACE_VK_RESOURCES
     void dumpInfo() const override {
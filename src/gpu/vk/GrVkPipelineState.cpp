@@ -56,9 +56,11 @@ GrVkPipelineState::GrVkPipelineState(
     fDescriptorSets[0] = VK_NULL_HANDLE;
     fDescriptorSets[1] = VK_NULL_HANDLE;
     fDescriptorSets[2] = VK_NULL_HANDLE;
+    fUniformOffsets[0] = 0;
+    fUniformOffsets[1] = 0;
 
-    fGeometryUniformBuffer.reset(GrVkUniformBuffer::Create(gpu, geometryUniformSize));
-    fFragmentUniformBuffer.reset(GrVkUniformBuffer::Create(gpu, fragmentUniformSize));
+    fGeometryUniformBuffer.reset(GrVkUniformBuffer::CreateWithSlots(gpu, geometryUniformSize));
+    fFragmentUniformBuffer.reset(GrVkUniformBuffer::CreateWithSlots(gpu, fragmentUniformSize));
 
     fNumSamplers = samplers.count();
 
@@ -165,11 +167,15 @@ void GrVkPipelineState::setAndBindUniforms(GrVkGpu* gpu,
         fXferProcessor->setData(fDataManager, pipeline.getXferProcessor(), dstTexture, offset);
     }
 
-    // Get new descriptor set
+    // Uniforms are written to a new slot of their buffers, which the descriptor set reaches
+    // through dynamic offsets, so we only need a new descriptor set when a buffer is replaced.
     if (fGeometryUniformBuffer || fFragmentUniformBuffer) {
         int uniformDSIdx = GrVkUniformHandler::kUniformBufferDescSet;
-        if (fDataManager.uploadUniformBuffers(
-                    gpu, fGeometryUniformBuffer.get(), fFragmentUniformBuffer.get()) ||
+        uint32_t* geomOffset = &fUniformOffsets[GrVkUniformHandler::kGeometryBinding];
+        uint32_t* fragOffset = &fUniformOffsets[GrVkUniformHandler::kFragBinding];
+        if (fDataManager.uploadUniformBuffers(gpu, fGeometryUniformBuffer.get(),
+                                              fFragmentUniformBuffer.get(), geomOffset,
+                                              fragOffset) ||
             !fUniformDescriptorSet) {
             if (fUniformDescriptorSet) {
                 fUniformDescriptorSet->recycle(gpu);
@@ -179,7 +185,8 @@ void GrVkPipelineState::setAndBindUniforms(GrVkGpu* gpu,
             this->writeUniformBuffers(gpu);
         }
         commandBuffer->bindDescriptorSets(gpu, this, fPipelineLayout, uniformDSIdx, 1,
-                                          &fDescriptorSets[uniformDSIdx], 0, nullptr);
+                                          &fDescriptorSets[uniformDSIdx],
+                                          SK_ARRAY_COUNT(fUniformOffsets), fUniformOffsets);
         if (fUniformDescriptorSet) {
             commandBuffer->addRecycledResource(fUniformDescriptorSet);
         }
@@ -302,7 +309,7 @@ void set_uniform_descriptor_writes(VkWriteDescriptorSet* descriptorWrite,
     memset(bufferInfo, 0, sizeof(VkDescriptorBufferInfo));
     bufferInfo->buffer = buffer->buffer();
     bufferInfo->offset = buffer->offset();
-    bufferInfo->range = buffer->size();
+    bufferInfo->range = buffer->slotSize();
 
     memset(descriptorWrite, 0, sizeof(VkWriteDescriptorSet));
     descriptorWrite->sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
@@ -311,7 +318,7 @@ void set_uniform_descriptor_writes(VkWriteDescriptorSet* descriptorWrite,
     descriptorWrite->dstBinding = binding;
     descriptorWrite->dstArrayElement = 0;
     descriptorWrite->descriptorCount = 1;
-    descriptorWrite->descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+    descriptorWrite->descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
     descriptorWrite->pImageInfo = nullptr;
     descriptorWrite->pBufferInfo = bufferInfo;
     descriptorWrite->pTexelBufferView = nullptr;
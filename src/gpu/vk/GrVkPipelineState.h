@@ -131,6 +131,9 @@ private:
     // GrVkPipelineState since we update the descriptor sets and bind them at separate times;
     VkDescriptorSet fDescriptorSets[3];
 
+    // The dynamic offsets of the current uniforms in their buffers, indexed by binding.
+    uint32_t fUniformOffsets[2];
+
     const GrVkDescriptorSet* fUniformDescriptorSet;
     const GrVkDescriptorSet* fSamplerDescriptorSet;
 
@@ -11,6 +11,8 @@
 #include "GrShaderCaps.h"
 #include "GrStencilSettings.h"
 #include "GrVkRenderTarget.h"
+#include "SkReader32.h"
+#include "SkWriter32.h"
 #include "vk/GrVkDescriptorSetManager.h"
 #include "vk/GrVkGpu.h"
 #include "vk/GrVkRenderPass.h"
@@ -62,7 +64,9 @@ bool GrVkPipelineStateBuilder::createVkShaderModule(VkShaderStageFlagBits stage,
                                                     VkShaderModule* shaderModule,
                                                     VkPipelineShaderStageCreateInfo* stageInfo,
                                                     const SkSL::Program::Settings& settings,
-                                                    Desc* desc) {
+                                                    Desc* desc,
+                                                    SkSL::String* outSPIRV,
+                                                    SkSL::Program::Inputs* outInputs) {
     SkString shaderString;
     for (int i = 0; i < builder.fCompilerStrings.count(); ++i) {
         if (builder.fCompilerStrings[i]) {
@@ -71,12 +75,16 @@ bool GrVkPipelineStateBuilder::createVkShaderModule(VkShaderStageFlagBits stage,
         }
     }
 
-    SkSL::Program::Inputs inputs;
-    bool result = GrCompileVkShaderModule(fGpu, shaderString.c_str(), stage, shaderModule,
-                                          stageInfo, settings, &inputs);
-    if (!result) {
+    if (!GrCompileVkShaderModule(fGpu, shaderString.c_str(), stage, shaderModule,
+                                 stageInfo, settings, outSPIRV, outInputs)) {
         return false;
     }
+    this->handleShaderInputs(*outInputs, desc);
+    return true;
+}
+
+void GrVkPipelineStateBuilder::handleShaderInputs(const SkSL::Program::Inputs& inputs,
+                                                  Desc* desc) {
     if (inputs.fRTHeight) {
         this->addRTHeightUniform(SKSL_RTHEIGHT_NAME);
     }
@@ -85,7 +93,85 @@ bool GrVkPipelineStateBuilder::createVkShaderModule(VkShaderStageFlagBits stage,
                                                      this->pipeline().proxy()->origin()));
         desc->finalize();
     }
-    return result;
+}
+
+// The SPIR-V stored in the PersistentCache is, for each stage: the VkShaderStageFlagBits, the
+// SkSL::Program::Inputs, and the length of the SPIR-V followed by the SPIR-V itself.
+static constexpr uint32_t kShaderCacheVersion = 1;
+
+int GrVkPipelineStateBuilder::loadShadersFromCache(const SkData& cached,
+                                                   VkShaderModule outShaderModules[],
+                                                   VkPipelineShaderStageCreateInfo* outStageInfo,
+                                                   Desc* desc) {
+    if (!SkIsAlign4(cached.size())) {
+        return 0;
+    }
+    SkReader32 reader(cached.data(), cached.size());
+    if (!reader.isAvailable(2 * sizeof(uint32_t)) || reader.readU32() != kShaderCacheVersion) {
+        return 0;
+    }
+    int numShaderStages = reader.readInt();
+    bool hasGeometryShader = this->primitiveProcessor().willUseGeoShader();
+    if (numShaderStages != (hasGeometryShader ? 3 : 2)) {
+        return 0;
+    }
+
+    static constexpr VkShaderStageFlagBits kStages[] = {
+        VK_SHADER_STAGE_VERTEX_BIT, VK_SHADER_STAGE_FRAGMENT_BIT, VK_SHADER_STAGE_GEOMETRY_BIT
+    };
+    SkSL::Program::Inputs inputs[3];
+    int installed = 0;
+    for (; installed < numShaderStages; ++installed) {
+        if (!reader.isAvailable(sizeof(uint32_t) + SkAlign4(sizeof(SkSL::Program::Inputs)) +
+                                sizeof(uint32_t))) {
+            break;
+        }
+        auto stage = (VkShaderStageFlagBits)reader.readU32();
+        if (stage != kStages[installed]) {
+            break;
+        }
+        reader.read(&inputs[installed], sizeof(SkSL::Program::Inputs));
+        size_t spirvSize = reader.readU32();
+        if (!SkIsAlign4(spirvSize) || !reader.isAvailable(spirvSize)) {
+            break;
+        }
+        SkSL::String spirv((const char*)reader.skip(spirvSize), spirvSize);
+        if (!GrInstallVkShaderModule(fGpu, spirv, stage, &outShaderModules[installed],
+                                     &outStageInfo[installed])) {
+            break;
+        }
+    }
+    if (installed != numShaderStages) {
+        for (int i = 0; i < installed; ++i) {
+            GR_VK_CALL(fGpu->vkInterface(), DestroyShaderModule(fGpu->device(),
+                                                                outShaderModules[i], nullptr));
+            outShaderModules[i] = VK_NULL_HANDLE;
+        }
+        return 0;
+    }
+
+    for (int i = 0; i < numShaderStages; ++i) {
+        this->handleShaderInputs(inputs[i], desc);
+    }
+    return numShaderStages;
+}
+
+void GrVkPipelineStateBuilder::storeShadersInCache(const SkData& key,
+                                                   const VkPipelineShaderStageCreateInfo* stageInfo,
+                                                   const SkSL::String spirv[],
+                                                   const SkSL::Program::Inputs inputs[],
+                                                   int numShaderStages) {
+    SkWriter32 writer;
+    writer.write32(kShaderCacheVersion);
+    writer.write32(numShaderStages);
+    for (int i = 0; i < numShaderStages; ++i) {
+        writer.write32(stageInfo[i].stage);
+        writer.writePad(&inputs[i], sizeof(SkSL::Program::Inputs));
+        writer.write32(SkToS32(spirv[i].size()));
+        writer.writePad(spirv[i].c_str(), spirv[i].size());
+    }
+    auto persistentCache = fGpu->getContext()->contextPriv().getPersistentCache();
+    persistentCache->store(key, *writer.snapshotAsData());
 }
 
 GrVkPipelineState* GrVkPipelineStateBuilder::finalize(const GrStencilSettings& stencil,
@@ -94,9 +180,8 @@ GrVkPipelineState* GrVkPipelineStateBuilder::finalize(const GrStencilSettings& s
                                                       Desc* desc) {
     VkDescriptorSetLayout dsLayout[2];
     VkPipelineLayout pipelineLayout;
-    VkShaderModule vertShaderModule = VK_NULL_HANDLE;
-    VkShaderModule geomShaderModule = VK_NULL_HANDLE;
-    VkShaderModule fragShaderModule = VK_NULL_HANDLE;
+    // Vertex, fragment and, if present, geometry.
+    VkShaderModule shaderModules[3] = { VK_NULL_HANDLE, VK_NULL_HANDLE, VK_NULL_HANDLE };
 
     GrVkResourceProvider& resourceProvider = fGpu->resourceProvider();
     // These layouts are not owned by the PipelineStateBuilder and thus should not be destroyed
@@ -139,29 +224,56 @@ GrVkPipelineState* GrVkPipelineStateBuilder::finalize(const GrStencilSettings& s
     settings.fFlipY = this->pipeline().proxy()->origin() != kTopLeft_GrSurfaceOrigin;
     settings.fSharpenTextures = this->gpu()->getContext()->contextPriv().sharpenMipmappedTextures();
     SkASSERT(!this->fragColorIsInOut());
-    SkAssertResult(this->createVkShaderModule(VK_SHADER_STAGE_VERTEX_BIT,
-                                              fVS,
-                                              &vertShaderModule,
-                                              &shaderStageInfo[0],
-                                              settings,
-                                              desc));
-
-    SkAssertResult(this->createVkShaderModule(VK_SHADER_STAGE_FRAGMENT_BIT,
-                                              fFS,
-                                              &fragShaderModule,
-                                              &shaderStageInfo[1],
-                                              settings,
-                                              desc));
-
-    int numShaderStages = 2; // We always have at least vertex and fragment stages.
-    if (this->primitiveProcessor().willUseGeoShader()) {
-        SkAssertResult(this->createVkShaderModule(VK_SHADER_STAGE_GEOMETRY_BIT,
-                                                  fGS,
-                                                  &geomShaderModule,
-                                                  &shaderStageInfo[2],
+
+    // The key is copied, since compiling the shaders can change the surface origin in desc.
+    auto persistentCache = fGpu->getContext()->contextPriv().getPersistentCache();
+    sk_sp<SkData> key;
+    int numShaderStages = 0;
+    if (persistentCache) {
+        key = SkData::MakeWithCopy(desc->asKey(), desc->keyLength());
+        if (sk_sp<SkData> cached = persistentCache->load(*key)) {
+            numShaderStages = this->loadShadersFromCache(*cached, shaderModules, shaderStageInfo,
+                                                         desc);
+        }
+    }
+
+    if (!numShaderStages) {
+        SkSL::String spirv[3];
+        SkSL::Program::Inputs inputs[3];
+        SkAssertResult(this->createVkShaderModule(VK_SHADER_STAGE_VERTEX_BIT,
+                                                  fVS,
+                                                  &shaderModules[0],
+                                                  &shaderStageInfo[0],
+                                                  settings,
+                                                  desc,
+                                                  &spirv[0],
+                                                  &inputs[0]));
+
+        SkAssertResult(this->createVkShaderModule(VK_SHADER_STAGE_FRAGMENT_BIT,
+                                                  fFS,
+                                                  &shaderModules[1],
+                                                  &shaderStageInfo[1],
                                                   settings,
-                                                  desc));
-        ++numShaderStages;
+                                                  desc,
+                                                  &spirv[1],
+                                                  &inputs[1]));
+
+        numShaderStages = 2; // We always have at least vertex and fragment stages.
+        if (this->primitiveProcessor().willUseGeoShader()) {
+            SkAssertResult(this->createVkShaderModule(VK_SHADER_STAGE_GEOMETRY_BIT,
+                                                      fGS,
+                                                      &shaderModules[2],
+                                                      &shaderStageInfo[2],
+                                                      settings,
+                                                      desc,
+                                                      &spirv[2],
+                                                      &inputs[2]));
+            ++numShaderStages;
+        }
+
+        if (persistentCache) {
+            this->storeShadersInCache(*key, shaderStageInfo, spirv, inputs, numShaderStages);
+        }
     }
 
     GrVkPipeline* pipeline = resourceProvider.createPipeline(fPrimProc,
@@ -172,14 +284,10 @@ GrVkPipelineState* GrVkPipelineStateBuilder::finalize(const GrStencilSettings& s
                                                              primitiveType,
                                                              compatibleRenderPass,
                                                              pipelineLayout);
-    GR_VK_CALL(fGpu->vkInterface(), DestroyShaderModule(fGpu->device(), vertShaderModule,
-                                                        nullptr));
-    GR_VK_CALL(fGpu->vkInterface(), DestroyShaderModule(fGpu->device(), fragShaderModule,
-                                                        nullptr));
-    // This if check should not be needed since calling destroy on a VK_NULL_HANDLE is allowed.
-    // However this is causing a crash in certain drivers (e.g. NVidia).
-    if (this->primitiveProcessor().willUseGeoShader()) {
-        GR_VK_CALL(fGpu->vkInterface(), DestroyShaderModule(fGpu->device(), geomShaderModule,
+    // This only destroys the modules that were created, since calling destroy on a
+    // VK_NULL_HANDLE is causing a crash in certain drivers (e.g. NVidia).
+    for (int i = 0; i < numShaderStages; ++i) {
+        GR_VK_CALL(fGpu->vkInterface(), DestroyShaderModule(fGpu->device(), shaderModules[i],
                                                             nullptr));
     }
 
@@ -238,7 +346,8 @@ bool GrVkPipelineStateBuilder::Desc::Build(Desc* desc,
     GrVkRenderTarget* vkRT = (GrVkRenderTarget*)pipeline.renderTarget();
     vkRT->simpleRenderPass()->genKey(&b);
 
-    stencil.genKey(&b);
+    // The stencil references and masks are dynamic state.
+    stencil.genKey(&b, false);
 
     b.add32(get_blend_info_key(pipeline));
 
@@ -90,7 +90,25 @@ private:
                               VkShaderModule* shaderModule,
                               VkPipelineShaderStageCreateInfo* stageInfo,
                               const SkSL::Program::Settings& settings,
-                              Desc* desc);
+                              Desc* desc,
+                              SkSL::String* outSPIRV,
+                              SkSL::Program::Inputs* outInputs);
+
+    // Adds what the compiled shaders ask for in inputs to the uniforms and to desc.
+    void handleShaderInputs(const SkSL::Program::Inputs& inputs, Desc* desc);
+
+    // Creates the shader modules from SPIR-V stored in the PersistentCache by a previous
+    // storeShadersInCache(). Returns the number of stages, or 0 if the data can't be used.
+    int loadShadersFromCache(const SkData& cached,
+                             VkShaderModule outShaderModules[],
+                             VkPipelineShaderStageCreateInfo* outStageInfo,
+                             Desc* desc);
+
+    void storeShadersInCache(const SkData& key,
+                             const VkPipelineShaderStageCreateInfo* stageInfo,
+                             const SkSL::String spirv[],
+                             const SkSL::Program::Inputs inputs[],
+                             int numShaderStages);
 
     GrGLSLUniformHandler* uniformHandler() override { return &fUniformHandler; }
     const GrGLSLUniformHandler* uniformHandler() const override { return &fUniformHandler; }
@@ -361,16 +361,20 @@ template<> struct set_uniform_matrix<4> {
 
 bool GrVkPipelineStateDataManager::uploadUniformBuffers(GrVkGpu* gpu,
                                                         GrVkUniformBuffer* geometryBuffer,
-                                                        GrVkUniformBuffer* fragmentBuffer) const {
+                                                        GrVkUniformBuffer* fragmentBuffer,
+                                                        uint32_t* geometryOffset,
+                                                        uint32_t* fragmentOffset) const {
     bool updatedBuffer = false;
     if (geometryBuffer && fGeometryUniformsDirty) {
-        SkAssertResult(geometryBuffer->updateData(gpu, fGeometryUniformData.get(),
-                                                  fGeometryUniformSize, &updatedBuffer));
+        SkASSERT(geometryBuffer->slotSize() == fGeometryUniformSize);
+        SkAssertResult(geometryBuffer->updateNextSlot(gpu, fGeometryUniformData.get(),
+                                                      geometryOffset, &updatedBuffer));
         fGeometryUniformsDirty = false;
     }
     if (fragmentBuffer && fFragmentUniformsDirty) {
-        SkAssertResult(fragmentBuffer->updateData(gpu, fFragmentUniformData.get(),
-                                                  fFragmentUniformSize, &updatedBuffer));
+        SkASSERT(fragmentBuffer->slotSize() == fFragmentUniformSize);
+        SkAssertResult(fragmentBuffer->updateNextSlot(gpu, fFragmentUniformData.get(),
+                                                      fragmentOffset, &updatedBuffer));
         fFragmentUniformsDirty = false;
     }
 
@@ -57,12 +57,15 @@ public:
         SK_ABORT("Only supported in NVPR, which is not in vulkan");
     }
 
-    // Returns true if either the geometry or fragment buffers needed to generate a new underlying
-    // VkBuffer object in order upload data. If true is returned, this is a signal to the caller
-    // that they will need to update the descriptor set that is using these buffers.
+    // Writes any changed uniforms to the next slot of their buffer and updates that buffer's
+    // dynamic offset. Returns true if either the geometry or fragment buffers needed to generate a
+    // new underlying VkBuffer object in order upload data. If true is returned, this is a signal to
+    // the caller that they will need to update the descriptor set that is using these buffers.
     bool uploadUniformBuffers(GrVkGpu* gpu,
                               GrVkUniformBuffer* geometryBuffer,
-                              GrVkUniformBuffer* fragmentBuffer) const;
+                              GrVkUniformBuffer* fragmentBuffer,
+                              uint32_t* geometryOffset,
+                              uint32_t* fragmentOffset) const;
 private:
     struct Uniform {
         uint32_t fBinding;
@@ -44,6 +44,13 @@ public:
     // Set up any initial vk objects
     void init();
 
+    // The VkPipelineCache is created on first use, seeded with the data stored in the
+    // GrContextOptions::PersistentCache, if there is one.
+    VkPipelineCache pipelineCache();
+
+    // Writes the contents of the VkPipelineCache to the GrContextOptions::PersistentCache.
+    void storePipelineCacheData();
+
     GrVkPipeline* createPipeline(const GrPrimitiveProcessor& primProc,
                                  const GrPipeline& pipeline,
                                  const GrStencilSettings& stencil,
@@ -239,6 +246,11 @@ private:
         int                           fLastReturnedIndex;
     };
 
+    // Key the VkPipelineCache data is stored under in the PersistentCache. Program keys are
+    // always longer than 4 bytes, so they can't collide with it.
+    static constexpr uint32_t kPipelineCache_PersistentCacheKeyType = SkSetFourByteTag('v', 'k',
+                                                                                       'p', 'c');
+
     GrVkGpu* fGpu;
 
     // Central cache for creating pipelines
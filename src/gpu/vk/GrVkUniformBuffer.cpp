@@ -38,6 +38,45 @@ GrVkUniformBuffer* GrVkUniformBuffer::Create(GrVkGpu* gpu, size_t size) {
     return buffer;
 }
 
+GrVkUniformBuffer* GrVkUniformBuffer::CreateWithSlots(GrVkGpu* gpu, size_t slotSize) {
+    if (0 == slotSize) {
+        return nullptr;
+    }
+    // Dynamic offsets must be multiples of the device's alignment, which is a power of two.
+    size_t alignment = SkTMax<size_t>(
+            gpu->physicalDeviceProperties().limits.minUniformBufferOffsetAlignment, 1);
+    size_t stride = GrSizeAlignUp(slotSize, alignment);
+    // Buffers of the standard size come from a pool, so use that size whenever a few slots fit.
+    static constexpr size_t kMinSlots = 4;
+    size_t size = stride * kMinSlots <= kStandardSize ? kStandardSize : stride * kMinSlots;
+
+    GrVkUniformBuffer* buffer = Create(gpu, size);
+    if (buffer) {
+        buffer->fSlotSize = slotSize;
+        buffer->fSlotStride = stride;
+    }
+    return buffer;
+}
+
+bool GrVkUniformBuffer::updateNextSlot(GrVkGpu* gpu, const void* src, uint32_t* slotOffset,
+                                       bool* createdNewBuffer) {
+    SkASSERT(fSlotStride);
+    bool discard = false;
+    if (this->resource()->unique()) {
+        // No command buffer reads any of the slots anymore.
+        fNextSlotOffset = 0;
+    } else if (fNextSlotOffset + fSlotStride > this->size()) {
+        fNextSlotOffset = 0;
+        discard = true;
+    }
+    if (!this->vkUpdateDataAt(gpu, src, fSlotSize, fNextSlotOffset, discard, createdNewBuffer)) {
+        return false;
+    }
+    *slotOffset = SkToU32(fNextSlotOffset);
+    fNextSlotOffset += fSlotStride;
+    return true;
+}
+
 // We implement our own creation function for special buffer resource type
 const GrVkResource* GrVkUniformBuffer::CreateResource(GrVkGpu* gpu, size_t size) {
     if (0 == size) {
@@ -18,8 +18,11 @@ class GrVkUniformBuffer : public GrVkBuffer {
 
 public:
     static GrVkUniformBuffer* Create(GrVkGpu* gpu, size_t size);
+    // Creates a buffer with room for several sets of 'slotSize' bytes of uniforms, which are
+    // written with updateNextSlot() and bound with dynamic offsets.
+    static GrVkUniformBuffer* CreateWithSlots(GrVkGpu* gpu, size_t slotSize);
     static const GrVkResource* CreateResource(GrVkGpu* gpu, size_t size);
-    static const size_t kStandardSize = 256;
+    static const size_t kStandardSize = 1024;
 
     void* map(GrVkGpu* gpu) {
         return this->vkMap(gpu);
@@ -33,6 +36,14 @@ public:
                     bool* createdNewBuffer) {
         return this->vkUpdateData(gpu, src, srcSizeInBytes, createdNewBuffer);
     }
+    // Writes slotSize() bytes to a slot that no command buffer reads yet and returns its offset.
+    // When every slot may still be read a new VkBuffer is swapped in, and createdNewBuffer is set
+    // to true.
+    bool updateNextSlot(GrVkGpu* gpu, const void* src, uint32_t* slotOffset,
+                        bool* createdNewBuffer);
+    // The size of the uniforms in each slot, or of the whole buffer if it has no slots.
+    size_t slotSize() const { return fSlotSize ? fSlotSize : this->size(); }
+
     void release(const GrVkGpu* gpu) { this->vkRelease(gpu); }
     void abandon() { this->vkAbandon(); }
 
@@ -54,6 +65,10 @@ private:
                       const GrVkUniformBuffer::Resource* resource)
         : INHERITED(desc, resource) {}
 
+    size_t fSlotSize = 0;
+    size_t fSlotStride = 0;
+    size_t fNextSlotOffset = 0;
+
     typedef GrVkBuffer INHERITED;
 };
 
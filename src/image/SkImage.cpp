@@ -414,6 +414,10 @@ sk_sp<SkImage> SkImage::makeTextureImage(GrContext*, SkColorSpace* dstColorSpace
     return nullptr;
 }
 
+sk_sp<SkImage> SkImage::makeTextureImageAsync(GrContext*, GrMipMapped) const {
+    return nullptr;
+}
+
 sk_sp<SkImage> MakeFromNV12TexturesCopyWithExternalBackend(GrContext* context,
                                                            SkYUVColorSpace yuvColorSpace,
                                                            const GrBackendTexture nv12Textures[2],
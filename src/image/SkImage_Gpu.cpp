@@ -313,6 +313,46 @@ sk_sp<SkImage> SkImage::makeTextureImage(GrContext* context, SkColorSpace* dstCo
     return nullptr;
 }
 
+sk_sp<SkImage> SkImage::makeTextureImageAsync(GrContext* context, GrMipMapped mipMapped) const {
+    if (!context || as_IB(this)->context() || context->abandoned()) {
+        return this->makeTextureImage(context, nullptr, mipMapped);
+    }
+    const SkBitmap* bmp = as_IB(this)->onPeekBitmap();
+    if (!bmp && !(this->isLazyGenerated() && this->refEncodedData())) {
+        return this->makeTextureImage(context, nullptr, mipMapped);
+    }
+
+    // A raster image shares its texture with other draws of its pixels, as GrBitmapTextureMaker
+    // keys it. If one is already there, or pending, use it.
+    GrProxyProvider* proxyProvider = context->contextPriv().proxyProvider();
+    GrUniqueKey key;
+    if (bmp && !bmp->isVolatile()) {
+        SkIPoint origin = bmp->pixelRefOrigin();
+        GrMakeKeyFromImageID(&key, bmp->getGenerationID(),
+                             SkIRect::MakeXYWH(origin.fX, origin.fY, bmp->width(), bmp->height()));
+        if (proxyProvider->findOrCreateProxyByUniqueKey(key, kTopLeft_GrSurfaceOrigin)) {
+            // makeTextureImage() finds it too, and mips it if need be.
+            return this->makeTextureImage(context, nullptr, mipMapped);
+        }
+    }
+
+    sk_sp<GrTextureProxy> proxy = proxyProvider->createDeferredTextureProxy(
+            sk_ref_sp(const_cast<SkImage*>(this)), mipMapped);
+    if (!proxy) {
+        return nullptr;
+    }
+    if (key.isValid()) {
+        proxyProvider->assignUniqueKeyToProxy(key, proxy.get());
+        // As in GrMakeCachedImageProxy(), DDL recorders can't install the listener.
+        if (!proxyProvider->recordingDDL()) {
+            GrInstallBitmapUniqueKeyInvalidator(key, proxyProvider->contextUniqueID(),
+                                                bmp->pixelRef());
+        }
+    }
+    return sk_make_sp<SkImage_Gpu>(sk_ref_sp(context), this->uniqueID(), this->alphaType(),
+                                   std::move(proxy), this->refColorSpace(), SkBudgeted::kNo);
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
 sk_sp<SkImage> SkImage_Gpu::MakePromiseTexture(GrContext* context,
@@ -327,7 +367,8 @@ sk_sp<SkImage> SkImage_Gpu::MakePromiseTexture(GrContext* context,
                                                TextureFulfillProc textureFulfillProc,
                                                TextureReleaseProc textureReleaseProc,
                                                PromiseDoneProc promiseDoneProc,
-                                               TextureContext textureContext) {
+                                               TextureContext textureContext,
+                                               GrPromiseTextureBatcher* batcher) {
     // The contract here is that if 'promiseDoneProc' is passed in it should always be called,
     // even if creation of the SkImage fails.
     if (!promiseDoneProc) {
@@ -345,7 +386,7 @@ sk_sp<SkImage> SkImage_Gpu::MakePromiseTexture(GrContext* context,
         return nullptr;
     }
 
-    if (!textureFulfillProc || !textureReleaseProc) {
+    if (!batcher && (!textureFulfillProc || !textureReleaseProc)) {
         return nullptr;
     }
 
@@ -373,6 +414,10 @@ sk_sp<SkImage> SkImage_Gpu::MakePromiseTexture(GrContext* context,
     desc.fHeight = height;
     desc.fConfig = config;
 
+    if (batcher) {
+        promiseHelper.setBatcher(batcher);
+    }
+
     sk_sp<GrTextureProxy> proxy = proxyProvider->createLazyProxy(
             [promiseHelper, config](GrResourceProvider* resourceProvider) mutable {
                 if (!resourceProvider) {
@@ -405,7 +450,8 @@ sk_sp<SkImage> SkImage_Gpu::MakePromiseYUVATexture(GrContext* context,
                                                    TextureFulfillProc textureFulfillProc,
                                                    TextureReleaseProc textureReleaseProc,
                                                    PromiseDoneProc promiseDoneProc,
-                                                   TextureContext textureContexts[]) {
+                                                   TextureContext textureContexts[],
+                                                   GrPromiseTextureBatcher* batcher) {
     // The contract here is that if 'promiseDoneProc' is passed in it should always be called,
     // even if creation of the SkImage fails.
     if (!promiseDoneProc) {
@@ -452,7 +498,7 @@ sk_sp<SkImage> SkImage_Gpu::MakePromiseYUVATexture(GrContext* context,
         return nullptr;
     }
 
-    if (!textureFulfillProc || !textureReleaseProc) {
+    if (!batcher && (!textureFulfillProc || !textureReleaseProc)) {
         return nullptr;
     }
 
@@ -481,6 +527,14 @@ sk_sp<SkImage> SkImage_Gpu::MakePromiseYUVATexture(GrContext* context,
     desc.fConfig = params.fConfigs[params.fLocalIndices[SkYUVAIndex::kY_Index].fIndex];
     desc.fSampleCnt = 1;
 
+    if (batcher) {
+        for (int i = 0; i < 4; ++i) {
+            if (slotUsed[i]) {
+                params.fPromiseHelpers[i].setBatcher(batcher);
+            }
+        }
+    }
+
     GrProxyProvider* proxyProvider = context->contextPriv().proxyProvider();
 
     sk_sp<GrTextureProxy> proxy = proxyProvider->createLazyProxy(
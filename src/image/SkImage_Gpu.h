@@ -78,6 +78,8 @@ public:
         @param textureReleaseProc  function called when texture can be released
         @param promiseDoneProc     function called when we will no longer call textureFulfillProc
         @param textureContext      state passed to textureFulfillProc and textureReleaseProc
+        @param batcher             if set, fulfills and releases in place of textureFulfillProc
+                                   and textureReleaseProc, which may then be nullptr
         @return                    created SkImage, or nullptr
      */
     static sk_sp<SkImage> MakePromiseTexture(GrContext* context,
@@ -92,7 +94,8 @@ public:
                                              TextureFulfillProc textureFulfillProc,
                                              TextureReleaseProc textureReleaseProc,
                                              PromiseDoneProc promiseDoneProc,
-                                             TextureContext textureContext);
+                                             TextureContext textureContext,
+                                             GrPromiseTextureBatcher* batcher = nullptr);
 
     /** To be deprecated. Use SkImage_GpuYUVA::MakePromiseYUVATexture instead.
      */
@@ -107,7 +110,8 @@ public:
                                                  TextureFulfillProc textureFulfillProc,
                                                  TextureReleaseProc textureReleaseProc,
                                                  PromiseDoneProc promiseDoneProc,
-                                                 TextureContext textureContexts[]);
+                                                 TextureContext textureContexts[],
+                                                 GrPromiseTextureBatcher* batcher = nullptr);
 
     static sk_sp<SkImage> ConvertYUVATexturesToRGB(
             GrContext*, SkYUVColorSpace yuvColorSpace, const GrBackendTexture yuvaTextures[],
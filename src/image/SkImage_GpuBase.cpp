@@ -391,12 +391,16 @@ sk_sp<GrTexture> SkPromiseImageHelper::getTexture(GrResourceProvider* resourcePr
 
     sk_sp<GrTexture> tex;
     if (!fReleaseHelper) {
-        fFulfillProc(fContext, &fBackendTex);
+        if (fBatchTexture) {
+            fBackendTex = fBatchTexture->fulfill();
+        } else {
+            fFulfillProc(fContext, &fBackendTex);
+        }
         fBackendTex.fConfig = config;
         if (!fBackendTex.isValid()) {
             // Even though the GrBackendTexture is not valid, we must call the release
             // proc to keep our contract of always calling Fulfill and Release in pairs.
-            fReleaseProc(fContext);
+            this->release();
             return sk_sp<GrTexture>();
         }
 
@@ -404,10 +408,11 @@ sk_sp<GrTexture> SkPromiseImageHelper::getTexture(GrResourceProvider* resourcePr
         if (!tex) {
             // Even though the GrBackendTexture is not valid, we must call the release
             // proc to keep our contract of always calling Fulfill and Release in pairs.
-            fReleaseProc(fContext);
+            this->release();
             return sk_sp<GrTexture>();
         }
-        fReleaseHelper = new SkPromiseReleaseProcHelper(fReleaseProc, fContext, fDoneHelper);
+        fReleaseHelper = new SkPromiseReleaseProcHelper(fReleaseProc, fContext, fDoneHelper,
+                                                        fBatchTexture);
         // Take a weak ref
         fReleaseHelper->weak_ref();
     } else {
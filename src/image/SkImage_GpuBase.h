@@ -9,6 +9,7 @@
 #define SkImage_GpuBase_DEFINED
 
 #include "GrBackendSurface.h"
+#include "GrPromiseTextureBatcher.h"
 #include "GrTypesPriv.h"
 #include "SkImage_Base.h"
 #include "SkYUVAIndex.h"
@@ -95,25 +96,34 @@ private:
 /**
  * This helper holds the normal hard ref for the Release proc as well as a hard ref on the DoneProc.
  * Thus when a GrTexture is being released, it will unref both the ReleaseProc and DoneProc.
+ * With a batch texture, the release goes to its batcher instead of the ReleaseProc.
  */
 class SkPromiseReleaseProcHelper : public GrReleaseProcHelper {
 public:
     SkPromiseReleaseProcHelper(SkImage_GpuBase::TextureReleaseProc releaseProc,
                                SkImage_GpuBase::TextureContext context,
-                               sk_sp<GrReleaseProcHelper> doneHelper)
+                               sk_sp<GrReleaseProcHelper> doneHelper,
+                               sk_sp<GrPromiseTextureBatcher::Texture> batchTexture)
         : INHERITED(releaseProc, context)
-        , fDoneProcHelper(std::move(doneHelper)) {
+        , fDoneProcHelper(std::move(doneHelper))
+        , fBatchTexture(std::move(batchTexture)) {
     }
 
     void weak_dispose() const override {
-        // Call the inherited weak_dispose first so that we call the ReleaseProc before the DoneProc
-        // if we hold the last ref to the DoneProc.
-        INHERITED::weak_dispose();
+        // Release first so that we call the ReleaseProc (or hand the release to the batcher)
+        // before the DoneProc if we hold the last ref to the DoneProc.
+        if (fBatchTexture) {
+            fBatchTexture->release();
+            fBatchTexture.reset();
+        } else {
+            INHERITED::weak_dispose();
+        }
         fDoneProcHelper.reset();
     }
 
 private:
     mutable sk_sp<GrReleaseProcHelper> fDoneProcHelper;
+    mutable sk_sp<GrPromiseTextureBatcher::Texture> fBatchTexture;
 
     typedef GrReleaseProcHelper INHERITED;
 };
@@ -158,16 +168,31 @@ public:
         , fDoneHelper(new GrReleaseProcHelper(doneProc, context)) {
     }
 
+    // Fulfills and releases through batcher rather than the procs.
+    void setBatcher(GrPromiseTextureBatcher* batcher) {
+        SkASSERT(fDoneHelper);
+        fBatchTexture = batcher->makeTexture(fContext, fDoneHelper);
+    }
+
     bool isValid() { return SkToBool(fDoneHelper); }
 
     void reset() {
         this->resetReleaseHelper();
         fDoneHelper.reset();
+        fBatchTexture.reset();
     }
 
     sk_sp<GrTexture> getTexture(GrResourceProvider* resourceProvider, GrPixelConfig config);
 
 private:
+    void release() {
+        if (fBatchTexture) {
+            fBatchTexture->release();
+        } else {
+            fReleaseProc(fContext);
+        }
+    }
+
     // Weak unrefs fReleaseHelper and sets it to null
     void resetReleaseHelper() {
         if (fReleaseHelper) {
@@ -191,6 +216,8 @@ private:
     // ReleaseHelpers are finished. Thus we hold a hard ref here and we will pass a hard ref to each
     // fReleaseHelper we make.
     sk_sp<GrReleaseProcHelper> fDoneHelper;
+    // Set if the image's promise textures are fulfilled in batches.
+    sk_sp<GrPromiseTextureBatcher::Texture> fBatchTexture;
 };
 
 #endif
@@ -220,7 +220,8 @@ sk_sp<SkImage> SkImage_GpuYUVA::MakePromiseYUVATexture(GrContext* context,
                                                        TextureFulfillProc textureFulfillProc,
                                                        TextureReleaseProc textureReleaseProc,
                                                        PromiseDoneProc promiseDoneProc,
-                                                       TextureContext textureContexts[]) {
+                                                       TextureContext textureContexts[],
+                                                       GrPromiseTextureBatcher* batcher) {
     // The contract here is that if 'promiseDoneProc' is passed in it should always be called,
     // even if creation of the SkImage fails.
     if (!promiseDoneProc) {
@@ -249,7 +250,7 @@ sk_sp<SkImage> SkImage_GpuYUVA::MakePromiseYUVATexture(GrContext* context,
         return nullptr;
     }
 
-    if (!textureFulfillProc || !textureReleaseProc) {
+    if (!batcher && (!textureFulfillProc || !textureReleaseProc)) {
         return nullptr;
     }
 
@@ -288,6 +289,9 @@ sk_sp<SkImage> SkImage_GpuYUVA::MakePromiseYUVATexture(GrContext* context,
         if (!res) {
             return nullptr;
         }
+        if (batcher) {
+            promiseHelpers[texIdx].setBatcher(batcher);
+        }
         params.fPromiseHelper = promiseHelpers[texIdx];
 
         GrProxyProvider::LazyInstantiateCallback lazyInstCallback =
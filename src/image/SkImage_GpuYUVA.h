@@ -92,6 +92,8 @@ public:
         @param textureReleaseProc  function called when texture can be released
         @param promiseDoneProc     function called when we will no longer call textureFulfillProc
         @param textureContext      state passed to textureFulfillProc and textureReleaseProc
+        @param batcher             if set, fulfills and releases in place of textureFulfillProc
+                                   and textureReleaseProc, which may then be nullptr
         @return                    created SkImage, or nullptr
      */
     static sk_sp<SkImage> MakePromiseYUVATexture(GrContext* context,
@@ -106,7 +108,8 @@ public:
                                                  TextureFulfillProc textureFulfillProc,
                                                  TextureReleaseProc textureReleaseProc,
                                                  PromiseDoneProc promiseDoneProc,
-                                                 TextureContext textureContexts[]);
+                                                 TextureContext textureContexts[],
+                                                 GrPromiseTextureBatcher* batcher = nullptr);
 
 private:
     // This array will usually only be sparsely populated.
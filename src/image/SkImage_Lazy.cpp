@@ -185,20 +185,26 @@ bool SkImage_Lazy::getROPixels(SkBitmap* bitmap, SkImage::CachingHint chint) con
         return true;
     }
 
+    // Another thread (or GrContext) may be decoding these same pixels right now. It holds the
+    // generator until it has added them to the cache, so look again once we have it, rather than
+    // decoding them a second time.
+    ScopedGenerator generator(fSharedGenerator);
+    if (SkBitmapCache::Find(desc, bitmap)) {
+        check_output_bitmap();
+        return true;
+    }
+
     if (SkImage::kAllow_CachingHint == chint) {
         SkPixmap pmap;
         SkBitmapCache::RecPtr cacheRec = SkBitmapCache::Alloc(desc, fInfo, &pmap);
-        if (!cacheRec ||
-            !generate_pixels(ScopedGenerator(fSharedGenerator), pmap,
-                             fOrigin.x(), fOrigin.y())) {
+        if (!cacheRec || !generate_pixels(generator, pmap, fOrigin.x(), fOrigin.y())) {
             return false;
         }
         SkBitmapCache::Add(std::move(cacheRec), bitmap);
         this->notifyAddedToRasterCache();
     } else {
         if (!bitmap->tryAllocPixels(fInfo) ||
-            !generate_pixels(ScopedGenerator(fSharedGenerator), bitmap->pixmap(),
-                             fOrigin.x(), fOrigin.y())) {
+            !generate_pixels(generator, bitmap->pixmap(), fOrigin.x(), fOrigin.y())) {
             return false;
         }
         bitmap->setImmutable();
@@ -423,8 +429,19 @@ sk_sp<GrTextureProxy> SkImage_Lazy::lockTextureProxy(
         GrBackendFormat format =
                 ctx->contextPriv().caps()->getBackendFormatFromColorType(colorType);
 
-        ScopedGenerator generator(fSharedGenerator);
-        Generator_GrYUVProvider provider(generator);
+        // The planes are decoded (or found in the SkYUVPlanesCache, where any GrContext that
+        // decoded them before us left them) with the generator held, so concurrent callers wait
+        // for one decode. The upload doesn't need the generator, so it happens after releasing it.
+        SkYUVASizeInfo yuvaSizeInfo;
+        SkYUVAIndex yuvaIndices[SkYUVAIndex::kIndexCount];
+        SkYUVColorSpace yuvColorSpace;
+        const void* planes[SkYUVASizeInfo::kMaxCount];
+        sk_sp<SkCachedData> planeStorage;
+        {
+            ScopedGenerator generator(fSharedGenerator);
+            Generator_GrYUVProvider provider(generator);
+            planeStorage = provider.getPlanes(&yuvaSizeInfo, yuvaIndices, &yuvColorSpace, planes);
+        }
 
         // The pixels in the texture will be in the generator's color space. If onMakeColorSpace
         // has been called then this will not match this image's color space. To correct this, apply
@@ -434,7 +451,11 @@ sk_sp<GrTextureProxy> SkImage_Lazy::lockTextureProxy(
 
         // TODO: Update to create the mipped surface in the YUV generator and draw the base
         // layer directly into the mipped surface.
-        proxy = provider.refAsTextureProxy(ctx, format, desc, generatorColorSpace, thisColorSpace);
+        if (planeStorage) {
+            proxy = GrYUVProvider::MakeTextureProxy(ctx, format, desc, yuvaSizeInfo, yuvaIndices,
+                                                    yuvColorSpace, planes, std::move(planeStorage),
+                                                    generatorColorSpace, thisColorSpace);
+        }
         if (proxy) {
             SK_HISTOGRAM_ENUMERATION("LockTexturePath", kYUV_LockTexturePath,
                                      kLockTexturePathCount);
@@ -449,7 +470,7 @@ sk_sp<GrTextureProxy> SkImage_Lazy::lockTextureProxy(
     SkBitmap bitmap;
     if (!proxy && this->getROPixels(&bitmap, chint)) {
         if (willBeMipped) {
-            proxy = proxyProvider->createMipMapProxyFromBitmap(bitmap);
+            proxy = proxyProvider->createDeferredMipMapProxyFromBitmap(bitmap);
         }
         if (!proxy) {
             proxy = GrUploadBitmapToTextureProxy(proxyProvider, bitmap);
@@ -6,6 +6,7 @@
  */
 
 #include "GrBackendSurface.h"
+#include "SkAutoPixmapStorage.h"
 #include "SkCanvas.h"
 #include "SkFontLCDConfig.h"
 #include "SkImagePriv.h"
@@ -86,11 +87,31 @@ void SkSurface_Base::onDraw(SkCanvas* canvas, SkScalar x, SkScalar y, const SkPa
     }
 }
 
+void SkSurface_Base::onAsyncRescaleAndReadPixels(const SkImageInfo& info, const SkIRect& srcRect,
+                                                 SkFilterQuality quality,
+                                                 ReadPixelsCallback callback,
+                                                 ReadPixelsContext context) {
+    auto image = this->makeImageSnapshot(srcRect);
+    SkAutoPixmapStorage pm;
+    if (!image || !pm.tryAlloc(info) || !image->scalePixels(pm, quality)) {
+        callback(context, nullptr, 0);
+        return;
+    }
+    callback(context, pm.addr(), pm.rowBytes());
+}
+
+void SkSurface_Base::onAsyncRescaleAndReadPixelsYUV420(SkYUVColorSpace, sk_sp<SkColorSpace>,
+                                                       const SkIRect&, int, int, SkFilterQuality,
+                                                       ReadPixelsCallbackYUV420 callback,
+                                                       ReadPixelsContext context) {
+    callback(context, nullptr, nullptr);
+}
+
 bool SkSurface_Base::outstandingImageSnapshot() const {
     return fCachedImage && !fCachedImage->unique();
 }
 
-void SkSurface_Base::aboutToDraw(ContentChangeMode mode) {
+void SkSurface_Base::aboutToDraw(ContentChangeMode mode, const SkIRect* bounds) {
     this->dirtyGenerationID();
 
     SkASSERT(!fCachedCanvas || fCachedCanvas->getSurfaceBase() == this);
@@ -117,6 +138,8 @@ void SkSurface_Base::aboutToDraw(ContentChangeMode mode) {
     } else if (kDiscard_ContentChangeMode == mode) {
         this->onDiscard();
     }
+
+    this->onContentWillChange(bounds);
 }
 
 uint32_t SkSurface_Base::newGenerationID() {
@@ -207,6 +230,33 @@ bool SkSurface::readPixels(const SkBitmap& bitmap, int srcX, int srcY) {
     return bitmap.peekPixels(&pm) && this->readPixels(pm, srcX, srcY);
 }
 
+void SkSurface::asyncRescaleAndReadPixels(const SkImageInfo& info, const SkIRect& srcRect,
+                                          SkFilterQuality quality, ReadPixelsCallback callback,
+                                          ReadPixelsContext context) {
+    if (!SkIRect::MakeWH(this->width(), this->height()).contains(srcRect) || srcRect.isEmpty() ||
+        info.isEmpty() || kUnknown_SkColorType == info.colorType()) {
+        callback(context, nullptr, 0);
+        return;
+    }
+    asSB(this)->onAsyncRescaleAndReadPixels(info, srcRect, quality, callback, context);
+}
+
+void SkSurface::asyncRescaleAndReadPixelsYUV420(SkYUVColorSpace yuvColorSpace,
+                                                sk_sp<SkColorSpace> dstColorSpace,
+                                                const SkIRect& srcRect, int dstW, int dstH,
+                                                SkFilterQuality quality,
+                                                ReadPixelsCallbackYUV420 callback,
+                                                ReadPixelsContext context) {
+    if (!SkIRect::MakeWH(this->width(), this->height()).contains(srcRect) || srcRect.isEmpty() ||
+        dstW <= 0 || dstH <= 0) {
+        callback(context, nullptr, nullptr);
+        return;
+    }
+    asSB(this)->onAsyncRescaleAndReadPixelsYUV420(yuvColorSpace, std::move(dstColorSpace),
+                                                  srcRect, dstW, dstH, quality, callback,
+                                                  context);
+}
+
 void SkSurface::writePixels(const SkPixmap& pmap, int x, int y) {
     if (pmap.addr() == nullptr || pmap.width() <= 0 || pmap.height() <= 0) {
         return;
@@ -219,7 +269,9 @@ void SkSurface::writePixels(const SkPixmap& pmap, int x, int y) {
         if (srcR.contains(dstR)) {
             mode = kDiscard_ContentChangeMode;
         }
-        asSB(this)->aboutToDraw(mode);
+        SkIRect changed = srcR;
+        SkAssertResult(changed.intersect(dstR));
+        asSB(this)->aboutToDraw(mode, &changed);
         asSB(this)->onWritePixels(pmap, x, y);
     }
 }
@@ -75,6 +75,13 @@ public:
      */
     virtual void onRestoreBackingMutability() {}
 
+    /**
+     *  Called after any copy-on-write, before the contents change.  If bounds is set, nothing
+     *  outside of it (in device space) will change; otherwise the whole surface may.  The canvas
+     *  only works out the bounds of its draws if tracksContentChanges() is true.
+     */
+    virtual void onContentWillChange(const SkIRect* bounds) {}
+
     /**
      * Issue any pending surface IO to the current backend 3D API and resolve any surface MSAA.
      * Inserts the requested number of semaphores for the gpu to signal when work is complete on the
@@ -97,19 +104,42 @@ public:
     virtual bool onCharacterize(SkSurfaceCharacterization*) const { return false; }
     virtual bool onDraw(const SkDeferredDisplayList*) { return false; }
 
+    /**
+     *  Default implementation: scales a snapshot of srcRect into info's pixels with
+     *  SkImage::scalePixels() and calls the callback before returning.
+     */
+    virtual void onAsyncRescaleAndReadPixels(const SkImageInfo&, const SkIRect& srcRect,
+                                             SkFilterQuality, ReadPixelsCallback,
+                                             ReadPixelsContext);
+
+    /**
+     *  Default implementation: calls the callback with nullptr.
+     */
+    virtual void onAsyncRescaleAndReadPixelsYUV420(SkYUVColorSpace, sk_sp<SkColorSpace>,
+                                                   const SkIRect& srcRect, int dstW, int dstH,
+                                                   SkFilterQuality, ReadPixelsCallbackYUV420,
+                                                   ReadPixelsContext);
+
     inline SkCanvas* getCachedCanvas();
     inline sk_sp<SkImage> refCachedImage();
 
     bool hasCachedImage() const { return fCachedImage != nullptr; }
 
+    bool tracksContentChanges() const { return fTracksContentChanges; }
+
+protected:
+    void setTracksContentChanges(bool tracks) { fTracksContentChanges = tracks; }
+
     // called by SkSurface to compute a new genID
     uint32_t newGenerationID();
 
 private:
     std::unique_ptr<SkCanvas>   fCachedCanvas;
     sk_sp<SkImage>              fCachedImage;
+    bool                        fTracksContentChanges = false;
 
-    void aboutToDraw(ContentChangeMode mode);
+    // If bounds is set, only the pixels inside it (in device space) are about to change.
+    void aboutToDraw(ContentChangeMode mode, const SkIRect* bounds = nullptr);
 
     // Returns true if there is an outstanding image-snapshot, indicating that a call to aboutToDraw
     // would trigger a copy-on-write.
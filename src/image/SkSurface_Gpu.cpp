@@ -157,6 +157,25 @@ GrSemaphoresSubmitted SkSurface_Gpu::onFlush(int numSemaphores,
     return fDevice->flushAndSignalSemaphores(numSemaphores, signalSemaphores);
 }
 
+void SkSurface_Gpu::onAsyncRescaleAndReadPixels(const SkImageInfo& info, const SkIRect& srcRect,
+                                                SkFilterQuality quality,
+                                                ReadPixelsCallback callback,
+                                                ReadPixelsContext context) {
+    fDevice->accessRenderTargetContext()->asyncRescaleAndReadPixels(info, srcRect, quality,
+                                                                    callback, context);
+}
+
+void SkSurface_Gpu::onAsyncRescaleAndReadPixelsYUV420(SkYUVColorSpace yuvColorSpace,
+                                                      sk_sp<SkColorSpace> dstColorSpace,
+                                                      const SkIRect& srcRect, int dstW, int dstH,
+                                                      SkFilterQuality quality,
+                                                      ReadPixelsCallbackYUV420 callback,
+                                                      ReadPixelsContext context) {
+    fDevice->accessRenderTargetContext()->asyncRescaleAndReadPixelsYUV420(
+            yuvColorSpace, std::move(dstColorSpace), srcRect, dstW, dstH, quality, callback,
+            context);
+}
+
 bool SkSurface_Gpu::onWait(int numSemaphores, const GrBackendSemaphore* waitSemaphores) {
     return fDevice->wait(numSemaphores, waitSemaphores);
 }
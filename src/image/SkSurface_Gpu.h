@@ -38,6 +38,12 @@ public:
     bool onCharacterize(SkSurfaceCharacterization*) const override;
     bool isCompatible(const SkSurfaceCharacterization&) const;
     bool onDraw(const SkDeferredDisplayList*) override;
+    void onAsyncRescaleAndReadPixels(const SkImageInfo&, const SkIRect& srcRect, SkFilterQuality,
+                                     ReadPixelsCallback, ReadPixelsContext) override;
+    void onAsyncRescaleAndReadPixelsYUV420(SkYUVColorSpace, sk_sp<SkColorSpace>,
+                                           const SkIRect& srcRect, int dstW, int dstH,
+                                           SkFilterQuality, ReadPixelsCallbackYUV420,
+                                           ReadPixelsContext) override;
 
     SkGpuDevice* getDevice() { return fDevice.get(); }
 
@@ -9,8 +9,10 @@
 #include "SkImageInfoPriv.h"
 #include "SkImagePriv.h"
 #include "SkCanvas.h"
+#include "SkConvertPixels.h"
 #include "SkDevice.h"
 #include "SkMallocPixelRef.h"
+#include "SkThreadedBMPDevice.h"
 
 class SkSurface_Raster : public SkSurface_Base {
 public:
@@ -19,6 +21,13 @@ public:
                      const SkSurfaceProps*);
     SkSurface_Raster(const SkImageInfo& info, sk_sp<SkPixelRef>, const SkSurfaceProps*);
 
+    // Draws through the canvas are recorded and rasterized in parallel on executor.
+    void setThreaded(SkExecutor* executor) {
+        SkASSERT(!this->getCachedCanvas());
+        fThreaded = true;
+        fExecutor = executor;
+    }
+
     SkCanvas* onNewCanvas() override;
     sk_sp<SkSurface> onNewSurface(const SkImageInfo&) override;
     sk_sp<SkImage> onNewImageSnapshot(const SkIRect* subset) override;
@@ -26,11 +35,27 @@ public:
     void onDraw(SkCanvas*, SkScalar x, SkScalar y, const SkPaint*) override;
     void onCopyOnWrite(ContentChangeMode) override;
     void onRestoreBackingMutability() override;
+    void onContentWillChange(const SkIRect* bounds) override;
 
 private:
+    // Makes sure any draws recorded by a threaded canvas have landed in fBitmap.
+    void flushThreadedDraws() {
+        if (fThreaded) {
+            this->getCachedCanvas()->flush();
+        }
+    }
+
     SkBitmap    fBitmap;
     size_t      fRowBytes;
     bool        fWeOwnThePixels;
+    bool        fThreaded = false;
+    SkExecutor* fExecutor = nullptr;
+
+    // The pixels we last copied-on-write away from.  Once no snapshot holds them we reuse them
+    // for the next copy-on-write, copying over only fSpareDirty: everything that has changed in
+    // fBitmap since the two were last the same.
+    sk_sp<SkPixelRef> fSpare;
+    SkIRect           fSpareDirty = SkIRect::MakeEmpty();
 
     typedef SkSurface_Base INHERITED;
 };
@@ -87,7 +112,12 @@ SkSurface_Raster::SkSurface_Raster(const SkImageInfo& info, sk_sp<SkPixelRef> pr
     fWeOwnThePixels = true;
 }
 
-SkCanvas* SkSurface_Raster::onNewCanvas() { return new SkCanvas(fBitmap, this->props()); }
+SkCanvas* SkSurface_Raster::onNewCanvas() {
+    if (fThreaded) {
+        return new SkCanvas(sk_make_sp<SkThreadedBMPDevice>(fBitmap, this->props(), fExecutor));
+    }
+    return new SkCanvas(fBitmap, this->props());
+}
 
 sk_sp<SkSurface> SkSurface_Raster::onNewSurface(const SkImageInfo& info) {
     return SkSurface::MakeRaster(info, &this->props());
@@ -95,10 +125,12 @@ sk_sp<SkSurface> SkSurface_Raster::onNewSurface(const SkImageInfo& info) {
 
 void SkSurface_Raster::onDraw(SkCanvas* canvas, SkScalar x, SkScalar y,
                               const SkPaint* paint) {
+    this->flushThreadedDraws();
     canvas->drawBitmap(fBitmap, x, y, paint);
 }
 
 sk_sp<SkImage> SkSurface_Raster::onNewImageSnapshot(const SkIRect* subset) {
+    this->flushThreadedDraws();
     if (subset) {
         SkASSERT(SkIRect::MakeWH(fBitmap.width(), fBitmap.height()).contains(*subset));
         SkBitmap dst;
@@ -125,6 +157,7 @@ sk_sp<SkImage> SkSurface_Raster::onNewImageSnapshot(const SkIRect* subset) {
 }
 
 void SkSurface_Raster::onWritePixels(const SkPixmap& src, int x, int y) {
+    this->flushThreadedDraws();
     fBitmap.writePixels(src, x, y);
 }
 
@@ -135,22 +168,46 @@ void SkSurface_Raster::onRestoreBackingMutability() {
     }
 }
 
+void SkSurface_Raster::onContentWillChange(const SkIRect* bounds) {
+    if (fSpare) {
+        fSpareDirty.join(bounds ? *bounds : SkIRect::MakeWH(fBitmap.width(), fBitmap.height()));
+    }
+}
+
 void SkSurface_Raster::onCopyOnWrite(ContentChangeMode mode) {
     // are we sharing pixelrefs with the image?
     sk_sp<SkImage> cached(this->refCachedImage());
     SkASSERT(cached);
     if (SkBitmapImageGetPixelRef(cached.get()) == fBitmap.pixelRef()) {
         SkASSERT(fWeOwnThePixels);
-        if (kDiscard_ContentChangeMode == mode) {
+        SkBitmap prev(fBitmap);
+        if (fSpare && fSpare->unique()) {
+            // The snapshot that held the spare is gone, so it only needs catching up with what
+            // has been drawn since.
+            fSpare->restoreMutability();
+            fSpare->notifyPixelsChanged();
+            if (kRetain_ContentChangeMode == mode && !fSpareDirty.isEmpty()) {
+                const SkImageInfo& info = fBitmap.info();
+                size_t offset = fSpareDirty.top() * fBitmap.rowBytes() +
+                                fSpareDirty.left() * info.bytesPerPixel();
+                SkRectMemcpy(SkTAddOffset<void>(fSpare->pixels(), offset), fSpare->rowBytes(),
+                             SkTAddOffset<const void>(prev.getPixels(), offset),
+                             prev.rowBytes(), fSpareDirty.width() * info.bytesPerPixel(),
+                             fSpareDirty.height());
+            }
+            fBitmap.setPixelRef(std::move(fSpare), 0, 0);
+        } else if (kDiscard_ContentChangeMode == mode) {
             fBitmap.allocPixels();
         } else {
-            SkBitmap prev(fBitmap);
             fBitmap.allocPixels();
             SkASSERT(prev.info() == fBitmap.info());
             SkASSERT(prev.rowBytes() == fBitmap.rowBytes());
             memcpy(fBitmap.getPixels(), prev.getPixels(), fBitmap.computeByteSize());
         }
         SkASSERT(fBitmap.rowBytes() == fRowBytes);  // be sure we always use the same value
+        fSpare = sk_ref_sp(prev.pixelRef());
+        fSpareDirty.setEmpty();
+        this->setTracksContentChanges(true);
 
         // Now fBitmap is a deep copy of itself (and therefore different from
         // what is being used by the image. Next we update the canvas to use
@@ -198,3 +255,18 @@ sk_sp<SkSurface> SkSurface::MakeRaster(const SkImageInfo& info, size_t rowBytes,
     }
     return sk_make_sp<SkSurface_Raster>(info, std::move(pr), props);
 }
+
+sk_sp<SkSurface> SkSurface::MakeRasterThreaded(const SkImageInfo& info, SkExecutor* executor,
+                                               const SkSurfaceProps* props) {
+    if (!SkSurfaceValidateRasterInfo(info)) {
+        return nullptr;
+    }
+
+    sk_sp<SkPixelRef> pr = SkMallocPixelRef::MakeZeroed(info, 0);
+    if (!pr) {
+        return nullptr;
+    }
+    auto surface = sk_make_sp<SkSurface_Raster>(info, std::move(pr), props);
+    surface->setThreaded(executor);
+    return surface;
+}
@@ -10,13 +10,20 @@
 #ifdef SK_HAS_JPEG_LIBRARY
 
 #include "SkColorData.h"
+#include "SkExecutor.h"
 #include "SkImageEncoderFns.h"
 #include "SkImageInfoPriv.h"
 #include "SkJpegEncoder.h"
 #include "SkJPEGWriteUtility.h"
+#include "SkOpts.h"
 #include "SkStream.h"
+#include "SkTaskGroup.h"
 #include "SkTemplates.h"
+#include "SkYUVAIndex.h"
+#include "SkYUVASizeInfo.h"
 
+#include <atomic>
+#include <functional>
 #include <stdio.h>
 
 extern "C" {
@@ -24,6 +31,39 @@ extern "C" {
     #include "jerror.h"
 }
 
+// With Options::fExecutor, images are encoded in strips of at least this many rows, and no more
+// than kMaxStrips of them unless the restart interval forces it.
+#ifndef SK_JPEG_ENCODER_MIN_STRIP_ROWS
+    #define SK_JPEG_ENCODER_MIN_STRIP_ROWS 256
+#endif
+static constexpr int kMaxStrips = 16;
+
+/**
+ *  The shape of a YCbCr encode whose components we downsample ourselves: the luma sampling
+ *  factors (chroma is always 1x1), and how wide each component's rows are once padded out to
+ *  whole blocks, which is how much of each row libjpeg reads from raw data.
+ */
+struct YCbCrLayout {
+    YCbCrLayout(int width, int height, int hSamp, int vSamp) : fWidth(width), fHeight(height) {
+        fH[0] = hSamp;
+        fV[0] = vSamp;
+        fH[1] = fH[2] = fV[1] = fV[2] = 1;
+        for (int c = 0; c < 3; c++) {
+            const int blockWidth = hSamp * DCTSIZE / fH[c];
+            fPaddedWidth[c] = (width + blockWidth - 1) / blockWidth * DCTSIZE;
+        }
+    }
+
+    int mcuWidth()   const { return fH[0] * DCTSIZE; }
+    int mcuHeight()  const { return fV[0] * DCTSIZE; }
+    int mcusPerRow() const { return (fWidth  + this->mcuWidth()  - 1) / this->mcuWidth(); }
+    int mcuRows()    const { return (fHeight + this->mcuHeight() - 1) / this->mcuHeight(); }
+
+    int fWidth, fHeight;
+    int fH[3], fV[3];
+    int fPaddedWidth[3];
+};
+
 class SkJpegEncoderMgr final : SkNoncopyable {
 public:
 
@@ -37,6 +77,13 @@ public:
 
     bool setParams(const SkImageInfo& srcInfo, const SkJpegEncoder::Options& options);
 
+    /**
+     *  Sets up an encode of |height| rows of already converted and downsampled YCbCr, which
+     *  are passed to jpeg_write_raw_data().
+     */
+    void setRawParams(const YCbCrLayout& layout, int height, int quality, bool optimizeCoding,
+                      int restartRows);
+
     jpeg_compress_struct* cinfo() { return &fCInfo; }
 
     skjpeg_error_mgr* errorMgr() { return &fErrMgr; }
@@ -160,9 +207,44 @@ bool SkJpegEncoderMgr::setParams(const SkImageInfo& srcInfo, const SkJpegEncoder
     // for the image.  This improves compression at the cost of
     // slower encode performance.
     fCInfo.optimize_coding = TRUE;
+
+    if (options.fRestartRows > 0) {
+        fCInfo.restart_in_rows = SkTMin(options.fRestartRows, 0xFFFF);
+    }
     return true;
 }
 
+void SkJpegEncoderMgr::setRawParams(const YCbCrLayout& layout, int height, int quality,
+                                    bool optimizeCoding, int restartRows) {
+    fCInfo.image_width = layout.fWidth;
+    fCInfo.image_height = height;
+    fCInfo.in_color_space = JCS_YCbCr;
+    fCInfo.input_components = 3;
+    jpeg_set_defaults(&fCInfo);
+
+    fCInfo.raw_data_in = TRUE;
+    for (int c = 0; c < 3; c++) {
+        fCInfo.comp_info[c].h_samp_factor = layout.fH[c];
+        fCInfo.comp_info[c].v_samp_factor = layout.fV[c];
+    }
+    fCInfo.optimize_coding = optimizeCoding ? TRUE : FALSE;
+    fCInfo.restart_in_rows = restartRows;
+    jpeg_set_quality(&fCInfo, quality, TRUE);
+}
+
+static void write_icc_marker(jpeg_compress_struct* cinfo, const SkData* icc) {
+    // Create a contiguous block of memory with the icc signature followed by the profile.
+    sk_sp<SkData> markerData = SkData::MakeUninitialized(kICCMarkerHeaderSize + icc->size());
+    uint8_t* ptr = (uint8_t*) markerData->writable_data();
+    memcpy(ptr, kICCSig, sizeof(kICCSig));
+    ptr += sizeof(kICCSig);
+    *ptr++ = 1; // This is the first marker.
+    *ptr++ = 1; // Out of one total markers.
+    memcpy(ptr, icc->data(), icc->size());
+
+    jpeg_write_marker(cinfo, kICCMarker, markerData->bytes(), markerData->size());
+}
+
 std::unique_ptr<SkEncoder> SkJpegEncoder::Make(SkWStream* dst, const SkPixmap& src,
                                                const Options& options) {
     if (!SkPixmapIsValid(src)) {
@@ -185,17 +267,7 @@ std::unique_ptr<SkEncoder> SkJpegEncoder::Make(SkWStream* dst, const SkPixmap& s
 
     sk_sp<SkData> icc = icc_from_color_space(src.info());
     if (icc) {
-        // Create a contiguous block of memory with the icc signature followed by the profile.
-        sk_sp<SkData> markerData =
-                SkData::MakeUninitialized(kICCMarkerHeaderSize + icc->size());
-        uint8_t* ptr = (uint8_t*) markerData->writable_data();
-        memcpy(ptr, kICCSig, sizeof(kICCSig));
-        ptr += sizeof(kICCSig);
-        *ptr++ = 1; // This is the first marker.
-        *ptr++ = 1; // Out of one total markers.
-        memcpy(ptr, icc->data(), icc->size());
-
-        jpeg_write_marker(encoderMgr->cinfo(), kICCMarker, markerData->bytes(), markerData->size());
+        write_icc_marker(encoderMgr->cinfo(), icc.get());
     }
 
     return std::unique_ptr<SkJpegEncoder>(new SkJpegEncoder(std::move(encoderMgr), src));
@@ -237,9 +309,389 @@ bool SkJpegEncoder::onEncodeRows(int numRows) {
     return true;
 }
 
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ *  Converts a band of rows of 8888 (or, with a proc, F16) pixels to YCbCr with SkOpts, and
+ *  downsamples the chroma.  Each strip has its own.
+ */
+class PixelRows : SkNoncopyable {
+public:
+    PixelRows(const SkPixmap& src, const YCbCrLayout& layout, transform_scanline_proc proc,
+              SkOpts::Convert_8888_YCbCr convert)
+        : fSrc(src), fLayout(layout), fProc(proc), fConvert(convert)
+        , fStride(layout.mcusPerRow() * layout.mcuWidth())
+    {
+        const int rows = layout.mcuHeight();
+        const bool downsampled = layout.fH[0] > 1 || layout.fV[0] > 1;
+        fStorage.reset(fStride * rows * 3 +
+                       (downsampled ? layout.fPaddedWidth[1] * DCTSIZE * 2 : 0));
+        fY  = fStorage.get();
+        fCb = fY  + fStride * rows;
+        fCr = fCb + fStride * rows;
+        if (downsampled) {
+            fCbOut = fCr + fStride * rows;
+            fCrOut = fCbOut + layout.fPaddedWidth[1] * DCTSIZE;
+        }
+        if (fProc) {
+            fConverted.reset(src.width());
+        }
+    }
+
+    /**
+     *  Points band[c] at the rows of component c for the image rows starting at |top|, padded
+     *  out to whole blocks by repeating the last column and row.
+     */
+    void fill(int top, JSAMPARRAY band[3]) {
+        const int width = fSrc.width();
+        for (int r = 0; r < fLayout.mcuHeight(); r++) {
+            const void* srcRow = fSrc.addr(0, SkTMin(top + r, fSrc.height() - 1));
+            if (fProc) {
+                fProc((char*)fConverted.get(), (const char*)srcRow, width, 4);
+                srcRow = fConverted.get();
+            }
+            uint8_t* rows[3] = { fY + r * fStride, fCb + r * fStride, fCr + r * fStride };
+            fConvert(rows[0], rows[1], rows[2], (const uint32_t*)srcRow, width);
+            for (uint8_t* row : rows) {
+                memset(row + width, row[width - 1], fStride - width);
+            }
+            fRows[0][r] = rows[0];
+        }
+        band[0] = fRows[0];
+
+        const int hs = fLayout.fH[0],
+                  vs = fLayout.fV[0];
+        uint8_t* planes[2]  = { fCb, fCr };
+        uint8_t* outputs[2] = { fCbOut, fCrOut };
+        for (int c = 1; c < 3; c++) {
+            for (int r = 0; r < DCTSIZE; r++) {
+                const uint8_t* src = planes[c - 1] + r * vs * fStride;
+                if (1 == hs && 1 == vs) {
+                    fRows[c][r] = const_cast<uint8_t*>(src);
+                    continue;
+                }
+                uint8_t* dst = outputs[c - 1] + r * fLayout.fPaddedWidth[c];
+                // Like libjpeg, alternate the rounding so as not to drift in either direction.
+                if (2 == vs) {
+                    const uint8_t* below = src + fStride;
+                    for (int x = 0; x < fLayout.fPaddedWidth[c]; x++) {
+                        dst[x] = (uint8_t)((src[2 * x] + src[2 * x + 1] + below[2 * x] +
+                                            below[2 * x + 1] + 1 + (x & 1)) >> 2);
+                    }
+                } else {
+                    for (int x = 0; x < fLayout.fPaddedWidth[c]; x++) {
+                        dst[x] = (uint8_t)((src[2 * x] + src[2 * x + 1] + (x & 1)) >> 1);
+                    }
+                }
+                fRows[c][r] = dst;
+            }
+            band[c] = fRows[c];
+        }
+    }
+
+private:
+    const SkPixmap&            fSrc;
+    const YCbCrLayout&         fLayout;
+    transform_scanline_proc    fProc;
+    SkOpts::Convert_8888_YCbCr fConvert;
+    const int                  fStride;      // Full resolution rows, padded to whole MCUs.
+    SkAutoTMalloc<uint8_t>     fStorage;
+    SkAutoTMalloc<uint32_t>    fConverted;   // fSrc's rows after fProc.
+    uint8_t*                   fY;
+    uint8_t*                   fCb;
+    uint8_t*                   fCr;
+    uint8_t*                   fCbOut = nullptr;
+    uint8_t*                   fCrOut = nullptr;
+    JSAMPROW                   fRows[3][2 * DCTSIZE];
+};
+
+/**
+ *  Supplies rows from Y, U and V planes, copying only those which need padding.
+ */
+class PlaneRows : SkNoncopyable {
+public:
+    PlaneRows(const uint8_t* const planes[3], const size_t rowBytes[3], const SkISize sizes[3],
+              const YCbCrLayout& layout)
+        : fLayout(layout)
+    {
+        size_t storage = 0;
+        for (int c = 0; c < 3; c++) {
+            fPlanes[c] = planes[c];
+            fRowBytes[c] = rowBytes[c];
+            fSizes[c] = sizes[c];
+            storage += layout.fPaddedWidth[c] * layout.fV[c] * DCTSIZE;
+        }
+        fStorage.reset(storage);
+    }
+
+    void fill(int top, JSAMPARRAY band[3]) {
+        uint8_t* dst = fStorage.get();
+        for (int c = 0; c < 3; c++) {
+            const int width  = fSizes[c].width(),
+                      padded = fLayout.fPaddedWidth[c],
+                      compTop = top * fLayout.fV[c] / fLayout.fV[0];
+            for (int r = 0; r < fLayout.fV[c] * DCTSIZE; r++) {
+                const int y = SkTMin(compTop + r, fSizes[c].height() - 1);
+                const uint8_t* src = fPlanes[c] + y * fRowBytes[c];
+                if (width == padded) {
+                    fRows[c][r] = const_cast<uint8_t*>(src);
+                } else {
+                    memcpy(dst, src, width);
+                    memset(dst + width, src[width - 1], padded - width);
+                    fRows[c][r] = dst;
+                }
+                dst += padded;
+            }
+            band[c] = fRows[c];
+        }
+    }
+
+private:
+    const YCbCrLayout&     fLayout;
+    const uint8_t*         fPlanes[3];
+    size_t                 fRowBytes[3];
+    SkISize                fSizes[3];
+    SkAutoTMalloc<uint8_t> fStorage;
+    JSAMPROW               fRows[3][2 * DCTSIZE];
+};
+
+/**
+ *  Encodes |height| rows of |rows|, starting at |top|, as a complete jpeg.
+ */
+template <typename Rows>
+static bool write_ycbcr(SkWStream* dst, const YCbCrLayout& layout, Rows* rows, int top,
+                        int height, int quality, bool optimizeCoding, int restartRows,
+                        const SkData* icc) {
+    std::unique_ptr<SkJpegEncoderMgr> encoderMgr = SkJpegEncoderMgr::Make(dst);
+
+    skjpeg_error_mgr::AutoPushJmpBuf jmp(encoderMgr->errorMgr());
+    if (setjmp(jmp)) {
+        return false;
+    }
+
+    encoderMgr->setRawParams(layout, height, quality, optimizeCoding, restartRows);
+    jpeg_start_compress(encoderMgr->cinfo(), TRUE);
+    if (icc) {
+        write_icc_marker(encoderMgr->cinfo(), icc);
+    }
+
+    JSAMPARRAY band[3];
+    for (int y = 0; y < height; y += layout.mcuHeight()) {
+        rows->fill(top + y, band);
+        jpeg_write_raw_data(encoderMgr->cinfo(), band, layout.mcuHeight());
+    }
+    jpeg_finish_compress(encoderMgr->cinfo());
+    return true;
+}
+
+/**
+ *  Returns where the entropy coded data after the SOS segment of |data| starts, and where its
+ *  SOF segment is in |sof|, or 0 if they can't be found.
+ */
+static size_t find_scan(const uint8_t* data, size_t size, size_t* sof) {
+    size_t offset = 2;  // Skip SOI.
+    while (offset + 4 <= size && 0xFF == data[offset]) {
+        const uint8_t marker = data[offset + 1];
+        if (marker >= 0xC0 && marker <= 0xC2) {
+            *sof = offset;
+        }
+        offset += 2 + ((data[offset + 2] << 8) | data[offset + 3]);
+        if (0xDA == marker) {
+            return offset <= size ? offset : 0;
+        }
+    }
+    return 0;
+}
+
+/**
+ *  Joins jpegs of consecutive strips of an image, each of which ends on a restart boundary,
+ *  into one: the first strip's headers with the height of the whole image, then every strip's
+ *  entropy coded data, with its restart markers renumbered to follow on from the strip before
+ *  and another between strips.
+ */
+static bool join_strips(SkWStream* dst, SkDynamicMemoryWStream strips[], int count,
+                        int height) {
+    int restarts = 0;
+    auto writeRestart = [&]() {
+        return dst->write8(0xFF) && dst->write8(0xD0 + (restarts++ & 7));
+    };
+    for (int i = 0; i < count; i++) {
+        sk_sp<SkData> strip = strips[i].detachAsData();
+        const uint8_t* data = strip->bytes();
+        const size_t size = strip->size();
+        size_t sof = 0,
+               scan = find_scan(data, size, &sof);
+        if (!scan || !sof || size < scan + 2 || 0xFF != data[size - 2] || 0xD9 != data[size - 1]) {
+            return false;
+        }
+        if (0 == i) {
+            // The height follows the SOF marker, its length, and the sample precision.
+            const size_t heightOffset = sof + 5;
+            if (!dst->write(data, heightOffset) ||
+                !dst->write8(height >> 8) || !dst->write8(height & 0xFF) ||
+                !dst->write(data + heightOffset + 2, scan - heightOffset - 2)) {
+                return false;
+            }
+        }
+
+        const uint8_t* run = data + scan;
+        const uint8_t* end = data + size - 2;
+        for (const uint8_t* p = run; p + 1 < end; p++) {
+            if (0xFF == p[0] && p[1] >= 0xD0 && p[1] <= 0xD7) {
+                if (!dst->write(run, p - run) || !writeRestart()) {
+                    return false;
+                }
+                run = ++p + 1;
+            }
+        }
+        if (!dst->write(run, end - run) || (i + 1 < count && !writeRestart())) {
+            return false;
+        }
+    }
+    return dst->write8(0xFF) && dst->write8(0xD9);
+}
+
+/**
+ *  Encodes an image through |writeStrip|, which encodes |height| rows starting at |top| as a
+ *  complete jpeg.  With options.fExecutor, large images are split into strips which are
+ *  encoded concurrently and then joined.
+ */
+using WriteStripProc = std::function<bool(SkWStream*, int top, int height, bool optimizeCoding,
+                                          int restartRows)>;
+static bool encode_strips(SkWStream* dst, const YCbCrLayout& layout,
+                          const SkJpegEncoder::Options& options, const WriteStripProc& writeStrip) {
+    const int restartRows = SkTPin(options.fRestartRows, 0, 0xFFFF),
+              mcuRows = layout.mcuRows(),
+              mcusPerRow = layout.mcusPerRow();
+    int strips = SkTMin(kMaxStrips, layout.fHeight / SK_JPEG_ENCODER_MIN_STRIP_ROWS);
+    if (!options.fExecutor || strips < 2) {
+        return writeStrip(dst, 0, layout.fHeight, true, restartRows);
+    }
+
+    // Strips must end on restart boundaries, and libjpeg caps the interval at 65535 MCUs, so
+    // each strip is a whole number of restart intervals which fit under that.
+    int stripMCURows = (mcuRows + strips - 1) / strips,
+        interval = restartRows;
+    if (restartRows) {
+        if ((int64_t)restartRows * mcusPerRow > 0xFFFF) {
+            return writeStrip(dst, 0, layout.fHeight, true, restartRows);
+        }
+        stripMCURows = (stripMCURows + restartRows - 1) / restartRows * restartRows;
+    } else {
+        stripMCURows = SkTMin(stripMCURows, 0xFFFF / mcusPerRow);
+        interval = stripMCURows;
+    }
+    if (0 == stripMCURows || stripMCURows >= mcuRows) {
+        return writeStrip(dst, 0, layout.fHeight, true, restartRows);
+    }
+    strips = (mcuRows + stripMCURows - 1) / stripMCURows;
+
+    // The strips' Huffman tables must match, so they can't be optimized for each strip.
+    SkAutoTArray<SkDynamicMemoryWStream> encoded(strips);
+    std::atomic<bool> failed{false};
+    SkTaskGroup(*options.fExecutor).batch(strips, [&](int i) {
+        const int top = i * stripMCURows * layout.mcuHeight(),
+                  height = SkTMin(stripMCURows * layout.mcuHeight(), layout.fHeight - top);
+        if (!writeStrip(&encoded[i], top, height, false, interval)) {
+            failed.store(true, std::memory_order_relaxed);
+        }
+    });
+    return !failed.load() && join_strips(dst, encoded.get(), strips, layout.fHeight);
+}
+
+static bool encode_ycbcr(SkWStream* dst, const SkPixmap& src,
+                         const SkJpegEncoder::Options& options) {
+    transform_scanline_proc proc = nullptr;
+    const bool blend = kUnpremul_SkAlphaType == src.alphaType() &&
+                       SkJpegEncoder::AlphaOption::kBlendOnBlack == options.fAlphaOption;
+    switch (src.colorType()) {
+        case kRGBA_8888_SkColorType:
+        case kBGRA_8888_SkColorType:
+            proc = blend ? transform_scanline_to_premul_legacy : nullptr;
+            break;
+        case kRGBA_F16_SkColorType:
+            proc = blend ? transform_scanline_F16_to_premul_8888 : transform_scanline_F16_to_8888;
+            break;
+        default:
+            SkASSERT(false);
+            return false;
+    }
+    const SkOpts::Convert_8888_YCbCr convert = kBGRA_8888_SkColorType == src.colorType()
+                                             ? SkOpts::BGRA_to_YCbCr : SkOpts::RGBA_to_YCbCr;
+
+    int hSamp = 1, vSamp = 1;
+    switch (options.fDownsample) {
+        case SkJpegEncoder::Downsample::k420: hSamp = 2; vSamp = 2; break;
+        case SkJpegEncoder::Downsample::k422: hSamp = 2; vSamp = 1; break;
+        case SkJpegEncoder::Downsample::k444:                       break;
+    }
+    const YCbCrLayout layout(src.width(), src.height(), hSamp, vSamp);
+    sk_sp<SkData> icc = icc_from_color_space(src.info());
+
+    return encode_strips(dst, layout, options,
+                         [&](SkWStream* stream, int top, int height, bool optimize, int restart) {
+        PixelRows rows(src, layout, proc, convert);
+        return write_ycbcr(stream, layout, &rows, top, height, options.fQuality, optimize,
+                           restart, 0 == top ? icc.get() : nullptr);
+    });
+}
+
 bool SkJpegEncoder::Encode(SkWStream* dst, const SkPixmap& src, const Options& options) {
+    if (options.fExecutor && SkPixmapIsValid(src)) {
+        switch (src.colorType()) {
+            case kRGBA_8888_SkColorType:
+            case kBGRA_8888_SkColorType:
+            case kRGBA_F16_SkColorType:
+                return encode_ycbcr(dst, src, options);
+            default:
+                break;
+        }
+    }
+
     auto encoder = SkJpegEncoder::Make(dst, src, options);
     return encoder.get() && encoder->encodeRows(src.height());
 }
 
+bool SkJpegEncoder::EncodeYUV(SkWStream* dst, const SkYUVASizeInfo& sizeInfo,
+                              const SkYUVAIndex yuvaIndices[4], const void* const planes[4],
+                              SkYUVColorSpace colorSpace, const Options& options) {
+    int numPlanes;
+    if (kJPEG_SkYUVColorSpace != colorSpace ||
+        !SkYUVAIndex::AreValidIndices(yuvaIndices, &numPlanes)) {
+        return false;
+    }
+
+    const uint8_t* yuvPlanes[3];
+    size_t rowBytes[3];
+    SkISize sizes[3];
+    for (int c = 0; c < 3; c++) {
+        const int index = yuvaIndices[c].fIndex;
+        yuvPlanes[c] = static_cast<const uint8_t*>(planes[index]);
+        rowBytes[c] = sizeInfo.fWidthBytes[index];
+        sizes[c] = sizeInfo.fSizes[index];
+        if (!yuvPlanes[c] || sizes[c].isEmpty() || rowBytes[c] < (size_t)sizes[c].width()) {
+            return false;
+        }
+    }
+
+    // Each chroma dimension is either full size or half (rounded up), which is how libjpeg
+    // downsamples too.
+    auto samp = [](int luma, int chroma) {
+        return chroma == luma ? 1 : chroma == (luma + 1) / 2 ? 2 : 0;
+    };
+    const int hSamp = samp(sizes[0].width(),  sizes[1].width()),
+              vSamp = samp(sizes[0].height(), sizes[1].height());
+    if (!hSamp || !vSamp || sizes[1] != sizes[2]) {
+        return false;
+    }
+    const YCbCrLayout layout(sizes[0].width(), sizes[0].height(), hSamp, vSamp);
+
+    return encode_strips(dst, layout, options,
+                         [&](SkWStream* stream, int top, int height, bool optimize, int restart) {
+        PlaneRows rows(yuvPlanes, rowBytes, sizes, layout);
+        return write_ycbcr(stream, layout, &rows, top, height, options.fQuality, optimize,
+                           restart, nullptr);
+    });
+}
+
 #endif
@@ -10,15 +10,21 @@
 #ifdef SK_HAS_PNG_LIBRARY
 
 #include "SkColorTable.h"
+#include "SkEndian.h"
+#include "SkExecutor.h"
 #include "SkImageEncoderFns.h"
 #include "SkImageInfoPriv.h"
+#include "SkOpts.h"
 #include "SkStream.h"
 #include "SkString.h"
 #include "SkPngEncoder.h"
 #include "SkPngPriv.h"
+#include "SkTaskGroup.h"
+#include <atomic>
 #include <vector>
 
 #include "png.h"
+#include "zlib.h"
 
 static_assert(PNG_FILTER_NONE  == (int)SkPngEncoder::FilterFlag::kNone,  "Skia libpng filter err.");
 static_assert(PNG_FILTER_SUB   == (int)SkPngEncoder::FilterFlag::kSub,   "Skia libpng filter err.");
@@ -58,26 +64,85 @@ public:
     bool writeInfo(const SkImageInfo& srcInfo);
     void chooseProc(const SkImageInfo& srcInfo);
 
+    /*
+     * Filters and compresses rows, continuing one zlib stream, and writes them as IDAT chunks.
+     * Must be called within a setjmp.
+     */
+    bool writeRows(const SkPixmap& src, int startRow, int numRows);
+
+    /*
+     * Like writeRows(), but filters and compresses rows in chunks on fExecutor.
+     */
+    bool writeRowsInParallel(const SkPixmap& src, int startRow, int numRows);
+
+    /*
+     * Writes the IEND chunk, once all the rows are written.  Must be called within a setjmp.
+     */
+    void writeEnd();
+
     png_structp pngPtr() { return fPngPtr; }
     png_infop infoPtr() { return fInfoPtr; }
-    int pngBytesPerPixel() const { return fPngBytesPerPixel; }
-    transform_scanline_proc proc() const { return fProc; }
+    SkExecutor* executor() const { return fExecutor; }
 
     ~SkPngEncoderMgr() {
+        if (fRowFilter) {
+            deflateEnd(&fZStream);
+        }
         png_destroy_write_struct(&fPngPtr, &fInfoPtr);
     }
 
 private:
+    // Transforms rows of a pixmap into png rows and filters them, keeping each row to filter the
+    // next one against.
+    class RowFilter {
+    public:
+        // Ready to filter row y.
+        RowFilter(const SkPngEncoderMgr* mgr, const SkPixmap& src, int y);
+
+        // Writes the filter type and filtered bytes of the next row to dst.
+        void filterNext(uint8_t* dst);
+
+    private:
+        const SkPngEncoderMgr*  fMgr;
+        const SkPixmap&         fSrc;
+        int                     fY;
+        SkAutoTMalloc<uint8_t>  fBuffers;
+        uint8_t*                fStorage;
+        uint8_t*                fPrev;
+        uint8_t*                fRow;
+        uint8_t*                fScratch;
+    };
 
     SkPngEncoderMgr(png_structp pngPtr, png_infop infoPtr)
         : fPngPtr(pngPtr)
         , fInfoPtr(infoPtr)
     {}
 
+    // Transforms a row of src into the bytes of a png row.
+    void transformRow(uint8_t* dst, const SkPixmap& src, int y, uint8_t* storage) const;
+
+    int zlibStrategy() const;
+
     png_structp             fPngPtr;
     png_infop               fInfoPtr;
     int                     fPngBytesPerPixel;
     transform_scanline_proc fProc;
+
+    size_t                  fRowBytes = 0;    // Of a png row.
+    size_t                  fFilterBPP = 0;   // Bytes per pixel of a png row, at least 1.
+    int                     fFilters = 0;
+    int                     fZLibLevel = 0;
+    bool                    fZLibRLE = false;
+
+    // State for writeRows().
+    std::unique_ptr<RowFilter> fRowFilter;
+    z_stream                   fZStream;
+    SkAutoTMalloc<uint8_t>     fFiltered;
+    SkAutoTMalloc<uint8_t>     fIDAT;
+
+    // State for writeRowsInParallel().
+    SkExecutor*             fExecutor = nullptr;
+    uLong                   fAdler = 1;
 };
 
 std::unique_ptr<SkPngEncoderMgr> SkPngEncoderMgr::Make(SkWStream* stream) {
@@ -200,6 +265,13 @@ bool SkPngEncoderMgr::setHeader(const SkImageInfo& srcInfo, const SkPngEncoder::
     SkASSERT(zlibLevel == options.fZLibLevel);
     png_set_compression_level(fPngPtr, zlibLevel);
 
+    fRowBytes = png_get_rowbytes(fPngPtr, fInfoPtr);
+    fFilterBPP = SkTMax(1, png_get_channels(fPngPtr, fInfoPtr) * bitDepth / 8);
+    fFilters = filters;
+    fZLibLevel = zlibLevel;
+    fZLibRLE = SkPngEncoder::Options::ZLibStrategy::kRLE == options.fZLibStrategy;
+    fExecutor = options.fExecutor;
+
     // Set comments in tEXt chunk
     const sk_sp<SkDataTable>& comments = options.fComments;
     if (comments != nullptr) {
@@ -352,14 +424,6 @@ bool SkPngEncoderMgr::writeInfo(const SkImageInfo& srcInfo) {
     }
 
     png_write_info(fPngPtr, fInfoPtr);
-    if (kRGBA_F16_SkColorType == srcInfo.colorType() &&
-        kOpaque_SkAlphaType == srcInfo.alphaType())
-    {
-        // For kOpaque, kRGBA_F16, we will keep the row as RGBA and tell libpng
-        // to skip the alpha channel.
-        png_set_filler(fPngPtr, 0, PNG_FILLER_AFTER);
-    }
-
     return true;
 }
 
@@ -367,6 +431,245 @@ void SkPngEncoderMgr::chooseProc(const SkImageInfo& srcInfo) {
     fProc = choose_proc(srcInfo);
 }
 
+// When encoding in parallel, rows are compressed in chunks of about this many filtered bytes.
+static constexpr size_t kParallelChunkBytes = 128 * 1024;
+
+// Each chunk's compressor is primed with up to this much of the data before it, all of deflate's
+// window, so chunks compress nearly as well as one stream.
+static constexpr size_t kDictionaryBytes = 32 * 1024;
+
+// Like libpng, we write IDAT chunks of up to this many bytes.
+static constexpr size_t kIDATBytes = 8192;
+
+static void filter_row(int type, uint8_t* dst, const uint8_t* row, const uint8_t* prev,
+                       size_t rowBytes, size_t bpp) {
+    dst[0] = type;
+    dst++;
+    switch (type) {
+        case PNG_FILTER_VALUE_NONE:  memcpy(dst, row, rowBytes);                           break;
+        case PNG_FILTER_VALUE_SUB:   SkOpts::png_filter_sub  (dst, row, prev, rowBytes, bpp); break;
+        case PNG_FILTER_VALUE_UP:    SkOpts::png_filter_up   (dst, row, prev, rowBytes, bpp); break;
+        case PNG_FILTER_VALUE_AVG:   SkOpts::png_filter_avg  (dst, row, prev, rowBytes, bpp); break;
+        case PNG_FILTER_VALUE_PAETH: SkOpts::png_filter_paeth(dst, row, prev, rowBytes, bpp); break;
+    }
+}
+
+// Filters |row| into |dst|, which gets the filter type byte followed by the filtered row. Like
+// libpng, when several filters are allowed, picks the one whose output, taken as signed bytes, has
+// the smallest sum of absolute values. |scratch| holds a filtered row.
+static void filter_row(int filters, uint8_t* dst, const uint8_t* row, const uint8_t* prev,
+                       size_t rowBytes, size_t bpp, uint8_t* scratch) {
+    size_t bestCost = SIZE_MAX;
+    for (int type = PNG_FILTER_VALUE_NONE; type < PNG_FILTER_VALUE_LAST; type++) {
+        if (!(filters & (PNG_FILTER_NONE << type))) {
+            continue;
+        }
+        if (filters == (PNG_FILTER_NONE << type)) {
+            filter_row(type, dst, row, prev, rowBytes, bpp);
+            return;
+        }
+        // Filter into whichever of dst and scratch doesn't hold the best row so far.
+        uint8_t* filtered = SIZE_MAX == bestCost ? dst : scratch;
+        filter_row(type, filtered, row, prev, rowBytes, bpp);
+        size_t cost = SkOpts::png_filter_cost(filtered + 1, rowBytes);
+        if (cost < bestCost) {
+            bestCost = cost;
+            if (filtered != dst) {
+                memcpy(dst, scratch, rowBytes + 1);
+            }
+        }
+    }
+    if (SIZE_MAX == bestCost) {
+        filter_row(PNG_FILTER_VALUE_NONE, dst, row, prev, rowBytes, bpp);
+    }
+}
+
+// Compresses |size| bytes as raw deflate data continuing a stream which so far held |dict|. Ends
+// with a sync flush, so that more data can follow, or with the final block if |last|.
+static bool deflate_chunk(const uint8_t* data, size_t size, const uint8_t* dict, size_t dictSize,
+                          int level, int strategy, bool last, SkWStream* dst) {
+    z_stream zStream;
+    sk_bzero(&zStream, sizeof(zStream));
+    if (Z_OK != deflateInit2(&zStream, level, Z_DEFLATED, -15, 8, strategy)) {
+        return false;
+    }
+    bool ok = !dictSize || Z_OK == deflateSetDictionary(&zStream, dict, SkToUInt(dictSize));
+    zStream.next_in = const_cast<uint8_t*>(data);
+    zStream.avail_in = SkToUInt(size);
+    uint8_t buffer[4096];
+    while (ok) {
+        zStream.next_out = buffer;
+        zStream.avail_out = sizeof(buffer);
+        int result = deflate(&zStream, last ? Z_FINISH : Z_SYNC_FLUSH);
+        ok = (Z_OK == result || Z_STREAM_END == result || Z_BUF_ERROR == result) &&
+             dst->write(buffer, sizeof(buffer) - zStream.avail_out);
+        if (last ? Z_STREAM_END == result : zStream.avail_out != 0) {
+            break;
+        }
+    }
+    deflateEnd(&zStream);
+    return ok;
+}
+
+void SkPngEncoderMgr::transformRow(uint8_t* dst, const SkPixmap& src, int y,
+                                   uint8_t* storage) const {
+    const int srcBPP = SkColorTypeBytesPerPixel(src.colorType());
+    if ((size_t) fPngBytesPerPixel == fFilterBPP) {
+        fProc((char*) dst, (const char*) src.addr(0, y), src.width(), srcBPP);
+        return;
+    }
+
+    // The row has 16 bit filler after each pixel, which libpng would strip (png_set_filler).
+    SkASSERT((size_t) fPngBytesPerPixel == fFilterBPP + 2);
+    fProc((char*) storage, (const char*) src.addr(0, y), src.width(), srcBPP);
+    for (int x = 0; x < src.width(); x++) {
+        memcpy(dst + x * fFilterBPP, storage + x * fPngBytesPerPixel, fFilterBPP);
+    }
+}
+
+SkPngEncoderMgr::RowFilter::RowFilter(const SkPngEncoderMgr* mgr, const SkPixmap& src, int y)
+    : fMgr(mgr)
+    , fSrc(src)
+    , fY(y)
+    // 16 bit rows are transformed with 16 bit stores, so keep them aligned.
+    , fBuffers(src.width() * mgr->fPngBytesPerPixel + 3 * mgr->fRowBytes + 1)
+{
+    fStorage = fBuffers.get();
+    fPrev    = fStorage + src.width() * mgr->fPngBytesPerPixel;
+    fRow     = fPrev + mgr->fRowBytes;
+    fScratch = fRow + mgr->fRowBytes;
+    if (y > 0) {
+        fMgr->transformRow(fPrev, fSrc, y - 1, fStorage);
+    } else {
+        sk_bzero(fPrev, mgr->fRowBytes);
+    }
+}
+
+void SkPngEncoderMgr::RowFilter::filterNext(uint8_t* dst) {
+    fMgr->transformRow(fRow, fSrc, fY++, fStorage);
+    filter_row(fMgr->fFilters, dst, fRow, fPrev, fMgr->fRowBytes, fMgr->fFilterBPP, fScratch);
+    std::swap(fPrev, fRow);
+}
+
+int SkPngEncoderMgr::zlibStrategy() const {
+    if (fZLibRLE) {
+        return Z_RLE;
+    }
+    // Like libpng, let zlib know when the data has been filtered.
+    return fFilters == PNG_FILTER_NONE ? Z_DEFAULT_STRATEGY : Z_FILTERED;
+}
+
+bool SkPngEncoderMgr::writeRows(const SkPixmap& src, int startRow, int numRows) {
+    const size_t filteredRowBytes = fRowBytes + 1;
+    if (!fRowFilter) {
+        SkASSERT(0 == startRow);
+        sk_bzero(&fZStream, sizeof(fZStream));
+        if (Z_OK != deflateInit2(&fZStream, fZLibLevel, Z_DEFLATED, 15, 8, this->zlibStrategy())) {
+            return false;
+        }
+        fRowFilter.reset(new RowFilter(this, src, startRow));
+        fFiltered.reset(filteredRowBytes);
+        fIDAT.reset(kIDATBytes);
+        fZStream.next_out = fIDAT.get();
+        fZStream.avail_out = kIDATBytes;
+    }
+
+    auto writeIDAT = [this] {
+        if (kIDATBytes != fZStream.avail_out) {
+            png_write_chunk(fPngPtr, (png_const_bytep) "IDAT", fIDAT.get(),
+                            kIDATBytes - fZStream.avail_out);
+        }
+        fZStream.next_out = fIDAT.get();
+        fZStream.avail_out = kIDATBytes;
+    };
+    for (int y = startRow; y < startRow + numRows; y++) {
+        fRowFilter->filterNext(fFiltered.get());
+        const bool last = y == src.height() - 1;
+        fZStream.next_in = fFiltered.get();
+        fZStream.avail_in = SkToUInt(filteredRowBytes);
+        while (true) {
+            int result = deflate(&fZStream, last ? Z_FINISH : Z_NO_FLUSH);
+            if (Z_OK != result && Z_STREAM_END != result && Z_BUF_ERROR != result) {
+                return false;
+            }
+            // Without flushing, deflate() only stops short of filling the output when it has
+            // taken all the input.
+            bool done = last ? Z_STREAM_END == result : 0 != fZStream.avail_out;
+            if (0 == fZStream.avail_out || (last && done)) {
+                writeIDAT();
+            }
+            if (done) {
+                break;
+            }
+        }
+    }
+    return true;
+}
+
+bool SkPngEncoderMgr::writeRowsInParallel(const SkPixmap& src, int startRow, int numRows) {
+    const size_t filteredRowBytes = fRowBytes + 1;
+    const int rowsPerChunk = SkTMax<int>(1, kParallelChunkBytes / filteredRowBytes),
+              dictRows = SkToInt((kDictionaryBytes + filteredRowBytes - 1) / filteredRowBytes),
+              chunks = (numRows + rowsPerChunk - 1) / rowsPerChunk;
+    const bool finishes = startRow + numRows == src.height();
+    const int strategy = this->zlibStrategy();
+
+    SkAutoTArray<SkDynamicMemoryWStream> compressed(chunks);
+    SkAutoTArray<uLong> adlers(chunks);
+    SkAutoTArray<size_t> sizes(chunks);
+    std::atomic<bool> failed{false};
+    SkTaskGroup(*fExecutor).batch(chunks, [&](int i) {
+        // Filter the rows before this chunk too, to get the data to prime the compressor with.
+        const int top    = startRow + i * rowsPerChunk,
+                  bottom = SkTMin(top + rowsPerChunk, startRow + numRows),
+                  first  = SkTMax(0, top - dictRows);
+        SkAutoTMalloc<uint8_t> filtered((bottom - first) * filteredRowBytes);
+        RowFilter rowFilter(this, src, first);
+        for (int y = first; y < bottom; y++) {
+            rowFilter.filterNext(filtered.get() + (y - first) * filteredRowBytes);
+        }
+
+        size_t before = (top - first) * filteredRowBytes,
+               dictSize = SkTMin(before, kDictionaryBytes);
+        const uint8_t* data = filtered.get() + before;
+        sizes[i] = (bottom - top) * filteredRowBytes;
+        adlers[i] = adler32(adler32(0, nullptr, 0), data, SkToUInt(sizes[i]));
+        if (0 == top) {
+            // The zlib header: deflate with a 32K window, and roughly how hard we tried.
+            uint8_t cmf = 0x78,
+                    flg = (fZLibLevel < 2 ? 0 : fZLibLevel < 6 ? 1 : fZLibLevel == 6 ? 2 : 3) << 6;
+            flg += 31 - (cmf * 256 + flg) % 31;
+            compressed[i].write8(cmf);
+            compressed[i].write8(flg);
+        }
+        if (!deflate_chunk(data, sizes[i], data - dictSize, dictSize, fZLibLevel, strategy,
+                           finishes && i == chunks - 1, &compressed[i])) {
+            failed.store(true, std::memory_order_relaxed);
+        }
+    });
+    if (failed.load()) {
+        return false;
+    }
+
+    for (int i = 0; i < chunks; i++) {
+        fAdler = adler32_combine(fAdler, adlers[i], sizes[i]);
+    }
+    if (finishes) {
+        compressed[chunks - 1].write32(SkEndian_SwapBE32(SkToU32(fAdler)));
+    }
+    for (int i = 0; i < chunks; i++) {
+        sk_sp<SkData> data = compressed[i].detachAsData();
+        png_write_chunk(fPngPtr, (png_const_bytep) "IDAT", data->bytes(), data->size());
+    }
+    return true;
+}
+
+void SkPngEncoderMgr::writeEnd() {
+    // We wrote the IDATs ourselves, so libpng's png_write_end() would think there were none.
+    // Any comments were written before them, so all that's left is the IEND.
+    png_write_chunk(fPngPtr, (png_const_bytep) "IEND", nullptr, 0);
+}
+
 std::unique_ptr<SkEncoder> SkPngEncoder::Make(SkWStream* dst, const SkPixmap& src,
                                               const Options& options) {
     if (!SkPixmapIsValid(src)) {
@@ -396,7 +699,7 @@ std::unique_ptr<SkEncoder> SkPngEncoder::Make(SkWStream* dst, const SkPixmap& sr
 }
 
 SkPngEncoder::SkPngEncoder(std::unique_ptr<SkPngEncoderMgr> encoderMgr, const SkPixmap& src)
-    : INHERITED(src, encoderMgr->pngBytesPerPixel() * src.width())
+    : INHERITED(src, 0)  // The manager keeps its own row buffers.
     , fEncoderMgr(std::move(encoderMgr))
 {}
 
@@ -407,21 +710,16 @@ bool SkPngEncoder::onEncodeRows(int numRows) {
         return false;
     }
 
-    const void* srcRow = fSrc.addr(0, fCurrRow);
-    for (int y = 0; y < numRows; y++) {
-        fEncoderMgr->proc()((char*)fStorage.get(),
-                            (const char*)srcRow,
-                            fSrc.width(),
-                            SkColorTypeBytesPerPixel(fSrc.colorType()));
-
-        png_bytep rowPtr = (png_bytep) fStorage.get();
-        png_write_rows(fEncoderMgr->pngPtr(), &rowPtr, 1);
-        srcRow = SkTAddOffset<const void>(srcRow, fSrc.rowBytes());
+    bool success = fEncoderMgr->executor()
+                 ? fEncoderMgr->writeRowsInParallel(fSrc, fCurrRow, numRows)
+                 : fEncoderMgr->writeRows(fSrc, fCurrRow, numRows);
+    if (!success) {
+        return false;
     }
 
     fCurrRow += numRows;
     if (fCurrRow == fSrc.height()) {
-        png_write_end(fEncoderMgr->pngPtr(), fEncoderMgr->infoPtr());
+        fEncoderMgr->writeEnd();
     }
 
     return true;
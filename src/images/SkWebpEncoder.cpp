@@ -20,8 +20,10 @@
 
 #include "SkBitmap.h"
 #include "SkColorData.h"
+#include "SkExecutor.h"
 #include "SkImageEncoderFns.h"
 #include "SkStream.h"
+#include "SkTaskGroup.h"
 #include "SkTemplates.h"
 #include "SkUnPreMultiply.h"
 #include "SkUTF.h"
@@ -103,7 +105,9 @@ static int stream_writer(const uint8_t* data, size_t data_size,
   return stream->write(data, data_size) ? 1 : 0;
 }
 
-bool SkWebpEncoder::Encode(SkWStream* stream, const SkPixmap& pixmap, const Options& opts) {
+// Encodes |pixmap| as a still webp, without any color profile.
+static bool encode_pixels(SkWStream* stream, const SkPixmap& pixmap,
+                          const SkWebpEncoder::Options& opts) {
     if (!SkPixmapIsValid(pixmap)) {
         return false;
     }
@@ -138,9 +142,8 @@ bool SkWebpEncoder::Encode(SkWStream* stream, const SkPixmap& pixmap, const Opti
 
     // Set compression, method, and pixel format.
     // libwebp recommends using BGRA for lossless and YUV for lossy.
-    // The choices of |webp_config.method| currently just match Chrome's defaults.  We
-    // could potentially expose this decision to the client.
-    if (Compression::kLossy == opts.fCompression) {
+    // The default choices of |webp_config.method| currently just match Chrome's defaults.
+    if (SkWebpEncoder::Compression::kLossy == opts.fCompression) {
         webp_config.lossless = 0;
 #ifndef SK_WEBP_ENCODER_USE_DEFAULT_METHOD
         webp_config.method = 3;
@@ -151,13 +154,12 @@ bool SkWebpEncoder::Encode(SkWStream* stream, const SkPixmap& pixmap, const Opti
         webp_config.method = 0;
         pic.use_argb = 1;
     }
+    if (opts.fMethod >= 0) {
+        webp_config.method = SkTMin(opts.fMethod, 6);
+    }
+    webp_config.thread_level = opts.fMultithreaded ? 1 : 0;
 
-    // If there is no need to embed an ICC profile, we write directly to the input stream.
-    // Otherwise, we will first encode to |tmp| and use a mux to add the ICC chunk.  libwebp
-    // forces us to have an encoded image before we can add a profile.
-    sk_sp<SkData> icc = icc_from_color_space(pixmap.info());
-    SkDynamicMemoryWStream tmp;
-    pic.custom_ptr = icc ? (void*)&tmp : (void*)stream;
+    pic.custom_ptr = (void*)stream;
 
     const uint8_t* src = (uint8_t*)pixmap.addr();
     const int rgbStride = pic.width * bpp;
@@ -186,34 +188,105 @@ bool SkWebpEncoder::Encode(SkWStream* stream, const SkPixmap& pixmap, const Opti
         return false;
     }
 
-    if (!WebPEncode(&webp_config, &pic)) {
-        return false;
-    }
+    return WebPEncode(&webp_config, &pic);
+}
 
+// Adds |icc|, if there is one, and writes the result to |stream|.
+static bool assemble(SkWStream* stream, WebPMux* mux, const SkData* icc) {
     if (icc) {
-        sk_sp<SkData> encodedData = tmp.detachAsData();
-        WebPData encoded = { encodedData->bytes(), encodedData->size() };
         WebPData iccChunk = { icc->bytes(), icc->size() };
-
-        SkAutoTCallVProc<WebPMux, WebPMuxDelete> mux(WebPMuxNew());
-        if (WEBP_MUX_OK != WebPMuxSetImage(mux, &encoded, 0)) {
+        if (WEBP_MUX_OK != WebPMuxSetChunk(mux, "ICCP", &iccChunk, 0)) {
             return false;
         }
+    }
 
-        if (WEBP_MUX_OK != WebPMuxSetChunk(mux, "ICCP", &iccChunk, 0)) {
+    WebPData assembled;
+    if (WEBP_MUX_OK != WebPMuxAssemble(mux, &assembled)) {
+        return false;
+    }
+
+    bool success = stream->write(assembled.bytes, assembled.size);
+    WebPDataClear(&assembled);
+    return success;
+}
+
+bool SkWebpEncoder::Encode(SkWStream* stream, const SkPixmap& pixmap, const Options& opts) {
+    // If there is no need to embed an ICC profile, we write directly to the input stream.
+    // Otherwise, we will first encode to |tmp| and use a mux to add the ICC chunk.  libwebp
+    // forces us to have an encoded image before we can add a profile.
+    sk_sp<SkData> icc = icc_from_color_space(pixmap.info());
+    if (!icc) {
+        return encode_pixels(stream, pixmap, opts);
+    }
+
+    SkDynamicMemoryWStream tmp;
+    if (!encode_pixels(&tmp, pixmap, opts)) {
+        return false;
+    }
+
+    sk_sp<SkData> encodedData = tmp.detachAsData();
+    WebPData encoded = { encodedData->bytes(), encodedData->size() };
+    SkAutoTCallVProc<WebPMux, WebPMuxDelete> mux(WebPMuxNew());
+    if (WEBP_MUX_OK != WebPMuxSetImage(mux, &encoded, 0)) {
+        return false;
+    }
+    return assemble(stream, mux, icc.get());
+}
+
+bool SkWebpEncoder::EncodeAnimated(SkWStream* stream, const Frame frames[], int frameCount,
+                                   const Options& opts) {
+    if (frameCount < 1) {
+        return false;
+    }
+    const SkISize size = frames[0].fPixmap.info().dimensions();
+    for (int i = 0; i < frameCount; i++) {
+        if (frames[i].fPixmap.info().dimensions() != size) {
             return false;
         }
+    }
 
-        WebPData assembled;
-        if (WEBP_MUX_OK != WebPMuxAssemble(mux, &assembled)) {
-            return false;
+    // The frames don't depend on each other, so they can all be encoded at once.
+    SkAutoTArray<SkDynamicMemoryWStream> encoded(frameCount);
+    std::unique_ptr<bool[]> succeeded(new bool[frameCount]);
+    auto encodeFrame = [&](int i) {
+        succeeded[i] = encode_pixels(&encoded[i], frames[i].fPixmap, opts);
+    };
+    if (opts.fExecutor) {
+        SkTaskGroup(*opts.fExecutor).batch(frameCount, encodeFrame);
+    } else {
+        for (int i = 0; i < frameCount; i++) {
+            encodeFrame(i);
         }
+    }
 
-        stream->write(assembled.bytes, assembled.size);
-        WebPDataClear(&assembled);
+    SkAutoTCallVProc<WebPMux, WebPMuxDelete> mux(WebPMuxNew());
+    for (int i = 0; i < frameCount; i++) {
+        if (!succeeded[i]) {
+            return false;
+        }
+        sk_sp<SkData> data = encoded[i].detachAsData();
+        WebPMuxFrameInfo frame;
+        frame.bitstream = { data->bytes(), data->size() };
+        frame.x_offset = 0;
+        frame.y_offset = 0;
+        frame.duration = frames[i].fDuration;
+        frame.id = WEBP_CHUNK_ANMF;
+        frame.dispose_method = WEBP_MUX_DISPOSE_NONE;
+        frame.blend_method = WEBP_MUX_NO_BLEND;
+        // Copies the bitstream, so |data| may go.
+        if (WEBP_MUX_OK != WebPMuxPushFrame(mux, &frame, 1)) {
+            return false;
+        }
     }
 
-    return true;
+    WebPMuxAnimParams params;
+    params.bgcolor = 0;
+    params.loop_count = 0;  // Forever.
+    if (WEBP_MUX_OK != WebPMuxSetAnimationParams(mux, &params)) {
+        return false;
+    }
+    sk_sp<SkData> icc = icc_from_color_space(frames[0].fPixmap.info());
+    return assemble(stream, mux, icc.get());
 }
 
 #endif
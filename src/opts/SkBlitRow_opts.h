@@ -9,6 +9,7 @@
 #define SkBlitRow_opts_DEFINED
 
 #include "SkColorData.h"
+#include "SkHalf.h"
 #include "SkMSAN.h"
 
 #if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE2
@@ -38,6 +39,28 @@
     }
 #endif
 
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SKX
+    // The same math as SkPMSrcOver_SSE2, 16 pixels at a time.  (Needs AVX-512BW.)
+    static inline __m512i SkPMSrcOver_AVX512(const __m512i& src, const __m512i& dst) {
+        const __m512i mask = _mm512_set1_epi32(0xFF00FF);
+        __m512i scale = _mm512_sub_epi32(_mm512_set1_epi32(256), _mm512_srli_epi32(src, 24)),
+                s     = _mm512_or_si512(_mm512_slli_epi32(scale, 16), scale);
+
+        // uint32_t rb = ((dst & mask) * scale) >> 8
+        __m512i rb = _mm512_and_si512(mask, dst);
+        rb = _mm512_mullo_epi16(rb, s);
+        rb = _mm512_srli_epi16(rb, 8);
+
+        // uint32_t ag = ((dst >> 8) & mask) * scale
+        __m512i ag = _mm512_srli_epi16(dst, 8);
+        ag = _mm512_mullo_epi16(ag, s);
+
+        // (rb & mask) | (ag & ~mask)
+        ag = _mm512_andnot_si512(mask, ag);
+        return _mm512_add_epi32(src, _mm512_or_si512(rb, ag));
+    }
+#endif
+
 namespace SK_OPTS_NS {
 
 #if defined(SK_ARM_HAS_NEON)
@@ -84,7 +107,38 @@ void blit_row_s32a_opaque(SkPMColor* dst, const SkPMColor* src, int len, U8CPU a
     SkASSERT(alpha == 0xFF);
     sk_msan_assert_initialized(src, src+len);
 
-#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE41
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SKX
+    while (len >= 16) {
+        // Load 16 source pixels.
+        auto s = _mm512_loadu_si512(src);
+
+        const auto alphaMask = _mm512_set1_epi32(0xFF000000);
+
+        if (0 == _mm512_test_epi32_mask(s, alphaMask)) {
+            // All 16 source pixels are transparent.  Nothing to do.
+            src += 16;
+            dst += 16;
+            len -= 16;
+            continue;
+        }
+
+        if (0xFFFF == _mm512_cmpeq_epi32_mask(_mm512_and_si512(s, alphaMask), alphaMask)) {
+            // All 16 source pixels are opaque.  SrcOver becomes Src.
+            _mm512_storeu_si512(dst, s);
+            src += 16;
+            dst += 16;
+            len -= 16;
+            continue;
+        }
+
+        // Do SrcOver.
+        _mm512_storeu_si512(dst, SkPMSrcOver_AVX512(s, _mm512_loadu_si512(dst)));
+        src += 16;
+        dst += 16;
+        len -= 16;
+    }
+
+#elif SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE41
     while (len >= 16) {
         // Load 16 source pixels.
         auto s0 = _mm_loadu_si128((const __m128i*)(src) + 0),
@@ -245,6 +299,30 @@ void blit_row_s32a_opaque(SkPMColor* dst, const SkPMColor* src, int len, U8CPU a
     }
 }
 
+// Blends the premul color src into count F16 pixels as dst = src + dst*dstScale.  Coverage is
+// folded in by the caller, so this covers SrcOver (dstScale = 1 - src.a) and Src (1 - coverage).
+/*not static*/ inline
+void blit_row_color_f16(uint64_t* dst, int count, const float src[4], float dstScale) {
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_AVX2
+    // Haswell and up have F16C, so two pixels go through each 8-wide conversion.
+    const __m256 s = _mm256_broadcast_ps((const __m128*)src),
+                 k = _mm256_set1_ps(dstScale);
+    while (count >= 2) {
+        __m256 d = _mm256_cvtph_ps(_mm_loadu_si128((const __m128i*)dst));
+        _mm_storeu_si128((__m128i*)dst,
+                         _mm256_cvtps_ph(_mm256_fmadd_ps(d, k, s), _MM_FROUND_CUR_DIRECTION));
+        dst   += 2;
+        count -= 2;
+    }
+#endif
+    // On ARM64 these convert with the NEON fp16 instructions.
+    Sk4f color = Sk4f::Load(src);
+    for (int i = 0; i < count; ++i) {
+        SkFloatToHalf_finite_ftz(color + SkHalfToFloat_finite_ftz(dst[i]) * dstScale)
+                .store(dst + i);
+    }
+}
+
 }  // SK_OPTS_NS
 
 #endif//SkBlitRow_opts_DEFINED
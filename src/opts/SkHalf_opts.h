@@ -0,0 +1,104 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkHalf_opts_DEFINED
+#define SkHalf_opts_DEFINED
+
+#include "SkHalf.h"
+#include "SkNx.h"
+
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_AVX2
+    #include <immintrin.h>
+#elif defined(SK_ARM_HAS_NEON) && defined(SK_CPU_ARM32) && (__ARM_FP & 2)
+    #include <arm_neon.h>
+    #define SK_HALF_OPTS_VCVT
+#endif
+
+// Bulk conversions between half and single precision floats, with the semantics of
+// SkHalfToFloat_finite_ftz() and SkFloatToHalf_finite_ftz(): values must be finite, and halfs
+// that would be denormal may be flushed to zero. Like those, float -> half truncates, except on
+// ARM, whose conversion instructions round to nearest.
+
+namespace SK_OPTS_NS {
+
+    static inline Sk4f half_to_float_4(const uint16_t src[4]) {
+    #if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_AVX2
+        return _mm_cvtph_ps(_mm_loadl_epi64((const __m128i*)src));
+    #elif defined(SK_HALF_OPTS_VCVT)
+        return vcvt_f32_f16(vreinterpret_f16_u16(vld1_u16(src)));
+    #else
+        uint64_t h;
+        memcpy(&h, src, sizeof(h));
+        return SkHalfToFloat_finite_ftz(h);
+    #endif
+    }
+
+    static inline void float_to_half_4(uint16_t dst[4], const Sk4f& f) {
+    #if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_AVX2
+        _mm_storel_epi64((__m128i*)dst, _mm_cvtps_ph(f.fVec, _MM_FROUND_TO_ZERO));
+    #elif defined(SK_HALF_OPTS_VCVT)
+        vst1_u16(dst, vreinterpret_u16_f16(vcvt_f16_f32(f.fVec)));
+    #else
+        SkFloatToHalf_finite_ftz(f).store(dst);
+    #endif
+    }
+
+    /*not static*/ inline void half_to_float(float dst[], const uint16_t src[], int count) {
+    #if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_AVX2
+        while (count >= 8) {
+            _mm256_storeu_ps(dst, _mm256_cvtph_ps(_mm_loadu_si128((const __m128i*)src)));
+            dst   += 8;
+            src   += 8;
+            count -= 8;
+        }
+    #endif
+        while (count >= 4) {
+            half_to_float_4(src).store(dst);
+            dst   += 4;
+            src   += 4;
+            count -= 4;
+        }
+        if (count > 0) {
+            // Pad the last 1-3 halfs out to 4 so the tail converts exactly like the rest.
+            uint16_t h[4] = {0, 0, 0, 0};
+            float    f[4];
+            memcpy(h, src, count * sizeof(uint16_t));
+            half_to_float_4(h).store(f);
+            memcpy(dst, f, count * sizeof(float));
+        }
+    }
+
+    /*not static*/ inline void float_to_half(uint16_t dst[], const float src[], int count) {
+    #if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_AVX2
+        while (count >= 8) {
+            _mm_storeu_si128((__m128i*)dst,
+                             _mm256_cvtps_ph(_mm256_loadu_ps(src), _MM_FROUND_TO_ZERO));
+            dst   += 8;
+            src   += 8;
+            count -= 8;
+        }
+    #endif
+        while (count >= 4) {
+            float_to_half_4(dst, Sk4f::Load(src));
+            dst   += 4;
+            src   += 4;
+            count -= 4;
+        }
+        if (count > 0) {
+            float    f[4] = {0, 0, 0, 0};
+            uint16_t h[4];
+            memcpy(f, src, count * sizeof(float));
+            float_to_half_4(h, Sk4f::Load(f));
+            memcpy(dst, h, count * sizeof(uint16_t));
+        }
+    }
+
+}  // namespace SK_OPTS_NS
+
+#undef SK_HALF_OPTS_VCVT
+
+#endif//SkHalf_opts_DEFINED
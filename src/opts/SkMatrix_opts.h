@@ -0,0 +1,135 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkMatrix_opts_DEFINED
+#define SkMatrix_opts_DEFINED
+
+#include "SkNx.h"
+#include "SkPoint.h"
+
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_AVX2
+    #include <immintrin.h>
+#endif
+
+// These map count points by the 9 values of an SkMatrix, in its kMScaleX...kMPersp2 order.
+// They keep the operation order of SkMatrix's scalar mapXY() procs, so src may equal dst.
+
+namespace SK_OPTS_NS {
+
+    /*not static*/ inline void map_points_affine(const float m[9], SkPoint dst[],
+                                                  const SkPoint src[], int count) {
+        const float sx = m[0], kx = m[1], tx = m[2],
+                    ky = m[3], sy = m[4], ty = m[5];
+
+    #if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_AVX2
+        const __m256 scale = _mm256_setr_ps(sx,sy, sx,sy, sx,sy, sx,sy),
+                     skew  = _mm256_setr_ps(kx,ky, kx,ky, kx,ky, kx,ky),  // applies to y,x
+                     trans = _mm256_setr_ps(tx,ty, tx,ty, tx,ty, tx,ty);
+        while (count >= 4) {
+            __m256 p = _mm256_loadu_ps(&src->fX),
+                   q = _mm256_permute_ps(p, 0xB1);  // y0 x0, y1 x1, ...
+            _mm256_storeu_ps(&dst->fX, _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(p, scale),
+                                                                   _mm256_mul_ps(q, skew)),
+                                                     trans));
+            src   += 4;
+            dst   += 4;
+            count -= 4;
+        }
+    #endif
+        const Sk4f scale4(sx, sy, sx, sy),
+                   skew4(kx, ky, kx, ky),
+                   trans4(tx, ty, tx, ty);
+        while (count >= 2) {
+            Sk4f p = Sk4f::Load(src),
+                 q = SkNx_shuffle<1,0,3,2>(p);
+            (p * scale4 + q * skew4 + trans4).store(dst);
+            src   += 2;
+            dst   += 2;
+            count -= 2;
+        }
+        if (count) {
+            dst->set(src->fX * sx + src->fY * kx + tx,
+                     src->fX * ky + src->fY * sy + ty);
+        }
+    }
+
+    /*not static*/ inline void map_points_persp(const float m[9], SkPoint dst[],
+                                                 const SkPoint src[], int count) {
+        // Like the scalar procs, points that map to w == 0 end up at 0,0.
+    #if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_AVX2
+        // x*m[i] + y*m[i+1] + m[i+2]
+        auto dot = [m](__m256 x, __m256 y, int i) {
+            __m256 a = _mm256_set1_ps(m[i+0]),
+                   b = _mm256_set1_ps(m[i+1]),
+                   c = _mm256_set1_ps(m[i+2]);
+            return _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(x, a), _mm256_mul_ps(y, b)), c);
+        };
+        while (count >= 8) {
+            __m256 lo = _mm256_loadu_ps(&src[0].fX),
+                   hi = _mm256_loadu_ps(&src[4].fX);
+            // Each 128-bit lane of x and y gets points {0,1,4,5} or {2,3,6,7}; that's fine,
+            // as long as we put them back the same way.
+            __m256 x = _mm256_shuffle_ps(lo, hi, 0x88),
+                   y = _mm256_shuffle_ps(lo, hi, 0xDD);
+            __m256 X = dot(x, y, 0),
+                   Y = dot(x, y, 3);
+        #ifdef SK_LEGACY_MATRIX_MATH_ORDER
+            __m256 Z = _mm256_add_ps(_mm256_mul_ps(x, _mm256_set1_ps(m[6])),
+                                     _mm256_add_ps(_mm256_mul_ps(y, _mm256_set1_ps(m[7])),
+                                                   _mm256_set1_ps(m[8])));
+        #else
+            __m256 Z = dot(x, y, 6);
+        #endif
+            Z = _mm256_and_ps(_mm256_cmp_ps(Z, _mm256_setzero_ps(), _CMP_NEQ_UQ),
+                              _mm256_div_ps(_mm256_set1_ps(1), Z));
+            X = _mm256_mul_ps(X, Z);
+            Y = _mm256_mul_ps(Y, Z);
+            _mm256_storeu_ps(&dst[0].fX, _mm256_unpacklo_ps(X, Y));
+            _mm256_storeu_ps(&dst[4].fX, _mm256_unpackhi_ps(X, Y));
+            src   += 8;
+            dst   += 8;
+            count -= 8;
+        }
+    #endif
+        // Two points at a time, each with its x and y splatted into a pair of lanes.
+        const Sk4f mx(m[0], m[3], m[0], m[3]),
+                   my(m[1], m[4], m[1], m[4]),
+                   mt(m[2], m[5], m[2], m[5]);
+        while (count >= 2) {
+            Sk4f p = Sk4f::Load(src),
+                 x = SkNx_shuffle<0,0,2,2>(p),
+                 y = SkNx_shuffle<1,1,3,3>(p);
+        #ifdef SK_LEGACY_MATRIX_MATH_ORDER
+            Sk4f z = x * m[6] + (y * m[7] + m[8]);
+        #else
+            Sk4f z = x * m[6] + y * m[7] + m[8];
+        #endif
+            z = (z != 0).thenElse(1.0f / z, Sk4f(0));
+            ((x * mx + y * my + mt) * z).store(dst);
+            src   += 2;
+            dst   += 2;
+            count -= 2;
+        }
+        if (count) {
+            float x = src->fX,
+                  y = src->fY;
+        #ifdef SK_LEGACY_MATRIX_MATH_ORDER
+            float z = x * m[6] + (y * m[7] + m[8]);
+        #else
+            float z = x * m[6] + y * m[7] + m[8];
+        #endif
+            if (z) {
+                z = 1 / z;
+            }
+            dst->set((x * m[0] + y * m[1] + m[2]) * z,
+                     (x * m[3] + y * m[4] + m[5]) * z);
+        }
+    }
+
+}  // namespace SK_OPTS_NS
+
+#endif//SkMatrix_opts_DEFINED
@@ -0,0 +1,159 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkMipMap_opts_DEFINED
+#define SkMipMap_opts_DEFINED
+
+#include "SkHalf.h"
+#include "SkNx.h"
+
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE2
+    #include <immintrin.h>
+#elif defined(SK_ARM_HAS_NEON)
+    #include <arm_neon.h>
+#endif
+
+// These are the 2x2 box filters SkMipMap uses for even-sized levels, the overwhelmingly common
+// case. Each writes |count| dst pixels, averaging (with truncation, to match the portable procs
+// in SkMipMap.cpp) the 2x2 src block at (2*i, 0) of the two src rows starting at src.
+
+namespace SK_OPTS_NS {
+
+    /*not static*/ inline void downsample_2_2_8888(void* dst, const void* src, size_t srcRB,
+                                                    int count) {
+        auto p0 = static_cast<const uint32_t*>(src);
+        auto p1 = (const uint32_t*)((const char*)src + srcRB);
+        auto d  = static_cast<uint32_t*>(dst);
+
+    #if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE2
+        const __m128i zero = _mm_setzero_si128();
+        // Sums the 2x2 blocks of 4 src pixels from each row into 2 dst pixels, 16 bits per channel.
+        auto sum2 = [&](__m128i r0, __m128i r1) {
+            __m128i lo = _mm_add_epi16(_mm_unpacklo_epi8(r0, zero), _mm_unpacklo_epi8(r1, zero)),
+                    hi = _mm_add_epi16(_mm_unpackhi_epi8(r0, zero), _mm_unpackhi_epi8(r1, zero));
+            lo = _mm_add_epi16(lo, _mm_srli_si128(lo, 8));
+            hi = _mm_add_epi16(hi, _mm_srli_si128(hi, 8));
+            return _mm_srli_epi16(_mm_unpacklo_epi64(lo, hi), 2);
+        };
+        while (count >= 4) {
+            __m128i a = sum2(_mm_loadu_si128((const __m128i*)(p0 + 0)),
+                             _mm_loadu_si128((const __m128i*)(p1 + 0))),
+                    b = sum2(_mm_loadu_si128((const __m128i*)(p0 + 4)),
+                             _mm_loadu_si128((const __m128i*)(p1 + 4)));
+            _mm_storeu_si128((__m128i*)d, _mm_packus_epi16(a, b));
+            p0 += 8;
+            p1 += 8;
+            d  += 4;
+            count -= 4;
+        }
+    #elif defined(SK_ARM_HAS_NEON)
+        while (count >= 4) {
+            // vld2q splits 8 pixels into the 4 even and 4 odd ones.
+            uint32x4x2_t r0 = vld2q_u32(p0),
+                         r1 = vld2q_u32(p1);
+            uint8x16_t e0 = vreinterpretq_u8_u32(r0.val[0]), o0 = vreinterpretq_u8_u32(r0.val[1]),
+                       e1 = vreinterpretq_u8_u32(r1.val[0]), o1 = vreinterpretq_u8_u32(r1.val[1]);
+            uint16x8_t lo = vaddq_u16(vaddl_u8(vget_low_u8 (e0), vget_low_u8 (o0)),
+                                      vaddl_u8(vget_low_u8 (e1), vget_low_u8 (o1))),
+                       hi = vaddq_u16(vaddl_u8(vget_high_u8(e0), vget_high_u8(o0)),
+                                      vaddl_u8(vget_high_u8(e1), vget_high_u8(o1)));
+            vst1q_u8((uint8_t*)d, vcombine_u8(vshrn_n_u16(lo, 2), vshrn_n_u16(hi, 2)));
+            p0 += 8;
+            p1 += 8;
+            d  += 4;
+            count -= 4;
+        }
+    #endif
+        for (int i = 0; i < count; ++i) {
+            auto expand = [](const uint32_t* p) { return SkNx_cast<uint16_t>(Sk4b::Load(p)); };
+            Sk4h c = expand(p0 + 0) + expand(p0 + 1) + expand(p1 + 0) + expand(p1 + 1);
+            SkNx_cast<uint8_t>(c >> 2).store(d + i);
+            p0 += 2;
+            p1 += 2;
+        }
+    }
+
+    /*not static*/ inline void downsample_2_2_a8(void* dst, const void* src, size_t srcRB,
+                                                  int count) {
+        auto p0 = static_cast<const uint8_t*>(src);
+        auto p1 = static_cast<const uint8_t*>(src) + srcRB;
+        auto d  = static_cast<uint8_t*>(dst);
+
+    #if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE2
+        const __m128i evens = _mm_set1_epi16(0x00FF);
+        // Sums the 2x2 blocks of 16 src pixels from each row into 8 dst pixels, 16 bits each.
+        auto sum8 = [&](__m128i r0, __m128i r1) {
+            __m128i s0 = _mm_add_epi16(_mm_and_si128(r0, evens), _mm_srli_epi16(r0, 8)),
+                    s1 = _mm_add_epi16(_mm_and_si128(r1, evens), _mm_srli_epi16(r1, 8));
+            return _mm_srli_epi16(_mm_add_epi16(s0, s1), 2);
+        };
+        while (count >= 16) {
+            __m128i a = sum8(_mm_loadu_si128((const __m128i*)(p0 +  0)),
+                             _mm_loadu_si128((const __m128i*)(p1 +  0))),
+                    b = sum8(_mm_loadu_si128((const __m128i*)(p0 + 16)),
+                             _mm_loadu_si128((const __m128i*)(p1 + 16)));
+            _mm_storeu_si128((__m128i*)d, _mm_packus_epi16(a, b));
+            p0 += 32;
+            p1 += 32;
+            d  += 16;
+            count -= 16;
+        }
+    #elif defined(SK_ARM_HAS_NEON)
+        while (count >= 16) {
+            // vpaddlq adds each even pixel to its odd neighbor, widening to 16 bits.
+            uint16x8_t a = vaddq_u16(vpaddlq_u8(vld1q_u8(p0 +  0)), vpaddlq_u8(vld1q_u8(p1 +  0))),
+                       b = vaddq_u16(vpaddlq_u8(vld1q_u8(p0 + 16)), vpaddlq_u8(vld1q_u8(p1 + 16)));
+            vst1q_u8(d, vcombine_u8(vshrn_n_u16(a, 2), vshrn_n_u16(b, 2)));
+            p0 += 32;
+            p1 += 32;
+            d  += 16;
+            count -= 16;
+        }
+    #endif
+        for (int i = 0; i < count; ++i) {
+            d[i] = (uint8_t)((p0[0] + p0[1] + p1[0] + p1[1]) >> 2);
+            p0 += 2;
+            p1 += 2;
+        }
+    }
+
+    /*not static*/ inline void downsample_2_2_f16(void* dst, const void* src, size_t srcRB,
+                                                   int count) {
+        auto p0 = static_cast<const uint64_t*>(src);
+        auto p1 = (const uint64_t*)((const char*)src + srcRB);
+        auto d  = static_cast<uint64_t*>(dst);
+
+    #if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_AVX2
+        // Haswell and up have F16C: convert a 2x2 block with one instruction per row.
+        while (count >= 2) {
+            __m256 a = _mm256_add_ps(_mm256_cvtph_ps(_mm_loadu_si128((const __m128i*)(p0 + 0))),
+                                     _mm256_cvtph_ps(_mm_loadu_si128((const __m128i*)(p1 + 0)))),
+                   b = _mm256_add_ps(_mm256_cvtph_ps(_mm_loadu_si128((const __m128i*)(p0 + 2))),
+                                     _mm256_cvtph_ps(_mm_loadu_si128((const __m128i*)(p1 + 2))));
+            // Add the left and right pixels of each block, then put the two results together.
+            __m256 s = _mm256_add_ps(_mm256_permute2f128_ps(a, b, 0x20),
+                                     _mm256_permute2f128_ps(a, b, 0x31));
+            s = _mm256_mul_ps(s, _mm256_set1_ps(0.25f));
+            _mm_storeu_si128((__m128i*)d, _mm256_cvtps_ph(s, _MM_FROUND_TO_ZERO));
+            p0 += 4;
+            p1 += 4;
+            d  += 2;
+            count -= 2;
+        }
+    #endif
+        for (int i = 0; i < count; ++i) {
+            Sk4f c = SkHalfToFloat_finite_ftz(p0[0]) + SkHalfToFloat_finite_ftz(p0[1])
+                   + SkHalfToFloat_finite_ftz(p1[0]) + SkHalfToFloat_finite_ftz(p1[1]);
+            SkFloatToHalf_finite_ftz(c * 0.25f).store(d + i);
+            p0 += 2;
+            p1 += 2;
+        }
+    }
+
+}  // namespace SK_OPTS_NS
+
+#endif//SkMipMap_opts_DEFINED
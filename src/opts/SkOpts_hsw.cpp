@@ -8,11 +8,36 @@
 #include "SkOpts.h"
 
 #define SK_OPTS_NS hsw
+#include "SkBlitMask_opts.h"
+#include "SkBlitRow_opts.h"
+#include "SkHalf_opts.h"
+#include "SkMatrix_opts.h"
+#include "SkMipMap_opts.h"
 #include "SkRasterPipeline_opts.h"
+#include "SkScan_opts.h"
 #include "SkUtils_opts.h"
 
 namespace SkOpts {
     void Init_hsw() {
+        blit_mask_d32_a8      = hsw::blit_mask_d32_a8;
+        blit_row_lcd16        = hsw::blit_row_lcd16;
+        blit_row_lcd16_opaque = hsw::blit_row_lcd16_opaque;
+
+        blit_row_color_f16 = hsw::blit_row_color_f16;
+        downsample_2_2_f16 = hsw::downsample_2_2_f16;
+        map_points_affine  = hsw::map_points_affine;
+        map_points_persp   = hsw::map_points_persp;
+
+        add_alphas                 = hsw::add_alphas;
+        add_alphas_saturating      = hsw::add_alphas_saturating;
+        subtract_alphas_saturating = hsw::subtract_alphas_saturating;
+        add_alpha                  = hsw::add_alpha;
+        add_alpha_saturating       = hsw::add_alpha_saturating;
+        alpha_ramp                 = hsw::alpha_ramp;
+
+        half_to_float = hsw::half_to_float;
+        float_to_half = hsw::float_to_half;
+
     #define M(st) stages_highp[SkRasterPipeline::st] = (StageFn)SK_OPTS_NS::st;
         SK_RASTER_PIPELINE_STAGES(M)
         just_return_highp = (StageFn)SK_OPTS_NS::just_return;
@@ -10,11 +10,19 @@
 #define SK_OPTS_NS sse41
 #include "SkRasterPipeline_opts.h"
 #include "SkBlitRow_opts.h"
+#include "SkScan_opts.h"
 
 namespace SkOpts {
     void Init_sse41() {
         blit_row_s32a_opaque = sse41::blit_row_s32a_opaque;
 
+        add_alphas                 = sse41::add_alphas;
+        add_alphas_saturating      = sse41::add_alphas_saturating;
+        subtract_alphas_saturating = sse41::subtract_alphas_saturating;
+        add_alpha                  = sse41::add_alpha;
+        add_alpha_saturating       = sse41::add_alpha_saturating;
+        alpha_ramp                 = sse41::alpha_ramp;
+
     #define M(st) stages_highp[SkRasterPipeline::st] = (StageFn)SK_OPTS_NS::st;
         SK_RASTER_PIPELINE_STAGES(M)
         just_return_highp = (StageFn)SK_OPTS_NS::just_return;
@@ -9,6 +9,7 @@
 #define SK_OPTS_NS ssse3
 #include "SkBitmapProcState_opts.h"
 #include "SkBlitMask_opts.h"
+#include "SkPngFilter_opts.h"
 #include "SkSwizzler_opts.h"
 #include "SkXfermode_opts.h"
 
@@ -29,5 +30,7 @@ namespace SkOpts {
         inverted_CMYK_to_BGR1 = ssse3::inverted_CMYK_to_BGR1;
 
         S32_alpha_D32_filter_DX  = ssse3::S32_alpha_D32_filter_DX;
+
+        png_filter_paeth = ssse3::png_filter_paeth;
     }
 }
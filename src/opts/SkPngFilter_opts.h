@@ -0,0 +1,202 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkPngFilter_opts_DEFINED
+#define SkPngFilter_opts_DEFINED
+
+#include "SkTypes.h"
+
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE2
+    #include <immintrin.h>
+#elif defined(SK_ARM_HAS_NEON)
+    #include <arm_neon.h>
+#endif
+
+// These are PNG's Sub, Up, Average and Paeth filters, as used by SkPngEncoder. Each writes the
+// rowBytes filtered bytes of row to dst, predicting each byte from a, the byte bpp to its left,
+// b, the byte above it in prev, and c, the byte above and to the left. a and c are 0 for the
+// first pixel. Unlike unfiltering, filtering only reads the unfiltered rows, so every byte past
+// the first pixel can be done at once.
+
+namespace SK_OPTS_NS {
+
+    static inline uint8_t png_paeth_predict(int a, int b, int c) {
+        int pa = SkTAbs(b - c),
+            pb = SkTAbs(a - c),
+            pc = SkTAbs(a + b - 2 * c);
+        return pa <= pb && pa <= pc ? a : pb <= pc ? b : c;
+    }
+
+    /*not static*/ inline void png_filter_sub(uint8_t* dst, const uint8_t* row,
+                                              const uint8_t* prev, size_t rowBytes, size_t bpp) {
+        size_t i = 0;
+        for (; i < bpp; i++) {
+            dst[i] = row[i];
+        }
+    #if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE2
+        for (; i + 16 <= rowBytes; i += 16) {
+            __m128i x = _mm_loadu_si128((const __m128i*)(row + i)),
+                    a = _mm_loadu_si128((const __m128i*)(row + i - bpp));
+            _mm_storeu_si128((__m128i*)(dst + i), _mm_sub_epi8(x, a));
+        }
+    #elif defined(SK_ARM_HAS_NEON)
+        for (; i + 16 <= rowBytes; i += 16) {
+            vst1q_u8(dst + i, vsubq_u8(vld1q_u8(row + i), vld1q_u8(row + i - bpp)));
+        }
+    #endif
+        for (; i < rowBytes; i++) {
+            dst[i] = row[i] - row[i - bpp];
+        }
+    }
+
+    /*not static*/ inline void png_filter_up(uint8_t* dst, const uint8_t* row,
+                                             const uint8_t* prev, size_t rowBytes, size_t bpp) {
+        size_t i = 0;
+    #if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE2
+        for (; i + 16 <= rowBytes; i += 16) {
+            __m128i x = _mm_loadu_si128((const __m128i*)(row  + i)),
+                    b = _mm_loadu_si128((const __m128i*)(prev + i));
+            _mm_storeu_si128((__m128i*)(dst + i), _mm_sub_epi8(x, b));
+        }
+    #elif defined(SK_ARM_HAS_NEON)
+        for (; i + 16 <= rowBytes; i += 16) {
+            vst1q_u8(dst + i, vsubq_u8(vld1q_u8(row + i), vld1q_u8(prev + i)));
+        }
+    #endif
+        for (; i < rowBytes; i++) {
+            dst[i] = row[i] - prev[i];
+        }
+    }
+
+    /*not static*/ inline void png_filter_avg(uint8_t* dst, const uint8_t* row,
+                                              const uint8_t* prev, size_t rowBytes, size_t bpp) {
+        size_t i = 0;
+        for (; i < bpp; i++) {
+            dst[i] = row[i] - (prev[i] >> 1);
+        }
+    #if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE2
+        const __m128i one = _mm_set1_epi8(1);
+        for (; i + 16 <= rowBytes; i += 16) {
+            __m128i x = _mm_loadu_si128((const __m128i*)(row  + i)),
+                    a = _mm_loadu_si128((const __m128i*)(row  + i - bpp)),
+                    b = _mm_loadu_si128((const __m128i*)(prev + i));
+            // _mm_avg_epu8() rounds up, and PNG rounds down.
+            __m128i avg = _mm_sub_epi8(_mm_avg_epu8(a, b), _mm_and_si128(_mm_xor_si128(a, b), one));
+            _mm_storeu_si128((__m128i*)(dst + i), _mm_sub_epi8(x, avg));
+        }
+    #elif defined(SK_ARM_HAS_NEON)
+        for (; i + 16 <= rowBytes; i += 16) {
+            uint8x16_t avg = vhaddq_u8(vld1q_u8(row + i - bpp), vld1q_u8(prev + i));
+            vst1q_u8(dst + i, vsubq_u8(vld1q_u8(row + i), avg));
+        }
+    #endif
+        for (; i < rowBytes; i++) {
+            dst[i] = row[i] - ((row[i - bpp] + prev[i]) >> 1);
+        }
+    }
+
+    /*not static*/ inline void png_filter_paeth(uint8_t* dst, const uint8_t* row,
+                                                const uint8_t* prev, size_t rowBytes, size_t bpp) {
+        size_t i = 0;
+        for (; i < bpp; i++) {
+            dst[i] = row[i] - prev[i];  // With a and c 0, Paeth always predicts b.
+        }
+    #if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE2
+        const __m128i zero = _mm_setzero_si128();
+        auto abs16 = [&](__m128i v) {
+        #if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSSE3
+            return _mm_abs_epi16(v);
+        #else
+            return _mm_max_epi16(v, _mm_sub_epi16(zero, v));
+        #endif
+        };
+        // Predicts 8 bytes, widened to 16 bits.
+        auto predict8 = [&](__m128i a, __m128i b, __m128i c) {
+            __m128i bc = _mm_sub_epi16(b, c),
+                    ac = _mm_sub_epi16(a, c),
+                    pa = abs16(bc),
+                    pb = abs16(ac),
+                    pc = abs16(_mm_add_epi16(bc, ac));
+            __m128i notA = _mm_or_si128(_mm_cmpgt_epi16(pa, pb), _mm_cmpgt_epi16(pa, pc)),
+                    isC  = _mm_cmpgt_epi16(pb, pc);
+            __m128i bOrC = _mm_or_si128(_mm_and_si128(isC, c), _mm_andnot_si128(isC, b));
+            return _mm_or_si128(_mm_and_si128(notA, bOrC), _mm_andnot_si128(notA, a));
+        };
+        for (; i + 16 <= rowBytes; i += 16) {
+            __m128i x = _mm_loadu_si128((const __m128i*)(row  + i)),
+                    a = _mm_loadu_si128((const __m128i*)(row  + i - bpp)),
+                    b = _mm_loadu_si128((const __m128i*)(prev + i)),
+                    c = _mm_loadu_si128((const __m128i*)(prev + i - bpp));
+            __m128i lo = predict8(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero),
+                                  _mm_unpacklo_epi8(c, zero)),
+                    hi = predict8(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero),
+                                  _mm_unpackhi_epi8(c, zero));
+            _mm_storeu_si128((__m128i*)(dst + i), _mm_sub_epi8(x, _mm_packus_epi16(lo, hi)));
+        }
+    #elif defined(SK_ARM_HAS_NEON)
+        // Returns the masks of the 8 bytes which don't predict a, and of those which predict c.
+        auto masks8 = [](uint8x8_t a, uint8x8_t b, uint8x8_t c, uint8x8_t* isC) {
+            uint16x8_t pa = vabdl_u8(b, c),
+                       pb = vabdl_u8(a, c),
+                       pc = vreinterpretq_u16_s16(vabsq_s16(vaddq_s16(
+                               vreinterpretq_s16_u16(vsubl_u8(b, c)),
+                               vreinterpretq_s16_u16(vsubl_u8(a, c)))));
+            *isC = vmovn_u16(vcgtq_u16(pb, pc));
+            return vmovn_u16(vorrq_u16(vcgtq_u16(pa, pb), vcgtq_u16(pa, pc)));
+        };
+        for (; i + 16 <= rowBytes; i += 16) {
+            uint8x16_t x = vld1q_u8(row  + i),
+                       a = vld1q_u8(row  + i - bpp),
+                       b = vld1q_u8(prev + i),
+                       c = vld1q_u8(prev + i - bpp);
+            uint8x8_t isCLo, isCHi;
+            uint8x8_t notALo = masks8(vget_low_u8 (a), vget_low_u8 (b), vget_low_u8 (c), &isCLo),
+                      notAHi = masks8(vget_high_u8(a), vget_high_u8(b), vget_high_u8(c), &isCHi);
+            uint8x16_t bOrC = vbslq_u8(vcombine_u8(isCLo, isCHi), c, b),
+                       pred = vbslq_u8(vcombine_u8(notALo, notAHi), bOrC, a);
+            vst1q_u8(dst + i, vsubq_u8(x, pred));
+        }
+    #endif
+        for (; i < rowBytes; i++) {
+            dst[i] = row[i] - png_paeth_predict(row[i - bpp], prev[i], prev[i - bpp]);
+        }
+    }
+
+    // The sum of the bytes' absolute values, taken as signed, which is how libpng guesses which
+    // filter will compress a row best.
+    /*not static*/ inline size_t png_filter_cost(const uint8_t* bytes, size_t count) {
+        size_t cost = 0,
+               i = 0;
+    #if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE2
+        const __m128i zero = _mm_setzero_si128();
+        __m128i sums = zero;
+        for (; i + 16 <= count; i += 16) {
+            __m128i v = _mm_loadu_si128((const __m128i*)(bytes + i));
+            // As unsigned bytes, |v| is the smaller of v and -v.
+            sums = _mm_add_epi64(sums, _mm_sad_epu8(_mm_min_epu8(v, _mm_sub_epi8(zero, v)), zero));
+        }
+        cost += (size_t)_mm_cvtsi128_si32(sums) +
+                (size_t)_mm_cvtsi128_si32(_mm_unpackhi_epi64(sums, sums));
+    #elif defined(SK_ARM_HAS_NEON)
+        uint32x4_t sums = vdupq_n_u32(0);
+        for (; i + 16 <= count; i += 16) {
+            uint8x16_t v = vld1q_u8(bytes + i),
+                       abs = vminq_u8(v, vreinterpretq_u8_s8(vnegq_s8(vreinterpretq_s8_u8(v))));
+            sums = vpadalq_u16(sums, vpaddlq_u8(abs));
+        }
+        uint64x2_t sum = vpaddlq_u32(sums);
+        cost += (size_t)(vgetq_lane_u64(sum, 0) + vgetq_lane_u64(sum, 1));
+    #endif
+        for (; i < count; i++) {
+            cost += bytes[i] < 128 ? bytes[i] : 256 - bytes[i];
+        }
+        return cost;
+    }
+
+}  // namespace SK_OPTS_NS
+
+#endif//SkPngFilter_opts_DEFINED
@@ -0,0 +1,161 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkScan_opts_DEFINED
+#define SkScan_opts_DEFINED
+
+#include "SkNx.h"
+
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_AVX2
+    #include <immintrin.h>
+#endif
+
+// These accumulate analytic AA's partial coverage into rows of 8-bit alphas (see
+// SkScan_AAAPath.cpp). They give exactly the results of its scalar loops.
+
+namespace SK_OPTS_NS {
+
+    // alpha + delta, where only a sum of 256 (which wraps to 0) is expected to carry, and
+    // becomes 255, like SkAlphaRuns::CatchOverflow().
+    struct AddAlphaOp {
+        static uint8_t Apply(uint8_t alpha, uint8_t delta) {
+            int sum = alpha + delta;
+            SkASSERT(sum <= 256);
+            return sum - (sum >> 8);
+        }
+        static Sk16b Apply(const Sk16b& alpha, const Sk16b& delta) {
+            Sk16b sum = alpha + delta;
+            return sum + (sum < alpha);  // A lane that carried gets 0xFF, i.e. -1, added.
+        }
+    #if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_AVX2
+        static __m256i Apply(__m256i alpha, __m256i delta) {
+            __m256i sum = _mm256_add_epi8(alpha, delta),
+                    noCarry = _mm256_cmpeq_epi8(_mm256_max_epu8(sum, alpha), sum);
+            return _mm256_add_epi8(sum, _mm256_xor_si256(noCarry, _mm256_set1_epi8(-1)));
+        }
+    #endif
+    };
+
+    struct AddAlphaSaturatingOp {
+        static uint8_t Apply(uint8_t alpha, uint8_t delta) {
+            return SkTMin(0xFF, alpha + (int)delta);
+        }
+        static Sk16b Apply(const Sk16b& alpha, const Sk16b& delta) {
+            return alpha.saturatedAdd(delta);
+        }
+    #if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_AVX2
+        static __m256i Apply(__m256i alpha, __m256i delta) {
+            return _mm256_adds_epu8(alpha, delta);
+        }
+    #endif
+    };
+
+    struct SubtractAlphaSaturatingOp {
+        static uint8_t Apply(uint8_t alpha, uint8_t delta) {
+            return alpha > delta ? alpha - delta : 0;
+        }
+        static Sk16b Apply(const Sk16b& alpha, const Sk16b& delta) {
+            return alpha - Sk16b::Min(alpha, delta);
+        }
+    #if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_AVX2
+        static __m256i Apply(__m256i alpha, __m256i delta) {
+            return _mm256_subs_epu8(alpha, delta);
+        }
+    #endif
+    };
+
+    template <typename Op>
+    static inline void apply_to_alphas(uint8_t alphas[], const uint8_t deltas[], int count) {
+    #if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_AVX2
+        while (count >= 32) {
+            __m256i a = _mm256_loadu_si256((const __m256i*)alphas),
+                    d = _mm256_loadu_si256((const __m256i*)deltas);
+            _mm256_storeu_si256((__m256i*)alphas, Op::Apply(a, d));
+            alphas += 32;
+            deltas += 32;
+            count  -= 32;
+        }
+    #endif
+        while (count >= 16) {
+            Op::Apply(Sk16b::Load(alphas), Sk16b::Load(deltas)).store(alphas);
+            alphas += 16;
+            deltas += 16;
+            count  -= 16;
+        }
+        while (count --> 0) {
+            *alphas = Op::Apply(*alphas, *deltas++);
+            alphas++;
+        }
+    }
+
+    template <typename Op>
+    static inline void apply_to_alphas(uint8_t alphas[], uint8_t delta, int count) {
+    #if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_AVX2
+        const __m256i d32 = _mm256_set1_epi8(delta);
+        while (count >= 32) {
+            __m256i a = _mm256_loadu_si256((const __m256i*)alphas);
+            _mm256_storeu_si256((__m256i*)alphas, Op::Apply(a, d32));
+            alphas += 32;
+            count  -= 32;
+        }
+    #endif
+        const Sk16b d16(delta);
+        while (count >= 16) {
+            Op::Apply(Sk16b::Load(alphas), d16).store(alphas);
+            alphas += 16;
+            count  -= 16;
+        }
+        while (count --> 0) {
+            *alphas = Op::Apply(*alphas, delta);
+            alphas++;
+        }
+    }
+
+    /*not static*/ inline void add_alphas(uint8_t alphas[], const uint8_t deltas[], int count) {
+        apply_to_alphas<AddAlphaOp>(alphas, deltas, count);
+    }
+    /*not static*/ inline void add_alphas_saturating(uint8_t alphas[], const uint8_t deltas[],
+                                                      int count) {
+        apply_to_alphas<AddAlphaSaturatingOp>(alphas, deltas, count);
+    }
+    /*not static*/ inline void subtract_alphas_saturating(uint8_t alphas[],
+                                                           const uint8_t deltas[], int count) {
+        apply_to_alphas<SubtractAlphaSaturatingOp>(alphas, deltas, count);
+    }
+
+    /*not static*/ inline void add_alpha(uint8_t alphas[], uint8_t delta, int count) {
+        apply_to_alphas<AddAlphaOp>(alphas, delta, count);
+    }
+    /*not static*/ inline void add_alpha_saturating(uint8_t alphas[], uint8_t delta, int count) {
+        apply_to_alphas<AddAlphaSaturatingOp>(alphas, delta, count);
+    }
+
+    /*not static*/ inline void alpha_ramp(uint8_t alphas[], int count, int32_t start,
+                                          int32_t step) {
+        // Each lane keeps its own running sum, so the sums match the scalar loop's exactly.
+        Sk4i lo(start, start + step, start + 2*step, start + 3*step),
+             hi = lo + Sk4i(4*step);
+        const Sk4i step8(8*step),
+                   mask(0xFF);
+        while (count >= 8) {
+            Sk8i alpha16(lo, hi);
+            SkNx_cast<uint8_t>((alpha16 >> 8) & Sk8i(mask, mask)).store(alphas);
+            lo = lo + step8;
+            hi = hi + step8;
+            alphas += 8;
+            count  -= 8;
+        }
+        int32_t alpha16 = lo[0];
+        while (count --> 0) {
+            *alphas++ = alpha16 >> 8;
+            alpha16 += step;
+        }
+    }
+
+}  // namespace SK_OPTS_NS
+
+#endif//SkScan_opts_DEFINED
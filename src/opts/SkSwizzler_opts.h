@@ -525,6 +525,42 @@ static void premul_should_swapRB(uint32_t* dst, const uint32_t* src, int count)
         *hi = _mm_unpackhi_epi16(rg, ba);                         // RGBARGBA RGBARGBA
     };
 
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SKX
+    // Premultiply 16 pixels at a time, working on them as 16-bit values in place.
+    {
+        const __m512i zeros = _mm512_setzero_si512(),
+                      _128  = _mm512_set1_epi16(128),
+                      _257  = _mm512_set1_epi16(257);
+        const __m512i swapRB = _mm512_broadcast_i32x4(
+                _mm_setr_epi8(2,1,0,3, 6,5,4,7, 10,9,8,11, 14,13,12,15));
+        // Selects the alpha channel of each 16-bit rgba pixel.
+        const __mmask32 alphas = 0x88888888;
+
+        auto premul4 = [&](__m512i px) {
+            // Broadcast each pixel's alpha across all four of its channels, then
+            // scale the color channels by it, (x*a+127)/255 == ((x*a+128)*257)>>16.
+            __m512i a = _mm512_shufflehi_epi16(_mm512_shufflelo_epi16(px, 0xFF), 0xFF),
+                    c = _mm512_mulhi_epu16(_mm512_add_epi16(_mm512_mullo_epi16(px, a), _128),
+                                           _257);
+            return _mm512_mask_blend_epi16(alphas, c, px);
+        };
+
+        while (count >= 16) {
+            __m512i px = _mm512_loadu_si512(src);
+            if (kSwapRB) {
+                px = _mm512_shuffle_epi8(px, swapRB);
+            }
+            __m512i lo = premul4(_mm512_unpacklo_epi8(px, zeros)),
+                    hi = premul4(_mm512_unpackhi_epi8(px, zeros));
+            _mm512_storeu_si512(dst, _mm512_packus_epi16(lo, hi));
+
+            src += 16;
+            dst += 16;
+            count -= 16;
+        }
+    }
+#endif
+
     while (count >= 8) {
         __m128i lo = _mm_loadu_si128((const __m128i*) (src + 0)),
                 hi = _mm_loadu_si128((const __m128i*) (src + 4));
@@ -568,6 +604,18 @@ static void premul_should_swapRB(uint32_t* dst, const uint32_t* src, int count)
 /*not static*/ inline void RGBA_to_BGRA(uint32_t* dst, const uint32_t* src, int count) {
     const __m128i swapRB = _mm_setr_epi8(2,1,0,3, 6,5,4,7, 10,9,8,11, 14,13,12,15);
 
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SKX
+    const __m512i swapRB16 = _mm512_broadcast_i32x4(swapRB);
+    while (count >= 16) {
+        __m512i rgba = _mm512_loadu_si512(src);
+        _mm512_storeu_si512(dst, _mm512_shuffle_epi8(rgba, swapRB16));
+
+        src += 16;
+        dst += 16;
+        count -= 16;
+    }
+#endif
+
     while (count >= 4) {
         __m128i rgba = _mm_loadu_si128((const __m128i*) src);
         __m128i bgra = _mm_shuffle_epi8(rgba, swapRB);
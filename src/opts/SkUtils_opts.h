@@ -11,6 +11,10 @@
 #include <stdint.h>
 #include "SkNx.h"
 
+#if defined(SK_CPU_SSE_LEVEL) && SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SKX
+    #include <immintrin.h>
+#endif
+
 namespace SK_OPTS_NS {
 
     template <typename T>
@@ -30,6 +34,37 @@ namespace SK_OPTS_NS {
         }
     }
 
+#if defined(SK_CPU_SSE_LEVEL) && SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SKX
+    // With AVX-512 the last partial vector is written with a masked store instead of a loop.
+    // (memset16 needs AVX-512BW.)
+    /*not static*/ inline void memset16(uint16_t buffer[], uint16_t value, int count) {
+        __m512i v = _mm512_set1_epi16(value);
+        while (count >= 32) {
+            _mm512_storeu_si512(buffer, v);
+            buffer += 32;
+            count  -= 32;
+        }
+        _mm512_mask_storeu_epi16(buffer, (__mmask32)((1u << count) - 1), v);
+    }
+    /*not static*/ inline void memset32(uint32_t buffer[], uint32_t value, int count) {
+        __m512i v = _mm512_set1_epi32(value);
+        while (count >= 16) {
+            _mm512_storeu_si512(buffer, v);
+            buffer += 16;
+            count  -= 16;
+        }
+        _mm512_mask_storeu_epi32(buffer, (__mmask16)((1 << count) - 1), v);
+    }
+    /*not static*/ inline void memset64(uint64_t buffer[], uint64_t value, int count) {
+        __m512i v = _mm512_set1_epi64(value);
+        while (count >= 8) {
+            _mm512_storeu_si512(buffer, v);
+            buffer += 8;
+            count  -= 8;
+        }
+        _mm512_mask_storeu_epi64(buffer, (__mmask8)((1 << count) - 1), v);
+    }
+#else
     /*not static*/ inline void memset16(uint16_t buffer[], uint16_t value, int count) {
         memsetT(buffer, value, count);
     }
@@ -39,6 +74,7 @@ namespace SK_OPTS_NS {
     /*not static*/ inline void memset64(uint64_t buffer[], uint64_t value, int count) {
         memsetT(buffer, value, count);
     }
+#endif
 
 }
 
@@ -0,0 +1,128 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkYCbCr_opts_DEFINED
+#define SkYCbCr_opts_DEFINED
+
+#include "SkTypes.h"
+
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE2
+    #include <immintrin.h>
+#elif defined(SK_ARM_HAS_NEON)
+    #include <arm_neon.h>
+#endif
+
+// These convert count 8888 pixels to JPEG's full range YCbCr, one byte per pixel in each of y, cb
+// and cr, ignoring alpha. The coefficients are JFIF's, in 15 bit fixed point, with the same
+// rounding as libjpeg's own conversion (which uses 16 bits, so results may differ by one).
+
+namespace SK_OPTS_NS {
+
+    // Each row sums to 1 (Y) or 0 (Cb, Cr), i.e. 1 << 15 or 0.
+    enum {
+        kY_R  =   9798, kY_G  =  19235, kY_B  =  3735,
+        kCb_R =  -5529, kCb_G = -10855, kCb_B = 16384,
+        kCr_R =  16384, kCr_G = -13720, kCr_B = -2664,
+
+        kY_Bias    = 1 << 14,
+        // Just under 128.5, so that Cb and Cr can't round up to 256.
+        kCbCr_Bias = (128 << 15) + (1 << 14) - 1,
+    };
+
+    template <bool kBGR>
+    static inline void to_YCbCr(uint8_t* y, uint8_t* cb, uint8_t* cr, const uint32_t* src,
+                                int count) {
+        int i = 0;
+    #if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE2
+        // In each pixel, the 16-bit lanes of px & 0x00FF00FF are (R,B) (or (B,R)), and those of
+        // (px >> 8) & 0x00FF00FF are (G,A), so _mm_madd_epi16() weighs and adds them in one go.
+        auto rb = [](short r, short b) {
+            return kBGR ? _mm_set_epi16(r,b, r,b, r,b, r,b) : _mm_set_epi16(b,r, b,r, b,r, b,r);
+        };
+        auto ga = [](short g) { return _mm_set_epi16(0,g, 0,g, 0,g, 0,g); };
+        const __m128i mask  = _mm_set1_epi32(0x00FF00FF),
+                      yBias = _mm_set1_epi32(kY_Bias),
+                      cBias = _mm_set1_epi32(kCbCr_Bias);
+        for (; i + 8 <= count; i += 8) {
+            __m128i lo = _mm_loadu_si128((const __m128i*)(src + i + 0)),
+                    hi = _mm_loadu_si128((const __m128i*)(src + i + 4));
+            __m128i rbLo = _mm_and_si128(lo, mask),
+                    rbHi = _mm_and_si128(hi, mask),
+                    gaLo = _mm_and_si128(_mm_srli_epi32(lo, 8), mask),
+                    gaHi = _mm_and_si128(_mm_srli_epi32(hi, 8), mask);
+            auto store8 = [&](uint8_t* dst, __m128i rbC, __m128i gaC, __m128i bias) {
+                __m128i vLo = _mm_add_epi32(_mm_madd_epi16(rbLo, rbC), _mm_madd_epi16(gaLo, gaC)),
+                        vHi = _mm_add_epi32(_mm_madd_epi16(rbHi, rbC), _mm_madd_epi16(gaHi, gaC));
+                vLo = _mm_srai_epi32(_mm_add_epi32(vLo, bias), 15);
+                vHi = _mm_srai_epi32(_mm_add_epi32(vHi, bias), 15);
+                __m128i v = _mm_packs_epi32(vLo, vHi);
+                _mm_storel_epi64((__m128i*)(dst + i), _mm_packus_epi16(v, v));
+            };
+            store8(y,  rb(kY_R,  kY_B),  ga(kY_G),  yBias);
+            store8(cb, rb(kCb_R, kCb_B), ga(kCb_G), cBias);
+            store8(cr, rb(kCr_R, kCr_B), ga(kCr_G), cBias);
+        }
+    #elif defined(SK_ARM_HAS_NEON)
+        // Everything stays unsigned: the bias is added first, then negative terms subtracted.
+        for (; i + 8 <= count; i += 8) {
+            uint8x8x4_t px = vld4_u8((const uint8_t*)(src + i));
+            uint16x8_t r = vmovl_u8(px.val[kBGR ? 2 : 0]),
+                       g = vmovl_u8(px.val[1]),
+                       b = vmovl_u8(px.val[kBGR ? 0 : 2]);
+            uint32x4_t yLo = vdupq_n_u32(kY_Bias), yHi = yLo;
+            yLo = vmlal_n_u16(yLo, vget_low_u16 (r), kY_R);
+            yHi = vmlal_n_u16(yHi, vget_high_u16(r), kY_R);
+            yLo = vmlal_n_u16(yLo, vget_low_u16 (g), kY_G);
+            yHi = vmlal_n_u16(yHi, vget_high_u16(g), kY_G);
+            yLo = vmlal_n_u16(yLo, vget_low_u16 (b), kY_B);
+            yHi = vmlal_n_u16(yHi, vget_high_u16(b), kY_B);
+            vst1_u8(y + i, vmovn_u16(vcombine_u16(vshrn_n_u32(yLo, 15), vshrn_n_u32(yHi, 15))));
+
+            uint32x4_t cbLo = vdupq_n_u32(kCbCr_Bias), cbHi = cbLo;
+            cbLo = vmlal_n_u16(cbLo, vget_low_u16 (b), kCb_B);
+            cbHi = vmlal_n_u16(cbHi, vget_high_u16(b), kCb_B);
+            cbLo = vmlsl_n_u16(cbLo, vget_low_u16 (r), -kCb_R);
+            cbHi = vmlsl_n_u16(cbHi, vget_high_u16(r), -kCb_R);
+            cbLo = vmlsl_n_u16(cbLo, vget_low_u16 (g), -kCb_G);
+            cbHi = vmlsl_n_u16(cbHi, vget_high_u16(g), -kCb_G);
+            vst1_u8(cb + i, vmovn_u16(vcombine_u16(vshrn_n_u32(cbLo, 15),
+                                                   vshrn_n_u32(cbHi, 15))));
+
+            uint32x4_t crLo = vdupq_n_u32(kCbCr_Bias), crHi = crLo;
+            crLo = vmlal_n_u16(crLo, vget_low_u16 (r), kCr_R);
+            crHi = vmlal_n_u16(crHi, vget_high_u16(r), kCr_R);
+            crLo = vmlsl_n_u16(crLo, vget_low_u16 (g), -kCr_G);
+            crHi = vmlsl_n_u16(crHi, vget_high_u16(g), -kCr_G);
+            crLo = vmlsl_n_u16(crLo, vget_low_u16 (b), -kCr_B);
+            crHi = vmlsl_n_u16(crHi, vget_high_u16(b), -kCr_B);
+            vst1_u8(cr + i, vmovn_u16(vcombine_u16(vshrn_n_u32(crLo, 15),
+                                                   vshrn_n_u32(crHi, 15))));
+        }
+    #endif
+        for (; i < count; i++) {
+            int r = (src[i] >> (kBGR ? 16 : 0)) & 0xFF,
+                g = (src[i] >>  8)               & 0xFF,
+                b = (src[i] >> (kBGR ? 0 : 16)) & 0xFF;
+            y [i] = (uint8_t)((kY_R  * r + kY_G  * g + kY_B  * b + kY_Bias   ) >> 15);
+            cb[i] = (uint8_t)((kCb_R * r + kCb_G * g + kCb_B * b + kCbCr_Bias) >> 15);
+            cr[i] = (uint8_t)((kCr_R * r + kCr_G * g + kCr_B * b + kCbCr_Bias) >> 15);
+        }
+    }
+
+    /*not static*/ inline void RGBA_to_YCbCr(uint8_t* y, uint8_t* cb, uint8_t* cr,
+                                             const uint32_t* src, int count) {
+        to_YCbCr<false>(y, cb, cr, src, count);
+    }
+
+    /*not static*/ inline void BGRA_to_YCbCr(uint8_t* y, uint8_t* cb, uint8_t* cr,
+                                             const uint32_t* src, int count) {
+        to_YCbCr<true>(y, cb, cr, src, count);
+    }
+
+}  // namespace SK_OPTS_NS
+
+#endif//SkYCbCr_opts_DEFINED
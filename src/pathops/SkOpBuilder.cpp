@@ -11,6 +11,11 @@
 #include "SkPathPriv.h"
 #include "SkPathOps.h"
 #include "SkPathOpsCommon.h"
+#include "SkTaskGroup.h"
+
+#include <algorithm>
+#include <atomic>
+#include <vector>
 
 static bool one_contour(const SkPath& path) {
     SkSTArenaAlloc<256> allocator;
@@ -25,6 +30,68 @@ static bool one_contour(const SkPath& path) {
     return true;
 }
 
+// Interleaves the bits of x and y, so that sorting by the result walks a Z-order curve.
+static uint32_t z_order(uint16_t x, uint16_t y) {
+    auto spread = [](uint32_t v) {
+        v = (v | (v << 8)) & 0x00FF00FF;
+        v = (v | (v << 4)) & 0x0F0F0F0F;
+        v = (v | (v << 2)) & 0x33333333;
+        v = (v | (v << 1)) & 0x55555555;
+        return v;
+    };
+    return spread(x) | (spread(y) << 1);
+}
+
+/* Unions the paths pairwise, a level at a time, running each level's unions in parallel.
+   Paths are paired with their neighbors along a Z-order curve through their bounds' centers,
+   so that they are likely to overlap, and their unions stay small. The pairing depends only
+   on the paths, and each union only on its pair, so the result is exactly the same whether
+   the unions run on one thread or many. */
+static bool union_all(const SkTArray<SkPath>& paths, SkPath* result) {
+    int count = paths.count();
+    SkRect bounds = SkRect::MakeEmpty();
+    for (const SkPath& path : paths) {
+        bounds.join(path.getBounds());
+    }
+    SkScalar scaleX = bounds.width()  > 0 ? 65535 / bounds.width()  : 0,
+             scaleY = bounds.height() > 0 ? 65535 / bounds.height() : 0;
+    std::vector<std::pair<uint32_t, int>> order(count);
+    for (int index = 0; index < count; ++index) {
+        const SkRect& b = paths[index].getBounds();
+        auto x = (uint16_t) SkScalarTruncToInt((b.centerX() - bounds.fLeft) * scaleX),
+             y = (uint16_t) SkScalarTruncToInt((b.centerY() - bounds.fTop) * scaleY);
+        order[index] = { z_order(x, y), index };
+    }
+    std::sort(order.begin(), order.end());
+
+    SkTArray<SkPath> level(count);
+    for (const auto& entry : order) {
+        level.push_back(paths[entry.second]);
+    }
+    while (level.count() > 1) {
+        int pairs = level.count() / 2;
+        SkTArray<SkPath> next(pairs + 1);
+        next.push_back_n(pairs);
+        std::atomic<bool> success(true);
+        SkTaskGroup taskGroup;
+        taskGroup.batch(pairs, [&](int pair) {
+            if (!Op(level[2 * pair], level[2 * pair + 1], kUnion_SkPathOp, &next[pair])) {
+                success = false;
+            }
+        });
+        taskGroup.wait();
+        if (!success) {
+            return false;
+        }
+        if (level.count() & 1) {
+            next.push_back(std::move(level.back()));
+        }
+        level.swap(next);
+    }
+    *result = level[0];
+    return true;
+}
+
 void SkOpBuilder::ReversePath(SkPath* path) {
     SkPath temp;
     SkPoint lastPt;
@@ -159,6 +226,16 @@ bool SkOpBuilder::resolve(SkPath* result) {
         }
     }
     if (!allUnion) {
+        // Many operands that overlap are too slow to union one after another.
+        if (count > 2 && std::all_of(fOps.begin(), fOps.end(),
+                                     [](SkPathOp op) { return kUnion_SkPathOp == op; })) {
+            bool success = union_all(fPathRefs, result);
+            reset();
+            if (!success) {
+                *result = original;
+            }
+            return success;
+        }
         *result = fPathRefs[0];
         for (int index = 1; index < count; ++index) {
             if (!Op(*result, fPathRefs[index], fOps[index], result)) {
@@ -222,6 +222,145 @@ static const bool gOutInverse[kReverseDifference_SkPathOp + 1][2][2] = {
     {{ false, true }, { false, false }},  // rev diff
 };
 
+// Fast paths for operands simple enough not to need the general engine. Each takes the op
+// after gOpInverse has been applied, so it only ever works with the operands' interiors.
+
+// Returns the operand's vertices if it is a single convex contour made only of lines.
+static bool convex_polygon(const SkPath& path, SkTDArray<SkPoint>* poly) {
+    if (path.getSegmentMasks() != SkPath::kLine_SegmentMask || !path.isConvex()) {
+        return false;
+    }
+    SkPath::RawIter iter(path);
+    SkPoint pts[4];
+    SkPath::Verb verb;
+    int moves = 0;
+    while ((verb = iter.next(pts)) != SkPath::kDone_Verb) {
+        switch (verb) {
+            case SkPath::kMove_Verb:
+                if (++moves > 1) {
+                    return false;
+                }
+                poly->push_back(pts[0]);
+                break;
+            case SkPath::kLine_Verb:
+                poly->push_back(pts[1]);
+                break;
+            case SkPath::kClose_Verb:
+                break;
+            default:
+                return false;
+        }
+    }
+    if (poly->count() > 1 && (*poly)[0] == poly->top()) {
+        poly->pop();
+    }
+    return poly->count() >= 3;
+}
+
+static double polygon_area2(const SkTDArray<SkPoint>& poly) {
+    double area = 0;
+    for (int i = 0, j = poly.count() - 1; i < poly.count(); j = i++) {
+        area += (double) poly[j].fX * poly[i].fY - (double) poly[i].fX * poly[j].fY;
+    }
+    return area;
+}
+
+// Sutherland-Hodgman: clips the convex subject by each edge of the convex clip in turn.
+static void intersect_convex(const SkTDArray<SkPoint>& subject, const SkTDArray<SkPoint>& clip,
+                             SkPath* result) {
+    double clipSign = polygon_area2(clip) > 0 ? 1 : -1;
+    SkTDArray<SkPoint> in, out = subject;
+    for (int e = 0; e < clip.count() && out.count() >= 3; ++e) {
+        in.swap(out);
+        out.rewind();
+        const SkPoint& a = clip[e];
+        const SkPoint& b = clip[(e + 1) % clip.count()];
+        auto side = [&](const SkPoint& p) {
+            return clipSign * ((double) (b.fX - a.fX) * (p.fY - a.fY) -
+                               (double) (b.fY - a.fY) * (p.fX - a.fX));
+        };
+        SkPoint prev = in.top();
+        double prevSide = side(prev);
+        for (const SkPoint& curr : in) {
+            double currSide = side(curr);
+            if ((currSide >= 0) != (prevSide >= 0)) {
+                double t = prevSide / (prevSide - currSide);
+                out.push_back({ (float) (prev.fX + t * (curr.fX - prev.fX)),
+                           (float) (prev.fY + t * (curr.fY - prev.fY)) });
+            }
+            if (currSide >= 0) {
+                out.push_back(curr);
+            }
+            prev = curr;
+            prevSide = currSide;
+        }
+    }
+    // Drop the repeats left where the subject's vertices sit on the clip's edges.
+    int count = 0;
+    for (int i = 0; i < out.count(); ++i) {
+        if (0 == count || out[i] != out[count - 1]) {
+            out[count++] = out[i];
+        }
+    }
+    while (count > 1 && out[0] == out[count - 1]) {
+        --count;
+    }
+    out.setCount(count);
+    if (count >= 3 && polygon_area2(out) != 0) {
+        result->addPoly(out.begin(), count, true);
+    }
+}
+
+// The bounds of a path hold its control points, so operands with bounds that don't even touch
+// can't overlap.
+static bool disjoint_bounds(const SkPath& one, const SkPath& two) {
+    const SkRect& a = one.getBounds();
+    const SkRect& b = two.getBounds();
+    return a.fRight < b.fLeft || b.fRight < a.fLeft || a.fBottom < b.fTop || b.fBottom < a.fTop;
+}
+
+// Returns false if the op needs the general engine.  Otherwise, sets result to the op's
+// interior, leaving the fill type to the caller.
+static bool simple_op(const SkPath& one, const SkPath& two, SkPathOp op, SkPath* result) {
+    if (one == two) {
+        // (Both operands have the same fill type, so the op's inverse mapping treats them alike.)
+        if (kIntersect_SkPathOp == op || kUnion_SkPathOp == op) {
+            return Simplify(one, result);
+        }
+        result->reset();
+        return true;
+    }
+    if (disjoint_bounds(one, two)) {
+        SkPath other;
+        switch (op) {
+            case kIntersect_SkPathOp:
+                result->reset();
+                return true;
+            case kDifference_SkPathOp:
+                return Simplify(one, result);
+            case kReverseDifference_SkPathOp:
+                return Simplify(two, result);
+            case kUnion_SkPathOp:
+            case kXOR_SkPathOp:
+                // Once simplified, each operand is even-odd, and they don't overlap.
+                if (!Simplify(one, result) || !Simplify(two, &other)) {
+                    return false;
+                }
+                result->addPath(other);
+                return true;
+        }
+    }
+    SkTDArray<SkPoint> poly1, poly2;
+    if (kIntersect_SkPathOp == op && one.isFinite() && two.isFinite() &&
+            convex_polygon(one, &poly1) && convex_polygon(two, &poly2) &&
+            polygon_area2(poly1) != 0 && polygon_area2(poly2) != 0) {
+        result->reset();
+        intersect_convex(poly1, poly2, result);
+        return true;
+    }
+    return false;
+}
+
 #if DEBUG_T_SECT_LOOP_COUNT
 
 #include "SkMutex.h"
@@ -288,6 +427,10 @@ bool OpDebug(const SkPath& one, const SkPath& two, SkPathOp op, SkPath* result
         }
         return Simplify(work, result);
     }
+    if (simple_op(one, two, op, result)) {
+        result->setFillType(fillType);
+        return true;
+    }
     SkSTArenaAlloc<4096> allocator;  // FIXME: add a constant expression here, tune
     SkOpContour contour;
     SkOpContourHead* contourList = static_cast<SkOpContourHead*>(&contour);
@@ -8,11 +8,16 @@
 #include "SkDeflate.h"
 
 #include "SkData.h"
+#include "SkEndian.h"
 #include "SkMakeUnique.h"
 #include "SkMalloc.h"
+#include "SkTaskGroup.h"
 #include "SkTo.h"
 #include "SkTraceEvent.h"
 
+#include <atomic>
+#include <vector>
+
 #include "zlib.h"
 
 namespace {
@@ -55,23 +60,152 @@ static void do_deflate(int flush,
                  : returnValue == Z_OK);
 }
 
+// When compressing in parallel, the data is split into chunks of this many bytes, and this many
+// bytes are compressed at a time.
+#define SKDEFLATEWSTREAM_CHUNK_SIZE (128 * 1024)
+#define SKDEFLATEWSTREAM_BATCH_SIZE (16 * SKDEFLATEWSTREAM_CHUNK_SIZE)
+
+// Each chunk's compressor is primed with this much of the data before it, deflate's whole window.
+#define SKDEFLATEWSTREAM_DICTIONARY_SIZE (32 * 1024)
+
 // Hide all zlib impl details.
 struct SkDeflateWStream::Impl {
     SkWStream* fOut;
     unsigned char fInBuffer[SKDEFLATEWSTREAM_INPUT_BUFFER_SIZE];
     size_t fInBufferIndex;
     z_stream fZStream;
+
+    // When compressing in parallel, fZStream is unused.
+    SkExecutor* fExecutor;
+    int fCompressionLevel;
+    bool fGzip;
+    std::vector<unsigned char> fPending;     // Data not yet compressed.
+    std::vector<unsigned char> fDictionary;  // The end of the data already compressed.
+    uLong fCheck;                            // adler32 (or crc32 for gzip) of that data.
+    size_t fTotalIn;                         // How much of it there was.
+
+    void deflateInParallel(bool last);
 };
 
+// Compresses size bytes as raw deflate data continuing a stream which so far held dict.  Ends
+// with a sync flush, so that more data can follow, or with the final block if last.
+static bool deflate_chunk(const unsigned char* data, size_t size,
+                          const unsigned char* dict, size_t dictSize,
+                          int compressionLevel, bool last, SkWStream* out) {
+    z_stream zStream;
+    sk_bzero(&zStream, sizeof(zStream));
+    zStream.zalloc = &skia_alloc_func;
+    zStream.zfree = &skia_free_func;
+    if (Z_OK != deflateInit2(&zStream, compressionLevel, Z_DEFLATED, -0x0F,
+                             8, Z_DEFAULT_STRATEGY)) {
+        return false;
+    }
+    bool ok = !dictSize ||
+              Z_OK == deflateSetDictionary(&zStream, dict, SkToUInt(dictSize));
+    zStream.next_in = const_cast<unsigned char*>(data);
+    zStream.avail_in = SkToUInt(size);
+    unsigned char outBuffer[SKDEFLATEWSTREAM_OUTPUT_BUFFER_SIZE];
+    while (ok) {
+        zStream.next_out = outBuffer;
+        zStream.avail_out = sizeof(outBuffer);
+        int result = deflate(&zStream, last ? Z_FINISH : Z_SYNC_FLUSH);
+        ok = (Z_OK == result || Z_STREAM_END == result || Z_BUF_ERROR == result) &&
+             out->write(outBuffer, sizeof(outBuffer) - zStream.avail_out);
+        if (last ? Z_STREAM_END == result : zStream.avail_out != 0) {
+            break;
+        }
+    }
+    (void)deflateEnd(&zStream);
+    return ok;
+}
+
+// Compresses fPending in chunks on fExecutor, and writes them to fOut, with the zlib or gzip
+// header first and the trailer if this is the last of the data.
+void SkDeflateWStream::Impl::deflateInParallel(bool last) {
+    const std::vector<unsigned char>& pending = fPending;
+    const int chunks = SkTMax(1, SkToInt((pending.size() + SKDEFLATEWSTREAM_CHUNK_SIZE - 1) /
+                                         SKDEFLATEWSTREAM_CHUNK_SIZE));
+    std::vector<SkDynamicMemoryWStream> compressed(chunks);
+    std::vector<uLong> checks(chunks);
+    std::atomic<bool> failed{false};
+    SkTaskGroup(*fExecutor).batch(chunks, [&](int i) {
+        size_t start = i * SKDEFLATEWSTREAM_CHUNK_SIZE,
+               size = SkTMin<size_t>(pending.size() - start, SKDEFLATEWSTREAM_CHUNK_SIZE);
+        const unsigned char* data = pending.data() + start;
+        const unsigned char* dict = data - SkTMin<size_t>(start, SKDEFLATEWSTREAM_DICTIONARY_SIZE);
+        size_t dictSize = data - dict;
+        if (0 == i) {
+            dict = fDictionary.data();
+            dictSize = fDictionary.size();
+        }
+        checks[i] = fGzip ? crc32(crc32(0, nullptr, 0), data, SkToUInt(size))
+                          : adler32(adler32(0, nullptr, 0), data, SkToUInt(size));
+        if (!deflate_chunk(data, size, dict, dictSize, fCompressionLevel,
+                           last && i == chunks - 1, &compressed[i])) {
+            failed.store(true, std::memory_order_relaxed);
+        }
+    });
+    SkASSERT(!failed.load());
+
+    if (0 == fTotalIn) {
+        if (fGzip) {
+            // No name, no modification time, unknown OS.
+            static const unsigned char kGzipHeader[] = { 0x1F, 0x8B, 8, 0, 0, 0, 0, 0, 0, 0xFF };
+            fOut->write(kGzipHeader, sizeof(kGzipHeader));
+        } else {
+            // Deflate with a 32K window, and roughly how hard we tried.
+            int level = fCompressionLevel < 0 ? 6 : fCompressionLevel;
+            unsigned cmf = 0x78,
+                     flg = (level < 2 ? 0 : level < 6 ? 1 : level == 6 ? 2 : 3) << 6;
+            flg += 31 - (cmf * 256 + flg) % 31;
+            fOut->write8(cmf);
+            fOut->write8(flg);
+        }
+    }
+    for (int i = 0; i < chunks; i++) {
+        size_t size = SkTMin<size_t>(pending.size() - i * SKDEFLATEWSTREAM_CHUNK_SIZE,
+                                     SKDEFLATEWSTREAM_CHUNK_SIZE);
+        fCheck = fGzip ? crc32_combine(fCheck, checks[i], size)
+                       : adler32_combine(fCheck, checks[i], size);
+        fTotalIn += size;
+        compressed[i].writeToAndReset(fOut);
+    }
+    if (last) {
+        if (fGzip) {
+            fOut->write32(SkEndian_SwapLE32(SkToU32(fCheck)));
+            fOut->write32(SkEndian_SwapLE32(SkToU32(fTotalIn)));
+        } else {
+            fOut->write32(SkEndian_SwapBE32(SkToU32(fCheck)));
+        }
+    }
+
+    // Keep the end of the data to prime the next chunk with.
+    fDictionary.insert(fDictionary.end(), pending.begin(), pending.end());
+    if (fDictionary.size() > SKDEFLATEWSTREAM_DICTIONARY_SIZE) {
+        fDictionary.erase(fDictionary.begin(),
+                          fDictionary.end() - SKDEFLATEWSTREAM_DICTIONARY_SIZE);
+    }
+    fPending.clear();
+}
+
 SkDeflateWStream::SkDeflateWStream(SkWStream* out,
                                    int compressionLevel,
-                                   bool gzip)
+                                   bool gzip,
+                                   SkExecutor* executor)
     : fImpl(skstd::make_unique<SkDeflateWStream::Impl>()) {
     fImpl->fOut = out;
     fImpl->fInBufferIndex = 0;
+    fImpl->fExecutor = executor;
+    fImpl->fCompressionLevel = compressionLevel;
+    fImpl->fGzip = gzip;
+    fImpl->fCheck = gzip ? crc32(0, nullptr, 0) : adler32(0, nullptr, 0);
+    fImpl->fTotalIn = 0;
     if (!fImpl->fOut) {
         return;
     }
+    if (fImpl->fExecutor) {
+        return;
+    }
     fImpl->fZStream.next_in = nullptr;
     fImpl->fZStream.zalloc = &skia_alloc_func;
     fImpl->fZStream.zfree = &skia_free_func;
@@ -90,6 +224,11 @@ void SkDeflateWStream::finalize() {
     if (!fImpl->fOut) {
         return;
     }
+    if (fImpl->fExecutor) {
+        fImpl->deflateInParallel(true);
+        fImpl->fOut = nullptr;
+        return;
+    }
     do_deflate(Z_FINISH, &fImpl->fZStream, fImpl->fOut, fImpl->fInBuffer,
                fImpl->fInBufferIndex);
     (void)deflateEnd(&fImpl->fZStream);
@@ -101,6 +240,20 @@ bool SkDeflateWStream::write(const void* void_buffer, size_t len) {
     if (!fImpl->fOut) {
         return false;
     }
+    if (fImpl->fExecutor) {
+        const unsigned char* buffer = (const unsigned char*)void_buffer;
+        std::vector<unsigned char>& pending = fImpl->fPending;
+        while (len > 0) {
+            size_t tocopy = SkTMin(len, SKDEFLATEWSTREAM_BATCH_SIZE - pending.size());
+            pending.insert(pending.end(), buffer, buffer + tocopy);
+            len -= tocopy;
+            buffer += tocopy;
+            if (SKDEFLATEWSTREAM_BATCH_SIZE == pending.size()) {
+                fImpl->deflateInParallel(false);
+            }
+        }
+        return true;
+    }
     const char* buffer = (const char*)void_buffer;
     while (len > 0) {
         size_t tocopy =
@@ -122,5 +275,8 @@ bool SkDeflateWStream::write(const void* void_buffer, size_t len) {
 }
 
 size_t SkDeflateWStream::bytesWritten() const {
+    if (fImpl->fExecutor) {
+        return fImpl->fTotalIn + fImpl->fPending.size();
+    }
     return fImpl->fZStream.total_in + fImpl->fInBufferIndex;
 }
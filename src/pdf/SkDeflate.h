@@ -11,6 +11,8 @@
 
 #include "SkStream.h"
 
+class SkExecutor;
+
 /**
   * Wrap a stream in this class to compress the information written to
   * this stream using the Deflate algorithm.
@@ -29,10 +31,16 @@ public:
         a wrapper, documented in RFC 1952, around a deflate stream."
         gzip adds a header with a magic number to the beginning of the
         stream, alowing a client to identify a gzip file.
+
+        @param executor if not null, the data is compressed in independent
+        chunks on this executor, each chunk's compressor primed with the
+        data before it.  The output is still a single stream, a little
+        bigger than a serial compressor's.
      */
     SkDeflateWStream(SkWStream*,
                      int compressionLevel = -1,
-                     bool gzip = false);
+                     bool gzip = false,
+                     SkExecutor* executor = nullptr);
 
     /** The destructor calls finalize(). */
     ~SkDeflateWStream() override;
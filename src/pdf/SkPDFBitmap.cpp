@@ -10,12 +10,15 @@
 #include "SkColorData.h"
 #include "SkData.h"
 #include "SkDeflate.h"
+#include "SkExecutor.h"
 #include "SkImage.h"
 #include "SkImageInfoPriv.h"
 #include "SkJpegInfo.h"
+#include "SkPDFCanon.h"
 #include "SkPDFDocumentPriv.h"
 #include "SkPDFTypes.h"
 #include "SkPDFUtils.h"
+#include "SkPngInfo.h"
 #include "SkStream.h"
 #include "SkTo.h"
 
@@ -120,13 +123,12 @@ static SkPDFIndirectReference do_deflated_alpha(const SkPixmap& pm, SkPDFDocumen
     return ref;
 }
 
-static SkPDFIndirectReference do_deflated_image(const SkPixmap& pm,
-                                                SkPDFDocument* doc,
-                                                bool isOpaque) {
-    SkPDFIndirectReference sMask;
-    if (!isOpaque) {
-        sMask = doc->reserve();
-    }
+static void do_deflated_image(const SkPixmap& pm,
+                              SkPDFDocument* doc,
+                              bool isOpaque,
+                              SkPDFIndirectReference ref,
+                              SkPDFIndirectReference sMask) {
+    SkASSERT(isOpaque == (sMask.fValue == -1));
     SkDynamicMemoryWStream buffer;
     SkDeflateWStream deflateWStream(&buffer);
     const char* colorSpace = "DeviceGray";
@@ -167,7 +169,6 @@ static SkPDFIndirectReference do_deflated_image(const SkPixmap& pm,
             deflateWStream.write(byteBuffer, dst - byteBuffer);
     }
     deflateWStream.finalize();
-    SkPDFIndirectReference ref = doc->reserve();
     SkWStream* stream = doc->beginObject(ref);
     emit_dict(stream, pm.info().dimensions(), colorSpace,
               sMask.fValue != -1 ? &sMask : nullptr,
@@ -177,11 +178,9 @@ static SkPDFIndirectReference do_deflated_image(const SkPixmap& pm,
     if (!isOpaque) {
         do_deflated_alpha(pm, doc, sMask);
     }
-    return ref;
 }
 
-static bool do_jpeg(const SkData& data, SkPDFDocument* doc, SkISize size,
-                    SkPDFIndirectReference* result) {
+static bool is_jpeg(const SkData& data, SkISize size, bool* yuv) {
     SkISize jpegSize;
     SkEncodedInfo::Color jpegColorType;
     SkEncodedOrigin exifOrientation;
@@ -189,24 +188,24 @@ static bool do_jpeg(const SkData& data, SkPDFDocument* doc, SkISize size,
                        &jpegColorType, &exifOrientation)) {
         return false;
     }
-    bool yuv = jpegColorType == SkEncodedInfo::kYUV_Color;
-    bool goodColorType = yuv || jpegColorType == SkEncodedInfo::kGray_Color;
-    if (jpegSize != size  // Sanity check.
-            || !goodColorType
-            || kTopLeft_SkEncodedOrigin != exifOrientation) {
-        return false;
-    }
+    *yuv = jpegColorType == SkEncodedInfo::kYUV_Color;
+    bool goodColorType = *yuv || jpegColorType == SkEncodedInfo::kGray_Color;
+    return jpegSize == size  // Sanity check.
+           && goodColorType
+           && kTopLeft_SkEncodedOrigin == exifOrientation;
+}
+
+static void do_jpeg(const SkData& data, bool yuv, SkISize size, SkPDFDocument* doc,
+                    SkPDFIndirectReference ref) {
     #ifdef SK_PDF_IMAGE_STATS
     gJpegImageObjects.fetch_add(1);
     #endif
-    SkPDFIndirectReference ref = doc->reserve();
-    *result = ref;
     SkWStream* stream = doc->beginObject(ref);
 
     SkPDFDict pdfDict("XObject");
     pdfDict.insertName("Subtype", "Image");
-    pdfDict.insertInt("Width", jpegSize.width());
-    pdfDict.insertInt("Height", jpegSize.height());
+    pdfDict.insertInt("Width", size.width());
+    pdfDict.insertInt("Height", size.height());
     if (yuv) {
         pdfDict.insertName("ColorSpace", "DeviceRGB");
     } else {
@@ -221,7 +220,44 @@ static bool do_jpeg(const SkData& data, SkPDFDocument* doc, SkISize size,
     stream->write(data.data(), data.size());
     stream->writeText("\nendstream");
     doc->endObject();
-    return true;
+}
+
+static bool is_png(const SkData& data, SkISize size) {
+    SkISize pngSize;
+    return SkGetPngInfo(data.data(), data.size(), &pngSize, nullptr, nullptr)
+           && pngSize == size;  // Sanity check.
+}
+
+// The compressed data of a PNG is a zlib stream of rows, each after one of the PNG filters.  That
+// is exactly what FlateDecode reads when given a PNG predictor, so it can be copied over as is.
+static void do_png(const SkData& data, SkISize size, SkPDFDocument* doc,
+                   SkPDFIndirectReference ref) {
+    #ifdef SK_PDF_IMAGE_STATS
+    gRegularImageObjects.fetch_add(1);
+    #endif
+    SkEncodedInfo::Color pngColorType;
+    SkDynamicMemoryWStream idat;
+    SkAssertResult(SkGetPngInfo(data.data(), data.size(), nullptr, &pngColorType, &idat));
+    bool gray = pngColorType == SkEncodedInfo::kGray_Color;
+    SkWStream* stream = doc->beginObject(ref);
+
+    SkPDFDict pdfDict("XObject");
+    pdfDict.insertName("Subtype", "Image");
+    pdfDict.insertInt("Width", size.width());
+    pdfDict.insertInt("Height", size.height());
+    pdfDict.insertName("ColorSpace", gray ? "DeviceGray" : "DeviceRGB");
+    pdfDict.insertInt("BitsPerComponent", 8);
+    pdfDict.insertName("Filter", "FlateDecode");
+    auto decodeParms = sk_make_sp<SkPDFDict>();
+    decodeParms->insertInt("Predictor", 15);  // Any PNG filter, chosen per row.
+    decodeParms->insertInt("Colors", gray ? 1 : 3);
+    decodeParms->insertInt("BitsPerComponent", 8);
+    decodeParms->insertInt("Columns", size.width());
+    pdfDict.insertObject("DecodeParms", std::move(decodeParms));
+    pdfDict.insertInt("Length", SkToInt(idat.bytesWritten()));
+    pdfDict.emitObject(stream);
+    emit_stream(&idat, stream);
+    doc->endObject();
 }
 
 static SkBitmap to_pixels(const SkImage* image) {
@@ -247,26 +283,99 @@ static SkBitmap to_pixels(const SkImage* image) {
     return bm;
 }
 
+static void encode_image(const SkImage* img,
+                         const SkPixmap& pm,
+                         bool isOpaque,
+                         int encodingQuality,
+                         SkPDFDocument* doc,
+                         SkPDFIndirectReference ref,
+                         SkPDFIndirectReference sMask) {
+    if (encodingQuality <= 100 && isOpaque) {
+        sk_sp<SkData> data = img->encodeToData(SkEncodedImageFormat::kJPEG, encodingQuality);
+        bool yuv;
+        if (data && is_jpeg(*data, img->dimensions(), &yuv)) {
+            do_jpeg(*data, yuv, img->dimensions(), doc, ref);
+            return;
+        }
+    }
+    do_deflated_image(pm, doc, isOpaque, ref, sMask);
+}
+
+static SkPDFImageDigest make_digest(const void* bytes, size_t size, SkISize dimensions,
+                                    uint32_t pixelFormat, int encodingQuality) {
+    SkPDFImageDigest digest;
+    memset(&digest, 0, sizeof(digest));  // No padding, but be sure memcmp() can't see garbage.
+    SkMD5 md5;
+    md5.write(bytes, size);
+    md5.finish(digest.fDigest);
+    digest.fWidth = dimensions.width();
+    digest.fHeight = dimensions.height();
+    digest.fPixelFormat = pixelFormat;
+    digest.fEncodingQuality = encodingQuality;
+    return digest;
+}
+
 SkPDFIndirectReference SkPDFSerializeImage(const SkImage* img,
                                            SkPDFDocument* doc,
                                            int encodingQuality) {
-    SkPDFIndirectReference result;
     SkASSERT(img);
     SkASSERT(doc);
     SkASSERT(encodingQuality >= 0);
+    SkPDFCanon* canon = doc->canon();
     SkISize dimensions = img->dimensions();
     sk_sp<SkData> data = img->refEncodedData();
-    if (data && do_jpeg(*data, doc, dimensions, &result)) {
-        return result;
+    // The same pixels often arrive as different SkImages, e.g. a logo decoded once per page.
+    // Those are found by a digest of their contents, encoded data if they have it.
+    SkPDFImageDigest digest;
+    if (data) {
+        digest = make_digest(data->data(), data->size(), dimensions, 0, encodingQuality);
+        if (SkPDFIndirectReference* ref = canon->fImageDigestMap.find(digest)) {
+            return *ref;
+        }
+        bool yuv;
+        if (is_jpeg(*data, dimensions, &yuv)) {
+            SkPDFIndirectReference ref = doc->reserve();
+            canon->fImageDigestMap.set(digest, ref);
+            do_jpeg(*data, yuv, dimensions, doc, ref);
+            return ref;
+        }
+        // A PNG's own compression is kept unless a lossy encoding was asked for.
+        if (encodingQuality > 100 && is_png(*data, dimensions)) {
+            SkPDFIndirectReference ref = doc->reserve();
+            canon->fImageDigestMap.set(digest, ref);
+            do_png(*data, dimensions, doc, ref);
+            return ref;
+        }
     }
     SkBitmap bm = to_pixels(img);
-    SkPixmap pm = bm.pixmap();
-    bool isOpaque = pm.isOpaque() || pm.computeIsOpaque();
-    if (encodingQuality <= 100 && isOpaque) {
-        sk_sp<SkData> data = img->encodeToData(SkEncodedImageFormat::kJPEG, encodingQuality);
-        if (data && do_jpeg(*data, doc, dimensions, &result)) {
-            return result;
+    if (!data) {
+        const SkPixmap& pm = bm.pixmap();
+        SkASSERT(pm.rowBytes() == pm.info().minRowBytes());
+        uint32_t pixelFormat = 1 << 16 | pm.colorType() << 8 | pm.alphaType();
+        digest = make_digest(pm.addr(), pm.computeByteSize(), dimensions, pixelFormat,
+                             encodingQuality);
+        if (SkPDFIndirectReference* ref = canon->fImageDigestMap.find(digest)) {
+            return *ref;
         }
     }
-    return do_deflated_image(pm, doc, isOpaque);
+    // Decide on the soft mask here, so references are reserved in the same order whether or
+    // not the encoding runs on an executor.
+    bool isOpaque = bm.pixmap().isOpaque() || bm.pixmap().computeIsOpaque();
+    SkPDFIndirectReference sMask;
+    if (!isOpaque) {
+        sMask = doc->reserve();
+    }
+    SkPDFIndirectReference ref = doc->reserve();
+    canon->fImageDigestMap.set(digest, ref);
+    if (SkExecutor* executor = doc->executor()) {
+        sk_sp<const SkImage> image = sk_ref_sp(img);
+        doc->incrementJobCount();
+        executor->add([image, bm, isOpaque, encodingQuality, doc, ref, sMask]() {
+            encode_image(image.get(), bm.pixmap(), isOpaque, encodingQuality, doc, ref, sMask);
+            doc->signalJobComplete();
+        });
+        return ref;
+    }
+    encode_image(img, bm.pixmap(), isOpaque, encodingQuality, doc, ref, sMask);
+    return ref;
 }
@@ -7,12 +7,31 @@
 #ifndef SkPDFBitmap_DEFINED
 #define SkPDFBitmap_DEFINED
 
+#include "SkMD5.h"
+
 class SkImage;
 class SkPDFDocument;
 struct SkPDFIndirectReference;
 
 /**
- * Serialize a SkImage as an Image Xobject.
+ *  Identifies an image by content rather than by unique ID: a digest of its encoded data or, if
+ *  it has none, of its pixels.
+ */
+struct SkPDFImageDigest {
+    SkMD5::Digest fDigest;
+    int32_t       fWidth;
+    int32_t       fHeight;
+    uint32_t      fPixelFormat;  // Zero for encoded data, otherwise color and alpha types.
+    int32_t       fEncodingQuality;
+
+    bool operator==(const SkPDFImageDigest& that) const {
+        return 0 == memcmp(this, &that, sizeof(*this));
+    }
+};
+
+/**
+ * Serialize a SkImage as an Image Xobject.  An image with the same contents as one already in
+ * the document is not serialized again; its reference is returned instead.
  *  quality > 100 means lossless
  */
 SkPDFIndirectReference SkPDFSerializeImage(const SkImage* img,
@@ -11,14 +11,16 @@
 
 #include "SkBitmapKey.h"
 #include "SkMacros.h"
+#include "SkPDFBitmap.h"
 #include "SkPDFGradientShader.h"
 #include "SkPDFGraphicState.h"
 #include "SkPDFShader.h"
 #include "SkString.h"
-#include "SkTHash.h"
+#include "SkTSwissHash.h"
 #include "SkTypeface.h"
 
 class SkPDFFont;
+class SkPDFFontCache;
 struct SkAdvancedTypefaceMetrics;
 
 /**
@@ -34,21 +36,24 @@ public:
     SkPDFCanon& operator=(SkPDFCanon&&);
     SkPDFCanon& operator=(const SkPDFCanon&) = delete;
 
-    SkTHashMap<SkPDFImageShaderKey, sk_sp<SkPDFObject>> fImageShaderMap;
+    SkTSwissHashMap<SkPDFImageShaderKey, sk_sp<SkPDFObject>> fImageShaderMap;
 
     SkPDFGradientShader::HashMap fGradientPatternMap;
 
-    SkTHashMap<SkBitmapKey, sk_sp<SkPDFObject>> fPDFBitmapMap;
+    SkTSwissHashMap<SkBitmapKey, sk_sp<SkPDFObject>> fPDFBitmapMap;
+    SkTSwissHashMap<SkPDFImageDigest, SkPDFIndirectReference> fImageDigestMap;
 
-    SkTHashMap<uint32_t, std::unique_ptr<SkAdvancedTypefaceMetrics>> fTypefaceMetrics;
-    SkTHashMap<uint32_t, std::vector<SkString>> fType1GlyphNames;
-    SkTHashMap<uint32_t, std::vector<SkUnichar>> fToUnicodeMap;
-    SkTHashMap<uint32_t, SkPDFIndirectReference> fFontDescriptors;
-    SkTHashMap<uint32_t, SkPDFIndirectReference> fType3FontDescriptors;
-    SkTHashMap<uint64_t, SkPDFFont> fFontMap;
+    SkTSwissHashMap<uint32_t, std::unique_ptr<SkAdvancedTypefaceMetrics>> fTypefaceMetrics;
+    SkTSwissHashMap<uint32_t, std::vector<SkString>> fType1GlyphNames;
+    SkTSwissHashMap<uint32_t, std::vector<SkUnichar>> fToUnicodeMap;
+    SkTSwissHashMap<uint32_t, SkPDFIndirectReference> fFontDescriptors;
+    SkTSwissHashMap<uint32_t, SkPDFIndirectReference> fType3FontDescriptors;
+    SkTSwissHashMap<uint64_t, SkPDFFont> fFontMap;
+    // Font data shared with other documents, if the document's metadata has a cache for it.
+    SkPDFFontCache* fFontCache = nullptr;
 
-    SkTHashMap<SkPDFStrokeGraphicState, sk_sp<SkPDFDict>> fStrokeGSMap;
-    SkTHashMap<SkPDFFillGraphicState, sk_sp<SkPDFDict>> fFillGSMap;
+    SkTSwissHashMap<SkPDFStrokeGraphicState, sk_sp<SkPDFDict>> fStrokeGSMap;
+    SkTSwissHashMap<SkPDFFillGraphicState, sk_sp<SkPDFDict>> fFillGSMap;
 
     sk_sp<SkPDFStream> fInvertFunction;
     sk_sp<SkPDFDict> fNoSmaskGraphicState;
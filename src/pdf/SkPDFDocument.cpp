@@ -11,6 +11,7 @@
 #include "SkMakeUnique.h"
 #include "SkPDFCanon.h"
 #include "SkPDFDevice.h"
+#include "SkPDFFontCache.h"
 #include "SkPDFTag.h"
 #include "SkPDFUtils.h"
 #include "SkStream.h"
@@ -216,6 +217,8 @@ SkPDFDocument::SkPDFDocument(SkWStream* stream,
     if (fMetadata.fStructureElementTreeRoot) {
         fTagRoot = recursiveBuildTagTree(*fMetadata.fStructureElementTreeRoot, nullptr);
     }
+    // fMetadata keeps the cache alive.
+    fCanon.fFontCache = static_cast<SkPDFFontCache*>(fMetadata.fFontCache.get());
 }
 
 SkPDFDocument::~SkPDFDocument() {
@@ -225,6 +228,7 @@ SkPDFDocument::~SkPDFDocument() {
 
 SkPDFIndirectReference SkPDFDocument::serialize(const sk_sp<SkPDFObject>& object) {
     SkASSERT(object);
+    SkAutoMutexAcquire lock(fMutex);
     fObjectSerializer.serializeObject(object, this->getStream());
     return object->fIndirectReference;
 }
@@ -242,13 +246,26 @@ SkPDFIndirectReference SkPDFDocument::reserve() {
 };
 
 SkWStream* SkPDFDocument::beginObject(SkPDFIndirectReference ref) {
+    fMutex.acquire();  // Released in endObject().
     --fOutstandingRefs;
     return fObjectSerializer.beginObject(ref, this->getStream());
 };
 void SkPDFDocument::endObject() {
     fObjectSerializer.endObject(this->getStream());
+    fMutex.release();
 };
 
+void SkPDFDocument::incrementJobCount() { ++fJobCount; }
+
+void SkPDFDocument::signalJobComplete() { fSemaphore.signal(); }
+
+void SkPDFDocument::waitForJobs() {
+    while (fJobCount > 0) {
+        fSemaphore.wait();
+        --fJobCount;
+    }
+}
+
 static SkSize operator*(SkISize u, SkScalar s) { return SkSize{u.width() * s, u.height() * s}; }
 static SkSize operator*(SkSize u, SkScalar s) { return SkSize{u.width() * s, u.height() * s}; }
 
@@ -295,20 +312,23 @@ void SkPDFDocument::onEndPage() {
     auto page = sk_make_sp<SkPDFDict>("Page");
 
     SkSize mediaSize = fPageDevice->imageInfo().dimensions() * fInverseRasterScale;
-    auto contentObject = sk_make_sp<SkPDFStream>(fPageDevice->content());
+    std::unique_ptr<SkStreamAsset> content = fPageDevice->content();
     auto resourceDict = fPageDevice->makeResourceDict();
     auto annotations = fPageDevice->getAnnotations();
     fPageDevice->appendDestinations(fDests.get(), page.get());
     fPageDevice = nullptr;
 
-    page->insertObject("Resources", resourceDict);
+    // Write out the resources (and everything they reference that has not been written yet)
+    // now, so that their data can be freed instead of being kept alive until onClose().
+    // Objects shared through the SkPDFCanon keep their indirect reference after being written,
+    // so later pages still reuse them.
+    page->insertRef("Resources", this->serialize(resourceDict));
     page->insertObject("MediaBox", SkPDFUtils::RectToArray(SkRect::MakeSize(mediaSize)));
 
     if (annotations) {
-        page->insertObject("Annots", std::move(annotations));
+        page->insertRef("Annots", this->serialize(annotations));
     }
-    this->serialize(contentObject);
-    page->insertObjRef("Contents", std::move(contentObject));
+    page->insertRef("Contents", SkPDFStreamOut(nullptr, std::move(content), this));
     // The StructParents unique identifier for each page is just its
     // 0-based page index.
     page->insertInt("StructParents", static_cast<int>(fPages.size()));
@@ -316,6 +336,7 @@ void SkPDFDocument::onEndPage() {
 }
 
 void SkPDFDocument::onAbort() {
+    this->waitForJobs();
     this->reset();
 }
 
@@ -593,10 +614,11 @@ void SkPDFDocument::onClose(SkWStream* stream) {
             }
         }
     }
-    fObjectSerializer.serializeObject(docCatalog, this->getStream());
+    this->serialize(docCatalog);
     for (const SkPDFFont* f : get_fonts(fCanon)) {
         f->emitSubset(this);
     }
+    this->waitForJobs();
     SkASSERT(fOutstandingRefs == 0);
     fObjectSerializer.serializeFooter(this->getStream(), docCatalog, fID);
     this->reset();
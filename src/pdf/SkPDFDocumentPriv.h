@@ -12,7 +12,12 @@
 #include "SkPDFCanon.h"
 #include "SkPDFFont.h"
 #include "SkPDFMetadata.h"
+#include "SkMutex.h"
+#include "SkSemaphore.h"
 
+#include <atomic>
+
+class SkExecutor;
 class SkPDFDevice;
 class SkPDFTag;
 
@@ -81,10 +86,19 @@ public:
     // Returns -1 if no mark ID.
     int getMarkIdForNodeId(int nodeId);
 
+    // Object numbers are only reserved on the thread that owns the document, so they do not
+    // depend on the order in which jobs run.  beginObject() and endObject() may be called from
+    // any thread; the stream is locked from beginObject() until the matching endObject().
     SkPDFIndirectReference reserve();
     SkWStream* beginObject(SkPDFIndirectReference);
     void endObject();
 
+    SkExecutor* executor() const { return fMetadata.fExecutor; }
+    // Call incrementJobCount() before handing a job to executor(), and signalJobComplete()
+    // from the job once it is done writing.
+    void incrementJobCount();
+    void signalJobComplete();
+
 private:
     sk_sp<SkPDFTag> recursiveBuildTagTree(const SkPDF::StructureElementNode& node,
                                           sk_sp<SkPDFTag> parent);
@@ -110,8 +124,12 @@ private:
     // A mapping from node ID to tag for fast lookup.
     SkTHashMap<int, sk_sp<SkPDFTag>> fNodeIdToTag;
 
-    int fOutstandingRefs = 0;
+    SkMutex fMutex;
+    SkSemaphore fSemaphore;
+    std::atomic<int> fJobCount{0};
+    std::atomic<int> fOutstandingRefs{0};
 
+    void waitForJobs();
     void reset();
 };
 
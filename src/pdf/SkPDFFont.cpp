@@ -8,6 +8,7 @@
 #include "SkPDFFont.h"
 
 #include "SkData.h"
+#include "SkExecutor.h"
 #include "SkFont.h"
 #include "SkGlyphCache.h"
 #include "SkImagePriv.h"
@@ -18,6 +19,7 @@
 #include "SkPDFConvertType1FontStream.h"
 #include "SkPDFDevice.h"
 #include "SkPDFDocumentPriv.h"
+#include "SkPDFFontCache.h"
 #include "SkPDFMakeCIDGlyphWidthsArray.h"
 #include "SkPDFMakeToUnicodeCmap.h"
 #include "SkPDFResourceDict.h"
@@ -31,14 +33,16 @@
 #include "SkTypes.h"
 #include "SkUTF.h"
 
+static int units_per_em(const SkTypeface* face) {
+    int unitsPerEm = face->getUnitsPerEm();
+    return unitsPerEm > 0 ? unitsPerEm : 1024;
+}
+
 SkExclusiveStrikePtr SkPDFFont::MakeVectorCache(SkTypeface* face, int* size) {
     SkFont font;
     font.setHinting(kNo_SkFontHinting);
     font.setTypeface(sk_ref_sp(face));
-    int unitsPerEm = face->getUnitsPerEm();
-    if (unitsPerEm <= 0) {
-        unitsPerEm = 1024;
-    }
+    int unitsPerEm = units_per_em(face);
     if (size) {
         *size = unitsPerEm;
     }
@@ -104,24 +108,8 @@ static bool can_embed(const SkAdvancedTypefaceMetrics& metrics) {
     return !SkToBool(metrics.fFlags & SkAdvancedTypefaceMetrics::kNotEmbeddable_FontFlag);
 }
 
-const SkAdvancedTypefaceMetrics* SkPDFFont::GetMetrics(const SkTypeface* typeface,
-                                                       SkPDFCanon* canon) {
-    SkASSERT(typeface);
-    SkFontID id = typeface->uniqueID();
-    if (std::unique_ptr<SkAdvancedTypefaceMetrics>* ptr = canon->fTypefaceMetrics.find(id)) {
-        return ptr->get();  // canon retains ownership.
-    }
-    int count = typeface->countGlyphs();
-    if (count <= 0 || count > 1 + SkTo<int>(UINT16_MAX)) {
-        // Cache nullptr to skip this check.  Use SkSafeUnref().
-        canon->fTypefaceMetrics.set(id, nullptr);
-        return nullptr;
-    }
-    std::unique_ptr<SkAdvancedTypefaceMetrics> metrics = typeface->getAdvancedMetrics();
-    if (!metrics) {
-        metrics = skstd::make_unique<SkAdvancedTypefaceMetrics>();
-    }
-
+static void guess_missing_metrics(const SkTypeface* typeface,
+                                  SkAdvancedTypefaceMetrics* metrics) {
     if (0 == metrics->fStemV || 0 == metrics->fCapHeight) {
         SkPaint tmpPaint;
         tmpPaint.setHinting(kNo_SkFontHinting);
@@ -149,6 +137,37 @@ const SkAdvancedTypefaceMetrics* SkPDFFont::GetMetrics(const SkTypeface* typefac
             metrics->fCapHeight = SkToS16(SkScalarRoundToInt(capHeight / 2));
         }
     }
+}
+
+const SkAdvancedTypefaceMetrics* SkPDFFont::GetMetrics(const SkTypeface* typeface,
+                                                       SkPDFCanon* canon) {
+    SkASSERT(typeface);
+    SkFontID id = typeface->uniqueID();
+    if (std::unique_ptr<SkAdvancedTypefaceMetrics>* ptr = canon->fTypefaceMetrics.find(id)) {
+        return ptr->get();  // canon retains ownership.
+    }
+    std::unique_ptr<SkAdvancedTypefaceMetrics> metrics;
+    SkPDFFontCache* fontCache = canon->fFontCache;
+    if (fontCache && fontCache->findMetrics(id, &metrics)) {
+        return canon->fTypefaceMetrics.set(id, std::move(metrics))->get();
+    }
+    int count = typeface->countGlyphs();
+    if (count <= 0 || count > 1 + SkTo<int>(UINT16_MAX)) {
+        // Cache nullptr to skip this check.  Use SkSafeUnref().
+        if (fontCache) {
+            fontCache->addMetrics(id, nullptr);
+        }
+        canon->fTypefaceMetrics.set(id, nullptr);
+        return nullptr;
+    }
+    metrics = typeface->getAdvancedMetrics();
+    if (!metrics) {
+        metrics = skstd::make_unique<SkAdvancedTypefaceMetrics>();
+    }
+    guess_missing_metrics(typeface, metrics.get());
+    if (fontCache) {
+        fontCache->addMetrics(id, metrics.get());
+    }
     return canon->fTypefaceMetrics.set(id, std::move(metrics))->get();
 }
 
@@ -161,7 +180,19 @@ const std::vector<SkUnichar>& SkPDFFont::GetUnicodeMap(const SkTypeface* typefac
         return *ptr;
     }
     std::vector<SkUnichar> buffer(typeface->countGlyphs());
-    typeface->getGlyphToUnicodeMap(buffer.data());
+    size_t bytes = buffer.size() * sizeof(SkUnichar);
+    SkPDFFontCache* fontCache = canon->fFontCache;
+    SkPDFFontCache::Key key(SkPDFFontCache::Kind::kUnicodeMap, id);
+    sk_sp<SkData> cached = fontCache ? fontCache->find(key) : nullptr;
+    if (cached) {
+        SkASSERT(cached->size() == bytes);
+        memcpy(buffer.data(), cached->data(), bytes);
+    } else {
+        typeface->getGlyphToUnicodeMap(buffer.data());
+        if (fontCache) {
+            fontCache->add(key, SkData::MakeWithCopy(buffer.data(), bytes));
+        }
+    }
     return *canon->fToUnicodeMap.set(id, std::move(buffer));
 }
 
@@ -283,8 +314,152 @@ static sk_sp<SkData> stream_to_data(std::unique_ptr<SkStreamAsset> stream) {
     }
     return SkData::MakeFromStream(stream.get(), size);
 }
+
+static void emit_subset_font_file(sk_sp<SkData> fontData,
+                                  const SkPDFGlyphUse& glyphUsage,
+                                  const char* fontName,
+                                  int ttcIndex,
+                                  SkFontID fontID,
+                                  SkPDFFontCache* fontCache,
+                                  SkPDFDocument* doc,
+                                  SkPDFIndirectReference ref) {
+    std::unique_ptr<SkPDFFontCache::Key> key;
+    if (fontCache) {
+        key.reset(new SkPDFFontCache::Key(SkPDFFontCache::Kind::kFontFile, fontID,
+                                          SkToU32(ttcIndex), &glyphUsage));
+        if (sk_sp<SkData> object = fontCache->find(*key)) {
+            SkPDFWriteObject(*object, doc, ref);
+            return;
+        }
+    }
+    sk_sp<SkData> subsetFontData = SkPDFSubsetFont(fontData, glyphUsage, fontName, ttcIndex);
+    // If subsetting fails, fall back to original font data.
+    sk_sp<SkData> data = subsetFontData ? std::move(subsetFontData) : std::move(fontData);
+    auto dict = sk_make_sp<SkPDFDict>();
+    dict->insertInt("Length1", SkToInt(data->size()));
+    auto stream = skstd::make_unique<SkMemoryStream>(std::move(data));
+    if (fontCache) {
+        // Keep the deflated stream, so later documents needn't compress it again either.
+        sk_sp<SkData> object = SkPDFSerializeStreamToData(std::move(dict), std::move(stream));
+        fontCache->add(*key, object);
+        SkPDFWriteObject(*object, doc, ref);
+        return;
+    }
+    SkPDFSerializeStream(std::move(dict), std::move(stream), doc, ref);
+}
+
+// Subsetting is the expensive part of emitting a font, so it runs on the document's executor
+// if there is one.  The reference is reserved up front to keep object numbers deterministic.
+static SkPDFIndirectReference subset_font_file(sk_sp<SkData> fontData,
+                                               const SkPDFGlyphUse& glyphUsage,
+                                               const SkString& fontName,
+                                               int ttcIndex,
+                                               SkFontID fontID,
+                                               SkPDFDocument* doc) {
+    SkPDFIndirectReference ref = doc->reserve();
+    // Both are owned by the SkPDFCanon (or its document's metadata), which outlives all jobs.
+    SkPDFFontCache* fontCache = doc->canon()->fFontCache;
+    const SkPDFGlyphUse* glyphUsagePtr = &glyphUsage;
+    if (SkExecutor* executor = doc->executor()) {
+        doc->incrementJobCount();
+        executor->add([fontData, glyphUsagePtr, fontName, ttcIndex, fontID, fontCache, doc, ref]() {
+            emit_subset_font_file(fontData, *glyphUsagePtr, fontName.c_str(), ttcIndex, fontID,
+                                  fontCache, doc, ref);
+            doc->signalJobComplete();
+        });
+        return ref;
+    }
+    emit_subset_font_file(std::move(fontData), glyphUsage, fontName.c_str(), ttcIndex, fontID,
+                          fontCache, doc, ref);
+    return ref;
+}
 #endif  // SK_PDF_SUBSET_SUPPORTED
 
+namespace {
+// Writes out bytes that were already serialized, i.e. an object from SkPDFFontCache.
+class SkPDFEmittedObject final : public SkPDFObject {
+public:
+    explicit SkPDFEmittedObject(sk_sp<SkData> bytes) : fBytes(std::move(bytes)) {}
+    void emitObject(SkWStream* stream) const override {
+        stream->write(fBytes->data(), fBytes->size());
+    }
+private:
+    sk_sp<SkData> fBytes;
+};
+}  // namespace
+
+// Adds the W and DW entries of a CID font.
+static void add_cid_glyph_widths(SkPDFDict* cidFont, const SkPDFFont& font,
+                                 SkPDFFontCache* fontCache) {
+    SkTypeface* face = font.typeface();
+    std::unique_ptr<SkPDFFontCache::Key> key;
+    int16_t defaultWidth = 0;
+    if (fontCache) {
+        key.reset(new SkPDFFontCache::Key(SkPDFFontCache::Kind::kWidths, face->uniqueID(), 0,
+                                          &font.glyphUsage()));
+        int extra = 0;
+        if (sk_sp<SkData> widths = fontCache->find(*key, &extra)) {
+            // An empty array isn't kept, so there's no W entry.
+            if (widths->size() > 0) {
+                cidFont->insertObject("W", sk_make_sp<SkPDFEmittedObject>(std::move(widths)));
+            }
+            cidFont->insertScalar("DW", scaleFromFontUnits(SkToS16(extra),
+                                                           SkToS16(units_per_em(face))));
+            return;
+        }
+    }
+    int emSize;
+    auto glyphCache = SkPDFFont::MakeVectorCache(face, &emSize);
+    sk_sp<SkPDFArray> widths = SkPDFMakeCIDGlyphWidthsArray(
+            glyphCache.get(), &font.glyphUsage(), SkToS16(emSize), &defaultWidth);
+    bool hasWidths = widths && widths->size() > 0;
+    if (fontCache) {
+        SkDynamicMemoryWStream bytes;
+        if (hasWidths) {
+            widths->emitObject(&bytes);
+        }
+        fontCache->add(*key, bytes.detachAsData(), defaultWidth);
+    }
+    if (hasWidths) {
+        cidFont->insertObject("W", std::move(widths));
+    }
+    cidFont->insertScalar("DW", scaleFromFontUnits(defaultWidth, SkToS16(emSize)));
+}
+
+static SkPDFIndirectReference to_unicode_cmap(const SkPDFFont& font,
+                                              const SkPDFGlyphUse& glyphUsage,
+                                              bool multiByteGlyphs,
+                                              SkGlyphID firstGlyphID,
+                                              SkGlyphID lastGlyphID,
+                                              SkPDFDocument* doc) {
+    SkTypeface* face = font.typeface();
+    SkPDFCanon* canon = doc->canon();
+    auto make = [&]() {
+        const std::vector<SkUnichar>& glyphToUnicode = SkPDFFont::GetUnicodeMap(face, canon);
+        SkASSERT(SkToSizeT(face->countGlyphs()) == glyphToUnicode.size());
+        return SkPDFMakeToUnicodeCmap(glyphToUnicode.data(), &glyphUsage, multiByteGlyphs,
+                                      firstGlyphID, lastGlyphID);
+    };
+    SkPDFFontCache* fontCache = canon->fFontCache;
+    if (!fontCache) {
+        return doc->serialize(make());
+    }
+    uint64_t params = (uint64_t)multiByteGlyphs << 32 | (uint64_t)firstGlyphID << 16 | lastGlyphID;
+    SkPDFFontCache::Key key(SkPDFFontCache::Kind::kToUnicode, face->uniqueID(), params,
+                            &glyphUsage);
+    sk_sp<SkData> object = fontCache->find(key);
+    if (!object) {
+        // The stream deflates itself as it's emitted, so the cache keeps it compressed.
+        SkDynamicMemoryWStream bytes;
+        make()->emitObject(&bytes);
+        object = bytes.detachAsData();
+        fontCache->add(key, object);
+    }
+    SkPDFIndirectReference ref = doc->reserve();
+    SkPDFWriteObject(*object, doc, ref);
+    return ref;
+}
+
 static void emit_subset_type0(const SkPDFFont& font, SkPDFDocument* doc) {
     SkPDFCanon* canon = doc->canon();
     const SkAdvancedTypefaceMetrics* metricsPtr =
@@ -315,22 +490,10 @@ static void emit_subset_type0(const SkPDFFont& font, SkPDFDocument* doc) {
                 if (!SkToBool(metrics.fFlags &
                               SkAdvancedTypefaceMetrics::kNotSubsettable_FontFlag)) {
                     SkASSERT(font.firstGlyphID() == 1);
-                    sk_sp<SkData> subsetFontData = SkPDFSubsetFont(
+                    descriptor->insertRef("FontFile2", subset_font_file(
                             stream_to_data(std::move(fontAsset)), font.glyphUsage(),
-                            metrics.fFontName.c_str(), ttcIndex);
-                    if (subsetFontData) {
-                        size_t len = subsetFontData->size();
-                        sk_sp<SkPDFStream> subsetStream = sk_make_sp<SkPDFStream>(
-                                std::move(subsetFontData));
-                        subsetStream->dict()->insertInt("Length1", SkToInt(len));
-                        descriptor->insertRef("FontFile2", doc->serialize(subsetStream));
-                        break;
-                    }
-                    // If subsetting fails, fall back to original font data.
-                    fontAsset.reset(face->openStream(&ttcIndex));
-                    SkASSERT(fontAsset);
-                    SkASSERT(fontAsset->getLength() == fontSize);
-                    if (!fontAsset || fontAsset->getLength() == 0) { break; }
+                            metrics.fFontName, ttcIndex, face->uniqueID(), doc));
+                    break;
                 }
                 #endif  // SK_PDF_SUBSET_SUPPORTED
                 auto fontStream = sk_make_sp<SkPDFSharedStream>(std::move(fontAsset));
@@ -370,18 +533,7 @@ static void emit_subset_type0(const SkPDFFont& font, SkPDFDocument* doc) {
     sysInfo->insertInt("Supplement", 0);
     newCIDFont->insertObject("CIDSystemInfo", std::move(sysInfo));
 
-    int16_t defaultWidth = 0;
-    {
-        int emSize;
-        auto glyphCache = SkPDFFont::MakeVectorCache(face, &emSize);
-        sk_sp<SkPDFArray> widths = SkPDFMakeCIDGlyphWidthsArray(
-                glyphCache.get(), &font.glyphUsage(), SkToS16(emSize), &defaultWidth);
-        if (widths && widths->size() > 0) {
-            newCIDFont->insertObject("W", std::move(widths));
-        }
-        newCIDFont->insertScalar(
-                "DW", scaleFromFontUnits(defaultWidth, SkToS16(emSize)));
-    }
+    add_cid_glyph_widths(newCIDFont.get(), font, canon->fFontCache);
 
     ////////////////////////////////////////////////////////////////////////////
 
@@ -393,16 +545,10 @@ static void emit_subset_type0(const SkPDFFont& font, SkPDFDocument* doc) {
     descendantFonts->appendRef(doc->serialize(newCIDFont));
     fontDict.insertObject("DescendantFonts", std::move(descendantFonts));
 
-    const std::vector<SkUnichar>& glyphToUnicode =
-        SkPDFFont::GetUnicodeMap(font.typeface(), canon);
-    SkASSERT(SkToSizeT(font.typeface()->countGlyphs()) == glyphToUnicode.size());
-    fontDict.insertRef("ToUnicode",
-                    doc->serialize(
-                       SkPDFMakeToUnicodeCmap(glyphToUnicode.data(),
-                                              &font.glyphUsage(),
-                                              font.multiByteGlyphs(),
-                                              font.firstGlyphID(),
-                                              font.lastGlyphID())));
+    fontDict.insertRef("ToUnicode", to_unicode_cmap(font, font.glyphUsage(),
+                                                    font.multiByteGlyphs(),
+                                                    font.firstGlyphID(), font.lastGlyphID(),
+                                                    doc));
 
     SkWStream* stream = doc->beginObject(font.indirectReference());
     fontDict.emitObject(stream);
@@ -746,14 +892,8 @@ static void emit_subset_type3(const SkPDFFont& pdfFont, SkPDFDocument* doc) {
 
     font.insertName("CIDToGIDMap", "Identity");
 
-    const std::vector<SkUnichar>& glyphToUnicode = SkPDFFont::GetUnicodeMap(typeface, canon);
-    SkASSERT(glyphToUnicode.size() == SkToSizeT(typeface->countGlyphs()));
-    sk_sp<SkPDFStream> toUnicodeCmap = SkPDFMakeToUnicodeCmap(glyphToUnicode.data(),
-                                                              &subset,
-                                                              false,
-                                                              firstGlyphID,
-                                                              lastGlyphID);
-    font.insertRef("ToUnicode", doc->serialize(toUnicodeCmap));
+    font.insertRef("ToUnicode", to_unicode_cmap(pdfFont, subset, false,
+                                                firstGlyphID, lastGlyphID, doc));
     font.insertRef("FontDescriptor", type3_descriptor(doc, typeface, cache.get()));
     font.insertObject("Widths", std::move(widthArray));
     font.insertObject("Encoding", std::move(encoding));
@@ -0,0 +1,145 @@
+// Copyright 2018 Google LLC.
+// Use of this source code is governed by a BSD-style license that can be found in the LICENSE file.
+
+#include "SkPDFFontCache.h"
+
+#include "SkMakeUnique.h"
+#include "SkOpts.h"
+#include "SkPDFGlyphUse.h"
+
+#include <algorithm>
+
+sk_sp<SkPDF::FontCache> SkPDF::FontCache::Make(size_t byteLimit) {
+    return sk_make_sp<SkPDFFontCache>(byteLimit);
+}
+
+SkPDFFontCache::Key::Key(Kind kind, SkFontID fontID, uint64_t params,
+                         const SkPDFGlyphUse* glyphs)
+    : fKind(kind), fFontID(fontID), fParams(params) {
+    if (glyphs) {
+        glyphs->getSetValues([this](unsigned gid) { fGlyphs.push_back(SkToU16(gid)); });
+    }
+    uint32_t fields[] = { (uint32_t)kind, fontID, (uint32_t)params, (uint32_t)(params >> 32) };
+    fHash = SkOpts::hash(fGlyphs.data(), fGlyphs.size() * sizeof(SkGlyphID),
+                         SkOpts::hash(fields, sizeof(fields)));
+}
+
+bool SkPDFFontCache::Key::operator==(const Key& that) const {
+    return fHash   == that.fHash
+        && fKind   == that.fKind
+        && fFontID == that.fFontID
+        && fParams == that.fParams
+        && fGlyphs == that.fGlyphs;
+}
+
+SkPDFFontCache::SkPDFFontCache(size_t byteLimit) : fByteLimit(byteLimit) {}
+
+SkPDFFontCache::~SkPDFFontCache() = default;
+
+size_t SkPDFFontCache::bytesUsed() const {
+    SkAutoMutexAcquire lock(fMutex);
+    return fBytesUsed;
+}
+
+void SkPDFFontCache::purgeAll() {
+    SkAutoMutexAcquire lock(fMutex);
+    fEntries.reset();
+    fBytesUsed = 0;
+}
+
+bool SkPDFFontCache::findMetrics(SkFontID fontID,
+                                 std::unique_ptr<SkAdvancedTypefaceMetrics>* metrics) {
+    SkAutoMutexAcquire lock(fMutex);
+    Entry* entry = fEntries.find(Key(Kind::kMetrics, fontID));
+    if (!entry) {
+        return false;
+    }
+    entry->fLastUse = ++fUseCount;
+    *metrics = entry->fMetrics ? skstd::make_unique<SkAdvancedTypefaceMetrics>(*entry->fMetrics)
+                               : nullptr;
+    return true;
+}
+
+void SkPDFFontCache::addMetrics(SkFontID fontID, const SkAdvancedTypefaceMetrics* metrics) {
+    Entry entry;
+    entry.fBytes = sizeof(Entry);
+    if (metrics) {
+        entry.fMetrics = skstd::make_unique<SkAdvancedTypefaceMetrics>(*metrics);
+        entry.fBytes += sizeof(SkAdvancedTypefaceMetrics) +
+                        metrics->fPostScriptName.size() + metrics->fFontName.size();
+    }
+    SkAutoMutexAcquire lock(fMutex);
+    this->insert(Key(Kind::kMetrics, fontID), std::move(entry));
+}
+
+sk_sp<SkData> SkPDFFontCache::find(const Key& key, int* extra) {
+    SkASSERT(key.fKind != Kind::kMetrics);
+    SkAutoMutexAcquire lock(fMutex);
+    Entry* entry = fEntries.find(key);
+    if (!entry) {
+        return nullptr;
+    }
+    entry->fLastUse = ++fUseCount;
+    if (extra) {
+        *extra = entry->fExtra;
+    }
+    return entry->fData;
+}
+
+void SkPDFFontCache::add(const Key& key, sk_sp<SkData> data, int extra) {
+    SkASSERT(key.fKind != Kind::kMetrics);
+    SkASSERT(data);
+    Entry entry;
+    entry.fBytes = sizeof(Entry) + sizeof(Key) + key.fGlyphs.size() * sizeof(SkGlyphID) +
+                   data->size();
+    entry.fData = std::move(data);
+    entry.fExtra = extra;
+    SkAutoMutexAcquire lock(fMutex);
+    this->insert(key, std::move(entry));
+}
+
+void SkPDFFontCache::insert(const Key& key, Entry&& entry) {
+    // Documents racing to work out the same data may both add it.
+    if (Entry* old = fEntries.find(key)) {
+        fBytesUsed -= old->fBytes;
+    }
+    entry.fLastUse = ++fUseCount;
+    fBytesUsed += entry.fBytes;
+    fEntries.set(key, std::move(entry));
+    this->purgeAsNeeded();
+}
+
+void SkPDFFontCache::purgeAsNeeded() {
+    if (fBytesUsed <= fByteLimit) {
+        return;
+    }
+    // Purging is rare, so rather than keep entries in order of use, we sort them when it's time.
+    std::vector<std::pair<uint64_t, size_t>> uses;
+    uses.reserve(fEntries.count());
+    fEntries.foreach([&uses](const Key&, Entry* entry) {
+        uses.push_back({entry->fLastUse, entry->fBytes});
+    });
+    std::sort(uses.begin(), uses.end());
+
+    size_t bytesToFree = fBytesUsed - fByteLimit,
+           freed = 0;
+    uint64_t lastUseToPurge = 0;
+    for (const auto& use : uses) {
+        if (freed >= bytesToFree) {
+            break;
+        }
+        freed += use.second;
+        lastUseToPurge = use.first;
+    }
+
+    std::vector<Key> keysToPurge;
+    fEntries.foreach([&](const Key& key, Entry* entry) {
+        if (entry->fLastUse <= lastUseToPurge) {
+            keysToPurge.push_back(key);
+        }
+    });
+    for (const Key& key : keysToPurge) {
+        fBytesUsed -= fEntries.find(key)->fBytes;
+        fEntries.remove(key);
+    }
+}
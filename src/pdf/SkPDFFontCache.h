@@ -0,0 +1,87 @@
+// Copyright 2018 Google LLC.
+// Use of this source code is governed by a BSD-style license that can be found in the LICENSE file.
+#ifndef SkPDFFontCache_DEFINED
+#define SkPDFFontCache_DEFINED
+
+#include "SkAdvancedTypefaceMetrics.h"
+#include "SkData.h"
+#include "SkMutex.h"
+#include "SkPDFDocument.h"
+#include "SkTHash.h"
+#include "SkTypeface.h"
+
+#include <vector>
+
+class SkPDFGlyphUse;
+
+/**
+ *  The implementation of SkPDF::FontCache.  Documents only ever get copies of what it holds, so
+ *  they never share objects with each other, or need the lock for longer than a lookup.
+ */
+class SkPDFFontCache final : public SkPDF::FontCache {
+public:
+    explicit SkPDFFontCache(size_t byteLimit);
+    ~SkPDFFontCache() override;
+
+    size_t bytesUsed() const override;
+    void purgeAll() override;
+
+    enum class Kind : uint8_t {
+        kMetrics,     // Only used through findMetrics() and addMetrics().
+        kUnicodeMap,  // The typeface's glyph to unicode map, as an array of SkUnichar.
+        kFontFile,    // The serialized font file stream, usually a subset.
+        kWidths,      // The serialized W array of a CID font, and its default width.
+        kToUnicode,   // The serialized ToUnicode CMap stream.
+    };
+
+    /**
+     *  Identifies data about a typeface.  The kinds for a set of glyphs also key on those glyphs,
+     *  and any other parameters they need, packed into params.
+     */
+    struct Key {
+        Key() = default;
+        Key(Kind, SkFontID, uint64_t params = 0, const SkPDFGlyphUse* glyphs = nullptr);
+        bool operator==(const Key&) const;
+
+        Kind                   fKind = Kind::kMetrics;
+        SkFontID               fFontID = 0;
+        uint64_t               fParams = 0;
+        std::vector<SkGlyphID> fGlyphs;
+        uint32_t               fHash = 0;
+    };
+
+    /**
+     *  Returns false if the typeface's metrics aren't in the cache.  Otherwise sets *metrics to a
+     *  copy of them, or to null if the typeface has none.
+     */
+    bool findMetrics(SkFontID, std::unique_ptr<SkAdvancedTypefaceMetrics>* metrics);
+    void addMetrics(SkFontID, const SkAdvancedTypefaceMetrics* metrics);
+
+    /** Returns null if the data isn't in the cache.  extra is only used by kWidths. */
+    sk_sp<SkData> find(const Key&, int* extra = nullptr);
+    void add(const Key&, sk_sp<SkData>, int extra = 0);
+
+private:
+    struct KeyHash {
+        uint32_t operator()(const Key& key) const { return key.fHash; }
+    };
+
+    struct Entry {
+        sk_sp<SkData>                              fData;
+        std::unique_ptr<SkAdvancedTypefaceMetrics> fMetrics;
+        int                                        fExtra = 0;
+        size_t                                     fBytes = 0;
+        uint64_t                                   fLastUse = 0;
+    };
+
+    void insert(const Key&, Entry&&);
+    void purgeAsNeeded();
+
+    const size_t                    fByteLimit;
+    mutable SkMutex                 fMutex;
+    SkTHashMap<Key, Entry, KeyHash> fEntries;
+    size_t                          fBytesUsed = 0;
+    uint64_t                        fUseCount = 0;
+};
+
+#endif  // SkPDFFontCache_DEFINED
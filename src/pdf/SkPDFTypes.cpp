@@ -9,7 +9,9 @@
 
 #include "SkData.h"
 #include "SkDeflate.h"
+#include "SkExecutor.h"
 #include "SkMakeUnique.h"
+#include "SkPDFDocumentPriv.h"
 #include "SkPDFUtils.h"
 #include "SkStream.h"
 #include "SkStreamPriv.h"
@@ -630,6 +632,95 @@ void SkPDFStream::setData(std::unique_ptr<SkStreamAsset> stream) {
 
 ////////////////////////////////////////////////////////////////////////////////
 
+// Deflates content if asked to and it helps, then adds its Length (and Filter) to dict.
+static std::unique_ptr<SkStreamAsset> prepare_stream(SkPDFDict* dict,
+                                                     std::unique_ptr<SkStreamAsset> content,
+                                                     bool deflate) {
+    SkASSERT(content && content->hasLength());
+    #ifndef SK_PDF_LESS_COMPRESSION
+    if (deflate) {
+        // Code assumes that the stream starts at the beginning.
+        SkDynamicMemoryWStream compressedData;
+        SkDeflateWStream deflateWStream(&compressedData);
+        if (content->getLength() > 0) {
+            SkStreamCopy(&deflateWStream, content.get());
+        }
+        deflateWStream.finalize();
+        size_t compressedLength = compressedData.bytesWritten();
+        if (content->getLength() > compressedLength + strlen("/Filter_/FlateDecode_")) {
+            content = compressedData.detachAsStream();
+            dict->insertName("Filter", "FlateDecode");
+        } else {
+            SkAssertResult(content->rewind());
+        }
+    }
+    #endif
+    dict->insertInt("Length", content->getLength());
+    return content;
+}
+
+static void write_stream(const SkPDFDict& dict, SkStreamAsset* content, SkWStream* stream) {
+    dict.emitObject(stream);
+    stream->writeText(" stream\n");
+    stream->writeStream(content, content->getLength());
+    stream->writeText("\nendstream");
+}
+
+void SkPDFSerializeStream(sk_sp<SkPDFDict> dict,
+                          std::unique_ptr<SkStreamAsset> content,
+                          SkPDFDocument* doc,
+                          SkPDFIndirectReference ref,
+                          bool deflate) {
+    SkASSERT(doc);
+    if (!dict) {
+        dict = sk_make_sp<SkPDFDict>();
+    }
+    content = prepare_stream(dict.get(), std::move(content), deflate);
+    write_stream(*dict, content.get(), doc->beginObject(ref));
+    doc->endObject();
+}
+
+sk_sp<SkData> SkPDFSerializeStreamToData(sk_sp<SkPDFDict> dict,
+                                         std::unique_ptr<SkStreamAsset> content,
+                                         bool deflate) {
+    if (!dict) {
+        dict = sk_make_sp<SkPDFDict>();
+    }
+    content = prepare_stream(dict.get(), std::move(content), deflate);
+    SkDynamicMemoryWStream stream;
+    write_stream(*dict, content.get(), &stream);
+    return stream.detachAsData();
+}
+
+void SkPDFWriteObject(const SkData& object, SkPDFDocument* doc, SkPDFIndirectReference ref) {
+    SkASSERT(doc);
+    doc->beginObject(ref)->write(object.data(), object.size());
+    doc->endObject();
+}
+
+SkPDFIndirectReference SkPDFStreamOut(sk_sp<SkPDFDict> dict,
+                                      std::unique_ptr<SkStreamAsset> content,
+                                      SkPDFDocument* doc,
+                                      bool deflate) {
+    SkPDFIndirectReference ref = doc->reserve();
+    if (SkExecutor* executor = doc->executor()) {
+        // std::function must be copyable, so hand the content over as a raw pointer.
+        // The job runs exactly once and takes ownership of it.
+        SkStreamAsset* contentPtr = content.release();
+        doc->incrementJobCount();
+        executor->add([dict, contentPtr, doc, ref, deflate]() {
+            SkPDFSerializeStream(dict, std::unique_ptr<SkStreamAsset>(contentPtr),
+                                 doc, ref, deflate);
+            doc->signalJobComplete();
+        });
+        return ref;
+    }
+    SkPDFSerializeStream(std::move(dict), std::move(content), doc, ref, deflate);
+    return ref;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 void SkPDFObjNumMap::addObjectRecursively(SkPDFObject* obj) {
     if (obj && obj->fIndirectReference.fValue == -1) {
         obj->fIndirectReference.fValue = fNextObjectNumber++;
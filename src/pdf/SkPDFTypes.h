@@ -444,6 +444,42 @@ private:
 
 ////////////////////////////////////////////////////////////////////////////////
 
+/** Write a stream object, dict followed by content, into the document and return
+    its reference.  The content is deflated if that makes it smaller (and deflate
+    is true).  The reference is reserved immediately; if the document has an
+    executor, compressing and writing the object happen on it.
+
+    dict may be null.  It must only hold direct objects and SkPDFIndirectReference
+    values, since it is emitted outside of any SkPDFObjNumMap.
+*/
+SkPDFIndirectReference SkPDFStreamOut(sk_sp<SkPDFDict> dict,
+                                      std::unique_ptr<SkStreamAsset> content,
+                                      SkPDFDocument* doc,
+                                      bool deflate = true);
+
+/** Like SkPDFStreamOut, but synchronous and into an already reserved reference.
+    Safe to call from an executor job.
+*/
+void SkPDFSerializeStream(sk_sp<SkPDFDict> dict,
+                          std::unique_ptr<SkStreamAsset> content,
+                          SkPDFDocument* doc,
+                          SkPDFIndirectReference ref,
+                          bool deflate = true);
+
+/** Returns what SkPDFSerializeStream would write between "obj" and "endobj", so that it can be
+    written to any number of documents (see SkPDFWriteObject).
+*/
+sk_sp<SkData> SkPDFSerializeStreamToData(sk_sp<SkPDFDict> dict,
+                                         std::unique_ptr<SkStreamAsset> content,
+                                         bool deflate = true);
+
+/** Writes an object serialized ahead of time into an already reserved reference.
+    Safe to call from an executor job.
+*/
+void SkPDFWriteObject(const SkData& object, SkPDFDocument* doc, SkPDFIndirectReference ref);
+
+////////////////////////////////////////////////////////////////////////////////
+
 #ifdef SK_PDF_IMAGE_STATS
 extern std::atomic<int> gDrawImageCalls;
 extern std::atomic<int> gJpegImageObjects;
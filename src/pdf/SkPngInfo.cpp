@@ -0,0 +1,82 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkPngInfo.h"
+
+#include "SkStream.h"
+
+static uint32_t get_bigendian_uint32(const uint8_t* ptr) {
+    return (uint32_t)ptr[0] << 24 | (uint32_t)ptr[1] << 16 | (uint32_t)ptr[2] << 8 | ptr[3];
+}
+
+bool SkGetPngInfo(const void* data, size_t len,
+                  SkISize* size,
+                  SkEncodedInfo::Color* colorType,
+                  SkWStream* idat) {
+    static const uint8_t kSignature[] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    if (len < sizeof(kSignature) || 0 != memcmp(bytes, kSignature, sizeof(kSignature))) {
+        return false;  // not a PNG
+    }
+    size_t offset = sizeof(kSignature);
+    uint32_t width = 0, height = 0;
+    uint8_t pngColorType = 0;
+    bool sawIHDR = false,
+         sawIDAT = false,
+         sawIEND = false;
+    // Each chunk is a 4 byte length, 4 byte type, its data, and a 4 byte CRC.
+    while (offset + 12 <= len) {
+        uint32_t length = get_bigendian_uint32(bytes + offset);
+        const uint8_t* type = bytes + offset + 4;
+        const uint8_t* chunk = bytes + offset + 8;
+        if (length > len - offset - 12) {
+            return false;  // Chunk too long.
+        }
+        offset += 12 + length;
+        if (!sawIHDR) {
+            if (0 != memcmp(type, "IHDR", 4) || length < 13) {
+                return false;  // IHDR must come first.
+            }
+            width  = get_bigendian_uint32(chunk);
+            height = get_bigendian_uint32(chunk + 4);
+            pngColorType = chunk[9];
+            if (8 != chunk[8]) {
+                return false;  // Only support 8-bit depth.
+            }
+            if (0 != pngColorType && 2 != pngColorType) {
+                return false;  // Only gray and RGB, without alpha or a palette.
+            }
+            if (0 != chunk[10] || 0 != chunk[11] || 0 != chunk[12]) {
+                return false;  // Unknown compression or filter method, or interlaced.
+            }
+            if (0 == width || width > INT32_MAX || 0 == height || height > INT32_MAX) {
+                return false;
+            }
+            sawIHDR = true;
+        } else if (0 == memcmp(type, "IDAT", 4)) {
+            if (idat) {
+                idat->write(chunk, length);
+            }
+            sawIDAT = true;
+        } else if (0 == memcmp(type, "tRNS", 4)) {
+            return false;  // Transparent color key.
+        } else if (0 == memcmp(type, "IEND", 4)) {
+            sawIEND = true;
+            break;
+        }
+    }
+    if (!sawIDAT || !sawIEND) {
+        return false;  // malformed PNG
+    }
+    if (size) {
+        *size = {(int32_t)width, (int32_t)height};
+    }
+    if (colorType) {
+        *colorType = 0 == pngColorType ? SkEncodedInfo::kGray_Color : SkEncodedInfo::kRGB_Color;
+    }
+    return true;
+}
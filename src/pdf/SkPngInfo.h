@@ -0,0 +1,29 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+#ifndef SkPngInfo_DEFINED
+#define SkPngInfo_DEFINED
+
+#include "SkEncodedInfo.h"
+#include "SkSize.h"
+
+class SkWStream;
+
+/** Returns true if the data seems to be a valid PNG image whose compressed data can be embedded
+    in a PDF as is: 8-bit gray or RGB, opaque, and not interlaced.
+
+    @param [out] size      Image size in pixels
+    @param [out] colorType Encoded color type (kGray_Color or kRGB_Color).
+    @param [out] idat      If not null, receives the image data from all IDAT chunks, which
+                           together make one zlib stream of PNG-filtered rows. What it
+                           receives is unspecified if this returns false.
+*/
+bool SkGetPngInfo(const void* data, size_t len,
+                  SkISize* size,
+                  SkEncodedInfo::Color* colorType,
+                  SkWStream* idat);
+
+#endif  // SkPngInfo_DEFINED
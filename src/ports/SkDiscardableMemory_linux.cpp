@@ -0,0 +1,175 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkDiscardableMemory.h"
+#include "SkDiscardableMemoryPool.h"
+#include "SkTemplates.h"
+#include "SkTypes.h"
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#if defined(SK_BUILD_FOR_ANDROID)
+    #include <fcntl.h>
+    #include <linux/ashmem.h>
+    #include <sys/ioctl.h>
+#endif
+
+#ifndef MADV_FREE
+    #define MADV_FREE 8
+#endif
+
+// Unlocked blocks made here can be taken back by the kernel whenever it needs the memory, rather
+// than only when SkDiscardableMemoryPool's budget runs out. Blocks smaller than a page would
+// waste most of it, so those still come from the pool.
+
+static size_t page_size() {
+    static const size_t size = (size_t)sysconf(_SC_PAGESIZE);
+    return size;
+}
+
+static size_t round_up_to_pages(size_t bytes) {
+    return (bytes + page_size() - 1) / page_size() * page_size();
+}
+
+namespace {
+
+#if defined(SK_BUILD_FOR_ANDROID)
+
+// Unpinned ashmem may be purged, and pinning it again says whether it was.
+class AshmemDiscardableMemory : public SkDiscardableMemory {
+public:
+    static SkDiscardableMemory* Make(size_t bytes) {
+        int fd = open("/dev/ashmem", O_RDWR | O_CLOEXEC);
+        if (fd < 0) {
+            return nullptr;
+        }
+        size_t size = round_up_to_pages(bytes);
+        void* addr = MAP_FAILED;
+        if (0 == ioctl(fd, ASHMEM_SET_NAME, "skia-discardable") &&
+            0 == ioctl(fd, ASHMEM_SET_SIZE, size)) {
+            addr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        }
+        if (MAP_FAILED == addr) {
+            close(fd);
+            return nullptr;
+        }
+        return new AshmemDiscardableMemory(fd, addr, size);
+    }
+
+    ~AshmemDiscardableMemory() override {
+        munmap(fAddr, fSize);
+        close(fFd);
+    }
+
+    bool lock() override {
+        ashmem_pin pin = { 0, 0 };
+        if (ASHMEM_NOT_PURGED == ioctl(fFd, ASHMEM_PIN, &pin)) {
+            return true;
+        }
+        ioctl(fFd, ASHMEM_UNPIN, &pin);
+        return false;
+    }
+
+    void* data() override { return fAddr; }
+
+    void unlock() override {
+        ashmem_pin pin = { 0, 0 };
+        ioctl(fFd, ASHMEM_UNPIN, &pin);
+    }
+
+private:
+    AshmemDiscardableMemory(int fd, void* addr, size_t size)
+        : fFd(fd), fAddr(addr), fSize(size) {}
+
+    int    fFd;
+    void*  fAddr;
+    size_t fSize;
+};
+
+using PurgeableDiscardableMemory = AshmemDiscardableMemory;
+
+#else
+
+// The kernel may drop pages given MADV_FREE any time until they are next written, after which
+// they read back as zeros. To tell whether that happened, unlock() sets aside the first word of
+// each page and puts a (non-zero) marker there instead. lock() swaps each marker back with a
+// compare-and-swap: that write keeps the page if it is still there, and finds zero if it isn't.
+// If MADV_FREE isn't supported (before Linux 4.5) nothing is ever purged, which is fine too.
+class MadvFreeDiscardableMemory : public SkDiscardableMemory {
+public:
+    static SkDiscardableMemory* Make(size_t bytes) {
+        size_t size = round_up_to_pages(bytes);
+        void* addr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS,
+                          -1, 0);
+        if (MAP_FAILED == addr) {
+            return nullptr;
+        }
+        return new MadvFreeDiscardableMemory(addr, size);
+    }
+
+    ~MadvFreeDiscardableMemory() override {
+        munmap(fAddr, fSize);
+    }
+
+    bool lock() override {
+        bool purged = false;
+        for (size_t i = 0; i < fPageCount && !purged; ++i) {
+            uint64_t expected = kMarker;
+            purged = !__atomic_compare_exchange_n(this->firstWord(i), &expected, fSavedWords[i],
+                                                  false, __ATOMIC_RELAXED, __ATOMIC_RELAXED);
+        }
+        if (purged) {
+            // Give back anything just faulted in by looking.
+            madvise(fAddr, fSize, MADV_DONTNEED);
+        }
+        return !purged;
+    }
+
+    void* data() override { return fAddr; }
+
+    void unlock() override {
+        for (size_t i = 0; i < fPageCount; ++i) {
+            fSavedWords[i] = *this->firstWord(i);
+            *this->firstWord(i) = kMarker;
+        }
+        madvise(fAddr, fSize, MADV_FREE);
+    }
+
+private:
+    static constexpr uint64_t kMarker = 0x5ea1ab1e5ea1ab1eULL;
+
+    MadvFreeDiscardableMemory(void* addr, size_t size)
+        : fAddr(addr)
+        , fSize(size)
+        , fPageCount(size / page_size())
+        , fSavedWords(fPageCount) {}
+
+    uint64_t* firstWord(size_t page) const {
+        return reinterpret_cast<uint64_t*>(static_cast<char*>(fAddr) + page * page_size());
+    }
+
+    void*                      fAddr;
+    size_t                     fSize;
+    size_t                     fPageCount;
+    SkAutoTMalloc<uint64_t>    fSavedWords;
+};
+
+using PurgeableDiscardableMemory = MadvFreeDiscardableMemory;
+
+#endif
+
+}  // namespace
+
+SkDiscardableMemory* SkDiscardableMemory::Create(size_t bytes) {
+    if (bytes >= page_size()) {
+        if (SkDiscardableMemory* dm = PurgeableDiscardableMemory::Make(bytes)) {
+            return dm;
+        }
+    }
+    return SkGetGlobalDiscardableMemoryPool()->create(bytes);
+}
@@ -234,6 +234,9 @@ private:
 
 struct SkFaceRec;
 
+// gFTMutex guards the library and the list of faces: creating and destroying FT_Faces (which
+// FreeType requires to be serialized per FT_Library) and their reference counts. Using an
+// FT_Face once created only requires that face's own SkFaceRec::fMutex.
 SK_DECLARE_STATIC_MUTEX(gFTMutex);
 static FreeTypeLibrary* gFTLibrary;
 static SkFaceRec* gFaceRecHead;
@@ -270,8 +273,16 @@ static void unref_ft_library() {
 
 ///////////////////////////////////////////////////////////////////////////
 
+// Scaler contexts of one typeface are spread over up to this many FT_Faces, each with its own
+// lock, so that several strikes of the same typeface can be rasterized on different threads at
+// once. The faces all read the typeface's font data (usually shared memory or a mapped file).
+#ifndef SK_FREETYPE_MAX_FACES_PER_TYPEFACE
+    #define SK_FREETYPE_MAX_FACES_PER_TYPEFACE 8
+#endif
+
 struct SkFaceRec {
     SkFaceRec* fNext;
+    SkMutex fMutex;  // Guards fFace, which is shared by everyone who refs this SkFaceRec.
     std::unique_ptr<FT_FaceRec, SkFunctionWrapper<FT_Error, FT_FaceRec, FT_Done_Face>> fFace;
     FT_StreamRec fFTStream;
     std::unique_ptr<SkStreamAsset> fSkStream;
@@ -366,20 +377,28 @@ static void ft_face_setup_axes(SkFaceRec* rec, const SkFontData& data) {
     }
 }
 
+// Returns the least shared face of typeface, unless it has fewer than maxFaces faces open, in
+// which case it opens another one.
 // Will return nullptr on failure
 // Caller must lock gFTMutex before calling this function.
-static SkFaceRec* ref_ft_face(const SkTypeface* typeface) {
+static SkFaceRec* ref_ft_face(const SkTypeface* typeface, int maxFaces) {
     gFTMutex.assertHeld();
 
     const SkFontID fontID = typeface->uniqueID();
-    SkFaceRec* cachedRec = gFaceRecHead;
-    while (cachedRec) {
+    SkFaceRec* leastShared = nullptr;
+    int faceCount = 0;
+    for (SkFaceRec* cachedRec = gFaceRecHead; cachedRec; cachedRec = cachedRec->fNext) {
         if (cachedRec->fFontID == fontID) {
             SkASSERT(cachedRec->fFace);
-            cachedRec->fRefCnt += 1;
-            return cachedRec;
+            if (!leastShared || cachedRec->fRefCnt < leastShared->fRefCnt) {
+                leastShared = cachedRec;
+            }
+            ++faceCount;
         }
-        cachedRec = cachedRec->fNext;
+    }
+    if (leastShared && faceCount >= maxFaces) {
+        leastShared->fRefCnt += 1;
+        return leastShared;
     }
 
     std::unique_ptr<SkFontData> data = typeface->makeFontData();
@@ -438,7 +457,7 @@ extern /*static*/ void unref_ft_face(SkFaceRec* faceRec) {
     SkFaceRec*  prev = nullptr;
     while (rec) {
         SkFaceRec* next = rec->fNext;
-        if (rec->fFace == faceRec->fFace) {
+        if (rec == faceRec) {
             if (--rec->fRefCnt == 0) {
                 if (prev) {
                     prev->fNext = next;
@@ -455,20 +474,29 @@ extern /*static*/ void unref_ft_face(SkFaceRec* faceRec) {
     SkDEBUGFAIL("shouldn't get here, face not in list");
 }
 
+// Holds one of the typeface's faces, locked, without opening another one just for this.
 class AutoFTAccess {
 public:
     AutoFTAccess(const SkTypeface* tf) : fFaceRec(nullptr) {
-        gFTMutex.acquire();
-        SkASSERT_RELEASE(ref_ft_library());
-        fFaceRec = ref_ft_face(tf);
+        {
+            SkAutoMutexAcquire ac(gFTMutex);
+            SkASSERT_RELEASE(ref_ft_library());
+            fFaceRec = ref_ft_face(tf, 1);
+        }
+        if (fFaceRec) {
+            fFaceRec->fMutex.acquire();
+        }
     }
 
     ~AutoFTAccess() {
+        if (fFaceRec) {
+            fFaceRec->fMutex.release();
+        }
+        SkAutoMutexAcquire ac(gFTMutex);
         if (fFaceRec) {
             unref_ft_face(fFaceRec);
         }
         unref_ft_library();
-        gFTMutex.release();
     }
 
     FT_Face face() { return fFaceRec ? fFaceRec->fFace.get() : nullptr; }
@@ -509,7 +537,7 @@ private:
     using UnrefFTFace = SkFunctionWrapper<void, SkFaceRec, unref_ft_face>;
     std::unique_ptr<SkFaceRec, UnrefFTFace> fFaceRec;
 
-    FT_Face   fFace;  // Borrowed face from gFaceRecHead.
+    FT_Face   fFace;  // Borrowed face from fFaceRec, used under fFaceRec->fMutex.
     FT_Size   fFTSize;  // The size on the fFace for this scaler.
     FT_Int    fStrikeIndex;
 
@@ -531,9 +559,9 @@ private:
     void getBBoxForCurrentGlyph(const SkGlyph* glyph, FT_BBox* bbox,
                                 bool snapToPixelBoundary = false);
     bool getCBoxForLetter(char letter, FT_BBox* bbox);
-    // Caller must lock gFTMutex before calling this function.
+    // Caller must lock fFaceRec->fMutex before calling this function.
     void updateGlyphIfLCD(SkGlyph* glyph);
-    // Caller must lock gFTMutex before calling this function.
+    // Caller must lock fFaceRec->fMutex before calling this function.
     // update FreeType2 glyph slot with glyph emboldened
     void emboldenIfNeeded(FT_Face face, FT_GlyphSlot glyph, SkGlyphID gid);
     bool shouldSubpixelBitmap(const SkGlyph&, const SkMatrix&);
@@ -826,16 +854,19 @@ SkScalerContext_FreeType::SkScalerContext_FreeType(sk_sp<SkTypeface> typeface,
     , fFTSize(nullptr)
     , fStrikeIndex(-1)
 {
-    SkAutoMutexAcquire  ac(gFTMutex);
-    SkASSERT_RELEASE(ref_ft_library());
+    {
+        SkAutoMutexAcquire  ac(gFTMutex);
+        SkASSERT_RELEASE(ref_ft_library());
 
-    fFaceRec.reset(ref_ft_face(this->getTypeface()));
+        fFaceRec.reset(ref_ft_face(this->getTypeface(), SK_FREETYPE_MAX_FACES_PER_TYPEFACE));
+    }
 
     // load the font file
     if (nullptr == fFaceRec) {
         SkDEBUGF("Could not create FT_Face.\n");
         return;
     }
+    SkAutoMutexAcquire  ac(fFaceRec->fMutex);
 
     fLCDIsVert = SkToBool(fRec.fFlags & SkScalerContext::kLCD_Vertical_Flag);
 
@@ -1001,12 +1032,12 @@ SkScalerContext_FreeType::SkScalerContext_FreeType(sk_sp<SkTypeface> typeface,
 }
 
 SkScalerContext_FreeType::~SkScalerContext_FreeType() {
-    SkAutoMutexAcquire  ac(gFTMutex);
-
     if (fFTSize != nullptr) {
+        SkAutoMutexAcquire  ac(fFaceRec->fMutex);
         FT_Done_Size(fFTSize);
     }
 
+    SkAutoMutexAcquire  ac(gFTMutex);
     fFaceRec = nullptr;
 
     unref_ft_library();
@@ -1016,7 +1047,7 @@ SkScalerContext_FreeType::~SkScalerContext_FreeType() {
     this face with other context (at different sizes).
 */
 FT_Error SkScalerContext_FreeType::setupSize() {
-    gFTMutex.assertHeld();
+    fFaceRec->fMutex.assertHeld();
     FT_Error err = FT_Activate_Size(fFTSize);
     if (err != 0) {
         return err;
@@ -1030,12 +1061,12 @@ unsigned SkScalerContext_FreeType::generateGlyphCount() {
 }
 
 uint16_t SkScalerContext_FreeType::generateCharToGlyph(SkUnichar uni) {
-    SkAutoMutexAcquire  ac(gFTMutex);
+    SkAutoMutexAcquire  ac(fFaceRec->fMutex);
     return SkToU16(FT_Get_Char_Index( fFace, uni ));
 }
 
 SkUnichar SkScalerContext_FreeType::generateGlyphToChar(uint16_t glyph) {
-    SkAutoMutexAcquire  ac(gFTMutex);
+    SkAutoMutexAcquire  ac(fFaceRec->fMutex);
     // iterate through each cmap entry, looking for matching glyph indices
     FT_UInt glyphIndex;
     SkUnichar charCode = FT_Get_First_Char( fFace, &glyphIndex );
@@ -1058,7 +1089,7 @@ bool SkScalerContext_FreeType::generateAdvance(SkGlyph* glyph) {
         return false;
     }
 
-    SkAutoMutexAcquire  ac(gFTMutex);
+    SkAutoMutexAcquire  ac(fFaceRec->fMutex);
 
     if (this->setupSize()) {
         glyph->zeroMetrics();
@@ -1163,7 +1194,7 @@ bool SkScalerContext_FreeType::shouldSubpixelBitmap(const SkGlyph& glyph, const
 }
 
 void SkScalerContext_FreeType::generateMetrics(SkGlyph* glyph) {
-    SkAutoMutexAcquire  ac(gFTMutex);
+    SkAutoMutexAcquire  ac(fFaceRec->fMutex);
 
     glyph->fMaskFormat = fRec.fMaskFormat;
 
@@ -1319,7 +1350,7 @@ static void clear_glyph_image(const SkGlyph& glyph) {
 }
 
 void SkScalerContext_FreeType::generateImage(const SkGlyph& glyph) {
-    SkAutoMutexAcquire  ac(gFTMutex);
+    SkAutoMutexAcquire  ac(fFaceRec->fMutex);
 
     if (this->setupSize()) {
         clear_glyph_image(glyph);
@@ -1352,7 +1383,7 @@ void SkScalerContext_FreeType::generateImage(const SkGlyph& glyph) {
 bool SkScalerContext_FreeType::generatePath(SkGlyphID glyphID, SkPath* path) {
     SkASSERT(path);
 
-    SkAutoMutexAcquire  ac(gFTMutex);
+    SkAutoMutexAcquire  ac(fFaceRec->fMutex);
 
     // FT_IS_SCALABLE is documented to mean the face contains outline glyphs.
     if (!FT_IS_SCALABLE(fFace) || this->setupSize()) {
@@ -1393,7 +1424,7 @@ void SkScalerContext_FreeType::generateFontMetrics(SkFontMetrics* metrics) {
         return;
     }
 
-    SkAutoMutexAcquire ac(gFTMutex);
+    SkAutoMutexAcquire  ac(fFaceRec->fMutex);
 
     if (this->setupSize()) {
         sk_bzero(metrics, sizeof(*metrics));
@@ -1853,7 +1884,8 @@ bool SkTypeface_FreeType::Scanner::recognizedFont(SkStreamAsset* stream, int* nu
 #include "SkTSearch.h"
 bool SkTypeface_FreeType::Scanner::scanFont(
     SkStreamAsset* stream, int ttcIndex,
-    SkString* name, SkFontStyle* style, bool* isFixedPitch, AxisDefinitions* axes) const
+    SkString* name, SkFontStyle* style, bool* isFixedPitch, AxisDefinitions* axes,
+    CharacterRanges* coverage) const
 {
     SkAutoMutexAcquire libraryLock(fLibraryMutex);
 
@@ -1934,11 +1966,50 @@ bool SkTypeface_FreeType::Scanner::scanFont(
         *isFixedPitch = FT_IS_FIXED_WIDTH(face);
     }
 
+    if (coverage) {
+        GetCoverage(face, coverage);
+    }
+
     bool success = GetAxes(face, axes);
     FT_Done_Face(face);
     return success;
 }
 
+void SkTypeface_FreeType::Scanner::GetCoverage(FT_Face face, CharacterRanges* coverage) {
+    coverage->reset();
+    // Use the same charmap as ref_ft_face, so this agrees with charsToGlyphs.
+    if (!face->charmap) {
+        FT_Select_Charmap(face, FT_ENCODING_MS_SYMBOL);
+    }
+    if (!face->charmap) {
+        return;
+    }
+    FT_UInt glyph;
+    for (FT_ULong c = FT_Get_First_Char(face, &glyph); glyph; c = FT_Get_Next_Char(face, c, &glyph))
+    {
+        if (!coverage->isEmpty() && coverage->top().fLast + 1 == (SkUnichar)c) {
+            coverage->top().fLast = c;
+        } else {
+            coverage->push_back({ (SkUnichar)c, (SkUnichar)c });
+        }
+    }
+}
+
+bool SkTypeface_FreeType::Scanner::Covers(const CharacterRanges& coverage, SkUnichar character) {
+    int lo = 0, hi = coverage.count();
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (character < coverage[mid].fFirst) {
+            hi = mid;
+        } else if (character > coverage[mid].fLast) {
+            lo = mid + 1;
+        } else {
+            return true;
+        }
+    }
+    return false;
+}
+
 bool SkTypeface_FreeType::Scanner::GetAxes(FT_Face face, AxisDefinitions* axes) {
     if (axes && face->face_flags & FT_FACE_FLAG_MULTIPLE_MASTERS) {
         FT_MM_Var* variations = nullptr;
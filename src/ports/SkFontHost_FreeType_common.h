@@ -12,6 +12,7 @@
 #include "SkGlyph.h"
 #include "SkMutex.h"
 #include "SkScalerContext.h"
+#include "SkTDArray.h"
 #include "SkTypeface.h"
 #include "SkTypes.h"
 
@@ -68,16 +69,26 @@ public:
             SkFixed fMaximum;
         };
         using AxisDefinitions = SkSTArray<4, AxisDefinition, true>;
+        /** An inclusive range of characters, all of which have glyphs. */
+        struct CharacterRange {
+            SkUnichar fFirst;
+            SkUnichar fLast;
+        };
+        /** Sorted, non-overlapping and non-adjacent. */
+        using CharacterRanges = SkTDArray<CharacterRange>;
         bool recognizedFont(SkStreamAsset* stream, int* numFonts) const;
         bool scanFont(SkStreamAsset* stream, int ttcIndex,
                       SkString* name, SkFontStyle* style, bool* isFixedPitch,
-                      AxisDefinitions* axes) const;
+                      AxisDefinitions* axes, CharacterRanges* coverage = nullptr) const;
         static void computeAxisValues(
             AxisDefinitions axisDefinitions,
             const SkFontArguments::VariationPosition position,
             SkFixed* axisValues,
             const SkString& name);
         static bool GetAxes(FT_Face face, AxisDefinitions* axes);
+        static void GetCoverage(FT_Face face, CharacterRanges* coverage);
+        /** Returns true if the character is in one of the ranges. */
+        static bool Covers(const CharacterRanges& coverage, SkUnichar character);
 
     private:
         FT_Face openFace(SkStreamAsset* stream, int ttcIndex, FT_Stream ftStream) const;
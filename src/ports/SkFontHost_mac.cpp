@@ -30,6 +30,7 @@
 #include "SkFontDescriptor.h"
 #include "SkFontMgr.h"
 #include "SkGlyph.h"
+#include "SkLRUCache.h"
 #include "SkMakeUnique.h"
 #include "SkMaskGamma.h"
 #include "SkMathPriv.h"
@@ -724,6 +725,9 @@ public:
     SkUniqueCFRef<CFTypeRef> fOriginatingCFTypeRef;
     const bool fHasColorGlyphs;
 
+    /** Returns fFontRef at textSize, shared by all the scaler contexts at that size. */
+    SkUniqueCFRef<CTFontRef> copyCTFontAtSize(CGFloat textSize) const;
+
 protected:
     int onGetUPEM() const override;
     SkStreamAsset* onOpenStream(int* ttcIndex) const override;
@@ -749,6 +753,12 @@ protected:
 private:
     bool fIsLocalStream;
 
+    // Making a CTFont at a new size is slow, and scaler contexts often differ only in their
+    // transform, so the most recently used sizes are kept.
+    static constexpr int kSizedFontCacheCount = 8;
+    mutable SkMutex fSizedFontsMutex;
+    mutable SkLRUCache<CGFloat, SkUniqueCFRef<CTFontRef>> fSizedFonts{kSizedFontCacheCount};
+
     typedef SkTypeface INHERITED;
 };
 
@@ -999,10 +1009,23 @@ SkScalerContext_Mac::SkScalerContext_Mac(sk_sp<SkTypeface_Mac> typeface,
     // The transform contains everything except the requested text size.
     // Some properties, like 'trak', are based on the text size (before applying the matrix).
     CGFloat textSize = ScalarToCG(scale.y());
-    fCTFont = ctfont_create_exact_copy(ctFont, textSize, nullptr);
+    fCTFont = static_cast<SkTypeface_Mac*>(this->getTypeface())->copyCTFontAtSize(textSize);
     fCGFont.reset(CTFontCopyGraphicsFont(fCTFont.get(), nullptr));
 }
 
+SkUniqueCFRef<CTFontRef> SkTypeface_Mac::copyCTFontAtSize(CGFloat textSize) const {
+    SkAutoMutexAcquire lock(fSizedFontsMutex);
+    SkUniqueCFRef<CTFontRef>* font = fSizedFonts.find(textSize);
+    if (!font) {
+        font = fSizedFonts.insert(textSize,
+                                  ctfont_create_exact_copy(fFontRef.get(), textSize, nullptr));
+    }
+    if (!*font) {
+        return nullptr;
+    }
+    return SkUniqueCFRef<CTFontRef>((CTFontRef)CFRetain(font->get()));
+}
+
 CGRGBPixel* Offscreen::getCG(const SkScalerContext_Mac& context, const SkGlyph& glyph,
                              CGGlyph glyphID, size_t* rowBytesPtr,
                              bool generateA8FromLCD) {
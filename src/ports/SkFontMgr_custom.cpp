@@ -33,6 +33,12 @@ SkTypeface_Custom::SkTypeface_Custom(const SkFontStyle& style, bool isFixedPitch
 
 bool SkTypeface_Custom::isSysFont() const { return fIsSysFont; }
 
+bool SkTypeface_Custom::hasCharacter(SkUnichar character) const {
+    uint16_t glyph;
+    this->charsToGlyphs(&character, kUTF32_Encoding, &glyph, 1);
+    return glyph != 0;
+}
+
 void SkTypeface_Custom::onGetFamilyName(SkString* familyName) const {
     *familyName = fFamilyName;
 }
@@ -87,10 +93,23 @@ sk_sp<SkTypeface> SkTypeface_Stream::onMakeClone(const SkFontArguments& args) co
 }
 
 SkTypeface_File::SkTypeface_File(const SkFontStyle& style, bool isFixedPitch, bool sysFont,
-                                 const SkString familyName, const char path[], int index)
+                                 const SkString familyName, const char path[], int index,
+                                 const Scanner::CharacterRanges* coverage)
     : INHERITED(style, isFixedPitch, sysFont, familyName, index)
     , fPath(path)
-{ }
+    , fHasCoverage(SkToBool(coverage))
+{
+    if (coverage) {
+        fCoverage = *coverage;
+    }
+}
+
+bool SkTypeface_File::hasCharacter(SkUnichar character) const {
+    if (fHasCoverage) {
+        return Scanner::Covers(fCoverage, character);
+    }
+    return this->INHERITED::hasCharacter(character);
+}
 
 SkStreamAsset* SkTypeface_File::onOpenStream(int* ttcIndex) const {
     *ttcIndex = this->getIndex();
@@ -206,11 +225,44 @@ SkTypeface* SkFontMgr_Custom::onMatchFamilyStyle(const char familyName[],
 }
 
 SkTypeface* SkFontMgr_Custom::onMatchFamilyStyleCharacter(const char familyName[],
-                                                          const SkFontStyle&,
+                                                          const SkFontStyle& style,
                                                           const char* bcp47[], int bcp47Count,
                                                           SkUnichar character) const
 {
-    return nullptr;
+    auto covers = [character](SkFontStyleSet_Custom* family, const SkFontStyle& style) {
+        sk_sp<SkTypeface> tf(family->matchStyle(style));
+        if (tf && static_cast<SkTypeface_Custom*>(tf.get())->hasCharacter(character)) {
+            return tf;
+        }
+        return sk_sp<SkTypeface>();
+    };
+
+    if (familyName) {
+        sk_sp<SkFontStyleSet_Custom> family(this->onMatchFamily(familyName));
+        if (family) {
+            if (sk_sp<SkTypeface> tf = covers(family.get(), style)) {
+                return tf.release();
+            }
+        }
+    }
+
+    const FallbackKey key = { character, style };
+    SkAutoMutexAcquire ama(fFallbackMutex);
+    if (sk_sp<SkTypeface>* cached = fFallbacks.find(key)) {
+        return SkSafeRef(cached->get());
+    }
+
+    sk_sp<SkTypeface> found;
+    for (int i = 0; i < fFamilies.count() && !found; ++i) {
+        found = covers(fFamilies[i].get(), style);
+    }
+    // Nothing ever evicts a single entry; start over if enough distinct characters are seen.
+    static constexpr int kMaxFallbacks = 1024;
+    if (fFallbacks.count() >= kMaxFallbacks) {
+        fFallbacks.reset();
+    }
+    fFallbacks.set(key, found);
+    return found.release();
 }
 
 SkTypeface* SkFontMgr_Custom::onMatchFaceStyle(const SkTypeface* familyMember,
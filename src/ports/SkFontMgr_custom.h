@@ -11,9 +11,11 @@
 #include "SkFontHost_FreeType_common.h"
 #include "SkFontMgr.h"
 #include "SkFontStyle.h"
+#include "SkMutex.h"
 #include "SkRefCnt.h"
 #include "SkString.h"
 #include "SkTArray.h"
+#include "SkTHash.h"
 #include "SkTypes.h"
 
 class SkData;
@@ -27,6 +29,8 @@ public:
     SkTypeface_Custom(const SkFontStyle& style, bool isFixedPitch,
                       bool sysFont, const SkString familyName, int index);
     bool isSysFont() const;
+    /** Returns true if this typeface has a glyph for the character. */
+    virtual bool hasCharacter(SkUnichar character) const;
 
 protected:
     void onGetFamilyName(SkString* familyName) const override;
@@ -74,11 +78,15 @@ private:
     typedef SkTypeface_Custom INHERITED;
 };
 
-/** The file SkTypeface implementation for the custom font manager. */
+/** The file SkTypeface implementation for the custom font manager.
+ *  If the character coverage of the file is already known, hasCharacter need not open it.
+ */
 class SkTypeface_File : public SkTypeface_Custom {
 public:
     SkTypeface_File(const SkFontStyle& style, bool isFixedPitch, bool sysFont,
-                    const SkString familyName, const char path[], int index);
+                    const SkString familyName, const char path[], int index,
+                    const Scanner::CharacterRanges* coverage = nullptr);
+    bool hasCharacter(SkUnichar character) const override;
 
 protected:
     SkStreamAsset* onOpenStream(int* ttcIndex) const override;
@@ -86,6 +94,8 @@ protected:
 
 private:
     SkString fPath;
+    Scanner::CharacterRanges fCoverage;
+    bool fHasCoverage;
 
     typedef SkTypeface_Custom INHERITED;
 };
@@ -153,9 +163,22 @@ protected:
     sk_sp<SkTypeface> onLegacyMakeTypeface(const char familyName[], SkFontStyle style) const override;
 
 private:
+    struct FallbackKey {
+        SkUnichar fCharacter;
+        SkFontStyle fStyle;
+        bool operator==(const FallbackKey& that) const {
+            return fCharacter == that.fCharacter && fStyle == that.fStyle;
+        }
+    };
+
     Families fFamilies;
     SkFontStyleSet_Custom* fDefaultFamily;
     SkTypeface_FreeType::Scanner fScanner;
+
+    // Which system family, if any, covers a character is the same for every lookup, and text
+    // tends to ask about the same few characters over and over, so remember the answers.
+    mutable SkMutex fFallbackMutex;
+    mutable SkTHashMap<FallbackKey, sk_sp<SkTypeface>> fFallbacks;
 };
 
 #endif
@@ -11,17 +11,153 @@
 #include "SkOSPath.h"
 #include "SkStream.h"
 
+#include <stdio.h>
+
+namespace {
+
+using Scanner = SkTypeface_FreeType::Scanner;
+
+/** What scanning one font file found, so that the next process need not scan it again. */
+struct IndexedFile {
+    struct Face {
+        int fIndex;
+        SkString fFamilyName;
+        SkFontStyle fStyle;
+        bool fIsFixedPitch;
+        Scanner::CharacterRanges fCoverage;
+    };
+    size_t fSize = 0;
+    int64_t fModified = 0;
+    // Only the faces which scanned successfully; empty if the file is not a font.
+    SkTArray<Face> fFaces;
+};
+
+using Index = SkTHashMap<SkString, IndexedFile>;
+
+/**
+ *  The index is a flat file: a header, then for each font file its path, size and modification
+ *  time, followed by the family name, style, pitch and character coverage of each face in it.
+ *  An entry is only trusted if the size and modification time of its file still match.
+ */
+static constexpr uint32_t kIndexMagic = SkSetFourByteTag('s', 'k', 'f', 'i');
+static constexpr uint32_t kIndexVersion = 1;
+
+static bool write_string(SkWStream* stream, const SkString& string) {
+    return stream->writePackedUInt(string.size()) && stream->write(string.c_str(), string.size());
+}
+
+static bool read_string(SkStream* stream, SkString* string) {
+    size_t size;
+    if (!stream->readPackedUInt(&size) || size > stream->getLength()) {
+        return false;
+    }
+    string->resize(size);
+    return stream->read(string->writable_str(), size) == size;
+}
+
+static bool read_index(const char path[], Index* index) {
+    std::unique_ptr<SkStreamAsset> stream = SkStream::MakeFromFile(path);
+    uint32_t magic, version;
+    size_t fileCount;
+    if (!stream || !stream->readU32(&magic) || !stream->readU32(&version) ||
+        magic != kIndexMagic || version != kIndexVersion || !stream->readPackedUInt(&fileCount))
+    {
+        return false;
+    }
+    for (size_t i = 0; i < fileCount; ++i) {
+        SkString filename;
+        IndexedFile file;
+        uint32_t modifiedLo, modifiedHi;
+        size_t faceCount;
+        if (!read_string(stream.get(), &filename) || !stream->readPackedUInt(&file.fSize) ||
+            !stream->readU32(&modifiedLo) || !stream->readU32(&modifiedHi) ||
+            !stream->readPackedUInt(&faceCount))
+        {
+            return false;
+        }
+        file.fModified = (int64_t)(((uint64_t)modifiedHi << 32) | modifiedLo);
+        for (size_t j = 0; j < faceCount; ++j) {
+            IndexedFile::Face& face = file.fFaces.push_back();
+            uint32_t faceIndex, weight, width, slant, rangeCount;
+            if (!stream->readU32(&faceIndex) || !read_string(stream.get(), &face.fFamilyName) ||
+                !stream->readU32(&weight) || !stream->readU32(&width) ||
+                !stream->readU32(&slant) || slant > SkFontStyle::kOblique_Slant ||
+                !stream->readBool(&face.fIsFixedPitch) || !stream->readU32(&rangeCount) ||
+                rangeCount > stream->getLength() / sizeof(Scanner::CharacterRange))
+            {
+                return false;
+            }
+            face.fIndex = faceIndex;
+            face.fStyle = SkFontStyle(weight, width, (SkFontStyle::Slant)slant);
+            face.fCoverage.setCount(rangeCount);
+            size_t rangeBytes = rangeCount * sizeof(Scanner::CharacterRange);
+            if (stream->read(face.fCoverage.begin(), rangeBytes) != rangeBytes) {
+                return false;
+            }
+        }
+        index->set(std::move(filename), std::move(file));
+    }
+    return true;
+}
+
+static bool write_index(const char path[], const Index& index) {
+    // Write a new file and move it into place, so that a reader never sees half an index.
+    SkString tempPath(path);
+    tempPath.append(".tmp");
+    {
+        SkFILEWStream stream(tempPath.c_str());
+        bool ok = stream.isValid() &&
+                  stream.write32(kIndexMagic) && stream.write32(kIndexVersion) &&
+                  stream.writePackedUInt(index.count());
+        index.foreach([&](const SkString& filename, const IndexedFile& file) {
+            ok = ok && write_string(&stream, filename) && stream.writePackedUInt(file.fSize) &&
+                 stream.write32((uint32_t)file.fModified) &&
+                 stream.write32((uint32_t)((uint64_t)file.fModified >> 32)) &&
+                 stream.writePackedUInt(file.fFaces.count());
+            for (const IndexedFile::Face& face : file.fFaces) {
+                ok = ok && stream.write32(face.fIndex) &&
+                     write_string(&stream, face.fFamilyName) &&
+                     stream.write32(face.fStyle.weight()) && stream.write32(face.fStyle.width()) &&
+                     stream.write32(face.fStyle.slant()) &&
+                     stream.writeBool(face.fIsFixedPitch) &&
+                     stream.write32(face.fCoverage.count()) &&
+                     stream.write(face.fCoverage.begin(), face.fCoverage.bytes());
+            }
+        });
+        if (!ok) {
+            return false;
+        }
+    }
+    return 0 == rename(tempPath.c_str(), path);
+}
+
+}  // namespace
+
 class DirectorySystemFontLoader : public SkFontMgr_Custom::SystemFontLoader {
 public:
-    DirectorySystemFontLoader(const char* dir) : fBaseDirectory(dir) { }
+    DirectorySystemFontLoader(const char* dir, const char* indexPath)
+        : fBaseDirectory(dir), fIndexPath(indexPath) { }
 
     void loadSystemFonts(const SkTypeface_FreeType::Scanner& scanner,
                          SkFontMgr_Custom::Families* families) const override
     {
-        load_directory_fonts(scanner, fBaseDirectory, ".ttf", families);
-        load_directory_fonts(scanner, fBaseDirectory, ".ttc", families);
-        load_directory_fonts(scanner, fBaseDirectory, ".otf", families);
-        load_directory_fonts(scanner, fBaseDirectory, ".pfb", families);
+        Index oldIndex, newIndex;
+        bool indexChanged = false;
+        if (!fIndexPath.isEmpty()) {
+            indexChanged = !read_index(fIndexPath.c_str(), &oldIndex);
+        }
+        Indexes indexes = { fIndexPath.isEmpty() ? nullptr : &oldIndex, &newIndex,
+                            &indexChanged };
+
+        load_directory_fonts(scanner, fBaseDirectory, ".ttf", indexes, families);
+        load_directory_fonts(scanner, fBaseDirectory, ".ttc", indexes, families);
+        load_directory_fonts(scanner, fBaseDirectory, ".otf", indexes, families);
+        load_directory_fonts(scanner, fBaseDirectory, ".pfb", indexes, families);
+
+        // Files which went away since the index was written also make it stale.
+        if (!fIndexPath.isEmpty() && (indexChanged || newIndex.count() != oldIndex.count())) {
+            write_index(fIndexPath.c_str(), newIndex);
+        }
 
         if (families->empty()) {
             SkFontStyleSet_Custom* family = new SkFontStyleSet_Custom(SkString());
@@ -31,6 +167,12 @@ public:
     }
 
 private:
+    struct Indexes {
+        const Index* fOld;  // nullptr if there is no index.
+        Index* fNew;
+        bool* fChanged;
+    };
+
     static SkFontStyleSet_Custom* find_family(SkFontMgr_Custom::Families& families,
                                               const char familyName[])
     {
@@ -42,8 +184,55 @@ private:
         return nullptr;
     }
 
+    /** Finds the faces in the file from the index if it is up to date, otherwise scans it. */
+    static const IndexedFile* scan_file(const SkTypeface_FreeType::Scanner& scanner,
+                                        const SkString& filename, const Indexes& indexes)
+    {
+        IndexedFile file;
+        if (indexes.fOld) {
+            if (sk_stat(filename.c_str(), &file.fSize, &file.fModified)) {
+                const IndexedFile* indexed = indexes.fOld->find(filename);
+                if (indexed && indexed->fSize == file.fSize &&
+                    indexed->fModified == file.fModified)
+                {
+                    return indexes.fNew->set(filename, *indexed);
+                }
+            }
+            *indexes.fChanged = true;
+        }
+
+        std::unique_ptr<SkStreamAsset> stream = SkStream::MakeFromFile(filename.c_str());
+        if (!stream) {
+            // SkDebugf("---- failed to open <%s>\n", filename.c_str());
+            return nullptr;
+        }
+
+        int numFaces;
+        if (!scanner.recognizedFont(stream.get(), &numFaces)) {
+            // SkDebugf("---- failed to open <%s> as a font\n", filename.c_str());
+            numFaces = 0;
+        }
+
+        for (int faceIndex = 0; faceIndex < numFaces; ++faceIndex) {
+            IndexedFile::Face face;
+            face.fIndex = faceIndex;
+            face.fStyle = SkFontStyle(); // avoid uninitialized warning
+            if (!scanner.scanFont(stream.get(), faceIndex, &face.fFamilyName, &face.fStyle,
+                                  &face.fIsFixedPitch, nullptr,
+                                  indexes.fOld ? &face.fCoverage : nullptr))
+            {
+                // SkDebugf("---- failed to open <%s> <%d> as a font\n",
+                //          filename.c_str(), faceIndex);
+                continue;
+            }
+            file.fFaces.push_back(std::move(face));
+        }
+        return indexes.fNew->set(filename, std::move(file));
+    }
+
     static void load_directory_fonts(const SkTypeface_FreeType::Scanner& scanner,
                                      const SkString& directory, const char* suffix,
+                                     const Indexes& indexes,
                                      SkFontMgr_Custom::Families* families)
     {
         SkOSFile::Iter iter(directory.c_str(), suffix);
@@ -51,38 +240,20 @@ private:
 
         while (iter.next(&name, false)) {
             SkString filename(SkOSPath::Join(directory.c_str(), name.c_str()));
-            std::unique_ptr<SkStreamAsset> stream = SkStream::MakeFromFile(filename.c_str());
-            if (!stream) {
-                // SkDebugf("---- failed to open <%s>\n", filename.c_str());
-                continue;
-            }
-
-            int numFaces;
-            if (!scanner.recognizedFont(stream.get(), &numFaces)) {
-                // SkDebugf("---- failed to open <%s> as a font\n", filename.c_str());
+            const IndexedFile* file = scan_file(scanner, filename, indexes);
+            if (!file) {
                 continue;
             }
 
-            for (int faceIndex = 0; faceIndex < numFaces; ++faceIndex) {
-                bool isFixedPitch;
-                SkString realname;
-                SkFontStyle style = SkFontStyle(); // avoid uninitialized warning
-                if (!scanner.scanFont(stream.get(), faceIndex,
-                                      &realname, &style, &isFixedPitch, nullptr))
-                {
-                    // SkDebugf("---- failed to open <%s> <%d> as a font\n",
-                    //          filename.c_str(), faceIndex);
-                    continue;
-                }
-
-                SkFontStyleSet_Custom* addTo = find_family(*families, realname.c_str());
+            for (const IndexedFile::Face& face : file->fFaces) {
+                SkFontStyleSet_Custom* addTo = find_family(*families, face.fFamilyName.c_str());
                 if (nullptr == addTo) {
-                    addTo = new SkFontStyleSet_Custom(realname);
+                    addTo = new SkFontStyleSet_Custom(face.fFamilyName);
                     families->push_back().reset(addTo);
                 }
-                addTo->appendTypeface(sk_make_sp<SkTypeface_File>(style, isFixedPitch, true,
-                                                                  realname, filename.c_str(),
-                                                                  faceIndex));
+                addTo->appendTypeface(sk_make_sp<SkTypeface_File>(
+                        face.fStyle, face.fIsFixedPitch, true, face.fFamilyName, filename.c_str(),
+                        face.fIndex, indexes.fOld ? &face.fCoverage : nullptr));
             }
         }
 
@@ -92,13 +263,18 @@ private:
                 continue;
             }
             SkString dirname(SkOSPath::Join(directory.c_str(), name.c_str()));
-            load_directory_fonts(scanner, dirname, suffix, families);
+            load_directory_fonts(scanner, dirname, suffix, indexes, families);
         }
     }
 
     SkString fBaseDirectory;
+    SkString fIndexPath;
 };
 
 SK_API sk_sp<SkFontMgr> SkFontMgr_New_Custom_Directory(const char* dir) {
-    return sk_make_sp<SkFontMgr_Custom>(DirectorySystemFontLoader(dir));
+    return SkFontMgr_New_Custom_Directory(dir, nullptr);
+}
+
+SK_API sk_sp<SkFontMgr> SkFontMgr_New_Custom_Directory(const char* dir, const char* indexPath) {
+    return sk_make_sp<SkFontMgr_Custom>(DirectorySystemFontLoader(dir, indexPath));
 }
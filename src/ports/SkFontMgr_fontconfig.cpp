@@ -20,6 +20,7 @@
 #include "SkStream.h"
 #include "SkString.h"
 #include "SkTDArray.h"
+#include "SkTHash.h"
 #include "SkTemplates.h"
 #include "SkTypeface.h"
 #include "SkTypefaceCache.h"
@@ -681,6 +682,8 @@ class SkFontMgr_fontconfig : public SkFontMgr {
 
     mutable SkMutex fTFCacheMutex;
     mutable SkTypefaceCache fTFCache;
+    mutable SkMutex fFallbackMutex;
+    mutable SkTHashMap<SkString, sk_sp<SkTypeface>> fFallbacks;
     /** Creates a typeface using a typeface cache.
      *  @param pattern a complete pattern from FcFontRenderPrepare.
      */
@@ -877,6 +880,37 @@ protected:
                                                     const char* bcp47[],
                                                     int bcp47Count,
                                                     SkUnichar character) const override
+    {
+        // Text asks about the same few characters over and over, and FcFontMatch is expensive.
+        // The answer only depends on the arguments, since fFC does not change.
+        SkString key;
+        key.printf("%s\n%d %d %d %X", familyName ? familyName : "",
+                   style.weight(), style.width(), style.slant(), character);
+        for (int i = 0; i < bcp47Count; ++i) {
+            key.appendf("\n%s", bcp47[i]);
+        }
+        {
+            SkAutoMutexAcquire ama(fFallbackMutex);
+            if (sk_sp<SkTypeface>* cached = fFallbacks.find(key)) {
+                return SkSafeRef(cached->get());
+            }
+        }
+
+        sk_sp<SkTypeface> found(this->matchCharacter(familyName, style, bcp47, bcp47Count,
+                                                     character));
+
+        SkAutoMutexAcquire ama(fFallbackMutex);
+        // Nothing ever evicts a single entry; start over if enough distinct queries are seen.
+        static constexpr int kMaxFallbacks = 1024;
+        if (fFallbacks.count() >= kMaxFallbacks) {
+            fFallbacks.reset();
+        }
+        fFallbacks.set(key, found);
+        return found.release();
+    }
+
+    SkTypeface* matchCharacter(const char familyName[], const SkFontStyle& style,
+                               const char* bcp47[], int bcp47Count, SkUnichar character) const
     {
         FCLocker lock;
 
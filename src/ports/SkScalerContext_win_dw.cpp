@@ -31,6 +31,7 @@
 #include "SkScalerContext_win_dw.h"
 #include "SkSharedMutex.h"
 #include "SkTScopedComPtr.h"
+#include "SkTemplates.h"
 #include "SkTo.h"
 #include "SkTypeface_win_dw.h"
 
@@ -429,6 +430,41 @@ bool SkScalerContext_DW::generateAdvance(SkGlyph* glyph) {
     return true;
 }
 
+HRESULT SkScalerContext_DW::createGlyphRunAnalysis(const DWRITE_GLYPH_RUN& run,
+                                                   DWRITE_RENDERING_MODE renderingMode,
+                                                   IDWriteGlyphRunAnalysis** analysis)
+{
+    SkAutoExclusive l(DWriteFactoryMutex);
+    // IDWriteFactory2::CreateGlyphRunAnalysis is very bad at aliased glyphs.
+    if (this->getDWriteTypeface()->fFactory2 &&
+            (fGridFitMode == DWRITE_GRID_FIT_MODE_DISABLED ||
+             fAntiAliasMode == DWRITE_TEXT_ANTIALIAS_MODE_GRAYSCALE))
+    {
+        HRM(this->getDWriteTypeface()->fFactory2->CreateGlyphRunAnalysis(
+                &run,
+                &fXform,
+                renderingMode,
+                fMeasuringMode,
+                fGridFitMode,
+                fAntiAliasMode,
+                0.0f, // baselineOriginX,
+                0.0f, // baselineOriginY,
+                analysis),
+            "Could not create DW2 glyph run analysis.");
+    } else {
+        HRM(this->getDWriteTypeface()->fFactory->CreateGlyphRunAnalysis(&run,
+                1.0f, // pixelsPerDip,
+                &fXform,
+                renderingMode,
+                fMeasuringMode,
+                0.0f, // baselineOriginX,
+                0.0f, // baselineOriginY,
+                analysis),
+            "Could not create glyph run analysis.");
+    }
+    return S_OK;
+}
+
 HRESULT SkScalerContext_DW::getBoundingBox(SkGlyph* glyph,
                                            DWRITE_RENDERING_MODE renderingMode,
                                            DWRITE_TEXTURE_TYPE textureType,
@@ -457,36 +493,8 @@ HRESULT SkScalerContext_DW::getBoundingBox(SkGlyph* glyph,
     run.glyphOffsets = &offset;
 
     SkTScopedComPtr<IDWriteGlyphRunAnalysis> glyphRunAnalysis;
-    {
-        SkAutoExclusive l(DWriteFactoryMutex);
-        // IDWriteFactory2::CreateGlyphRunAnalysis is very bad at aliased glyphs.
-        if (this->getDWriteTypeface()->fFactory2 &&
-                (fGridFitMode == DWRITE_GRID_FIT_MODE_DISABLED ||
-                 fAntiAliasMode == DWRITE_TEXT_ANTIALIAS_MODE_GRAYSCALE))
-        {
-            HRM(this->getDWriteTypeface()->fFactory2->CreateGlyphRunAnalysis(
-                    &run,
-                    &fXform,
-                    renderingMode,
-                    fMeasuringMode,
-                    fGridFitMode,
-                    fAntiAliasMode,
-                    0.0f, // baselineOriginX,
-                    0.0f, // baselineOriginY,
-                    &glyphRunAnalysis),
-                "Could not create DW2 glyph run analysis.");
-        } else {
-            HRM(this->getDWriteTypeface()->fFactory->CreateGlyphRunAnalysis(&run,
-                    1.0f, // pixelsPerDip,
-                    &fXform,
-                    renderingMode,
-                    fMeasuringMode,
-                    0.0f, // baselineOriginX,
-                    0.0f, // baselineOriginY,
-                    &glyphRunAnalysis),
-                "Could not create glyph run analysis.");
-        }
-    }
+    HRM(this->createGlyphRunAnalysis(run, renderingMode, &glyphRunAnalysis),
+        "Could not create glyph run analysis.");
     {
         Shared l(DWriteFactoryMutex);
         HRM(glyphRunAnalysis->GetAlphaTextureBounds(textureType, bbox),
@@ -930,35 +938,8 @@ const void* SkScalerContext_DW::drawDWMask(const SkGlyph& glyph,
     run.glyphOffsets = &offset;
     {
         SkTScopedComPtr<IDWriteGlyphRunAnalysis> glyphRunAnalysis;
-        {
-            SkAutoExclusive l(DWriteFactoryMutex);
-            // IDWriteFactory2::CreateGlyphRunAnalysis is very bad at aliased glyphs.
-            if (this->getDWriteTypeface()->fFactory2 &&
-                    (fGridFitMode == DWRITE_GRID_FIT_MODE_DISABLED ||
-                     fAntiAliasMode == DWRITE_TEXT_ANTIALIAS_MODE_GRAYSCALE))
-            {
-                HRNM(this->getDWriteTypeface()->fFactory2->CreateGlyphRunAnalysis(&run,
-                         &fXform,
-                         renderingMode,
-                         fMeasuringMode,
-                         fGridFitMode,
-                         fAntiAliasMode,
-                         0.0f, // baselineOriginX,
-                         0.0f, // baselineOriginY,
-                         &glyphRunAnalysis),
-                     "Could not create DW2 glyph run analysis.");
-            } else {
-                HRNM(this->getDWriteTypeface()->fFactory->CreateGlyphRunAnalysis(&run,
-                         1.0f, // pixelsPerDip,
-                         &fXform,
-                         renderingMode,
-                         fMeasuringMode,
-                         0.0f, // baselineOriginX,
-                         0.0f, // baselineOriginY,
-                         &glyphRunAnalysis),
-                     "Could not create glyph run analysis.");
-            }
-        }
+        HRNM(this->createGlyphRunAnalysis(run, renderingMode, &glyphRunAnalysis),
+             "Could not create glyph run analysis.");
         //NOTE: this assumes that the glyph has already been measured
         //with an exact same glyph run analysis.
         RECT bbox;
@@ -1120,8 +1101,13 @@ void SkScalerContext_DW::generateImage(const SkGlyph& glyph) {
         return;
     }
 
-    //Copy the mask into the glyph.
-    const uint8_t* src = (const uint8_t*)bits;
+    this->copyDWMask(glyph, static_cast<const uint8_t*>(bits), renderingMode, textureType);
+}
+
+void SkScalerContext_DW::copyDWMask(const SkGlyph& glyph, const uint8_t* src,
+                                    DWRITE_RENDERING_MODE renderingMode,
+                                    DWRITE_TEXTURE_TYPE textureType)
+{
     if (DWRITE_RENDERING_MODE_ALIASED == renderingMode) {
         SkASSERT(SkMask::kBW_Format == glyph.fMaskFormat);
         SkASSERT(DWRITE_TEXTURE_ALIASED_1x1 == textureType);
@@ -1158,6 +1144,135 @@ void SkScalerContext_DW::generateImage(const SkGlyph& glyph) {
     }
 }
 
+// At most this many glyphs are drawn with one glyph run analysis, which bounds how far along the
+// baseline the last of them is placed.
+static constexpr int kMaxGlyphsPerAnalysis = 64;
+
+// The columns left empty between glyphs drawn with the same analysis.
+static constexpr int kGlyphGap = 2;
+
+bool SkScalerContext_DW::drawDWMasks(const SkGlyph* const glyphs[], int count,
+                                     DWRITE_RENDERING_MODE renderingMode,
+                                     DWRITE_TEXTURE_TYPE textureType)
+{
+    SkASSERT(count > 0 && count <= kMaxGlyphsPerAnalysis);
+    fXform.dx = SkFixedToFloat(glyphs[0]->getSubXFixed());
+    fXform.dy = SkFixedToFloat(glyphs[0]->getSubYFixed());
+
+    // Place the glyphs side by side along the baseline, far enough apart that the bounds each was
+    // measured with on its own don't touch. The transform is only the sub-pixel offset, so each
+    // glyph is drawn exactly as it would be alone, just further along.
+    UINT16 indices[kMaxGlyphsPerAnalysis];
+    FLOAT advances[kMaxGlyphsPerAnalysis];
+    DWRITE_GLYPH_OFFSET offsets[kMaxGlyphsPerAnalysis];
+    int origins[kMaxGlyphsPerAnalysis];
+    int x = glyphs[0]->fLeft;
+    for (int i = 0; i < count; ++i) {
+        const SkGlyph& glyph = *glyphs[i];
+        origins[i] = x - glyph.fLeft;
+        indices[i] = glyph.getGlyphID();
+        advances[i] = 0.0f;
+        offsets[i].advanceOffset = SkIntToFloat(origins[i]);
+        offsets[i].ascenderOffset = 0.0f;
+        x += glyph.fWidth + kGlyphGap;
+    }
+
+    DWRITE_GLYPH_RUN run;
+    run.glyphCount = count;
+    run.glyphAdvances = advances;
+    run.fontFace = this->getDWriteTypeface()->fDWriteFontFace.get();
+    run.fontEmSize = SkScalarToFloat(fTextSizeRender);
+    run.bidiLevel = 0;
+    run.glyphIndices = indices;
+    run.isSideways = FALSE;
+    run.glyphOffsets = offsets;
+
+    SkTScopedComPtr<IDWriteGlyphRunAnalysis> glyphRunAnalysis;
+    HRBM(this->createGlyphRunAnalysis(run, renderingMode, &glyphRunAnalysis),
+         "Could not create glyph run analysis.");
+
+    for (int i = 0; i < count; ++i) {
+        const SkGlyph& glyph = *glyphs[i];
+        int sizeNeeded = glyph.fWidth * glyph.fHeight;
+        if (DWRITE_TEXTURE_CLEARTYPE_3x1 == textureType) {
+            sizeNeeded *= 3;
+        }
+        if (sizeNeeded > fBits.count()) {
+            fBits.setCount(sizeNeeded);
+        }
+        memset(fBits.begin(), 0, sizeNeeded);
+
+        //NOTE: this assumes that the glyph has already been measured
+        //with an exact same glyph run analysis, at its place in this run.
+        RECT bbox;
+        bbox.left = glyph.fLeft + origins[i];
+        bbox.top = glyph.fTop;
+        bbox.right = bbox.left + glyph.fWidth;
+        bbox.bottom = glyph.fTop + glyph.fHeight;
+        HRESULT hr;
+        {
+            Shared l(DWriteFactoryMutex);
+            hr = glyphRunAnalysis->CreateAlphaTexture(textureType, &bbox,
+                                                      fBits.begin(), sizeNeeded);
+        }
+        if (FAILED(hr)) {
+            this->generateImage(glyph);
+            continue;
+        }
+        this->copyDWMask(glyph, fBits.begin(), renderingMode, textureType);
+    }
+    return true;
+}
+
+void SkScalerContext_DW::generateImages(const SkGlyph* const glyphs[], int count) {
+    // Glyphs are only placed side by side exactly when the transform doesn't move them off the
+    // baseline or scale the space between them.
+    if (fXform.m11 != 1 || fXform.m12 != 0 || fXform.m21 != 0 || fXform.m22 != 1) {
+        this->SkScalerContext::generateImages(glyphs, count);
+        return;
+    }
+
+    // Glyphs with the same sub-pixel offset and rendering mode share an analysis.
+    SkAutoSTMalloc<64, bool> batched(count);
+    sk_bzero(batched.get(), count * sizeof(bool));
+    const SkGlyph* batch[kMaxGlyphsPerAnalysis];
+    for (int i = 0; i < count; ++i) {
+        const SkGlyph& glyph = *glyphs[i];
+        if (batched[i]) {
+            continue;
+        }
+        if (SkMask::kARGB32_Format == glyph.fMaskFormat) {
+            this->generateImage(glyph);
+            continue;
+        }
+
+        int batchCount = 0;
+        for (int j = i; j < count && batchCount < kMaxGlyphsPerAnalysis; ++j) {
+            const SkGlyph& other = *glyphs[j];
+            if (!batched[j] && SkMask::kARGB32_Format != other.fMaskFormat &&
+                other.getSubXFixed() == glyph.getSubXFixed() &&
+                other.getSubYFixed() == glyph.getSubYFixed() &&
+                other.fForceBW == glyph.fForceBW)
+            {
+                batch[batchCount++] = &other;
+                batched[j] = true;
+            }
+        }
+
+        DWRITE_RENDERING_MODE renderingMode = fRenderingMode;
+        DWRITE_TEXTURE_TYPE textureType = fTextureType;
+        if (glyph.fForceBW) {
+            renderingMode = DWRITE_RENDERING_MODE_ALIASED;
+            textureType = DWRITE_TEXTURE_ALIASED_1x1;
+        }
+        if (batchCount == 1 || !this->drawDWMasks(batch, batchCount, renderingMode, textureType)) {
+            for (int j = 0; j < batchCount; ++j) {
+                this->generateImage(*batch[j]);
+            }
+        }
+    }
+}
+
 bool SkScalerContext_DW::generatePath(SkGlyphID glyph, SkPath* path) {
     SkASSERT(path);
 
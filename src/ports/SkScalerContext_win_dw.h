@@ -32,14 +32,30 @@ protected:
     bool generateAdvance(SkGlyph* glyph) override;
     void generateMetrics(SkGlyph* glyph) override;
     void generateImage(const SkGlyph& glyph) override;
+    void generateImages(const SkGlyph* const glyphs[], int count) override;
+    bool generatesImageBatches() const override { return true; }
     bool generatePath(SkGlyphID glyph, SkPath* path) override;
     void generateFontMetrics(SkFontMetrics*) override;
 
 private:
+    HRESULT createGlyphRunAnalysis(const DWRITE_GLYPH_RUN& run,
+                                   DWRITE_RENDERING_MODE renderingMode,
+                                   IDWriteGlyphRunAnalysis** analysis);
+
     const void* drawDWMask(const SkGlyph& glyph,
                            DWRITE_RENDERING_MODE renderingMode,
                            DWRITE_TEXTURE_TYPE textureType);
 
+    /** Draws glyphs, which must share their sub-pixel offset and fForceBW, with one glyph run
+     *  analysis, copying each into its image.  Returns false if it could not. */
+    bool drawDWMasks(const SkGlyph* const glyphs[], int count,
+                     DWRITE_RENDERING_MODE renderingMode,
+                     DWRITE_TEXTURE_TYPE textureType);
+
+    void copyDWMask(const SkGlyph& glyph, const uint8_t* src,
+                    DWRITE_RENDERING_MODE renderingMode,
+                    DWRITE_TEXTURE_TYPE textureType);
+
     HRESULT getBoundingBox(SkGlyph* glyph,
                            DWRITE_RENDERING_MODE renderingMode,
                            DWRITE_TEXTURE_TYPE textureType,
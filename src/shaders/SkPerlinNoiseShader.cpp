@@ -10,6 +10,7 @@
 #include "SkArenaAlloc.h"
 #include "SkColorFilter.h"
 #include "SkMakeUnique.h"
+#include "SkNx.h"
 #include "SkReadBuffer.h"
 #include "SkShader.h"
 #include "SkString.h"
@@ -20,6 +21,8 @@
 #include "GrContext.h"
 #include "GrContextPriv.h"
 #include "GrCoordTransform.h"
+#include "GrProxyProvider.h"
+#include "SkFloatBits.h"
 #include "SkGr.h"
 #include "effects/GrConstColorProcessor.h"
 #include "glsl/GrGLSLFragmentProcessor.h"
@@ -160,6 +163,8 @@ public:
             memcpy(fLatticeSelector, that.fLatticeSelector, sizeof(fLatticeSelector));
             memcpy(fNoise, that.fNoise, sizeof(fNoise));
             memcpy(fGradient, that.fGradient, sizeof(fGradient));
+            memcpy(fGradientX, that.fGradientX, sizeof(fGradientX));
+            memcpy(fGradientY, that.fGradientY, sizeof(fGradientY));
         }
     #endif
 
@@ -167,6 +172,9 @@ public:
         uint8_t     fLatticeSelector[kBlockSize];
         uint16_t    fNoise[4][kBlockSize][2];
         SkPoint     fGradient[4][kBlockSize];
+        // fGradient with the channels interleaved, so all four can be loaded at once.
+        float       fGradientX[kBlockSize][4];
+        float       fGradientY[kBlockSize][4];
         SkISize     fTileSize;
         SkVector    fBaseFrequency;
         StitchData  fStitchDataInit;
@@ -258,6 +266,8 @@ public:
                                                    (fGradient[channel][i].fX + 1) * gHalfMax16bits);
                     fNoise[channel][i][1] = SkScalarRoundToInt(
                                                    (fGradient[channel][i].fY + 1) * gHalfMax16bits);
+                    fGradientX[i][channel] = fGradient[channel][i].fX;
+                    fGradientY[i][channel] = fGradient[channel][i].fY;
                 }
             }
         }
@@ -348,12 +358,10 @@ public:
 
     private:
         SkPMColor shade(const SkPoint& point, StitchData& stitchData) const;
-        SkScalar calculateTurbulenceValueForPoint(
-                                                  int channel,
-                                                  StitchData& stitchData, const SkPoint& point) const;
+        // These compute all four channels at once, one per lane, in RGBA order.
+        Sk4f calculateTurbulenceValueForPoint(StitchData& stitchData, const SkPoint& point) const;
+        Sk4f noise2D(const StitchData& stitchData, const SkPoint& noiseVector) const;
         SkScalar calculateImprovedNoiseValueForPoint(int channel, const SkPoint& point) const;
-        SkScalar noise2D(int channel,
-                         const StitchData& stitchData, const SkPoint& noiseVector) const;
 
         SkMatrix     fMatrix;
         PaintingData fPaintingData;
@@ -463,8 +471,8 @@ void SkPerlinNoiseShaderImpl::flatten(SkWriteBuffer& buffer) const {
     buffer.writeInt(fTileSize.fHeight);
 }
 
-SkScalar SkPerlinNoiseShaderImpl::PerlinNoiseShaderContext::noise2D(
-        int channel, const StitchData& stitchData, const SkPoint& noiseVector) const {
+Sk4f SkPerlinNoiseShaderImpl::PerlinNoiseShaderContext::noise2D(
+        const StitchData& stitchData, const SkPoint& noiseVector) const {
     struct Noise {
         int noisePositionIntegerValue;
         int nextNoisePositionIntegerValue;
@@ -479,7 +487,6 @@ SkScalar SkPerlinNoiseShaderImpl::PerlinNoiseShaderContext::noise2D(
     };
     Noise noiseX(noiseVector.x());
     Noise noiseY(noiseVector.y());
-    SkScalar u, v;
     const SkPerlinNoiseShaderImpl& perlinNoiseShader = static_cast<const SkPerlinNoiseShaderImpl&>(fShader);
     // If stitching, adjust lattice points accordingly.
     if (perlinNoiseShader.fStitchTiles) {
@@ -510,35 +517,33 @@ SkScalar SkPerlinNoiseShaderImpl::PerlinNoiseShaderContext::noise2D(
     }
 
     // This is taken 1:1 from SVG spec: http://www.w3.org/TR/SVG11/filters.html#feTurbulenceElement
-    SkPoint fractionValue = SkPoint::Make(noiseX.noisePositionFractionValue,
-                                          noiseY.noisePositionFractionValue); // Offset (0,0)
-    u = fPaintingData.fGradient[channel][b00].dot(fractionValue);
-    fractionValue.fX -= SK_Scalar1; // Offset (-1,0)
-    v = fPaintingData.fGradient[channel][b10].dot(fractionValue);
-    SkScalar a = SkScalarInterp(u, v, sx);
-    fractionValue.fY -= SK_Scalar1; // Offset (-1,-1)
-    v = fPaintingData.fGradient[channel][b11].dot(fractionValue);
-    fractionValue.fX = noiseX.noisePositionFractionValue; // Offset (0,-1)
-    u = fPaintingData.fGradient[channel][b01].dot(fractionValue);
-    SkScalar b = SkScalarInterp(u, v, sx);
-    return SkScalarInterp(a, b, sy);
+    // The lattice lookups are shared by all channels; only the gradients differ between them.
+    auto dot = [this](int b, SkScalar x, SkScalar y) {
+        return Sk4f::Load(fPaintingData.fGradientX[b]) * x +
+               Sk4f::Load(fPaintingData.fGradientY[b]) * y;
+    };
+    auto interp = [](const Sk4f& u, const Sk4f& v, SkScalar t) { return u + (v - u) * t; };
+    SkScalar fx = noiseX.noisePositionFractionValue,
+             fy = noiseY.noisePositionFractionValue;
+    Sk4f a = interp(dot(b00, fx, fy), dot(b10, fx - SK_Scalar1, fy), sx),
+         b = interp(dot(b01, fx, fy - SK_Scalar1), dot(b11, fx - SK_Scalar1, fy - SK_Scalar1), sx);
+    return interp(a, b, sy);
 }
 
-SkScalar SkPerlinNoiseShaderImpl::PerlinNoiseShaderContext::calculateTurbulenceValueForPoint(
-        int channel, StitchData& stitchData, const SkPoint& point) const {
+Sk4f SkPerlinNoiseShaderImpl::PerlinNoiseShaderContext::calculateTurbulenceValueForPoint(
+        StitchData& stitchData, const SkPoint& point) const {
     const SkPerlinNoiseShaderImpl& perlinNoiseShader = static_cast<const SkPerlinNoiseShaderImpl&>(fShader);
     if (perlinNoiseShader.fStitchTiles) {
         // Set up TurbulenceInitial stitch values.
         stitchData = fPaintingData.fStitchDataInit;
     }
-    SkScalar turbulenceFunctionResult = 0;
+    Sk4f turbulenceFunctionResult = 0;
     SkPoint noiseVector(SkPoint::Make(point.x() * fPaintingData.fBaseFrequency.fX,
                                       point.y() * fPaintingData.fBaseFrequency.fY));
     SkScalar ratio = SK_Scalar1;
     for (int octave = 0; octave < perlinNoiseShader.fNumOctaves; ++octave) {
-        SkScalar noise = noise2D(channel, stitchData, noiseVector);
-        SkScalar numer = (perlinNoiseShader.fType == kFractalNoise_Type) ?
-                            noise : SkScalarAbs(noise);
+        Sk4f noise = noise2D(stitchData, noiseVector);
+        Sk4f numer = (perlinNoiseShader.fType == kFractalNoise_Type) ? noise : noise.abs();
         turbulenceFunctionResult += numer / ratio;
         noiseVector.fX *= 2;
         noiseVector.fY *= 2;
@@ -553,15 +558,14 @@ SkScalar SkPerlinNoiseShaderImpl::PerlinNoiseShaderContext::calculateTurbulenceV
     // The value of turbulenceFunctionResult comes from ((turbulenceFunctionResult) + 1) / 2
     // by fractalNoise and (turbulenceFunctionResult) by turbulence.
     if (perlinNoiseShader.fType == kFractalNoise_Type) {
-        turbulenceFunctionResult = SkScalarHalf(turbulenceFunctionResult + 1);
+        turbulenceFunctionResult = (turbulenceFunctionResult + 1.0f) * SK_ScalarHalf;
     }
 
-    if (channel == 3) { // Scale alpha by paint value
-        turbulenceFunctionResult *= SkIntToScalar(getPaintAlpha()) / 255;
-    }
+    // Scale alpha by paint value
+    turbulenceFunctionResult *= Sk4f(1, 1, 1, SkIntToScalar(getPaintAlpha()) / 255);
 
     // Clamp result
-    return SkScalarPin(turbulenceFunctionResult, 0, SK_Scalar1);
+    return Sk4f::Max(Sk4f::Min(turbulenceFunctionResult, 1.0f), 0.0f);
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -635,15 +639,18 @@ SkPMColor SkPerlinNoiseShaderImpl::PerlinNoiseShaderContext::shade(
     newPoint.fY = SkScalarRoundToScalar(newPoint.fY);
 
     U8CPU rgba[4];
-    for (int channel = 3; channel >= 0; --channel) {
-        SkScalar value;
-        if (perlinNoiseShader.fType == kImprovedNoise_Type) {
-            value = calculateImprovedNoiseValueForPoint(channel, newPoint);
+    if (perlinNoiseShader.fType == kImprovedNoise_Type) {
+        for (int channel = 3; channel >= 0; --channel) {
+            SkScalar value = calculateImprovedNoiseValueForPoint(channel, newPoint);
+            rgba[channel] = SkScalarFloorToInt(255 * value);
         }
-        else {
-            value = calculateTurbulenceValueForPoint(channel, stitchData, newPoint);
+    } else {
+        Sk4f value = calculateTurbulenceValueForPoint(stitchData, newPoint);
+        float values[4];
+        (value * 255.0f).store(values);
+        for (int channel = 0; channel < 4; ++channel) {
+            rgba[channel] = SkScalarFloorToInt(values[channel]);
         }
-        rgba[channel] = SkScalarFloorToInt(255 * value);
     }
     return SkPreMultiplyARGB(rgba[3], rgba[0], rgba[1], rgba[2]);
 }
@@ -1399,6 +1406,40 @@ void GrGLImprovedPerlinNoise::onSetData(const GrGLSLProgramDataManager& pdman,
 }
 
 /////////////////////////////////////////////////////////////////////
+
+enum class NoiseTexture : uint32_t {
+    kPermutations,
+    kNoise,
+    kImprovedPermutations,
+    kImprovedGradients,
+};
+
+// The lattice and gradient tables only depend on the seed (and the improved ones on nothing at
+// all), so rather than upload them for every draw, key their textures on what they were made from.
+static sk_sp<GrTextureProxy> find_or_make_noise_proxy(GrProxyProvider* proxyProvider,
+                                                      NoiseTexture texture, SkScalar seed,
+                                                      sk_sp<SkImage> image) {
+    static const GrUniqueKey::Domain kDomain = GrUniqueKey::GenerateDomain();
+    GrUniqueKey key;
+    GrUniqueKey::Builder builder(&key, kDomain, 2, "Perlin Noise");
+    builder[0] = (uint32_t)texture;
+    builder[1] = SkFloat2Bits(seed);
+    builder.finish();
+
+    sk_sp<GrTextureProxy> proxy =
+            proxyProvider->findOrCreateProxyByUniqueKey(key, kTopLeft_GrSurfaceOrigin);
+    if (!proxy) {
+        proxy = proxyProvider->createTextureProxy(std::move(image), kNone_GrSurfaceFlags, 1,
+                                                  SkBudgeted::kYes, SkBackingFit::kExact);
+        if (!proxy) {
+            return nullptr;
+        }
+        SkASSERT(proxy->origin() == kTopLeft_GrSurfaceOrigin);
+        proxyProvider->assignUniqueKeyToProxy(key, proxy.get());
+    }
+    return proxy;
+}
+
 std::unique_ptr<GrFragmentProcessor> SkPerlinNoiseShaderImpl::asFragmentProcessor(
         const GrFPArgs& args) const {
     SkASSERT(args.fContext);
@@ -1428,12 +1469,14 @@ std::unique_ptr<GrFragmentProcessor> SkPerlinNoiseShaderImpl::asFragmentProcesso
         const sk_sp<SkImage> permutationsImage = paintingData->getImprovedPermutationsImage();
         SkASSERT(SkIsPow2(permutationsImage->width()) && SkIsPow2(permutationsImage->height()));
         sk_sp<GrTextureProxy> permutationsTexture(
-                GrMakeCachedImageProxy(proxyProvider, std::move(permutationsImage)));
+                find_or_make_noise_proxy(proxyProvider, NoiseTexture::kImprovedPermutations, 0,
+                                         std::move(permutationsImage)));
 
         const sk_sp<SkImage> gradientImage = paintingData->getGradientImage();
         SkASSERT(SkIsPow2(gradientImage->width()) && SkIsPow2(gradientImage->height()));
         sk_sp<GrTextureProxy> gradientTexture(
-                GrMakeCachedImageProxy(proxyProvider, std::move(gradientImage)));
+                find_or_make_noise_proxy(proxyProvider, NoiseTexture::kImprovedGradients, 0,
+                                         std::move(gradientImage)));
         return GrImprovedPerlinNoiseEffect::Make(fNumOctaves, fSeed, std::move(paintingData),
                                                  std::move(permutationsTexture),
                                                  std::move(gradientTexture), m);
@@ -1460,13 +1503,13 @@ std::unique_ptr<GrFragmentProcessor> SkPerlinNoiseShaderImpl::asFragmentProcesso
     // through GrBitmapTextureMaker to handle needed copies.
     const sk_sp<SkImage> permutationsImage = paintingData->getPermutationsImage();
     SkASSERT(SkIsPow2(permutationsImage->width()) && SkIsPow2(permutationsImage->height()));
-    sk_sp<GrTextureProxy> permutationsProxy = GrMakeCachedImageProxy(proxyProvider,
-                                                                     std::move(permutationsImage));
+    sk_sp<GrTextureProxy> permutationsProxy = find_or_make_noise_proxy(
+            proxyProvider, NoiseTexture::kPermutations, fSeed, std::move(permutationsImage));
 
     const sk_sp<SkImage> noiseImage = paintingData->getNoiseImage();
     SkASSERT(SkIsPow2(noiseImage->width()) && SkIsPow2(noiseImage->height()));
-    sk_sp<GrTextureProxy> noiseProxy = GrMakeCachedImageProxy(proxyProvider,
-                                                              std::move(noiseImage));
+    sk_sp<GrTextureProxy> noiseProxy = find_or_make_noise_proxy(
+            proxyProvider, NoiseTexture::kNoise, fSeed, std::move(noiseImage));
 
     if (permutationsProxy && noiseProxy) {
         auto inner = GrPerlinNoise2Effect::Make(fType,
@@ -14,11 +14,15 @@
 #include "SkColorSpaceXformCanvas.h"
 #include "SkImage.h"
 #include "SkImageShader.h"
+#include "SkExecutor.h"
 #include "SkMatrixUtils.h"
+#include "SkMutex.h"
 #include "SkPicturePriv.h"
 #include "SkReadBuffer.h"
 #include "SkResourceCache.h"
+#include "SkTHash.h"
 #include <atomic>
+#include <cmath>
 
 #if SK_SUPPORT_GPU
 #include "GrCaps.h"
@@ -29,6 +33,8 @@
 #include "SkGr.h"
 #endif
 
+std::atomic<bool> gSkRasterizePictureTilesInBackground{false};
+
 namespace {
 static unsigned gBitmapShaderKeyNamespaceLabel;
 
@@ -67,17 +73,19 @@ private:
 };
 
 struct BitmapShaderRec : public SkResourceCache::Rec {
-    BitmapShaderRec(const BitmapShaderKey& key, SkShader* tileShader)
+    BitmapShaderRec(const BitmapShaderKey& key, SkShader* tileShader, size_t pixelBytes = 0)
         : fKey(key)
-        , fShader(SkRef(tileShader)) {}
+        , fShader(SkRef(tileShader))
+        , fPixelBytes(pixelBytes) {}
 
     BitmapShaderKey fKey;
     sk_sp<SkShader> fShader;
+    size_t          fPixelBytes;  // Only for tiles rasterized up front, not lazily.
 
     const Key& getKey() const override { return fKey; }
     size_t bytesUsed() const override {
-        // Just the record overhead -- the actual pixels are accounted by SkImage_Lazy.
-        return sizeof(fKey) + sizeof(SkImageShader);
+        // Lazily rasterized tiles' pixels are accounted by SkImage_Lazy.
+        return sizeof(fKey) + sizeof(SkImageShader) + fPixelBytes;
     }
     const char* getCategory() const override { return "bitmap-shader"; }
     SkDiscardableMemory* diagnostic_only_getDiscardable() const override { return nullptr; }
@@ -94,6 +102,89 @@ struct BitmapShaderRec : public SkResourceCache::Rec {
     }
 };
 
+// Rounds a tile's scale up to a power of two, so draws at nearby scales, like the frames of a
+// pinch-zoom, share one tile rather than each rasterizing their own.
+SkScalar level_scale(SkScalar scale) {
+    if (!(scale > 0) || !SkScalarIsFinite(scale)) {
+        return scale;
+    }
+    int exp;
+    SkScalar mantissa = std::frexp(scale, &exp);
+    // scale is mantissa * 2^exp, with mantissa in [0.5, 1).
+    return 0.5f == mantissa ? scale : std::ldexp(1.0f, exp);
+}
+
+// Returns the pixel size of a tile rasterized at scale, within the tile area and texture limits.
+SkISize tile_size(const SkRect& tile, SkSize scale, int maxTextureSize) {
+    SkSize scaledSize = SkSize::Make(SkScalarAbs(scale.width() * tile.width()),
+                                     SkScalarAbs(scale.height() * tile.height()));
+
+    // Clamp the tile size to about 4M pixels
+    static const SkScalar kMaxTileArea = 2048 * 2048;
+    SkScalar tileArea = scaledSize.width() * scaledSize.height();
+    if (tileArea > kMaxTileArea) {
+        SkScalar clampScale = SkScalarSqrt(kMaxTileArea / tileArea);
+        scaledSize.set(scaledSize.width() * clampScale,
+                       scaledSize.height() * clampScale);
+    }
+#if SK_SUPPORT_GPU
+    // Scale down the tile size if larger than maxTextureSize for GPU Path or it should fail on create texture
+    if (maxTextureSize) {
+        if (scaledSize.width() > maxTextureSize || scaledSize.height() > maxTextureSize) {
+            SkScalar downScale = maxTextureSize / SkMaxScalar(scaledSize.width(), scaledSize.height());
+            scaledSize.set(SkScalarFloorToScalar(scaledSize.width() * downScale),
+                           SkScalarFloorToScalar(scaledSize.height() * downScale));
+        }
+    }
+#endif
+    return scaledSize.toCeil();
+}
+
+SK_DECLARE_STATIC_MUTEX(gPendingTilesMutex);
+
+// Hashes of the keys of the tiles being rasterized in the background.
+SkTHashSet<uint32_t>* pending_tiles() {
+    static SkTHashSet<uint32_t>* pending = new SkTHashSet<uint32_t>;
+    return pending;
+}
+
+// Rasterizes a tile up front on SkExecutor::GetDefault() and adds it to the cache, unless that
+// tile is already underway.  owner is the picture shader, kept alive until the tile is added so
+// the tile is purged along with the rest of its entries.
+void rasterize_tile_in_background(sk_sp<SkShader> owner, sk_sp<SkPicture> picture,
+                                  const SkRect& tile, SkShader::TileMode tmx,
+                                  SkShader::TileMode tmy, const BitmapShaderKey& key,
+                                  SkISize tileSize, SkImage::BitDepth bitDepth,
+                                  sk_sp<SkColorSpace> colorSpace) {
+    {
+        SkAutoMutexAcquire lock(gPendingTilesMutex);
+        if (pending_tiles()->contains(key.hash())) {
+            return;
+        }
+        pending_tiles()->add(key.hash());
+    }
+
+    SkExecutor::GetDefault().add([owner, picture, tile, tmx, tmy, key, tileSize, bitDepth,
+                                  colorSpace] {
+        SkMatrix tileMatrix;
+        tileMatrix.setRectToRect(tile, SkRect::MakeIWH(tileSize.width(), tileSize.height()),
+                                 SkMatrix::kFill_ScaleToFit);
+        sk_sp<SkImage> tileImage = SkImage::MakeFromPicture(picture, tileSize, &tileMatrix,
+                                                            nullptr, bitDepth, colorSpace);
+        if (tileImage) {
+            tileImage = tileImage->makeRasterImage();
+        }
+        if (tileImage) {
+            size_t pixelBytes = tileSize.width() * tileSize.height() *
+                                (SkImage::BitDepth::kF16 == bitDepth ? 8 : 4);
+            sk_sp<SkShader> tileShader = tileImage->makeShader(tmx, tmy);
+            SkResourceCache::Add(new BitmapShaderRec(key, tileShader.get(), pixelBytes));
+        }
+        SkAutoMutexAcquire lock(gPendingTilesMutex);
+        pending_tiles()->remove(key.hash());
+    });
+}
+
 uint32_t next_id() {
     static std::atomic<uint32_t> nextID{1};
 
@@ -166,6 +257,7 @@ sk_sp<SkShader> SkPictureShader::refBitmapShader(const SkMatrix& viewMatrix,
                                                  SkTCopyOnFirstWrite<SkMatrix>* localMatrix,
                                                  SkColorType dstColorType,
                                                  SkColorSpace* dstColorSpace,
+                                                 SkFilterQuality* filterQuality,
                                                  const int maxTextureSize) const {
     SkASSERT(fPicture && !fPicture->cullRect().isEmpty());
 
@@ -181,36 +273,23 @@ sk_sp<SkShader> SkPictureShader::refBitmapShader(const SkMatrix& viewMatrix,
         scale.set(SkScalarSqrt(m.getScaleX() * m.getScaleX() + m.getSkewX() * m.getSkewX()),
                   SkScalarSqrt(m.getScaleY() * m.getScaleY() + m.getSkewY() * m.getSkewY()));
     }
-    SkSize scaledSize = SkSize::Make(SkScalarAbs(scale.x() * fTile.width()),
-                                     SkScalarAbs(scale.y() * fTile.height()));
-
-    // Clamp the tile size to about 4M pixels
-    static const SkScalar kMaxTileArea = 2048 * 2048;
-    SkScalar tileArea = scaledSize.width() * scaledSize.height();
-    if (tileArea > kMaxTileArea) {
-        SkScalar clampScale = SkScalarSqrt(kMaxTileArea / tileArea);
-        scaledSize.set(scaledSize.width() * clampScale,
-                       scaledSize.height() * clampScale);
-    }
-#if SK_SUPPORT_GPU
-    // Scale down the tile size if larger than maxTextureSize for GPU Path or it should fail on create texture
-    if (maxTextureSize) {
-        if (scaledSize.width() > maxTextureSize || scaledSize.height() > maxTextureSize) {
-            SkScalar downScale = maxTextureSize / SkMaxScalar(scaledSize.width(), scaledSize.height());
-            scaledSize.set(SkScalarFloorToScalar(scaledSize.width() * downScale),
-                           SkScalarFloorToScalar(scaledSize.height() * downScale));
-        }
-    }
-#endif
+    // Tiles are rasterized at power of two scales, the nearest at or above the draw's.
+    const SkSize levelScale = SkSize::Make(level_scale(SkScalarAbs(scale.x())),
+                                           level_scale(SkScalarAbs(scale.y())));
+    bool resampled = levelScale.width()  != SkScalarAbs(scale.x()) ||
+                     levelScale.height() != SkScalarAbs(scale.y());
 
-    const SkISize tileSize = scaledSize.toCeil();
+    SkISize tileSize = tile_size(fTile, levelScale, maxTextureSize);
     if (tileSize.isEmpty()) {
         return SkShader::MakeEmptyShader();
     }
 
     // The actual scale, compensating for rounding & clamping.
-    const SkSize tileScale = SkSize::Make(SkIntToScalar(tileSize.width()) / fTile.width(),
-                                          SkIntToScalar(tileSize.height()) / fTile.height());
+    auto scaleOf = [this](SkISize size) {
+        return SkSize::Make(SkIntToScalar(size.width()) / fTile.width(),
+                            SkIntToScalar(size.height()) / fTile.height());
+    };
+    SkSize tileScale = scaleOf(tileSize);
 
     // |fColorSpace| will only be set when using an SkColorSpaceXformCanvas to do pre-draw xforms.
     // A non-null |dstColorSpace| indicates that the surface we're drawing to is tagged. In all
@@ -230,7 +309,32 @@ sk_sp<SkShader> SkPictureShader::refBitmapShader(const SkMatrix& viewMatrix,
     BitmapShaderKey key(imgCS.get(), bitDepth, fUniqueID, tileScale);
 
     sk_sp<SkShader> tileShader;
-    if (!SkResourceCache::Find(key, BitmapShaderRec::Visitor, &tileShader)) {
+    if (!SkResourceCache::Find(key, BitmapShaderRec::Visitor, &tileShader) &&
+        gSkRasterizePictureTilesInBackground && !maxTextureSize) {
+        // If a neighboring level is cached, draw with it while this one rasterizes.
+        for (int step : { 1, -1, 2, -2 }) {
+            SkScalar factor = std::ldexp(1.0f, step);
+            SkISize size = tile_size(fTile, SkSize::Make(levelScale.width()  * factor,
+                                                         levelScale.height() * factor), 0);
+            if (size.isEmpty() || size == tileSize) {
+                continue;
+            }
+            BitmapShaderKey levelKey(imgCS.get(), bitDepth, fUniqueID, scaleOf(size));
+            if (SkResourceCache::Find(levelKey, BitmapShaderRec::Visitor, &tileShader)) {
+                fAddedToCache.store(true);
+                rasterize_tile_in_background(sk_ref_sp(const_cast<SkPictureShader*>(this)),
+                                             fPicture, fTile, fTmx, fTmy, key, tileSize,
+                                             bitDepth, imgCS);
+                // The default executor may well have finished it already.
+                if (!SkResourceCache::Find(key, BitmapShaderRec::Visitor, &tileShader)) {
+                    tileScale = scaleOf(size);
+                    resampled = true;
+                }
+                break;
+            }
+        }
+    }
+    if (!tileShader) {
         SkMatrix tileMatrix;
         tileMatrix.setRectToRect(fTile, SkRect::MakeIWH(tileSize.width(), tileSize.height()),
                                  SkMatrix::kFill_ScaleToFit);
@@ -250,6 +354,11 @@ sk_sp<SkShader> SkPictureShader::refBitmapShader(const SkMatrix& viewMatrix,
     if (tileScale.width() != 1 || tileScale.height() != 1) {
         localMatrix->writable()->preScale(1 / tileScale.width(), 1 / tileScale.height());
     }
+    // A tile drawn at other than its own scale needs at least bilinear filtering.  Tiles are never
+    // more than twice the size they're drawn at, so that's enough without mipmaps.
+    if (resampled && *filterQuality < kLow_SkFilterQuality) {
+        *filterQuality = kLow_SkFilterQuality;
+    }
 
     return tileShader;
 }
@@ -259,14 +368,21 @@ bool SkPictureShader::onAppendStages(const StageRec& rec) const {
 
     // Keep bitmapShader alive by using alloc instead of stack memory
     auto& bitmapShader = *rec.fAlloc->make<sk_sp<SkShader>>();
-    bitmapShader = this->refBitmapShader(rec.fCTM, &lm, rec.fDstColorType, rec.fDstCS);
+    SkFilterQuality quality = rec.fPaint.getFilterQuality();
+    bitmapShader = this->refBitmapShader(rec.fCTM, &lm, rec.fDstColorType, rec.fDstCS, &quality);
 
     if (!bitmapShader) {
         return false;
     }
 
-    StageRec localRec = rec;
-    localRec.fLocalM = lm->isIdentity() ? nullptr : lm.get();
+    const SkPaint* paint = &rec.fPaint;
+    if (quality != paint->getFilterQuality()) {
+        SkPaint* filteredPaint = rec.fAlloc->make<SkPaint>(*paint);
+        filteredPaint->setFilterQuality(quality);
+        paint = filteredPaint;
+    }
+    StageRec localRec = { rec.fPipeline, rec.fAlloc, rec.fDstColorType, rec.fDstCS, *paint,
+                          lm->isIdentity() ? nullptr : lm.get(), rec.fCTM };
 
     return as_SB(bitmapShader)->appendStages(localRec);
 }
@@ -277,14 +393,20 @@ bool SkPictureShader::onAppendStages(const StageRec& rec) const {
 SkShaderBase::Context* SkPictureShader::onMakeContext(const ContextRec& rec, SkArenaAlloc* alloc)
 const {
     auto lm = this->totalLocalMatrix(rec.fLocalMatrix);
+    SkFilterQuality quality = rec.fPaint->getFilterQuality();
     sk_sp<SkShader> bitmapShader = this->refBitmapShader(*rec.fMatrix, &lm, rec.fDstColorType,
-                                                         rec.fDstColorSpace);
+                                                         rec.fDstColorSpace, &quality);
     if (!bitmapShader) {
         return nullptr;
     }
 
     ContextRec localRec = rec;
     localRec.fLocalMatrix = lm->isIdentity() ? nullptr : lm.get();
+    if (quality != rec.fPaint->getFilterQuality()) {
+        SkPaint* filteredPaint = alloc->make<SkPaint>(*rec.fPaint);
+        filteredPaint->setFilterQuality(quality);
+        localRec.fPaint = filteredPaint;
+    }
 
     PictureShaderContext* ctx =
         alloc->make<PictureShaderContext>(*this, localRec, std::move(bitmapShader), alloc);
@@ -338,15 +460,16 @@ std::unique_ptr<GrFragmentProcessor> SkPictureShader::asFragmentProcessor(
     auto lm = this->totalLocalMatrix(args.fPreLocalMatrix, args.fPostLocalMatrix);
     SkColorType dstColorType = kN32_SkColorType;
     GrPixelConfigToColorType(args.fDstColorSpaceInfo->config(), &dstColorType);
+    SkFilterQuality quality = args.fFilterQuality;
     sk_sp<SkShader> bitmapShader(this->refBitmapShader(*args.fViewMatrix, &lm, dstColorType,
                                                        args.fDstColorSpaceInfo->colorSpace(),
-                                                       maxTextureSize));
+                                                       &quality, maxTextureSize));
     if (!bitmapShader) {
         return nullptr;
     }
 
     // We want to *reset* args.fPreLocalMatrix, not compose it.
-    GrFPArgs newArgs(args.fContext, args.fViewMatrix, args.fFilterQuality, args.fDstColorSpaceInfo);
+    GrFPArgs newArgs(args.fContext, args.fViewMatrix, quality, args.fDstColorSpaceInfo);
     newArgs.fPreLocalMatrix = lm.get();
 
     return as_SB(bitmapShader)->asFragmentProcessor(newArgs);
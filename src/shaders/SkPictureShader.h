@@ -15,6 +15,11 @@ class SkArenaAlloc;
 class SkBitmap;
 class SkPicture;
 
+// When set, raster draws that need a picture tile at a scale that isn't cached yet draw with a
+// cached tile of a neighboring scale, if there is one, and have the tile rasterized on
+// SkExecutor::GetDefault(). Off by default.
+extern std::atomic<bool> gSkRasterizePictureTilesInBackground;
+
 /*
  * An SkPictureShader can be used to draw SkPicture-based patterns.
  *
@@ -47,8 +52,10 @@ private:
     SkPictureShader(sk_sp<SkPicture>, TileMode, TileMode, const SkMatrix*, const SkRect*,
                     sk_sp<SkColorSpace>);
 
+    // Raises *filterQuality if the tile needs filtering to be drawn at the matrix's scale.
     sk_sp<SkShader> refBitmapShader(const SkMatrix&, SkTCopyOnFirstWrite<SkMatrix>* localMatrix,
                                     SkColorType dstColorType, SkColorSpace* dstColorSpace,
+                                    SkFilterQuality* filterQuality,
                                     const int maxTextureSize = 0) const;
 
     class PictureShaderContext : public Context {
@@ -17,10 +17,23 @@
 #include "SkMallocPixelRef.h"
 #include "SkRadialGradient.h"
 #include "SkReadBuffer.h"
+#include "SkResourceCache.h"
 #include "SkSweepGradient.h"
 #include "SkTwoPointConicalGradient.h"
 #include "SkWriteBuffer.h"
 
+// Gradients with more stops than this may draw from an evenly resampled table instead of searching
+// their stops for every pixel.
+#ifndef SK_GRADIENT_LUT_MIN_STOPS
+    #define SK_GRADIENT_LUT_MIN_STOPS 8
+#endif
+
+// The most a resampled table may be off from the exact gradient, in any channel.  Half of an 8-bit
+// step keeps the table's results within a rounding of the exact ones.
+#ifndef SK_GRADIENT_LUT_TOLERANCE
+    #define SK_GRADIENT_LUT_TOLERANCE (0.5f / 255)
+#endif
+
 enum GradientSerializationFlags {
     // Bits 29:31 used for various boolean flags
     kHasPosition_GSF    = 0x80000000,
@@ -271,6 +284,175 @@ static void init_stop_pos(
     add_stop_color(ctx, stop, Fs, Bs);
 }
 
+namespace {
+
+static unsigned gGradientLUTNamespaceLabel;
+
+// A gradient with stops at arbitrary positions, resampled at gapCount+1 evenly spaced points.  The
+// data holds the evenly_spaced_gradient stage's fs[4] and then its bs[4], each gapCount+1 floats.
+class GradientLUTRec : public SkResourceCache::Rec {
+public:
+    GradientLUTRec(const SkResourceCache::Key& key, sk_sp<SkData> lut) : fLUT(std::move(lut)) {
+        fKey.reset(new uint8_t[key.size()]);
+        memcpy(fKey.get(), &key, key.size());
+    }
+
+    const Key& getKey() const override {
+        return *reinterpret_cast<SkResourceCache::Key*>(fKey.get());
+    }
+    size_t bytesUsed() const override {
+        return sizeof(*this) + this->getKey().size() + fLUT->size();
+    }
+    const char* getCategory() const override { return "gradient lut"; }
+    SkDiscardableMemory* diagnostic_only_getDiscardable() const override { return nullptr; }
+
+    static bool Visitor(const SkResourceCache::Rec& baseRec, void* contextData) {
+        const GradientLUTRec& rec = static_cast<const GradientLUTRec&>(baseRec);
+        *static_cast<sk_sp<SkData>*>(contextData) = rec.fLUT;
+        return true;
+    }
+
+private:
+    std::unique_ptr<uint8_t[]> fKey;
+    sk_sp<SkData>              fLUT;
+};
+
+// Tables only stand in for the exact gradient when its small error disappears in the dst's 8-bit
+// channels, and isn't magnified by a linear transfer function on the way there.
+bool dst_hides_lut_error(SkColorType dstCT, const SkColorSpace* dstCS) {
+    switch (dstCT) {
+        case kAlpha_8_SkColorType:
+        case kRGB_565_SkColorType:
+        case kARGB_4444_SkColorType:
+        case kRGBA_8888_SkColorType:
+        case kRGB_888x_SkColorType:
+        case kBGRA_8888_SkColorType:
+        case kGray_8_SkColorType:
+            return !dstCS || !dstCS->gammaIsLinear();
+        default:
+            return false;
+    }
+}
+
+// Returns the fewest gaps, out of 255 and 1023, that resample the gradient to within
+// SK_GRADIENT_LUT_TOLERANCE, or 0 if neither does or the gradient has a hard stop.
+int choose_lut_gap_count(const SkScalar pos[], const SkPMColor4f colors[], int count) {
+    // The slope of each channel changes by some amount at every stop.  Linear interpolation
+    // between samples a gap h apart bends the same way, and misses the exact color by at most
+    // change * d*(h-d)/h for a stop d into its gap.  Each gap's error is the sum over its stops.
+    SkSTArray<16, float, true> changes;
+    changes.push_back_n(count, 0.0f);
+    Sk4f prevSlope(0);
+    for (int i = 0; i < count - 1; i++) {
+        Sk4f dc = Sk4f::Load(colors[i + 1].vec()) - Sk4f::Load(colors[i].vec());
+        float dt = pos[i + 1] - pos[i];
+        if (dt <= 0) {
+            if ((dc != 0).anyTrue()) {
+                return 0;
+            }
+            continue;
+        }
+        Sk4f slope = dc * (1 / dt);
+        changes[i] = (slope - prevSlope).abs().max();
+        prevSlope = slope;
+    }
+    changes[count - 1] = prevSlope.abs().max();
+
+    for (int gapCount : { 255, 1023 }) {
+        float h = 1.0f / gapCount,
+              error = 0;
+        int gap = -1;
+        for (int i = 0; i < count; i++) {
+            float x = pos[i] * gapCount;
+            int stopGap = std::min((int)x, gapCount - 1);
+            if (stopGap != gap) {
+                error = 0;
+                gap = stopGap;
+            }
+            float d = x - stopGap;
+            error += changes[i] * h * d * (1 - d);
+            if (error > SK_GRADIENT_LUT_TOLERANCE) {
+                break;
+            }
+        }
+        if (error <= SK_GRADIENT_LUT_TOLERANCE) {
+            return gapCount;
+        }
+    }
+    return 0;
+}
+
+sk_sp<SkData> make_lut(const SkScalar pos[], const SkPMColor4f colors[], int count, int gapCount) {
+    const int stopCount = gapCount + 1;
+    sk_sp<SkData> lut = SkData::MakeUninitialized(8 * stopCount * sizeof(float));
+    float* fs = static_cast<float*>(lut->writable_data());
+    float* bs = fs + 4 * stopCount;
+
+    // Sample the exact gradient, then fit F*t + B through neighboring samples like
+    // init_stop_evenly() does.
+    int i = 0;
+    Sk4f c_l = Sk4f::Load(colors[0].vec());
+    for (int j = 0; j <= gapCount; j++) {
+        float t = (float)j / gapCount;
+        while (i < count - 1 && pos[i + 1] <= t) {
+            i++;
+        }
+        Sk4f c_r = Sk4f::Load(colors[i].vec());
+        if (i < count - 1 && pos[i] < pos[i + 1]) {
+            float w = (t - pos[i]) / (pos[i + 1] - pos[i]);
+            c_r = c_r + (Sk4f::Load(colors[i + 1].vec()) - c_r) * w;
+        }
+        if (j > 0) {
+            Sk4f F = (c_r - c_l) * gapCount,
+                 B = c_l - F * ((float)(j - 1) / gapCount);
+            for (int k = 0; k < 4; k++) {
+                fs[k * stopCount + j - 1] = F[k];
+                bs[k * stopCount + j - 1] = B[k];
+            }
+        }
+        c_l = c_r;
+    }
+    for (int k = 0; k < 4; k++) {
+        fs[k * stopCount + gapCount] = 0;
+        bs[k * stopCount + gapCount] = c_l[k];
+    }
+    return lut;
+}
+
+// Returns a resampled table for the stops, from SkResourceCache if possible, or null if the
+// gradient can't be resampled closely enough.
+sk_sp<SkData> find_or_make_lut(const SkScalar pos[], const SkPMColor4f colors[], int count,
+                               bool premul) {
+    // The key is the stops as the pipeline will see them: positions, then colors prepared for
+    // the dst.
+    const size_t keyDataBytes = sizeof(uint32_t) + count * (sizeof(SkScalar) + sizeof(SkPMColor4f));
+    SkAutoSTArray<32 * 4, uint8_t> keyStorage(sizeof(SkResourceCache::Key) + keyDataBytes);
+    auto* key = new (keyStorage.begin()) SkResourceCache::Key();
+    uint8_t* keyData = keyStorage.begin() + sizeof(*key);
+    uint32_t header = (uint32_t)count << 1 | premul;
+    memcpy(keyData, &header, sizeof(header));
+    memcpy(keyData + sizeof(header), pos, count * sizeof(SkScalar));
+    memcpy(keyData + sizeof(header) + count * sizeof(SkScalar), colors,
+           count * sizeof(SkPMColor4f));
+    key->init(&gGradientLUTNamespaceLabel, 0, keyDataBytes);
+
+    sk_sp<SkData> lut;
+    if (SkResourceCache::Find(*key, GradientLUTRec::Visitor, &lut)) {
+        return lut;
+    }
+    // Gradients that can't be resampled aren't cached, but finding that out only costs a pass
+    // over their stops.
+    int gapCount = choose_lut_gap_count(pos, colors, count);
+    if (!gapCount) {
+        return nullptr;
+    }
+    lut = make_lut(pos, colors, count, gapCount);
+    SkResourceCache::Add(new GradientLUTRec(*key, lut));
+    return lut;
+}
+
+}  // namespace
+
 bool SkGradientShaderBase::onAppendStages(const StageRec& rec) const {
     SkRasterPipeline* p = rec.fPipeline;
     SkArenaAlloc* alloc = rec.fAlloc;
@@ -284,6 +466,28 @@ bool SkGradientShaderBase::onAppendStages(const StageRec& rec) const {
 
     SkRasterPipeline_<256> postPipeline;
 
+    const bool premulGrad = fGradFlags & SkGradientShader::kInterpolateColorsInPremul_Flag;
+
+    // Transform all of the colors to destination color space
+    SkColor4fXformer xformedColors(fOrigColors4f, fColorCount, fColorSpace.get(), rec.fDstCS);
+
+    auto prepareColor = [premulGrad, &xformedColors](int i) {
+        SkColor4f c = xformedColors.fColors[i];
+        return premulGrad ? c.premul()
+                          : SkPMColor4f{ c.fR, c.fG, c.fB, c.fA };
+    };
+
+    // Many arbitrary stops are cheaper to look up in an evenly spaced table than to search.
+    sk_sp<SkData> lut;
+    if (fOrigPos && fColorCount > SK_GRADIENT_LUT_MIN_STOPS &&
+        dst_hides_lut_error(rec.fDstColorType, rec.fDstCS)) {
+        SkSTArray<16, SkPMColor4f, true> colors;
+        for (int i = 0; i < fColorCount; i++) {
+            colors.push_back(prepareColor(i));
+        }
+        lut = find_or_make_lut(fOrigPos, colors.begin(), fColorCount, premulGrad);
+    }
+
     p->append(SkRasterPipeline::seed_shader);
     p->append_matrix(alloc, matrix);
     this->appendGradientStages(alloc, p, &postPipeline);
@@ -298,8 +502,8 @@ bool SkGradientShaderBase::onAppendStages(const StageRec& rec) const {
             p->append(SkRasterPipeline::decal_x, decal_ctx);
             // fall-through to clamp
         case kClamp_TileMode:
-            if (!fOrigPos) {
-                // We clamp only when the stops are evenly spaced.
+            if (!fOrigPos || lut) {
+                // We clamp only when the stops are evenly spaced, or resampled to be.
                 // If not, there may be hard stops, and clamping ruins hard stops at 0 and/or 1.
                 // In that case, we must make sure we're using the general "gradient" stage,
                 // which is the only stage that will correctly handle unclamped t.
@@ -308,17 +512,6 @@ bool SkGradientShaderBase::onAppendStages(const StageRec& rec) const {
             break;
     }
 
-    const bool premulGrad = fGradFlags & SkGradientShader::kInterpolateColorsInPremul_Flag;
-
-    // Transform all of the colors to destination color space
-    SkColor4fXformer xformedColors(fOrigColors4f, fColorCount, fColorSpace.get(), rec.fDstCS);
-
-    auto prepareColor = [premulGrad, &xformedColors](int i) {
-        SkColor4f c = xformedColors.fColors[i];
-        return premulGrad ? c.premul()
-                          : SkPMColor4f{ c.fR, c.fG, c.fB, c.fA };
-    };
-
     // The two-stop case with stops at 0 and 1.
     if (fColorCount == 2 && fOrigPos == nullptr) {
         const SkPMColor4f c_l = prepareColor(0),
@@ -331,6 +524,20 @@ bool SkGradientShaderBase::onAppendStages(const StageRec& rec) const {
         ctx->interpolatedInPremul = premulGrad;
 
         p->append(SkRasterPipeline::evenly_spaced_2_stop_gradient, ctx);
+    } else if (lut) {
+        auto* ctx = alloc->make<SkRasterPipeline_GradientCtx>();
+        ctx->interpolatedInPremul = premulGrad;
+        ctx->stopCount = lut->size() / (8 * sizeof(float));
+
+        // The pipeline only reads the table, and the arena keeps it alive as long as it runs.
+        float* data = const_cast<float*>(static_cast<const float*>(lut->data()));
+        for (int i = 0; i < 4; i++) {
+            ctx->fs[i] = data + i * ctx->stopCount;
+            ctx->bs[i] = data + (4 + i) * ctx->stopCount;
+        }
+        alloc->make<sk_sp<SkData>>(std::move(lut));
+
+        p->append(SkRasterPipeline::evenly_spaced_gradient, ctx);
     } else {
         auto* ctx = alloc->make<SkRasterPipeline_GradientCtx>();
         ctx->interpolatedInPremul = premulGrad;
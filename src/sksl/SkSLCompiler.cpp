@@ -13,8 +13,10 @@
 #include "SkSLHCodeGenerator.h"
 #include "SkSLIRGenerator.h"
 #include "SkSLMetalCodeGenerator.h"
+#include "SkSLParser.h"
 #include "SkSLPipelineStageCodeGenerator.h"
 #include "SkSLSPIRVCodeGenerator.h"
+#include "ir/SkSLAppendStage.h"
 #include "ir/SkSLEnum.h"
 #include "ir/SkSLExpression.h"
 #include "ir/SkSLExpressionStatement.h"
@@ -217,37 +219,101 @@ Compiler::Compiler(Flags flags)
                                     *fContext->fSkArgs_Type, Variable::kGlobal_Storage);
     fIRGenerator->fSymbolTable->add(skArgsName, std::unique_ptr<Symbol>(skArgs));
 
+    fRootSymbolTable = symbols;
+}
+
+Compiler::~Compiler() {
+    delete fIRGenerator;
+}
+
+// The include modules are parsed once per process, and only converted to IR by each Compiler,
+// since the IR and symbol tables refer to Compiler-specific types and are modified as programs are
+// compiled. The modules declare no structs or enums, so parsing them doesn't add to the types table
+// and their ASTs are the same whichever Compiler parses them.
+typedef std::vector<std::unique_ptr<ASTDeclaration>> ParsedModule;
+
+static const ParsedModule* parse_module(const char* text, SymbolTable& types,
+                                        ErrorReporter& errors) {
+    Parser parser(text, strlen(text), types, errors);
+    return new ParsedModule(parser.file());
+}
+
+void Compiler::loadBaseModule() {
+    if (fBaseModuleLoaded) {
+        return;
+    }
+    static const ParsedModule* gParsed = parse_module(SKSL_INCLUDE, *fTypes, *this);
     std::vector<std::unique_ptr<ProgramElement>> ignored;
-    fIRGenerator->convertProgram(Program::kFragment_Kind, SKSL_INCLUDE, strlen(SKSL_INCLUDE),
-                                 *fTypes, &ignored);
-    fIRGenerator->fSymbolTable->markAllFunctionsBuiltin();
+    fIRGenerator->fSymbolTable = fRootSymbolTable;
+    fIRGenerator->convertProgram(Program::kFragment_Kind, *gParsed, &ignored);
+    fRootSymbolTable->markAllFunctionsBuiltin();
     if (fErrorCount) {
         printf("Unexpected errors: %s\n", fErrorText.c_str());
     }
     SkASSERT(!fErrorCount);
-
-    Program::Settings settings;
-    fIRGenerator->start(&settings, nullptr);
-    fIRGenerator->convertProgram(Program::kFragment_Kind, SKSL_VERT_INCLUDE,
-                                 strlen(SKSL_VERT_INCLUDE), *fTypes, &fVertexInclude);
-    fIRGenerator->fSymbolTable->markAllFunctionsBuiltin();
-    fVertexSymbolTable = fIRGenerator->fSymbolTable;
-
-    fIRGenerator->start(&settings, nullptr);
-    fIRGenerator->convertProgram(Program::kVertex_Kind, SKSL_FRAG_INCLUDE,
-                                 strlen(SKSL_FRAG_INCLUDE), *fTypes, &fFragmentInclude);
-    fIRGenerator->fSymbolTable->markAllFunctionsBuiltin();
-    fFragmentSymbolTable = fIRGenerator->fSymbolTable;
-
-    fIRGenerator->start(&settings, nullptr);
-    fIRGenerator->convertProgram(Program::kGeometry_Kind, SKSL_GEOM_INCLUDE,
-                                 strlen(SKSL_GEOM_INCLUDE), *fTypes, &fGeometryInclude);
-    fIRGenerator->fSymbolTable->markAllFunctionsBuiltin();
-    fGeometrySymbolTable = fIRGenerator->fSymbolTable;
+    fBaseModuleLoaded = true;
 }
 
-Compiler::~Compiler() {
-    delete fIRGenerator;
+void Compiler::loadModule(Program::Kind kind) {
+    // Each module's symbol table nests inside the previous one's: fragment programs see the vertex
+    // module's symbols, and geometry programs see both.
+    const ParsedModule* parsed;
+    Program::Kind moduleKind;
+    std::vector<std::unique_ptr<ProgramElement>>* elements;
+    std::shared_ptr<SymbolTable>* symbolTable;
+    std::shared_ptr<SymbolTable>* parent;
+    switch (kind) {
+        case Program::kVertex_Kind: {
+            static const ParsedModule* gParsed = parse_module(SKSL_VERT_INCLUDE, *fTypes, *this);
+            parsed = gParsed;
+            moduleKind = Program::kFragment_Kind;
+            elements = &fVertexInclude;
+            symbolTable = &fVertexSymbolTable;
+            parent = &fRootSymbolTable;
+            if (!*symbolTable) {
+                this->loadBaseModule();
+            }
+            break;
+        }
+        case Program::kFragment_Kind: {
+            static const ParsedModule* gParsed = parse_module(SKSL_FRAG_INCLUDE, *fTypes, *this);
+            parsed = gParsed;
+            moduleKind = Program::kVertex_Kind;
+            elements = &fFragmentInclude;
+            symbolTable = &fFragmentSymbolTable;
+            parent = &fVertexSymbolTable;
+            if (!*symbolTable) {
+                this->loadModule(Program::kVertex_Kind);
+            }
+            break;
+        }
+        case Program::kGeometry_Kind: {
+            static const ParsedModule* gParsed = parse_module(SKSL_GEOM_INCLUDE, *fTypes, *this);
+            parsed = gParsed;
+            moduleKind = Program::kGeometry_Kind;
+            elements = &fGeometryInclude;
+            symbolTable = &fGeometrySymbolTable;
+            parent = &fFragmentSymbolTable;
+            if (!*symbolTable) {
+                this->loadModule(Program::kFragment_Kind);
+            }
+            break;
+        }
+        default:
+            // Fragment processors and pipeline stages convert their own includes every time.
+            this->loadBaseModule();
+            fIRGenerator->fSymbolTable = fRootSymbolTable;
+            return;
+    }
+    if (!*symbolTable) {
+        Program::Settings settings;
+        fIRGenerator->fSymbolTable = *parent;
+        fIRGenerator->start(&settings, nullptr);
+        fIRGenerator->convertProgram(moduleKind, *parsed, elements);
+        fIRGenerator->fSymbolTable->markAllFunctionsBuiltin();
+        *symbolTable = fIRGenerator->fSymbolTable;
+    }
+    fIRGenerator->fSymbolTable = *symbolTable;
 }
 
 // add the definition created by assigning to the lvalue to the definition set
@@ -1233,6 +1299,7 @@ void Compiler::scanCFG(FunctionDefinition& f) {
 
 std::unique_ptr<Program> Compiler::convertProgram(Program::Kind kind, String text,
                                                   const Program::Settings& settings) {
+    this->loadModule(kind);
     fErrorText = "";
     fErrorCount = 0;
     std::vector<std::unique_ptr<ProgramElement>>* inherited;
@@ -1240,17 +1307,14 @@ std::unique_ptr<Program> Compiler::convertProgram(Program::Kind kind, String tex
     switch (kind) {
         case Program::kVertex_Kind:
             inherited = &fVertexInclude;
-            fIRGenerator->fSymbolTable = fVertexSymbolTable;
             fIRGenerator->start(&settings, inherited);
             break;
         case Program::kFragment_Kind:
             inherited = &fFragmentInclude;
-            fIRGenerator->fSymbolTable = fFragmentSymbolTable;
             fIRGenerator->start(&settings, inherited);
             break;
         case Program::kGeometry_Kind:
             inherited = &fGeometryInclude;
-            fIRGenerator->fSymbolTable = fGeometrySymbolTable;
             fIRGenerator->start(&settings, inherited);
             break;
         case Program::kFragmentProcessor_Kind:
@@ -1290,17 +1354,358 @@ std::unique_ptr<Program> Compiler::convertProgram(Program::Kind kind, String tex
     return result;
 }
 
+// Calls fn on each expression slot under expr, including expr itself, children before their
+// parents. fn may replace the expression in the slot it is given.
+template <typename Fn>
+static void visit_expressions(std::unique_ptr<Expression>* expr, Fn& fn) {
+    if (!*expr) {
+        return;
+    }
+    switch ((*expr)->fKind) {
+#ifndef SKSL_STANDALONE
+        case Expression::kAppendStage_Kind:
+            for (auto& arg : ((AppendStage&) **expr).fArguments) {
+                visit_expressions(&arg, fn);
+            }
+            break;
+#endif
+        case Expression::kBinary_Kind: {
+            BinaryExpression& b = (BinaryExpression&) **expr;
+            visit_expressions(&b.fLeft, fn);
+            visit_expressions(&b.fRight, fn);
+            break;
+        }
+        case Expression::kConstructor_Kind:
+            for (auto& arg : ((Constructor&) **expr).fArguments) {
+                visit_expressions(&arg, fn);
+            }
+            break;
+        case Expression::kFieldAccess_Kind:
+            visit_expressions(&((FieldAccess&) **expr).fBase, fn);
+            break;
+        case Expression::kFunctionCall_Kind:
+            for (auto& arg : ((FunctionCall&) **expr).fArguments) {
+                visit_expressions(&arg, fn);
+            }
+            break;
+        case Expression::kIndex_Kind: {
+            IndexExpression& i = (IndexExpression&) **expr;
+            visit_expressions(&i.fBase, fn);
+            visit_expressions(&i.fIndex, fn);
+            break;
+        }
+        case Expression::kPrefix_Kind:
+            visit_expressions(&((PrefixExpression&) **expr).fOperand, fn);
+            break;
+        case Expression::kPostfix_Kind:
+            visit_expressions(&((PostfixExpression&) **expr).fOperand, fn);
+            break;
+        case Expression::kSwizzle_Kind:
+            visit_expressions(&((Swizzle&) **expr).fBase, fn);
+            break;
+        case Expression::kTernary_Kind: {
+            TernaryExpression& t = (TernaryExpression&) **expr;
+            visit_expressions(&t.fTest, fn);
+            visit_expressions(&t.fIfTrue, fn);
+            visit_expressions(&t.fIfFalse, fn);
+            break;
+        }
+        default:
+            break;
+    }
+    fn(expr);
+}
+
+// Calls fn on each expression slot under stmt, children before their parents.
+template <typename Fn>
+static void visit_expressions(std::unique_ptr<Statement>* stmt, Fn& fn) {
+    if (!*stmt) {
+        return;
+    }
+    switch ((*stmt)->fKind) {
+        case Statement::kBlock_Kind:
+            for (auto& child : ((Block&) **stmt).fStatements) {
+                visit_expressions(&child, fn);
+            }
+            break;
+        case Statement::kDo_Kind: {
+            DoStatement& d = (DoStatement&) **stmt;
+            visit_expressions(&d.fStatement, fn);
+            visit_expressions(&d.fTest, fn);
+            break;
+        }
+        case Statement::kExpression_Kind:
+            visit_expressions(&((ExpressionStatement&) **stmt).fExpression, fn);
+            break;
+        case Statement::kFor_Kind: {
+            ForStatement& f = (ForStatement&) **stmt;
+            visit_expressions(&f.fInitializer, fn);
+            visit_expressions(&f.fTest, fn);
+            visit_expressions(&f.fNext, fn);
+            visit_expressions(&f.fStatement, fn);
+            break;
+        }
+        case Statement::kIf_Kind: {
+            IfStatement& i = (IfStatement&) **stmt;
+            visit_expressions(&i.fTest, fn);
+            visit_expressions(&i.fIfTrue, fn);
+            visit_expressions(&i.fIfFalse, fn);
+            break;
+        }
+        case Statement::kReturn_Kind:
+            visit_expressions(&((ReturnStatement&) **stmt).fExpression, fn);
+            break;
+        case Statement::kSwitch_Kind: {
+            SwitchStatement& s = (SwitchStatement&) **stmt;
+            visit_expressions(&s.fValue, fn);
+            for (auto& c : s.fCases) {
+                visit_expressions(&c->fValue, fn);
+                for (auto& child : c->fStatements) {
+                    visit_expressions(&child, fn);
+                }
+            }
+            break;
+        }
+        case Statement::kVarDeclaration_Kind: {
+            VarDeclaration& v = (VarDeclaration&) **stmt;
+            for (auto& size : v.fSizes) {
+                visit_expressions(&size, fn);
+            }
+            visit_expressions(&v.fValue, fn);
+            break;
+        }
+        case Statement::kVarDeclarations_Kind:
+            for (auto& var : ((VarDeclarationsStatement&) **stmt).fDeclaration->fVars) {
+                visit_expressions(&var, fn);
+            }
+            break;
+        case Statement::kWhile_Kind: {
+            WhileStatement& w = (WhileStatement&) **stmt;
+            visit_expressions(&w.fTest, fn);
+            visit_expressions(&w.fStatement, fn);
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+// If the function's body is a single return of an expression without side effects, returns that
+// expression.
+static const Expression* inlinable_expression(const FunctionDefinition& f) {
+    if (f.fBody->fKind != Statement::kBlock_Kind) {
+        return nullptr;
+    }
+    const Block& body = (const Block&) *f.fBody;
+    if (body.fStatements.size() != 1 ||
+        body.fStatements[0]->fKind != Statement::kReturn_Kind) {
+        return nullptr;
+    }
+    const Expression* result = ((const ReturnStatement&) *body.fStatements[0]).fExpression.get();
+    if (!result || result->hasSideEffects()) {
+        return nullptr;
+    }
+    return result;
+}
+
+// Adds the names of the variables declared in stmt, and in the statements under it, to names.
+static void add_declared_names(const Statement* stmt, std::unordered_set<StringFragment>* names) {
+    if (!stmt) {
+        return;
+    }
+    switch (stmt->fKind) {
+        case Statement::kBlock_Kind:
+            for (const auto& child : ((const Block&) *stmt).fStatements) {
+                add_declared_names(child.get(), names);
+            }
+            break;
+        case Statement::kDo_Kind:
+            add_declared_names(((const DoStatement&) *stmt).fStatement.get(), names);
+            break;
+        case Statement::kFor_Kind: {
+            const ForStatement& f = (const ForStatement&) *stmt;
+            add_declared_names(f.fInitializer.get(), names);
+            add_declared_names(f.fStatement.get(), names);
+            break;
+        }
+        case Statement::kIf_Kind: {
+            const IfStatement& i = (const IfStatement&) *stmt;
+            add_declared_names(i.fIfTrue.get(), names);
+            add_declared_names(i.fIfFalse.get(), names);
+            break;
+        }
+        case Statement::kSwitch_Kind:
+            for (const auto& c : ((const SwitchStatement&) *stmt).fCases) {
+                for (const auto& child : c->fStatements) {
+                    add_declared_names(child.get(), names);
+                }
+            }
+            break;
+        case Statement::kVarDeclaration_Kind:
+            names->insert(((const VarDeclaration&) *stmt).fVar->fName);
+            break;
+        case Statement::kVarDeclarations_Kind:
+            for (const auto& var : ((const VarDeclarationsStatement&) *stmt).fDeclaration->fVars) {
+                add_declared_names(var.get(), names);
+            }
+            break;
+        case Statement::kWhile_Kind:
+            add_declared_names(((const WhileStatement&) *stmt).fStatement.get(), names);
+            break;
+        default:
+            break;
+    }
+}
+
+// Returns the inlined body of the call, or null if inlining it could change what the call does or
+// would evaluate a non-trivial argument more than once. The inlined body refers to variables by
+// name, so the call isn't inlined if the callee uses a global that one of the caller's parameters
+// or locals (callerNames) hides.
+static std::unique_ptr<Expression> inline_call(const FunctionCall& call,
+                                               const FunctionDefinition& f,
+                                               const std::unordered_set<StringFragment>&
+                                                       callerNames) {
+    const Expression* result = inlinable_expression(f);
+    if (!result) {
+        return nullptr;
+    }
+    const std::vector<const Variable*>& parameters = f.fDeclaration.fParameters;
+    for (size_t i = 0; i < parameters.size(); i++) {
+        const Variable& p = *parameters[i];
+        const Expression& arg = *call.fArguments[i];
+        if ((p.fModifiers.fFlags & Modifiers::kOut_Flag) || p.fWriteCount ||
+            arg.hasSideEffects()) {
+            return nullptr;
+        }
+        if (p.fReadCount > 1 && arg.fKind != Expression::kVariableReference_Kind &&
+            !arg.isConstant()) {
+            return nullptr;
+        }
+    }
+    std::unique_ptr<Expression> inlined = result->clone();
+    bool hidden = false;
+    auto substitute = [&](std::unique_ptr<Expression>* expr) {
+        if ((*expr)->fKind != Expression::kVariableReference_Kind) {
+            return;
+        }
+        const Variable* var = &((VariableReference&) **expr).fVariable;
+        for (size_t i = 0; i < parameters.size(); i++) {
+            if (parameters[i] == var) {
+                *expr = call.fArguments[i]->clone();
+                return;
+            }
+        }
+        if (callerNames.count(var->fName)) {
+            hidden = true;
+        }
+    };
+    visit_expressions(&inlined, substitute);
+    if (hidden) {
+        return nullptr;
+    }
+    return inlined;
+}
+
+void Compiler::inlineFunctions(Program& program) {
+    std::unordered_map<const FunctionDeclaration*, const FunctionDefinition*> definitions;
+    for (const auto& element : program.fElements) {
+        if (element->fKind == ProgramElement::kFunction_Kind) {
+            const FunctionDefinition& f = (const FunctionDefinition&) *element;
+            if (inlinable_expression(f)) {
+                definitions[&f.fDeclaration] = &f;
+            }
+        }
+    }
+    if (definitions.empty()) {
+        return;
+    }
+    // Functions must be declared before they are called, so by the time a function is inlined, the
+    // calls in its own body have already been inlined where possible.
+    for (auto& element : program.fElements) {
+        if (element->fKind != ProgramElement::kFunction_Kind) {
+            continue;
+        }
+        FunctionDefinition& caller = (FunctionDefinition&) *element;
+        std::unordered_set<StringFragment> callerNames;
+        for (const Variable* p : caller.fDeclaration.fParameters) {
+            callerNames.insert(p->fName);
+        }
+        add_declared_names(caller.fBody.get(), &callerNames);
+        auto inlineCall = [&](std::unique_ptr<Expression>* expr) {
+            if ((*expr)->fKind != Expression::kFunctionCall_Kind) {
+                return;
+            }
+            const FunctionCall& call = (const FunctionCall&) **expr;
+            auto found = definitions.find(&call.fFunction);
+            if (found == definitions.end() || found->second == &caller) {
+                return;
+            }
+            if (std::unique_ptr<Expression> inlined = inline_call(call, *found->second,
+                                                                  callerNames)) {
+                *expr = std::move(inlined);
+            }
+        };
+        visit_expressions(&caller.fBody, inlineCall);
+    }
+}
+
+void Compiler::removeDeadFunctions(Program& program) {
+    // Removing a function can leave the functions only it called uncalled, so repeat until
+    // nothing more is removed.
+    for (;;) {
+        std::unordered_set<const FunctionDeclaration*> called;
+        auto findCalls = [&](std::unique_ptr<Expression>* expr) {
+            if ((*expr)->fKind == Expression::kFunctionCall_Kind) {
+                called.insert(&((FunctionCall&) **expr).fFunction);
+            }
+        };
+        for (auto& element : program.fElements) {
+            if (element->fKind == ProgramElement::kFunction_Kind) {
+                visit_expressions(&((FunctionDefinition&) *element).fBody, findCalls);
+            } else if (element->fKind == ProgramElement::kVar_Kind) {
+                for (auto& var : ((VarDeclarations&) *element).fVars) {
+                    visit_expressions(&var, findCalls);
+                }
+            }
+        }
+        auto isDead = [&](const std::unique_ptr<ProgramElement>& element) {
+            if (element->fKind != ProgramElement::kFunction_Kind) {
+                return false;
+            }
+            const FunctionDeclaration& f = ((const FunctionDefinition&) *element).fDeclaration;
+            return f.fName != "main" && !called.count(&f);
+        };
+        auto firstDead = std::remove_if(program.fElements.begin(), program.fElements.end(),
+                                        isDead);
+        if (firstDead == program.fElements.end()) {
+            return;
+        }
+        program.fElements.erase(firstDead, program.fElements.end());
+    }
+}
+
 bool Compiler::optimize(Program& program) {
     SkASSERT(!fErrorCount);
     if (!program.fIsOptimized) {
         program.fIsOptimized = true;
         fIRGenerator->fKind = program.fKind;
         fIRGenerator->fSettings = &program.fSettings;
+        // Fragment processors and pipeline stages are emitted function by function into other
+        // programs, so only complete programs have their functions inlined and removed.
+        bool inlineFunctions = program.fKind == Program::kFragment_Kind ||
+                               program.fKind == Program::kVertex_Kind ||
+                               program.fKind == Program::kGeometry_Kind;
+        if (inlineFunctions) {
+            this->inlineFunctions(program);
+        }
         for (auto& element : program) {
             if (element.fKind == ProgramElement::kFunction_Kind) {
                 this->scanCFG((FunctionDefinition&) element);
             }
         }
+        if (inlineFunctions && !fErrorCount) {
+            this->removeDeadFunctions(program);
+        }
         fSource = nullptr;
     }
     return fErrorCount == 0;
@@ -166,8 +166,28 @@ private:
 
     void scanCFG(FunctionDefinition& f);
 
+    /**
+     * Replaces calls to functions whose body is a single return statement with the returned
+     * expression, where that evaluates the same things as the call.
+     */
+    void inlineFunctions(Program& program);
+
+    /** Removes the definitions of functions other than main() that are never called. */
+    void removeDeadFunctions(Program& program);
+
     Position position(int offset);
 
+    /** Converts sksl.inc into the root symbol table, if that hasn't happened yet. */
+    void loadBaseModule();
+
+    /**
+     * Converts the include module of the given kind of program, if that hasn't happened yet, and
+     * sets the IRGenerator's symbol table to the module's.
+     */
+    void loadModule(Program::Kind kind);
+
+    bool fBaseModuleLoaded = false;
+    std::shared_ptr<SymbolTable> fRootSymbolTable;
     std::vector<std::unique_ptr<ProgramElement>> fVertexInclude;
     std::shared_ptr<SymbolTable> fVertexSymbolTable;
     std::vector<std::unique_ptr<ProgramElement>> fFragmentInclude;
@@ -2287,36 +2287,42 @@ void IRGenerator::convertProgram(Program::Kind kind,
                                  size_t length,
                                  SymbolTable& types,
                                  std::vector<std::unique_ptr<ProgramElement>>* out) {
-    fKind = kind;
-    fProgramElements = out;
     Parser parser(text, length, types, fErrors);
     std::vector<std::unique_ptr<ASTDeclaration>> parsed = parser.file();
     if (fErrors.errorCount()) {
         return;
     }
+    this->convertProgram(kind, parsed, out);
+}
+
+void IRGenerator::convertProgram(Program::Kind kind,
+                                 const std::vector<std::unique_ptr<ASTDeclaration>>& parsed,
+                                 std::vector<std::unique_ptr<ProgramElement>>* out) {
+    fKind = kind;
+    fProgramElements = out;
     for (size_t i = 0; i < parsed.size(); i++) {
-        ASTDeclaration& decl = *parsed[i];
+        const ASTDeclaration& decl = *parsed[i];
         switch (decl.fKind) {
             case ASTDeclaration::kVar_Kind: {
                 std::unique_ptr<VarDeclarations> s = this->convertVarDeclarations(
-                                                                         (ASTVarDeclarations&) decl,
-                                                                         Variable::kGlobal_Storage);
+                                                                   (const ASTVarDeclarations&) decl,
+                                                                   Variable::kGlobal_Storage);
                 if (s) {
                     fProgramElements->push_back(std::move(s));
                 }
                 break;
             }
             case ASTDeclaration::kEnum_Kind: {
-                this->convertEnum((ASTEnum&) decl);
+                this->convertEnum((const ASTEnum&) decl);
                 break;
             }
             case ASTDeclaration::kFunction_Kind: {
-                this->convertFunction((ASTFunction&) decl);
+                this->convertFunction((const ASTFunction&) decl);
                 break;
             }
             case ASTDeclaration::kModifiers_Kind: {
                 std::unique_ptr<ModifiersDeclaration> f = this->convertModifiersDeclaration(
-                                                                   (ASTModifiersDeclaration&) decl);
+                                                             (const ASTModifiersDeclaration&) decl);
                 if (f) {
                     fProgramElements->push_back(std::move(f));
                 }
@@ -2324,21 +2330,21 @@ void IRGenerator::convertProgram(Program::Kind kind,
             }
             case ASTDeclaration::kInterfaceBlock_Kind: {
                 std::unique_ptr<InterfaceBlock> i = this->convertInterfaceBlock(
-                                                                         (ASTInterfaceBlock&) decl);
+                                                                   (const ASTInterfaceBlock&) decl);
                 if (i) {
                     fProgramElements->push_back(std::move(i));
                 }
                 break;
             }
             case ASTDeclaration::kExtension_Kind: {
-                std::unique_ptr<Extension> e = this->convertExtension((ASTExtension&) decl);
+                std::unique_ptr<Extension> e = this->convertExtension((const ASTExtension&) decl);
                 if (e) {
                     fProgramElements->push_back(std::move(e));
                 }
                 break;
             }
             case ASTDeclaration::kSection_Kind: {
-                std::unique_ptr<Section> s = this->convertSection((ASTSection&) decl);
+                std::unique_ptr<Section> s = this->convertSection((const ASTSection&) decl);
                 if (s) {
                     fProgramElements->push_back(std::move(s));
                 }
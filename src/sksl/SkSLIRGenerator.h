@@ -69,6 +69,14 @@ public:
                         SymbolTable& types,
                         std::vector<std::unique_ptr<ProgramElement>>* result);
 
+    /**
+     * Converts declarations that have already been parsed. The ASTs are not modified, so they may
+     * be shared between IRGenerators.
+     */
+    void convertProgram(Program::Kind kind,
+                        const std::vector<std::unique_ptr<ASTDeclaration>>& parsed,
+                        std::vector<std::unique_ptr<ProgramElement>>* result);
+
     /**
      * If both operands are compile-time constants and can be folded, returns an expression
      * representing the folded value. Otherwise, returns null. Note that unlike most other functions
@@ -9,6 +9,7 @@
 
 #include "SkSLInterpreter.h"
 #include "ir/SkSLBinaryExpression.h"
+#include "ir/SkSLConstructor.h"
 #include "ir/SkSLExpressionStatement.h"
 #include "ir/SkSLForStatement.h"
 #include "ir/SkSLFunctionCall.h"
@@ -19,10 +20,12 @@
 #include "ir/SkSLPrefixExpression.h"
 #include "ir/SkSLProgram.h"
 #include "ir/SkSLStatement.h"
+#include "ir/SkSLSwizzle.h"
 #include "ir/SkSLTernaryExpression.h"
 #include "ir/SkSLVarDeclarations.h"
 #include "ir/SkSLVarDeclarationsStatement.h"
 #include "ir/SkSLVariableReference.h"
+#include "SkArenaAlloc.h"
 #include "SkRasterPipeline.h"
 
 namespace SkSL {
@@ -41,7 +44,7 @@ void Interpreter::run() {
 }
 
 static int SizeOf(const Type& type) {
-    return 1;
+    return Type::kVector_Kind == type.kind() ? type.columns() : 1;
 }
 
 void Interpreter::run(const FunctionDefinition& f) {
@@ -179,7 +182,7 @@ void Interpreter::runStatement() {
 static Interpreter::TypeKind type_kind(const Type& type) {
     if (type.fName == "int") {
         return Interpreter::kInt_TypeKind;
-    } else if (type.fName == "float") {
+    } else if (type.fName == "float" || type.fName == "half") {
         return Interpreter::kFloat_TypeKind;
     }
     ABORT("unsupported type: %s\n", type.description().c_str());
@@ -193,8 +196,14 @@ Interpreter::StackIndex Interpreter::getLValue(const Expression& expr) {
             const IndexExpression& idx = (const IndexExpression&) expr;
             return this->evaluate(*idx.fBase).fInt + this->evaluate(*idx.fIndex).fInt;
         }
-        case Expression::kSwizzle_Kind:
+        case Expression::kSwizzle_Kind: {
+            // Values are scalars, so we can only address a single component of a vector.
+            const Swizzle& s = (const Swizzle&) expr;
+            if (s.fComponents.size() == 1) {
+                return this->getLValue(*s.fBase) + s.fComponents[0];
+            }
             break;
+        }
         case Expression::kVariableReference_Kind:
             SkASSERT(fVars.size());
             SkASSERT(fVars.back().find(&((VariableReference&) expr).fVariable) !=
@@ -230,6 +239,43 @@ static void do_callback(SkRasterPipeline_CallbackCtx* raw, int activePixels) {
     }
 }
 
+struct StageCtx : public SkRasterPipeline_CallbackCtx {
+    Interpreter* fInterpreter;
+    const FunctionDefinition* fFunction;
+};
+
+static void do_stage(SkRasterPipeline_CallbackCtx* raw, int activePixels) {
+    StageCtx& ctx = (StageCtx&) *raw;
+    for (int i = 0; i < activePixels; ++i) {
+        ctx.fInterpreter->runStage(*ctx.fFunction, &ctx.rgba[i * 4]);
+    }
+}
+
+void Interpreter::runStage(const FunctionDefinition& f, float color[4]) {
+    // x, y, and then the four components of color
+    StackIndex params = (StackIndex) fStack.size();
+    this->push(Value(0));
+    this->push(Value(0));
+    for (int i = 0; i < 4; ++i) {
+        this->push(Value(color[i]));
+    }
+    this->run(f);
+    for (int i = 0; i < 4; ++i) {
+        color[i] = fStack[params + 2 + i].fFloat;
+    }
+    // drop the parameters, along with any locals the function left on the stack
+    fStack.resize(params, Value(0));
+    fVars.pop_back();
+}
+
+void Interpreter::appendStageFunction(const FunctionDefinition& f, SkArenaAlloc* alloc) {
+    StageCtx* ctx = alloc->make<StageCtx>();
+    ctx->fInterpreter = this;
+    ctx->fFunction = &f;
+    ctx->fn = do_stage;
+    fPipeline.append(SkRasterPipeline::callback, ctx);
+}
+
 void Interpreter::appendStage(const AppendStage& a) {
     switch (a.fStage) {
         case SkRasterPipeline::matrix_4x5: {
@@ -382,8 +428,22 @@ Interpreter::Value Interpreter::evaluate(const Expression& expr) {
         }
         case Expression::kBoolLiteral_Kind:
             return Value(((const BoolLiteral&) expr).fValue);
-        case Expression::kConstructor_Kind:
+        case Expression::kConstructor_Kind: {
+            const Constructor& c = (const Constructor&) expr;
+            if (Type::kScalar_Kind == c.fType.kind() && c.fArguments.size() == 1) {
+                Value arg = this->evaluate(*c.fArguments[0]);
+                TypeKind from = type_kind(c.fArguments[0]->fType);
+                switch (type_kind(c.fType)) {
+                    case kFloat_TypeKind:
+                        return kInt_TypeKind == from ? Value((float) arg.fInt) : arg;
+                    case kInt_TypeKind:
+                        return kFloat_TypeKind == from ? Value((int) arg.fFloat) : arg;
+                    default:
+                        break;
+                }
+            }
             break;
+        }
         case Expression::kIntLiteral_Kind:
             return Value((int) ((const IntLiteral&) expr).fValue);
         case Expression::kFieldAccess_Kind:
@@ -449,6 +509,9 @@ Interpreter::Value Interpreter::evaluate(const Expression& expr) {
         case Expression::kSetting_Kind:
             break;
         case Expression::kSwizzle_Kind:
+            if (((const Swizzle&) expr).fComponents.size() == 1) {
+                return fStack[this->getLValue(expr)];
+            }
             break;
         case Expression::kVariableReference_Kind:
             SkASSERT(fVars.size());
@@ -17,6 +17,7 @@
 
 #include <stack>
 
+class SkArenaAlloc;
 class SkRasterPipeline;
 
 namespace SkSL {
@@ -74,6 +75,18 @@ public:
 
     void appendStage(const AppendStage& c);
 
+    /**
+     * Appends a stage to the pipeline which calls f, a function with the signature
+     * void f(int x, int y, inout half4 color), on each pixel in turn. The pixel coordinates are
+     * not available to the callback, so x and y are always zero.
+     */
+    void appendStageFunction(const FunctionDefinition& f, SkArenaAlloc* alloc);
+
+    /**
+     * Runs a stage function (see appendStageFunction) on a single pixel.
+     */
+    void runStage(const FunctionDefinition& f, float color[4]);
+
     Value evaluate(const Expression& expr);
 
 private:
@@ -1477,7 +1477,12 @@ bool JIT::compileVectorBinary(LLVMBuilderRef builder, const BinaryExpression& b,
             }
             int columns = b.fRight->fType.columns();
             for (int i = 0; i < columns; ++i) {
-                LLVMBuildStore(builder, right[i], left[i]);
+                LLVMValueRef value = right[i];
+                if (fVectorMask) {
+                    LLVMValueRef old = LLVMBuildLoad(builder, left[i], "masked load");
+                    value = LLVMBuildSelect(builder, fVectorMask, value, old, "masked store");
+                }
+                LLVMBuildStore(builder, value, left[i]);
             }
             return true;
         }
@@ -1495,6 +1500,63 @@ bool JIT::compileVectorBinary(LLVMBuilderRef builder, const BinaryExpression& b,
             VECTOR_BINARY(LLVMBuildAnd, LLVMBuildAnd, LLVMBuildAnd);
         case Token::BITWISEOR:
             VECTOR_BINARY(LLVMBuildOr, LLVMBuildOr, LLVMBuildOr);
+        // Comparisons produce a single vector of bools, so we only handle scalar operands.
+        #define VECTOR_COMPARE(signedCmp, signedPred, unsignedCmp, unsignedPred, floatCmp,      \
+                               floatPred) {                                                     \
+            if (b.fLeft->fType.columns() != 1 || b.fRight->fType.columns() != 1 ||              \
+                !this->getVectorBinaryOperands(builder, *b.fLeft, left, *b.fRight, right)) {    \
+                return false;                                                                   \
+            }                                                                                   \
+            switch (this->typeKind(b.fLeft->fType)) {                                           \
+                case kInt_TypeKind:                                                             \
+                    out[0] = signedCmp(builder, signedPred, left[0], right[0], "compare");      \
+                    return true;                                                                \
+                case kUInt_TypeKind:                                                            \
+                    out[0] = unsignedCmp(builder, unsignedPred, left[0], right[0], "compare");  \
+                    return true;                                                                \
+                case kFloat_TypeKind:                                                           \
+                    out[0] = floatCmp(builder, floatPred, left[0], right[0], "compare");        \
+                    return true;                                                                \
+                case kBool_TypeKind:                                                            \
+                    return false;                                                               \
+            }                                                                                   \
+            return false;                                                                       \
+        }
+        case Token::EQEQ:
+            VECTOR_COMPARE(LLVMBuildICmp, LLVMIntEQ,
+                           LLVMBuildICmp, LLVMIntEQ,
+                           LLVMBuildFCmp, LLVMRealOEQ);
+        case Token::NEQ:
+            VECTOR_COMPARE(LLVMBuildICmp, LLVMIntNE,
+                           LLVMBuildICmp, LLVMIntNE,
+                           LLVMBuildFCmp, LLVMRealONE);
+        case Token::LT:
+            VECTOR_COMPARE(LLVMBuildICmp, LLVMIntSLT,
+                           LLVMBuildICmp, LLVMIntULT,
+                           LLVMBuildFCmp, LLVMRealOLT);
+        case Token::LTEQ:
+            VECTOR_COMPARE(LLVMBuildICmp, LLVMIntSLE,
+                           LLVMBuildICmp, LLVMIntULE,
+                           LLVMBuildFCmp, LLVMRealOLE);
+        case Token::GT:
+            VECTOR_COMPARE(LLVMBuildICmp, LLVMIntSGT,
+                           LLVMBuildICmp, LLVMIntUGT,
+                           LLVMBuildFCmp, LLVMRealOGT);
+        case Token::GTEQ:
+            VECTOR_COMPARE(LLVMBuildICmp, LLVMIntSGE,
+                           LLVMBuildICmp, LLVMIntUGE,
+                           LLVMBuildFCmp, LLVMRealOGE);
+        case Token::LOGICALAND:
+        case Token::LOGICALOR:
+            // Every lane evaluates both operands, so we can't short circuit side effects.
+            if (b.fRight->hasSideEffects() ||
+                !this->getVectorBinaryOperands(builder, *b.fLeft, left, *b.fRight, right)) {
+                return false;
+            }
+            out[0] = b.fOperator == Token::LOGICALAND
+                             ? LLVMBuildAnd(builder, left[0], right[0], "&&")
+                             : LLVMBuildOr(builder, left[0], right[0], "||");
+            return true;
         default:
             printf("unsupported operator: %s\n", b.description().c_str());
             return false;
@@ -1512,6 +1574,11 @@ bool JIT::compileVectorConstructor(LLVMBuilderRef builder, const Constructor& c,
             if (!this->compileVectorExpression(builder, *c.fArguments[0], base)) {
                 return false;
             }
+            if (from == to) {
+                // e.g. float(half), which doesn't change the representation
+                out[0] = base[0];
+                return true;
+            }
             #define CONSTRUCT(fn)                                                                \
                 out[0] = LLVMGetUndef(LLVMVectorType(this->getType(c.fType), fVectorCount));     \
                 for (int i = 0; i < fVectorCount; ++i) {                                         \
@@ -1603,6 +1670,26 @@ bool JIT::compileVectorSwizzle(LLVMBuilderRef builder, const Swizzle& s,
     return true;
 }
 
+bool JIT::compileVectorTernary(LLVMBuilderRef builder, const TernaryExpression& t,
+                               LLVMValueRef out[CHANNELS]) {
+    // Both sides are evaluated for every lane, so they must not have side effects.
+    if (t.fIfTrue->hasSideEffects() || t.fIfFalse->hasSideEffects()) {
+        return false;
+    }
+    LLVMValueRef test;
+    LLVMValueRef ifTrue[CHANNELS];
+    LLVMValueRef ifFalse[CHANNELS];
+    if (!this->compileVectorExpression(builder, *t.fTest, &test) ||
+        !this->compileVectorExpression(builder, *t.fIfTrue, ifTrue) ||
+        !this->compileVectorExpression(builder, *t.fIfFalse, ifFalse)) {
+        return false;
+    }
+    for (int i = 0; i < t.fType.columns(); ++i) {
+        out[i] = LLVMBuildSelect(builder, test, ifTrue[i], ifFalse[i], "ternary");
+    }
+    return true;
+}
+
 bool JIT::compileVectorVariableReference(LLVMBuilderRef builder, const VariableReference& v,
                                          LLVMValueRef out[CHANNELS]) {
     if (&v.fVariable == fColorParam) {
@@ -1625,6 +1712,8 @@ bool JIT::compileVectorExpression(LLVMBuilderRef builder, const Expression& expr
             return this->compileVectorFloatLiteral(builder, (const FloatLiteral&) expr, out);
         case Expression::kSwizzle_Kind:
             return this->compileVectorSwizzle(builder, (const Swizzle&) expr, out);
+        case Expression::kTernary_Kind:
+            return this->compileVectorTernary(builder, (const TernaryExpression&) expr, out);
         case Expression::kVariableReference_Kind:
             return this->compileVectorVariableReference(builder, (const VariableReference&) expr,
                                                         out);
@@ -1633,6 +1722,23 @@ bool JIT::compileVectorExpression(LLVMBuilderRef builder, const Expression& expr
     }
 }
 
+bool JIT::compileVectorIf(LLVMBuilderRef builder, const IfStatement& i) {
+    LLVMValueRef test;
+    if (!this->compileVectorExpression(builder, *i.fTest, &test)) {
+        return false;
+    }
+    LLVMValueRef oldMask = fVectorMask;
+    fVectorMask = oldMask ? LLVMBuildAnd(builder, oldMask, test, "if mask") : test;
+    bool success = this->compileVectorStatement(builder, *i.fIfTrue);
+    if (success && i.fIfFalse) {
+        LLVMValueRef notTest = LLVMBuildNot(builder, test, "else");
+        fVectorMask = oldMask ? LLVMBuildAnd(builder, oldMask, notTest, "else mask") : notTest;
+        success = this->compileVectorStatement(builder, *i.fIfFalse);
+    }
+    fVectorMask = oldMask;
+    return success;
+}
+
 bool JIT::compileVectorStatement(LLVMBuilderRef builder, const Statement& stmt) {
     switch (stmt.fKind) {
         case Statement::kBlock_Kind:
@@ -1647,6 +1753,10 @@ bool JIT::compileVectorStatement(LLVMBuilderRef builder, const Statement& stmt)
             return this->compileVectorExpression(builder,
                                                  *((const ExpressionStatement&) stmt).fExpression,
                                                  &result);
+        case Statement::kIf_Kind:
+            return this->compileVectorIf(builder, (const IfStatement&) stmt);
+        case Statement::kNop_Kind:
+            return true;
         default:
             return false;
     }
@@ -1673,6 +1783,7 @@ bool JIT::compileStageFunctionVector(const FunctionDefinition& f, LLVMValueRef n
     LLVMBuildStore(builder, params.get()[7], fChannels[3]);
     LLVMBasicBlockRef start = LLVMAppendBasicBlockInContext(fContext, fCurrentFunction, "start");
     this->setBlock(builder, start);
+    fVectorMask = nullptr;
     bool success = this->compileVectorStatement(builder, *f.fBody);
     if (success) {
         // increment program pointer, call next
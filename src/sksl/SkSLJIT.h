@@ -230,6 +230,9 @@ private:
     bool compileVectorSwizzle(LLVMBuilderRef builder, const Swizzle& s,
                               LLVMValueRef out[CHANNELS]);
 
+    bool compileVectorTernary(LLVMBuilderRef builder, const TernaryExpression& t,
+                              LLVMValueRef out[CHANNELS]);
+
     bool compileVectorVariableReference(LLVMBuilderRef builder, const VariableReference& v,
                                         LLVMValueRef out[CHANNELS]);
 
@@ -246,6 +249,13 @@ private:
                                  LLVMValueRef outLeft[CHANNELS], const Expression& right,
                                  LLVMValueRef outRight[CHANNELS]);
 
+    /**
+     * Control flow is vectorized by evaluating both sides of a branch for every pixel, with
+     * fVectorMask narrowed to the pixels that take each side; stores to the color channels then
+     * only change the pixels whose lanes are set in the mask.
+     */
+    bool compileVectorIf(LLVMBuilderRef builder, const IfStatement& i);
+
     bool compileVectorStatement(LLVMBuilderRef builder, const Statement& stmt);
 
     /**
@@ -330,6 +340,9 @@ private:
     LLVMValueRef fChannels[CHANNELS];
     // when processing a stage function, this points to the SkSL color parameter (an inout float4)
     const Variable* fColorParam;
+    // when compiling a vectorized stage function, the lanes (pixels) that the code being compiled
+    // applies to, as a vector of fVectorCount bools. Null means all of them.
+    LLVMValueRef fVectorMask;
     std::unordered_map<const FunctionDeclaration*, LLVMValueRef> fFunctions;
     std::unordered_map<const Variable*, LLVMValueRef> fVariables;
     // LLVM function parameters are read-only, so when modifying function parameters we need to
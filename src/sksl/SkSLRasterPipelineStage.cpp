@@ -0,0 +1,115 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SKSL_STANDALONE
+
+#include "SkSLRasterPipelineStage.h"
+
+#include "SkArenaAlloc.h"
+#include "SkMutex.h"
+#include "SkRasterPipeline.h"
+#include "SkSLCompiler.h"
+#include "SkSLInterpreter.h"
+#include "SkTHash.h"
+#include "ir/SkSLFunctionDefinition.h"
+
+#ifdef SK_LLVM_AVAILABLE
+#include "SkSLJIT.h"
+#endif
+
+namespace SkSL {
+
+namespace {
+
+// Compiling is not thread safe, and each JIT module must outlive every pipeline using its stages,
+// so one compiler (and JIT) is shared by the whole process and guarded by fMutex.
+struct StageCompiler {
+    SkMutex fMutex;
+    Compiler fCompiler;
+#ifdef SK_LLVM_AVAILABLE
+    JIT fJIT{&fCompiler};
+    std::vector<std::unique_ptr<JIT::Module>> fModules;
+    // null for programs which failed to compile
+    SkTHashMap<SkString, void*> fStages;
+#endif
+};
+
+} // namespace
+
+static StageCompiler* stage_compiler() {
+    static StageCompiler* gCompiler = new StageCompiler;
+    return gCompiler;
+}
+
+static const FunctionDefinition* find_stage_function(const Program& program, const char* name) {
+    const Context& context = *program.fContext;
+    for (const auto& e : program) {
+        if (ProgramElement::kFunction_Kind != e.fKind) {
+            continue;
+        }
+        const FunctionDeclaration& f = ((const FunctionDefinition&) e).fDeclaration;
+        if (f.fName == name &&
+            f.fReturnType == *context.fVoid_Type &&
+            f.fParameters.size() == 3 &&
+            f.fParameters[0]->fType == *context.fInt_Type &&
+            f.fParameters[1]->fType == *context.fInt_Type &&
+            f.fParameters[2]->fType == *context.fHalf4_Type &&
+            f.fParameters[2]->fModifiers.fFlags == (Modifiers::kIn_Flag | Modifiers::kOut_Flag)) {
+            return (const FunctionDefinition*) &e;
+        }
+    }
+    return nullptr;
+}
+
+bool AppendRasterPipelineStage(const char* src, const char* name, SkRasterPipeline* pipeline,
+                               SkArenaAlloc* alloc) {
+    StageCompiler* compiler = stage_compiler();
+    SkAutoMutexAcquire lock(compiler->fMutex);
+#ifdef SK_LLVM_AVAILABLE
+    // Names can't contain a colon, so this can't be confused with another name and source.
+    SkString key(name);
+    key.append(":");
+    key.append(src);
+    if (void** stage = compiler->fStages.find(key)) {
+        if (!*stage) {
+            return false;
+        }
+        pipeline->append(*stage, nullptr);
+        return true;
+    }
+#endif
+    Program::Settings settings;
+    std::unique_ptr<Program> program =
+            compiler->fCompiler.convertProgram(Program::kPipelineStage_Kind, String(src), settings);
+    const FunctionDefinition* f = program ? find_stage_function(*program, name) : nullptr;
+#ifdef SK_LLVM_AVAILABLE
+    void* stage = nullptr;
+    if (f) {
+        std::unique_ptr<JIT::Module> module = compiler->fJIT.compile(std::move(program));
+        stage = module->getJumperStage(name);
+        compiler->fModules.push_back(std::move(module));
+    }
+    compiler->fStages.set(key, stage);
+    if (!stage) {
+        return false;
+    }
+    pipeline->append(stage, nullptr);
+#else
+    if (!f || f->fDeclaration.fParameters[0]->fReadCount ||
+        f->fDeclaration.fParameters[1]->fReadCount) {
+        return false;
+    }
+    auto stack = alloc->make<std::vector<Interpreter::Value>>();
+    auto interpreter = alloc->make<Interpreter>(std::move(program), pipeline, stack);
+    interpreter->appendStageFunction(*f, alloc);
+#endif
+    return true;
+}
+
+} // namespace
+
+#endif
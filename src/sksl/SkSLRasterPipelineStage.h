@@ -0,0 +1,35 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SKSL_RASTERPIPELINESTAGE
+#define SKSL_RASTERPIPELINESTAGE
+
+class SkArenaAlloc;
+class SkRasterPipeline;
+
+namespace SkSL {
+
+/**
+ * Compiles 'src' as a pipeline stage program and appends its function 'name' to the pipeline. The
+ * function must have the signature void name(int x, int y, inout half4 color), and is called to
+ * transform the color of each pixel.
+ *
+ * When Skia is built with LLVM (the skia_llvm_path gn arg), the function is compiled to native
+ * code by SkSL::JIT, which works on a full vector of pixels at once. Compiled stages are cached
+ * per process by their source and name, so appending the same stage again is just a hash lookup.
+ * Otherwise the function is run by SkSL::Interpreter, one pixel at a time; the pixel coordinates
+ * are not available to it, so functions which read x or y are rejected.
+ *
+ * Returns false if the program fails to compile or has no suitable function. Any allocations which
+ * must live as long as the pipeline are made in 'alloc'.
+ */
+bool AppendRasterPipelineStage(const char* src, const char* name, SkRasterPipeline* pipeline,
+                               SkArenaAlloc* alloc);
+
+} // namespace
+
+#endif
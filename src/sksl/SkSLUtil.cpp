@@ -7,6 +7,11 @@
 
 #include "SkSLUtil.h"
 
+#ifndef SKSL_STANDALONE
+#include "GrMemoryPool.h"
+#include "SkSpinlock.h"
+#endif
+
 #ifndef __STDC_FORMAT_MACROS
 #define __STDC_FORMAT_MACROS
 #endif
@@ -30,4 +35,37 @@ void write_stringstream(const StringStream& s, OutputStream& out) {
     out.write(s.str().c_str(), s.str().size());
 }
 
+#ifndef SKSL_STANDALONE
+static SkSpinlock gNodePoolSpinlock;
+
+namespace {
+class NodePoolAccessor {
+public:
+    NodePoolAccessor() { gNodePoolSpinlock.acquire(); }
+    ~NodePoolAccessor() { gNodePoolSpinlock.release(); }
+
+    GrMemoryPool* pool() const {
+        // Nodes are released in no particular order, so released ones are recycled through the
+        // size class free lists. The parsed include modules are never released, so neither is the
+        // pool.
+        static GrMemoryPool* gPool = [] {
+            GrMemoryPool::Options options;
+            options.fSizeClassFreeLists = true;
+            options.fWarmBlockBytes = 64 * 1024;
+            return new GrMemoryPool(16 * 1024, 16 * 1024, options);
+        }();
+        return gPool;
+    }
+};
+}
+
+void* allocate_node(size_t size) {
+    return NodePoolAccessor().pool()->allocate(size);
+}
+
+void release_node(void* node) {
+    NodePoolAccessor().pool()->release(node);
+}
+#endif
+
 } // namespace
@@ -400,6 +400,22 @@ void write_stringstream(const StringStream& d, OutputStream& out);
 
 NORETURN void sksl_abort();
 
+#ifndef SKSL_STANDALONE
+/**
+ * Compiling a program creates and destroys thousands of small IR and AST nodes, so their memory
+ * comes from a shared pool instead of the system allocator. The pool is safe to use from several
+ * threads at once.
+ */
+void* allocate_node(size_t size);
+void release_node(void* node);
+
+#define SKSL_POOLED_NEW_AND_DELETE                                                   \
+    void* operator new(size_t size) { return SkSL::allocate_node(size); }           \
+    void operator delete(void* node) { if (node) { SkSL::release_node(node); } }
+#else
+#define SKSL_POOLED_NEW_AND_DELETE
+#endif
+
 } // namespace
 
 #ifdef SKSL_STANDALONE
@@ -9,6 +9,7 @@
 #define SKSL_ASTNODE
 
 #include "SkSLString.h"
+#include "SkSLUtil.h"
 
 namespace SkSL {
 
@@ -20,6 +21,8 @@ struct ASTNode {
     virtual ~ASTNode() {}
 
     virtual String description() const = 0;
+
+    SKSL_POOLED_NEW_AND_DELETE
 };
 
 } // namespace
@@ -9,6 +9,7 @@
 #define SKSL_IRNODE
 
 #include "../SkSLLexer.h"
+#include "../SkSLUtil.h"
 
 namespace SkSL {
 
@@ -24,6 +25,8 @@ struct IRNode {
 
     virtual String description() const = 0;
 
+    SKSL_POOLED_NEW_AND_DELETE
+
     // character offset of this element within the program being compiled, for error reporting
     // purposes
     int fOffset;
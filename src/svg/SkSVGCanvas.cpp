@@ -19,6 +19,11 @@ std::unique_ptr<SkCanvas> SkSVGCanvas::Make(const SkRect& bounds, SkXMLWriter* w
 }
 
 std::unique_ptr<SkCanvas> SkSVGCanvas::Make(const SkRect& bounds, SkWStream* writer) {
-    SkXMLStreamWriter xmlWriter(writer);
-    return Make(bounds, &xmlWriter);
+    // TODO: pass full bounds to the device
+    SkISize size = bounds.roundOut().size();
+    // The device owns the xml writer, which writes straight to the stream as it draws.
+    sk_sp<SkBaseDevice> device(SkSVGDevice::Create(size,
+                                                   skstd::make_unique<SkXMLStreamWriter>(writer)));
+
+    return skstd::make_unique<SkCanvas>(device);
 }
@@ -17,12 +17,13 @@
 #include "SkColorFilter.h"
 #include "SkData.h"
 #include "SkDraw.h"
+#include "SkFloatToDecimal.h"
+#include "SkGeometry.h"
 #include "SkImage.h"
 #include "SkImageEncoder.h"
 #include "SkJpegCodec.h"
 #include "SkPaint.h"
 #include "SkPaintPriv.h"
-#include "SkParsePath.h"
 #include "SkPngCodec.h"
 #include "SkShader.h"
 #include "SkStream.h"
@@ -240,6 +241,7 @@ public:
 
     void addRectAttributes(const SkRect&);
     void addPathAttributes(const SkPath&);
+    void addDataUriAttribute(const char name[], const char mimeType[], const SkData& data);
     void addTextAttributes(const SkPaint&);
 
 private:
@@ -402,38 +404,43 @@ void SkSVGDevice::AutoElement::addColorFilterResources(const SkColorFilter& cf,
 
 // Returns data uri from bytes.
 // it will use any cached data if available, otherwise will
-// encode as png.
-sk_sp<SkData> AsDataUri(SkImage* image) {
+// Returns the image's data for a data uri: its own if it's a jpeg or png, otherwise encoded as png.
+static sk_sp<SkData> encode_for_data_uri(SkImage* image, const char** mimeType) {
     sk_sp<SkData> imageData = image->encodeToData();
     if (!imageData) {
         return nullptr;
     }
 
     const char* src = (char*)imageData->data();
-    const char* selectedPrefix = nullptr;
-    size_t selectedPrefixLength = 0;
-
-    const static char pngDataPrefix[] = "data:image/png;base64,";
-    const static char jpgDataPrefix[] = "data:image/jpeg;base64,";
-
     if (SkJpegCodec::IsJpeg(src, imageData->size())) {
-        selectedPrefix = jpgDataPrefix;
-        selectedPrefixLength = sizeof(jpgDataPrefix);
+        *mimeType = "image/jpeg";
     } else {
       if (!SkPngCodec::IsPng(src, imageData->size())) {
         imageData = image->encodeToData(SkEncodedImageFormat::kPNG, 100);
       }
-      selectedPrefix = pngDataPrefix;
-      selectedPrefixLength = sizeof(pngDataPrefix);
+      *mimeType = "image/png";
     }
+    return imageData;
+}
 
-    size_t b64Size = SkBase64::Encode(imageData->data(), imageData->size(), nullptr);
-    sk_sp<SkData> dataUri = SkData::MakeUninitialized(selectedPrefixLength + b64Size);
-    char* dest = (char*)dataUri->writable_data();
-    memcpy(dest, selectedPrefix, selectedPrefixLength);
-    SkBase64::Encode(imageData->data(), imageData->size(), dest + selectedPrefixLength - 1);
-    dest[dataUri->size() - 1] = 0;
-    return dataUri;
+// Base64 is written a chunk at a time, so a large image never needs all of it in memory at once.
+void SkSVGDevice::AutoElement::addDataUriAttribute(const char name[], const char mimeType[],
+                                                   const SkData& data) {
+    static constexpr size_t kChunkSize = 3 * 1024;  // Bytes in, a multiple of 3 so no padding.
+    char b64[kChunkSize / 3 * 4];
+
+    fWriter->startAttribute(name);
+    SkString prefix = SkStringPrintf("data:%s;base64,", mimeType);
+    fWriter->appendAttributeValue(prefix.c_str(), prefix.size());
+    const uint8_t* src = data.bytes();
+    for (size_t left = data.size(); left > 0; ) {
+        size_t chunk = SkTMin(left, kChunkSize);
+        size_t b64Size = SkBase64::Encode(src, chunk, b64);
+        fWriter->appendAttributeValue(b64, b64Size);
+        src += chunk;
+        left -= chunk;
+    }
+    fWriter->endAttribute();
 }
 
 void SkSVGDevice::AutoElement::addImageShaderResources(const SkShader* shader, const SkPaint& paint,
@@ -446,8 +453,9 @@ void SkSVGDevice::AutoElement::addImageShaderResources(const SkShader* shader, c
 
     SkString patternDims[2];  // width, height
 
-    sk_sp<SkData> dataUri = AsDataUri(image);
-    if (!dataUri) {
+    const char* mimeType;
+    sk_sp<SkData> imageData = encode_for_data_uri(image, &mimeType);
+    if (!imageData) {
         return;
     }
     SkIRect imageSize = image->bounds();
@@ -482,7 +490,7 @@ void SkSVGDevice::AutoElement::addImageShaderResources(const SkShader* shader, c
             imageTag.addAttribute("y", 0);
             imageTag.addAttribute("width", image->width());
             imageTag.addAttribute("height", image->height());
-            imageTag.addAttribute("xlink:href", static_cast<const char*>(dataUri->data()));
+            imageTag.addDataUriAttribute("xlink:href", mimeType, *imageData);
         }
     }
     resources->fPaintServer.printf("url(#%s)", patternID.c_str());
@@ -582,10 +590,81 @@ void SkSVGDevice::AutoElement::addRectAttributes(const SkRect& rect) {
     this->addAttribute("height", rect.height());
 }
 
+namespace {
+// Writes the same path data as SkParsePath::ToSVGString(), but a buffer at a time straight to the
+// writer, and with SkFloatToDecimal() rather than printf.
+class PathDataWriter {
+public:
+    explicit PathDataWriter(SkXMLWriter* writer) : fWriter(writer) {}
+    ~PathDataWriter() { this->flush(); }
+
+    void writeVerb(char verb, const SkScalar data[], int count) {
+        this->reserve(1);
+        *fCursor++ = verb;
+        for (int i = 0; i < count; ++i) {
+            if (i > 0) {
+                this->reserve(1);
+                *fCursor++ = ' ';
+            }
+            this->reserve(kMaximumSkFloatToDecimalLength);
+            fCursor += SkFloatToDecimal(SkScalarToFloat(data[i]), fCursor);
+        }
+    }
+
+private:
+    void reserve(size_t bytes) {
+        if (fCursor + bytes > fBuffer + sizeof(fBuffer)) {
+            this->flush();
+        }
+    }
+    void flush() {
+        fWriter->appendAttributeValue(fBuffer, fCursor - fBuffer);
+        fCursor = fBuffer;
+    }
+
+    SkXMLWriter* fWriter;
+    char         fBuffer[1024];
+    char*        fCursor = fBuffer;
+};
+}  // namespace
+
 void SkSVGDevice::AutoElement::addPathAttributes(const SkPath& path) {
-    SkString pathData;
-    SkParsePath::ToSVGString(path, &pathData);
-    this->addAttribute("d", pathData);
+    fWriter->startAttribute("d");
+    {
+        PathDataWriter data(fWriter);
+        SkPath::Iter iter(path, false);
+        SkPoint pts[4];
+        for (SkPath::Verb verb; (verb = iter.next(pts, false)) != SkPath::kDone_Verb; ) {
+            switch (verb) {
+                case SkPath::kConic_Verb: {
+                    const SkScalar tol = SK_Scalar1 / 1024; // how close to a quad
+                    SkAutoConicToQuads quadder;
+                    const SkPoint* quadPts = quadder.computeQuads(pts, iter.conicWeight(), tol);
+                    for (int i = 0; i < quadder.countQuads(); ++i) {
+                        data.writeVerb('Q', &quadPts[i*2 + 1].fX, 4);
+                    }
+                } break;
+                case SkPath::kMove_Verb:
+                    data.writeVerb('M', &pts[0].fX, 2);
+                    break;
+                case SkPath::kLine_Verb:
+                    data.writeVerb('L', &pts[1].fX, 2);
+                    break;
+                case SkPath::kQuad_Verb:
+                    data.writeVerb('Q', &pts[1].fX, 4);
+                    break;
+                case SkPath::kCubic_Verb:
+                    data.writeVerb('C', &pts[1].fX, 6);
+                    break;
+                case SkPath::kClose_Verb:
+                    data.writeVerb('Z', nullptr, 0);
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+    fWriter->endAttribute();
 }
 
 void SkSVGDevice::AutoElement::addTextAttributes(const SkPaint& paint) {
@@ -643,6 +722,16 @@ SkBaseDevice* SkSVGDevice::Create(const SkISize& size, SkXMLWriter* writer) {
     return new SkSVGDevice(size, writer);
 }
 
+SkBaseDevice* SkSVGDevice::Create(const SkISize& size, std::unique_ptr<SkXMLWriter> writer) {
+    if (!writer) {
+        return nullptr;
+    }
+
+    SkSVGDevice* device = new SkSVGDevice(size, writer.get());
+    device->fOwnedWriter = std::move(writer);
+    return device;
+}
+
 SkSVGDevice::SkSVGDevice(const SkISize& size, SkXMLWriter* writer)
     : INHERITED(SkImageInfo::MakeUnknown(size.fWidth, size.fHeight),
                 SkSurfaceProps(0, kUnknown_SkPixelGeometry))
@@ -783,13 +872,6 @@ void SkSVGDevice::drawBitmapCommon(const MxCp& mc, const SkBitmap& bm, const SkP
         return;
     }
 
-    size_t b64Size = SkBase64::Encode(pngData->data(), pngData->size(), nullptr);
-    SkAutoTMalloc<char> b64Data(b64Size);
-    SkBase64::Encode(pngData->data(), pngData->size(), b64Data.get());
-
-    SkString svgImageData("data:image/png;base64,");
-    svgImageData.append(b64Data.get(), b64Size);
-
     SkString imageID = fResourceBucket->addImage();
     {
         AutoElement defs("defs", fWriter);
@@ -798,7 +880,7 @@ void SkSVGDevice::drawBitmapCommon(const MxCp& mc, const SkBitmap& bm, const SkP
             image.addAttribute("id", imageID);
             image.addAttribute("width", bm.width());
             image.addAttribute("height", bm.height());
-            image.addAttribute("xlink:href", svgImageData);
+            image.addDataUriAttribute("xlink:href", "image/png", *pngData);
         }
     }
 
@@ -16,6 +16,8 @@ class SkXMLWriter;
 class SkSVGDevice : public SkClipStackDevice {
 public:
     static SkBaseDevice* Create(const SkISize& size, SkXMLWriter* writer);
+    // The device owns this writer, e.g. one streaming to an SkWStream.
+    static SkBaseDevice* Create(const SkISize& size, std::unique_ptr<SkXMLWriter> writer);
 
 protected:
     void drawPaint(const SkPaint& paint) override;
@@ -52,6 +54,7 @@ private:
     class AutoElement;
     class ResourceBucket;
 
+    std::unique_ptr<SkXMLWriter>    fOwnedWriter;  // Outlives fRootElement, which writes on exit.
     SkXMLWriter*                    fWriter;
     std::unique_ptr<AutoElement>    fRootElement;
     std::unique_ptr<ResourceBucket> fResourceBucket;
@@ -10,9 +10,17 @@
 #include "SkCodecImageGenerator.h"
 #include "SkData.h"
 #include "SkImage.h"
+#include "SkTaskGroup.h"
+#include "SkTo.h"
 #include <algorithm>
 
-SkAnimCodecPlayer::SkAnimCodecPlayer(std::unique_ptr<SkCodec> codec) : fCodec(std::move(codec)) {
+// How many frames, counting the current one, to decode ahead in the background.
+static constexpr int kPrefetchFrames = 3;
+
+SkAnimCodecPlayer::SkAnimCodecPlayer(std::unique_ptr<SkCodec> codec, size_t cacheBudget,
+                                     SkExecutor* executor)
+    : fCodec(std::move(codec))
+    , fCacheBudget(cacheBudget) {
     fImageInfo = fCodec->getInfo();
     fFrameInfos = fCodec->getFrameInfo();
     fImages.resize(fFrameInfos.size());
@@ -31,42 +39,141 @@ SkAnimCodecPlayer::SkAnimCodecPlayer(std::unique_ptr<SkCodec> codec) : fCodec(st
         fImages.clear();
         fImages.push_back(SkImage::MakeFromGenerator(
                               SkCodecImageGenerator::MakeFromCodec(std::move(fCodec))));
+        return;
+    }
+
+    if (executor) {
+        fPrefetchTasks.reset(new SkTaskGroup(*executor));
+        this->prefetch();
     }
 }
 
-SkAnimCodecPlayer::~SkAnimCodecPlayer() {}
+SkAnimCodecPlayer::~SkAnimCodecPlayer() {
+    if (fPrefetchTasks) {
+        fPrefetchTasks->wait();
+    }
+}
 
 SkISize SkAnimCodecPlayer::dimensions() {
     return { fImageInfo.width(), fImageInfo.height() };
 }
 
-sk_sp<SkImage> SkAnimCodecPlayer::getFrameAt(int index) {
-    SkASSERT((unsigned)index < fFrameInfos.size());
+sk_sp<SkImage> SkAnimCodecPlayer::findFrame(int index) {
+    SkAutoMutexAcquire lock(fCacheMutex);
+    return fImages[index];
+}
+
+void SkAnimCodecPlayer::cacheFrame(int index, sk_sp<SkImage> image) {
+    const size_t frameBytes = fImageInfo.computeMinByteSize();
+    const int count = SkToInt(fFrameInfos.size()),
+              curr  = fCurrIndex.load();
 
+    SkAutoMutexAcquire lock(fCacheMutex);
     if (fImages[index]) {
-        return fImages[index];
+        return;
+    }
+    fImages[index] = std::move(image);
+    fCachedBytes += frameBytes;
+    if (fCachedBytes <= fCacheBudget) {
+        return;
+    }
+
+    // How many frames from now playback will next need each frame, either to show it or to
+    // decode a frame on top of it.
+    std::vector<int> nextUse(count, count);
+    for (int i = count - 1; i >= 0; i--) {
+        int frame = (curr + i) % count,
+            required = fFrameInfos[frame].fRequiredFrame;
+        nextUse[frame] = i;
+        if (required != SkCodec::kNoFrame) {
+            nextUse[required] = SkTMin(nextUse[required], i);
+        }
+    }
+
+    // Drop the frames needed last, but never the current one.
+    while (fCachedBytes > fCacheBudget) {
+        int victim = -1;
+        for (int i = 0; i < count; i++) {
+            if (fImages[i] && i != curr && (victim < 0 || nextUse[i] > nextUse[victim])) {
+                victim = i;
+            }
+        }
+        if (victim < 0) {
+            break;
+        }
+        fImages[victim] = nullptr;
+        fCachedBytes -= frameBytes;
+    }
+}
+
+sk_sp<SkImage> SkAnimCodecPlayer::decodeFrame(int index) {
+    // Decode the frames this one is drawn on top of first, back to one which is cached or
+    // which needs no other, so that each is decoded once and can be cached for later.
+    std::vector<int> frames;
+    sk_sp<SkImage> prior;
+    for (int i = index; i != SkCodec::kNoFrame; i = fFrameInfos[i].fRequiredFrame) {
+        if ((prior = this->findFrame(i))) {
+            break;
+        }
+        frames.push_back(i);
     }
 
     size_t rb = fImageInfo.minRowBytes();
     size_t size = fImageInfo.computeByteSize(rb);
-    auto data = SkData::MakeUninitialized(size);
-
-    SkCodec::Options opts;
-    opts.fFrameIndex = index;
-
-    const int requiredFrame = fFrameInfos[index].fRequiredFrame;
-    if (requiredFrame != SkCodec::kNoFrame) {
-        auto requiredImage = fImages[requiredFrame];
-        SkPixmap requiredPM;
-        if (requiredImage && requiredImage->peekPixels(&requiredPM)) {
-            sk_careful_memcpy(data->writable_data(), requiredPM.addr(), size);
-            opts.fPriorFrame = requiredFrame;
+    for (auto frame = frames.rbegin(); frame != frames.rend(); ++frame) {
+        auto data = SkData::MakeUninitialized(size);
+
+        SkCodec::Options opts;
+        opts.fFrameIndex = *frame;
+
+        SkPixmap priorPM;
+        if (prior && prior->peekPixels(&priorPM)) {
+            sk_careful_memcpy(data->writable_data(), priorPM.addr(), size);
+            opts.fPriorFrame = fFrameInfos[*frame].fRequiredFrame;
         }
+        if (SkCodec::kSuccess != fCodec->getPixels(fImageInfo, data->writable_data(), rb, &opts)) {
+            return nullptr;
+        }
+        prior = SkImage::MakeRasterData(fImageInfo, std::move(data), rb);
+        this->cacheFrame(*frame, prior);
     }
-    if (SkCodec::kSuccess == fCodec->getPixels(fImageInfo, data->writable_data(), rb, &opts)) {
-        return fImages[index] = SkImage::MakeRasterData(fImageInfo, std::move(data), rb);
+    return prior;
+}
+
+sk_sp<SkImage> SkAnimCodecPlayer::getFrameAt(int index) {
+    SkASSERT((unsigned)index < fFrameInfos.size());
+
+    if (auto image = this->findFrame(index)) {
+        return image;
+    }
+    SkAutoMutexAcquire lock(fCodecMutex);
+    return this->decodeFrame(index);
+}
+
+void SkAnimCodecPlayer::prefetch() {
+    if (!fPrefetchTasks || fPrefetching.exchange(true)) {
+        return;
     }
-    return nullptr;
+    fPrefetchTasks->add([this] {
+        const int count = SkToInt(fFrameInfos.size());
+        int from;
+        do {
+            from = fCurrIndex.load();
+            for (int i = 0; i < kPrefetchFrames && i < count; i++) {
+                int index = (from + i) % count;
+                if (!this->findFrame(index)) {
+                    SkAutoMutexAcquire lock(fCodecMutex);
+                    this->decodeFrame(index);
+                }
+            }
+        } while (from != fCurrIndex.load());
+        fPrefetching.store(false);
+
+        // Catch a seek() which happened as we were finishing.
+        if (from != fCurrIndex.load()) {
+            this->prefetch();
+        }
+    });
 }
 
 sk_sp<SkImage> SkAnimCodecPlayer::getFrame() {
@@ -88,9 +195,13 @@ bool SkAnimCodecPlayer::seek(uint32_t msec) {
                                   [](const SkCodec::FrameInfo& info, uint32_t msec) {
                                       return (uint32_t)info.fDuration < msec;
                                   });
-    int prevIndex = fCurrIndex;
-    fCurrIndex = lower - fFrameInfos.begin();
-    return fCurrIndex != prevIndex;
+    int prevIndex = fCurrIndex.load();
+    fCurrIndex.store(lower - fFrameInfos.begin());
+    if (fCurrIndex.load() == prevIndex) {
+        return false;
+    }
+    this->prefetch();
+    return true;
 }
 
 
@@ -7,6 +7,7 @@
 
 #include "SkDashPathPriv.h"
 #include "SkPathMeasure.h"
+#include "SkPathMeasureCache.h"
 #include "SkPointPriv.h"
 #include "SkStrokeRec.h"
 
@@ -315,7 +316,9 @@ bool SkDashPath::InternalFilter(SkPath* dst, const SkPath& src, SkStrokeRec* rec
         // if rect is closed, starts in a dash, and ends in a dash, add the initial join
         // potentially a better fix is described here: bug.skia.org/7445
         if (src.isRect(nullptr) && src.isLastContourClosed() && is_even(initialDashIndex)) {
-            SkScalar pathLength = SkPathMeasure(src, false, rec->getResScale()).getLength();
+            SkPathMeasure srcMeas;
+            SkPathMeasureCache::SetPath(&srcMeas, src, false, rec->getResScale());
+            SkScalar pathLength = srcMeas.getLength();
             SkScalar endPhase = SkScalarMod(pathLength + initialDashLength, intervalLength);
             int index = 0;
             while (endPhase > intervals[index]) {
@@ -357,6 +360,8 @@ bool SkDashPath::InternalFilter(SkPath* dst, const SkPath& src, SkStrokeRec* rec
                 cullPathStorage.lineTo(midPoint - v);
             }
         }
+        // The culled path is new on every draw, so there's no use caching its measurements.
+        cullPathStorage.setIsVolatile(true);
         srcPtr = &cullPathStorage;
     }
 
@@ -364,7 +369,8 @@ bool SkDashPath::InternalFilter(SkPath* dst, const SkPath& src, SkStrokeRec* rec
     bool specialLine = (StrokeRecApplication::kAllow == strokeRecApplication) &&
                        lineRec.init(*srcPtr, dst, rec, count >> 1, intervalLength);
 
-    SkPathMeasure   meas(*srcPtr, false, rec->getResScale());
+    SkPathMeasure   meas;
+    SkPathMeasureCache::SetPath(&meas, *srcPtr, false, rec->getResScale());
 
     do {
         bool        skipFirstSegment = meas.isClosed();
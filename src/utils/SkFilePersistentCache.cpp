@@ -0,0 +1,375 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkFilePersistentCache.h"
+
+#if SK_SUPPORT_GPU
+
+#include "SkOSFile.h"
+#include "SkOSPath.h"
+#include "SkTaskGroup.h"
+#include "SkTDArray.h"
+#include "SkTSort.h"
+
+#include <cinttypes>
+#include <cstdio>
+
+static constexpr char kEntrySuffix[] = ".skpc";
+static constexpr char kTempSuffix[] = ".tmp";
+
+namespace {
+
+// Each file is a Header, then the key, then the data.
+struct Header {
+    static constexpr uint32_t kMagic = SkSetFourByteTag('s', 'k', 'p', 'c');
+    static constexpr uint32_t kVersion = 1;
+
+    uint32_t fMagic;
+    uint32_t fVersion;
+    uint32_t fKeySize;
+    uint32_t fDataSize;
+    uint32_t fCRC;      // Of the key, then the data.
+};
+
+}  // namespace
+
+// The CRC-32 used by zip and PNG, continuing from 'crc'.
+static uint32_t crc32(uint32_t crc, const void* bytes, size_t size) {
+    static const uint32_t* kTable = [] {
+        static uint32_t table[256];
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; ++k) {
+                c = (c & 1) ? 0xEDB88320 ^ (c >> 1) : c >> 1;
+            }
+            table[i] = c;
+        }
+        return table;
+    }();
+    const uint8_t* p = static_cast<const uint8_t*>(bytes);
+    crc = ~crc;
+    for (size_t i = 0; i < size; ++i) {
+        crc = kTable[(crc ^ p[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+// Names the key's file. This must not change between runs, so it can't use SkOpts::hash_fn,
+// whose result depends on the CPU. It's 64-bit FNV-1a.
+static uint64_t name_for(const SkData& key) {
+    uint64_t hash = 0xCBF29CE484222325ull;
+    for (size_t i = 0; i < key.size(); ++i) {
+        hash = (hash ^ key.bytes()[i]) * 0x100000001B3ull;
+    }
+    return hash;
+}
+
+static bool parse_name(const SkString& filename, uint64_t* name) {
+    static constexpr size_t kHexDigits = 16;
+    if (filename.size() != kHexDigits + strlen(kEntrySuffix) ||
+        !filename.endsWith(kEntrySuffix)) {
+        return false;
+    }
+    *name = 0;
+    for (size_t i = 0; i < kHexDigits; ++i) {
+        char c = filename[i];
+        int digit = c >= '0' && c <= '9' ? c - '0' : c >= 'a' && c <= 'f' ? c - 'a' + 10 : -1;
+        if (digit < 0) {
+            return false;
+        }
+        *name = (*name << 4) | digit;
+    }
+    return true;
+}
+
+static size_t file_size(const SkData& key, const SkData& data) {
+    return sizeof(Header) + key.size() + data.size();
+}
+
+// Returns the entry's data if the file at path is whole, undamaged, and holds 'key'. Sets
+// *damaged if it is not whole or the CRC doesn't match.
+static sk_sp<SkData> read_entry(const char path[], const SkData& key, bool* damaged) {
+    *damaged = false;
+    FILE* file = sk_fopen(path, kRead_SkFILE_Flag);
+    if (!file) {
+        return nullptr;
+    }
+    size_t size = sk_fgetsize(file);
+    Header header;
+    sk_sp<SkData> contents;
+    if (size < sizeof(Header) || sizeof(Header) != sk_qread(file, &header, sizeof(Header), 0) ||
+        header.fMagic != Header::kMagic || header.fVersion != Header::kVersion ||
+        size != sizeof(Header) + (size_t)header.fKeySize + header.fDataSize) {
+        *damaged = true;
+    } else if (header.fKeySize == key.size()) {
+        contents = SkData::MakeUninitialized(size - sizeof(Header));
+        if (contents->size() != sk_qread(file, contents->writable_data(), contents->size(),
+                                         sizeof(Header))) {
+            contents.reset();
+        }
+    }
+    sk_fclose(file);
+    if (!contents) {
+        return nullptr;
+    }
+
+    if (header.fCRC != crc32(0, contents->data(), contents->size())) {
+        *damaged = true;
+        return nullptr;
+    }
+    if (memcmp(contents->data(), key.data(), key.size())) {
+        return nullptr;  // Another key with the same name.
+    }
+    return SkData::MakeSubset(contents.get(), key.size(), header.fDataSize);
+}
+
+// Writes the entry to path, or returns false after removing what it wrote.
+static bool write_entry(const char path[], const SkData& key, const SkData& data) {
+    FILE* file = sk_fopen(path, kWrite_SkFILE_Flag);
+    if (!file) {
+        return false;
+    }
+    Header header;
+    header.fMagic = Header::kMagic;
+    header.fVersion = Header::kVersion;
+    header.fKeySize = SkToU32(key.size());
+    header.fDataSize = SkToU32(data.size());
+    header.fCRC = crc32(crc32(0, key.data(), key.size()), data.data(), data.size());
+    bool ok = sk_fwrite(&header, sizeof(header), file) &&
+              sk_fwrite(key.data(), key.size(), file) &&
+              sk_fwrite(data.data(), data.size(), file);
+    if (ok) {
+        // The data must reach the disk before the rename, or a crash could leave a renamed but
+        // empty file.
+        sk_fflush(file);
+        sk_fsync(file);
+    }
+    sk_fclose(file);
+    if (!ok) {
+        remove(path);
+    }
+    return ok;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+struct SkFilePersistentCache::Entry {
+    SK_DECLARE_INTERNAL_LLIST_INTERFACE(Entry);
+
+    uint64_t      fName;
+    size_t        fFileSize;
+    // Identifies the latest store() of the entry, so that an older write doesn't replace it.
+    uint32_t      fWriteID = 0;
+    // Set from store() until the file is written.
+    sk_sp<SkData> fPendingKey;
+    sk_sp<SkData> fPendingData;
+};
+
+std::unique_ptr<SkFilePersistentCache> SkFilePersistentCache::Make(const char dir[],
+                                                                   const Options& options) {
+    if (!dir || !sk_mkdir(dir)) {
+        return nullptr;
+    }
+    std::unique_ptr<SkFilePersistentCache> cache(new SkFilePersistentCache(dir, options));
+    cache->scanDirectory();
+    return cache;
+}
+
+SkFilePersistentCache::SkFilePersistentCache(const char dir[], const Options& options)
+        : fDir(dir)
+        , fOptions(options)
+        , fWrites(options.fExecutor ? new SkTaskGroup(*options.fExecutor) : nullptr) {}
+
+SkFilePersistentCache::~SkFilePersistentCache() {
+    this->flush();
+    while (Entry* entry = fLRU.head()) {
+        fLRU.remove(entry);
+        delete entry;
+    }
+}
+
+SkString SkFilePersistentCache::pathFor(uint64_t name, const char suffix[]) const {
+    SkString filename = SkStringPrintf("%016" PRIx64 "%s", name, suffix);
+    return SkOSPath::Join(fDir.c_str(), filename.c_str());
+}
+
+void SkFilePersistentCache::scanDirectory() {
+    struct Found {
+        uint64_t fName;
+        size_t   fSize;
+        int64_t  fModified;
+    };
+    SkTDArray<Found> found;
+    SkString filename;
+    for (SkOSFile::Iter iter(fDir.c_str(), kEntrySuffix); iter.next(&filename);) {
+        Found f;
+        if (parse_name(filename, &f.fName) &&
+            sk_stat(SkOSPath::Join(fDir.c_str(), filename.c_str()).c_str(), &f.fSize,
+                    &f.fModified)) {
+            found.push_back(f);
+        }
+    }
+    // Temporary files are left by runs that ended in the middle of a write.
+    for (SkOSFile::Iter iter(fDir.c_str(), kTempSuffix); iter.next(&filename);) {
+        remove(SkOSPath::Join(fDir.c_str(), filename.c_str()).c_str());
+    }
+
+    if (found.count() > 1) {
+        SkTQSort(found.begin(), found.end() - 1, [](const Found& a, const Found& b) {
+            return a.fModified < b.fModified;
+        });
+    }
+    SkAutoMutexAcquire lock(fMutex);
+    for (const Found& f : found) {
+        Entry* entry = new Entry;
+        entry->fName = f.fName;
+        entry->fFileSize = f.fSize;
+        fEntries.set(f.fName, entry);
+        fLRU.addToHead(entry);
+        fTotalBytes += f.fSize;
+    }
+    // The limit may be lower than in earlier runs.
+    this->evictUntilFits();
+}
+
+sk_sp<SkData> SkFilePersistentCache::load(const SkData& key) {
+    const uint64_t name = name_for(key);
+    uint32_t writeID;
+    {
+        SkAutoMutexAcquire lock(fMutex);
+        Entry** found = fEntries.find(name);
+        if (!found) {
+            return nullptr;
+        }
+        Entry* entry = *found;
+        fLRU.remove(entry);
+        fLRU.addToHead(entry);
+        if (entry->fPendingData) {
+            return entry->fPendingKey->equals(&key) ? entry->fPendingData : nullptr;
+        }
+        writeID = entry->fWriteID;
+    }
+
+    // The file is read without the lock, so that loads don't wait on each other.
+    bool damaged;
+    SkString path = this->pathFor(name, kEntrySuffix);
+    sk_sp<SkData> data = read_entry(path.c_str(), key, &damaged);
+    if (damaged) {
+        SkAutoMutexAcquire lock(fMutex);
+        Entry** found = fEntries.find(name);
+        // Unless a store() has replaced the file since.
+        if (found && (*found)->fWriteID == writeID) {
+            this->removeEntry(*found);
+        }
+    }
+    return data;
+}
+
+void SkFilePersistentCache::store(const SkData& key, const SkData& data) {
+    const size_t size = file_size(key, data);
+    if (size > fOptions.fMaxBytes) {
+        return;
+    }
+    const uint64_t name = name_for(key);
+    auto keyCopy = SkData::MakeWithCopy(key.data(), key.size());
+    auto dataCopy = SkData::MakeWithCopy(data.data(), data.size());
+    uint32_t writeID;
+    {
+        SkAutoMutexAcquire lock(fMutex);
+        Entry* entry;
+        if (Entry** found = fEntries.find(name)) {
+            entry = *found;
+            fLRU.remove(entry);
+            fTotalBytes -= entry->fFileSize;
+        } else {
+            entry = new Entry;
+            entry->fName = name;
+            fEntries.set(name, entry);
+        }
+        fLRU.addToHead(entry);
+        entry->fFileSize = size;
+        entry->fWriteID = writeID = ++fNextWriteID;
+        entry->fPendingKey = keyCopy;
+        entry->fPendingData = dataCopy;
+        fTotalBytes += size;
+        this->evictUntilFits();
+    }
+
+    if (fWrites) {
+        fWrites->add([this, name, writeID, keyCopy, dataCopy] {
+            this->write(name, writeID, keyCopy, dataCopy);
+        });
+    } else {
+        this->write(name, writeID, std::move(keyCopy), std::move(dataCopy));
+    }
+}
+
+void SkFilePersistentCache::write(uint64_t name, uint32_t writeID, sk_sp<SkData> key,
+                                  sk_sp<SkData> data) {
+    // The write ID keeps concurrent writes of the same entry from sharing a temporary file.
+    SkString tempPath = this->pathFor(name, SkStringPrintf(".%u%s", writeID, kTempSuffix).c_str());
+    bool written = write_entry(tempPath.c_str(), *key, *data);
+
+    SkAutoMutexAcquire lock(fMutex);
+    Entry** found = fEntries.find(name);
+    if (!found || (*found)->fWriteID != writeID) {
+        // Evicted, or stored again since.
+        if (written) {
+            remove(tempPath.c_str());
+        }
+        return;
+    }
+    Entry* entry = *found;
+    entry->fPendingKey.reset();
+    entry->fPendingData.reset();
+    if (written) {
+        SkString path = this->pathFor(name, kEntrySuffix);
+#ifdef SK_BUILD_FOR_WIN
+        // rename() doesn't replace files there.
+        remove(path.c_str());
+#endif
+        if (0 == rename(tempPath.c_str(), path.c_str())) {
+            return;
+        }
+        remove(tempPath.c_str());
+    }
+    this->removeEntry(entry);
+}
+
+void SkFilePersistentCache::removeEntry(Entry* entry) {
+    // Any file is from an earlier store() if the entry is pending.
+    remove(this->pathFor(entry->fName, kEntrySuffix).c_str());
+    fLRU.remove(entry);
+    fEntries.remove(entry->fName);
+    fTotalBytes -= entry->fFileSize;
+    delete entry;
+}
+
+void SkFilePersistentCache::evictUntilFits() {
+    while (fTotalBytes > fOptions.fMaxBytes) {
+        // If the entry is pending, its write sees that it's gone.
+        this->removeEntry(fLRU.tail());
+    }
+}
+
+void SkFilePersistentCache::flush() {
+    if (fWrites) {
+        fWrites->wait();
+    }
+}
+
+int SkFilePersistentCache::count() const {
+    SkAutoMutexAcquire lock(fMutex);
+    return fEntries.count();
+}
+
+size_t SkFilePersistentCache::totalBytes() const {
+    SkAutoMutexAcquire lock(fMutex);
+    return fTotalBytes;
+}
+
+#endif
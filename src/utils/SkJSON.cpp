@@ -17,6 +17,16 @@
 #include <tuple>
 #include <vector>
 
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE2
+    #include <emmintrin.h>
+#elif defined(SK_ARM_HAS_NEON)
+    #include <arm_neon.h>
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__)
+    #include <intrin.h>
+#endif
+
 namespace skjson {
 
 // #define SK_JSON_REPORT_ERRORS
@@ -261,6 +271,52 @@ static inline const char* skip_ws(const char* p) {
     return p;
 }
 
+// Skips plain string chars, 16 at a time while that doesn't read past p_stop, and returns the
+// first string terminator (see is_eostring).
+static inline const char* skip_string_chars(const char* p, const char* p_stop) {
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE2
+    const __m128i quote    = _mm_set1_epi8('"'),
+                  bslash   = _mm_set1_epi8('\\'),
+                  rbrace   = _mm_set1_epi8('}'),
+                  rbracket = _mm_set1_epi8(']'),
+                  ctrl_max = _mm_set1_epi8(0x1f);
+    for (; p_stop - p >= 15; p += 16) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        const __m128i terminators =
+                _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, quote), _mm_cmpeq_epi8(v, bslash)),
+                             _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, rbrace),
+                                                       _mm_cmpeq_epi8(v, rbracket)),
+                                          _mm_cmpeq_epi8(_mm_min_epu8(v, ctrl_max), v)));
+        if (const auto mask = _mm_movemask_epi8(terminators)) {
+        #if defined(_MSC_VER) && !defined(__clang__)
+            unsigned long index;
+            _BitScanForward(&index, mask);
+            return p + index;
+        #else
+            return p + __builtin_ctz(mask);
+        #endif
+        }
+    }
+#elif defined(SK_ARM_HAS_NEON)
+    for (; p_stop - p >= 15; p += 16) {
+        const uint8x16_t v = vld1q_u8(reinterpret_cast<const uint8_t*>(p));
+        const uint8x16_t terminators = vceqq_u8(v, vdupq_n_u8('"'))
+                                     | vceqq_u8(v, vdupq_n_u8('\\'))
+                                     | vceqq_u8(v, vdupq_n_u8('}'))
+                                     | vceqq_u8(v, vdupq_n_u8(']'))
+                                     | vcleq_u8(v, vdupq_n_u8(0x1f));
+        const uint64x2_t t64 = vreinterpretq_u64_u8(terminators);
+        if (vgetq_lane_u64(t64, 0) | vgetq_lane_u64(t64, 1)) {
+            break;
+        }
+    }
+#endif
+
+    // The input always ends with a terminator (see DOMParser::parse), so this stops in time.
+    while (!is_eostring(*p)) ++p;
+    return p;
+}
+
 static inline float pow10(int32_t exp) {
     static constexpr float g_pow10_table[63] =
     {
@@ -688,7 +744,7 @@ private:
         do {
             // Consume string chars.
             // This is the fast path, and hopefully we only hit it once then quick-exit below.
-            for (p = p + 1; !is_eostring(*p); ++p);
+            p = skip_string_chars(p + 1, p_stop);
 
             if (*p == '"') {
                 // Valid string found.
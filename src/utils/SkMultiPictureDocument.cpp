@@ -7,6 +7,7 @@
 
 #include "SkMultiPictureDocument.h"
 
+#include "SkData.h"
 #include "SkMultiPictureDocumentPriv.h"
 #include "SkNWayCanvas.h"
 #include "SkPicture.h"
@@ -22,13 +23,22 @@
   File format:
       BEGINNING_OF_FILE:
         kMagic
-        uint32_t version_number (==2)
+        uint32_t version_number (==3)
         uint32_t page_count
         {
           float sizeX
           float sizeY
         } * page_count
-        skp file
+        skp file * page_count
+        {
+          uint64_t offset (from the beginning of the file)
+          uint64_t length
+        } * page_count
+        uint64_t index_offset (of the offsets and lengths above)
+      END_OF_FILE
+
+  Version 2 files have a single skp file after the page sizes, in which the pages are separated by
+  kEndPage annotations. They are still read, but not randomly accessed.
 */
 
 namespace {
@@ -37,15 +47,13 @@ static constexpr char kMagic[] = "Skia Multi-Picture Doc\n\n";
 
 static constexpr char kEndPage[] = "SkMultiPictureEndPage";
 
-const uint32_t kVersion = 2;
+const uint32_t kVersion = 3;
+const uint32_t kSinglePictureVersion = 2;
 
-static SkSize join(const SkTArray<SkSize>& sizes) {
-    SkSize joined = {0, 0};
-    for (SkSize s : sizes) {
-        joined = SkSize{SkTMax(joined.width(), s.width()), SkTMax(joined.height(), s.height())};
-    }
-    return joined;
-}
+struct PageIndexEntry {
+    uint64_t fOffset;
+    uint64_t fLength;
+};
 
 struct MultiPictureDocument final : public SkDocument {
     const SkSerialProcs fProcs;
@@ -76,14 +84,18 @@ struct MultiPictureDocument final : public SkDocument {
         for (SkSize s : fSizes) {
             wStream->write(&s, sizeof(s));
         }
-        SkSize bigsize = join(fSizes);
-        SkCanvas* c = fPictureRecorder.beginRecording(SkRect::MakeSize(bigsize));
+        // Each page is its own skp, so that readers can find and read any one of them alone.
+        SkTArray<PageIndexEntry> index(fPages.count());
         for (const sk_sp<SkPicture>& page : fPages) {
-            c->drawPicture(page);
-            c->drawAnnotation(SkRect::MakeEmpty(), kEndPage, nullptr);
+            const size_t offset = wStream->bytesWritten();
+            page->serialize(wStream, &fProcs);
+            index.push_back({offset, wStream->bytesWritten() - offset});
         }
-        sk_sp<SkPicture> p = fPictureRecorder.finishRecordingAsPicture();
-        p->serialize(wStream, &fProcs);
+        const uint64_t indexOffset = wStream->bytesWritten();
+        for (const PageIndexEntry& entry : index) {
+            wStream->write(&entry, sizeof(entry));
+        }
+        wStream->write(&indexOffset, sizeof(indexOffset));
         fPages.reset();
         fSizes.reset();
         return;
@@ -101,7 +113,7 @@ sk_sp<SkDocument> SkMakeMultiPictureDocument(SkWStream* wStream, const SkSerialP
 
 ////////////////////////////////////////////////////////////////////////////////
 
-int SkMultiPictureDocumentReadPageCount(SkStreamSeekable* stream) {
+static int read_page_count(SkStreamSeekable* stream, uint32_t* version) {
     if (!stream) {
         return 0;
     }
@@ -112,8 +124,7 @@ int SkMultiPictureDocumentReadPageCount(SkStreamSeekable* stream) {
         stream = nullptr;
         return 0;
     }
-    uint32_t versionNumber;
-    if (!stream->readU32(&versionNumber) || versionNumber != kVersion) {
+    if (!stream->readU32(version) || (*version != kVersion && *version != kSinglePictureVersion)) {
         return 0;
     }
     uint32_t pageCount;
@@ -124,13 +135,17 @@ int SkMultiPictureDocumentReadPageCount(SkStreamSeekable* stream) {
     return SkTo<int>(pageCount);
 }
 
-bool SkMultiPictureDocumentReadPageSizes(SkStreamSeekable* stream,
-                                         SkDocumentPage* dstArray,
-                                         int dstArrayCount) {
+int SkMultiPictureDocumentReadPageCount(SkStreamSeekable* stream) {
+    uint32_t version;
+    return read_page_count(stream, &version);
+}
+
+static bool read_page_sizes(SkStreamSeekable* stream, SkDocumentPage* dstArray, int dstArrayCount,
+                            uint32_t* version) {
     if (!dstArray || dstArrayCount < 1) {
         return false;
     }
-    int pageCount = SkMultiPictureDocumentReadPageCount(stream);
+    int pageCount = read_page_count(stream, version);
     if (pageCount < 1 || pageCount != dstArrayCount) {
         return false;
     }
@@ -144,6 +159,13 @@ bool SkMultiPictureDocumentReadPageSizes(SkStreamSeekable* stream,
     return true;
 }
 
+bool SkMultiPictureDocumentReadPageSizes(SkStreamSeekable* stream,
+                                         SkDocumentPage* dstArray,
+                                         int dstArrayCount) {
+    uint32_t version;
+    return read_page_sizes(stream, dstArray, dstArrayCount, &version);
+}
+
 namespace {
 struct PagerCanvas : public SkNWayCanvas {
     SkPictureRecorder fRecorder;
@@ -179,9 +201,21 @@ bool SkMultiPictureDocumentRead(SkStreamSeekable* stream,
                                 SkDocumentPage* dstArray,
                                 int dstArrayCount,
                                 const SkDeserialProcs* procs) {
-    if (!SkMultiPictureDocumentReadPageSizes(stream, dstArray, dstArrayCount)) {
+    uint32_t version;
+    if (!read_page_sizes(stream, dstArray, dstArrayCount, &version)) {
         return false;
     }
+    if (kVersion == version) {
+        // The pages follow one another, each in its own skp.
+        for (int i = 0; i < dstArrayCount; ++i) {
+            dstArray[i].fPicture = SkPicture::MakeFromStream(stream, procs);
+            if (!dstArray[i].fPicture) {
+                return false;
+            }
+        }
+        return true;
+    }
+
     SkSize joined = {0.0f, 0.0f};
     for (int i = 0; i < dstArrayCount; ++i) {
         joined = SkSize{SkTMax(joined.width(), dstArray[i].fSize.width()),
@@ -199,3 +233,82 @@ bool SkMultiPictureDocumentRead(SkStreamSeekable* stream,
     }
     return true;
 }
+
+////////////////////////////////////////////////////////////////////////////////
+
+std::unique_ptr<SkMultiPictureDocumentReader> SkMultiPictureDocumentReader::Make(
+        sk_sp<SkData> data, const SkDeserialProcs* procs) {
+    if (!data) {
+        return nullptr;
+    }
+    SkMemoryStream stream(data);
+    uint32_t version;
+    const int pageCount = read_page_count(&stream, &version);
+    if (pageCount < 1) {
+        return nullptr;
+    }
+    std::vector<SkDocumentPage> pages(pageCount);
+    std::unique_ptr<SkMultiPictureDocumentReader> reader(
+            new SkMultiPictureDocumentReader(data, procs));
+    reader->fPages.resize(pageCount);
+
+    if (kSinglePictureVersion == version) {
+        // There's no index to find the pages with, so they're all read now.
+        if (!SkMultiPictureDocumentRead(&stream, pages.data(), pageCount, procs)) {
+            return nullptr;
+        }
+        for (int i = 0; i < pageCount; ++i) {
+            reader->fPages[i].fSize = pages[i].fSize;
+            reader->fPages[i].fPicture = std::move(pages[i].fPicture);
+        }
+        return reader;
+    }
+
+    if (!read_page_sizes(&stream, pages.data(), pageCount, &version)) {
+        return nullptr;
+    }
+    const size_t pagesOffset = stream.getPosition(),
+                 indexSize = pageCount * sizeof(PageIndexEntry);
+    uint64_t indexOffset;
+    if (data->size() < pagesOffset + indexSize + sizeof(indexOffset)) {
+        return nullptr;
+    }
+    memcpy(&indexOffset, data->bytes() + data->size() - sizeof(indexOffset), sizeof(indexOffset));
+    if (indexOffset != data->size() - sizeof(indexOffset) - indexSize) {
+        return nullptr;
+    }
+    const PageIndexEntry* index = (const PageIndexEntry*)(data->bytes() + indexOffset);
+    for (int i = 0; i < pageCount; ++i) {
+        PageIndexEntry entry;
+        memcpy(&entry, index + i, sizeof(entry));
+        if (entry.fOffset < pagesOffset || entry.fOffset > indexOffset ||
+            entry.fLength > indexOffset - entry.fOffset) {
+            return nullptr;
+        }
+        reader->fPages[i].fSize = pages[i].fSize;
+        reader->fPages[i].fOffset = SkTo<size_t>(entry.fOffset);
+        reader->fPages[i].fLength = SkTo<size_t>(entry.fLength);
+    }
+    return reader;
+}
+
+SkMultiPictureDocumentReader::SkMultiPictureDocumentReader(sk_sp<SkData> data,
+                                                           const SkDeserialProcs* procs)
+    : fData(std::move(data))
+    , fProcs(procs ? *procs : SkDeserialProcs()) {}
+
+SkMultiPictureDocumentReader::~SkMultiPictureDocumentReader() {}
+
+SkSize SkMultiPictureDocumentReader::pageSize(int index) const {
+    SkASSERT(0 <= index && index < this->pageCount());
+    return fPages[index].fSize;
+}
+
+sk_sp<SkPicture> SkMultiPictureDocumentReader::readPage(int index) const {
+    SkASSERT(0 <= index && index < this->pageCount());
+    const Page& page = fPages[index];
+    if (page.fPicture) {
+        return page.fPicture;
+    }
+    return SkPicture::MakeFromData(fData->bytes() + page.fOffset, page.fLength, &fProcs);
+}
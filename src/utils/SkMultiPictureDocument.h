@@ -10,10 +10,13 @@
 
 #include "SkDocument.h"
 #include "SkPicture.h"
+#include "SkSerialProcs.h"
 #include "SkSize.h"
 
-struct SkDeserialProcs;
-struct SkSerialProcs;
+#include <memory>
+#include <vector>
+
+class SkData;
 class SkStreamSeekable;
 
 /**
@@ -41,4 +44,43 @@ SK_API bool SkMultiPictureDocumentRead(SkStreamSeekable* src,
                                        int dstArrayCount,
                                        const SkDeserialProcs* = nullptr);
 
+/**
+ *  Reads the pages of an SkMultiPictureDocument one at a time, as they are asked for, from its
+ *  data (e.g. a file mapped by SkData::MakeFromFileName()). Only the page sizes and the index of
+ *  the pages are read up front. readPage() may be called from several threads at once, if the
+ *  deserial procs allow it, so that pages can be rendered in parallel.
+ *
+ *  Documents written before the pages were indexed are read all at once by Make().
+ */
+class SK_API SkMultiPictureDocumentReader {
+public:
+    /**
+     *  Returns null if the data is not a valid SkMultiPictureDocument. The procs are kept for
+     *  readPage().
+     */
+    static std::unique_ptr<SkMultiPictureDocumentReader> Make(sk_sp<SkData>,
+                                                              const SkDeserialProcs* = nullptr);
+    ~SkMultiPictureDocumentReader();
+
+    int pageCount() const { return (int)fPages.size(); }
+    SkSize pageSize(int index) const;
+
+    /** Deserializes the page's picture. Returns null if it is malformed. */
+    sk_sp<SkPicture> readPage(int index) const;
+
+private:
+    SkMultiPictureDocumentReader(sk_sp<SkData>, const SkDeserialProcs*);
+
+    struct Page {
+        SkSize           fSize;
+        size_t           fOffset = 0;
+        size_t           fLength = 0;
+        sk_sp<SkPicture> fPicture;  // only for documents without an index
+    };
+
+    sk_sp<SkData>     fData;
+    SkDeserialProcs   fProcs;
+    std::vector<Page> fPages;
+};
+
 #endif  // SkMultiPictureDocument_DEFINED
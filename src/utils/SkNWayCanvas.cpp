@@ -5,6 +5,9 @@
  * found in the LICENSE file.
  */
 #include "SkNWayCanvas.h"
+#include "SkLiteDL.h"
+#include "SkLiteRecorder.h"
+#include "SkTaskGroup.h"
 
 SkNWayCanvas::SkNWayCanvas(int width, int height) : INHERITED(width, height) {}
 
@@ -14,19 +17,57 @@ SkNWayCanvas::~SkNWayCanvas() {
 
 void SkNWayCanvas::addCanvas(SkCanvas* canvas) {
     if (canvas) {
-        *fList.append() = canvas;
+        *this->targets().append() = canvas;
     }
 }
 
 void SkNWayCanvas::removeCanvas(SkCanvas* canvas) {
-    int index = fList.find(canvas);
+    SkTDArray<SkCanvas*>& targets = this->targets();
+    int index = targets.find(canvas);
     if (index >= 0) {
-        fList.removeShuffle(index);
+        // Keep the order, since the first canvas is played back on the calling thread.
+        targets.remove(index);
     }
 }
 
 void SkNWayCanvas::removeAll() {
-    fList.reset();
+    this->targets().reset();
+}
+
+void SkNWayCanvas::setExecutor(SkExecutor* executor) {
+    if (fRecorder && !executor) {
+        this->playbackFrame();
+        fList.swap(fTargets);
+        fTargets.reset();
+        fRecorder.reset();
+        fFrame.reset();
+    } else if (!fRecorder && executor) {
+        fFrame.reset(new SkLiteDL);
+        fRecorder.reset(new SkLiteRecorder);
+        fRecorder->reset(fFrame.get(), SkIRect::MakeSize(this->getBaseLayerSize()));
+        fTargets.swap(fList);
+        *fList.append() = fRecorder.get();
+    }
+    fExecutor = executor;
+}
+
+void SkNWayCanvas::playbackFrame() {
+    SkTaskGroup group(*fExecutor);
+    for (int i = 1; i < fTargets.count(); i++) {
+        SkCanvas* canvas = fTargets[i];
+        group.add([this, canvas] {
+            fFrame->draw(canvas);
+            canvas->flush();
+        });
+    }
+    if (!fTargets.isEmpty()) {
+        fFrame->draw(fTargets[0]);
+        fTargets[0]->flush();
+    }
+    group.wait();
+
+    fFrame->reset();
+    fRecorder->reset(fFrame.get(), SkIRect::MakeSize(this->getBaseLayerSize()));
 }
 
 ///////////////////////////////////////////////////////////////////////////
@@ -258,10 +299,11 @@ void SkNWayCanvas::onDrawImageLattice(const SkImage* image, const Lattice& latti
 }
 
 void SkNWayCanvas::onDrawImageSet(const SkCanvas::ImageSetEntry set[], int count,
-                                  SkFilterQuality filterQuality, SkBlendMode mode) {
+                                  const SkMatrix preViewMatrices[], SkFilterQuality filterQuality,
+                                  SkBlendMode mode) {
     Iter iter(fList);
     while (iter.next()) {
-        iter->experimental_DrawImageSetV1(set, count, filterQuality, mode);
+        iter->experimental_DrawImageSetV2(set, count, preViewMatrices, filterQuality, mode);
     }
 }
 
@@ -361,6 +403,10 @@ void SkNWayCanvas::onDrawAnnotation(const SkRect& rect, const char key[], SkData
 }
 
 void SkNWayCanvas::onFlush() {
+    if (fRecorder) {
+        this->playbackFrame();
+        return;
+    }
     Iter iter(fList);
     while (iter.next()) {
         iter->flush();
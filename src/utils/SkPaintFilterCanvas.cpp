@@ -174,13 +174,14 @@ void SkPaintFilterCanvas::onDrawImageLattice(const SkImage* image, const Lattice
 }
 
 void SkPaintFilterCanvas::onDrawImageSet(const SkCanvas::ImageSetEntry set[], int count,
+                                         const SkMatrix preViewMatrices[],
                                          SkFilterQuality filterQuality, SkBlendMode mode) {
     SkPaint paint;
     paint.setBlendMode(mode);
     AutoPaintFilter apf(this, kBitmap_Type, &paint);
     mode = paint.getBlendMode();
     if (apf.shouldDraw()) {
-        this->SkNWayCanvas::onDrawImageSet(set, count, filterQuality, mode);
+        this->SkNWayCanvas::onDrawImageSet(set, count, preViewMatrices, filterQuality, mode);
     }
 }
 
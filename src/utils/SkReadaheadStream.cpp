@@ -0,0 +1,104 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkReadaheadStream.h"
+
+#include "SkExecutor.h"
+#include "SkTaskGroup.h"
+#include "SkTemplates.h"
+
+// How much each task reads from the source.
+static constexpr size_t kChunkSize = 16 * 1024;
+
+std::unique_ptr<SkReadaheadStream> SkReadaheadStream::Make(std::unique_ptr<SkStream> source,
+                                                           SkExecutor* executor,
+                                                           std::function<void()> onData) {
+    if (!source) {
+        return nullptr;
+    }
+    std::unique_ptr<SkReadaheadStream> stream(
+            new SkReadaheadStream(std::move(source), executor, std::move(onData)));
+    SkReadaheadStream* self = stream.get();
+    stream->fReads->add([self] { self->readChunk(); });
+    return stream;
+}
+
+SkReadaheadStream::SkReadaheadStream(std::unique_ptr<SkStream> source, SkExecutor* executor,
+                                     std::function<void()> onData)
+        : fSource(std::move(source))
+        , fOnData(std::move(onData))
+        , fReads(new SkTaskGroup(executor ? *executor : SkExecutor::GetDefault())) {}
+
+SkReadaheadStream::~SkReadaheadStream() {
+    fStopping.store(true, std::memory_order_relaxed);
+    fReads->wait();
+}
+
+// Each task reads one chunk and then queues the next, so that a long (or slow) source doesn't
+// keep one of the executor's threads to itself.
+void SkReadaheadStream::readChunk() {
+    if (fStopping.load(std::memory_order_relaxed)) {
+        return;
+    }
+    SkAutoTMalloc<uint8_t> chunk(kChunkSize);
+    size_t bytes = fSource->read(chunk.get(), kChunkSize);
+    bool done = 0 == bytes || fSource->isAtEnd();
+    {
+        SkAutoMutexAcquire lock(fMutex);
+        fData.append(SkToInt(bytes), chunk.get());
+        fSourceIsDone = done;
+    }
+    if (fOnData && (bytes > 0 || done)) {
+        fOnData();
+    }
+    if (!done) {
+        fReads->add([this] { this->readChunk(); });
+    }
+}
+
+size_t SkReadaheadStream::read(void* buffer, size_t size) {
+    SkAutoMutexAcquire lock(fMutex);
+    size = SkTMin(size, fData.bytes() - fPosition);
+    if (buffer) {
+        memcpy(buffer, fData.begin() + fPosition, size);
+    }
+    fPosition += size;
+    return size;
+}
+
+size_t SkReadaheadStream::peek(void* buffer, size_t size) const {
+    SkAutoMutexAcquire lock(fMutex);
+    size = SkTMin(size, fData.bytes() - fPosition);
+    memcpy(buffer, fData.begin() + fPosition, size);
+    return size;
+}
+
+bool SkReadaheadStream::isAtEnd() const {
+    SkAutoMutexAcquire lock(fMutex);
+    return fSourceIsDone && fPosition == fData.bytes();
+}
+
+bool SkReadaheadStream::rewind() {
+    SkAutoMutexAcquire lock(fMutex);
+    fPosition = 0;
+    return true;
+}
+
+size_t SkReadaheadStream::getPosition() const {
+    SkAutoMutexAcquire lock(fMutex);
+    return fPosition;
+}
+
+size_t SkReadaheadStream::bytesAvailable() const {
+    SkAutoMutexAcquire lock(fMutex);
+    return fData.bytes();
+}
+
+bool SkReadaheadStream::sourceIsDone() const {
+    SkAutoMutexAcquire lock(fMutex);
+    return fSourceIsDone;
+}
@@ -0,0 +1,234 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkRingBufferTracer.h"
+
+#include "SkChecksum.h"
+#include "SkJSONWriter.h"
+#include "SkMathPriv.h"
+#include "SkStream.h"
+#include "SkTDArray.h"
+#include "SkTime.h"
+#include "SkTraceEventPhase.h"
+
+// Each event is a name pointer and one 64-bit word holding its timestamp, category, and phase:
+//     [ nanoseconds since fStartNanos : 48 | category index : 8 | phase : 8 ]
+// 48 bits of nanoseconds wrap every few days, which is far longer than any buffer will last.
+static constexpr int      kTimestampShift = 16;
+static constexpr uint64_t kTimestampMask  = (uint64_t(1) << 48) - 1;
+
+struct SkRingBufferTracer::Ring {
+    struct Event {
+        std::atomic<const char*> fName;
+        std::atomic<uint64_t>    fBits;
+    };
+
+    explicit Ring(int capacity) : fMask(capacity - 1), fEvents(new Event[capacity]) {}
+
+    // Only the thread owning this ring calls push().  dumpJSON() may read it at any time, so we
+    // work like a seqlock: fClaimed moves before an event's slot is overwritten, and fCommitted
+    // after.  A reader copies events below fCommitted, then keeps only those fClaimed shows were
+    // not being overwritten while it copied.
+    void push(const char* name, uint64_t bits) {
+        uint64_t i = fCommitted.load(std::memory_order_relaxed);
+        fClaimed.store(i + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        Event& event = fEvents[i & fMask];
+        event.fName.store(name, std::memory_order_relaxed);
+        event.fBits.store(bits, std::memory_order_relaxed);
+
+        fCommitted.store(i + 1, std::memory_order_release);
+    }
+
+    const uint64_t            fMask;
+    std::unique_ptr<Event[]>  fEvents;
+    std::atomic<uint64_t>     fClaimed{0},
+                              fCommitted{0};
+};
+
+SkRingBufferTracer::SkRingBufferTracer(int eventsPerThread)
+    : fEventsPerThread(GrNextPow2(SkTMax(eventsPerThread, 2)))
+    , fStartNanos(SkTime::GetNSecs()) {
+    for (int i = 0; i < kMaxThreads; i++) {
+        fThreadIDs[i].store(kIllegalThreadID, std::memory_order_relaxed);
+        fRings[i].store(nullptr, std::memory_order_relaxed);
+    }
+}
+
+SkRingBufferTracer::~SkRingBufferTracer() {
+    for (int i = 0; i < kMaxThreads; i++) {
+        delete fRings[i].load(std::memory_order_relaxed);
+    }
+}
+
+SkRingBufferTracer::Ring* SkRingBufferTracer::ringForThisThread() {
+    // Threads claim slots in a small open-addressed table, keyed on their thread ID.
+    SkThreadID id = SkGetThreadID();
+    uint32_t start = SkChecksum::Mix((uint32_t)id ^ (uint32_t)((uint64_t)id >> 32));
+    for (int i = 0; i < kMaxThreads; i++) {
+        int slot = (start + i) % kMaxThreads;
+        SkThreadID owner = fThreadIDs[slot].load(std::memory_order_relaxed);
+        if (owner == kIllegalThreadID &&
+                fThreadIDs[slot].compare_exchange_strong(owner, id, std::memory_order_relaxed)) {
+            auto ring = new Ring(fEventsPerThread);
+            fRings[slot].store(ring, std::memory_order_release);
+            return ring;
+        }
+        if (owner == id) {
+            // Thread IDs may be reused once a thread exits.  That's fine, as the ring still only
+            // has one writer at a time.
+            return fRings[slot].load(std::memory_order_relaxed);
+        }
+    }
+    return nullptr;
+}
+
+void SkRingBufferTracer::record(char phase, const uint8_t* categoryEnabledFlag,
+                                const char* name) {
+    if (Ring* ring = this->ringForThisThread()) {
+        uint64_t nanos = (uint64_t)(SkTime::GetNSecs() - fStartNanos);
+        uint64_t category = categoryEnabledFlag - fCategoryFlags;
+        ring->push(name, (nanos & kTimestampMask) << kTimestampShift
+                       | category << 8
+                       | (uint8_t)phase);
+    }
+}
+
+SkEventTracer::Handle SkRingBufferTracer::addTraceEvent(char phase,
+                                                        const uint8_t* categoryEnabledFlag,
+                                                        const char* name,
+                                                        uint64_t id,
+                                                        int numArgs,
+                                                        const char** argNames,
+                                                        const uint8_t* argTypes,
+                                                        const uint64_t* argValues,
+                                                        uint8_t flags) {
+    switch (phase) {
+        // A complete event is recorded as a begin, and its duration later as a matching end.
+        case TRACE_EVENT_PHASE_COMPLETE:
+        case TRACE_EVENT_PHASE_BEGIN:         this->record(TRACE_EVENT_PHASE_BEGIN,
+                                                           categoryEnabledFlag, name); break;
+        case TRACE_EVENT_PHASE_END:           this->record(TRACE_EVENT_PHASE_END,
+                                                           categoryEnabledFlag, name); break;
+        case TRACE_EVENT_PHASE_INSTANT:       this->record(TRACE_EVENT_PHASE_INSTANT,
+                                                           categoryEnabledFlag, name); break;
+        // Everything else needs arguments or IDs to make any sense, which we don't record.
+        default: break;
+    }
+    return 0;
+}
+
+void SkRingBufferTracer::updateTraceEventDuration(const uint8_t* categoryEnabledFlag,
+                                                  const char* name,
+                                                  SkEventTracer::Handle) {
+    this->record(TRACE_EVENT_PHASE_END, categoryEnabledFlag, name);
+}
+
+const uint8_t* SkRingBufferTracer::getCategoryGroupEnabled(const char* name) {
+    // The tracing macros cache the result per call site, so this is rarely called.
+    SkAutoMutexAcquire lock(fCategoryMutex);
+    int count = fCategoryCount.load(std::memory_order_relaxed);
+    for (int i = 0; i < count; i++) {
+        if (0 == strcmp(fCategoryNames[i], name)) {
+            return &fCategoryFlags[i];
+        }
+    }
+    if (count == kMaxCategories) {
+        static const uint8_t kDisabled = 0;
+        return &kDisabled;
+    }
+    fCategoryNames[count] = name;
+    fCategoryFlags[count] = kEnabledForRecording_CategoryGroupEnabledFlags;
+    fCategoryCount.store(count + 1, std::memory_order_release);
+    return &fCategoryFlags[count];
+}
+
+const char* SkRingBufferTracer::getCategoryGroupName(const uint8_t* categoryEnabledFlag) {
+    if (categoryEnabledFlag >= fCategoryFlags &&
+        categoryEnabledFlag <  fCategoryFlags + fCategoryCount.load(std::memory_order_acquire)) {
+        return fCategoryNames[categoryEnabledFlag - fCategoryFlags];
+    }
+    return "unknown";
+}
+
+void SkRingBufferTracer::dumpJSON(SkWStream* stream, double seconds) const {
+    // Timestamps wrap, so we recover them relative to now.
+    uint64_t now = (uint64_t)(SkTime::GetNSecs() - fStartNanos);
+    uint64_t oldest = seconds > 0 ? now - SkTMin(now, (uint64_t)(seconds * 1e9)) : 0;
+    auto full_timestamp = [now](uint64_t bits) {
+        return now - (((now & kTimestampMask) - (bits >> kTimestampShift)) & kTimestampMask);
+    };
+    int categoryCount = fCategoryCount.load(std::memory_order_acquire);
+
+    SkJSONWriter writer(stream, SkJSONWriter::Mode::kFast);
+    writer.beginArray();
+
+    SkTDArray<const char*> names;
+    SkTDArray<uint64_t>    bits;
+    SkTDArray<bool>        written;  // For each open begin event, did we write it?
+    for (int slot = 0; slot < kMaxThreads; slot++) {
+        const Ring* ring = fRings[slot].load(std::memory_order_acquire);
+        if (!ring) {
+            continue;
+        }
+
+        uint64_t capacity = ring->fMask + 1,
+                 end      = ring->fCommitted.load(std::memory_order_acquire),
+                 copied   = end - SkTMin(end, capacity);
+        names.setCount(SkToInt(end - copied));
+        bits .setCount(SkToInt(end - copied));
+        for (uint64_t i = copied; i < end; i++) {
+            const Ring::Event& event = ring->fEvents[i & ring->fMask];
+            names[SkToInt(i - copied)] = event.fName.load(std::memory_order_relaxed);
+            bits [SkToInt(i - copied)] = event.fBits.load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        uint64_t claimed = ring->fClaimed.load(std::memory_order_relaxed),
+                 begin   = SkTMax(copied, claimed - SkTMin(claimed, capacity));
+
+        written.rewind();
+        for (uint64_t i = begin; i < end; i++) {
+            uint64_t b        = bits[SkToInt(i - copied)];
+            char     phase    = (char)(b & 0xff);
+            int      category = (int)((b >> 8) & 0xff);
+            uint64_t ts       = full_timestamp(b);
+
+            // Write ends only if we wrote their begins, which may have been overwritten already.
+            bool write = ts >= oldest;
+            if (phase == TRACE_EVENT_PHASE_BEGIN) {
+                written.push_back(write);
+            } else if (phase == TRACE_EVENT_PHASE_END) {
+                if (written.isEmpty()) {
+                    continue;
+                }
+                written.pop(&write);
+            }
+            if (!write) {
+                continue;
+            }
+
+            writer.beginObject();
+            char phaseString[2] = { phase, 0 };
+            writer.appendString("ph", phaseString);
+            writer.appendString("name", names[SkToInt(i - copied)]);
+            writer.appendString("cat", category < categoryCount ? fCategoryNames[category]
+                                                                : "unknown");
+            // Chrome's tracing JSON is in microseconds.
+            writer.appendDoubleDigits("ts", ts * 1e-3, 3);
+            if (phase == TRACE_EVENT_PHASE_INSTANT) {
+                writer.appendString("s", "t");
+            }
+            writer.appendS32("tid", slot);
+            writer.appendS32("pid", 0);
+            writer.endObject();
+        }
+    }
+
+    writer.endArray();
+    writer.flush();
+}
@@ -28,13 +28,13 @@ public:
     SkBaseShadowTessellator(const SkPoint3& zPlaneParams, bool transparent);
     virtual ~SkBaseShadowTessellator() {}
 
-    sk_sp<SkVertices> releaseVertices() {
+    sk_sp<SkVertices> releaseVertices(bool isVolatile) {
         if (!fSucceeded) {
             return nullptr;
         }
         return SkVertices::MakeCopy(SkVertices::kTriangles_VertexMode, this->vertexCount(),
                                     fPositions.begin(), nullptr, fColors.begin(),
-                                    this->indexCount(), fIndices.begin());
+                                    this->indexCount(), fIndices.begin(), isVolatile);
     }
 
 protected:
@@ -1143,22 +1143,24 @@ void SkSpotShadowTessellator::addToClip(const SkPoint& point) {
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
 sk_sp<SkVertices> SkShadowTessellator::MakeAmbient(const SkPath& path, const SkMatrix& ctm,
-                                                   const SkPoint3& zPlane, bool transparent) {
+                                                   const SkPoint3& zPlane, bool transparent,
+                                                   bool isVolatile) {
     if (!ctm.mapRect(path.getBounds()).isFinite() || !zPlane.isFinite()) {
         return nullptr;
     }
     SkAmbientShadowTessellator ambientTess(path, ctm, zPlane, transparent);
-    return ambientTess.releaseVertices();
+    return ambientTess.releaseVertices(isVolatile);
 }
 
 sk_sp<SkVertices> SkShadowTessellator::MakeSpot(const SkPath& path, const SkMatrix& ctm,
                                                 const SkPoint3& zPlane, const SkPoint3& lightPos,
-                                                SkScalar lightRadius,  bool transparent) {
+                                                SkScalar lightRadius, bool transparent,
+                                                bool isVolatile) {
     if (!ctm.mapRect(path.getBounds()).isFinite() || !zPlane.isFinite() ||
         !lightPos.isFinite() || !(lightPos.fZ >= SK_ScalarNearlyZero) ||
         !SkScalarIsFinite(lightRadius) || !(lightRadius >= SK_ScalarNearlyZero)) {
         return nullptr;
     }
     SkSpotShadowTessellator spotTess(path, ctm, zPlane, lightPos, lightRadius, transparent);
-    return spotTess.releaseVertices();
+    return spotTess.releaseVertices(isVolatile);
 }
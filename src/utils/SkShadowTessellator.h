@@ -24,10 +24,11 @@ typedef std::function<SkScalar(SkScalar, SkScalar)> HeightFunc;
 /**
  * This function generates an ambient shadow mesh for a path by walking the path, outsetting by
  * the radius, and setting inner and outer colors to umbraColor and penumbraColor, respectively.
- * If transparent is true, then the center of the ambient shadow will be filled in.
+ * If transparent is true, then the center of the ambient shadow will be filled in. Meshes that
+ * will be drawn again should not be volatile, so the GPU backend can keep them in a buffer.
  */
 sk_sp<SkVertices> MakeAmbient(const SkPath& path, const SkMatrix& ctm,
-                              const SkPoint3& zPlane, bool transparent);
+                              const SkPoint3& zPlane, bool transparent, bool isVolatile = true);
 
 /**
  * This function generates a spot shadow mesh for a path by walking the transformed path,
@@ -35,7 +36,8 @@ sk_sp<SkVertices> MakeAmbient(const SkPath& path, const SkMatrix& ctm,
  * The center will be clipped against the original path unless transparent is true.
  */
 sk_sp<SkVertices> MakeSpot(const SkPath& path, const SkMatrix& ctm, const SkPoint3& zPlane,
-                           const SkPoint3& lightPos, SkScalar lightRadius, bool transparent);
+                           const SkPoint3& lightPos, SkScalar lightRadius, bool transparent,
+                           bool isVolatile = true);
 
 
 }
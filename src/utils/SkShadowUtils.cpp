@@ -14,6 +14,7 @@
 #include "SkDrawShadowInfo.h"
 #include "SkMaskFilter.h"
 #include "SkPath.h"
+#include "SkPointPriv.h"
 #include "SkRandom.h"
 #include "SkRasterPipeline.h"
 #include "SkResourceCache.h"
@@ -27,6 +28,12 @@
 #include "effects/GrBlurredEdgeFragmentProcessor.h"
 #endif
 
+// How far, in device pixels, the light's offset of a spot shadow may move before a cached mesh
+// whose umbra is cut out by the occluder stops being reused.
+#ifndef SK_SHADOW_UMBRA_CUTOUT_TOLERANCE
+    #define SK_SHADOW_UMBRA_CUTOUT_TOLERANCE 0.25f
+#endif
+
 /**
 *  Gaussian color filter -- produces a Gaussian ramp based on the color's B value,
 *                           then blends with the color's G value.
@@ -102,7 +109,7 @@ struct AmbientVerticesFactory {
             noTrans[SkMatrix::kMTransY] = 0;
         }
         *translate = fOffset;
-        return SkShadowTessellator::MakeAmbient(path, noTrans, zParams, fTransparent);
+        return SkShadowTessellator::MakeAmbient(path, noTrans, zParams, fTransparent, false);
     }
 };
 
@@ -119,6 +126,7 @@ struct SpotVerticesFactory {
     };
 
     SkVector fOffset;
+    SkVector fSpotOffset;  // fOffset without the ctm's translation.
     SkPoint  fLocalCenter;
     SkScalar fOccluderHeight = SK_ScalarNaN; // NaN so that isCompatible will fail until init'ed.
     SkPoint3 fDevLightPos;
@@ -137,14 +145,18 @@ struct SpotVerticesFactory {
                 // umbra removed.
                 *translate = that.fOffset;
                 return true;
-            case OccluderType::kOpaquePartialUmbra:
+            case OccluderType::kOpaquePartialUmbra: {
                 // In this case we partially remove the umbra differently for 'this' and 'that'
-                // if the offsets don't match.
-                if (fOffset == that.fOffset) {
-                    translate->set(0, 0);
+                // if the light isn't in the same place relative to the occluder. The mesh was
+                // made at 'this' ctm's translation, so we move it by the difference, which also
+                // moves its cutout to within the tolerance of where it belongs.
+                SkScalar tol = SK_SHADOW_UMBRA_CUTOUT_TOLERANCE;
+                if (SkPointPriv::DistanceToSqd(fSpotOffset, that.fSpotOffset) <= tol * tol) {
+                    *translate = (that.fOffset - that.fSpotOffset) - (fOffset - fSpotOffset);
                     return true;
                 }
                 return false;
+            }
         }
         SK_ABORT("Uninitialized occluder type?");
         return false;
@@ -157,7 +169,7 @@ struct SpotVerticesFactory {
         if (ctm.hasPerspective() || OccluderType::kOpaquePartialUmbra == fOccluderType) {
             translate->set(0, 0);
             return SkShadowTessellator::MakeSpot(path, ctm, zParams,
-                                                 fDevLightPos, fLightRadius, transparent);
+                                                 fDevLightPos, fLightRadius, transparent, false);
         } else {
             // pick a canonical place to generate shadow, with light centered over path
             SkMatrix noTrans(ctm);
@@ -168,7 +180,7 @@ struct SpotVerticesFactory {
             SkPoint3 centerLightPos = SkPoint3::Make(devCenter.fX, devCenter.fY, fDevLightPos.fZ);
             *translate = fOffset;
             return SkShadowTessellator::MakeSpot(path, noTrans, zParams,
-                                                 centerLightPos, fLightRadius, transparent);
+                                                 centerLightPos, fLightRadius, transparent, false);
         }
     }
 };
@@ -693,6 +705,7 @@ void SkBaseDevice::drawShadow(const SkPath& path, const SkDrawShadowRec& rec) {
                 factory.fOccluderType = SpotVerticesFactory::OccluderType::kTransparent;
             }
             // need to add this after we classify the shadow
+            factory.fSpotOffset = factory.fOffset;
             factory.fOffset.fX += viewMatrix.getTranslateX();
             factory.fOffset.fY += viewMatrix.getTranslateY();
 
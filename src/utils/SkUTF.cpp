@@ -4,6 +4,7 @@
 #include "SkUTF.h"
 
 #include <climits>
+#include <cstring>
 
 static constexpr inline int32_t left_shift(int32_t value, int32_t shift) {
     return (int32_t) ((uint32_t) value << shift);
@@ -44,6 +45,22 @@ static bool utf8_byte_is_continuation(uint8_t c) { return utf8_byte_type(c) == 0
 
 ////////////////////////////////////////////////////////////////////////////////
 
+size_t SkUTF::CountASCII(const char* utf8, size_t byteLength) {
+    size_t count = 0;
+    // Any byte with its high bit set ends the run, so test eight of them with one mask.
+    for (; count + 8 <= byteLength; count += 8) {
+        uint64_t bytes;
+        memcpy(&bytes, utf8 + count, 8);
+        if (bytes & 0x8080808080808080ull) {
+            break;
+        }
+    }
+    while (count < byteLength && (uint8_t)utf8[count] < 0x80) {
+        ++count;
+    }
+    return count;
+}
+
 int SkUTF::CountUTF8(const char* utf8, size_t byteLength) {
     if (!utf8) {
         return -1;
@@ -51,6 +68,12 @@ int SkUTF::CountUTF8(const char* utf8, size_t byteLength) {
     int count = 0;
     const char* stop = utf8 + byteLength;
     while (utf8 < stop) {
+        size_t ascii = CountASCII(utf8, stop - utf8);
+        utf8 += ascii;
+        count += (int)ascii;
+        if (utf8 == stop) {
+            break;
+        }
         int type = utf8_byte_type(*(const uint8_t*)utf8);
         if (!utf8_type_is_valid_leading_byte(type) || utf8 + type > stop) {
             return -1;  // Sequence extends beyond end.
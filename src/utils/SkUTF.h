@@ -15,6 +15,11 @@ namespace SkUTF {
 */
 int CountUTF8(const char* utf8, size_t byteLength);
 
+/** Return how many of the first `byteLength` bytes of `utf8` are ASCII, i.e. each
+    is a codepoint of its own.  Eight bytes are checked at a time.
+*/
+size_t CountASCII(const char* utf8, size_t byteLength);
+
 /** Given a sequence of aligned UTF-16 characters in machine-endian form,
     return the number of unicode codepoints.  If the sequence is invalid
     UTF-16, return -1.
@@ -143,6 +143,44 @@ void SkXMLWriter::addAttributeLen(const char name[], const char value[], size_t
     this->onAddAttributeLen(name, value, length);
 }
 
+void SkXMLWriter::startAttribute(const char name[]) {
+    this->onStartAttribute(name);
+}
+
+void SkXMLWriter::appendAttributeValue(const char value[], size_t length) {
+    if (fDoEscapeMarkup) {
+        size_t extra = escape_markup(nullptr, value, length);
+        if (extra) {
+            SkString valueStr;
+            valueStr.resize(length + extra);
+            (void)escape_markup(valueStr.writable_str(), value, length);
+            this->onAppendAttributeValue(valueStr.c_str(), valueStr.size());
+            return;
+        }
+    }
+    this->onAppendAttributeValue(value, length);
+}
+
+void SkXMLWriter::endAttribute() {
+    this->onEndAttribute();
+}
+
+void SkXMLWriter::onStartAttribute(const char name[]) {
+    SkASSERT(fAttributeName.isEmpty() && fAttributeValue.isEmpty());
+    fAttributeName.set(name);
+}
+
+void SkXMLWriter::onAppendAttributeValue(const char value[], size_t length) {
+    fAttributeValue.append(value, length);
+}
+
+void SkXMLWriter::onEndAttribute() {
+    this->onAddAttributeLen(fAttributeName.c_str(), fAttributeValue.c_str(),
+                            fAttributeValue.size());
+    fAttributeName.reset();
+    fAttributeValue.reset();
+}
+
 void SkXMLWriter::startElementLen(const char elem[], size_t length) {
     this->onStartElementLen(elem, length);
 }
@@ -212,6 +250,21 @@ void SkXMLStreamWriter::onAddAttributeLen(const char name[], const char value[],
     fStream.writeText("\"");
 }
 
+void SkXMLStreamWriter::onStartAttribute(const char name[]) {
+    SkASSERT(!fElems.top()->fHasChildren && !fElems.top()->fHasText);
+    fStream.writeText(" ");
+    fStream.writeText(name);
+    fStream.writeText("=\"");
+}
+
+void SkXMLStreamWriter::onAppendAttributeValue(const char value[], size_t length) {
+    fStream.write(value, length);
+}
+
+void SkXMLStreamWriter::onEndAttribute() {
+    fStream.writeText("\"");
+}
+
 void SkXMLStreamWriter::onAddText(const char text[], size_t length) {
     Elem* elem = fElems.top();
 
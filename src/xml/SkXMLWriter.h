@@ -26,6 +26,11 @@ public:
     void    addHexAttribute(const char name[], uint32_t value, int minDigits = 0);
     void    addScalarAttribute(const char name[], SkScalar value);
     void    addText(const char text[], size_t length);
+    // An attribute may also be written in pieces: any number of appendAttributeValue() calls
+    // between startAttribute() and endAttribute().  Writers to a stream never hold all of it.
+    void    startAttribute(const char name[]);
+    void    appendAttributeValue(const char value[], size_t length);
+    void    endAttribute();
     void    endElement() { this->onEndElement(); }
     void    startElement(const char elem[]);
     void    startElementLen(const char elem[], size_t length);
@@ -38,6 +43,10 @@ protected:
     virtual void onAddAttributeLen(const char name[], const char value[], size_t length) = 0;
     virtual void onAddText(const char text[], size_t length) = 0;
     virtual void onEndElement() = 0;
+    // By default, the pieces of an attribute are gathered up and added with onAddAttributeLen().
+    virtual void onStartAttribute(const char name[]);
+    virtual void onAppendAttributeValue(const char value[], size_t length);
+    virtual void onEndAttribute();
 
     struct Elem {
         Elem(const char name[], size_t len)
@@ -57,6 +66,8 @@ protected:
 
 private:
     bool fDoEscapeMarkup;
+    SkString fAttributeName;
+    SkString fAttributeValue;
     // illegal
     SkXMLWriter& operator=(const SkXMLWriter&);
 };
@@ -72,6 +83,9 @@ protected:
     void onEndElement() override;
     void onAddAttributeLen(const char name[], const char value[], size_t length) override;
     void onAddText(const char text[], size_t length) override;
+    void onStartAttribute(const char name[]) override;
+    void onAppendAttributeValue(const char value[], size_t length) override;
+    void onEndAttribute() override;
 
 private:
     SkWStream&      fStream;
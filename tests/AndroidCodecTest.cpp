@@ -8,6 +8,7 @@
 #include "Resources.h"
 #include "SkAndroidCodec.h"
 #include "SkBitmap.h"
+#include "SkBitmapRegionDecoder.h"
 #include "SkCodec.h"
 #include "SkCodecImageGenerator.h"
 #include "SkColor.h"
@@ -268,3 +269,58 @@ DEF_TEST(AndroidCodec_orientation, r) {
         }
     }
 }
+
+DEF_TEST(AndroidCodec_tiledRegions, r) {
+    // Pan around each image in overlapping steps, some of them off the edge, and check that
+    // putting regions together from cached tiles gives the same pixels as decoding them.
+    const char* paths[] = { "images/mandrill_512.png", "images/plane_interlaced.png",
+                            "images/mandrill_512_q075.jpg" };
+    for (const char* path : paths) {
+        sk_sp<SkData> data = GetResourceAsData(path);
+        if (!data) {
+            continue;
+        }
+        std::unique_ptr<SkBitmapRegionDecoder> plain(SkBitmapRegionDecoder::Create(
+                data, SkBitmapRegionDecoder::kAndroidCodec_Strategy));
+        std::unique_ptr<SkBitmapRegionDecoder> tiled(SkBitmapRegionDecoder::Create(
+                data, SkBitmapRegionDecoder::kTiledAndroidCodec_Strategy));
+        if (!plain || !tiled) {
+            ERRORF(r, "Could not create region decoders for %s", path);
+            continue;
+        }
+
+        for (int sampleSize : { 1, 2, 3, 4 }) {
+            for (SkColorType colorType : { kN32_SkColorType, kRGB_565_SkColorType }) {
+                auto ct = plain->computeOutputColorType(colorType);
+                auto cs = plain->computeOutputColorSpace(ct);
+                const int step = 36 * sampleSize,
+                          size = 120 * sampleSize;
+                for (int pass = 0; pass < 2; pass++) {
+                    for (int y = -step; y < plain->height(); y += step) {
+                        for (int x = -step; x < plain->width(); x += step) {
+                            SkIRect region = SkIRect::MakeXYWH(x, y, size, size);
+                            SkBitmap expected, actual;
+                            bool ok = plain->decodeRegion(&expected, nullptr, region, sampleSize,
+                                                          ct, false, cs);
+                            REPORTER_ASSERT(r, ok == tiled->decodeRegion(&actual, nullptr, region,
+                                                                         sampleSize, ct, false,
+                                                                         cs));
+                            if (!ok) {
+                                continue;
+                            }
+                            REPORTER_ASSERT(r, expected.info() == actual.info());
+                            for (int row = 0; row < expected.height(); row++) {
+                                if (0 != memcmp(expected.getAddr(0, row), actual.getAddr(0, row),
+                                                expected.info().minRowBytes())) {
+                                    ERRORF(r, "%s: region (%d, %d) sampled by %d differs",
+                                           path, x, y, sampleSize);
+                                    break;
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
@@ -173,3 +173,39 @@ DEF_TEST(ArenaAlloc, r) {
     REPORTER_ASSERT(r, destroyed == 128);
 
 }
+
+DEF_TEST(ArenaAlloc_RecycleBlocks, r) {
+    static SkArenaAlloc::Site gSite{"ArenaAlloc_RecycleBlocks"};
+
+    // Each arena needs one heap block, the same one each time once it is recycled.
+    SkArenaAlloc::SetBlockRecyclingLimit(1 << 16);
+    char* firstBytes = nullptr;
+    for (int i = 0; i < 3; i++) {
+        SkSTArenaAlloc<64> arena;
+        arena.setSite(&gSite);
+        char* bytes = arena.makeArrayDefault<char>(1000);
+        if (i == 0) {
+            firstBytes = bytes;
+        } else {
+            REPORTER_ASSERT(r, bytes == firstBytes);
+        }
+    }
+    SkArenaAlloc::SetBlockRecyclingLimit(0);
+
+    // reset() records too, and keeps the site.
+    {
+        SkSTArenaAlloc<64> arena;
+        arena.setSite(&gSite);
+        arena.makeArrayDefault<char>(2000);
+        arena.reset();
+        arena.makeArrayDefault<char>(16);
+    }
+
+    REPORTER_ASSERT(r, gSite.highWaterMark() >= 2000);
+    REPORTER_ASSERT(r, gSite.heapCount() == 4);
+    bool listed = false;
+    for (auto site = SkArenaAlloc::Site::Head(); site; site = site->next()) {
+        listed |= site == &gSite;
+    }
+    REPORTER_ASSERT(r, listed);
+}
@@ -0,0 +1,123 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkColorData.h"
+#include "SkOpts.h"
+#include "SkRandom.h"
+#include "Test.h"
+
+// The SkOpts mask blitters have wide paths for whole groups of 8 or 16 pixels and narrower ones
+// for the rest of each row.  These check that every pixel gets the same result either way.
+
+static const SkColor kColors[] = {
+    SK_ColorBLACK, SK_ColorWHITE, 0xFF336699, 0x80336699, 0x01FFFFFF, 0x00000000,
+};
+
+// Sk4px::approxMulDiv255(), one byte at a time.
+static SkPMColor approx_mul_div255(SkPMColor x, SkPMColor y) {
+    SkPMColor result = 0;
+    for (int shift = 0; shift < 32; shift += 8) {
+        uint32_t a = (x >> shift) & 0xFF,
+                 b = (y >> shift) & 0xFF;
+        result |= ((a*b + a) >> 8) << shift;
+    }
+    return result;
+}
+
+static SkPMColor dup_alpha(unsigned a) {
+    return a * 0x01010101;
+}
+
+static SkPMColor expected_a8(SkColor color, SkPMColor d, SkAlpha aa) {
+    SkPMColor s = SkPreMultiplyColor(color);
+    SkPMColor left = approx_mul_div255(s, dup_alpha(aa));
+    if (SkColorGetA(color) == 0xFF) {
+        return left + approx_mul_div255(d, dup_alpha(255 - aa));
+    }
+    return left + approx_mul_div255(d, dup_alpha(255 - SkGetPackedA32(left)));
+}
+
+static SkPMColor expected_lcd16(SkColor color, SkPMColor d, uint16_t m) {
+    // Only opaque destinations are supported.
+    SkASSERT(SkGetPackedA32(d) == 0xFF);
+    if (m == 0) {
+        return d;
+    }
+    int scale = SkAlpha255To256(SkColorGetA(color));
+    auto blend = [&](int s, int d, int m5) {
+        m5 = (m5 + (m5 >> 4)) * scale >> 8;
+        return d + ((s - d) * m5 >> 5);
+    };
+    return SkPackARGB32(0xFF,
+                        blend(SkColorGetR(color), SkGetPackedR32(d),
+                              SkGetPackedR16(m) >> (SK_R16_BITS - 5)),
+                        blend(SkColorGetG(color), SkGetPackedG32(d),
+                              SkGetPackedG16(m) >> (SK_G16_BITS - 5)),
+                        blend(SkColorGetB(color), SkGetPackedB32(d),
+                              SkGetPackedB16(m) >> (SK_B16_BITS - 5)));
+}
+
+static SkPMColor random_pmcolor(SkRandom* random, bool opaque) {
+    U8CPU a = opaque ? 0xFF : random->nextULessThan(256);
+    return SkPackARGB32(a, random->nextULessThan(a + 1), random->nextULessThan(a + 1),
+                        random->nextULessThan(a + 1));
+}
+
+DEF_TEST(BlitMask_A8, r) {
+    SkRandom random;
+    constexpr int kMaxWidth = 40, kHeight = 3, kDstStride = kMaxWidth + 1;
+    SkPMColor src[kDstStride * kHeight], dst[kDstStride * kHeight];
+    SkAlpha mask[kDstStride * kHeight];
+
+    for (SkColor color : kColors) {
+        for (int w = 1; w <= kMaxWidth; w++) {
+            for (int i = 0; i < kDstStride * kHeight; i++) {
+                dst[i] = src[i] = random_pmcolor(&random, false);
+                // Lots of fully transparent and fully opaque coverage.
+                mask[i] = random.nextBool() ? random.nextULessThan(256)
+                                            : (random.nextBool() ? 0 : 255);
+            }
+            SkOpts::blit_mask_d32_a8(dst, kDstStride * sizeof(SkPMColor), mask, kDstStride,
+                                     color, w, kHeight);
+            for (int i = 0; i < kDstStride * kHeight; i++) {
+                SkPMColor expected = i % kDstStride < w ? expected_a8(color, src[i], mask[i])
+                                                        : src[i];
+                REPORTER_ASSERT(r, dst[i] == expected, "color %08x width %d pixel %d: %08x, %08x",
+                                color, w, i, dst[i], expected);
+            }
+        }
+    }
+}
+
+DEF_TEST(BlitMask_LCD16, r) {
+    SkRandom random;
+    constexpr int kMaxWidth = 40, kDstStride = kMaxWidth + 1;
+    SkPMColor src[kDstStride], dst[kDstStride];
+    uint16_t mask[kDstStride];
+
+    for (SkColor color : kColors) {
+        bool opaque = SkColorGetA(color) == 0xFF;
+        auto blit_row = opaque ? SkOpts::blit_row_lcd16_opaque : SkOpts::blit_row_lcd16;
+        for (int w = 1; w <= kMaxWidth; w++) {
+            // Start at each alignment, as the SSE2 blits align dst before their loops.
+            for (int x = 0; x + w <= kDstStride; x += 3) {
+                for (int i = 0; i < kDstStride; i++) {
+                    dst[i] = src[i] = random_pmcolor(&random, true);
+                    mask[i] = random.nextBool() ? random.nextU() : (random.nextBool() ? 0 : 0xFFFF);
+                }
+                blit_row(dst + x, mask + x, color, w, SkPreMultiplyColor(color));
+                for (int i = 0; i < kDstStride; i++) {
+                    SkPMColor expected = i >= x && i < x + w
+                                       ? expected_lcd16(color, src[i], mask[i]) : src[i];
+                    REPORTER_ASSERT(r, dst[i] == expected,
+                                    "color %08x width %d pixel %d: %08x, %08x",
+                                    color, w, i, dst[i], expected);
+                }
+            }
+        }
+    }
+}
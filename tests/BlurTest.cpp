@@ -742,3 +742,62 @@ DEF_TEST(zero_blur, reporter) {
     bitmap.extractAlpha(&alpha, &paint, nullptr, &offset);
 }
 
+
+// Sigmas of 64 and up are blurred at a reduced resolution. Check that a blurred rect stays as close
+// to the exact gaussian as the full resolution three-pass box blur gets (about 9/255).
+DEF_TEST(BlurLargeSigma, reporter) {
+    static constexpr int kW = 300, kH = 200;
+    SkMask src;
+    src.fBounds.set(0, 0, kW, kH);
+    src.fRowBytes = kW;
+    src.fFormat = SkMask::kA8_Format;
+    src.fImage = SkMask::AllocImage(src.computeImageSize());
+    SkAutoMaskFreeImage srcImage(src.fImage);
+    memset(src.fImage, 0xFF, src.computeImageSize());
+
+    for (SkScalar sigma : {64.f, 80.f, 136.f}) {
+        SkMask dst;
+        SkIPoint margin;
+        REPORTER_ASSERT(reporter,
+                        SkBlurMask::BoxBlur(&dst, src, sigma, kNormal_SkBlurStyle, &margin));
+        SkAutoMaskFreeImage dstImage(dst.fImage);
+
+        auto profile = [sigma](int x, int width) {
+            double c = x + 0.5;
+            return 0.5 * (erf(c / (sigma * sqrt(2.0))) - erf((c - width) / (sigma * sqrt(2.0))));
+        };
+        double maxError = 0;
+        for (int y = dst.fBounds.fTop; y < dst.fBounds.fBottom; ++y) {
+            for (int x = dst.fBounds.fLeft; x < dst.fBounds.fRight; ++x) {
+                double expected = 255 * profile(x, kW) * profile(y, kH);
+                maxError = SkTMax(maxError, fabs(*dst.getAddr8(x, y) - expected));
+            }
+        }
+        REPORTER_ASSERT(reporter, maxError < 10, "sigma %g, max error %g", sigma, maxError);
+    }
+}
+
+// Blurred rrects whose sigma and radii differ by a sliver of a pixel share one nine-patch mask,
+// so they draw identically.
+DEF_TEST(BlurRRectNinePatchQuantized, reporter) {
+    auto draw = [](SkScalar sigma, SkScalar radius) {
+        SkBitmap bitmap;
+        bitmap.allocN32Pixels(200, 200);
+        bitmap.eraseColor(SK_ColorTRANSPARENT);
+        SkCanvas canvas(bitmap);
+        SkPaint paint;
+        paint.setMaskFilter(SkMaskFilter::MakeBlur(kNormal_SkBlurStyle, sigma));
+        canvas.drawRRect(SkRRect::MakeRectXY(SkRect::MakeXYWH(20, 20, 160, 160), radius, radius),
+                         paint);
+        return bitmap;
+    };
+    auto equal = [](const SkBitmap& a, const SkBitmap& b) {
+        return !memcmp(a.getPixels(), b.getPixels(), a.computeByteSize());
+    };
+
+    SkBitmap reference = draw(6, 12);
+    REPORTER_ASSERT(reporter, equal(reference, draw(6.01f, 12.05f)));
+    REPORTER_ASSERT(reporter, equal(reference, draw(5.97f, 11.93f)));
+    REPORTER_ASSERT(reporter, !equal(reference, draw(7, 12)));
+    REPORTER_ASSERT(reporter, !equal(reference, draw(6, 16)));
+}
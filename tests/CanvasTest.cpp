@@ -52,6 +52,9 @@
 #include "SkClipOp.h"
 #include "SkClipOpPriv.h"
 #include "SkColor.h"
+#include "SkData.h"
+#include "SkExecutor.h"
+#include "SkImage.h"
 #include "SkImageFilter.h"
 #include "SkImageInfo.h"
 #include "SkMalloc.h"
@@ -61,9 +64,11 @@
 #include "SkPaint.h"
 #include "SkPaintFilterCanvas.h"
 #include "SkPath.h"
+#include "SkPicture.h"
 #include "SkPictureRecorder.h"
 #include "SkPixmap.h"
 #include "SkPoint.h"
+#include "SkRandom.h"
 #include "SkRect.h"
 #include "SkRefCnt.h"
 #include "SkRegion.h"
@@ -752,6 +757,65 @@ DEF_TEST(NWayCanvas, r) {
     REPORTER_ASSERT(r, life[1]);
 }
 
+// With an executor, NWayCanvas plays each frame back into all its canvases on flush().
+DEF_TEST(NWayCanvas_executor, r) {
+    const int w = 32;
+    const int h = 32;
+    auto draw_frame = [](SkCanvas* canvas, int frame) {
+        SkPaint paint;
+        paint.setAntiAlias(true);
+        paint.setColor(frame ? SK_ColorRED : SK_ColorBLUE);
+        canvas->save();
+        canvas->translate(4.5f, 3);
+        canvas->clipRect(SkRect::MakeWH(20, 20));
+        canvas->drawCircle(10, 10, 12, paint);
+        canvas->restore();
+        canvas->drawRect(SkRect::MakeXYWH(frame * 8, 24, 8, 8), paint);
+    };
+
+    sk_sp<SkSurface> expected = SkSurface::MakeRasterN32Premul(w, h);
+    sk_sp<SkSurface> surfaces[3];
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(2);
+    SkNWayCanvas nway(w, h);
+    for (auto& surface : surfaces) {
+        surface = SkSurface::MakeRasterN32Premul(w, h);
+        surface->getCanvas()->clear(SK_ColorTRANSPARENT);
+        nway.addCanvas(surface->getCanvas());
+    }
+    nway.setExecutor(executor.get());
+    expected->getCanvas()->clear(SK_ColorTRANSPARENT);
+
+    auto matches = [&](SkSurface* surface) {
+        SkBitmap a, b;
+        a.allocN32Pixels(w, h);
+        b.allocN32Pixels(w, h);
+        return expected->readPixels(a.pixmap(), 0, 0) && surface->readPixels(b.pixmap(), 0, 0) &&
+               0 == memcmp(a.getPixels(), b.getPixels(), a.computeByteSize());
+    };
+
+    for (int frame = 0; frame < 2; frame++) {
+        draw_frame(&nway, frame);
+        // Nothing reaches the canvases until the frame is flushed.
+        REPORTER_ASSERT(r, matches(surfaces[1].get()));
+
+        draw_frame(expected->getCanvas(), frame);
+        nway.flush();
+        for (auto& surface : surfaces) {
+            REPORTER_ASSERT(r, matches(surface.get()));
+        }
+    }
+
+    // Without an executor, calls are forwarded as they're made again.
+    draw_frame(&nway, 0);
+    nway.setExecutor(nullptr);
+    draw_frame(&nway, 1);
+    draw_frame(expected->getCanvas(), 0);
+    draw_frame(expected->getCanvas(), 1);
+    for (auto& surface : surfaces) {
+        REPORTER_ASSERT(r, matches(surface.get()));
+    }
+}
+
 // Check that CanvasStack DOES manage the lifetime of its sub-canvases
 DEF_TEST(CanvasStack, r) {
     const int w = 10;
@@ -919,3 +983,197 @@ DEF_TEST(Canvas_ClippedOutImageFilter, reporter) {
     REPORTER_ASSERT(reporter, preCTM == postCTM);
 }
 
+DEF_TEST(Canvas_DrawImageSetV2, reporter) {
+    SkBitmap src;
+    src.allocN32Pixels(16, 16);
+    src.eraseColor(SK_ColorRED);
+    src.erase(SK_ColorBLUE, SkIRect::MakeWH(8, 8));
+    sk_sp<SkImage> image = SkImage::MakeFromBitmap(src);
+
+    SkMatrix matrices[2];
+    matrices[0].setRotate(90, 8, 8);
+    matrices[1].setScale(-1, 1);
+    matrices[1].postTranslate(56, 8);
+    SkCanvas::ImageSetEntry set[4];
+    for (int i = 0; i < 4; ++i) {
+        set[i].fImage = image;
+        set[i].fSrcRect = SkRect::MakeWH(16, 16);
+        set[i].fDstRect = SkRect::MakeXYWH(20 * (i % 2), 20 * (i / 2), 16, 16);
+        set[i].fAlpha = 1.f;
+        set[i].fAAFlags = SkCanvas::kNone_QuadAAFlags;
+        set[i].fMatrixIndex = i - 1;  // the first entry only uses the canvas matrix
+    }
+    set[3].fMatrixIndex = 0;
+
+    auto draw = [&](SkCanvas* canvas) {
+        canvas->translate(4, 4);
+        canvas->experimental_DrawImageSetV2(set, 4, matrices, kNone_SkFilterQuality,
+                                            SkBlendMode::kSrcOver);
+    };
+    auto make_pixels = [](SkBitmap* bm) {
+        bm->allocN32Pixels(64, 64);
+        bm->eraseColor(SK_ColorTRANSPARENT);
+    };
+
+    SkBitmap expected;
+    make_pixels(&expected);
+    {
+        SkCanvas canvas(expected);
+        canvas.translate(4, 4);
+        for (const auto& entry : set) {
+            canvas.save();
+            if (entry.fMatrixIndex >= 0) {
+                canvas.concat(matrices[entry.fMatrixIndex]);
+            }
+            canvas.drawImageRect(image, entry.fSrcRect, entry.fDstRect, nullptr,
+                                 SkCanvas::kFast_SrcRectConstraint);
+            canvas.restore();
+        }
+    }
+
+    auto check = [&](const SkBitmap& actual, const char* desc) {
+        for (int y = 0; y < 64; ++y) {
+            if (memcmp(expected.getAddr32(0, y), actual.getAddr32(0, y), 64 * 4)) {
+                ERRORF(reporter, "%s doesn't match drawing each entry, row %d", desc, y);
+                return;
+            }
+        }
+    };
+
+    SkBitmap direct;
+    make_pixels(&direct);
+    {
+        SkCanvas canvas(direct);
+        draw(&canvas);
+    }
+    check(direct, "Direct draw");
+
+    SkPictureRecorder recorder;
+    draw(recorder.beginRecording(SkRect::MakeWH(64, 64)));
+    sk_sp<SkPicture> picture = recorder.finishRecordingAsPicture();
+
+    SkBitmap played;
+    make_pixels(&played);
+    {
+        SkCanvas canvas(played);
+        picture->playback(&canvas);
+    }
+    check(played, "Picture playback");
+
+    // The serialized picture has no per-entry matrices and stores them as concats.
+    sk_sp<SkPicture> copy = SkPicture::MakeFromData(picture->serialize().get());
+    REPORTER_ASSERT(reporter, copy);
+    SkBitmap deserialized;
+    make_pixels(&deserialized);
+    {
+        SkCanvas canvas(deserialized);
+        copy->playback(&canvas);
+    }
+    check(deserialized, "Deserialized picture playback");
+}
+
+// Levels that don't clip defer their device save until the first clip. The reference forces the
+// save at every level with a no-op clip, and both canvases must agree after every step.
+DEF_TEST(Canvas_DeferredDeviceSave, reporter) {
+    const SkIRect deviceBounds = SkIRect::MakeWH(64, 64);
+    SkRandom rand;
+    for (int trial = 0; trial < 50; ++trial) {
+        SkBitmap deferredBitmap, eagerBitmap;
+        deferredBitmap.allocN32Pixels(64, 64);
+        eagerBitmap.allocN32Pixels(64, 64);
+        deferredBitmap.eraseColor(SK_ColorWHITE);
+        eagerBitmap.eraseColor(SK_ColorWHITE);
+        SkCanvas deferred(deferredBitmap), eager(eagerBitmap);
+        deferred.save();
+        eager.save();
+        eager.clipRegion(SkRegion(deviceBounds));
+
+        for (int step = 0; step < 40; ++step) {
+            SkCanvas* canvases[] = { &deferred, &eager };
+            switch (rand.nextU() % 8) {
+                case 0:
+                    deferred.save();
+                    eager.save();
+                    eager.clipRegion(SkRegion(deviceBounds));
+                    break;
+                case 1:
+                    deferred.saveLayer(nullptr, nullptr);
+                    eager.saveLayer(nullptr, nullptr);
+                    eager.clipRegion(SkRegion(deviceBounds));
+                    break;
+                case 2:
+                case 3:
+                    if (deferred.getSaveCount() > 2) {
+                        deferred.restore();
+                        eager.restore();
+                    }
+                    break;
+                case 4: {
+                    SkScalar dx = rand.nextRangeScalar(-8, 8), dy = rand.nextRangeScalar(-8, 8);
+                    for (SkCanvas* c : canvases) {
+                        c->translate(dx, dy);
+                    }
+                    break;
+                }
+                case 5: {
+                    SkMatrix m;
+                    m.setRotate(rand.nextRangeScalar(-30, 30), 32, 32);
+                    m.preScale(rand.nextRangeScalar(0.8f, 1.25f),
+                               rand.nextRangeScalar(0.8f, 1.25f));
+                    for (SkCanvas* c : canvases) {
+                        c->concat(m);
+                    }
+                    break;
+                }
+                case 6: {
+                    SkRect r = SkRect::MakeXYWH(rand.nextRangeScalar(0, 32),
+                                                rand.nextRangeScalar(0, 32),
+                                                rand.nextRangeScalar(8, 40),
+                                                rand.nextRangeScalar(8, 40));
+                    SkClipOp op = rand.nextBool() ? SkClipOp::kIntersect : SkClipOp::kDifference;
+                    bool aa = rand.nextBool();
+                    if (rand.nextBool()) {
+                        for (SkCanvas* c : canvases) {
+                            c->clipRect(r, op, aa);
+                        }
+                    } else {
+                        SkPath path;
+                        path.moveTo(r.fLeft, r.fTop);
+                        path.lineTo(r.fRight, r.centerY());
+                        path.lineTo(r.centerX(), r.fBottom);
+                        for (SkCanvas* c : canvases) {
+                            c->clipPath(path, op, aa);
+                        }
+                    }
+                    break;
+                }
+                case 7: {
+                    SkPaint paint;
+                    paint.setColor(rand.nextU() | 0xFF000000);
+                    SkRect r = SkRect::MakeXYWH(rand.nextRangeScalar(0, 48),
+                                                rand.nextRangeScalar(0, 48), 16, 16);
+                    for (SkCanvas* c : canvases) {
+                        c->drawRect(r, paint);
+                    }
+                    break;
+                }
+            }
+
+            REPORTER_ASSERT(reporter, deferred.getSaveCount() == eager.getSaveCount());
+            REPORTER_ASSERT(reporter, deferred.getTotalMatrix() == eager.getTotalMatrix());
+            REPORTER_ASSERT(reporter,
+                            deferred.getDeviceClipBounds() == eager.getDeviceClipBounds());
+            SkRegion deferredClip, eagerClip;
+            deferred.temporary_internal_getRgnClip(&deferredClip);
+            eager.temporary_internal_getRgnClip(&eagerClip);
+            REPORTER_ASSERT(reporter, deferredClip == eagerClip);
+        }
+
+        deferred.restoreToCount(1);
+        eager.restoreToCount(1);
+        REPORTER_ASSERT(reporter, deferred.getTotalMatrix().isIdentity());
+        REPORTER_ASSERT(reporter, deferred.getDeviceClipBounds() == deviceBounds);
+        REPORTER_ASSERT(reporter, 0 == memcmp(deferredBitmap.getPixels(), eagerBitmap.getPixels(),
+                                              deferredBitmap.computeByteSize()));
+    }
+}
@@ -1425,6 +1425,84 @@ static void test_tiny_query_bounds_assertion_bug(skiatest::Reporter* reporter) {
     }
 }
 
+static void test_reduced_clip_cache(skiatest::Reporter* reporter) {
+    auto context = GrContext::MakeMock(nullptr);
+    const GrCaps* caps = context->contextPriv().caps();
+
+    SkClipStack stack;
+    for (int i = 0; i < 3; ++i) {
+        SkRRect rrect = SkRRect::MakeRectXY(SkRect::MakeLTRB(10.f * i, 10.f * i, 200, 200), 5, 5);
+        stack.clipRRect(rrect, SkMatrix::I(), kIntersect_SkClipOp, true);
+    }
+    const SkRect queryBounds = SkRect::MakeWH(256, 256);
+
+    GrReducedClipCache cache;
+    const GrReducedClip* reduced = &cache.findOrCreate(stack, queryBounds, caps, 0, 4);
+    const int numAnalyticFPs = reduced->numAnalyticFPs();
+    REPORTER_ASSERT(reporter, reduced->maskElements().isEmpty());
+    REPORTER_ASSERT(reporter, numAnalyticFPs > 0);
+    REPORTER_ASSERT(reporter, 1 == cache.count());
+
+    // The same clip and bounds find the same reduction, which can hand out its FPs repeatedly.
+    REPORTER_ASSERT(reporter, reduced == &cache.findOrCreate(stack, queryBounds, caps, 0, 4));
+    REPORTER_ASSERT(reporter, 1 == cache.count());
+    for (int i = 0; i < 2; ++i) {
+        REPORTER_ASSERT(reporter, reduced->makeAnalyticFPs(nullptr, 0, 256, 256));
+        REPORTER_ASSERT(reporter, numAnalyticFPs == reduced->numAnalyticFPs());
+    }
+
+    // Different bounds or limits are reduced separately.
+    cache.findOrCreate(stack, SkRect::MakeWH(100, 100), caps, 0, 4);
+    cache.findOrCreate(stack, queryBounds, caps, 0, 0);
+    REPORTER_ASSERT(reporter, 3 == cache.count());
+    REPORTER_ASSERT(reporter, !cache.findOrCreate(stack, queryBounds, caps).numAnalyticFPs());
+
+    // Changing the clip changes its gen ID, and restoring it brings the old reduction back.
+    stack.save();
+    stack.clipRect(SkRect::MakeLTRB(50, 50, 150, 150), SkMatrix::I(), kIntersect_SkClipOp, false);
+    REPORTER_ASSERT(reporter, reduced != &cache.findOrCreate(stack, queryBounds, caps, 0, 4));
+    stack.restore();
+    REPORTER_ASSERT(reporter, reduced == &cache.findOrCreate(stack, queryBounds, caps, 0, 4));
+
+    // The least recently used reductions are replaced once the cache is full.
+    for (int i = 0; i < GrReducedClipCache::kMaxEntries; ++i) {
+        cache.findOrCreate(stack, SkRect::MakeWH(100, 100 + i), caps, 0, 4);
+    }
+    REPORTER_ASSERT(reporter, GrReducedClipCache::kMaxEntries == cache.count());
+    const GrReducedClip& again = cache.findOrCreate(stack, queryBounds, caps, 0, 4);
+    REPORTER_ASSERT(reporter, numAnalyticFPs == again.numAnalyticFPs());
+    REPORTER_ASSERT(reporter, GrReducedClipCache::kMaxEntries == cache.count());
+}
+
+static void test_reduced_clip_ccpr_merging(skiatest::Reporter* reporter) {
+    auto context = GrContext::MakeMock(nullptr);
+    const GrCaps* caps = context->contextPriv().caps();
+
+    // Concave AA paths that need CCPR, more of them than we have FPs for.
+    SkClipStack stack;
+    for (int i = 0; i < 8; ++i) {
+        SkPath star;
+        star.moveTo(100 + i, 0);
+        star.lineTo(40, 200);
+        star.lineTo(200, 70);
+        star.lineTo(0, 70);
+        star.lineTo(160, 200);
+        star.close();
+        stack.clipPath(star, SkMatrix::I(),
+                       (i & 1) ? kDifference_SkClipOp : kIntersect_SkClipOp, true);
+    }
+    const SkRect queryBounds = SkRect::MakeWH(256, 256);
+
+    // Without CCPR, the paths have to go in a mask.
+    const GrReducedClip maskClip(stack, queryBounds, caps, 0, 4, 0);
+    REPORTER_ASSERT(reporter, !maskClip.maskElements().isEmpty());
+
+    // With CCPR, the paths past the FP limit fold into the last CCPR path instead.
+    const GrReducedClip ccprClip(stack, queryBounds, caps, 0, 4, 4);
+    REPORTER_ASSERT(reporter, ccprClip.maskElements().isEmpty());
+    REPORTER_ASSERT(reporter, 4 == ccprClip.numAnalyticFPs());
+}
+
 DEF_TEST(ClipStack, reporter) {
     SkClipStack stack;
 
@@ -1477,6 +1555,8 @@ DEF_TEST(ClipStack, reporter) {
     test_reduced_clip_stack_no_aa_crash(reporter);
     test_reduced_clip_stack_aa(reporter);
     test_tiny_query_bounds_assertion_bug(reporter);
+    test_reduced_clip_cache(reporter);
+    test_reduced_clip_ccpr_merging(reporter);
 }
 
 //////////////////////////////////////////////////////////////////////////////
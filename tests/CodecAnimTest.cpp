@@ -13,6 +13,8 @@
 #include "SkCodec.h"
 #include "SkCodecAnimation.h"
 #include "SkData.h"
+#include "SkExecutor.h"
+#include "SkImage.h"
 #include "SkImageInfo.h"
 #include "SkMakeUnique.h"
 #include "SkRefCnt.h"
@@ -484,3 +486,111 @@ DEF_TEST(AnimCodecPlayer, r) {
         REPORTER_ASSERT(r, f1->bounds().size() == test.fSize);
     }
 }
+
+// Whatever the cache budget and whether or not frames are prefetched, every frame should match
+// the one the codec decodes from scratch.
+DEF_TEST(AnimCodecPlayer_Cache, r) {
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(2);
+
+    for (const char* file : { "images/alphabetAnim.gif", "images/randPixelsAnim.gif",
+                              "images/required.webp", "images/webp-animated.webp" }) {
+        sk_sp<SkData> data = GetResourceAsData(file);
+        auto codec = SkCodec::MakeFromData(data);
+        if (!codec) {
+            continue;
+        }
+        const SkImageInfo info = codec->getInfo();
+        std::vector<SkCodec::FrameInfo> frameInfos = codec->getFrameInfo();
+        std::vector<SkBitmap> expected(frameInfos.size());
+        for (size_t i = 0; i < frameInfos.size(); i++) {
+            SkCodec::Options opts;
+            opts.fFrameIndex = i;
+            expected[i].allocPixels(info);
+            REPORTER_ASSERT(r, SkCodec::kSuccess == codec->getPixels(expected[i].pixmap(), &opts));
+        }
+
+        // Play the animation through twice, then step back through it. seek() to the time a
+        // frame starts finds the one before, and frames with no duration can't be found at all.
+        std::vector<std::pair<uint32_t, int>> frames;
+        uint32_t start = 0;
+        for (size_t i = 0; i < frameInfos.size(); i++) {
+            if (frameInfos[i].fDuration > 0) {
+                frames.push_back({ start + 1, SkToInt(i) });
+            }
+            start += frameInfos[i].fDuration;
+        }
+        std::vector<std::pair<uint32_t, int>> playback = frames;
+        playback.insert(playback.end(), frames.begin(), frames.end());
+        playback.insert(playback.end(), frames.rbegin(), frames.rend());
+
+        const size_t frameBytes = info.computeMinByteSize();
+        for (size_t budget : { SIZE_MAX, 3 * frameBytes, frameBytes / 2 }) {
+            for (SkExecutor* prefetch : { (SkExecutor*)nullptr, executor.get() }) {
+                SkAnimCodecPlayer player(SkCodec::MakeFromData(data), budget, prefetch);
+                for (const auto& timeAndFrame : playback) {
+                    player.seek(timeAndFrame.first);
+                    const SkBitmap& frame = expected[timeAndFrame.second];
+                    sk_sp<SkImage> image = player.getFrame();
+                    SkPixmap pixmap;
+                    if (!image || !image->peekPixels(&pixmap) ||
+                        0 != memcmp(pixmap.addr(), frame.getPixels(), frame.computeByteSize())) {
+                        ERRORF(r, "Frame %d of %s is wrong with a budget of %zu, prefetch %d",
+                               timeAndFrame.second, file, budget, prefetch != nullptr);
+                        break;
+                    }
+                }
+            }
+        }
+    }
+}
+
+DEF_TEST(Codec_getAllFrames, r) {
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+    for (const char* file : { "images/alphabetAnim.gif", "images/colorTables.gif",
+                              "images/flightAnim.gif", "images/randPixelsAnim.gif",
+                              "images/randPixelsAnim2.gif", "images/test640x479.gif",
+                              "images/box.gif", "images/webp-animated.webp",
+                              "images/blendBG.webp" }) {
+        sk_sp<SkData> data(GetResourceAsData(file));
+        if (!data) {
+            continue;
+        }
+        std::unique_ptr<SkCodec> codec(SkCodec::MakeFromData(data));
+        if (!codec) {
+            ERRORF(r, "Could not create codec for %s", file);
+            continue;
+        }
+        const SkImageInfo info = codec->getInfo().makeColorType(kN32_SkColorType)
+                                                 .makeAlphaType(kPremul_SkAlphaType);
+        const int frameCount = codec->getFrameCount();
+
+        // Decoding each frame alone, with a new codec, is the reference.
+        std::vector<SkBitmap> expected(frameCount);
+        for (int i = 0; i < frameCount; i++) {
+            std::unique_ptr<SkCodec> frameCodec(SkCodec::MakeFromData(data));
+            SkCodec::Options options;
+            options.fFrameIndex = i;
+            expected[i].allocPixels(info);
+            REPORTER_ASSERT(r, SkCodec::kSuccess == frameCodec->getPixels(info,
+                    expected[i].getPixels(), expected[i].rowBytes(), &options));
+        }
+
+        for (SkExecutor* frameExecutor : { (SkExecutor*) nullptr, executor.get() }) {
+            std::unique_ptr<SkCodec> allCodec(SkCodec::MakeFromData(data));
+            std::vector<SkBitmap> actual(frameCount);
+            std::vector<void*> pixels(frameCount);
+            for (int i = 0; i < frameCount; i++) {
+                actual[i].allocPixels(info);
+                pixels[i] = actual[i].getPixels();
+            }
+            REPORTER_ASSERT(r, SkCodec::kSuccess == allCodec->getAllFrames(info, pixels.data(),
+                    info.minRowBytes(), frameExecutor));
+            for (int i = 0; i < frameCount; i++) {
+                if (!sk_tool_utils::equal_pixels(expected[i], actual[i])) {
+                    ERRORF(r, "%s: frame %d differs %s an executor", file, i,
+                           frameExecutor ? "with" : "without");
+                }
+            }
+        }
+    }
+}
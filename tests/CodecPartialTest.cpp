@@ -144,6 +144,57 @@ DEF_TEST(Codec_partial, r) {
     test_partial(r, "images/box.gif");
     test_partial(r, "images/randPixels.gif", 215);
     test_partial(r, "images/color_wheel.gif");
+
+    // Progressive jpegs.
+    test_partial(r, "images/brickwork-texture.jpg");
+    test_partial(r, "images/flutter_logo.jpg");
+    test_partial(r, "images/grayscale.jpg");
+}
+
+// A progressive jpeg's incremental decode outputs the whole image as soon as its first scan has
+// arrived, and improves it as more scans arrive.
+DEF_TEST(Codec_partialProgressive, r) {
+    sk_sp<SkData> file = GetResourceAsData("images/brickwork-texture.jpg");
+    if (!file) {
+        return;
+    }
+    SkBitmap truth;
+    if (!create_truth(file, &truth)) {
+        ERRORF(r, "Failed to decode brickwork-texture.jpg");
+        return;
+    }
+
+    HaltingStream* stream = new HaltingStream(file, file->size() / 4);
+    std::unique_ptr<SkCodec> codec(SkCodec::MakeFromStream(std::unique_ptr<SkStream>(stream)));
+    if (!codec) {
+        ERRORF(r, "Failed to create codec");
+        return;
+    }
+
+    const SkImageInfo info = standardize_info(codec.get());
+    SkBitmap incremental;
+    incremental.allocPixels(info);
+    REPORTER_ASSERT(r, SkCodec::kSuccess == codec->startIncrementalDecode(info,
+            incremental.getPixels(), incremental.rowBytes()));
+
+    int previews = 0;
+    for (;;) {
+        int rowsDecoded = 0;
+        const SkCodec::Result result = codec->incrementalDecode(&rowsDecoded);
+        if (SkCodec::kSuccess == result) {
+            break;
+        }
+        REPORTER_ASSERT(r, SkCodec::kIncompleteInput == result);
+        REPORTER_ASSERT(r, 0 == rowsDecoded || info.height() == rowsDecoded);
+        previews += info.height() == rowsDecoded;
+        if (stream->isAllDataReceived()) {
+            ERRORF(r, "Failed to completely decode");
+            return;
+        }
+        stream->addNewData(file->size() / 8);
+    }
+    REPORTER_ASSERT(r, previews > 0);
+    compare_bitmaps(r, truth, incremental);
 }
 
 // Verify that when decoding an animated gif byte by byte we report the correct
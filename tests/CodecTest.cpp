@@ -18,6 +18,7 @@
 #include "SkColorSpacePriv.h"
 #include "SkData.h"
 #include "SkEncodedImageFormat.h"
+#include "SkExecutor.h"
 #include "SkFrontBufferedStream.h"
 #include "SkImage.h"
 #include "SkImageGenerator.h"
@@ -1008,6 +1009,87 @@ DEF_TEST(Codec_jpeg_rewind, r) {
     REPORTER_ASSERT(r, SkCodec::kIncompleteInput == result);
 }
 
+// Decodes the whole image with getPixels(), which decodes jpegs with restart markers in strips, and
+// one scanline at a time, which never does, and checks that the results match.
+static void check_strips(skiatest::Reporter* r, sk_sp<SkData> data, SkColorType colorType) {
+    std::unique_ptr<SkCodec> codec(SkCodec::MakeFromData(data));
+    if (!codec) {
+        ERRORF(r, "Unable to create codec.");
+        return;
+    }
+    SkImageInfo info = codec->getInfo().makeColorType(colorType);
+    SkBitmap strips, scanlines;
+    strips.allocPixels(info);
+    scanlines.allocPixels(info);
+
+    {
+        std::unique_ptr<SkExecutor> pool = SkExecutor::MakeFIFOThreadPool(4);
+        SkExecutor::SetDefault(pool.get());
+        auto result = codec->getPixels(strips.pixmap());
+        SkExecutor::SetDefault(nullptr);
+        REPORTER_ASSERT(r, SkCodec::kSuccess == result);
+    }
+
+    REPORTER_ASSERT(r, SkCodec::kSuccess == codec->startScanlineDecode(info));
+    REPORTER_ASSERT(r, info.height() == codec->getScanlines(scanlines.getPixels(), info.height(),
+                                                           scanlines.rowBytes()));
+    for (int y = 0; y < info.height(); y++) {
+        if (0 != memcmp(strips.getAddr(0, y), scanlines.getAddr(0, y), info.minRowBytes())) {
+            ERRORF(r, "Row %d of %s differs when decoded in strips.", y,
+                   sk_tool_utils::colortype_name(colorType));
+            return;
+        }
+    }
+}
+
+DEF_TEST(Codec_jpeg_restart_strips, r) {
+    // Big enough to be decoded in strips. Some noise keeps every block busy.
+    SkBitmap bm;
+    bm.allocPixels(SkImageInfo::MakeN32(2003, 1601, kOpaque_SkAlphaType));
+    SkRandom rand;
+    for (int y = 0; y < bm.height(); y++) {
+        for (int x = 0; x < bm.width(); x++) {
+            *bm.getAddr32(x, y) = SkPreMultiplyColor(SkColorSetRGB(
+                    (x + (rand.nextU() & 0x1F)) & 0xFF, y & 0xFF, (x ^ y) & 0xFF));
+        }
+    }
+    SkBitmap gray;
+    gray.allocPixels(bm.info().makeColorType(kGray_8_SkColorType));
+    bm.readPixels(gray.pixmap());
+
+    struct {
+        const SkBitmap&           fSrc;
+        SkJpegEncoder::Downsample fDownsample;
+        int                       fRestartRows;
+    } recs[] = {
+        { bm,   SkJpegEncoder::Downsample::k420, 1 },
+        { bm,   SkJpegEncoder::Downsample::k422, 3 },
+        { bm,   SkJpegEncoder::Downsample::k444, 2 },
+        { gray, SkJpegEncoder::Downsample::k420, 1 },
+    };
+    for (const auto& rec : recs) {
+        SkJpegEncoder::Options options;
+        options.fDownsample = rec.fDownsample;
+        options.fRestartRows = rec.fRestartRows;
+        SkDynamicMemoryWStream stream;
+        REPORTER_ASSERT(r, SkJpegEncoder::Encode(&stream, rec.fSrc.pixmap(), options));
+        sk_sp<SkData> data = stream.detachAsData();
+
+        check_strips(r, data, kN32_SkColorType);
+        check_strips(r, data, kRGB_565_SkColorType);
+        if (&rec.fSrc == &gray) {
+            check_strips(r, data, kGray_8_SkColorType);
+        }
+
+        // Without all of its restart markers, the image is decoded normally.
+        std::unique_ptr<SkCodec> codec(SkCodec::MakeFromData(
+                SkData::MakeSubset(data.get(), 0, data->size() / 2)));
+        SkBitmap partial;
+        partial.allocPixels(codec->getInfo());
+        REPORTER_ASSERT(r, SkCodec::kIncompleteInput == codec->getPixels(partial.pixmap()));
+    }
+}
+
 static void check_color_xform(skiatest::Reporter* r, const char* path) {
     std::unique_ptr<SkAndroidCodec> codec(SkAndroidCodec::MakeFromStream(GetResourceAsStream(path)));
 
@@ -430,3 +430,32 @@ DEF_TEST(ColorSpace_skcms_sRGB_exact, r) {
 
     REPORTER_ASSERT(r, 0 == memcmp(&profile, skcms_sRGB_profile(), sizeof(skcms_ICCProfile)));
 }
+
+DEF_TEST(ColorSpace_InternedByProfile, r) {
+    skcms_ICCProfile p3, adobe;
+    SkColorSpace::MakeRGB(SkColorSpace::kSRGB_RenderTargetGamma,
+                          SkColorSpace::kDCIP3_D65_Gamut)->toProfile(&p3);
+    SkColorSpace::MakeRGB(g2Dot2_TransferFn, SkColorSpace::kAdobeRGB_Gamut)->toProfile(&adobe);
+
+    // Images with the same embedded profile share one SkColorSpace.
+    sk_sp<SkColorSpace> p3Space = SkColorSpace::Make(p3);
+    REPORTER_ASSERT(r, p3Space && p3Space == SkColorSpace::Make(p3));
+    skcms_ICCProfile p3Copy = p3;
+    REPORTER_ASSERT(r, p3Space == SkColorSpace::Make(p3Copy));
+
+    sk_sp<SkColorSpace> adobeSpace = SkColorSpace::Make(adobe);
+    REPORTER_ASSERT(r, adobeSpace && adobeSpace != p3Space);
+    REPORTER_ASSERT(r, !SkColorSpace::Equals(adobeSpace.get(), p3Space.get()));
+
+    // Remembered comparisons give the same answers as skcms.
+    const skcms_ICCProfile* profiles[] = { &p3, &adobe, skcms_sRGB_profile() };
+    for (int repeat = 0; repeat < 2; repeat++) {
+        for (auto a : profiles) {
+            for (auto b : profiles) {
+                REPORTER_ASSERT(r, sk_approximately_equal_profiles(a, b) ==
+                                   skcms_ApproximatelyEqualProfiles(a, b));
+            }
+        }
+    }
+    REPORTER_ASSERT(r, sk_approximately_equal_profiles(&p3, &p3Copy));
+}
@@ -22,6 +22,7 @@
 #include "SkBitmap.h"
 #include "SkCanvas.h"
 #include "SkColorSpace.h"
+#include "SkData.h"
 #include "SkDeferredDisplayList.h"
 #include "SkDeferredDisplayListRecorder.h"
 #include "SkGpuDevice.h"
@@ -802,6 +803,71 @@ DEF_GPUTEST_FOR_RENDERING_CONTEXTS(DDLFlushWhileRecording, reporter, ctxInfo) {
     canvas->getGrContext()->flush();
 }
 
+////////////////////////////////////////////////////////////////////////////////
+// Check that a serialized DDL plays back into another recorder to the same pixels
+DEF_GPUTEST_FOR_RENDERING_CONTEXTS(DDLSerializeTest, reporter, ctxInfo) {
+    GrContext* context = ctxInfo.grContext();
+
+    SkImageInfo ii = SkImageInfo::MakeN32Premul(32, 32);
+    sk_sp<SkSurface> s1 = SkSurface::MakeRenderTarget(context, SkBudgeted::kNo, ii);
+    sk_sp<SkSurface> s2 = SkSurface::MakeRenderTarget(context, SkBudgeted::kNo, ii);
+
+    SkSurfaceCharacterization characterization;
+    SkAssertResult(s1->characterize(&characterization));
+
+    sk_sp<SkData> data;
+    std::unique_ptr<SkDeferredDisplayList> ddl1;
+    {
+        SkDeferredDisplayListRecorder recorder(characterization,
+                                               SkDeferredDisplayListRecorder::Serializable::kYes);
+        SkCanvas* canvas = recorder.getCanvas();
+        canvas->clear(SK_ColorWHITE);
+        SkPaint paint;
+        paint.setColor(SK_ColorRED);
+        canvas->drawRect(SkRect::MakeXYWH(4, 4, 10, 20), paint);
+        paint.setColor(SK_ColorBLUE);
+        paint.setAntiAlias(true);
+        canvas->drawCircle(20, 16, 8, paint);
+
+        ddl1 = recorder.detach();
+        data = ddl1->serialize();
+        REPORTER_ASSERT(reporter, data);
+    }
+    if (!data) {
+        return;
+    }
+
+    std::unique_ptr<SkDeferredDisplayList> ddl2;
+    {
+        SkDeferredDisplayListRecorder recorder(characterization);
+        REPORTER_ASSERT(reporter, recorder.playback(data->data(), data->size()));
+        REPORTER_ASSERT(reporter, !recorder.playback(data->data(), data->size() / 2));
+        ddl2 = recorder.detach();
+
+        // Only serializable recorders' DDLs can be serialized.
+        REPORTER_ASSERT(reporter, !ddl2->serialize());
+    }
+
+    REPORTER_ASSERT(reporter, s1->draw(ddl1.get()));
+    REPORTER_ASSERT(reporter, s2->draw(ddl2.get()));
+
+    SkBitmap bm1, bm2;
+    bm1.allocPixels(ii);
+    bm2.allocPixels(ii);
+    REPORTER_ASSERT(reporter, s1->readPixels(bm1, 0, 0));
+    REPORTER_ASSERT(reporter, s2->readPixels(bm2, 0, 0));
+    REPORTER_ASSERT(reporter, 0 == memcmp(bm1.getPixels(), bm2.getPixels(),
+                                          bm1.computeByteSize()));
+
+    // A DDL can only be played back into a recorder for a surface of the same size.
+    sk_sp<SkSurface> s3 = SkSurface::MakeRenderTarget(context, SkBudgeted::kNo,
+                                                      ii.makeWH(16, 16));
+    SkSurfaceCharacterization smaller;
+    SkAssertResult(s3->characterize(&smaller));
+    SkDeferredDisplayListRecorder recorder(smaller);
+    REPORTER_ASSERT(reporter, !recorder.playback(data->data(), data->size()));
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // Check that the texture-specific flags (i.e., for external & rectangle textures) work
 // for promise images. As such, this is a GL-only test.
@@ -62,3 +62,31 @@ DEF_TEST(DiscardableMemory_nonglobal, reporter) {
     test_dm(reporter, dm.get(), true);
 }
 
+
+DEF_TEST(DiscardableMemory_global_pages, reporter) {
+    // Big enough that an OS backed implementation won't take it from the pool. Every byte,
+    // including the first of each page, must come back if relocking succeeds.
+    constexpr size_t kSize = 64 * 1024 + 100;
+    std::unique_ptr<SkDiscardableMemory> dm(SkDiscardableMemory::Create(kSize));
+    REPORTER_ASSERT(reporter, dm && dm->data());
+    if (!dm || !dm->data()) {
+        return;
+    }
+    uint8_t* bytes = static_cast<uint8_t*>(dm->data());
+    for (size_t i = 0; i < kSize; ++i) {
+        bytes[i] = (uint8_t)(i * 7 + 1);
+    }
+    for (int round = 0; round < 3; ++round) {
+        dm->unlock();
+        if (!dm->lock()) {
+            return;  // Purged, which is allowed.
+        }
+        bytes = static_cast<uint8_t*>(dm->data());
+        bool same = true;
+        for (size_t i = 0; i < kSize; ++i) {
+            same = same && bytes[i] == (uint8_t)(i * 7 + 1);
+        }
+        REPORTER_ASSERT(reporter, same);
+    }
+    dm->unlock();
+}
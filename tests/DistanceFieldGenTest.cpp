@@ -0,0 +1,40 @@
+/*
+ * Copyright 2019 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkDistanceFieldGen.h"
+#include "SkTemplates.h"
+#include "Test.h"
+
+// A shape that is symmetric about a vertical axis must produce a distance field that is too,
+// including in the padding. The bottom rows are filled edge to edge (with partial coverage at the
+// ends), so the padding above them is reached only by the backwards-in-y passes.
+DEF_TEST(DistanceFieldGen_Symmetric, reporter) {
+    static constexpr int kWidth = 16;
+    static constexpr int kHeight = 12;
+    unsigned char image[kWidth * kHeight] = {};
+    for (int y = 9; y < kHeight; ++y) {
+        image[y * kWidth] = 100;
+        for (int x = 1; x < kWidth - 1; ++x) {
+            image[y * kWidth + x] = 255;
+        }
+        image[y * kWidth + kWidth - 1] = 100;
+    }
+
+    static constexpr int kDFWidth = kWidth + 2 * SK_DistanceFieldPad;
+    static constexpr int kDFHeight = kHeight + 2 * SK_DistanceFieldPad;
+    SkAutoTMalloc<unsigned char> distanceField(kDFWidth * kDFHeight);
+    REPORTER_ASSERT(reporter, SkGenerateDistanceFieldFromA8Image(distanceField.get(), image,
+                                                                 kWidth, kHeight, kWidth));
+
+    for (int y = 0; y < kDFHeight; ++y) {
+        const unsigned char* row = distanceField.get() + y * kDFWidth;
+        for (int x = 0; x < kDFWidth / 2; ++x) {
+            REPORTER_ASSERT(reporter, row[x] == row[kDFWidth - 1 - x], "(%d, %d): %d vs. %d",
+                            x, y, row[x], row[kDFWidth - 1 - x]);
+        }
+    }
+}
@@ -176,6 +176,141 @@ DEF_GPUTEST_FOR_RENDERING_CONTEXTS(BasicDrawOpAtlas, reporter, ctxInfo) {
     check(reporter, atlas.get(), 1, 4, 1);
 }
 
+struct CallbackCounts {
+    int fEvictions = 0;
+    int fRelocations = 0;
+    GrDrawOpAtlas::AtlasID fTracked = GrDrawOpAtlas::kInvalidAtlasID;  // Follows relocations.
+};
+
+static void count_eviction(GrDrawOpAtlas::AtlasID, void* data) {
+    static_cast<CallbackCounts*>(data)->fEvictions++;
+}
+
+static void count_relocation(GrDrawOpAtlas::AtlasID from, GrDrawOpAtlas::AtlasID to, SkIPoint16,
+                             void* data) {
+    CallbackCounts* counts = static_cast<CallbackCounts*>(data);
+    counts->fRelocations++;
+    if (from == counts->fTracked) {
+        counts->fTracked = to;
+    }
+}
+
+static void simulate_flush(GrDrawOpAtlas* atlas, TestingUploadTarget* uploadTarget,
+                           const GrDrawOpAtlas::AtlasID* usedIDs, int count) {
+    for (int i = 0; i < count; ++i) {
+        atlas->setLastUseToken(usedIDs[i], uploadTarget->tokenTracker()->nextDrawToken());
+    }
+    uploadTarget->issueDrawToken();
+    uploadTarget->flushToken();
+    atlas->compact(uploadTarget->tokenTracker()->nextTokenToFlush());
+}
+
+// Verifies that compaction moves a sparsely used last page's plots to free plots on earlier pages,
+// instead of evicting them, when the atlas's clients can follow them.
+DEF_GPUTEST_FOR_RENDERING_CONTEXTS(DrawOpAtlasRelocation, reporter, ctxInfo) {
+    auto context = ctxInfo.grContext();
+    auto proxyProvider = context->contextPriv().proxyProvider();
+    auto resourceProvider = context->contextPriv().resourceProvider();
+    auto drawingManager = context->contextPriv().drawingManager();
+
+    GrOnFlushResourceProvider onFlushResourceProvider(drawingManager);
+    TestingUploadTarget uploadTarget;
+    CallbackCounts counts;
+
+    GrBackendFormat format =
+            context->contextPriv().caps()->getBackendFormatFromColorType(kAlpha_8_SkColorType);
+
+    std::unique_ptr<GrDrawOpAtlas> atlas = GrDrawOpAtlas::Make(
+                                                proxyProvider,
+                                                format,
+                                                kAlpha_8_GrPixelConfig,
+                                                kAtlasSize, kAtlasSize,
+                                                kNumPlots, kNumPlots,
+                                                GrDrawOpAtlas::AllowMultitexturing::kYes,
+                                                count_eviction, &counts);
+    atlas->registerRelocationCallback(count_relocation, &counts);
+
+    // Fill the first page, and one plot of the second.
+    GrDrawOpAtlas::AtlasID atlasIDs[kNumPlots * kNumPlots];
+    for (int i = 0; i < kNumPlots * kNumPlots; ++i) {
+        REPORTER_ASSERT(reporter,
+                        fill_plot(atlas.get(), resourceProvider, &uploadTarget, &atlasIDs[i], i));
+    }
+    atlas->instantiate(&onFlushResourceProvider);
+    REPORTER_ASSERT(reporter, fill_plot(atlas.get(), resourceProvider, &uploadTarget,
+                                        &counts.fTracked, 255));
+    REPORTER_ASSERT(reporter, 1 == GrDrawOpAtlas::GetPageIndexFromID(counts.fTracked));
+    check(reporter, atlas.get(), 2, 4, 2);
+
+    // Keep using only the plot on the second page, until the first page's plots age out.
+    for (int i = 0; i < 512; ++i) {
+        simulate_flush(atlas.get(), &uploadTarget, &counts.fTracked, 1);
+    }
+
+    // The used plot moved to the first page, and the second page was released.
+    check(reporter, atlas.get(), 1, 4, 1);
+    REPORTER_ASSERT(reporter, 1 == counts.fRelocations);
+    REPORTER_ASSERT(reporter, 1 == counts.fEvictions);
+    REPORTER_ASSERT(reporter, 0 == GrDrawOpAtlas::GetPageIndexFromID(counts.fTracked));
+    REPORTER_ASSERT(reporter, atlas->hasID(counts.fTracked));
+    REPORTER_ASSERT(reporter, 1 == atlas->stats().fRelocations);
+
+    // The moved plot is uploaded once to its new place.
+    size_t uploadBytes = atlas->stats().fUploadBytes;
+    atlas->uploadRelocatedPlots(&uploadTarget);
+    REPORTER_ASSERT(reporter, uploadBytes + kPlotSize * kPlotSize == atlas->stats().fUploadBytes);
+    atlas->uploadRelocatedPlots(&uploadTarget);
+    REPORTER_ASSERT(reporter, uploadBytes + kPlotSize * kPlotSize == atlas->stats().fUploadBytes);
+}
+
+// Verifies that a full atlas evicts the plot that has been used least lately, rather than the
+// least recently used one.
+DEF_GPUTEST_FOR_RENDERING_CONTEXTS(DrawOpAtlasFrequencyEviction, reporter, ctxInfo) {
+    auto context = ctxInfo.grContext();
+    auto proxyProvider = context->contextPriv().proxyProvider();
+    auto resourceProvider = context->contextPriv().resourceProvider();
+    auto drawingManager = context->contextPriv().drawingManager();
+
+    GrOnFlushResourceProvider onFlushResourceProvider(drawingManager);
+    TestingUploadTarget uploadTarget;
+    CallbackCounts counts;
+
+    GrBackendFormat format =
+            context->contextPriv().caps()->getBackendFormatFromColorType(kAlpha_8_SkColorType);
+
+    std::unique_ptr<GrDrawOpAtlas> atlas = GrDrawOpAtlas::Make(
+                                                proxyProvider,
+                                                format,
+                                                kAlpha_8_GrPixelConfig,
+                                                kAtlasSize, kAtlasSize,
+                                                kNumPlots, kNumPlots,
+                                                GrDrawOpAtlas::AllowMultitexturing::kNo,
+                                                count_eviction, &counts);
+
+    GrDrawOpAtlas::AtlasID atlasIDs[kNumPlots * kNumPlots];
+    for (int i = 0; i < kNumPlots * kNumPlots; ++i) {
+        REPORTER_ASSERT(reporter,
+                        fill_plot(atlas.get(), resourceProvider, &uploadTarget, &atlasIDs[i], i));
+    }
+    atlas->instantiate(&onFlushResourceProvider);
+
+    // Use every plot but the first for a while, and then only the first, once.
+    for (int i = 0; i < 8; ++i) {
+        simulate_flush(atlas.get(), &uploadTarget, &atlasIDs[1], kNumPlots * kNumPlots - 1);
+    }
+    simulate_flush(atlas.get(), &uploadTarget, &atlasIDs[0], 1);
+
+    // Though the first plot is the most recently used, it's the one to go.
+    GrDrawOpAtlas::AtlasID atlasID;
+    REPORTER_ASSERT(reporter,
+                    fill_plot(atlas.get(), resourceProvider, &uploadTarget, &atlasID, 255));
+    REPORTER_ASSERT(reporter, 1 == counts.fEvictions);
+    REPORTER_ASSERT(reporter, !atlas->hasID(atlasIDs[0]));
+    for (int i = 1; i < kNumPlots * kNumPlots; ++i) {
+        REPORTER_ASSERT(reporter, atlas->hasID(atlasIDs[i]));
+    }
+}
+
 // This test verifies that the GrAtlasTextOp::onPrepare method correctly handles a failure
 // when allocating an atlas page.
 DEF_GPUTEST_FOR_RENDERING_CONTEXTS(GrAtlasTextOpPreparation, reporter, ctxInfo) {
@@ -8,6 +8,7 @@
 #include "SkBitmap.h"
 #include "SkCanvas.h"
 #include "SkColor.h"
+#include "SkColorPriv.h"
 #include "SkDashPathEffect.h"
 #include "SkImageInfo.h"
 #include "SkMatrix.h"
@@ -24,6 +25,8 @@
 #include "SkTypes.h"
 #include "Test.h"
 
+#include <atomic>
+
 // test that we can draw an aa-rect at coordinates > 32K (bigger than fixedpoint)
 static void test_big_aa_rect(skiatest::Reporter* reporter) {
     SkBitmap output;
@@ -371,3 +374,57 @@ DEF_TEST(DrawPath, reporter) {
     test_big_aa_rect(reporter);
     test_halfway();
 }
+
+extern std::atomic<bool> gSkForceDeltaAA;
+extern std::atomic<int>  gSkDAABandPixelThreshold;
+
+// Filling a big path with its delta AA coverage built in bands should match filling it at once, up
+// to rounding where the bands' edges are clipped.
+DEF_TEST(DrawPath_DAABands, reporter) {
+    SkPath star;
+    star.moveTo(10, 10);
+    for (int i = 1; i < 40; ++i) {
+        SkScalar angle = i * 2.4f;
+        star.lineTo(256 + 240 * SkScalarCos(angle), 256 + 240 * SkScalarSin(angle));
+    }
+    star.close();
+    star.addCircle(256, 256, 100);
+    // Convex, so that its straight sides are filled by blitAntiRect, across several bands.
+    SkPath roundRect;
+    roundRect.addRRect(SkRRect::MakeRectXY(SkRect::MakeLTRB(20.3f, 30.6f, 490.2f, 480.7f), 60, 60));
+
+    SkPath path;
+    auto fill = [&](SkBitmap* bm, SkPath::FillType fillType) {
+        bm->allocN32Pixels(512, 512);
+        bm->eraseColor(SK_ColorTRANSPARENT);
+        SkCanvas canvas(*bm);
+        SkPaint paint;
+        paint.setAntiAlias(true);
+        path.setFillType(fillType);
+        canvas.drawPath(path, paint);
+    };
+
+    bool forceDeltaAA = gSkForceDeltaAA;
+    gSkForceDeltaAA = true;
+    for (auto fillType : {SkPath::kWinding_FillType, SkPath::kEvenOdd_FillType})
+    for (const SkPath& p : {star, roundRect}) {
+        path = p;
+        SkBitmap serial, banded;
+        gSkDAABandPixelThreshold = 0;
+        fill(&serial, fillType);
+        gSkDAABandPixelThreshold = 1;
+        fill(&banded, fillType);
+        gSkDAABandPixelThreshold = 0;
+
+        int maxDiff = 0;
+        for (int y = 0; y < 512; ++y) {
+            for (int x = 0; x < 512; ++x) {
+                maxDiff = SkTMax(maxDiff, SkTAbs((int)SkGetPackedA32(*serial.getAddr32(x, y)) -
+                                                 (int)SkGetPackedA32(*banded.getAddr32(x, y))));
+            }
+        }
+        REPORTER_ASSERT(reporter, maxDiff <= 2, "fill type %d, max alpha diff %d",
+                        fillType, maxDiff);
+    }
+    gSkForceDeltaAA = forceDeltaAA;
+}
@@ -8,14 +8,21 @@
 #include "Resources.h"
 #include "Test.h"
 
+#include "SkAutoMalloc.h"
 #include "SkBitmap.h"
+#include "SkCodec.h"
 #include "SkColorPriv.h"
 #include "SkEncodedImageFormat.h"
+#include "SkExecutor.h"
 #include "SkImage.h"
 #include "SkJpegEncoder.h"
+#include "SkOpts.h"
 #include "SkPngEncoder.h"
+#include "SkRandom.h"
 #include "SkStream.h"
 #include "SkWebpEncoder.h"
+#include "SkYUVAIndex.h"
+#include "SkYUVASizeInfo.h"
 
 #include "png.h"
 
@@ -172,6 +179,127 @@ DEF_TEST(Encode_JpegDownsample, r) {
     REPORTER_ASSERT(r, almost_equals(bm1, bm2, 60));
 }
 
+static bool decode_jpeg(sk_sp<SkData> data, SkBitmap* bitmap) {
+    std::unique_ptr<SkCodec> codec = SkCodec::MakeFromData(std::move(data));
+    return codec && bitmap->tryAllocPixels(codec->getInfo().makeColorType(kN32_SkColorType)) &&
+           SkCodec::kSuccess == codec->getPixels(bitmap->pixmap());
+}
+
+DEF_TEST(Encode_JpegParallel, r) {
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+
+    // Odd sizes, so the edges need padding, and tall enough for several strips.
+    const int kWidth = 1001, kHeight = 1301;
+    SkRandom random;
+    SkBitmap bitmap;
+    bitmap.allocPixels(SkImageInfo::MakeN32(kWidth, kHeight, kOpaque_SkAlphaType));
+    for (int y = 0; y < kHeight; y++) {
+        for (int x = 0; x < kWidth; x++) {
+            *bitmap.getAddr32(x, y) = SkPackARGB32(0xFF, x % 256, y % 256,
+                                                   (x + y) % 256 ^ (random.nextU() & 7));
+        }
+    }
+
+    // SkOpts' conversion matches JFIF's definition.
+    {
+        uint32_t pixels[19];
+        uint8_t yuv[3][19];
+        for (uint32_t& pixel : pixels) {
+            pixel = random.nextU();
+        }
+        SkOpts::RGBA_to_YCbCr(yuv[0], yuv[1], yuv[2], pixels, 19);
+        for (int i = 0; i < 19; i++) {
+            float R = pixels[i] & 0xFF, G = (pixels[i] >> 8) & 0xFF, B = (pixels[i] >> 16) & 0xFF;
+            float expected[3] = { 0.299f * R + 0.587f * G + 0.114f * B,
+                                  128 - 0.168736f * R - 0.331264f * G + 0.5f * B,
+                                  128 + 0.5f * R - 0.418688f * G - 0.081312f * B };
+            for (int c = 0; c < 3; c++) {
+                REPORTER_ASSERT(r, SkTAbs(expected[c] - yuv[c][i]) <= 0.51f);
+            }
+        }
+    }
+
+    const SkColorType colorTypes[] = {
+        kRGBA_8888_SkColorType, kBGRA_8888_SkColorType, kRGBA_F16_SkColorType,
+    };
+    const SkJpegEncoder::Downsample downsamples[] = {
+        SkJpegEncoder::Downsample::k420, SkJpegEncoder::Downsample::k422,
+        SkJpegEncoder::Downsample::k444,
+    };
+    for (SkColorType colorType : colorTypes) {
+        SkBitmap converted;
+        converted.allocPixels(bitmap.info().makeColorType(colorType));
+        REPORTER_ASSERT(r, bitmap.readPixels(converted.pixmap()));
+
+        for (SkJpegEncoder::Downsample downsample : downsamples) {
+            for (int restartRows : { 0, 3 }) {
+                SkJpegEncoder::Options options;
+                options.fQuality = 90;
+                options.fDownsample = downsample;
+                options.fRestartRows = restartRows;
+                SkDynamicMemoryWStream serial, parallel;
+                REPORTER_ASSERT(r, SkJpegEncoder::Encode(&serial, converted.pixmap(), options));
+                options.fExecutor = executor.get();
+                REPORTER_ASSERT(r, SkJpegEncoder::Encode(&parallel, converted.pixmap(), options));
+
+                sk_sp<SkData> serialData = serial.detachAsData(),
+                              parallelData = parallel.detachAsData();
+                SkBitmap serialBitmap, parallelBitmap;
+                REPORTER_ASSERT(r, decode_jpeg(serialData, &serialBitmap));
+                if (!decode_jpeg(parallelData, &parallelBitmap)) {
+                    ERRORF(r, "Could not decode parallel encode of color type %d", colorType);
+                    continue;
+                }
+                // Only the color conversion and the Huffman tables differ.
+                REPORTER_ASSERT(r, almost_equals(serialBitmap, parallelBitmap, 16));
+                REPORTER_ASSERT(r, parallelData->size() <= serialData->size() * 3 / 2);
+            }
+        }
+    }
+
+    // Re-encoding a jpeg's own YUV planes doesn't need to convert to RGB and back.
+    SkDynamicMemoryWStream original;
+    REPORTER_ASSERT(r, SkJpegEncoder::Encode(&original, bitmap.pixmap(),
+                                             SkJpegEncoder::Options()));
+    sk_sp<SkData> originalData = original.detachAsData();
+    std::unique_ptr<SkCodec> codec = SkCodec::MakeFromData(originalData);
+    SkYUVASizeInfo sizeInfo;
+    SkYUVColorSpace colorSpace;
+    if (!codec || !codec->queryYUV8(&sizeInfo, &colorSpace)) {
+        ERRORF(r, "Could not decode to YUV");
+        return;
+    }
+    SkAutoMalloc storage(sizeInfo.computeTotalBytes());
+    void* planes[SkYUVASizeInfo::kMaxCount];
+    sizeInfo.computePlanes(storage.get(), planes);
+    REPORTER_ASSERT(r, SkCodec::kSuccess == codec->getYUV8Planes(sizeInfo, planes));
+
+    // Swap the planes around, to be sure they're found through the indices.
+    std::swap(planes[0], planes[2]);
+    std::swap(sizeInfo.fSizes[0], sizeInfo.fSizes[2]);
+    std::swap(sizeInfo.fWidthBytes[0], sizeInfo.fWidthBytes[2]);
+    const SkYUVAIndex indices[4] = {
+        { 2, SkColorChannel::kR }, { 1, SkColorChannel::kR }, { 0, SkColorChannel::kR },
+        { -1, SkColorChannel::kR },
+    };
+    SkBitmap decoded;
+    REPORTER_ASSERT(r, decode_jpeg(originalData, &decoded));
+    for (SkExecutor* yuvExecutor : { (SkExecutor*)nullptr, executor.get() }) {
+        SkJpegEncoder::Options options;
+        options.fExecutor = yuvExecutor;
+        SkDynamicMemoryWStream reencoded;
+        REPORTER_ASSERT(r, SkJpegEncoder::EncodeYUV(&reencoded, sizeInfo, indices, planes,
+                                                    colorSpace, options));
+        SkBitmap redecoded;
+        REPORTER_ASSERT(r, decode_jpeg(reencoded.detachAsData(), &redecoded));
+        REPORTER_ASSERT(r, almost_equals(decoded, redecoded, 16));
+
+        SkDynamicMemoryWStream unsupported;
+        REPORTER_ASSERT(r, !SkJpegEncoder::EncodeYUV(&unsupported, sizeInfo, indices, planes,
+                                                     kRec601_SkYUVColorSpace, options));
+    }
+}
+
 static inline void pushComment(
         std::vector<std::string>& comments, const char* keyword, const char* text) {
     comments.push_back(keyword);
@@ -278,12 +406,133 @@ DEF_TEST(Encode_PngOptions, r) {
     REPORTER_ASSERT(r, data0->size() < data1->size());
     REPORTER_ASSERT(r, data1->size() < data2->size());
 
-    SkBitmap bm0, bm1, bm2;
+    SkDynamicMemoryWStream dst3;
+    success = SkPngEncoder::Encode(&dst3, src, SkPngEncoder::Options::Speed());
+    REPORTER_ASSERT(r, success);
+    sk_sp<SkData> data3 = dst3.detachAsData();
+
+    SkBitmap bm0, bm1, bm2, bm3;
     SkImage::MakeFromEncoded(data0)->asLegacyBitmap(&bm0);
     SkImage::MakeFromEncoded(data1)->asLegacyBitmap(&bm1);
     SkImage::MakeFromEncoded(data2)->asLegacyBitmap(&bm2);
+    SkImage::MakeFromEncoded(data3)->asLegacyBitmap(&bm3);
     REPORTER_ASSERT(r, almost_equals(bm0, bm1, 0));
     REPORTER_ASSERT(r, almost_equals(bm0, bm2, 0));
+    REPORTER_ASSERT(r, almost_equals(bm0, bm3, 0));
+}
+
+DEF_TEST(Encode_PngFilters, r) {
+    const size_t kRowBytes = 8 * 37;  // Exercises both the SIMD loops and their tails.
+    SkRandom rand;
+    uint8_t row[kRowBytes], prev[kRowBytes], dst[kRowBytes];
+    for (size_t i = 0; i < kRowBytes; i++) {
+        // Mostly smooth, so that each of Paeth's predictions gets picked.
+        row [i] = i % 7 ? (uint8_t)(i + rand.nextU() % 4) : (uint8_t)rand.nextU();
+        prev[i] = i % 5 ? (uint8_t)(i + rand.nextU() % 4) : (uint8_t)rand.nextU();
+    }
+
+    for (size_t bpp : { 1, 2, 3, 4, 6, 8 }) {
+        auto check = [&](const char* name, SkOpts::PngFilter filter,
+                         int (*predict)(int, int, int)) {
+            filter(dst, row, prev, kRowBytes, bpp);
+            for (size_t i = 0; i < kRowBytes; i++) {
+                int a = i >= bpp ? row [i - bpp] : 0,
+                    c = i >= bpp ? prev[i - bpp] : 0;
+                if (dst[i] != (uint8_t)(row[i] - predict(a, prev[i], c))) {
+                    ERRORF(r, "%s filter, %zu bytes per pixel, differs at byte %zu",
+                           name, bpp, i);
+                    return;
+                }
+            }
+        };
+        check("Sub",   SkOpts::png_filter_sub, [](int a, int, int) { return a; });
+        check("Up",    SkOpts::png_filter_up,  [](int, int b, int) { return b; });
+        check("Avg",   SkOpts::png_filter_avg, [](int a, int b, int) { return (a + b) >> 1; });
+        check("Paeth", SkOpts::png_filter_paeth, [](int a, int b, int c) {
+            int pa = SkTAbs(b - c),
+                pb = SkTAbs(a - c),
+                pc = SkTAbs(a + b - 2 * c);
+            return pa <= pb && pa <= pc ? a : pb <= pc ? b : c;
+        });
+    }
+
+    size_t cost = 0;
+    for (size_t i = 0; i < kRowBytes; i++) {
+        cost += SkTAbs((int)(int8_t)row[i]);
+    }
+    REPORTER_ASSERT(r, SkOpts::png_filter_cost(row, kRowBytes) == cost);
+}
+
+// Decodes with libpng itself, which checks every chunk and the zlib stream, to 16 bit RGBA.
+static bool decode_png(const SkData* data, SkAutoTMalloc<uint16_t>* pixels) {
+    png_image image;
+    memset(&image, 0, sizeof(image));
+    image.version = PNG_IMAGE_VERSION;
+    if (!png_image_begin_read_from_memory(&image, data->data(), data->size())) {
+        return false;
+    }
+    image.format = PNG_FORMAT_LINEAR_RGB_ALPHA;
+    pixels->reset(PNG_IMAGE_SIZE(image) / sizeof(uint16_t));
+    return png_image_finish_read(&image, nullptr, pixels->get(), 0, nullptr);
+}
+
+DEF_TEST(Encode_PngParallel, r) {
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+
+    const int kWidth = 1001, kHeight = 700;
+    SkRandom random;
+    SkBitmap bitmap;
+    bitmap.allocPixels(SkImageInfo::MakeN32Premul(kWidth, kHeight));
+    for (int y = 0; y < kHeight; y++) {
+        for (int x = 0; x < kWidth; x++) {
+            U8CPU a = random.nextU() % 3 ? 255 : y % 256;
+            *bitmap.getAddr32(x, y) = SkPreMultiplyARGB(a, x % 256, (x ^ y) % 256,
+                                                        random.nextU() % 16);
+        }
+    }
+
+    const SkColorType colorTypes[] = {
+        kN32_SkColorType, kRGB_565_SkColorType, kGray_8_SkColorType, kRGBA_F16_SkColorType,
+    };
+    const SkPngEncoder::FilterFlag filters[] = {
+        SkPngEncoder::FilterFlag::kAll, SkPngEncoder::FilterFlag::kNone,
+        SkPngEncoder::FilterFlag::kPaeth,
+    };
+    for (SkColorType colorType : colorTypes) {
+        SkAlphaType alphaType = kN32_SkColorType == colorType ? kPremul_SkAlphaType
+                                                              : kOpaque_SkAlphaType;
+        SkBitmap converted;
+        converted.allocPixels(bitmap.info().makeColorType(colorType).makeAlphaType(alphaType));
+        REPORTER_ASSERT(r, bitmap.readPixels(converted.pixmap()));
+
+        for (SkPngEncoder::FilterFlag filter : filters) {
+            SkPngEncoder::Options options;
+            options.fFilterFlags = filter;
+            SkDynamicMemoryWStream serial, parallel;
+            REPORTER_ASSERT(r, SkPngEncoder::Encode(&serial, converted.pixmap(), options));
+
+            // Encoding a few rows at a time continues the same zlib stream.
+            options.fExecutor = executor.get();
+            auto encoder = SkPngEncoder::Make(&parallel, converted.pixmap(), options);
+            REPORTER_ASSERT(r, encoder);
+            for (int y = 0; encoder && y < kHeight; y += 300) {
+                REPORTER_ASSERT(r, encoder->encodeRows(SkTMin(300, kHeight - y)));
+            }
+
+            sk_sp<SkData> serialData = serial.detachAsData(),
+                          parallelData = parallel.detachAsData();
+            SkAutoTMalloc<uint16_t> serialPixels, parallelPixels;
+            REPORTER_ASSERT(r, decode_png(serialData.get(), &serialPixels));
+            if (!decode_png(parallelData.get(), &parallelPixels)) {
+                ERRORF(r, "Could not decode parallel encode of color type %d", colorType);
+                continue;
+            }
+            REPORTER_ASSERT(r, 0 == memcmp(serialPixels.get(), parallelPixels.get(),
+                                           kWidth * kHeight * 4 * sizeof(uint16_t)));
+            // Priming each chunk with the data before it keeps the cost of splitting small.
+            REPORTER_ASSERT(r, parallelData->size() <= serialData->size() * 21 / 20);
+        }
+    }
 }
 
 DEF_TEST(Encode_WebpOptions, r) {
@@ -338,3 +587,57 @@ DEF_TEST(Encode_WebpOptions, r) {
     REPORTER_ASSERT(r, almost_equals(bm0, bm2, 90));
     REPORTER_ASSERT(r, almost_equals(bm2, bm3, 50));
 }
+
+DEF_TEST(Encode_WebpAnimated, r) {
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+
+    const int kFrames = 5;
+    SkRandom random;
+    SkBitmap bitmaps[kFrames];
+    SkWebpEncoder::Frame frames[kFrames];
+    for (int i = 0; i < kFrames; i++) {
+        bitmaps[i].allocPixels(SkImageInfo::MakeN32(64, 48, kOpaque_SkAlphaType));
+        for (int y = 0; y < 48; y++) {
+            for (int x = 0; x < 64; x++) {
+                *bitmaps[i].getAddr32(x, y) = random.nextU() | 0xFF000000;
+            }
+        }
+        frames[i] = { bitmaps[i].pixmap(), 100 + 10 * i };
+    }
+
+    SkWebpEncoder::Options options = SkWebpEncoder::Options::FastLossless();
+    SkDynamicMemoryWStream serial, parallel;
+    REPORTER_ASSERT(r, SkWebpEncoder::EncodeAnimated(&serial, frames, kFrames, options));
+    options.fExecutor = executor.get();
+    REPORTER_ASSERT(r, SkWebpEncoder::EncodeAnimated(&parallel, frames, kFrames, options));
+    sk_sp<SkData> data = serial.detachAsData();
+    REPORTER_ASSERT(r, data->equals(parallel.detachAsData().get()));
+
+    std::unique_ptr<SkCodec> codec = SkCodec::MakeFromData(data);
+    if (!codec) {
+        ERRORF(r, "Could not decode animated webp");
+        return;
+    }
+    REPORTER_ASSERT(r, kFrames == codec->getFrameCount());
+    REPORTER_ASSERT(r, SkCodec::kRepetitionCountInfinite == codec->getRepetitionCount());
+    for (int i = 0; i < kFrames; i++) {
+        SkCodec::FrameInfo frameInfo;
+        REPORTER_ASSERT(r, codec->getFrameInfo(i, &frameInfo));
+        REPORTER_ASSERT(r, frames[i].fDuration == frameInfo.fDuration);
+        REPORTER_ASSERT(r, SkCodec::kNoFrame == frameInfo.fRequiredFrame);
+
+        SkBitmap decoded;
+        decoded.allocPixels(bitmaps[i].info());
+        SkCodec::Options codecOptions;
+        codecOptions.fFrameIndex = i;
+        REPORTER_ASSERT(r, SkCodec::kSuccess == codec->getPixels(decoded.pixmap(), &codecOptions));
+        REPORTER_ASSERT(r, almost_equals(bitmaps[i], decoded, 0));
+    }
+
+    // Every frame must be the same size.
+    SkBitmap small;
+    small.allocN32Pixels(8, 8);
+    frames[2].fPixmap = small.pixmap();
+    SkDynamicMemoryWStream mismatched;
+    REPORTER_ASSERT(r, !SkWebpEncoder::EncodeAnimated(&mismatched, frames, kFrames, options));
+}
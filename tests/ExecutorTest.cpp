@@ -0,0 +1,143 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkExecutor.h"
+#include "SkMutex.h"
+#include "SkSemaphore.h"
+#include "SkTaskGroup.h"
+#include "Test.h"
+
+#include <atomic>
+#include <vector>
+
+static void test_executor(skiatest::Reporter* r, SkExecutor& executor) {
+    // Work added from outside the pool.
+    std::atomic<int> count{0};
+    {
+        SkTaskGroup tg(executor);
+        tg.batch(1000, [&](int) { count++; });
+        tg.wait();
+        REPORTER_ASSERT(r, 1000 == count.load());
+    }
+
+    // Work added from inside the pool, waited on from inside the pool.
+    count = 0;
+    {
+        SkTaskGroup outer(executor);
+        outer.batch(50, [&](int) {
+            SkTaskGroup inner(executor);
+            inner.batch(50, [&](int) {
+                SkTaskGroup innermost(executor);
+                innermost.add([&] { count++; });
+            });
+        });
+        outer.wait();
+        REPORTER_ASSERT(r, 2500 == count.load());
+    }
+
+    // Work added from inside the pool that nobody waits on until the end.
+    count = 0;
+    {
+        SkTaskGroup tg(executor);
+        tg.add([&] {
+            for (int i = 0; i < 200; i++) {
+                tg.add([&] { count++; });
+            }
+        });
+        tg.wait();
+        REPORTER_ASSERT(r, 200 == count.load());
+    }
+}
+
+static void test_parallel_for(skiatest::Reporter* r, SkExecutor& executor) {
+    for (int N : { 0, 1, 7, 64, 1000 }) {
+        for (int grain : { 0, 1, 3, 64, 5000 }) {
+            std::vector<std::atomic<int>> hits(N);
+            for (auto& hit : hits) {
+                hit = 0;
+            }
+            std::atomic<int> calls{0};
+            SkTaskGroup tg(executor);
+            tg.parallelFor(N, grain, [&](int start, int end) {
+                calls++;
+                REPORTER_ASSERT(r, start < end && end - start <= SkTMax(grain, 1));
+                for (int i = start; i < end; i++) {
+                    hits[i]++;
+                }
+            });
+            tg.wait();
+            for (const auto& hit : hits) {
+                REPORTER_ASSERT(r, 1 == hit.load());
+            }
+            REPORTER_ASSERT(r, (N ? (N - 1) / SkTMax(grain, 1) + 1 : 0) == calls.load());
+        }
+    }
+}
+
+// Work waiting on a pool's only thread starts in priority order.
+static void test_priorities(skiatest::Reporter* r, SkExecutor& executor) {
+    using Priority = SkExecutor::Priority;
+    SkSemaphore blocked, started, finished;
+    SkMutex mutex;
+    std::vector<Priority> order;
+
+    SkTaskGroup tg(executor);
+    tg.add([&] {
+        started.signal();
+        blocked.wait();
+    });
+    started.wait();
+    for (Priority priority : { Priority::kBackground, Priority::kNormal,
+                               Priority::kFrameCritical, Priority::kNormal }) {
+        tg.add([&, priority] {
+            SkAutoMutexAcquire lock(mutex);
+            order.push_back(priority);
+            finished.signal();
+        }, priority);
+    }
+    blocked.signal();
+    // Unlike tg.wait(), this doesn't borrow work, so it all runs in order on the pool's thread.
+    for (int i = 0; i < 4; i++) {
+        finished.wait();
+    }
+    tg.wait();
+
+    REPORTER_ASSERT(r, 4 == order.size());
+    REPORTER_ASSERT(r, Priority::kFrameCritical == order[0]);
+    REPORTER_ASSERT(r, Priority::kNormal == order[1] && Priority::kNormal == order[2]);
+    REPORTER_ASSERT(r, Priority::kBackground == order[3]);
+}
+
+DEF_TEST(Executor_ThreadPools, r) {
+    for (int threads : { 1, 2, 4 }) {
+        test_executor(r, *SkExecutor::MakeFIFOThreadPool(threads));
+        test_executor(r, *SkExecutor::MakeLIFOThreadPool(threads));
+        test_executor(r, *SkExecutor::MakeWorkStealingPool(threads));
+        test_parallel_for(r, *SkExecutor::MakeFIFOThreadPool(threads));
+        test_parallel_for(r, *SkExecutor::MakeWorkStealingPool(threads));
+    }
+    test_priorities(r, *SkExecutor::MakeFIFOThreadPool(1));
+    test_priorities(r, *SkExecutor::MakeLIFOThreadPool(1));
+    test_priorities(r, *SkExecutor::MakeWorkStealingPool(1));
+}
+
+DEF_TEST(Executor_WorkStealingPoolShutdown, r) {
+    // Pools must be able to shut down whether they're idle or not.
+    for (int i = 0; i < 20; i++) {
+        SkExecutor::MakeWorkStealingPool(4);
+    }
+    std::atomic<int> count{0};
+    for (int i = 0; i < 20; i++) {
+        auto pool = SkExecutor::MakeWorkStealingPool(4);
+        pool->add([&] {
+            count++;
+            SkTaskGroup tg(*pool);
+            tg.batch(100, [&](int) { count++; });
+        });
+    }
+    REPORTER_ASSERT(r, 20 * 101 == count.load());
+}
@@ -5,7 +5,12 @@
  * found in the LICENSE file.
  */
 
+#include "SkBitmap.h"
+#include "SkCanvas.h"
+#include "SkColorSpace.h"
+#include "SkHalf.h"
 #include "SkRasterPipeline.h"
+#include "SkShader.h"
 #include "Test.h"
 
 DEF_TEST(F16Stages, r) {
@@ -51,3 +56,50 @@ DEF_TEST(F16Stages, r) {
     REPORTER_ASSERT(r, floats[6] ==  1.25f);
     REPORTER_ASSERT(r, floats[7] ==  2.00f);
 }
+
+DEF_TEST(F16ConstantColorBlits, r) {
+    // Solid colors drawn into premul F16 skip the pipeline, blending a precomputed dst-gamut color.
+    // They should match the same color coming from a (non-constant) image shader.
+    SkBitmap src;
+    src.allocN32Pixels(1, 1);
+    src.eraseColor(SkColorSetRGB(200, 100, 50));
+    sk_sp<SkShader> shader = SkShader::MakeBitmapShader(src, SkShader::kRepeat_TileMode,
+                                                        SkShader::kRepeat_TileMode);
+
+    for (auto dstCS : { SkColorSpace::MakeSRGBLinear(),
+                        SkColorSpace::MakeRGB(SkColorSpace::kLinear_RenderTargetGamma,
+                                              SkColorSpace::kRec2020_Gamut) }) {
+        auto info = SkImageInfo::Make(64, 64, kRGBA_F16_SkColorType, kPremul_SkAlphaType, dstCS);
+        SkBitmap fast, slow;
+        fast.allocPixels(info);
+        slow.allocPixels(info);
+
+        for (SkBlendMode mode : { SkBlendMode::kSrcOver, SkBlendMode::kSrc }) {
+            for (bool aa : { false, true }) {
+                auto draw = [&](SkBitmap* bm, bool useShader) {
+                    SkCanvas canvas(*bm);
+                    canvas.clear(SkColorSetRGB(30, 60, 90));
+                    SkPaint paint;
+                    paint.setAntiAlias(aa);
+                    paint.setBlendMode(mode);
+                    paint.setColor(SkColorSetARGB(128, 200, 100, 50));
+                    if (useShader) {
+                        paint.setShader(shader);
+                    }
+                    canvas.drawRect(SkRect::MakeXYWH(3.5f, 2.25f, 40, 50), paint);
+                    canvas.drawCircle(40.3f, 30.7f, 20, paint);
+                };
+                draw(&fast, false);
+                draw(&slow, true);
+
+                for (int y = 0; y < 64; ++y)
+                for (int x = 0; x < 64; ++x) {
+                    Sk4f a = SkHalfToFloat_finite_ftz(*fast.pixmap().addr64(x, y)),
+                         b = SkHalfToFloat_finite_ftz(*slow.pixmap().addr64(x, y));
+                    // Allow a couple ulps at the scale of these values.
+                    REPORTER_ASSERT(r, ((a - b).abs() <= 1/512.0f).allTrue());
+                }
+            }
+        }
+    }
+}
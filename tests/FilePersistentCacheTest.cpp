@@ -0,0 +1,175 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Test.h"
+
+#if SK_SUPPORT_GPU
+
+#include "SkExecutor.h"
+#include "SkFilePersistentCache.h"
+#include "SkOSFile.h"
+#include "SkOSPath.h"
+
+// Makes an empty directory for a test's cache.
+static SkString make_cache_dir(const char name[]) {
+    SkString tmpDir = skiatest::GetTmpDir();
+    if (tmpDir.isEmpty()) {
+        return SkString();
+    }
+    SkString dir = SkOSPath::Join(tmpDir.c_str(), name);
+    SkString filename;
+    for (SkOSFile::Iter iter(dir.c_str()); iter.next(&filename);) {
+        remove(SkOSPath::Join(dir.c_str(), filename.c_str()).c_str());
+    }
+    return dir;
+}
+
+static sk_sp<SkData> make_data(const char prefix[], int i, size_t size = 100) {
+    auto data = SkData::MakeUninitialized(size);
+    memset(data->writable_data(), i, size);
+    memcpy(data->writable_data(), prefix, strlen(prefix));
+    return data;
+}
+
+static bool loads(SkFilePersistentCache* cache, const SkData& key, const SkData& expected) {
+    sk_sp<SkData> data = cache->load(key);
+    return data && data->equals(&expected);
+}
+
+DEF_TEST(FilePersistentCache_Basic, reporter) {
+    SkString dir = make_cache_dir("FilePersistentCache_Basic");
+    if (dir.isEmpty()) {
+        return;
+    }
+    auto key = make_data("key", 1), data = make_data("data", 2, 1000);
+    {
+        auto cache = SkFilePersistentCache::Make(dir.c_str());
+        REPORTER_ASSERT(reporter, cache);
+        REPORTER_ASSERT(reporter, !cache->load(*key));
+        cache->store(*key, *data);
+        REPORTER_ASSERT(reporter, loads(cache.get(), *key, *data));
+        REPORTER_ASSERT(reporter, !cache->load(*make_data("key", 3)));
+        REPORTER_ASSERT(reporter, 1 == cache->count());
+    }
+
+    // A later cache in the same directory finds the entry.
+    auto cache = SkFilePersistentCache::Make(dir.c_str());
+    REPORTER_ASSERT(reporter, 1 == cache->count());
+    REPORTER_ASSERT(reporter, loads(cache.get(), *key, *data));
+
+    // Storing again replaces the entry.
+    auto newData = make_data("new data", 4);
+    cache->store(*key, *newData);
+    REPORTER_ASSERT(reporter, loads(cache.get(), *key, *newData));
+    REPORTER_ASSERT(reporter, 1 == cache->count());
+}
+
+DEF_TEST(FilePersistentCache_Damaged, reporter) {
+    SkString dir = make_cache_dir("FilePersistentCache_Damaged");
+    if (dir.isEmpty()) {
+        return;
+    }
+    auto key = make_data("key", 1), data = make_data("data", 2);
+    SkFilePersistentCache::Make(dir.c_str())->store(*key, *data);
+
+    // Flip a byte of the data in the entry's file.
+    SkString filename;
+    REPORTER_ASSERT(reporter, SkOSFile::Iter(dir.c_str(), ".skpc").next(&filename));
+    SkString path = SkOSPath::Join(dir.c_str(), filename.c_str());
+    sk_sp<SkData> contents = SkData::MakeFromFileName(path.c_str());
+    REPORTER_ASSERT(reporter, contents);
+    auto damaged = SkData::MakeWithCopy(contents->data(), contents->size());
+    static_cast<uint8_t*>(damaged->writable_data())[damaged->size() - 1] ^= 0xFF;
+    FILE* file = sk_fopen(path.c_str(), kWrite_SkFILE_Flag);
+    sk_fwrite(damaged->data(), damaged->size(), file);
+    sk_fclose(file);
+
+    auto cache = SkFilePersistentCache::Make(dir.c_str());
+    REPORTER_ASSERT(reporter, 1 == cache->count());
+    REPORTER_ASSERT(reporter, !cache->load(*key));
+    // The damaged file is deleted.
+    REPORTER_ASSERT(reporter, 0 == cache->count());
+    REPORTER_ASSERT(reporter, !sk_exists(path.c_str()));
+}
+
+DEF_TEST(FilePersistentCache_Evicts, reporter) {
+    SkString dir = make_cache_dir("FilePersistentCache_Evicts");
+    if (dir.isEmpty()) {
+        return;
+    }
+    SkFilePersistentCache::Options options;
+    sk_sp<SkData> keys[4], data[4];
+    for (int i = 0; i < 4; ++i) {
+        keys[i] = make_data("key", i);
+        data[i] = make_data("data", i);
+    }
+    {
+        auto cache = SkFilePersistentCache::Make(dir.c_str(), options);
+        cache->store(*keys[0], *data[0]);
+        options.fMaxBytes = cache->totalBytes() * 3;
+    }
+
+    auto cache = SkFilePersistentCache::Make(dir.c_str(), options);
+    cache->store(*keys[1], *data[1]);
+    cache->store(*keys[2], *data[2]);
+    // Using the first entry makes the second the least recently used.
+    REPORTER_ASSERT(reporter, loads(cache.get(), *keys[0], *data[0]));
+    cache->store(*keys[3], *data[3]);
+    REPORTER_ASSERT(reporter, 3 == cache->count());
+    REPORTER_ASSERT(reporter, cache->totalBytes() <= options.fMaxBytes);
+    REPORTER_ASSERT(reporter, !cache->load(*keys[1]));
+    for (int i : {0, 2, 3}) {
+        REPORTER_ASSERT(reporter, loads(cache.get(), *keys[i], *data[i]));
+    }
+
+    // Too big to ever fit.
+    cache->store(*make_data("big key", 5), *make_data("big data", 5, options.fMaxBytes));
+    REPORTER_ASSERT(reporter, 3 == cache->count());
+
+    // A lower limit evicts when the directory is scanned.
+    options.fMaxBytes /= 3;
+    cache = SkFilePersistentCache::Make(dir.c_str(), options);
+    REPORTER_ASSERT(reporter, 1 == cache->count());
+}
+
+DEF_TEST(FilePersistentCache_WriteBehind, reporter) {
+    SkString dir = make_cache_dir("FilePersistentCache_WriteBehind");
+    if (dir.isEmpty()) {
+        return;
+    }
+    static constexpr int kNumEntries = 50;
+    auto executor = SkExecutor::MakeFIFOThreadPool(2);
+    SkFilePersistentCache::Options options;
+    options.fExecutor = executor.get();
+    {
+        auto cache = SkFilePersistentCache::Make(dir.c_str(), options);
+        for (int i = 0; i < kNumEntries; ++i) {
+            cache->store(*make_data("key", i), *make_data("data", i));
+            // Whether or not it has been written yet.
+            REPORTER_ASSERT(reporter, loads(cache.get(), *make_data("key", i),
+                                            *make_data("data", i)));
+        }
+        // Stores of the same key may be written in any order, but the last one wins.
+        for (int i = 0; i < 10; ++i) {
+            cache->store(*make_data("key", 0), *make_data("data", i));
+        }
+        cache->flush();
+        REPORTER_ASSERT(reporter, loads(cache.get(), *make_data("key", 0), *make_data("data", 9)));
+    }
+
+    auto cache = SkFilePersistentCache::Make(dir.c_str(), options);
+    REPORTER_ASSERT(reporter, kNumEntries == cache->count());
+    REPORTER_ASSERT(reporter, loads(cache.get(), *make_data("key", 0), *make_data("data", 9)));
+    for (int i = 1; i < kNumEntries; ++i) {
+        REPORTER_ASSERT(reporter, loads(cache.get(), *make_data("key", i), *make_data("data", i)));
+    }
+    // No temporary files are left.
+    SkString filename;
+    REPORTER_ASSERT(reporter, !SkOSFile::Iter(dir.c_str(), ".tmp").next(&filename));
+}
+
+#endif
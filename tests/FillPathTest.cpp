@@ -5,12 +5,20 @@
  * found in the LICENSE file.
  */
 
+#include "SkBitmap.h"
 #include "SkBlitter.h"
+#include "SkCanvas.h"
+#include "SkEdgeCache.h"
+#include "SkMatrix.h"
+#include "SkOpts.h"
 #include "SkPath.h"
+#include "SkRandom.h"
 #include "SkRegion.h"
 #include "SkScan.h"
 #include "Test.h"
 
+#include <atomic>
+
 struct FakeBlitter : public SkBlitter {
     FakeBlitter()
         : m_blitCount(0) { }
@@ -46,3 +54,127 @@ DEF_TEST(FillPathInverse, reporter) {
 
     REPORTER_ASSERT(reporter, blitter.m_blitCount == expected_lines);
 }
+
+extern std::atomic<bool> gSkUseAnalyticAA;
+extern std::atomic<bool> gSkForceAnalyticAA;
+extern std::atomic<bool> gSkUseDeltaAA;
+
+static SkBitmap draw_for_edge_cache(const SkPath& path, const SkMatrix& matrix, bool aa) {
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(64, 64);
+    bitmap.eraseColor(SK_ColorWHITE);
+    SkCanvas canvas(bitmap);
+    canvas.clipRect(SkRect::MakeXYWH(5, 3, 50, 55));
+    canvas.concat(matrix);
+    SkPaint paint;
+    paint.setAntiAlias(aa);
+    canvas.drawPath(path, paint);
+    return bitmap;
+}
+
+// Fills that find their device path and edges in SkEdgeCache must match fills that build them.
+DEF_TEST(FillPath_EdgeCache, reporter) {
+    SkPath path;
+    path.moveTo(30, 2);
+    for (int i = 1; i < 8; i++) {
+        SkScalar angle = i * SK_ScalarPI * 4 / 7;
+        SkPoint p = { 30 + 28 * SkScalarSin(angle), 30 - 28 * SkScalarCos(angle) };
+        if (i % 3 == 0) {
+            path.cubicTo(p.fX + 9, p.fY - 4, p.fX - 7, p.fY + 6, p.fX, p.fY);
+        } else if (i % 3 == 1) {
+            path.quadTo(p.fX + 5, p.fY + 5, p.fX, p.fY);
+        } else {
+            path.lineTo(p);
+        }
+    }
+    path.close();
+    path.addCircle(30, 30, 6);
+    REPORTER_ASSERT(reporter, SkEdgeCache::WorthCaching(path));
+
+    SkMatrix scale = SkMatrix::MakeScale(1.5f, 1.25f);
+    scale.postTranslate(-12.5f, -3.25f);
+    SkPath devPath, devPath2;
+    SkEdgeCache::TransformPath(path, scale, &devPath);
+    SkEdgeCache::TransformPath(path, scale, &devPath2);
+    REPORTER_ASSERT(reporter, devPath.getGenerationID() == devPath2.getGenerationID());
+    path.transform(scale, &devPath2);
+    REPORTER_ASSERT(reporter, devPath == devPath2);
+
+    // Non-AA, analytic AA and supersampled AA each build their own edges.
+    const bool useAnalyticAA = gSkUseAnalyticAA,
+               forceAnalyticAA = gSkForceAnalyticAA,
+               useDeltaAA = gSkUseDeltaAA;
+    gSkUseDeltaAA = false;
+    for (int mode = 0; mode < 3; mode++) {
+        gSkUseAnalyticAA = gSkForceAnalyticAA = (mode == 1);
+        for (auto fillType : { SkPath::kWinding_FillType, SkPath::kInverseEvenOdd_FillType }) {
+            path.setFillType(fillType);
+            SkPath volatilePath(path);
+            volatilePath.setIsVolatile(true);
+            for (const SkMatrix& matrix : { SkMatrix::I(), SkMatrix::MakeTrans(2.5f, 1), scale }) {
+                SkBitmap expected = draw_for_edge_cache(volatilePath, matrix, mode > 0);
+                // The first draw may cache the edges, the second finds them.
+                for (int i = 0; i < 2; i++) {
+                    SkBitmap actual = draw_for_edge_cache(path, matrix, mode > 0);
+                    REPORTER_ASSERT(reporter, 0 == memcmp(expected.getPixels(),
+                                                          actual.getPixels(),
+                                                          expected.computeByteSize()));
+                }
+            }
+        }
+    }
+    gSkUseAnalyticAA = useAnalyticAA;
+    gSkForceAnalyticAA = forceAnalyticAA;
+    gSkUseDeltaAA = useDeltaAA;
+}
+
+// The SkOpts kernels that accumulate analytic AA's coverage must match its scalar math exactly.
+DEF_TEST(FillPath_AlphaOpts, reporter) {
+    SkRandom rand;
+    for (int count = 0; count < 80; count++) {
+        uint8_t alphas[80], deltas[80], actual[80];
+        for (int i = 0; i < count; i++) {
+            alphas[i] = rand.nextU() & 0xFF;
+            // Sums of at most 256, as add_alphas expects.
+            deltas[i] = rand.nextULessThan(257 - alphas[i] < 256 ? 257 - alphas[i] : 256);
+        }
+        uint8_t delta = rand.nextU() & 0xFF;
+
+        memcpy(actual, alphas, count);
+        SkOpts::add_alphas(actual, deltas, count);
+        for (int i = 0; i < count; i++) {
+            int sum = alphas[i] + deltas[i];
+            REPORTER_ASSERT(reporter, actual[i] == (sum == 256 ? 255 : sum));
+        }
+        memcpy(actual, alphas, count);
+        SkOpts::add_alphas_saturating(actual, alphas, count);
+        for (int i = 0; i < count; i++) {
+            REPORTER_ASSERT(reporter, actual[i] == SkTMin(255, 2 * alphas[i]));
+        }
+        memcpy(actual, alphas, count);
+        SkOpts::subtract_alphas_saturating(actual, deltas, count);
+        for (int i = 0; i < count; i++) {
+            REPORTER_ASSERT(reporter, actual[i] == SkTMax(0, alphas[i] - deltas[i]));
+        }
+        uint8_t expected[80];
+        for (int i = 0; i < count; i++) {
+            actual[i] = rand.nextULessThan(257 - delta);
+            int sum = actual[i] + delta;
+            expected[i] = sum == 256 ? 255 : sum;
+        }
+        SkOpts::add_alpha(actual, delta, count);
+        REPORTER_ASSERT(reporter, 0 == memcmp(actual, expected, count));
+        memcpy(actual, alphas, count);
+        SkOpts::add_alpha_saturating(actual, delta, count);
+        for (int i = 0; i < count; i++) {
+            REPORTER_ASSERT(reporter, actual[i] == SkTMin(255, alphas[i] + delta));
+        }
+
+        int32_t start = rand.nextULessThan(SK_Fixed1);
+        int32_t step = rand.nextRangeU(0, SK_Fixed1 / 2) - SK_Fixed1 / 4;
+        SkOpts::alpha_ramp(actual, count, start, step);
+        for (int i = 0; i < count; i++) {
+            REPORTER_ASSERT(reporter, actual[i] == (uint8_t)((start + i * step) >> 8));
+        }
+    }
+}
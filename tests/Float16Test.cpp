@@ -15,6 +15,7 @@
 #include "Test.h"
 
 #include <cmath>
+#include <vector>
 
 static bool is_denorm(uint16_t h) {
     return (h & 0x7fff) < 0x0400;
@@ -70,3 +71,30 @@ DEF_TEST(SkFloatToHalf_finite_ftz, r) {
                            actual == alternate || actual == alternate - 1);
     }
 }
+
+DEF_TEST(SkOpts_half_to_float, r) {
+    // Every finite half, in an odd count so the SIMD loops' tails are covered too.
+    std::vector<uint16_t> halfs;
+    for (uint32_t h = 0; h <= 0xffff; h++) {
+        if (is_finite(h)) {
+            halfs.push_back(h);
+        }
+    }
+    halfs.pop_back();
+    SkASSERT(halfs.size() % 8 == 7);
+
+    std::vector<float> floats(halfs.size());
+    SkOpts::half_to_float(floats.data(), halfs.data(), SkToInt(halfs.size()));
+    for (size_t i = 0; i < halfs.size(); i++) {
+        float expected = SkHalfToFloat(halfs[i]);
+        REPORTER_ASSERT(r, floats[i] == expected || (is_denorm(halfs[i]) && floats[i] == 0));
+    }
+
+    // Converting them back gives the same halfs, except that denorms may be flushed to zero.
+    std::vector<uint16_t> roundTrip(halfs.size());
+    SkOpts::float_to_half(roundTrip.data(), floats.data(), SkToInt(floats.size()));
+    for (size_t i = 0; i < halfs.size(); i++) {
+        uint16_t h = halfs[i];
+        REPORTER_ASSERT(r, roundTrip[i] == h || (is_denorm(h) && (roundTrip[i] & 0x7fff) == 0));
+    }
+}
@@ -9,9 +9,12 @@
 #include "SkAutoMalloc.h"
 #include "SkEndian.h"
 #include "SkFontStream.h"
+#include "SkGraphics.h"
 #include "SkOSFile.h"
 #include "SkPaint.h"
+#include "SkPath.h"
 #include "SkStream.h"
+#include "SkTaskGroup.h"
 #include "SkTypeface.h"
 #include "Test.h"
 
@@ -314,4 +317,37 @@ DEF_TEST(FontHost, reporter) {
     test_symbolfont(reporter);
 }
 
+// Creates many strikes of one typeface at once, which exercises the font host's locking, and
+// checks that they produce the same outlines as strikes created one at a time.
+DEF_TEST(FontHost_ThreadedScalers, reporter) {
+    sk_sp<SkTypeface> face = MakeResourceAsTypeface("fonts/Roboto-Regular.ttf");
+    if (!face) {
+        face = SkTypeface::MakeDefault();
+    }
+    static const char kText[] = "Hamburgefons";
+    static const int kStrikes = 32;
+    auto textPath = [&](int strike) {
+        SkPaint paint;
+        paint.setTypeface(face);
+        paint.setTextSize(SkIntToScalar(8 + strike));
+        SkPath path;
+        paint.getTextPath(kText, sizeof(kText) - 1, 0, 0, &path);
+        return path;
+    };
+
+    SkGraphics::PurgeFontCache();
+    SkPath expected[kStrikes];
+    for (int i = 0; i < kStrikes; ++i) {
+        expected[i] = textPath(i);
+    }
+
+    SkGraphics::PurgeFontCache();
+    SkTaskGroup::Enabler enabler(8);
+    SkPath actual[kStrikes];
+    SkTaskGroup().batch(kStrikes, [&](int i) { actual[i] = textPath(i); });
+    for (int i = 0; i < kStrikes; ++i) {
+        REPORTER_ASSERT(reporter, actual[i] == expected[i]);
+    }
+}
+
 // need tests for SkStrSearch
@@ -0,0 +1,91 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Resources.h"
+#include "SkFontMgr.h"
+#include "SkFontMgr_directory.h"
+#include "SkOSFile.h"
+#include "SkOSPath.h"
+#include "SkStream.h"
+#include "SkTypeface.h"
+#include "Test.h"
+
+static void check_same_fonts(skiatest::Reporter* reporter,
+                             SkFontMgr* expected, SkFontMgr* actual) {
+    REPORTER_ASSERT(reporter, expected->countFamilies() == actual->countFamilies());
+    for (int i = 0; i < SkTMin(expected->countFamilies(), actual->countFamilies()); ++i) {
+        SkString expectedName, actualName;
+        expected->getFamilyName(i, &expectedName);
+        actual->getFamilyName(i, &actualName);
+        REPORTER_ASSERT(reporter, expectedName == actualName);
+
+        sk_sp<SkFontStyleSet> expectedSet(expected->createStyleSet(i));
+        sk_sp<SkFontStyleSet> actualSet(actual->createStyleSet(i));
+        REPORTER_ASSERT(reporter, expectedSet->count() == actualSet->count());
+        for (int j = 0; j < SkTMin(expectedSet->count(), actualSet->count()); ++j) {
+            SkFontStyle expectedStyle, actualStyle;
+            expectedSet->getStyle(j, &expectedStyle, nullptr);
+            actualSet->getStyle(j, &actualStyle, nullptr);
+            REPORTER_ASSERT(reporter, expectedStyle == actualStyle);
+        }
+    }
+
+    // Fallback must find the same family whether or not the coverage came from the index.
+    const SkUnichar characters[] = { 'A', 0x2603, 0x1F600, 0x10FFFF };
+    for (SkUnichar character : characters) {
+        sk_sp<SkTypeface> expectedTf(
+                expected->matchFamilyStyleCharacter(nullptr, SkFontStyle(), nullptr, 0, character));
+        sk_sp<SkTypeface> actualTf(
+                actual->matchFamilyStyleCharacter(nullptr, SkFontStyle(), nullptr, 0, character));
+        REPORTER_ASSERT(reporter, SkToBool(expectedTf) == SkToBool(actualTf));
+        if (expectedTf && actualTf) {
+            SkString expectedName, actualName;
+            expectedTf->getFamilyName(&expectedName);
+            actualTf->getFamilyName(&actualName);
+            REPORTER_ASSERT(reporter, expectedName == actualName);
+
+            uint16_t glyph;
+            actualTf->charsToGlyphs(&character, SkTypeface::kUTF32_Encoding, &glyph, 1);
+            REPORTER_ASSERT(reporter, glyph != 0);
+        }
+    }
+}
+
+DEF_TEST(FontMgrCustomDirectory_Index, reporter) {
+    SkString tmpDir = skiatest::GetTmpDir();
+    if (tmpDir.isEmpty()) {
+        return;
+    }
+    SkString fontDir = GetResourcePath("fonts");
+    SkString indexPath = SkOSPath::Join(tmpDir.c_str(), "font_index");
+    remove(indexPath.c_str());
+
+    sk_sp<SkFontMgr> scanned(SkFontMgr_New_Custom_Directory(fontDir.c_str()));
+    if (scanned->countFamilies() < 2) {
+        return;  // No resources.
+    }
+
+    // Without an index, everything is scanned and the index is written.
+    sk_sp<SkFontMgr> indexing(SkFontMgr_New_Custom_Directory(fontDir.c_str(), indexPath.c_str()));
+    REPORTER_ASSERT(reporter, sk_exists(indexPath.c_str()));
+    check_same_fonts(reporter, scanned.get(), indexing.get());
+
+    // With an up to date index, nothing is scanned.
+    sk_sp<SkFontMgr> indexed(SkFontMgr_New_Custom_Directory(fontDir.c_str(), indexPath.c_str()));
+    check_same_fonts(reporter, scanned.get(), indexed.get());
+
+    // A broken index is ignored and replaced.
+    {
+        SkFILEWStream stream(indexPath.c_str());
+        stream.writeText("not an index");
+    }
+    sk_sp<SkFontMgr> reindexed(SkFontMgr_New_Custom_Directory(fontDir.c_str(),
+                                                              indexPath.c_str()));
+    check_same_fonts(reporter, scanned.get(), reindexed.get());
+    std::unique_ptr<SkStreamAsset> stream = SkStream::MakeFromFile(indexPath.c_str());
+    REPORTER_ASSERT(reporter, stream && stream->getLength() > 12);
+}
@@ -20,6 +20,7 @@
 #include "GrTexture.h"
 #include "SkMatrix.h"
 #include "SkPathPriv.h"
+#include "SkRRect.h"
 #include "SkRect.h"
 #include "sk_tool_utils.h"
 #include "ccpr/GrCoverageCountingPathRenderer.h"
@@ -285,6 +286,44 @@ class GrCCPRTest_parseEmptyPath : public CCPRTest {
 };
 DEF_CCPR_TEST(GrCCPRTest_parseEmptyPath)
 
+class GrCCPRTest_conics : public CCPRTest {
+    void onRun(skiatest::Reporter* reporter, CCPRPathDrawer& ccpr) override {
+        SkPath conicsPath;
+        conicsPath.addCircle(50, 50, 40);
+        conicsPath.addRRect(SkRRect::MakeRectXY(SkRect::MakeLTRB(10, 110, 90, 190), 20, 30));
+        conicsPath.moveTo(110, 10);
+        conicsPath.conicTo(190, 10, 190, 90, 5);  // An open contour, so it gets caps.
+        SkASSERT(SkPathPriv::ConicWeightCnt(conicsPath));
+
+        // Conics used to be rejected for strokes. Both fills and strokes should accept them now.
+        SkStrokeRec stroke(SkStrokeRec::kHairline_InitStyle);
+        stroke.setStrokeStyle(3);
+        for (SkPaint::Join join : {SkPaint::kMiter_Join, SkPaint::kRound_Join,
+                                   SkPaint::kBevel_Join}) {
+            for (SkPaint::Cap cap : {SkPaint::kButt_Cap, SkPaint::kRound_Cap,
+                                     SkPaint::kSquare_Cap}) {
+                stroke.setStrokeParams(cap, join, 4);
+                GrShape shape(conicsPath, GrStyle(stroke, nullptr));
+                SkIRect clipBounds = SkIRect::MakeWH(kCanvasSize, kCanvasSize);
+                GrPathRenderer::CanDrawPathArgs args;
+                args.fCaps = ccpr.ctx()->contextPriv().caps();
+                args.fClipConservativeBounds = &clipBounds;
+                args.fViewMatrix = &SkMatrix::I();
+                args.fShape = &shape;
+                args.fAAType = GrAAType::kCoverage;
+                args.fHasUserStencilSettings = false;
+                REPORTER_ASSERT(reporter, GrPathRenderer::CanDrawPath::kYes ==
+                                          ccpr.ccpr()->canDrawPath(args));
+            }
+        }
+
+        // This exercises the parsers' conic handling. It should not hit any asserts.
+        ccpr.drawPath(conicsPath);
+        ccpr.flush();
+    }
+};
+DEF_CCPR_TEST(GrCCPRTest_conics)
+
 // This test exercises CCPR's cache capabilities by drawing many paths with two different
 // transformation matrices. We then vary the matrices independently by whole and partial pixels,
 // and verify the caching behaved as expected.
@@ -395,6 +434,71 @@ class GrCCPRTest_cache : public CCPRTest {
 };
 DEF_CCPR_TEST(GrCCPRTest_cache)
 
+// This test verifies that with a nonzero fPathMaskCachingTolerance, cached masks survive subpixel
+// translates and small scale changes, but not changes beyond the tolerance.
+class GrCCPRTest_cacheTolerance : public CCPRTest {
+    void customizeOptions(GrMockOptions*, GrContextOptions* ctxOptions) override {
+        ctxOptions->fAllowPathMaskCaching = true;
+        ctxOptions->fPathMaskCachingTolerance = .5f;
+    }
+
+    void onRun(skiatest::Reporter* reporter, CCPRPathDrawer& ccpr) override {
+        using CacheStats = GrCoverageCountingPathRenderer::CacheStats;
+        static constexpr int kPathSize = 20;
+        static constexpr int kNumPaths = 200;
+
+        SkPath paths[kNumPaths];
+        for (int i = 0; i < kNumPaths; ++i) {
+            paths[i] = sk_tool_utils::make_star(SkRect::MakeIWH(kPathSize, kPathSize),
+                                                GrShape::kMaxKeyFromDataVerbCnt + 1 + i % 7, 3);
+        }
+
+        SkMatrix matrix = SkMatrix::MakeTrans(10, 10);
+        auto drawAll = [&]() -> CacheStats {
+            for (const SkPath& path : paths) {
+                ccpr.drawPath(path, matrix);
+            }
+            ccpr.flush();
+            return ccpr.ccpr()->lastFlushCacheStats();
+        };
+
+        // Two flushes to stash the masks, a third to copy them into the resource cache.
+        for (int i = 0; i < 3; ++i) {
+            drawAll();
+        }
+        CacheStats stats = drawAll();
+        REPORTER_ASSERT(reporter, kNumPaths == stats.fNumPaths);
+        REPORTER_ASSERT(reporter, kNumPaths == stats.fNumCachedPaths);
+        REPORTER_ASSERT(reporter, 0 == stats.fNumInexactHits);
+        REPORTER_ASSERT(reporter, 1 == stats.hitRate());
+
+        // Subpixel translate within the tolerance.
+        matrix.postTranslate(.3f, -.2f);
+        stats = drawAll();
+        REPORTER_ASSERT(reporter, kNumPaths == stats.fNumCachedPaths);
+        REPORTER_ASSERT(reporter, kNumPaths == stats.fNumInexactHits);
+
+        // More subpixel translate: the cached masks are now closest one pixel over.
+        matrix.postTranslate(.5f, -.6f);
+        stats = drawAll();
+        REPORTER_ASSERT(reporter, kNumPaths == stats.fNumCachedPaths);
+
+        // A small zoom.
+        matrix.postScale(1.005f, 1.005f);
+        stats = drawAll();
+        REPORTER_ASSERT(reporter, kNumPaths == stats.fNumCachedPaths);
+
+        // Too much zoom: every path has to be rendered again.
+        matrix.postScale(1.1f, 1.1f);
+        stats = drawAll();
+        REPORTER_ASSERT(reporter, kNumPaths == stats.fNumPaths);
+        REPORTER_ASSERT(reporter, 0 == stats.fNumCachedPaths);
+        REPORTER_ASSERT(reporter, 0 == stats.fNumCopiedPaths);
+        REPORTER_ASSERT(reporter, 0 == stats.hitRate());
+    }
+};
+DEF_CCPR_TEST(GrCCPRTest_cacheTolerance)
+
 class GrCCPRTest_unrefPerOpListPathsBeforeOps : public CCPRTest {
     void onRun(skiatest::Reporter* reporter, CCPRPathDrawer& ccpr) override {
         REPORTER_ASSERT(reporter, SkPathPriv::TestingOnly_unique(fPath));
@@ -44,8 +44,9 @@ public:
 
     static A* Create(SkRandom* r);
 
-    static void SetAllocator(size_t preallocSize, size_t minAllocSize) {
-        GrMemoryPool* pool = new GrMemoryPool(preallocSize, minAllocSize);
+    static void SetAllocator(size_t preallocSize, size_t minAllocSize,
+                             const GrMemoryPool::Options& options) {
+        GrMemoryPool* pool = new GrMemoryPool(preallocSize, minAllocSize, options);
         gPool.reset(pool);
     }
 
@@ -190,9 +191,16 @@ DEF_TEST(GrMemoryPool, reporter) {
     // number of iterations
     static const int kCheckPeriod = 500;
 
+    // plain bump allocation, and with free lists and warm blocks
+    GrMemoryPool::Options gOptions[2];
+    gOptions[1].fSizeClassFreeLists = true;
+    gOptions[1].fWarmBlockBytes = 1000 * sizeof(A);
+
     SkRandom r;
-    for (size_t s = 0; s < SK_ARRAY_COUNT(gSizes); ++s) {
-        A::SetAllocator(gSizes[s][0], gSizes[s][1]);
+    for (size_t s = 0; s < SK_ARRAY_COUNT(gSizes) * SK_ARRAY_COUNT(gOptions); ++s) {
+        A::SetAllocator(gSizes[s / SK_ARRAY_COUNT(gOptions)][0],
+                        gSizes[s / SK_ARRAY_COUNT(gOptions)][1],
+                        gOptions[s % SK_ARRAY_COUNT(gOptions)]);
         for (size_t c = 0; c < SK_ARRAY_COUNT(gCreateFraction); ++c) {
             SkTDArray<Rec> instanceRecs;
             for (int i = 0; i < kNumIters; ++i) {
@@ -318,3 +326,55 @@ DEF_TEST(GrMemoryPoolAPI, reporter) {
         REPORTER_ASSERT(reporter, pool.size() == hugeBlockSize + kMinAllocSize);
     }
 }
+
+DEF_TEST(GrMemoryPoolFreeLists, reporter) {
+    GrMemoryPool::Options options;
+    options.fSizeClassFreeLists = true;
+    options.fWarmBlockBytes = 4 * GrMemoryPool::kSmallestMinAllocSize;
+    GrMemoryPool pool(GrMemoryPool::kSmallestMinAllocSize, GrMemoryPool::kSmallestMinAllocSize,
+                      options);
+
+    // Releasing anything but the most recent allocation puts it in a free list, where the next
+    // allocation of the same size class finds it.
+    void* a = pool.allocate(100);
+    void* b = pool.allocate(20);
+    pool.release(a);
+    REPORTER_ASSERT(reporter, pool.allocate(99) == a);
+    REPORTER_ASSERT(reporter, pool.stats().fFreeListHits == 1);
+    void* c = pool.allocate(200);
+    REPORTER_ASSERT(reporter, c != a);
+    REPORTER_ASSERT(reporter, pool.stats().fFreeListHits == 1);
+    pool.release(a);
+    pool.release(b);
+    pool.release(c);
+    REPORTER_ASSERT(reporter, pool.isEmpty());
+
+    // Emptied blocks are kept warm, within the limit, and reused before new ones are made.
+    SkTArray<void*> allocations;
+    while (pool.stats().fBlocksCreated < 3) {
+        allocations.push_back(pool.allocate(200));
+    }
+    for (void* p : allocations) {
+        pool.release(p);
+    }
+    REPORTER_ASSERT(reporter, pool.isEmpty());
+    REPORTER_ASSERT(reporter, pool.size() == 0);
+    REPORTER_ASSERT(reporter, pool.stats().fWarmBytes == 3 * GrMemoryPool::kSmallestMinAllocSize);
+    allocations.reset();
+    for (int i = 0; i < 10; ++i) {
+        allocations.push_back(pool.allocate(200));
+    }
+    REPORTER_ASSERT(reporter, pool.stats().fBlocksCreated == 3);
+    REPORTER_ASSERT(reporter, pool.stats().fWarmBlockHits >= 2);
+    // Release out of order, so the blocks empty with their space in the free lists.
+    for (int i = 0; i < allocations.count(); i += 2) {
+        pool.release(allocations[i]);
+    }
+    for (int i = 1; i < allocations.count(); i += 2) {
+        pool.release(allocations[i]);
+    }
+    REPORTER_ASSERT(reporter, pool.isEmpty());
+
+    pool.purgeWarmBlocks();
+    REPORTER_ASSERT(reporter, pool.stats().fWarmBytes == 0);
+}
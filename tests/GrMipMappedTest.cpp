@@ -12,12 +12,14 @@
 #include "GrContext.h"
 #include "GrContextPriv.h"
 #include "GrGpu.h"
+#include "GrProxyProvider.h"
 #include "GrRenderTargetContext.h"
 #include "GrSemaphore.h"
 #include "GrSurfaceProxyPriv.h"
 #include "GrTexturePriv.h"
 #include "GrTextureProxy.h"
 #include "SkCanvas.h"
+#include "SkExecutor.h"
 #include "SkImage_Base.h"
 #include "SkGpuDevice.h"
 #include "SkPoint.h"
@@ -319,3 +321,44 @@ DEF_GPUTEST_FOR_RENDERING_CONTEXTS(Gr1x1TextureMipMappedTest, reporter, ctxInfo)
     surface->flush();
 }
 
+
+// The mip levels of an immutable bitmap are built on the context's executor and only uploaded
+// when the proxy is instantiated, as long as the pending upload budget allows it.
+DEF_GPUTEST(GrDeferredMipMapUploadTest, reporter, /* options */) {
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(2);
+
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(64, 64);
+    bitmap.eraseColor(SK_ColorBLUE);
+    SkBitmap mutableBitmap = bitmap;
+    bitmap.setImmutable();
+
+    for (size_t maxPendingBytes : {size_t(1 << 20), size_t(0)}) {
+        GrContextOptions options;
+        options.fExecutor = executor.get();
+        options.fMaxPendingMipMapUploadBytes = maxPendingBytes;
+        sk_sp<GrContext> context = GrContext::MakeMock(nullptr, options);
+        GrProxyProvider* proxyProvider = context->contextPriv().proxyProvider();
+
+        for (const SkBitmap* bm : {&bitmap, &mutableBitmap}) {
+            sk_sp<GrTextureProxy> proxy = proxyProvider->createDeferredMipMapProxyFromBitmap(*bm);
+            REPORTER_ASSERT(reporter, proxy);
+            if (!proxy) {
+                continue;
+            }
+            REPORTER_ASSERT(reporter, GrMipMapped::kYes == proxy->mipMapped());
+
+            bool deferred = GrSurfaceProxy::LazyState::kNot != proxy->lazyInstantiationState();
+            REPORTER_ASSERT(reporter, deferred == (bm->isImmutable() && maxPendingBytes > 0));
+            if (deferred) {
+                REPORTER_ASSERT(reporter, proxy->priv().doLazyInstantiation(
+                                                  context->contextPriv().resourceProvider()));
+            }
+            GrTexture* texture = proxy->peekTexture();
+            REPORTER_ASSERT(reporter, texture);
+            if (texture) {
+                REPORTER_ASSERT(reporter, GrMipMapped::kYes == texture->texturePriv().mipMapped());
+            }
+        }
+    }
+}
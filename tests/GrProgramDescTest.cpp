@@ -0,0 +1,95 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Test.h"
+
+#include "GrAppliedClip.h"
+#include "GrContext.h"
+#include "GrContextPriv.h"
+#include "GrDefaultGeoProcFactory.h"
+#include "GrPaint.h"
+#include "GrPipeline.h"
+#include "GrProcessorSet.h"
+#include "GrProgramDesc.h"
+#include "GrRenderTargetContext.h"
+#include "effects/GrConstColorProcessor.h"
+
+static std::unique_ptr<GrPipeline> make_pipeline(GrContext* context, GrRenderTargetContext* rtc,
+                                                 int fpDepth) {
+    GrPaint paint;
+    auto fp = GrConstColorProcessor::Make({0.5f, 0.5f, 0.5f, 1},
+                                          GrConstColorProcessor::InputMode::kModulateRGBA);
+    for (int i = 1; i < fpDepth; ++i) {
+        fp = GrFragmentProcessor::MulChildByInputAlpha(std::move(fp));
+    }
+    paint.addColorFragmentProcessor(std::move(fp));
+    paint.setXPFactory(GrPorterDuffXPFactory::Get(SkBlendMode::kSrcOver));
+
+    const GrCaps& caps = *context->contextPriv().caps();
+    GrProcessorSet set(std::move(paint));
+    SkPMColor4f overrideColor = SK_PMColor4fWHITE;
+    set.finalize(GrProcessorAnalysisColor::Opaque::kNo, GrProcessorAnalysisCoverage::kNone,
+                 nullptr, false, caps, &overrideColor);
+
+    GrPipeline::InitArgs args;
+    args.fProxy = rtc->asRenderTargetProxy();
+    args.fCaps = &caps;
+    args.fResourceProvider = context->contextPriv().resourceProvider();
+    return std::unique_ptr<GrPipeline>(new GrPipeline(args, std::move(set), GrAppliedClip()));
+}
+
+static bool build_desc(GrContext* context, const GrPrimitiveProcessor& primProc,
+                       const GrPipeline& pipeline, GrProgramDesc* desc) {
+    if (!GrProgramDesc::Build(desc, primProc, false, pipeline, context->contextPriv().getGpu())) {
+        return false;
+    }
+    desc->finalize();
+    return true;
+}
+
+// GrProgramDesc::Build() caches the processors' part of the key in the pipeline. Keys built from
+// the cache must match keys built from scratch.
+DEF_GPUTEST(GrProgramDesc_CachedProcessorKey, reporter, /*ctxInfo*/) {
+    auto context = GrContext::MakeMock(nullptr);
+    SkASSERT(context);
+    const GrCaps& caps = *context->contextPriv().caps();
+    auto rtc = context->contextPriv().makeDeferredRenderTargetContext(
+            caps.getBackendFormatFromColorType(kRGBA_8888_SkColorType), SkBackingFit::kExact, 64,
+            64, kRGBA_8888_GrPixelConfig, nullptr);
+    REPORTER_ASSERT(reporter, rtc);
+
+    using namespace GrDefaultGeoProcFactory;
+    SkMatrix matrix = SkMatrix::MakeScale(2);
+    auto gp = GrDefaultGeoProcFactory::Make(caps.shaderCaps(), Color(SK_PMColor4fWHITE),
+                                            Coverage::kSolid_Type,
+                                            LocalCoords::kUsePosition_Type, SkMatrix::I());
+    // This one's key differs from gp's, but the pipeline's part of the key should not.
+    auto otherGP = GrDefaultGeoProcFactory::Make(
+            caps.shaderCaps(), Color(Color::kPremulGrColorAttribute_Type),
+            Coverage::kAttribute_Type, LocalCoords(LocalCoords::kHasExplicit_Type, &matrix),
+            SkMatrix::I());
+
+    for (int depth : {1, 4}) {
+        auto pipeline = make_pipeline(context.get(), rtc.get(), depth);
+
+        GrProgramDesc first, second, other, fresh, otherFresh;
+        REPORTER_ASSERT(reporter, build_desc(context.get(), *gp, *pipeline, &first));
+        REPORTER_ASSERT(reporter, build_desc(context.get(), *gp, *pipeline, &second));
+        REPORTER_ASSERT(reporter, first == second);
+
+        REPORTER_ASSERT(reporter, build_desc(context.get(), *otherGP, *pipeline, &other));
+        REPORTER_ASSERT(reporter, !(other == first));
+        auto otherPipeline = make_pipeline(context.get(), rtc.get(), depth);
+        REPORTER_ASSERT(reporter, build_desc(context.get(), *otherGP, *otherPipeline,
+                                             &otherFresh));
+        REPORTER_ASSERT(reporter, other == otherFresh);
+
+        // And back to the first primitive processor.
+        REPORTER_ASSERT(reporter, build_desc(context.get(), *gp, *pipeline, &fresh));
+        REPORTER_ASSERT(reporter, first == fresh);
+    }
+}
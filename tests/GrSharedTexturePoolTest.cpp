@@ -0,0 +1,117 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Test.h"
+
+#include "GrBackendSurface.h"
+#include "GrContext.h"
+#include "GrContextPriv.h"
+#include "GrProxyProvider.h"
+#include "GrSharedTexturePool.h"
+#include "GrTexture.h"
+#include "GrTextureProxy.h"
+#include "SkImage.h"
+#include "mock/GrMockTypes.h"
+
+static sk_sp<GrContext> make_context(GrSharedTexturePool* pool) {
+    GrMockOptions mockOptions;
+    mockOptions.fCrossContextTextureSupport = true;
+    GrContextOptions ctxOptions;
+    ctxOptions.fSharedTexturePool = pool;
+    return GrContext::MakeMock(&mockOptions, ctxOptions);
+}
+
+static GrUniqueKey make_key(int id) {
+    static GrUniqueKey::Domain kDomain = GrUniqueKey::GenerateDomain();
+    GrUniqueKey key;
+    GrUniqueKey::Builder builder(&key, kDomain, 1);
+    builder[0] = id;
+    return key;
+}
+
+static sk_sp<GrTextureProxy> upload_keyed_texture(GrContext* context, const GrUniqueKey& key) {
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(32, 32);
+    bitmap.eraseColor(SK_ColorGREEN);
+    GrProxyProvider* proxyProvider = context->contextPriv().proxyProvider();
+    sk_sp<GrTextureProxy> proxy = proxyProvider->createTextureProxy(
+            SkImage::MakeRasterCopy(bitmap.pixmap()), kNone_GrSurfaceFlags, 1, SkBudgeted::kYes,
+            SkBackingFit::kExact);
+    if (proxy) {
+        proxyProvider->assignUniqueKeyToProxy(key, proxy.get());
+    }
+    return proxy;
+}
+
+static int mock_texture_id(GrTextureProxy* proxy) {
+    GrMockTextureInfo info;
+    if (!proxy->peekTexture()->getBackendTexture().getMockTextureInfo(&info)) {
+        return 0;
+    }
+    return info.fID;
+}
+
+DEF_GPUTEST(GrSharedTexturePool, reporter, /* options */) {
+    GrSharedTexturePool pool;
+    {
+        sk_sp<GrContext> owner = make_context(&pool);
+        sk_sp<GrContext> borrower = make_context(&pool);
+        const GrUniqueKey key = make_key(0);
+
+        sk_sp<GrTextureProxy> uploaded = upload_keyed_texture(owner.get(), key);
+        REPORTER_ASSERT(reporter, uploaded && uploaded->peekTexture());
+        REPORTER_ASSERT(reporter, 1 == pool.count());
+        REPORTER_ASSERT(reporter, pool.bytesUsed() > 0);
+
+        size_t bytesBefore;
+        borrower->getResourceCacheUsage(nullptr, &bytesBefore);
+
+        GrProxyProvider* proxyProvider = borrower->contextPriv().proxyProvider();
+        // A different origin can't reuse the published texture.
+        REPORTER_ASSERT(reporter, !proxyProvider->findOrCreateProxyByUniqueKey(
+                                          key, kBottomLeft_GrSurfaceOrigin));
+        sk_sp<GrTextureProxy> borrowed =
+                proxyProvider->findOrCreateProxyByUniqueKey(key, kTopLeft_GrSurfaceOrigin);
+        REPORTER_ASSERT(reporter, borrowed && borrowed->peekTexture());
+        if (borrowed && borrowed->peekTexture()) {
+            REPORTER_ASSERT(reporter,
+                            mock_texture_id(uploaded.get()) == mock_texture_id(borrowed.get()));
+
+            // The borrowed copy isn't counted against the borrowing context's budget.
+            size_t bytesAfter;
+            borrower->getResourceCacheUsage(nullptr, &bytesAfter);
+            REPORTER_ASSERT(reporter, bytesBefore == bytesAfter);
+        }
+
+        // The owning context doesn't borrow its own textures.
+        owner->contextPriv().proxyProvider()->removeUniqueKeyFromProxy(key, uploaded.get());
+        REPORTER_ASSERT(reporter, 0 == pool.count());
+        REPORTER_ASSERT(reporter, !owner->contextPriv().proxyProvider()->
+                                          findOrCreateProxyByUniqueKey(key,
+                                                                       kTopLeft_GrSurfaceOrigin));
+    }
+    REPORTER_ASSERT(reporter, 0 == pool.count());
+    REPORTER_ASSERT(reporter, 0 == pool.bytesUsed());
+
+    // A pool with room for one texture withdraws the least recently used one.
+    GrSharedTexturePool smallPool(32 * 32 * 4);
+    {
+        sk_sp<GrContext> owner = make_context(&smallPool);
+        sk_sp<GrTextureProxy> first = upload_keyed_texture(owner.get(), make_key(1));
+        REPORTER_ASSERT(reporter, 1 == smallPool.count());
+        sk_sp<GrTextureProxy> second = upload_keyed_texture(owner.get(), make_key(2));
+        REPORTER_ASSERT(reporter, 1 == smallPool.count());
+
+        sk_sp<GrContext> borrower = make_context(&smallPool);
+        GrProxyProvider* proxyProvider = borrower->contextPriv().proxyProvider();
+        REPORTER_ASSERT(reporter, !proxyProvider->findOrCreateProxyByUniqueKey(
+                                          make_key(1), kTopLeft_GrSurfaceOrigin));
+        REPORTER_ASSERT(reporter, proxyProvider->findOrCreateProxyByUniqueKey(
+                                          make_key(2), kTopLeft_GrSurfaceOrigin));
+    }
+    REPORTER_ASSERT(reporter, 0 == smallPool.count());
+}
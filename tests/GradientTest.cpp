@@ -7,6 +7,7 @@
 
 #include "SkCanvas.h"
 #include "SkColorPriv.h"
+#include "SkColorSpace.h"
 #include "SkColorShader.h"
 #include "SkGradientShader.h"
 #include "SkShader.h"
@@ -538,6 +539,71 @@ static void test_sweep_fuzzer(skiatest::Reporter*) {
     }
 }
 
+// Gradients with many stops either search them or draw from a resampled table.  Both should land
+// on the same colors as drawing the exact gradient at higher precision.
+static void test_many_stops(skiatest::Reporter* reporter) {
+    const int kStops = 40;
+    SkColor colors[kStops];
+    SkScalar pos[kStops];
+    for (int i = 0; i < kStops; ++i) {
+        // Unevenly spaced stops along a smooth curve, like a sampled colormap.
+        float u = (float)i / (kStops - 1),
+              t = u + 0.05f * sinf(u * 2 * SK_ScalarPI);
+        colors[i] = SkColorSetARGB(255, (U8CPU)(255 * t), (U8CPU)(255 * t * t), 128);
+        pos[i] = t;
+    }
+    // Linear gradients with more than two stops draw through their own context, not the stages.
+    const SkPoint center = { 0, 0 };
+    const SkScalar radius = 256;
+
+    auto cs = SkColorSpace::MakeSRGB();
+    SkImageInfo info8 = SkImageInfo::MakeN32Premul(256, 1, cs),
+                infoF16 = info8.makeColorType(kRGBA_F16_SkColorType);
+
+    SkPaint paint;
+    paint.setShader(SkGradientShader::MakeRadial(center, radius, colors, pos, kStops,
+                                                 SkShader::kClamp_TileMode));
+    SkBitmap fast, exact;
+    fast.allocPixels(info8);
+    exact.allocPixels(info8);
+    // Draw twice, to cover a table found in the cache.
+    for (int i = 0; i < 2; ++i) {
+        auto surface8 = SkSurface::MakeRaster(info8),
+             surfaceF16 = SkSurface::MakeRaster(infoF16);
+        surface8->getCanvas()->drawPaint(paint);
+        surfaceF16->getCanvas()->drawPaint(paint);
+        surface8->readPixels(fast, 0, 0);
+        surfaceF16->readPixels(exact, 0, 0);
+
+        int maxDiff = 0;
+        for (int x = 0; x < 256; ++x) {
+            SkColor a = fast.getColor(x, 0),
+                    b = exact.getColor(x, 0);
+            maxDiff = SkTMax(maxDiff, SkTAbs((int)SkColorGetR(a) - (int)SkColorGetR(b)));
+            maxDiff = SkTMax(maxDiff, SkTAbs((int)SkColorGetG(a) - (int)SkColorGetG(b)));
+            maxDiff = SkTMax(maxDiff, SkTAbs((int)SkColorGetB(a) - (int)SkColorGetB(b)));
+        }
+        REPORTER_ASSERT(reporter, maxDiff <= 1, "max diff %d", maxDiff);
+    }
+
+    // Hard stops between bands of solid colors can't be resampled, and should stay sharp.
+    const int kBands = 20;
+    for (int i = 0; i < kBands; ++i) {
+        colors[2 * i] = colors[2 * i + 1] = SkColorSetARGB(255, 10 * i, 255 - 10 * i, 7 * i);
+        pos[2 * i] = (float)i / kBands;
+        pos[2 * i + 1] = (float)(i + 1) / kBands;
+    }
+    paint.setShader(SkGradientShader::MakeRadial(center, radius, colors, pos, 2 * kBands,
+                                                 SkShader::kClamp_TileMode));
+    auto surface8 = SkSurface::MakeRaster(info8);
+    surface8->getCanvas()->drawPaint(paint);
+    surface8->readPixels(fast, 0, 0);
+    for (int i = 0; i < kBands; ++i) {
+        int x = (int)((i + 0.5f) * 256 / kBands);
+        REPORTER_ASSERT(reporter, fast.getColor(x, 0) == colors[2 * i]);
+    }
+}
+
 DEF_TEST(Gradient, reporter) {
     TestGradientShaders(reporter);
     TestGradientOptimization(reporter);
@@ -551,4 +617,5 @@ DEF_TEST(Gradient, reporter) {
     test_degenerate_linear(reporter);
     test_linear_fuzzer(reporter);
     test_sweep_fuzzer(reporter);
+    test_many_stops(reporter);
 }
@@ -8,7 +8,9 @@
 #include "SkChecksum.h"
 #include "SkRefCnt.h"
 #include "SkString.h"
+#include "SkRandom.h"
 #include "SkTHash.h"
+#include "SkTSwissHash.h"
 #include "Test.h"
 
 // Tests use of const foreach().  map.count() is of course the better way to do this.
@@ -177,3 +179,101 @@ DEF_TEST(HashSetCopyCounter, r) {
     // We allow copies for same-value adds for now.
     REPORTER_ASSERT(r, globalCounter == 5);
 }
+
+// Checks SkTSwissHashMap against SkTHashMap through enough sets and removes to resize, reuse
+// deleted slots and rehash them away, with keys from a range small enough to collide often.
+template <typename HashK>
+static void check_swiss_hash_map(skiatest::Reporter* r, uint32_t keyRange) {
+    SkTSwissHashMap<uint32_t, sk_sp<SkRefCnt>, HashK> swiss;
+    SkTHashMap<uint32_t, sk_sp<SkRefCnt>> expected;
+    SkRandom rand;
+    for (int i = 0; i < 20000; i++) {
+        uint32_t key = rand.nextULessThan(keyRange);
+        if (rand.nextBool() || !expected.find(key)) {
+            auto val = sk_make_sp<SkRefCnt>();
+            swiss.set(key, val);
+            expected.set(key, val);
+        } else {
+            swiss.remove(key);
+            expected.remove(key);
+        }
+        if (i % 1000 == 0) {
+            REPORTER_ASSERT(r, swiss.count() == expected.count());
+            int found = 0;
+            for (uint32_t k = 0; k < keyRange; k++) {
+                sk_sp<SkRefCnt>* s = swiss.find(k);
+                sk_sp<SkRefCnt>* e = expected.find(k);
+                REPORTER_ASSERT(r, SkToBool(s) == SkToBool(e));
+                if (s && e) {
+                    REPORTER_ASSERT(r, s->get() == e->get());
+                    found++;
+                }
+            }
+            REPORTER_ASSERT(r, found == expected.count());
+            int visited = 0;
+            swiss.foreach([&](uint32_t k, sk_sp<SkRefCnt>* v) {
+                REPORTER_ASSERT(r, expected.find(k) && expected.find(k)->get() == v->get());
+                visited++;
+            });
+            REPORTER_ASSERT(r, visited == expected.count());
+        }
+    }
+
+    // Removing everything leaves nothing behind, in particular no refs.
+    SkTArray<uint32_t> keys;
+    expected.foreach([&](uint32_t k, sk_sp<SkRefCnt>*) { keys.push_back(k); });
+    for (uint32_t k : keys) {
+        swiss.remove(k);
+        REPORTER_ASSERT(r, (*expected.find(k))->unique());
+    }
+    REPORTER_ASSERT(r, swiss.count() == 0);
+}
+
+struct CollidingHash {
+    uint32_t operator()(uint32_t k) const { return k & 0x10F; }  // Only 32 distinct hashes.
+};
+
+DEF_TEST(SwissHashMap, r) {
+    check_swiss_hash_map<SkGoodHash>(r, 10);
+    check_swiss_hash_map<SkGoodHash>(r, 1000);
+    check_swiss_hash_map<CollidingHash>(r, 300);
+
+    SkTSwissHashMap<int, double> map;
+    REPORTER_ASSERT(r, map.approxBytesUsed() == 0);
+    REPORTER_ASSERT(r, !map.find(0));
+    map.set(3, 4.0);
+    REPORTER_ASSERT(r, map.approxBytesUsed() > 0);
+    REPORTER_ASSERT(r, *map.find(3) == 4.0);
+    map.set(3, 5.0);
+    REPORTER_ASSERT(r, map.count() == 1 && *map.find(3) == 5.0);
+
+    // remove() doesn't move the other entries.
+    map.set(4, 6.0);
+    double* four = map.find(4);
+    map.remove(3);
+    REPORTER_ASSERT(r, map.find(4) == four);
+
+    SkTSwissHashMap<int, double> moved(std::move(map));
+    REPORTER_ASSERT(r, moved.count() == 1 && map.count() == 0);
+    moved.reset();
+    REPORTER_ASSERT(r, moved.count() == 0 && !moved.find(4));
+}
+
+DEF_TEST(SwissHashSet, r) {
+    SkTSwissHashSet<SkString> set;
+
+    set.add(SkString("Hello"));
+    set.add(SkString("World"));
+    REPORTER_ASSERT(r, set.count() == 2);
+    REPORTER_ASSERT(r, set.contains(SkString("Hello")));
+    REPORTER_ASSERT(r, set.contains(SkString("World")));
+    REPORTER_ASSERT(r, !set.contains(SkString("Goodbye")));
+    REPORTER_ASSERT(r, *set.find(SkString("Hello")) == SkString("Hello"));
+
+    set.remove(SkString("Hello"));
+    REPORTER_ASSERT(r, !set.contains(SkString("Hello")));
+    REPORTER_ASSERT(r, set.count() == 1);
+
+    set.reset();
+    REPORTER_ASSERT(r, set.count() == 0);
+}
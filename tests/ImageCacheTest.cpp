@@ -7,6 +7,7 @@
 
 #include "SkDiscardableMemory.h"
 #include "SkResourceCache.h"
+#include "SkTaskGroup.h"
 #include "Test.h"
 
 namespace {
@@ -150,3 +151,65 @@ DEF_TEST(ImageCache_doubleAdd, r) {
     REPORTER_ASSERT(r, cache.find(key, TestingRec::Visitor, &value));
     REPORTER_ASSERT(r, 2 == value || 3 == value);
 }
+
+namespace {
+struct CategoryRec : public TestingRec {
+    CategoryRec(const TestingKey& key, uint32_t value, const char* category)
+        : TestingRec(key, value), fCategory(category) {}
+
+    const char* getCategory() const override { return fCategory; }
+
+    const char* fCategory;
+};
+}
+
+DEF_TEST(ImageCache_categoryLimit, r) {
+    const size_t recSize = CategoryRec(TestingKey(0), 0, "").bytesUsed();
+    SkResourceCache cache(1000 * recSize);
+
+    // A few "image" recs, then lots of "mask" recs limited to 10 recs' worth.
+    for (int i = 0; i < 5; ++i) {
+        cache.add(new CategoryRec(TestingKey(i), i, "image"));
+    }
+    REPORTER_ASSERT(r, 0 == cache.setCategoryByteLimit("mask", 10 * recSize));
+    for (int i = 5; i < 500; ++i) {
+        cache.add(new CategoryRec(TestingKey(i), i, "mask"));
+    }
+    REPORTER_ASSERT(r, cache.getCategoryBytesUsed("mask") == 10 * recSize);
+    REPORTER_ASSERT(r, cache.getCategoryBytesUsed("image") == 5 * recSize);
+
+    // The newest masks and all of the images survived.
+    intptr_t value;
+    for (int i = 0; i < 5; ++i) {
+        REPORTER_ASSERT(r, cache.find(TestingKey(i), TestingRec::Visitor, &value));
+    }
+    REPORTER_ASSERT(r, cache.find(TestingKey(499), TestingRec::Visitor, &value));
+    REPORTER_ASSERT(r, !cache.find(TestingKey(100), TestingRec::Visitor, &value));
+
+    // Lowering the limit purges right away; removing it lets masks grow again.
+    REPORTER_ASSERT(r, 10 * recSize == cache.setCategoryByteLimit("mask", 4 * recSize));
+    REPORTER_ASSERT(r, cache.getCategoryBytesUsed("mask") == 4 * recSize);
+    cache.setCategoryByteLimit("mask", 0);
+    for (int i = 500; i < 520; ++i) {
+        cache.add(new CategoryRec(TestingKey(i), i, "mask"));
+    }
+    REPORTER_ASSERT(r, cache.getCategoryBytesUsed("mask") == 24 * recSize);
+}
+
+DEF_TEST(ImageCache_globalThreaded, r) {
+    // Hammer the (sharded) global cache from several threads; every rec should be findable right
+    // after it was added.
+    SkTaskGroup().batch(8, [&](int thread) {
+        for (int i = 0; i < 1000; ++i) {
+            TestingKey key(thread * 1000 + i, 0xABC0 + thread);
+            SkResourceCache::Add(new TestingRec(key, i));
+            intptr_t value = -1;
+            REPORTER_ASSERT(r, SkResourceCache::Find(key, TestingRec::Visitor, &value));
+            REPORTER_ASSERT(r, value == i);
+        }
+    });
+
+    for (int thread = 0; thread < 8; ++thread) {
+        SkResourceCache::PostPurgeSharedID(0xABC0 + thread);
+    }
+}
@@ -8,11 +8,13 @@
 #include "Test.h"
 
 #include "SkBitmap.h"
+#include "SkBlurImageFilter.h"
 #include "SkColorFilter.h"
 #include "SkColorFilterImageFilter.h"
 #include "SkImage.h"
 #include "SkImageFilter.h"
 #include "SkImageFilterCache.h"
+#include "SkImageSource.h"
 #include "SkMatrix.h"
 #include "SkSpecialImage.h"
 
@@ -189,6 +191,109 @@ DEF_TEST(ImageFilterCache_ImageBackedRaster, reporter) {
     test_image_backed(reporter, srcImage);
 }
 
+// A result is found for any clip inside the one it was made for, or for any clip at all if it
+// was not cut by its clip.
+DEF_TEST(ImageFilterCache_ClipReuse, reporter) {
+    SkBitmap srcBM = create_bm();
+    sk_sp<SkSpecialImage> image(SkSpecialImage::MakeFromRaster(SkIRect::MakeWH(kFullSize,
+                                                                               kFullSize),
+                                                               srcBM));
+    sk_sp<SkImageFilterCache> cache(SkImageFilterCache::Create(1000000));
+    auto filter = make_filter();
+    auto key = [&](uint32_t id, const SkIRect& clip) {
+        return SkImageFilterCacheKey(id, SkMatrix::I(), clip, image->uniqueID(), image->subset());
+    };
+    const SkIRect clip = SkIRect::MakeWH(100, 100);
+    const SkIRect inside = SkIRect::MakeLTRB(10, 10, 50, 50);
+    const SkIRect bigger = SkIRect::MakeWH(200, 200);
+
+    SkIPoint offset = SkIPoint::Make(3, 4);
+    cache->set(key(0, clip), image.get(), offset, filter.get());
+    cache->set(key(1, clip), image.get(), offset, filter.get(), true);
+
+    SkIPoint foundOffset;
+    REPORTER_ASSERT(reporter, cache->get(key(0, clip), &foundOffset));
+    REPORTER_ASSERT(reporter, cache->get(key(0, inside), &foundOffset));
+    REPORTER_ASSERT(reporter, offset == foundOffset);
+    REPORTER_ASSERT(reporter, !cache->get(key(0, bigger), &foundOffset));
+    REPORTER_ASSERT(reporter, cache->get(key(1, bigger), &foundOffset));
+
+    SkImageFilterCache::Stats stats = cache->stats();
+    REPORTER_ASSERT(reporter, 3 == stats.fHits);
+    REPORTER_ASSERT(reporter, 1 == stats.fMisses);
+    REPORTER_ASSERT(reporter, 2 == stats.fClipReuseHits);
+
+    // A result for a different clip replaces the old one.
+    cache->set(key(0, bigger), image.get(), offset, filter.get());
+    SkDEBUGCODE(REPORTER_ASSERT(reporter, 2 == cache->count());)
+    REPORTER_ASSERT(reporter, cache->get(key(0, clip), &foundOffset));
+}
+
+static bool equal_pixels(SkSpecialImage* a, SkSpecialImage* b) {
+    SkBitmap bmA, bmB;
+    if (!a->getROPixels(&bmA) || !b->getROPixels(&bmB) || bmA.width() != bmB.width() ||
+        bmA.height() != bmB.height()) {
+        return false;
+    }
+    for (int y = 0; y < bmA.height(); ++y) {
+        if (memcmp(bmA.getAddr32(0, y), bmB.getAddr32(0, y), bmA.width() * 4)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Filters that don't read the source reuse their results when the CTM moves by whole pixels.
+DEF_TEST(ImageFilterCache_ReusedUnderTranslation, reporter) {
+    SkBitmap bm;
+    bm.allocN32Pixels(20, 20);
+    bm.eraseColor(SK_ColorRED);
+    auto filter = SkBlurImageFilter::Make(2, 2, SkImageSource::Make(SkImage::MakeFromBitmap(bm)));
+    SkBitmap srcBM = create_bm();
+    sk_sp<SkSpecialImage> src(SkSpecialImage::MakeFromRaster(SkIRect::MakeWH(kFullSize,
+                                                                             kFullSize),
+                                                             srcBM));
+    sk_sp<SkImageFilterCache> cache(SkImageFilterCache::Create(1000000));
+    const SkIRect clip = SkIRect::MakeWH(100, 100);
+
+    auto filterAt = [&](SkImageFilterCache* cache, SkScalar dx, SkScalar dy,
+                        const SkIRect& clip, SkIPoint* offset) {
+        SkImageFilter::OutputProperties props(kN32_SkColorType, nullptr);
+        SkImageFilter::Context ctx(SkMatrix::MakeTrans(dx, dy), clip, cache, props);
+        return filter->filterImage(src.get(), ctx, offset);
+    };
+
+    SkIPoint offset;
+    sk_sp<SkSpecialImage> first = filterAt(cache.get(), 10, 10, clip, &offset);
+    REPORTER_ASSERT(reporter, first);
+    SkImageFilterCache::Stats stats = cache->stats();
+
+    // Scrolled, with the viewport's clip.
+    SkIPoint scrolledOffset;
+    sk_sp<SkSpecialImage> scrolled = filterAt(cache.get(), 30, 5, clip, &scrolledOffset);
+    REPORTER_ASSERT(reporter, scrolled == first);
+    REPORTER_ASSERT(reporter, scrolledOffset == offset + SkIVector::Make(20, -5));
+    REPORTER_ASSERT(reporter, stats.fHits + 1 == cache->stats().fHits);
+
+    SkIPoint freshOffset;
+    sk_sp<SkSpecialImage> fresh = filterAt(nullptr, 30, 5, clip, &freshOffset);
+    REPORTER_ASSERT(reporter, freshOffset == scrolledOffset);
+    REPORTER_ASSERT(reporter, equal_pixels(fresh.get(), scrolled.get()));
+
+    // A different fractional translation is a different result.
+    stats = cache->stats();
+    filterAt(cache.get(), 30.5f, 5, clip, &offset);
+    REPORTER_ASSERT(reporter, stats.fHits == cache->stats().fHits);
+
+    // Scrolled partly out of the clip, the result is cut and only found for clips inside its own.
+    cache.reset(SkImageFilterCache::Create(1000000));
+    sk_sp<SkSpecialImage> cut = filterAt(cache.get(), -10, 0, clip, &offset);
+    stats = cache->stats();
+    REPORTER_ASSERT(reporter, cut == filterAt(cache.get(), -5, 0, clip.makeOffset(5, 0), &offset));
+    REPORTER_ASSERT(reporter, cut != filterAt(cache.get(), -5, 0, clip, &offset));
+    REPORTER_ASSERT(reporter, stats.fHits + 1 == cache->stats().fHits);
+}
+
 #include "GrContext.h"
 #include "GrContextPriv.h"
 #include "GrProxyProvider.h"
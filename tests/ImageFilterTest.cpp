@@ -9,6 +9,7 @@
 #include "SkBitmap.h"
 #include "SkBlurImageFilter.h"
 #include "SkCanvas.h"
+#include "SkColorFilter.h"
 #include "SkColorFilterImageFilter.h"
 #include "SkColorMatrixFilter.h"
 #include "SkColorSpaceXformer.h"
@@ -2043,3 +2044,95 @@ DEF_TEST(ImageSourceBounds, reporter) {
                                                              &input));
 }
 
+
+// Filtering a raster draw one tile at a time should give the same pixels as filtering it at once.
+DEF_TEST(ImageFilterTiledDraw, reporter) {
+    auto blur = SkBlurImageFilter::Make(6.0f, 6.0f, nullptr);
+    auto tint = SkColorFilterImageFilter::Make(
+            SkColorFilter::MakeModeFilter(SK_ColorBLUE, SkBlendMode::kSrcIn), blur);
+    sk_sp<SkImageFilter> inputs[2] = { tint, SkOffsetImageFilter::Make(15, 15, blur) };
+    SkPaint paint;
+    paint.setImageFilter(SkMergeImageFilter::Make(inputs, 2));
+
+    auto draw = [&](SkBitmap* bitmap, int tileSize) {
+        bitmap->allocN32Pixels(200, 200);
+        bitmap->eraseColor(SK_ColorWHITE);
+        gSkImageFilterTileSize = tileSize;
+        SkCanvas canvas(*bitmap);
+        canvas.clipRect(SkRect::MakeLTRB(5, 5, 190, 170));
+        canvas.drawRect(SkRect::MakeLTRB(30, 40, 150, 120), paint);
+        gSkImageFilterTileSize = 0;
+    };
+
+    SkBitmap whole, tiled;
+    draw(&whole, 0);
+    draw(&tiled, 32);
+    for (int y = 0; y < 200; ++y) {
+        if (memcmp(whole.getAddr32(0, y), tiled.getAddr32(0, y), 200 * sizeof(uint32_t))) {
+            ERRORF(reporter, "Tiled filtering differs on row %d", y);
+            return;
+        }
+    }
+}
+
+static sk_sp<SkColorFilter> make_rgb_scale(float scale) {
+    SkScalar matrix[20] = { scale, 0,     0,     0, 0,
+                            0,     scale, 0,     0, 0,
+                            0,     0,     scale, 0, 0,
+                            0,     0,     0,     1, 0 };
+    return SkColorFilter::MakeMatrixFilterRowMajor255(matrix);
+}
+
+// Filters that change nothing are dropped when they are made, leaving their inputs.
+DEF_TEST(ImageFilterDropsNoOps, reporter) {
+    auto blur = SkBlurImageFilter::Make(2, 2, nullptr);
+    REPORTER_ASSERT(reporter, blur == SkOffsetImageFilter::Make(0, 0, blur));
+    REPORTER_ASSERT(reporter, blur == SkImageFilter::MakeMatrixFilter(SkMatrix::I(),
+                                                                      kLow_SkFilterQuality,
+                                                                      blur));
+    // Without an input, they still filter the source.
+    REPORTER_ASSERT(reporter, SkOffsetImageFilter::Make(0, 0, nullptr));
+
+    // Color matrices that undo each other.
+    auto darken = SkColorFilterImageFilter::Make(make_rgb_scale(0.5f), blur);
+    REPORTER_ASSERT(reporter, blur == SkColorFilterImageFilter::Make(make_rgb_scale(2), darken));
+    REPORTER_ASSERT(reporter, blur != SkColorFilterImageFilter::Make(make_rgb_scale(0.5f),
+                                                                     darken));
+
+    SkImageFilter::CropRect cropRect(SkRect::MakeWH(10, 10));
+    REPORTER_ASSERT(reporter, blur != SkOffsetImageFilter::Make(0, 0, blur, &cropRect));
+}
+
+// Drawing with a filter that just offsets the source matches drawing it moved by whole pixels.
+DEF_TEST(ImageFilterOffsetDraw, reporter) {
+    auto draw = [](SkBitmap* bitmap, const SkMatrix& ctm, const SkIVector& devOffset,
+                   sk_sp<SkImageFilter> filter) {
+        bitmap->allocN32Pixels(100, 100);
+        bitmap->eraseColor(SK_ColorWHITE);
+        SkCanvas canvas(*bitmap);
+        canvas.clipRect(SkRect::MakeLTRB(5, 5, 90, 80));
+        canvas.translate(SkIntToScalar(devOffset.fX), SkIntToScalar(devOffset.fY));
+        canvas.concat(ctm);
+        SkPaint paint;
+        paint.setAntiAlias(true);
+        paint.setColor(0x80FF0000);
+        paint.setImageFilter(std::move(filter));
+        canvas.drawCircle(30, 30, 20.5f, paint);
+    };
+
+    for (const SkMatrix& ctm : {SkMatrix::I(), SkMatrix::MakeScale(1.5f),
+                                SkMatrix::MakeTrans(0.25f, 0.5f)}) {
+        SkBitmap filtered, moved;
+        draw(&filtered, ctm, {0, 0}, SkOffsetImageFilter::Make(7.6f, -3, nullptr));
+        // The offset is rounded to whole pixels in device space.
+        SkVector devOffset = ctm.mapVector(7.6f, -3);
+        draw(&moved, ctm, {SkScalarRoundToInt(devOffset.fX), SkScalarRoundToInt(devOffset.fY)},
+             nullptr);
+        for (int y = 0; y < 100; ++y) {
+            if (memcmp(filtered.getAddr32(0, y), moved.getAddr32(0, y), 100 * sizeof(uint32_t))) {
+                ERRORF(reporter, "Offset draw differs on row %d", y);
+                break;
+            }
+        }
+    }
+}
@@ -5,15 +5,20 @@
  * found in the LICENSE file.
  */
 
+#include <atomic>
+#include <chrono>
 #include <functional>
 #include <initializer_list>
+#include <thread>
 #include <vector>
 
 #include "SkAutoPixmapStorage.h"
 #include "SkBitmap.h"
 #include "SkCanvas.h"
 #include "SkColorSpacePriv.h"
+#include "SkColorSpaceXformCanvas.h"
 #include "SkData.h"
+#include "SkExecutor.h"
 #include "SkImageEncoder.h"
 #include "SkImageGenerator.h"
 #include "SkImage_Base.h"
@@ -22,9 +27,11 @@
 #include "SkPicture.h"
 #include "SkPictureRecorder.h"
 #include "SkRRect.h"
+#include "SkResourceCache.h"
 #include "SkSerialProcs.h"
 #include "SkStream.h"
 #include "SkSurface.h"
+#include "SkTaskGroup.h"
 #include "SkUtils.h"
 #include "Test.h"
 
@@ -453,6 +460,45 @@ DEF_GPUTEST_FOR_RENDERING_CONTEXTS(SkImage_makeTextureImage, reporter, contextIn
     }
 }
 
+// makeTextureImageAsync() hands out images whose textures are only uploaded by the flush that
+// draws them, and which draws of the raster source share.
+DEF_GPUTEST(SkImage_makeTextureImageAsync, reporter, /* options */) {
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(2);
+    for (SkExecutor* exec : { (SkExecutor*)nullptr, executor.get() }) {
+        GrContextOptions options;
+        options.fExecutor = exec;
+        sk_sp<GrContext> context = GrContext::MakeMock(nullptr, options);
+        auto surface = SkSurface::MakeRenderTarget(context.get(), SkBudgeted::kNo,
+                                                   SkImageInfo::MakeN32Premul(20, 20));
+
+        for (auto factory : { create_image, create_codec_image }) {
+            for (auto mipMapped : { GrMipMapped::kNo, GrMipMapped::kYes }) {
+                sk_sp<SkImage> image = factory();
+                sk_sp<SkImage> texImage = image->makeTextureImageAsync(context.get(), mipMapped);
+                REPORTER_ASSERT(reporter, texImage && texImage->isTextureBacked());
+                if (!texImage) {
+                    continue;
+                }
+                REPORTER_ASSERT(reporter, texImage->dimensions() == image->dimensions());
+                REPORTER_ASSERT(reporter, texImage->alphaType() == image->alphaType());
+                GrTextureProxy* proxy = as_IB(texImage)->peekProxy();
+                REPORTER_ASSERT(reporter, mipMapped == proxy->mipMapped());
+                REPORTER_ASSERT(reporter, !proxy->isInstantiated());
+
+                if (!image->isLazyGenerated()) {
+                    // The raster image finds the pending upload rather than making another.
+                    sk_sp<SkImage> sameTexImage = image->makeTextureImage(context.get(), nullptr);
+                    REPORTER_ASSERT(reporter, as_IB(sameTexImage)->peekProxy() == proxy);
+                    surface->getCanvas()->drawImage(image, 0, 0);
+                }
+                surface->getCanvas()->drawImage(texImage, 0, 0);
+                surface->flush();
+                REPORTER_ASSERT(reporter, proxy->isInstantiated());
+            }
+        }
+    }
+}
+
 DEF_GPUTEST_FOR_RENDERING_CONTEXTS(SkImage_makeNonTextureImage, reporter, contextInfo) {
     GrContext* context = contextInfo.grContext();
 
@@ -637,6 +683,45 @@ DEF_TEST(ImageEmpty, reporter) {
                                                             skstd::make_unique<EmptyGenerator>()));
 }
 
+// Counts its decodes, and takes long enough over each that concurrent callers overlap it.
+class CountingGenerator : public SkImageGenerator {
+public:
+    CountingGenerator(std::atomic<int>* decodes)
+        : SkImageGenerator(SkImageInfo::MakeN32Premul(32, 32)), fDecodes(decodes) {}
+
+protected:
+    bool onGetPixels(const SkImageInfo& info, void* pixels, size_t rowBytes,
+                     const Options&) override {
+        fDecodes->fetch_add(1);
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        return SkPixmap(info, pixels, rowBytes).erase(SK_ColorBLUE);
+    }
+
+private:
+    std::atomic<int>* fDecodes;
+};
+
+DEF_TEST(Image_Lazy_DecodeOnce, reporter) {
+    std::atomic<int> decodes{0};
+    sk_sp<SkImage> image = SkImage::MakeFromGenerator(
+            skstd::make_unique<CountingGenerator>(&decodes));
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+
+    // Everyone asking at once should wait for the first decode rather than start their own.
+    const int kCallers = 8;
+    SkPMColor colors[kCallers] = { 0 };
+    SkTaskGroup(*executor).batch(kCallers, [&](int i) {
+        SkBitmap bitmap;
+        if (as_IB(image)->getROPixels(&bitmap)) {
+            colors[i] = *bitmap.getAddr32(0, 0);
+        }
+    });
+    for (SkPMColor color : colors) {
+        REPORTER_ASSERT(reporter, SkPreMultiplyColor(SK_ColorBLUE) == color);
+    }
+    REPORTER_ASSERT(reporter, 1 == decodes.load());
+}
+
 DEF_TEST(ImageDataRef, reporter) {
     SkImageInfo info = SkImageInfo::MakeN32Premul(1, 1);
     size_t rowBytes = info.minRowBytes();
@@ -1234,6 +1319,48 @@ DEF_TEST(Image_makeColorSpace, r) {
     REPORTER_ASSERT(r, almost_equal(0x77, SkGetPackedB32(*p3Bitmap.getAddr32(0, 0))));
 }
 
+// SkColorSpaceXformCanvas transforms an image it draws again and again only once, for any canvas.
+DEF_TEST(Image_makeColorSpace_cached, r) {
+    sk_sp<SkColorSpace> p3 = SkColorSpace::MakeRGB(SkColorSpace::kSRGB_RenderTargetGamma,
+                                                   SkColorSpace::kDCIP3_D65_Gamut);
+    SkBitmap bitmap;
+    bitmap.allocPixels(SkImageInfo::MakeS32(64, 64, kPremul_SkAlphaType));
+    bitmap.eraseColor(0xFF604020);
+    bitmap.setImmutable();
+    sk_sp<SkImage> image = SkImage::MakeFromBitmap(bitmap);
+
+    sk_sp<SkSurface> expected = SkSurface::MakeRasterN32Premul(64, 64);
+    expected->getCanvas()->drawImage(image->makeColorSpace(p3), 0, 0);
+
+    sk_sp<SkSurface> surfaces[2] = {
+        SkSurface::MakeRasterN32Premul(64, 64),
+        SkSurface::MakeRasterN32Premul(64, 64),
+    };
+    size_t bytesUsed = SkResourceCache::GetTotalBytesUsed();
+    for (int i = 0; i < 4; i++) {
+        std::unique_ptr<SkCanvas> canvas =
+                SkCreateColorSpaceXformCanvas(surfaces[i & 1]->getCanvas(), p3);
+        if (i & 2) {
+            canvas->drawBitmap(bitmap, 0, 0);
+        } else {
+            canvas->drawImage(image, 0, 0);
+        }
+        if (0 == i) {
+            REPORTER_ASSERT(r, SkResourceCache::GetTotalBytesUsed() >= bytesUsed + 64 * 64 * 4);
+            bytesUsed = SkResourceCache::GetTotalBytesUsed();
+        }
+        // The image has the bitmap's generation ID, so they share their transformed copy.
+        REPORTER_ASSERT(r, bytesUsed == SkResourceCache::GetTotalBytesUsed());
+
+        SkBitmap a, b;
+        a.allocN32Pixels(64, 64);
+        b.allocN32Pixels(64, 64);
+        REPORTER_ASSERT(r, expected->readPixels(a.pixmap(), 0, 0) &&
+                           surfaces[i & 1]->readPixels(b.pixmap(), 0, 0) &&
+                           0 == memcmp(a.getPixels(), b.getPixels(), a.computeByteSize()));
+    }
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
 static void make_all_premul(SkBitmap* bm) {
@@ -414,3 +414,29 @@ DEF_TEST(JSON_DOM_build, reporter) {
                                                             "]"
                                             "}");
 }
+
+DEF_TEST(JSON_LongStrings, reporter) {
+    // Strings are scanned a block of chars at a time: check terminators at every block offset.
+    for (size_t len = 0; len < 50; ++len) {
+        for (const char* terminator : { "\\n", "\\\"", "}", "]", "\x01" }) {
+            for (size_t pos = 0; pos <= len; ++pos) {
+                SkString str(len);
+                memset(str.writable_str(), 'x', len);
+                str.insert(pos, terminator);
+                const auto json = SkStringPrintf("[ \"%s\" ]", str.c_str());
+
+                DOM dom(json.c_str(), json.size());
+                const bool valid = terminator[0] != '\x01';
+                REPORTER_ASSERT(reporter, dom.root().is<NullValue>() != valid);
+                if (!valid) {
+                    continue;
+                }
+
+                const auto& a = dom.root().as<ArrayValue>();
+                REPORTER_ASSERT(reporter, a.size() == 1 && a[0].is<StringValue>());
+                const size_t unescaped_len = len + (terminator[0] == '\\' ? 1 : strlen(terminator));
+                REPORTER_ASSERT(reporter, a[0].as<StringValue>().size() == unescaped_len);
+            }
+        }
+    }
+}
@@ -0,0 +1,118 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkBitmap.h"
+#include "SkCanvas.h"
+#include "SkImage.h"
+#include "SkLatticeIter.h"
+#include "Test.h"
+
+DEF_TEST(LatticeIter_NinePatch, reporter) {
+    SkIRect src, center;
+    SkLatticeIter nine(20, 10, SkIRect::MakeLTRB(4, 3, 15, 8), SkRect::MakeWH(100, 50));
+    REPORTER_ASSERT(reporter, nine.isNinePatch(&src, &center));
+    REPORTER_ASSERT(reporter, SkIRect::MakeWH(20, 10) == src);
+    REPORTER_ASSERT(reporter, SkIRect::MakeLTRB(4, 3, 15, 8) == center);
+
+    const SkIRect bounds = SkIRect::MakeLTRB(2, 1, 20, 10);
+    int xDivs[] = {4, 15};
+    int yDivs[] = {3, 8};
+    SkCanvas::Lattice lattice = {xDivs, yDivs, nullptr, 2, 2, &bounds, nullptr};
+    REPORTER_ASSERT(reporter,
+                    SkLatticeIter(lattice, SkRect::MakeWH(100, 50)).isNinePatch(&src, &center));
+    REPORTER_ASSERT(reporter, bounds == src);
+    REPORTER_ASSERT(reporter, SkIRect::MakeLTRB(4, 3, 15, 8) == center);
+
+    // A lattice whose first column is scalable isn't a nine-patch, nor is one with rect types.
+    xDivs[0] = 2;
+    REPORTER_ASSERT(reporter,
+                    !SkLatticeIter(lattice, SkRect::MakeWH(100, 50)).isNinePatch(&src, &center));
+    xDivs[0] = 4;
+    SkCanvas::Lattice::RectType types[9] = {};
+    SkColor colors[9] = {};
+    lattice.fRectTypes = types;
+    lattice.fColors = colors;
+    REPORTER_ASSERT(reporter,
+                    !SkLatticeIter(lattice, SkRect::MakeWH(100, 50)).isNinePatch(&src, &center));
+}
+
+DEF_TEST(LatticeIter_IntegerTranslate, reporter) {
+    const SkIRect center = SkIRect::MakeLTRB(4, 3, 15, 8);
+    REPORTER_ASSERT(reporter, SkLatticeIter(20, 10, center, SkRect::MakeXYWH(5, 6, 20, 10))
+                                      .isIntegerTranslate(3, -2));
+    REPORTER_ASSERT(reporter, !SkLatticeIter(20, 10, center, SkRect::MakeXYWH(5, 6, 20, 10))
+                                       .isIntegerTranslate(0.5f, 0));
+    REPORTER_ASSERT(reporter, !SkLatticeIter(20, 10, center, SkRect::MakeXYWH(5, 6, 21, 10))
+                                       .isIntegerTranslate(0, 0));
+}
+
+static SkBitmap make_source() {
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(20, 10);
+    for (int y = 0; y < bitmap.height(); ++y) {
+        for (int x = 0; x < bitmap.width(); ++x) {
+            *bitmap.getAddr32(x, y) = SkPreMultiplyARGB(0xFF, x * 12, y * 25, 0x80);
+        }
+    }
+    bitmap.setImmutable();
+    return bitmap;
+}
+
+// Unscaled lattices are blitted a patch at a time; they must match drawing the whole image.
+DEF_TEST(Lattice_UnscaledMatchesImage, reporter) {
+    const SkBitmap source = make_source();
+    const sk_sp<SkImage> image = SkImage::MakeFromBitmap(source);
+
+    SkBitmap expected, actual;
+    expected.allocN32Pixels(40, 30);
+    actual.allocN32Pixels(40, 30);
+    expected.eraseColor(SK_ColorBLUE);
+    SkCanvas(expected).drawBitmap(source, 11, 7);
+
+    const SkIRect center = SkIRect::MakeLTRB(4, 3, 15, 8);
+    const SkRect dst = SkRect::MakeXYWH(1, 2, 20, 10);
+    SkPaint paint;
+    paint.setFilterQuality(kLow_SkFilterQuality);
+    for (int i = 0; i < 2; ++i) {
+        actual.eraseColor(SK_ColorBLUE);
+        SkCanvas canvas(actual);
+        canvas.translate(10, 5);
+        if (0 == i) {
+            canvas.drawImageNine(image.get(), center, dst, &paint);
+        } else {
+            canvas.drawBitmapNine(source, center, dst, &paint);
+        }
+        for (int y = 0; y < actual.height(); ++y) {
+            REPORTER_ASSERT(reporter, !memcmp(expected.getAddr32(0, y), actual.getAddr32(0, y),
+                                              actual.width() * sizeof(uint32_t)));
+        }
+    }
+}
+
+// Fixed color patches of image lattices are still filled with their colors.
+DEF_TEST(Lattice_UnscaledFixedColor, reporter) {
+    const sk_sp<SkImage> image = SkImage::MakeFromBitmap(make_source());
+
+    int xDivs[] = {4, 15};
+    int yDivs[] = {3, 8};
+    SkCanvas::Lattice::RectType types[9] = {};
+    SkColor colors[9] = {};
+    types[4] = SkCanvas::Lattice::kFixedColor;
+    colors[4] = SK_ColorRED;
+    types[0] = SkCanvas::Lattice::kTransparent;
+    SkCanvas::Lattice lattice = {xDivs, yDivs, types, 2, 2, nullptr, colors};
+
+    SkBitmap actual;
+    actual.allocN32Pixels(20, 10);
+    actual.eraseColor(SK_ColorBLUE);
+    SkCanvas(actual).drawImageLattice(image.get(), lattice, SkRect::MakeWH(20, 10));
+
+    REPORTER_ASSERT(reporter, SK_ColorBLUE == actual.getColor(0, 0));
+    REPORTER_ASSERT(reporter, SK_ColorRED == actual.getColor(4, 3));
+    REPORTER_ASSERT(reporter, SK_ColorRED == actual.getColor(14, 7));
+    REPORTER_ASSERT(reporter, *make_source().getAddr32(19, 9) == *actual.getAddr32(19, 9));
+}
@@ -1066,3 +1066,53 @@ DEF_TEST(Matrix_maprects, r) {
         }
     }
 }
+
+// mapPoints() maps several points at a time; it should agree with mapping them one by one.
+DEF_TEST(Matrix_mapPoints, r) {
+    SkMatrix affine, persp;
+    affine.setRotate(30);
+    affine.postScale(2, 3);
+    affine.postTranslate(5, 7);
+    persp = affine;
+    persp.setPerspX(0.001f);
+    persp.setPerspY(-0.002f);
+
+    SkRandom rand;
+    SkPoint src[37];
+    for (SkPoint& p : src) {
+        p.set(rand.nextSScalar1() * 100, rand.nextSScalar1() * 100);
+    }
+
+    for (const SkMatrix& m : { affine, persp }) {
+        // Try every count and alignment, so we hit each batch size and its tail.
+        for (int count = 0; count <= 17; ++count)
+        for (int offset = 0; offset < 4; ++offset) {
+            SkPoint dst[37], inPlace[37];
+            m.mapPoints(dst, src + offset, count);
+            memcpy(inPlace, src + offset, count * sizeof(SkPoint));
+            m.mapPoints(inPlace, count);
+
+            for (int i = 0; i < count; ++i) {
+                SkPoint expected = m.mapXY(src[offset + i].fX, src[offset + i].fY);
+                // Allow for FMAs in the batched code.
+                const SkScalar tol = 1e-5f * SkTMax(1.0f, expected.length());
+                REPORTER_ASSERT(r, SkScalarNearlyEqual(dst[i].fX, expected.fX, tol));
+                REPORTER_ASSERT(r, SkScalarNearlyEqual(dst[i].fY, expected.fY, tol));
+                REPORTER_ASSERT(r, dst[i] == inPlace[i]);
+            }
+        }
+    }
+
+    // Points that map to w == 0 land at the origin, like they do one at a time.
+    SkPoint pts[9];
+    for (SkPoint& p : pts) {
+        p.set(1000, 0);
+    }
+    SkMatrix m;
+    m.setPerspX(-0.001f);
+    m.mapPoints(pts, SK_ARRAY_COUNT(pts));
+    for (const SkPoint& p : pts) {
+        REPORTER_ASSERT(r, p == m.mapXY(1000, 0));
+        REPORTER_ASSERT(r, p.isZero());
+    }
+}
@@ -0,0 +1,47 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkArenaAlloc.h"
+#include "SkCanvas.h"
+#include "SkGraphics.h"
+#include "SkPaint.h"
+#include "SkPath.h"
+#include "SkPictureRecorder.h"
+#include "SkRect.h"
+#include "Test.h"
+
+using MemoryCounters = SkGraphics::MemoryCounters;
+
+// Other tests run in parallel, so we can only check that our own allocations are accounted for.
+DEF_TEST(MemoryCounters, r) {
+    MemoryCounters counters;
+
+    SkPath path;
+    for (int i = 0; i < 10000; i++) {
+        path.lineTo(i, i);
+    }
+    SkArenaAlloc arena(0);
+    arena.makeArrayDefault<char>(100000);
+    sk_sp<SkPicture> picture;
+    {
+        SkPictureRecorder recorder;
+        SkCanvas* canvas = recorder.beginRecording(SkRect::MakeWH(100, 100));
+        for (int i = 0; i < 1000; i++) {
+            canvas->drawRect(SkRect::MakeXYWH(i % 100, i % 100, 10, 10), SkPaint());
+        }
+        picture = recorder.finishRecordingAsPicture();
+    }
+
+    SkGraphics::GetMemoryCounters(&counters);
+    REPORTER_ASSERT(r, counters.fBytes[MemoryCounters::kPathRef]    >= 10000 * sizeof(SkPoint));
+    REPORTER_ASSERT(r, counters.fBytes[MemoryCounters::kArenaAlloc] >= 100000);
+    REPORTER_ASSERT(r, counters.fBytes[MemoryCounters::kPicture]    >= 1000 * sizeof(SkRect));
+    for (int i = 0; i < MemoryCounters::kCounterCount; i++) {
+        REPORTER_ASSERT(r, counters.fPeakBytes[i] >= counters.fBytes[i]);
+        REPORTER_ASSERT(r, strlen(MemoryCounters::Name((MemoryCounters::Counter)i)) > 0);
+    }
+}
@@ -6,7 +6,9 @@
  */
 
 #include "SkBitmap.h"
+#include "SkHalf.h"
 #include "SkMipMap.h"
+#include "SkOpts.h"
 #include "SkRandom.h"
 #include "Test.h"
 
@@ -209,3 +211,81 @@ DEF_TEST(MipMap_F16, reporter) {
     bmp.eraseColor(0);
     sk_sp<SkMipMap> mipmap(SkMipMap::Build(bmp, nullptr));
 }
+
+// The SkOpts 2x2 filters should match a plain box filter: exactly for 8-bit channels, and to
+// within rounding of the result for F16.
+DEF_TEST(MipMap_Downsample_2_2, reporter) {
+    const int kCount = 37;  // Exercises both the SIMD loops and their tails.
+    SkRandom rand;
+
+    uint32_t src32[2][2 * kCount], dst32[kCount];
+    uint8_t  src8 [2][2 * kCount], dst8 [kCount];
+    uint64_t src16[2][2 * kCount], dst16[kCount];
+    for (int y = 0; y < 2; ++y) {
+        for (int x = 0; x < 2 * kCount; ++x) {
+            src32[y][x] = rand.nextU();
+            src8 [y][x] = (uint8_t)rand.nextU();
+            SkFloatToHalf_finite_ftz(Sk4f(rand.nextUScalar1(), rand.nextUScalar1(),
+                                          rand.nextUScalar1(), rand.nextUScalar1()))
+                    .store(&src16[y][x]);
+        }
+    }
+
+    SkOpts::downsample_2_2_8888(dst32, src32, sizeof(src32[0]), kCount);
+    SkOpts::downsample_2_2_a8  (dst8,  src8,  sizeof(src8 [0]), kCount);
+    SkOpts::downsample_2_2_f16 (dst16, src16, sizeof(src16[0]), kCount);
+
+    for (int i = 0; i < kCount; ++i) {
+        for (int c = 0; c < 4; ++c) {
+            auto channel = [&](int y, int x) { return (src32[y][x] >> (8 * c)) & 0xFF; };
+            uint32_t expected = (channel(0, 2*i) + channel(0, 2*i + 1) +
+                                 channel(1, 2*i) + channel(1, 2*i + 1)) >> 2;
+            REPORTER_ASSERT(reporter, ((dst32[i] >> (8 * c)) & 0xFF) == expected);
+        }
+
+        REPORTER_ASSERT(reporter, dst8[i] == (src8[0][2*i] + src8[0][2*i + 1] +
+                                              src8[1][2*i] + src8[1][2*i + 1]) >> 2);
+
+        Sk4f expected = (SkHalfToFloat_finite_ftz(src16[0][2*i]) +
+                         SkHalfToFloat_finite_ftz(src16[0][2*i + 1]) +
+                         SkHalfToFloat_finite_ftz(src16[1][2*i]) +
+                         SkHalfToFloat_finite_ftz(src16[1][2*i + 1])) * 0.25f;
+        Sk4f actual = SkHalfToFloat_finite_ftz(dst16[i]);
+        REPORTER_ASSERT(reporter, ((actual - expected).abs() <= 1/1024.0f).allTrue());
+    }
+}
+
+// Levels generated on demand should match the ones Build() makes up front.
+DEF_TEST(MipMap_Lazy, reporter) {
+    SkRandom rand;
+    for (SkColorType ct : { kN32_SkColorType, kAlpha_8_SkColorType, kRGBA_F16_SkColorType,
+                            kRGB_565_SkColorType }) {
+        SkBitmap bm;
+        bm.allocPixels(SkImageInfo::Make(301, 200, ct, kPremul_SkAlphaType));
+        for (int y = 0; y < bm.height(); ++y) {
+            uint8_t* row = (uint8_t*)bm.getAddr(0, y);
+            for (size_t i = 0; i < bm.info().minRowBytes(); ++i) {
+                // Keep F16 channels finite and small.
+                row[i] = kRGBA_F16_SkColorType == ct && (i & 1) ? 0x30 : (uint8_t)rand.nextU();
+            }
+        }
+
+        sk_sp<SkMipMap> eager(SkMipMap::Build(bm, nullptr));
+        sk_sp<SkMipMap> lazy(SkMipMap::Build(bm, nullptr, 1));
+        REPORTER_ASSERT(reporter, eager && lazy);
+        REPORTER_ASSERT(reporter, eager->countLevels() == lazy->countLevels());
+
+        // Ask for a deep level first, then for the rest.
+        SkMipMap::Level level;
+        REPORTER_ASSERT(reporter, lazy->extractLevel(SkSize::Make(0.1f, 0.1f), &level));
+        for (int i = 0; i < eager->countLevels(); ++i) {
+            SkMipMap::Level e, l;
+            REPORTER_ASSERT(reporter, eager->getLevel(i, &e) && lazy->getLevel(i, &l));
+            REPORTER_ASSERT(reporter, e.fPixmap.info() == l.fPixmap.info());
+            for (int y = 0; y < e.fPixmap.height(); ++y) {
+                REPORTER_ASSERT(reporter, !memcmp(e.fPixmap.addr(0, y), l.fPixmap.addr(0, y),
+                                                  e.fPixmap.info().minRowBytes()));
+            }
+        }
+    }
+}
@@ -0,0 +1,113 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkCanvas.h"
+#include "SkData.h"
+#include "SkDocument.h"
+#include "SkMultiPictureDocument.h"
+#include "SkPictureRecorder.h"
+#include "SkStream.h"
+#include "SkSurface.h"
+#include "Test.h"
+
+static const int kPageCount = 5;
+
+static SkSize page_size(int i) {
+    return SkSize::Make(40 + 4 * i, 30 + 2 * i);
+}
+
+static void draw_page(SkCanvas* canvas, int i) {
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    paint.setColor(SkColorSetARGB(0xFF, 40 * i, 0x80, 0xFF - 40 * i));
+    canvas->drawCircle(10 + 5 * i, 15, 8 + i, paint);
+    canvas->drawRect(SkRect::MakeXYWH(2 * i, 20, 12, 6), paint);
+}
+
+static bool draws_page(SkPicture* picture, int i) {
+    if (!picture) {
+        return false;
+    }
+    const SkISize size = page_size(i).toCeil();
+    sk_sp<SkSurface> expected = SkSurface::MakeRasterN32Premul(size.width(), size.height()),
+                     actual   = SkSurface::MakeRasterN32Premul(size.width(), size.height());
+    expected->getCanvas()->clear(SK_ColorWHITE);
+    actual->getCanvas()->clear(SK_ColorWHITE);
+    draw_page(expected->getCanvas(), i);
+    actual->getCanvas()->drawPicture(picture);
+
+    SkBitmap a, b;
+    a.allocN32Pixels(size.width(), size.height());
+    b.allocN32Pixels(size.width(), size.height());
+    return expected->readPixels(a.pixmap(), 0, 0) && actual->readPixels(b.pixmap(), 0, 0) &&
+           0 == memcmp(a.getPixels(), b.getPixels(), a.computeByteSize());
+}
+
+static sk_sp<SkData> make_document() {
+    SkDynamicMemoryWStream stream;
+    sk_sp<SkDocument> doc = SkMakeMultiPictureDocument(&stream);
+    for (int i = 0; i < kPageCount; i++) {
+        SkSize size = page_size(i);
+        draw_page(doc->beginPage(size.width(), size.height()), i);
+        doc->endPage();
+    }
+    doc->close();
+    return stream.detachAsData();
+}
+
+DEF_TEST(MultiPictureDocument_read, r) {
+    sk_sp<SkData> data = make_document();
+
+    SkMemoryStream stream(data);
+    REPORTER_ASSERT(r, kPageCount == SkMultiPictureDocumentReadPageCount(&stream));
+    SkDocumentPage pages[kPageCount];
+    REPORTER_ASSERT(r, SkMultiPictureDocumentRead(&stream, pages, kPageCount));
+    for (int i = 0; i < kPageCount; i++) {
+        REPORTER_ASSERT(r, pages[i].fSize == page_size(i));
+        REPORTER_ASSERT(r, draws_page(pages[i].fPicture.get(), i));
+    }
+
+    // The reader finds each page on its own, in any order.
+    auto reader = SkMultiPictureDocumentReader::Make(data);
+    REPORTER_ASSERT(r, reader && kPageCount == reader->pageCount());
+    for (int i = kPageCount - 1; reader && i >= 0; i -= 2) {
+        REPORTER_ASSERT(r, reader->pageSize(i) == page_size(i));
+        REPORTER_ASSERT(r, draws_page(reader->readPage(i).get(), i));
+    }
+
+    // A truncated document has no index to find the pages with.
+    REPORTER_ASSERT(r, !SkMultiPictureDocumentReader::Make(
+            SkData::MakeSubset(data.get(), 0, data->size() - 1)));
+}
+
+// Documents written before the pages were indexed hold all the pages in one picture.
+DEF_TEST(MultiPictureDocument_readSinglePicture, r) {
+    SkDynamicMemoryWStream stream;
+    stream.writeText("Skia Multi-Picture Doc\n\n");
+    stream.write32(2);
+    stream.write32(kPageCount);
+    for (int i = 0; i < kPageCount; i++) {
+        SkSize size = page_size(i);
+        stream.write(&size, sizeof(size));
+    }
+    SkPictureRecorder recorder;
+    SkCanvas* canvas = recorder.beginRecording(SkRect::MakeSize(page_size(kPageCount - 1)));
+    for (int i = 0; i < kPageCount; i++) {
+        SkPictureRecorder pageRecorder;
+        draw_page(pageRecorder.beginRecording(SkRect::MakeSize(page_size(i))), i);
+        canvas->drawPicture(pageRecorder.finishRecordingAsPicture());
+        canvas->drawAnnotation(SkRect::MakeEmpty(), "SkMultiPictureEndPage", nullptr);
+    }
+    recorder.finishRecordingAsPicture()->serialize(&stream);
+
+    auto reader = SkMultiPictureDocumentReader::Make(stream.detachAsData());
+    REPORTER_ASSERT(r, reader && kPageCount == reader->pageCount());
+    for (int i = 0; reader && i < kPageCount; i++) {
+        REPORTER_ASSERT(r, reader->pageSize(i) == page_size(i));
+        REPORTER_ASSERT(r, draws_page(reader->readPage(i).get(), i));
+    }
+}
@@ -239,3 +239,168 @@ DEF_GPUTEST(OpChainTest, reporter, /*ctxInfo*/) {
         }
     }
 }
+
+namespace {
+/**
+ * An op that writes its value into a single column of the result. Ops with the same 'kMerges'
+ * value are of the same type. If kMerges is true they always merge with each other, otherwise
+ * they never combine.
+ */
+template <bool kMerges> class ColumnOp : public GrOp {
+public:
+    DEFINE_OP_CLASS_ID
+
+    static std::unique_ptr<ColumnOp> Make(GrContext* context, int column, int result[]) {
+        GrOpMemoryPool* pool = context->contextPriv().opMemoryPool();
+        return pool->allocate<ColumnOp>(column, result);
+    }
+
+    const char* name() const override { return "ColumnOp"; }
+
+private:
+    friend class ::GrOpMemoryPool;  // for ctor
+
+    ColumnOp(int column, int result[]) : INHERITED(ClassID()), fResult(result) {
+        fColumns.push_back(column);
+        this->setBounds(SkRect::MakeXYWH(column, 0, 1, 1), HasAABloat::kNo, IsZeroArea::kNo);
+    }
+
+    void onPrepare(GrOpFlushState*) override {}
+
+    void onExecute(GrOpFlushState*, const SkRect& chainBounds) override {
+        for (int column : fColumns) {
+            fResult[column] = column;
+        }
+    }
+
+    CombineResult onCombineIfPossible(GrOp* t, const GrCaps&) override {
+        if (!kMerges) {
+            return CombineResult::kCannotCombine;
+        }
+        auto that = t->cast<ColumnOp>();
+        fColumns.insert(fColumns.end(), that->fColumns.begin(), that->fColumns.end());
+        return CombineResult::kMerged;
+    }
+
+    std::vector<int> fColumns;
+    int* fResult;
+
+    typedef GrOp INHERITED;
+};
+}  // namespace
+
+/**
+ * Ops that don't overlap anything in between should merge no matter how many ops of other types
+ * were recorded between them.
+ */
+DEF_GPUTEST(OpChainTest_MergeAcrossManyOps, reporter, /*ctxInfo*/) {
+    // Well beyond the number of ops that used to be searched.
+    static constexpr int kSpacing = 25;
+    static constexpr int kNumColumns = 4 * kSpacing;
+
+    auto context = GrContext::MakeMock(nullptr);
+    SkASSERT(context);
+    GrSurfaceDesc desc;
+    desc.fConfig = kRGBA_8888_GrPixelConfig;
+    desc.fWidth = kNumColumns;
+    desc.fHeight = 1;
+    desc.fFlags = kRenderTarget_GrSurfaceFlag;
+
+    const GrBackendFormat format =
+            context->contextPriv().caps()->getBackendFormatFromColorType(kRGBA_8888_SkColorType);
+
+    auto proxy = context->contextPriv().proxyProvider()->createProxy(
+            format, desc, kTopLeft_GrSurfaceOrigin, GrMipMapped::kNo, SkBackingFit::kExact,
+            SkBudgeted::kNo, GrInternalSurfaceFlags::kNone);
+    SkASSERT(proxy);
+    proxy->instantiate(context->contextPriv().resourceProvider());
+
+    GrAuditTrail* auditTrail = context->contextPriv().getAuditTrail();
+    GrAuditTrail::AutoEnable autoEnable(auditTrail);
+
+    int result[kNumColumns];
+    std::fill_n(result, kNumColumns, -1);
+    GrTokenTracker tracker;
+    GrOpFlushState flushState(context->contextPriv().getGpu(),
+                              context->contextPriv().resourceProvider(), &tracker, nullptr,
+                              nullptr);
+    GrRenderTargetOpList opList(context->contextPriv().resourceProvider(),
+                                sk_ref_sp(context->contextPriv().opMemoryPool()),
+                                proxy->asRenderTargetProxy(), auditTrail);
+    for (int x = 0; x < kNumColumns; ++x) {
+        if (x % kSpacing == 0) {
+            opList.addOp(ColumnOp<true>::Make(context.get(), x, result),
+                         *context->contextPriv().caps());
+        } else {
+            opList.addOp(ColumnOp<false>::Make(context.get(), x, result),
+                         *context->contextPriv().caps());
+        }
+    }
+    REPORTER_ASSERT(reporter, auditTrail->drawCallsSaved() == kNumColumns / kSpacing - 1);
+
+    opList.makeClosed(*context->contextPriv().caps());
+    opList.prepare(&flushState);
+    opList.execute(&flushState);
+    opList.endFlush();
+    for (int x = 0; x < kNumColumns; ++x) {
+        REPORTER_ASSERT(reporter, result[x] == x);
+    }
+    auditTrail->fullReset();
+}
+
+/**
+ * Ops that only draw inside the rect of a later op that replaces every pixel there are dropped,
+ * and the rest are kept.
+ */
+DEF_GPUTEST(OpChainTest_OccludedOps, reporter, /*ctxInfo*/) {
+    static constexpr int kNumColumns = 8;
+
+    auto context = GrContext::MakeMock(nullptr);
+    SkASSERT(context);
+    GrSurfaceDesc desc;
+    desc.fConfig = kRGBA_8888_GrPixelConfig;
+    desc.fWidth = kNumColumns;
+    desc.fHeight = 1;
+    desc.fFlags = kRenderTarget_GrSurfaceFlag;
+
+    const GrCaps& caps = *context->contextPriv().caps();
+    const GrBackendFormat format = caps.getBackendFormatFromColorType(kRGBA_8888_SkColorType);
+
+    auto proxy = context->contextPriv().proxyProvider()->createProxy(
+            format, desc, kTopLeft_GrSurfaceOrigin, GrMipMapped::kNo, SkBackingFit::kExact,
+            SkBudgeted::kNo, GrInternalSurfaceFlags::kNone);
+    SkASSERT(proxy);
+    proxy->instantiate(context->contextPriv().resourceProvider());
+
+    // The opaque op only writes column 3, but claims to hide columns 2 through 5, or all of them.
+    const SkRect partialRect = SkRect::MakeLTRB(2, 0, 6, 1);
+    const SkRect fullRect = SkRect::MakeIWH(kNumColumns, 1);
+    for (const SkRect* opaqueRect : {&partialRect, &fullRect}) {
+        int result[kNumColumns];
+        std::fill_n(result, kNumColumns, -1);
+        GrTokenTracker tracker;
+        GrOpFlushState flushState(context->contextPriv().getGpu(),
+                                  context->contextPriv().resourceProvider(), &tracker, nullptr,
+                                  nullptr);
+        GrRenderTargetOpList opList(context->contextPriv().resourceProvider(),
+                                    sk_ref_sp(context->contextPriv().opMemoryPool()),
+                                    proxy->asRenderTargetProxy(),
+                                    context->contextPriv().getAuditTrail());
+        for (int x = 0; x < kNumColumns; ++x) {
+            opList.addOp(ColumnOp<false>::Make(context.get(), x, result), caps);
+        }
+        opList.addOp(ColumnOp<false>::Make(context.get(), 3, result), caps, GrAppliedClip(),
+                     GrXferProcessor::DstProxy(), opaqueRect);
+        // Ops recorded after the opaque one are unaffected.
+        opList.addOp(ColumnOp<false>::Make(context.get(), 4, result), caps);
+
+        opList.makeClosed(caps);
+        opList.prepare(&flushState);
+        opList.execute(&flushState);
+        opList.endFlush();
+        for (int x = 0; x < kNumColumns; ++x) {
+            bool hidden = x != 3 && x != 4 && opaqueRect->contains(SkRect::MakeXYWH(x, 0, 1, 1));
+            REPORTER_ASSERT(reporter, result[x] == (hidden ? -1 : x));
+        }
+    }
+}
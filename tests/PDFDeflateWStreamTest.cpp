@@ -9,7 +9,9 @@
 
 #ifdef SK_SUPPORT_PDF
 
+#include "SkData.h"
 #include "SkDeflate.h"
+#include "SkExecutor.h"
 #include "SkRandom.h"
 #include "SkTo.h"
 
@@ -103,6 +105,27 @@ std::unique_ptr<SkStreamAsset> stream_inflate(skiatest::Reporter* reporter, SkSt
     }
     return decompressedDynamicMemoryWStream.detachAsStream();
 }
+
+/** Inflates all of src, a zlib or gzip stream, returning nullptr if it is not exactly one. */
+sk_sp<SkData> inflate_all(const SkData* src, size_t expectedSize) {
+    z_stream zStream;
+    sk_bzero(&zStream, sizeof(zStream));
+    zStream.zalloc = &skia_alloc_func;
+    zStream.zfree = &skia_free_func;
+    if (inflateInit2(&zStream, 15 + 32) != Z_OK) {  // Detect the header.
+        return nullptr;
+    }
+    sk_sp<SkData> dst = SkData::MakeUninitialized(expectedSize + 1);
+    zStream.next_in = (Bytef*)src->data();
+    zStream.avail_in = SkToUInt(src->size());
+    zStream.next_out = (Bytef*)dst->writable_data();
+    zStream.avail_out = SkToUInt(dst->size());
+    int rc = inflate(&zStream, Z_FINISH);
+    bool ok = Z_STREAM_END == rc && 0 == zStream.avail_in;
+    size_t size = zStream.total_out;
+    inflateEnd(&zStream);
+    return ok ? SkData::MakeSubset(dst.get(), 0, size) : nullptr;
+}
 }  // namespace
 
 DEF_TEST(SkPDF_DeflateWStream, r) {
@@ -167,4 +190,49 @@ DEF_TEST(SkPDF_DeflateWStream, r) {
     REPORTER_ASSERT(r, !emptyDeflateWStream.writeText("FOO"));
 }
 
+DEF_TEST(SkPDF_DeflateWStream_Parallel, r) {
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+
+    // Compressible data, with repeats far enough apart that they only help if each chunk's
+    // compressor knows about the data before it.
+    SkRandom random(654321);
+    const size_t kMaxSize = 5 * 1024 * 1024;
+    SkAutoTMalloc<uint8_t> buffer(kMaxSize);
+    for (size_t j = 0; j < kMaxSize; ++j) {
+        buffer[j] = j >= 1000 && random.nextU() % 4 ? buffer[j - 1000] : random.nextU() & 0x7;
+    }
+
+    for (size_t size : { (size_t)0, (size_t)1, (size_t)100000, (size_t)(128 * 1024),
+                         (size_t)(300 * 1024), kMaxSize }) {
+        for (bool gzip : { false, true }) {
+            SkDynamicMemoryWStream serial, parallel;
+            {
+                SkDeflateWStream deflateWStream(&serial, -1, gzip);
+                deflateWStream.write(buffer.get(), size);
+            }
+            {
+                SkDeflateWStream deflateWStream(&parallel, -1, gzip, executor.get());
+                size_t j = 0;
+                while (j < size) {
+                    size_t writeSize = SkTMin<size_t>(size - j, random.nextRangeU(1, 300000));
+                    REPORTER_ASSERT(r, deflateWStream.write(&buffer[j], writeSize));
+                    j += writeSize;
+                }
+                REPORTER_ASSERT(r, deflateWStream.bytesWritten() == size);
+            }
+            sk_sp<SkData> compressed = parallel.detachAsData();
+            sk_sp<SkData> decompressed = inflate_all(compressed.get(), size);
+            if (!decompressed) {
+                ERRORF(r, "Parallel deflate of %zu bytes (gzip %d) is not one stream.",
+                       size, gzip);
+                continue;
+            }
+            REPORTER_ASSERT(r, decompressed->size() == size &&
+                               0 == memcmp(decompressed->data(), buffer.get(), size));
+            // A little bigger than the serial stream, but not much.
+            REPORTER_ASSERT(r, compressed->size() <= serial.bytesWritten() * 21 / 20 + 64);
+        }
+    }
+}
+
 #endif
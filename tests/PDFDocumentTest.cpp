@@ -8,13 +8,19 @@
 
 #include "Resources.h"
 #include "SkCanvas.h"
+#include "SkExecutor.h"
 #include "SkOSFile.h"
 #include "SkOSPath.h"
 #include "SkPDFDocument.h"
 #include "SkStream.h"
+#include "SkSurface.h"
 
 #include "sk_tool_utils.h"
 
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
 static void test_empty(skiatest::Reporter* reporter) {
     SkDynamicMemoryWStream stream;
 
@@ -239,3 +245,127 @@ DEF_TEST(SkPDF_multiple_pages, r) {
                 SkColorSetARGB(0xFF, 0x00, (uint8_t)(255.0f * i / (n - 1)), 0x00));
     }
 }
+
+static sk_sp<SkImage> make_test_image(int i) {
+    auto surface = SkSurface::MakeRasterN32Premul(64, 64);
+    SkCanvas* canvas = surface->getCanvas();
+    canvas->clear(i % 2 ? SK_ColorTRANSPARENT : SK_ColorWHITE);
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    paint.setColor(SkColorSetARGB(0xFF, (uint8_t)(i * 37), 0x80, (uint8_t)(255 - i * 11)));
+    canvas->drawCircle(32, 32, SkIntToScalar(8 + i % 24), paint);
+    return surface->makeImageSnapshot();
+}
+
+static size_t make_multipage_pdf(SkWStream* stream, SkExecutor* executor) {
+    SkPDF::Metadata metadata;
+    metadata.fExecutor = executor;
+    auto doc = SkPDF::MakeDocument(stream, metadata);
+    SkPaint paint;
+    sk_tool_utils::set_portable_typeface(&paint);
+    for (int i = 0; i < 12; ++i) {
+        SkCanvas* canvas = doc->beginPage(612, 792);
+        canvas->drawColor(SkColorSetARGB(0xFF, 0x00, (uint8_t)(255.0f * i / 11), 0x00));
+        for (int j = 0; j < 4; ++j) {
+            canvas->drawImage(make_test_image(i * 4 + j), 50.0f + j * 70, 50.0f);
+        }
+        canvas->drawString("Hello, PDF.", 50, 200, paint);
+        doc->endPage();
+    }
+    doc->close();
+    return stream->bytesWritten();
+}
+
+// Work done on the executor may be written out in any order, but it must produce the same
+// objects with the same object numbers.
+DEF_TEST(SkPDF_multiple_pages_threaded, r) {
+    REQUIRE_PDF_DOCUMENT(SkPDF_multiple_pages_threaded, r);
+    SkDynamicMemoryWStream serialStream, threadedStream;
+    size_t serialSize = make_multipage_pdf(&serialStream, nullptr);
+
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+    size_t threadedSize = make_multipage_pdf(&threadedStream, executor.get());
+
+    REPORTER_ASSERT(r, serialSize > 0);
+    REPORTER_ASSERT(r, serialSize == threadedSize);
+}
+
+static int count_occurrences(const SkDynamicMemoryWStream& stream, const char* needle) {
+    std::vector<char> data(stream.bytesWritten());
+    stream.copyTo(data.data());
+    int count = 0;
+    size_t len = strlen(needle);
+    for (auto it = data.begin(); ; it += len, ++count) {
+        it = std::search(it, data.end(), needle, needle + len);
+        if (it == data.end()) {
+            return count;
+        }
+    }
+}
+
+// Page resources are written when the page ends, not when the document is closed.
+DEF_TEST(SkPDF_resources_written_per_page, r) {
+    REQUIRE_PDF_DOCUMENT(SkPDF_resources_written_per_page, r);
+    SkDynamicMemoryWStream stream;
+    auto doc = SkPDF::MakeDocument(&stream);
+
+    SkPaint paint;
+    paint.setShader(make_test_image(1)->makeShader(SkShader::kRepeat_TileMode,
+                                                   SkShader::kRepeat_TileMode));
+    for (int i = 0; i < 3; ++i) {
+        doc->beginPage(612, 792)->drawPaint(paint);
+        doc->endPage();
+        // The pattern is shared by all pages through the canon, so it is only written once.
+        REPORTER_ASSERT(r, count_occurrences(stream, "/PatternType") == 1);
+    }
+    doc->close();
+    REPORTER_ASSERT(r, count_occurrences(stream, "/PatternType") == 1);
+}
+
+static size_t make_text_pdf(SkWStream* stream, sk_sp<SkPDF::FontCache> fontCache) {
+    SkPDF::Metadata metadata;
+    metadata.fFontCache = std::move(fontCache);
+    auto doc = SkPDF::MakeDocument(stream, metadata);
+    SkPaint paint;
+    sk_tool_utils::set_portable_typeface(&paint);
+    doc->beginPage(612, 792)->drawString("Hello, PDF.", 50, 200, paint);
+    doc->close();
+    return stream->bytesWritten();
+}
+
+// Documents sharing a font cache must write the same fonts they would have written alone.
+DEF_TEST(SkPDF_font_cache, r) {
+    REQUIRE_PDF_DOCUMENT(SkPDF_font_cache, r);
+    sk_sp<SkPDF::FontCache> fontCache = SkPDF::FontCache::Make();
+    SkDynamicMemoryWStream uncached, first, second;
+    size_t uncachedSize = make_text_pdf(&uncached, nullptr);
+    size_t firstSize = make_text_pdf(&first, fontCache);
+    REPORTER_ASSERT(r, fontCache->bytesUsed() > 0);
+    size_t bytesUsed = fontCache->bytesUsed();
+    size_t secondSize = make_text_pdf(&second, fontCache);
+
+    REPORTER_ASSERT(r, uncachedSize == firstSize);
+    REPORTER_ASSERT(r, uncachedSize == secondSize);
+    // The second document found everything it needed already in the cache.
+    REPORTER_ASSERT(r, fontCache->bytesUsed() == bytesUsed);
+    fontCache->purgeAll();
+    REPORTER_ASSERT(r, fontCache->bytesUsed() == 0);
+}
+
+// Images with the same pixels are written once, even if they are different SkImages.
+DEF_TEST(SkPDF_image_content_dedupe, r) {
+    REQUIRE_PDF_DOCUMENT(SkPDF_image_content_dedupe, r);
+    SkDynamicMemoryWStream stream;
+    auto doc = SkPDF::MakeDocument(&stream);
+    SkBitmap bm;
+    bm.allocN32Pixels(16, 16);
+    bm.eraseColor(SK_ColorBLUE);
+    for (int i = 0; i < 3; ++i) {
+        SkCanvas* canvas = doc->beginPage(612, 792);
+        canvas->drawImage(SkImage::MakeRasterCopy(bm.pixmap()), 0, 0);
+        canvas->drawImage(make_test_image(2 * i), 100, 0);  // Opaque, so without a mask.
+        doc->endPage();
+    }
+    doc->close();
+    REPORTER_ASSERT(r, count_occurrences(stream, "/Subtype /Image") == 4);
+}
@@ -81,6 +81,7 @@ DEF_TEST(SkPDF_JpegEmbedTest, r) {
 #ifdef SK_SUPPORT_PDF
 
 #include "SkJpegInfo.h"
+#include "SkPngInfo.h"
 
 struct SkJFIFInfo {
     SkISize fSize;
@@ -254,4 +255,44 @@ DEF_TEST(SkPDF_JpegIdentification, r) {
         REPORTER_ASSERT(r, !SkIsJFIF(data.get(), &info));
     }
 }
+
+DEF_TEST(SkPDF_PngIdentification, r) {
+    static struct {
+        const char* path;
+        bool embeddable;
+        SkEncodedInfo::Color color;
+    } kTests[] = {{"images/mandrill_512.png", true, SkEncodedInfo::kRGB_Color},
+                  {"images/randPixels.png", true, SkEncodedInfo::kRGB_Color},
+                  {"images/color_wheel.png", false, SkEncodedInfo::kRGB_Color},     // alpha
+                  {"images/index8.png", false, SkEncodedInfo::kRGB_Color},          // palette
+                  {"images/plane_interlaced.png", false, SkEncodedInfo::kRGB_Color},
+                  {"images/mandrill_512_q075.jpg", false, SkEncodedInfo::kRGB_Color}};
+    for (const auto& test : kTests) {
+        sk_sp<SkData> data(load_resource(r, "PngIdentification", test.path));
+        if (!data) {
+            continue;
+        }
+        SkISize size;
+        SkEncodedInfo::Color color;
+        SkDynamicMemoryWStream idat;
+        bool embeddable = SkGetPngInfo(data->data(), data->size(), &size, &color, &idat);
+        if (embeddable != test.embeddable) {
+            ERRORF(r, "%s failed embeddable test", test.path);
+            continue;
+        }
+        if (!embeddable) {
+            continue;
+        }
+        REPORTER_ASSERT(r, color == test.color);
+        // The image data is a zlib stream, so it begins with a deflate compression method.
+        sk_sp<SkData> idatData = idat.detachAsData();
+        REPORTER_ASSERT(r, idatData->size() > 2 && (idatData->bytes()[0] & 0x0F) == 8);
+    }
+
+    // A truncated PNG is rejected.
+    sk_sp<SkData> data(load_resource(r, "PngIdentification", "images/mandrill_512.png"));
+    if (data) {
+        REPORTER_ASSERT(r, !SkGetPngInfo(data->data(), 40, nullptr, nullptr, nullptr));
+    }
+}
 #endif
@@ -6,6 +6,8 @@
  */
 
 #include "SkPathMeasure.h"
+#include "SkPathMeasureCache.h"
+#include "SkResourceCache.h"
 #include "Test.h"
 
 static void test_small_segment3() {
@@ -227,3 +229,66 @@ DEF_TEST(PathMeasure_nextctr, reporter) {
     // only expect 1 contour, even if we didn't explicitly call getLength() ourselves
     REPORTER_ASSERT(reporter, !meas.nextContour());
 }
+
+static void compare_measures(skiatest::Reporter* reporter, SkPathMeasure* expected,
+                             SkPathMeasure* actual) {
+    bool more;
+    do {
+        SkScalar length = expected->getLength();
+        REPORTER_ASSERT(reporter, length == actual->getLength());
+        REPORTER_ASSERT(reporter, expected->isClosed() == actual->isClosed());
+        for (SkScalar d = 0; d <= length; d += length / 7 + 1) {
+            SkPoint pos[2];
+            SkVector tan[2];
+            bool ok = expected->getPosTan(d, &pos[0], &tan[0]);
+            REPORTER_ASSERT(reporter, ok == actual->getPosTan(d, &pos[1], &tan[1]));
+            REPORTER_ASSERT(reporter, !ok || (pos[0] == pos[1] && tan[0] == tan[1]));
+        }
+        SkPath segs[2];
+        REPORTER_ASSERT(reporter, expected->getSegment(length / 4, length / 2, &segs[0], true) ==
+                                  actual->getSegment(length / 4, length / 2, &segs[1], true));
+        REPORTER_ASSERT(reporter, segs[0] == segs[1]);
+        more = expected->nextContour();
+        REPORTER_ASSERT(reporter, more == actual->nextContour());
+    } while (more);
+    REPORTER_ASSERT(reporter, expected->getLength() == actual->getLength());
+}
+
+DEF_TEST(PathMeasure_cache, reporter) {
+    SkResourceCache cache(1024 * 1024);
+    SkPath path;
+    path.moveTo(0, 0);
+    path.cubicTo(10, 40, 30, -20, 50, 10);
+    path.quadTo(60, 60, 0, 40);
+    path.close();
+    path.moveTo(100, 0);
+    path.conicTo(150, 0, 150, 50, 0.7f);
+    path.lineTo(120, 70);
+    // A zero-length contour ends the walk, so the last one is never visited.
+    path.moveTo(200, 0);
+    path.lineTo(200, 0);
+    path.moveTo(300, 0);
+    path.lineTo(320, 0);
+
+    for (bool forceClosed : {false, true}) {
+        for (SkScalar resScale : {1.0f, 3.0f}) {
+            SkPathMeasure expected(path, forceClosed, resScale), first, second;
+            SkPathMeasureCache::SetPath(&first, path, forceClosed, resScale, &cache);
+            SkPathMeasureCache::SetPath(&second, path, forceClosed, resScale, &cache);
+            compare_measures(reporter, &expected, &first);
+            SkPathMeasure again(path, forceClosed, resScale);
+            compare_measures(reporter, &again, &second);
+        }
+    }
+    REPORTER_ASSERT(reporter, cache.getTotalBytesUsed() > 0);
+
+    // Changing the path purges its measurements, which leaves just the other path's.
+    SkPath other(path);
+    other.offset(5, 5);
+    path.lineTo(0, 50);
+    SkPathMeasure meas;
+    SkPathMeasureCache::SetPath(&meas, other, false, 1, &cache);
+    SkResourceCache otherCache(1024 * 1024);
+    SkPathMeasureCache::SetPath(&meas, other, false, 1, &otherCache);
+    REPORTER_ASSERT(reporter, cache.getTotalBytesUsed() == otherCache.getTotalBytesUsed());
+}
@@ -8,6 +8,7 @@
 #include "PathOpsExtendedTest.h"
 #include "PathOpsTestCommon.h"
 #include "SkBitmap.h"
+#include "SkRandom.h"
 #include "Test.h"
 
 DEF_TEST(PathOpsBuilder, reporter) {
@@ -361,3 +362,39 @@ SkOpBuilder builder;
     builder.add(path1, SkPathOp::kUnion_SkPathOp);
     builder.resolve(&path);
 }
+
+DEF_TEST(SkOpBuilderManyUnions, reporter) {
+    // Overlapping L shapes aren't convex, so these are unioned pairwise, level by level.
+    SkRandom rand;
+    SkOpBuilder builder;
+    SkPath expected;
+    SkTArray<SkPath> paths;
+    for (int index = 0; index < 37; ++index) {
+        SkScalar x = rand.nextRangeScalar(0, 80),
+                 y = rand.nextRangeScalar(0, 80);
+        SkPath path;
+        path.moveTo(x, y);
+        path.lineTo(x + 20, y);
+        path.lineTo(x + 20, y + 8);
+        path.lineTo(x + 8, y + 8);
+        path.lineTo(x + 8, y + 20);
+        path.lineTo(x, y + 20);
+        path.close();
+        paths.push_back(path);
+        REPORTER_ASSERT(reporter, Op(expected, path, kUnion_SkPathOp, &expected));
+    }
+    for (const SkPath& path : paths) {
+        builder.add(path, kUnion_SkPathOp);
+    }
+    SkPath result;
+    REPORTER_ASSERT(reporter, builder.resolve(&result));
+    REPORTER_ASSERT(reporter, 0 == comparePaths(reporter, __FUNCTION__, expected, result));
+
+    // The pairing is deterministic, so resolving again gives exactly the same path.
+    for (const SkPath& path : paths) {
+        builder.add(path, kUnion_SkPathOp);
+    }
+    SkPath again;
+    REPORTER_ASSERT(reporter, builder.resolve(&again));
+    REPORTER_ASSERT(reporter, again == result);
+}
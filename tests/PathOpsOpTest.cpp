@@ -7,6 +7,7 @@
 #include "PathOpsDebug.h"
 #include "PathOpsExtendedTest.h"
 #include "PathOpsTestCommon.h"
+#include "SkRegion.h"
 
 class PathTest_Private {
 public:
@@ -8947,7 +8948,8 @@ path.lineTo(26.0234f, 26.3324f);
 path.conicTo(26.0409f, 27.3323f, 25.041f, 27.3497f, 0.707107f);
 path.conicTo(24.0412f, 27.3672f, 24.0237f, 26.3673f, 0.707107f);
 path.close();
-    testPathOpFail(reporter, path, path1, kXOR_SkPathOp, filename);
+    // The operands are identical, so this no longer needs the general engine (which fails).
+    testPathOp(reporter, path, path1, kXOR_SkPathOp, filename);
 }
 
 static void op_1(skiatest::Reporter* reporter, const char* filename) {
@@ -12523,3 +12525,98 @@ DEF_TEST(PathOpsRepOp, reporter) {
   for (int index = 0; index < 1; ++index)
     RunTestSet(reporter, repTests, SK_ARRAY_COUNT(repTests), nullptr, nullptr, nullptr, false);
 }
+
+// Op() answers some ops without the general engine: identical operands, operands with disjoint
+// bounds, and intersections of convex polygons. Check those answers against SkRegion.
+static void check_op_with_region(skiatest::Reporter* reporter, const SkPath& one,
+                                 const SkPath& two, SkPathOp op, const char* name) {
+    SkPath result;
+    if (!Op(one, two, op, &result)) {
+        ERRORF(reporter, "%s: op %d failed", name, op);
+        return;
+    }
+    SkRegion clip(SkIRect::MakeLTRB(-64, -64, 192, 192));
+    SkRegion rgnOne, rgnTwo, expected, actual;
+    rgnOne.setPath(one, clip);
+    rgnTwo.setPath(two, clip);
+    expected.op(rgnOne, rgnTwo, (SkRegion::Op) op);
+    actual.setPath(result, clip);
+    REPORTER_ASSERT(reporter, actual == expected, "%s: op %d, fill types %d %d", name, op,
+                    one.getFillType(), two.getFillType());
+}
+
+static SkPath make_poly(std::initializer_list<SkPoint> pts, SkPath::FillType fillType) {
+    SkPath path;
+    path.addPoly(pts.begin(), SkToInt(pts.size()), true);
+    path.setFillType(fillType);
+    return path;
+}
+
+static const SkPath::FillType kFillTypes[] = {
+    SkPath::kWinding_FillType, SkPath::kEvenOdd_FillType,
+    SkPath::kInverseWinding_FillType, SkPath::kInverseEvenOdd_FillType,
+};
+
+DEF_TEST(PathOpsOpFastPaths, reporter) {
+    for (SkPath::FillType fillType : kFillTypes) {
+        // A convex polygon, a circle, a concave polygon and a path with a hole.
+        SkPath circle, framed;
+        circle.addCircle(30, 30, 20);
+        circle.setFillType(fillType);
+        framed.addRect(SkRect::MakeLTRB(0, 0, 50, 50));
+        framed.addRect(SkRect::MakeLTRB(10, 10, 40, 40), SkPath::kCCW_Direction);
+        framed.setFillType(fillType);
+        const SkPath shapes[] = {
+            make_poly({{10, 0}, {50, 10}, {40, 50}, {0, 30}}, fillType),
+            circle,
+            make_poly({{0, 0}, {40, 0}, {40, 10}, {10, 10}, {10, 40}, {0, 40}}, fillType),
+            framed,
+        };
+        for (const SkPath& shape : shapes) {
+            for (int op = kDifference_SkPathOp; op <= kReverseDifference_SkPathOp; ++op) {
+                check_op_with_region(reporter, shape, shape, (SkPathOp) op, "identical");
+            }
+        }
+
+        // Each shape with each other one, moved so that their bounds don't touch.
+        for (const SkPath& shape : shapes) {
+            for (const SkPath& other : shapes) {
+                for (SkPath::FillType otherFillType : {SkPath::kWinding_FillType,
+                                                       SkPath::kInverseEvenOdd_FillType}) {
+                    SkPath moved;
+                    other.offset(70, 60, &moved);
+                    moved.setFillType(otherFillType);
+                    for (int op = kDifference_SkPathOp; op <= kReverseDifference_SkPathOp; ++op) {
+                        check_op_with_region(reporter, shape, moved, (SkPathOp) op, "disjoint");
+                    }
+                }
+            }
+        }
+    }
+
+    // Convex polygons that overlap, that share an edge, that touch at a vertex, that have
+    // collinear edges, and that contain one another.
+    const SkPath::FillType fill = SkPath::kWinding_FillType;
+    const SkPath diamond = make_poly({{20, 0}, {40, 20}, {20, 40}, {0, 20}}, fill);
+    const SkPath triangle = make_poly({{0, 0}, {40, 0}, {0, 40}}, fill);
+    const struct {
+        SkPath      fOne;
+        SkPath      fTwo;
+        const char* fName;
+    } pairs[] = {
+        { diamond, make_poly({{30, 10}, {60, 20}, {30, 50}}, fill), "overlapping" },
+        { diamond, make_poly({{40, 20}, {60, 40}, {40, 60}, {20, 40}}, fill), "shared edge" },
+        { diamond, make_poly({{40, 20}, {60, 0}, {60, 40}}, fill), "shared vertex" },
+        { diamond, make_poly({{30, 30}, {50, 10}, {50, 50}}, fill), "vertex on edge" },
+        { diamond, make_poly({{30, 10}, {50, 30}, {30, 50}, {10, 30}}, fill), "collinear" },
+        { triangle, make_poly({{10, 0}, {60, 0}, {10, 50}}, fill), "collinear triangles" },
+        { triangle, make_poly({{0, 0}, {20, 0}, {0, 20}}, fill), "corner in corner" },
+        { diamond, make_poly({{15, 15}, {25, 15}, {25, 25}, {15, 25}}, fill), "contained" },
+        { diamond, make_poly({{0, 0}, {40, 0}, {40, 40}, {0, 40}}, fill), "inscribed" },
+        { diamond, make_poly({{20, 0}, {0, 20}, {20, 40}, {40, 20}}, fill), "opposite winding" },
+    };
+    for (const auto& pair : pairs) {
+        check_op_with_region(reporter, pair.fOne, pair.fTwo, kIntersect_SkPathOp, pair.fName);
+        check_op_with_region(reporter, pair.fTwo, pair.fOne, kIntersect_SkPathOp, pair.fName);
+    }
+}
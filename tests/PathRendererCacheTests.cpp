@@ -14,8 +14,10 @@
 #include "GrShape.h"
 #include "GrSoftwarePathRenderer.h"
 #include "GrStyle.h"
+#include "SkExecutor.h"
 #include "SkPath.h"
 #include "effects/GrPorterDuffXferProcessor.h"
+#include "ops/GrSmallPathRenderer.h"
 #include "ops/GrTessellatingPathRenderer.h"
 
 static SkPath create_concave_path() {
@@ -28,12 +30,23 @@ static SkPath create_concave_path() {
     return path;
 }
 
+static SkPath create_concave_curved_path() {
+    SkPath path;
+    path.moveTo(100, 0);
+    path.cubicTo(150, 50, 250, 150, 200, 200);
+    path.lineTo(100, 150);
+    path.quadTo(50, 250, 0, 200);
+    path.close();
+    return path;
+}
+
 static void draw_path(GrContext* ctx,
                       GrRenderTargetContext* renderTargetContext,
                       const SkPath& path,
                       GrPathRenderer* pr,
                       GrAAType aaType,
-                      const GrStyle& style) {
+                      const GrStyle& style,
+                      const SkMatrix& viewMatrix = SkMatrix::I()) {
     GrPaint paint;
     paint.setXPFactory(GrPorterDuffXPFactory::Get(SkBlendMode::kSrc));
 
@@ -44,7 +57,7 @@ static void draw_path(GrContext* ctx,
     if (shape.style().applies()) {
         shape = shape.applyStyle(GrStyle::Apply::kPathEffectAndStrokeRec, 1.0f);
     }
-    SkMatrix matrix = SkMatrix::I();
+    SkMatrix matrix = viewMatrix;
     GrPathRenderer::DrawPathArgs args{ctx,
                                       std::move(paint),
                                       &GrUserStencilSettings::kUnused,
@@ -132,6 +145,54 @@ DEF_GPUTEST(TessellatingPathRendererCacheTest, reporter, /* options */) {
     test_path(reporter, create_concave_path, createPR, kExpectedResources, GrAAType::kNone, style);
 }
 
+// Test that the tessellating path renderer keeps one vertex buffer per zoom level (tolerance bucket),
+// with and without an executor to tessellate on.
+DEF_GPUTEST(TessellatingPathRendererMultiResolutionCacheTest, reporter, /* options */) {
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(2);
+    for (SkExecutor* exec : {(SkExecutor*)nullptr, executor.get()}) {
+        GrContextOptions options;
+        options.fExecutor = exec;
+        sk_sp<GrContext> ctx = GrContext::MakeMock(nullptr, options);
+        ctx->setResourceCacheLimits(100, 8000000);
+        GrResourceCache* cache = ctx->contextPriv().getResourceCache();
+
+        const GrBackendFormat format =
+                ctx->contextPriv().caps()->getBackendFormatFromColorType(kRGBA_8888_SkColorType);
+        sk_sp<GrRenderTargetContext> rtc(ctx->contextPriv().makeDeferredRenderTargetContext(
+                format, SkBackingFit::kApprox, 800, 800, kRGBA_8888_GrPixelConfig, nullptr, 1,
+                GrMipMapped::kNo, kTopLeft_GrSurfaceOrigin));
+        if (!rtc) {
+            return;
+        }
+
+        GrTessellatingPathRenderer pr;
+        SkPath curved = create_concave_curved_path();
+        SkPath linear = create_concave_path();
+        GrStyle fill(SkStrokeRec::kFill_InitStyle);
+        auto drawBoth = [&](SkScalar scale) {
+            SkMatrix m = SkMatrix::MakeScale(scale);
+            draw_path(ctx.get(), rtc.get(), curved, &pr, GrAAType::kNone, fill, m);
+            draw_path(ctx.get(), rtc.get(), linear, &pr, GrAAType::kNone, fill, m);
+            ctx->flush();
+        };
+
+        drawBoth(1);
+        REPORTER_ASSERT(reporter, cache_non_scratch_resources_equals(cache, 2));
+
+        // Zooming in needs a finer tessellation of the curved path. The linear one is reused.
+        drawBoth(3);
+        REPORTER_ASSERT(reporter, cache_non_scratch_resources_equals(cache, 3));
+
+        // A slightly different zoom falls in the same tolerance bucket.
+        drawBoth(3.1f);
+        REPORTER_ASSERT(reporter, cache_non_scratch_resources_equals(cache, 3));
+
+        // Zooming back out reuses the first tessellation instead of replacing it.
+        drawBoth(.95f);
+        REPORTER_ASSERT(reporter, cache_non_scratch_resources_equals(cache, 3));
+    }
+}
+
 // Test that deleting the original path invalidates the textures cached by the SW path renderer
 DEF_GPUTEST(SoftwarePathRendererCacheTest, reporter, /* options */) {
     auto createPR = [](GrContext* ctx) {
@@ -153,3 +214,55 @@ DEF_GPUTEST(SoftwarePathRendererCacheTest, reporter, /* options */) {
     test_path(reporter, create_concave_path, createPR, kExpectedResources, GrAAType::kCoverage,
               style);
 }
+
+static SkPath create_icon_path(SkScalar size) {
+    SkPath path;
+    path.moveTo(size / 2, 0);
+    path.lineTo(size, size);
+    path.lineTo(0, size * 0.4f);
+    path.lineTo(size, size * 0.4f);
+    path.lineTo(0, size);
+    path.close();
+    return path;
+}
+
+// Test that prewarmed small path masks are made into the shared cache, and that another context
+// draws from them.
+DEF_GPUTEST(SmallPathRendererPrewarmTest, reporter, /* options */) {
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(2);
+    GrContextOptions options;
+    options.fExecutor = executor.get();
+    sk_sp<GrContext> ctx = GrContext::MakeMock(nullptr, options);
+    sk_sp<GrContext> otherCtx = GrContext::MakeMock(nullptr);
+
+    const GrBackendFormat format =
+            otherCtx->contextPriv().caps()->getBackendFormatFromColorType(kRGBA_8888_SkColorType);
+    sk_sp<GrRenderTargetContext> rtc(otherCtx->contextPriv().makeDeferredRenderTargetContext(
+            format, SkBackingFit::kApprox, 800, 800, kRGBA_8888_GrPixelConfig, nullptr, 1,
+            GrMipMapped::kNo, kTopLeft_GrSurfaceOrigin));
+    if (!rtc) {
+        return;
+    }
+    GrSmallPathRenderer pr;
+    otherCtx->contextPriv().addOnFlushCallbackObject(&pr);
+
+    SkPath icons[] = {create_icon_path(17), create_icon_path(18), create_icon_path(19)};
+    GrStyle fill(SkStrokeRec::kFill_InitStyle);
+    // Icons are drawn from coverage masks at their size, and from distance fields when large.
+    for (SkScalar scale : {1.f, 10.f}) {
+        SkMatrix m = SkMatrix::MakeScale(scale);
+        ctx->prewarmPathMasks(icons, SK_ARRAY_COUNT(icons), m);
+        for (const SkPath& icon : icons) {
+            REPORTER_ASSERT(reporter, GrSmallPathRenderer::HasSharedMask_ForTesting(icon, m));
+            draw_path(otherCtx.get(), rtc.get(), icon, &pr, GrAAType::kCoverage, fill, m);
+        }
+        otherCtx->flush();
+    }
+
+    // Paths too big for the small path renderer are skipped.
+    SkPath big = create_icon_path(200);
+    ctx->prewarmPathMasks(&big, 1, SkMatrix::I());
+    REPORTER_ASSERT(reporter, !GrSmallPathRenderer::HasSharedMask_ForTesting(big, SkMatrix::I()));
+
+    otherCtx->contextPriv().testingOnly_flushAndRemoveOnFlushCallbackObject(&pr);
+}
@@ -4159,6 +4159,10 @@ public:
             ed.resetToSize(0, 0, 0);
         }
     }
+
+    static bool UsesInlineStorage(const SkPathRef& ref) {
+        return ref.usesInlineStorage();
+    }
 };
 
 static void test_operatorEqual(skiatest::Reporter* reporter) {
@@ -4267,6 +4271,59 @@ public:
         return PathRefTest_Private::GetFreeSpace(*path.fPathRef);
     }
 
+    static bool UsesInlineStorage(const SkPath& path) {
+        return PathRefTest_Private::UsesInlineStorage(*path.fPathRef);
+    }
+
+    static void TestInlineStorage(skiatest::Reporter* reporter) {
+        // Small paths keep their points and verbs in the path ref.
+        SkPath path;
+        path.addRect({0, 0, 10, 10});
+        REPORTER_ASSERT(reporter, UsesInlineStorage(path));
+
+        // Growing past the inline storage moves them to the heap.
+        SkPath grown = path;
+        for (int i = 0; i < 40; i++) {
+            grown.lineTo(i, i * 2);
+        }
+        REPORTER_ASSERT(reporter, !UsesInlineStorage(grown));
+        REPORTER_ASSERT(reporter, UsesInlineStorage(path));
+        REPORTER_ASSERT(reporter, grown.countPoints() == 4 + 1 + 40);
+        REPORTER_ASSERT(reporter, grown.countVerbs() == 5 + 1 + 40);
+        REPORTER_ASSERT(reporter, grown.getPoint(2) == SkPoint::Make(10, 10));
+        REPORTER_ASSERT(reporter, grown.getPoint(44) == SkPoint::Make(39, 78));
+        SkPath::RawIter iter(grown);
+        SkPoint pts[4];
+        REPORTER_ASSERT(reporter, iter.next(pts) == SkPath::kMove_Verb);
+        REPORTER_ASSERT(reporter, iter.next(pts) == SkPath::kLine_Verb);
+
+        // Rewinding keeps the heap allocation, but shrinking a small path moves it back.
+        grown.rewind();
+        grown.moveTo(1, 2);
+        grown.quadTo(3, 4, 5, 6);
+        grown.conicTo(7, 8, 9, 10, 0.5f);
+        REPORTER_ASSERT(reporter, !UsesInlineStorage(grown));
+        SkPath expected;
+        expected.moveTo(1, 2);
+        expected.quadTo(3, 4, 5, 6);
+        expected.conicTo(7, 8, 9, 10, 0.5f);
+        grown.shrinkToFit();
+        REPORTER_ASSERT(reporter, UsesInlineStorage(grown));
+        REPORTER_ASSERT(reporter, grown == expected);
+
+        // Copies for editing and transformed copies are small too.
+        SkPath large;
+        for (int i = 0; i < 100; i++) {
+            large.lineTo(i, -i);
+        }
+        SkPath transformed;
+        path.transform(SkMatrix::MakeScale(2), &transformed);
+        REPORTER_ASSERT(reporter, UsesInlineStorage(transformed));
+        large.transform(SkMatrix::MakeScale(2), &transformed);
+        REPORTER_ASSERT(reporter, !UsesInlineStorage(transformed));
+        REPORTER_ASSERT(reporter, transformed.getPoint(100) == SkPoint::Make(198, -198));
+    }
+
     static void TestPathTo(skiatest::Reporter* reporter) {
         SkPath p, q;
         p.lineTo(4, 4);
@@ -4670,6 +4727,7 @@ DEF_TEST(Paths, reporter) {
     test_contains(reporter);
     PathTest_Private::TestPathTo(reporter);
     PathRefTest_Private::TestPathRef(reporter);
+    PathTest_Private::TestInlineStorage(reporter);
     PathTest_Private::TestPathrefListeners(reporter);
     test_dump(reporter);
     test_path_crbug389050(reporter);
@@ -0,0 +1,134 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Test.h"
+
+#include "GrContext.h"
+#include "GrContextFactory.h"
+#include "GrContextPriv.h"
+#include "GrPictureRasterCache.h"
+#include "SkCanvas.h"
+#include "SkPictureRecorder.h"
+#include "SkSurface.h"
+
+static constexpr int kPictureSize = 64;
+
+// A checkerboard of 8x8 squares, which draws the same whether played back or rasterized.
+static sk_sp<SkPicture> make_picture(int opCount) {
+    SkPictureRecorder recorder;
+    SkCanvas* canvas = recorder.beginRecording(SkRect::MakeIWH(kPictureSize, kPictureSize));
+    SkPaint paint;
+    for (int i = 0; i < opCount; ++i) {
+        paint.setColor((i + i / 8) & 1 ? SK_ColorRED : SK_ColorBLUE);
+        canvas->drawRect(SkRect::MakeXYWH(i % 8 * 8, i / 8 % 8 * 8, 8, 8), paint);
+    }
+    return recorder.finishRecordingAsPicture();
+}
+
+static size_t raster_bytes(int size) { return size * size * 4; }
+
+DEF_GPUTEST(PictureRasterCache, reporter, options) {
+    GrContextOptions cacheOptions = options;
+    cacheOptions.fPictureRasterCacheBytes = raster_bytes(kPictureSize) + raster_bytes(32);
+    sk_gpu_test::GrContextFactory factory(cacheOptions);
+    GrContext* context = factory.get(sk_gpu_test::GrContextFactory::kNullGL_ContextType);
+    if (!context) {
+        return;
+    }
+    GrPictureRasterCache* cache = context->contextPriv().getPictureRasterCache();
+    REPORTER_ASSERT(reporter, cache);
+    sk_sp<SkSurface> surface = SkSurface::MakeRenderTarget(context, SkBudgeted::kNo,
+                                                           SkImageInfo::MakeN32Premul(256, 256));
+    if (!cache || !surface) {
+        return;
+    }
+    SkCanvas* canvas = surface->getCanvas();
+    sk_sp<SkPicture> picture = make_picture(GrPictureRasterCache::kMinOpCount);
+
+    // The picture is played back the first time, and rasterized the second.
+    SkMatrix matrix = SkMatrix::MakeTrans(10, 10);
+    canvas->drawPicture(picture, &matrix, nullptr);
+    REPORTER_ASSERT(reporter, 1 == cache->count());
+    REPORTER_ASSERT(reporter, 0 == cache->usedBytes());
+    canvas->drawPicture(picture, &matrix, nullptr);
+    REPORTER_ASSERT(reporter, raster_bytes(kPictureSize) == cache->usedBytes());
+
+    // Whole pixel translates reuse the raster, as do those that round to the same subpixel offset.
+    // A quarter pixel more is another offset.
+    matrix.setTranslate(30.05f, 11);
+    canvas->drawPicture(picture, &matrix, nullptr);
+    matrix.setTranslate(30.25f, 11);
+    canvas->drawPicture(picture, &matrix, nullptr);
+    REPORTER_ASSERT(reporter, 2 == cache->count());
+    REPORTER_ASSERT(reporter, raster_bytes(kPictureSize) == cache->usedBytes());
+
+    // Another scale needs another raster.
+    matrix.setScale(0.5f, 0.5f);
+    canvas->drawPicture(picture, &matrix, nullptr);
+    canvas->drawPicture(picture, &matrix, nullptr);
+    REPORTER_ASSERT(reporter, raster_bytes(kPictureSize) + raster_bytes(32) == cache->usedBytes());
+
+    // Past the budget, the least recently drawn raster is dropped.
+    matrix.setScale(0.75f, 0.75f);
+    canvas->drawPicture(picture, &matrix, nullptr);
+    canvas->drawPicture(picture, &matrix, nullptr);
+    REPORTER_ASSERT(reporter, raster_bytes(32) + raster_bytes(48) == cache->usedBytes());
+
+    // Rasters too big for the budget are never made, and simple pictures aren't worth one.
+    int count = cache->count();
+    matrix.setScale(2, 2);
+    canvas->drawPicture(picture, &matrix, nullptr);
+    canvas->drawPicture(picture, &matrix, nullptr);
+    REPORTER_ASSERT(reporter, ++count == cache->count());
+    sk_sp<SkPicture> simple = make_picture(GrPictureRasterCache::kMinOpCount - 1);
+    canvas->drawPicture(simple);
+    canvas->drawPicture(simple);
+    REPORTER_ASSERT(reporter, count == cache->count());
+    REPORTER_ASSERT(reporter, raster_bytes(32) + raster_bytes(48) == cache->usedBytes());
+
+    context->freeGpuResources();
+    REPORTER_ASSERT(reporter, 0 == cache->count());
+    REPORTER_ASSERT(reporter, 0 == cache->usedBytes());
+}
+
+static void enable_picture_raster_cache(GrContextOptions* options) {
+    options->fPictureRasterCacheBytes = 1 << 20;
+}
+
+DEF_GPUTEST_FOR_CONTEXTS(PictureRasterCache_Pixels,
+                         sk_gpu_test::GrContextFactory::IsRenderingContext,
+                         reporter, ctxInfo, enable_picture_raster_cache) {
+    GrContext* context = ctxInfo.grContext();
+    sk_sp<SkSurface> surface = SkSurface::MakeRenderTarget(context, SkBudgeted::kNo,
+                                                           SkImageInfo::MakeN32Premul(128, 128));
+    if (!surface) {
+        return;
+    }
+    SkCanvas* canvas = surface->getCanvas();
+    sk_sp<SkPicture> picture = make_picture(GrPictureRasterCache::kMinOpCount * 2);
+    SkPaint paint;
+    paint.setAlpha(0x80);
+
+    // Rasterized or not, the picture draws the same at each whole pixel offset.
+    SkImageInfo info = SkImageInfo::MakeN32Premul(80, 100);
+    SkBitmap expected, actual;
+    expected.allocPixels(info);
+    actual.allocPixels(info);
+    for (int i = 0; i < 3; ++i) {
+        canvas->clear(SK_ColorWHITE);
+        SkMatrix matrix = SkMatrix::MakeTrans(10 + i * 20, 20);
+        canvas->drawPicture(picture, &matrix, &paint);
+        SkBitmap* bitmap = i ? &actual : &expected;
+        if (!surface->readPixels(*bitmap, i * 20, 0)) {
+            ERRORF(reporter, "Could not read pixels.");
+            return;
+        }
+        if (i && memcmp(expected.getPixels(), actual.getPixels(), expected.computeByteSize())) {
+            ERRORF(reporter, "Draw %d of the picture differs from the first.", i);
+        }
+    }
+}
@@ -6,9 +6,11 @@
  */
 
 #include "SkCanvas.h"
+#include "SkGraphics.h"
 #include "SkPicture.h"
 #include "SkPictureRecorder.h"
 #include "SkPictureShader.h"
+#include "SkResourceCache.h"
 #include "SkShader.h"
 #include "SkSurface.h"
 #include "Test.h"
@@ -78,3 +80,53 @@ DEF_TEST(PictureShader_caching, reporter) {
     // All but the local ref should be gone now.
     REPORTER_ASSERT(reporter, picture->unique());
 }
+
+static int count_picture_tiles() {
+    int count = 0;
+    SkResourceCache::VisitAll([](const SkResourceCache::Rec& rec, void* context) {
+        if (!strcmp(rec.getCategory(), "bitmap-shader")) {
+            *static_cast<int*>(context) += 1;
+        }
+    }, &count);
+    return count;
+}
+
+// Test that draws at nearby scales share a tile rasterized at the next power of two scale.
+DEF_TEST(PictureShader_levels, reporter) {
+    SkPictureRecorder recorder;
+    recorder.beginRecording(10, 10)->drawColor(SK_ColorGREEN);
+    SkPaint paint;
+    paint.setShader(SkPictureShader::Make(recorder.finishRecordingAsPicture(),
+                                          SkShader::kRepeat_TileMode,
+                                          SkShader::kRepeat_TileMode, nullptr, nullptr));
+
+    sk_sp<SkSurface> surface = SkSurface::MakeRasterN32Premul(50, 50);
+    SkCanvas* canvas = surface->getCanvas();
+    SkGraphics::PurgeResourceCache();
+    const int tiles = count_picture_tiles();
+
+    auto draw = [&](SkScalar scale) {
+        canvas->clear(SK_ColorRED);
+        canvas->save();
+        canvas->scale(scale, scale);
+        canvas->drawRect(SkRect::MakeWH(10, 10), paint);
+        canvas->restore();
+        SkBitmap bitmap;
+        bitmap.allocPixels(SkImageInfo::MakeN32Premul(1, 1));
+        surface->readPixels(bitmap, 5, 5);
+        REPORTER_ASSERT(reporter, bitmap.getColor(0, 0) == SK_ColorGREEN);
+    };
+
+    for (SkScalar scale : { 1.2f, 1.5f, 1.9f, 2.0f }) {
+        draw(scale);
+    }
+    REPORTER_ASSERT(reporter, count_picture_tiles() == tiles + 1);
+    draw(2.5f);
+    REPORTER_ASSERT(reporter, count_picture_tiles() == tiles + 2);
+
+    // A missing level is rasterized on the default executor, which runs the work right away.
+    gSkRasterizePictureTilesInBackground = true;
+    draw(5.0f);
+    gSkRasterizePictureTilesInBackground = false;
+    REPORTER_ASSERT(reporter, count_picture_tiles() == tiles + 3);
+}
@@ -9,15 +9,25 @@
 #include "SkBBoxHierarchy.h"
 #include "SkBigPicture.h"
 #include "SkBitmap.h"
+#include "SkBitmapCache.h"
+#include "SkBlurImageFilter.h"
 #include "SkCanvas.h"
 #include "SkClipOp.h"
 #include "SkClipOpPriv.h"
 #include "SkColor.h"
 #include "SkData.h"
+#include "SkExecutor.h"
 #include "SkFontStyle.h"
+#include "SkImage.h"
+#include "SkImageGenerator.h"
 #include "SkImageInfo.h"
+#include "SkMakeUnique.h"
 #include "SkMatrix.h"
 #include "SkMiniRecorder.h"
+#include "SkMipMap.h"
+#include "SkMultiPictureDraw.h"
+#include "SkOSFile.h"
+#include "SkOSPath.h"
 #include "SkPaint.h"
 #include "SkPath.h"
 #include "SkPicturePriv.h"
@@ -28,12 +38,16 @@
 #include "SkRectPriv.h"
 #include "SkRefCnt.h"
 #include "SkScalar.h"
+#include "SkSerialProcs.h"
 #include "SkShader.h"
 #include "SkStream.h"
+#include "SkTaskGroup.h"
 #include "SkTypeface.h"
 #include "SkTypes.h"
+#include "SkVertices.h"
 #include "Test.h"
 
+#include <atomic>
 #include <memory>
 
 class SkRRect;
@@ -873,3 +887,237 @@ DEF_TEST(Picture_empty_serial, reporter) {
     REPORTER_ASSERT(reporter, pic2);
 }
 
+
+// Paths and paints rebuilt for each draw are only serialized once.
+DEF_TEST(Picture_SerializeDedupesContent, r) {
+    auto serialized_size = [](int draws) {
+        SkPictureRecorder recorder;
+        SkCanvas* canvas = recorder.beginRecording(100, 100);
+        for (int i = 0; i < draws; i++) {
+            SkPath path;
+            path.addCircle(50, 50, 40);
+            path.addRect(SkRect::MakeLTRB(10, 10, 90, 90));
+            SkPaint paint;
+            paint.setAntiAlias(true);
+            paint.setColor(SK_ColorBLUE);
+            canvas->drawPath(path, paint);
+        }
+        return recorder.finishRecordingAsPicture()->serialize()->size();
+    };
+    // Each extra draw only costs its op: far less than a path and a paint.
+    REPORTER_ASSERT(r, serialized_size(20) - serialized_size(2) < 18 * 32);
+}
+
+// Images round-trip through these as their raw N32 pixels, so the test doesn't need codecs.
+static sk_sp<SkData> serialize_raw_image(SkImage* image, void*) {
+    SkBitmap bm;
+    bm.allocN32Pixels(image->width(), image->height());
+    if (!image->readPixels(bm.pixmap(), 0, 0)) {
+        return nullptr;
+    }
+    SkDynamicMemoryWStream stream;
+    stream.write32(image->width());
+    stream.write32(image->height());
+    stream.write(bm.getPixels(), bm.computeByteSize());
+    return stream.detachAsData();
+}
+
+static sk_sp<SkImage> deserialize_raw_image(const void* data, size_t length, void* ctx) {
+    auto header = static_cast<const int32_t*>(data);
+    if (length < 2 * sizeof(int32_t)) {
+        return nullptr;
+    }
+    ++*static_cast<int*>(ctx);
+    SkImageInfo info = SkImageInfo::MakeN32Premul(header[0], header[1]);
+    SkPixmap pixmap(info, header + 2, info.minRowBytes());
+    if (length < 2 * sizeof(int32_t) + pixmap.computeByteSize()) {
+        return nullptr;
+    }
+    return SkImage::MakeRasterCopy(pixmap);
+}
+
+static SkBitmap draw_picture(SkPicture* pic) {
+    SkBitmap bm;
+    bm.allocN32Pixels(64, 64);
+    SkCanvas canvas(bm);
+    canvas.clear(SK_ColorWHITE);
+    canvas.drawPicture(pic);
+    return bm;
+}
+
+DEF_TEST(Picture_MakeFromFile, r) {
+    SkString tmpDir = skiatest::GetTmpDir();
+    if (tmpDir.isEmpty()) {
+        return;
+    }
+    SkString path = SkOSPath::Join(tmpDir.c_str(), "Picture_MakeFromFile.skp");
+
+    SkBitmap pixels;
+    pixels.allocN32Pixels(8, 8);
+    pixels.eraseColor(SK_ColorBLUE);
+    *pixels.getAddr32(3, 5) = SK_ColorRED;
+    sk_sp<SkImage> image = SkImage::MakeFromBitmap(pixels);
+
+    SkPictureRecorder subRecorder;
+    subRecorder.beginRecording(32, 32)->drawCircle(16, 16, 10, SkPaint());
+    sk_sp<SkPicture> sub = subRecorder.finishRecordingAsPicture();
+
+    SkPictureRecorder recorder;
+    SkCanvas* canvas = recorder.beginRecording(64, 64);
+    canvas->drawImageRect(image, SkRect::MakeXYWH(4, 4, 24, 24), nullptr);
+    const SkPoint pts[] = { {40, 4}, {60, 4}, {50, 30} };
+    const SkColor colors[] = { SK_ColorRED, SK_ColorGREEN, SK_ColorBLUE };
+    canvas->drawVertices(SkVertices::MakeCopy(SkVertices::kTriangles_VertexMode, 3, pts,
+                                              nullptr, colors),
+                         SkBlendMode::kSrcOver, SkPaint());
+    SkPath path1;
+    path1.moveTo(4, 40);
+    path1.quadTo(30, 60, 60, 40);
+    canvas->drawPath(path1, SkPaint());
+    canvas->translate(20, 30);
+    canvas->drawPicture(sub);
+    sk_sp<SkPicture> pic = recorder.finishRecordingAsPicture();
+
+    SkSerialProcs serialProcs;
+    serialProcs.fImageProc = serialize_raw_image;
+    {
+        SkFILEWStream stream(path.c_str());
+        if (!stream.isValid()) {
+            ERRORF(r, "Failed to create tmp file %s\n", path.c_str());
+            return;
+        }
+        pic->serialize(&stream, &serialProcs);
+    }
+
+    int decodedImages = 0;
+    SkDeserialProcs deserialProcs;
+    deserialProcs.fImageProc = deserialize_raw_image;
+    deserialProcs.fImageCtx = &decodedImages;
+    sk_sp<SkPicture> mapped = SkPicture::MakeFromFile(path.c_str(), &deserialProcs);
+    REPORTER_ASSERT(r, mapped);
+    REPORTER_ASSERT(r, decodedImages == 1);
+    sk_sp<SkPicture> copied = SkPicture::MakeFromData(SkData::MakeFromFileName(path.c_str()).get(),
+                                                      &deserialProcs);
+    REPORTER_ASSERT(r, copied);
+    if (mapped && copied) {
+        REPORTER_ASSERT(r, mapped->approximateOpCount() == copied->approximateOpCount());
+        SkBitmap expected = draw_picture(pic.get()),
+                 actual   = draw_picture(mapped.get());
+        REPORTER_ASSERT(r, 0 == memcmp(expected.getPixels(), actual.getPixels(),
+                                       expected.computeByteSize()));
+    }
+
+    SkString missing = SkOSPath::Join(tmpDir.c_str(), "Picture_MakeFromFile_missing.skp");
+    REPORTER_ASSERT(r, !SkPicture::MakeFromFile(missing.c_str()));
+}
+
+DEF_TEST(Picture_DrawTiled, r) {
+    SkRTreeFactory factory;
+    SkPictureRecorder recorder;
+    SkCanvas* canvas = recorder.beginRecording(100, 100, &factory);
+    // Tiles clip their draws, and geometry crossing a clip edge can round differently than it
+    // would unclipped, so stick to pixel-aligned shapes to compare exactly.
+    SkPaint paint;
+    SkRandom rand;
+    for (int i = 0; i < 40; ++i) {
+        paint.setColor(rand.nextU() | 0xFF000000);
+        SkRect rect = SkRect::MakeXYWH(rand.nextULessThan(100), rand.nextULessThan(100),
+                                       rand.nextRangeU(1, 40), rand.nextRangeU(1, 40));
+        // Tiles skip the picture where they're outside its cull rect, so stay inside it.
+        rect.intersect(SkRect::MakeWH(100, 100));
+        canvas->drawRect(rect, paint);
+    }
+    // Layers straddle tile edges, and the blur needs source pixels from neighboring tiles.
+    SkPaint layerPaint;
+    layerPaint.setAlpha(0x80);
+    canvas->saveLayer(SkRect::MakeLTRB(20, 20, 80, 80), &layerPaint);
+        canvas->drawRect(SkRect::MakeLTRB(10, 40, 90, 60), paint);
+    canvas->restore();
+    layerPaint.setImageFilter(SkBlurImageFilter::Make(3, 3, nullptr));
+    canvas->saveLayer(nullptr, &layerPaint);
+        canvas->drawRect(SkRect::MakeLTRB(28, 5, 36, 95), paint);
+    canvas->restore();
+    sk_sp<SkPicture> pic = recorder.finishRecordingAsPicture();
+
+    SkMatrix matrix = SkMatrix::MakeTrans(3, -2);
+    SkBitmap expected;
+    expected.allocN32Pixels(100, 100);
+    expected.eraseColor(SK_ColorWHITE);
+    SkCanvas(expected).drawPicture(pic, &matrix, nullptr);
+
+    SkTaskGroup::Enabler enabler(4);
+    for (int tileSize : { 16, 33, 256 }) {
+        SkBitmap actual;
+        actual.allocN32Pixels(100, 100);
+        actual.eraseColor(SK_ColorWHITE);
+        SkMultiPictureDraw::DrawTiled(actual.pixmap(), pic.get(), &matrix, tileSize);
+        // The blur may round differently by one where a tile's layer is cut off by the edge.
+        int mismatches = 0;
+        for (int y = 0; y < 100; ++y) {
+            for (int x = 0; x < 100; ++x) {
+                SkColor e = *expected.getAddr32(x, y),
+                        a = *actual.getAddr32(x, y);
+                for (int shift = 0; shift < 32; shift += 8) {
+                    if (SkTAbs((int)((e >> shift) & 0xFF) - (int)((a >> shift) & 0xFF)) > 1) {
+                        mismatches++;
+                        break;
+                    }
+                }
+            }
+        }
+        REPORTER_ASSERT(r, mismatches == 0, "tile size %d: %d pixels differ", tileSize,
+                        mismatches);
+    }
+}
+
+// Counts the times it is asked for its pixels.
+class PrefetchGenerator : public SkImageGenerator {
+public:
+    PrefetchGenerator(std::atomic<int>* decodes)
+        : SkImageGenerator(SkImageInfo::MakeN32Premul(64, 64)), fDecodes(decodes) {}
+
+protected:
+    bool onGetPixels(const SkImageInfo& info, void* pixels, size_t rowBytes,
+                     const Options&) override {
+        fDecodes->fetch_add(1);
+        return SkPixmap(info, pixels, rowBytes).erase(SK_ColorGREEN);
+    }
+
+private:
+    std::atomic<int>* fDecodes;
+};
+
+DEF_TEST(Picture_PrefetchImages, r) {
+    std::atomic<int> decodes[3];
+    sk_sp<SkImage> images[3];
+    for (int i = 0; i < 3; ++i) {
+        decodes[i] = 0;
+        images[i] = SkImage::MakeFromGenerator(skstd::make_unique<PrefetchGenerator>(&decodes[i]));
+    }
+
+    SkPictureRecorder recorder;
+    SkCanvas* canvas = recorder.beginRecording(200, 100);
+    SkPaint medium;
+    medium.setFilterQuality(kMedium_SkFilterQuality);
+    canvas->drawImage(images[0], 0, 0);
+    canvas->drawImageRect(images[1], SkRect::MakeXYWH(80, 0, 16, 16), &medium);
+    canvas->drawImage(images[2], 150, 0);
+    sk_sp<SkPicture> picture = recorder.finishRecordingAsPicture();
+
+    // Only what is drawn within the clip is decoded, and the second image's mipmap is built.
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(2);
+    picture->prefetchImages(executor.get(), SkMatrix::I(), SkRect::MakeWH(120, 100));
+    REPORTER_ASSERT(r, 1 == decodes[0] && 1 == decodes[1] && 0 == decodes[2]);
+    SkBitmap cached;
+    REPORTER_ASSERT(r, SkBitmapCache::Find(SkBitmapCacheDesc::Make(images[0].get()), &cached));
+    sk_sp<const SkMipMap> mipmap(
+            SkMipMapCache::FindAndRef(SkBitmapCacheDesc::Make(images[1].get())));
+    REPORTER_ASSERT(r, mipmap);
+
+    // Playback then has nothing left to decode.
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(120, 100);
+    SkCanvas(bitmap).drawPicture(picture);
+    REPORTER_ASSERT(r, 1 == decodes[0] && 1 == decodes[1] && 0 == decodes[2]);
+    REPORTER_ASSERT(r, SkPreMultiplyColor(SK_ColorGREEN) == *bitmap.getAddr32(8, 8));
+}
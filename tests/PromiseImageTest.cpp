@@ -237,3 +237,88 @@ DEF_GPUTEST_FOR_RENDERING_CONTEXTS(PromiseImageTest, reporter, ctxInfo) {
         gpu->deleteTestingOnlyBackendTexture(backendTex);
     }
 }
+
+struct PromiseTextureBatchChecker {
+    explicit PromiseTextureBatchChecker(const GrBackendTexture& tex) : fTexture(tex) {}
+    GrBackendTexture fTexture;
+    int fFulfillCalls = 0;
+    int fFulfillCount = 0;
+    int fReleaseCalls = 0;
+    int fReleaseCount = 0;
+    static void Fulfill(void* self, void* const[], GrBackendTexture outTextures[], int count) {
+        auto checker = static_cast<PromiseTextureBatchChecker*>(self);
+        checker->fFulfillCalls++;
+        checker->fFulfillCount += count;
+        for (int i = 0; i < count; ++i) {
+            outTextures[i] = checker->fTexture;
+        }
+    }
+    static void Release(void* self, void* const[], int count) {
+        auto checker = static_cast<PromiseTextureBatchChecker*>(self);
+        checker->fReleaseCalls++;
+        checker->fReleaseCount += count;
+    }
+    static void Done(void* doneCount) {
+        ++*static_cast<int*>(doneCount);
+    }
+};
+
+// Promise images drawn by a DDL are fulfilled with one call when it's replayed, and released
+// together at the end of the flush.
+DEF_GPUTEST_FOR_RENDERING_CONTEXTS(PromiseImageBatchTest, reporter, ctxInfo) {
+    const int kWidth = 10;
+    const int kHeight = 10;
+    const int kImageCount = 3;
+
+    GrContext* ctx = ctxInfo.grContext();
+    GrGpu* gpu = ctx->contextPriv().getGpu();
+
+    GrBackendTexture backendTex = gpu->createTestingOnlyBackendTexture(
+            nullptr, kWidth, kHeight, GrColorType::kRGBA_8888, true, GrMipMapped::kNo);
+    REPORTER_ASSERT(reporter, backendTex.isValid());
+    GrBackendFormat backendFormat = gpu->caps()->createFormatFromBackendTexture(backendTex);
+
+    SkImageInfo info = SkImageInfo::MakeN32Premul(kWidth, kHeight);
+    sk_sp<SkSurface> surface = SkSurface::MakeRenderTarget(ctx, SkBudgeted::kNo, info);
+    SkSurfaceCharacterization characterization;
+    SkAssertResult(surface->characterize(&characterization));
+
+    PromiseTextureBatchChecker checker(backendTex);
+    int doneCounts[kImageCount] = {0, 0, 0};
+    std::unique_ptr<SkDeferredDisplayList> ddl;
+    {
+        SkDeferredDisplayListRecorder recorder(characterization);
+        recorder.setPromiseTextureBatchProcs(PromiseTextureBatchChecker::Fulfill,
+                                             PromiseTextureBatchChecker::Release, &checker);
+        SkCanvas* canvas = recorder.getCanvas();
+        for (int i = 0; i < kImageCount; ++i) {
+            sk_sp<SkImage> image = recorder.makePromiseTexture(
+                    backendFormat, kWidth, kHeight, GrMipMapped::kNo, kTopLeft_GrSurfaceOrigin,
+                    kRGBA_8888_SkColorType, kPremul_SkAlphaType, nullptr, nullptr, nullptr,
+                    PromiseTextureBatchChecker::Done, &doneCounts[i]);
+            REPORTER_ASSERT(reporter, image);
+            canvas->drawImage(image, 0, 0);
+        }
+        ddl = recorder.detach();
+    }
+    REPORTER_ASSERT(reporter, 0 == checker.fFulfillCalls);
+
+    surface->draw(ddl.get());
+    surface->flush();
+    REPORTER_ASSERT(reporter, 1 == checker.fFulfillCalls);
+    REPORTER_ASSERT(reporter, kImageCount == checker.fFulfillCount);
+
+    // Vulkan may hold on to the textures until its command buffers finish.
+    gpu->testingOnly_flushGpuAndSync();
+    ddl.reset();
+    REPORTER_ASSERT(reporter, kImageCount == checker.fReleaseCount);
+    REPORTER_ASSERT(reporter, checker.fReleaseCalls <= kImageCount);
+    if (GrBackendApi::kVulkan != ctx->contextPriv().getBackend()) {
+        REPORTER_ASSERT(reporter, 1 == checker.fReleaseCalls);
+    }
+    for (int doneCount : doneCounts) {
+        REPORTER_ASSERT(reporter, 1 == doneCount);
+    }
+
+    gpu->deleteTestingOnlyBackendTexture(backendTex);
+}
@@ -0,0 +1,153 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Resources.h"
+#include "SkBitmap.h"
+#include "SkCodec.h"
+#include "SkData.h"
+#include "SkExecutor.h"
+#include "SkMakeUnique.h"
+#include "SkReadaheadStream.h"
+#include "SkStream.h"
+#include "Test.h"
+
+#include <deque>
+
+// Runs its work only when asked to, so the tests can control when data arrives.
+class ManualExecutor final : public SkExecutor {
+public:
+    void add(std::function<void(void)> work) override { fWork.push_back(std::move(work)); }
+    void borrow() override { this->runOne(); }
+
+    bool runOne() {
+        if (fWork.empty()) {
+            return false;
+        }
+        std::function<void(void)> work = std::move(fWork.front());
+        fWork.pop_front();
+        work();
+        return true;
+    }
+
+private:
+    std::deque<std::function<void(void)>> fWork;
+};
+
+static sk_sp<SkData> make_data(size_t size) {
+    sk_sp<SkData> data = SkData::MakeUninitialized(size);
+    uint8_t* bytes = static_cast<uint8_t*>(data->writable_data());
+    for (size_t i = 0; i < size; i++) {
+        bytes[i] = SkToU8(i * 7);
+    }
+    return data;
+}
+
+DEF_TEST(ReadaheadStream_read, r) {
+    ManualExecutor executor;
+    sk_sp<SkData> data = make_data(40000);
+    int callbacks = 0;
+    auto stream = SkReadaheadStream::Make(skstd::make_unique<SkMemoryStream>(data), &executor,
+                                          [&callbacks] { callbacks++; });
+    REPORTER_ASSERT(r, stream);
+
+    // Nothing has been read from the source, so reads return nothing without blocking.
+    uint8_t buffer[40000];
+    REPORTER_ASSERT(r, 0 == stream->read(buffer, sizeof(buffer)));
+    REPORTER_ASSERT(r, !stream->isAtEnd());
+    REPORTER_ASSERT(r, 0 == stream->bytesAvailable());
+
+    REPORTER_ASSERT(r, executor.runOne());
+    REPORTER_ASSERT(r, 1 == callbacks);
+    const size_t available = stream->bytesAvailable();
+    REPORTER_ASSERT(r, available > 0 && available < data->size());
+    REPORTER_ASSERT(r, !stream->sourceIsDone());
+
+    REPORTER_ASSERT(r, 10 == stream->peek(buffer, 10));
+    REPORTER_ASSERT(r, 0 == stream->getPosition());
+    REPORTER_ASSERT(r, available == stream->read(buffer, sizeof(buffer)));
+    REPORTER_ASSERT(r, !memcmp(buffer, data->data(), available));
+    REPORTER_ASSERT(r, !stream->isAtEnd());
+
+    while (executor.runOne()) {}
+    REPORTER_ASSERT(r, stream->sourceIsDone());
+    REPORTER_ASSERT(r, data->size() == stream->bytesAvailable());
+    REPORTER_ASSERT(r, data->size() - available == stream->read(buffer + available,
+                                                                sizeof(buffer)));
+    REPORTER_ASSERT(r, !memcmp(buffer, data->data(), data->size()));
+    REPORTER_ASSERT(r, stream->isAtEnd());
+
+    // Everything is kept, so the stream can be read again.
+    REPORTER_ASSERT(r, stream->rewind());
+    REPORTER_ASSERT(r, !stream->isAtEnd());
+    REPORTER_ASSERT(r, 0 == stream->getPosition());
+    memset(buffer, 0, sizeof(buffer));
+    REPORTER_ASSERT(r, data->size() == stream->read(buffer, sizeof(buffer)));
+    REPORTER_ASSERT(r, !memcmp(buffer, data->data(), data->size()));
+}
+
+DEF_TEST(ReadaheadStream_stop, r) {
+    ManualExecutor executor;
+    auto stream = SkReadaheadStream::Make(skstd::make_unique<SkMemoryStream>(make_data(40000)),
+                                          &executor);
+    REPORTER_ASSERT(r, executor.runOne());
+    // Destroying the stream stops it reading the rest of the source.
+    stream.reset();
+    REPORTER_ASSERT(r, !executor.runOne());
+}
+
+// A progressive jpeg shows a preview while its data is still arriving, and finishes once it has
+// all arrived.
+DEF_TEST(ReadaheadStream_incrementalDecode, r) {
+    const char* path = "images/brickwork-texture.jpg";
+    sk_sp<SkData> file = GetResourceAsData(path);
+    if (!file) {
+        return;
+    }
+
+    SkBitmap truth;
+    std::unique_ptr<SkCodec> truthCodec = SkCodec::MakeFromData(file);
+    if (!truthCodec) {
+        ERRORF(r, "Failed to create codec from %s", path);
+        return;
+    }
+    const SkImageInfo info = truthCodec->getInfo().makeColorType(kN32_SkColorType)
+                                                  .makeAlphaType(kPremul_SkAlphaType);
+    truth.allocPixels(info);
+    REPORTER_ASSERT(r, SkCodec::kSuccess == truthCodec->getPixels(truth.pixmap()));
+
+    ManualExecutor executor;
+    auto stream = SkReadaheadStream::Make(skstd::make_unique<SkMemoryStream>(file), &executor);
+    SkReadaheadStream* readahead = stream.get();
+    REPORTER_ASSERT(r, executor.runOne());
+    std::unique_ptr<SkCodec> codec = SkCodec::MakeFromStream(std::move(stream));
+    if (!codec) {
+        ERRORF(r, "Failed to create codec from the start of %s", path);
+        return;
+    }
+
+    SkBitmap bm;
+    bm.allocPixels(info);
+    REPORTER_ASSERT(r, SkCodec::kSuccess == codec->startIncrementalDecode(info, bm.getPixels(),
+                                                                          bm.rowBytes()));
+    int previews = 0;
+    for (;;) {
+        int rowsDecoded = 0;
+        SkCodec::Result result = codec->incrementalDecode(&rowsDecoded);
+        if (SkCodec::kSuccess == result) {
+            break;
+        }
+        REPORTER_ASSERT(r, SkCodec::kIncompleteInput == result);
+        previews += info.height() == rowsDecoded;
+        if (!executor.runOne()) {
+            ERRORF(r, "Failed to completely decode %s", path);
+            return;
+        }
+    }
+    REPORTER_ASSERT(r, readahead->sourceIsDone());
+    REPORTER_ASSERT(r, previews > 0);
+    REPORTER_ASSERT(r, !memcmp(bm.getPixels(), truth.getPixels(), truth.computeByteSize()));
+}
@@ -427,3 +427,159 @@ DEF_TEST(savelayer_srcmode_alpha, r) {
     do_savelayer_srcmode(r, 0x80FF0000);
 }
 
+
+DEF_TEST(RecordOpts_MergeTranslates, r) {
+    SkRecord record;
+    SkRecorder recorder(&record, W, H);
+
+    recorder.translate(1, 2);
+    recorder.concat(SkMatrix::MakeTrans(3, 4));
+    recorder.drawRect(SkRect::MakeWH(10, 10), SkPaint());
+    recorder.translate(5, 6);
+    recorder.concat(SkMatrix::MakeScale(2, 2));  // Not a translation, so this one stays.
+
+    SkRecordMergeTranslates(&record);
+    assert_type<SkRecords::NoOp>(r, record, 0);
+    const SkRecords::Translate* translate = assert_type<SkRecords::Translate>(r, record, 1);
+    REPORTER_ASSERT(r, translate->dx == 4 && translate->dy == 6);
+    assert_type<SkRecords::DrawRect>(r, record, 2);
+    assert_type<SkRecords::Translate>(r, record, 3);
+    assert_type<SkRecords::Concat>(r, record, 4);
+}
+
+DEF_TEST(RecordOpts_NoopRedundantClipRects, r) {
+    SkRecord record;
+    SkRecorder recorder(&record, W, H);
+
+    recorder.clipRect(SkRect::MakeWH(100, 100));
+    recorder.clipRect(SkRect::MakeWH(200, 200));          // 1: contains the clip, goes away.
+    recorder.save();
+        recorder.clipRect(SkRect::MakeWH(50, 50));
+        recorder.clipRect(SkRect::MakeWH(60, 60));        // 4: goes away.
+        recorder.clipRect(SkRect::MakeWH(60, 60), true);  // 5: antialiased, stays.
+    recorder.restore();
+    recorder.clipRect(SkRect::MakeWH(80, 80));            // 7: smaller than the clip, stays.
+    recorder.translate(10, 10);
+    recorder.clipRect(SkRect::MakeWH(200, 200));          // 9: new coordinates, stays.
+    recorder.clipRect(SkRect::MakeWH(300, 300));          // 10: goes away.
+
+    SkRecordNoopRedundantClipRects(&record);
+    for (int index : {1, 4, 10}) {
+        assert_type<SkRecords::NoOp>(r, record, index);
+    }
+    for (int index : {0, 3, 5, 7, 9}) {
+        assert_type<SkRecords::ClipRect>(r, record, index);
+    }
+}
+
+DEF_TEST(RecordOpts_NoopOccludedDraws, r) {
+    SkRecord record;
+    SkRecorder recorder(&record, W, H);
+
+    SkPaint aa;
+    aa.setAntiAlias(true);
+    SkPaint translucent;
+    translucent.setAlpha(0x80);
+
+    recorder.drawOval(SkRect::MakeXYWH(10, 10, 20, 20), SkPaint());  // 0: covered, goes away.
+    recorder.drawOval(SkRect::MakeXYWH(10, 10, 20, 20), aa);         // 1: antialiased, stays.
+    recorder.drawRect(SkRect::MakeXYWH(10, 10, 90, 90), translucent);
+    recorder.drawRect(SkRect::MakeXYWH(50, 50, 80, 80), SkPaint());  // 3: not covered, stays.
+    recorder.drawRect(SkRect::MakeXYWH(0, 0, 100, 100), SkPaint());  // Covers 0 and 2.
+    recorder.clipRect(SkRect::MakeWH(50, 50));
+    recorder.drawRect(SkRect::MakeWH(100, 100), SkPaint());          // 6: after a clip, stays.
+
+    SkRecordNoopOccludedDraws(&record);
+    for (int index : {0, 2}) {
+        assert_type<SkRecords::NoOp>(r, record, index);
+    }
+    assert_type<SkRecords::DrawOval>(r, record, 1);
+    for (int index : {3, 4, 6}) {
+        assert_type<SkRecords::DrawRect>(r, record, index);
+    }
+}
+
+DEF_TEST(RecordOpts_BatchDraws, r) {
+    SkRecord record;
+    SkRecorder recorder(&record, W, H);
+
+    SkPaint blue;
+    blue.setColor(SK_ColorBLUE);
+    sk_sp<SkImage> image = SkSurface::MakeRasterN32Premul(16, 16)->makeImageSnapshot();
+
+    // 0-2: disjoint integer rects with the same paint become a region.
+    for (int i = 0; i < 3; i++) {
+        recorder.drawRect(SkRect::MakeXYWH(20 * i, 0, 10, 10), blue);
+    }
+    // 3-4: 3 overlaps the region so far, so it starts a new one.
+    recorder.drawRect(SkRect::MakeXYWH(5, 5, 10, 10), blue);
+    recorder.drawRect(SkRect::MakeXYWH(100, 0, 10, 10), blue);
+    blue.setAntiAlias(true);
+    recorder.drawRect(SkRect::MakeXYWH(200, 0, 10, 10), blue);  // 5: AA, stays.
+    // 6-8: image rects become an image set.
+    for (int i = 0; i < 3; i++) {
+        recorder.drawImageRect(image, SkRect::MakeXYWH(20 * i, 50, 16, 16), nullptr);
+    }
+    recorder.drawImageRect(image, SkRect::MakeWH(16, 16), SkRect::MakeXYWH(0, 100, 16, 16),
+                           nullptr, SkCanvas::kStrict_SrcRectConstraint);  // 9: stays.
+
+    SkRecordBatchDraws(&record);
+    const SkRecords::DrawRegion* region = assert_type<SkRecords::DrawRegion>(r, record, 0);
+    REPORTER_ASSERT(r, region->region.computeRegionComplexity() == 3);
+    assert_type<SkRecords::DrawRegion>(r, record, 3);
+    for (int index : {1, 2, 4, 7, 8}) {
+        assert_type<SkRecords::NoOp>(r, record, index);
+    }
+    assert_type<SkRecords::DrawRect>(r, record, 5);
+    const SkRecords::DrawImageSet* set = assert_type<SkRecords::DrawImageSet>(r, record, 6);
+    REPORTER_ASSERT(r, set->count == 3);
+    REPORTER_ASSERT(r, set->set[2].fDstRect == SkRect::MakeXYWH(40, 50, 16, 16));
+    assert_type<SkRecords::DrawImageRect>(r, record, 9);
+}
+
+// Pictures finished with kOptimizeDrawCalls_FinishFlag should still draw the same pixels.
+DEF_TEST(RecordOpts_OptimizeDrawCallsDrawsSame, r) {
+    sk_sp<SkImage> image;
+    {
+        sk_sp<SkSurface> surface = SkSurface::MakeRasterN32Premul(16, 16);
+        surface->getCanvas()->clear(SK_ColorGREEN);
+        image = surface->makeImageSnapshot();
+    }
+
+    SkPictureRecorder recorders[2];
+    for (SkPictureRecorder& recorder : recorders) {
+        SkCanvas* canvas = recorder.beginRecording(100, 100);
+        SkPaint red, blue;
+        red.setColor(SK_ColorRED);
+        blue.setColor(0x800000FF);
+        canvas->drawCircle(30, 30, 10, red);
+        canvas->drawRect(SkRect::MakeWH(50, 50), red);
+        canvas->translate(5, 5);
+        canvas->translate(5, 5);
+        canvas->clipRect(SkRect::MakeWH(80, 80));
+        canvas->clipRect(SkRect::MakeWH(90, 90));
+        for (int i = 0; i < 4; i++) {
+            canvas->drawRect(SkRect::MakeXYWH(20 * i, 0, 10, 10), blue);
+            canvas->drawImageRect(image, SkRect::MakeXYWH(20 * i, 40, 16, 16), nullptr);
+        }
+        for (int i = 0; i < 4; i++) {
+            canvas->drawRect(SkRect::MakeXYWH(20 * i, 60, 10, 10), blue);
+        }
+    }
+    sk_sp<SkPicture> plain = recorders[0].finishRecordingAsPicture(),
+                     optimized = recorders[1].finishRecordingAsPicture(
+                             SkPictureRecorder::kOptimizeDrawCalls_FinishFlag);
+    REPORTER_ASSERT(r, optimized->approximateOpCount() < plain->approximateOpCount());
+
+    SkBitmap bitmaps[2];
+    int i = 0;
+    for (const sk_sp<SkPicture>& picture : {plain, optimized}) {
+        bitmaps[i].allocN32Pixels(100, 100);
+        SkCanvas canvas(bitmaps[i]);
+        canvas.clear(SK_ColorWHITE);
+        picture->playback(&canvas);
+        i++;
+    }
+    REPORTER_ASSERT(r, 0 == memcmp(bitmaps[0].getPixels(), bitmaps[1].getPixels(),
+                                   bitmaps[0].computeByteSize()));
+}
@@ -7,12 +7,16 @@
 
 #include "Test.h"
 
+#include "SkFont.h"
 #include "SkPictureRecorder.h"
 #include "SkRecord.h"
 #include "SkRecorder.h"
 #include "SkRecords.h"
 #include "SkShader.h"
 #include "SkSurface.h"
+#include "SkTextBlob.h"
+
+#include <vector>
 
 #define COUNT(T) + 1
 static const int kRecordTypes = SK_RECORD_TYPES(COUNT);
@@ -70,6 +74,65 @@ DEF_TEST(Recorder_RefLeaking, r) {
     REPORTER_ASSERT(r, paint.getShader()->unique());
 }
 
+// Collects the IDs of the paths and text blobs that are drawn.
+struct ContentIDs {
+    template <typename T>
+    void operator()(const T&) {}
+
+    void operator()(const SkRecords::DrawPath& op) { fPaths.push_back(op.path.getGenerationID()); }
+    void operator()(const SkRecords::ClipPath& op) { fPaths.push_back(op.path.getGenerationID()); }
+    void operator()(const SkRecords::DrawTextBlob& op) { fBlobs.push_back(op.blob->uniqueID()); }
+
+    std::vector<uint32_t> fPaths, fBlobs;
+};
+
+static SkPath make_triangle(SkScalar size) {
+    SkPath path;
+    path.moveTo(0, 0);
+    path.lineTo(size, 0);
+    path.lineTo(0, size);
+    path.close();
+    return path;
+}
+
+static sk_sp<SkTextBlob> make_blob(SkScalar x) {
+    SkFont font;
+    SkTextBlobBuilder builder;
+    const auto& run = builder.allocRun(font, 3, x, 0);
+    for (int i = 0; i < 3; i++) {
+        run.glyphs[i] = i + 1;
+    }
+    return builder.make();
+}
+
+DEF_TEST(Recorder_DedupesContent, r) {
+    for (bool dedupe : {false, true}) {
+        SkRecord record;
+        SkRecorder recorder(&record, 1920, 1080);
+        recorder.setDedupesContent(dedupe);
+
+        recorder.drawPath(make_triangle(10), SkPaint());
+        recorder.clipPath(make_triangle(10));
+        recorder.drawPath(make_triangle(20), SkPaint());
+        recorder.drawPath(make_triangle(10), SkPaint());
+        recorder.drawTextBlob(make_blob(0), 0, 0, SkPaint());
+        recorder.drawTextBlob(make_blob(5), 0, 0, SkPaint());
+        recorder.drawTextBlob(make_blob(0), 0, 0, SkPaint());
+
+        ContentIDs ids;
+        for (int i = 0; i < record.count(); i++) {
+            record.visit(i, ids);
+        }
+        REPORTER_ASSERT(r, 4 == ids.fPaths.size() && 3 == ids.fBlobs.size());
+        // Equal contents share one path or blob only when deduplicating.
+        REPORTER_ASSERT(r, dedupe == (ids.fPaths[0] == ids.fPaths[1]));
+        REPORTER_ASSERT(r, dedupe == (ids.fPaths[0] == ids.fPaths[3]));
+        REPORTER_ASSERT(r, ids.fPaths[0] != ids.fPaths[2]);
+        REPORTER_ASSERT(r, dedupe == (ids.fBlobs[0] == ids.fBlobs[2]));
+        REPORTER_ASSERT(r, ids.fBlobs[0] != ids.fBlobs[1]);
+    }
+}
+
 DEF_TEST(Recorder_drawImage_takeReference, reporter) {
 
     sk_sp<SkImage> image;
@@ -9,6 +9,7 @@
 #include "SkPath.h"
 #include "SkRandom.h"
 #include "SkRegion.h"
+#include "SkTDArray.h"
 #include "Test.h"
 
 static void Union(SkRegion* rgn, const SkIRect& rect) {
@@ -264,6 +265,57 @@ DEF_TEST(Region, reporter) {
     test_fromchrome(reporter);
 }
 
+// setRects() writes the runs of rects in bands directly; check it against repeated unions.
+DEF_TEST(Region_setRects_bands, reporter) {
+    SkRandom rand;
+    for (int i = 0; i < 200; i++) {
+        SkTDArray<SkIRect> rects;
+        int y = 0;
+        for (int row = 0; row < 8; row++) {
+            // Rows may abut, overlap (breaking the bands) or leave gaps.
+            y += (int)(rand.nextU() % 3) - (0 == i % 10 ? 1 : 0);
+            const int h = 1 + rand.nextU() % 3;
+            int x = 0;
+            for (int col = 0; col < 8; col++) {
+                x += (int)(rand.nextU() % 3) - 1;
+                const int w = rand.nextU() % 4;  // some are empty
+                if (rand.nextU() % 4) {
+                    rects.push_back(SkIRect::MakeXYWH(x, y, w, h));
+                }
+                x += w;
+            }
+            y += h;
+        }
+        // The order of the rects shouldn't matter.
+        for (int j = rects.count() - 1; j > 0; j--) {
+            std::swap(rects[j], rects[rand.nextU() % (j + 1)]);
+        }
+        REPORTER_ASSERT(reporter, test_rects(rects.begin(), rects.count()));
+    }
+}
+
+// Ops with a single rect take a shortcut per span; check them against ops that don't.
+DEF_TEST(Region_op_rect, reporter) {
+    SkRandom rand;
+    for (int i = 0; i < 1000; i++) {
+        SkRegion rgn;
+        randRgn(rand, &rgn, 1 + rand.nextU() % 16);
+        const SkIRect rect = randRect(rand);
+
+        SkRegion sect, expected;
+        sect.op(rgn, rect, SkRegion::kIntersect_Op);
+        expected.op(rgn, rect, SkRegion::kDifference_Op);
+        expected.op(rgn, expected, SkRegion::kDifference_Op);
+        REPORTER_ASSERT(reporter, sect == expected);
+
+        SkRegion uni;
+        uni.op(rgn, rect, SkRegion::kUnion_Op);
+        expected.op(rgn, rect, SkRegion::kDifference_Op);
+        expected.op(expected, rect, SkRegion::kXOR_Op);
+        REPORTER_ASSERT(reporter, uni == expected);
+    }
+}
+
 // Test that writeToMemory reports the same number of bytes whether there was a
 // buffer to write to or not.
 static void test_write(const SkRegion& region, skiatest::Reporter* r) {
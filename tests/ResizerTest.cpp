@@ -0,0 +1,125 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkAutoPixmapStorage.h"
+#include "SkColorData.h"
+#include "SkExecutor.h"
+#include "SkResizer.h"
+#include "Test.h"
+
+#include <cstdlib>
+
+// A gradient that's easy to check averages of: red along x, green along y.
+static void fill_gradient(const SkPixmap& pm) {
+    for (int y = 0; y < pm.height(); ++y) {
+        for (int x = 0; x < pm.width(); ++x) {
+            *pm.writable_addr32(x, y) = SkPackARGB32(0xFF,
+                                                     x * 255 / (pm.width() - 1),
+                                                     y * 255 / (pm.height() - 1),
+                                                     0);
+        }
+    }
+}
+
+DEF_TEST(Resizer_SolidColor, reporter) {
+    const SkImageInfo srcInfo = SkImageInfo::MakeN32Premul(301, 157);
+    SkAutoPixmapStorage src;
+    src.alloc(srcInfo);
+    src.erase(SkPreMultiplyARGB(0x80, 0x20, 0x40, 0xC0));
+
+    for (auto filter : { SkResizer::Filter::kMitchell, SkResizer::Filter::kLanczos3 }) {
+        for (auto size : { SkISize{150, 78}, SkISize{37, 19}, SkISize{1, 1}, SkISize{301, 20} }) {
+            SkAutoPixmapStorage dst;
+            dst.alloc(srcInfo.makeWH(size.width(), size.height()));
+            REPORTER_ASSERT(reporter, SkResizer::Resize(dst, src, filter));
+            for (int y = 0; y < dst.height(); ++y) {
+                for (int x = 0; x < dst.width(); ++x) {
+                    REPORTER_ASSERT(reporter, *dst.addr32(x, y) == *src.addr32());
+                }
+            }
+        }
+    }
+}
+
+DEF_TEST(Resizer_Downscale, reporter) {
+    const SkImageInfo srcInfo = SkImageInfo::MakeN32Premul(400, 300);
+    SkAutoPixmapStorage src;
+    src.alloc(srcInfo);
+    fill_gradient(src);
+
+    // A linear gradient stays one, so each pixel should be about the average of the source
+    // pixels it covers.
+    SkAutoPixmapStorage dst;
+    dst.alloc(srcInfo.makeWH(40, 30));
+    REPORTER_ASSERT(reporter, SkResizer::Resize(dst, src));
+    for (int y = 1; y < dst.height() - 1; ++y) {
+        for (int x = 1; x < dst.width() - 1; ++x) {
+            const SkPMColor c = *dst.addr32(x, y);
+            const int r = (int)((x * 10 + 4.5f) * 255 / 399),
+                      g = (int)((y * 10 + 4.5f) * 255 / 299);
+            REPORTER_ASSERT(reporter, SkGetPackedA32(c) == 0xFF);
+            REPORTER_ASSERT(reporter, std::abs((int)SkGetPackedR32(c) - r) <= 2);
+            REPORTER_ASSERT(reporter, std::abs((int)SkGetPackedG32(c) - g) <= 2);
+            REPORTER_ASSERT(reporter, SkGetPackedB32(c) == 0);
+        }
+    }
+}
+
+DEF_TEST(Resizer_Executor, reporter) {
+    const SkImageInfo srcInfo = SkImageInfo::MakeN32Premul(512, 700);
+    SkAutoPixmapStorage src;
+    src.alloc(srcInfo);
+    fill_gradient(src);
+
+    // Bands of rows filtered on other threads must come out just like filtering all of them here.
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+    SkAutoPixmapStorage expected, actual;
+    expected.alloc(srcInfo.makeWH(200, 90));
+    actual.alloc(srcInfo.makeWH(200, 90));
+    REPORTER_ASSERT(reporter, SkResizer::Resize(expected, src, SkResizer::Filter::kLanczos3));
+    REPORTER_ASSERT(reporter, SkResizer::Resize(actual, src, SkResizer::Filter::kLanczos3,
+                                                executor.get()));
+    REPORTER_ASSERT(reporter, 0 == memcmp(expected.addr(), actual.addr(),
+                                          expected.computeByteSize()));
+}
+
+DEF_TEST(Resizer_CanResize, reporter) {
+    const SkImageInfo info = SkImageInfo::MakeN32Premul(16, 16);
+    SkAutoPixmapStorage src, dst;
+    src.alloc(info);
+    dst.alloc(info.makeWH(4, 4));
+    REPORTER_ASSERT(reporter, SkResizer::CanResize(dst, src));
+
+    auto reinterpret = [](const SkPixmap& pm, const SkImageInfo& info) {
+        return SkPixmap(info, pm.addr(), pm.rowBytes());
+    };
+    REPORTER_ASSERT(reporter, !SkResizer::CanResize(
+            dst, reinterpret(src, info.makeAlphaType(kUnpremul_SkAlphaType))));
+    REPORTER_ASSERT(reporter, !SkResizer::CanResize(
+            reinterpret(dst, dst.info().makeAlphaType(kUnpremul_SkAlphaType)), src));
+    REPORTER_ASSERT(reporter, !SkResizer::CanResize(
+            reinterpret(dst, dst.info().makeColorType(kRGB_565_SkColorType)), src));
+    REPORTER_ASSERT(reporter, !SkResizer::CanResize(
+            reinterpret(dst, dst.info().makeColorSpace(SkColorSpace::MakeSRGB())), src));
+    REPORTER_ASSERT(reporter, !SkResizer::CanResize(SkPixmap(), src));
+}
+
+DEF_TEST(Resizer_ScalePixels, reporter) {
+    const SkImageInfo srcInfo = SkImageInfo::MakeN32Premul(320, 240);
+    SkAutoPixmapStorage src;
+    src.alloc(srcInfo);
+    fill_gradient(src);
+
+    // kHigh_SkFilterQuality downscales of 2x or more go through SkResizer.
+    SkAutoPixmapStorage expected, actual;
+    expected.alloc(srcInfo.makeWH(64, 48));
+    actual.alloc(srcInfo.makeWH(64, 48));
+    REPORTER_ASSERT(reporter, SkResizer::Resize(expected, src));
+    REPORTER_ASSERT(reporter, src.scalePixels(actual, kHigh_SkFilterQuality));
+    REPORTER_ASSERT(reporter, 0 == memcmp(expected.addr(), actual.addr(),
+                                          expected.computeByteSize()));
+}
@@ -253,6 +253,60 @@ DEF_GPUTEST_FOR_RENDERING_CONTEXTS(ResourceAllocatorTest, reporter, ctxInfo) {
     resourceProvider->testingOnly_setExplicitlyAllocateGPUResources(orig);
 }
 
+bool GrResourceProvider::testingOnly_setReuseLargerTransientSurfaces(bool newValue) {
+    bool oldValue = fReuseLargerTransientSurfaces;
+    fReuseLargerTransientSurfaces = newValue;
+    return oldValue;
+}
+
+// Approx-fit proxies may reuse free surfaces one size bucket larger, and the peak bytes only
+// count surfaces that are in use at once.
+DEF_GPUTEST_FOR_RENDERING_CONTEXTS(ResourceAllocatorLargerSurfaceTest, reporter, ctxInfo) {
+    const GrCaps* caps = ctxInfo.grContext()->contextPriv().caps();
+    GrProxyProvider* proxyProvider = ctxInfo.grContext()->contextPriv().proxyProvider();
+    GrResourceProvider* resourceProvider = ctxInfo.grContext()->contextPriv().resourceProvider();
+
+    bool origExplicit = resourceProvider->testingOnly_setExplicitlyAllocateGPUResources(true);
+    bool origReuse = resourceProvider->testingOnly_setReuseLargerTransientSurfaces(true);
+
+    const ProxyParams kBig   = { 255, true, kRGBA_8888_SkColorType, SkBackingFit::kApprox, 0,
+                                 kTopLeft_GrSurfaceOrigin };
+    const ProxyParams kSmall = { 127, true, kRGBA_8888_SkColorType, SkBackingFit::kApprox, 0,
+                                 kTopLeft_GrSurfaceOrigin };
+    const ProxyParams kTiny  = {  63, true, kRGBA_8888_SkColorType, SkBackingFit::kApprox, 0,
+                                 kTopLeft_GrSurfaceOrigin };
+
+    GrSurfaceProxy* big = make_deferred(proxyProvider, caps, kBig);
+    GrSurfaceProxy* small = make_deferred(proxyProvider, caps, kSmall);
+    GrSurfaceProxy* tiny = make_deferred(proxyProvider, caps, kTiny);
+    {
+        GrUninstantiateProxyTracker uninstantiateTracker;
+        GrResourceAllocator alloc(resourceProvider, &uninstantiateTracker);
+
+        alloc.addInterval(big, 0, 2);
+        alloc.addInterval(small, 3, 5);
+        alloc.addInterval(tiny, 6, 8);
+        alloc.markEndOfOpList(0);
+
+        int startIndex, stopIndex;
+        GrResourceAllocator::AssignError error;
+        alloc.assign(&startIndex, &stopIndex, &error);
+        REPORTER_ASSERT(reporter, GrResourceAllocator::AssignError::kNoError == error);
+
+        // The 128x128 bucket may take the free 256x256 surface, but the 64x64 one is too small.
+        REPORTER_ASSERT(reporter, big->underlyingUniqueID() == small->underlyingUniqueID());
+        REPORTER_ASSERT(reporter, big->underlyingUniqueID() != tiny->underlyingUniqueID());
+        REPORTER_ASSERT(reporter, small->width() == 127 && small->worstCaseWidth() == 256);
+        REPORTER_ASSERT(reporter, alloc.peakTransientBytes() == big->gpuMemorySize());
+    }
+    big->completedRead();
+    small->completedRead();
+    tiny->completedRead();
+
+    resourceProvider->testingOnly_setReuseLargerTransientSurfaces(origReuse);
+    resourceProvider->testingOnly_setExplicitlyAllocateGPUResources(origExplicit);
+}
+
 static void draw(GrContext* context) {
     SkImageInfo ii = SkImageInfo::Make(1024, 1024, kRGBA_8888_SkColorType, kPremul_SkAlphaType);
 
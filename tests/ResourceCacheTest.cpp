@@ -24,8 +24,11 @@
 #include "SkMessageBus.h"
 #include "SkMipMap.h"
 #include "SkSurface.h"
+#include "SkTraceMemoryDump.h"
 #include "Test.h"
 
+#include <map>
+#include <string>
 #include <thread>
 
 static const int gWidth = 640;
@@ -1328,9 +1331,10 @@ static void test_partial_purge(skiatest::Reporter* reporter) {
                 break;
             }
             case kPartial_TestCase: {
+                // Scratch resources have the lowest purge priority, so scratch1 goes first.
                 context->purgeUnlockedResources(13, false);
-                REPORTER_ASSERT(reporter, 3 == cache->getBudgetedResourceCount());
-                REPORTER_ASSERT(reporter, 37 == cache->getBudgetedResourceBytes());
+                REPORTER_ASSERT(reporter, 4 == cache->getBudgetedResourceCount());
+                REPORTER_ASSERT(reporter, 47 == cache->getBudgetedResourceBytes());
                 break;
             }
             case kAll_TestCase: {
@@ -1503,6 +1507,136 @@ static void test_tags(skiatest::Reporter* reporter) {
 #endif
 }
 
+namespace {
+// Records the values that GrResourceCache dumps for each purge priority.
+class PurgePriorityDump : public SkTraceMemoryDump {
+public:
+    void dumpNumericValue(const char* dumpName, const char* valueName, const char*,
+                          uint64_t value) override {
+        if (!strcmp(dumpName, "skia/gpu_resources/purge_priorities")) {
+            fValues[valueName] = value;
+        }
+    }
+    void setMemoryBacking(const char*, const char*, const char*) override {}
+    void setDiscardableMemoryBacking(const char*, const SkDiscardableMemory&) override {}
+    LevelOfDetail getRequestedDetails() const override {
+        return SkTraceMemoryDump::kObjectsBreakdowns_LevelOfDetail;
+    }
+
+    uint64_t value(const char* valueName) { return fValues[valueName]; }
+
+private:
+    std::map<std::string, uint64_t> fValues;
+};
+}  // namespace
+
+static void test_purge_priority(skiatest::Reporter* reporter) {
+    Mock mock(10, 300);
+    GrContext* context = mock.context();
+    GrResourceCache* cache = mock.cache();
+    GrGpu* gpu = context->contextPriv().getGpu();
+
+    GrUniqueKey uniqueKey, expensiveKey;
+    make_unique_key<0>(&uniqueKey, 0);
+    make_unique_key<0>(&expensiveKey, 1);
+
+    TestResource* expensive = new TestResource(gpu, SkBudgeted::kYes, 10);
+    expensive->resourcePriv().setUniqueKey(expensiveKey);
+    expensive->resourcePriv().setPurgePriority(GrGpuResource::PurgePriority::kCCPRCache);
+    TestResource* unique = new TestResource(gpu, SkBudgeted::kYes, 11);
+    unique->resourcePriv().setUniqueKey(uniqueKey);
+    TestResource* scratch = TestResource::CreateScratch(gpu, SkBudgeted::kYes,
+                                                        TestResource::kA_SimulatedProperty, 12);
+    TestResource* atlas = TestResource::CreateScratch(gpu, SkBudgeted::kYes,
+                                                      TestResource::kB_SimulatedProperty, 13);
+    atlas->resourcePriv().setPurgePriority(GrGpuResource::PurgePriority::kGlyphAtlas);
+
+    // Make all but the atlas purgeable, least recently used first.
+    expensive->unref();
+    unique->unref();
+    scratch->unref();
+
+    PurgePriorityDump dump;
+    cache->dumpMemoryStatistics(&dump);
+    REPORTER_ASSERT(reporter, 12 == dump.value("scratch_bytes"));
+    REPORTER_ASSERT(reporter, 12 == dump.value("scratch_purgeable_bytes"));
+    REPORTER_ASSERT(reporter, 11 == dump.value("unique_key_bytes"));
+    REPORTER_ASSERT(reporter, 10 == dump.value("ccpr_cache_purgeable_bytes"));
+    REPORTER_ASSERT(reporter, 13 == dump.value("glyph_atlas_bytes"));
+    REPORTER_ASSERT(reporter, 0 == dump.value("glyph_atlas_purgeable_bytes"));
+
+    // Despite LRU order, the scratch resource is purged first, then the uniquely keyed one.
+    context->setResourceCacheLimits(10, 35);
+    REPORTER_ASSERT(reporter, 3 == TestResource::NumAlive());
+    REPORTER_ASSERT(reporter, cache->hasUniqueKey(uniqueKey));
+    context->setResourceCacheLimits(10, 25);
+    REPORTER_ASSERT(reporter, 2 == TestResource::NumAlive());
+    REPORTER_ASSERT(reporter, !cache->hasUniqueKey(uniqueKey));
+    REPORTER_ASSERT(reporter, cache->hasUniqueKey(expensiveKey));
+
+    // Once nothing refers to it, the keyless atlas page is only good as scratch.
+    atlas->unref();
+    cache->dumpMemoryStatistics(&dump);
+    REPORTER_ASSERT(reporter, 13 == dump.value("scratch_purgeable_bytes"));
+    REPORTER_ASSERT(reporter, 0 == dump.value("glyph_atlas_bytes"));
+    context->setResourceCacheLimits(10, 20);
+    REPORTER_ASSERT(reporter, 1 == TestResource::NumAlive());
+    REPORTER_ASSERT(reporter, cache->hasUniqueKey(expensiveKey));
+
+    cache->purgeAllUnlocked();
+    REPORTER_ASSERT(reporter, 0 == TestResource::NumAlive());
+}
+
+static void test_flush_purge(skiatest::Reporter* reporter) {
+    Mock mock(10, 300);
+    GrContext* context = mock.context();
+    GrResourceCache* cache = mock.cache();
+    GrGpu* gpu = context->contextPriv().getGpu();
+
+    GrUniqueKey key1, key2;
+    make_unique_key<0>(&key1, 1);
+    make_unique_key<0>(&key2, 2);
+
+    // By default resources are never purged for going unused.
+    TestResource* r1 = new TestResource(gpu);
+    r1->resourcePriv().setUniqueKey(key1);
+    r1->unref();
+    for (int i = 0; i < 10; ++i) {
+        cache->notifyFlushOccurred();
+    }
+    REPORTER_ASSERT(reporter, cache->hasUniqueKey(key1));
+
+    cache->setMaxUnusedLimits(3, GrStdSteadyClock::duration::zero());
+    TestResource* r2 = new TestResource(gpu);
+    r2->resourcePriv().setUniqueKey(key2);
+    r2->unref();
+    cache->notifyFlushOccurred();
+    REPORTER_ASSERT(reporter, !cache->hasUniqueKey(key1));
+    REPORTER_ASSERT(reporter, cache->hasUniqueKey(key2));
+
+    // Using a resource restarts its count.
+    cache->notifyFlushOccurred();
+    cache->findAndRefUniqueResource(key2)->unref();
+    cache->notifyFlushOccurred();
+    cache->notifyFlushOccurred();
+    REPORTER_ASSERT(reporter, cache->hasUniqueKey(key2));
+    cache->notifyFlushOccurred();
+    REPORTER_ASSERT(reporter, !cache->hasUniqueKey(key2));
+
+    // The time limit works the same way.
+    cache->setMaxUnusedLimits(0, std::chrono::hours(1));
+    r1 = new TestResource(gpu);
+    r1->resourcePriv().setUniqueKey(key1);
+    r1->unref();
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    cache->notifyFlushOccurred();
+    REPORTER_ASSERT(reporter, cache->hasUniqueKey(key1));
+    cache->setMaxUnusedLimits(0, std::chrono::milliseconds(1));
+    cache->notifyFlushOccurred();
+    REPORTER_ASSERT(reporter, !cache->hasUniqueKey(key1));
+    REPORTER_ASSERT(reporter, 0 == TestResource::NumAlive());
+}
+
 static void test_free_resource_messages(skiatest::Reporter* reporter) {
     Mock mock(10, 30000);
     GrContext* context = mock.context();
@@ -1561,6 +1695,8 @@ DEF_GPUTEST(ResourceCacheMisc, reporter, /* options */) {
     test_custom_data(reporter);
     test_abandoned(reporter);
     test_tags(reporter);
+    test_purge_priority(reporter);
+    test_flush_purge(reporter);
     test_free_resource_messages(reporter);
 }
 
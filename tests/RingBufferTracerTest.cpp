@@ -0,0 +1,95 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkData.h"
+#include "SkJSON.h"
+#include "SkRingBufferTracer.h"
+#include "SkStream.h"
+#include "SkString.h"
+#include "SkTraceEventPhase.h"
+#include "Test.h"
+
+#include <thread>
+
+using namespace skjson;
+
+// Returns the events' phases and names, like "B:draw E:draw I:flush".
+static SkString dump_events(skiatest::Reporter* r, const SkRingBufferTracer& tracer) {
+    SkDynamicMemoryWStream stream;
+    tracer.dumpJSON(&stream);
+    sk_sp<SkData> json = stream.detachAsData();
+
+    SkString events;
+    DOM dom(static_cast<const char*>(json->data()), json->size());
+    if (!dom.root().is<ArrayValue>()) {
+        ERRORF(r, "Expected an array of events.");
+        return events;
+    }
+    for (const Value& v : dom.root().as<ArrayValue>()) {
+        const ObjectValue& event = v.as<ObjectValue>();
+        const StringValue* ph   = event["ph"];
+        const StringValue* name = event["name"];
+        const NumberValue* ts   = event["ts"];
+        REPORTER_ASSERT(r, ph && name && ts);
+        if (ph && name) {
+            events.appendf("%s%s:%s", events.isEmpty() ? "" : " ", ph->begin(), name->begin());
+        }
+    }
+    return events;
+}
+
+DEF_TEST(RingBufferTracer, r) {
+    SkRingBufferTracer tracer(8);
+    const uint8_t* category = tracer.getCategoryGroupEnabled("skia");
+    REPORTER_ASSERT(r, *category);
+    REPORTER_ASSERT(r, category == tracer.getCategoryGroupEnabled("skia"));
+    REPORTER_ASSERT(r, !strcmp("skia", tracer.getCategoryGroupName(category)));
+
+    auto begin = [&](const char* name) {
+        tracer.addTraceEvent(TRACE_EVENT_PHASE_COMPLETE, category, name,
+                             0, 0, nullptr, nullptr, nullptr, 0);
+    };
+    auto end = [&](const char* name) {
+        tracer.updateTraceEventDuration(category, name, 0);
+    };
+
+    REPORTER_ASSERT(r, dump_events(r, tracer).equals(""));
+
+    begin("frame");
+    begin("draw");
+    end("draw");
+    tracer.addTraceEvent(TRACE_EVENT_PHASE_INSTANT, category, "flush",
+                         0, 0, nullptr, nullptr, nullptr, 0);
+    end("frame");
+    REPORTER_ASSERT(r, dump_events(r, tracer).equals("B:frame B:draw E:draw I:flush E:frame"));
+
+    // Once the ring wraps around, ends whose begins have been overwritten are dropped.
+    for (int i = 0; i < 3; i++) {
+        begin("frame");
+        begin("draw");
+        end("draw");
+        end("frame");
+    }
+    REPORTER_ASSERT(r, dump_events(r, tracer).equals(
+            "B:frame B:draw E:draw E:frame B:frame B:draw E:draw E:frame"));
+
+    begin("frame");
+    begin("draw");
+    end("draw");
+    SkString events = dump_events(r, tracer);
+    REPORTER_ASSERT(r, events.equals("B:frame B:draw E:draw E:frame B:frame B:draw E:draw"),
+                    "%s", events.c_str());
+
+    // Each thread gets its own ring.
+    std::thread([&] {
+        begin("other");
+        end("other");
+    }).join();
+    events = dump_events(r, tracer);
+    REPORTER_ASSERT(r, events.endsWith("B:other E:other") || events.startsWith("B:other E:other"),
+                    "%s", events.c_str());
+}
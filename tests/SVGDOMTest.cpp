@@ -0,0 +1,79 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkBitmap.h"
+#include "SkCanvas.h"
+#include "SkStream.h"
+#include "Test.h"
+
+#ifdef SK_XML
+
+#include "SkSVGDOM.h"
+#include "SkSVGNode.h"
+#include "SkSVGValue.h"
+
+static SkColor render_pixel(const SkSVGDOM& dom, int x, int y) {
+    SkBitmap bm;
+    bm.allocN32Pixels(10, 10);
+    SkCanvas canvas(bm);
+    canvas.clear(SK_ColorWHITE);
+    dom.render(&canvas);
+    return bm.getColor(x, y);
+}
+
+DEF_TEST(SVGDOM_invalidation, reporter) {
+    static const char svg[] =
+        "<svg xmlns='http://www.w3.org/2000/svg' width='10' height='10'>"
+          "<defs>"
+            "<linearGradient id='grad'>"
+              "<stop id='s0' offset='0' stop-color='#00ff00'/>"
+              "<stop id='s1' offset='1' stop-color='#00ff00'/>"
+            "</linearGradient>"
+          "</defs>"
+          "<g fill='url(#grad)'>"
+            "<g><rect x='0' y='0' width='5' height='10'/></g>"
+          "</g>"
+          "<g><rect id='r' x='5' y='0' width='5' height='10' fill='#ff0000'/></g>"
+        "</svg>";
+
+    SkMemoryStream stream(svg, sizeof(svg) - 1);
+    sk_sp<SkSVGDOM> dom = SkSVGDOM::MakeFromStream(stream);
+    REPORTER_ASSERT(reporter, dom);
+    if (!dom) {
+        return;
+    }
+
+    // The second render replays the cached pictures.
+    for (int i = 0; i < 2; ++i) {
+        REPORTER_ASSERT(reporter, render_pixel(*dom, 2, 5) == SK_ColorGREEN);
+        REPORTER_ASSERT(reporter, render_pixel(*dom, 7, 5) == SK_ColorRED);
+    }
+
+    // A change to a node shows up in its own subtree...
+    sk_sp<SkSVGNode>* rect = dom->findNodeById("r");
+    REPORTER_ASSERT(reporter, rect);
+    if (rect) {
+        (*rect)->setAttribute(SkSVGAttribute::kFill,
+                              SkSVGPaintValue(SkSVGPaint(SkSVGColorType(SK_ColorBLUE))));
+        REPORTER_ASSERT(reporter, render_pixel(*dom, 7, 5) == SK_ColorBLUE);
+        REPORTER_ASSERT(reporter, render_pixel(*dom, 2, 5) == SK_ColorGREEN);
+    }
+
+    // ... and in subtrees painted with it, even those that only inherit the paint.
+    for (const char* id : { "s0", "s1" }) {
+        sk_sp<SkSVGNode>* stop = dom->findNodeById(id);
+        REPORTER_ASSERT(reporter, stop);
+        if (stop) {
+            (*stop)->setAttribute(SkSVGAttribute::kStopColor,
+                                  SkSVGColorValue(SkSVGColorType(SK_ColorBLACK)));
+        }
+    }
+    REPORTER_ASSERT(reporter, render_pixel(*dom, 2, 5) == SK_ColorBLACK);
+    REPORTER_ASSERT(reporter, render_pixel(*dom, 7, 5) == SK_ColorBLUE);
+}
+
+#endif
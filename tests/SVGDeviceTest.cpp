@@ -20,6 +20,7 @@
 #include "SkImage.h"
 #include "SkImageShader.h"
 #include "SkParse.h"
+#include "SkParsePath.h"
 #include "SkShader.h"
 #include "SkStream.h"
 #include "SkTo.h"
@@ -382,4 +383,42 @@ DEF_TEST(SVGDevice_ColorFilters, reporter) {
     REPORTER_ASSERT(reporter, strcmp(dom.findAttr(compositeElement, "operator"), "in") == 0);
 }
 
+// Path data is written in pieces, and must read back as the same path from either writer.
+DEF_TEST(SVGDevice_path_data, reporter) {
+    SkPath path;
+    path.moveTo(0.1f, 1.0f / 3);
+    for (int i = 0; i < 500; ++i) {  // Long enough to need several buffers.
+        path.lineTo(i * 0.7f, 100.0f / (i + 1));
+    }
+    path.cubicTo(1, 2, 3, 4, 0.1f, 1.0f / 3);  // Back to the start, so close adds no line.
+    path.close();
+
+    SkDOM dom;
+    {
+        SkXMLParserWriter writer(dom.beginParsing());
+        std::unique_ptr<SkCanvas> svgCanvas = SkSVGCanvas::Make(SkRect::MakeWH(400, 400), &writer);
+        svgCanvas->drawPath(path, SkPaint());
+    }
+    const SkDOM::Node* rootElement = dom.finishParsing();
+    ABORT_TEST(reporter, !rootElement, "root element not found");
+    const SkDOM::Node* pathElement = dom.getFirstChild(rootElement, "path");
+    ABORT_TEST(reporter, !pathElement, "path element not found");
+    const char* pathData = dom.findAttr(pathElement, "d");
+    ABORT_TEST(reporter, !pathData, "path data not found");
+
+    SkPath parsed;
+    REPORTER_ASSERT(reporter, SkParsePath::FromSVGString(pathData, &parsed));
+    REPORTER_ASSERT(reporter, parsed == path);
+
+    SkDynamicMemoryWStream stream;
+    {
+        std::unique_ptr<SkCanvas> svgCanvas = SkSVGCanvas::Make(SkRect::MakeWH(400, 400), &stream);
+        svgCanvas->drawPath(path, SkPaint());
+    }
+    sk_sp<SkData> svg = stream.detachAsData();
+    SkString expected = SkStringPrintf("d=\"%s\"", pathData);
+    SkString written(static_cast<const char*>(svg->data()), svg->size());
+    REPORTER_ASSERT(reporter, written.contains(expected.c_str()));
+}
+
 #endif
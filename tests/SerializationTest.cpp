@@ -784,3 +784,62 @@ DEF_TEST(WriteBuffer_external_memory_flattenable, reporter) {
     storage.realloc(storage_size);
     REPORTER_ASSERT(reporter, path_effect->serialize(storage.get(), storage_size) != 0u);
 }
+
+DEF_TEST(ReadBuffer_backing_data, reporter) {
+    const char bytes[] = "0123456789";
+    SkBinaryWriteBuffer writer;
+    writer.writeInt(42);
+    writer.writeByteArray(bytes, sizeof(bytes));
+    sk_sp<SkData> backing = SkData::MakeUninitialized(writer.bytesWritten());
+    writer.writeToMemory(backing->writable_data());
+
+    // Without backing data, byte arrays are copied out of the buffer.
+    SkReadBuffer copying(backing->data(), backing->size());
+    REPORTER_ASSERT(reporter, copying.readInt() == 42);
+    sk_sp<SkData> copy = copying.readByteArrayAsData();
+    REPORTER_ASSERT(reporter, copy && copy->size() == sizeof(bytes));
+    REPORTER_ASSERT(reporter, copy && 0 == memcmp(copy->data(), bytes, sizeof(bytes)));
+    REPORTER_ASSERT(reporter, copy && copy->bytes() != backing->bytes() + 8);
+
+    // With it, they reference the backing data in place, even when reading from a copy of it.
+    sk_sp<SkData> shifted = SkData::MakeWithCopy(backing->bytes() + 4, backing->size() - 4);
+    SkReadBuffer sharing(shifted->data(), shifted->size());
+    sharing.setBackingData(backing.get(), 4);
+    sk_sp<SkData> shared = sharing.readByteArrayAsData();
+    REPORTER_ASSERT(reporter, sharing.isValid() && sharing.eof());
+    REPORTER_ASSERT(reporter, shared && shared->bytes() == backing->bytes() + 8);
+    REPORTER_ASSERT(reporter, shared && shared->size() == sizeof(bytes));
+}
+
+DEF_TEST(ReadBuffer_trusted, reporter) {
+    // A nested picture, drawn with an image filter, so that both flattenables and pictures are
+    // read back through the buffer.
+    SkPictureRecorder recorder;
+    draw_something(recorder.beginRecording(SkRect::MakeWH(kBitmapSize, kBitmapSize)));
+    sk_sp<SkPicture> inner = recorder.finishRecordingAsPicture();
+
+    SkCanvas* canvas = recorder.beginRecording(SkRect::MakeWH(kBitmapSize, kBitmapSize));
+    SkPaint paint;
+    paint.setImageFilter(SkXfermodeImageFilter::Make(SkBlendMode::kSrcOver, nullptr));
+    paint.setColorFilter(SkColorFilter::MakeModeFilter(SK_ColorBLUE, SkBlendMode::kDstOver));
+    canvas->saveLayer(nullptr, &paint);
+    canvas->drawPicture(inner);
+    canvas->restore();
+    sk_sp<SkPicture> outer = recorder.finishRecordingAsPicture();
+    sk_sp<SkData> data = outer->serialize();
+
+    SkDeserialProcs procs;
+    procs.fTrusted = true;
+    sk_sp<SkPicture> trusted = SkPicture::MakeFromData(data.get(), &procs);
+    sk_sp<SkPicture> checked = SkPicture::MakeFromData(data.get());
+    REPORTER_ASSERT(reporter, trusted && checked);
+    if (trusted && checked) {
+        compare_bitmaps(reporter, draw_picture(*trusted), draw_picture(*checked));
+    }
+
+    // Factories are found again by name, and unknown names find nothing.
+    SkFlattenable::Factory factory = paint.getImageFilter()->getFactory();
+    const char* name = SkFlattenable::FactoryToName(factory);
+    REPORTER_ASSERT(reporter, name && SkFlattenable::NameToFactory(name) == factory);
+    REPORTER_ASSERT(reporter, !SkFlattenable::NameToFactory("SkNoSuchFlattenable"));
+}
@@ -5,6 +5,7 @@
  * found in the LICENSE file.
  */
 
+#include "SkBitmap.h"
 #include "SkCanvas.h"
 #include "SkDrawShadowInfo.h"
 #include "SkPath.h"
@@ -175,3 +176,45 @@ DEF_TEST(ShadowBounds, reporter) {
     path.cubicTo(100, 50, 20, 100, 0, 0);
     check_bounds(reporter, path);
 }
+
+static void draw_spot_shadow(SkBitmap* bm, const SkPath& path, SkScalar dx) {
+    bm->allocN32Pixels(160, 160);
+    SkCanvas canvas(*bm);
+    canvas.clear(SK_ColorWHITE);
+    canvas.translate(dx, 0);
+    // A small light off to the side, so the umbra is partly cut out by the opaque occluder.
+    SkShadowUtils::DrawShadow(&canvas, path, {0, 0, 20}, {-200, 50, 600}, 10,
+                              SK_ColorTRANSPARENT, SK_ColorBLACK);
+}
+
+DEF_TEST(ShadowCachedSpotReuse, reporter) {
+    SkPath path;
+    path.moveTo(30, 20);
+    path.lineTo(110, 30);
+    path.lineTo(120, 100);
+    path.lineTo(40, 110);
+    path.close();
+
+    auto verts = SkShadowTessellator::MakeSpot(path, SkMatrix::I(), {0, 0, 20}, {-200, 50, 600},
+                                               10, false, false);
+    REPORTER_ASSERT(reporter, verts && !verts->isVolatile());
+
+    // Fill the cache, then draw slightly moved so the light moves less than the tolerance
+    // relative to the occluder. The reused mesh has to land where a fresh one would.
+    SkBitmap cached, fresh;
+    draw_spot_shadow(&cached, path, 0);
+    draw_spot_shadow(&cached, path, 2);
+    SkPath volatilePath(path);
+    volatilePath.setIsVolatile(true);
+    draw_spot_shadow(&fresh, volatilePath, 2);
+
+    int maxDiff = 0;
+    for (int y = 0; y < cached.height(); ++y) {
+        for (int x = 0; x < cached.width(); ++x) {
+            SkColor a = cached.getColor(x, y), b = fresh.getColor(x, y);
+            maxDiff = SkTMax(maxDiff, SkTAbs((int)SkColorGetA(a) - (int)SkColorGetA(b)));
+            maxDiff = SkTMax(maxDiff, SkTAbs((int)SkColorGetR(a) - (int)SkColorGetR(b)));
+        }
+    }
+    REPORTER_ASSERT(reporter, maxDiff <= 4, "maxDiff %d", maxDiff);
+}
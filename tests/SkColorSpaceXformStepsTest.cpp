@@ -7,6 +7,9 @@
 
 #include "SkColorSpacePriv.h"
 #include "SkColorSpaceXformSteps.h"
+#include "SkConvertPixels.h"
+#include "SkExecutor.h"
+#include "SkRandom.h"
 #include "Test.h"
 
 DEF_TEST(SkColorSpaceXformSteps, r) {
@@ -169,3 +172,80 @@ DEF_TEST(SkColorSpaceXformSteps, r) {
                 (t&16) ? " true" : "false");
     }
 }
+
+DEF_TEST(SkColorSpaceXformSteps_byteTable, r) {
+    auto srgb   = SkColorSpace::MakeSRGB(),
+         adobe  = SkColorSpace::MakeRGB(g2Dot2_TransferFn, SkColorSpace::kAdobeRGB_Gamut),
+         srgb22 = SkColorSpace::MakeRGB(g2Dot2_TransferFn, SkColorSpace::    kSRGB_Gamut);
+
+    uint8_t table[256];
+    // Only transfer function changes can be done with a table.
+    SkColorSpaceXformSteps tf{srgb.get(), kOpaque_SkAlphaType, srgb22.get(), kOpaque_SkAlphaType};
+    REPORTER_ASSERT(r, tf.byteTable(table));
+    for (int i = 0; i < 256; i++) {
+        float rgba[4] = { i * (1/255.0f), 0, 0, 1 };
+        tf.apply(rgba);
+        REPORTER_ASSERT(r, table[i] == (uint8_t)(rgba[0] * 255 + 0.5f));
+    }
+    // Asking again finds the same table in the cache.
+    uint8_t again[256];
+    REPORTER_ASSERT(r, tf.byteTable(again) && 0 == memcmp(table, again, 256));
+
+    SkColorSpaceXformSteps gamut{srgb.get(), kOpaque_SkAlphaType,
+                                 adobe.get(), kOpaque_SkAlphaType},
+                           premul{srgb.get(), kPremul_SkAlphaType,
+                                  srgb22.get(), kPremul_SkAlphaType},
+                           none{srgb.get(), kOpaque_SkAlphaType, srgb.get(), kOpaque_SkAlphaType};
+    REPORTER_ASSERT(r, !gamut.byteTable(table));
+    REPORTER_ASSERT(r, !premul.byteTable(table));
+    REPORTER_ASSERT(r, !none.byteTable(table));
+}
+
+DEF_TEST(SkConvertPixels_bands, r) {
+    auto srgb   = SkColorSpace::MakeSRGB(),
+         adobe  = SkColorSpace::MakeRGB(g2Dot2_TransferFn, SkColorSpace::kAdobeRGB_Gamut),
+         srgb22 = SkColorSpace::MakeRGB(g2Dot2_TransferFn, SkColorSpace::    kSRGB_Gamut);
+
+    // Big enough to be split into bands.
+    const int w = 1000, h = 777;
+    SkImageInfo srcInfo = SkImageInfo::Make(w, h, kRGBA_8888_SkColorType, kUnpremul_SkAlphaType,
+                                            srgb);
+    SkAutoTMalloc<uint32_t> src(w * h);
+    SkRandom rand;
+    for (int i = 0; i < w * h; i++) {
+        src[i] = rand.nextU();
+    }
+
+    // A gamut change goes through the pipeline, a transfer function change through a table.
+    for (auto dstInfo : { srcInfo.makeColorType(kBGRA_8888_SkColorType).makeColorSpace(adobe),
+                          srcInfo.makeColorType(kBGRA_8888_SkColorType).makeColorSpace(srgb22),
+                          srcInfo.makeColorSpace(srgb22) }) {
+        SkAutoTMalloc<uint32_t> serial(w * h), parallel(w * h);
+        SkConvertPixels(dstInfo, serial.get(), 4 * w, srcInfo, src.get(), 4 * w);
+        {
+            // Enabler would leave the default pointing at its pool once it's gone.
+            std::unique_ptr<SkExecutor> pool = SkExecutor::MakeFIFOThreadPool(4);
+            SkExecutor::SetDefault(pool.get());
+            SkConvertPixels(dstInfo, parallel.get(), 4 * w, srcInfo, src.get(), 4 * w);
+            SkExecutor::SetDefault(nullptr);
+        }
+        REPORTER_ASSERT(r, 0 == memcmp(serial.get(), parallel.get(), 4 * w * h));
+
+        // Check a few pixels against the reference steps.
+        SkColorSpaceXformSteps steps{srcInfo.colorSpace(), srcInfo.alphaType(),
+                                     dstInfo.colorSpace(), dstInfo.alphaType()};
+        const bool swapRB = dstInfo.colorType() != srcInfo.colorType();
+        for (int i = 0; i < w * h; i += 997) {
+            float rgba[4];
+            for (int c = 0; c < 4; c++) {
+                rgba[c] = ((src[i] >> (8 * c)) & 0xFF) * (1/255.0f);
+            }
+            steps.apply(rgba);
+            for (int c = 0; c < 4; c++) {
+                int expected = (int)(SkTPin(rgba[c], 0.0f, 1.0f) * 255 + 0.5f),
+                    actual   = (serial[i] >> (8 * (swapRB && c != 3 ? 2 - c : c))) & 0xFF;
+                REPORTER_ASSERT(r, SkTAbs(expected - actual) <= 1, "%d vs %d", expected, actual);
+            }
+        }
+    }
+}
@@ -202,3 +202,32 @@ DEF_TEST(SkRasterPipeline_lowp_clamp01, r) {
     p.append(SkRasterPipeline::store_8888, &ptr);
     p.run(0,0,1,1);
 }
+
+DEF_TEST(SkRasterPipeline_compileCache, r) {
+    // Two pipelines with the same stages but different contexts share a cached program,
+    // and each must still run with its own contexts.
+    uint32_t srcA = 0xff0000ff, srcB = 0xff00ff00,
+             dstA = 0,          dstB = 0;
+    SkRasterPipeline_MemoryCtx loadA  = { &srcA, 0 }, loadB  = { &srcB, 0 },
+                               storeA = { &dstA, 0 }, storeB = { &dstB, 0 };
+
+    SkSTArenaAlloc<256> alloc;
+    auto build = [&](SkRasterPipeline_MemoryCtx* load, SkRasterPipeline_MemoryCtx* store) {
+        SkRasterPipeline p(&alloc);
+        p.append(SkRasterPipeline::load_8888, load);
+        p.append(SkRasterPipeline::swap_rb);
+        p.append(SkRasterPipeline::store_8888, store);
+        return p.compile();
+    };
+
+    auto fnA = build(&loadA, &storeA);
+    int hits = SkRasterPipeline::ProgramCacheHitCount();
+    auto fnB = build(&loadB, &storeB);
+    REPORTER_ASSERT(r, SkRasterPipeline::ProgramCacheHitCount() > hits);
+    REPORTER_ASSERT(r, SkRasterPipeline::ProgramCacheCountUsed() > 0);
+
+    fnA(0,0,1,1);
+    fnB(0,0,1,1);
+    REPORTER_ASSERT(r, dstA == 0xffff0000);
+    REPORTER_ASSERT(r, dstB == 0xff00ff00);
+}
@@ -850,3 +850,171 @@ DEF_TEST(SkRemoteGlyphCache_ReWriteGlyph, reporter) {
     // Must unlock everything on termination, otherwise valgrind complains about memory leaks.
     discardableManager->unlockAndDeleteAll();
 }
+
+DEF_TEST(SkStrikeStore_RoundTrip, reporter) {
+    auto tf = SkTypeface::MakeFromName("monospace", SkFontStyle());
+    SkString familyName;
+    tf->getFamilyName(&familyName);
+    // The store finds typefaces again by family name, so this only works if that gets us back
+    // the same typeface.
+    auto found = SkTypeface::MakeFromName(familyName.c_str(), tf->fontStyle());
+    if (familyName.isEmpty() || !found || found->uniqueID() != tf->uniqueID()) {
+        return;
+    }
+
+    SkFont font;
+    font.setTypeface(tf);
+    font.setSize(24);
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    paint.setTypeface(tf);
+
+    SkAutoDescriptor ad;
+    SkScalerContextRec rec;
+    SkScalerContextEffects effects;
+    SkScalerContext::MakeRecAndEffects(
+            font, paint, SkSurfacePropsCopyOrDefault(nullptr),
+            SkScalerContextFlags::kFakeGammaAndBoostContrast, SkMatrix::I(), &rec, &effects, false);
+    auto desc = SkScalerContext::AutoDescriptorGivenRecAndEffects(rec, effects, &ad);
+
+    const SkGlyphID glyphIDs[] = {1, 2, 3, 4};
+    std::vector<uint8_t> memory;
+    {
+        SkStrikeCache strikeCache;
+        {
+            auto strike = strikeCache.findOrCreateStrikeExclusive(*desc, effects, *tf);
+            for (SkGlyphID glyphID : glyphIDs) {
+                const SkGlyph& glyph = strike->getGlyphIDMetrics(glyphID);
+                strike->findImage(glyph);
+                strike->findPath(glyph);
+            }
+        }
+        SkStrikeStore::Serialize(&strikeCache, &memory);
+    }
+
+    SkStrikeCache strikeCache;
+    REPORTER_ASSERT(reporter,
+                    SkStrikeStore::Deserialize(memory.data(), memory.size(), &strikeCache) == 1);
+    {
+        auto strike = strikeCache.findStrikeExclusive(*desc);
+        REPORTER_ASSERT(reporter, strike);
+        if (!strike) {
+            return;
+        }
+        REPORTER_ASSERT(reporter, strike->countCachedGlyphs() == (int)SK_ARRAY_COUNT(glyphIDs));
+
+        // The loaded glyphs must match what the scaler context would make.
+        auto context = tf->createScalerContext(effects, desc, false);
+        for (SkGlyphID glyphID : glyphIDs) {
+            REPORTER_ASSERT(reporter, strike->isGlyphCached(glyphID, 0, 0));
+            SkGlyph* loaded = strike->getRawGlyphByID(SkPackedGlyphID(glyphID));
+
+            SkGlyph expected;
+            expected.initWithGlyphID(SkPackedGlyphID(glyphID));
+            context->getMetrics(&expected);
+            REPORTER_ASSERT(reporter, loaded->fWidth == expected.fWidth);
+            REPORTER_ASSERT(reporter, loaded->fHeight == expected.fHeight);
+            REPORTER_ASSERT(reporter, loaded->fAdvanceX == expected.fAdvanceX);
+
+            size_t imageSize = expected.computeImageSize();
+            if (imageSize) {
+                REPORTER_ASSERT(reporter, loaded->fImage);
+                SkAutoTMalloc<uint8_t> image(imageSize);
+                expected.fImage = image.get();
+                context->getImage(expected);
+                REPORTER_ASSERT(reporter,
+                                loaded->fImage && !memcmp(loaded->fImage, image.get(), imageSize));
+            }
+        }
+    }
+
+    // Truncated data is rejected.
+    SkStrikeCache truncatedCache;
+    REPORTER_ASSERT(reporter,
+                    SkStrikeStore::Deserialize(memory.data(), memory.size() / 2,
+                                               &truncatedCache) == -1);
+}
+
+DEF_TEST(SkRemoteGlyphCache_GlyphRequests, reporter) {
+    sk_sp<DiscardableManager> discardableManager = sk_make_sp<DiscardableManager>();
+    SkStrikeServer server(discardableManager.get());
+    SkStrikeClient client(discardableManager, false);
+    const SkSurfaceProps props(SkSurfaceProps::kLegacyFontHost_InitType);
+    SkPaint paint;
+
+    // Server sends the first 5 glyphs.
+    auto serverTf = SkTypeface::MakeFromName("monospace", SkFontStyle());
+    auto serverTfData = server.serializeTypeface(serverTf.get());
+    {
+        SkTextBlobCacheDiffCanvas cache_diff_canvas(10, 10, props, &server);
+        cache_diff_canvas.drawTextBlob(buildTextBlob(serverTf, 5).get(), 0, 0, paint);
+    }
+    std::vector<uint8_t> serverStrikeData;
+    server.writeStrikeData(&serverStrikeData);
+
+    auto clientTf = client.deserializeTypeface(serverTfData->data(), serverTfData->size());
+    REPORTER_ASSERT(reporter,
+                    client.readStrikeData(serverStrikeData.data(), serverStrikeData.size()));
+
+    // The client draws 10, and asks for all the missing ones in one request.
+    auto clientBlob = buildTextBlob(clientTf, 10);
+    auto surface = SkSurface::MakeRaster(SkImageInfo::MakeN32Premul(20, 20), &props);
+    surface->getCanvas()->drawTextBlob(clientBlob.get(), 0, 0, paint);
+
+    std::vector<uint8_t> requests;
+    REPORTER_ASSERT(reporter, client.writeGlyphRequests(&requests) == 5);
+    REPORTER_ASSERT(reporter, client.glyphRequestStats().fMessages == 1);
+    REPORTER_ASSERT(reporter, client.glyphRequestStats().fGlyphs == 5);
+
+    std::vector<uint8_t> noRequests;
+    REPORTER_ASSERT(reporter, client.writeGlyphRequests(&noRequests) == 0);
+    REPORTER_ASSERT(reporter, noRequests.empty());
+
+    // The server answers them all in one message, after which the client has everything.
+    REPORTER_ASSERT(reporter, server.readGlyphRequests(requests.data(), requests.size()));
+    serverStrikeData.clear();
+    server.writeStrikeData(&serverStrikeData);
+    REPORTER_ASSERT(reporter, !serverStrikeData.empty());
+    REPORTER_ASSERT(reporter,
+                    client.readStrikeData(serverStrikeData.data(), serverStrikeData.size()));
+
+    surface->getCanvas()->drawTextBlob(clientBlob.get(), 0, 0, paint);
+    REPORTER_ASSERT(reporter, client.writeGlyphRequests(&requests) == 0);
+    client.resetGlyphRequestStats();
+    REPORTER_ASSERT(reporter, client.glyphRequestStats().fMessages == 0);
+
+    // Must unlock everything on termination, otherwise valgrind complains about memory leaks.
+    discardableManager->unlockAndDeleteAll();
+}
+
+DEF_TEST(SkRemoteGlyphCache_PrefetchTextBlob, reporter) {
+    sk_sp<DiscardableManager> discardableManager = sk_make_sp<DiscardableManager>();
+    SkStrikeServer server(discardableManager.get());
+    const SkSurfaceProps props(SkSurfaceProps::kLegacyFontHost_InitType);
+
+    auto serverTf = SkTypeface::MakeFromName("monospace", SkFontStyle());
+    server.serializeTypeface(serverTf.get());
+    {
+        SkTextBlobCacheDiffCanvas cache_diff_canvas(10, 10, props, &server);
+        cache_diff_canvas.drawTextBlob(buildTextBlob(serverTf, 5).get(), 0, 0, SkPaint());
+    }
+    std::vector<uint8_t> serverStrikeData;
+    server.writeStrikeData(&serverStrikeData);
+    size_t firstSize = serverStrikeData.size();
+
+    // Prefetching a blob already sent sends nothing new; a bigger one sends its new glyphs,
+    // even far off the canvas.
+    server.prefetchTextBlob(*buildTextBlob(serverTf, 5), {0, 0}, SkPaint(), props, SkMatrix::I());
+    serverStrikeData.clear();
+    server.writeStrikeData(&serverStrikeData);
+    size_t resentSize = serverStrikeData.size();
+
+    server.prefetchTextBlob(*buildTextBlob(serverTf, 10), {-1000, 5000}, SkPaint(), props,
+                            SkMatrix::MakeScale(2));
+    serverStrikeData.clear();
+    server.writeStrikeData(&serverStrikeData);
+    REPORTER_ASSERT(reporter, serverStrikeData.size() > resentSize);
+    REPORTER_ASSERT(reporter, firstSize > 0);
+
+    discardableManager->unlockAndDeleteAll();
+}
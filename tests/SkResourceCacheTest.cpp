@@ -13,6 +13,7 @@
 #include "SkGraphics.h"
 #include "SkMakeUnique.h"
 #include "SkMipMap.h"
+#include "SkNextID.h"
 #include "SkPicture.h"
 #include "SkPictureRecorder.h"
 #include "SkResourceCache.h"
@@ -291,3 +292,38 @@ DEF_TEST(ResourceCache_purge, reporter) {
         }
     }
 }
+
+DEF_TEST(Graphics_PurgeForMemoryPressure, reporter) {
+    // Other tests may be using the global cache too, so only check on our own recs.
+    constexpr int kCount = 4;
+    const SkImageInfo info = SkImageInfo::MakeN32Premul(64, 64);
+    SkBitmapCacheDesc desc[kCount];
+    for (int i = 0; i < kCount; ++i) {
+        desc[i] = SkBitmapCacheDesc::Make(SkNextID::ImageID(), info.bounds());
+        SkPixmap pmap;
+        auto rec = SkBitmapCache::Alloc(desc[i], info, &pmap);
+        REPORTER_ASSERT(reporter, rec);
+        if (!rec) {
+            return;
+        }
+        SkBitmap bitmap;
+        SkBitmapCache::Add(std::move(rec), &bitmap);
+    }
+
+    // Something the least recently used had to go, and freeing it freed at least what we asked.
+    auto result = SkGraphics::PurgeForMemoryPressure(SkGraphics::MemoryPressureLevel::kModerate,
+                                                     info.computeMinByteSize());
+    REPORTER_ASSERT(reporter, result.fResourceCacheBytes >= info.computeMinByteSize());
+    REPORTER_ASSERT(reporter, result.totalBytes() >= result.fResourceCacheBytes);
+
+    // A locked rec survives even critical pressure; the others do not.
+    SkBitmap locked;
+    bool lockedFound = SkBitmapCache::Find(desc[kCount - 1], &locked);
+    result = SkGraphics::PurgeForMemoryPressure(SkGraphics::MemoryPressureLevel::kCritical, 0);
+    for (int i = 0; i < kCount - 1; ++i) {
+        SkBitmap bitmap;
+        REPORTER_ASSERT(reporter, !SkBitmapCache::Find(desc[i], &bitmap));
+    }
+    SkBitmap bitmap;
+    REPORTER_ASSERT(reporter, SkBitmapCache::Find(desc[kCount - 1], &bitmap) == lockedFound);
+}
@@ -102,14 +102,11 @@ DEF_TEST(SkSLFunctions, r) {
          *SkSL::ShaderCapsFactory::Default(),
          "#version 400\n"
          "out vec4 sk_FragColor;\n"
-         "float foo(float v[2]) {\n"
-         "    return v[0] * v[1];\n"
-         "}\n"
          "void bar(inout float x) {\n"
          "    float y[2], z;\n"
          "    y[0] = x;\n"
          "    y[1] = x * 2.0;\n"
-         "    z = foo(y);\n"
+         "    z = y[0] * y[1];\n"
          "    x = z;\n"
          "}\n"
          "void main() {\n"
@@ -1673,6 +1670,77 @@ DEF_TEST(SkSLDeadLoopVar, r) {
          );
 }
 
+DEF_TEST(SkSLInlining, r) {
+    test(r,
+         "uniform half4 color;"
+         "half scale(half x, half s) { return x * s; }"
+         "half square(half x) { return x * x; }"
+         "half4 twice(half4 x) { return x + x; }"
+         "half unused(half x) { return x; }"
+         "void main() {"
+         "sk_FragColor = twice(color) * scale(color.a, 0.5) * square(color.r + 1) * square(2);"
+         "}",
+         *SkSL::ShaderCapsFactory::Default(),
+         "#version 400\n"
+         "out vec4 sk_FragColor;\n"
+         "uniform vec4 color;\n"
+         "float square(float x) {\n"
+         "    return x * x;\n"
+         "}\n"
+         "void main() {\n"
+         "    sk_FragColor = (((color + color) * (color.w * 0.5)) * square(color.x + 1.0)) * 4.0;\n"
+         "}\n");
+    test(r,
+         "half next(half x) { return x + 1; }"
+         "void main() {"
+         "half x = 1;"
+         "sk_FragColor = half4(next(x++));"
+         "}",
+         *SkSL::ShaderCapsFactory::Default(),
+         "#version 400\n"
+         "out vec4 sk_FragColor;\n"
+         "float next(float x) {\n"
+         "    return x + 1.0;\n"
+         "}\n"
+         "void main() {\n"
+         "    float x = 1.0;\n"
+         "    sk_FragColor = vec4(next(x++));\n"
+         "}\n");
+    // Inlining f() would make its g refer to main's g.
+    test(r,
+         "uniform half g;"
+         "half f() { return g; }"
+         "void main() {"
+         "half g = half(sk_FragCoord.x);"
+         "sk_FragColor = half4(f(), g, 0, 1);"
+         "}",
+         *SkSL::ShaderCapsFactory::Default(),
+         "#version 400\n"
+         "out vec4 sk_FragColor;\n"
+         "uniform float g;\n"
+         "float f() {\n"
+         "    return g;\n"
+         "}\n"
+         "void main() {\n"
+         "    float g = gl_FragCoord.x;\n"
+         "    sk_FragColor = vec4(f(), g, 0.0, 1.0);\n"
+         "}\n");
+    // b() is only called from dead code, and a() only from b().
+    test(r,
+         "half a(half x) { half y = x * 2; return y; }"
+         "half b(half x) { half y = a(x); return y; }"
+         "void main() {"
+         "if (false) { sk_FragColor = half4(b(1)); }"
+         "sk_FragColor = half4(1);"
+         "}",
+         *SkSL::ShaderCapsFactory::Default(),
+         "#version 400\n"
+         "out vec4 sk_FragColor;\n"
+         "void main() {\n"
+         "    sk_FragColor = vec4(1.0);\n"
+         "}\n");
+}
+
 DEF_TEST(SkSLGeometryShaders, r) {
     test(r,
          "layout(points) in;"
@@ -1683,6 +1751,7 @@ DEF_TEST(SkSLGeometryShaders, r) {
          "EmitVertex();"
          "}"
          "void main() {"
+         "test();"
          "sk_Position = sk_in[0].sk_Position + float4(-0.5, 0, 0, sk_InvocationID);"
          "EmitVertex();"
          "}",
@@ -1696,6 +1765,7 @@ DEF_TEST(SkSLGeometryShaders, r) {
          "    EmitVertex();\n"
          "}\n"
          "void _invoke() {\n"
+         "    test();\n"
          "    gl_Position = gl_in[0].gl_Position + vec4(-0.5, 0.0, 0.0, float(sk_InvocationID));\n"
          "    EmitVertex();\n"
          "}\n"
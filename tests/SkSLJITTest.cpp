@@ -7,6 +7,7 @@
 
 #include "SkSLJIT.h"
 
+#include "SkRasterPipeline.h"
 #include "Test.h"
 
 #ifdef SK_LLVM_AVAILABLE
@@ -118,4 +119,50 @@ DEF_TEST(SkSLJITWhile, r) {
                  "}", 96, 200, 288);
 }
 
+DEF_TEST(SkSLJITStageControlFlow, r) {
+    // Each pixel takes its own side of each branch, so this only passes if the vectorized stage
+    // masks its stores correctly.
+    SkSL::Compiler compiler;
+    SkSL::Program::Settings settings;
+    std::unique_ptr<SkSL::Program> program = compiler.convertProgram(
+            SkSL::Program::kPipelineStage_Kind,
+            SkSL::String("void stage(int x, int y, inout float4 color) {"
+                         "    if (color.r < 0.5) {"
+                         "        color.g = 1.0;"
+                         "        if (color.b > 0.5) { color.a = 0.0; }"
+                         "    } else {"
+                         "        color.g = color.b > 0.5 ? 0.25 : 0.75;"
+                         "    }"
+                         "}"),
+            settings);
+    REPORTER_ASSERT(r, program);
+    if (!program) {
+        printf("%s", compiler.errorText().c_str());
+        return;
+    }
+    SkSL::JIT jit(&compiler);
+    std::unique_ptr<SkSL::JIT::Module> module = jit.compile(std::move(program));
+
+    constexpr int kCount = 16;
+    float pixels[kCount][4];
+    for (int i = 0; i < kCount; i++) {
+        pixels[i][0] = (i & 1) ? 1 : 0;
+        pixels[i][1] = 0;
+        pixels[i][2] = (i & 2) ? 1 : 0;
+        pixels[i][3] = 1;
+    }
+    SkRasterPipeline_MemoryCtx ctx = { pixels, 0 };
+    SkRasterPipeline_<256> p;
+    p.append(SkRasterPipeline::load_f32, &ctx);
+    p.append(module->getJumperStage("stage"), nullptr);
+    p.append(SkRasterPipeline::store_f32, &ctx);
+    p.run(0, 0, kCount, 1);
+
+    for (int i = 0; i < kCount; i++) {
+        bool red = i & 1, blue = i & 2;
+        REPORTER_ASSERT(r, pixels[i][1] == (red ? (blue ? 0.25f : 0.75f) : 1));
+        REPORTER_ASSERT(r, pixels[i][3] == (!red && blue ? 0 : 1));
+    }
+}
+
 #endif
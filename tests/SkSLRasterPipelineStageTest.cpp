@@ -0,0 +1,52 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkSLRasterPipelineStage.h"
+
+#include "SkArenaAlloc.h"
+#include "SkRasterPipeline.h"
+#include "Test.h"
+
+DEF_TEST(SkSLRasterPipelineStage, r) {
+    const char* src =
+            "void stage(int x, int y, inout half4 color) {"
+            "    if (color.r < 0.5) {"
+            "        color.g = 1.0;"
+            "        if (color.b > 0.5) { color.a = 0.0; }"
+            "    } else {"
+            "        color.g = color.b > 0.5 ? 0.25 : 0.75;"
+            "    }"
+            "}";
+
+    constexpr int kCount = 16;
+    float pixels[kCount][4];
+    for (int i = 0; i < kCount; i++) {
+        pixels[i][0] = (i & 1) ? 1 : 0;
+        pixels[i][1] = 0;
+        pixels[i][2] = (i & 2) ? 1 : 0;
+        pixels[i][3] = 1;
+    }
+    SkRasterPipeline_MemoryCtx ctx = { pixels, 0 };
+
+    // Append the stage twice, so that with the JIT the second one comes from the cache.
+    SkSTArenaAlloc<256> alloc;
+    SkRasterPipeline p(&alloc);
+    p.append(SkRasterPipeline::load_f32, &ctx);
+    REPORTER_ASSERT(r, SkSL::AppendRasterPipelineStage(src, "stage", &p, &alloc));
+    REPORTER_ASSERT(r, SkSL::AppendRasterPipelineStage(src, "stage", &p, &alloc));
+    p.append(SkRasterPipeline::store_f32, &ctx);
+    p.run(0, 0, kCount, 1);
+
+    for (int i = 0; i < kCount; i++) {
+        bool red = i & 1, blue = i & 2;
+        REPORTER_ASSERT(r, pixels[i][1] == (red ? (blue ? 0.25f : 0.75f) : 1));
+        REPORTER_ASSERT(r, pixels[i][3] == (!red && blue ? 0 : 1));
+    }
+
+    REPORTER_ASSERT(r, !SkSL::AppendRasterPipelineStage(src, "missing", &p, &alloc));
+    REPORTER_ASSERT(r, !SkSL::AppendRasterPipelineStage("void stage(", "stage", &p, &alloc));
+}
@@ -52,3 +52,51 @@ DEF_TEST(SkSharedMutexMultiThreaded, r) {
         }
     });
 }
+
+DEF_TEST(SkDistributedSharedMutexBasic, r) {
+    SkDistributedSharedMutex sm;
+    sm.acquire();
+    sm.assertHeld();
+    sm.release();
+    sm.acquireShared();
+    sm.releaseShared();
+    // Readers don't keep each other out.
+    sm.acquireShared();
+    sm.acquireShared();
+    sm.releaseShared();
+    sm.releaseShared();
+    sm.acquire();
+    sm.release();
+}
+
+DEF_TEST(SkDistributedSharedMutexMultiThreaded, r) {
+    SkDistributedSharedMutex sm;
+    static const int kSharedSize = 10;
+    int shared[kSharedSize];
+    int value = 0;
+    for (int i = 0; i < kSharedSize; ++i) {
+        shared[i] = 0;
+    }
+    // More threads than the mutex has slots, so some of them share one.
+    SkTaskGroup().batch(40, [&](int threadIndex) {
+        if (threadIndex % 4 != 0) {
+            for (int c = 0; c < 20000; ++c) {
+                SkAutoSharedMutexShared lock(sm);
+                int v = shared[0];
+                for (int i = 1; i < kSharedSize; ++i) {
+                    REPORTER_ASSERT(r, v == shared[i]);
+                }
+            }
+        } else {
+            for (int c = 0; c < 2000; ++c) {
+                SkAutoExclusive lock(sm);
+                sm.assertHeld();
+                value += 1;
+                for (int i = 0; i < kSharedSize; ++i) {
+                    shared[i] = value;
+                }
+            }
+        }
+    });
+    REPORTER_ASSERT(r, 10 * 2000 == value);
+}
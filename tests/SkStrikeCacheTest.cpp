@@ -0,0 +1,86 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Resources.h"
+#include "SkCanvas.h"
+#include "SkExecutor.h"
+#include "SkFont.h"
+#include "SkGraphics.h"
+#include "SkStrikeCache.h"
+#include "SkSurfaceProps.h"
+#include "SkTaskGroup.h"
+#include "SkTypeface.h"
+#include "Test.h"
+#include "sk_tool_utils.h"
+
+static void find_strikes(SkStrikeCache* strikeCache, int index) {
+    SkPaint paint;
+    SkFont font;
+    for (SkScalar size = 8; size < 40; size++) {
+        font.setSize(size + index * 0.25f);
+        SkExclusiveStrikePtr strike(strikeCache->findOrCreateStrike(
+                font, paint, SkSurfaceProps(0, kUnknown_SkPixelGeometry),
+                SkScalerContextFlags::kNone, SkMatrix::I()));
+        strike->getGlyphIDMetrics(strike->unicharToGlyph('a' + index % 26));
+    }
+}
+
+DEF_TEST(SkStrikeCache_ThreadedBudget, reporter) {
+    // Strikes are spread over shards, but the count budget applies to the whole cache.
+    SkStrikeCache strikeCache;
+    strikeCache.setCacheCountLimit(20);
+
+    SkTaskGroup().batch(16, [&](int index) { find_strikes(&strikeCache, index); });
+
+    REPORTER_ASSERT(reporter, strikeCache.getCacheCountUsed() <= 20);
+    REPORTER_ASSERT(reporter, strikeCache.getCacheCountUsed() > 0);
+    strikeCache.validate();
+
+    strikeCache.purgeAll();
+    REPORTER_ASSERT(reporter, strikeCache.getCacheCountUsed() == 0);
+    REPORTER_ASSERT(reporter, strikeCache.getTotalMemoryUsed() == 0);
+}
+
+static SkBitmap draw_alphabet(sk_sp<SkTypeface> typeface) {
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(400, 100);
+    SkCanvas canvas(bitmap);
+    canvas.clear(SK_ColorWHITE);
+
+    SkPaint paint;
+    paint.setTypeface(std::move(typeface));
+    paint.setTextSize(17);
+    paint.setAntiAlias(true);
+    const char text[] = "The quick brown fox jumps over the lazy dog. 0123456789";
+    canvas.drawText(text, strlen(text), 2, 30, paint);
+    const char upper[] = "SPHINX OF BLACK QUARTZ, JUDGE MY VOW!";
+    canvas.drawText(upper, strlen(upper), 2, 70, paint);
+    return bitmap;
+}
+
+DEF_TEST(SkStrikeCache_RasterExecutor, reporter) {
+    sk_sp<SkTypeface> typeface = MakeResourceAsTypeface("fonts/Roboto-Regular.ttf");
+    if (!typeface) {
+        return;
+    }
+
+    SkGraphics::PurgeFontCache();
+    SkBitmap serial = draw_alphabet(typeface);
+
+    // With an executor the glyphs of each run are rasterized in parallel, and must come out the
+    // same.
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+    SkExecutor* oldExecutor = SkGraphics::SetFontCacheRasterExecutor(executor.get());
+    SkGraphics::PurgeFontCache();
+    SkBitmap parallel = draw_alphabet(typeface);
+    // A second time all the images are already cached.
+    SkBitmap cached = draw_alphabet(typeface);
+    SkGraphics::SetFontCacheRasterExecutor(oldExecutor);
+
+    REPORTER_ASSERT(reporter, sk_tool_utils::equal_pixels(serial, parallel));
+    REPORTER_ASSERT(reporter, sk_tool_utils::equal_pixels(serial, cached));
+}
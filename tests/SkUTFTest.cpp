@@ -93,6 +93,26 @@ DEF_TEST(SkUTF_CountUTF8, r) {
     }
 }
 
+DEF_TEST(SkUTF_CountASCII, r) {
+    // Put a non-ASCII character at every position of a run longer than the eight bytes that are
+    // checked at once, and check both the ASCII prefix and the count around it.
+    char text[40];
+    for (size_t pos = 0; pos <= 20; ++pos) {
+        memset(text, 'a', sizeof(text));
+        size_t len = 20;
+        if (pos < 20) {
+            text[pos] = LEADING_TWO_BYTE[0];
+            text[pos + 1] = CONTINUATION_BYTE[0];
+            len = 21;
+        }
+        REPORTER_ASSERT(r, pos == SkUTF::CountASCII(text, len));
+        REPORTER_ASSERT(r, 20 == SkUTF::CountUTF8(text, len));
+        REPORTER_ASSERT(r, SkTMin(pos, (size_t)5) == SkUTF::CountASCII(text, 5));
+    }
+    text[17] = CONTINUATION_BYTE[0];
+    REPORTER_ASSERT(r, -1 == SkUTF::CountUTF8(text, 21));
+}
+
 DEF_TEST(SkUTF_NextUTF8_ToUTF8, r) {
     struct {
         SkUnichar expected;
@@ -8,7 +8,9 @@
 #include "SkPaint.h"
 #include "SkPath.h"
 #include "SkRect.h"
+#include "SkResourceCache.h"
 #include "SkStroke.h"
+#include "SkStrokeCache.h"
 #include "SkStrokeRec.h"
 #include "Test.h"
 
@@ -179,9 +181,41 @@ static void test_big_stroke(skiatest::Reporter* reporter) {
     paint.getFillPath(path, &strokeAndFillPath);
 }
 
+static void test_stroke_cache(skiatest::Reporter* reporter) {
+    SkResourceCache cache(1024 * 1024);
+    SkPath path;
+    path.moveTo(0, 0);
+    for (int i = 1; i < 10; ++i) {
+        path.lineTo(SkIntToScalar(i * 10), SkIntToScalar((i & 1) * 20));
+    }
+    SkStrokeRec rec(SkStrokeRec::kFill_InitStyle);
+    rec.setStrokeStyle(4);
+    rec.setResScale(SkStrokeCache::BucketResScale(3));
+    REPORTER_ASSERT(reporter, 4 == rec.getResScale());
+
+    SkPath expected, first, second;
+    REPORTER_ASSERT(reporter, rec.applyToPath(&expected, path));
+    REPORTER_ASSERT(reporter, SkStrokeCache::ApplyToPath(rec, path, &first, &cache));
+    REPORTER_ASSERT(reporter, SkStrokeCache::ApplyToPath(rec, path, &second, &cache));
+    REPORTER_ASSERT(reporter, first == expected);
+    // The second outline comes from the cache, so it shares the first's points.
+    REPORTER_ASSERT(reporter, first.getGenerationID() == second.getGenerationID());
+    REPORTER_ASSERT(reporter, cache.getTotalBytesUsed() > 0);
+
+    // Changing the path purges its outline, which leaves just the other path's in the cache.
+    SkPath other(path), third;
+    other.offset(5, 5);
+    path.lineTo(0, 50);
+    REPORTER_ASSERT(reporter, SkStrokeCache::ApplyToPath(rec, other, &third, &cache));
+    SkResourceCache otherCache(1024 * 1024);
+    REPORTER_ASSERT(reporter, SkStrokeCache::ApplyToPath(rec, other, &third, &otherCache));
+    REPORTER_ASSERT(reporter, cache.getTotalBytesUsed() == otherCache.getTotalBytesUsed());
+}
+
 DEF_TEST(Stroke, reporter) {
     test_strokecubic(reporter);
     test_strokerect(reporter);
     test_strokerec_equality(reporter);
     test_big_stroke(reporter);
+    test_stroke_cache(reporter);
 }
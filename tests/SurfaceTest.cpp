@@ -478,6 +478,73 @@ DEF_GPUTEST_FOR_RENDERING_CONTEXTS(SurfaceWriteableAfterSnapshotRelease_Gpu, rep
     }
 }
 
+// Once a snapshot is released, a raster surface reuses its pixels for the next copy-on-write,
+// copying over only what has changed since.  Checks that surface and snapshots stay right.
+DEF_TEST(SurfaceCopyOnWriteReusesPixels, reporter) {
+    const SkImageInfo info = SkImageInfo::MakeN32Premul(20, 20);
+    auto surface = SkSurface::MakeRaster(info);
+    // Never snapshotted, so never copied-on-write.
+    auto expected = SkSurface::MakeRaster(info);
+
+    SkPaint stroke;
+    stroke.setColor(SK_ColorGREEN);
+    stroke.setStyle(SkPaint::kStroke_Style);
+    stroke.setStrokeWidth(3);
+    SkPath inverse;
+    inverse.addRect(SkRect::MakeLTRB(0, 0, 18, 18));
+    inverse.setFillType(SkPath::kInverseWinding_FillType);
+    const SkPoint points[] = {{2, 17}, {17, 2}};
+    SkBitmap patch;
+    patch.allocPixels(SkImageInfo::MakeN32Premul(2, 2));
+    patch.eraseColor(SK_ColorMAGENTA);
+
+    const std::function<void(SkSurface*)> draws[] = {
+        [](SkSurface* s) { s->getCanvas()->drawColor(SK_ColorWHITE); },
+        [](SkSurface* s) { s->getCanvas()->drawRect(SkRect::MakeLTRB(1, 1, 3, 3), SkPaint()); },
+        [&](SkSurface* s) { s->getCanvas()->drawCircle(10, 10, 4, stroke); },
+        [&](SkSurface* s) { s->writePixels(patch, 15, 4); },
+        [&](SkSurface* s) { s->getCanvas()->drawPath(inverse, stroke); },
+        [&](SkSurface* s) {
+            s->getCanvas()->drawPoints(SkCanvas::kPoints_PointMode, 2, points, stroke);
+        },
+        [](SkSurface* s) {
+            SkPaint paint;
+            paint.setColor(SK_ColorRED);
+            s->getCanvas()->drawRect(SkRect::MakeLTRB(5, 12, 8, 14), paint);
+        },
+    };
+
+    sk_sp<SkImage> snapshots[2];
+    sk_sp<SkImage> expectedSnapshots[2];
+    const void* pixels[2] = {nullptr, nullptr};
+    int i = 0;
+    for (const auto& draw : draws) {
+        draw(surface.get());
+        draw(expected.get());
+        // Drop the older snapshot, so its pixels are free to be reused.
+        int slot = i++ % 2;
+        SkPixmap pm;
+        snapshots[slot] = surface->makeImageSnapshot();
+        SkPixmap expectedPixels;
+        SkAssertResult(expected->peekPixels(&expectedPixels));
+        expectedSnapshots[slot] = SkImage::MakeRasterCopy(expectedPixels);
+        REPORTER_ASSERT(reporter, snapshots[slot]->peekPixels(&pm));
+        // From the third draw on, the surface is back on pixels that were snapshotted before.
+        if (i > 2) {
+            REPORTER_ASSERT(reporter, pm.addr() == pixels[slot]);
+        }
+        pixels[slot] = pm.addr();
+        for (int j = 0; j < 2; j++) {
+            if (snapshots[j]) {
+                REPORTER_ASSERT(reporter, sk_tool_utils::equal_pixels(snapshots[j].get(),
+                                                                      expectedSnapshots[j].get()));
+            }
+        }
+        expectedSnapshots[(slot + 1) % 2].reset();
+        snapshots[(slot + 1) % 2].reset();
+    }
+}
+
 static void test_crbug263329(skiatest::Reporter* reporter,
                              SkSurface* surface1,
                              SkSurface* surface2) {
@@ -970,3 +1037,131 @@ DEF_TEST(surface_image_unity, reporter) {
         }
     }
 }
+
+namespace {
+struct AsyncReadResult {
+    bool                   fCalled = false;
+    int                    fWidth = 0;
+    int                    fHeight = 0;
+    std::vector<SkPMColor> fPixels;
+    int                    fPlaneWidths[3] = {0, 0, 0};
+    int                    fPlaneHeights[3] = {0, 0, 0};
+    std::vector<uint8_t>   fPlanes[3];
+};
+}  // namespace
+
+static void async_read_callback(void* context, const void* data, size_t rowBytes) {
+    auto* result = static_cast<AsyncReadResult*>(context);
+    result->fCalled = true;
+    if (!data) {
+        return;
+    }
+    for (int y = 0; y < result->fHeight; ++y) {
+        auto row = SkTAddOffset<const SkPMColor>(data, y * rowBytes);
+        result->fPixels.insert(result->fPixels.end(), row, row + result->fWidth);
+    }
+}
+
+static void async_read_yuv_callback(void* context, const void* data[3], size_t rowBytes[3]) {
+    auto* result = static_cast<AsyncReadResult*>(context);
+    result->fCalled = true;
+    if (!data) {
+        return;
+    }
+    for (int i = 0; i < 3; ++i) {
+        for (int y = 0; y < result->fPlaneHeights[i]; ++y) {
+            auto row = SkTAddOffset<const uint8_t>(data[i], y * rowBytes[i]);
+            result->fPlanes[i].insert(result->fPlanes[i].end(), row,
+                                      row + result->fPlaneWidths[i]);
+        }
+    }
+}
+
+// Fills the surface's quadrants with different colors, then reads back the bottom right one,
+// scaled to half its size, and checks that every pixel is that quadrant's color.
+static void test_async_read(skiatest::Reporter* reporter, SkSurface* surface,
+                            GrContext* context) {
+    const SkColor colors[] = { SK_ColorRED, SK_ColorGREEN, SK_ColorBLUE, SK_ColorYELLOW };
+    const int w = surface->width() / 2;
+    const int h = surface->height() / 2;
+    for (int i = 0; i < 4; ++i) {
+        SkPaint paint;
+        paint.setColor(colors[i]);
+        surface->getCanvas()->drawRect(SkRect::MakeXYWH((i % 2) * w, (i / 2) * h, w, h), paint);
+    }
+
+    const SkImageInfo dstInfo = SkImageInfo::MakeN32Premul(w / 2, h / 2);
+    for (SkFilterQuality quality : { kNone_SkFilterQuality, kLow_SkFilterQuality,
+                                     kMedium_SkFilterQuality, kHigh_SkFilterQuality }) {
+        AsyncReadResult result;
+        result.fWidth = dstInfo.width();
+        result.fHeight = dstInfo.height();
+        surface->asyncRescaleAndReadPixels(dstInfo, SkIRect::MakeXYWH(w, h, w, h), quality,
+                                           async_read_callback, &result);
+        while (context && !result.fCalled) {
+            context->checkAsyncWorkCompletion();
+        }
+        REPORTER_ASSERT(reporter, result.fCalled);
+        REPORTER_ASSERT(reporter,
+                        result.fPixels.size() == (size_t)(dstInfo.width() * dstInfo.height()));
+        for (SkPMColor pixel : result.fPixels) {
+            REPORTER_ASSERT(reporter, pixel == SkPreMultiplyColor(SK_ColorYELLOW),
+                            "quality %d: 0x%08x", quality, pixel);
+        }
+    }
+
+    // Reading outside the surface fails right away.
+    AsyncReadResult result;
+    surface->asyncRescaleAndReadPixels(dstInfo, SkIRect::MakeXYWH(w, h, w + 1, h),
+                                       kNone_SkFilterQuality, async_read_callback, &result);
+    REPORTER_ASSERT(reporter, result.fCalled && result.fPixels.empty());
+}
+
+DEF_TEST(SurfaceAsyncReadPixels, reporter) {
+    auto surface = SkSurface::MakeRasterN32Premul(64, 32);
+    test_async_read(reporter, surface.get(), nullptr);
+
+    // Raster surfaces have no YUV readback.
+    AsyncReadResult result;
+    surface->asyncRescaleAndReadPixelsYUV420(kJPEG_SkYUVColorSpace, nullptr,
+                                             SkIRect::MakeWH(64, 32), 32, 16,
+                                             kLow_SkFilterQuality, async_read_yuv_callback,
+                                             &result);
+    REPORTER_ASSERT(reporter, result.fCalled && result.fPlanes[0].empty());
+}
+
+DEF_GPUTEST_FOR_RENDERING_CONTEXTS(SurfaceAsyncReadPixels_Gpu, reporter, ctxInfo) {
+    GrContext* context = ctxInfo.grContext();
+    for (GrSurfaceOrigin origin : { kTopLeft_GrSurfaceOrigin, kBottomLeft_GrSurfaceOrigin }) {
+        auto surface = SkSurface::MakeRenderTarget(context, SkBudgeted::kNo,
+                                                   SkImageInfo::MakeN32Premul(64, 32), 1,
+                                                   origin, nullptr);
+        test_async_read(reporter, surface.get(), context);
+    }
+
+    // A gray's Y is its level in JPEG's full range, and its U and V are neutral.
+    auto surface = SkSurface::MakeRenderTarget(context, SkBudgeted::kNo,
+                                               SkImageInfo::MakeN32Premul(64, 32));
+    surface->getCanvas()->clear(SkColorSetRGB(100, 100, 100));
+    AsyncReadResult result;
+    for (int i = 0; i < 3; ++i) {
+        result.fPlaneWidths[i] = i ? 9 : 17;
+        result.fPlaneHeights[i] = i ? 5 : 9;
+    }
+    surface->asyncRescaleAndReadPixelsYUV420(kJPEG_SkYUVColorSpace, nullptr,
+                                             SkIRect::MakeWH(64, 32), 17, 9,
+                                             kMedium_SkFilterQuality, async_read_yuv_callback,
+                                             &result);
+    while (!result.fCalled) {
+        context->checkAsyncWorkCompletion();
+    }
+    const int expected[] = { 100, 128, 128 };
+    for (int i = 0; i < 3; ++i) {
+        REPORTER_ASSERT(reporter, result.fPlanes[i].size() ==
+                                  (size_t)(result.fPlaneWidths[i] * result.fPlaneHeights[i]));
+        for (uint8_t value : result.fPlanes[i]) {
+            REPORTER_ASSERT(reporter, SkTAbs(value - expected[i]) <= 1,
+                            "plane %d: %d", i, value);
+        }
+    }
+}
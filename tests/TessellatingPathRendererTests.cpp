@@ -12,9 +12,13 @@
 #include "GrContextPriv.h"
 #include "GrShape.h"
 #include "GrStyle.h"
+#include "GrTessellator.h"
+#include "SkExecutor.h"
 #include "SkGradientShader.h"
 #include "SkPath.h"
+#include "SkRandom.h"
 #include "SkShaderBase.h"
+#include "SkTemplates.h"
 #include "effects/GrPorterDuffXferProcessor.h"
 #include "ops/GrTessellatingPathRenderer.h"
 
@@ -736,3 +740,70 @@ DEF_GPUTEST_FOR_ALL_CONTEXTS(TessellatingPathRendererTests, reporter, ctxInfo) {
     test_path(ctx, rtc.get(), create_path_42());
     test_path(ctx, rtc.get(), create_path_43(), SkMatrix(), GrAAType::kCoverage);
 }
+
+namespace {
+class PointAllocator : public GrTessellator::VertexAllocator {
+public:
+    PointAllocator() : VertexAllocator(sizeof(SkPoint)) {}
+    void* lock(int vertexCount) override {
+        fPoints.reset(vertexCount);
+        return fPoints.get();
+    }
+    void unlock(int actualCount) override { fCount = actualCount; }
+
+    // Total area of the emitted triangles.
+    double area() const {
+        double area = 0;
+        for (int i = 0; i + 2 < fCount; i += 3) {
+            const SkPoint* p = fPoints.get() + i;
+            area += SkScalarAbs(SkPoint::CrossProduct(p[1] - p[0], p[2] - p[0])) * 0.5;
+        }
+        return area;
+    }
+
+private:
+    SkAutoTMalloc<SkPoint> fPoints;
+    int fCount = 0;
+};
+}
+
+// A self-intersecting polygon large enough for PathToTrianglesInBands to split into bands.
+static SkPath create_big_star(SkPath::FillType fillType) {
+    SkPath path;
+    path.setFillType(fillType);
+    SkRandom rand;
+    for (int i = 0; i < 4000; ++i) {
+        SkScalar radius = rand.nextRangeF(50, 400);
+        SkScalar angle = i * SK_ScalarPI * 7 / 4000;
+        SkPoint p = { 500 + radius * SkScalarCos(angle), 500 + radius * SkScalarSin(angle) };
+        if (0 == i) {
+            path.moveTo(p);
+        } else {
+            path.lineTo(p);
+        }
+    }
+    path.close();
+    path.addCircle(500, 500, 75);
+    return path;
+}
+
+DEF_TEST(TessellatorBands, reporter) {
+    const SkRect clip = SkRect::MakeWH(1000, 1000);
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+    for (auto fillType : { SkPath::kWinding_FillType, SkPath::kEvenOdd_FillType,
+                           SkPath::kInverseWinding_FillType }) {
+        SkPath path = create_big_star(fillType);
+        PointAllocator serial;
+        bool isLinear;
+        GrTessellator::PathToTriangles(path, 0.25f, clip, &serial, false, GrColor(), false,
+                                       &isLinear);
+        REPORTER_ASSERT(reporter, serial.area() > 0);
+        for (SkExecutor* exec : { executor.get(), (SkExecutor*)nullptr }) {
+            PointAllocator banded;
+            GrTessellator::PathToTrianglesInBands(path, 0.25f, clip, &banded, 8, exec,
+                                                  &isLinear);
+            double tolerance = serial.area() * 1e-4;
+            REPORTER_ASSERT(reporter, SkTAbs(banded.area() - serial.area()) <= tolerance);
+        }
+    }
+}
@@ -25,7 +25,9 @@
 #include "Test.h"
 
 #include "GrContext.h"
+#include "GrContextFactory.h"
 #include "GrContextPriv.h"
+#include "text/GrTextBlobCache.h"
 
 static void draw(SkCanvas* canvas, int redraw, const SkTArray<sk_sp<SkTextBlob>>& blobs) {
     int yOffset = 0;
@@ -170,3 +172,78 @@ DEF_GPUTEST_FOR_NULLGL_CONTEXT(TextBlobAbnormal, reporter, ctxInfo) {
 DEF_GPUTEST_FOR_NULLGL_CONTEXT(TextBlobStressAbnormal, reporter, ctxInfo) {
     text_blob_cache_inner(reporter, ctxInfo.grContext(), 256, 256, 10, false, true);
 }
+
+// Draws a cached blob once per flush with each of the given translations and scales, and returns
+// the text blob cache's stats afterwards.
+static GrTextBlobCache::Stats draw_blob_frames(skiatest::Reporter* reporter,
+                                               const GrContextOptions& options,
+                                               const SkPoint translations[],
+                                               const SkScalar scales[], int frameCount) {
+    sk_gpu_test::GrContextFactory factory(options);
+    GrContext* context = factory.get(sk_gpu_test::GrContextFactory::kNullGL_ContextType);
+    if (!context) {
+        return GrTextBlobCache::Stats();
+    }
+    SkImageInfo info = SkImageInfo::MakeN32Premul(256, 256);
+    auto surface(SkSurface::MakeRenderTarget(context, SkBudgeted::kNo, info));
+    REPORTER_ASSERT(reporter, surface);
+    if (!surface) {
+        return GrTextBlobCache::Stats();
+    }
+
+    SkFont font(sk_tool_utils::create_portable_typeface(), 24);
+    font.setSubpixel(true);
+    sk_sp<SkTextBlob> blob = SkTextBlob::MakeFromString("Hamburgefons", font);
+
+    SkCanvas* canvas = surface->getCanvas();
+    for (int i = 0; i < frameCount; i++) {
+        canvas->save();
+        canvas->translate(translations[i].fX, translations[i].fY);
+        canvas->scale(scales[i], scales[i]);
+        canvas->drawTextBlob(blob, 0, 0, SkPaint());
+        canvas->restore();
+        canvas->flush();
+    }
+    return context->contextPriv().getTextBlobCache()->stats();
+}
+
+DEF_GPUTEST(TextBlobCacheFractionalTranslation, reporter, options) {
+    static const SkPoint kTranslations[] = {{10, 40}, {10.0625f, 40}, {10.125f, 39.9375f},
+                                            {10.5f, 40}};
+    static const SkScalar kScales[] = {1, 1, 1, 1};
+
+    // Only whole pixel translations reuse the blob by default.
+    GrTextBlobCache::Stats stats = draw_blob_frames(reporter, options, kTranslations, kScales,
+                                                    SK_ARRAY_COUNT(kTranslations));
+    REPORTER_ASSERT(reporter, 3 == stats.fRegenerations);
+
+    // Translations within the subpixel rounding reuse it, but half a pixel still regenerates.
+    GrContextOptions reuseOptions = options;
+    reuseOptions.fReuseTextBlobsUnderFractionalTranslation = true;
+    stats = draw_blob_frames(reporter, reuseOptions, kTranslations, kScales,
+                             SK_ARRAY_COUNT(kTranslations));
+    REPORTER_ASSERT(reporter, 1 == stats.fRegenerations);
+    REPORTER_ASSERT(reporter, 1 == stats.fLastFlushRegenerations);
+    REPORTER_ASSERT(reporter, 0 == stats.fScaleChangeRegenerations);
+}
+
+DEF_GPUTEST(TextBlobCacheScaleChange, reporter, options) {
+    static const SkPoint kTranslations[] = {{10, 40}, {10, 40}, {10, 40}, {10, 40}, {10, 40}};
+    static const SkScalar kScales[] = {1, 1.1f, 1.15f, 1.2f, 1.2f};
+
+    // Bitmap glyphs are regenerated for every new scale by default.
+    GrTextBlobCache::Stats stats = draw_blob_frames(reporter, options, kTranslations, kScales,
+                                                    SK_ARRAY_COUNT(kTranslations));
+    REPORTER_ASSERT(reporter, 3 == stats.fRegenerations);
+    REPORTER_ASSERT(reporter, 0 == stats.fScaleChangeRegenerations);
+
+    // With the option on, the blob switches to distance fields when its scale starts changing,
+    // reuses them while it keeps changing, and switches back once it has settled.
+    GrContextOptions dfOptions = options;
+    dfOptions.fDistanceFieldTextForScaleChanges = true;
+    stats = draw_blob_frames(reporter, dfOptions, kTranslations, kScales,
+                             SK_ARRAY_COUNT(kTranslations));
+    REPORTER_ASSERT(reporter, 2 == stats.fRegenerations);
+    REPORTER_ASSERT(reporter, 2 == stats.fScaleChangeRegenerations);
+    REPORTER_ASSERT(reporter, 1 == stats.fLastFlushRegenerations);
+}
@@ -0,0 +1,133 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkCanvas.h"
+#include "SkExecutor.h"
+#include "SkGradientShader.h"
+#include "SkImage.h"
+#include "SkPath.h"
+#include "SkRandom.h"
+#include "SkSurface.h"
+#include "Test.h"
+
+#include "sk_tool_utils.h"
+
+static void draw_content(SkCanvas* canvas) {
+    SkRandom rand;
+    SkPaint paint;
+
+    canvas->clear(SK_ColorWHITE);
+    for (int i = 0; i < 50; ++i) {
+        paint.setColor(rand.nextU() | 0xFF000000);
+        paint.setAntiAlias(rand.nextBool());
+        paint.setStyle(rand.nextBool() ? SkPaint::kFill_Style : SkPaint::kStroke_Style);
+        paint.setStrokeWidth(rand.nextBool() ? 0 : rand.nextRangeF(1, 8));
+
+        SkPath path;
+        path.moveTo(rand.nextRangeF(-20, 280), rand.nextRangeF(-20, 220));
+        path.cubicTo(rand.nextRangeF(-20, 280), rand.nextRangeF(-20, 220),
+                     rand.nextRangeF(-20, 280), rand.nextRangeF(-20, 220),
+                     rand.nextRangeF(-20, 280), rand.nextRangeF(-20, 220));
+        path.quadTo(rand.nextRangeF(-20, 280), rand.nextRangeF(-20, 220),
+                    rand.nextRangeF(-20, 280), rand.nextRangeF(-20, 220));
+        canvas->drawPath(path, paint);
+        canvas->drawCircle(rand.nextRangeF(0, 256), rand.nextRangeF(0, 200),
+                           rand.nextRangeF(1, 40), paint);
+    }
+
+    const SkPoint pts[] = {{0, 0}, {256, 200}};
+    const SkColor colors[] = {SK_ColorRED, SK_ColorBLUE};
+    paint.reset();
+    paint.setShader(SkGradientShader::MakeLinear(pts, colors, nullptr, 2,
+                                                 SkShader::kClamp_TileMode));
+    paint.setDither(true);
+    paint.setAlpha(0x80);
+    canvas->save();
+    canvas->rotate(17);
+    canvas->clipRRect(SkRRect::MakeOval(SkRect::MakeXYWH(20, 10, 180, 150)), true);
+    canvas->drawPaint(paint);
+    canvas->restore();
+
+    paint.reset();
+    paint.setAntiAlias(true);
+    paint.setTextSize(23);
+    sk_tool_utils::set_portable_typeface(&paint);
+    for (int y = 20; y < 200; y += 30) {
+        canvas->drawString("Hello threaded world", 5, SkIntToScalar(y), paint);
+    }
+
+    SkPoint points[64];
+    for (SkPoint& p : points) {
+        p = {rand.nextRangeF(0, 256), rand.nextRangeF(0, 200)};
+    }
+    paint.setStrokeWidth(3);
+    canvas->drawPoints(SkCanvas::kPolygon_PointMode, SK_ARRAY_COUNT(points), points, paint);
+
+    canvas->saveLayerAlpha(nullptr, 0x80);
+    canvas->drawRect(SkRect::MakeXYWH(40, 40, 100, 100), paint);
+    canvas->restore();
+}
+
+static bool equal_pixels(const SkPixmap& a, const SkPixmap& b) {
+    for (int y = 0; y < a.height(); ++y) {
+        if (0 != memcmp(a.addr(0, y), b.addr(0, y), a.info().minRowBytes())) {
+            return false;
+        }
+    }
+    return true;
+}
+
+DEF_TEST(ThreadedBMPDevice_MatchesRaster, reporter) {
+    const SkImageInfo info = SkImageInfo::MakeN32Premul(256, 200);
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+
+    auto reference = SkSurface::MakeRaster(info);
+    auto threaded = SkSurface::MakeRasterThreaded(info, executor.get());
+    REPORTER_ASSERT(reporter, threaded);
+
+    draw_content(reference->getCanvas());
+    draw_content(threaded->getCanvas());
+
+    SkPixmap expected, actual;
+    REPORTER_ASSERT(reporter, reference->peekPixels(&expected));
+    REPORTER_ASSERT(reporter, threaded->peekPixels(&actual));
+    REPORTER_ASSERT(reporter, equal_pixels(expected, actual));
+}
+
+DEF_TEST(ThreadedBMPDevice_SnapshotKeepsCanvasState, reporter) {
+    const SkImageInfo info = SkImageInfo::MakeN32Premul(64, 64);
+    auto surface = SkSurface::MakeRasterThreaded(info, nullptr);
+    SkCanvas* canvas = surface->getCanvas();
+
+    canvas->clear(SK_ColorWHITE);
+    canvas->save();
+    canvas->translate(32, 0);
+    canvas->clipRect(SkRect::MakeWH(32, 64));
+
+    SkPaint paint;
+    paint.setColor(SK_ColorRED);
+    canvas->drawRect(SkRect::MakeWH(64, 32), paint);
+
+    // Taking a snapshot flushes, but must not disturb the matrix or clip.
+    sk_sp<SkImage> first = surface->makeImageSnapshot();
+    paint.setColor(SK_ColorBLUE);
+    canvas->drawRect(SkRect::MakeXYWH(-32, 32, 64, 32), paint);
+    canvas->restore();
+
+    auto check = [&](const SkImage* image, int x, int y, SkColor expected) {
+        SkBitmap bm;
+        bm.allocPixels(SkImageInfo::MakeN32Premul(1, 1));
+        REPORTER_ASSERT(reporter, image->readPixels(bm.pixmap(), x, y));
+        REPORTER_ASSERT(reporter, bm.getColor(0, 0) == expected);
+    };
+    sk_sp<SkImage> second = surface->makeImageSnapshot();
+    check(first.get(),  40, 40, SK_ColorWHITE);
+    check(second.get(), 40, 40, SK_ColorBLUE);
+    check(second.get(),  8, 40, SK_ColorWHITE);
+    check(second.get(), 40,  8, SK_ColorRED);
+    check(second.get(),  8,  8, SK_ColorWHITE);
+}
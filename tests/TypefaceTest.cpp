@@ -7,14 +7,21 @@
 
 #include "SkAdvancedTypefaceMetrics.h"
 #include "SkData.h"
+#include "SkExecutor.h"
 #include "SkFixed.h"
 #include "SkFontDescriptor.h"
 #include "SkFontMgr.h"
 #include "SkMakeUnique.h"
 #include "SkOTTable_OS_2.h"
+#include "SkFont.h"
+#include "SkPaint.h"
 #include "SkSFNTHeader.h"
 #include "SkStream.h"
+#include "SkStrikeCache.h"
 #include "SkRefCnt.h"
+#include "SkSurfaceProps.h"
+#include "SkTaskGroup.h"
+#include "SkUTF.h"
 #include "SkTestEmptyTypeface.h"
 #include "SkTypeface.h"
 #include "SkTypefaceCache.h"
@@ -227,6 +234,68 @@ DEF_TEST(Typeface, reporter) {
     REPORTER_ASSERT(reporter, SkTypeface::Equal(t2.get(), nullptr));
 }
 
+DEF_TEST(Typeface_charsToGlyphs, reporter) {
+    sk_sp<SkTypeface> typeface(MakeResourceAsTypeface("fonts/Roboto-Regular.ttf"));
+    if (!typeface) {
+        // Not all SkFontMgr can MakeFromStream().
+        return;
+    }
+
+    // ASCII runs longer than the eight bytes decoded at once, Latin-1, Greek, CJK (which Roboto
+    // doesn't have), surrogates, and characters outside of the BMP, over several chunks.
+    static const SkUnichar kOthers[] = { 0xE9, 0x3A9, 0x4E2D, 0x1F600, 0x10000, 0xFFFD };
+    SkTDArray<SkUnichar> unichars;
+    for (int i = 0; i < 700; ++i) {
+        unichars.push_back(i % 23 ? 'a' + i % 26 : kOthers[(i / 23) % SK_ARRAY_COUNT(kOthers)]);
+    }
+    SkString utf8;
+    SkTDArray<uint16_t> utf16;
+    for (SkUnichar uni : unichars) {
+        char bytes[SkUTF::kMaxBytesInUTF8Sequence];
+        utf8.append(bytes, SkUTF::ToUTF8(uni, bytes));
+        uint16_t units[2];
+        utf16.append(SkUTF::ToUTF16(uni, units), units);
+    }
+
+    // The glyph cache maps characters with the scaler context, not the typeface.
+    SkFont font;
+    font.setTypeface(typeface);
+    SkPaint paint;
+    SkSurfaceProps props(0, kUnknown_SkPixelGeometry);
+    auto cache = SkStrikeCache::FindOrCreateStrikeExclusive(
+            font, paint, props, SkScalerContextFlags::kNone, SkMatrix::I());
+    SkTDArray<SkGlyphID> expected;
+    int expectedFirstMissing = -1;
+    for (SkUnichar uni : unichars) {
+        if (0 == (*expected.append() = cache->unicharToGlyph(uni)) && expectedFirstMissing < 0) {
+            expectedFirstMissing = expected.count() - 1;
+        }
+    }
+    REPORTER_ASSERT(reporter, expected[0] != 0 && expectedFirstMissing > 0);
+
+    const struct {
+        const void* fChars;
+        SkTypeface::Encoding fEncoding;
+    } kTests[] = {
+        { utf8.c_str(), SkTypeface::kUTF8_Encoding },
+        { utf16.begin(), SkTypeface::kUTF16_Encoding },
+        { unichars.begin(), SkTypeface::kUTF32_Encoding },
+    };
+    for (const auto& test : kTests) {
+        SkTDArray<SkGlyphID> glyphs;
+        glyphs.setCount(unichars.count());
+        int firstMissing = typeface->charsToGlyphs(test.fChars, test.fEncoding, glyphs.begin(),
+                                                   unichars.count());
+        REPORTER_ASSERT(reporter, firstMissing == expectedFirstMissing);
+        REPORTER_ASSERT(reporter, glyphs == expected);
+        REPORTER_ASSERT(reporter, expectedFirstMissing ==
+                typeface->charsToGlyphs(test.fChars, test.fEncoding, nullptr, unichars.count()));
+    }
+    for (int i = 0; i < unichars.count(); ++i) {
+        REPORTER_ASSERT(reporter, typeface->unicharToGlyph(unichars[i]) == expected[i]);
+    }
+}
+
 DEF_TEST(TypefaceAxesParameters, reporter) {
     std::unique_ptr<SkStreamAsset> distortable(GetResourceAsStream("fonts/Distortable.ttf"));
     if (!distortable) {
@@ -297,6 +366,34 @@ DEF_TEST(TypefaceCache, reporter) {
     REPORTER_ASSERT(reporter, t1->unique());
 }
 
+static bool find_by_pointer(SkTypeface* cached, void* context) {
+    return cached == context;
+}
+
+// Lookups share the global cache's lock, while additions take it for themselves.
+DEF_TEST(TypefaceCache_threaded, reporter) {
+    constexpr int kCount = 64;
+    sk_sp<SkTypeface> faces[kCount];
+    for (sk_sp<SkTypeface>& face : faces) {
+        face = SkTestEmptyTypeface::Make();
+    }
+
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+    SkTaskGroup(*executor).batch(kCount, [&](int i) {
+        SkTypefaceCache::Add(faces[i].get());
+        for (int j = 0; j < 100; j++) {
+            sk_sp<SkTypeface> found(SkTypefaceCache::FindByProcAndRef(find_by_pointer,
+                                                                      faces[i].get()));
+            REPORTER_ASSERT(reporter, found == faces[i]);
+        }
+    });
+
+    for (sk_sp<SkTypeface>& face : faces) {
+        face.reset();
+    }
+    SkTypefaceCache::PurgeAll();
+}
+
 static void check_serialize_behaviors(sk_sp<SkTypeface> tf, bool isLocalData,
                                       skiatest::Reporter* reporter) {
     if (!tf) {
@@ -6,11 +6,15 @@
  */
 
 #include "SkCanvas.h"
+#include "SkImage.h"
+#include "SkShader.h"
 #include "SkSurface.h"
 #include "SkVertices.h"
 #include "sk_pixel_iter.h"
 #include "Test.h"
 
+#include "GrContext.h"
+
 static bool equal(const SkVertices* v0, const SkVertices* v1) {
     if (v0->mode() != v1->mode()) {
         return false;
@@ -147,3 +151,49 @@ DEF_TEST(Vertices_clipping, reporter) {
         }
     }
 }
+
+DEF_GPUTEST_FOR_RENDERING_CONTEXTS(Vertices_nonVolatileLayouts, reporter, ctxInfo) {
+    // Non-volatile vertices keep their GPU buffers between draws. Which attributes those buffers
+    // hold depends on the paint, so drawing the same vertices with and without a shader must not
+    // reuse a buffer with the wrong layout.
+    static constexpr int kSize = 4;
+    auto surf = SkSurface::MakeRenderTarget(ctxInfo.grContext(), SkBudgeted::kNo,
+                                            SkImageInfo::MakeN32Premul(kSize, kSize));
+    if (!surf) {
+        return;
+    }
+
+    const SkPoint pts[] = { {0, 0}, {kSize, 0}, {0, kSize}, {kSize, kSize} };
+    const SkPoint texs[] = { {0, 0}, {1, 0}, {0, 1}, {1, 1} };
+    auto verts = SkVertices::MakeCopy(SkVertices::kTriangleStrip_VertexMode, 4, pts, texs,
+                                      nullptr, /*isVolatile=*/false);
+
+    SkBitmap red;
+    red.allocN32Pixels(1, 1);
+    red.eraseColor(SK_ColorRED);
+    SkPaint shaderPaint;
+    shaderPaint.setShader(SkImage::MakeFromBitmap(red)->makeShader());
+
+    SkPaint bluePaint;
+    bluePaint.setColor(SK_ColorBLUE);
+
+    for (const SkPaint& paint : {shaderPaint, bluePaint, shaderPaint}) {
+        surf->getCanvas()->clear(SK_ColorTRANSPARENT);
+        surf->getCanvas()->drawVertices(verts, SkBlendMode::kModulate, paint);
+
+        SkBitmap result;
+        result.allocN32Pixels(kSize, kSize);
+        if (!surf->readPixels(result, 0, 0)) {
+            ERRORF(reporter, "Could not read pixels");
+            return;
+        }
+        SkColor expected = paint.getShader() ? SK_ColorRED : SK_ColorBLUE;
+        for (int y = 0; y < kSize; ++y) {
+            for (int x = 0; x < kSize; ++x) {
+                REPORTER_ASSERT(reporter, result.getColor(x, y) == expected,
+                                "(%d, %d): 0x%08x != 0x%08x", x, y, result.getColor(x, y),
+                                expected);
+            }
+        }
+    }
+}
@@ -309,6 +309,8 @@ public:
     // The method returns false if there is an error.
     bool decode(int frameIndex, bool* frameComplete);
 
+    std::unique_ptr<SkStream> duplicateStream() const { return m_streamBuffer.duplicateStream(); }
+
     int imagesCount() const
     {
         const int frames = m_frames.count();
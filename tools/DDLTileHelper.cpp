@@ -11,11 +11,13 @@
 #include "SkCanvas.h"
 #include "SkDeferredDisplayListPriv.h"
 #include "SkDeferredDisplayListRecorder.h"
+#include "SkExecutor.h"
 #include "SkImage_Gpu.h"
 #include "SkPicture.h"
 #include "SkSurface.h"
 #include "SkSurfaceCharacterization.h"
 #include "SkTaskGroup.h"
+#include "SkTime.h"
 
 DDLTileHelper::TileData::TileData(sk_sp<SkSurface> s, const SkIRect& clip)
         : fSurface(std::move(s))
@@ -45,6 +47,8 @@ void DDLTileHelper::TileData::createTileSpecificSKP(SkData* compressedPictureDat
 void DDLTileHelper::TileData::createDDL() {
     SkASSERT(!fDisplayList);
 
+    double startMs = SkTime::GetMSecs();
+
     SkDeferredDisplayListRecorder recorder(fCharacterization);
 
     // DDL TODO: the DDLRecorder's GrContext isn't initialized until getCanvas is called.
@@ -73,6 +77,8 @@ void DDLTileHelper::TileData::createDDL() {
     }
 
     fDisplayList = recorder.detach();
+
+    fRecordMs = SkTime::GetMSecs() - startMs;
 }
 
 void DDLTileHelper::TileData::draw() {
@@ -136,10 +142,11 @@ void DDLTileHelper::createSKPPerTile(SkData* compressedPictureData,
     }
 }
 
-void DDLTileHelper::createDDLsInParallel() {
+void DDLTileHelper::createDDLsInParallel(SkExecutor* executor) {
 #if 1
-    SkTaskGroup().batch(fTiles.count(), [&](int i) { fTiles[i].createDDL(); });
-    SkTaskGroup().wait();
+    SkTaskGroup taskGroup(executor ? *executor : SkExecutor::GetDefault());
+    taskGroup.batch(fTiles.count(), [&](int i) { fTiles[i].createDDL(); });
+    taskGroup.wait();
 #else
     // Use this code path to debug w/o threads
     for (int i = 0; i < fTiles.count(); ++i) {
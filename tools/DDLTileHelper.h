@@ -16,6 +16,7 @@ class DDLPromiseImageHelper;
 class SkCanvas;
 class SkData;
 class SkDeferredDisplayList;
+class SkExecutor;
 class SkPicture;
 class SkSurface;
 class SkSurfaceCharacterization;
@@ -47,6 +48,12 @@ public:
 
         void reset();
 
+        const SkIRect& clip() const { return fClip; }
+        const SkDeferredDisplayList* ddl() const { return fDisplayList.get(); }
+
+        // Wall time spent in the most recent call to createDDL(), in milliseconds.
+        double recordMs() const { return fRecordMs; }
+
     private:
         sk_sp<SkSurface>                       fSurface;
         SkSurfaceCharacterization              fCharacterization;
@@ -55,13 +62,15 @@ public:
         SkTArray<sk_sp<SkImage>>               fPromiseImages; // All the promise images in the
                                                                // reconstituted picture
         std::unique_ptr<SkDeferredDisplayList> fDisplayList;
+        double                                 fRecordMs = 0;
     };
 
     DDLTileHelper(SkCanvas* canvas, const SkIRect& viewport, int numDivisions);
 
     void createSKPPerTile(SkData* compressedPictureData, const DDLPromiseImageHelper& helper);
 
-    void createDDLsInParallel();
+    // Records the DDLs on 'executor', or on SkExecutor::GetDefault() if it is null.
+    void createDDLsInParallel(SkExecutor* executor = nullptr);
 
     void drawAllTilesAndFlush(GrContext*, bool flush);
 
@@ -69,6 +78,9 @@ public:
 
     void resetAllTiles();
 
+    int numTiles() const { return fTiles.count(); }
+    TileData& tile(int i) { return fTiles[i]; }
+
 private:
     int                fNumDivisions; // number of tiles along a side
     SkTArray<TileData> fTiles;
@@ -0,0 +1,116 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "PerfCounters.h"
+#include "SkTypes.h"
+
+using namespace sk_tools;
+
+const char* PerfCounters::Name(Counter counter) {
+    switch (counter) {
+        case kInstructions: return "instructions";
+        case kCycles:       return "cycles";
+        case kCacheMisses:  return "cache_misses";
+        case kBranchMisses: return "branch_misses";
+        case kCounterCount: break;
+    }
+    SkASSERT(false);
+    return "";
+}
+
+#if defined(SK_BUILD_FOR_UNIX) || defined(SK_BUILD_FOR_ANDROID)
+    #include <linux/perf_event.h>
+    #include <string.h>
+    #include <sys/ioctl.h>
+    #include <sys/syscall.h>
+    #include <unistd.h>
+
+    PerfCounters::PerfCounters() {
+        static const uint64_t kConfigs[kCounterCount] = {
+            PERF_COUNT_HW_INSTRUCTIONS,
+            PERF_COUNT_HW_CPU_CYCLES,
+            PERF_COUNT_HW_CACHE_MISSES,
+            PERF_COUNT_HW_BRANCH_MISSES,
+        };
+        for (int i = 0; i < kCounterCount; i++) {
+            perf_event_attr attr;
+            memset(&attr, 0, sizeof(attr));
+            attr.size           = sizeof(attr);
+            attr.type           = PERF_TYPE_HARDWARE;
+            attr.config         = kConfigs[i];
+            attr.disabled       = 1;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv     = 1;
+            attr.read_format    = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+            // There's no libc wrapper for perf_event_open().  This thread only, on any CPU.
+            fFDs[i] = (int)syscall(__NR_perf_event_open, &attr, 0/*pid*/, -1/*cpu*/,
+                                   -1/*group fd*/, 0/*flags*/);
+        }
+    }
+
+    PerfCounters::~PerfCounters() {
+        for (int fd : fFDs) {
+            if (fd >= 0) {
+                close(fd);
+            }
+        }
+    }
+
+    bool PerfCounters::isValid() const {
+        for (int fd : fFDs) {
+            if (fd >= 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void PerfCounters::start() {
+        for (int fd : fFDs) {
+            if (fd >= 0) {
+                ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+                ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+            }
+        }
+    }
+
+    void PerfCounters::stop() {
+        for (int fd : fFDs) {
+            if (fd >= 0) {
+                ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+            }
+        }
+    }
+
+    int64_t PerfCounters::read(Counter counter) const {
+        int fd = fFDs[counter];
+        // { value, time enabled, time running }, as requested by our read_format.
+        uint64_t values[3];
+        if (fd < 0 || (ssize_t)sizeof(values) != ::read(fd, values, sizeof(values)) ||
+                values[2] == 0) {
+            return -1;
+        }
+        if (values[2] < values[1]) {
+            // The counter was multiplexed with others, so only ran part of the time.
+            return (int64_t)((double)values[0] * values[1] / values[2]);
+        }
+        return (int64_t)values[0];
+    }
+#else
+    PerfCounters::PerfCounters() {
+        for (int& fd : fFDs) {
+            fd = -1;
+        }
+    }
+    PerfCounters::~PerfCounters() {}
+
+    bool PerfCounters::isValid() const { return false; }
+    void PerfCounters::start() {}
+    void PerfCounters::stop() {}
+    int64_t PerfCounters::read(Counter) const { return -1; }
+#endif
@@ -0,0 +1,60 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef PerfCounters_DEFINED
+#define PerfCounters_DEFINED
+
+#include <stdint.h>
+
+namespace sk_tools {
+
+/**
+ *  PerfCounters - counts hardware events on the calling thread between start() and stop().
+ *
+ *  Only implemented on Linux, using perf_event_open().  Elsewhere, or when the kernel won't let us
+ *  count (see /proc/sys/kernel/perf_event_paranoid), every counter reads as unavailable.
+ */
+class PerfCounters {
+public:
+    enum Counter {
+        kInstructions,
+        kCycles,
+        kCacheMisses,
+        kBranchMisses,
+
+        kCounterCount
+    };
+
+    PerfCounters();
+    ~PerfCounters();
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    static const char* Name(Counter);
+
+    /** Are any of the counters available? */
+    bool isValid() const;
+
+    /** Resets the counters and starts counting. */
+    void start();
+    void stop();
+
+    /**
+     *  Returns the count between the last start() and stop(), or -1 if the counter is unavailable.
+     *  If the kernel had to share the hardware with other counters, this is scaled up to estimate
+     *  the count over the whole time.
+     */
+    int64_t read(Counter) const;
+
+private:
+    int fFDs[kCounterCount];
+};
+
+}  // namespace sk_tools
+
+#endif  // PerfCounters_DEFINED
@@ -59,7 +59,8 @@ SkDebugCanvas::SkDebugCanvas(int width, int height)
         : INHERITED(width, height)
         , fOverdrawViz(false)
         , fClipVizColor(SK_ColorTRANSPARENT)
-        , fDrawGpuOpBounds(false) {
+        , fDrawGpuOpBounds(false)
+        , fGpuOpTiming(false) {
     // SkPicturePlayback uses the base-class' quickReject calls to cull clipped
     // operations. This can lead to problems in the debugger which expects all
     // the operations in the captured skp to appear in the debug canvas. To
@@ -235,7 +236,10 @@ void SkDebugCanvas::drawAndCollectOps(int n, SkCanvas* canvas) {
         // in case there is some kind of global reordering
         {
             GrAuditTrail::AutoEnable ae(at);
+            at->setGpuTimingEnabled(fGpuOpTiming);
             canvas->flush();
+            at->resolveGpuTimes();
+            at->setGpuTimingEnabled(false);
         }
     }
 }
@@ -358,8 +362,10 @@ void SkDebugCanvas::onDrawImageNine(const SkImage* image, const SkIRect& center,
 }
 
 void SkDebugCanvas::onDrawImageSet(const SkCanvas::ImageSetEntry set[], int count,
-                                   SkFilterQuality filterQuality, SkBlendMode mode) {
-    this->addDrawCommand(new SkDrawImageSetCommand(set, count, filterQuality, mode));
+                                   const SkMatrix preViewMatrices[], SkFilterQuality filterQuality,
+                                   SkBlendMode mode) {
+    this->addDrawCommand(new SkDrawImageSetCommand(set, count, preViewMatrices, filterQuality,
+                                                   mode));
 }
 
 void SkDebugCanvas::onDrawOval(const SkRect& oval, const SkPaint& paint) {
@@ -45,6 +45,14 @@ public:
 
     bool getDrawGpuOpBounds() const { return fDrawGpuOpBounds; }
 
+    /**
+     * When enabled, the GPU op list JSON reports how long the GPU spent on each op, if the
+     * backend supports timer queries.
+     */
+    void setGpuOpTiming(bool gpuOpTiming) { fGpuOpTiming = gpuOpTiming; }
+
+    bool getGpuOpTiming() const { return fGpuOpTiming; }
+
     /**
         Executes all draw calls to the canvas.
         @param canvas  The canvas being drawn to
@@ -158,7 +166,8 @@ protected:
                             const SkRect& dst, const SkPaint* paint) override;
     void onDrawImageRect(const SkImage*, const SkRect* src, const SkRect& dst,
                          const SkPaint*, SrcRectConstraint) override;
-    void onDrawImageSet(const ImageSetEntry[], int count, SkFilterQuality, SkBlendMode) override;
+    void onDrawImageSet(const ImageSetEntry[], int count, const SkMatrix[], SkFilterQuality,
+                        SkBlendMode) override;
     void onDrawBitmapNine(const SkBitmap&, const SkIRect& center, const SkRect& dst,
                           const SkPaint*) override;
     void onDrawImageNine(const SkImage*, const SkIRect& center, const SkRect& dst,
@@ -182,6 +191,7 @@ private:
     bool fOverdrawViz;
     SkColor fClipVizColor;
     bool fDrawGpuOpBounds;
+    bool fGpuOpTiming;
 
     /**
         Adds the command to the class' vector of commands.
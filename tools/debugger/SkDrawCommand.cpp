@@ -1530,6 +1530,7 @@ Json::Value SkDrawImageRectCommand::toJSON(UrlDataManager& urlDataManager) const
 }
 
 SkDrawImageSetCommand::SkDrawImageSetCommand(const SkCanvas::ImageSetEntry set[], int count,
+                                             const SkMatrix preViewMatrices[],
                                              SkFilterQuality filterQuality, SkBlendMode mode)
         : INHERITED(kDrawImageSet_OpType)
         , fSet(count)
@@ -1537,10 +1538,18 @@ SkDrawImageSetCommand::SkDrawImageSetCommand(const SkCanvas::ImageSetEntry set[]
         , fFilterQuality(filterQuality)
         , fMode(mode) {
     std::copy_n(set, count, fSet.get());
+    int matrixCount = 0;
+    for (int i = 0; i < count; ++i) {
+        matrixCount = SkTMax(matrixCount, set[i].fMatrixIndex + 1);
+    }
+    fPreViewMatrices.append(matrixCount, preViewMatrices);
 }
 
 void SkDrawImageSetCommand::execute(SkCanvas* canvas) const {
-    canvas->experimental_DrawImageSetV1(fSet.get(), fCount, fFilterQuality, fMode);
+    canvas->experimental_DrawImageSetV2(fSet.get(), fCount,
+                                        fPreViewMatrices.isEmpty() ? nullptr
+                                                                   : fPreViewMatrices.begin(),
+                                        fFilterQuality, fMode);
 }
 
 SkDrawImageNineCommand::SkDrawImageNineCommand(const SkImage* image, const SkIRect& center,
@@ -366,12 +366,14 @@ private:
 
 class SkDrawImageSetCommand : public SkDrawCommand {
 public:
-    SkDrawImageSetCommand(const SkCanvas::ImageSetEntry[], int count, SkFilterQuality, SkBlendMode);
+    SkDrawImageSetCommand(const SkCanvas::ImageSetEntry[], int count, const SkMatrix[],
+                          SkFilterQuality, SkBlendMode);
     void execute(SkCanvas* canvas) const override;
 
 private:
     SkAutoTArray<SkCanvas::ImageSetEntry> fSet;
     int fCount;
+    SkTDArray<SkMatrix> fPreViewMatrices;
     SkFilterQuality fFilterQuality;
     SkBlendMode fMode;
 
@@ -123,6 +123,9 @@ void GrGpu::Stats::dump(SkString* out) {
     out->appendf("Transfers to Texture: %d\n", fTransfersToTexture);
     out->appendf("Stencil Buffer Creates: %d\n", fStencilAttachmentCreates);
     out->appendf("Number of draws: %d\n", fNumDraws);
+    out->appendf("Draws skipped for pending programs: %d\n", fNumDrawsSkippedForPendingPrograms);
+    out->appendf("Uniform uploads: %d\n", fUniformUploads);
+    out->appendf("Uniform uploads skipped: %d\n", fUniformUploadsSkipped);
 }
 
 void GrGpu::Stats::dumpKeyValuePairs(SkTArray<SkString>* keys, SkTArray<double>* values) {
@@ -131,6 +134,10 @@ void GrGpu::Stats::dumpKeyValuePairs(SkTArray<SkString>* keys, SkTArray<double>*
     keys->push_back(SkString("texture_uploads")); values->push_back(fTextureUploads);
     keys->push_back(SkString("number_of_draws")); values->push_back(fNumDraws);
     keys->push_back(SkString("number_of_failed_draws")); values->push_back(fNumFailedDraws);
+    keys->push_back(SkString("number_of_draws_skipped_for_pending_programs"));
+    values->push_back(fNumDrawsSkippedForPendingPrograms);
+    keys->push_back(SkString("uniform_uploads")); values->push_back(fUniformUploads);
+    keys->push_back(SkString("uniform_uploads_skipped")); values->push_back(fUniformUploadsSkipped);
 }
 
 #endif
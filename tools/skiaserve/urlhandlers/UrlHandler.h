@@ -135,6 +135,17 @@ public:
                const char* upload_data, size_t* upload_data_size) override;
 };
 
+/*
+ * Enables timing of gpu ops
+ */
+class OpTimingHandler : public UrlHandler {
+public:
+    bool canHandle(const char* method, const char* url) override;
+    int handle(Request* request, MHD_Connection* connection,
+               const char* url, const char* method,
+               const char* upload_data, size_t* upload_data_size) override;
+};
+
 class RootHandler : public UrlHandler {
 public:
     bool canHandle(const char* method, const char* url) override;
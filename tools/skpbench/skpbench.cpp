@@ -15,6 +15,8 @@
 #include "SkCommonFlags.h"
 #include "SkCommonFlagsGpu.h"
 #include "SkDeferredDisplayList.h"
+#include "SkDeferredDisplayListPriv.h"
+#include "SkExecutor.h"
 #include "SkGraphics.h"
 #include "SkGr.h"
 #include "SkOSFile.h"
@@ -40,6 +42,8 @@
 #include <array>
 #include <chrono>
 #include <cmath>
+#include <deque>
+#include <thread>
 #include <vector>
 
 /**
@@ -52,12 +56,19 @@
  * render target and syncs the GPU after each draw.
  *
  * Currently, only GPU configs are supported.
+ *
+ * With --pacingFps, it instead plays the skp (or a sequence of skps) as a compositor would: one
+ * frame per vsync at the given rate, with up to --framesInFlight frames queued on the GPU. It then
+ * reports how many frames missed their deadline, and the spread of their cpu record, flush, and
+ * gpu times.
  */
 
 DEFINE_bool(ddl, false, "record the skp into DDLs before rendering");
 DEFINE_int32(ddlNumAdditionalThreads, 0, "number of DDL recording threads in addition to main one");
 DEFINE_int32(ddlTilingWidthHeight, 0, "number of tiles along one edge when in DDL mode");
 DEFINE_bool(ddlRecordTime, false, "report just the cpu time spent recording DDLs");
+DEFINE_bool(ddlTileStats, false, "print DDL record-time scaling and per-tile stats before the "
+                                 "result");
 
 DEFINE_int32(duration, 5000, "number of milliseconds to run the benchmark");
 DEFINE_int32(sampleMs, 50, "minimum duration of a sample");
@@ -67,6 +78,9 @@ DEFINE_string(src, "", "path to a single .skp or .svg file, or 'warmup' for a bu
 DEFINE_string(png, "", "if set, save a .png proof to disk at this file location");
 DEFINE_int32(verbosity, 4, "level of verbosity (0=none to 5=debug)");
 DEFINE_bool(suppressHeader, false, "don't print a header row before the results");
+DEFINE_int32(pacingFps, 0, "if > 0, play --src (one or more skps) at this frame rate and report "
+                           "frame pacing instead");
+DEFINE_int32(framesInFlight, 2, "in pacing mode, how many frames the gpu may lag behind");
 
 static const char* header =
 "   accum    median       max       min   stddev  samples  sample_ms  clock  metric  config    bench";
@@ -74,6 +88,12 @@ static const char* header =
 static const char* resultFormat =
 "%8.4g  %8.4g  %8.4g  %8.4g  %6.3g%%  %7li  %9i  %-5s  %-6s  %-9s %s";
 
+static const char* pacingHeader =
+"  frames   missed  fps  inflight  phase    p50_ms    p90_ms    p99_ms    max_ms  config    bench";
+
+static const char* pacingFormat =
+"%8zu  %6.3g%%  %3i  %8i  %-6s  %8.4g  %8.4g  %8.4g  %8.4g  %-9s %s";
+
 static constexpr int kNumFlushesToPrimeCache = 3;
 
 struct Sample {
@@ -113,6 +133,7 @@ enum class ExitErr {
 };
 
 static void draw_skp_and_flush(SkCanvas*, const SkPicture*);
+static sk_sp<SkPicture> load_src(const char* src, SkString* srcname);
 static sk_sp<SkPicture> create_warmup_skp();
 static sk_sp<SkPicture> create_skp_from_svg(SkStream*, const char* filename);
 static bool mkdir_p(const SkString& name);
@@ -145,7 +166,85 @@ static void ddl_sample(GrContext* context, DDLTileHelper* tiles, GpuSync* gpuSyn
     }
 }
 
-static void run_ddl_benchmark(const sk_gpu_test::FenceSync* fenceSync,
+// Records all the tiles once with 0..ddlNumAdditionalThreads worker threads to show how recording
+// scales, then reports each tile's record time, opList/opChain counts and replay time. Replay is
+// timed on the gpu clock when the context supports it and on the cpu clock (including a finish)
+// otherwise.
+static void print_ddl_tile_stats(GrContext* context, sk_gpu_test::TestContext* testCtx,
+                                 DDLTileHelper* tiles) {
+    using clock = std::chrono::high_resolution_clock;
+    constexpr int kNumRecordRuns = 3;
+
+    printf("DDL record time for %i tiles:\n", tiles->numTiles());
+    printf("  threads   record_ms  speedup\n");
+    double serialMs = 0;
+    for (int threads = 0; threads <= FLAGS_ddlNumAdditionalThreads; ++threads) {
+        std::unique_ptr<SkExecutor> executor;
+        if (threads > 0) {
+            executor = SkExecutor::MakeFIFOThreadPool(threads);
+        }
+        double bestMs = 0;
+        for (int run = 0; run < kNumRecordRuns; ++run) {
+            clock::time_point start = clock::now();
+            if (executor) {
+                tiles->createDDLsInParallel(executor.get());
+            } else {
+                for (int i = 0; i < tiles->numTiles(); ++i) {
+                    tiles->tile(i).createDDL();
+                }
+            }
+            double ms = std::chrono::duration<double, std::milli>(clock::now() - start).count();
+            bestMs = (0 == run) ? ms : SkTMin(bestMs, ms);
+            tiles->resetAllTiles();
+        }
+        if (0 == threads) {
+            serialMs = bestMs;
+        }
+        printf("  %7i  %10.4g  %6.3gx\n", threads, bestMs, serialMs / SkTMax(bestMs, 1e-6));
+    }
+
+    const bool gpuClock = testCtx->gpuTimingSupport();
+    tiles->createDDLsInParallel();
+    printf("DDL tiles (replay on the %s clock):\n", gpuClock ? "gpu" : "cpu");
+    printf("  tile         x      y      w      h  record_ms  opLists  opChains  replay_ms\n");
+    for (int i = 0; i < tiles->numTiles(); ++i) {
+        DDLTileHelper::TileData& tile = tiles->tile(i);
+        const SkIRect& clip = tile.clip();
+        const SkDeferredDisplayList* ddl = tile.ddl();
+        int numOpLists = ddl ? ddl->priv().numOpLists() : 0;
+        int numOpChains = ddl ? ddl->priv().numOpChains() : 0;
+
+        double replayMs = 0;
+        if (gpuClock) {
+            sk_gpu_test::GpuTimer* gpuTimer = testCtx->gpuTimer();
+            gpuTimer->queueStart();
+            tile.draw();
+            context->flush();
+            sk_gpu_test::PlatformTimerQuery query = gpuTimer->queueStop();
+            testCtx->finish();
+            if (sk_gpu_test::GpuTimer::QueryStatus::kInvalid != gpuTimer->checkQueryStatus(query)) {
+                replayMs = std::chrono::duration<double, std::milli>(
+                        gpuTimer->getTimeElapsed(query)).count();
+            }
+            gpuTimer->deleteQuery(query);
+        } else {
+            clock::time_point start = clock::now();
+            tile.draw();
+            context->flush();
+            testCtx->finish();
+            replayMs = std::chrono::duration<double, std::milli>(clock::now() - start).count();
+        }
+
+        printf("  %4i  %6i %6i %6i %6i  %9.4g  %7i  %8i  %9.4g\n", i,
+               clip.fLeft, clip.fTop, clip.width(), clip.height(), tile.recordMs(),
+               numOpLists, numOpChains, replayMs);
+    }
+    fflush(stdout);
+
+    tiles->resetAllTiles();
+}
+
+static void run_ddl_benchmark(sk_gpu_test::TestContext* testCtx,
                               GrContext* context, SkCanvas* finalCanvas,
                               SkPicture* inputPicture, std::vector<Sample>* samples) {
     using clock = std::chrono::high_resolution_clock;
@@ -168,10 +267,14 @@ static void run_ddl_benchmark(const sk_gpu_test::FenceSync* fenceSync,
 
     SkTaskGroup::Enabler enabled(FLAGS_ddlNumAdditionalThreads);
 
+    if (FLAGS_ddlTileStats) {
+        print_ddl_tile_stats(context, testCtx, &tiles);
+    }
+
     clock::time_point startStopTime = clock::now();
 
     ddl_sample(context, &tiles, nullptr, nullptr, &startStopTime);
-    GpuSync gpuSync(fenceSync);
+    GpuSync gpuSync(testCtx->fenceSync());
     ddl_sample(context, &tiles, &gpuSync, nullptr, &startStopTime);
 
     clock::duration cumulativeDuration = std::chrono::milliseconds(0);
@@ -290,6 +393,151 @@ static void run_gpu_time_benchmark(sk_gpu_test::GpuTimer* gpuTimer,
     gpuTimer->deleteQuery(previousTime);
 }
 
+// One frame in pacing mode. Times are in milliseconds; fGpuMs is negative if it isn't known.
+struct PacedFrame {
+    double   fRecordMs;
+    double   fFlushMs;
+    double   fGpuMs;
+    bool     fMissedDeadline;
+};
+
+// Plays the skps in order, starting a frame at each vsync. Each frame must be done on the gpu by
+// the vsync --framesInFlight intervals after it started, when it would be presented. We check this
+// at that vsync (waiting for its fence if need be), or later if the cpu fell behind. A frame that
+// can't be started by its vsync waits for the next one, as if the compositor dropped a frame.
+static void run_pacing_benchmark(sk_gpu_test::TestContext* testCtx, SkCanvas* canvas,
+                                 const std::vector<sk_sp<SkPicture>>& skps,
+                                 std::vector<PacedFrame>* frames) {
+    using sk_gpu_test::PlatformFence;
+    using sk_gpu_test::PlatformTimerQuery;
+    using clock = std::chrono::steady_clock;
+    const clock::duration interval = std::chrono::duration_cast<clock::duration>(
+            std::chrono::duration<double>(1.0 / FLAGS_pacingFps));
+    const clock::duration benchDuration = std::chrono::milliseconds(FLAGS_duration);
+    // Allow for waking up a little late.
+    const clock::duration slack = std::chrono::microseconds(500);
+    auto to_ms = [](clock::duration d) {
+        return std::chrono::duration<double, std::milli>(d).count();
+    };
+
+    const sk_gpu_test::FenceSync* fenceSync = testCtx->fenceSync();
+    sk_gpu_test::GpuTimer* gpuTimer = testCtx->gpuTimingSupport() ? testCtx->gpuTimer() : nullptr;
+
+    for (int i = 0; i < kNumFlushesToPrimeCache; ++i) {
+        for (const sk_sp<SkPicture>& skp : skps) {
+            draw_skp_and_flush(canvas, skp.get());
+        }
+    }
+    testCtx->finish();
+
+    struct InFlightFrame {
+        clock::time_point    fDeadline;
+        PlatformFence        fFence;
+        PlatformTimerQuery   fTimerQuery;
+        PacedFrame           fFrame;
+    };
+    std::deque<InFlightFrame> inFlight;
+    auto present = [&](InFlightFrame* f) {
+        if (!fenceSync->waitFence(f->fFence)) {
+            exitf(ExitErr::kUnavailable, "failed to wait for fence");
+        }
+        f->fFrame.fMissedDeadline = clock::now() > f->fDeadline + slack;
+        fenceSync->deleteFence(f->fFence);
+        if (gpuTimer) {
+            if (sk_gpu_test::GpuTimer::QueryStatus::kAccurate ==
+                    gpuTimer->checkQueryStatus(f->fTimerQuery)) {
+                f->fFrame.fGpuMs = std::chrono::duration<double, std::milli>(
+                        gpuTimer->getTimeElapsed(f->fTimerQuery)).count();
+            }
+            gpuTimer->deleteQuery(f->fTimerQuery);
+        }
+        frames->push_back(f->fFrame);
+    };
+
+    const clock::time_point start = clock::now();
+    const clock::time_point endTime = start + benchDuration;
+    int64_t tick = 0;
+    for (size_t n = 0;; ++n) {
+        const clock::time_point vsync = start + tick * interval;
+        std::this_thread::sleep_until(vsync);
+
+        while (!inFlight.empty() && inFlight.front().fDeadline <= vsync) {
+            present(&inFlight.front());
+            inFlight.pop_front();
+        }
+        if (vsync >= endTime) {
+            break;
+        }
+        SkASSERT((int)inFlight.size() < FLAGS_framesInFlight);
+
+        inFlight.emplace_back();
+        InFlightFrame& f = inFlight.back();
+        f.fDeadline = vsync + FLAGS_framesInFlight * interval;
+        f.fFrame.fGpuMs = -1;
+
+        if (gpuTimer) {
+            gpuTimer->queueStart();
+        }
+        clock::time_point recordStart = clock::now();
+        canvas->drawPicture(skps[n % skps.size()].get());
+        clock::time_point flushStart = clock::now();
+        canvas->flush();
+        clock::time_point flushEnd = clock::now();
+        if (gpuTimer) {
+            f.fTimerQuery = gpuTimer->queueStop();
+        }
+        f.fFence = fenceSync->insertFence();
+        if (sk_gpu_test::kInvalidFence == f.fFence) {
+            exitf(ExitErr::kUnavailable, "failed to insert fence");
+        }
+        f.fFrame.fRecordMs = to_ms(flushStart - recordStart);
+        f.fFrame.fFlushMs  = to_ms(flushEnd - flushStart);
+
+        // The next frame starts at the first vsync after this one's cpu work.
+        tick = SkTMax(tick + 1, (int64_t)((flushEnd - start) / interval) + 1);
+    }
+    while (!inFlight.empty()) {
+        present(&inFlight.front());
+        inFlight.pop_front();
+    }
+}
+
+static void print_pacing_result(const std::vector<PacedFrame>& frames, const char* config,
+                                const char* bench) {
+    if (frames.empty()) {
+        exitf(ExitErr::kSoftware, "attempted to gather stats on zero frames");
+    }
+
+    size_t missed = 0;
+    std::vector<double> phases[4];
+    for (const PacedFrame& frame : frames) {
+        missed += frame.fMissedDeadline;
+        phases[0].push_back(frame.fRecordMs);
+        phases[1].push_back(frame.fFlushMs);
+        if (frame.fGpuMs >= 0) {
+            phases[2].push_back(frame.fGpuMs);
+        }
+        phases[3].push_back(frame.fRecordMs + frame.fFlushMs + SkTMax(frame.fGpuMs, 0.0));
+    }
+
+    static const char* kPhaseNames[] = {"record", "flush", "gpu", "total"};
+    for (int i = 0; i < 4; ++i) {
+        std::vector<double>& values = phases[i];
+        if (values.empty()) {
+            continue;  // The gpu doesn't support timing.
+        }
+        std::sort(values.begin(), values.end());
+        auto percentile = [&values](double p) {
+            return values[SkTMin(values.size() - 1, (size_t)(p * values.size()))];
+        };
+        printf(pacingFormat, frames.size(), 100.0 * missed / frames.size(), FLAGS_pacingFps,
+               FLAGS_framesInFlight, kPhaseNames[i], percentile(0.5), percentile(0.9),
+               percentile(0.99), values.back(), config, bench);
+        printf("\n");
+    }
+    fflush(stdout);
+}
+
 void print_result(const std::vector<Sample>& samples, const char* config, const char* bench)  {
     if (0 == (samples.size() % 2)) {
         exitf(ExitErr::kSoftware, "attempted to gather stats on even number of samples");
@@ -327,8 +575,9 @@ int main(int argc, char** argv) {
                                  "You usually don't want to use this program directly.");
     SkCommandLineFlags::Parse(argc, argv);
 
+    const bool pacing = FLAGS_pacingFps > 0;
     if (!FLAGS_suppressHeader) {
-        printf("%s\n", header);
+        printf("%s\n", pacing ? pacingHeader : header);
     }
     if (FLAGS_duration <= 0) {
         exit(0); // This can be used to print the header and quit.
@@ -343,36 +592,35 @@ int main(int argc, char** argv) {
                                join(FLAGS_config).c_str());
     }
 
-    // Parse the skp.
-    if (FLAGS_src.count() != 1) {
+    // Parse the skp. In pacing mode, a sequence of them plays as an animation.
+    if (FLAGS_src.count() != 1 && !(pacing && FLAGS_src.count() > 1)) {
         exitf(ExitErr::kUsage,
               "invalid input '%s': must specify a single .skp or .svg file, or 'warmup'",
               join(FLAGS_src).c_str());
     }
+    if (pacing && (FLAGS_ddl || FLAGS_gpuClock)) {
+        exitf(ExitErr::kUsage, "--pacingFps can't be combined with --ddl or --gpuClock");
+    }
+    if (pacing && FLAGS_framesInFlight < 1) {
+        exitf(ExitErr::kUsage, "invalid --framesInFlight %i: must be at least 1",
+                               FLAGS_framesInFlight);
+    }
 
     SkGraphics::Init();
 
-    sk_sp<SkPicture> skp;
+    std::vector<sk_sp<SkPicture>> skps;
     SkString srcname;
-    if (0 == strcmp(FLAGS_src[0], "warmup")) {
-        skp = create_warmup_skp();
-        srcname = "warmup";
-    } else {
-        SkString srcfile(FLAGS_src[0]);
-        std::unique_ptr<SkStream> srcstream(SkStream::MakeFromFile(srcfile.c_str()));
-        if (!srcstream) {
-            exitf(ExitErr::kIO, "failed to open file %s", srcfile.c_str());
+    for (int i = 0; i < FLAGS_src.count(); ++i) {
+        SkString name;
+        skps.push_back(load_src(FLAGS_src[i], &name));
+        if (0 == i) {
+            srcname = name;
         }
-        if (srcfile.endsWith(".svg")) {
-            skp = create_skp_from_svg(srcstream.get(), srcfile.c_str());
-        } else {
-            skp = SkPicture::MakeFromStream(srcstream.get());
-        }
-        if (!skp) {
-            exitf(ExitErr::kData, "failed to parse file %s", srcfile.c_str());
-        }
-        srcname = SkOSPath::Basename(srcfile.c_str());
     }
+    if (skps.size() > 1) {
+        srcname.appendf("+%zu", skps.size() - 1);
+    }
+    const sk_sp<SkPicture>& skp = skps.front();
     int width = SkTMin(SkScalarCeilToInt(skp->cullRect().width()), 2048),
         height = SkTMin(SkScalarCeilToInt(skp->cullRect().height()), 2048);
     if (FLAGS_verbosity >= 3 &&
@@ -434,6 +682,16 @@ int main(int argc, char** argv) {
                                      width, height, config->getTag().c_str());
     }
 
+    if (pacing) {
+        SkCanvas* canvas = surface->getCanvas();
+        canvas->translate(-skp->cullRect().x(), -skp->cullRect().y());
+        std::vector<PacedFrame> frames;
+        frames.reserve((size_t)FLAGS_duration * FLAGS_pacingFps / 1000 + 1);
+        run_pacing_benchmark(testCtx, canvas, skps, &frames);
+        print_pacing_result(frames, config->getTag().c_str(), srcname.c_str());
+        exit(0);
+    }
+
     // Run the benchmark.
     std::vector<Sample> samples;
     if (FLAGS_sampleMs > 0) {
@@ -446,7 +704,7 @@ int main(int argc, char** argv) {
     canvas->translate(-skp->cullRect().x(), -skp->cullRect().y());
     if (!FLAGS_gpuClock) {
         if (FLAGS_ddl) {
-            run_ddl_benchmark(testCtx->fenceSync(), ctx, canvas, skp.get(), &samples);
+            run_ddl_benchmark(testCtx, ctx, canvas, skp.get(), &samples);
         } else {
             run_benchmark(testCtx->fenceSync(), canvas, skp.get(), &samples);
         }
@@ -485,6 +743,29 @@ static void draw_skp_and_flush(SkCanvas* canvas, const SkPicture* skp) {
     canvas->flush();
 }
 
+static sk_sp<SkPicture> load_src(const char* src, SkString* srcname) {
+    if (0 == strcmp(src, "warmup")) {
+        *srcname = "warmup";
+        return create_warmup_skp();
+    }
+    SkString srcfile(src);
+    std::unique_ptr<SkStream> srcstream(SkStream::MakeFromFile(srcfile.c_str()));
+    if (!srcstream) {
+        exitf(ExitErr::kIO, "failed to open file %s", srcfile.c_str());
+    }
+    sk_sp<SkPicture> skp;
+    if (srcfile.endsWith(".svg")) {
+        skp = create_skp_from_svg(srcstream.get(), srcfile.c_str());
+    } else {
+        skp = SkPicture::MakeFromStream(srcstream.get());
+    }
+    if (!skp) {
+        exitf(ExitErr::kData, "failed to parse file %s", srcfile.c_str());
+    }
+    *srcname = SkOSPath::Basename(srcfile.c_str());
+    return skp;
+}
+
 static sk_sp<SkPicture> create_warmup_skp() {
     static constexpr SkRect bounds{0, 0, 500, 500};
     SkPictureRecorder recorder;
@@ -75,6 +75,9 @@ __argparse.add_argument('--ddlTilingWidthHeight',
   type=int, default=0, help="number of tiles along one edge when in DDL mode")
 __argparse.add_argument('--ddlRecordTime',
   action='store_true', help="report just the cpu time spent recording DDLs")
+__argparse.add_argument('--ddlTileStats',
+  action='store_true',
+  help="print DDL record-time scaling and per-tile stats before the result")
 __argparse.add_argument('--gpuThreads',
   type=int, default=-1,
   help="Create this many extra threads to assist with GPU work, including"
@@ -146,6 +149,8 @@ class SKPBench:
     ARGV.extend(['--ddlTilingWidthHeight', str(FLAGS.ddlTilingWidthHeight)])
   if FLAGS.ddlRecordTime:
     ARGV.extend(['--ddlRecordTime', 'true'])
+  if FLAGS.ddlTileStats:
+    ARGV.extend(['--ddlTileStats', 'true'])
 
   if FLAGS.adb:
     if FLAGS.device_serial is None:
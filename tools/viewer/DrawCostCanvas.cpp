@@ -0,0 +1,430 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "DrawCostCanvas.h"
+
+#include "GrAuditTrail.h"
+#include "SkBitmap.h"
+#include "SkColorPriv.h"
+#include "SkImage.h"
+#include "SkPaint.h"
+#include "SkPath.h"
+#include "SkPicture.h"
+#include "SkRRect.h"
+#include "SkRSXform.h"
+#include "SkRegion.h"
+#include "SkSurface.h"
+#include "SkTemplates.h"
+#include "SkTextBlob.h"
+#include "SkTime.h"
+#include "SkVertices.h"
+
+#include <memory>
+
+DrawCostCanvas::DrawCostCanvas(SkCanvas* target, GrAuditTrail* auditTrail)
+        : SkCanvasVirtualEnforcer<SkNWayCanvas>(target->imageInfo().width(),
+                                                target->imageInfo().height())
+        , fAuditTrail(auditTrail) {
+    // Transfer matrix & clip state before adding the target canvas.
+    this->clipRect(SkRect::Make(target->getDeviceClipBounds()));
+    this->setMatrix(target->getTotalMatrix());
+
+    this->addCanvas(target);
+}
+
+template <typename Fn>
+void DrawCostCanvas::timeDraw(const char* name, const SkRect* bounds, const SkPaint* paint,
+                              Fn&& draw) {
+    SkIRect deviceBounds = this->getDeviceClipBounds();
+    SkRect storage;
+    if (bounds && paint) {
+        bounds = paint->canComputeFastBounds() ? &paint->computeFastBounds(*bounds, &storage)
+                                               : nullptr;
+    }
+    if (bounds) {
+        // Outset for antialiasing, like quickReject().
+        SkIRect drawBounds = this->getTotalMatrix().mapRect(*bounds).makeOutset(1, 1).roundOut();
+        if (!deviceBounds.intersect(drawBounds)) {
+            deviceBounds.setEmpty();
+        }
+    }
+
+    // The ops the draw makes are tagged with its index.
+    std::unique_ptr<GrAuditTrail::AutoCollectOps> collect;
+    if (fAuditTrail) {
+        collect.reset(new GrAuditTrail::AutoCollectOps(fAuditTrail, fDraws.count()));
+    }
+    double start = SkTime::GetNSecs();
+    draw();
+    double nanos = SkTime::GetNSecs() - start;
+    collect.reset();
+
+    fDraws.push_back({name, deviceBounds, nanos * 1e-6, -1});
+}
+
+bool DrawCostCanvas::collectGpuTimes() {
+    if (!fAuditTrail) {
+        return false;
+    }
+    SkAutoTArray<double> nanos(fDraws.count());
+    for (int i = 0; i < fDraws.count(); ++i) {
+        nanos[i] = 0;
+    }
+    if (!fAuditTrail->addGpuTimesByClientID(nanos.get(), fDraws.count())) {
+        return false;
+    }
+    for (int i = 0; i < fDraws.count(); ++i) {
+        fDraws[i].fGpuMs = nanos[i] * 1e-6;
+    }
+    return true;
+}
+
+double DrawCostCanvas::GetMs(const Draw& draw, Cost cost) {
+    double gpuMs = SkTMax(draw.fGpuMs, 0.0);
+    switch (cost) {
+        case Cost::kCpu:       return draw.fCpuMs;
+        case Cost::kGpu:       return gpuMs;
+        case Cost::kCpuAndGpu: return draw.fCpuMs + gpuMs;
+    }
+    return 0;
+}
+
+void DrawCostCanvas::DrawHeatmap(SkCanvas* canvas, const SkTArray<Draw>& draws, Cost cost) {
+    // The heat is summed in cells of this many pixels square.
+    static constexpr int kCellSize = 4;
+
+    SkISize size = canvas->getBaseLayerSize();
+    int width  = (size.width()  + kCellSize - 1) / kCellSize;
+    int height = (size.height() + kCellSize - 1) / kCellSize;
+    if (width <= 0 || height <= 0) {
+        return;
+    }
+
+    // Add each draw's cost per pixel at the corners of its cells, so that a running sum over
+    // the rows and columns gives the heat of each cell.
+    int stride = width + 1;
+    SkAutoTMalloc<double> heat(stride * (height + 1));
+    sk_bzero(heat.get(), stride * (height + 1) * sizeof(double));
+    for (const Draw& draw : draws) {
+        SkIRect bounds = draw.fDeviceBounds;
+        if (!bounds.intersect(SkIRect::MakeSize(size))) {
+            continue;
+        }
+        double perPixel = GetMs(draw, cost) / ((double)bounds.width() * bounds.height());
+        int left   = bounds.fLeft / kCellSize;
+        int top    = bounds.fTop / kCellSize;
+        int right  = (bounds.fRight  + kCellSize - 1) / kCellSize;
+        int bottom = (bounds.fBottom + kCellSize - 1) / kCellSize;
+        heat[top    * stride + left ] += perPixel;
+        heat[top    * stride + right] -= perPixel;
+        heat[bottom * stride + left ] -= perPixel;
+        heat[bottom * stride + right] += perPixel;
+    }
+    double maxHeat = 0;
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            double* cell = &heat[y * stride + x];
+            if (x > 0) {
+                cell[0] += cell[-1];
+            }
+            if (y > 0) {
+                cell[0] += cell[-stride];
+            }
+            if (x > 0 && y > 0) {
+                cell[0] -= cell[-stride - 1];
+            }
+            maxHeat = SkTMax(maxHeat, cell[0]);
+        }
+    }
+    if (maxHeat <= 0) {
+        return;
+    }
+
+    // Ramp from clear through yellow to red.
+    SkBitmap bitmap;
+    bitmap.allocPixels(SkImageInfo::MakeN32(width, height, kUnpremul_SkAlphaType));
+    for (int y = 0; y < height; ++y) {
+        uint32_t* row = bitmap.getAddr32(0, y);
+        for (int x = 0; x < width; ++x) {
+            float t = SkTPin((float)(heat[y * stride + x] / maxHeat), 0.f, 1.f);
+            float green = t < 0.5f ? 1 : 2 * (1 - t);
+            row[x] = SkPackARGB32NoCheck(SkScalarRoundToInt(t * 200),
+                                         255, SkScalarRoundToInt(green * 255), 0);
+        }
+    }
+
+    SkAutoCanvasRestore acr(canvas, true);
+    canvas->resetMatrix();
+    canvas->scale(kCellSize, kCellSize);
+    canvas->drawBitmap(bitmap, 0, 0);
+}
+
+void DrawCostCanvas::onDrawPaint(const SkPaint& paint) {
+    this->timeDraw("drawPaint", nullptr, &paint, [&] {
+        this->SkNWayCanvas::onDrawPaint(paint);
+    });
+}
+
+void DrawCostCanvas::onDrawPoints(PointMode mode, size_t count, const SkPoint pts[],
+                                  const SkPaint& paint) {
+    SkRect bounds;
+    bounds.set(pts, SkToInt(count));
+    this->timeDraw("drawPoints", &bounds, &paint, [&] {
+        this->SkNWayCanvas::onDrawPoints(mode, count, pts, paint);
+    });
+}
+
+void DrawCostCanvas::onDrawRect(const SkRect& rect, const SkPaint& paint) {
+    SkRect bounds = rect.makeSorted();
+    this->timeDraw("drawRect", &bounds, &paint, [&] {
+        this->SkNWayCanvas::onDrawRect(rect, paint);
+    });
+}
+
+void DrawCostCanvas::onDrawRRect(const SkRRect& rrect, const SkPaint& paint) {
+    this->timeDraw("drawRRect", &rrect.getBounds(), &paint, [&] {
+        this->SkNWayCanvas::onDrawRRect(rrect, paint);
+    });
+}
+
+void DrawCostCanvas::onDrawDRRect(const SkRRect& outer, const SkRRect& inner,
+                                  const SkPaint& paint) {
+    this->timeDraw("drawDRRect", &outer.getBounds(), &paint, [&] {
+        this->SkNWayCanvas::onDrawDRRect(outer, inner, paint);
+    });
+}
+
+void DrawCostCanvas::onDrawRegion(const SkRegion& region, const SkPaint& paint) {
+    SkRect bounds = SkRect::Make(region.getBounds());
+    this->timeDraw("drawRegion", &bounds, &paint, [&] {
+        this->SkNWayCanvas::onDrawRegion(region, paint);
+    });
+}
+
+void DrawCostCanvas::onDrawOval(const SkRect& rect, const SkPaint& paint) {
+    SkRect bounds = rect.makeSorted();
+    this->timeDraw("drawOval", &bounds, &paint, [&] {
+        this->SkNWayCanvas::onDrawOval(rect, paint);
+    });
+}
+
+void DrawCostCanvas::onDrawArc(const SkRect& rect, SkScalar startAngle, SkScalar sweepAngle,
+                               bool useCenter, const SkPaint& paint) {
+    SkRect bounds = rect.makeSorted();
+    this->timeDraw("drawArc", &bounds, &paint, [&] {
+        this->SkNWayCanvas::onDrawArc(rect, startAngle, sweepAngle, useCenter, paint);
+    });
+}
+
+void DrawCostCanvas::onDrawPath(const SkPath& path, const SkPaint& paint) {
+    // Inverse fills can touch anything inside the clip.
+    const SkRect* bounds = path.isInverseFillType() ? nullptr : &path.getBounds();
+    this->timeDraw("drawPath", bounds, &paint, [&] {
+        this->SkNWayCanvas::onDrawPath(path, paint);
+    });
+}
+
+void DrawCostCanvas::onDrawBitmap(const SkBitmap& bm, SkScalar left, SkScalar top,
+                                  const SkPaint* paint) {
+    SkRect bounds = SkRect::MakeXYWH(left, top, bm.width(), bm.height());
+    this->timeDraw("drawBitmap", &bounds, paint, [&] {
+        this->SkNWayCanvas::onDrawBitmap(bm, left, top, paint);
+    });
+}
+
+void DrawCostCanvas::onDrawBitmapRect(const SkBitmap& bm, const SkRect* src, const SkRect& dst,
+                                      const SkPaint* paint, SrcRectConstraint constraint) {
+    SkRect bounds = dst.makeSorted();
+    this->timeDraw("drawBitmapRect", &bounds, paint, [&] {
+        this->SkNWayCanvas::onDrawBitmapRect(bm, src, dst, paint, constraint);
+    });
+}
+
+void DrawCostCanvas::onDrawBitmapNine(const SkBitmap& bm, const SkIRect& center,
+                                      const SkRect& dst, const SkPaint* paint) {
+    SkRect bounds = dst.makeSorted();
+    this->timeDraw("drawBitmapNine", &bounds, paint, [&] {
+        this->SkNWayCanvas::onDrawBitmapNine(bm, center, dst, paint);
+    });
+}
+
+void DrawCostCanvas::onDrawBitmapLattice(const SkBitmap& bm, const Lattice& lattice,
+                                         const SkRect& dst, const SkPaint* paint) {
+    SkRect bounds = dst.makeSorted();
+    this->timeDraw("drawBitmapLattice", &bounds, paint, [&] {
+        this->SkNWayCanvas::onDrawBitmapLattice(bm, lattice, dst, paint);
+    });
+}
+
+void DrawCostCanvas::onDrawImage(const SkImage* image, SkScalar left, SkScalar top,
+                                 const SkPaint* paint) {
+    SkRect bounds = SkRect::MakeXYWH(left, top, image->width(), image->height());
+    this->timeDraw("drawImage", &bounds, paint, [&] {
+        this->SkNWayCanvas::onDrawImage(image, left, top, paint);
+    });
+}
+
+void DrawCostCanvas::onDrawImageRect(const SkImage* image, const SkRect* src, const SkRect& dst,
+                                     const SkPaint* paint, SrcRectConstraint constraint) {
+    SkRect bounds = dst.makeSorted();
+    this->timeDraw("drawImageRect", &bounds, paint, [&] {
+        this->SkNWayCanvas::onDrawImageRect(image, src, dst, paint, constraint);
+    });
+}
+
+void DrawCostCanvas::onDrawImageNine(const SkImage* image, const SkIRect& center,
+                                     const SkRect& dst, const SkPaint* paint) {
+    SkRect bounds = dst.makeSorted();
+    this->timeDraw("drawImageNine", &bounds, paint, [&] {
+        this->SkNWayCanvas::onDrawImageNine(image, center, dst, paint);
+    });
+}
+
+void DrawCostCanvas::onDrawImageLattice(const SkImage* image, const Lattice& lattice,
+                                        const SkRect& dst, const SkPaint* paint) {
+    SkRect bounds = dst.makeSorted();
+    this->timeDraw("drawImageLattice", &bounds, paint, [&] {
+        this->SkNWayCanvas::onDrawImageLattice(image, lattice, dst, paint);
+    });
+}
+
+void DrawCostCanvas::onDrawImageSet(const SkCanvas::ImageSetEntry set[], int count,
+                                    const SkMatrix preViewMatrices[], SkFilterQuality quality,
+                                    SkBlendMode mode) {
+    SkRect bounds = SkRect::MakeEmpty();
+    for (int i = 0; i < count; ++i) {
+        SkRect dst = set[i].fDstRect;
+        if (set[i].fMatrixIndex >= 0) {
+            dst = preViewMatrices[set[i].fMatrixIndex].mapRect(dst);
+        }
+        bounds.join(dst);
+    }
+    this->timeDraw("drawImageSet", &bounds, nullptr, [&] {
+        this->SkNWayCanvas::onDrawImageSet(set, count, preViewMatrices, quality, mode);
+    });
+}
+
+void DrawCostCanvas::onDrawVerticesObject(const SkVertices* vertices,
+                                          const SkVertices::Bone bones[], int boneCount,
+                                          SkBlendMode mode, const SkPaint& paint) {
+    // Bones move the vertices away from their bounds.
+    const SkRect* bounds = boneCount > 0 ? nullptr : &vertices->bounds();
+    this->timeDraw("drawVertices", bounds, &paint, [&] {
+        this->SkNWayCanvas::onDrawVerticesObject(vertices, bones, boneCount, mode, paint);
+    });
+}
+
+void DrawCostCanvas::onDrawPatch(const SkPoint cubics[12], const SkColor colors[4],
+                                 const SkPoint texCoords[4], SkBlendMode mode,
+                                 const SkPaint& paint) {
+    SkRect bounds;
+    bounds.set(cubics, 12);
+    this->timeDraw("drawPatch", &bounds, &paint, [&] {
+        this->SkNWayCanvas::onDrawPatch(cubics, colors, texCoords, mode, paint);
+    });
+}
+
+void DrawCostCanvas::onDrawPicture(const SkPicture* picture, const SkMatrix* matrix,
+                                   const SkPaint* paint) {
+    // Play the picture back through this canvas, to time each of its draws.
+    this->SkCanvas::onDrawPicture(picture, matrix, paint);
+}
+
+void DrawCostCanvas::onDrawDrawable(SkDrawable* drawable, const SkMatrix* matrix) {
+    // As with pictures, draw the drawable's contents through this canvas.
+    this->SkCanvas::onDrawDrawable(drawable, matrix);
+}
+
+void DrawCostCanvas::onDrawText(const void* text, size_t byteLength, SkScalar x, SkScalar y,
+                                const SkPaint& paint) {
+    SkRect bounds;
+    paint.measureText(text, byteLength, &bounds);
+    bounds.offset(x, y);
+    this->timeDraw("drawText", &bounds, &paint, [&] {
+        this->SkNWayCanvas::onDrawText(text, byteLength, x, y, paint);
+    });
+}
+
+void DrawCostCanvas::onDrawPosText(const void* text, size_t byteLength, const SkPoint pos[],
+                                   const SkPaint& paint) {
+    this->timeDraw("drawPosText", nullptr, &paint, [&] {
+        this->SkNWayCanvas::onDrawPosText(text, byteLength, pos, paint);
+    });
+}
+
+void DrawCostCanvas::onDrawPosTextH(const void* text, size_t byteLength, const SkScalar xpos[],
+                                    SkScalar constY, const SkPaint& paint) {
+    this->timeDraw("drawPosTextH", nullptr, &paint, [&] {
+        this->SkNWayCanvas::onDrawPosTextH(text, byteLength, xpos, constY, paint);
+    });
+}
+
+void DrawCostCanvas::onDrawTextRSXform(const void* text, size_t byteLength,
+                                       const SkRSXform xform[], const SkRect* cull,
+                                       const SkPaint& paint) {
+    this->timeDraw("drawTextRSXform", cull, &paint, [&] {
+        this->SkNWayCanvas::onDrawTextRSXform(text, byteLength, xform, cull, paint);
+    });
+}
+
+void DrawCostCanvas::onDrawTextBlob(const SkTextBlob* blob, SkScalar x, SkScalar y,
+                                    const SkPaint& paint) {
+    SkRect bounds = blob->bounds().makeOffset(x, y);
+    this->timeDraw("drawTextBlob", &bounds, &paint, [&] {
+        this->SkNWayCanvas::onDrawTextBlob(blob, x, y, paint);
+    });
+}
+
+void DrawCostCanvas::onDrawAtlas(const SkImage* image, const SkRSXform xform[],
+                                 const SkRect tex[], const SkColor colors[], int count,
+                                 SkBlendMode mode, const SkRect* cull, const SkPaint* paint) {
+    this->timeDraw("drawAtlas", cull, paint, [&] {
+        this->SkNWayCanvas::onDrawAtlas(image, xform, tex, colors, count, mode, cull, paint);
+    });
+}
+
+void DrawCostCanvas::onDrawAnnotation(const SkRect& rect, const char key[], SkData* value) {
+    // Annotations don't draw anything.
+    this->SkNWayCanvas::onDrawAnnotation(rect, key, value);
+}
+
+void DrawCostCanvas::onDrawShadowRec(const SkPath& path, const SkDrawShadowRec& rec) {
+    // Shadows spread well past the path, so use the clip.
+    this->timeDraw("drawShadow", nullptr, nullptr, [&] {
+        this->SkNWayCanvas::onDrawShadowRec(path, rec);
+    });
+}
+
+sk_sp<SkSurface> DrawCostCanvas::onNewSurface(const SkImageInfo& info,
+                                              const SkSurfaceProps& props) {
+    return this->target()->makeSurface(info, &props);
+}
+
+bool DrawCostCanvas::onPeekPixels(SkPixmap* pixmap) {
+    return this->target()->peekPixels(pixmap);
+}
+
+bool DrawCostCanvas::onAccessTopLayerPixels(SkPixmap* pixmap) {
+    SkImageInfo info;
+    size_t rowBytes;
+
+    void* addr = this->target()->accessTopLayerPixels(&info, &rowBytes);
+    if (!addr) {
+        return false;
+    }
+
+    pixmap->reset(info, addr, rowBytes);
+    return true;
+}
+
+SkImageInfo DrawCostCanvas::onImageInfo() const {
+    return this->target()->imageInfo();
+}
+
+bool DrawCostCanvas::onGetProps(SkSurfaceProps* props) const {
+    return this->target()->getProps(props);
+}
@@ -0,0 +1,129 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef DrawCostCanvas_DEFINED
+#define DrawCostCanvas_DEFINED
+
+#include "SkCanvasVirtualEnforcer.h"
+#include "SkNWayCanvas.h"
+#include "SkTArray.h"
+
+class GrAuditTrail;
+
+/**
+ * Forwards draws to another canvas, timing each one on the CPU and noting the device bounds it
+ * can touch. Pictures and drawables are played back through it, so each of their draws is timed
+ * on its own.
+ *
+ * Given a GrAuditTrail, the ops each draw makes are tagged with its index. After a flush made with
+ * the audit trail's GPU timing on, collectGpuTimes() gives each draw its share of the GPU time of
+ * the op chains its ops ended up in.
+ */
+class DrawCostCanvas : public SkCanvasVirtualEnforcer<SkNWayCanvas> {
+public:
+    struct Draw {
+        const char* fName;
+        SkIRect     fDeviceBounds;
+        double      fCpuMs;
+        double      fGpuMs;  // -1 if it isn't known
+    };
+
+    DrawCostCanvas(SkCanvas* target, GrAuditTrail* = nullptr);
+
+    const SkTArray<Draw>& draws() const { return fDraws; }
+
+    // Returns false if the audit trail has no GPU times, e.g. the backend can't time its ops.
+    bool collectGpuTimes();
+
+    enum class Cost {
+        kCpu,
+        kGpu,
+        kCpuAndGpu,
+    };
+    static double GetMs(const Draw&, Cost);
+
+    /**
+     * Shades the canvas by cost per pixel: each draw's cost is spread evenly over its device
+     * bounds, and the sum at each point goes from clear for none to opaque red for the most.
+     */
+    static void DrawHeatmap(SkCanvas*, const SkTArray<Draw>&, Cost);
+
+    // Forwarded to the wrapped canvas.
+    SkISize getBaseLayerSize() const override { return this->target()->getBaseLayerSize(); }
+    GrContext* getGrContext() override { return this->target()->getGrContext(); }
+    GrRenderTargetContext* internal_private_accessTopLayerRenderTargetContext() override {
+        return this->target()->internal_private_accessTopLayerRenderTargetContext();
+    }
+
+protected:
+    void onDrawPaint(const SkPaint&) override;
+    void onDrawPoints(PointMode, size_t count, const SkPoint pts[], const SkPaint&) override;
+    void onDrawRect(const SkRect&, const SkPaint&) override;
+    void onDrawRRect(const SkRRect&, const SkPaint&) override;
+    void onDrawDRRect(const SkRRect&, const SkRRect&, const SkPaint&) override;
+    void onDrawRegion(const SkRegion&, const SkPaint&) override;
+    void onDrawOval(const SkRect&, const SkPaint&) override;
+    void onDrawArc(const SkRect&, SkScalar, SkScalar, bool, const SkPaint&) override;
+    void onDrawPath(const SkPath&, const SkPaint&) override;
+    void onDrawBitmap(const SkBitmap&, SkScalar left, SkScalar top, const SkPaint*) override;
+    void onDrawBitmapRect(const SkBitmap&, const SkRect* src, const SkRect& dst, const SkPaint*,
+                          SrcRectConstraint) override;
+    void onDrawBitmapNine(const SkBitmap&, const SkIRect& center, const SkRect& dst,
+                          const SkPaint*) override;
+    void onDrawBitmapLattice(const SkBitmap&, const Lattice&, const SkRect&,
+                             const SkPaint*) override;
+    void onDrawImage(const SkImage*, SkScalar left, SkScalar top, const SkPaint*) override;
+    void onDrawImageRect(const SkImage*, const SkRect* src, const SkRect& dst,
+                         const SkPaint*, SrcRectConstraint) override;
+    void onDrawImageNine(const SkImage*, const SkIRect& center, const SkRect& dst,
+                         const SkPaint*) override;
+    void onDrawImageLattice(const SkImage*, const Lattice&, const SkRect&,
+                            const SkPaint*) override;
+    void onDrawImageSet(const SkCanvas::ImageSetEntry[], int count, const SkMatrix[],
+                        SkFilterQuality, SkBlendMode) override;
+    void onDrawVerticesObject(const SkVertices*, const SkVertices::Bone bones[], int boneCount,
+                              SkBlendMode, const SkPaint&) override;
+    void onDrawPatch(const SkPoint cubics[12], const SkColor colors[4],
+                     const SkPoint texCoords[4], SkBlendMode, const SkPaint& paint) override;
+    void onDrawPicture(const SkPicture*, const SkMatrix*, const SkPaint*) override;
+    void onDrawDrawable(SkDrawable*, const SkMatrix*) override;
+
+    void onDrawText(const void* text, size_t byteLength, SkScalar x, SkScalar y,
+                    const SkPaint&) override;
+    void onDrawPosText(const void* text, size_t byteLength, const SkPoint pos[],
+                       const SkPaint&) override;
+    void onDrawPosTextH(const void* text, size_t byteLength, const SkScalar xpos[],
+                        SkScalar constY, const SkPaint&) override;
+    void onDrawTextRSXform(const void* text, size_t byteLength, const SkRSXform xform[],
+                           const SkRect* cull, const SkPaint& paint) override;
+    void onDrawTextBlob(const SkTextBlob* blob, SkScalar x, SkScalar y,
+                        const SkPaint& paint) override;
+    void onDrawAtlas(const SkImage*, const SkRSXform[], const SkRect[], const SkColor[],
+                     int, SkBlendMode, const SkRect*, const SkPaint*) override;
+    void onDrawAnnotation(const SkRect& rect, const char key[], SkData* value) override;
+    void onDrawShadowRec(const SkPath& path, const SkDrawShadowRec& rec) override;
+
+    // Forwarded to the wrapped canvas.
+    sk_sp<SkSurface> onNewSurface(const SkImageInfo&, const SkSurfaceProps&) override;
+    bool onPeekPixels(SkPixmap* pixmap) override;
+    bool onAccessTopLayerPixels(SkPixmap* pixmap) override;
+    SkImageInfo onImageInfo() const override;
+    bool onGetProps(SkSurfaceProps* props) const override;
+
+private:
+    SkCanvas* target() const { SkASSERT(fList.count() == 1); return fList[0]; }
+
+    // Times draw(), which forwards one draw to the target. A null bounds means the draw can touch
+    // anything inside the clip; a paint makes the bounds include its effects when it can.
+    template <typename Fn>
+    void timeDraw(const char* name, const SkRect* bounds, const SkPaint* paint, Fn&& draw);
+
+    GrAuditTrail*  fAuditTrail;
+    SkTArray<Draw> fDraws;
+};
+
+#endif
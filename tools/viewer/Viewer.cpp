@@ -7,6 +7,7 @@
 
 #include "BisectSlide.h"
 #include "GMSlide.h"
+#include "GrAuditTrail.h"
 #include "GrContext.h"
 #include "GrContextPriv.h"
 #include "ImageSlide.h"
@@ -40,6 +41,7 @@
 #include "ccpr/GrCoverageCountingPathRenderer.h"
 
 #include <stdlib.h>
+#include <algorithm>
 #include <map>
 
 #include "imgui.h"
@@ -181,6 +183,11 @@ Viewer::Viewer(int argc, char** argv, void* platformData)
     , fZoomWindowLocation{0.0f, 0.0f}
     , fLastImage(nullptr)
     , fZoomUI(false)
+    , fShowDrawCosts(false)
+    , fDrawCostGpuTiming(false)
+    , fDrawCostHeat(DrawCostCanvas::Cost::kCpu)
+    , fDrawCostsHaveGpuTimes(false)
+    , fHighlightedDraw(-1)
     , fBackendType(sk_app::Window::kNativeGL_BackendType)
     , fColorMode(ColorMode::kLegacy)
     , fColorSpacePrimaries(gSrgbPrimaries)
@@ -275,6 +282,10 @@ Viewer::Viewer(int argc, char** argv, void* platformData)
         fStatsLayer.setActive(!fStatsLayer.getActive());
         fWindow->inval();
     });
+    fCommands.addCommand('o', "Overlays", "Toggle draw cost heatmap", [this]() {
+        fShowDrawCosts = !fShowDrawCosts;
+        fWindow->inval();
+    });
     fCommands.addCommand('0', "Overlays", "Reset stats", [this]() {
         fStatsLayer.resetMeasurements();
         this->updateTitle();
@@ -1127,6 +1138,10 @@ void Viewer::drawSlide(SkCanvas* canvas) {
         slideCanvas = offscreenSurface->getCanvas();
     }
 
+    // Draw costs are measured on the slide canvas, so not while tiling.
+    std::unique_ptr<DrawCostCanvas> costCanvas;
+    GrAuditTrail* auditTrail = nullptr;
+
     int count = slideCanvas->save();
     slideCanvas->clear(SK_ColorWHITE);
     // Time the painting logic of the slide
@@ -1165,7 +1180,16 @@ void Viewer::drawSlide(SkCanvas* canvas) {
         if (kPerspective_Real == fPerspectiveMode) {
             slideCanvas->clipRect(SkRect::MakeWH(fWindow->width(), fWindow->height()));
         }
-        OveridePaintFilterCanvas filterCanvas(slideCanvas, &fPaint, &fPaintOverrides);
+        SkCanvas* drawCanvas = slideCanvas;
+        if (fShowDrawCosts) {
+            GrContext* context = slideCanvas->getGrContext();
+            if (fDrawCostGpuTiming && context) {
+                auditTrail = context->contextPriv().getAuditTrail();
+            }
+            costCanvas.reset(new DrawCostCanvas(slideCanvas, auditTrail));
+            drawCanvas = costCanvas.get();
+        }
+        OveridePaintFilterCanvas filterCanvas(drawCanvas, &fPaint, &fPaintOverrides);
         fSlides[fCurrentSlide]->draw(&filterCanvas);
     }
     fStatsLayer.endTiming(fPaintTimer);
@@ -1173,9 +1197,31 @@ void Viewer::drawSlide(SkCanvas* canvas) {
 
     // Force a flush so we can time that, too
     fStatsLayer.beginTiming(fFlushTimer);
-    slideCanvas->flush();
+    if (auditTrail) {
+        // Op lists only time their op chains while the audit trail is enabled.
+        GrAuditTrail::AutoEnable enable(auditTrail);
+        auditTrail->setGpuTimingEnabled(true);
+        slideCanvas->flush();
+        auditTrail->setGpuTimingEnabled(false);
+    } else {
+        slideCanvas->flush();
+    }
     fStatsLayer.endTiming(fFlushTimer);
 
+    fDrawCostsHaveGpuTimes = false;
+    if (costCanvas) {
+        if (auditTrail) {
+            // This waits for the GPU to finish the frame.
+            GrAuditTrail::AutoEnable enable(auditTrail);
+            auditTrail->resolveGpuTimes();
+            fDrawCostsHaveGpuTimes = costCanvas->collectGpuTimes();
+            auditTrail->fullReset();
+        }
+        fDrawCosts = costCanvas->draws();
+    } else {
+        fDrawCosts.reset();
+    }
+
     // If we rendered offscreen, snap an image and push the results to the window's canvas
     if (offscreenSurface) {
         fLastImage = offscreenSurface->makeImageSnapshot();
@@ -1191,6 +1237,17 @@ void Viewer::drawSlide(SkCanvas* canvas) {
         canvas->drawImage(fLastImage, 0, 0, &paint);
         canvas->restoreToCount(prePerspectiveCount);
     }
+
+    if (fShowDrawCosts) {
+        DrawCostCanvas::DrawHeatmap(canvas, fDrawCosts, fDrawCostHeat);
+        if (fHighlightedDraw >= 0 && fHighlightedDraw < fDrawCosts.count()) {
+            SkPaint outline;
+            outline.setStyle(SkPaint::kStroke_Style);
+            outline.setStrokeWidth(2);
+            outline.setColor(SK_ColorBLUE);
+            canvas->drawRect(SkRect::Make(fDrawCosts[fHighlightedDraw].fDeviceBounds), outline);
+        }
+    }
 }
 
 void Viewer::onBackendCreated() {
@@ -1898,6 +1955,95 @@ void Viewer::drawImGui() {
 
         ImGui::End();
     }
+
+    if (fShowDrawCosts) {
+        this->drawDrawCostsWindow();
+    }
+}
+
+void Viewer::drawDrawCostsWindow() {
+    // Only this many of the draws are listed.
+    static constexpr int kMaxRows = 200;
+
+    fHighlightedDraw = -1;
+    ImGui::SetNextWindowSize(ImVec2(400, 400), ImGuiCond_FirstUseEver);
+    if (ImGui::Begin("Draw Costs", &fShowDrawCosts)) {
+        if (fWindow->getGrContext()) {
+            ImGui::Checkbox("GPU Timing", &fDrawCostGpuTiming);
+        }
+        int heat = static_cast<int>(fDrawCostHeat);
+        if (ImGui::Combo("Heat", &heat, "CPU\0GPU\0CPU + GPU\0\0")) {
+            fDrawCostHeat = static_cast<DrawCostCanvas::Cost>(heat);
+        }
+        if (fTiled) {
+            ImGui::Text("Draws aren't timed while tiling.");
+        }
+
+        double cpuMs = 0, gpuMs = 0;
+        for (const DrawCostCanvas::Draw& draw : fDrawCosts) {
+            cpuMs += draw.fCpuMs;
+            gpuMs += SkTMax(draw.fGpuMs, 0.0);
+        }
+        if (fDrawCostsHaveGpuTimes) {
+            ImGui::Text("%d draws, CPU %.3f ms, GPU %.3f ms", fDrawCosts.count(), cpuMs, gpuMs);
+        } else {
+            ImGui::Text("%d draws, CPU %.3f ms", fDrawCosts.count(), cpuMs);
+        }
+
+        // Clicking a column's header sorts the draws by it, the costs from most to least.
+        static int sortColumn = 2;
+        static const char* kHeaders[] = { "#", "Draw", "CPU ms", "GPU ms" };
+        SkTArray<int> order(fDrawCosts.count());
+        for (int i = 0; i < fDrawCosts.count(); ++i) {
+            order.push_back(i);
+        }
+        std::stable_sort(order.begin(), order.end(), [this](int a, int b) {
+            const DrawCostCanvas::Draw& drawA = fDrawCosts[a];
+            const DrawCostCanvas::Draw& drawB = fDrawCosts[b];
+            switch (sortColumn) {
+                case 1:  return strcmp(drawA.fName, drawB.fName) < 0;
+                case 2:  return drawA.fCpuMs > drawB.fCpuMs;
+                case 3:  return drawA.fGpuMs > drawB.fGpuMs;
+                default: return a < b;
+            }
+        });
+
+        ImGui::Columns(4, "DrawCostList");
+        for (int i = 0; i < 4; ++i) {
+            if (ImGui::Selectable(kHeaders[i], sortColumn == i)) {
+                sortColumn = i;
+            }
+            ImGui::NextColumn();
+        }
+        ImGui::Separator();
+        int rows = SkTMin(order.count(), kMaxRows);
+        for (int row = 0; row < rows; ++row) {
+            int index = order[row];
+            const DrawCostCanvas::Draw& draw = fDrawCosts[index];
+            // Hovering over a draw outlines its bounds.
+            SkString label = SkStringPrintf("%d", index);
+            ImGui::Selectable(label.c_str(), false, ImGuiSelectableFlags_SpanAllColumns);
+            if (ImGui::IsItemHovered()) {
+                fHighlightedDraw = index;
+            }
+            ImGui::NextColumn();
+            ImGui::Text("%s", draw.fName);
+            ImGui::NextColumn();
+            ImGui::Text("%.4f", draw.fCpuMs);
+            ImGui::NextColumn();
+            if (draw.fGpuMs >= 0) {
+                ImGui::Text("%.4f", draw.fGpuMs);
+            } else {
+                ImGui::Text("-");
+            }
+            ImGui::NextColumn();
+        }
+        ImGui::Columns(1);
+        if (order.count() > rows) {
+            ImGui::Text("and %d more", order.count() - rows);
+        }
+    }
+    ImGui::End();
 }
 
 void Viewer::onIdle() {
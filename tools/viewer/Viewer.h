@@ -12,6 +12,7 @@
 #include "sk_app/CommandSet.h"
 #include "sk_app/Window.h"
 #include "gm.h"
+#include "DrawCostCanvas.h"
 #include "ImGuiLayer.h"
 #include "SkAnimTimer.h"
 #include "SkExecutor.h"
@@ -98,6 +99,7 @@ private:
 
     void drawSlide(SkCanvas* canvs);
     void drawImGui();
+    void drawDrawCostsWindow();
 
     void changeZoomLevel(float delta);
     void preTouchMatrixChanged();
@@ -133,6 +135,14 @@ private:
     sk_sp<SkImage>         fLastImage;
     bool                   fZoomUI;
 
+    // The cost of each draw in the last frame, shaded over it and listed by cost.
+    bool                   fShowDrawCosts;
+    bool                   fDrawCostGpuTiming;
+    DrawCostCanvas::Cost   fDrawCostHeat;
+    SkTArray<DrawCostCanvas::Draw> fDrawCosts;
+    bool                   fDrawCostsHaveGpuTimes;
+    int                    fHighlightedDraw;  // -1 for none
+
     sk_app::Window::BackendType fBackendType;
 
     // Color properties for slide rendering